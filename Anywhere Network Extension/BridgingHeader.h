@@ -9,6 +9,7 @@
 #define BridgingHeader_h
 
 #include "./lwip/lwip_bridge.h"
+#include "./lwip/udp_packet.h"
 #include "ngtcp2_bridge.h"
 #include "blake2.h"
 #include "blake3.h"
@@ -9,8 +9,23 @@ import Foundation
 
 enum DNSPacket {
 
-    /// Extracts the queried domain name and QTYPE, or nil on failure.
+    /// Longest dotted name a question can carry (RFC 1035 §2.3.4).
+    static let maxNameLength = 255
+
+    /// Extracts the queried domain name (lowercased) and QTYPE, or nil on failure.
     static func parseQuery(_ data: UnsafeBufferPointer<UInt8>) -> (domain: String, qtype: UInt16)? {
+        withUnsafeTemporaryAllocation(of: UInt8.self, capacity: maxNameLength) { name in
+            guard let parsed = parseQuestion(data, into: name) else { return nil }
+            return (String(decoding: UnsafeBufferPointer(rebasing: name[..<parsed.nameLength]), as: UTF8.self), parsed.qtype)
+        }
+    }
+
+    /// Writes the queried name into `name` as lowercased dotted ASCII and
+    /// returns its length and the QTYPE, or nil on failure. Allocation-free,
+    /// so the fake-IP path can key on the bytes directly. Names that are not
+    /// ASCII (IDNs travel as punycode) or exceed `name` are rejected.
+    static func parseQuestion(_ data: UnsafeBufferPointer<UInt8>,
+                              into name: UnsafeMutableBufferPointer<UInt8>) -> (nameLength: Int, qtype: UInt16)? {
         // DNS header is 12 bytes
         guard data.count >= 12 else { return nil }
 
@@ -18,9 +33,7 @@ enum DNSPacket {
         guard qdcount > 0 else { return nil }
 
         var offset = 12
-        var domainBytes = [UInt8]()
-        domainBytes.reserveCapacity(64)
-        var labelCount = 0
+        var length = 0
 
         while offset < data.count {
             let labelLen = Int(data[offset])
@@ -31,21 +44,29 @@ enum DNSPacket {
             // Compressed pointers not expected in queries
             guard labelLen & 0xC0 == 0 else { return nil }
             guard offset + labelLen <= data.count else { return nil }
+            guard length + (length > 0 ? 1 : 0) + labelLen <= name.count else { return nil }
 
-            if labelCount > 0 { domainBytes.append(0x2E) } // "."
-            domainBytes.append(contentsOf: UnsafeBufferPointer(start: data.baseAddress! + offset, count: labelLen))
-            labelCount += 1
+            if length > 0 {
+                name[length] = 0x2E // "."
+                length += 1
+            }
+            for i in offset..<(offset + labelLen) {
+                let byte = data[i]
+                guard byte < 0x80 else { return nil }
+                // ASCII-only case fold (RFC 4343)
+                name[length] = byte &- 0x41 < 26 ? byte | 0x20 : byte
+                length += 1
+            }
             offset += labelLen
         }
 
-        guard labelCount > 0 else { return nil }
+        guard length > 0 else { return nil }
 
         // Read QTYPE: 2 bytes after QNAME terminator
         guard offset + 2 <= data.count else { return nil }
         let qtype = UInt16(data[offset]) << 8 | UInt16(data[offset + 1])
 
-        let domain = String(bytes: domainBytes, encoding: .ascii) ?? ""
-        return (domain, qtype)
+        return (length, qtype)
     }
 
     /// Generates a minimal DNS response: an A/AAAA record when fakeIP is non-nil
@@ -129,4 +150,78 @@ enum DNSPacket {
             return response
         }
     }
+
+    /// Where a cacheable response's TTLs live and how long it may be cached.
+    struct CacheInfo {
+        /// End of the (single) question section.
+        let questionEnd: Int
+        /// Seconds the whole response may be reused.
+        let ttl: UInt32
+        /// NXDOMAIN or NODATA, whose lifetime came from the SOA.
+        let isNegative: Bool
+        /// Byte offsets of every RR TTL field (OPT excluded), for aging on reuse.
+        let ttlOffsets: [Int]
+    }
+
+    /// Decides whether an upstream response may be cached and for how long:
+    /// positive answers for their smallest RR TTL, NXDOMAIN / NODATA for
+    /// min(SOA TTL, SOA MINIMUM) per RFC 2308 §5. Returns nil for truncated
+    /// or failed responses and for negative ones without an SOA.
+    static func cacheInfo(response data: UnsafeBufferPointer<UInt8>) -> CacheInfo? {
+        guard data.count >= 12, data[2] & 0x80 != 0, data[2] & 0x02 == 0 else { return nil }
+        let rcode = data[3] & 0x0F
+        guard rcode == 0 || rcode == 3 else { return nil }
+        let qdcount = Int(data[4]) << 8 | Int(data[5])
+        let ancount = Int(data[6]) << 8 | Int(data[7])
+        let nscount = Int(data[8]) << 8 | Int(data[9])
+        let arcount = Int(data[10]) << 8 | Int(data[11])
+        guard qdcount == 1, var offset = skipName(data, from: 12), offset + 4 <= data.count else { return nil }
+        offset += 4
+        let questionEnd = offset
+
+        func readUInt32(_ at: Int) -> UInt32 {
+            UInt32(data[at]) << 24 | UInt32(data[at + 1]) << 16 | UInt32(data[at + 2]) << 8 | UInt32(data[at + 3])
+        }
+
+        var ttlOffsets: [Int] = []
+        var minTTL = UInt32.max
+        var negativeTTL: UInt32?
+        for index in 0..<(ancount + nscount + arcount) {
+            guard let nameEnd = skipName(data, from: offset), nameEnd + 10 <= data.count else { return nil }
+            let type = UInt16(data[nameEnd]) << 8 | UInt16(data[nameEnd + 1])
+            let ttl = readUInt32(nameEnd + 4)
+            let rdLength = Int(data[nameEnd + 8]) << 8 | Int(data[nameEnd + 9])
+            let rdataStart = nameEnd + 10
+            guard rdataStart + rdLength <= data.count else { return nil }
+            // OPT's "TTL" carries EDNS flags, not a lifetime.
+            if type != 41 {
+                ttlOffsets.append(nameEnd + 4)
+                minTTL = min(minTTL, ttl)
+                let inAuthority = index >= ancount && index < ancount + nscount
+                // SOA MINIMUM is the last 4 bytes of its RDATA.
+                if type == 6, inAuthority, rdLength >= 20 {
+                    negativeTTL = min(ttl, readUInt32(rdataStart + rdLength - 4))
+                }
+            }
+            offset = rdataStart + rdLength
+        }
+
+        let isNegative = rcode != 0 || ancount == 0
+        guard let ttl = isNegative ? negativeTTL : minTTL, ttl > 0 else { return nil }
+        return CacheInfo(questionEnd: questionEnd, ttl: ttl, isNegative: isNegative, ttlOffsets: ttlOffsets)
+    }
+
+    /// Offset just past the (possibly compressed) name at `offset`.
+    private static func skipName(_ data: UnsafeBufferPointer<UInt8>, from offset: Int) -> Int? {
+        var offset = offset
+        while offset < data.count {
+            let labelLen = Int(data[offset])
+            if labelLen == 0 { return offset + 1 }
+            // A compression pointer ends the name in two bytes.
+            if labelLen & 0xC0 == 0xC0 { return offset + 2 <= data.count ? offset + 2 : nil }
+            guard labelLen & 0xC0 == 0 else { return nil }
+            offset += 1 + labelLen
+        }
+        return nil
+    }
 }
@@ -0,0 +1,143 @@
+//
+//  DNSResponseCache.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Upstream DNS responses keyed by (qname, qtype), so repeated queries are
+/// answered without another trip over the proxy. Entries live for the
+/// response's TTL (RFC 2308 negative TTL for NXDOMAIN / NODATA) and are
+/// replayed with the querier's ID and question bytes and TTLs aged by the
+/// time spent in the cache. Split into independently locked shards because
+/// every UDP shard queue answers DNS; each shard evicts least-recently-used.
+final class DNSResponseCache {
+
+    private struct Key: Hashable {
+        let name: String
+        let qtype: UInt16
+    }
+
+    private struct Entry {
+        let response: Data
+        let info: DNSPacket.CacheInfo
+        let storedAt: TimeInterval
+        let expiresAt: TimeInterval
+        var lastUse: UInt64
+    }
+
+    private final class Shard {
+        let lock = UnfairLock()
+        var entries: [Key: Entry] = [:]
+        /// Use counter standing in for recency, so a hit writes one integer.
+        var useClock: UInt64 = 0
+    }
+
+    private let shards: [Shard]
+    private let capacityPerShard: Int
+
+    init(shardCount: Int = TunnelConstants.dnsCacheShardCount,
+         capacityPerShard: Int = TunnelConstants.dnsCacheEntriesPerShard) {
+        shards = (0..<max(1, shardCount)).map { _ in Shard() }
+        self.capacityPerShard = max(1, capacityPerShard)
+    }
+
+    private func shard(for key: Key) -> Shard {
+        shards[Int(UInt(bitPattern: key.hashValue) % UInt(shards.count))]
+    }
+
+    /// The cached response for `query`, rewritten to answer it, or nil.
+    /// `name` must be lowercased.
+    func response(for query: Data, name: String, qtype: UInt16) -> Data? {
+        let key = Key(name: name, qtype: qtype)
+        let keyShard = shard(for: key)
+        let now = MonotonicClock.now
+        let hit: Entry? = keyShard.lock.withLock {
+            guard var entry = keyShard.entries[key] else { return nil }
+            guard now < entry.expiresAt else {
+                keyShard.entries.removeValue(forKey: key)
+                return nil
+            }
+            keyShard.useClock += 1
+            entry.lastUse = keyShard.useClock
+            keyShard.entries[key] = entry
+            return entry
+        }
+        guard let hit, query.count >= hit.info.questionEnd else { return nil }
+
+        let elapsed = UInt32(min(now - hit.storedAt, TimeInterval(UInt32.max)))
+        var response = hit.response
+        response.withUnsafeMutableBytes { raw in
+            guard let p = raw.bindMemory(to: UInt8.self).baseAddress else { return }
+            query.withUnsafeBytes { queryRaw in
+                guard let q = queryRaw.bindMemory(to: UInt8.self).baseAddress else { return }
+                // Transaction ID, then the question as the querier spelled it
+                // (0x20 case randomization); same name, so same length.
+                p[0] = q[0]; p[1] = q[1]
+                memcpy(p + 12, q + 12, hit.info.questionEnd - 12)
+            }
+            for offset in hit.info.ttlOffsets {
+                let ttl = UInt32(p[offset]) << 24 | UInt32(p[offset + 1]) << 16
+                    | UInt32(p[offset + 2]) << 8 | UInt32(p[offset + 3])
+                let aged = ttl > elapsed ? ttl - elapsed : 0
+                p[offset] = UInt8(aged >> 24); p[offset + 1] = UInt8((aged >> 16) & 0xFF)
+                p[offset + 2] = UInt8((aged >> 8) & 0xFF); p[offset + 3] = UInt8(aged & 0xFF)
+            }
+        }
+        return response
+    }
+
+    /// Caches `response` if ``DNSPacket/cacheInfo(response:)`` allows it,
+    /// evicting the shard's least-recently-used entry when full.
+    func store(response: Data) {
+        let parsed: (key: Key, info: DNSPacket.CacheInfo)? = response.withUnsafeBytes { raw in
+            guard let base = raw.bindMemory(to: UInt8.self).baseAddress else { return nil }
+            let buffer = UnsafeBufferPointer(start: base, count: raw.count)
+            guard let question = DNSPacket.parseQuery(buffer),
+                  let info = DNSPacket.cacheInfo(response: buffer) else { return nil }
+            return (Key(name: question.domain, qtype: question.qtype), info)
+        }
+        guard let parsed else { return }
+
+        let maxTTL = parsed.info.isNegative ? TunnelConstants.dnsCacheMaxNegativeTTL : TunnelConstants.dnsCacheMaxTTL
+        let lifetime = min(TimeInterval(parsed.info.ttl), maxTTL)
+        let now = MonotonicClock.now
+        // Own the bytes: `response` may be a slice of a larger receive buffer.
+        let stored = Data(response)
+
+        let keyShard = shard(for: parsed.key)
+        keyShard.lock.withLock {
+            if keyShard.entries[parsed.key] == nil, keyShard.entries.count >= capacityPerShard {
+                evictOne(from: keyShard, now: now)
+            }
+            keyShard.useClock += 1
+            keyShard.entries[parsed.key] = Entry(
+                response: stored,
+                info: parsed.info,
+                storedAt: now,
+                expiresAt: now + lifetime,
+                lastUse: keyShard.useClock
+            )
+        }
+    }
+
+    /// Drops an expired entry if there is one, else the least recently used.
+    /// Caller holds `shard.lock`.
+    private func evictOne(from shard: Shard, now: TimeInterval) {
+        var victim: Key?
+        var victimUse = UInt64.max
+        for (key, entry) in shard.entries {
+            if now >= entry.expiresAt { victim = key; break }
+            if entry.lastUse < victimUse { victimUse = entry.lastUse; victim = key }
+        }
+        if let victim { shard.entries.removeValue(forKey: victim) }
+    }
+
+    func removeAll() {
+        for shard in shards {
+            shard.lock.withLock { shard.entries.removeAll() }
+        }
+    }
+}
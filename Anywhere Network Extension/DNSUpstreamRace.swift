@@ -0,0 +1,89 @@
+//
+//  DNSUpstreamRace.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// One forwarded DNS query raced across several upstreams, happy-eyeballs
+/// style: legs start a stagger apart and the first valid reply wins. Later
+/// replies are dropped and losing legs close, and every outcome feeds
+/// ``DNSUpstreamSelector``. Only the first leg is registered in the shard's
+/// flow table, so a retransmitted query reaches it; the race owns the rest.
+/// Confined to the shard's queue.
+final class DNSUpstreamRace {
+
+    private struct Leg {
+        let server: String
+        let flow: UDPFlow
+        let startedAt: TimeInterval
+    }
+
+    private let queryID: (UInt8, UInt8)
+    private let selector: DNSUpstreamSelector
+    private let onAnswer: (Data) -> Void
+    private var legs: [Leg] = []
+    private weak var winner: UDPFlow?
+    private(set) var isFinished = false
+
+    /// `onAnswer` sees the winning reply once.
+    init(query: Data, selector: DNSUpstreamSelector, onAnswer: @escaping (Data) -> Void) {
+        queryID = query.count >= 2 ? (query[query.startIndex], query[query.startIndex + 1]) : (0, 0)
+        self.selector = selector
+        self.onAnswer = onAnswer
+    }
+
+    /// Adds a leg: `flow` must target `server` and not yet have seen the query.
+    func launch(_ flow: UDPFlow, server: String, payload: Data) {
+        guard !isFinished else { return }
+        legs.append(Leg(server: server, flow: flow, startedAt: MonotonicClock.now))
+        flow.replyTap = { [weak self, weak flow] reply in
+            guard let self, let flow else { return false }
+            return self.accept(reply, from: flow)
+        }
+        flow.handleReceivedData(payload, payloadLength: payload.count)
+    }
+
+    /// Gives up on legs still waiting; the registered leg stays for the
+    /// querier's retransmits and idles out as usual.
+    func expire() {
+        guard !isFinished else { return }
+        isFinished = true
+        let now = MonotonicClock.now
+        for (index, leg) in legs.enumerated() {
+            selector.recordUnanswered(server: leg.server, waited: now - leg.startedAt)
+            if index > 0 { leg.flow.close() }
+        }
+        legs.removeAll()
+    }
+
+    private func accept(_ reply: Data, from flow: UDPFlow) -> Bool {
+        guard !isFinished else { return flow === winner }
+        // A reply to this query: same ID, QR set.
+        guard reply.count >= 12,
+              reply[reply.startIndex] == queryID.0, reply[reply.startIndex + 1] == queryID.1,
+              reply[reply.startIndex + 2] & 0x80 != 0 else { return false }
+
+        isFinished = true
+        winner = flow
+        let now = MonotonicClock.now
+        for leg in legs {
+            if leg.flow === flow {
+                selector.record(server: leg.server, rtt: now - leg.startedAt)
+                if leg.flow !== legs.first?.flow {
+                    // Unregistered, so nothing reaps it; close once this reply is written.
+                    leg.flow.flowQueue.async { [flow = leg.flow] in flow.close() }
+                }
+            } else {
+                selector.recordUnanswered(server: leg.server, waited: now - leg.startedAt)
+                leg.flow.close()
+                leg.flow.shard.remove(leg.flow)
+            }
+        }
+        legs.removeAll()
+        onAnswer(reply)
+        return true
+    }
+}
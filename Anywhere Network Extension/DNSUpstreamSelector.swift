@@ -0,0 +1,62 @@
+//
+//  DNSUpstreamSelector.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Ranks the upstream resolvers forwarded queries may use by smoothed reply
+/// latency (EWMA, weight 1/4, as for TCP's SRTT). A server not yet measured
+/// ranks first, so every server gets sampled. Shared by all UDP shards.
+final class DNSUpstreamSelector {
+
+    private let lock = UnfairLock()
+    private let servers: [String]
+    private var smoothedRTT: [String: TimeInterval] = [:]
+
+    init(servers: [String]) {
+        self.servers = servers
+    }
+
+    /// The `fanout` best servers, best first, and how long each race leg
+    /// waits before the next one starts: twice the best server's smoothed
+    /// latency, clamped to the configured range.
+    func plan(fanout: Int) -> (servers: [String], stagger: TimeInterval) {
+        lock.withLock {
+            let ranked = servers.enumerated().sorted { a, b in
+                let rttA = smoothedRTT[a.element] ?? 0
+                let rttB = smoothedRTT[b.element] ?? 0
+                return rttA != rttB ? rttA < rttB : a.offset < b.offset
+            }.map(\.element)
+            let best = ranked.first.flatMap { smoothedRTT[$0] } ?? TunnelConstants.dnsRaceMaxStagger
+            let stagger = min(max(best * 2, TunnelConstants.dnsRaceMinStagger), TunnelConstants.dnsRaceMaxStagger)
+            return (Array(ranked.prefix(max(1, fanout))), stagger)
+        }
+    }
+
+    /// Folds one reply latency into `server`'s average.
+    func record(server: String, rtt: TimeInterval) {
+        lock.withLock { fold(server: server, sample: rtt) }
+    }
+
+    /// For a leg that never answered: its latency is at least `waited`, so
+    /// the average only moves when that already exceeds it.
+    func recordUnanswered(server: String, waited: TimeInterval) {
+        lock.withLock {
+            guard let previous = smoothedRTT[server], waited <= previous else {
+                fold(server: server, sample: waited)
+                return
+            }
+        }
+    }
+
+    private func fold(server: String, sample: TimeInterval) {
+        if let previous = smoothedRTT[server] {
+            smoothedRTT[server] = previous + (sample - previous) / 4
+        } else {
+            smoothedRTT[server] = sample
+        }
+    }
+}
@@ -22,27 +22,50 @@ class FakeIPPool {
     /// Protects all mutable state.
     private let lock = UnfairLock()
 
-    private var domainToOffset: [String: Int] = [:]
-    private var offsetToEntry: [Int: Entry] = [:]
+    // Struct-of-arrays slots indexed by offset, so an allocation or lookup
+    // touches a few flat arrays and allocates nothing but a new domain's
+    // String. Slot 0 is the LRU sentinel: `lruNext[0]` is the most recently
+    // used offset, `lruPrev[0]` the least. A free slot has a nil domain.
+    private var domains: ContiguousArray<String?>
+    private var domainHashes: ContiguousArray<UInt64>
+    private var lruPrev: ContiguousArray<Int32>
+    private var lruNext: ContiguousArray<Int32>
+
+    /// Linear-probed domain index of offsets (0 = empty), at most half full.
+    private var index: ContiguousArray<Int32>
+    private let indexMask: Int
+
+    private let capacity = TunnelConstants.fakeIPPoolSize
+    private var nextOffset = 1
 
-    private class LRUNode {
-        let offset: Int
-        var prev: LRUNode?
-        var next: LRUNode?
-        init(offset: Int) { self.offset = offset }
+    /// Where ``saveSnapshot()`` persists the mapping across tunnel restarts.
+    private let snapshotURL: URL?
+
+    init(snapshotURL: URL? = FileManager.default
+            .containerURL(forSecurityApplicationGroupIdentifier: AWCore.Identifier.appGroupSuite)?
+            .appendingPathComponent("fakeip.bin")) {
+        self.snapshotURL = snapshotURL
+        var indexSize = 16
+        while indexSize < capacity * 2 { indexSize <<= 1 }
+        domains = ContiguousArray(repeating: nil, count: capacity + 1)
+        domainHashes = ContiguousArray(repeating: 0, count: capacity + 1)
+        lruPrev = ContiguousArray(repeating: 0, count: capacity + 1)
+        lruNext = ContiguousArray(repeating: 0, count: capacity + 1)
+        index = ContiguousArray(repeating: 0, count: indexSize)
+        indexMask = indexSize - 1
     }
-    private var lruHead: LRUNode?  // most recently used
-    private var lruTail: LRUNode?  // least recently used
-    private var offsetToNode: [Int: LRUNode] = [:]
-
-    private var nextOffset = 1
 
     // MARK: - Static Helpers
 
-    /// Is this IP in the fake IPv4 or IPv6 range? A string-prefix check suffices:
-    /// lwIP's canonical ntoa always renders fakes with the `2001:db8::` prefix.
-    static func isFakeIP(_ ip: String) -> Bool {
-        ip.hasPrefix("198.18.") || ip.hasPrefix("198.19.") || ip.hasPrefix("2001:db8::")
+    /// Is this raw address (4 or 16 bytes) in the fake IPv4 /15 or IPv6 /96?
+    static func isFakeIP(address: UnsafeRawPointer, isIPv6: Bool) -> Bool {
+        let bytes = address.assumingMemoryBound(to: UInt8.self)
+        if !isIPv6 {
+            return bytes[0] == 198 && bytes[1] & 0xFE == 18
+        }
+        guard bytes[0] == 0x20, bytes[1] == 0x01, bytes[2] == 0x0D, bytes[3] == 0xB8 else { return false }
+        for i in 4...11 where bytes[i] != 0 { return false }
+        return true
     }
 
     static func ipv4Bytes(offset: Int) -> (UInt8, UInt8, UInt8, UInt8) {
@@ -70,157 +93,265 @@ class FakeIPPool {
         ]
     }
 
+    /// Pool offset encoded in a fake address, or nil outside 1...fakeIPPoolSize.
+    private static func offset(address: UnsafeRawPointer, isIPv6: Bool) -> Int? {
+        guard isFakeIP(address: address, isIPv6: isIPv6) else { return nil }
+        let bytes = address.assumingMemoryBound(to: UInt8.self) + (isIPv6 ? 12 : 0)
+        let low32 = UInt32(bytes[0]) << 24 | UInt32(bytes[1]) << 16 | UInt32(bytes[2]) << 8 | UInt32(bytes[3])
+        let offset = Int(isIPv6 ? low32 : low32 - TunnelConstants.fakeIPPoolBaseIPv4)
+        guard offset >= 1, offset <= TunnelConstants.fakeIPPoolSize else { return nil }
+        return offset
+    }
+
+    /// FNV-1a over the name bytes.
+    private static func hash(_ name: UnsafeBufferPointer<UInt8>) -> UInt64 {
+        var hash: UInt64 = 0xCBF2_9CE4_8422_2325
+        for byte in name {
+            hash = (hash ^ UInt64(byte)) &* 0x0000_0100_0000_01B3
+        }
+        return hash
+    }
+
+    private static func matches(_ domain: String, _ name: UnsafeBufferPointer<UInt8>) -> Bool {
+        domain.utf8.withContiguousStorageIfAvailable { stored in
+            stored.count == name.count
+                && (name.isEmpty || memcmp(stored.baseAddress!, name.baseAddress!, name.count) == 0)
+        } ?? domain.utf8.elementsEqual(name)
+    }
+
     // MARK: - Pool Operations
 
-    func allocate(domain: String) -> Int {
-        lock.withLock {
-            if let offset = domainToOffset[domain] {
+    /// Allocates by UTF-8 name bytes; a String is built only for a new domain.
+    func allocate(domain name: UnsafeBufferPointer<UInt8>) -> Int {
+        let hash = Self.hash(name)
+        return lock.withLock {
+            if let offset = find(name, hash: hash) {
                 touchLRU(offset)
                 return offset
             }
 
             let offset: Int
-            if nextOffset <= TunnelConstants.fakeIPPoolSize {
+            if nextOffset <= capacity {
                 offset = nextOffset
                 nextOffset += 1
             } else {
                 offset = evictLRU()
             }
 
-            domainToOffset[domain] = offset
-            offsetToEntry[offset] = Entry(domain: domain)
-            appendLRU(offset)
+            domains[offset] = String(decoding: name, as: UTF8.self)
+            domainHashes[offset] = hash
+            insertIntoIndex(offset)
+            linkAtHead(offset)
 
             return offset
         }
     }
 
-    func lookup(ip: String) -> Entry? {
-        lock.withLock {
-            guard let offset = ipToOffset(ip) else { return nil }
-            guard let entry = offsetToEntry[offset] else { return nil }
+    /// Entry for a destination's raw address (4 or 16 bytes), or nil when the
+    /// address isn't a fake IP or its slot is free (stale from a previous
+    /// session).
+    func lookup(address: UnsafeRawPointer, isIPv6: Bool) -> Entry? {
+        guard let offset = Self.offset(address: address, isIPv6: isIPv6) else { return nil }
+        return lock.withLock {
+            guard let domain = domains[offset] else { return nil }
             touchLRU(offset)
-            return entry
+            return Entry(domain: domain)
         }
     }
 
     func reset() {
-        lock.withLock {
-            domainToOffset.removeAll()
-            offsetToEntry.removeAll()
-            offsetToNode.removeAll()
-            lruHead = nil
-            lruTail = nil
-            nextOffset = 1
-        }
+        lock.withLock { resetUnlocked() }
     }
 
-    var count: Int { lock.withLock { domainToOffset.count } }
-
-    // MARK: - IP ↔ Offset Conversion
-
-    private func ipToOffset(_ ip: String) -> Int? {
-        if ip.contains(":") {
-            return ipv6ToOffset(ip)
+    private func resetUnlocked() {
+        for offset in 1..<nextOffset {
+            domains[offset] = nil
+        }
+        for slot in index.indices where index[slot] != 0 {
+            index[slot] = 0
         }
-        return ipv4ToOffset(ip)
-    }
-
-    private func ipv4ToOffset(_ ip: String) -> Int? {
-        var octets: (UInt32, UInt32, UInt32, UInt32) = (0, 0, 0, 0)
-        var current: UInt32 = 0
-        var octetIndex = 0
-        for c in ip.utf8 {
-            if c == UInt8(ascii: ".") {
-                guard octetIndex < 3 else { return nil }
-                switch octetIndex {
-                case 0: octets.0 = current
-                case 1: octets.1 = current
-                case 2: octets.2 = current
-                default: return nil
+        lruPrev[0] = 0
+        lruNext[0] = 0
+        nextOffset = 1
+    }
+
+    var count: Int { lock.withLock { nextOffset - 1 } }
+
+    // MARK: - Snapshot
+
+    // Layout (big-endian): magic, pool size, IPv4 base, entry count, then per
+    // entry, least recently used first: UInt32 offset, UInt8 name length, name.
+    // Offsets 1...count are always all live, so a snapshot restores exactly.
+    private static let snapshotMagic: UInt32 = 0x4157_4650 // "AWFP"
+
+    /// Writes the mapping and LRU order so the next start can hand existing
+    /// fake IPs back to the same domains, instead of every app's cached
+    /// answer failing its first connection. Call on clean shutdown.
+    func saveSnapshot() {
+        guard let snapshotURL else { return }
+        let data: Data = lock.withLock {
+            var data = Data()
+            data.reserveCapacity(16 + (nextOffset - 1) * 24)
+            func append(_ value: UInt32) {
+                withUnsafeBytes(of: value.bigEndian) { data.append(contentsOf: $0) }
+            }
+            append(Self.snapshotMagic)
+            append(UInt32(capacity))
+            append(TunnelConstants.fakeIPPoolBaseIPv4)
+            append(UInt32(nextOffset - 1))
+            var offset = Int(lruPrev[0])
+            while offset != 0 {
+                if var domain = domains[offset] {
+                    append(UInt32(offset))
+                    domain.withUTF8 { name in
+                        data.append(UInt8(name.count))
+                        data.append(name.baseAddress!, count: name.count)
+                    }
                 }
-                current = 0
-                octetIndex += 1
-            } else if c >= UInt8(ascii: "0") && c <= UInt8(ascii: "9") {
-                current = current * 10 + UInt32(c - UInt8(ascii: "0"))
-                guard current <= 255 else { return nil }
-            } else {
-                return nil
+                offset = Int(lruPrev[offset])
             }
+            return data
+        }
+        do {
+            try data.write(to: snapshotURL, options: [.atomic, .noFileProtection])
+        } catch {
+            logger.error("[FakeIPPool] Failed to write snapshot: \(error)")
         }
-        guard octetIndex == 3 else { return nil }
-        octets.3 = current
-        guard octets.3 <= 255 else { return nil }
-        let ip32 = (octets.0 << 24) | (octets.1 << 16) | (octets.2 << 8) | octets.3
-        let offset = Int(ip32 - TunnelConstants.fakeIPPoolBaseIPv4)
-        guard offset >= 1, offset <= TunnelConstants.fakeIPPoolSize else { return nil }
-        return offset
     }
 
-    private func ipv6ToOffset(_ ip: String) -> Int? {
-        var address = in6_addr()
-        guard inet_pton(AF_INET6, ip, &address) == 1 else { return nil }
+    /// Restores the mapping written by ``saveSnapshot()`` into an empty pool.
+    /// The file is consumed: after an unclean exit the pool starts empty rather
+    /// than from a snapshot older than fake IPs handed out since.
+    func restoreSnapshot() {
+        guard let snapshotURL,
+              let data = try? Data(contentsOf: snapshotURL, options: .mappedIfSafe) else { return }
+        try? FileManager.default.removeItem(at: snapshotURL)
 
-        return withUnsafeBytes(of: &address) { raw -> Int? in
+        let restored: Int? = data.withUnsafeBytes { raw in
             let bytes = raw.bindMemory(to: UInt8.self)
-            guard bytes.count == 16 else { return nil }
-
-            guard bytes[0] == 0x20, bytes[1] == 0x01,
-                  bytes[2] == 0x0D, bytes[3] == 0xB8 else { return nil }
-            for i in 4...11 {
-                guard bytes[i] == 0 else { return nil }
+            var cursor = 0
+            func readUInt32() -> UInt32? {
+                guard cursor + 4 <= bytes.count else { return nil }
+                defer { cursor += 4 }
+                return UInt32(bytes[cursor]) << 24 | UInt32(bytes[cursor + 1]) << 16
+                    | UInt32(bytes[cursor + 2]) << 8 | UInt32(bytes[cursor + 3])
+            }
+            guard readUInt32() == Self.snapshotMagic,
+                  readUInt32() == UInt32(capacity),
+                  readUInt32() == TunnelConstants.fakeIPPoolBaseIPv4,
+                  let count = readUInt32().map(Int.init), count <= capacity else { return nil }
+
+            return lock.withLock {
+                guard nextOffset == 1 else { return nil }
+                for _ in 0..<count {
+                    guard let offset = readUInt32().map(Int.init),
+                          offset >= 1, offset <= count, domains[offset] == nil,
+                          cursor < bytes.count else { break }
+                    let length = Int(bytes[cursor])
+                    cursor += 1
+                    guard length > 0, cursor + length <= bytes.count else { break }
+                    let name = UnsafeBufferPointer(rebasing: bytes[cursor..<(cursor + length)])
+                    cursor += length
+                    domains[offset] = String(decoding: name, as: UTF8.self)
+                    domainHashes[offset] = Self.hash(name)
+                    insertIntoIndex(offset)
+                    linkAtHead(offset)
+                    nextOffset += 1
+                }
+                // A gap would break the "1..<nextOffset are live" invariant.
+                guard nextOffset == count + 1 else {
+                    nextOffset = count + 1
+                    resetUnlocked()
+                    return nil
+                }
+                return count
             }
+        }
+        if let restored {
+            logger.debug("[FakeIPPool] Restored \(restored) mappings from snapshot")
+        } else {
+            logger.warning("[FakeIPPool] Discarded unreadable snapshot")
+        }
+    }
 
-            let offset = (Int(bytes[12]) << 24) | (Int(bytes[13]) << 16)
-                       | (Int(bytes[14]) << 8) | Int(bytes[15])
-            guard offset >= 1, offset <= TunnelConstants.fakeIPPoolSize else { return nil }
-            return offset
+    // MARK: - Domain Index
+
+    private func find(_ name: UnsafeBufferPointer<UInt8>, hash: UInt64) -> Int? {
+        var slot = Int(truncatingIfNeeded: hash) & indexMask
+        while index[slot] != 0 {
+            let offset = Int(index[slot])
+            if domainHashes[offset] == hash, let domain = domains[offset], Self.matches(domain, name) {
+                return offset
+            }
+            slot = (slot + 1) & indexMask
         }
+        return nil
     }
 
-    // MARK: - LRU Doubly-Linked List (O(1) operations)
+    private func insertIntoIndex(_ offset: Int) {
+        var slot = Int(truncatingIfNeeded: domainHashes[offset]) & indexMask
+        while index[slot] != 0 {
+            slot = (slot + 1) & indexMask
+        }
+        index[slot] = Int32(offset)
+    }
 
-    private func touchLRU(_ offset: Int) {
-        guard let node = offsetToNode[offset] else { return }
-        removeNode(node)
-        insertAtHead(node)
+    /// Backward-shift deletion, so no tombstones lengthen later probes.
+    private func removeFromIndex(_ offset: Int) {
+        var hole = Int(truncatingIfNeeded: domainHashes[offset]) & indexMask
+        while Int(index[hole]) != offset {
+            guard index[hole] != 0 else { return }
+            hole = (hole + 1) & indexMask
+        }
+        var slot = hole
+        while true {
+            slot = (slot + 1) & indexMask
+            let moved = Int(index[slot])
+            if moved == 0 { break }
+            let home = Int(truncatingIfNeeded: domainHashes[moved]) & indexMask
+            // Shift back unless the entry's home lies cyclically in (hole, slot].
+            if (slot - home) & indexMask >= (slot - hole) & indexMask {
+                index[hole] = index[slot]
+                hole = slot
+            }
+        }
+        index[hole] = 0
     }
 
-    private func appendLRU(_ offset: Int) {
-        let node = LRUNode(offset: offset)
-        offsetToNode[offset] = node
-        insertAtHead(node)
+    // MARK: - Index-Linked LRU (O(1) operations)
+
+    private func touchLRU(_ offset: Int) {
+        guard Int(lruNext[0]) != offset else { return }
+        unlink(offset)
+        linkAtHead(offset)
     }
 
     private func evictLRU() -> Int {
-        guard let tail = lruTail else {
+        let offset = Int(lruPrev[0])
+        guard offset != 0 else {
             // Unreachable (pool is full ⇒ LRU nonempty); fall back rather than crash.
             logger.debug("[FakeIPPool] evictLRU called on empty list, falling back to offset 1")
+            if domains[1] != nil { removeFromIndex(1) }
             return 1
         }
-        let offset = tail.offset
-        removeNode(tail)
-        offsetToNode.removeValue(forKey: offset)
-        if let entry = offsetToEntry.removeValue(forKey: offset) {
-            domainToOffset.removeValue(forKey: entry.domain)
-        }
+        unlink(offset)
+        removeFromIndex(offset)
+        domains[offset] = nil
         return offset
     }
 
-    private func removeNode(_ node: LRUNode) {
-        node.prev?.next = node.next
-        node.next?.prev = node.prev
-        if node === lruHead { lruHead = node.next }
-        if node === lruTail { lruTail = node.prev }
-        node.prev = nil
-        node.next = nil
+    private func unlink(_ offset: Int) {
+        let prev = Int(lruPrev[offset])
+        let next = Int(lruNext[offset])
+        lruNext[prev] = Int32(next)
+        lruPrev[next] = Int32(prev)
     }
 
-    private func insertAtHead(_ node: LRUNode) {
-        node.next = lruHead
-        node.prev = nil
-        lruHead?.prev = node
-        lruHead = node
-        if lruTail == nil { lruTail = node }
+    private func linkAtHead(_ offset: Int) {
+        let first = Int(lruNext[0])
+        lruPrev[offset] = 0
+        lruNext[offset] = Int32(first)
+        lruPrev[first] = Int32(offset)
+        lruNext[0] = Int32(offset)
     }
 }
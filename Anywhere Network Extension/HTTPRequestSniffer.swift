@@ -7,6 +7,10 @@
 
 import Foundation
 
+/// Resumable scanner for the head of a cleartext HTTP/1.x request. Each `feed` advances a
+/// byte-level state machine over just the new bytes, so a head split across many segments is
+/// scanned once in total. It keeps only the request line and the `Host` value, matches header
+/// names in place without building Strings, and stops at the first `Host` header.
 struct HTTPRequestSniffer {
 
     enum State: Equatable {
@@ -18,40 +22,126 @@ struct HTTPRequestSniffer {
         case found(authority: String?)
     }
 
+    private enum Phase {
+        case requestLine
+        /// At the first byte of a header line.
+        case lineStart
+        /// Inside a header name; `matched` bytes so far agree with "host".
+        case name(matched: Int, isHost: Bool)
+        /// Collecting the `Host` value up to its CRLF.
+        case hostValue
+        /// Skipping the rest of an unneeded header line.
+        case skipLine
+        /// A CR at line start; the head ends if LF follows.
+        case blankLineCR
+    }
+
+    private static let hostName: [UInt8] = Array("host".utf8)
+
     private let bufferLimit: Int
-    private var buffer = [UInt8]()
+    private var phase = Phase.requestLine
+    private var scanned = 0
+    /// Request line, then the `Host` value; nothing else is retained.
+    private var field = [UInt8]()
+    private var previousWasCR = false
     private(set) var state: State = .needMore
 
     init(bufferLimit: Int = TunnelConstants.httpSnifferBufferLimit) {
         self.bufferLimit = bufferLimit
     }
-    
+
     mutating func feed(_ data: Data) -> State {
-        guard state == .needMore, !data.isEmpty else { return state }
-        
-        if buffer.isEmpty, !Self.isMethodStartByte(data[data.startIndex]) {
-            state = .notHTTP
-            return state
-        }
+        data.withUnsafeBytes { feed($0) }
+    }
 
-        buffer.append(contentsOf: data)
-        if buffer.count > bufferLimit {
+    /// Scans `bytes`, which follow everything fed before; they need not outlive the call.
+    mutating func feed(_ bytes: UnsafeRawBufferPointer) -> State {
+        guard state == .needMore, !bytes.isEmpty else { return state }
+
+        if scanned == 0, !Self.isMethodStartByte(bytes[0]) {
             state = .notHTTP
             return state
         }
 
-        state = parse()
+        for byte in bytes {
+            scanned += 1
+            if scanned > bufferLimit {
+                state = .notHTTP
+                return state
+            }
+            if let result = step(byte) {
+                state = result
+                return state
+            }
+        }
         return state
     }
 
     // MARK: - Parsing
 
-    private func parse() -> State {
-        guard let lineEnd = indexOfCRLF(from: 0) else { return .needMore }
-        guard let request = Self.parseRequestLine(Self.decodeLine(buffer[0..<lineEnd])) else {
-            return .notHTTP
+    /// Advances one byte; returns the final state once the head resolves.
+    private mutating func step(_ byte: UInt8) -> State? {
+        let isLineEnd = byte == 0x0A && previousWasCR
+        previousWasCR = byte == 0x0D
+
+        switch phase {
+        case .requestLine:
+            guard isLineEnd else {
+                field.append(byte)
+                return nil
+            }
+            field.removeLast()  // the CR
+            return requestLineResolved()
+
+        case .lineStart:
+            switch byte {
+            case 0x0D:
+                phase = .blankLineCR
+            case 0x3A:  // ":" with an empty name
+                phase = .skipLine
+            default:
+                phase = .name(matched: 1, isHost: Self.lowercased(byte) == Self.hostName[0])
+            }
+            return nil
+
+        case .blankLineCR:
+            // End of head with no `Host` header.
+            if isLineEnd { return .found(authority: nil) }
+            phase = .skipLine
+            return nil
+
+        case .name(let matched, let isHost):
+            if isLineEnd {
+                phase = .lineStart  // header line without a colon
+            } else if byte == 0x3A {
+                phase = isHost && matched == Self.hostName.count ? .hostValue : .skipLine
+                field.removeAll(keepingCapacity: true)
+            } else {
+                let stillHost = isHost && matched < Self.hostName.count
+                    && Self.lowercased(byte) == Self.hostName[matched]
+                phase = .name(matched: matched + 1, isHost: stillHost)
+            }
+            return nil
+
+        case .hostValue:
+            guard isLineEnd else {
+                field.append(byte)
+                return nil
+            }
+            field.removeLast()  // the CR
+            let value = Self.decodeLine(field[...]).trimmingCharacters(in: .whitespaces)
+            return .found(authority: value.isEmpty ? nil : Self.normalizeAuthorityHost(value))
+
+        case .skipLine:
+            if isLineEnd { phase = .lineStart }
+            return nil
         }
+    }
 
+    private mutating func requestLineResolved() -> State? {
+        guard let request = Self.parseRequestLine(Self.decodeLine(field[...])) else {
+            return .notHTTP
+        }
         switch request.target {
         case .authorityForm:
             // CONNECT sets up a tunnel with no rewritable body — leave it to plain proxying.
@@ -59,10 +149,10 @@ struct HTTPRequestSniffer {
         case .absolute(let authority):
             return .found(authority: Self.normalizeAuthorityHost(authority))
         case .originOrAsterisk:
-            // No authority in the request line — the host is in the `Host` header, so we need the full head.
-            guard let headEnd = indexOfDoubleCRLF() else { return .needMore }
-            let host = hostHeader(from: lineEnd + 2, to: headEnd)
-            return .found(authority: host.flatMap(Self.normalizeAuthorityHost))
+            // No authority in the request line — the host is in the `Host` header.
+            field.removeAll(keepingCapacity: true)
+            phase = .lineStart
+            return nil
         }
     }
 
@@ -133,26 +223,6 @@ struct HTTPRequestSniffer {
         return value.isEmpty ? nil : value.lowercased()
     }
 
-    // MARK: - Headers
-
-    /// Returns the first `Host` header value in the head region `[start, end)`.
-    private func hostHeader(from start: Int, to end: Int) -> String? {
-        var cursor = start
-        while cursor < end {
-            guard let lineEnd = indexOfCRLF(from: cursor), lineEnd <= end else { break }
-            defer { cursor = lineEnd + 2 }
-            if lineEnd == cursor { break } // blank line: end of head
-            let line = Self.decodeLine(buffer[cursor..<lineEnd])
-            guard let colon = line.firstIndex(of: ":") else { continue }
-            let name = line[line.startIndex..<colon]
-            guard ASCII.equalsIgnoringCase(String(name), "host") else { continue }
-            let value = line[line.index(after: colon)...]
-                .trimmingCharacters(in: .whitespaces)
-            return value.isEmpty ? nil : value
-        }
-        return nil
-    }
-
     // MARK: - Byte helpers
 
     /// RFC 9110 §9.1 method tokens are `tchar`; in practice every method begins with an ASCII letter.
@@ -160,31 +230,10 @@ struct HTTPRequestSniffer {
         (0x41...0x5A).contains(byte) || (0x61...0x7A).contains(byte)
     }
 
-    /// Index of the first byte of the next CRLF at or after `from`, or nil.
-    private func indexOfCRLF(from: Int) -> Int? {
-        guard from >= 0, buffer.count >= 2 else { return nil }
-        var i = from
-        while i + 1 < buffer.count {
-            if buffer[i] == 0x0D, buffer[i + 1] == 0x0A { return i }
-            i += 1
-        }
-        return nil
+    private static func lowercased(_ byte: UInt8) -> UInt8 {
+        (0x41...0x5A).contains(byte) ? byte | 0x20 : byte
     }
 
-    /// Index of the first byte of the CRLF that terminates the head (the empty line).
-    private func indexOfDoubleCRLF() -> Int? {
-        guard buffer.count >= 4 else { return nil }
-        var i = 0
-        while i + 3 < buffer.count {
-            if buffer[i] == 0x0D, buffer[i + 1] == 0x0A,
-               buffer[i + 2] == 0x0D, buffer[i + 3] == 0x0A {
-                return i + 2
-            }
-            i += 1
-        }
-        return nil
-    }
-    
     private static func decodeLine(_ bytes: ArraySlice<UInt8>) -> String {
         String(bytes.map { Character(UnicodeScalar($0)) })
     }
@@ -503,22 +503,296 @@ enum MITMBodyCodec {
 
     /// CRC-32 (reflected, polynomial 0xEDB88320); the Compression framework
     /// computes no checksum for raw DEFLATE, and the gzip trailer needs one.
+    /// Slicing-by-8: eight bytes per step through eight derived tables, with a
+    /// bytewise loop for the tail.
     private static func crc32(_ data: Data) -> UInt32 {
         var crc: UInt32 = 0xFFFF_FFFF
-        for byte in data {
-            let index = Int((crc ^ UInt32(byte)) & 0xFF)
-            crc = crc32Table[index] ^ (crc >> 8)
+        data.withUnsafeBytes { raw in
+            crc32Table.withUnsafeBufferPointer { table in
+                let count = raw.count
+                var offset = 0
+                while count - offset >= 8 {
+                    let word = UInt64(littleEndian: raw.loadUnaligned(fromByteOffset: offset, as: UInt64.self))
+                    let lo = crc ^ UInt32(truncatingIfNeeded: word)
+                    let hi = UInt32(truncatingIfNeeded: word >> 32)
+                    crc = table[7 * 256 + Int(lo & 0xFF)]
+                        ^ table[6 * 256 + Int((lo >> 8) & 0xFF)]
+                        ^ table[5 * 256 + Int((lo >> 16) & 0xFF)]
+                        ^ table[4 * 256 + Int(lo >> 24)]
+                        ^ table[3 * 256 + Int(hi & 0xFF)]
+                        ^ table[2 * 256 + Int((hi >> 8) & 0xFF)]
+                        ^ table[1 * 256 + Int((hi >> 16) & 0xFF)]
+                        ^ table[Int(hi >> 24)]
+                    offset += 8
+                }
+                while offset < count {
+                    crc = table[Int((crc ^ UInt32(raw[offset])) & 0xFF)] ^ (crc >> 8)
+                    offset += 1
+                }
+            }
         }
         return crc ^ 0xFFFF_FFFF
     }
 
+    /// Eight 256-entry tables back to back: slice 0 is the classic bytewise
+    /// table; slice k advances slice k-1 by one more zero byte.
     private static let crc32Table: [UInt32] = {
-        (0..<256).map { i -> UInt32 in
+        var table = [UInt32](repeating: 0, count: 8 * 256)
+        for i in 0..<256 {
             var c = UInt32(i)
             for _ in 0..<8 {
                 c = (c & 1) != 0 ? (0xEDB8_8320 ^ (c >> 1)) : (c >> 1)
             }
-            return c
+            table[i] = c
+        }
+        for slice in 1..<8 {
+            for i in 0..<256 {
+                let previous = table[(slice - 1) * 256 + i]
+                table[slice * 256 + i] = (previous >> 8) ^ table[Int(previous & 0xFF)]
+            }
         }
+        return table
     }()
 }
+
+// MARK: - Incremental decoder (streaming rewrite)
+
+extension MITMBodyCodec {
+
+    /// Decodes a `Content-Encoding` chain chunk by chunk, keeping one `compression_stream` open
+    /// per codec across calls, so a streaming body rule never holds the whole body. gzip members
+    /// are framed incrementally (header, raw DEFLATE, trailer) and concatenated members decode in
+    /// sequence; trailing junk after a member is dropped, as in the buffered path.
+    final class StreamDecoder {
+        private let stages: [DecodeStage]
+
+        /// Nil for an unsupported plan or when a stream can't be initialized.
+        init?(plan: Plan) {
+            guard plan.supported else { return nil }
+            var stages: [DecodeStage] = []
+            for codec in plan.codecs.reversed() {
+                switch codec {
+                case .identity: continue
+                case .gzip:     stages.append(DecodeStage(kind: .gzip))
+                case .deflate:  stages.append(DecodeStage(kind: .deflate))
+                case .brotli:   stages.append(DecodeStage(kind: .brotli))
+                }
+            }
+            self.stages = stages
+        }
+
+        /// Decoded bytes for `data`; nil on a corrupt stream or an expansion past the bomb guard.
+        func decode(_ data: Data) -> Data? {
+            var current = data
+            for stage in stages {
+                guard let next = stage.feed(current) else { return nil }
+                current = next
+            }
+            return current
+        }
+
+        /// Signals end of input; nil when a stream ended mid-member.
+        func finish() -> Data? {
+            var current = Data()
+            for stage in stages {
+                guard let fed = stage.feed(current), stage.isComplete else { return nil }
+                current = fed
+            }
+            return current
+        }
+    }
+
+    private final class DecodeStage {
+        enum Kind { case gzip, deflate, brotli }
+
+        private enum Phase {
+            /// Accumulating a gzip member header or the 2-byte zlib sniff for deflate.
+            case header
+            case body
+            /// gzip only: trailer bytes still to skip before a possible next member.
+            case trailer(remaining: Int)
+            /// The stream ended; anything further is dropped.
+            case done
+        }
+
+        /// Input fed to `compression_stream_process` per step; with the per-step output ceiling
+        /// below this bounds expansion at 256:1, well past real content and short of a bomb.
+        private static let inputSlice = 16 * 1024
+        private static let outputPerSlice = maxBufferedBodyBytes
+        private static let bufferSize = 64 * 1024
+
+        let kind: Kind
+        private var phase: Phase = .header
+        private var headerBytes = Data()
+        private var stream: UnsafeMutablePointer<compression_stream>?
+        private let buffer = UnsafeMutablePointer<UInt8>.allocate(capacity: DecodeStage.bufferSize)
+        /// At least one member decoded to its end; lets a gzip body end cleanly between members.
+        private var completedMember = false
+
+        init(kind: Kind) {
+            self.kind = kind
+        }
+
+        deinit {
+            closeStream()
+            buffer.deallocate()
+        }
+
+        var isComplete: Bool {
+            switch phase {
+            case .done: return true
+            case .header: return completedMember
+            // A short trailer still leaves the payload whole, as `gunzipOneMember` accepts.
+            case .trailer: return true
+            case .body: return false
+            }
+        }
+
+        func feed(_ data: Data) -> Data? {
+            var output = Data()
+            var input = data
+            while !input.isEmpty {
+                switch phase {
+                case .done:
+                    return output
+                case .header:
+                    headerBytes.append(contentsOf: input)
+                    input = Data()
+                    switch kind {
+                    case .gzip:
+                        switch Self.gzipHeaderLength(headerBytes) {
+                        case .needMore:
+                            continue
+                        case .invalid:
+                            // A decoded member followed by junk ends the body, as `gunzip` does.
+                            guard completedMember else { return nil }
+                            phase = .done
+                            headerBytes = Data()
+                            return output
+                        case .length(let length):
+                            input = headerBytes.dropFirst(length)
+                            headerBytes = Data()
+                        }
+                    case .deflate:
+                        guard headerBytes.count >= 2 else { continue }
+                        let cmf = headerBytes[headerBytes.startIndex]
+                        let flg = headerBytes[headerBytes.startIndex + 1]
+                        // zlib-wrapped (RFC 1950): CM=8, CINFO≤7, FCHECK valid. Raw DEFLATE is
+                        // what servers actually send, so it's the default.
+                        let zlibWrapped = cmf & 0x0F == 8 && cmf >> 4 <= 7
+                            && (UInt16(cmf) << 8 | UInt16(flg)) % 31 == 0
+                        if zlibWrapped, flg & 0x20 != 0 { return nil } // FDICT unsupported
+                        input = zlibWrapped ? headerBytes.dropFirst(2) : headerBytes
+                        headerBytes = Data()
+                    case .brotli:
+                        input = headerBytes
+                        headerBytes = Data()
+                    }
+                    guard openStream() else { return nil }
+                    phase = .body
+                case .body:
+                    let slice = input.prefix(Self.inputSlice)
+                    guard let step = process(Data(slice), into: &output) else { return nil }
+                    input = input.dropFirst(step.consumed)
+                    if step.ended {
+                        closeStream()
+                        completedMember = true
+                        // Only gzip frames further members; deflate/brotli end here.
+                        phase = kind == .gzip ? .trailer(remaining: 8) : .done
+                    }
+                case .trailer(let remaining):
+                    let skip = min(remaining, input.count)
+                    input = input.dropFirst(skip)
+                    phase = remaining == skip ? .header : .trailer(remaining: remaining - skip)
+                }
+            }
+            return output
+        }
+
+        private func openStream() -> Bool {
+            let stream = UnsafeMutablePointer<compression_stream>.allocate(capacity: 1)
+            let algorithm = kind == .brotli ? COMPRESSION_BROTLI : COMPRESSION_ZLIB
+            guard compression_stream_init(stream, COMPRESSION_STREAM_DECODE, algorithm) == COMPRESSION_STATUS_OK else {
+                stream.deallocate()
+                return false
+            }
+            self.stream = stream
+            return true
+        }
+
+        private func closeStream() {
+            guard let stream else { return }
+            compression_stream_destroy(stream)
+            stream.deallocate()
+            self.stream = nil
+        }
+
+        /// One slice through the open stream; returns consumed input and whether the stream ended.
+        private func process(_ slice: Data, into output: inout Data) -> (consumed: Int, ended: Bool)? {
+            guard let stream else { return nil }
+            let produced = output.count
+            return slice.withUnsafeBytes { (raw: UnsafeRawBufferPointer) -> (consumed: Int, ended: Bool)? in
+                guard let base = raw.baseAddress?.assumingMemoryBound(to: UInt8.self) else { return (0, false) }
+                stream.pointee.src_ptr = base
+                stream.pointee.src_size = slice.count
+                while true {
+                    stream.pointee.dst_ptr = buffer
+                    stream.pointee.dst_size = Self.bufferSize
+                    let status = compression_stream_process(stream, 0)
+                    guard status == COMPRESSION_STATUS_OK || status == COMPRESSION_STATUS_END else { return nil }
+                    let written = Self.bufferSize - stream.pointee.dst_size
+                    if written > 0 {
+                        if output.count - produced + written > Self.outputPerSlice {
+                            logger.warning("streaming decode expanded a \(slice.count) B slice past \(Self.outputPerSlice) B; aborting")
+                            return nil
+                        }
+                        output.append(buffer, count: written)
+                    }
+                    let consumed = slice.count - stream.pointee.src_size
+                    if status == COMPRESSION_STATUS_END { return (consumed, true) }
+                    // Output buffer had room: the stream took what it could and waits for more input.
+                    if stream.pointee.dst_size > 0 {
+                        // Neither input consumed nor output produced is a stuck stream, not a wait.
+                        return consumed == 0 && written == 0 ? nil : (consumed, false)
+                    }
+                }
+            }
+        }
+
+        private enum HeaderParse {
+            case needMore
+            case invalid
+            case length(Int)
+        }
+
+        /// Length of the gzip member header (RFC 1952 §2.3) at the start of `data`.
+        private static func gzipHeaderLength(_ data: Data) -> HeaderParse {
+            let bytes = [UInt8](data.prefix(3))
+            for (offset, expected) in [UInt8(0x1F), 0x8B, 0x08].enumerated() where offset < bytes.count {
+                guard bytes[offset] == expected else { return .invalid }
+            }
+            guard data.count >= 10 else { return .needMore }
+            let start = data.startIndex
+            let flags = data[start + 3]
+            var index = 10
+            if flags & 0x04 != 0 { // FEXTRA
+                guard data.count >= index + 2 else { return .needMore }
+                let xlen = Int(data[start + index]) | (Int(data[start + index + 1]) << 8)
+                index += 2 + xlen
+                guard data.count >= index else { return .needMore }
+            }
+            for flag in [UInt8(0x08), 0x10] where flags & flag != 0 { // FNAME, FCOMMENT
+                guard let nul = data[(start + index)...].firstIndex(of: 0) else {
+                    // An unbounded name field is junk, not a header.
+                    return data.count > 64 * 1024 ? .invalid : .needMore
+                }
+                index = nul - start + 1
+            }
+            if flags & 0x02 != 0 { // FHCRC
+                index += 2
+                guard data.count >= index else { return .needMore }
+            }
+            return .length(index)
+        }
+    }
+}
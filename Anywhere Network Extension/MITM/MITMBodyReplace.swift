@@ -77,6 +77,19 @@ enum MITMBodyReplace {
 
     /// Runs one substitution under the soft budget; nil on timeout or while a prior runaway is still burning.
     private static func boundedReplace(_ text: String, op: CompiledOp) -> String? {
+        bounded(byteCount: text.utf8.count) {
+            if let literal = op.staticReplacement {
+                return text.replacing(op.search, with: literal)
+            }
+            return text.replacing(op.search) { match in
+                op.template.expand(output: match.output)
+            }
+        }
+    }
+
+    /// Runs `work` on the watchdog queue under the soft budget; nil on timeout or while a prior
+    /// runaway is still burning.
+    private static func bounded<T>(byteCount: Int, _ work: @escaping () -> T) -> T? {
         inFlightLock.lock()
         if substitutionInFlight {
             inFlightLock.unlock()
@@ -85,16 +98,10 @@ enum MITMBodyReplace {
         substitutionInFlight = true
         inFlightLock.unlock()
 
-        let resultBox = ResultBox()
+        let resultBox = ResultBox<T>()
         let done = DispatchSemaphore(value: 0)
         watchdogQueue.async {
-            if let literal = op.staticReplacement {
-                resultBox.value = text.replacing(op.search, with: literal)
-            } else {
-                resultBox.value = text.replacing(op.search) { match in
-                    op.template.expand(output: match.output)
-                }
-            }
+            resultBox.value = work()
             inFlightLock.lock()
             substitutionInFlight = false
             inFlightLock.unlock()
@@ -102,9 +109,9 @@ enum MITMBodyReplace {
         }
         // The semaphore establishes happens-before for the unsynchronized resultBox.
         guard done.wait(timeout: .now() + substitutionTimeLimit) == .success else {
-            logger.warning("bodyReplace: regex substitution exceeded its time budget over a \(text.utf8.count) B body; leaving the body unchanged (possible catastrophic backtracking in the pattern)")
+            logger.warning("bodyReplace: regex substitution exceeded its time budget over a \(byteCount) B body; leaving the body unchanged (possible catastrophic backtracking in the pattern)")
             // The worker is still spinning with the in-flight flag stuck; arm the hard-cap crash.
-            Self.scheduleHardCapCheck(done, byteCount: text.utf8.count)
+            Self.scheduleHardCapCheck(done, byteCount: byteCount)
             return nil
         }
         return resultBox.value
@@ -119,8 +126,178 @@ enum MITMBodyReplace {
         }
     }
 
+    // MARK: - Streaming
+
+    /// Chunk-at-a-time `applyAll` for a streamed body. Each op is a stage holding back a trailing
+    /// window of text: matches are committed only when they start before the window, so a match
+    /// straddling a chunk boundary is still found whole. About a kilobyte of committed text stays
+    /// in front of each search, so anchors and lookbehind see real context rather than a cut, and
+    /// the search stays within the same watchdog budget.
+    ///
+    /// The charset is chosen once from the first bytes, as `applyAll` chooses it for a whole body.
+    /// A match longer than the window, a later invalid UTF-8 sequence, or a blown budget stops
+    /// editing: text already held goes out as edited so far, and the rest passes through unedited.
+    final class StreamingReplacer {
+        private final class Stage {
+            let op: CompiledOp
+            var pending = ""
+            /// Committed text kept in front of `pending` as match context; never re-emitted.
+            var context = ""
+            init(op: CompiledOp) { self.op = op }
+        }
+
+        /// Text a stage holds back past the last commit point.
+        private static let window = 64 * 1024
+        private static let contextLength = 1024
+
+        private let stages: [Stage]
+        private var encoding: String.Encoding?
+        /// Undecoded tail: an incomplete UTF-8 sequence at a chunk boundary.
+        private var carry = Data()
+        private var stopped = false
+
+        init(ops: [CompiledOp]) {
+            stages = ops.map(Stage.init)
+        }
+
+        func feed(_ data: Data) -> Data {
+            if stopped { return data }
+            carry.append(data)
+            guard let text = decodeCarry(final: false) else { return stop() }
+            return encode(run(text, final: false))
+        }
+
+        func finish() -> Data {
+            if stopped { return Data() }
+            guard let text = decodeCarry(final: true) else { return stop() }
+            return encode(run(text, final: true))
+        }
+
+        /// Decodes `carry`, keeping back an incomplete trailing UTF-8 sequence; nil once the body
+        /// turns out not to be in the charset chosen at the start.
+        private func decodeCarry(final: Bool) -> String? {
+            if encoding == nil {
+                guard final || carry.count >= 4 else { return "" }
+                encoding = String(data: Self.completePrefix(carry), encoding: .utf8) != nil ? .utf8 : .isoLatin1
+            }
+            if encoding == .isoLatin1 {
+                defer { carry = Data() }
+                return String(data: carry, encoding: .isoLatin1)
+            }
+            let complete = final ? carry : Self.completePrefix(carry)
+            guard let text = String(data: complete, encoding: .utf8) else { return nil }
+            carry = Data(carry.dropFirst(complete.count))
+            return text
+        }
+
+        /// `data` minus a trailing partial UTF-8 sequence (at most three bytes).
+        private static func completePrefix(_ data: Data) -> Data {
+            var back = 0
+            for byte in data.suffix(3).reversed() {
+                back += 1
+                if byte & 0xC0 == 0x80 { continue } // continuation byte
+                if byte & 0x80 == 0 { return data }  // ASCII: nothing pending
+                let length = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : 2
+                return length > back ? data.dropLast(back) : data
+            }
+            return data
+        }
+
+        private func encode(_ text: String) -> Data {
+            guard !text.isEmpty else { return Data() }
+            // Only a replacement outside latin-1 fails here; UTF-8 is the least-bad spelling of it.
+            return text.data(using: encoding ?? .utf8) ?? Data(text.utf8)
+        }
+
+        /// Pushes `text` through every stage; stops editing on a blown budget or an oversized match.
+        private func run(_ text: String, final: Bool) -> String {
+            var current = text
+            for stage in stages {
+                stage.pending.append(current)
+                guard final || stage.pending.utf8.count >= 2 * Self.window else { return "" }
+                guard let committed = drain(stage, final: final) else {
+                    logger.warning("bodyReplace: streamed substitution stopped; forwarding the rest of the body unedited")
+                    stopped = true
+                    return flushStages()
+                }
+                current = committed
+            }
+            return current
+        }
+
+        private struct Drained {
+            let committed: String
+            let context: String
+            let pending: String
+        }
+
+        /// Replaces matches that start before the held-back window and returns text up to the
+        /// commit point; `final` commits all of it. Nil on a blown budget or a match that runs
+        /// to the end of what's buffered (it could have run on in the full body).
+        private func drain(_ stage: Stage, final: Bool) -> String? {
+            let op = stage.op
+            let contextCount = stage.context.utf8.count
+            let searched = stage.context + stage.pending
+            let held = final ? 0 : Self.window
+            let outcome = MITMBodyReplace.bounded(byteCount: searched.utf8.count) { () -> Drained? in
+                let pendingStart = Self.characterIndex(in: searched, utf8Offset: contextCount)
+                let boundary = Self.characterIndex(in: searched, utf8Offset: searched.utf8.count - held)
+                var out = ""
+                var last = pendingStart
+                for match in searched.matches(of: op.search) {
+                    if match.range.lowerBound < pendingStart { continue }
+                    if match.range.lowerBound >= boundary, !final { break }
+                    if !final, match.range.upperBound == searched.endIndex { return nil }
+                    out += searched[last..<match.range.lowerBound]
+                    if let literal = op.staticReplacement {
+                        out += literal
+                    } else {
+                        out += op.template.expand(output: match.output)
+                    }
+                    last = match.range.upperBound
+                }
+                let commit = max(boundary, last)
+                out += searched[last..<commit]
+                return Drained(
+                    committed: out,
+                    context: String(searched[pendingStart..<commit].suffix(Self.contextLength)),
+                    pending: String(searched[commit...])
+                )
+            }
+            guard let outcome, let drained = outcome else { return nil }
+            stage.context = drained.context
+            stage.pending = drained.pending
+            return drained.committed
+        }
+
+        private static func characterIndex(in text: String, utf8Offset: Int) -> String.Index {
+            var index = text.utf8.index(text.startIndex, offsetBy: max(0, min(utf8Offset, text.utf8.count)))
+            while String.Index(index, within: text) == nil { index = text.utf8.index(before: index) }
+            return index
+        }
+
+        /// Everything still held, oldest first: a later stage holds text an earlier one already let out.
+        private func flushStages() -> String {
+            var out = ""
+            for stage in stages.reversed() {
+                out += stage.pending
+                stage.pending = ""
+            }
+            return out
+        }
+
+        /// The body left the charset chosen at the start: release what's held and pass through.
+        private func stop() -> Data {
+            stopped = true
+            var out = encode(flushStages())
+            out.append(carry)
+            carry = Data()
+            return out
+        }
+    }
+
     /// Synchronized by the semaphore (written before `signal`, read after `wait`) — hence `@unchecked Sendable`.
-    private final class ResultBox: @unchecked Sendable {
-        var value: String?
+    private final class ResultBox<T>: @unchecked Sendable {
+        var value: T?
     }
 }
@@ -141,6 +141,11 @@ final class MITMBridgeClientLeg: MITMResponseSink {
     private var batchedConnCredit = 0
     private var batchedStreamCredit: [UInt32: Int] = [:]
 
+    /// Frames written while a pass (ours, or an upstream read via `beginResponseBatch`) is open,
+    /// handed to the delegate as one write when the outermost closes; outside a pass `write`
+    /// writes immediately.
+    private var outbox = Data()
+    private var outboxDepth = 0
 
     init(
         host: String,
@@ -164,6 +169,7 @@ final class MITMBridgeClientLeg: MITMResponseSink {
         pendingStreamCredit.removeAll()
         batchedConnCredit = 0
         batchedStreamCredit.removeAll()
+        outbox = Data()
         pending = nil
     }
 
@@ -201,6 +207,7 @@ final class MITMBridgeClientLeg: MITMResponseSink {
             prefaceRemaining -= take
         }
         if !input.isEmpty { rxBuffer.append(input) }
+        outboxDepth += 1
         ensureServerPrefaceSent()
         parkedCompletion = completion
         let parked = pump()
@@ -230,10 +237,10 @@ final class MITMBridgeClientLeg: MITMResponseSink {
         preface.append(contentsOf: [0x00, 0x06, // SETTINGS_MAX_HEADER_LIST_SIZE
                                     UInt8((maxHeaderList >> 24) & 0xFF), UInt8((maxHeaderList >> 16) & 0xFF),
                                     UInt8((maxHeaderList >> 8) & 0xFF), UInt8(maxHeaderList & 0xFF)])
-        delegate?.clientLegWriteToClient(preface)
+        write { $0.append(preface) }
         // INITIAL_WINDOW_SIZE doesn't move the connection window (RFC 9113 §6.9.2); raise it
         // explicitly so the connection isn't the ~64 KiB upload bottleneck.
-        delegate?.clientLegWriteToClient(Codec.windowUpdate(streamID: 0, increment: Self.receiveWindow - 65_535))
+        write { Codec.appendWindowUpdate(streamID: 0, increment: Self.receiveWindow - 65_535, into: &$0) }
     }
 
     private func pump() -> Bool {
@@ -255,22 +262,35 @@ final class MITMBridgeClientLeg: MITMResponseSink {
         // Flush every pass so coalesced receive-window credit reaches the client before it can stall
         // on a depleted window, and never lingers across a script hop.
         flushBatchedCredits()
+        endResponseBatch()
         if parked { return }
         let completion = parkedCompletion
         parkedCompletion = nil
         completion?()
     }
 
+    private func write(_ frames: (inout Data) -> Void) {
+        frames(&outbox)
+        if outboxDepth == 0 { flushOutbox() }
+    }
+
+    private func flushOutbox() {
+        guard !outbox.isEmpty else { return }
+        let bytes = outbox
+        outbox = Data()
+        delegate?.clientLegWriteToClient(bytes)
+    }
+
     /// Emits the WINDOW_UPDATEs accumulated this pass (one per credited stream plus one for the
     /// connection). A stream-level update for a since-closed stream is harmless (RFC 9113 §5.1).
     private func flushBatchedCredits() {
         if batchedConnCredit > 0 {
-            delegate?.clientLegWriteToClient(Codec.windowUpdate(streamID: 0, increment: batchedConnCredit))
+            write { Codec.appendWindowUpdate(streamID: 0, increment: batchedConnCredit, into: &$0) }
             batchedConnCredit = 0
         }
         guard !batchedStreamCredit.isEmpty else { return }
         for (sid, n) in batchedStreamCredit where n > 0 {
-            delegate?.clientLegWriteToClient(Codec.windowUpdate(streamID: sid, increment: n))
+            write { Codec.appendWindowUpdate(streamID: sid, increment: n, into: &$0) }
         }
         batchedStreamCredit.removeAll(keepingCapacity: true)
     }
@@ -290,7 +310,9 @@ final class MITMBridgeClientLeg: MITMResponseSink {
     func sendGoAwayToClient(code: UInt32) {
         guard !torn, !goAwaySent else { return }
         goAwaySent = true
-        delegate?.clientLegWriteToClient(Codec.goAway(lastStreamID: highestStreamID, errorCode: code))
+        write { Codec.appendGoAway(lastStreamID: highestStreamID, errorCode: code, into: &$0) }
+        // Flush now, batch or not: a GOAWAY usually precedes a close that would drop the outbox.
+        flushOutbox()
     }
 
     private func handleFrame(_ frame: Codec.RawFrame) -> Bool {
@@ -305,7 +327,7 @@ final class MITMBridgeClientLeg: MITMResponseSink {
         case Codec.FrameType.settings:     handleSettings(frame)
         case Codec.FrameType.windowUpdate: handleWindowUpdate(frame)
         case Codec.FrameType.ping:
-            if frame.flags & 0x1 == 0 { delegate?.clientLegWriteToClient(Codec.pingAck(opaque: frame.payload)) }
+            if frame.flags & 0x1 == 0 { write { Codec.appendPingAck(opaque: frame.payload, into: &$0) } }
         case Codec.FrameType.rstStream:    handleClientRST(frame)
         case Codec.FrameType.priority:     break
         case Codec.FrameType.goaway:       break
@@ -333,7 +355,7 @@ final class MITMBridgeClientLeg: MITMResponseSink {
             if identifier == 0x4 { applyClientInitialWindowSize(Int(value)) }
             i += 6
         }
-        delegate?.clientLegWriteToClient(Codec.settingsAck())
+        write { Codec.appendSettingsAck(into: &$0) }
     }
 
     private func applyClientInitialWindowSize(_ newValue: Int) {
@@ -846,15 +868,25 @@ final class MITMBridgeClientLeg: MITMResponseSink {
     /// the stream (RFC 9113 §8.1), so no PaceState is created and the real head follows later.
     private func sendInterimContinue(_ streamID: UInt32) {
         let block: [(name: String, value: String)] = [(name: ":status", value: "100")]
-        delegate?.clientLegWriteToClient(Codec.emitHeaders(
+        write { Codec.appendHeaders(
             streamID: streamID,
             block: HPACKEncoder.encodeHeaderBlock(block),
-            endStream: false
-        ))
+            endStream: false,
+            into: &$0
+        ) }
     }
 
     // MARK: - MITMResponseSink (upstream → client)
 
+    func beginResponseBatch() {
+        outboxDepth += 1
+    }
+
+    func endResponseBatch() {
+        outboxDepth -= 1
+        if outboxDepth == 0 { flushOutbox() }
+    }
+
     /// Sink entry points guard on this so an upstream event losing the race with a client RST_STREAM
     /// is dropped, not re-materialized onto a closed stream — which would draw STREAM_CLOSED, a
     /// connection error.
@@ -866,11 +898,12 @@ final class MITMBridgeClientLeg: MITMResponseSink {
         guard !torn, isLiveResponseStream(streamID) else { return }
         var block: [(name: String, value: String)] = [(name: ":status", value: String(status))]
         block.append(contentsOf: MITMBridgeHeaders.responseHeadersToH2(headers))
-        delegate?.clientLegWriteToClient(Codec.emitHeaders(
+        write { Codec.appendHeaders(
             streamID: streamID,
             block: HPACKEncoder.encodeHeaderBlock(block, neverIndexed: neverIndexed),
-            endStream: endStream
-        ))
+            endStream: endStream,
+            into: &$0
+        ) }
         if endStream {
             finishClientStream(streamID, notifyUpstream: true)
         } else if paceStates[streamID] == nil {
@@ -882,11 +915,12 @@ final class MITMBridgeClientLeg: MITMResponseSink {
         guard !torn, isLiveResponseStream(streamID) else { return }
         var block: [(name: String, value: String)] = [(name: ":status", value: String(status))]
         block.append(contentsOf: MITMBridgeHeaders.responseHeadersToH2(headers))
-        delegate?.clientLegWriteToClient(Codec.emitHeaders(
+        write { Codec.appendHeaders(
             streamID: streamID,
             block: HPACKEncoder.encodeHeaderBlock(block),
-            endStream: false
-        ))
+            endStream: false,
+            into: &$0
+        ) }
         // No PaceState, no finalize: a 1xx precedes the final response (RFC 9113 §8.1), so the
         // stream stays open for the real head.
     }
@@ -948,7 +982,7 @@ final class MITMBridgeClientLeg: MITMResponseSink {
             // A pending trailer is the terminal frame, so body DATA must not carry END_STREAM.
             let bodyDrained = paceState.sawEnd && available == paceState.pending.count
             let endOnData = bodyDrained && paceState.pendingTrailers == nil
-            delegate?.clientLegWriteToClient(Codec.frameData(streamID: streamID, payload: chunk, endStream: endOnData))
+            write { Codec.appendData(streamID: streamID, payload: chunk, endStream: endOnData, into: &$0) }
             flowController.debitConnection(available)
             paceState.streamWindow -= available
             paceState.pending.removeFirst(available)
@@ -963,10 +997,10 @@ final class MITMBridgeClientLeg: MITMResponseSink {
         if paceState.sawEnd, paceState.pending.isEmpty, !paceState.finished {
             if let trailers = paceState.pendingTrailers {
                 let block = HPACKEncoder.encodeHeaderBlock(trailers)
-                delegate?.clientLegWriteToClient(Codec.emitHeaders(streamID: streamID, block: block, endStream: true))
+                write { Codec.appendHeaders(streamID: streamID, block: block, endStream: true, into: &$0) }
                 paceState.pendingTrailers = nil
             } else {
-                delegate?.clientLegWriteToClient(Codec.frameData(streamID: streamID, payload: Data(), endStream: true))
+                write { Codec.appendData(streamID: streamID, payload: Data(), endStream: true, into: &$0) }
             }
             paceState.finished = true
             progressed = true
@@ -1007,7 +1041,7 @@ final class MITMBridgeClientLeg: MITMResponseSink {
     }
 
     private func rstToClient(_ streamID: UInt32, errorCode: UInt32, abortUpstream: Bool) {
-        delegate?.clientLegWriteToClient(Codec.rstStream(streamID: streamID, errorCode: errorCode))
+        write { Codec.appendRSTStream(streamID: streamID, errorCode: errorCode, into: &$0) }
         streamMethods.removeValue(forKey: streamID)
         paceStates.removeValue(forKey: streamID)
         pendingStreamCredit.removeValue(forKey: streamID)
@@ -72,6 +72,10 @@ protocol MITMResponseSink: AnyObject {
     /// §7): a real upstream RST relays its own code (keeping REFUSED_STREAM distinguishable);
     /// locally-detected failures use INTERNAL_ERROR.
     func deliverResponseReset(streamID: UInt32, errorCode: UInt32)
+    /// Brackets one upstream read: deliveries in between may be written to the client as one buffer.
+    /// Calls nest and always pair.
+    func beginResponseBatch()
+    func endResponseBatch()
 }
 
 extension MITMResponseSink {
@@ -80,6 +84,9 @@ extension MITMResponseSink {
         deliverResponseHead(streamID: streamID, status: status, headers: headers, endStream: endStream, neverIndexed: [])
     }
 
+    func beginResponseBatch() {}
+    func endResponseBatch() {}
+
     /// Locally-detected reset (no upstream code to relay): INTERNAL_ERROR.
     func deliverResponseReset(streamID: UInt32) {
         deliverResponseReset(streamID: streamID, errorCode: MITMHTTP2FrameCodec.ErrorCode.internalError)
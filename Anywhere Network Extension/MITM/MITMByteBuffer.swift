@@ -7,94 +7,188 @@
 
 import Foundation
 
-/// Read offset makes prefix removal O(1) (not the O(n²) memmove of `Data.removeFirst`); the visible region is always 0-indexed.
+/// Chained-block receive buffer: appended `Data` blocks are kept as-is and consumed from the front by
+/// advancing a cursor, so prefix removal is O(1) and nothing is ever compacted. A read inside one
+/// block comes back as a zero-copy slice of it; only a read straddling blocks gathers. The visible
+/// region is always 0-indexed, but returned `Data` may be a slice — index it from its `startIndex`.
 struct MITMByteBuffer {
 
-    /// Compact once the consumed prefix exceeds this; 64 KiB = 4× the upstream TLS plaintext record size.
-    private static let compactAbsoluteThreshold = 64 * 1024
+    /// Appends below this fold into a small tail block, keeping the chain short when a peer trickles
+    /// tiny reads.
+    private static let coalesceBytes = 1024
 
-    private var storage: Data
-    private var offset: Int
+    private var blocks: [Data] = []
 
-    init() {
-        self.storage = Data()
-        self.offset = 0
-    }
+    /// First live block; consumed blocks ahead of it are released and dropped in batches.
+    private var head = 0
+
+    /// Bytes of `blocks[head]` already consumed.
+    private var headOffset = 0
 
-    var count: Int { storage.count - offset }
+    private(set) var count = 0
 
-    var isEmpty: Bool { offset >= storage.count }
+    init() {}
 
-    /// Always 0; the underlying storage offset is hidden from callers.
+    var isEmpty: Bool { count == 0 }
+
+    /// Always 0; block boundaries and the consumed prefix are hidden from callers.
     var startIndex: Int { 0 }
 
     var endIndex: Int { count }
 
     subscript(_ i: Int) -> UInt8 {
-        return storage[storage.startIndex + offset + i]
+        let first = blocks[head]
+        let local = headOffset + i
+        if local < first.count {
+            return first[first.startIndex + local]
+        }
+        let (block, index) = locate(i)
+        return blocks[block][index]
     }
 
     func prefix(_ n: Int) -> Data {
-        let take = Swift.min(n, count)
-        let absoluteStart = storage.startIndex + offset
-        return storage.subdata(in: absoluteStart..<(absoluteStart + take))
+        subdata(in: 0..<Swift.min(n, count))
     }
 
+    /// Bytes `range`, without copying when they sit in one block.
     func subdata(in range: Range<Int>) -> Data {
-        let s = storage.startIndex + offset
-        return storage.subdata(in: (s + range.lowerBound)..<(s + range.upperBound))
+        guard !range.isEmpty else { return Data() }
+        let (block, lower) = locate(range.lowerBound)
+        let first = blocks[block]
+        if lower + range.count <= first.endIndex {
+            return first[lower..<(lower + range.count)]
+        }
+        var out = Data(capacity: range.count)
+        out.append(first[lower...])
+        var needed = range.count - (first.endIndex - lower)
+        var next = block + 1
+        while needed > 0 {
+            let data = blocks[next]
+            let take = Swift.min(needed, data.count)
+            out.append(data[data.startIndex..<(data.startIndex + take)])
+            needed -= take
+            next += 1
+        }
+        return out
     }
 
-    /// 0-relative range of the first occurrence of `pattern` at or after `start` (clamped).
-    /// Incremental scans must overlap by `pattern.count - 1` to catch straddling matches.
-    func range(of pattern: Data, from start: Int = 0) -> Range<Int>? {
-        let s = storage.startIndex + offset
-        let clamped = Swift.max(0, Swift.min(start, count))
-        guard let r = storage.range(of: pattern, in: (s + clamped)..<storage.endIndex) else {
-            return nil
-        }
-        return (r.lowerBound - s)..<(r.upperBound - s)
+    /// Up to `n` leading bytes that are contiguous in memory, without copying. May return fewer
+    /// than `n` when the front block ends first; empty only when the buffer is.
+    func peekContiguous(upTo n: Int) -> Data {
+        guard count > 0, n > 0 else { return Data() }
+        let first = blocks[head]
+        let start = first.startIndex + headOffset
+        return first[start..<Swift.min(first.endIndex, start + n)]
     }
 
     /// Index of the CR in the first CRLF at or after `start` (clamped).
     /// Incremental scans pass the prior `count - 1` to catch a straddling CRLF.
     func firstCRLF(from start: Int = 0) -> Int? {
-        guard count >= 2 else { return nil }
-        var i = Swift.max(0, Swift.min(start, count))
-        let last = count - 1
-        while i < last {
-            if self[i] == 0x0D, self[i + 1] == 0x0A {
-                return i
-            }
-            i += 1
-        }
-        return nil
+        firstCR(followedBy: [0x0A], from: start)
+    }
+
+    /// Index of the first CRLF CRLF head terminator at or after `start` (clamped).
+    /// Incremental scans overlap the prior count by 3 to catch a straddling terminator.
+    func firstHeadTerminator(from start: Int = 0) -> Int? {
+        firstCR(followedBy: [0x0A, 0x0D, 0x0A], from: start)
     }
 
     mutating func append(_ other: Data) {
-        compactIfNeeded()
-        storage.append(other)
+        guard !other.isEmpty else { return }
+        count += other.count
+        if other.count < Self.coalesceBytes, blocks.count > head,
+           blocks[blocks.count - 1].count < Self.coalesceBytes * 4 {
+            blocks[blocks.count - 1].append(other)
+            return
+        }
+        blocks.append(other)
     }
 
     mutating func removeFirst(_ n: Int) {
-        // Overshoot past count is tolerated — the reset below clamps to empty.
-        offset += n
-        if offset >= storage.count {
-            storage.removeAll(keepingCapacity: true)
-            offset = 0
+        // Overshoot past count is tolerated — it clamps to empty.
+        guard n < count else {
+            removeAll(keepingCapacity: true)
+            return
+        }
+        count -= n
+        var left = n
+        while left > 0 {
+            let available = blocks[head].count - headOffset
+            if left < available {
+                headOffset += left
+                break
+            }
+            left -= available
+            blocks[head] = Data()
+            head += 1
+            headOffset = 0
+        }
+        if head * 2 >= blocks.count {
+            blocks.removeFirst(head)
+            head = 0
         }
     }
 
     mutating func removeAll(keepingCapacity: Bool = false) {
-        storage.removeAll(keepingCapacity: keepingCapacity)
-        offset = 0
+        blocks.removeAll(keepingCapacity: keepingCapacity)
+        head = 0
+        headOffset = 0
+        count = 0
+    }
+
+    // MARK: - Private
+
+    /// Block index and `Data` index of visible byte `i`.
+    private func locate(_ i: Int) -> (block: Int, index: Data.Index) {
+        var block = head
+        var local = headOffset + i
+        while local >= blocks[block].count {
+            local -= blocks[block].count
+            block += 1
+        }
+        return (block, blocks[block].startIndex + local)
+    }
+
+    /// memchr hops CR to CR within each block (libc vectorizes it); only candidates are compared
+    /// against `tail`, which may straddle into the next block.
+    private func firstCR(followedBy tail: [UInt8], from start: Int) -> Int? {
+        let clamped = Swift.max(0, Swift.min(start, count))
+        guard count - clamped > tail.count else { return nil }
+        // Exclusive bound on the CR's position: the whole tail must be buffered behind it.
+        let lastCandidate = count - tail.count
+        var base = 0
+        var block = head
+        while block < blocks.count, base < lastCandidate {
+            let data = blocks[block]
+            let skip = block == head ? headOffset : 0
+            let blockEnd = base + data.count - skip
+            let from = Swift.max(clamped, base)
+            let to = Swift.min(blockEnd, lastCandidate)
+            if from < to {
+                let hit = data.withUnsafeBytes { (raw: UnsafeRawBufferPointer) -> Int? in
+                    guard let visible = raw.baseAddress?.advanced(by: skip) else { return nil }
+                    var i = from - base
+                    let end = to - base
+                    while i < end {
+                        guard let found = memchr(visible + i, 0x0D, end - i) else { return nil }
+                        let cr = visible.distance(to: UnsafeRawPointer(found))
+                        if matches(tail, after: base + cr) { return base + cr }
+                        i = cr + 1
+                    }
+                    return nil
+                }
+                if let hit { return hit }
+            }
+            base = blockEnd
+            block += 1
+        }
+        return nil
     }
 
-    private mutating func compactIfNeeded() {
-        guard offset > 0 else { return }
-        if offset >= Self.compactAbsoluteThreshold || offset * 2 > storage.count {
-            storage = storage.subdata(in: (storage.startIndex + offset)..<storage.endIndex)
-            offset = 0
+    private func matches(_ tail: [UInt8], after position: Int) -> Bool {
+        for (k, byte) in tail.enumerated() where self[position + 1 + k] != byte {
+            return false
         }
+        return true
     }
 }
@@ -35,6 +35,9 @@ final class MITMHTTP1Stream {
     /// line is a remote memory DoS; on exceed the framing is treated as malformed.
     fileprivate static let maxChunkLineBytes: Int = 16 * 1024
 
+    /// Frame size when native body rules stream a long chunk or a Content-Length body.
+    private static let nativeStreamSliceBytes: Int = 64 * 1024
+
     /// Memory cap on `Anywhere.respond` bodies; oversized bodies are truncated
     /// rather than rejected — a partial mock beats a dropped one.
     private static let maxSynthesizedResponseBodyBytes: Int = MITMBodyCodec.maxBufferedBodyBytes
@@ -143,6 +146,8 @@ final class MITMHTTP1Stream {
         /// Per-chunk cap overflow: bypass the script and forward the remaining
         /// `left` bytes of this chunk verbatim.
         case bypassRemainder(left: Int, accumulator: Data)
+        /// Last frame of a re-chunked Content-Length body: emit the terminator and end the message.
+        case finalThenDone
     }
 
     private enum StreamingChunkedInner {
@@ -151,6 +156,9 @@ final class MITMHTTP1Stream {
         case dataCRLF
         /// After the zero-size line: drain trailer lines until the empty-line terminator.
         case trailerOrEnd
+        /// Native streaming rewrite of a Content-Length body, re-emitted chunked; `accumulator`
+        /// fills to one slice before it becomes a frame.
+        case lengthData(remaining: Int, accumulator: Data)
     }
 
     private enum Mode {
@@ -247,6 +255,10 @@ final class MITMHTTP1Stream {
             completion(data)
             return
         }
+        if let spliced = spliceForwardedBody(data) {
+            completion(spliced)
+            return
+        }
         rxBuffer.append(data)
         parkedCompletion = completion
         var output = Data()
@@ -254,6 +266,27 @@ final class MITMHTTP1Stream {
         finishDrivePass(output)
     }
 
+    /// Fast path for bodies the head evaluation left unrewritten: when `data` lies wholly inside
+    /// the declared length or the current chunk's payload, hand it straight back without copying
+    /// it through `rxBuffer` and the drive loop. Nil when the read touches framing or any other state.
+    private func spliceForwardedBody(_ data: Data) -> Data? {
+        guard responseIRSink == nil, rxBuffer.isEmpty, !data.isEmpty else { return nil }
+        switch mode {
+        case .forwardingLength(let remaining) where data.count < remaining:
+            mode = .forwardingLength(remaining: remaining - data.count)
+            return data
+        case .forwardingLength(let remaining) where data.count == remaining:
+            var output = data
+            flushSynthAfterResponse(into: &output)
+            mode = .awaitingHead
+            return output
+        case .forwardingChunked(let reader) where reader.skipChunkData(data.count):
+            return data
+        default:
+            return nil
+        }
+    }
+
     /// Fires the stashed completion, or holds `output` while a script hop is outstanding.
     private func finishDrivePass(_ output: Data) {
         if case .awaitingScript = mode {
@@ -440,10 +473,8 @@ final class MITMHTTP1Stream {
     /// Scans for CRLF CRLF, parses the head, applies rewrites, and enters the
     /// appropriate body mode.
     private func consumeHead(into output: inout Data) -> Bool {
-        let crlfcrlf = Data([0x0D, 0x0A, 0x0D, 0x0A])
         // Overlap the scanned prefix by 3 bytes so a straddling CRLF CRLF is found.
-        let searchFrom = max(0, headScanned - (crlfcrlf.count - 1))
-        guard let terminator = rxBuffer.range(of: crlfcrlf, from: searchFrom) else {
+        guard let terminator = rxBuffer.firstHeadTerminator(from: max(0, headScanned - 3)) else {
             if rxBuffer.count > Self.maxHeadBytes {
                 // An over-cap head with no CRLF CRLF (giant headers, or bare-LF framing we never
                 // terminate) would skip every parseHead smuggling check if relayed verbatim. Fail
@@ -460,7 +491,7 @@ final class MITMHTTP1Stream {
             return false
         }
         headScanned = 0
-        let headEnd = terminator.upperBound
+        let headEnd = terminator + 4
         let headData = rxBuffer.subdata(in: 0..<headEnd)
         rxBuffer.removeFirst(headEnd)
 
@@ -708,6 +739,23 @@ final class MITMHTTP1Stream {
         // Opt out of buffering up front when length exceeds the cap — keeps
         // large downloads out of the accumulator.
         let codec = MITMBodyCodec.plan(for: combinedHeaderValue(rewrittenHeaders, name: "content-encoding"))
+
+        // Native-only body rules stream at any length. Re-framing as chunked is limited to HTTP/1.1
+        // responses: a request's origin may not accept a chunked body.
+        if buffersBody, length > 0, phase == .httpResponse, responseIRSink == nil,
+           startLineIsHTTP11(rewrittenStartLine),
+           let rewriter = MITMStreamingBodyRewriter.make(rules: rules, requestURL: requestURL, codec: codec, host: host) {
+            enterNativeStreaming(
+                rewrittenStartLine: rewrittenStartLine,
+                rewrittenHeaders: rewrittenHeaders,
+                codec: codec,
+                rewriter: rewriter,
+                originatingRequest: originatingRequest,
+                inner: .lengthData(remaining: length, accumulator: Data()),
+                into: &output
+            )
+            return true
+        }
         let canRewrite = buffersBody && codec.supported && length <= MITMBodyCodec.maxBufferedBodyBytes
 
         if canRewrite {
@@ -773,6 +821,19 @@ final class MITMHTTP1Stream {
         }
 
         let codec = MITMBodyCodec.plan(for: combinedHeaderValue(rewrittenHeaders, name: "content-encoding"))
+        if buffersBody, responseIRSink == nil,
+           let rewriter = MITMStreamingBodyRewriter.make(rules: rules, requestURL: requestURL, codec: codec, host: host) {
+            enterNativeStreaming(
+                rewrittenStartLine: rewrittenStartLine,
+                rewrittenHeaders: rewrittenHeaders,
+                codec: codec,
+                rewriter: rewriter,
+                originatingRequest: originatingRequest,
+                inner: .sizeLine,
+                into: &output
+            )
+            return true
+        }
         if buffersBody, codec.supported {
             warnIfBufferedScriptDeStreams(rewrittenHeaders)
             let headers = handleExpectContinue(startLine: rewrittenStartLine, headers: rewrittenHeaders)
@@ -796,6 +857,35 @@ final class MITMHTTP1Stream {
         return true
     }
 
+    /// Native body rules without a script: the head goes out now, chunked and identity-coded, and
+    /// each frame is rewritten on the script queue through the streaming-frame path, so memory
+    /// and time-to-first-byte stay per chunk instead of per body.
+    private func enterNativeStreaming(
+        rewrittenStartLine: String,
+        rewrittenHeaders: [Header],
+        codec: MITMBodyCodec.Plan,
+        rewriter: MITMStreamingBodyRewriter,
+        originatingRequest: MITMRequestLog.Record?,
+        inner: StreamingChunkedInner,
+        into output: inout Data
+    ) {
+        var headers = strippedFramingHeaders(rewrittenHeaders, dropContentEncoding: codec.requiresDecompression)
+        headers.append((name: "Transfer-Encoding", value: "chunked"))
+        if phase == .httpRequest {
+            logRequest(startLine: rewrittenStartLine)
+        }
+        output.append(serializeHead(startLine: rewrittenStartLine, headers: headers))
+        let cursor = MITMScriptTransform.FrameCursor()
+        cursor.nativeRewriter = rewriter
+        let streaming = StreamingState(
+            headers: headers,
+            originatingRequest: originatingRequest,
+            startLine: rewrittenStartLine,
+            cursor: cursor
+        )
+        mode = .streamingChunked(streaming: streaming, inner: inner)
+    }
+
     /// `Expect: 100-continue` while the head is withheld: the upstream can't send
     /// the 100 yet, so synthesize it and strip `Expect` to avoid a duplicate.
     private func handleExpectContinue(startLine: String, headers: [Header]) -> [Header] {
@@ -816,8 +906,9 @@ final class MITMHTTP1Stream {
 
     private func forwardLength(remaining: Int, into output: inout Data) -> Bool {
         guard !rxBuffer.isEmpty else { return false }
-        let take = min(remaining, rxBuffer.count)
-        let slice = Data(rxBuffer.prefix(take))
+        // One block at a time, uncopied; the drive loop comes back for the rest.
+        let slice = rxBuffer.peekContiguous(upTo: remaining)
+        let take = slice.count
         rxBuffer.removeFirst(take)
         let left = remaining - take
         if !emitBridgeBody(slice, endStream: left == 0) {
@@ -1030,6 +1121,25 @@ final class MITMHTTP1Stream {
                 accumulator.append(rxBuffer.prefix(take))
                 rxBuffer.removeFirst(take)
                 let left = remaining - take
+                // Native rules don't need the sender's chunk boundaries: a long chunk goes over in slices.
+                if left != 0, streaming.cursor.nativeRewriter != nil,
+                   accumulator.count >= Self.nativeStreamSliceBytes {
+                    let next: StreamingChunkedInner = .chunkData(remaining: left, accumulator: Data())
+                    if let held = streaming.pendingChunk {
+                        if emitOrParkStreamingFrame(
+                            streaming: &streaming,
+                            chunk: held,
+                            isLast: false,
+                            postFrame: .hold(nextPending: accumulator, inner: next),
+                            into: &output
+                        ) {
+                            return false // parked
+                        }
+                    }
+                    streaming.pendingChunk = accumulator
+                    currentInner = next
+                    continue
+                }
                 // A declared chunk size can be Int.max; on overflow flush the held
                 // chunk, bypass the script, and emit the remainder verbatim.
                 if left != 0, accumulator.count > MITMBodyCodec.maxBufferedBodyBytes {
@@ -1121,6 +1231,55 @@ final class MITMHTTP1Stream {
                     mode = .awaitingHead
                     return true
                 }
+            case .lengthData(let remaining, var accumulator):
+                guard !rxBuffer.isEmpty else {
+                    mode = .streamingChunked(
+                        streaming: streaming,
+                        inner: .lengthData(remaining: remaining, accumulator: accumulator)
+                    )
+                    return false
+                }
+                let take = min(remaining, rxBuffer.count, Self.nativeStreamSliceBytes - accumulator.count)
+                accumulator.append(rxBuffer.prefix(take))
+                rxBuffer.removeFirst(take)
+                let left = remaining - take
+                if left == 0 {
+                    // Body complete: the held slice and this one go out as the last frame.
+                    var finalChunk = streaming.pendingChunk ?? Data()
+                    streaming.pendingChunk = nil
+                    finalChunk.append(accumulator)
+                    if emitOrParkStreamingFrame(
+                        streaming: &streaming,
+                        chunk: finalChunk,
+                        isLast: true,
+                        postFrame: .finalThenDone,
+                        into: &output
+                    ) {
+                        return false // parked
+                    }
+                    output.append(contentsOf: "0\r\n\r\n".utf8)
+                    flushSynthAfterResponse(into: &output)
+                    mode = .awaitingHead
+                    return true
+                }
+                if accumulator.count >= Self.nativeStreamSliceBytes {
+                    let next: StreamingChunkedInner = .lengthData(remaining: left, accumulator: Data())
+                    if let held = streaming.pendingChunk {
+                        if emitOrParkStreamingFrame(
+                            streaming: &streaming,
+                            chunk: held,
+                            isLast: false,
+                            postFrame: .hold(nextPending: accumulator, inner: next),
+                            into: &output
+                        ) {
+                            return false // parked
+                        }
+                    }
+                    streaming.pendingChunk = accumulator
+                    currentInner = next
+                } else {
+                    currentInner = .lengthData(remaining: left, accumulator: accumulator)
+                }
             }
         }
     }
@@ -1184,6 +1343,15 @@ final class MITMHTTP1Stream {
         if !result.body.isEmpty {
             appendChunk(result.body, into: &resumed)
         }
+        if result.failed {
+            // The head already dropped Content-Encoding; nothing left can be forwarded as-is.
+            logger.warning("HTTP/1 \(host): streaming body decode failed; closing the connection")
+            rxBuffer.removeAll(keepingCapacity: false)
+            mode = .draining
+            onHardClose?()
+            finishDrivePass(resumed)
+            return
+        }
         switch postFrame {
         case .hold(let nextPending, let inner):
             streaming.pendingChunk = nextPending
@@ -1198,6 +1366,10 @@ final class MITMHTTP1Stream {
                 streaming: streaming,
                 inner: .chunkData(remaining: left, accumulator: Data())
             )
+        case .finalThenDone:
+            resumed.append(contentsOf: "0\r\n\r\n".utf8)
+            flushSynthAfterResponse(into: &resumed)
+            mode = .awaitingHead
         }
         while drive(into: &resumed) { }
         finishDrivePass(resumed)
@@ -1562,13 +1734,16 @@ final class MITMHTTP1Stream {
     }
 
     private func parseHead(_ data: Data) -> ParsedHeadResult {
+        // Parsed on bytes: lines are found with memchr, fields are sliced and trimmed in place,
+        // and CL/TE are recognized without building Strings. Each field becomes a String once, as
         // ISO-8859-1, not ASCII: HTTP/1 header octets are a byte string (RFC 9110 §5.5 obs-text), and
         // latin-1 maps every byte 1:1 so it never fails (ASCII would reject any byte > 0x7F, common in
         // real Set-Cookie / Content-Disposition / Server fields). `serializeHead` re-emits these via
         // `HTTPHeader.appendFieldBytes`, so the original octets round-trip exactly.
-        guard let raw = String(data: data, encoding: .isoLatin1) else { return .forward }
-        let lines = raw.components(separatedBy: "\r\n")
-        guard let startLine = lines.first, !startLine.isEmpty else { return .forward }
+        let bytes = [UInt8](data)
+        let lines = Self.crlfLines(bytes)
+        guard let startBytes = lines.first, !startBytes.isEmpty else { return .forward }
+        let startLine = Self.latin1String(startBytes)
         guard isHTTPStartLine(startLine) else {
             // Not a head Anywhere rewrites (some other `HTTP/<d>.<d>` version). Forward it verbatim if
             // it still parses as a valid start-line grammar; fail closed only on a true non-HTTP or
@@ -1578,7 +1753,7 @@ final class MITMHTTP1Stream {
         // RFC 9112 §2.2: a lone CR/LF in the start line would split into a smuggled header on
         // re-emission. NUL / other control / DEL bytes are not a line-splitting vector here, so they
         // forward verbatim (rejecting them would diverge from the endpoint parser).
-        if Self.containsCRorLF(startLine) { return .smuggling }
+        if Self.containsCRorLF(startBytes) { return .smuggling }
         // Validate the start-line grammar (request-line: `method SP target SP version` tokenized on
         // whitespace runs, so a target with SP yields ≠3 tokens and is rejected; status-line needs
         // an HTTP/d.d version and integer status).
@@ -1590,40 +1765,42 @@ final class MITMHTTP1Stream {
         // RFC 9112 §5.2 / RFC 7230 §3.2.4: obs-fold is deprecated. Unfold it (append each
         // continuation to the prior field value with a single SP) and validate the result, so a
         // value split across a fold can't skip the CL/TE smuggling checks below.
-        var headerLines: [String] = []
+        var headerLines: [ArraySlice<UInt8>] = []
+        headerLines.reserveCapacity(lines.count)
         for line in lines.dropFirst() {
-            if line.isEmpty { continue }
-            if let first = line.utf8.first, first == 0x20 || first == 0x09 {
-                guard !headerLines.isEmpty else { return .smuggling } // continuation with no field
-                let continuation = line.drop { $0 == " " || $0 == "\t" }
-                headerLines[headerLines.count - 1] += " " + String(continuation)
+            guard let first = line.first else { continue }
+            if first == 0x20 || first == 0x09 {
+                guard let previous = headerLines.last else { return .smuggling } // continuation with no field
+                var unfolded = Array(previous)
+                unfolded.append(0x20)
+                unfolded.append(contentsOf: line.drop { $0 == 0x20 || $0 == 0x09 })
+                headerLines[headerLines.count - 1] = unfolded[...]
                 continue
             }
             headerLines.append(line)
         }
         var headers: [Header] = []
-        var contentLengthValues: [String] = []
+        headers.reserveCapacity(headerLines.count)
+        var contentLengthValues: [ArraySlice<UInt8>] = []
         var transferEncodingValues: [String] = []
         for line in headerLines {
             // RFC 9112 §5.1 / RFC 9110 §5.6: a header field with no colon is malformed; fail closed
             // rather than forwarding it.
-            guard let colon = line.firstIndex(of: ":") else { return .smuggling }
-            let name = String(line[..<colon])
-            let value = String(line[line.index(after: colon)...])
-                .trimmingCharacters(in: CharacterSet.whitespaces)
+            guard let colon = line.firstIndex(of: 0x3A) else { return .smuggling }
+            let nameBytes = line[..<colon]
+            let valueBytes = Self.trimmedFieldValue(line[(colon + 1)...])
             // RFC 9110 §5.6.2: SP/CTL in a field-name is the classic obfuscated-TE smuggle.
-            guard HTTPHeader.isValidName(name) else { return .smuggling }
+            guard Self.isTokenBytes(nameBytes) else { return .smuggling }
             // CR/LF in a field-value would split the line on re-emission (request/response splitting).
             // NUL / other control bytes are not a splitting vector here and pass through verbatim.
-            if Self.containsCRorLF(value) { return .smuggling }
-            if ASCII.equalsIgnoringCase(name, "content-length") {
-                contentLengthValues.append(
-                    value.trimmingCharacters(in: CharacterSet.whitespaces)
-                )
-            } else if ASCII.equalsIgnoringCase(name, "transfer-encoding") {
+            if Self.containsCRorLF(valueBytes) { return .smuggling }
+            let value = Self.latin1String(valueBytes)
+            if Self.bytesEqualIgnoringCase(nameBytes, "content-length") {
+                contentLengthValues.append(valueBytes)
+            } else if Self.bytesEqualIgnoringCase(nameBytes, "transfer-encoding") {
                 transferEncodingValues.append(value)
             }
-            headers.append((name: name, value: value))
+            headers.append((name: Self.latin1String(nameBytes), value: value))
         }
         // Reject any Content-Length that isn't a clean decimal (`NaN`, `-1`, `007`, comma-joined
         // `5, 5` are all framing-confusion vectors).
@@ -1671,9 +1848,12 @@ final class MITMHTTP1Stream {
     /// octal/decimal split-interpretation smuggle). No upper bound; `bodyFraming` clamps an
     /// over-`Int64` value to `Int.max`. Shared by `parseHead` and `bodyFraming` so they can't drift.
     static func isCleanContentLength(_ trimmed: String) -> Bool {
-        guard !trimmed.isEmpty, trimmed.allSatisfy({ $0.isASCII && $0.isNumber }) else { return false }
-        if trimmed.count > 1, trimmed.first == "0" { return false }
-        return true
+        isCleanContentLength(trimmed.utf8)
+    }
+
+    static func isCleanContentLength<Bytes: Collection>(_ trimmed: Bytes) -> Bool where Bytes.Element == UInt8 {
+        guard let first = trimmed.first, trimmed.allSatisfy({ $0 >= 0x30 && $0 <= 0x39 }) else { return false }
+        return first != 0x30 || trimmed.count == 1
     }
 
     /// True when the start line declares HTTP/1.1 — a request line ends with the version, a status
@@ -1685,11 +1865,8 @@ final class MITMHTTP1Stream {
     /// True when `chunked` is the final Transfer-Encoding coding (RFC 9112 §6.1).
     /// Shared by `parseHead` and `bodyFraming` so their decisions can't diverge.
     static func transferEncodingIsChunked(_ value: String) -> Bool {
-        let last = value
-            .split(separator: ",", omittingEmptySubsequences: false)
-            .last?
-            .trimmingCharacters(in: CharacterSet.whitespaces)
-        return last.map { ASCII.equalsIgnoringCase($0, "chunked") } == true
+        let lastCoding = value.lastIndex(of: ",").map { value[value.index(after: $0)...] } ?? value[...]
+        return ASCII.equalsIgnoringCase(lastCoding.trimmingCharacters(in: CharacterSet.whitespaces), "chunked")
     }
 
     /// Returns the normalized Transfer-Encoding (lowercased, whitespace around commas removed) iff it is
@@ -1754,6 +1931,76 @@ final class MITMHTTP1Stream {
         return false
     }
 
+    private static func containsCRorLF(_ bytes: ArraySlice<UInt8>) -> Bool {
+        bytes.contains { $0 == 0x0D || $0 == 0x0A }
+    }
+
+    /// Splits a head on CRLF (a lone CR or LF stays inside its line for the splitting checks).
+    /// memchr finds each CR, so the scan runs at libc's vectorized speed.
+    private static func crlfLines(_ bytes: [UInt8]) -> [ArraySlice<UInt8>] {
+        var lines: [ArraySlice<UInt8>] = []
+        bytes.withUnsafeBytes { raw in
+            guard let base = raw.baseAddress else { return }
+            var lineStart = 0
+            var searchFrom = 0
+            while searchFrom < raw.count,
+                  let hit = memchr(base + searchFrom, 0x0D, raw.count - searchFrom) {
+                let cr = base.distance(to: UnsafeRawPointer(hit))
+                guard cr + 1 < raw.count else { break }
+                if raw[cr + 1] == 0x0A {
+                    lines.append(bytes[lineStart..<cr])
+                    lineStart = cr + 2
+                    searchFrom = lineStart
+                } else {
+                    searchFrom = cr + 1
+                }
+            }
+            if lineStart < raw.count { lines.append(bytes[lineStart...]) }
+        }
+        return lines
+    }
+
+    /// OWS trim, plus 0xA0 (latin-1 NBSP): the set `CharacterSet.whitespaces` strips from a
+    /// latin-1 decoded value, so trimming on bytes keeps the same field values.
+    private static func trimmedFieldValue(_ bytes: ArraySlice<UInt8>) -> ArraySlice<UInt8> {
+        let isTrimmed: (UInt8) -> Bool = { $0 == 0x20 || $0 == 0x09 || $0 == 0xA0 }
+        guard let first = bytes.firstIndex(where: { !isTrimmed($0) }),
+              let last = bytes.lastIndex(where: { !isTrimmed($0) }) else { return bytes[bytes.endIndex...] }
+        return bytes[first...last]
+    }
+
+    /// `HTTPHeader.isValidName` on raw bytes (RFC 9110 token).
+    private static func isTokenBytes(_ bytes: ArraySlice<UInt8>) -> Bool {
+        guard !bytes.isEmpty else { return false }
+        return bytes.allSatisfy { byte in
+            switch byte {
+            case 0x21, 0x23, 0x24, 0x25, 0x26, 0x27, 0x2A, 0x2B, 0x2D, 0x2E, 0x5E, 0x5F, 0x60, 0x7C, 0x7E,
+                 0x30...0x39, 0x41...0x5A, 0x61...0x7A:
+                return true
+            default:
+                return false
+            }
+        }
+    }
+
+    /// ASCII case-insensitive match of a field name against a lowercase literal.
+    private static func bytesEqualIgnoringCase(_ bytes: ArraySlice<UInt8>, _ lowercase: StaticString) -> Bool {
+        guard bytes.count == lowercase.utf8CodeUnitCount else { return false }
+        return lowercase.withUTF8Buffer { literal in
+            zip(bytes, literal).allSatisfy { byte, expected in
+                (byte >= 0x41 && byte <= 0x5A ? byte | 0x20 : byte) == expected
+            }
+        }
+    }
+
+    /// ISO-8859-1 decode: ASCII takes the UTF-8 fast path, other bytes map 1:1 to U+0000–U+00FF.
+    private static func latin1String(_ bytes: ArraySlice<UInt8>) -> String {
+        if bytes.allSatisfy({ $0 < 0x80 }) {
+            return String(decoding: bytes, as: UTF8.self)
+        }
+        return String(decoding: bytes.map { UInt16($0) }, as: UTF16.self)
+    }
+
     private func isHTTPStartLine(_ line: String) -> Bool {
         if line.hasPrefix("HTTP/1.") { return true }
         // Method must be a valid RFC 9110 §9.1 token — the version suffix alone
@@ -2259,6 +2506,14 @@ private final class ChunkedReader {
         case malformed
     }
 
+    /// Advances past `count` payload bytes the caller forwarded itself; false (state untouched)
+    /// unless they fall strictly inside the current chunk, so the next byte is still payload.
+    func skipChunkData(_ count: Int) -> Bool {
+        guard case .chunkData(let remaining, let originalSize) = state, count < remaining else { return false }
+        state = .chunkData(remaining: remaining - count, originalSize: originalSize)
+        return true
+    }
+
     func consumeForward(_ buffer: inout MITMByteBuffer, into output: inout Data) -> ForwardResult {
         while !buffer.isEmpty {
             switch state {
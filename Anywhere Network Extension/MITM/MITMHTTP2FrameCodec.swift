@@ -68,7 +68,8 @@ enum MITMHTTP2FrameCodec {
         case error
     }
 
-    /// Reads one complete frame, consuming its bytes. `.needMore` when incomplete.
+    /// Reads one complete frame, consuming its bytes. `.needMore` when incomplete. The payload is a
+    /// zero-copy slice of the receive block unless the frame straddles blocks.
     static func parseFrame(from buffer: inout MITMByteBuffer) -> ParseResult {
         guard buffer.count >= 9 else { return .needMore }
         let length = (Int(buffer[0]) << 16) | (Int(buffer[1]) << 8) | Int(buffer[2])
@@ -107,6 +108,13 @@ enum MITMHTTP2FrameCodec {
     /// Emits a HEADERS frame plus CONTINUATIONs as needed (RFC 9113 §6.2/§6.10);
     /// END_HEADERS on the final frame, END_STREAM on the first.
     static func emitHeaders(streamID: UInt32, block: Data, endStream: Bool) -> Data {
+        var out = Data(capacity: 9 + block.count + 16)
+        appendHeaders(streamID: streamID, block: block, endStream: endStream, into: &out)
+        return out
+    }
+
+    /// `emitHeaders` written onto `out`, so a pass can batch many frames into one write.
+    static func appendHeaders(streamID: UInt32, block: Data, endStream: Bool, into out: inout Data) {
         let firstChunkSize = min(block.count, maxFramePayloadSize)
         let firstChunkEnd = block.startIndex + firstChunkSize
         let needsContinuation = firstChunkEnd < block.endIndex
@@ -115,7 +123,6 @@ enum MITMHTTP2FrameCodec {
         if !needsContinuation { firstFlags |= 0x4 } // END_HEADERS
         if endStream { firstFlags |= 0x1 }          // END_STREAM
 
-        var out = Data(capacity: 9 + block.count + 16)
         appendFrameHeader(
             typeCode: FrameType.headers,
             flags: firstFlags,
@@ -139,14 +146,20 @@ enum MITMHTTP2FrameCodec {
             out.append(block[offset..<end])
             offset = end
         }
-        return out
     }
 
     /// Pure DATA framing (no flow-control accounting); an empty payload still yields
     /// one zero-length DATA so END_STREAM survives.
     static func frameData(streamID: UInt32, payload: Data, endStream: Bool) -> Data {
+        let frameCount = max(1, (payload.count + maxFramePayloadSize - 1) / maxFramePayloadSize)
+        var out = Data(capacity: payload.count + frameCount * 9)
+        appendData(streamID: streamID, payload: payload, endStream: endStream, into: &out)
+        return out
+    }
+
+    /// `frameData` written onto `out`.
+    static func appendData(streamID: UInt32, payload: Data, endStream: Bool, into out: inout Data) {
         if payload.isEmpty {
-            var out = Data(capacity: 9)
             appendFrameHeader(
                 typeCode: FrameType.data,
                 flags: endStream ? 0x1 : 0,
@@ -154,10 +167,8 @@ enum MITMHTTP2FrameCodec {
                 payloadLength: 0,
                 into: &out
             )
-            return out
+            return
         }
-        let frameCount = (payload.count + maxFramePayloadSize - 1) / maxFramePayloadSize
-        var out = Data(capacity: payload.count + frameCount * 9)
         var offset = payload.startIndex
         while offset < payload.endIndex {
             let end = min(payload.endIndex, offset + maxFramePayloadSize)
@@ -172,7 +183,6 @@ enum MITMHTTP2FrameCodec {
             out.append(payload[offset..<end])
             offset = end
         }
-        return out
     }
 
     // MARK: Control frames
@@ -180,43 +190,66 @@ enum MITMHTTP2FrameCodec {
     /// A SETTINGS ACK (RFC 9113 §6.5.3) for the client's SETTINGS.
     static func settingsAck() -> Data {
         var d = Data()
-        appendFrameHeader(typeCode: FrameType.settings, flags: 0x1, streamID: 0, payloadLength: 0, into: &d)
+        appendSettingsAck(into: &d)
         return d
     }
 
+    static func appendSettingsAck(into out: inout Data) {
+        appendFrameHeader(typeCode: FrameType.settings, flags: 0x1, streamID: 0, payloadLength: 0, into: &out)
+    }
+
     /// A PING ACK echoing the 8 opaque octets (RFC 9113 §6.7).
     static func pingAck(opaque: Data) -> Data {
         var d = Data()
-        let body = opaque.count == 8 ? opaque : Data(count: 8)
-        appendFrameHeader(typeCode: FrameType.ping, flags: 0x1, streamID: 0, payloadLength: 8, into: &d)
-        d.append(body)
+        appendPingAck(opaque: opaque, into: &d)
         return d
     }
 
+    static func appendPingAck(opaque: Data, into out: inout Data) {
+        appendFrameHeader(typeCode: FrameType.ping, flags: 0x1, streamID: 0, payloadLength: 8, into: &out)
+        if opaque.count == 8 {
+            out.append(opaque)
+        } else {
+            out.append(contentsOf: [UInt8](repeating: 0, count: 8))
+        }
+    }
+
     static func windowUpdate(streamID: UInt32, increment: Int) -> Data {
         var d = Data()
-        appendFrameHeader(typeCode: FrameType.windowUpdate, flags: 0, streamID: streamID, payloadLength: 4, into: &d)
-        HTTP2FrameWire.appendUInt32(UInt32(truncatingIfNeeded: increment) & 0x7FFF_FFFF, into: &d)
+        appendWindowUpdate(streamID: streamID, increment: increment, into: &d)
         return d
     }
 
+    static func appendWindowUpdate(streamID: UInt32, increment: Int, into out: inout Data) {
+        appendFrameHeader(typeCode: FrameType.windowUpdate, flags: 0, streamID: streamID, payloadLength: 4, into: &out)
+        HTTP2FrameWire.appendUInt32(UInt32(truncatingIfNeeded: increment) & 0x7FFF_FFFF, into: &out)
+    }
+
     static func rstStream(streamID: UInt32, errorCode: UInt32) -> Data {
         var d = Data()
-        appendFrameHeader(typeCode: FrameType.rstStream, flags: 0, streamID: streamID, payloadLength: 4, into: &d)
-        HTTP2FrameWire.appendUInt32(errorCode, into: &d)
+        appendRSTStream(streamID: streamID, errorCode: errorCode, into: &d)
         return d
     }
 
+    static func appendRSTStream(streamID: UInt32, errorCode: UInt32, into out: inout Data) {
+        appendFrameHeader(typeCode: FrameType.rstStream, flags: 0, streamID: streamID, payloadLength: 4, into: &out)
+        HTTP2FrameWire.appendUInt32(errorCode, into: &out)
+    }
+
     /// A GOAWAY (RFC 9113 §6.8): names the last stream the sender processed so the peer can
     /// safely retry anything above it. Empty debug data.
     static func goAway(lastStreamID: UInt32, errorCode: UInt32) -> Data {
         var d = Data()
-        appendFrameHeader(typeCode: FrameType.goaway, flags: 0, streamID: 0, payloadLength: 8, into: &d)
-        HTTP2FrameWire.appendUInt32(lastStreamID & 0x7FFF_FFFF, into: &d)
-        HTTP2FrameWire.appendUInt32(errorCode, into: &d)
+        appendGoAway(lastStreamID: lastStreamID, errorCode: errorCode, into: &d)
         return d
     }
 
+    static func appendGoAway(lastStreamID: UInt32, errorCode: UInt32, into out: inout Data) {
+        appendFrameHeader(typeCode: FrameType.goaway, flags: 0, streamID: 0, payloadLength: 8, into: &out)
+        HTTP2FrameWire.appendUInt32(lastStreamID & 0x7FFF_FFFF, into: &out)
+        HTTP2FrameWire.appendUInt32(errorCode, into: &out)
+    }
+
     /// Decodes a WINDOW_UPDATE's 31-bit increment (RFC 9113 §6.9.1); nil for a
     /// non-4-byte payload.
     static func windowUpdateIncrement(_ payload: Data) -> Int? {
@@ -225,35 +258,34 @@ enum MITMHTTP2FrameCodec {
     }
 
     // MARK: Padding strippers
+    //
+    // The results are slices of `payload` (shared storage, offset `startIndex`): padding and the
+    // PRIORITY prefix are dropped by narrowing the range, never by copying the body.
 
     /// Strips PADDED + PRIORITY prefixes from a HEADERS payload; nil for invalid padding.
     static func stripHeadersPadding(payload: Data, flags: UInt8) -> Data? {
         var p = payload
         if flags & 0x8 != 0 { // PADDED
-            guard let stripped = stripPadding(&p) else { return nil }
+            guard let stripped = stripPadding(p) else { return nil }
             p = stripped
         }
         if flags & 0x20 != 0 { // PRIORITY
             guard p.count >= 5 else { return nil }
-            p = p.subdata(in: (p.startIndex + 5)..<p.endIndex)
+            p = p[(p.startIndex + 5)...]
         }
         return p
     }
 
     /// Strips PADDED from a DATA payload; nil for invalid padding.
     static func stripDataPadding(payload: Data, flags: UInt8) -> Data? {
-        var p = payload
-        if flags & 0x8 != 0 {
-            guard let stripped = stripPadding(&p) else { return nil }
-            p = stripped
-        }
-        return p
+        guard flags & 0x8 != 0 else { return payload }
+        return stripPadding(payload)
     }
 
-    private static func stripPadding(_ payload: inout Data) -> Data? {
+    private static func stripPadding(_ payload: Data) -> Data? {
         guard !payload.isEmpty else { return nil }
         let padLen = Int(payload[payload.startIndex])
         guard payload.count >= 1 + padLen else { return nil }
-        return payload.subdata(in: (payload.startIndex + 1)..<(payload.endIndex - padLen))
+        return payload[(payload.startIndex + 1)..<(payload.endIndex - padLen)]
     }
 }
@@ -133,7 +133,7 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
         // MAX_CONCURRENT_STREAMS slots leak. Clean completions and origin-initiated closes
         // (RST/GOAWAY) pass false so we don't re-RST a stream already closing.
         if resetOrigin, let sid = ourStreamID[clientID] {
-            onUpstreamBytes?(Codec.rstStream(streamID: sid, errorCode: Codec.ErrorCode.cancel))
+            write { Codec.appendRSTStream(streamID: sid, errorCode: Codec.ErrorCode.cancel, into: &$0) }
         }
         responseStreams.removeValue(forKey: clientID)
         drainCoupledStreams.remove(clientID)
@@ -212,6 +212,11 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
     private var batchedConnCredit = 0
     private var batchedStreamCredit: [UInt32: Int] = [:]
 
+    /// Frames written while a pass is open, sent as one `onUpstreamBytes` when the outermost pass
+    /// closes; outside a pass `write` sends immediately.
+    private var outbox = Data()
+    private var outboxDepth = 0
+
     private static let maxBufferedRewriteGrowthBytes = 65_535
     private static let maxStreamingRewriteGrowthBytes = 65_535
 
@@ -251,6 +256,7 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
         theirStreamID.removeAll()
         batchedConnCredit = 0
         batchedStreamCredit.removeAll()
+        outbox = Data()
         pending = nil
     }
 
@@ -273,11 +279,11 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
         preface.append(contentsOf: [0x00, 0x06, // SETTINGS_MAX_HEADER_LIST_SIZE
                               UInt8((maxHeaderList >> 24) & 0xFF), UInt8((maxHeaderList >> 16) & 0xFF),
                               UInt8((maxHeaderList >> 8) & 0xFF), UInt8(maxHeaderList & 0xFF)])
-        onUpstreamBytes?(preface)
+        write { $0.append(preface) }
         // INITIAL_WINDOW_SIZE doesn't move the connection window (RFC 9113 §6.9.2); raise it
         // explicitly so the connection isn't the ~64 KiB bottleneck. Direct emit (not batched): must
         // reach the origin before any DATA pass, or it throttles the first response to 64 KiB.
-        onUpstreamBytes?(Codec.windowUpdate(streamID: 0, increment: Self.receiveWindow - 65_535))
+        write { Codec.appendWindowUpdate(streamID: 0, increment: Self.receiveWindow - 65_535, into: &$0) }
     }
 
     // MARK: - MITMUpstreamLeg (request IR → upstream h2)
@@ -332,11 +338,12 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
         for (name, value) in head.headers {
             block.append((name: name.lowercased(), value: value))
         }
-        onUpstreamBytes?(Codec.emitHeaders(
+        write { Codec.appendHeaders(
             streamID: sid,
             block: HPACKEncoder.encodeHeaderBlock(block, neverIndexed: head.neverIndexed),
-            endStream: endStream
-        ))
+            endStream: endStream,
+            into: &$0
+        ) }
         if endStream {
             openRequestStreams.remove(clientID)
         } else {
@@ -374,7 +381,7 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
         if let backlog = pendingRequestBodies[clientID]?.remaining.count, backlog > Self.maxUpstreamBufferedBytes {
             logger.warning("h2-upstream \(host) stream \(clientID): request backlog \(backlog) B over cap; resetting stream")
             if let sid = ourStreamID[clientID] {
-                onUpstreamBytes?(Codec.rstStream(streamID: sid, errorCode: Codec.ErrorCode.internalError))
+                write { Codec.appendRSTStream(streamID: sid, errorCode: Codec.ErrorCode.internalError, into: &$0) }
             }
             releaseStream(clientID: clientID)
             sink?.deliverResponseReset(streamID: clientID)
@@ -390,7 +397,7 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
             return
         }
         if openRequestStreams.contains(clientID), let sid = ourStreamID[clientID] {
-            onUpstreamBytes?(Codec.rstStream(streamID: sid, errorCode: Codec.ErrorCode.cancel))
+            write { Codec.appendRSTStream(streamID: sid, errorCode: Codec.ErrorCode.cancel, into: &$0) }
         }
         releaseStream(clientID: clientID)
     }
@@ -431,11 +438,12 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
     /// Emits request trailers as a trailing HEADERS block with END_STREAM (RFC 9113 §8.1).
     private func emitRequestTrailers(sid: UInt32, _ trailers: [(name: String, value: String)]) {
         let block = trailers.map { (name: $0.name.lowercased(), value: $0.value) }
-        onUpstreamBytes?(Codec.emitHeaders(
+        write { Codec.appendHeaders(
             streamID: sid,
             block: HPACKEncoder.encodeHeaderBlock(block),
-            endStream: true
-        ))
+            endStream: true,
+            into: &$0
+        ) }
     }
 
     /// Sends as much of a pending request body as the connection and stream windows allow, up to
@@ -450,8 +458,9 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
             entry.remaining.removeFirst(available)
             let bodyDone = entry.endStream && entry.remaining.isEmpty
             // With trailers pending, END_STREAM rides the trailing HEADERS, not the final DATA.
-            onUpstreamBytes?(Codec.frameData(streamID: sid, payload: chunk,
-                                             endStream: bodyDone && entry.pendingTrailers == nil))
+            write { Codec.appendData(streamID: sid, payload: chunk,
+                                     endStream: bodyDone && entry.pendingTrailers == nil,
+                                     into: &$0) }
             flowController.debitServerConnection(available)
             entry.streamWindow -= available
             if bodyDone {
@@ -464,7 +473,7 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
             if let trailers = entry.pendingTrailers {
                 emitRequestTrailers(sid: sid, trailers)
             } else {
-                onUpstreamBytes?(Codec.frameData(streamID: sid, payload: Data(), endStream: true))
+                write { Codec.appendData(streamID: sid, payload: Data(), endStream: true, into: &$0) }
             }
             pendingRequestBodies.removeValue(forKey: clientID)
             openRequestStreams.remove(clientID)
@@ -506,10 +515,30 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
         if parseError || torn { completion(); return }
         rxBuffer.append(data)
         parkedCompletion = completion
+        beginPass()
         let parked = pump()
         finishPass(parked: parked)
     }
 
+    /// Opens a write batch here and on the sink, so the frames one inbound read produces go out as
+    /// one buffer per direction instead of one write per frame.
+    private func beginPass() {
+        outboxDepth += 1
+        sink?.beginResponseBatch()
+    }
+
+    private func write(_ frames: (inout Data) -> Void) {
+        frames(&outbox)
+        if outboxDepth == 0 { flushOutbox() }
+    }
+
+    private func flushOutbox() {
+        guard !outbox.isEmpty else { return }
+        let bytes = outbox
+        outbox = Data()
+        onUpstreamBytes?(bytes)
+    }
+
     private func pump() -> Bool {
         while true {
             switch Codec.parseFrame(from: &rxBuffer) {
@@ -526,6 +555,9 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
         // Flush every pass (parked or not) so coalesced receive-window credit reaches the origin
         // before it can stall on a depleted window, and never lingers across a script hop.
         flushBatchedCredits()
+        outboxDepth -= 1
+        if outboxDepth == 0 { flushOutbox() }
+        sink?.endResponseBatch()
         if parked { return }
         let completion = parkedCompletion; parkedCompletion = nil; completion?()
     }
@@ -535,18 +567,19 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
     /// harmless (the origin ignores WINDOW_UPDATE on a closed stream, RFC 9113 §5.1).
     private func flushBatchedCredits() {
         if batchedConnCredit > 0 {
-            onUpstreamBytes?(Codec.windowUpdate(streamID: 0, increment: batchedConnCredit))
+            write { Codec.appendWindowUpdate(streamID: 0, increment: batchedConnCredit, into: &$0) }
             batchedConnCredit = 0
         }
         guard !batchedStreamCredit.isEmpty else { return }
         for (sid, n) in batchedStreamCredit where n > 0 {
-            onUpstreamBytes?(Codec.windowUpdate(streamID: sid, increment: n))
+            write { Codec.appendWindowUpdate(streamID: sid, increment: n, into: &$0) }
         }
         batchedStreamCredit.removeAll(keepingCapacity: true)
     }
 
     private func resumeAfterScript() {
         guard !torn, !parseError else { let completion = parkedCompletion; parkedCompletion = nil; completion?(); return }
+        beginPass()
         let parked = pump()
         finishPass(parked: parked)
     }
@@ -572,7 +605,7 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
         case Codec.FrameType.settings:     handleSettings(frame)
         case Codec.FrameType.windowUpdate: handleWindowUpdate(frame)
         case Codec.FrameType.ping:
-            if frame.flags & 0x1 == 0 { onUpstreamBytes?(Codec.pingAck(opaque: frame.payload)) }
+            if frame.flags & 0x1 == 0 { write { Codec.appendPingAck(opaque: frame.payload, into: &$0) } }
         case Codec.FrameType.rstStream:    handleUpstreamRST(frame)
         case Codec.FrameType.goaway:       handleGoAway(frame)
         case Codec.FrameType.pushPromise:
@@ -600,7 +633,7 @@ final class MITMHTTP2UpstreamLeg: MITMUpstreamLeg {
             i += 6
         }
         firstSettingsSeen = true
-        onUpstreamBytes?(Codec.settingsAck())
+        write { Codec.appendSettingsAck(into: &$0) }
         // The limit may have risen; open anything now permitted.
         drainQueue()
     }
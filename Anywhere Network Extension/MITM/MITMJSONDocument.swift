@@ -0,0 +1,615 @@
+//
+//  MITMJSONDocument.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Native JSON document behind `MITMJSONPatch.applyAll`. One pass over the body builds a flat
+/// tape of byte spans; edits land in a sparse overlay that expands only the containers on an
+/// edited path, and serialization copies every untouched span verbatim. Patching one field of a
+/// large feed touches that field's ancestors and nothing else — unedited 64-bit IDs and
+/// high-precision decimals come out exactly as they went in.
+///
+/// Strict RFC 8259 syntax over UTF-8 (string bytes aren't re-validated). Anything else — a BOM,
+/// UTF-16, nesting past `maxDepth` — fails `init`, and the caller falls back to Foundation.
+final class MITMJSONDocument {
+
+    typealias PathSegment = MITMJSONPatch.PathSegment
+
+    /// JSONSerialization's own nesting limit, so both engines accept the same documents.
+    private static let maxDepth = 512
+
+    /// Depth ceiling for walks over the overlay, matching `MITMJSONPatch`'s walkers.
+    private static let maxRecursionDepth = 600
+
+    // MARK: - Tape
+
+    private enum Kind: UInt8 { case object, array, string, number, literal }
+
+    /// One value or object key in document order; an object's children alternate key, value.
+    private struct Entry {
+        var kind: Kind
+        /// The string holds a backslash escape, so it can't be compared as raw bytes.
+        var escaped: Bool
+        /// Byte span of the value, quotes and brackets included.
+        var start: UInt32
+        var end: UInt32
+        /// Tape index just past this entry's subtree.
+        var next: UInt32
+    }
+
+    private let bytes: [UInt8]
+    private var tape: [Entry] = []
+
+    // MARK: - Overlay
+
+    private enum Key {
+        case tape(Int)
+        /// An inserted key, with its serialized (quoted) form.
+        case authored(String, Data)
+    }
+
+    private struct Member {
+        var key: Key
+        var value: Value
+    }
+
+    /// A node of the edited document. `.tape` is an untouched original value; containers are
+    /// expanded into `.object`/`.array` only once an edit lands inside them.
+    private indirect enum Value {
+        case tape(Int)
+        /// A serialized authored scalar.
+        case encoded(Data)
+        case object([Member])
+        case array([Value])
+    }
+
+    /// A member name in both forms: `utf8` compares against unescaped tape keys without decoding.
+    private struct KeyName {
+        let string: String
+        let utf8: [UInt8]
+
+        init(_ string: String) {
+            self.string = string
+            self.utf8 = Array(string.utf8)
+        }
+    }
+
+    private var root: Value = .tape(0)
+
+    /// Nil for empty input or anything that isn't a single strict JSON value.
+    init?(_ data: Data) {
+        guard !data.isEmpty, data.count < Int(UInt32.max) else { return nil }
+        bytes = [UInt8](data)
+        tape.reserveCapacity(bytes.count / 8)
+        guard parse() else { return nil }
+    }
+
+    // MARK: - Parsing
+
+    private enum ParseState {
+        case value
+        case valueOrEnd
+        case keyOrEnd
+        case key
+        case afterValue
+    }
+
+    private func parse() -> Bool {
+        let count = bytes.count
+        var i = 0
+        var stack: [Int] = []
+        var state = ParseState.value
+        while true {
+            while i < count, bytes[i] == 0x20 || bytes[i] == 0x0A || bytes[i] == 0x0D || bytes[i] == 0x09 {
+                i += 1
+            }
+            switch state {
+            case .value, .valueOrEnd:
+                guard i < count else { return false }
+                let c = bytes[i]
+                if state == .valueOrEnd, c == UInt8(ascii: "]") {
+                    close(stack.removeLast(), at: i)
+                    i += 1
+                    state = .afterValue
+                    continue
+                }
+                switch c {
+                case UInt8(ascii: "{"), UInt8(ascii: "["):
+                    guard stack.count < Self.maxDepth else { return false }
+                    stack.append(tape.count)
+                    tape.append(Entry(kind: c == UInt8(ascii: "{") ? .object : .array, escaped: false,
+                                      start: UInt32(i), end: 0, next: 0))
+                    i += 1
+                    state = c == UInt8(ascii: "{") ? .keyOrEnd : .valueOrEnd
+                    continue
+                case UInt8(ascii: "\""):
+                    guard let end = scanString(at: i) else { return false }
+                    i = end
+                case UInt8(ascii: "-"), UInt8(ascii: "0")...UInt8(ascii: "9"):
+                    guard let end = scanNumber(at: i) else { return false }
+                    appendScalar(.number, start: i, end: end)
+                    i = end
+                case UInt8(ascii: "t"), UInt8(ascii: "f"), UInt8(ascii: "n"):
+                    guard let end = scanLiteral(at: i) else { return false }
+                    appendScalar(.literal, start: i, end: end)
+                    i = end
+                default:
+                    return false
+                }
+                state = .afterValue
+            case .keyOrEnd, .key:
+                guard i < count else { return false }
+                if state == .keyOrEnd, bytes[i] == UInt8(ascii: "}") {
+                    close(stack.removeLast(), at: i)
+                    i += 1
+                    state = .afterValue
+                    continue
+                }
+                guard bytes[i] == UInt8(ascii: "\""), let end = scanString(at: i) else { return false }
+                i = end
+                while i < count, bytes[i] == 0x20 || bytes[i] == 0x0A || bytes[i] == 0x0D || bytes[i] == 0x09 {
+                    i += 1
+                }
+                guard i < count, bytes[i] == UInt8(ascii: ":") else { return false }
+                i += 1
+                state = .value
+            case .afterValue:
+                guard let top = stack.last else { return i == count }
+                guard i < count else { return false }
+                let isObject = tape[top].kind == .object
+                if bytes[i] == UInt8(ascii: ",") {
+                    i += 1
+                    state = isObject ? .key : .value
+                } else if bytes[i] == (isObject ? UInt8(ascii: "}") : UInt8(ascii: "]")) {
+                    close(stack.removeLast(), at: i)
+                    i += 1
+                } else {
+                    return false
+                }
+            }
+        }
+    }
+
+    private func close(_ index: Int, at position: Int) {
+        tape[index].end = UInt32(position + 1)
+        tape[index].next = UInt32(tape.count)
+    }
+
+    private func appendScalar(_ kind: Kind, start: Int, end: Int, escaped: Bool = false) {
+        tape.append(Entry(kind: kind, escaped: escaped, start: UInt32(start), end: UInt32(end),
+                          next: UInt32(tape.count + 1)))
+    }
+
+    /// Appends the string entry opening at `start`; returns the offset past its closing quote.
+    private func scanString(at start: Int) -> Int? {
+        var j = start + 1
+        var escaped = false
+        while j < bytes.count {
+            let c = bytes[j]
+            if c == UInt8(ascii: "\"") {
+                appendScalar(.string, start: start, end: j + 1, escaped: escaped)
+                return j + 1
+            }
+            if c < 0x20 { return nil }
+            guard c == UInt8(ascii: "\\") else {
+                j += 1
+                continue
+            }
+            escaped = true
+            guard j + 1 < bytes.count else { return nil }
+            switch bytes[j + 1] {
+            case UInt8(ascii: "\""), UInt8(ascii: "\\"), UInt8(ascii: "/"),
+                 UInt8(ascii: "b"), UInt8(ascii: "f"), UInt8(ascii: "n"), UInt8(ascii: "r"), UInt8(ascii: "t"):
+                j += 2
+            case UInt8(ascii: "u"):
+                guard j + 6 <= bytes.count,
+                      bytes[(j + 2)..<(j + 6)].allSatisfy({ Self.isHexDigit($0) }) else { return nil }
+                j += 6
+            default:
+                return nil
+            }
+        }
+        return nil
+    }
+
+    private func scanNumber(at start: Int) -> Int? {
+        var j = start
+        if bytes[j] == UInt8(ascii: "-") { j += 1 }
+        guard j < bytes.count, Self.isDigit(bytes[j]) else { return nil }
+        if bytes[j] == UInt8(ascii: "0") {
+            j += 1
+        } else {
+            while j < bytes.count, Self.isDigit(bytes[j]) { j += 1 }
+        }
+        if j < bytes.count, bytes[j] == UInt8(ascii: ".") {
+            j += 1
+            guard j < bytes.count, Self.isDigit(bytes[j]) else { return nil }
+            while j < bytes.count, Self.isDigit(bytes[j]) { j += 1 }
+        }
+        if j < bytes.count, bytes[j] == UInt8(ascii: "e") || bytes[j] == UInt8(ascii: "E") {
+            j += 1
+            if j < bytes.count, bytes[j] == UInt8(ascii: "+") || bytes[j] == UInt8(ascii: "-") { j += 1 }
+            guard j < bytes.count, Self.isDigit(bytes[j]) else { return nil }
+            while j < bytes.count, Self.isDigit(bytes[j]) { j += 1 }
+        }
+        return j
+    }
+
+    private func scanLiteral(at start: Int) -> Int? {
+        for literal in ["true", "false", "null"] {
+            let utf8 = literal.utf8
+            let end = start + utf8.count
+            if end <= bytes.count, bytes[start..<end].elementsEqual(utf8) { return end }
+        }
+        return nil
+    }
+
+    private static func isDigit(_ c: UInt8) -> Bool {
+        c >= UInt8(ascii: "0") && c <= UInt8(ascii: "9")
+    }
+
+    private static func isHexDigit(_ c: UInt8) -> Bool {
+        isDigit(c) || ((c | 0x20) >= UInt8(ascii: "a") && (c | 0x20) <= UInt8(ascii: "f"))
+    }
+
+    // MARK: - Application
+
+    /// Applies every compiled edit in order; false when none of them changed the document.
+    func apply(_ ops: [MITMJSONPatch.CompiledOp]) -> Bool {
+        var changed = false
+        for op in ops where apply(op) {
+            changed = true
+        }
+        return changed
+    }
+
+    private func apply(_ op: MITMJSONPatch.CompiledOp) -> Bool {
+        switch op {
+        case .add(let path, let value):
+            guard let authored = Self.authored(value) else { return false }
+            return set(path, mode: .add, value: authored)
+        case .replace(let path, let value):
+            guard let authored = Self.authored(value) else { return false }
+            return set(path, mode: .replace, value: authored)
+        case .delete(let path):
+            return set(path, mode: .delete, value: nil)
+        case .replaceRecursive(let key, let value):
+            guard let authored = Self.authored(value),
+                  let rewritten = rewriteRecursive(root, key: KeyName(key), replacement: authored, depth: 0) else { return false }
+            root = rewritten
+            return true
+        case .deleteRecursive(let key):
+            guard let rewritten = rewriteRecursive(root, key: KeyName(key), replacement: nil, depth: 0) else { return false }
+            root = rewritten
+            return true
+        case .removeWhereKeyExists(let path, let key):
+            let name = KeyName(key)
+            return removeElements(at: path) { element in
+                self.memberValue(of: element, key: name) != nil
+            }
+        case .removeWhereFieldIn(let path, let field, let values):
+            let name = KeyName(field)
+            return removeElements(at: path) { element in
+                guard let fieldValue = self.memberValue(of: element, key: name),
+                      let decoded = self.foundationValue(fieldValue) else { return false }
+                return values.contains { MITMJSONPatch.valueEquals($0, decoded) }
+            }
+        }
+    }
+
+    /// Add/replace/delete at the path leaf with `MITMJSONPatch.applyAtPath`'s semantics; every miss
+    /// is a no-op. Duplicate keys resolve to the last occurrence, as JSONSerialization does.
+    private func set(_ path: [PathSegment], mode: MITMJSONPatch.LeafMode, value: Value?) -> Bool {
+        guard let leaf = path.last else {
+            guard mode != .delete, let value else { return false }
+            root = value
+            return true
+        }
+        return modify(&root, path: path.dropLast()) { parent in
+            switch leaf {
+            case .key(let name):
+                guard case .object(var members) = self.expand(parent) else { return false }
+                let key = KeyName(name)
+                let matches = members.indices.filter { self.keyMatches(members[$0].key, key) }
+                switch mode {
+                case .add, .replace:
+                    guard let value else { return false }
+                    if let last = matches.last {
+                        members[last].value = value
+                        for index in matches.dropLast().reversed() { members.remove(at: index) }
+                    } else {
+                        guard mode == .add, let quoted = MITMJSONPatch.serialize(name) else { return false }
+                        members.append(Member(key: .authored(name, quoted), value: value))
+                    }
+                case .delete:
+                    guard !matches.isEmpty else { return false }
+                    for index in matches.reversed() { members.remove(at: index) }
+                }
+                parent = .object(members)
+                return true
+            case .index(let index):
+                guard case .array(var elements) = self.expand(parent) else { return false }
+                switch mode {
+                case .add:
+                    guard let value else { return false }
+                    if index >= 0, index < elements.count {
+                        elements[index] = value
+                    } else if index == elements.count {
+                        elements.append(value)
+                    } else {
+                        return false
+                    }
+                case .replace:
+                    guard let value, index >= 0, index < elements.count else { return false }
+                    elements[index] = value
+                case .delete:
+                    guard index >= 0, index < elements.count else { return false }
+                    elements.remove(at: index)
+                }
+                parent = .array(elements)
+                return true
+            }
+        }
+    }
+
+    private func removeElements(at path: [PathSegment], where shouldRemove: (Value) -> Bool) -> Bool {
+        modify(&root, path: path[...]) { node in
+            guard case .array(let elements) = self.expand(node) else { return false }
+            let kept = elements.filter { !shouldRemove($0) }
+            guard kept.count != elements.count else { return false }
+            node = .array(kept)
+            return true
+        }
+    }
+
+    /// Runs `body` on the node at `path`. Ancestors are expanded to descend, but written back
+    /// only when `body` reports a change, so a missed edit leaves every span untouched.
+    private func modify(_ node: inout Value, path: ArraySlice<PathSegment>, _ body: (inout Value) -> Bool) -> Bool {
+        guard let segment = path.first else { return body(&node) }
+        switch segment {
+        case .key(let name):
+            let key = KeyName(name)
+            guard case .object(var members) = expand(node),
+                  let last = members.lastIndex(where: { keyMatches($0.key, key) }),
+                  modify(&members[last].value, path: path.dropFirst(), body) else { return false }
+            node = .object(members)
+        case .index(let index):
+            guard case .array(var elements) = expand(node), index >= 0, index < elements.count,
+                  modify(&elements[index], path: path.dropFirst(), body) else { return false }
+            node = .array(elements)
+        }
+        return true
+    }
+
+    /// `replaceRecursive` (non-nil `replacement`) or `deleteRecursive`: nil when no member matched.
+    /// Tape containers are walked in place and expanded only once a descendant changes; a
+    /// replaced value is never descended into.
+    private func rewriteRecursive(_ node: Value, key: KeyName, replacement: Value?, depth: Int) -> Value? {
+        guard depth < Self.maxRecursionDepth else { return nil }
+        switch node {
+        case .encoded:
+            return nil
+        case .tape(let index):
+            let entry = tape[index]
+            switch entry.kind {
+            case .object:
+                var rewritten: [Member]?
+                var position = 0
+                var child = index + 1
+                while child < Int(entry.next) {
+                    let valueIndex = child + 1
+                    let next = Int(tape[valueIndex].next)
+                    let newValue: Value??
+                    if keyMatches(.tape(child), key) {
+                        newValue = .some(replacement)
+                    } else if let value = rewriteRecursive(.tape(valueIndex), key: key, replacement: replacement, depth: depth + 1) {
+                        newValue = .some(value)
+                    } else {
+                        newValue = nil
+                    }
+                    if let newValue {
+                        if rewritten == nil { rewritten = members(of: index, prefix: position) }
+                        if let value = newValue { rewritten?.append(Member(key: .tape(child), value: value)) }
+                    } else {
+                        rewritten?.append(Member(key: .tape(child), value: .tape(valueIndex)))
+                    }
+                    position += 1
+                    child = next
+                }
+                return rewritten.map { .object($0) }
+            case .array:
+                var rewritten: [Value]?
+                var position = 0
+                var child = index + 1
+                while child < Int(entry.next) {
+                    if let value = rewriteRecursive(.tape(child), key: key, replacement: replacement, depth: depth + 1) {
+                        if rewritten == nil { rewritten = elements(of: index, prefix: position) }
+                        rewritten?.append(value)
+                    } else {
+                        rewritten?.append(.tape(child))
+                    }
+                    position += 1
+                    child = Int(tape[child].next)
+                }
+                return rewritten.map { .array($0) }
+            default:
+                return nil
+            }
+        case .object(let members):
+            var changed = false
+            var rewritten: [Member] = []
+            rewritten.reserveCapacity(members.count)
+            for member in members {
+                if keyMatches(member.key, key) {
+                    changed = true
+                    if let replacement { rewritten.append(Member(key: member.key, value: replacement)) }
+                } else if let value = rewriteRecursive(member.value, key: key, replacement: replacement, depth: depth + 1) {
+                    changed = true
+                    rewritten.append(Member(key: member.key, value: value))
+                } else {
+                    rewritten.append(member)
+                }
+            }
+            return changed ? .object(rewritten) : nil
+        case .array(let elements):
+            var changed = false
+            let rewritten = elements.map { element -> Value in
+                guard let value = rewriteRecursive(element, key: key, replacement: replacement, depth: depth + 1) else {
+                    return element
+                }
+                changed = true
+                return value
+            }
+            return changed ? .array(rewritten) : nil
+        }
+    }
+
+    // MARK: - Overlay helpers
+
+    /// A container's children as overlay nodes; other values are returned as they are.
+    private func expand(_ value: Value) -> Value {
+        guard case .tape(let index) = value else { return value }
+        switch tape[index].kind {
+        case .object: return .object(members(of: index, prefix: Int.max))
+        case .array: return .array(elements(of: index, prefix: Int.max))
+        default: return value
+        }
+    }
+
+    /// The first `prefix` members of the tape object at `index`.
+    private func members(of index: Int, prefix: Int) -> [Member] {
+        var members: [Member] = []
+        var child = index + 1
+        let end = Int(tape[index].next)
+        while child < end, members.count < prefix {
+            members.append(Member(key: .tape(child), value: .tape(child + 1)))
+            child = Int(tape[child + 1].next)
+        }
+        return members
+    }
+
+    /// The first `prefix` elements of the tape array at `index`.
+    private func elements(of index: Int, prefix: Int) -> [Value] {
+        var elements: [Value] = []
+        var child = index + 1
+        let end = Int(tape[index].next)
+        while child < end, elements.count < prefix {
+            elements.append(.tape(child))
+            child = Int(tape[child].next)
+        }
+        return elements
+    }
+
+    /// The value of member `key` when `value` is an object (last occurrence wins), else nil.
+    private func memberValue(of value: Value, key: KeyName) -> Value? {
+        switch value {
+        case .tape(let index):
+            guard tape[index].kind == .object else { return nil }
+            var found: Value?
+            var child = index + 1
+            let end = Int(tape[index].next)
+            while child < end {
+                if keyMatches(.tape(child), key) { found = .tape(child + 1) }
+                child = Int(tape[child + 1].next)
+            }
+            return found
+        case .object(let members):
+            return members.last { keyMatches($0.key, key) }?.value
+        case .encoded, .array:
+            return nil
+        }
+    }
+
+    private func keyMatches(_ key: Key, _ name: KeyName) -> Bool {
+        switch key {
+        case .authored(let string, _):
+            return string == name.string
+        case .tape(let index):
+            let entry = tape[index]
+            guard entry.escaped else {
+                let start = Int(entry.start) + 1, end = Int(entry.end) - 1
+                return end - start == name.utf8.count && bytes[start..<end].elementsEqual(name.utf8)
+            }
+            let raw = Data(bytes[Int(entry.start)..<Int(entry.end)])
+            return (try? JSONSerialization.jsonObject(with: raw, options: [.fragmentsAllowed])) as? String == name.string
+        }
+    }
+
+    /// A node as a Foundation value, for `MITMJSONPatch.valueEquals`.
+    private func foundationValue(_ value: Value) -> Any? {
+        var out: [UInt8] = []
+        write(value, into: &out)
+        return try? JSONSerialization.jsonObject(with: Data(out), options: [.fragmentsAllowed])
+    }
+
+    /// Converts an authored operation value; nil when it can't be serialized.
+    private static func authored(_ value: Any, depth: Int = 0) -> Value? {
+        guard depth < maxRecursionDepth else { return nil }
+        switch value {
+        case let dictionary as NSDictionary:
+            var members: [Member] = []
+            members.reserveCapacity(dictionary.count)
+            for (key, child) in dictionary {
+                guard let name = key as? String,
+                      let quoted = MITMJSONPatch.serialize(name),
+                      let converted = authored(child, depth: depth + 1) else { return nil }
+                members.append(Member(key: .authored(name, quoted), value: converted))
+            }
+            return .object(members)
+        case let array as NSArray:
+            var elements: [Value] = []
+            elements.reserveCapacity(array.count)
+            for element in array {
+                guard let converted = authored(element, depth: depth + 1) else { return nil }
+                elements.append(converted)
+            }
+            return .array(elements)
+        default:
+            return MITMJSONPatch.serialize(value).map { .encoded($0) }
+        }
+    }
+
+    // MARK: - Serialization
+
+    /// The edited document: untouched spans verbatim, expanded containers written compactly.
+    func serialized() -> Data {
+        var out: [UInt8] = []
+        out.reserveCapacity(bytes.count + 256)
+        write(root, into: &out)
+        return Data(out)
+    }
+
+    private func write(_ value: Value, into out: inout [UInt8]) {
+        switch value {
+        case .tape(let index):
+            out.append(contentsOf: bytes[Int(tape[index].start)..<Int(tape[index].end)])
+        case .encoded(let data):
+            out.append(contentsOf: data)
+        case .object(let members):
+            out.append(UInt8(ascii: "{"))
+            for (position, member) in members.enumerated() {
+                if position > 0 { out.append(UInt8(ascii: ",")) }
+                switch member.key {
+                case .tape(let index):
+                    out.append(contentsOf: bytes[Int(tape[index].start)..<Int(tape[index].end)])
+                case .authored(_, let quoted):
+                    out.append(contentsOf: quoted)
+                }
+                out.append(UInt8(ascii: ":"))
+                write(member.value, into: &out)
+            }
+            out.append(UInt8(ascii: "}"))
+        case .array(let elements):
+            out.append(UInt8(ascii: "["))
+            for (position, element) in elements.enumerated() {
+                if position > 0 { out.append(UInt8(ascii: ",")) }
+                write(element, into: &out)
+            }
+            out.append(UInt8(ascii: "]"))
+        }
+    }
+}
@@ -85,8 +85,13 @@ enum MITMJSONPatch {
     // MARK: - Application
 
     /// Applies every compiled edit in order; fail-closed on non-JSON, no-op edits, or re-serialization failure.
+    /// Foundation handles only what `MITMJSONDocument` can't parse (a BOM, UTF-16).
     static func applyAll(_ ops: [CompiledOp], to body: Data) -> Data {
         guard !ops.isEmpty else { return body }
+        // Native tape first: edits expand only their own paths and untouched spans stay byte-exact.
+        if let document = MITMJSONDocument(body) {
+            return document.apply(ops) ? document.serialized() : body
+        }
         guard var root = parse(body) else { return body }
         // Return original bytes when nothing changed: re-serializing could reshape 64-bit IDs / high-precision decimals.
         let before = snapshot(root)
@@ -370,7 +375,7 @@ enum MITMJSONPatch {
     }
 
     /// Deep copy sharing no mutable node with the source; copies stay mutable for later edits.
-    private static func deepCopy(_ value: Any, depth: Int = 0) -> Any {
+    static func deepCopy(_ value: Any, depth: Int = 0) -> Any {
         guard depth < maxRecursionDepth else { return value }
         switch value {
         case let dictionary as NSDictionary:
@@ -0,0 +1,534 @@
+//
+//  MITMJSONStreamEditor.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Incremental `.bodyJSON` editing for streamed bodies. A tokenizer walks the bytes chunk by chunk
+/// and passes them through verbatim except where an edit lands: a deleted member is dropped, a
+/// replaced value is swapped for the serialized replacement, and an `add` whose key never appeared
+/// is inserted before the closing brace. Original formatting and number spelling survive, and only
+/// the member being decided plus replacement values are ever held.
+///
+/// Edits compose per position in rule order, the same result `MITMJSONPatch.applyAll` reaches by
+/// applying them one after another. Malformed input is fail-open from the first bad byte: what
+/// was already emitted stays, the rest passes through unedited.
+final class MITMJSONStreamEditor {
+    typealias PathSegment = MITMJSONPatch.PathSegment
+
+    private let ops: [MITMJSONPatch.CompiledOp]
+    /// Keys named by recursive ops; a member whose key isn't here skips them.
+    private let recursiveKeys: Set<String>
+    private let hasPathOps: Bool
+
+    /// Containers enclosing the current position, innermost last.
+    private struct Frame {
+        let isObject: Bool
+        /// Path of this container; nil when no path op reaches inside, so children skip path bookkeeping.
+        let path: [PathSegment]?
+        /// Next element's index (arrays), counted over the original elements.
+        var index = 0
+        /// Members/elements written out so far; decides whether a held separator is kept.
+        var emitted = 0
+        /// Keys seen in this object, tracked only when an `add` may need to insert one.
+        var seenKeys: Set<String>?
+        var currentKey: String?
+    }
+
+    private enum State {
+        case value
+        case afterValue
+        case keyOrEnd
+        case key
+        case inKey(escaped: Bool)
+        case afterKey
+        case inString(escaped: Bool)
+        case inScalar
+    }
+
+    private enum Sink { case emit, hold, drop }
+
+    private enum Edit {
+        case original
+        case value(Any)
+        case deleted
+    }
+
+    private var state: State = .value
+    private var stack: [Frame] = []
+    /// Separator, key, and whitespace of the member being decided; written out only if it's kept.
+    private var memberPrefix = Data()
+    /// True while `.value` whitespace belongs to a held member prefix rather than the root.
+    private var pendingMember = false
+    private var keyStart = 0
+
+    private var skipping = false
+    private var skipDepth = 0
+    private var skipInString = false
+    private var skipEscaped = false
+    private var skipScalar = false
+
+    private var passthrough = false
+    private var sink: Sink = .emit
+    private var runStart = 0
+
+    /// Keys longer than this are treated as unmatched rather than held.
+    private static let maxKeyBytes = 64 * 1024
+
+    /// Nil when an op needs the whole document (`removeWhere…` filters), which keeps the buffered path.
+    init?(ops: [MITMJSONPatch.CompiledOp]) {
+        var recursiveKeys = Set<String>()
+        var hasPathOps = false
+        for op in ops {
+            switch op {
+            case .add, .replace, .delete:
+                hasPathOps = true
+            case .replaceRecursive(let key, _), .deleteRecursive(let key):
+                recursiveKeys.insert(key)
+            case .removeWhereKeyExists, .removeWhereFieldIn:
+                return nil
+            }
+        }
+        self.ops = ops
+        self.recursiveKeys = recursiveKeys
+        self.hasPathOps = hasPathOps
+    }
+
+    // MARK: - Feeding
+
+    func feed(_ data: Data) -> Data {
+        guard !passthrough else { return data }
+        var out = Data()
+        data.withUnsafeBytes { (raw: UnsafeRawBufferPointer) in
+            let bytes = raw.bindMemory(to: UInt8.self)
+            runStart = 0
+            var i = 0
+            while i < bytes.count {
+                if passthrough {
+                    out.append(UnsafeBufferPointer(rebasing: bytes[i...]))
+                    return
+                }
+                i = step(bytes, at: i, out: &out)
+            }
+            flush(bytes, upTo: bytes.count, out: &out)
+        }
+        return out
+    }
+
+    /// End of body: a root scalar completes here; a truncated document's held bytes go out verbatim.
+    func finish() -> Data {
+        guard !passthrough else { return Data() }
+        var out = Data()
+        out.append(memberPrefix)
+        memberPrefix = Data()
+        passthrough = true
+        return out
+    }
+
+    // MARK: - Tokenizer
+
+    private static func isWhitespace(_ b: UInt8) -> Bool { b == 0x20 || b == 0x0A || b == 0x0D || b == 0x09 }
+
+    private static func isScalarByte(_ b: UInt8) -> Bool {
+        switch b {
+        case UInt8(ascii: "0")...UInt8(ascii: "9"), UInt8(ascii: "a")...UInt8(ascii: "z"),
+             UInt8(ascii: "A")...UInt8(ascii: "Z"), UInt8(ascii: "+"), UInt8(ascii: "-"), UInt8(ascii: "."):
+            return true
+        default:
+            return false
+        }
+    }
+
+    /// Consumes the byte at `i` (or re-enters it after a state change) and returns the next index.
+    private func step(_ bytes: UnsafeBufferPointer<UInt8>, at i: Int, out: inout Data) -> Int {
+        let b = bytes[i]
+        if skipping {
+            return skipStep(bytes, at: i, out: &out)
+        }
+        switch state {
+        case .value:
+            if Self.isWhitespace(b) { return i + 1 }
+            if b == UInt8(ascii: "]"), let top = stack.last, !top.isObject {
+                // `[]` closes; `,]` is a trailing comma and fails below as a bad value.
+                flush(bytes, upTo: i, out: &out)
+                if memberPrefix.first != UInt8(ascii: ",") { return closeContainer(bytes, at: i, out: &out) }
+            }
+            return beginValue(bytes, at: i, out: &out)
+        case .afterValue:
+            if Self.isWhitespace(b) { return i + 1 }
+            guard let top = stack.last else { return fail(bytes, at: i, out: &out) }
+            if b == UInt8(ascii: ",") {
+                setSink(.hold, bytes, at: i, out: &out)
+                pendingMember = true
+                state = top.isObject ? .key : .value
+                return i + 1
+            }
+            if b == (top.isObject ? UInt8(ascii: "}") : UInt8(ascii: "]")) {
+                return closeContainer(bytes, at: i, out: &out)
+            }
+            return fail(bytes, at: i, out: &out)
+        case .keyOrEnd:
+            if Self.isWhitespace(b) { return i + 1 }
+            if b == UInt8(ascii: "}") { return closeContainer(bytes, at: i, out: &out) }
+            guard b == UInt8(ascii: "\"") else { return fail(bytes, at: i, out: &out) }
+            setSink(.hold, bytes, at: i, out: &out)
+            pendingMember = true
+            return startKey(bytes, at: i, out: &out)
+        case .key:
+            if Self.isWhitespace(b) { return i + 1 }
+            guard b == UInt8(ascii: "\"") else { return fail(bytes, at: i, out: &out) }
+            return startKey(bytes, at: i, out: &out)
+        case .inKey(let escaped):
+            if escaped {
+                state = .inKey(escaped: false)
+            } else if b == UInt8(ascii: "\\") {
+                state = .inKey(escaped: true)
+            } else if b == UInt8(ascii: "\"") {
+                flush(bytes, upTo: i + 1, out: &out)
+                stack[stack.count - 1].currentKey = decodeKey(memberPrefix[(memberPrefix.startIndex + keyStart)...])
+                state = .afterKey
+            } else if memberPrefix.count - keyStart + (i - runStart) > Self.maxKeyBytes {
+                return fail(bytes, at: i, out: &out)
+            }
+            return i + 1
+        case .afterKey:
+            if Self.isWhitespace(b) { return i + 1 }
+            guard b == UInt8(ascii: ":") else { return fail(bytes, at: i, out: &out) }
+            state = .value
+            return i + 1
+        case .inString(let escaped):
+            if escaped {
+                state = .inString(escaped: false)
+            } else if b == UInt8(ascii: "\\") {
+                state = .inString(escaped: true)
+            } else if b == UInt8(ascii: "\"") {
+                state = .afterValue
+            }
+            return i + 1
+        case .inScalar:
+            if Self.isScalarByte(b) { return i + 1 }
+            state = .afterValue
+            return i
+        }
+    }
+
+    private func startKey(_ bytes: UnsafeBufferPointer<UInt8>, at i: Int, out: inout Data) -> Int {
+        flush(bytes, upTo: i, out: &out)
+        keyStart = memberPrefix.count + 1
+        state = .inKey(escaped: false)
+        return i + 1
+    }
+
+    /// Decides the value starting at `i` and either streams it, swaps it, or drops it.
+    private func beginValue(_ bytes: UnsafeBufferPointer<UInt8>, at i: Int, out: inout Data) -> Int {
+        let b = bytes[i]
+        let path: [PathSegment]?
+        let key: String?
+        if stack.isEmpty {
+            path = []
+            key = nil
+        } else {
+            let top = stack[stack.count - 1]
+            if top.isObject {
+                key = top.currentKey
+                path = key.flatMap { k in top.path.map { $0 + [.key(k)] } }
+                if let key, top.seenKeys != nil { stack[stack.count - 1].seenKeys?.insert(key) }
+            } else {
+                key = nil
+                path = top.path.map { $0 + [.index(top.index)] }
+                stack[stack.count - 1].index += 1
+            }
+        }
+        flush(bytes, upTo: i, out: &out)
+        let edit = (key == nil && path == nil) ? .original : compose(path: path, key: key, from: 0, start: .original)
+
+        switch edit {
+        case .deleted:
+            memberPrefix = Data()
+            pendingMember = false
+            startSkip(bytes, at: i, out: &out)
+            return skipStartIndex(i)
+        case .value(let replacement):
+            // An unserializable replacement leaves the original value, like the buffered fail-closed.
+            if let serialized = MITMJSONPatch.serialize(replacement) {
+                emitMemberPrefix(out: &out)
+                out.append(serialized)
+                startSkip(bytes, at: i, out: &out)
+                return skipStartIndex(i)
+            }
+        case .original:
+            break
+        }
+        emitMemberPrefix(out: &out)
+        setSink(.emit, bytes, at: i, out: &out)
+        switch b {
+        case UInt8(ascii: "{"):
+            stack.append(Frame(isObject: true, path: containerPath(path),
+                               seenKeys: needsSeenKeys(path) ? [] : nil))
+            state = .keyOrEnd
+            return i + 1
+        case UInt8(ascii: "["):
+            stack.append(Frame(isObject: false, path: containerPath(path)))
+            state = .value
+            pendingMember = true
+            setSink(.hold, bytes, at: i + 1, out: &out)
+            return i + 1
+        case UInt8(ascii: "\""):
+            state = .inString(escaped: false)
+            return i + 1
+        default:
+            guard Self.isScalarByte(b) else { return fail(bytes, at: i, out: &out) }
+            state = .inScalar
+            return i
+        }
+    }
+
+    private func closeContainer(_ bytes: UnsafeBufferPointer<UInt8>, at i: Int, out: inout Data) -> Int {
+        flush(bytes, upTo: i, out: &out)
+        // Whitespace held after `[` in an empty array is ordinary formatting.
+        out.append(memberPrefix)
+        memberPrefix = Data()
+        pendingMember = false
+        let frame = stack.removeLast()
+        appendInsertions(for: frame, out: &out)
+        setSink(.emit, bytes, at: i, out: &out)
+        state = .afterValue
+        return i + 1
+    }
+
+    private func emitMemberPrefix(out: inout Data) {
+        defer {
+            memberPrefix = Data()
+            pendingMember = false
+        }
+        guard !stack.isEmpty else { return }
+        var prefix = memberPrefix[...]
+        // Every earlier sibling was deleted: the held comma would now lead the container.
+        if stack[stack.count - 1].emitted == 0, prefix.first == UInt8(ascii: ",") {
+            prefix = prefix.dropFirst()
+        }
+        out.append(prefix)
+        stack[stack.count - 1].emitted += 1
+    }
+
+    // MARK: - Skipping
+
+    private func startSkip(_ bytes: UnsafeBufferPointer<UInt8>, at i: Int, out: inout Data) {
+        setSink(.drop, bytes, at: i, out: &out)
+        skipping = true
+        skipDepth = 0
+        skipInString = false
+        skipEscaped = false
+        skipScalar = false
+        switch bytes[i] {
+        case UInt8(ascii: "{"), UInt8(ascii: "["): skipDepth = 1
+        case UInt8(ascii: "\""): skipInString = true
+        default: skipScalar = true
+        }
+    }
+
+    /// Where skipping resumes after `startSkip` classified the opening byte.
+    private func skipStartIndex(_ i: Int) -> Int {
+        skipScalar ? i : i + 1
+    }
+
+    private func skipStep(_ bytes: UnsafeBufferPointer<UInt8>, at i: Int, out: inout Data) -> Int {
+        let b = bytes[i]
+        if skipInString {
+            if skipEscaped {
+                skipEscaped = false
+            } else if b == UInt8(ascii: "\\") {
+                skipEscaped = true
+            } else if b == UInt8(ascii: "\"") {
+                skipInString = false
+                if skipDepth == 0 { return endSkip(bytes, at: i + 1, out: &out) }
+            }
+            return i + 1
+        }
+        if skipScalar {
+            if Self.isScalarByte(b) { return i + 1 }
+            return endSkip(bytes, at: i, out: &out)
+        }
+        switch b {
+        case UInt8(ascii: "\""):
+            skipInString = true
+        case UInt8(ascii: "{"), UInt8(ascii: "["):
+            skipDepth += 1
+        case UInt8(ascii: "}"), UInt8(ascii: "]"):
+            skipDepth -= 1
+            if skipDepth == 0 { return endSkip(bytes, at: i + 1, out: &out) }
+        default:
+            break
+        }
+        return i + 1
+    }
+
+    private func endSkip(_ bytes: UnsafeBufferPointer<UInt8>, at i: Int, out: inout Data) -> Int {
+        setSink(.emit, bytes, at: i, out: &out)
+        skipping = false
+        state = .afterValue
+        return i
+    }
+
+    // MARK: - Output routing
+
+    private func setSink(_ next: Sink, _ bytes: UnsafeBufferPointer<UInt8>, at i: Int, out: inout Data) {
+        guard next != sink else { return }
+        flush(bytes, upTo: i, out: &out)
+        sink = next
+    }
+
+    private func flush(_ bytes: UnsafeBufferPointer<UInt8>, upTo i: Int, out: inout Data) {
+        guard i > runStart else { return }
+        let run = UnsafeBufferPointer(rebasing: bytes[runStart..<i])
+        switch sink {
+        case .emit: out.append(run)
+        case .hold: memberPrefix.append(run)
+        case .drop: break
+        }
+        runStart = i
+    }
+
+    /// Malformed JSON: release what's held and pass the rest through untouched.
+    private func fail(_ bytes: UnsafeBufferPointer<UInt8>, at i: Int, out: inout Data) -> Int {
+        flush(bytes, upTo: i, out: &out)
+        out.append(memberPrefix)
+        memberPrefix = Data()
+        passthrough = true
+        runStart = i
+        return i
+    }
+
+    // MARK: - Edit composition
+
+    private func decodeKey(_ raw: Data) -> String? {
+        // Drop the closing quote; an escape-free key decodes directly.
+        let body = raw.dropLast()
+        guard body.contains(UInt8(ascii: "\\")) else { return String(decoding: body, as: UTF8.self) }
+        var quoted = Data([UInt8(ascii: "\"")])
+        quoted.append(body)
+        quoted.append(UInt8(ascii: "\""))
+        return (try? JSONSerialization.jsonObject(with: quoted, options: [.fragmentsAllowed])) as? String
+    }
+
+    /// A container's path is tracked only if some path op targets it or something inside it.
+    private func containerPath(_ path: [PathSegment]?) -> [PathSegment]? {
+        guard hasPathOps, let path else { return nil }
+        for op in ops {
+            switch op {
+            case .add(let target, _), .replace(let target, _), .delete(let target):
+                if target.count > path.count, Array(target.prefix(path.count)) == path { return path }
+            default:
+                continue
+            }
+        }
+        return nil
+    }
+
+    private func needsSeenKeys(_ path: [PathSegment]?) -> Bool {
+        guard let path else { return false }
+        return ops.contains { op in
+            if case .add(let target, _) = op, target.count == path.count + 1,
+               case .key? = target.last, Array(target.dropLast()) == path {
+                return true
+            }
+            return false
+        }
+    }
+
+    /// Runs ops `from...` over one position: `path` (nil when no path op can reach it) and the
+    /// member `key` in its parent object. An edit inside a value an earlier op placed is applied
+    /// to that value, as the sequential buffered apply would.
+    private func compose(path: [PathSegment]?, key: String?, from first: Int, start: Edit) -> Edit {
+        if path == nil, key.map({ !recursiveKeys.contains($0) }) ?? true {
+            if case .original = start { return .original }
+        }
+        var edit = start
+        for op in ops[first...] {
+            switch op {
+            case .add(let target, let value), .replace(let target, let value):
+                var isAdd = false
+                if case .add = op { isAdd = true }
+                guard let path else { continue }
+                if target == path {
+                    if case .deleted = edit, !isAdd { continue }
+                    edit = .value(MITMJSONPatch.deepCopy(value))
+                } else if case .value(let current) = edit, target.count > path.count,
+                          Array(target.prefix(path.count)) == path {
+                    edit = .value(MITMJSONPatch.applyAtPath(current, segments: Array(target.dropFirst(path.count)),
+                                                            mode: isAdd ? .add : .replace, value: value))
+                }
+            case .delete(let target):
+                guard let path else { continue }
+                if target == path {
+                    // Deleting the root is a no-op, as in `applyAtPath`.
+                    guard !target.isEmpty else { continue }
+                    edit = .deleted
+                } else if case .value(let current) = edit, target.count > path.count,
+                          Array(target.prefix(path.count)) == path {
+                    edit = .value(MITMJSONPatch.applyAtPath(current, segments: Array(target.dropFirst(path.count)),
+                                                            mode: .delete, value: nil))
+                }
+            case .replaceRecursive(let name, let value):
+                if case .value(let current) = edit {
+                    MITMJSONPatch.replaceKeyRecursive(current, key: name, value: value)
+                }
+                if key == name, !isDeleted(edit) {
+                    edit = .value(MITMJSONPatch.deepCopy(value))
+                }
+            case .deleteRecursive(let name):
+                if key == name {
+                    edit = .deleted
+                } else if case .value(let current) = edit {
+                    MITMJSONPatch.deleteKeyRecursive(current, key: name)
+                }
+            case .removeWhereKeyExists, .removeWhereFieldIn:
+                continue
+            }
+        }
+        return edit
+    }
+
+    private func isDeleted(_ edit: Edit) -> Bool {
+        if case .deleted = edit { return true }
+        return false
+    }
+
+    /// `add` targets that never appeared in `frame`: object keys not seen, or the index one past
+    /// the last element. Each is composed with the ops after it before being written.
+    private func appendInsertions(for frame: Frame, out: inout Data) {
+        guard let path = frame.path else { return }
+        var written = frame.emitted
+        var inserted = Set<String>()
+        var appended = false
+        for (position, op) in ops.enumerated() {
+            guard case .add(let target, let value) = op, let leaf = target.last,
+                  target.count == path.count + 1, Array(target.dropLast()) == path else { continue }
+            var member = Data()
+            let key: String?
+            switch leaf {
+            case .key(let name):
+                guard frame.isObject, frame.seenKeys?.contains(name) == false,
+                      inserted.insert(name).inserted,
+                      let quoted = MITMJSONPatch.serialize(name) else { continue }
+                member.append(quoted)
+                member.append(UInt8(ascii: ":"))
+                key = name
+            case .index(let index):
+                guard !frame.isObject, index == frame.index, !appended else { continue }
+                appended = true
+                key = nil
+            }
+            let edit = compose(path: target, key: key, from: position + 1,
+                               start: .value(MITMJSONPatch.deepCopy(value)))
+            guard case .value(let final) = edit, let serialized = MITMJSONPatch.serialize(final) else { continue }
+            if written > 0 { out.append(UInt8(ascii: ",")) }
+            out.append(member)
+            out.append(serialized)
+            written += 1
+        }
+    }
+}
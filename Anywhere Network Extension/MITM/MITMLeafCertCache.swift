@@ -26,12 +26,22 @@ final class MITMLeafCertCache {
     // MARK: - Init
 
     private let store: MITMCertificateStore
+    private let diskStore: MITMLeafCertDiskStore
     private let leafPrivateKey: P256.Signing.PrivateKey
     private let leafPrivateKeySecKey: SecKey
 
     private static let maxEntries = 256
     private static let validity: TimeInterval = 7 * 24 * 60 * 60
+    /// notBefore is backdated to absorb client clock skew.
+    private static let backdate: TimeInterval = 60 * 60
     private static let refreshThreshold: TimeInterval = 24 * 60 * 60
+    /// Pre-minting stops at half the cache so live hosts aren't evicted by rule-set hosts.
+    private static let maxPremint = maxEntries / 2
+    /// Coalesces a burst of mints into one disk write.
+    private static let persistDelay: TimeInterval = 2
+    /// How long one leaf template's validity window is reused; leaves minted under it are
+    /// at most this much shorter-lived than a freshly windowed one.
+    private static let templateLifetime: TimeInterval = 60 * 60
     
     private static let mintQueue = DispatchQueue(
         label: AWCore.Identifier.mitmCertMintQueue,
@@ -42,28 +52,91 @@ final class MITMLeafCertCache {
 
     private let lock = UnfairLock()
     private var entries: [String: CacheEntry] = [:]
+    private var persistScheduled = false
+    private var template: X509Builder.LeafTemplate?
+    /// Completions waiting on a mint in progress, by certificate name.
+    private var inFlight: [String: [(Result<Leaf, Error>) -> Void]] = [:]
 
     private struct CacheEntry {
         let leaf: Leaf
         var lastAccess: Date
     }
 
+    /// Restores the leaves the previous tunnel run persisted, if they were minted under the
+    /// current CA; otherwise starts empty with a fresh leaf key.
     init(store: MITMCertificateStore) throws {
         self.store = store
-        let key = P256.Signing.PrivateKey()
+        let diskStore = MITMLeafCertDiskStore(store: store)
+        self.diskStore = diskStore
+        let restored = store.loadCA().flatMap { diskStore.load(caCertificateDER: $0.certificateDER) }
+        let key = restored?.leafKey ?? P256.Signing.PrivateKey()
         self.leafPrivateKey = key
         self.leafPrivateKeySecKey = try Self.importSoftwareP256(key)
+        guard let restored else { return }
+        let now = Date()
+        for saved in restored.leaves where saved.expiry.timeIntervalSince(now) > Self.refreshThreshold {
+            guard let certificate = SecCertificateCreateWithData(nil, saved.certificateDER as CFData) else { continue }
+            let leaf = Leaf(
+                certificate: certificate,
+                certificateDER: saved.certificateDER,
+                privateKeySecKey: leafPrivateKeySecKey,
+                privateKey: leafPrivateKey,
+                expiry: saved.expiry
+            )
+            entries[saved.hostname] = CacheEntry(leaf: leaf, lastAccess: now)
+        }
+        evictIfNeededUnlocked()
     }
 
-    /// Resolves a leaf for `hostname`, minting one if the cache misses.
-    func leaf(for hostname: String, completion: @escaping (Result<Leaf, Error>) -> Void) {
+    /// Resolves a leaf for `hostname`, minting one if the cache misses. With `wildcardParent`
+    /// the leaf is minted for `*.wildcardParent` and shared by every sibling. Concurrent
+    /// misses for one name wait on a single mint; distinct names sign in parallel.
+    func leaf(for hostname: String, wildcardParent: String? = nil, completion: @escaping (Result<Leaf, Error>) -> Void) {
         let normalized = hostname.lowercased()
         if let cached = cachedLeaf(for: normalized) {
             completion(.success(cached))
             return
         }
+        let name = wildcardParent.map { "*.\($0.lowercased())" } ?? normalized
+        if name != normalized, let cached = cachedLeaf(for: name) {
+            completion(.success(cached))
+            return
+        }
+        let isFirst: Bool = lock.withLock {
+            if inFlight[name] != nil {
+                inFlight[name]?.append(completion)
+                return false
+            }
+            inFlight[name] = [completion]
+            return true
+        }
+        guard isFirst else { return }
         Self.mintQueue.async { [self] in
-            completion(Result { try mintAndStore(for: normalized) })
+            let result = Result { try mintAndStore(for: name) }
+            let waiters = lock.withLock { inFlight.removeValue(forKey: name) ?? [] }
+            for waiter in waiters { waiter(result) }
+        }
+    }
+
+    /// Mints leaves for rule-set hosts in the background so their first interception after a
+    /// restart or reload skips signing; hosts already cached are skipped.
+    func premint(hostnames: [String]) {
+        var seen = Set<String>()
+        let pending = hostnames
+            .map { $0.lowercased() }
+            .filter { seen.insert($0).inserted && cachedLeaf(for: $0) == nil }
+            .prefix(Self.maxPremint)
+        guard !pending.isEmpty else { return }
+        Self.mintQueue.async(qos: .utility) { [self] in
+            guard store.loadCA() != nil else { return }
+            for hostname in pending {
+                do {
+                    _ = try mintAndStore(for: hostname)
+                } catch {
+                    logger.warning("[MITM] pre-mint failed for \(hostname): \(error)")
+                    return
+                }
+            }
         }
     }
 
@@ -85,25 +158,41 @@ final class MITMLeafCertCache {
         lock.lock()
         entries[normalized] = CacheEntry(leaf: leaf, lastAccess: Date())
         evictIfNeededUnlocked()
+        let shouldSchedule = !persistScheduled
+        persistScheduled = true
         lock.unlock()
+        if shouldSchedule {
+            Self.mintQueue.asyncAfter(deadline: .now() + Self.persistDelay) { [weak self] in
+                self?.persist()
+            }
+        }
         return leaf
     }
 
+    /// Writes every cached leaf to disk; runs once per burst of mints.
+    private func persist() {
+        let leaves: [(hostname: String, certificateDER: Data, expiry: Date)] = lock.withLock {
+            persistScheduled = false
+            return entries.map { (hostname: $0.key, certificateDER: $0.value.leaf.certificateDER, expiry: $0.value.leaf.expiry) }
+        }
+        guard let caCertificateDER = store.loadCA()?.certificateDER else { return }
+        diskStore.save(
+            MITMLeafCertDiskStore.Snapshot(leafKey: leafPrivateKey, leaves: leaves),
+            caCertificateDER: caCertificateDER
+        )
+    }
+
     private func mintLeaf(for hostname: String) throws -> Leaf {
         guard let (caKey, caCertDER) = store.loadCA() else {
             throw MITMCertificateStoreError.missingCAComponents
         }
 
-        let now = Date()
-        let serial = store.nextSerial()
+        let template = try leafTemplate(caCertificateDER: caCertDER)
         let der = try X509Builder.buildLeafCertificate(
-            leafPublicKey: leafPrivateKey.publicKey,
+            template: template,
             caPrivateKey: caKey,
-            caCertificateDER: caCertDER,
             hostname: hostname,
-            serial: serial,
-            notBefore: now.addingTimeInterval(-60 * 60),
-            notAfter: now.addingTimeInterval(Self.validity)
+            serial: store.nextSerial()
         )
 
         guard let secCert = SecCertificateCreateWithData(nil, der as CFData) else {
@@ -115,8 +204,37 @@ final class MITMLeafCertCache {
             certificateDER: der,
             privateKeySecKey: leafPrivateKeySecKey,
             privateKey: leafPrivateKey,
-            expiry: now.addingTimeInterval(Self.validity)
+            expiry: template.notAfter
+        )
+    }
+
+    /// The shared leaf template for `caCertificateDER`, re-encoded when the CA changes or
+    /// its validity window is `templateLifetime` old.
+    private func leafTemplate(caCertificateDER: Data) throws -> X509Builder.LeafTemplate {
+        let now = Date()
+        let cached: X509Builder.LeafTemplate? = lock.withLock { template }
+        if let cached, cached.caCertificateDER == caCertificateDER,
+           now.timeIntervalSince(cached.notBefore) < Self.backdate + Self.templateLifetime {
+            return cached
+        }
+        let fresh = try X509Builder.makeLeafTemplate(
+            leafPublicKey: leafPrivateKey.publicKey,
+            caCertificateDER: caCertificateDER,
+            notBefore: now.addingTimeInterval(-Self.backdate),
+            notAfter: now.addingTimeInterval(Self.validity)
         )
+        lock.withLock { template = fresh }
+        return fresh
+    }
+
+    /// Keeps only the `count` most recently used leaves in memory; the disk copy is left
+    /// alone, so the next persist simply writes the smaller set.
+    func trim(keeping count: Int) {
+        lock.withLock {
+            guard entries.count > count else { return }
+            let keep = entries.sorted { $0.value.lastAccess > $1.value.lastAccess }.prefix(count)
+            entries = Dictionary(uniqueKeysWithValues: keep.map { ($0.key, $0.value) })
+        }
     }
 
     private func evictIfNeededUnlocked() {
@@ -0,0 +1,84 @@
+//
+//  MITMLeafCertDiskStore.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import CryptoKit
+
+nonisolated private let logger = AnywhereLogger(category: "MITMLeafCertDiskStore")
+
+/// Persists `MITMLeafCertCache` across tunnel restarts: the shared leaf key plus every minted
+/// leaf, as one AES-GCM-sealed plist in the App Group container. The seal key lives in the
+/// keychain next to the CA, and the file records a digest of the CA it was minted under, so a
+/// regenerated or deleted CA orphans the file instead of serving leaves it never signed.
+final class MITMLeafCertDiskStore {
+
+    struct Snapshot {
+        let leafKey: P256.Signing.PrivateKey
+        let leaves: [(hostname: String, certificateDER: Data, expiry: Date)]
+    }
+
+    private static let formatVersion = 1
+
+    private let store: MITMCertificateStore
+    private let fileURL: URL?
+
+    init(store: MITMCertificateStore, appGroup: String = AWCore.Identifier.appGroupSuite) {
+        self.store = store
+        if let container = FileManager.default.containerURL(forSecurityApplicationGroupIdentifier: appGroup) {
+            fileURL = container.appendingPathComponent("MITMLeafCache.bin")
+        } else {
+            fileURL = nil
+        }
+    }
+
+    /// Nil when there's no file, it doesn't open under the current seal key, or it was minted
+    /// under another CA.
+    func load(caCertificateDER: Data) -> Snapshot? {
+        guard let fileURL,
+              let sealed = try? Data(contentsOf: fileURL),
+              let key = store.loadOrCreateLeafCacheKey(),
+              let box = try? AES.GCM.SealedBox(combined: sealed),
+              let plain = try? AES.GCM.open(box, using: key),
+              let object = try? PropertyListSerialization.propertyList(from: plain, options: [], format: nil),
+              let root = object as? [String: Any],
+              root["version"] as? Int == Self.formatVersion,
+              root["ca"] as? Data == Self.digest(caCertificateDER),
+              let rawKey = root["key"] as? Data,
+              let leafKey = try? P256.Signing.PrivateKey(rawRepresentation: rawKey),
+              let entries = root["leaves"] as? [[String: Any]]
+        else { return nil }
+        let leaves = entries.compactMap { entry -> (hostname: String, certificateDER: Data, expiry: Date)? in
+            guard let hostname = entry["host"] as? String,
+                  let der = entry["der"] as? Data,
+                  let expiry = entry["expiry"] as? Date else { return nil }
+            return (hostname: hostname, certificateDER: der, expiry: expiry)
+        }
+        return Snapshot(leafKey: leafKey, leaves: leaves)
+    }
+
+    func save(_ snapshot: Snapshot, caCertificateDER: Data) {
+        guard let fileURL, let key = store.loadOrCreateLeafCacheKey() else { return }
+        let root: [String: Any] = [
+            "version": Self.formatVersion,
+            "ca": Self.digest(caCertificateDER),
+            "key": snapshot.leafKey.rawRepresentation,
+            "leaves": snapshot.leaves.map { ["host": $0.hostname, "der": $0.certificateDER, "expiry": $0.expiry] },
+        ]
+        do {
+            let plain = try PropertyListSerialization.data(fromPropertyList: root, format: .binary, options: 0)
+            guard let sealed = try AES.GCM.seal(plain, using: key).combined else { return }
+            // FirstUserAuthentication protection lets a background tunnel restart read it while locked.
+            try sealed.write(to: fileURL, options: [.atomic, .completeFileProtectionUntilFirstUserAuthentication])
+        } catch {
+            logger.warning("[MITM] leaf cache write failed: \(error)")
+        }
+    }
+
+    private static func digest(_ der: Data) -> Data {
+        Data(SHA256.hash(data: der))
+    }
+}
@@ -154,6 +154,10 @@ final class MITMRewritePolicy {
     /// Guards trie + setCount; reload holds it across the full rebuild so lookups never see a half-built trie.
     private let lock = UnfairLock()
 
+    /// Script rules whose compile ``load(ruleSets:prewarmScripts:)`` left for
+    /// ``prewarmDeferredScripts()``; guarded by `lock`.
+    private var deferredPrewarm: [(scope: UUID, rules: [CompiledMITMRule])]?
+
     /// lwIP fast path: keeps the no-rules case at a single bool check.
     var hasRules: Bool { lock.withLock { setCount > 0 } }
 
@@ -166,11 +170,13 @@ final class MITMRewritePolicy {
         trie = FlatLabelTrie<Int16>()
         compiledSets = []
         setCount = 0
+        deferredPrewarm = nil
     }
 
     /// Replaces the rule set table. Bad rules are dropped (logged) without
-    /// dropping their set; on duplicate suffixes the later set wins.
-    func load(ruleSets: [MITMRuleSet]) {
+    /// dropping their set; on duplicate suffixes the later set wins. With
+    /// `prewarmScripts` false, script compilation waits for ``prewarmDeferredScripts()``.
+    func load(ruleSets: [MITMRuleSet], prewarmScripts: Bool = true) {
         var scopedRules: [(scope: UUID, rules: [CompiledMITMRule])] = []
         lock.withLock {
             resetUnlocked()
@@ -182,6 +188,7 @@ final class MITMRewritePolicy {
                 }
             }
             trie.freeze()
+            deferredPrewarm = prewarmScripts ? nil : scopedRules
         }
         // Purge JS engine state for deleted sets; edited sets (stable id) keep theirs.
         let activeIDs = Set(ruleSets.map { $0.id })
@@ -189,7 +196,9 @@ final class MITMRewritePolicy {
         // Surface each set's resolved parameters to scripts as Anywhere.params.
         MITMParamStore.shared.replaceAll(ruleSets.map { (scope: $0.id, values: $0.parameterValues) })
         // Prewarm compile caches so the first intercepted flow doesn't pay cold-start inline.
-        MITMScriptTransform.prewarm(scopedRules: scopedRules)
+        if prewarmScripts {
+            MITMScriptTransform.prewarm(scopedRules: scopedRules)
+        }
         let purged = MITMScriptStore.shared.purgeExcept(activeIDs: activeIDs)
         if purged > 0 {
             logger.debug("Loaded \(ruleSets.count) rule set(s); purged \(purged) stale script-store bucket(s)")
@@ -198,6 +207,16 @@ final class MITMRewritePolicy {
         }
     }
 
+    /// Runs the script prewarm a deferred ``load(ruleSets:prewarmScripts:)`` skipped;
+    /// a no-op once done or after a reload that prewarmed itself.
+    func prewarmDeferredScripts() {
+        guard let scopedRules = lock.withLock({ () -> [(scope: UUID, rules: [CompiledMITMRule])]? in
+            defer { deferredPrewarm = nil }
+            return deferredPrewarm
+        }) else { return }
+        MITMScriptTransform.prewarm(scopedRules: scopedRules)
+    }
+
     /// Inserts one rule set and returns its compiled rules, or nil without a usable suffix. Caller must hold `lock`.
     private func insertUnlocked(_ set: MITMRuleSet) -> [CompiledMITMRule]? {
         let suffixes = set.domainSuffixes
@@ -240,6 +259,15 @@ final class MITMRewritePolicy {
         set(for: host) != nil
     }
 
+    /// Every loaded domain suffix that is itself a hostname, in load order — the hosts worth
+    /// minting leaves for ahead of traffic. A suffix also covers subdomains, which can't be known.
+    var premintHostnames: [String] {
+        lock.withLock {
+            compiledSets.map { $0.domainSuffix.hasPrefix(".") ? String($0.domainSuffix.dropFirst()) : $0.domainSuffix }
+                .filter { $0.contains(".") && !$0.contains("*") }
+        }
+    }
+
     /// Returns the most-specific rule set covering ``host``, or nil.
     func set(for host: String) -> CompiledMITMRuleSet? {
         guard !host.isEmpty else { return nil }
@@ -253,6 +281,26 @@ final class MITMRewritePolicy {
         }
     }
 
+    /// The parent domain a wildcard leaf for ``host`` may be minted for, or nil. Only a host
+    /// one label below a name its rule set's suffix covers folds, so every sibling the
+    /// wildcard matches is one the policy intercepts anyway; apex hosts, IP literals and
+    /// single-label parents (which SecTrust rejects under a wildcard) stay exact.
+    func wildcardParent(for host: String) -> String? {
+        guard let set = set(for: host) else { return nil }
+        let lowered = host.lowercased()
+        guard !lowered.hasPrefix("["),
+              let dot = lowered.firstIndex(of: "."),
+              dot != lowered.startIndex,
+              !lowered[..<dot].contains("*") else { return nil }
+        let parent = String(lowered[lowered.index(after: dot)...])
+        guard parent.contains("."),
+              let tld = parent.split(separator: ".").last,
+              !tld.allSatisfy(\.isNumber) else { return nil }
+        let suffix = set.domainSuffix.hasPrefix(".") ? String(set.domainSuffix.dropFirst()) : set.domainSuffix
+        guard parent == suffix || parent.hasSuffix("." + suffix) else { return nil }
+        return parent
+    }
+
     /// Rules from the most-specific set matching ``host``, filtered to ``phase``.
     func rules(for host: String, phase: MITMPhase) -> [CompiledMITMRule] {
         guard let set = set(for: host) else { return [] }
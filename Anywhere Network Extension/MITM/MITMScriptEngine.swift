@@ -20,7 +20,8 @@ private let mitmScriptTypedArrayLock = UnfairLock()
 private nonisolated(unsafe) var mitmScriptGlobalFetchCount: Int = 0
 private let mitmScriptGlobalFetchLock = UnfairLock()
 
-/// One JSContext per rule set, functions cached by source hash. JS cannot be preempted
+/// One JSContext per rule set, functions cached by source hash; each rule set runs on the
+/// script lane its scope hashes to. JS cannot be preempted
 /// (the execution-time-limit SPI is App Review-flagged); a hung sync span trips MITMScriptWatchdog,
 /// an unsettled promise is reverted by the idle watchdog.
 final class MITMScriptEngine {
@@ -122,15 +123,41 @@ final class MITMScriptEngine {
     }
     private var compiled: [Int: CompiledEntry] = [:]
 
+    /// Builds the `process(ctx)` argument in one call; a property-by-property build crosses the
+    /// ObjC bridge once per field and once more per header pair. Installed per context, before
+    /// any user script runs.
+    private var messageBuilder: JSValue?
+    private var frameBuilder: JSValue?
+
+    /// Headers arrive as a flat `[name, value, ...]` list (one bridged array, not one per pair);
+    /// an object literal defines its fields, so prototype setters a script installs never fire.
+    private static let messageBuilderSource = #"""
+    (function (phase, method, url, originalUrl, status, flatHeaders, body) {
+        "use strict";
+        var headers = [];
+        for (var i = 0; i + 1 < flatHeaders.length; i += 2) headers[i >> 1] = [flatHeaders[i], flatHeaders[i + 1]];
+        return { phase: phase, method: method, url: url, originalUrl: originalUrl, status: status, headers: headers, body: body };
+    })
+    """#
+
+    private static let frameBuilderSource = #"""
+    (function (phase, method, url, originalUrl, status, flatHeaders, index, end, state, body) {
+        "use strict";
+        var headers = [];
+        for (var i = 0; i + 1 < flatHeaders.length; i += 2) headers[i >> 1] = [flatHeaders[i], flatHeaders[i + 1]];
+        return { phase: phase, method: method, url: url, originalUrl: originalUrl, status: status, headers: headers,
+                 frame: { index: index, end: end }, state: state, body: body };
+    })
+    """#
+
     /// Invocation whose synchronous JS span is running right now; nil between spans.
     private var currentInvocation: Invocation?
 
     /// Suspended async invocations, retained until delivery so weak captures in fetch/settle closures stay valid.
     private var liveInvocations: [ObjectIdentifier: Invocation] = [:]
 
-    /// Shared across all engines: per-rule-set VMs would multiply JSC's multi-MiB per-VM
-    /// overhead beyond the NE's ~50 MiB budget. JSC serializes heap access internally.
-    private static let sharedVM: JSVirtualMachine = JSVirtualMachine()!
+    /// The lane whose VM owns `context`; every span on this engine runs on `lane.queue`.
+    let lane: Lane
 
     /// Serializes synchronous JS spans and guards `currentInvocation`/`compiled`; never held across an `await`.
     private let invocationLock = NSLock()
@@ -157,8 +184,9 @@ final class MITMScriptEngine {
     /// override to throw and recurse the exception handler until the NE stack-overflows.
     private var isFormattingException = false
 
-    init() {
-        self.context = JSContext(virtualMachine: Self.sharedVM)
+    init(lane: Lane) {
+        self.lane = lane
+        self.context = JSContext(virtualMachine: lane.vm)
         configureContext()
     }
 
@@ -180,13 +208,41 @@ final class MITMScriptEngine {
             }
         }
         installAnywhereGlobals()
+        messageBuilder = Self.callableOrNil(context.evaluateScript(Self.messageBuilderSource))
+        frameBuilder = Self.callableOrNil(context.evaluateScript(Self.frameBuilderSource))
+        context.exception = nil
+    }
+
+    private static func callableOrNil(_ value: JSValue?) -> JSValue? {
+        guard let value, value.isObject, !value.isUndefined else { return nil }
+        return value
+    }
+
+    private static func flatHeaders(_ headers: [(name: String, value: String)]) -> [String] {
+        var flat: [String] = []
+        flat.reserveCapacity(headers.count * 2)
+        for header in headers {
+            flat.append(header.name)
+            flat.append(header.value)
+        }
+        return flat
+    }
+
+    /// Runs a ctx builder; nil (caller builds field by field) if it threw or returned a non-object.
+    private func build(with builder: JSValue?, _ arguments: [Any]) -> JSValue? {
+        guard let builder, let object = builder.call(withArguments: arguments) else { return nil }
+        if context.exception != nil {
+            context.exception = nil
+            return nil
+        }
+        return object.isObject ? object : nil
     }
 
     /// Wraps one synchronous JSC span with the ``MITMScriptWatchdog`` hard cap.
     @inline(__always)
     private func runUserScript<T>(_ label: String, _ body: () -> T) -> T {
-        MITMScriptWatchdog.begin(label)
-        defer { MITMScriptWatchdog.end() }
+        MITMScriptWatchdog.begin(label, lane: lane.index)
+        defer { MITMScriptWatchdog.end(lane: lane.index) }
         return body()
     }
 
@@ -337,7 +393,7 @@ final class MITMScriptEngine {
             self.deliver(.modified(original), for: inv)
         }
         inv.watchdog = item
-        MITMScriptTransform.scriptQueue.asyncAfter(deadline: .now() + Self.invocationIdleTimeout, execute: item)
+        lane.queue.asyncAfter(deadline: .now() + Self.invocationIdleTimeout, execute: item)
     }
 
     /// Nudges JSC's GC (unaware of pinned NoCopy buffers) past the soft budget.
@@ -411,7 +467,7 @@ final class MITMScriptEngine {
         _ = compileIfNeeded(source, key: sourceKey)
     }
 
-    /// Drops cache entries not in ``keep``. Must be called on the script queue
+    /// Drops cache entries not in ``keep``. Must be called on the engine's lane queue
     /// so dropped JSValues release on the VM-owning queue.
     func pruneCompiled(keeping keep: Set<Int>) {
         invocationLock.lock()
@@ -420,7 +476,7 @@ final class MITMScriptEngine {
         for key in stale { compiled.removeValue(forKey: key) }
     }
 
-    /// Reload reset. Script-queue only.
+    /// Reload reset. Lane-queue only.
     fileprivate func resetOnReload(keepingCompiled keep: Set<Int>) {
         invocationLock.lock()
         defer { invocationLock.unlock() }
@@ -430,7 +486,7 @@ final class MITMScriptEngine {
             return
         }
         compiled.removeAll()
-        context = JSContext(virtualMachine: Self.sharedVM)
+        context = JSContext(virtualMachine: lane.vm)
         configureContext()
     }
 
@@ -469,6 +525,14 @@ final class MITMScriptEngine {
     // MARK: - Context bridging
 
     private func makeContextValue(_ msg: Message) -> JSValue {
+        let body = Self.makeUint8Array(in: context, from: msg.body)
+        if let object = build(with: messageBuilder, [
+            msg.phase == .httpRequest ? "request" : "response",
+            msg.method as Any, msg.url as Any, msg.originalUrl as Any, msg.status as Any,
+            Self.flatHeaders(msg.headers), body,
+        ]) {
+            return object
+        }
         let object = JSValue(newObjectIn: context)!
         object.setObject(
             msg.phase == .httpRequest ? "request" : "response",
@@ -481,7 +545,7 @@ final class MITMScriptEngine {
         // [[name, value], ...] preserves duplicates and emit order.
         let pairs: [[String]] = msg.headers.map { [$0.name, $0.value] }
         object.setObject(pairs, forKeyedSubscript: "headers" as NSString)
-        object.setObject(Self.makeUint8Array(in: context, from: msg.body), forKeyedSubscript: "body" as NSString)
+        object.setObject(body, forKeyedSubscript: "body" as NSString)
         return object
     }
 
@@ -492,6 +556,22 @@ final class MITMScriptEngine {
         frame: Data,
         state: JSValue?
     ) -> JSValue {
+        // Using a JSValue in a context other than its own is UB in JSC; reset a
+        // stale cursor that survived a rule reload / engine swap rather than trap.
+        let stateValue: JSValue
+        if let state, state.context === context {
+            stateValue = state
+        } else {
+            stateValue = JSValue(newObjectIn: context)!
+        }
+        let body = Self.makeUint8Array(in: context, from: frame)
+        if let object = build(with: frameBuilder, [
+            ctx.phase == .httpRequest ? "request" : "response",
+            ctx.method as Any, ctx.url as Any, ctx.originalUrl as Any, ctx.status as Any,
+            Self.flatHeaders(ctx.headers), ctx.frameIndex, ctx.isLast, stateValue, body,
+        ]) {
+            return object
+        }
         let object = JSValue(newObjectIn: context)!
         object.setObject(
             ctx.phase == .httpRequest ? "request" : "response",
@@ -508,18 +588,8 @@ final class MITMScriptEngine {
         frameInfo.setObject(ctx.frameIndex, forKeyedSubscript: "index" as NSString)
         frameInfo.setObject(ctx.isLast, forKeyedSubscript: "end" as NSString)
         object.setObject(frameInfo, forKeyedSubscript: "frame" as NSString)
-
-        // Using a JSValue in a context other than its own is UB in JSC; reset a
-        // stale cursor that survived a rule reload / engine swap rather than trap.
-        let stateValue: JSValue
-        if let state, state.context === context {
-            stateValue = state
-        } else {
-            stateValue = JSValue(newObjectIn: context)!
-        }
         object.setObject(stateValue, forKeyedSubscript: "state" as NSString)
-
-        object.setObject(Self.makeUint8Array(in: context, from: frame), forKeyedSubscript: "body" as NSString)
+        object.setObject(body, forKeyedSubscript: "body" as NSString)
         return object
     }
 
@@ -1577,7 +1647,7 @@ final class MITMScriptEngine {
                 // timeoutInterval bounds inactivity; resourceTimeout is the wall-clock cap.
                 resourceTimeout: Self.invocationIdleTimeout
             ) { result in
-                MITMScriptTransform.scriptQueue.async {
+                self.lane.queue.async {
                     Self.releaseGlobalFetchSlot()
                     guard let inv else { return }   // delivered/torn down — drop
                     self.resumeFetch(inv: inv, resolve: resolve, reject: reject, result: result)
@@ -2118,8 +2188,40 @@ final class MITMScriptEngine {
 
 extension MITMScriptEngine {
 
-    /// Process-wide registry of engines keyed by rule-set id. Serialization comes from the script
-    /// queue, NOT the lwIP queue — calling apply/applyFrame there would race the shared JSContext.
+    /// A JSVirtualMachine and the serial queue that owns it. Rule sets are pinned to a lane by
+    /// scope, so independent rule sets run scripts in parallel while each VM stays single-threaded.
+    final class Lane {
+        let index: Int
+        let queue: DispatchQueue
+
+        /// Created on first use (under the registry lock), so an idle lane costs no VM.
+        private(set) lazy var vm: JSVirtualMachine = JSVirtualMachine()!
+
+        init(index: Int, queue: DispatchQueue) {
+            self.index = index
+            self.queue = queue
+        }
+    }
+
+    /// Sized to the active cores but capped: every VM adds JSC's multi-MiB per-VM overhead against
+    /// the NE's ~50 MiB budget. Lane 0 runs on `MITMScriptTransform.scriptQueue`.
+    static let lanes: [Lane] = {
+        let count = min(max(ProcessInfo.processInfo.activeProcessorCount / 2, 1), 3)
+        return (0..<count).map { index in
+            let queue = index == 0
+                ? MITMScriptTransform.scriptQueue
+                : DispatchQueue(label: "\(AWCore.Identifier.mitmScriptQueue).\(index)", qos: .userInitiated)
+            return Lane(index: index, queue: queue)
+        }
+    }()
+
+    static func lane(forScope scope: UUID?) -> Lane {
+        guard let scope else { return lanes[0] }
+        return lanes[Int(UInt(bitPattern: scope.hashValue) % UInt(lanes.count))]
+    }
+
+    /// Process-wide registry of engines keyed by rule-set id. Serialization comes from each engine's
+    /// lane queue, NOT the lwIP queue — calling apply/applyFrame there would race the JSContext.
     private static var engines: [UUID: MITMScriptEngine] = [:]
     private static var scopelessEngine: MITMScriptEngine?
     private static let registryLock = UnfairLock()
@@ -2128,12 +2230,12 @@ extension MITMScriptEngine {
         registryLock.withLock { () -> MITMScriptEngine in
             guard let scope else {
                 if let engine = scopelessEngine { return engine }
-                let engine = MITMScriptEngine()
+                let engine = MITMScriptEngine(lane: lane(forScope: nil))
                 scopelessEngine = engine
                 return engine
             }
             if let engine = engines[scope] { return engine }
-            let engine = MITMScriptEngine()
+            let engine = MITMScriptEngine(lane: lane(forScope: scope))
             engines[scope] = engine
             return engine
         }
@@ -2146,19 +2248,24 @@ extension MITMScriptEngine {
             return removed
         }
         guard !dropped.isEmpty else { return }
-        // Hold the dropped engines until the queue drains them so their final release lands on the
+        // Hold each dropped engine until its lane drains it so the final release lands on the
         // VM-owning queue.
-        MITMScriptTransform.scriptQueue.async { withExtendedLifetime(dropped) {} }
+        for engine in dropped {
+            engine.lane.queue.async { withExtendedLifetime(engine) {} }
+        }
     }
 
     /// Reload reset for the engines that survive ``purgeEngines``.
     static func resetCachesOnReload(keepByScope: [UUID: Set<Int>]) {
-        MITMScriptTransform.scriptQueue.async {
-            let snapshot: [(engine: MITMScriptEngine, keep: Set<Int>)] = registryLock.withLock {
-                engines.map { (engine: $0.value, keep: keepByScope[$0.key] ?? []) }
-            }
-            for item in snapshot {
-                item.engine.resetOnReload(keepingCompiled: item.keep)
+        for lane in lanes {
+            lane.queue.async {
+                let snapshot: [(engine: MITMScriptEngine, keep: Set<Int>)] = registryLock.withLock {
+                    engines.filter { $0.value.lane === lane }
+                        .map { (engine: $0.value, keep: keepByScope[$0.key] ?? []) }
+                }
+                for item in snapshot {
+                    item.engine.resetOnReload(keepingCompiled: item.keep)
+                }
             }
         }
     }
@@ -2168,5 +2275,7 @@ extension MITMScriptEngine {
         private let scope: UUID?
         init(scope: UUID?) { self.scope = scope }
         func get() -> MITMScriptEngine { MITMScriptEngine.sharedEngine(forScope: scope) }
+        /// The lane queue every call into this rule set's engine must run on.
+        var queue: DispatchQueue { MITMScriptEngine.lane(forScope: scope).queue }
     }
 }
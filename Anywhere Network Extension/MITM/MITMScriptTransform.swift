@@ -12,14 +12,15 @@ import JavaScriptCore
 /// collide on rule-set-scoped store keys and the single-valued per-stream state slot.
 enum MITMScriptTransform {
 
-    /// Serial queue carrying every script invocation (off the lwIP queue, so a slow process(ctx)
-    /// parks only its connection). Serial ordering keeps FrameCursor from concurrent touches.
+    /// Serial queue of script lane 0 (see `MITMScriptEngine.lanes`), off the lwIP queue so a slow
+    /// process(ctx) parks only its connection; it also carries native body edits for sessions
+    /// without an engine. Serial ordering keeps FrameCursor from concurrent touches.
     static let scriptQueue = DispatchQueue(
         label: AWCore.Identifier.mitmScriptQueue,
         qos: .userInitiated
     )
 
-    /// Compiles every script rule on scriptQueue at (re)configuration time so cold-start cost doesn't
+    /// Compiles every script rule on its lane at (re)configuration time so cold-start cost doesn't
     /// land on the first intercepted flow. One async dispatch per scope so real calls can interleave.
     static func prewarm(scopedRules: [(scope: UUID, rules: [CompiledMITMRule])]) {
         // scope → its deduped script/streamScript sources (the same source on multiple rules compiles once).
@@ -41,7 +42,7 @@ enum MITMScriptTransform {
         MITMScriptEngine.resetCachesOnReload(keepByScope: keepByScope)
         // Precompile per scope.
         for (scope, scripts) in scriptsByScope {
-            scriptQueue.async {
+            MITMScriptEngine.lane(forScope: scope).queue.async {
                 let engine = MITMScriptEngine.sharedEngine(forScope: scope)
                 for script in scripts {
                     engine.precompile(source: script.source, sourceKey: script.sourceKey)
@@ -143,7 +144,7 @@ enum MITMScriptTransform {
     }
 
     /// All matching `.bodyJSON` edits in rule order; unlike `.script`, every match is returned so edits compose.
-    private static func matchingBodyJSONOps(
+    static func matchingBodyJSONOps(
         in rules: [CompiledMITMRule],
         requestURL: String?
     ) -> [MITMJSONPatch.CompiledOp] {
@@ -157,7 +158,7 @@ enum MITMScriptTransform {
     }
 
     /// All matching `.bodyReplace` edits in rule order; every match composes over the running body text.
-    private static func matchingBodyReplaceOps(
+    static func matchingBodyReplaceOps(
         in rules: [CompiledMITMRule],
         requestURL: String?
     ) -> [MITMBodyReplace.CompiledOp] {
@@ -170,7 +171,7 @@ enum MITMScriptTransform {
         return ops
     }
 
-    /// Runs native body edits and the matching `.script` rule on scriptQueue. An awaiting
+    /// Runs native body edits and the matching `.script` rule on the rule set's lane. An awaiting
     /// process(ctx) suspends without holding the queue; `completion` fires exactly once on
     /// `resumeQueue`, and `message` is a value copy never aliased to the caller's buffer.
     static func apply(
@@ -180,7 +181,7 @@ enum MITMScriptTransform {
         resumeOn resumeQueue: DispatchQueue,
         completion: @escaping (Outcome) -> Void
     ) {
-        scriptQueue.async {
+        (engineProvider?.queue ?? scriptQueue).async {
             let requestURL = message.url
             let edited = applyNativeBodyEdits(message, rules: rules)
             guard let match = lastMatchingScriptSource(in: rules, requestURL: requestURL),
@@ -207,25 +208,31 @@ enum MITMScriptTransform {
 
     /// Per-stream cursor threaded through each applyFrame call.
     final class FrameCursor {
-        /// Script's persistent per-stream state; only ever touched on scriptQueue (deinit hops its release there).
+        /// Script's persistent per-stream state; only ever touched on `stateQueue` (deinit hops its release there).
         var state: JSValue?
+        /// Lane queue of the engine that owns `state`.
+        var stateQueue: DispatchQueue?
         /// Set by a done/exit directive; subsequent frames bypass the script.
         var bypass: Bool = false
+        /// Native body rules streamed in place of a script; when set, frames never reach the engine.
+        var nativeRewriter: MITMStreamingBodyRewriter?
         /// Outer nil = unresolved, `.some(nil)` = no rule matches.
         fileprivate var resolvedMatch: ScriptMatch??
         init() {}
 
         deinit {
             // state's final release runs JSValueUnprotect, which mutates VM bookkeeping; off
-            // scriptQueue that would race in-flight scripts and corrupt the VM heap.
+            // the owning lane that would race in-flight scripts and corrupt the VM heap.
             guard let state else { return }
-            MITMScriptTransform.scriptQueue.async { withExtendedLifetime(state) {} }
+            (stateQueue ?? MITMScriptTransform.scriptQueue).async { withExtendedLifetime(state) {} }
         }
     }
 
     struct StreamFrameResult {
         let body: Data
         let bypass: Bool
+        /// The native rewriter hit a corrupt coded body; the stream must be closed.
+        var failed = false
     }
 
     /// Runs the last matching `.streamScript` rule against one frame. `Anywhere.done`/`exit`
@@ -237,6 +244,10 @@ enum MITMScriptTransform {
         cursor: FrameCursor,
         engineProvider: MITMScriptEngine.Provider?
     ) -> StreamFrameResult {
+        if let native = cursor.nativeRewriter {
+            let body = native.process(frame, isLast: frameContext.isLast)
+            return StreamFrameResult(body: body, bypass: false, failed: native.failed)
+        }
         let resolved: ScriptMatch?
         if let cached = cursor.resolvedMatch {
             resolved = cached
@@ -256,6 +267,7 @@ enum MITMScriptTransform {
         switch outcome {
         case .modified(let body, let state):
             cursor.state = state
+            cursor.stateQueue = engineProvider.queue
             return StreamFrameResult(body: body, bypass: false)
         case .done(let body):
             cursor.bypass = true
@@ -266,7 +278,7 @@ enum MITMScriptTransform {
         }
     }
 
-    /// Async counterpart: runs on scriptQueue, delivers on `resumeQueue` exactly once. Cursor
+    /// Async counterpart: runs on the rule set's lane, delivers on `resumeQueue` exactly once. Cursor
     /// mutation is safe because the caller keeps only one frame in flight at a time.
     static func applyFrame(
         _ frame: Data,
@@ -277,7 +289,7 @@ enum MITMScriptTransform {
         resumeOn resumeQueue: DispatchQueue,
         completion: @escaping (StreamFrameResult) -> Void
     ) {
-        scriptQueue.async {
+        (engineProvider?.queue ?? scriptQueue).async {
             let result = applyFrame(
                 frame,
                 rules: rules,
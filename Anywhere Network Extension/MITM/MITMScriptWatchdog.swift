@@ -13,7 +13,8 @@ enum MITMWatchdogMonitor {
 }
 
 /// JSC sync execution is uninterruptible, so crashing for a clean OS relaunch is the only recovery.
-/// A suspended `await` already called end(), so slow async fetches never trip this.
+/// A suspended `await` already called end(), so slow async fetches never trip this. Tracks one
+/// span per script lane, since lanes run concurrently.
 enum MITMScriptWatchdog {
 
     /// Hard wall-clock cap on one synchronous JS span; any legitimate span finishes far inside this.
@@ -23,9 +24,9 @@ enum MITMScriptWatchdog {
     private static let checkIntervalSeconds = 5
 
     private static let lock = UnfairLock()
-    private static var spanStart: DispatchTime?
-    /// Script source string surfaced in the crash report to identify the offending rule.
-    private static var spanLabel = ""
+    /// Lane index → start of its in-flight span, with the script source surfaced in the crash
+    /// report to identify the offending rule.
+    private static var spans: [Int: (start: DispatchTime, label: String)] = [:]
 
     /// Lazily started on the first begin().
     private static let sampler: DispatchSourceTimer = {
@@ -41,27 +42,29 @@ enum MITMScriptWatchdog {
     }()
 
     /// Marks a synchronous JS span as started; must be paired with end() (use `defer`) or a phantom span stays armed.
-    static func begin(_ label: String) {
+    static func begin(_ label: String, lane: Int) {
         _ = sampler
         lock.lock()
-        spanStart = .now()
-        spanLabel = label
+        spans[lane] = (start: .now(), label: label)
         lock.unlock()
     }
 
-    static func end() {
+    static func end(lane: Int) {
         lock.lock()
-        spanStart = nil
-        spanLabel = ""
+        spans[lane] = nil
         lock.unlock()
     }
 
     private static func checkInFlightSpan() {
         lock.lock()
-        let start = spanStart
-        let label = spanLabel
+        let inFlight = Array(spans.values)
         lock.unlock()
-        guard let start else { return }
+        for span in inFlight {
+            check(start: span.start, label: span.label)
+        }
+    }
+
+    private static func check(start: DispatchTime, label: String) {
         let elapsedNanos = DispatchTime.now().uptimeNanoseconds &- start.uptimeNanoseconds
         guard elapsedNanos >= UInt64(hardCapSeconds) * 1_000_000_000 else { return }
         let seconds = elapsedNanos / 1_000_000_000
@@ -372,17 +372,24 @@ final class MITMSession {
     // MARK: - Lifecycle
 
     /// Starts the inner leg — a TLS handshake for HTTPS, or a direct cleartext leg for plain HTTP —
-    /// and defers the upstream dial until the first request resolves the destination.
-    func start(sni: String) {
+    /// and defers the upstream dial until the first request resolves the destination. A
+    /// `clientHello` from the connection's sniffer stands in for parsing the buffered one.
+    func start(sni: String, clientHello: TLSClientHelloSniffer.ClientHello? = nil) {
         installStreamHandlers()
         guard !isPlaintext else {
             startPlaintext()
             return
         }
-        let parsed = parseClientHello(pendingClientBytes)
-        let clientALPNs = parsed?.alpnProtocols ?? []
-        // Unparseable ClientHello fails closed to TLS 1.2; any 1.3-capable client also speaks 1.2.
-        clientSupportsTLS13 = parsed?.supportedVersions.contains(0x0304) ?? false
+        let clientALPNs: [String]
+        if let clientHello {
+            clientALPNs = clientHello.alpnProtocols
+            clientSupportsTLS13 = clientHello.supportsTLS13
+        } else {
+            let parsed = parseClientHello(pendingClientBytes)
+            clientALPNs = parsed?.alpnProtocols ?? []
+            // Unparseable ClientHello fails closed to TLS 1.2; any 1.3-capable client also speaks 1.2.
+            clientSupportsTLS13 = parsed?.supportedVersions.contains(0x0304) ?? false
+        }
         startInnerHandshakeFromClientOffer(
             sni: sni,
             clientALPNs: clientALPNs,
@@ -501,7 +508,7 @@ final class MITMSession {
 
     private func startInnerHandshake(sni: String, alpns: [String], tlsVersions: Set<UInt16>) {
         guard let leafCache else { cancel(error: nil); return }
-        leafCache.leaf(for: sni) { [weak self] result in
+        leafCache.leaf(for: sni, wildcardParent: policy.wildcardParent(for: sni)) { [weak self] result in
             guard let self else { return }
             self.lwipQueue.async {
                 guard !self.torn else { return }
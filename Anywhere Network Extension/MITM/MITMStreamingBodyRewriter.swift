@@ -0,0 +1,102 @@
+//
+//  MITMStreamingBodyRewriter.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "MITMStreamingBodyRewriter")
+
+/// Native body rules applied chunk by chunk: incremental decode, then `.bodyJSON` edits through
+/// ``MITMJSONStreamEditor``, then `.bodyReplace` through ``MITMBodyReplace/StreamingReplacer``,
+/// the same order `MITMScriptTransform` applies them to a buffered body. Output is identity-coded.
+/// Lives on the stream's `FrameCursor`, so it's only touched on the script queue, one frame at a time.
+final class MITMStreamingBodyRewriter {
+    private let decoder: MITMBodyCodec.StreamDecoder?
+    private let jsonEditor: MITMJSONStreamEditor?
+    private let replacer: MITMBodyReplace.StreamingReplacer?
+    private let host: String
+
+    /// Set when the coded body turned out corrupt. `Content-Encoding` was already dropped from the
+    /// emitted head, so the caller must close rather than forward the remaining bytes.
+    private(set) var failed = false
+
+    /// Nil unless the matching rules are all native body edits that can run incrementally: a
+    /// `.script`/`.streamScript` needs the whole body or owns the frames, and `removeWhere…`
+    /// JSON filters need whole array elements.
+    static func make(
+        rules: [CompiledMITMRule],
+        requestURL: String?,
+        codec: MITMBodyCodec.Plan,
+        host: String
+    ) -> MITMStreamingBodyRewriter? {
+        guard codec.supported,
+              !MITMScriptTransform.hasScriptRule(in: rules, requestURL: requestURL),
+              !MITMScriptTransform.hasStreamScriptRule(in: rules, requestURL: requestURL)
+        else { return nil }
+        let jsonOps = MITMScriptTransform.matchingBodyJSONOps(in: rules, requestURL: requestURL)
+        let replaceOps = MITMScriptTransform.matchingBodyReplaceOps(in: rules, requestURL: requestURL)
+        guard !jsonOps.isEmpty || !replaceOps.isEmpty else { return nil }
+        var jsonEditor: MITMJSONStreamEditor?
+        if !jsonOps.isEmpty {
+            guard let editor = MITMJSONStreamEditor(ops: jsonOps) else { return nil }
+            jsonEditor = editor
+        }
+        var decoder: MITMBodyCodec.StreamDecoder?
+        if codec.requiresDecompression {
+            guard let streamDecoder = MITMBodyCodec.StreamDecoder(plan: codec) else { return nil }
+            decoder = streamDecoder
+        }
+        return MITMStreamingBodyRewriter(
+            decoder: decoder,
+            jsonEditor: jsonEditor,
+            replacer: replaceOps.isEmpty ? nil : MITMBodyReplace.StreamingReplacer(ops: replaceOps),
+            host: host
+        )
+    }
+
+    private init(
+        decoder: MITMBodyCodec.StreamDecoder?,
+        jsonEditor: MITMJSONStreamEditor?,
+        replacer: MITMBodyReplace.StreamingReplacer?,
+        host: String
+    ) {
+        self.decoder = decoder
+        self.jsonEditor = jsonEditor
+        self.replacer = replacer
+        self.host = host
+    }
+
+    /// Rewrites one frame of the coded body; `isLast` flushes everything still held.
+    func process(_ frame: Data, isLast: Bool) -> Data {
+        guard !failed else { return Data() }
+        var data = frame
+        if let decoder {
+            guard var decoded = decoder.decode(frame) else { return fail("decode failed mid-stream") }
+            if isLast {
+                guard let tail = decoder.finish() else { return fail("coded body ended mid-stream") }
+                decoded.append(tail)
+            }
+            data = decoded
+        }
+        if let jsonEditor {
+            var edited = jsonEditor.feed(data)
+            if isLast { edited.append(jsonEditor.finish()) }
+            data = edited
+        }
+        if let replacer {
+            var replaced = replacer.feed(data)
+            if isLast { replaced.append(replacer.finish()) }
+            data = replaced
+        }
+        return data
+    }
+
+    private func fail(_ reason: String) -> Data {
+        logger.warning("\(host): streaming body rewrite: \(reason); closing the connection")
+        failed = true
+        return Data()
+    }
+}
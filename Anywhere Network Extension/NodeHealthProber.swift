@@ -0,0 +1,187 @@
+//
+//  NodeHealthProber.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "NodeHealthProber")
+
+/// Scores an auto-select group's candidates and hands the best one to `onSelect`. Each node
+/// keeps a smoothed probe RTT and probe failure rate (EWMA, weight 1/4, as in
+/// `DNSUpstreamSelector`) from periodic `LatencyTester` rounds, and ``telemetry`` keeps the
+/// decayed failure rate of its live dials and connections; either one crossing the threshold
+/// demotes the node, and a dying selected node triggers an early round instead of waiting out
+/// the interval. Dials to the selected node race its healthiest stand-ins (see
+/// ``ProxyDialRace``), and a stand-in overtaking it counts as a failed dial. Probing runs here
+/// rather than in the app because only the extension's DNS answers with real addresses while
+/// the tunnel is up.
+final class NodeHealthProber {
+
+    private struct Health {
+        var smoothedRTT: Double?
+        var failureRate: Double = 0
+
+        var isHealthy: Bool {
+            smoothedRTT != nil && failureRate < TunnelConstants.healthProbeUnhealthyFailureRate
+        }
+
+        /// Latency inflated by unreliability, so a fast but flaky node loses to a steady one.
+        var score: Double {
+            (smoothedRTT ?? .infinity) * (1 + 2 * failureRate)
+        }
+
+        mutating func fold(_ result: LatencyResult) {
+            switch result {
+            case .success(let ms):
+                let sample = Double(ms)
+                smoothedRTT = smoothedRTT.map { $0 + (sample - $0) / 4 } ?? sample
+                foldOutcome(succeeded: true)
+            case .failed, .insecure:
+                foldOutcome(succeeded: false)
+            case .testing:
+                break
+            }
+        }
+
+        mutating func foldOutcome(succeeded: Bool) {
+            failureRate += ((succeeded ? 0 : 1) - failureRate) / 4
+        }
+    }
+
+    /// Called off `lwipQueue` whenever the selection changes.
+    var onSelect: ((ProxyConfiguration) -> Void)?
+
+    /// Live outcomes of every proxied node, group member or not; outlives group changes.
+    let telemetry = NodeTelemetry()
+
+    private let lock = UnfairLock()
+    private var group: AutoSelectGroup?
+    private var health: [UUID: Health] = [:]
+    private var selectedID: UUID?
+    private var loop: Task<Void, Never>?
+    private var lastRoundAt: CFAbsoluteTime = 0
+    /// Pokes the loop awake early after a live failure of the selected node.
+    private var wake: AsyncStream<Void>.Continuation?
+
+    /// Replaces the group; nil stops probing and keeps whatever node is selected.
+    func update(_ group: AutoSelectGroup?, current: ProxyConfiguration?) {
+        let (wakes, wake) = AsyncStream.makeStream(of: Void.self, bufferingPolicy: .bufferingNewest(1))
+        let previous: Task<Void, Never>? = lock.withLock {
+            let previous = loop
+            self.group = group
+            health = [:]
+            selectedID = current?.id
+            loop = nil
+            self.wake?.finish()
+            self.wake = group == nil ? nil : wake
+            return previous
+        }
+        previous?.cancel()
+        guard let group, !group.candidates.isEmpty else { return }
+        logger.info("[AutoSelect] Probing \(group.candidates.count) candidates (\(group.policy.rawValue))")
+        let task = Task { [weak self] in
+            while !Task.isCancelled {
+                guard let self else { return }
+                await self.runRound(group)
+                await self.sleepUntilNextRound(wakes: wakes)
+            }
+        }
+        lock.withLock { loop = task }
+    }
+
+    func stop() {
+        update(nil, current: nil)
+    }
+
+    /// Feeds one live outcome for `id`; a failure that leaves the selected node unhealthy asks
+    /// for an early round.
+    func record(_ id: UUID, _ outcome: NodeTelemetry.Outcome) {
+        telemetry.record(id, outcome)
+        if case .connected = outcome { return }
+        lock.withLock {
+            if id == selectedID, health[id] != nil, !isHealthy(id) {
+                wake?.yield()
+            }
+        }
+    }
+
+    /// What a dial to `configuration` races, in attempt order: `configuration` itself, then the
+    /// next healthy candidates the group's policy prefers. Just `configuration` unless it is the
+    /// group's current pick.
+    func raceCandidates(leading configuration: ProxyConfiguration) -> [ProxyConfiguration] {
+        lock.withLock {
+            guard let group, configuration.id == selectedID else { return [configuration] }
+            var standIns = group.candidates.filter { $0.id != configuration.id && isHealthy($0.id) }
+            if group.policy == .urlTest {
+                standIns.sort { score($0.id) < score($1.id) }
+            }
+            return [configuration] + standIns.prefix(TunnelConstants.dialRaceWidth - 1)
+        }
+    }
+
+    // MARK: - Private
+
+    private func runRound(_ group: AutoSelectGroup) async {
+        lock.withLock { lastRoundAt = CFAbsoluteTimeGetCurrent() }
+        for await outcome in LatencyTester.test(group.candidates) where !Task.isCancelled {
+            lock.withLock { health[outcome.id, default: Health()].fold(outcome.result) }
+        }
+        guard !Task.isCancelled else { return }
+        select(from: group)
+    }
+
+    private func select(from group: AutoSelectGroup) {
+        let choice: ProxyConfiguration? = lock.withLock {
+            let healthy = group.candidates.filter { isHealthy($0.id) }
+            let best: ProxyConfiguration?
+            switch group.policy {
+            case .fallback:
+                best = healthy.first
+            case .urlTest:
+                best = healthy.min { score($0.id) < score($1.id) }
+                // Stay on a healthy current node unless the winner clears the tolerance.
+                if let best, let selectedID, selectedID != best.id, isHealthy(selectedID),
+                   score(selectedID) - score(best.id) < TunnelConstants.healthProbeTolerance {
+                    return nil
+                }
+            }
+            guard let best, best.id != selectedID else { return nil }
+            selectedID = best.id
+            return best
+        }
+        guard let choice else { return }
+        logger.info("[AutoSelect] Selected \(choice.name)")
+        onSelect?(choice)
+    }
+
+    /// Probed healthy and not failing on live traffic. Call with `lock` held.
+    private func isHealthy(_ id: UUID) -> Bool {
+        guard health[id]?.isHealthy == true else { return false }
+        return (telemetry.failureRate(id) ?? 0) < TunnelConstants.healthProbeUnhealthyFailureRate
+    }
+
+    /// The probe score, inflated the same way by the live failure rate. Call with `lock` held.
+    private func score(_ id: UUID) -> Double {
+        (health[id]?.score ?? .infinity) * (1 + 2 * (telemetry.failureRate(id) ?? 0))
+    }
+
+    /// Sleeps out the interval, or less when a live failure wakes it — never under the floor.
+    private func sleepUntilNextRound(wakes: AsyncStream<Void>) async {
+        let untilFloor = lock.withLock { lastRoundAt } + TunnelConstants.healthProbeMinInterval - CFAbsoluteTimeGetCurrent()
+        try? await Task.sleep(for: .seconds(max(0, untilFloor)))
+        await withTaskGroup(of: Void.self) { group in
+            group.addTask {
+                try? await Task.sleep(for: .seconds(TunnelConstants.healthProbeInterval - TunnelConstants.healthProbeMinInterval))
+            }
+            group.addTask {
+                var iterator = wakes.makeAsyncIterator()
+                _ = await iterator.next()
+            }
+            _ = await group.next()
+            group.cancelAll()
+        }
+    }
+}
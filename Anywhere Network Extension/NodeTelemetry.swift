@@ -0,0 +1,120 @@
+//
+//  NodeTelemetry.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Live-traffic record per node: how its real dials and connections went, which a
+/// `LatencyTester` round only samples every few minutes. Successes and failures are weights
+/// that halve every `TunnelConstants.nodeTelemetryHalfLife`, so a node that degrades
+/// mid-session loses its standing within minutes and earns it back the same way. The table
+/// holds `TunnelConstants.nodeTelemetryCapacity` nodes; a node new to a full table replaces
+/// the one heard from least recently. Thread-safe.
+final class NodeTelemetry {
+
+    enum Outcome {
+        /// Dial and proxy handshake completed, in this many seconds.
+        case connected(TimeInterval)
+        /// The dial or the proxy handshake failed.
+        case connectFailed
+        /// An established connection failed mid-stream.
+        case reset
+    }
+
+    private struct Entry {
+        let id: UUID
+        var successes: Double = 0
+        var failures: Double = 0
+        var smoothedConnectTime: TimeInterval?
+        var updatedAt: TimeInterval
+
+        /// Share of recent outcomes that failed; nil until there is enough weight to judge.
+        var failureRate: Double? {
+            let total = successes + failures
+            return total >= TunnelConstants.nodeTelemetryMinimumWeight ? failures / total : nil
+        }
+
+        mutating func decay(to now: TimeInterval) {
+            let factor = exp2(-max(0, now - updatedAt) / TunnelConstants.nodeTelemetryHalfLife)
+            successes *= factor
+            failures *= factor
+            updatedAt = now
+        }
+
+        mutating func fold(_ outcome: Outcome) {
+            switch outcome {
+            case .connected(let connectTime):
+                successes += 1
+                // Same EWMA weight as the probe RTT in `NodeHealthProber`.
+                smoothedConnectTime = smoothedConnectTime.map { $0 + (connectTime - $0) / 4 } ?? connectTime
+            case .connectFailed, .reset:
+                failures += 1
+            }
+        }
+    }
+
+    private let lock = UnfairLock()
+    private var entries: [Entry] = []
+    private var slots: [UUID: Int] = [:]
+
+    init() {
+        entries.reserveCapacity(TunnelConstants.nodeTelemetryCapacity)
+    }
+
+    func record(_ id: UUID, _ outcome: Outcome) {
+        let now = MonotonicClock.now
+        lock.withLock {
+            if let slot = slots[id] {
+                entries[slot].decay(to: now)
+                entries[slot].fold(outcome)
+                return
+            }
+            var entry = Entry(id: id, updatedAt: now)
+            entry.fold(outcome)
+            if entries.count < TunnelConstants.nodeTelemetryCapacity {
+                slots[id] = entries.count
+                entries.append(entry)
+            } else if let slot = entries.indices.min(by: { entries[$0].updatedAt < entries[$1].updatedAt }) {
+                slots[entries[slot].id] = nil
+                slots[id] = slot
+                entries[slot] = entry
+            }
+        }
+    }
+
+    /// Decayed failure rate of `id`'s live traffic; nil for a node with too little of it.
+    func failureRate(_ id: UUID) -> Double? {
+        let now = MonotonicClock.now
+        return lock.withLock {
+            guard let slot = slots[id] else { return nil }
+            entries[slot].decay(to: now)
+            return entries[slot].failureRate
+        }
+    }
+
+    /// Every node in the table, for the app's proxy list.
+    func snapshot() -> [NodeHealthEntry] {
+        let now = MonotonicClock.now
+        return lock.withLock {
+            entries.indices.map { slot in
+                entries[slot].decay(to: now)
+                let entry = entries[slot]
+                return NodeHealthEntry(
+                    id: entry.id,
+                    failureRate: entry.failureRate,
+                    connectMs: entry.smoothedConnectTime.map { Int(($0 * 1000).rounded()) }
+                )
+            }
+        }
+    }
+
+    func removeAll() {
+        lock.withLock {
+            entries.removeAll(keepingCapacity: true)
+            slots.removeAll()
+        }
+    }
+}
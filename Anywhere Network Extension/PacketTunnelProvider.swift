@@ -45,15 +45,19 @@ class PacketTunnelProvider: NEPacketTunnelProvider {
             throw NSError(domain: AWCore.Identifier.errorDomain, code: 1, userInfo: [NSLocalizedDescriptionKey: "Invalid configuration"])
         }
         
+        logger.info("[VPN] Tuning profile: \(TuningProfile.current.name)")
+
         tunnelStack.onTunnelSettingsNeedReapply = { [weak self] in
             self?.reapplyTunnelSettings()
         }
         
-        let settings = buildTunnelSettings()
+        let settings = StartupSignposts.measure("buildTunnelSettings") { buildTunnelSettings() }
         
         Task {
             do {
+                let applying = StartupSignposts.begin("setTunnelNetworkSettings")
                 try await setTunnelNetworkSettings(settings)
+                StartupSignposts.end("setTunnelNetworkSettings", applying)
                 
 #if os(iOS)
                 if #available(iOS 18.0, *) {
@@ -67,9 +71,11 @@ class PacketTunnelProvider: NEPacketTunnelProvider {
                 self.statsRecorder.start {
                     return StatsRecorder.RawValues(
                         byteCounts: self.tunnelStack.byteCounts,
+                        heavyHitters: self.tunnelStack.heavyHitters,
                         tcpConnectionCount: self.tunnelStack.activeTCPConnections,
                         udpConnectionCount: self.tunnelStack.activeUDPConnections,
-                        memoryBytes: Self.memoryFootprint()
+                        memoryBytes: Self.memoryFootprint(),
+                        queueLoad: self.tunnelStack.queueLoad
                     )
                 }
             } catch {
@@ -86,7 +92,9 @@ class PacketTunnelProvider: NEPacketTunnelProvider {
         let hideVPNIcon = AWCore.getHideVPNIcon()
         let ipv4Settings = NEIPv4Settings(addresses: ["10.8.0.1"], subnetMasks: ["255.255.255.0"])
         ipv4Settings.includedRoutes = [NEIPv4Route.default()]
-        ipv4Settings.excludedRoutes = hideVPNIcon ? [NEIPv4Route(destinationAddress: "0.0.0.0", subnetMask: "255.255.255.254")] : []
+        let bypass = kernelBypassRoutes()
+        ipv4Settings.excludedRoutes = (hideVPNIcon ? [NEIPv4Route(destinationAddress: "0.0.0.0", subnetMask: "255.255.255.254")] : [])
+            + bypass.ipv4
         settings.ipv4Settings = ipv4Settings
 
         // Claiming IPv6 tunnel settings makes iOS show the VPN icon on cellular,
@@ -95,7 +103,7 @@ class PacketTunnelProvider: NEPacketTunnelProvider {
         if advertiseIPv6ToApps {
             let ipv6Settings = NEIPv6Settings(addresses: ["fd00::1"], networkPrefixLengths: [64])
             ipv6Settings.includedRoutes = [NEIPv6Route.default()]
-            ipv6Settings.excludedRoutes = []
+            ipv6Settings.excludedRoutes = bypass.ipv6
             settings.ipv6Settings = ipv6Settings
         }
 
@@ -109,11 +117,60 @@ class PacketTunnelProvider: NEPacketTunnelProvider {
         }
 
         settings.dnsSettings = NEDNSSettings(servers: plainDNSServers)
-        settings.mtu = 1500
+        settings.mtu = NSNumber(value: AWCore.getTunnelMTU().rawValue)
 
         return settings
     }
 
+    /// Kernel bypass: the country-bypass tier's DIRECT CIDRs and the country's GeoIP ranges
+    /// as excluded routes, so that IP-literal domestic traffic never enters utun. Empty
+    /// unless the option is on and the base mode is rule (global proxies everything).
+    private func kernelBypassRoutes() -> (ipv4: [NEIPv4Route], ipv6: [NEIPv6Route]) {
+        guard AWCore.getKernelBypassEnabled(), AWCore.getProxyMode() == .rule,
+              let data = AWCore.getRoutingData() else { return ([], []) }
+        typealias Prefix = RoutingCompiler.RoutePrefix
+        let reserved = [
+            Prefix(ipv4: 0x0A08_0000, length: 24),                               // 10.8.0.0/24, the tunnel subnet
+            Prefix(ipv4: TunnelConstants.fakeIPPoolBaseIPv4, length: 15),
+        ]
+        let reservedIPv6 = [
+            Prefix(hi: 0xFD00_0000_0000_0000, lo: 0, length: 64),                // fd00::/64, the tunnel subnet
+            Prefix(hi: 0x2001_0DB8_0000_0000, lo: 0, length: 96),                // the fake-IP pool
+        ]
+        let countryCode = AWCore.getBypassCountryCode()
+        var bypassIPv4: [Prefix] = []
+        if !countryCode.isEmpty, let geoIP = GeoIPTable(contentsOf: AWCore.geoIPTableURL),
+           let country = geoIP.countryIndex(for: countryCode) {
+            bypassIPv4 = geoIP.prefixes(ofCountry: country).map { Prefix(ipv4: $0.network, length: $0.length) }
+        }
+        guard let prefixes = RoutingCompiler.excludedRoutePrefixes(
+            routingData: data, reserved: reserved, reservedIPv6: reservedIPv6, bypassIPv4: bypassIPv4,
+            limit: TunnelConstants.kernelBypassMaxRoutes
+        ) else { return ([], []) }
+
+        let ipv4 = prefixes.ipv4.map { prefix in
+            NEIPv4Route(destinationAddress: Self.dottedQuad(prefix.ipv4Network),
+                        subnetMask: Self.dottedQuad(UInt32(truncatingIfNeeded: Prefix.mask(prefix.length).0 >> 32)))
+        }
+        let ipv6 = prefixes.ipv6.map { prefix in
+            var address = in6_addr()
+            withUnsafeMutableBytes(of: &address) { raw in
+                raw.storeBytes(of: prefix.hi.bigEndian, as: UInt64.self)
+                raw.storeBytes(of: prefix.lo.bigEndian, toByteOffset: 8, as: UInt64.self)
+            }
+            var buffer = [CChar](repeating: 0, count: Int(INET6_ADDRSTRLEN))
+            inet_ntop(AF_INET6, &address, &buffer, socklen_t(buffer.count))
+            return NEIPv6Route(destinationAddress: String(cString: buffer),
+                               networkPrefixLength: NSNumber(value: prefix.length))
+        }
+        logger.info("[VPN] Kernel bypass: \(ipv4.count) IPv4 and \(ipv6.count) IPv6 excluded routes")
+        return (ipv4, ipv6)
+    }
+
+    private static func dottedQuad(_ address: UInt32) -> String {
+        "\(address >> 24).\(address >> 16 & 0xFF).\(address >> 8 & 0xFF).\(address & 0xFF)"
+    }
+
     /// Re-applies tunnel settings from current UserDefaults; resets the virtual
     /// interface and flushes the OS DNS cache.
     private func reapplyTunnelSettings() {
@@ -135,6 +192,8 @@ class PacketTunnelProvider: NEPacketTunnelProvider {
 #endif
         
         statsRecorder.stop()
+        DataPathSignposts.isEnabled = false
+        QUICQlogSink.isEnabled = false
         stopMonitoringPath()
         logTunnelStop(reason: reason)
         tunnelStack.stop()
@@ -160,6 +219,20 @@ class PacketTunnelProvider: NEPacketTunnelProvider {
                 completionHandler?(try? JSONEncoder().encode(response))
             }
 
+        case .setAutoSelectGroup(let group):
+            tunnelStack.setAutoSelectGroup(group)
+            completionHandler?(nil)
+
+        case .setDataPathTracing(let enabled):
+            logger.info("[VPN] Data-path tracing \(enabled ? "enabled" : "disabled")")
+            DataPathSignposts.isEnabled = enabled
+            completionHandler?(nil)
+
+        case .setQlogCapture(let enabled):
+            logger.info("[VPN] qlog capture \(enabled ? "enabled" : "disabled")")
+            QUICQlogSink.isEnabled = enabled
+            completionHandler?(nil)
+
         case .fetchStats:
             let response = statsRecorder.snapshot()
             completionHandler?(try? JSONEncoder().encode(response))
@@ -171,6 +244,10 @@ class PacketTunnelProvider: NEPacketTunnelProvider {
         case .fetchRequests:
             let response = RequestsResponse(requests: tunnelStack.requestLog.snapshot())
             completionHandler?(try? JSONEncoder().encode(response))
+
+        case .fetchNodeHealth:
+            let response = NodeHealthResponse(nodes: tunnelStack.nodeHealth.telemetry.snapshot())
+            completionHandler?(try? JSONEncoder().encode(response))
         }
     }
 
@@ -230,14 +307,31 @@ class PacketTunnelProvider: NEPacketTunnelProvider {
             // Requires the "Access WiFi Information" entitlement; otherwise `ssid`
             // is nil and the network is treated as untrusted.
             NEHotspotNetwork.fetchCurrent { [weak self] network in
+                Self.updatePathMTUNetwork(path, ssid: network?.ssid)
                 self?.tunnelStack.updateNetworkContext(isWiFi: true, isCellular: false, ssid: network?.ssid)
             }
             return
         }
 #endif
+        Self.updatePathMTUNetwork(path, ssid: nil)
         tunnelStack.updateNetworkContext(isWiFi: isWiFi, isCellular: isCellular, ssid: nil)
     }
 
+    /// Keys QUIC's PMTUD memory by SSID on Wi-Fi, and by interface and gateway
+    /// elsewhere, bounded by the egress interface's MTU.
+    private static func updatePathMTUNetwork(_ path: Network.NWPath, ssid: String?) {
+        let interface = path.availableInterfaces.first
+        let key: String?
+        if let ssid {
+            key = "wifi:\(ssid)"
+        } else if let interface {
+            key = "\(interface.name):\(path.gateways.map { "\($0)" }.joined(separator: ","))"
+        } else {
+            key = nil
+        }
+        QUICPathMTU.shared.setNetwork(key: key, interfaceName: interface?.name)
+    }
+
     /// Applies the trusted-network policy, releases upstream transports while the
     /// path is down, and rebuilds them (flushing stale DNS) when it returns. Per-leg
     /// recovery is left to the NW transports' viability handlers.
@@ -0,0 +1,124 @@
+//
+//  ProxyDialRace.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "ProxyDialRace")
+
+/// Races one TCP dial across an auto-select group's leading nodes, in the manner of RFC 8305's
+/// connection attempts: the first candidate dials at once, and each next one starts after
+/// `TunnelConstants.dialRaceStagger` or as soon as the attempt before it fails. The first
+/// connection up wins and the rest are cancelled. Outcomes go to ``NodeHealthProber``; a
+/// leading node that a stand-in overtook counts as a failed dial, so a pick that is slow on
+/// live traffic is re-scored early rather than only by its next probe.
+///
+/// Driven from one serial queue (the owning connection's `lwipQueue`). Attempts carry no
+/// client bytes, since several servers may see the request.
+final class ProxyDialRace {
+
+    /// The winning client and the connection it dialed.
+    struct Winner {
+        let client: ProxyClient
+        let connection: ProxyConnection
+    }
+
+    private let candidates: [ProxyConfiguration]
+    private let queue: DispatchQueue
+    private let isDefaultProxy: (UUID) -> Bool
+
+    private var attempts: [ProxyClient] = []
+    private var inFlight = 0
+    /// The first candidate hasn't answered yet; a win by anyone else overtakes it.
+    private var leaderPending = true
+    private var stagger: DispatchWorkItem?
+    private var completion: ((Result<Winner, Error>) -> Void)?
+
+    init(candidates: [ProxyConfiguration], queue: DispatchQueue, isDefaultProxy: @escaping (UUID) -> Bool) {
+        self.candidates = candidates
+        self.queue = queue
+        self.isDefaultProxy = isDefaultProxy
+    }
+
+    /// Must be called on `queue`; `completion` fires there once, unless the race is cancelled.
+    func start(host: String, port: UInt16, completion: @escaping (Result<Winner, Error>) -> Void) {
+        self.completion = completion
+        launchNext(host: host, port: port)
+    }
+
+    /// Drops every attempt still dialing. Must be called on `queue`; idempotent.
+    func cancel() {
+        completion = nil
+        finish()
+    }
+
+    // MARK: - Private
+
+    private func launchNext(host: String, port: UInt16) {
+        stagger?.cancel()
+        stagger = nil
+        guard completion != nil, attempts.count < candidates.count else { return }
+        let configuration = candidates[attempts.count]
+        let client = ProxyClient(configuration: configuration, isDefaultProxy: isDefaultProxy(configuration.id))
+        attempts.append(client)
+        inFlight += 1
+        let startedAt = MonotonicClock.now
+        if attempts.count > 1 {
+            logger.debug("[AutoSelect] Racing \(configuration.name) for \(host):\(port)")
+        }
+        client.connect(to: host, port: port, initialData: nil) { [self] result in
+            queue.async { attemptDidFinish(client, result: result, startedAt: startedAt, host: host, port: port) }
+        }
+
+        guard attempts.count < candidates.count else { return }
+        let next = DispatchWorkItem { [weak self] in self?.launchNext(host: host, port: port) }
+        stagger = next
+        queue.asyncAfter(deadline: .now() + TunnelConstants.dialRaceStagger, execute: next)
+    }
+
+    private func attemptDidFinish(_ client: ProxyClient, result: Result<ProxyConnection, Error>,
+                                  startedAt: TimeInterval, host: String, port: UInt16) {
+        inFlight -= 1
+        let overtook = leaderPending && attempts.first.map { $0 !== client } == true
+        if attempts.first === client { leaderPending = false }
+        guard let completion else {
+            // Lost, or the race was cancelled while this attempt dialed.
+            if case .success(let connection) = result { connection.cancel() }
+            return
+        }
+        let nodeHealth = TunnelStack.shared?.nodeHealth
+        switch result {
+        case .success(let connection):
+            nodeHealth?.record(client.configuration.id, .connected(MonotonicClock.now - startedAt))
+            if overtook, let leader = attempts.first {
+                nodeHealth?.record(leader.configuration.id, .connectFailed)
+                logger.debug("[AutoSelect] \(client.configuration.name) overtook \(leader.configuration.name)")
+            }
+            self.completion = nil
+            attempts.removeAll { $0 === client }
+            finish()
+            completion(.success(Winner(client: client, connection: connection)))
+        case .failure(let error):
+            nodeHealth?.record(client.configuration.id, .connectFailed)
+            if attempts.count < candidates.count {
+                launchNext(host: host, port: port)
+            } else if inFlight == 0 {
+                self.completion = nil
+                finish()
+                completion(.failure(error))
+            }
+        }
+    }
+
+    /// Cancels the stagger timer and every attempt left in `attempts`.
+    private func finish() {
+        stagger?.cancel()
+        stagger = nil
+        let losers = attempts
+        attempts.removeAll()
+        for client in losers { client.cancel() }
+    }
+}
@@ -0,0 +1,60 @@
+//
+//  RecordRing.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Fixed-capacity overwrite ring for the recent-activity logs. An append is one slot store and a
+/// counter bump — no allocation, no trimming — so writers on the connection-setup path hold the
+/// lock for a handful of instructions even during a connection storm; the evicted record is
+/// released after the lock drops. Records stay in their raw form until `snapshot`, which the app
+/// only triggers through an IPC fetch.
+final class RecordRing<Record> {
+
+    /// One stored record and its sequence number; the sequence is unique for the ring's
+    /// lifetime, so `entryID(for:)` gives the app a stable identity across fetches.
+    typealias Stamped = (sequence: UInt64, record: Record)
+
+    private let lock = UnfairLock()
+    private var slots: [Stamped?]
+    private var written: UInt64 = 0
+
+    /// Random per-ring half of every `entryID`, so IDs never collide across tunnel sessions.
+    private let idPrefix: UInt64 = .random(in: .min ... .max)
+
+    init(capacity: Int) {
+        precondition(capacity > 0)
+        slots = Array(repeating: nil, count: capacity)
+    }
+
+    func append(_ record: Record) {
+        lock.lock()
+        let sequence = written
+        let index = Int(sequence % UInt64(slots.count))
+        let evicted = slots[index]
+        slots[index] = (sequence, record)
+        written = sequence &+ 1
+        lock.unlock()
+        withExtendedLifetime(evicted) {}
+    }
+
+    /// Live records, oldest first.
+    func snapshot() -> [Stamped] {
+        lock.lock()
+        let copy = slots
+        let count = written
+        lock.unlock()
+        let capacity = UInt64(copy.count)
+        let first = count > capacity ? count - capacity : 0
+        return (first..<count).compactMap { copy[Int($0 % capacity)] }
+    }
+
+    func entryID(for sequence: UInt64) -> UUID {
+        withUnsafeBytes(of: (idPrefix.bigEndian, sequence.bigEndian)) { raw in
+            UUID(uuid: raw.load(as: uuid_t.self))
+        }
+    }
+}
@@ -11,8 +11,17 @@ final class RequestLog {
 
     typealias Entry = TunnelRequestEntry
 
-    private let lock = UnfairLock()
-    private var entries: [Entry] = []
+    /// Raw form kept in the ring; `Entry` (and its ID) is built only when the app fetches.
+    private struct Record {
+        let timestamp: CFAbsoluteTime
+        let protocolName: String
+        let host: String
+        let port: UInt16
+        let routeTarget: RouteTarget
+        let viaDefault: Bool
+    }
+
+    private let ring = RecordRing<Record>(capacity: TunnelConstants.requestLogMaxEntries)
 
     /// Records one routing decision; `host` is the domain if known, else the IP literal.
     func record(
@@ -22,37 +31,31 @@ final class RequestLog {
         routeTarget: RouteTarget,
         viaDefault: Bool = false
     ) {
-        let now = CFAbsoluteTimeGetCurrent()
-        let entry = Entry(
-            timestamp: now,
+        ring.append(Record(
+            timestamp: CFAbsoluteTimeGetCurrent(),
             protocolName: protocolName,
             host: host,
             port: port,
             routeTarget: routeTarget,
             viaDefault: viaDefault
-        )
-        lock.lock()
-        entries.append(entry)
-        compact(now: now)
-        lock.unlock()
+        ))
     }
 
     /// Returns all entries within the retention window; safe from any thread.
     func snapshot() -> [Entry] {
-        let now = CFAbsoluteTimeGetCurrent()
-        lock.lock()
-        compact(now: now)
-        let result = entries
-        lock.unlock()
-        return result
-    }
-
-    /// Caller must hold `lock`.
-    private func compact(now: CFAbsoluteTime) {
-        let cutoff = now - TunnelConstants.requestLogRetentionInterval
-        entries.removeAll { $0.timestamp < cutoff }
-        if entries.count > TunnelConstants.requestLogMaxEntries {
-            entries.removeFirst(entries.count - TunnelConstants.requestLogMaxEntries)
+        let cutoff = CFAbsoluteTimeGetCurrent() - TunnelConstants.requestLogRetentionInterval
+        return ring.snapshot().compactMap { stamped in
+            let record = stamped.record
+            guard record.timestamp >= cutoff else { return nil }
+            return Entry(
+                id: ring.entryID(for: stamped.sequence),
+                timestamp: record.timestamp,
+                protocolName: record.protocolName,
+                host: record.host,
+                port: record.port,
+                routeTarget: record.routeTarget,
+                viaDefault: record.viaDefault
+            )
         }
     }
 }
@@ -0,0 +1,78 @@
+//
+//  RouteDecisionCache.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Domain routing decisions, misses included, so a burst of connections to one
+/// host walks the suffix trie and keyword automaton once. One cache belongs to
+/// one ``DomainRouter`` snapshot: a reload publishes a fresh, empty cache with
+/// the new rules, so no entry outlives the rules that produced it. Sharded like
+/// ``DNSResponseCache``; each shard evicts least-recently-used.
+final class RouteDecisionCache {
+
+    private struct Entry {
+        let target: RouteTarget?
+        var lastUse: UInt64
+    }
+
+    private final class Shard {
+        let lock = UnfairLock()
+        var entries: [String: Entry] = [:]
+        /// Use counter standing in for recency, so a hit writes one integer.
+        var useClock: UInt64 = 0
+    }
+
+    private let shards: [Shard]
+    private let capacityPerShard: Int
+
+    init(shardCount: Int = TunnelConstants.routeCacheShardCount,
+         capacityPerShard: Int = TunnelConstants.routeCacheEntriesPerShard) {
+        shards = (0..<max(1, shardCount)).map { _ in Shard() }
+        self.capacityPerShard = max(1, capacityPerShard)
+    }
+
+    private func shard(for domain: String) -> Shard {
+        shards[Int(UInt(bitPattern: domain.hashValue) % UInt(shards.count))]
+    }
+
+    /// The cached decision for `domain`, or `compute()`'s, which is stored.
+    /// `domain` must already be case-folded.
+    func decision(for domain: String, compute: () -> RouteTarget?) -> RouteTarget? {
+        let keyShard = shard(for: domain)
+        let hit: Entry? = keyShard.lock.withLock {
+            guard var entry = keyShard.entries[domain] else { return nil }
+            keyShard.useClock += 1
+            entry.lastUse = keyShard.useClock
+            keyShard.entries[domain] = entry
+            return entry
+        }
+        if let hit { return hit.target }
+
+        // Computed outside the lock; a racing miss on the same domain computes
+        // the same answer and overwrites it harmlessly.
+        let target = compute()
+        keyShard.lock.withLock {
+            if keyShard.entries[domain] == nil, keyShard.entries.count >= capacityPerShard {
+                evictOne(from: keyShard)
+            }
+            keyShard.useClock += 1
+            keyShard.entries[domain] = Entry(target: target, lastUse: keyShard.useClock)
+        }
+        return target
+    }
+
+    /// Drops the least recently used entry. Caller holds `shard.lock`.
+    private func evictOne(from shard: Shard) {
+        var victim: String?
+        var victimUse = UInt64.max
+        for (key, entry) in shard.entries where entry.lastUse < victimUse {
+            victimUse = entry.lastUse
+            victim = key
+        }
+        if let victim { shard.entries.removeValue(forKey: victim) }
+    }
+}
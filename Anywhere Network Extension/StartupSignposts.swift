@@ -0,0 +1,41 @@
+//
+//  StartupSignposts.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import os
+
+nonisolated private let logger = AnywhereLogger(category: "Startup")
+
+/// Intervals for each phase of bringing the tunnel up, from `startTunnel` to the first
+/// packet read. Unlike ``DataPathSignposts`` they are always on: a cold start is over
+/// before the app could enable tracing, and each phase runs once per start.
+nonisolated enum StartupSignposts {
+
+    private static let signposter = OSSignposter(subsystem: "com.argsment.Anywhere", category: "Startup")
+
+    struct Interval {
+        fileprivate let state: OSSignpostIntervalState
+        fileprivate let startedAt: CFAbsoluteTime
+    }
+
+    static func begin(_ name: StaticString) -> Interval {
+        Interval(state: signposter.beginInterval(name, id: signposter.makeSignpostID()),
+                 startedAt: CFAbsoluteTimeGetCurrent())
+    }
+
+    static func end(_ name: StaticString, _ interval: Interval) {
+        signposter.endInterval(name, interval.state)
+        let elapsed = (CFAbsoluteTimeGetCurrent() - interval.startedAt) * 1000
+        logger.debug("[Startup] \(name): \(String(format: "%.1f", elapsed))ms")
+    }
+
+    static func measure<T>(_ name: StaticString, _ body: () throws -> T) rethrows -> T {
+        let interval = begin(name)
+        defer { end(name, interval) }
+        return try body()
+    }
+}
@@ -10,9 +10,11 @@ import Foundation
 final class StatsRecorder {
     struct RawValues {
         let byteCounts: TrafficByteCounts
+        let heavyHitters: [TrafficHeavyHitters.Entry]
         let tcpConnectionCount: Int
         let udpConnectionCount: Int
         let memoryBytes: UInt64
+        let queueLoad: (lwipDelayMicroseconds: Int, udpDelayMicroseconds: Int, outputDepth: Int)
     }
 
     private var source: (() -> RawValues)?
@@ -20,6 +22,9 @@ final class StatsRecorder {
     private var sleepSecondsAccumulated: TimeInterval = 0
     /// Non-nil while the device is asleep (between `noteSleep` and `noteWake`).
     private var sleepBeganAt: TimeInterval?
+    /// Publishes snapshots to the app through the shared ring, only while it reads them.
+    private var ringWriter: StatsRing.Writer?
+    private var publishTimer: DispatchSourceTimer?
 
     /// Called once at tunnel start.
     func start(source: @escaping () -> RawValues) {
@@ -27,15 +32,20 @@ final class StatsRecorder {
         startedAt = MonotonicClock.now
         sleepSecondsAccumulated = 0
         sleepBeganAt = nil
+        startPublishing()
     }
 
     /// Clears live connection timings so the next session starts blank.
     func stop() {
+        publishTimer?.cancel()
+        publishTimer = nil
+        ringWriter?.clear()
         source = nil
         startedAt = nil
         sleepSecondsAccumulated = 0
         sleepBeganAt = nil
         ConnectionMetrics.shared.reset()
+        HotPathMetrics.shared.reset()
     }
 
     /// Marks the start of a device-sleep interval (`NEProvider.sleep`).
@@ -51,6 +61,20 @@ final class StatsRecorder {
         self.sleepBeganAt = nil
     }
 
+    /// Main-queue timer, like the provider callbacks that drive the rest of the recorder.
+    private func startPublishing() {
+        if ringWriter == nil { ringWriter = StatsRing.Writer() }
+        guard ringWriter != nil, publishTimer == nil else { return }
+        let timer = DispatchSource.makeTimerSource(queue: .main)
+        timer.schedule(deadline: .now() + 1, repeating: 1, leeway: .milliseconds(250))
+        timer.setEventHandler { [weak self] in
+            guard let self, let ringWriter = self.ringWriter, ringWriter.hasReader else { return }
+            ringWriter.publish(self.snapshot())
+        }
+        timer.resume()
+        publishTimer = timer
+    }
+
     func snapshot() -> StatsResponse {
         let live = source?()
         let counts = live?.byteCounts ?? TrafficByteCounts()
@@ -67,6 +91,17 @@ final class StatsRecorder {
                 )
             }
             .sorted { $0.totalBytes > $1.totalBytes }
+        let domains = (live?.heavyHitters ?? [])
+            .sorted { $0.total > $1.total }
+            .map {
+                DomainTrafficEntry(
+                    domain: $0.domain,
+                    target: $0.target,
+                    bytesIn: $0.bytesIn,
+                    bytesOut: $0.bytesOut,
+                    errorBytes: $0.errorBytes
+                )
+            }
         return StatsResponse(
             bytesIn: counts.totalBytesIn,
             bytesOut: counts.totalBytesOut,
@@ -79,7 +114,40 @@ final class StatsRecorder {
             dialMs: timings.dialMs,
             handshakeMs: timings.handshakeMs,
             avgDialMs: timings.avgDialMs,
-            avgHandshakeMs: timings.avgHandshakeMs
+            avgHandshakeMs: timings.avgHandshakeMs,
+            hotPath: live.map { Self.hotPathStats(queueLoad: $0.queueLoad) },
+            domains: domains
+        )
+    }
+
+    private static func hotPathStats(
+        queueLoad: (lwipDelayMicroseconds: Int, udpDelayMicroseconds: Int, outputDepth: Int)
+    ) -> HotPathStats {
+        let counters = HotPathMetrics.shared.snapshot()
+        let crypto = HotPathMetrics.CryptoLayer.allCases.map { layer in
+            HotPathStats.Crypto(
+                layer: layer.name,
+                sealBytes: counters.cryptoBytes(layer, .seal),
+                sealNanoseconds: counters.cryptoNanoseconds(layer, .seal),
+                openBytes: counters.cryptoBytes(layer, .open),
+                openNanoseconds: counters.cryptoNanoseconds(layer, .open)
+            )
+        }
+        return HotPathStats(
+            tunReadBatches: counters[.tunReadBatches],
+            tunReadPackets: counters[.tunReadPackets],
+            tunWriteBatches: counters[.tunWriteBatches],
+            tunWritePackets: counters[.tunWritePackets],
+            lwipWriteStalls: counters[.lwipWriteStalls],
+            dnsAnswerCacheHits: counters[.dnsAnswerCacheHits],
+            dnsAnswerCacheMisses: counters[.dnsAnswerCacheMisses],
+            dnsResolverHits: counters[.dnsResolverHits],
+            dnsResolverMisses: counters[.dnsResolverMisses],
+            udpPendingDrops: counters[.udpPendingDrops],
+            crypto: crypto,
+            outputQueueDepth: queueLoad.outputDepth,
+            lwipQueueDelayMicroseconds: queueLoad.lwipDelayMicroseconds,
+            udpQueueDelayMicroseconds: queueLoad.udpDelayMicroseconds
         )
     }
 }
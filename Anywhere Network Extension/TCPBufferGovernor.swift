@@ -0,0 +1,78 @@
+//
+//  TCPBufferGovernor.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Process-wide byte budget for what TCP connections buffer in Swift: the downlink backlog,
+/// the upload buffer and pre-dial data. Each connection is individually capped, but hundreds
+/// of them at their caps would far exceed the extension's jetsam limit. Once the total nears
+/// the budget, connections holding more than a fair share stop arming proxy receives and
+/// defer `tcp_recved` (shrinking the window their app sees) until they drain below it or the
+/// total eases; connections under their share are never throttled. Lives on lwipQueue.
+final class TCPBufferGovernor {
+
+    let budget: Int
+    private let pressureThreshold: Int
+
+    private(set) var totalBytes = 0
+    private(set) var connectionCount = 0
+
+    /// Throttled connections, retained until they're resumed or unregister.
+    private var parked: [ObjectIdentifier: TCPConnection] = [:]
+
+    init(budget: Int) {
+        self.budget = budget
+        self.pressureThreshold = budget / 4 * 3
+    }
+
+    /// What one connection may hold while the total is near the budget.
+    var fairShare: Int {
+        max(TunnelConstants.tcpBufferMinShare, budget / max(1, connectionCount))
+    }
+
+    func register() {
+        connectionCount += 1
+    }
+
+    func unregister(_ connection: TCPConnection, heldBytes: Int) {
+        connectionCount -= 1
+        parked.removeValue(forKey: ObjectIdentifier(connection))
+        update(by: -heldBytes)
+    }
+
+    func update(by delta: Int) {
+        totalBytes += delta
+        if delta < 0, totalBytes < pressureThreshold {
+            resumeAll()
+        }
+    }
+
+    /// Whether a connection holding `heldBytes` may take on more.
+    func admits(_ heldBytes: Int) -> Bool {
+        totalBytes < pressureThreshold || heldBytes < fairShare
+    }
+
+    func park(_ connection: TCPConnection) {
+        parked[ObjectIdentifier(connection)] = connection
+    }
+
+    /// Resumes one parked connection on its next lwipQueue turn, never from inside the
+    /// caller's lwIP callback.
+    func resume(_ connection: TCPConnection) {
+        guard parked.removeValue(forKey: ObjectIdentifier(connection)) != nil else { return }
+        connection.lwipQueue.async { connection.governorDidResume() }
+    }
+
+    private func resumeAll() {
+        guard !parked.isEmpty else { return }
+        let woken = parked.values
+        parked.removeAll(keepingCapacity: true)
+        for connection in woken {
+            connection.lwipQueue.async { connection.governorDidResume() }
+        }
+    }
+}
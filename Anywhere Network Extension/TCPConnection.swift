@@ -27,6 +27,9 @@ class TCPConnection {
     let pcb: UnsafeMutableRawPointer
     let dstPort: UInt16
     let lwipQueue: DispatchQueue
+    /// Where proxy-leg calls (send, receive arming, cancel) are issued, so their
+    /// synchronous crypto runs off `lwipQueue`. Serial, so they keep their order.
+    let proxyQueue: DispatchQueue
 
     /// Dial destination, fixed at accept time; an SNI re-route deliberately
     /// keeps the caller's own DNS choice.
@@ -38,9 +41,24 @@ class TCPConnection {
     private var proxyClient: ProxyClient?
     private var proxyConnection: ProxyConnection?
     private var proxyConnecting = false
+    /// A dial to the auto-selected node racing its stand-ins; `proxyClient` stays nil until it wins.
+    private var dialRace: ProxyDialRace?
+
+    // MARK: Speculative Dial
+    //
+    // While the sniffer runs, the accept-time proxy route is dialed without client bytes so
+    // its transport and handshake overlap the client's first flight. The commit adopts it when
+    // the sniffed route lands on the same configuration and cancels it otherwise.
+
+    private var speculativeClient: ProxyClient?
+    /// The speculative leg once it's up, held until the route commits.
+    private var speculativeConnection: ProxyConnection?
+    private var speculativeConfigurationID: UUID?
 
     /// Committed routing identity for traffic accounting and the dial path; an SNI re-match can change it.
     private var routeTarget: RouteTarget
+    /// The route this connection committed to; read by in-place reconfiguration.
+    var boundRouteTarget: RouteTarget { routeTarget }
 
     /// Whether the accept-time route is the default outbound.
     private let acceptedViaDefault: Bool
@@ -64,11 +82,16 @@ class TCPConnection {
 
     /// True when `dstHost` is a DNS-resolved domain (fake-IP), false when it is a raw IP (real-IP).
     private let hostIsResolvedDomain: Bool
+    /// Domain this connection's bytes are tallied under: the fake-IP domain, replaced by the
+    /// sniffed SNI; nil for a bare IP.
+    private var accountingDomain: String?
 
     // MARK: SNI / HTTP Sniffing
 
     /// Non-nil during the TLS sniff phase; inbound bytes buffer in `pendingData` until the route commits.
     private var sniffer: TLSClientHelloSniffer?
+    /// The sniffed ClientHello, kept for the MITM session so it needn't parse it again.
+    private var sniffedClientHello: TLSClientHelloSniffer.ClientHello?
     /// Non-nil during the cleartext HTTP sniff phase; resolves the authority that gates plain-HTTP interception.
     private var httpSniffer: HTTPRequestSniffer?
 
@@ -84,9 +107,26 @@ class TCPConnection {
         pendingWrite.count - pendingWriteOffset
     }
 
+    /// Buffers lwIP segments point into after reference-mode writes; created on first use.
+    private var writeReferences: TCPWriteReferences?
+
     /// At most one outstanding proxy receive; the transports require serial receives.
     private var receiveInFlight = false
 
+    // MARK: Buffer Budget
+
+    /// Cleared once this connection unregisters, so a second teardown path can't repeat it.
+    private var governor = TunnelStack.shared?.tcpBufferGovernor
+    /// This connection's bytes as last reported to `governor`.
+    private var governedBytes = 0
+    /// Uplink bytes the proxy accepted but `tcp_recved` was held back for while throttled.
+    private var deferredUplinkAck = 0
+
+    /// Socket-level transports adopted once the proxy chain turns transparent
+    /// (Vision direct copy); receives and sends then skip every layer above.
+    private var splicedReceive: (any RawTransport)?
+    private var splicedSend: (any RawTransport)?
+
     // MARK: Upload Pipeline
     //
     // Single-flight is mandatory: transports can split a logical send and resume it later,
@@ -96,19 +136,46 @@ class TCPConnection {
         var bufferOffset = 0
         var sendInFlight = false
         var isPumpScheduled = false
+        /// A coalescing window is open; its timer forces the next send.
+        var isCoalesceArmed = false
+        var lastSendAt: TimeInterval = 0
     }
     private var uploadPipeline = UploadPipeline()
 
+    /// How long a small mid-burst upload waits for more app writes: a sixteenth of the
+    /// dial time (the one RTT sample there is), clamped. Zero until the leg is up.
+    private var uploadCoalesceWindow: TimeInterval = 0
+    /// When the first dial for this connection began; 0 before it does.
+    private var dialStartedAt: TimeInterval = 0
+
     private var uploadBufferCount: Int {
         uploadPipeline.buffer.count - uploadPipeline.bufferOffset
     }
 
-    private var activityTimer: ActivityTimer?
-    private var handshakeTimer: DispatchWorkItem?
+    // MARK: Deadlines
+    //
+    // All tracked by the stack's ``TCPDeadlineWheel``; `.infinity` means not armed, and
+    // disarming or pushing one later needs no wheel call.
+
+    private let deadlines = TunnelStack.shared?.tcpDeadlines
+    /// Position in `deadlines`, -1 while unscheduled; owned by the wheel.
+    var wheelSlot = -1
+    /// Idle close after this long without activity; nil until the upstream leg is up.
+    private var idleTimeout: TimeInterval?
+    private var lastActivity: TimeInterval = 0
+    private var handshakeDeadline = TimeInterval.infinity
     /// Commits the IP-based route if the sniff doesn't resolve in time.
-    private var sniffDeadline: DispatchWorkItem?
+    private var sniffDeadline = TimeInterval.infinity
+    /// Sends a deferred proxy request header alone if the client stays silent this long.
+    private var earlyDataDeadline = TimeInterval.infinity
+    /// The sniff timed out without a byte: a server-speaks-first session, so the proxy
+    /// leg shouldn't wait for client data to carry its header.
+    private var clientSilentAtCommit = false
     private var uplinkDone = false
     private var downlinkDone = false
+    /// Last time the app ACKed downlink bytes; how memory pressure tells a stuck backlog
+    /// from one that is draining.
+    private var lastDownlinkProgress: TimeInterval = 0
 
     /// Logs this connection's terminal failure at most once.
     private let failureReporter = ConnectionFailureReporter(prefix: "[TCP]", logger: logger)
@@ -120,54 +187,111 @@ class TCPConnection {
          viaDefault: Bool,
          sniffSNI: Bool = false,
          hostIsResolvedDomain: Bool = false,
-         lwipQueue: DispatchQueue) {
+         lwipQueue: DispatchQueue,
+         proxyQueue: DispatchQueue) {
         self.pcb = pcb
         self.dstHost = dstHost
         self.dstPort = dstPort
         self.configuration = configuration
         self.lwipQueue = lwipQueue
+        self.proxyQueue = proxyQueue
         self.routeTarget = routeTarget
         self.acceptedViaDefault = viaDefault
         self.hostIsResolvedDomain = hostIsResolvedDomain
+        self.accountingDomain = hostIsResolvedDomain ? dstHost.lowercased() : nil
         if sniffSNI {
             self.sniffer = TLSClientHelloSniffer()
         }
+        governor?.register()
 
         // Covers both the sniff wait and the proxy dial so a stalled client can't hold the connection open.
-        let timer = DispatchWorkItem { [weak self] in
-            guard let self, !self.closed else { return }
-            if self.isEstablishing {
-                let phase = self.isSniffing ? "protocol sniff" : "proxy dial"
-                self.failureReporter.report(
-                    operation: "Handshake",
-                    endpoint: self.endpointDescription,
-                    error: HandshakeTimeoutError(phase: phase)
-                )
-                self.abort()
-            }
+        let now = MonotonicClock.now
+        handshakeDeadline = now + TunnelConstants.handshakeTimeout
+        if sniffer != nil {
+            sniffDeadline = now + TunnelConstants.sniffDeadline
         }
-        handshakeTimer = timer
-        lwipQueue.asyncAfter(deadline: .now() + TunnelConstants.handshakeTimeout, execute: timer)
+        deadlines?.schedule(self)
 
         if sniffer == nil {
             beginConnecting()
         } else {
+            startSpeculativeDial()
+        }
+    }
+
+    private func cancelSniffDeadline() {
+        sniffDeadline = .infinity
+    }
+
+    // MARK: - Deadlines
+
+    var nextDeadline: TimeInterval {
+        min(handshakeDeadline, sniffDeadline, earlyDataDeadline,
+            idleTimeout.map { lastActivity + $0 } ?? .infinity)
+    }
+
+    /// Runs whichever deadlines have passed; the wheel has already unscheduled this connection.
+    func handleDeadline(now: TimeInterval) {
+        guard !closed else { return }
+        if now >= sniffDeadline {
+            sniffDeadline = .infinity
             // Server-speaks-first protocols (SSH, SMTP, FTP) never send client
             // bytes; commit the IP-based route at the deadline.
-            let deadline = DispatchWorkItem { [weak self] in
-                guard let self, !self.closed, self.isSniffing else { return }
-                self.sniffer = nil
-                self.httpSniffer = nil
-                self.beginConnecting()
+            if isSniffing {
+                sniffer = nil
+                httpSniffer = nil
+                clientSilentAtCommit = pendingData.isEmpty
+                beginConnecting()
             }
-            sniffDeadline = deadline
-            lwipQueue.asyncAfter(deadline: .now() + TunnelConstants.sniffDeadline, execute: deadline)
+        }
+        if !closed, now >= earlyDataDeadline {
+            earlyDataDeadline = .infinity
+            flushDeferredProxyHeader()
+        }
+        if !closed, now >= handshakeDeadline {
+            handshakeDeadline = .infinity
+            if isEstablishing {
+                let phase = isSniffing ? "protocol sniff" : "proxy dial"
+                failureReporter.report(
+                    operation: "Handshake",
+                    endpoint: endpointDescription,
+                    error: HandshakeTimeoutError(phase: phase)
+                )
+                abort()
+            }
+        }
+        if !closed, let idleTimeout, now >= lastActivity + idleTimeout {
+            self.idleTimeout = nil
+            close()
+        }
+        if !closed {
+            deadlines?.schedule(self)
         }
     }
 
-    private func cancelSniffDeadline() {
-        sniffDeadline?.cancel()
-        sniffDeadline = nil
+    /// Starts the idle deadline once the upstream leg is up, ending the handshake one.
+    private func armIdleTimeout() {
+        handshakeDeadline = .infinity
+        idleTimeout = TunnelConstants.connectionIdleTimeout
+        lastActivity = MonotonicClock.now
+        lastDownlinkProgress = lastActivity
+        deadlines?.schedule(self)
+    }
+
+    /// Restarts an armed idle deadline from now at a new length (the half-closed windows).
+    private func setIdleTimeout(_ timeout: TimeInterval) {
+        guard idleTimeout != nil else { return }
+        idleTimeout = timeout
+        lastActivity = MonotonicClock.now
+        deadlines?.schedule(self)
+    }
+
+    /// Pushes the idle deadline out; a store against the wheel's coarse clock.
+    @inline(__always)
+    private func noteActivity() {
+        if let deadlines {
+            lastActivity = deadlines.now
+        }
     }
 
     /// Appends to `pendingData`; aborts and returns `false` if the cap would be exceeded.
@@ -181,6 +305,7 @@ class TCPConnection {
             return false
         }
         pendingData.append(ptr, count: count)
+        reportBufferedBytes()
         return true
     }
 
@@ -202,23 +327,22 @@ class TCPConnection {
     /// Upload path: data from the local app via lwIP.
     func handleReceivedData(bytes ptr: UnsafeRawPointer, count: Int) {
         guard !closed, count > 0 else { return }
-        activityTimer?.update()
+        noteActivity()
 
         let bytePtr = ptr.assumingMemoryBound(to: UInt8.self)
 
-        // The sniffer and appendPendingData both copy eagerly, so a bytesNoCopy
-        // wrapper is safe — the Data never outlives this function.
+        // The TLS sniffer reads `pendingData` in place, resuming where the last feed stopped.
         if sniffer != nil {
-            let data = Data(bytesNoCopy: UnsafeMutableRawPointer(mutating: ptr), count: count, deallocator: .none)
-            if let state = sniffer?.feed(data) {
-                guard appendPendingData(bytes: bytePtr, count: count) else { return }
+            guard appendPendingData(bytes: bytePtr, count: count) else { return }
+            if let state = sniffer?.feed(pendingData) {
                 switch state {
                 case .needMore:
                     return
-                case .found(let sni):
+                case .found(let hello):
                     sniffer = nil
                     cancelSniffDeadline()
-                    applySNI(sni)
+                    sniffedClientHello = hello
+                    applySNI(hello.serverName)
                     guard !closed else { return }  // rule may have rejected
                     beginConnecting()
                     return
@@ -243,10 +367,10 @@ class TCPConnection {
             }
         }
 
+        // The sniffer scans the lwIP segment in place and resumes where the last one stopped.
         if httpSniffer != nil {
-            let data = Data(bytesNoCopy: UnsafeMutableRawPointer(mutating: ptr), count: count, deallocator: .none)
             guard appendPendingData(bytes: bytePtr, count: count) else { return }
-            if let state = httpSniffer?.feed(data) {
+            if let state = httpSniffer?.feed(UnsafeRawBufferPointer(start: ptr, count: count)) {
                 handleHTTPSniff(state)
             }
             return
@@ -264,7 +388,7 @@ class TCPConnection {
             // yet (a large POST/PUT, or a slow upstream) produces no downlink to refresh the idle
             // timer, so without this it looks idle and is torn down mid-stream — the non-MITM upload
             // path refreshes the timer on every accepted chunk for the same reason.
-            activityTimer?.update()
+            noteActivity()
             // Ack to lwIP up-front; MITMSession owns inner-leg flow control.
             acknowledgeReceivedBytes(count)
             mitmSession.feedClientBytes(chunk)
@@ -278,15 +402,46 @@ class TCPConnection {
         }
 
         uploadPipeline.buffer.append(bytePtr, count: count)
+        reportBufferedBytes()
         schedulePumpIfNeeded()
     }
 
+    /// Upload path for a chained pbuf. Once the pipeline is live each region goes
+    /// straight into the upload buffer; before that the sniffers and pending buffer
+    /// need one contiguous run, so the regions are joined and take the path above.
+    func handleReceivedData(segments: UnsafeBufferPointer<lwip_bridge_iovec>, count: Int) {
+        guard !closed, count > 0 else { return }
+
+        if sniffer == nil, httpSniffer == nil, !proxyConnecting, mitmSession == nil, proxyConnection != nil {
+            noteActivity()
+            for segment in segments {
+                guard let base = segment.base, segment.len > 0 else { continue }
+                uploadPipeline.buffer.append(base.assumingMemoryBound(to: UInt8.self), count: Int(segment.len))
+            }
+            reportBufferedBytes()
+            schedulePumpIfNeeded()
+            return
+        }
+
+        var joined = Data(capacity: count)
+        for segment in segments {
+            guard let base = segment.base, segment.len > 0 else { continue }
+            joined.append(base.assumingMemoryBound(to: UInt8.self), count: Int(segment.len))
+        }
+        joined.withUnsafeBytes { buffer in
+            guard let baseAddress = buffer.baseAddress else { return }
+            handleReceivedData(bytes: baseAddress, count: buffer.count)
+        }
+    }
+
     /// The async hop coalesces a synchronous burst of lwIP callbacks into one large
     /// send; while a send is in flight, the completion's tail call ships what accumulated.
     private func schedulePumpIfNeeded() {
         guard !uploadPipeline.isPumpScheduled,
               !uploadPipeline.sendInFlight,
               uploadBufferCount > 0 else { return }
+        // An open window's timer sends unless the buffer outgrows it first.
+        if uploadPipeline.isCoalesceArmed, uploadBufferCount < TunnelConstants.uploadCoalesceFlushSize { return }
         uploadPipeline.isPumpScheduled = true
         lwipQueue.async { [weak self] in
             self?.pumpUploadSends(fromSchedule: true)
@@ -294,16 +449,23 @@ class TCPConnection {
     }
 
     /// Issues one `proxyConnection.send` with the head slice of the pipeline buffer; strict single-flight.
-    private func pumpUploadSends(fromSchedule: Bool = false) {
+    /// `force` skips the coalescing hold.
+    private func pumpUploadSends(fromSchedule: Bool = false, force: Bool = false) {
+        let signpost = DataPathSignposts.begin("pumpUploadSends")
+        defer { DataPathSignposts.end("pumpUploadSends", signpost) }
         if fromSchedule {
             uploadPipeline.isPumpScheduled = false
         }
 
         guard !closed, !uploadPipeline.sendInFlight, uploadBufferCount > 0,
               let proxyConnection else { return }
+        if !force, holdsUploadForCoalescing() { return }
 
+        earlyDataDeadline = .infinity
+        uploadPipeline.lastSendAt = MonotonicClock.now
         let take = min(uploadBufferCount, TunnelConstants.uploadChunkSize)
         let chunk = sliceUploadBuffer(take)
+        reportBufferedBytes()
 
         uploadPipeline.sendInFlight = true
         let chunkSize = take
@@ -320,14 +482,39 @@ class TCPConnection {
                 }
                 // Count proxy-side accepts as uplink activity; a long upload that
                 // backpressures the app would otherwise look idle and close mid-stream.
-                self.activityTimer?.update()
-                self.acknowledgeReceivedBytes(chunkSize)
+                self.noteActivity()
+                self.acknowledgeUplink(chunkSize)
                 // Drain synchronously so bytes accumulated in-flight ship without another hop.
                 self.pumpUploadSends()
             }
         }
 
-        proxyConnection.send(data: chunk, completion: completion)
+        if splicedSend == nil { splicedSend = proxyConnection.directSendTransport }
+        if let splicedSend {
+            splicedSend.send(data: chunk, completion: completion)
+        } else {
+            proxyQueue.async { proxyConnection.send(data: chunk, completion: completion) }
+        }
+    }
+
+    /// Holds a small buffer while the app writes in a burst, so consecutive recv chunks
+    /// leave as one record and one transport write. The first send after an idle gap and
+    /// a buffer past the flush size go at once; otherwise a timer sends after the window.
+    private func holdsUploadForCoalescing() -> Bool {
+        let window = uploadCoalesceWindow
+        guard window > 0, !uplinkDone,
+              uploadBufferCount < TunnelConstants.uploadCoalesceFlushSize,
+              MonotonicClock.now - uploadPipeline.lastSendAt < TunnelConstants.uploadCoalesceIdleGap
+        else { return false }
+        if !uploadPipeline.isCoalesceArmed {
+            uploadPipeline.isCoalesceArmed = true
+            lwipQueue.asyncAfter(deadline: .now() + window) { [weak self] in
+                guard let self, self.uploadPipeline.isCoalesceArmed else { return }
+                self.uploadPipeline.isCoalesceArmed = false
+                self.pumpUploadSends(force: true)
+            }
+        }
+        return true
     }
 
     /// Acks local-app bytes to lwIP once the proxy leg accepted them, then
@@ -335,7 +522,7 @@ class TCPConnection {
     private func acknowledgeReceivedBytes(_ byteCount: Int) {
         guard byteCount > 0 else { return }
         // Single uplink tally point; rejects call tcp_recved directly, uncounted.
-        TunnelStack.shared?.addBytesOut(Int64(byteCount), target: routeTarget)
+        TunnelStack.shared?.addBytesOut(Int64(byteCount), target: routeTarget, domain: accountingDomain)
         var remaining = byteCount
         while remaining > 0 {
             let part = UInt16(min(remaining, Int(UInt16.max)))
@@ -346,6 +533,17 @@ class TCPConnection {
         lwip_bridge_tcp_output(pcb)
     }
 
+    /// Acks a proxy-accepted uplink chunk, or holds the ack back while the buffer budget
+    /// throttles this connection so the app's window closes instead of the buffers growing.
+    private func acknowledgeUplink(_ byteCount: Int) {
+        if let governor, !governor.admits(governedBytes) {
+            deferredUplinkAck += byteCount
+            governor.park(self)
+            return
+        }
+        acknowledgeReceivedBytes(byteCount)
+    }
+
     /// Removes and returns the `take`-byte head slice; whole-buffer consumption hands
     /// off the storage so the in-flight chunk's backing isn't mutated under it.
     private func sliceUploadBuffer(_ take: Int) -> Data {
@@ -375,6 +573,10 @@ class TCPConnection {
     /// Client ACK freed lwIP send-buffer space; drain more downlink backlog.
     func handleSent(len: UInt16) {
         guard !closed else { return }
+        if let deadlines {
+            lastDownlinkProgress = deadlines.now
+        }
+        writeReferences?.retire(upTo: lwip_bridge_tcp_ref_floor(pcb))
         drainPendingWrite()
     }
 
@@ -398,10 +600,15 @@ class TCPConnection {
         mitmSession?.clientDidClose()
 
         uplinkDone = true
+        // Nothing more is coming to merge with.
+        if uploadPipeline.isCoalesceArmed {
+            uploadPipeline.isCoalesceArmed = false
+            pumpUploadSends(force: true)
+        }
         if downlinkDone {
             close()
         } else {
-            activityTimer?.setTimeout(TunnelConstants.downlinkOnlyTimeout)
+            setIdleTimeout(TunnelConstants.downlinkOnlyTimeout)
         }
     }
 
@@ -463,6 +670,9 @@ class TCPConnection {
     /// Kicks off the outbound connection on the committed route. Idempotent.
     private func beginConnecting() {
         guard !closed, !proxyConnecting, proxyConnection == nil, mitmSession == nil else { return }
+        if dialStartedAt == 0 { dialStartedAt = MonotonicClock.now }
+        if adoptSpeculativeDial() { return }
+        discardSpeculativeDial()
         // MITM defers the dial into the session: a rewrite may change the host,
         // and a 302 / reject answers without dialing at all.
         if mitmEnabled {
@@ -479,9 +689,14 @@ class TCPConnection {
     /// Evaluates routing from the sniffed SNI; call only after the sniffer is cleared.
     private func applySNI(_ sni: String) {
         guard let stack = TunnelStack.shared else { return }
+        accountingDomain = sni.lowercased()
 
         // MITM (intercept TLS?) is decided independently of routing (which leg).
         if stack.mitmEnabled, stack.mitmPolicy.matches(sni) {
+            if sniffedClientHello?.offersECH == true {
+                // GREASE is the norm; a real ECH offer makes the client refuse the MITM leaf.
+                logger.debug("[TCP] MITM \(sni) offers ECH; interception fails if it's not GREASE")
+            }
             mitmEnabled = true
             mitmSNI = sni
             // Routing is deferred to the dialer.
@@ -571,15 +786,7 @@ class TCPConnection {
                     self.handleConnectFailure(error, bufferedClientData: initialData)
                     return
                 }
-                self.handshakeTimer?.cancel()
-                self.handshakeTimer = nil
-                self.activityTimer = ActivityTimer(
-                    queue: self.lwipQueue,
-                    timeout: TunnelConstants.connectionIdleTimeout
-                ) { [weak self] in
-                    guard let self, !self.closed else { return }
-                    self.close()
-                }
+                self.armIdleTimeout()
 
                 if let initialData {
                     self.uploadPipeline.buffer.append(initialData)
@@ -600,6 +807,12 @@ class TCPConnection {
         guard !proxyConnecting && proxyConnection == nil && !closed else { return }
         proxyConnecting = true
 
+        if let candidates = TunnelStack.shared?.nodeHealth.raceCandidates(leading: configuration),
+           candidates.count > 1 {
+            raceProxy(candidates)
+            return
+        }
+
         // Protocols whose handshake carries a payload take pendingData as
         // initialData so the first bytes ride the handshake.
         let initialData: Data?
@@ -618,37 +831,18 @@ class TCPConnection {
         )
         self.proxyClient = client
 
+        let startedAt = MonotonicClock.now
         client.connect(to: dstHost, port: dstPort, initialData: initialData) { [weak self] result in
             guard let self else { return }
 
             self.lwipQueue.async {
                 self.proxyConnecting = false
+                self.recordDial(self.configuration.id, result: result, startedAt: startedAt)
                 guard !self.closed else { return }
 
                 switch result {
                 case .success(let proxyConnection):
-                    self.proxyConnection = proxyConnection
-                    self.handshakeTimer?.cancel()
-                    self.handshakeTimer = nil
-                    self.activityTimer = ActivityTimer(
-                        queue: self.lwipQueue,
-                        timeout: TunnelConstants.connectionIdleTimeout
-                    ) { [weak self] in
-                        guard let self, !self.closed else { return }
-                        self.close()
-                    }
-
-                    if let initialData {
-                        // Connect success implies handshake-carried initialData was accepted.
-                        self.acknowledgeReceivedBytes(initialData.count)
-                    }
-                    if !self.pendingData.isEmpty {
-                        self.uploadPipeline.buffer.append(self.pendingData)
-                        self.pendingData.removeAll(keepingCapacity: true)
-                    }
-                    self.pumpUploadSends()
-                    self.tryArmReceive()
-
+                    self.proxyDidConnect(proxyConnection, initialData: initialData)
                 case .failure(let error):
                     self.handleConnectFailure(error, bufferedClientData: initialData)
                 }
@@ -656,11 +850,178 @@ class TCPConnection {
         }
     }
 
+    /// Dials the auto-selected node against its stand-ins, and rides whichever comes up first.
+    /// Client bytes wait in `pendingData`: every racer would otherwise carry them.
+    private func raceProxy(_ candidates: [ProxyConfiguration]) {
+        let race = ProxyDialRace(candidates: candidates, queue: lwipQueue) { id in
+            TunnelStack.shared?.isDefaultConfiguration(id) ?? false
+        }
+        dialRace = race
+        race.start(host: dstHost, port: dstPort) { [weak self] result in
+            guard let self, self.dialRace === race else {
+                if case .success(let winner) = result {
+                    winner.connection.cancel()
+                    winner.client.cancel()
+                }
+                return
+            }
+            self.dialRace = nil
+            self.proxyConnecting = false
+            switch result {
+            case .success(let winner):
+                self.proxyClient = winner.client
+                self.configuration = winner.client.configuration
+                self.proxyDidConnect(winner.connection, initialData: nil)
+            case .failure(let error):
+                self.handleConnectFailure(error, bufferedClientData: nil)
+            }
+        }
+    }
+
+    private func proxyDidConnect(_ proxyConnection: ProxyConnection, initialData: Data?) {
+        self.proxyConnection = proxyConnection
+        armIdleTimeout()
+        if dialStartedAt > 0 {
+            uploadCoalesceWindow = min(max((MonotonicClock.now - dialStartedAt) / 16,
+                                           TunnelConstants.uploadCoalesceMinWindow),
+                                       TunnelConstants.uploadCoalesceMaxWindow)
+        }
+
+        if let initialData {
+            // Connect success implies handshake-carried initialData was accepted.
+            acknowledgeReceivedBytes(initialData.count)
+        }
+        if !pendingData.isEmpty {
+            uploadPipeline.buffer.append(pendingData)
+            pendingData.removeAll(keepingCapacity: true)
+        }
+        if initialData == nil, uploadBufferCount == 0 {
+            // Protocols that hold their request header for the first payload would
+            // otherwise never send it to a server that speaks first.
+            if clientSilentAtCommit {
+                flushDeferredProxyHeader()
+            } else {
+                earlyDataDeadline = MonotonicClock.now + TunnelConstants.earlyDataWait
+                deadlines?.schedule(self)
+            }
+        }
+        pumpUploadSends()
+        tryArmReceive()
+    }
+
+    private func recordDial(_ id: UUID, result: Result<ProxyConnection, Error>, startedAt: TimeInterval) {
+        guard let nodeHealth = TunnelStack.shared?.nodeHealth else { return }
+        if case .success = result {
+            nodeHealth.record(id, .connected(MonotonicClock.now - startedAt))
+        } else {
+            nodeHealth.record(id, .connectFailed)
+        }
+    }
+
+    private func flushDeferredProxyHeader() {
+        guard let proxyConnection else { return }
+        proxyQueue.async { proxyConnection.flushDeferredHeader() }
+    }
+
+    // MARK: - Speculative Dial
+
+    /// Dials the accept-time route while the sniffer waits for the client's first flight.
+    /// Only proxy routes speculate: a direct dial would put the real destination on the wire
+    /// before the SNI could move it behind a proxy. A fake-IP host whose name already
+    /// matches MITM is left alone, since the session dials for itself.
+    private func startSpeculativeDial() {
+        guard !closed, case .proxy = routeTarget, let stack = TunnelStack.shared else { return }
+        if hostIsResolvedDomain, stack.mitmEnabled, stack.mitmPolicy.matches(dstHost) { return }
+        dialStartedAt = MonotonicClock.now
+
+        let client = ProxyClient(
+            configuration: configuration,
+            isDefaultProxy: stack.isDefaultConfiguration(configuration.id)
+        )
+        speculativeClient = client
+        speculativeConfigurationID = configuration.id
+
+        let startedAt = dialStartedAt
+        client.connect(to: dstHost, port: dstPort, initialData: nil) { [weak self] result in
+            guard let self else {
+                if case .success(let connection) = result { connection.cancel() }
+                return
+            }
+            self.lwipQueue.async {
+                self.speculativeDialDidFinish(client, result: result, startedAt: startedAt)
+            }
+        }
+    }
+
+    private func speculativeDialDidFinish(_ client: ProxyClient, result: Result<ProxyConnection, Error>,
+                                          startedAt: TimeInterval) {
+        // Both adoption and a live speculation keep the client on one of these two fields.
+        guard speculativeClient === client || (proxyConnecting && proxyClient === client) else {
+            // Discarded while in flight.
+            if case .success(let connection) = result {
+                proxyQueue.async { connection.cancel() }
+            }
+            return
+        }
+        recordDial(client.configuration.id, result: result, startedAt: startedAt)
+
+        if proxyConnecting {
+            // Adopted while still dialing; this is now the committed dial.
+            proxyConnecting = false
+            switch result {
+            case .success(let connection):
+                proxyDidConnect(connection, initialData: nil)
+            case .failure(let error):
+                handleConnectFailure(error, bufferedClientData: nil)
+            }
+            return
+        }
+
+        switch result {
+        case .success(let connection):
+            speculativeConnection = connection
+        case .failure:
+            // The commit dials again on whatever route the sniff settles on.
+            speculativeClient = nil
+            speculativeConfigurationID = nil
+        }
+    }
+
+    /// Takes over the speculative leg when the committed route is the one it dialed (a
+    /// same-configuration SNI re-match included). Returns `false` when there is none to take.
+    private func adoptSpeculativeDial() -> Bool {
+        guard let client = speculativeClient, !mitmEnabled, !bypass,
+              speculativeConfigurationID == configuration.id else { return false }
+        speculativeClient = nil
+        speculativeConfigurationID = nil
+        proxyClient = client
+        if let connection = speculativeConnection {
+            speculativeConnection = nil
+            proxyDidConnect(connection, initialData: nil)
+        } else {
+            proxyConnecting = true
+        }
+        return true
+    }
+
+    private func discardSpeculativeDial() {
+        guard let client = speculativeClient else { return }
+        let connection = speculativeConnection
+        speculativeClient = nil
+        speculativeConnection = nil
+        speculativeConfigurationID = nil
+        if let connection {
+            proxyQueue.async { connection.cancel() }
+        }
+        client.cancel()
+    }
+
     // MARK: - MITM Session
 
     private func startMITMSession() {
         guard let stack = TunnelStack.shared else { abort(); return }
         let sni = mitmSNI ?? dstHost
+        stack.warmMITMIfNeeded()
         
         let cache: MITMLeafCertCache?
         if mitmPlaintext {
@@ -679,15 +1040,7 @@ class TCPConnection {
             }
         }
 
-        handshakeTimer?.cancel()
-        handshakeTimer = nil
-        activityTimer = ActivityTimer(
-            queue: lwipQueue,
-            timeout: TunnelConstants.connectionIdleTimeout
-        ) { [weak self] in
-            guard let self, !self.closed else { return }
-            self.close()
-        }
+        armIdleTimeout()
 
         let initialClientHello = pendingData
         pendingData.removeAll(keepingCapacity: true)
@@ -711,7 +1064,7 @@ class TCPConnection {
                     completion?(TransportError.notConnected)
                     return
                 }
-                self.activityTimer?.update()
+                self.noteActivity()
                 self.writeToLWIP(data)
                 completion?(nil)
             }
@@ -735,7 +1088,7 @@ class TCPConnection {
             acknowledgeReceivedBytes(initialClientHello.count)
         }
 
-        session.start(sni: sni)
+        session.start(sni: sni, clientHello: sniffedClientHello)
     }
 
     private enum UpstreamRoute {
@@ -867,72 +1220,130 @@ class TCPConnection {
               !receiveInFlight,
               pendingWriteCount < TunnelConstants.drainLowWaterMark,
               let connection = proxyConnection else { return }
+        if let governor, !governor.admits(governedBytes) {
+            governor.park(self)
+            return
+        }
 
         receiveInFlight = true
-        connection.receive { [weak self] data, error in
-            guard let self else { return }
-
-            self.lwipQueue.async {
-                self.receiveInFlight = false
-                guard !self.closed else { return }
-
-                if let error {
-                    self.reportFailure("Receive", error: error)
-                    self.abort()
-                    return
-                }
-
-                guard let data, !data.isEmpty else {
-                    self.downlinkDone = true
-                    if self.uplinkDone {
-                        self.close()
-                    } else {
-                        self.activityTimer?.setTimeout(TunnelConstants.uplinkOnlyTimeout)
+        if splicedReceive == nil { splicedReceive = connection.directReceiveTransport }
+        if let splicedReceive {
+            splicedReceive.receive { [weak self] data, isComplete, error in
+                guard let self else { return }
+                self.lwipQueue.async {
+                    // An empty read short of EOF is not a close; just read again.
+                    if error == nil, data?.isEmpty ?? true, !isComplete {
+                        self.receiveInFlight = false
+                        self.tryArmReceive()
+                        return
                     }
-                    return
+                    self.handleProxyReceive(data, error: error)
                 }
+            }
+            return
+        }
+        proxyQueue.async {
+            connection.receive { [weak self] data, error in
+                guard let self else { return }
 
-                self.activityTimer?.update()
-                self.writeToLWIP(data)
+                self.lwipQueue.async {
+                    self.handleProxyReceive(data, error: error)
+                }
             }
         }
     }
 
-    // MARK: - lwIP Write Helper
+    private func handleProxyReceive(_ data: Data?, error: Error?) {
+        receiveInFlight = false
+        guard !closed else { return }
 
-    /// Writes as much as lwIP's send buffer accepts; returns bytes written, or -1 on a
-    /// fatal tcp_write error. `retryOnEmpty` flushes a full buffer once so ACKs free snd_buf.
-    private func feedLWIP(_ base: UnsafeRawPointer, count: Int, retryOnEmpty: Bool = false) -> Int {
-        var offset = 0
-        while offset < count {
-            var sndbuf = Int(lwip_bridge_tcp_sndbuf(pcb))
-            if sndbuf <= 0 {
-                if retryOnEmpty {
-                    lwip_bridge_tcp_output(pcb)
-                    sndbuf = Int(lwip_bridge_tcp_sndbuf(pcb))
-                }
-                guard sndbuf > 0 else { break }
+        if let error {
+            reportFailure("Receive", error: error)
+            if !bypass {
+                TunnelStack.shared?.nodeHealth.record(configuration.id, .reset)
             }
-            let chunkSize = min(min(sndbuf, count - offset), TunnelConstants.tcpMaxWriteSize)
-            let error = lwip_bridge_tcp_write(pcb, base + offset, UInt16(chunkSize))
-            if error != 0 {
-                if error == -1 { break }  // ERR_MEM: transient
-                return -1               // fatal error
+            abort()
+            return
+        }
+
+        guard let data, !data.isEmpty else {
+            downlinkDone = true
+            if uplinkDone {
+                close()
+            } else {
+                setIdleTimeout(TunnelConstants.uplinkOnlyTimeout)
             }
-            offset += chunkSize
+            return
         }
-        return offset
+
+        noteActivity()
+        writeToLWIP(data)
+    }
+
+    // MARK: - lwIP Write Helper
+
+    /// Writes as much as lwIP's send buffer accepts in one bridge call; returns bytes
+    /// written, or -1 on a fatal tcp_write error. `retryOnEmpty` flushes a full buffer
+    /// once so ACKs free snd_buf; `flush` pushes the accepted bytes out; `byReference`
+    /// queues segments that point at `base` instead of copying it.
+    private func feedLWIP(_ base: UnsafeRawPointer, count: Int, retryOnEmpty: Bool = false,
+                          flush: Bool = false, byReference: Bool = false) -> Int {
+        var flags: Int32 = 0
+        if retryOnEmpty { flags |= LWIP_BRIDGE_WRITE_RETRY }
+        if flush { flags |= LWIP_BRIDGE_WRITE_FLUSH }
+        if byReference { flags |= LWIP_BRIDGE_WRITE_REF }
+        var vec = lwip_bridge_iovec(base: base, len: Int32(clamping: count))
+        return Int(lwip_bridge_tcp_write_v(pcb, &vec, 1, flags))
     }
 
     /// Appends proxy data to the downlink backlog and drains what lwIP accepts;
     /// ordering lives in `pendingWrite`, so a prefetched receive can't race the drain.
     private func writeToLWIP(_ data: Data) {
         guard !closed, !data.isEmpty else { return }
-        TunnelStack.shared?.addBytesIn(Int64(data.count), target: routeTarget)
-        pendingWrite.append(data)
+        TunnelStack.shared?.addBytesIn(Int64(data.count), target: routeTarget, domain: accountingDomain)
+        // Large chunk, nothing queued ahead of it, one contiguous region (its bytes
+        // stay put while `data` lives): hand lwIP the bytes by reference.
+        if pendingWriteCount == 0,
+           data.count >= TunnelConstants.tcpReferenceWriteMinSize,
+           data.regions.count == 1 {
+            let written = writeByReference(data)
+            guard !closed else { return }
+            guard written < data.count else {
+                tryArmReceive()
+                return
+            }
+            pendingWrite.append(data.dropFirst(written))
+        } else {
+            pendingWrite.append(data)
+        }
         drainPendingWrite()
     }
 
+    /// Reference-mode feed of a whole chunk; `writeReferences` keeps `data` alive
+    /// until lwIP and the TUN output stage are done with it. Returns bytes accepted.
+    private func writeByReference(_ data: Data) -> Int {
+        let written = data.withUnsafeBytes { buffer -> Int in
+            guard let base = buffer.baseAddress else { return 0 }
+            return feedLWIP(base, count: buffer.count, retryOnEmpty: true, flush: true, byReference: true)
+        }
+        // Retain before any abort: queued output packets may already point into `data`.
+        let references = writeReferences ?? TCPWriteReferences(attachingTo: pcb)
+        writeReferences = references
+        references.append(data, end: lwip_bridge_tcp_snd_lbb(pcb))
+        if written == -1 {
+            reportFatalWrite(pending: data.count)
+            return 0
+        }
+        return written
+    }
+
+    private func reportFatalWrite(pending: Int) {
+        let sndbuf = Int(lwip_bridge_tcp_sndbuf(pcb))
+        let queuelen = Int(lwip_bridge_tcp_snd_queuelen(pcb))
+        reportFailure("Write", error: LWIPWriteFatalError(pending: pending, sndbuf: sndbuf, queuelen: queuelen))
+        abort()
+    }
+
     /// Drains `pendingWrite` into lwIP and re-arms the proxy receive on progress;
     /// driven by client ACKs, with a fallback retry timer when nothing was placed.
     private func drainPendingWrite() {
@@ -943,15 +1354,9 @@ class TCPConnection {
             let head = pendingWriteOffset
             let written = pendingWrite.withUnsafeBytes { buffer -> Int in
                 guard let base = buffer.baseAddress else { return 0 }
-                let n = feedLWIP(base + head, count: live, retryOnEmpty: true)
+                let n = feedLWIP(base + head, count: live, retryOnEmpty: true, flush: true)
                 if n == -1 {
-                    let sndbuf = Int(lwip_bridge_tcp_sndbuf(self.pcb))
-                    let queuelen = Int(lwip_bridge_tcp_snd_queuelen(self.pcb))
-                    self.reportFailure(
-                        "Write",
-                        error: LWIPWriteFatalError(pending: live, sndbuf: sndbuf, queuelen: queuelen)
-                    )
-                    self.abort()
+                    self.reportFatalWrite(pending: live)
                     return 0
                 }
                 return n
@@ -969,10 +1374,12 @@ class TCPConnection {
                     pendingWrite.removeSubrange(0..<pendingWriteOffset)
                     pendingWriteOffset = 0
                 }
-                lwip_bridge_tcp_output(pcb)
+                reportBufferedBytes()
             } else {
+                reportBufferedBytes()
                 // Nothing drained (ERR_MEM / zero window) — retry after a delay;
                 // don't rearm the receive while stalled.
+                HotPathMetrics.shared.add(.lwipWriteStalls)
                 lwipQueue.asyncAfter(deadline: .now() + .milliseconds(TunnelConstants.drainRetryDelayMs)) { [weak self] in
                     guard let self, !self.closed else { return }
                     self.drainPendingWrite()
@@ -985,6 +1392,70 @@ class TCPConnection {
         tryArmReceive()
     }
 
+    // MARK: - Buffer Budget
+
+    /// Folds this connection's buffered-byte change into `governor`; a throttled connection
+    /// that drained back under its share resumes without waiting for the total to ease.
+    private func reportBufferedBytes() {
+        guard let governor else { return }
+        let held = pendingWriteCount + uploadBufferCount + pendingData.count
+        let delta = held - governedBytes
+        guard delta != 0 else { return }
+        governedBytes = held
+        governor.update(by: delta)
+        if delta < 0, governor.admits(held) {
+            governor.resume(self)
+        }
+    }
+
+    /// The governor lifted this connection's throttle: release the held-back window and
+    /// re-arm the downlink.
+    func governorDidResume() {
+        guard !closed else { return }
+        if deferredUplinkAck > 0 {
+            let byteCount = deferredUplinkAck
+            deferredUplinkAck = 0
+            acknowledgeReceivedBytes(byteCount)
+        }
+        tryArmReceive()
+    }
+
+    // MARK: - Memory Pressure
+
+    /// Drops the spare capacity the buffers keep between bursts; live bytes stay.
+    func trimBuffers() {
+        guard !closed else { return }
+        if pendingWriteCount == 0 {
+            pendingWrite = Data()
+            pendingWriteOffset = 0
+        } else if pendingWriteOffset > 0 {
+            pendingWrite = pendingWrite.subdata(in: pendingWriteOffset..<pendingWrite.count)
+            pendingWriteOffset = 0
+        }
+        if uploadBufferCount == 0 {
+            uploadPipeline.buffer = Data()
+            uploadPipeline.bufferOffset = 0
+        }
+        if pendingData.isEmpty {
+            pendingData = Data()
+        }
+    }
+
+    /// The downlink backlog, when the app has ACKed nothing for `stalledFor`; nil for a
+    /// connection that's draining or has nothing backlogged.
+    func stalledDownlinkBacklog(now: TimeInterval, stalledFor: TimeInterval) -> Int? {
+        guard !closed, pendingWriteCount > 0, now - lastDownlinkProgress >= stalledFor else { return nil }
+        return pendingWriteCount
+    }
+
+    /// Aborts a stalled connection to free its backlog before jetsam takes the whole tunnel.
+    func shedForMemoryPressure() {
+        guard !closed else { return }
+        logger.warning("[TCP] Memory pressure: shedding \(endpointDescription) with \(pendingWriteCount) bytes backlogged")
+        failureReporter.markReported()
+        abort()
+    }
+
     // MARK: - Close / Abort
 
     /// Best-effort flush before close so drained bytes precede the FIN.
@@ -993,19 +1464,20 @@ class TCPConnection {
         guard live > 0 else { return }
 
         let head = pendingWriteOffset
-        let written = pendingWrite.withUnsafeBytes { buffer -> Int in
-            guard let base = buffer.baseAddress else { return 0 }
-            return max(feedLWIP(base + head, count: live), 0)  // treat fatal as 0 (best-effort)
-        }
-
-        if written > 0 {
-            lwip_bridge_tcp_output(pcb)
+        pendingWrite.withUnsafeBytes { buffer in
+            guard let base = buffer.baseAddress else { return }
+            _ = feedLWIP(base + head, count: live, flush: true)  // best-effort; fatal is ignored
         }
     }
 
     func close() {
         guard !closed else { return }
         closed = true
+        // Un-recved bytes would turn the FIN into an RST.
+        if deferredUplinkAck > 0 {
+            acknowledgeReceivedBytes(deferredUplinkAck)
+            deferredUplinkAck = 0
+        }
         flushPendingToLWIP()
         lwip_bridge_tcp_close(pcb)
         releaseProxy()
@@ -1034,8 +1506,7 @@ class TCPConnection {
         let alert: [UInt8] = [0x15, 0x03, 0x03, 0x00, 0x02, 0x02, 0x31]
         alert.withUnsafeBufferPointer { buffer in
             guard let base = buffer.baseAddress else { return }
-            _ = feedLWIP(UnsafeRawPointer(base), count: alert.count, retryOnEmpty: true)
-            lwip_bridge_tcp_output(pcb)
+            _ = feedLWIP(UnsafeRawPointer(base), count: alert.count, retryOnEmpty: true, flush: true)
         }
         rejectGracefully()
     }
@@ -1049,26 +1520,85 @@ class TCPConnection {
     }
 
     private func releaseProxy() {
-        handshakeTimer?.cancel()
-        handshakeTimer = nil
-        sniffDeadline?.cancel()
-        sniffDeadline = nil
+        handshakeDeadline = .infinity
+        sniffDeadline = .infinity
+        earlyDataDeadline = .infinity
+        idleTimeout = nil
+        deadlines?.remove(self)
         sniffer = nil
-        activityTimer?.cancel()
-        activityTimer = nil
         let connection = proxyConnection
         let client = proxyClient
         let session = mitmSession
         proxyConnection = nil
+        splicedReceive = nil
+        splicedSend = nil
         proxyClient = nil
         proxyConnecting = false
+        dialRace?.cancel()
+        dialRace = nil
         pendingData = Data()
         pendingWrite = Data()
         pendingWriteOffset = 0
+        // lwIP's ext-arg reference keeps the buffers until the PCB is freed.
+        writeReferences = nil
         uploadPipeline = UploadPipeline()
+        deferredUplinkAck = 0
+        governor?.unregister(self, heldBytes: governedBytes)
+        governor = nil
+        governedBytes = 0
         mitmSession = nil
         session?.cancel(error: nil)
-        connection?.cancel()
+        discardSpeculativeDial()
+        // Behind any send or receive still queued for it.
+        if let connection {
+            proxyQueue.async { connection.cancel() }
+        }
         client?.cancel()
     }
 }
+
+// MARK: - TCPWriteReferences
+
+/// Downlink buffers a PCB's reference-mode segments point into, oldest first,
+/// each tagged with the sequence number just past its last byte. Shared between
+/// the ``TCPConnection`` (which trims it as ACKs free segments) and the PCB's
+/// lwIP ext-arg (+1, released when lwIP frees the PCB), so buffers outlive a
+/// closed connection whose FIN_WAIT segments are still retransmitting.
+/// Lives on lwipQueue.
+final class TCPWriteReferences {
+    private var buffers: [(end: UInt32, data: Data)] = []
+    private var head = 0
+
+    init(attachingTo pcb: UnsafeMutableRawPointer) {
+        lwip_bridge_tcp_set_write_refs(pcb, Unmanaged.passRetained(self).toOpaque())
+    }
+
+    func append(_ data: Data, end: UInt32) {
+        buffers.append((end: end, data: data))
+    }
+
+    /// Retires every buffer wholly before `floor` (TCP sequence order, mod 2^32).
+    func retire(upTo floor: UInt32) {
+        while head < buffers.count, Int32(bitPattern: buffers[head].end &- floor) <= 0 {
+            TunnelStack.shared?.retireWriteReference(buffers[head].data)
+            buffers[head].data = Data()
+            head += 1
+        }
+        if head == buffers.count {
+            buffers.removeAll(keepingCapacity: true)
+            head = 0
+        } else if head > buffers.count - head {
+            buffers.removeSubrange(0..<head)
+            head = 0
+        }
+    }
+
+    /// The PCB is gone, so lwIP holds none of these any more.
+    func retireAll() {
+        for index in head..<buffers.count {
+            TunnelStack.shared?.retireWriteReference(buffers[index].data)
+        }
+        buffers.removeAll()
+        head = 0
+    }
+}
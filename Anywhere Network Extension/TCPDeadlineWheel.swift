@@ -0,0 +1,162 @@
+//
+//  TCPDeadlineWheel.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Two-level hierarchical timing wheel of TCP connections keyed by their next deadline
+/// (idle, handshake or sniff; see ``TCPConnection/nextDeadline``), ticked by one
+/// ``TunnelScheduler`` task instead of a GCD timer per connection and deadline. The inner
+/// wheel has a slot per tick; the outer wheel a slot per inner revolution, cascaded into
+/// the inner one as the cursor reaches it. Like ``UDPExpiryWheel`` it is lazy: activity only
+/// pushes a deadline later, so resetting an idle deadline is a store on the connection, and
+/// a connection whose slot comes due early is re-slotted for its current deadline. Only a
+/// deadline moving earlier needs ``schedule(_:)``. Lives on lwipQueue.
+final class TCPDeadlineWheel {
+
+    static let tickInterval: TimeInterval = 0.25
+
+    private static let innerBits = 6
+    private static let innerCount = 1 << innerBits
+    /// 64 × 16 s covers ``TunnelConstants/connectionIdleTimeout`` with room to spare; a
+    /// farther deadline parks in the last outer slot and is re-slotted from there.
+    private static let outerCount = 64
+
+    private var inner: [[ObjectIdentifier: TCPConnection]]
+    private var outer: [[ObjectIdentifier: TCPConnection]]
+    /// Last tick already visited.
+    private var cursor: Int
+    private var count = 0
+    /// Set while `advance` runs; deadline handlers schedule back into the wheel from it.
+    private var advancing = false
+
+    var isEmpty: Bool { count == 0 }
+
+    /// Coarse clock for activity stamps, refreshed every tick and on every `schedule`.
+    private(set) var now: TimeInterval
+
+    /// Called with `true` when the wheel gains its first connection and `false` when it
+    /// empties, so the driving task only wakes while there is something to time.
+    var onOccupancyChange: ((Bool) -> Void)?
+
+    init(now: TimeInterval) {
+        inner = Array(repeating: [:], count: Self.innerCount)
+        outer = Array(repeating: [:], count: Self.outerCount)
+        cursor = Self.tick(now)
+        self.now = now
+    }
+
+    private static func tick(_ time: TimeInterval) -> Int {
+        Int((time / tickInterval).rounded(.down))
+    }
+
+    /// (Re)schedules `connection` for its current ``TCPConnection/nextDeadline``; an
+    /// infinite deadline leaves it unscheduled.
+    func schedule(_ connection: TCPConnection) {
+        let wasEmpty = count == 0
+        now = MonotonicClock.now
+        if wasEmpty, !advancing {
+            // Paused while empty, so the cursor may be far behind; nothing is slotted to skip.
+            cursor = max(cursor, Self.tick(now))
+        }
+        unlink(connection)
+        place(connection)
+        noteOccupancy(wasEmpty: wasEmpty)
+    }
+
+    func remove(_ connection: TCPConnection) {
+        let wasEmpty = count == 0
+        unlink(connection)
+        noteOccupancy(wasEmpty: wasEmpty)
+    }
+
+    /// Visits every tick due by `now`: cascades an outer slot at each inner revolution, then
+    /// hands connections past their deadline to ``TCPConnection/handleDeadline(now:)``
+    /// (already unscheduled) and re-slots the rest. A gap longer than the whole wheel
+    /// (device sleep) visits each slot once.
+    func advance(to now: TimeInterval) {
+        self.now = now
+        let target = Self.tick(now)
+        guard target > cursor else { return }
+        let wasEmpty = count == 0
+        advancing = true
+        defer { advancing = false }
+        let steps = min(target - cursor, Self.innerCount * Self.outerCount)
+        let start = cursor
+        for t in (start + 1)...(start + steps) {
+            if t & (Self.innerCount - 1) == 0 {
+                cursor = t - 1
+                let slot = (t >> Self.innerBits) % Self.outerCount
+                if !outer[slot].isEmpty {
+                    let cascading = outer[slot]
+                    outer[slot] = [:]
+                    count -= cascading.count
+                    for connection in cascading.values {
+                        connection.wheelSlot = -1
+                        place(connection)
+                    }
+                }
+            }
+            cursor = t
+            let slot = t & (Self.innerCount - 1)
+            guard !inner[slot].isEmpty else { continue }
+            let due = inner[slot]
+            inner[slot] = [:]
+            count -= due.count
+            for connection in due.values {
+                connection.wheelSlot = -1
+                if now >= connection.nextDeadline {
+                    connection.handleDeadline(now: now)
+                } else {
+                    place(connection)
+                }
+            }
+        }
+        cursor = max(cursor, target)
+        noteOccupancy(wasEmpty: wasEmpty)
+    }
+
+    // MARK: - Private
+
+    /// Slot encoding on the connection: inner slots as-is, outer slots offset by `innerCount`.
+    private func place(_ connection: TCPConnection) {
+        let deadline = connection.nextDeadline
+        guard deadline.isFinite else { return }
+        let due = max(Self.tick(deadline) + 1, cursor + 1)
+        let id = ObjectIdentifier(connection)
+        if due - cursor < Self.innerCount {
+            let slot = due & (Self.innerCount - 1)
+            inner[slot][id] = connection
+            connection.wheelSlot = slot
+        } else {
+            let revolution = min(due >> Self.innerBits, (cursor >> Self.innerBits) + Self.outerCount - 1)
+            let slot = revolution % Self.outerCount
+            outer[slot][id] = connection
+            connection.wheelSlot = Self.innerCount + slot
+        }
+        count += 1
+    }
+
+    private func unlink(_ connection: TCPConnection) {
+        let slot = connection.wheelSlot
+        guard slot >= 0 else { return }
+        let id = ObjectIdentifier(connection)
+        if slot < Self.innerCount {
+            inner[slot].removeValue(forKey: id)
+        } else {
+            outer[slot - Self.innerCount].removeValue(forKey: id)
+        }
+        connection.wheelSlot = -1
+        count -= 1
+    }
+
+    private func noteOccupancy(wasEmpty: Bool) {
+        let isEmpty = count == 0
+        if wasEmpty != isEmpty {
+            onOccupancyChange?(!isEmpty)
+        }
+    }
+}
@@ -2,54 +2,73 @@
 //  TLSClientHelloSniffer.swift
 //  Anywhere
 //
-//  Incremental, bounds-checked parser that extracts the SNI hostname from an
-//  inbound TLS ClientHello, enabling domain-based routing for traffic that
-//  reaches the tunnel by real IP. Strictly passive; buffers at most
-//  tlsSnifferBufferLimit bytes.
+//  Incremental, bounds-checked parser that extracts the SNI hostname (and the
+//  ALPN, TLS 1.3 and ECH offers) from an inbound TLS ClientHello, enabling
+//  domain-based routing for traffic that reaches the tunnel by real IP.
+//  Strictly passive and copy-free: it reads the caller's own buffer and looks
+//  at most tlsSnifferBufferLimit bytes into it.
 //
 
 import Foundation
 
 struct TLSClientHelloSniffer {
 
+    /// What one pass over the ClientHello yields, for the routing and MITM decisions alike.
+    struct ClientHello: Equatable {
+        /// Lowercased.
+        let serverName: String
+        let alpnProtocols: [String]
+        /// `supported_versions` lists TLS 1.3.
+        let supportsTLS13: Bool
+        /// Carries an `encrypted_client_hello` extension (real or GREASE), so `serverName`
+        /// may be the outer public name.
+        let offersECH: Bool
+    }
+
     enum State: Equatable {
         /// Need more bytes to decide.
         case needMore
         /// First bytes do not start with a TLS Handshake record (0x16).
         case notTLS
-        /// SNI extracted from a well-formed ClientHello (lowercased).
-        case found(serverName: String)
+        /// Extracted from a well-formed ClientHello that carries SNI.
+        case found(ClientHello)
         /// TLS-shaped but SNI unavailable (malformed, absent, or cap reached);
         /// caller should fall back to IP-based routing.
         case unavailable
     }
 
     private let bufferLimit: Int
-    private var buffer = Data()
     private(set) var state: State = .needMore
 
+    // Resumable record-layer position, as offsets from the buffer's start so they survive
+    // the caller appending to it.
+
+    /// Start of the first record not yet consumed.
+    private var scanned = 0
+    /// Handshake bytes of each consumed record.
+    private var fragments: [Range<Int>] = []
+    private var fragmentBytes = 0
+    /// 4 + body length, once the handshake header is in hand.
+    private var messageLength: Int?
+
     init(bufferLimit: Int = TunnelConstants.tlsSnifferBufferLimit) {
         self.bufferLimit = bufferLimit
     }
 
-    /// Appends `data` and returns the new state; no-ops after a terminal state.
-    mutating func feed(_ data: Data) -> State {
-        guard state == .needMore, !data.isEmpty else { return state }
+    /// Advances over `buffer` — everything the client has sent so far, a prefix of which
+    /// earlier calls saw — and returns the new state; no-ops after a terminal state.
+    /// Records already consumed aren't re-read.
+    mutating func feed(_ buffer: Data) -> State {
+        guard state == .needMore, !buffer.isEmpty else { return state }
 
-        // Fast reject before copying: a TLS record starts with 0x16, so the
-        // buffer stays empty for non-TLS protocols.
-        if buffer.isEmpty, data[data.startIndex] != 0x16 {
+        if buffer[buffer.startIndex] != 0x16 {
             state = .notTLS
             return state
         }
-
-        buffer.append(data)
-        if buffer.count > bufferLimit {
+        state = advance(buffer)
+        if state == .needMore, buffer.count > bufferLimit {
             state = .unavailable
-            return state
         }
-
-        state = parse(buffer)
         return state
     }
 
@@ -58,45 +77,65 @@ struct TLSClientHelloSniffer {
     /// TLS record layer: [content_type:1][legacy_version:2][length:2][fragment]
     ///
     /// A client may split the ClientHello across several TLS records (RFC 8446 §5.1) — common with
-    /// TLS-fragmenting / anti-censorship clients. Reassemble the handshake message across consecutive
+    /// TLS-fragmenting / anti-censorship clients. Consume the handshake message across consecutive
     /// handshake records before parsing, rather than giving up after the first record (which would
-    /// drop SNI-based routing for those clients). The total is bounded by `bufferLimit`.
-    private func parse(_ buf: Data) -> State {
-        guard buf.count >= 5 else { return .needMore }
+    /// drop SNI-based routing for those clients). The scan is bounded by `bufferLimit`.
+    private mutating func advance(_ buf: Data) -> State {
         let base = buf.startIndex
-        guard buf[base] == 0x16 else { return .unavailable }
-
-        var fragment = Data()
-        var offset = 0                  // bytes scanned from base
-        var messageLength: Int?         // 4 + bodyLen, once the handshake header is in hand
-        let total = buf.count
+        let total = min(buf.count, bufferLimit)
         while true {
-            guard total - offset >= 5 else { return .needMore }
-            let recordStart = buf.index(base, offsetBy: offset)
+            guard total - scanned >= 5 else { return .needMore }
+            let recordStart = base + scanned
             guard buf[recordStart] == 0x16 else { return .unavailable } // non-handshake record mid-message
             // RFC 8446 §5.1: record fragment length ≤ 2^14.
-            let fragLen = (Int(buf[buf.index(recordStart, offsetBy: 3)]) << 8) | Int(buf[buf.index(recordStart, offsetBy: 4)])
+            let fragLen = (Int(buf[recordStart + 3]) << 8) | Int(buf[recordStart + 4])
             guard fragLen > 0, fragLen <= 16_384 else { return .unavailable }
-            let recordTotal = 5 + fragLen
-            guard total - offset >= recordTotal else { return .needMore }
-            let fStart = buf.index(recordStart, offsetBy: 5)
-            let fEnd = buf.index(fStart, offsetBy: fragLen)
-            fragment.append(buf[fStart..<fEnd])
-            offset += recordTotal
-            if messageLength == nil, fragment.count >= 4 {
-                let b = fragment.startIndex
-                guard fragment[b] == 0x01 else { return .unavailable } // ClientHello
-                let bodyLen = (Int(fragment[fragment.index(b, offsetBy: 1)]) << 16)
-                            | (Int(fragment[fragment.index(b, offsetBy: 2)]) << 8)
-                            | Int(fragment[fragment.index(b, offsetBy: 3)])
+            guard total - scanned >= 5 + fragLen else { return .needMore }
+            fragments.append((scanned + 5)..<(scanned + 5 + fragLen))
+            fragmentBytes += fragLen
+            scanned += 5 + fragLen
+
+            if messageLength == nil, fragmentBytes >= 4 {
+                guard handshakeByte(0, in: buf) == 0x01 else { return .unavailable } // ClientHello
+                let bodyLen = (Int(handshakeByte(1, in: buf)) << 16)
+                            | (Int(handshakeByte(2, in: buf)) << 8)
+                            | Int(handshakeByte(3, in: buf))
                 messageLength = 4 + bodyLen
             }
-            if let messageLength, fragment.count >= messageLength {
-                return parseHandshake(fragment.prefix(messageLength))
+            if let messageLength, fragmentBytes >= messageLength {
+                return parseHandshake(handshakeMessage(messageLength, in: buf))
             }
         }
     }
 
+    /// Byte `index` of the handshake stream, across record boundaries.
+    private func handshakeByte(_ index: Int, in buf: Data) -> UInt8 {
+        var remaining = index
+        for range in fragments {
+            if remaining < range.count {
+                return buf[buf.startIndex + range.lowerBound + remaining]
+            }
+            remaining -= range.count
+        }
+        preconditionFailure("handshake byte \(index) past the consumed records")
+    }
+
+    /// The whole message: a slice of `buf` when one record holds it (the common case);
+    /// reassembled only for a fragmented ClientHello.
+    private func handshakeMessage(_ length: Int, in buf: Data) -> Data {
+        let base = buf.startIndex
+        if let first = fragments.first, first.count >= length {
+            return buf[(base + first.lowerBound)..<(base + first.lowerBound + length)]
+        }
+        var message = Data(capacity: length)
+        for range in fragments {
+            let take = min(range.count, length - message.count)
+            message.append(buf[(base + range.lowerBound)..<(base + range.lowerBound + take)])
+            if message.count == length { break }
+        }
+        return message
+    }
+
     /// Handshake layer: [msg_type:1][length:3][body]
     private func parseHandshake(_ frag: Data) -> State {
         var current = Cursor(frag)
@@ -125,22 +164,41 @@ struct TLSClientHelloSniffer {
         return parseExtensions(extensions)
     }
 
+    /// One walk collects every extension the callers decide on. A malformed SNI makes the
+    /// hello unavailable; a malformed extension past it ends the walk with what was found.
     private func parseExtensions(_ buf: Data) -> State {
         var current = Cursor(buf)
+        var serverName: String?
+        var alpnProtocols: [String] = []
+        var supportsTLS13 = false
+        var offersECH = false
         while !current.isAtEnd {
             guard let extType = current.readU16(),
                   let extLen = current.readU16(),
                   let extData = current.readBytes(extLen) else {
-                return .unavailable
+                break
             }
-            if extType == 0x0000 {
-                if let name = parseServerNameList(extData) {
-                    return .found(serverName: name)
-                }
-                return .unavailable
+            switch extType {
+            case 0x0000:
+                guard let name = parseServerNameList(extData) else { return .unavailable }
+                serverName = name
+            case 0x0010:
+                alpnProtocols = parseALPN(extData)
+            case 0x002B:
+                supportsTLS13 = parseSupportedVersions(extData).contains(0x0304)
+            case 0xFE0D:
+                offersECH = true
+            default:
+                break
             }
         }
-        return .unavailable
+        guard let serverName else { return .unavailable }
+        return .found(ClientHello(
+            serverName: serverName,
+            alpnProtocols: alpnProtocols,
+            supportsTLS13: supportsTLS13,
+            offersECH: offersECH
+        ))
     }
 
     /// server_name extension:
@@ -164,6 +222,34 @@ struct TLSClientHelloSniffer {
         return nil
     }
 
+    /// application_layer_protocol_negotiation: uint16 length + list of uint8-length names.
+    /// A malformed list yields what parsed before the fault.
+    private func parseALPN(_ buf: Data) -> [String] {
+        var current = Cursor(buf)
+        guard let listLen = current.readU16(), let list = current.readBytes(listLen) else { return [] }
+        var listCursor = Cursor(list)
+        var protocols: [String] = []
+        while !listCursor.isAtEnd {
+            guard let nameLen = listCursor.readU8(),
+                  let nameData = listCursor.readBytes(Int(nameLen)),
+                  let name = String(data: nameData, encoding: .utf8) else { break }
+            protocols.append(name)
+        }
+        return protocols
+    }
+
+    /// supported_versions (ClientHello form): uint8 length + list of uint16 versions.
+    private func parseSupportedVersions(_ buf: Data) -> [Int] {
+        var current = Cursor(buf)
+        guard let listLen = current.readU8(), let list = current.readBytes(Int(listLen)) else { return [] }
+        var listCursor = Cursor(list)
+        var versions: [Int] = []
+        while let version = listCursor.readU16() {
+            versions.append(version)
+        }
+        return versions
+    }
+
     // MARK: - Cursor
 
     private struct Cursor {
@@ -204,6 +290,7 @@ struct TLSClientHelloSniffer {
             return v
         }
 
+        /// A slice sharing `data`'s storage; no bytes are copied.
         mutating func readBytes(_ n: Int) -> Data? {
             guard n >= 0, position &+ n <= data.endIndex else { return nil }
             let slice = data[position..<(position &+ n)]
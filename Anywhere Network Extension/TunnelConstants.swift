@@ -22,25 +22,54 @@ enum TunnelConstants {
     /// Max wait for a TLS ClientHello before falling back to IP-based routing,
     /// so server-speaks-first protocols (SSH, SMTP, FTP) don't stall.
     static let sniffDeadline: TimeInterval = 0.5
+    /// How long a fresh proxy leg waits for the client's first bytes to carry its request
+    /// header before sending the header alone; rounded up to the deadline wheel's tick.
+    static let earlyDataWait: TimeInterval = 0.1
 
     // MARK: - TCP Buffer Sizes
 
-    /// Max bytes per tcp_write call (16 KB ≈ 12 segments at TCP_MSS=1360); must stay in sync with lwipopts.h.
-    static let tcpMaxWriteSize = 16 * 1024
+    /// Proxy chunks at least this large go to lwIP by reference (no copy into segments) when nothing is backlogged.
+    static let tcpReferenceWriteMinSize = 16 * 1024
     /// Max bytes per upload send; UInt16.max stays safe for protocols with 2-byte length framing (e.g. Vision padding).
     static let uploadChunkSize = Int(UInt16.max)
+    /// A mid-burst upload buffer this large ships without waiting; about one TLS record.
+    static let uploadCoalesceFlushSize = 16 * 1024
+    /// An upload this long after the previous send starts a burst and ships at once.
+    static let uploadCoalesceIdleGap: TimeInterval = 0.02
+    /// Bounds on ``TCPConnection``'s RTT-scaled coalescing window.
+    static let uploadCoalesceMinWindow: TimeInterval = 0.001
+    static let uploadCoalesceMaxWindow: TimeInterval = 0.005
     /// Safety cap on per-connection pendingData; 2 × TCP_WND so it only fires on runaway bookkeeping drift.
-    static let tcpMaxPendingDataSize = 2 * 1024 * 1360
+    static let tcpMaxPendingDataSize = 2 * Int(lwip_bridge_tcp_wnd())
     /// Max packets per writePackets call; 128 is the empirical utun ceiling (256 trips ENOSPC).
     static let tunnelMaxPacketsPerWrite = 128
+    /// Initial ``TunnelOutputRing`` slots (8 writePackets windows); grows only under a sustained backlog.
+    static let tunnelOutputRingCapacity = 8 * tunnelMaxPacketsPerWrite
 
     /// Downlink backlog low-water mark below which the next proxy receive is prefetched
     /// (otherwise downlink degrades to stop-and-wait); half TCP_SND_BUF (lwipopts.h).
-    static let drainLowWaterMark = 512 * 1360
+    static let drainLowWaterMark = Int(lwip_bridge_tcp_snd_buf()) / 2
+    /// Queues TCP connections drive their proxy legs on, by 4-tuple hash; the same
+    /// core budget as ``udpShardCount``, leaving one core for ``TunnelStack/lwipQueue``.
+    static let tcpProxyShardCount = udpShardCount
+
+    // MARK: - TCP Buffer Budget
+
+    /// Process-wide cap on TCP connections' Swift-side buffers (downlink backlog, upload
+    /// buffer, pre-dial data); per ``TuningProfile``, well inside the extension's jetsam limit.
+    static let tcpBufferBudget = TuningProfile.current.tcpBufferBudget
+    /// Floor on ``TCPBufferGovernor/fairShare`` so a crowd of connections can each still
+    /// hold about one proxy chunk.
+    static let tcpBufferMinShare = 256 * 1024
+    /// A downlink backlog the app hasn't ACKed into for this long is sheddable under
+    /// critical memory pressure.
+    static let memoryPressureStallInterval: TimeInterval = 5
+    /// Leaves the MITM leaf cache keeps through a memory-pressure trim.
+    static let memoryPressureMITMLeafKeep = 32
 
     // MARK: - UDP Settings
 
-    static let udpMaxBufferSize = 256 * 1024
+    static let udpMaxBufferSize = TuningProfile.current.udpPendingBufferSize
     /// Idle timeout for unreplied UDP flows; mirrors Linux conntrack's `nf_conntrack_udp_timeout` (30s) so probe storms are reaped fast.
     static let udpIdleTimeoutUnreplied: TimeInterval = 30
     /// Idle timeout for established UDP flows; matches Linux conntrack's `nf_conntrack_udp_timeout_stream` (120s).
@@ -48,9 +77,12 @@ enum TunnelConstants {
     /// Downlink datagrams before a flow earns the longer stream timeout; one
     /// reply is not enough since STUN and one-shot DNS get exactly one answer.
     static let udpStreamMinReplies = 4
-    /// Hard ceiling on concurrent UDP flows; each pins a socket plus a 64 KB
+    /// Hard ceiling on concurrent UDP flows; each pins a socket plus its pending
     /// buffer, and an uncapped probe storm can get the extension jetsam-killed.
-    static let udpMaxFlows = 256
+    static let udpMaxFlows = TuningProfile.current.udpMaxFlows
+    /// UDP shards, each a serial queue owning the flows whose source hashes to
+    /// it; one core is left for ``TunnelStack/lwipQueue``.
+    static let udpShardCount = max(1, min(4, ProcessInfo.processInfo.activeProcessorCount - 1))
 
     // MARK: - Log Buffer
 
@@ -68,8 +100,9 @@ enum TunnelConstants {
     // MARK: - Timer Intervals
 
     /// lwIP tick interval (ms); must equal `TCP_TMR_INTERVAL` in `port/lwipopts.h`.
+    /// The timer's first run; later ones follow `lwip_bridge_check_timeouts`.
     static let lwipTimeoutIntervalMs = 100
-    /// Leeway for the lwIP tick (ms); lets libdispatch coalesce wakeups.
+    /// Leeway for the lwIP timer (ms); lets libdispatch coalesce wakeups.
     static let lwipTimeoutLeewayMs = 10
     static let udpCleanupIntervalSec = 1
     /// Leeway for the UDP cleanup reaper (ms); reaping tolerates the slack.
@@ -107,4 +140,50 @@ enum TunnelConstants {
             ? ["1.1.1.1", "1.0.0.1", "2606:4700:4700::1111", "2606:4700:4700::1001"]
             : ["1.1.1.1", "1.0.0.1"]
     }
+
+    /// Upstreams a forwarded query is raced across, best-ranked first.
+    static let dnsRaceFanout = 2
+    /// Bounds on the wait before the next upstream joins a race.
+    static let dnsRaceMinStagger: TimeInterval = 0.05
+    static let dnsRaceMaxStagger: TimeInterval = 0.3
+    /// After this long a race stops waiting on its unanswered legs.
+    static let dnsRaceTimeout: TimeInterval = 5
+
+    /// Independently locked shards of the forwarded-response cache.
+    static let dnsCacheShardCount = 4
+    static let dnsCacheEntriesPerShard = 128
+    /// Ceiling on how long a positive forwarded response is reused.
+    static let dnsCacheMaxTTL: TimeInterval = 3600
+    /// Ceiling for NXDOMAIN / NODATA; RFC 2308 §5 suggests at most hours, kept short so new records show up.
+    static let dnsCacheMaxNegativeTTL: TimeInterval = 900
+
+    // MARK: - Routing
+
+    /// Independently locked shards of the per-domain routing decision cache.
+    static let routeCacheShardCount = 4
+    static let routeCacheEntriesPerShard = 256
+    /// Cap on kernel-bypass excluded routes per address family; past it only the widest
+    /// prefixes are excluded and the rest stay on the in-tunnel DIRECT path.
+    static let kernelBypassMaxRoutes = 1024
+
+    // MARK: - Auto-Select
+
+    /// Time between health-probe rounds over an auto-select group's candidates.
+    static let healthProbeInterval: TimeInterval = 120
+    /// Floor between rounds, however often live-traffic failures ask for an early one.
+    static let healthProbeMinInterval: TimeInterval = 10
+    /// A url-test switch must improve the score by at least this many ms, so near-ties don't flap.
+    static let healthProbeTolerance: Double = 50
+    /// Smoothed failure rate at which a node stops counting as healthy.
+    static let healthProbeUnhealthyFailureRate: Double = 0.5
+    /// Delay before a dial to the selected node also tries the next candidate (RFC 8305 §5).
+    static let dialRaceStagger: TimeInterval = 0.25
+    /// Nodes a dial to the selected node may race, the selected one included.
+    static let dialRaceWidth = 3
+    /// Nodes ``NodeTelemetry`` keeps live-traffic outcomes for.
+    static let nodeTelemetryCapacity = 64
+    /// Seconds over which a live outcome's weight halves.
+    static let nodeTelemetryHalfLife: TimeInterval = 120
+    /// Decayed outcome weight below which a node's live failure rate isn't judged.
+    static let nodeTelemetryMinimumWeight: Double = 3
 }
@@ -0,0 +1,89 @@
+//
+//  TunnelOutputRing.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// FIFO of packets bound for utun, drained in `tunnelMaxPacketsPerWrite`
+/// windows. Slots are preallocated and reused, so push and pop never shift
+/// elements; a backlog past capacity doubles the ring rather than dropping,
+/// because an lwIP entry owns a buffer (its `releaseCtx`, nil for Swift-built
+/// packets) that must still go back through `lwip_bridge_release_batch`.
+/// Not thread-safe — ``TunnelStack/outputBufferLock`` guards it.
+struct TunnelOutputRing {
+
+    private struct Entry {
+        let packet: Data
+        let proto: NSNumber
+        let releaseCtx: UnsafeMutableRawPointer?
+    }
+
+    private var slots: ContiguousArray<Entry?>
+    private var head = 0
+    private(set) var count = 0
+
+    /// `capacity` is rounded up to a power of two so indices wrap with a mask.
+    init(capacity: Int) {
+        var size = 1
+        while size < capacity { size <<= 1 }
+        slots = ContiguousArray(repeating: nil, count: size)
+    }
+
+    var isEmpty: Bool { count == 0 }
+
+    mutating func push(_ packet: Data, proto: NSNumber, releaseCtx: UnsafeMutableRawPointer?) {
+        if count == slots.count { grow() }
+        slots[(head + count) & (slots.count - 1)] = Entry(packet: packet, proto: proto, releaseCtx: releaseCtx)
+        count += 1
+    }
+
+    /// Moves up to `limit` oldest entries into the caller's (emptied) arrays;
+    /// only non-nil release ctxs are appended to `releaseCtxs`.
+    mutating func popWindow(
+        limit: Int,
+        packets: inout [Data],
+        protocols: inout [NSNumber],
+        releaseCtxs: inout [UnsafeMutableRawPointer?]
+    ) {
+        let n = min(limit, count)
+        let mask = slots.count - 1
+        for i in 0..<n {
+            let index = (head + i) & mask
+            guard let entry = slots[index] else { continue }
+            packets.append(entry.packet)
+            protocols.append(entry.proto)
+            if let ctx = entry.releaseCtx { releaseCtxs.append(ctx) }
+            slots[index] = nil
+        }
+        head = (head + n) & mask
+        count -= n
+    }
+
+    /// Empties the ring, returning the release ctxs it still owned.
+    mutating func removeAll() -> [UnsafeMutableRawPointer?] {
+        var releaseCtxs: [UnsafeMutableRawPointer?] = []
+        let mask = slots.count - 1
+        for i in 0..<count {
+            let index = (head + i) & mask
+            if let ctx = slots[index]?.releaseCtx { releaseCtxs.append(ctx) }
+            slots[index] = nil
+        }
+        head = 0
+        count = 0
+        return releaseCtxs
+    }
+
+    /// Doubles the slot array, unwrapping the live run to start at index 0.
+    private mutating func grow() {
+        let mask = slots.count - 1
+        var next = ContiguousArray<Entry?>(repeating: nil, count: slots.count * 2)
+        for i in 0..<count {
+            next[i] = slots[(head + i) & mask]
+        }
+        slots = next
+        head = 0
+    }
+}
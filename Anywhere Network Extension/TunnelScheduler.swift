@@ -8,13 +8,33 @@
 import Foundation
 
 final class TunnelScheduler {
-    private final class ScheduledTask {
+    /// Lets a task's owner stop its wakeups while it has nothing to do.
+    final class Handle {
+        fileprivate weak var task: ScheduledTask?
+
+        fileprivate init(task: ScheduledTask) {
+            self.task = task
+        }
+
+        /// A paused task neither fires nor wakes the CPU; resuming picks up its
+        /// repeating schedule. Thread-safe.
+        func setPaused(_ paused: Bool) {
+            task?.setPaused(paused)
+        }
+    }
+
+    fileprivate final class ScheduledTask {
         let label: String
         let queue: DispatchQueue
         let interval: TimeInterval
         let handler: () -> Void
         let timer: DispatchSourceTimer
         var lastRun: TimeInterval
+        /// Guards `paused` and `cancelled`: a suspended source must be resumed before it
+        /// is cancelled or released.
+        private let stateLock = UnfairLock()
+        private var paused = false
+        private var cancelled = false
 
         init(label: String, queue: DispatchQueue, interval: TimeInterval,
              timer: DispatchSourceTimer, handler: @escaping () -> Void) {
@@ -27,7 +47,31 @@ final class TunnelScheduler {
         }
         
         deinit {
-            timer.cancel()
+            cancel()
+        }
+
+        func setPaused(_ paused: Bool) {
+            stateLock.withLock {
+                guard !cancelled, paused != self.paused else { return }
+                self.paused = paused
+                if paused {
+                    timer.suspend()
+                } else {
+                    timer.resume()
+                }
+            }
+        }
+
+        func cancel() {
+            stateLock.withLock {
+                guard !cancelled else { return }
+                cancelled = true
+                if paused {
+                    paused = false
+                    timer.resume()
+                }
+                timer.cancel()
+            }
         }
 
         /// Must run on ``queue``.
@@ -48,12 +92,13 @@ final class TunnelScheduler {
     private let lock = UnfairLock()
     private var tasks: [ScheduledTask] = []
     
+    @discardableResult
     func schedule(
         label: String, on queue: DispatchQueue,
         every interval: TimeInterval,
         leeway: TimeInterval,
         _ handler: @escaping () -> Void
-    ) {
+    ) -> Handle {
         let timer = DispatchSource.makeTimerSource(queue: queue)
         timer.schedule(
             deadline: .now() + interval,
@@ -65,6 +110,7 @@ final class TunnelScheduler {
         timer.setEventHandler { [weak task] in task?.fire() }
         lock.withLock { tasks.append(task) }
         timer.resume()
+        return Handle(task: task)
     }
     
     /// Catch-up pass for tasks that fell due while the device was frozen.
@@ -82,7 +128,7 @@ final class TunnelScheduler {
             return current
         }
         for task in removed {
-            task.timer.cancel()
+            task.cancel()
         }
     }
 }
@@ -48,27 +48,31 @@ extension TunnelStack {
     func registerCallbacks() {
         // Output: lwIP → tunnel packet flow, batched. `Data(bytesNoCopy:)` with
         // a `.none` deallocator lets writePackets read lwIP's memory directly;
-        // ``pendingReleases`` is the actual owner, and releases must stay on
+        // the ring entry's release is the actual owner, and releases must stay on
         // lwipQueue (pbuf_free/mem_free mutate freelists with no locking under
         // NO_SYS=1).
-        lwip_bridge_set_output_fn { data, len, isIPv6, releaseCtx, release in
-            guard let shared = TunnelStack.shared, let data, let release else { return }
+        lwip_bridge_set_output_fn { data, len, isIPv6, releaseCtx in
+            guard let shared = TunnelStack.shared, let data else { return }
             let byteCount = Int(len)
             let mutableData = UnsafeMutableRawPointer(mutating: data)
             let packet = Data(bytesNoCopy: mutableData, count: byteCount, deallocator: .none)
-            let proto: NSNumber = isIPv6 != 0 ? TunnelStack.ipv6Proto : TunnelStack.ipv4Proto
-            let pending = TunnelStack.PendingRelease(ctx: releaseCtx, fn: release)
-            let needsKick: Bool = shared.outputBufferLock.withLock {
-                shared.outputPackets.append(packet)
-                shared.outputProtocols.append(proto)
-                shared.pendingReleases.append(pending)
-                if shared.outputDrainInFlight { return false }
-                shared.outputDrainInFlight = true
-                return true
-            }
-            if needsKick {
-                shared.outputQueue.async { shared.drainOutputLoop() }
+            shared.enqueueLwipOutput(packet, isIPv6: isIPv6 != 0, releaseCtx: releaseCtx)
+        }
+
+        // Chained output (header pbuf + data pbufs): the regions are stitched
+        // into one dispatch_data without copying; NSData is toll-free bridged
+        // with dispatch_data_t, so the resulting `Data` still reads lwIP's
+        // memory and the head pbuf's ref (the release ctx) owns it all.
+        lwip_bridge_set_output_chain_fn { vecs, nvecs, _, isIPv6, releaseCtx in
+            guard let shared = TunnelStack.shared, let vecs else { return }
+            var regions = DispatchData.empty
+            for i in 0..<Int(nvecs) {
+                let vec = vecs[i]
+                let region = UnsafeRawBufferPointer(start: vec.base, count: Int(vec.len))
+                regions.append(DispatchData(bytesNoCopy: region, deallocator: .custom(nil, {})))
             }
+            let packet = Data(referencing: regions as AnyObject as! NSData)
+            shared.enqueueLwipOutput(packet, isIPv6: isIPv6 != 0, releaseCtx: releaseCtx)
         }
 
         // TCP SYN filter: reject `.reject` destinations at SYN time — never
@@ -78,8 +82,6 @@ extension TunnelStack {
             guard let shared = TunnelStack.shared, let dstIP else {
                 return Int32(LWIP_BRIDGE_SYN_PASS)
             }
-            let dstIPString = TunnelStack.ipAddrToString(dstIP, isIPv6: isIPv6 != 0)
-
             // DROP if the host is flooding, RESET otherwise.
             func reject(host: String, reason: String) -> Int32 {
                 shared.requestLog.record(protocolName: "TCP", host: host, port: dstPort, routeTarget: .reject)
@@ -91,10 +93,11 @@ extension TunnelStack {
                 return Int32(LWIP_BRIDGE_SYN_RESET)
             }
 
-            switch shared.resolveFakeIP(dstIPString, dstPort: dstPort, proto: "TCP") {
+            // Match on the raw address; the string is only built for a reject.
+            switch shared.resolveFakeIP(address: dstIP, isIPv6: isIPv6 != 0, dstPort: dstPort, proto: "TCP") {
             case .passthrough:
-                if case .reject = shared.domainRouter.matchIP(dstIPString) {
-                    return reject(host: dstIPString, reason: "IP rule")
+                if case .reject = shared.domainRouter.matchIP(address: dstIP, isIPv6: isIPv6 != 0) {
+                    return reject(host: TunnelStack.ipAddrToString(dstIP, isIPv6: isIPv6 != 0), reason: "IP rule")
                 }
                 return Int32(LWIP_BRIDGE_SYN_PASS)
             case .resolved:
@@ -103,7 +106,7 @@ extension TunnelStack {
                 return reject(host: domain, reason: "fake-IP domain rule")
             case .unreachable:
                 // Stale fake-IP pool entry — drop silently rather than RST.
-                logger.debug("[TCP] SYN dropped (stale fake-IP): \(dstIPString):\(dstPort)")
+                logger.debug("[TCP] SYN dropped (stale fake-IP): \(TunnelStack.ipAddrToString(dstIP, isIPv6: isIPv6 != 0)):\(dstPort)")
                 return Int32(LWIP_BRIDGE_SYN_DROP)
             }
         }
@@ -112,7 +115,7 @@ extension TunnelStack {
         // was already handled by the SYN filter.
         lwip_bridge_set_tcp_accept_fn { srcIP, srcPort, dstIP, dstPort, isIPv6, pcb in
             guard let shared = TunnelStack.shared,
-                  let pcb, let dstIP,
+                  let pcb, let srcIP, let dstIP,
                   let defaultConfiguration = shared.configuration else {
                 logger.debug("[TunnelStack] tcp_accept: guard failed")
                 return nil
@@ -134,9 +137,9 @@ extension TunnelStack {
             // True until a routing rule matches — i.e. the default outbound is used.
             var viaDefault = true
 
-            switch shared.resolveFakeIP(dstIPString, dstPort: dstPort, proto: "TCP") {
+            switch shared.resolveFakeIP(address: dstIP, isIPv6: isIPv6 != 0, dstPort: dstPort, proto: "TCP") {
             case .passthrough:
-                if let action = shared.domainRouter.matchIP(dstIPString) {
+                if let action = shared.domainRouter.matchIP(address: dstIP, isIPv6: isIPv6 != 0) {
                     viaDefault = false
                     switch action {
                     case .direct:
@@ -201,7 +204,10 @@ extension TunnelStack {
                 viaDefault: viaDefault,
                 sniffSNI: sniffSNI,
                 hostIsResolvedDomain: hostIsResolvedDomain,
-                lwipQueue: shared.lwipQueue
+                lwipQueue: shared.lwipQueue,
+                proxyQueue: shared.tcpProxyQueue(srcIP: srcIP, srcPort: srcPort,
+                                                 dstIP: dstIP, dstPort: dstPort,
+                                                 isIPv6: isIPv6 != 0)
             )
             return Unmanaged.passRetained(connection).toOpaque()
         }
@@ -219,6 +225,30 @@ extension TunnelStack {
             }
         }
 
+        // Chained segments arrive as payload regions and are copied once, into
+        // the upload buffer, instead of being flattened by the bridge first.
+        lwip_bridge_set_tcp_recv_vec_fn { connection, vecs, nvecs, totLen in
+            guard let connection, let vecs, totLen > 0 else { return }
+            let tcpConnection = Unmanaged<TCPConnection>.fromOpaque(connection).takeUnretainedValue()
+            tcpConnection.handleReceivedData(
+                segments: UnsafeBufferPointer(start: vecs, count: Int(nvecs)),
+                count: Int(totLen)
+            )
+        }
+
+        // PCB freed with reference-mode writes attached (release the +1 taken in
+        // `TCPWriteReferences.attach`); its remaining buffers are retired.
+        lwip_bridge_set_tcp_write_refs_destroyed_fn { owner in
+            guard let owner else { return }
+            Unmanaged<TCPWriteReferences>.fromOpaque(owner).takeRetainedValue().retireAll()
+        }
+
+        // lwIP state changed under a deferred timer: run it now so it picks the
+        // new deadline.
+        lwip_bridge_set_timer_kick_fn {
+            TunnelStack.shared?.armLwipTimer(afterMs: 0)
+        }
+
         lwip_bridge_set_tcp_sent_fn { connection, len in
             guard let connection else { return }
             let tcpConnection = Unmanaged<TCPConnection>.fromOpaque(connection).takeUnretainedValue()
@@ -252,10 +282,14 @@ extension TunnelStack {
     }
 
     /// Resolves a destination IP through the fake-IP pool and domain router.
-    func resolveFakeIP(_ ip: String, dstPort: UInt16, proto: String) -> FakeIPResolution {
-        guard FakeIPPool.isFakeIP(ip) else { return .passthrough }
+    /// `address` is the raw 4/16-byte destination; it is only formatted as a
+    /// string when a log line is actually emitted.
+    func resolveFakeIP(address: UnsafeRawPointer, isIPv6: Bool,
+                       dstPort: UInt16, proto: String) -> FakeIPResolution {
+        guard FakeIPPool.isFakeIP(address: address, isIPv6: isIPv6) else { return .passthrough }
+        var ip: String { TunnelStack.ipAddrToString(address, isIPv6: isIPv6) }
 
-        guard let entry = fakeIPPool.lookup(ip: ip) else {
+        guard let entry = fakeIPPool.lookup(address: address, isIPv6: isIPv6) else {
             logger.warning("[\(proto)] Fake IP not in pool (stale): \(ip):\(dstPort)")
             return .unreachable
         }
@@ -303,4 +337,11 @@ extension TunnelStack {
 
         return .resolved(domain: entry.domain, target: nil, configuration: nil)
     }
+
+    func resolveFakeIP(address: SIMD16<UInt8>, isIPv6: Bool,
+                       dstPort: UInt16, proto: String) -> FakeIPResolution {
+        withUnsafeBytes(of: address) { raw in
+            resolveFakeIP(address: raw.baseAddress!, isIPv6: isIPv6, dstPort: dstPort, proto: proto)
+        }
+    }
 }
@@ -49,19 +49,48 @@ extension TunnelStack {
         dstIP: Data,
         dstPort: UInt16,
         isIPv6: Bool,
-        destination: DNSDestination
+        destination: DNSDestination,
+        on shard: UDPShard
     ) -> Bool {
-        guard let parsed = payload.withUnsafeBytes({ ptr -> (domain: String, qtype: UInt16)? in
+        // The name is parsed lowercased into a stack buffer; A/AAAA queries
+        // reach the fake-IP pool without ever becoming a String.
+        guard let question = payload.withUnsafeBytes({ ptr -> DNSQuestion? in
             guard let base = ptr.bindMemory(to: UInt8.self).baseAddress else { return nil }
-            return DNSPacket.parseQuery(UnsafeBufferPointer(start: base, count: ptr.count))
+            let query = UnsafeBufferPointer(start: base, count: ptr.count)
+            return withUnsafeTemporaryAllocation(of: UInt8.self, capacity: DNSPacket.maxNameLength) { nameBuffer in
+                guard let parsed = DNSPacket.parseQuestion(query, into: nameBuffer) else { return nil }
+                let name = UnsafeBufferPointer(rebasing: nameBuffer[..<parsed.nameLength])
+                if (parsed.qtype == 1 || parsed.qtype == 28) && !name.elementsEqual(Self.ddrName.utf8) {
+                    // Fake-IP even rejected domains — a NODATA here could be negatively
+                    // cached by the OS; rejects are enforced at connection time instead.
+                    return .fakeIP(offset: fakeIPPool.allocate(domain: name), qtype: parsed.qtype)
+                }
+                return .other(domain: String(decoding: name, as: UTF8.self), qtype: parsed.qtype)
+            }
         }) else { return false }
 
-        let domain = parsed.domain.lowercased()
-        let qtype = parsed.qtype
+        let domain: String
+        let qtype: UInt16
+        switch question {
+        case .fakeIP(let offset, let addressType):
+            return sendFakeIPResponse(
+                offset: offset,
+                qtype: addressType,
+                payload: payload,
+                srcIP: srcIP,
+                srcPort: srcPort,
+                dstIP: dstIP,
+                dstPort: dstPort,
+                isIPv6: isIPv6
+            )
+        case .other(let name, let type):
+            domain = name
+            qtype = type
+        }
 
         // Block DDR (RFC 9462) — otherwise the system auto-upgrades to DoH/DoT
         // and bypasses the port-53 interception this tunnel relies on.
-        if domain == "_dns.resolver.arpa" {
+        if domain == Self.ddrName {
             return sendNODATA(
                 payload: payload,
                 srcIP: srcIP,
@@ -91,43 +120,70 @@ extension TunnelStack {
         // Only A (1) and AAAA (28) get fake IPs. Other types:
         // `.anywhereResolver` forwards upstream (NODATA if no config);
         // `.publicResolver` falls through to a proxied UDP flow.
-        guard qtype == 1 || qtype == 28 else {
-            if destination == .anywhereResolver {
-                if forwardToUpstreamResolver(
-                    domain: domain,
-                    payload: payload,
-                    srcIP: srcIP,
-                    srcPort: srcPort,
-                    dstIP: dstIP,
-                    dstPort: dstPort,
-                    isIPv6: isIPv6,
-                    qtype: qtype
-                ) {
-                    return true
-                }
-                return sendNODATA(
-                    payload: payload,
-                    srcIP: srcIP,
-                    srcPort: srcPort,
-                    dstIP: dstIP,
-                    dstPort: dstPort,
-                    isIPv6: isIPv6,
-                    qtype: qtype
+        if destination == .anywhereResolver {
+            if let cached = dnsCache.response(for: payload, name: domain, qtype: qtype) {
+                HotPathMetrics.shared.add(.dnsAnswerCacheHits)
+                writeOutboundUDP(
+                    srcIP: dstIP, srcPort: dstPort,
+                    dstIP: srcIP, dstPort: srcPort,
+                    isIPv6: isIPv6, payload: cached
                 )
+                return true
+            }
+            HotPathMetrics.shared.add(.dnsAnswerCacheMisses)
+            if forwardToUpstreamResolver(
+                domain: domain,
+                payload: payload,
+                srcIP: srcIP,
+                srcPort: srcPort,
+                dstIP: dstIP,
+                dstPort: dstPort,
+                isIPv6: isIPv6,
+                qtype: qtype,
+                on: shard
+            ) {
+                return true
             }
-            return false
+            return sendNODATA(
+                payload: payload,
+                srcIP: srcIP,
+                srcPort: srcPort,
+                dstIP: dstIP,
+                dstPort: dstPort,
+                isIPv6: isIPv6,
+                qtype: qtype
+            )
         }
+        return false
+    }
 
-        // Fake-IP even rejected domains — a NODATA here could be negatively
-        // cached by the OS; rejects are enforced at connection time instead.
-        let offset = fakeIPPool.allocate(domain: domain)
+    /// A parsed query: A/AAAA with the fake-IP offset already allocated, or
+    /// any other question with its (lowercased) name.
+    private enum DNSQuestion {
+        case fakeIP(offset: Int, qtype: UInt16)
+        case other(domain: String, qtype: UInt16)
+    }
+
+    /// DDR discovery name (RFC 9462).
+    private static let ddrName = "_dns.resolver.arpa"
 
+    /// Answers an A/AAAA query with the fake IP at `offset`.
+    private func sendFakeIPResponse(
+        offset: Int,
+        qtype: UInt16,
+        payload: Data,
+        srcIP: Data,
+        srcPort: UInt16,
+        dstIP: Data,
+        dstPort: UInt16,
+        isIPv6: Bool
+    ) -> Bool {
         var fakeIPBytes: [UInt8]?
         if qtype == 1 {
             let ipv4 = FakeIPPool.ipv4Bytes(offset: offset)
             fakeIPBytes = [ipv4.0, ipv4.1, ipv4.2, ipv4.3]
         } else if qtype == 28, udpConfig().advertiseIPv6ToApps {
-            // Snapshot read — DNS runs on udpQueue, not lwipQueue.
+            // Snapshot read — DNS runs on a UDP shard queue, not lwipQueue.
             fakeIPBytes = FakeIPPool.ipv6Bytes(offset: offset)
         }
         // else: AAAA with IPv6 disabled → nil → NODATA response
@@ -151,10 +207,12 @@ extension TunnelStack {
         return true
     }
 
-    /// Forwards a non-A/AAAA query to a real upstream resolver through the
-    /// default proxy and relays the reply (nothing answers behind the tunnel
-    /// peer address). Must be called on ``udpQueue``. Returns `false` when
-    /// there is no active configuration; the caller falls back to NODATA.
+    /// Forwards a non-A/AAAA query to real upstream resolvers through the
+    /// default proxy and relays the first reply (nothing answers behind the
+    /// tunnel peer address), caching it in ``dnsCache``. The query is raced
+    /// across the best-ranked upstreams (``DNSUpstreamRace``). Must be called
+    /// on `shard`'s queue. Returns `false` when there is no active
+    /// configuration; the caller falls back to NODATA.
     private func forwardToUpstreamResolver(
         domain: String,
         payload: Data,
@@ -163,14 +221,11 @@ extension TunnelStack {
         dstIP: Data,
         dstPort: UInt16,
         isIPv6: Bool,
-        qtype: UInt16
+        qtype: UInt16,
+        on shard: UDPShard
     ) -> Bool {
         guard let configuration = udpConfig().configuration else { return false }
 
-        // Forward over IPv4 regardless of query family — proxy egress always
-        // reaches it; the reply family follows the flow's `isIPv6`.
-        let upstream = TunnelConstants.fallbackDNSServers(includeIPv6: false).first ?? "1.1.1.1"
-
         let srcHost = TunnelStack.ipAddrToString(srcIP, isIPv6: isIPv6)
         let srcIPData = srcIP
         let dstIPData = dstIP
@@ -179,28 +234,46 @@ extension TunnelStack {
         // intercepted destinations re-enter here, never the fast path.
         let flowKey = UDPFlowKey(srcIP: UDPPacket.loadIP(srcIP), srcPort: srcPort,
                                  dstIP: UDPPacket.loadIP(dstIP), dstPort: dstPort, isIPv6: isIPv6)
-        if let existing = udpFlows[flowKey] {
+        if let existing = shard.flows[flowKey] {
             existing.handleReceivedData(payload, payloadLength: payload.count)
             return true
         }
 
-        let flow = UDPFlow(
-            flowKey: flowKey,
-            srcHost: srcHost,
-            srcPort: srcPort,
-            dstHost: upstream,        // outbound → real upstream resolver
-            dstPort: dstPort,
-            srcIPData: srcIPData,
-            dstIPData: dstIPData,     // reply source → the Anywhere resolver address
-            isIPv6: isIPv6,
-            configuration: configuration,
-            routeTarget: defaultRouteTarget,   // proxied via the default outbound
-            flowQueue: udpQueue
-        )
-        evictUDPFlowsToAdmit()
-        udpFlows[flowKey] = flow
-        logger.debug("[DNS] Forwarding qtype \(qtype) for \(domain) → \(upstream):\(dstPort) via \(configuration.name)")
-        flow.handleReceivedData(payload, payloadLength: payload.count)
+        // Forward over IPv4 regardless of query family — proxy egress always
+        // reaches it; the reply family follows the flow's `isIPv6`.
+        let plan = dnsUpstreams.plan(fanout: TunnelConstants.dnsRaceFanout)
+        let race = DNSUpstreamRace(query: payload, selector: dnsUpstreams) { [weak self] reply in
+            self?.dnsCache.store(response: reply)
+        }
+
+        for (index, upstream) in plan.servers.enumerated() {
+            let launch = { [weak self, race] in
+                guard let self, !race.isFinished else { return }
+                let flow = UDPFlow(
+                    flowKey: flowKey,
+                    srcHost: srcHost,
+                    srcPort: srcPort,
+                    dstHost: upstream,        // outbound → real upstream resolver
+                    dstPort: dstPort,
+                    srcIPData: srcIPData,
+                    dstIPData: dstIPData,     // reply source → the Anywhere resolver address
+                    isIPv6: isIPv6,
+                    configuration: configuration,
+                    routeTarget: self.defaultRouteTarget,   // proxied via the default outbound
+                    shard: shard
+                )
+                if index == 0 { shard.admit(flow) }
+                race.launch(flow, server: upstream, payload: payload)
+            }
+            if index == 0 {
+                launch()
+            } else {
+                shard.queue.asyncAfter(deadline: .now() + plan.stagger * Double(index), execute: launch)
+            }
+        }
+        shard.queue.asyncAfter(deadline: .now() + TunnelConstants.dnsRaceTimeout) { race.expire() }
+
+        logger.debug("[DNS] Forwarding qtype \(qtype) for \(domain) → \(plan.servers.joined(separator: ", ")):\(dstPort) via \(configuration.name)")
         return true
     }
 
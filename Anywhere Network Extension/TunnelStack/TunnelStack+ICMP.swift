@@ -15,7 +15,7 @@ extension TunnelStack {
     // QUIC/UDP clients abandon it and re-resolve DNS instead of retrying forever.
 
     /// `srcIP`/`dstIP` are the original datagram's raw source/destination bytes;
-    /// the builders swap them so the response appears to come from `dstIP`.
+    /// the C builder swaps them so the response appears to come from `dstIP`.
     func sendICMPPortUnreachable(
         srcIP: Data,
         srcPort: UInt16,
@@ -24,190 +24,19 @@ extension TunnelStack {
         isIPv6: Bool,
         udpPayloadLength: Int
     ) {
-        let packet: Data = srcIP.withUnsafeBytes { srcRaw in
-            dstIP.withUnsafeBytes { dstRaw in
-                guard let source = srcRaw.baseAddress, let destination = dstRaw.baseAddress else {
-                    return Data()
-                }
-                if isIPv6 {
-                    return buildICMPv6PortUnreachable(
-                        srcIP: source, srcPort: srcPort, dstIP: destination, dstPort: dstPort,
-                        udpPayloadLength: udpPayloadLength
-                    )
-                } else {
-                    return buildICMPv4PortUnreachable(
-                        srcIP: source, srcPort: srcPort, dstIP: destination, dstPort: dstPort,
-                        udpPayloadLength: udpPayloadLength
-                    )
+        let addressLength = isIPv6 ? 16 : 4
+        guard srcIP.count == addressLength, dstIP.count == addressLength else { return }
+        var packet = Data(count: Int(isIPv6 ? ICMP_PORT_UNREACHABLE_LEN_V6 : ICMP_PORT_UNREACHABLE_LEN_V4))
+        let length = packet.withUnsafeMutableBytes { out in
+            srcIP.withUnsafeBytes { source in
+                dstIP.withUnsafeBytes { destination in
+                    icmp_port_unreachable_build(out.bindMemory(to: UInt8.self).baseAddress, isIPv6 ? 1 : 0,
+                                                source.baseAddress, srcPort, destination.baseAddress, dstPort,
+                                                Int32(udpPayloadLength))
                 }
             }
         }
-        guard !packet.isEmpty else { return }
+        guard length > 0 else { return }
         enqueueOutbound(packet, isIPv6: isIPv6)
     }
-
-    /// Builds an IPv4 ICMP Destination Unreachable (Type 3, Code 3) packet.
-    /// Contains a reconstructed original IPv4+UDP header per RFC 792.
-    private func buildICMPv4PortUnreachable(
-        srcIP: UnsafeRawPointer,
-        srcPort: UInt16,
-        dstIP: UnsafeRawPointer,
-        dstPort: UInt16,
-        udpPayloadLength: Int
-    ) -> Data {
-        // Outer IPv4 (20) + ICMP header (8) + inner IPv4 (20) + UDP header (8) = 56
-        let packetLen = 56
-        var packet = Data(count: packetLen)
-        packet.withUnsafeMutableBytes { raw in
-            let packetBytes = raw.bindMemory(to: UInt8.self).baseAddress!
-
-            // --- Outer IPv4 header (src=fake IP, dst=sender) ---
-            packetBytes[0] = 0x45                                     // Version 4, IHL 5
-            packetBytes[1] = 0x00                                     // TOS
-            packetBytes[2] = UInt8(packetLen >> 8)                    // Total length
-            packetBytes[3] = UInt8(packetLen & 0xFF)
-            packetBytes[4] = 0; packetBytes[5] = 0                              // Identification
-            packetBytes[6] = 0; packetBytes[7] = 0                              // Flags + Fragment offset
-            packetBytes[8] = 64                                       // TTL
-            packetBytes[9] = 1                                        // Protocol: ICMP
-            packetBytes[10] = 0; packetBytes[11] = 0                            // Checksum (below)
-            memcpy(packetBytes + 12, dstIP, 4)                        // Src = fake IP
-            memcpy(packetBytes + 16, srcIP, 4)                        // Dst = sender
-
-            // IPv4 header checksum
-            var sum: UInt32 = 0
-            for i in stride(from: 0, to: 20, by: 2) {
-                sum += UInt32(packetBytes[i]) << 8 | UInt32(packetBytes[i + 1])
-            }
-            while sum > 0xFFFF { sum = (sum & 0xFFFF) + (sum >> 16) }
-            let ipCksum = ~UInt16(sum)
-            packetBytes[10] = UInt8(ipCksum >> 8)
-            packetBytes[11] = UInt8(ipCksum & 0xFF)
-
-            // --- ICMP header (Type 3 = Dest Unreachable, Code 3 = Port Unreachable) ---
-            packetBytes[20] = 3
-            packetBytes[21] = 3
-            packetBytes[22] = 0
-            packetBytes[23] = 0
-            packetBytes[24] = 0
-            packetBytes[25] = 0
-            packetBytes[26] = 0
-            packetBytes[27] = 0
-
-            // --- Reconstructed original IPv4 header ---
-            let udpTotalLen = 8 + udpPayloadLength
-            let innerTotalLen = 20 + udpTotalLen
-            packetBytes[28] = 0x45
-            packetBytes[29] = 0x00
-            packetBytes[30] = UInt8((innerTotalLen >> 8) & 0xFF)
-            packetBytes[31] = UInt8(innerTotalLen & 0xFF)
-            packetBytes[32] = 0
-            packetBytes[33] = 0
-            packetBytes[34] = 0
-            packetBytes[35] = 0
-            packetBytes[36] = 64
-            packetBytes[37] = 17
-            packetBytes[38] = 0
-            packetBytes[39] = 0
-            memcpy(packetBytes + 40, srcIP, 4)
-            memcpy(packetBytes + 44, dstIP, 4)
-
-            // --- First 8 bytes of original UDP ---
-            packetBytes[48] = UInt8(srcPort >> 8)
-            packetBytes[49] = UInt8(srcPort & 0xFF)
-            packetBytes[50] = UInt8(dstPort >> 8)
-            packetBytes[51] = UInt8(dstPort & 0xFF)
-            packetBytes[52] = UInt8((udpTotalLen >> 8) & 0xFF)
-            packetBytes[53] = UInt8(udpTotalLen & 0xFF)
-            packetBytes[54] = 0
-            packetBytes[55] = 0
-
-            // ICMP checksum (over ICMP header + data, offset 20..55)
-            sum = 0
-            for i in stride(from: 20, to: packetLen, by: 2) {
-                sum += UInt32(packetBytes[i]) << 8 | UInt32(packetBytes[i + 1])
-            }
-            while sum > 0xFFFF { sum = (sum & 0xFFFF) + (sum >> 16) }
-            let icmpCksum = ~UInt16(sum)
-            packetBytes[22] = UInt8(icmpCksum >> 8)
-            packetBytes[23] = UInt8(icmpCksum & 0xFF)
-        }
-        return packet
-    }
-
-    /// Builds an IPv6 ICMPv6 Destination Unreachable (Type 1, Code 4) packet.
-    /// Contains a reconstructed original IPv6+UDP header per RFC 4443.
-    private func buildICMPv6PortUnreachable(
-        srcIP: UnsafeRawPointer,
-        srcPort: UInt16,
-        dstIP: UnsafeRawPointer,
-        dstPort: UInt16,
-        udpPayloadLength: Int
-    ) -> Data {
-        // Outer IPv6 (40) + ICMPv6 header (8) + inner IPv6 (40) + UDP header (8) = 96
-        let icmpLen = 56  // 8 + 40 + 8
-        let packetLen = 40 + icmpLen
-        var packet = Data(count: packetLen)
-        packet.withUnsafeMutableBytes { raw in
-            let p = raw.bindMemory(to: UInt8.self).baseAddress!
-
-            // --- Outer IPv6 header (src=fake IP, dst=sender) ---
-            p[0] = 0x60; p[1] = 0; p[2] = 0; p[3] = 0
-            p[4] = UInt8(icmpLen >> 8)
-            p[5] = UInt8(icmpLen & 0xFF)
-            p[6] = 58
-            p[7] = 64
-            memcpy(p + 8, dstIP, 16)
-            memcpy(p + 24, srcIP, 16)
-
-            // --- ICMPv6 header (Type 1 = Dest Unreachable, Code 4 = Port Unreachable) ---
-            p[40] = 1
-            p[41] = 4
-            p[42] = 0
-            p[43] = 0
-            p[44] = 0
-            p[45] = 0
-            p[46] = 0
-            p[47] = 0
-
-            // --- Reconstructed original IPv6 header ---
-            let udpTotalLen = 8 + udpPayloadLength
-            p[48] = 0x60; p[49] = 0; p[50] = 0; p[51] = 0
-            p[52] = UInt8(udpTotalLen >> 8)
-            p[53] = UInt8(udpTotalLen & 0xFF)
-            p[54] = 17
-            p[55] = 64
-            memcpy(p + 56, srcIP, 16)
-            memcpy(p + 72, dstIP, 16)
-
-            // --- First 8 bytes of original UDP ---
-            p[88] = UInt8(srcPort >> 8)
-            p[89] = UInt8(srcPort & 0xFF)
-            p[90] = UInt8(dstPort >> 8)
-            p[91] = UInt8(dstPort & 0xFF)
-            p[92] = UInt8((udpTotalLen >> 8) & 0xFF)
-            p[93] = UInt8(udpTotalLen & 0xFF)
-            p[94] = 0
-            p[95] = 0
-
-            // ICMPv6 checksum (includes pseudo-header per RFC 4443 §2.3)
-            var sum: UInt32 = 0
-            for i in stride(from: 8, to: 24, by: 2) {
-                sum += UInt32(p[i]) << 8 | UInt32(p[i + 1])
-            }
-            for i in stride(from: 24, to: 40, by: 2) {
-                sum += UInt32(p[i]) << 8 | UInt32(p[i + 1])
-            }
-            sum += UInt32(icmpLen)
-            sum += 58
-            for i in stride(from: 40, to: packetLen, by: 2) {
-                sum += UInt32(p[i]) << 8 | UInt32(p[i + 1])
-            }
-            while sum > 0xFFFF { sum = (sum & 0xFFFF) + (sum >> 16) }
-            let cksum = ~UInt16(sum)
-            p[42] = UInt8(cksum >> 8)
-            p[43] = UInt8(cksum & 0xFF)
-        }
-        return packet
-    }
 }
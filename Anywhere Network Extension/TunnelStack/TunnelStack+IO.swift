@@ -15,73 +15,71 @@ extension TunnelStack {
     // MARK: - Output Batching
     //
     // Two producers append under ``outputBufferLock`` (lwIP callbacks on
-    // ``lwipQueue``, Swift UDP/ICMP builders on ``udpQueue``); the appender
+    // ``lwipQueue``, Swift UDP/ICMP builders on the UDP shard queues); the appender
     // that finds no drain in flight kicks one ``drainOutputLoop`` on
-    // ``outputQueue``. Per-packet pbuf/heap releases still fire on ``lwipQueue``.
+    // ``outputQueue``. Each written window's pbuf/heap buffers are freed on
+    // ``lwipQueue`` with one `lwip_bridge_release_batch` call.
 
-    /// Drains the output buffer with back-to-back writePackets calls, each
+    /// Drains ``outputRing`` with back-to-back writePackets calls, each
     /// capped at tunnelMaxPacketsPerWrite (utun's empirical per-call ceiling —
-    /// exceeding it trips ENOSPC). ``outputDrainInFlight`` flips back false
-    /// under the lock, atomic with the empty check, so a concurrent appender
-    /// can't see "drain in flight" after the loop has decided to exit.
+    /// exceeding it trips ENOSPC). The packet/protocol arrays are reused across
+    /// windows, so a long backlog costs one window copy per call and no
+    /// shifting. ``outputDrainInFlight`` flips back false under the lock,
+    /// atomic with the empty check, so a concurrent appender can't see "drain
+    /// in flight" after the loop has decided to exit.
     func drainOutputLoop() {
         let cap = TunnelConstants.tunnelMaxPacketsPerWrite
+        var packets: [Data] = []
+        var protocols: [NSNumber] = []
+        packets.reserveCapacity(cap)
+        protocols.reserveCapacity(cap)
         while true {
-            var packets: [Data] = []
-            var protocols: [NSNumber] = []
-            var releases: [PendingRelease] = []
+            packets.removeAll(keepingCapacity: true)
+            protocols.removeAll(keepingCapacity: true)
+            // Handed to lwipQueue below, so each window gets its own; stays
+            // unallocated for a window of Swift-built packets.
+            var releaseCtxs: [UnsafeMutableRawPointer?] = []
 
-            var queueDepth = 0
             outputBufferLock.withLock {
-                let pending = outputPackets.count
-                queueDepth = pending
-                if pending == 0 {
+                if outputRing.isEmpty {
                     outputDrainInFlight = false
                     return
                 }
-                if pending <= cap {
-                    packets = outputPackets
-                    protocols = outputProtocols
-                    releases = pendingReleases
-                    outputPackets = []
-                    outputProtocols = []
-                    pendingReleases = []
-                    outputPackets.reserveCapacity(cap)
-                    outputProtocols.reserveCapacity(cap)
-                    pendingReleases.reserveCapacity(cap)
-                } else {
-                    packets = Array(outputPackets.prefix(cap))
-                    protocols = Array(outputProtocols.prefix(cap))
-                    releases = Array(pendingReleases.prefix(cap))
-                    outputPackets.removeFirst(cap)
-                    outputProtocols.removeFirst(cap)
-                    pendingReleases.removeFirst(cap)
-                }
+                outputRing.popWindow(limit: cap, packets: &packets, protocols: &protocols, releaseCtxs: &releaseCtxs)
             }
-            
+
             if packets.isEmpty { return }
+            let signpost = DataPathSignposts.begin("writePackets")
             packetFlow?.writePackets(packets, withProtocols: protocols)
+            DataPathSignposts.end("writePackets", signpost)
+            HotPathMetrics.shared.add(.tunWriteBatches)
+            HotPathMetrics.shared.add(.tunWritePackets, packets.count)
 
             // writePackets copies into the kernel synchronously, so the buffers
-            // are already unreferenced.
-            if !releases.isEmpty {
+            // are already unreferenced. One hop and one C call per window.
+            if !releaseCtxs.isEmpty {
                 lwipQueue.async {
-                    for r in releases {
-                        r.fn(r.ctx)
-                    }
+                    self.releaseOutputBuffers(releaseCtxs)
                 }
             }
         }
     }
 
-    /// Appends a Swift-built IP packet to the output buffer and kicks the drain
-    /// if idle; ``noopRelease`` keeps ``pendingReleases`` index-aligned.
+    /// Appends a Swift-built IP packet to the output ring and kicks the drain
+    /// if idle.
     func enqueueOutbound(_ packet: Data, isIPv6: Bool) {
+        enqueueLwipOutput(packet, isIPv6: isIPv6, releaseCtx: nil)
+    }
+
+    /// Appends an IP packet whose bytes are owned by `releaseCtx` (an lwIP
+    /// output buffer, or nil for a Swift-built packet) and kicks the drain if
+    /// idle. Called with a non-nil ctx only on ``lwipQueue``.
+    func enqueueLwipOutput(_ packet: Data, isIPv6: Bool, releaseCtx: UnsafeMutableRawPointer?) {
         let proto: NSNumber = isIPv6 ? Self.ipv6Proto : Self.ipv4Proto
+        // Non-nil ctxs only come from lwIP's output callback, i.e. lwipQueue.
+        if releaseCtx != nil { outputBuffersQueued += 1 }
         let needsKick: Bool = outputBufferLock.withLock {
-            outputPackets.append(packet)
-            outputProtocols.append(proto)
-            pendingReleases.append(Self.noopRelease)
+            outputRing.push(packet, proto: proto, releaseCtx: releaseCtx)
             if outputDrainInFlight { return false }
             outputDrainInFlight = true
             return true
@@ -94,53 +92,48 @@ extension TunnelStack {
     // MARK: - Packet Reading
 
     /// Continuously reads IP packets from the tunnel, splitting each batch:
-    /// UDP datagrams to ``udpQueue``, TCP/ICMP into lwIP on ``lwipQueue``.
-    /// Backpressure: the next read is issued only after *both* sub-batches
-    /// finish, so at most one batch is ever in flight (utun paces us).
+    /// UDP datagrams to the ``udpShards`` their source hashes to, TCP/ICMP
+    /// into lwIP on ``lwipQueue``. Backpressure: the next read is issued only
+    /// after *every* sub-batch finishes, so at most one batch is ever in
+    /// flight (utun paces us).
     func startReadingPackets() {
         packetFlow?.readPackets { [weak self] packets, _ in
             guard let self, self.running else { return }
+            HotPathMetrics.shared.add(.tunReadBatches)
+            HotPathMetrics.shared.add(.tunReadPackets, packets.count)
 
-            // Partition on the read-callback thread — a cheap header peek per
+            // Partition on the read-callback thread — one header peek per
             // packet. Reflected packets bounce straight back into the TUN here,
             // never reaching lwIP, UDP, routing, or the proxy.
-            let reflector = self.reflector()
-            var udpBatch: [Data] = []
-            var lwipBatch: [Data] = []
-            for packet in packets {
-                if reflector.isActive, let reflected = reflector.reflect(packet) {
-                    self.enqueueOutbound(reflected.data, isIPv6: reflected.isIPv6)
-                    continue
-                }
-                if let info = UDPPacket.ipProtocol(of: packet), info.proto == UDPPacket.ipProtocolUDP {
-                    udpBatch.append(packet)
-                } else {
-                    lwipBatch.append(packet)
-                }
+            let batch = self.partition(packets)
+            let lwipBatch = batch.lwip
+            let udpBatch = batch.udp
+
+            var legs: [(queue: DispatchQueue, work: () -> Void)] = []
+            if !lwipBatch.isEmpty {
+                legs.append((self.lwipQueue, { self.feedLwip(packets, lwipBatch) }))
+            }
+            for shard in self.udpShards where batch.udpShardMask & (1 << shard.index) != 0 {
+                legs.append((shard.queue, { self.feedUDP(packets, udpBatch, to: shard) }))
             }
 
-            switch (lwipBatch.isEmpty, udpBatch.isEmpty) {
-            case (true, true):
+            switch legs.count {
+            case 0:
                 // Empty or all-reflected batch — re-arm so the loop can't stall.
                 self.startReadingPackets()
-            case (false, true):
-                self.lwipQueue.async {
-                    self.feedLwip(lwipBatch)
+            case 1:
+                let leg = legs[0]
+                leg.queue.async {
+                    leg.work()
                     self.startReadingPackets()
                 }
-            case (true, false):
-                self.udpQueue.async {
-                    self.feedUDP(udpBatch)
-                    self.startReadingPackets()
-                }
-            case (false, false):
+            default:
                 let group = DispatchGroup()
-                group.enter()
-                self.lwipQueue.async { self.feedLwip(lwipBatch); group.leave() }
-                group.enter()
-                self.udpQueue.async { self.feedUDP(udpBatch); group.leave() }
+                for leg in legs {
+                    leg.queue.async(group: group) { leg.work() }
+                }
                 // Re-arm off the data-plane queues so the next read waits only
-                // on both finishing, not on either queue's depth.
+                // on every leg finishing, not on any one queue's depth.
                 group.notify(queue: DispatchQueue.global(qos: .userInitiated)) { [weak self] in
                     self?.startReadingPackets()
                 }
@@ -148,93 +141,152 @@ extension TunnelStack {
         }
     }
 
-    /// Feeds a TCP/ICMP sub-batch into lwIP. Must run on ``lwipQueue``. The
-    /// batch bracket coalesces per-segment ACKs and walks every active PCB on `_end`.
-    private func feedLwip(_ packets: [Data]) {
+    /// Splits a read batch with one header peek per packet. Reflected packets
+    /// are answered on the spot; the rest become index lists into `packets` —
+    /// lwIP (TCP/ICMP) indices counting up from the front of one buffer, UDP
+    /// entries counting down from its back — so no sub-batch copies or
+    /// retains a `Data`. A UDP entry is its packet index tagged with its shard
+    /// in the top byte (``udpShardTagShift``); the UDP slice is in reverse
+    /// arrival order, and `udpShardMask` has a bit set per shard it touches.
+    private func partition(_ packets: [Data]) -> (lwip: ArraySlice<Int32>, udp: ArraySlice<Int32>, udpShardMask: UInt32) {
+        let reflector = self.reflector()
+        let reflecting = reflector.isActive
+        let shardCount = udpShards.count
+        var indices = [Int32](repeating: 0, count: packets.count)
+        var lwipEnd = 0
+        var udpStart = packets.count
+        var udpShardMask: UInt32 = 0
+        for (index, packet) in packets.enumerated() {
+            // 0 = lwIP, 1 = reflect IPv4, 2 = reflect IPv6, 3 + n = UDP shard n.
+            let route: Int = packet.withUnsafeBytes { raw in
+                guard let p = raw.bindMemory(to: UInt8.self).baseAddress else { return 0 }
+                let proto: UInt8
+                let isIPv6: Bool
+                let transportOffset: Int
+                switch raw.count >= 1 ? (p[0] >> 4) & 0x0F : 0 {
+                case 4 where raw.count >= 20: proto = p[9]; isIPv6 = false; transportOffset = Int(p[0] & 0x0F) * 4
+                case 6 where raw.count >= 40: proto = p[6]; isIPv6 = true; transportOffset = 40
+                default: return 0
+                }
+                if reflecting, reflector.matchesDestination(of: p, isIPv6: isIPv6) {
+                    return isIPv6 ? 2 : 1
+                }
+                guard proto == UDPPacket.ipProtocolUDP else { return 0 }
+                // Too short for a source port: shard 0, where parse drops it.
+                guard raw.count >= transportOffset + 2 else { return 3 }
+                return 3 + UDPShard.index(forSourceOf: p, transportOffset: transportOffset,
+                                          isIPv6: isIPv6, shardCount: shardCount)
+            }
+            switch route {
+            case 0:
+                indices[lwipEnd] = Int32(index)
+                lwipEnd += 1
+            case 1, 2:
+                let isIPv6 = route == 2
+                enqueueOutbound(Reflector.swapped(packet, isIPv6: isIPv6), isIPv6: isIPv6)
+            default:
+                let shard = route - 3
+                udpStart -= 1
+                indices[udpStart] = Int32(index | shard << Self.udpShardTagShift)
+                udpShardMask |= 1 << shard
+            }
+        }
+        return (indices[..<lwipEnd], indices[udpStart...], udpShardMask)
+    }
+
+    /// Bit offset of the shard tag in a ``partition(_:)`` UDP entry; read
+    /// batches are far below 2^24 packets.
+    private static let udpShardTagShift = 24
+
+    /// Feeds the TCP/ICMP packets at `indices` into lwIP. Must run on
+    /// ``lwipQueue``. The batch bracket coalesces per-segment ACKs and flushes
+    /// the PCBs they dirtied on `_end`.
+    private func feedLwip(_ packets: [Data], _ indices: ArraySlice<Int32>) {
+        let signpost = DataPathSignposts.begin("feedLwip")
+        defer { DataPathSignposts.end("feedLwip", signpost) }
         lwip_bridge_input_batch_begin()
-        for packet in packets {
-            packet.withUnsafeBytes { buffer in
+        for index in indices {
+            packets[Int(index)].withUnsafeBytes { buffer in
                 guard let baseAddress = buffer.baseAddress else { return }
                 lwip_bridge_input(baseAddress, Int32(buffer.count))
             }
         }
         lwip_bridge_input_batch_end()
-        // A fresh segment may have queued a timeout while the tick was suspended — re-arm.
-        resumeLwipTickIfNeeded()
     }
 
-    /// Parses and dispatches a UDP sub-batch. Must run on ``udpQueue``.
-    private func feedUDP(_ packets: [Data]) {
-        for packet in packets {
-            if let datagram = UDPPacket.parse(packet) {
-                handleInboundUDP(datagram)
+    /// Parses and dispatches `shard`'s UDP packets among `entries` (reverse
+    /// arrival order, as ``partition(_:)`` fills them). Must run on
+    /// `shard.queue`.
+    private func feedUDP(_ packets: [Data], _ entries: ArraySlice<Int32>, to shard: UDPShard) {
+        let indexMask = Int32(1 << Self.udpShardTagShift) - 1
+        for entry in entries.reversed() where Int(entry >> Int32(Self.udpShardTagShift)) == shard.index {
+            if let datagram = UDPPacket.parse(packets[Int(entry & indexMask)]) {
+                handleInboundUDP(datagram, on: shard)
             }
         }
     }
 
     // MARK: - Timers
 
-    /// Starts the lwIP timeout timer (100ms, matching `TCP_TMR_INTERVAL`).
-    /// The tick suspends itself whenever lwIP's timeout list is empty so an
-    /// idle tunnel stops waking the CPU 10x/sec; ``feedLwip`` re-arms it.
+    /// Starts the lwIP timeout timer. It is one-shot, re-armed after each run
+    /// for the next deadline lwIP actually has (a retransmit, persist probe or
+    /// TIME_WAIT expiry) rather than every `TCP_TMR_INTERVAL`, so idle
+    /// connections stop waking the CPU 10x/sec; the bridge's timer kick pulls
+    /// it forward when input or a write changes that deadline.
     func startTimeoutTimer() {
         let timer = DispatchSource.makeTimerSource(queue: lwipQueue)
-        timer.schedule(
-            deadline: .now() + .milliseconds(TunnelConstants.lwipTimeoutIntervalMs),
-            repeating: .milliseconds(TunnelConstants.lwipTimeoutIntervalMs),
-            leeway: .milliseconds(TunnelConstants.lwipTimeoutLeewayMs)
-        )
         timer.setEventHandler { [weak self] in
             guard let self, self.running else { return }
-            if lwip_bridge_check_timeouts() != 0 {
-                self.suspendLwipTickIfNeeded()
-            }
+            self.armLwipTimer(afterMs: lwip_bridge_check_timeouts())
         }
-        timer.resume()
-        lwipTickSuspended = false
         timeoutTimer = timer
+        armLwipTimer(afterMs: UInt32(TunnelConstants.lwipTimeoutIntervalMs))
+        timer.resume()
     }
 
-    /// Suspends the drained lwIP tick; idempotent. Must run on ``lwipQueue``.
-    private func suspendLwipTickIfNeeded() {
-        guard let timeoutTimer, !lwipTickSuspended else { return }
-        lwipTickSuspended = true
-        timeoutTimer.suspend()
+    /// Re-arms the one-shot lwIP timer; `LWIP_BRIDGE_TIMER_NONE` parks it until
+    /// the next kick. Must run on ``lwipQueue``.
+    func armLwipTimer(afterMs delay: UInt32) {
+        guard let timeoutTimer else { return }
+        let leeway = DispatchTimeInterval.milliseconds(TunnelConstants.lwipTimeoutLeewayMs)
+        if delay == LWIP_BRIDGE_TIMER_NONE {
+            timeoutTimer.schedule(deadline: .distantFuture, leeway: leeway)
+        } else {
+            timeoutTimer.schedule(deadline: .now() + .milliseconds(Int(delay)), leeway: leeway)
+        }
     }
 
-    /// Re-arms the lwIP tick if it idled. Must run on ``lwipQueue``.
-    func resumeLwipTickIfNeeded() {
-        guard let timeoutTimer, lwipTickSuspended else { return }
-        lwipTickSuspended = false
-        timeoutTimer.resume()
+    /// Registers one 1s cleanup task per shard reaping UDP flows past their
+    /// idle deadline, each on its shard's queue, which owns those flows; owned
+    /// by ``scheduler`` so they catch up promptly on device wake instead of
+    /// drifting with the frozen clock.
+    func scheduleUDPCleanup() {
+        for shard in udpShards {
+            scheduler.schedule(
+                label: "udp-cleanup-\(shard.index)",
+                on: shard.queue,
+                every: TimeInterval(TunnelConstants.udpCleanupIntervalSec),
+                leeway: TimeInterval(TunnelConstants.udpCleanupLeewayMs) / 1000
+            ) { [weak self] in
+                guard let self, self.running else { return }
+                shard.reapIdleFlows(now: MonotonicClock.now)
+            }
+        }
     }
 
-    /// Registers the 1s cleanup task reaping UDP flows past their idle deadline.
-    /// Runs on ``udpQueue``, which owns ``udpFlows``; owned by ``scheduler`` so it
-    /// catches up promptly on device wake instead of drifting with the frozen clock.
-    func scheduleUDPCleanup() {
-        scheduler.schedule(
-            label: "udp-cleanup",
-            on: udpQueue,
-            every: TimeInterval(TunnelConstants.udpCleanupIntervalSec),
-            leeway: TimeInterval(TunnelConstants.udpCleanupLeewayMs) / 1000
+    /// Ticks ``tcpDeadlines`` on ``lwipQueue``. The task is paused whenever no
+    /// connection has a deadline armed, so an idle tunnel takes no wakeups for it.
+    func scheduleTCPDeadlines() {
+        let handle = scheduler.schedule(
+            label: "tcp-deadlines",
+            on: lwipQueue,
+            every: TCPDeadlineWheel.tickInterval,
+            leeway: TCPDeadlineWheel.tickInterval / 5
         ) { [weak self] in
             guard let self, self.running else { return }
-            let now = MonotonicClock.now
-            var keysToRemove: [UDPFlowKey] = []
-            for (key, flow) in self.udpFlows {
-                if now > flow.idleDeadline {
-                    flow.close()
-                    keysToRemove.append(key)
-                }
-            }
-            for key in keysToRemove {
-                self.udpFlows.removeValue(forKey: key)
-            }
-            // Re-arm the flow-cap warning so a later storm logs its own rising edge.
-            if self.udpFlowCapWarned && self.udpFlows.count < TunnelConstants.udpMaxFlows {
-                self.udpFlowCapWarned = false
-            }
+            self.tcpDeadlines.advance(to: MonotonicClock.now)
         }
+        tcpDeadlines.onOccupancyChange = { active in handle.setPaused(!active) }
+        handle.setPaused(tcpDeadlines.isEmpty)
     }
 }
@@ -28,15 +28,25 @@ extension TunnelStack {
         }
         self.packetFlow = packetFlow
         self.configuration = configuration
+        nodeHealth.onSelect = { [weak self] in self?.switchDefaultOutbound($0) }
 
         lwipQueue.async { [self] in
             running = true
 
-            configureRuntime(for: configuration)
+            // Before the first packet, so cached fake IPs keep their domains.
+            StartupSignposts.measure("restoreSnapshots") {
+                fakeIPPool.restoreSnapshot()
+                TLSSessionTicketCache.shared.restoreSnapshot()
+                VLESSEncryption0RTTCache.shared.restoreSnapshot()
+                QUICPathMTU.shared.restoreSnapshot()
+            }
+            StartupSignposts.measure("configureRuntime") { configureRuntime(for: configuration) }
             registerCallbacks()
-            lwip_bridge_init()
+            StartupSignposts.measure("lwipInit") { lwip_bridge_init() }
             startTimeoutTimer()
             scheduleUDPCleanup()
+            scheduleTCPDeadlines()
+            startMemoryPressureMonitor()
             startReadingPackets()
             logger.debug("[TunnelStack] Started, mode=\(proxyMode.rawValue), advertiseIPv6=\(advertiseIPv6ToApps), bypass=\(!bypassCountryCode.isEmpty)")
         }
@@ -47,12 +57,20 @@ extension TunnelStack {
 
     func stop() {
         stopObservingSettings()
+        nodeHealth.stop()
+        nodeHealth.telemetry.removeAll()
         lwipQueue.sync { [self] in
             running = false
             deferredRestart?.cancel()
             deferredRestart = nil
+            stopMemoryPressureMonitor()
             shutdownInternal()
+            fakeIPPool.saveSnapshot()
+            TLSSessionTicketCache.shared.saveSnapshot()
+            VLESSEncryption0RTTCache.shared.saveSnapshot()
+            QUICPathMTU.shared.saveSnapshot()
             fakeIPPool.reset()
+            dnsCache.removeAll()
         }
 
         AnywhereLogger.logSink = nil
@@ -61,11 +79,37 @@ extension TunnelStack {
         TunnelStack.shared = nil
     }
 
-    /// Restarts the stack on the existing packet flow under the new configuration.
+    /// Points the tunnel at the new configuration in place; only flows on the old default
+    /// outbound reconnect.
     func switchConfiguration(_ newConfiguration: ProxyConfiguration) {
         lwipQueue.async { [self] in
-            logger.info("[VPN] Configuration switched; reconnecting active connections")
-            restartStack(configuration: newConfiguration)
+            logger.info("[VPN] Configuration switched; reconnecting flows on the old outbound")
+            // A manual pick overrides auto-selection until the app sets a group again.
+            nodeHealth.stop()
+            reconfigureInPlace(configuration: newConfiguration)
+        }
+    }
+
+    /// Starts or stops auto-selection; the prober's picks arrive through `switchDefaultOutbound`.
+    func setAutoSelectGroup(_ group: AutoSelectGroup?) {
+        lwipQueue.async { [self] in
+            guard running else { return }
+            nodeHealth.update(group, current: configuration)
+        }
+    }
+
+    /// Points new connections at `newConfiguration` without a restart: open flows keep the node
+    /// they dialed, since failing over one node must not drop the traffic a healthy path carries.
+    func switchDefaultOutbound(_ newConfiguration: ProxyConfiguration) {
+        lwipQueue.async { [self] in
+            guard running, configuration?.id != newConfiguration.id else { return }
+            logger.info("[VPN] Auto-select: default outbound is now \(newConfiguration.name)")
+            configuration = newConfiguration
+            if proxyMode != .direct {
+                defaultRouteTarget = .proxy(newConfiguration.id)
+            }
+            publishUDPConfig()
+            prepareDefaultOutbound(newConfiguration)
         }
     }
 
@@ -126,6 +170,55 @@ extension TunnelStack {
         }
     }
 
+    /// Applies a new default outbound and/or proxy mode without touching lwIP: the netif,
+    /// FakeIP pool and compiled rule tiers stay, and only the flows the change reroutes
+    /// close. A flow survives when it already rides the new default, or when the mode held
+    /// and it never rode the old default (a rule-chosen route the change leaves alone).
+    /// Must be called on `lwipQueue`.
+    private func reconfigureInPlace(configuration newConfiguration: ProxyConfiguration) {
+        // A pending restart would later replay its older configuration; fold into it.
+        guard deferredRestart == nil else {
+            restartStack(configuration: newConfiguration)
+            return
+        }
+        let previousMode = proxyMode
+        let previousDefault = defaultRouteTarget
+        let outboundChanged = configuration != newConfiguration
+
+        configuration = newConfiguration
+        reloadProxyModeSettings()
+        defaultRouteTarget = resolveDefaultRouteTarget(for: newConfiguration)
+        let modeChanged = proxyMode != previousMode
+        if modeChanged {
+            if proxyMode == .rule {
+                domainRouter.loadRoutingConfigurationInBackground()
+            } else if previousMode == .rule {
+                domainRouter.reset()
+            }
+        }
+        publishUDPConfig()
+        if outboundChanged {
+            prepareDefaultOutbound(newConfiguration)
+        }
+
+        let newDefault = defaultRouteTarget
+        guard modeChanged || outboundChanged || newDefault != previousDefault else { return }
+        let survives: (RouteTarget) -> Bool = { target in
+            target == newDefault || (!modeChanged && target != previousDefault)
+        }
+        var closedTCP = 0
+        for connection in activeTCPConnectionList() where !survives(connection.boundRouteTarget) {
+            connection.close()
+            closedTCP += 1
+        }
+        for shard in udpShards {
+            shard.queue.async {
+                shard.closeFlows { !survives($0.boundRouteTarget) }
+            }
+        }
+        logger.debug("[TunnelStack] Reconfigured in place, mode=\(proxyMode.rawValue), closed \(closedTCP) TCP connection(s)")
+    }
+
     /// Flushes cached DNS and invalidates all outbound transport state while
     /// leaving the lwIP netif, listeners, and timers running. Must be called
     /// on `lwipQueue`.
@@ -152,47 +245,32 @@ extension TunnelStack {
         MITMScriptHTTP2Pool.shared.reclaim()
     }
 
-    /// Reclaims the udpQueue-owned per-tunnel transports (Vision mux, SS UDP
+    /// Reclaims the shard-owned per-tunnel transports (Vision mux, SS UDP
     /// sessions, per-flow UDP connections). Must be called on `lwipQueue`.
     private func reclaimInstanceTransports(rebuildMultiplexerPool: Bool) {
-        // Build the replacement mux on lwipQueue, which owns `configuration`.
-        let rebuiltMultiplexerPool: VLESSVisionUDPMultiplexerPool?
-        if rebuildMultiplexerPool, let configuration, configuration.outboundProtocol == .vless {
-            rebuiltMultiplexerPool = VLESSVisionUDPMultiplexerPool(configuration: configuration, flowQueue: udpQueue)
-        } else {
-            rebuiltMultiplexerPool = nil
-        }
+        // Build the replacement muxes on lwipQueue, which owns `configuration`.
+        let rebuildConfiguration = rebuildMultiplexerPool && configuration?.outboundProtocol == .vless ? configuration : nil
 
-        udpQueue.sync {
-            udpMultiplexerPool?.closeAll()
-            udpMultiplexerPool = rebuiltMultiplexerPool
-            purgeShadowsocksUDPSessions()
-            for (_, flow) in udpFlows {
-                flow.close()
+        for shard in udpShards {
+            let rebuiltMultiplexerPool = rebuildConfiguration.map {
+                VLESSVisionUDPMultiplexerPool(configuration: $0, flowQueue: shard.queue)
+            }
+            shard.queue.sync {
+                shard.reclaimAll(replacingMultiplexerPool: rebuiltMultiplexerPool)
             }
-            udpFlows.removeAll()
         }
     }
 
     /// Shuts down the lwIP stack and all active flows. Must be called on `lwipQueue`.
     private func shutdownInternal() {
         timeoutTimer?.cancel()
-        if lwipTickSuspended {
-            lwipTickSuspended = false
-            timeoutTimer?.resume()
-        }
         timeoutTimer = nil
         scheduler.cancelAll()
 
         outputBufferLock.withLock {
-            outputPackets.removeAll(keepingCapacity: true)
-            outputProtocols.removeAll(keepingCapacity: true)
-            // The release fns are the only owners (.none deallocator); calling
+            // The release ctxs are the only owners (.none deallocator); freeing
             // them synchronously is safe — we're on `lwipQueue`.
-            for r in pendingReleases {
-                r.fn(r.ctx)
-            }
-            pendingReleases.removeAll(keepingCapacity: true)
+            releaseOutputBuffers(outputRing.removeAll())
             outputDrainInFlight = false
         }
 
@@ -252,6 +330,7 @@ extension TunnelStack {
         lwip_bridge_init()
         startTimeoutTimer()
         scheduleUDPCleanup()
+        scheduleTCPDeadlines()
         logger.debug("[TunnelStack] Restarted, mode=\(proxyMode.rawValue), advertiseIPv6=\(advertiseIPv6ToApps), bypass=\(!bypassCountryCode.isEmpty)")
     }
 
@@ -372,6 +451,14 @@ extension TunnelStack {
                 self.preventDNSLeak = preventDNSLeak
             }
 
+            // VLESS Mux only steers new TCP dials; flows already on a mux
+            // connection keep it until they end, so reload in place.
+            let vlessMuxEnabled = AWCore.getVLESSMuxEnabled()
+            if vlessMuxEnabled != VLESSMuxMultiplexerPool.shared.isEnabled {
+                logger.info("[VPN] VLESS Mux changed: \(!vlessMuxEnabled) -> \(vlessMuxEnabled)")
+                VLESSMuxMultiplexerPool.shared.isEnabled = vlessMuxEnabled
+            }
+
             // Reflection is a pure read-path setting; reload in place, before
             // the change-detection guard below.
             let reflectionEnabled = AWCore.getReflectionEnabled()
@@ -391,14 +478,21 @@ extension TunnelStack {
                 return
             }
             
-            logger.info("[VPN] Settings changed, reconnecting active connections")
-
             // These toggles change tunnel network settings (routes/DNS);
             // re-apply them before restarting the stack.
-            if advertiseIPv6ToAppsChanged || hideVPNIconChanged {
+            if advertiseIPv6ToAppsChanged || hideVPNIconChanged || (proxyModeChanged && AWCore.getKernelBypassEnabled()) {
                 onTunnelSettingsNeedReapply?()
             }
 
+            // A mode change alone is a routing change; the lwIP netif only needs
+            // rebuilding when its address family or the VPN-icon routes change.
+            guard advertiseIPv6ToAppsChanged || hideVPNIconChanged else {
+                logger.info("[VPN] Mode changed to \(effectiveProxyMode.rawValue); reconfiguring in place")
+                reconfigureInPlace(configuration: configuration)
+                return
+            }
+
+            logger.info("[VPN] Settings changed, reconnecting active connections")
             restartStack(configuration: configuration)
         }
     }
@@ -412,6 +506,10 @@ extension TunnelStack {
             guard proxyMode == .rule else { return }
             logger.info("[VPN] Routing changed; reloading rules in place")
             domainRouter.loadRoutingConfiguration()
+            // Kernel-bypass excluded routes are derived from the rules.
+            if AWCore.getKernelBypassEnabled() {
+                onTunnelSettingsNeedReapply?()
+            }
         }
     }
 
@@ -423,7 +521,7 @@ extension TunnelStack {
             logger.info("[VPN] MITM settings changed; reloading matcher")
             loadMITMSetting()
             // `mitmEnabled` gates the UDP/443 MITM decision via the snapshot;
-            // republish so udpQueue sees the new toggle.
+            // republish so the UDP shards see the new toggle.
             publishUDPConfig()
         }
     }
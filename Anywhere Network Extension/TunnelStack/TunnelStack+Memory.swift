@@ -0,0 +1,86 @@
+//
+//  TunnelStack+Memory.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "TunnelStack+Memory")
+
+/// Collects connections out of `lwip_bridge_for_each_tcp`, whose C callback can't capture. lwipQueue only.
+nonisolated(unsafe) private var scannedTCPConnections: [TCPConnection] = []
+
+extension TunnelStack {
+
+    // MARK: - Memory Pressure
+    //
+    // A jetsam kill drops every connection at once, so pressure is answered in tiers that
+    // give up progressively more: a warning trims caches and spare buffer capacity; a
+    // critical event also closes warm transports with no stream on them and, if the TCP
+    // buffers are still past half their budget, aborts the largest stalled downlink backlogs.
+
+    func startMemoryPressureMonitor() {
+        guard memoryPressureSource == nil else { return }
+        let source = DispatchSource.makeMemoryPressureSource(eventMask: [.warning, .critical], queue: lwipQueue)
+        source.setEventHandler { [weak self, weak source] in
+            guard let self, let source, self.running else { return }
+            self.relieveMemoryPressure(critical: source.data.contains(.critical))
+        }
+        memoryPressureSource = source
+        source.resume()
+    }
+
+    func stopMemoryPressureMonitor() {
+        memoryPressureSource?.cancel()
+        memoryPressureSource = nil
+    }
+
+    /// Must be called on `lwipQueue`.
+    private func relieveMemoryPressure(critical: Bool) {
+        logger.warning("[VPN] Memory pressure (\(critical ? "critical" : "warning")): trimming caches")
+        lwip_bridge_trim_caches()
+        udp_packet_buffer_trim()
+        TLSReceiveBufferPool.shared.trim()
+        mitmLeafCache?.trim(keeping: TunnelConstants.memoryPressureMITMLeafKeep)
+        let connections = activeTCPConnectionList()
+        for connection in connections {
+            connection.trimBuffers()
+        }
+        guard critical else { return }
+
+        logger.warning("[VPN] Memory pressure: closing idle multiplexers and pre-dialed sockets")
+        TransportReclaim.reclaimIdle()
+
+        shedStalledBacklogs(connections)
+    }
+
+    /// Aborts stalled connections, largest backlog first, until the TCP buffers are back
+    /// under half their budget; connections still draining are never picked.
+    private func shedStalledBacklogs(_ connections: [TCPConnection]) {
+        let target = tcpBufferGovernor.budget / 2
+        guard tcpBufferGovernor.totalBytes > target else { return }
+        let now = MonotonicClock.now
+        let stalled = connections.compactMap { connection in
+            connection.stalledDownlinkBacklog(
+                now: now, stalledFor: TunnelConstants.memoryPressureStallInterval
+            ).map { (connection, $0) }
+        }
+        for (connection, _) in stalled.sorted(by: { $0.1 > $1.1 }) {
+            guard tcpBufferGovernor.totalBytes > target else { break }
+            connection.shedForMemoryPressure()
+        }
+    }
+
+    /// Must be called on `lwipQueue`.
+    func activeTCPConnectionList() -> [TCPConnection] {
+        lwip_bridge_for_each_tcp { arg in
+            guard let arg else { return }
+            scannedTCPConnections.append(Unmanaged<TCPConnection>.fromOpaque(arg).takeUnretainedValue())
+        }
+        let connections = scannedTCPConnections
+        scannedTCPConnections.removeAll()
+        return connections
+    }
+}
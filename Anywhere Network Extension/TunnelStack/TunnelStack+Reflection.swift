@@ -61,29 +61,24 @@ extension TunnelStack {
             self.ipv6Addresses = v6
         }
 
-        /// Returns a src⇄dst-swapped copy if the destination matches; nil routes
-        /// normally. Ports, payload, and checksums are untouched.
-        func reflect(_ packet: Data) -> (data: Data, isIPv6: Bool)? {
-            // nil = no match; false = IPv4 match; true = IPv6 match.
-            let match: Bool? = packet.withUnsafeBytes { raw -> Bool? in
-                guard let p = raw.bindMemory(to: UInt8.self).baseAddress, raw.count >= 1 else { return nil }
-                switch (p[0] >> 4) & 0x0F {
-                case 4:
-                    guard raw.count >= 20 else { return nil }
-                    let destination = UInt32(p[16]) << 24 | UInt32(p[17]) << 16 | UInt32(p[18]) << 8 | UInt32(p[19])
-                    return ipv4Addresses.contains(destination) ? false : nil
-                case 6:
-                    guard raw.count >= 40 else { return nil }
-                    var destination = SIMD16<UInt8>()
-                    for i in 0..<16 { destination[i] = p[24 + i] }
-                    return ipv6Addresses.contains(destination) ? true : nil
-                default:
-                    return nil
-                }
+        /// Whether the packet at `p` is addressed to a reflected destination.
+        /// The caller has checked the header is complete (20 / 40 bytes).
+        func matchesDestination(of p: UnsafePointer<UInt8>, isIPv6: Bool) -> Bool {
+            if isIPv6 {
+                guard !ipv6Addresses.isEmpty else { return false }
+                var destination = SIMD16<UInt8>()
+                for i in 0..<16 { destination[i] = p[24 + i] }
+                return ipv6Addresses.contains(destination)
             }
-            guard let isIPv6 = match else { return nil }
+            guard !ipv4Addresses.isEmpty else { return false }
+            let destination = UInt32(p[16]) << 24 | UInt32(p[17]) << 16 | UInt32(p[18]) << 8 | UInt32(p[19])
+            return ipv4Addresses.contains(destination)
+        }
 
-            // Swap on a copy: IPv4 src [12,16) ⇄ dst [16,20); IPv6 src [8,24) ⇄ dst [24,40).
+        /// A src⇄dst-swapped copy of a matched packet. Ports, payload, and
+        /// checksums are untouched.
+        static func swapped(_ packet: Data, isIPv6: Bool) -> Data {
+            // IPv4 src [12,16) ⇄ dst [16,20); IPv6 src [8,24) ⇄ dst [24,40).
             var out = packet
             out.withUnsafeMutableBytes { raw in
                 guard let p = raw.bindMemory(to: UInt8.self).baseAddress else { return }
@@ -93,7 +88,7 @@ extension TunnelStack {
                     for i in 0..<4 { swap(&p[12 + i], &p[16 + i]) }
                 }
             }
-            return (out, isIPv6)
+            return out
         }
     }
 }
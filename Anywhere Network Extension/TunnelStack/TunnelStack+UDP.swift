@@ -11,47 +11,11 @@ nonisolated private let logger = AnywhereLogger(category: "TunnelStack+UDP")
 
 extension TunnelStack {
 
-    // MARK: - Flow Registry
-
-    /// Removes `flow` only if it is still the registered flow for its key — a
-    /// stale teardown callback must not orphan a recreated flow for the same
-    /// 5-tuple. Must be called on ``udpQueue``.
-    func removeUDPFlow(_ flow: UDPFlow) {
-        if udpFlows[flow.flowKey] === flow {
-            udpFlows.removeValue(forKey: flow.flowKey)
-        }
-    }
-
-    /// Caps ``udpFlows`` by evicting the flow with the smallest idle deadline —
-    /// unreplied flows time out sooner, so one-way NAT probes shed first.
-    /// Run on ``udpQueue`` before each insert.
-    func evictUDPFlowsToAdmit() {
-        // Runs before every insert and frees at most one slot, so a single pass suffices.
-        let cap = TunnelConstants.udpMaxFlows
-        guard udpFlows.count >= cap else { return }
-
-        var victim: UDPFlow?
-        var victimDeadline = TimeInterval.greatestFiniteMagnitude
-        for flow in udpFlows.values {
-            let deadline = flow.idleDeadline
-            if deadline < victimDeadline { victimDeadline = deadline; victim = flow }
-        }
-
-        if let victim {
-            if !udpFlowCapWarned {
-                udpFlowCapWarned = true
-                logger.warning("[UDP] Flow table at capacity (\(cap)); evicting flow with least time left to bound memory")
-            }
-            victim.close()
-            removeUDPFlow(victim)
-        }
-    }
-
     // MARK: - Inbound UDP
 
-    /// Routes one parsed inbound UDP datagram. Must be called on ``udpQueue``
-    /// (mutates ``udpFlows``).
-    func handleInboundUDP(_ datagram: UDPPacket.Inbound) {
+    /// Routes one parsed inbound UDP datagram. Must be called on `shard`'s
+    /// queue (mutates its flows).
+    func handleInboundUDP(_ datagram: UDPPacket.Inbound, on shard: UDPShard) {
         let payload = datagram.payload
         let isIPv6 = datagram.isIPv6
 
@@ -71,7 +35,8 @@ extension TunnelStack {
                     dstIP: datagram.dstIPData,
                     dstPort: datagram.dstPort,
                     isIPv6: isIPv6,
-                    destination: destination
+                    destination: destination,
+                    on: shard
                 ) {
                     return  // Fake response sent, no flow needed
                 }
@@ -127,7 +92,7 @@ extension TunnelStack {
         // domain from creation, so it survives fake-IP pool eviction.
         let flowKey = UDPFlowKey(srcIP: datagram.srcIP, srcPort: datagram.srcPort,
                                  dstIP: datagram.dstIP, dstPort: datagram.dstPort, isIPv6: isIPv6)
-        if let flow = udpFlows[flowKey] {
+        if let flow = shard.flows[flowKey] {
             flow.handleReceivedData(payload, payloadLength: payload.count)
             return
         }
@@ -147,9 +112,9 @@ extension TunnelStack {
         // True until a routing rule matches — i.e. the default outbound is used.
         var viaDefault = true
 
-        switch resolveFakeIP(dstIPString, dstPort: datagram.dstPort, proto: "UDP") {
+        switch resolveFakeIP(address: datagram.dstIP, isIPv6: isIPv6, dstPort: datagram.dstPort, proto: "UDP") {
         case .passthrough:
-            if let action = domainRouter.matchIP(dstIPString) {
+            if let action = domainRouter.matchIP(address: datagram.dstIP, isIPv6: isIPv6) {
                 viaDefault = false
                 switch action {
                 case .direct:
@@ -255,10 +220,9 @@ extension TunnelStack {
             isIPv6: isIPv6,
             configuration: flowConfiguration,
             routeTarget: routeTarget,
-            flowQueue: udpQueue
+            shard: shard
         )
-        evictUDPFlowsToAdmit()
-        udpFlows[flowKey] = flow
+        shard.admit(flow)
         flow.handleReceivedData(payload, payloadLength: payload.count)
     }
 
@@ -32,11 +32,61 @@ struct TrafficByteCounts {
     }
 }
 
+/// Space-Saving top-K table of the domains moving the most payload bytes, in fixed memory
+/// however many distinct hosts a session sees. A domain not in a full table takes over the
+/// smallest entry and inherits its count as `errorBytes`, so a listed total overstates the
+/// truth by at most that much and any domain above total / `capacity` is always listed.
+struct TrafficHeavyHitters {
+    static let capacity = 128
+
+    struct Entry {
+        var domain: String
+        /// Route of the domain's most recent traffic.
+        var target: RouteTarget
+        var bytesIn: Int64 = 0
+        var bytesOut: Int64 = 0
+        var errorBytes: Int64 = 0
+        var total: Int64 { bytesIn + bytesOut + errorBytes }
+    }
+
+    private(set) var entries: [Entry] = []
+    private var index: [String: Int] = [:]
+
+    init() {
+        entries.reserveCapacity(Self.capacity)
+        index.reserveCapacity(Self.capacity)
+    }
+
+    mutating func add(bytesIn: Int64 = 0, bytesOut: Int64 = 0, domain: String, target: RouteTarget) {
+        let slot: Int
+        if let existing = index[domain] {
+            slot = existing
+        } else if entries.count < Self.capacity {
+            slot = entries.count
+            entries.append(Entry(domain: domain, target: target))
+            index[domain] = slot
+        } else {
+            // O(capacity) scan, paid only when a domain outside the table moves bytes.
+            var smallest = 0
+            for i in 1..<entries.count where entries[i].total < entries[smallest].total {
+                smallest = i
+            }
+            index.removeValue(forKey: entries[smallest].domain)
+            entries[smallest] = Entry(domain: domain, target: target, errorBytes: entries[smallest].total)
+            index[domain] = smallest
+            slot = smallest
+        }
+        entries[slot].bytesIn += bytesIn
+        entries[slot].bytesOut += bytesOut
+        entries[slot].target = target
+    }
+}
+
 // MARK: - TunnelStack
 
 /// Coordinator for the tunnel's data plane: TCP/ICMP feed the vendored lwIP
-/// stack on ``lwipQueue``; UDP is handled entirely in Swift on ``udpQueue``
-/// (lwIP is built `LWIP_UDP 0`).
+/// stack on ``lwipQueue``; UDP is handled entirely in Swift on the
+/// ``udpShards`` queues (lwIP is built `LWIP_UDP 0`).
 class TunnelStack {
 
     // MARK: Properties
@@ -46,10 +96,21 @@ class TunnelStack {
                                   qos: .userInitiated,
                                   autoreleaseFrequency: .workItem)
 
-    /// Serial queue owning the UDP data plane.
-    let udpQueue = DispatchQueue(label: AWCore.Identifier.udpQueue,
-                                 qos: .userInitiated,
-                                 autoreleaseFrequency: .workItem)
+    /// The UDP data plane, split by source address and port; each shard's
+    /// queue owns its flows and per-tunnel UDP transports.
+    let udpShards: [UDPShard] = (0..<TunnelConstants.udpShardCount).map {
+        UDPShard(index: $0, count: TunnelConstants.udpShardCount)
+    }
+
+    /// Queues TCP connections issue their proxy-leg calls on (uplink sends, receive
+    /// arming, cancel). lwIP itself stays on ``lwipQueue``, but the record sealing and
+    /// buffered-record opening those calls do synchronously spread across cores; see
+    /// ``tcpProxyQueue(srcIP:srcPort:dstIP:dstPort:isIPv6:)``.
+    let tcpProxyQueues: [DispatchQueue] = (0..<TunnelConstants.tcpProxyShardCount).map {
+        DispatchQueue(label: "\(AWCore.Identifier.tcpProxyQueue).\($0)",
+                      qos: .userInitiated,
+                      autoreleaseFrequency: .workItem)
+    }
 
     /// Queue for writing packets back to the tunnel.
     let outputQueue = DispatchQueue(label: AWCore.Identifier.outputQueue,
@@ -67,31 +128,64 @@ class TunnelStack {
     static let ipv4Proto = NSNumber(value: AF_INET)
     static let ipv6Proto = NSNumber(value: AF_INET6)
 
-    /// Guards ``outputPackets``, ``outputProtocols``, ``pendingReleases``, and
-    /// ``outputDrainInFlight``.
+    /// Guards ``outputRing`` and ``outputDrainInFlight``.
     let outputBufferLock = UnfairLock()
-    /// Pending IP packets to ship to utun. Protected by ``outputBufferLock``.
-    var outputPackets: [Data] = []
-    /// Per-packet protocol family (AF_INET / AF_INET6). Protected by ``outputBufferLock``.
-    var outputProtocols: [NSNumber] = []
-    /// Sole owners of the buffers backing ``outputPackets`` (their ``Data``
-    /// uses a `.none` deallocator). Index-aligned with ``outputPackets``;
-    /// releases fire on ``lwipQueue``. Protected by ``outputBufferLock``.
-    var pendingReleases: [PendingRelease] = []
+    /// Pending IP packets to ship to utun, each with its protocol family
+    /// (AF_INET / AF_INET6) and the lwIP release ctx that solely owns its
+    /// buffer (the ``Data`` uses a `.none` deallocator); releases run on
+    /// ``lwipQueue``.
+    /// Protected by ``outputBufferLock``.
+    var outputRing = TunnelOutputRing(capacity: TunnelConstants.tunnelOutputRingCapacity)
     /// True while a drain loop is running on ``outputQueue``; appenders only
     /// kick a new loop when false. Protected by ``outputBufferLock``.
     var outputDrainInFlight = false
 
-    /// ``fn(ctx)`` must run on ``lwipQueue``: `pbuf_free` and `mem_free`
-    /// mutate per-pool freelists with no locking under NO_SYS=1.
-    struct PendingRelease {
-        let ctx: UnsafeMutableRawPointer?
-        let fn: @convention(c) (UnsafeMutableRawPointer?) -> Void
+    /// lwIP output buffers pushed into ``outputRing`` / released back through
+    /// ``releaseOutputBuffers(_:)``; both counted on ``lwipQueue``. Output is
+    /// FIFO, so once the released count reaches a mark taken from the queued
+    /// count, every lwIP packet queued before the mark has been written and freed.
+    var outputBuffersQueued: UInt64 = 0
+    var outputBuffersReleased: UInt64 = 0
+    /// Reference-mode downlink buffers lwIP itself no longer points into, kept
+    /// until the output packets queued before their retirement (which may still
+    /// read them) are released. `[0, retiredWriteReferencesHead)` is already
+    /// dropped. Owned by ``lwipQueue``.
+    var retiredWriteReferences: [(mark: UInt64, data: Data)] = []
+    var retiredWriteReferencesHead = 0
+
+    /// Hands lwIP output buffers back in one C call. Must run on ``lwipQueue``:
+    /// `pbuf_free` and `mem_free` mutate per-pool freelists with no locking
+    /// under NO_SYS=1.
+    func releaseOutputBuffers(_ releaseCtxs: [UnsafeMutableRawPointer?]) {
+        guard !releaseCtxs.isEmpty else { return }
+        releaseCtxs.withUnsafeBufferPointer { buffer in
+            lwip_bridge_release_batch(buffer.baseAddress, Int32(buffer.count))
+        }
+        outputBuffersReleased += UInt64(releaseCtxs.count)
+        dropReleasedWriteReferences()
     }
 
-    /// Release placeholder for Swift-owned output packets; required so
-    /// ``pendingReleases`` stays index-aligned with ``outputPackets``.
-    static let noopRelease = PendingRelease(ctx: nil, fn: { _ in })
+    /// Takes a downlink buffer lwIP has stopped referencing; it is freed as soon
+    /// as no queued output packet can still point into it. Must run on ``lwipQueue``.
+    func retireWriteReference(_ data: Data) {
+        guard outputBuffersReleased < outputBuffersQueued else { return }
+        retiredWriteReferences.append((mark: outputBuffersQueued, data: data))
+    }
+
+    private func dropReleasedWriteReferences() {
+        while retiredWriteReferencesHead < retiredWriteReferences.count,
+              retiredWriteReferences[retiredWriteReferencesHead].mark <= outputBuffersReleased {
+            retiredWriteReferences[retiredWriteReferencesHead].data = Data()
+            retiredWriteReferencesHead += 1
+        }
+        if retiredWriteReferencesHead == retiredWriteReferences.count {
+            retiredWriteReferences.removeAll(keepingCapacity: true)
+            retiredWriteReferencesHead = 0
+        } else if retiredWriteReferencesHead > retiredWriteReferences.count - retiredWriteReferencesHead {
+            retiredWriteReferences.removeSubrange(0..<retiredWriteReferencesHead)
+            retiredWriteReferencesHead = 0
+        }
+    }
 
     // Settings read from App Group UserDefaults at start/restart and
     // live-reloaded via Darwin notification.
@@ -127,6 +221,9 @@ class TunnelStack {
     let mitmPolicy = MITMRewritePolicy()
     /// Lazily created to defer keychain access until a session needs a leaf cert.
     var mitmLeafCache: MITMLeafCertCache?
+    /// Set by the first interception; until then leaf preminting and the script
+    /// prewarm wait, so a tunnel start pays only for the matcher. lwipQueue only.
+    private var mitmWarm = false
     let mitmCertificateStore = MITMCertificateStore()
 
     var running = false
@@ -147,27 +244,35 @@ class TunnelStack {
 
     var timeoutTimer: DispatchSourceTimer?
 
-    /// True while ``timeoutTimer`` is suspended. Mutated only on ``lwipQueue``
-    /// so it tracks the suspend count exactly — releasing a suspended
-    /// `DispatchSource` traps.
-    var lwipTickSuspended = false
+    /// Delivers the kernel's memory-pressure warnings on lwipQueue; see `relieveMemoryPressure`.
+    var memoryPressureSource: DispatchSourceMemoryPressure?
 
     /// Active bypass country code (empty = disabled).
     var bypassCountryCode: String = ""
 
     /// Per-target traffic counters. Payload bytes, not wire bytes (headers,
-    /// ACKs, retransmits excluded). Written from ``lwipQueue``/``udpQueue``,
+    /// ACKs, retransmits excluded). Written from ``lwipQueue`` and the UDP shard queues,
     /// read from the NE message handler — every access takes ``countersLock``.
     private let countersLock = UnfairLock()
     private var _byteCounts = TrafficByteCounts()
-    func addBytesIn(_ n: Int64, target: RouteTarget) {
-        countersLock.withLock { _byteCounts.add(bytesIn: n, target: target) }
+    /// Per-domain split of the same bytes, for flows whose domain is known; same lock.
+    private var _heavyHitters = TrafficHeavyHitters()
+    func addBytesIn(_ n: Int64, target: RouteTarget, domain: String? = nil) {
+        countersLock.withLock {
+            _byteCounts.add(bytesIn: n, target: target)
+            if let domain { _heavyHitters.add(bytesIn: n, domain: domain, target: target) }
+        }
     }
-    func addBytesOut(_ n: Int64, target: RouteTarget) {
-        countersLock.withLock { _byteCounts.add(bytesOut: n, target: target) }
+    func addBytesOut(_ n: Int64, target: RouteTarget, domain: String? = nil) {
+        countersLock.withLock {
+            _byteCounts.add(bytesOut: n, target: target)
+            if let domain { _heavyHitters.add(bytesOut: n, domain: domain, target: target) }
+        }
     }
     /// Snapshot of all per-target counters, read once per stats poll.
     var byteCounts: TrafficByteCounts { countersLock.withLock { _byteCounts } }
+    /// Snapshot of the per-domain top-K table, read once per stats poll.
+    var heavyHitters: [TrafficHeavyHitters.Entry] { countersLock.withLock { _heavyHitters.entries } }
 
     // MARK: - Live Connection Counts
     //
@@ -181,13 +286,48 @@ class TunnelStack {
     }
 
     var activeUDPConnections: Int {
-        udpQueue.sync { udpFlows.count }
+        udpShards.reduce(0) { total, shard in total + shard.queue.sync { shard.flows.count } }
+    }
+
+    /// How long a no-op waited on ``lwipQueue`` and on the slowest UDP shard queue (µs), and
+    /// the TUN output ring's backlog. GCD exposes no queue depth, so the wait stands in for it.
+    var queueLoad: (lwipDelayMicroseconds: Int, udpDelayMicroseconds: Int, outputDepth: Int) {
+        let lwip = Self.noOpDelay(on: lwipQueue)
+        let udp = udpShards.map { Self.noOpDelay(on: $0.queue) }.max() ?? 0
+        let depth = outputBufferLock.withLock { outputRing.count }
+        return (lwip, udp, depth)
+    }
+
+    private static func noOpDelay(on queue: DispatchQueue) -> Int {
+        let start = HotPathMetrics.now()
+        queue.sync {}
+        return Int((HotPathMetrics.now() - start) / 1000)
+    }
+
+    /// The proxy-leg queue for a TCP connection, by FNV-1a over its 4-tuple; the
+    /// addresses are 4 or 16 raw bytes as lwIP's accept callback passes them.
+    func tcpProxyQueue(srcIP: UnsafeRawPointer, srcPort: UInt16,
+                       dstIP: UnsafeRawPointer, dstPort: UInt16, isIPv6: Bool) -> DispatchQueue {
+        guard tcpProxyQueues.count > 1 else { return tcpProxyQueues[0] }
+        var hash: UInt32 = 2166136261
+        let addressLength = isIPv6 ? 16 : 4
+        for address in [srcIP, dstIP] {
+            let bytes = address.assumingMemoryBound(to: UInt8.self)
+            for i in 0..<addressLength {
+                hash = (hash ^ UInt32(bytes[i])) &* 16777619
+            }
+        }
+        for port in [srcPort, dstPort] {
+            hash = (hash ^ UInt32(port >> 8)) &* 16777619
+            hash = (hash ^ UInt32(port & 0xFF)) &* 16777619
+        }
+        return tcpProxyQueues[Int(hash % UInt32(tcpProxyQueues.count))]
     }
 
     // MARK: - Log Buffer
     //
-    // Recent logs for the main app's viewer. Locked because appends come from
-    // I/O completion handlers, fetches from IPC.
+    // Recent logs for the main app's viewer, in a ``RecordRing``: appends come
+    // from I/O completion handlers, fetches from IPC.
 
     typealias LogLevel = TunnelLogLevel
     typealias LogEntry = TunnelLogEntry
@@ -198,42 +338,32 @@ class TunnelStack {
         let summary: String
     }
 
-    private let logLock = UnfairLock()
-    private var logEntries: [LogEntry] = []
+    private let logRing = RecordRing<(timestamp: CFAbsoluteTime, level: LogLevel, message: String)>(
+        capacity: TunnelConstants.logMaxEntries
+    )
 
     func appendLog(_ message: String, level: LogLevel) {
-        let now = CFAbsoluteTimeGetCurrent()
-        logLock.lock()
-        logEntries.append(LogEntry(timestamp: now, level: level, message: message))
-        compactLogs(now: now)
-        logLock.unlock()
+        logRing.append((CFAbsoluteTimeGetCurrent(), level, message))
     }
 
+    /// Entries within the retention window, oldest first.
     func fetchLogs() -> [LogEntry] {
-        let now = CFAbsoluteTimeGetCurrent()
-        logLock.lock()
-        compactLogs(now: now)
-        let result = logEntries
-        logLock.unlock()
-        return result
-    }
-
-    /// Prunes by age, then by count. Caller must hold `logLock`.
-    private func compactLogs(now: CFAbsoluteTime) {
-        let cutoff = now - TunnelConstants.logRetentionInterval
-        logEntries.removeAll { $0.timestamp < cutoff }
-        if logEntries.count > TunnelConstants.logMaxEntries {
-            logEntries.removeFirst(logEntries.count - TunnelConstants.logMaxEntries)
+        let cutoff = CFAbsoluteTimeGetCurrent() - TunnelConstants.logRetentionInterval
+        return logRing.snapshot().compactMap { stamped in
+            let record = stamped.record
+            guard record.timestamp >= cutoff else { return nil }
+            return LogEntry(
+                id: logRing.entryID(for: stamped.sequence),
+                timestamp: record.timestamp,
+                level: record.level,
+                message: record.message
+            )
         }
     }
 
-    /// Mux manager for multiplexing UDP flows (created when Vision flow is
-    /// active). Owned by ``udpQueue``.
-    var udpMultiplexerPool: VLESSVisionUDPMultiplexerPool?
-
     // MARK: - UDP Config Snapshot
     //
-    // The UDP path on ``udpQueue`` needs config that ``lwipQueue`` owns and
+    // The UDP path on the shard queues needs config that ``lwipQueue`` owns and
     // mutates; reading the stored properties cross-queue would race, so
     // ``lwipQueue`` publishes an immutable snapshot under ``udpConfigLock``
     // on every change.
@@ -312,26 +442,30 @@ class TunnelStack {
         }
     }
 
-    /// Active UDP flows keyed by 5-tuple. Owned by ``udpQueue``.
-    var udpFlows: [UDPFlowKey: UDPFlow] = [:]
-
-    /// Rising-edge latch so a sustained flow storm logs once, not per evicted
-    /// flow. Owned by ``udpQueue``.
-    var udpFlowCapWarned = false
-
-    /// Shared Shadowsocks UDP sessions keyed by configuration id: one session
-    /// serves every flow for that configuration. Owned by ``udpQueue``.
-    var ssUDPSessions: [UUID: ShadowsocksUDPSession] = [:]
-
     /// Domain-based DNS routing (loaded from App Group routing.json).
     let domainRouter = DomainRouter()
 
     /// Recent per-connection routing decisions, shown in the app's Requests view.
     let requestLog = RequestLog()
 
+    /// Idle, handshake and sniff deadlines of every TCP connection; lwipQueue only.
+    let tcpDeadlines = TCPDeadlineWheel(now: MonotonicClock.now)
+
+    /// Shared byte budget for TCP connections' Swift-side buffers; lwipQueue only.
+    let tcpBufferGovernor = TCPBufferGovernor(budget: TunnelConstants.tcpBufferBudget)
+
     /// Fake-IP pool for mapping domains to synthetic IPs.
     let fakeIPPool = FakeIPPool()
 
+    /// Upstream answers to forwarded (non-A/AAAA) DNS queries.
+    let dnsCache = DNSResponseCache()
+
+    /// Latency ranking of the upstreams forwarded queries race across.
+    let dnsUpstreams = DNSUpstreamSelector(servers: TunnelConstants.fallbackDNSServers(includeIPv6: false))
+
+    /// Background scoring of the app's auto-select group, if one is set.
+    let nodeHealth = NodeHealthProber()
+
     /// Re-applies tunnel network settings via `setTunnelNetworkSettings`,
     /// resetting the virtual interface and flushing the OS DNS cache.
     var onTunnelSettingsNeedReapply: (() -> Void)?
@@ -339,72 +473,12 @@ class TunnelStack {
     /// Singleton for C callback access (one NE process = one stack).
     static var shared: TunnelStack?
 
-    // MARK: - Shadowsocks UDP Sessions
-
-    /// Returns the shared SS UDP session for `configuration`, creating or
-    /// replacing terminal ones; sharing one sessionID + socket across flows
-    /// restores full-cone NAT. Must be called on `udpQueue`.
-    func shadowsocksUDPSession(for configuration: ProxyConfiguration) -> Result<ShadowsocksUDPSession, Error> {
-        if let existing = ssUDPSessions[configuration.id], existing.isUsable {
-            return .success(existing)
-        }
-        ssUDPSessions.removeValue(forKey: configuration.id)
-
-        guard case .shadowsocks(let password, let method) = configuration.outbound else {
-            return .failure(ProxyError.protocolError("Shadowsocks password not set"))
-        }
-        guard let cipher = ShadowsocksCipher(method: method) else {
-            return .failure(ShadowsocksError.invalidMethod(method))
-        }
-
-        let mode: ShadowsocksUDPSession.Mode
-        if cipher.isSS2022 {
-            guard let pskList = ShadowsocksKeyDerivation.decodePSKList(password: password, keySize: cipher.keySize) else {
-                return .failure(ShadowsocksError.invalidPSK)
-            }
-            if cipher == .blake3chacha20poly1305 {
-                mode = .ss2022ChaCha(psk: pskList.last!)
-            } else {
-                mode = .ss2022AES(cipher: cipher, pskList: pskList)
-            }
-        } else {
-            let masterKey = ShadowsocksKeyDerivation.deriveKey(password: password, keySize: cipher.keySize)
-            mode = .legacy(cipher: cipher, masterKey: masterKey)
-        }
-
-        let session = ShadowsocksUDPSession(
-            mode: mode,
-            serverHost: configuration.serverAddress,
-            serverPort: configuration.serverPort,
-            delegateQueue: udpQueue
-        )
-        ssUDPSessions[configuration.id] = session
-        return .success(session)
-    }
-
-    /// Cancels and forgets every SS UDP session. Must be called on `udpQueue`.
-    func purgeShadowsocksUDPSessions() {
-        for (_, session) in ssUDPSessions {
-            session.cancel()
-        }
-        ssUDPSessions.removeAll()
-    }
-
     // MARK: - Runtime Configuration
 
     func configureRuntime(for configuration: ProxyConfiguration) {
         reloadProxyModeSettings()
 
-        if proxyMode == .direct {
-            // Router is reset below, so every connection falls through to this
-            // direct default, bypassing all proxies and rules.
-            defaultRouteTarget = .direct
-        } else {
-            // Prefer the app's persisted selection — never a composited chain's throwaway id.
-            defaultRouteTarget = AWCore.getSelectedChainId().map(RouteTarget.proxy)
-                ?? AWCore.getSelectedConfigurationId().map(RouteTarget.proxy)
-                ?? .proxy(configuration.id)
-        }
+        defaultRouteTarget = resolveDefaultRouteTarget(for: configuration)
 
         loadIPv6Settings()
         loadBypassCountry()
@@ -413,29 +487,63 @@ class TunnelStack {
         loadQUICPolicySetting()
         loadBlockWebRTCSetting()
         loadPreventDNSLeakSetting()
+        loadVLESSMuxSetting()
         loadReflectionSetting()
-        loadMITMSetting()
+        StartupSignposts.measure("loadMITM") { loadMITMSetting() }
+        lwip_bridge_set_mtu(UInt16(AWCore.getTunnelMTU().rawValue))
+        DialTransports.useSockets = AWCore.getSocketTransportEnabled()
 
         publishUDPConfig()
         publishReflector()
-        
-        udpQueue.async { [self] in
-            if configuration.outboundProtocol == .vless {
-                udpMultiplexerPool = VLESSVisionUDPMultiplexerPool(configuration: configuration, flowQueue: udpQueue)
-            } else {
-                udpMultiplexerPool = nil
-            }
-        }
+
+        StartupSignposts.measure("prepareDefaultOutbound") { prepareDefaultOutbound(configuration) }
 
         // Only rule mode consults the router; global and direct reset it and
         // rely on the default outbound.
         if proxyMode == .rule {
-            domainRouter.loadRoutingConfiguration()
+            domainRouter.loadRoutingConfigurationInBackground()
         } else {
             domainRouter.reset()
         }
     }
 
+    /// The route unmatched connections take under the current `proxyMode`.
+    func resolveDefaultRouteTarget(for configuration: ProxyConfiguration) -> RouteTarget {
+        if proxyMode == .direct {
+            // The router is reset, so every connection falls through to this
+            // direct default, bypassing all proxies and rules.
+            return .direct
+        }
+        // Prefer the app's persisted selection — never a composited chain's throwaway id.
+        return AWCore.getSelectedChainId().map(RouteTarget.proxy)
+            ?? AWCore.getSelectedConfigurationId().map(RouteTarget.proxy)
+            ?? .proxy(configuration.id)
+    }
+
+    /// Warms and installs the per-tunnel state keyed to the default outbound.
+    func prepareDefaultOutbound(_ configuration: ProxyConfiguration) {
+        // Build Reality ClientHellos ahead of the first burst of dials.
+        if case .reality(let realityConfig) = configuration.xraySecurityLayer {
+            RealityHandshakePrecompute.shared.prewarm(realityConfig)
+        }
+        // And VLESS encryption's ephemeral ML-KEM/X25519 shares.
+        if #available(iOS 26.0, macOS 26.0, tvOS 26.0, *),
+           case .vless(_, let encryption, _, _, _) = configuration.outbound,
+           let encryptionConfig = try? VLESSEncryptionConfig.parse(encryption) {
+            VLESSEncryptionKeyPool.shared.prewarm(encryptionConfig)
+        }
+
+        for shard in udpShards {
+            shard.queue.async {
+                if configuration.outboundProtocol == .vless {
+                    shard.multiplexerPool = VLESSVisionUDPMultiplexerPool(configuration: configuration, flowQueue: shard.queue)
+                } else {
+                    shard.multiplexerPool = nil
+                }
+            }
+        }
+    }
+
     private func loadIPv6Settings() {
         advertiseIPv6ToApps = AWCore.getAdvertiseIPv6ToApps()
     }
@@ -444,7 +552,7 @@ class TunnelStack {
         bypassCountryCode = AWCore.getBypassCountryCode()
     }
 
-    private func reloadProxyModeSettings() {
+    func reloadProxyModeSettings() {
         baseProxyMode = AWCore.getProxyMode()
         trustedSSIDs = Set(AWCore.getTrustedSSIDs())
         alwaysTrustCellular = AWCore.getAlwaysTrustCellular()
@@ -492,6 +600,10 @@ class TunnelStack {
         preventDNSLeak = AWCore.getPreventDNSLeak()
     }
 
+    private func loadVLESSMuxSetting() {
+        VLESSMuxMultiplexerPool.shared.isEnabled = AWCore.getVLESSMuxEnabled()
+    }
+
     private func loadReflectionSetting() {
         reflectionEnabled = AWCore.getReflectionEnabled()
         reflectionAddresses = AWCore.getReflectionAddresses()
@@ -506,12 +618,34 @@ class TunnelStack {
         }
         mitmEnabled = snapshot.enabled
         if snapshot.enabled {
-            mitmPolicy.load(ruleSets: snapshot.ruleSets)
+            mitmPolicy.load(ruleSets: snapshot.ruleSets, prewarmScripts: mitmWarm)
+            if mitmWarm { premintMITMLeaves() }
         } else {
             mitmPolicy.reset()
         }
     }
 
+    /// Called as a session starts intercepting: does the warm-up `loadMITMSetting` deferred,
+    /// so the sessions after the first find leaves minted and scripts compiled.
+    func warmMITMIfNeeded() {
+        guard !mitmWarm else { return }
+        mitmWarm = true
+        StartupSignposts.measure("warmMITM") {
+            mitmPolicy.prewarmDeferredScripts()
+            premintMITMLeaves()
+        }
+    }
+
+    /// Creates the leaf cache (restoring the previous run's leaves) and mints the rest for
+    /// rule-set hosts in the background, so the first interception doesn't pay for signing.
+    private func premintMITMLeaves() {
+        guard mitmPolicy.hasRules else { return }
+        if mitmLeafCache == nil {
+            mitmLeafCache = try? MITMLeafCertCache(store: mitmCertificateStore)
+        }
+        mitmLeafCache?.premint(hostnames: mitmPolicy.premintHostnames)
+    }
+
     // MARK: - IP Address Helpers
 
     /// Converts raw IP address bytes (4 for IPv4, 16 for IPv6) to a string.
@@ -0,0 +1,80 @@
+//
+//  UDPExpiryWheel.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Hashed timing wheel of UDP flows keyed by idle deadline, one slot per
+/// second. The wheel is lazy: traffic only pushes a flow's deadline later, so
+/// ``UDPFlow/handleReceivedData(_:payloadLength:)`` never touches it; a flow
+/// whose slot comes due with time still left is moved to its current
+/// deadline's slot instead. Each reap therefore visits only the slots that
+/// elapsed since the last one. Not thread-safe — owned by its ``UDPShard``.
+struct UDPExpiryWheel {
+
+    /// Covers the longest idle timeout plus a tick, so a scheduled flow never
+    /// wraps past the cursor.
+    private static let slotCount = 128
+
+    private var slots: [[ObjectIdentifier: UDPFlow]]
+    /// Last tick (whole second) already reaped.
+    private var cursor: Int
+
+    init(now: TimeInterval) {
+        slots = Array(repeating: [:], count: Self.slotCount)
+        cursor = Self.tick(now)
+    }
+
+    private static func tick(_ time: TimeInterval) -> Int {
+        Int(time.rounded(.down))
+    }
+
+    /// Schedules `flow` for the first tick past its idle deadline.
+    mutating func insert(_ flow: UDPFlow) {
+        let due = max(Self.tick(flow.idleDeadline) + 1, cursor + 1)
+        let slot = min(due, cursor + Self.slotCount) & (Self.slotCount - 1)
+        slots[slot][ObjectIdentifier(flow)] = flow
+        flow.expirySlot = slot
+    }
+
+    mutating func remove(_ flow: UDPFlow) {
+        guard flow.expirySlot >= 0 else { return }
+        slots[flow.expirySlot].removeValue(forKey: ObjectIdentifier(flow))
+        flow.expirySlot = -1
+    }
+
+    /// Visits every slot due by `now`, handing flows past their deadline to
+    /// `expire` (already unscheduled) and rescheduling the rest. A gap longer
+    /// than one revolution (device sleep) visits each slot once.
+    mutating func advance(to now: TimeInterval, expire: (UDPFlow) -> Void) {
+        let target = Self.tick(now)
+        guard target > cursor else { return }
+        let steps = min(target - cursor, Self.slotCount)
+        let start = cursor
+        cursor = target
+        for t in (start + 1)...(start + steps) {
+            let slot = t & (Self.slotCount - 1)
+            guard !slots[slot].isEmpty else { continue }
+            let due = slots[slot]
+            slots[slot] = [:]
+            for flow in due.values {
+                flow.expirySlot = -1
+                if now > flow.idleDeadline {
+                    expire(flow)
+                } else {
+                    insert(flow)
+                }
+            }
+        }
+    }
+
+    mutating func removeAll() {
+        for slot in slots.indices where !slots[slot].isEmpty {
+            for flow in slots[slot].values { flow.expirySlot = -1 }
+            slots[slot] = [:]
+        }
+    }
+}
@@ -17,7 +17,9 @@ class UDPFlow {
     let dstPort: UInt16
     let isIPv6: Bool
     let configuration: ProxyConfiguration
-    /// All mutable state is confined to this queue, so the flow needs no locking.
+    /// The shard that registered this flow and lends it the per-tunnel transports.
+    let shard: UDPShard
+    /// All mutable state is confined to this queue (``shard``'s), so the flow needs no locking.
     let flowQueue: DispatchQueue
 
     // Raw IP bytes for building the response packet (swapped src/dst).
@@ -38,14 +40,22 @@ class UDPFlow {
                         : TunnelConstants.udpIdleTimeoutUnreplied)
     }
 
+    /// Slot in ``shard``'s expiry wheel, -1 when unscheduled. Owned by the shard.
+    var expirySlot = -1
+
+    /// Sees each reply datagram before it is written to the TUN and returns
+    /// false to drop it; the DNS forwarder's ``DNSUpstreamRace`` uses it to
+    /// pick the first answer and fill ``TunnelStack/dnsCache``.
+    var replyTap: ((Data) -> Bool)?
+
     // Direct bypass path
-    private var directTransport: NWUDPTransport?
+    private var directTransport: (any UDPDialTransport)?
 
     // Non-mux path
     private var proxyClient: ProxyClient?
     private var proxyConnection: ProxyConnection?
 
-    // Shared SS UDP session owned by TunnelStack; borrowed only.
+    // Shared SS UDP session owned by the shard; borrowed only.
     private weak var ssUDPSession: ShadowsocksUDPSession?
     private var ssUDPSessionToken: ShadowsocksUDPSession.Token?
 
@@ -56,14 +66,18 @@ class UDPFlow {
 
     /// Routing identity for accounting and dialing; fixed at creation (UDP has no SNI re-routing).
     private let routeTarget: RouteTarget
+    /// The route this flow committed to; read by in-place reconfiguration.
+    var boundRouteTarget: RouteTarget { routeTarget }
+    /// `dstHost` when it is a domain rather than an IP literal (no TLD ends in a digit).
+    private let accountingDomain: String?
 
     private var bypass: Bool {
         if case .direct = routeTarget { return true }
         return false
     }
 
-    private var pendingData: [Data] = []  // always raw payloads (framing applied at send time)
-    private var pendingBufferSize = 0
+    /// Raw payloads held while the outbound dials; framing is applied at send time.
+    private var pending = UDPPendingRing(capacity: TunnelConstants.udpMaxBufferSize)
     private var didWarnPendingOverflow = false
     private var closed = false
 
@@ -77,7 +91,7 @@ class UDPFlow {
          isIPv6: Bool,
          configuration: ProxyConfiguration,
          routeTarget: RouteTarget,
-         flowQueue: DispatchQueue) {
+         shard: UDPShard) {
         self.flowKey = flowKey
         self.srcHost = srcHost
         self.srcPort = srcPort
@@ -88,7 +102,9 @@ class UDPFlow {
         self.isIPv6 = isIPv6
         self.configuration = configuration
         self.routeTarget = routeTarget
-        self.flowQueue = flowQueue
+        self.accountingDomain = dstHost.contains(":") || dstHost.last?.isNumber != false ? nil : dstHost.lowercased()
+        self.shard = shard
+        self.flowQueue = shard.queue
     }
 
     private func reportFailure(_ operation: String, error: Error) {
@@ -109,7 +125,7 @@ class UDPFlow {
         if Self.isTerminalProxySendError(error, connection: connection) {
             reportFailure("Send", error: error)
             close()
-            TunnelStack.shared?.removeUDPFlow(self)
+            shard.remove(self)
         } else {
             logTransientSendFailure(error)
         }
@@ -151,7 +167,7 @@ class UDPFlow {
         guard !closed else { return }
         lastActivity = MonotonicClock.now
         
-        TunnelStack.shared?.addBytesOut(Int64(payloadLength), target: routeTarget)
+        TunnelStack.shared?.addBytesOut(Int64(payloadLength), target: routeTarget, domain: accountingDomain)
 
         // Buffer while connecting: sends on an unconnected UDP transport are silently dropped.
         if proxyConnecting {
@@ -205,16 +221,15 @@ class UDPFlow {
     }
 
     private func bufferPayload(data: Data, payloadLength: Int) {
-        // Bound the buffer against a stalled connect; dropping is fine since UDP is lossy.
-        if pendingBufferSize + payloadLength > TunnelConstants.udpMaxBufferSize {
-            if !didWarnPendingOverflow {
-                didWarnPendingOverflow = true
-                logger.warning("[UDP] Pending buffer overflow for \(flowKey); dropping datagrams until proxy connects")
-            }
-            return
+        // Bounded against a stalled connect; UDP is lossy, and the newest datagrams are
+        // the ones the app is still waiting on, so the oldest make room.
+        let dropped = pending.push(data.prefix(payloadLength))
+        guard dropped > 0 else { return }
+        HotPathMetrics.shared.add(.udpPendingDrops, dropped)
+        if !didWarnPendingOverflow {
+            didWarnPendingOverflow = true
+            logger.warning("[UDP] Pending buffer full for \(flowKey); dropping oldest datagrams until proxy connects")
         }
-        pendingData.append(data.prefix(payloadLength))
-        pendingBufferSize += payloadLength
     }
 
     // MARK: - Proxy Connection
@@ -232,7 +247,7 @@ class UDPFlow {
         // Fast paths bypass ProxyClient, so they must only run when no chain is configured.
         if !hasChain {
             let isDefaultConfiguration = TunnelStack.shared?.isDefaultConfiguration(configuration.id) ?? false
-            if configuration.outboundProtocol == .vless, isDefaultConfiguration, let udpMultiplexerPool = TunnelStack.shared?.udpMultiplexerPool {
+            if configuration.outboundProtocol == .vless, isDefaultConfiguration, let udpMultiplexerPool = shard.multiplexerPool {
                 proxyConnecting = true
                 connectViaMultiplexer(udpMultiplexerPool: udpMultiplexerPool)
                 return
@@ -274,23 +289,20 @@ class UDPFlow {
                                 self.reportFailure("Mux", error: error)
                             }
                             self.close()
-                            TunnelStack.shared?.removeUDPFlow(self)
+                            self.shard.remove(self)
                         }
                     }
 
                     // closeAll() may have already closed the session before this ran.
                     guard !session.closed else {
                         self.close()
-                        TunnelStack.shared?.removeUDPFlow(self)
+                        self.shard.remove(self)
                         return
                     }
 
                     self.udpStream = session
 
-                    let buffered = self.pendingData
-                    self.pendingData.removeAll()
-                    self.pendingBufferSize = 0
-                    for payload in buffered {
+                    for payload in self.pending.drain() {
                         session.send(data: payload) { [weak self] error in
                             if let error {
                                 self?.logTransientSendFailure(error)
@@ -303,7 +315,7 @@ class UDPFlow {
                         self.reportFailure("Connect", error: error)
                     }
                     self.close()
-                    TunnelStack.shared?.removeUDPFlow(self)
+                    self.shard.remove(self)
                 }
             }
         }
@@ -327,9 +339,10 @@ class UDPFlow {
                 case .success(let proxyConnection):
                     self.proxyConnection = proxyConnection
 
-                    // Drain buffered payloads; `send` preserves packet boundaries.
-                    for payload in self.pendingData {
-                        proxyConnection.send(data: payload) { [weak self] error in
+                    // Drain buffered payloads as one batch; boundaries are preserved.
+                    let buffered = self.pending.drain()
+                    if !buffered.isEmpty {
+                        proxyConnection.send(datagrams: buffered) { [weak self] error in
                             guard let self, let error else { return }
                             self.flowQueue.async {
                                 guard !self.closed else { return }
@@ -337,8 +350,6 @@ class UDPFlow {
                             }
                         }
                     }
-                    self.pendingData.removeAll()
-                    self.pendingBufferSize = 0
 
                     self.startProxyReceiving(proxyConnection: proxyConnection)
 
@@ -347,7 +358,7 @@ class UDPFlow {
                         self.reportFailure("Connect", error: error)
                     }
                     self.close()
-                    TunnelStack.shared?.removeUDPFlow(self)
+                    self.shard.remove(self)
                 }
             }
         }
@@ -356,12 +367,7 @@ class UDPFlow {
     private func connectShadowsocksUDP() {
         guard ssUDPSession == nil && !closed else { return }
 
-        guard let stack = TunnelStack.shared else {
-            close()
-            return
-        }
-
-        let sessionResult = stack.shadowsocksUDPSession(for: configuration)
+        let sessionResult = shard.shadowsocksUDPSession(for: configuration)
         let session: ShadowsocksUDPSession
         switch sessionResult {
         case .success(let s):
@@ -369,7 +375,7 @@ class UDPFlow {
         case .failure(let error):
             reportFailure("SS session", error: error)
             close()
-            stack.removeUDPFlow(self)
+            shard.remove(self)
             return
         }
 
@@ -390,7 +396,7 @@ class UDPFlow {
                 self.flowQueue.async {
                     self.reportFailure("Receive", error: error)
                     self.close()
-                    TunnelStack.shared?.removeUDPFlow(self)
+                    self.shard.remove(self)
                 }
             }
         )
@@ -401,15 +407,11 @@ class UDPFlow {
         // Drain what buffered meanwhile; the session re-buffers if its transport isn't ready yet.
         let host = dstHost
         let port = dstPort
-        for payload in pendingData {
-            session.send(token: token, dstHost: host, dstPort: port, payload: payload) { [weak self] error in
-                if let error {
-                    self?.logTransientSendFailure(error)
-                }
+        session.send(token: token, dstHost: host, dstPort: port, payloads: pending.drain()) { [weak self] error in
+            if let error {
+                self?.logTransientSendFailure(error)
             }
         }
-        pendingData.removeAll()
-        pendingBufferSize = 0
 
         // Async-resolve uncached domains so replies route by exact IP; the port-only
         // fallback misroutes flows sharing a destination port (e.g. QUIC on 443).
@@ -446,7 +448,7 @@ class UDPFlow {
         proxyConnecting = true  // reuse the flag so datagrams buffer until the transport connects
 
         // One connection per peer 5-tuple.
-        let transport = NWUDPTransport()
+        let transport = DialTransports.udp()
         self.directTransport = transport
         transport.connect(host: dstHost, port: dstPort, completionQueue: flowQueue) { [weak self] error in
             guard let self else { return }
@@ -458,19 +460,18 @@ class UDPFlow {
                 if let error {
                     self.reportFailure("Connect", error: error)
                     self.close()
-                    TunnelStack.shared?.removeUDPFlow(self)
+                    self.shard.remove(self)
                     return
                 }
 
-                for payload in self.pendingData {
-                    transport.send(data: payload) { [weak self] error in
+                let buffered = self.pending.drain()
+                if !buffered.isEmpty {
+                    transport.send(batch: buffered) { [weak self] error in
                         if let error {
                             self?.logTransientSendFailure(error)
                         }
                     }
                 }
-                self.pendingData.removeAll()
-                self.pendingBufferSize = 0
 
                 // Non-EAGAIN recv errors close the flow so we don't sit on a dead transport.
                 transport.startReceiving(handler: { [weak self] data in
@@ -480,7 +481,7 @@ class UDPFlow {
                     self.flowQueue.async {
                         self.reportFailure("Receive", error: error)
                         self.close()
-                        TunnelStack.shared?.removeUDPFlow(self)
+                        self.shard.remove(self)
                     }
                 })
             }
@@ -498,7 +499,7 @@ class UDPFlow {
                     self.reportFailure("Receive", error: error)
                 }
                 self.close()
-                TunnelStack.shared?.removeUDPFlow(self)
+                self.shard.remove(self)
             }
         }
     }
@@ -509,7 +510,8 @@ class UDPFlow {
             self.lastActivity = MonotonicClock.now
             self.replyCount += 1
             
-            TunnelStack.shared?.addBytesIn(Int64(data.count), target: self.routeTarget)
+            TunnelStack.shared?.addBytesIn(Int64(data.count), target: self.routeTarget, domain: self.accountingDomain)
+            if let replyTap = self.replyTap, !replyTap(data) { return }
 
             // Swap the 5-tuple: response source = original destination, and vice versa.
             TunnelStack.shared?.writeOutboundUDP(
@@ -542,10 +544,9 @@ class UDPFlow {
         proxyClient = nil
         udpStream = nil
         proxyConnecting = false
-        pendingData.removeAll()
-        pendingBufferSize = 0
+        pending.removeAll()
         transport?.cancel()
-        // The SS session is shared and owned by TunnelStack; unregister, never cancel.
+        // The SS session is shared and owned by the flow's shard; unregister, never cancel.
         if let ssSession, let ssToken {
             ssSession.unregister(token: ssToken)
         }
@@ -0,0 +1,167 @@
+//
+//  UDPFlowTable.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Open-addressed flow table for a shard's fast-path lookup, one contiguous
+/// slot array probed with robin-hood ordering. A probe compares the stored
+/// hash and probe distance before touching the flow, so a miss does no ARC
+/// work and a hit retains only the returned flow. The hash mixes the key's
+/// raw address words directly instead of going through `Hasher`. Sized at
+/// twice the shard's flow cap, so probe runs stay short; the table still
+/// doubles past 3/4 load. Not thread-safe — owned by its ``UDPShard``.
+struct UDPFlowTable: Sequence {
+
+    fileprivate struct Slot {
+        var key: TunnelStack.UDPFlowKey
+        var flow: UDPFlow?
+        var hash: UInt32
+        /// Distance from the key's home slot; -1 marks an empty slot.
+        var distance: Int32
+
+        static let empty = Slot(
+            key: TunnelStack.UDPFlowKey(srcIP: .zero, srcPort: 0, dstIP: .zero, dstPort: 0, isIPv6: false),
+            flow: nil,
+            hash: 0,
+            distance: -1
+        )
+    }
+
+    private var slots: ContiguousArray<Slot>
+    private(set) var count = 0
+
+    init(capacity: Int) {
+        var size = 16
+        while size < capacity * 2 { size <<= 1 }
+        slots = ContiguousArray(repeating: .empty, count: size)
+    }
+
+    var isEmpty: Bool { count == 0 }
+
+    private static func hash(_ key: TunnelStack.UDPFlowKey) -> UInt32 {
+        @inline(__always) func mix(_ x: UInt64) -> UInt64 {
+            let y = (x ^ (x >> 31)) &* 0x7FB5_D329_728E_A185
+            return (y ^ (y >> 27)) &* 0x81DA_DEF4_BC2D_D44D
+        }
+        let src = unsafeBitCast(key.srcIP, to: SIMD2<UInt64>.self)
+        let dst = unsafeBitCast(key.dstIP, to: SIMD2<UInt64>.self)
+        var h = UInt64(key.srcPort) | UInt64(key.dstPort) << 16 | (key.isIPv6 ? 1 << 32 : 0)
+        h = mix(h ^ src.x)
+        h = mix(h ^ src.y)
+        h = mix(h ^ dst.x)
+        h = mix(h ^ dst.y)
+        return UInt32(truncatingIfNeeded: h ^ (h >> 32))
+    }
+
+    /// Index of `key`'s slot, or nil.
+    private func find(_ key: TunnelStack.UDPFlowKey, hash: UInt32) -> Int? {
+        let mask = slots.count - 1
+        var index = Int(hash) & mask
+        var distance: Int32 = 0
+        // Robin-hood order: once a slot sits closer to home than the probe, the key is absent.
+        while slots[index].distance >= distance {
+            if slots[index].hash == hash && slots[index].key == key { return index }
+            index = (index + 1) & mask
+            distance += 1
+        }
+        return nil
+    }
+
+    subscript(key: TunnelStack.UDPFlowKey) -> UDPFlow? {
+        guard let index = find(key, hash: Self.hash(key)) else { return nil }
+        return slots[index].flow
+    }
+
+    /// Inserts or replaces the flow for `key`, returning the one replaced.
+    @discardableResult
+    mutating func updateValue(_ flow: UDPFlow, forKey key: TunnelStack.UDPFlowKey) -> UDPFlow? {
+        let hash = Self.hash(key)
+        if let index = find(key, hash: hash) {
+            let replaced = slots[index].flow
+            slots[index].flow = flow
+            return replaced
+        }
+        if (count + 1) * 4 > slots.count * 3 { grow() }
+        insertNew(Slot(key: key, flow: flow, hash: hash, distance: 0))
+        return nil
+    }
+
+    /// Places a key known to be absent, displacing richer entries.
+    private mutating func insertNew(_ slot: Slot) {
+        let mask = slots.count - 1
+        var entry = slot
+        var index = Int(entry.hash) & mask
+        while true {
+            if slots[index].distance < 0 {
+                slots[index] = entry
+                count += 1
+                return
+            }
+            if slots[index].distance < entry.distance {
+                swap(&slots[index], &entry)
+            }
+            index = (index + 1) & mask
+            entry.distance += 1
+        }
+    }
+
+    /// Removes `key`'s flow with backward-shift deletion, so no tombstones
+    /// lengthen later probes.
+    @discardableResult
+    mutating func removeValue(forKey key: TunnelStack.UDPFlowKey) -> UDPFlow? {
+        guard var index = find(key, hash: Self.hash(key)) else { return nil }
+        let removed = slots[index].flow
+        let mask = slots.count - 1
+        var next = (index + 1) & mask
+        while slots[next].distance > 0 {
+            slots[index] = slots[next]
+            slots[index].distance -= 1
+            index = next
+            next = (next + 1) & mask
+        }
+        slots[index] = .empty
+        count -= 1
+        return removed
+    }
+
+    mutating func removeAll() {
+        for index in slots.indices where slots[index].distance >= 0 {
+            slots[index] = .empty
+        }
+        count = 0
+    }
+
+    private mutating func grow() {
+        let old = slots
+        slots = ContiguousArray(repeating: .empty, count: old.count * 2)
+        count = 0
+        for var slot in old where slot.distance >= 0 {
+            slot.distance = 0
+            insertNew(slot)
+        }
+    }
+
+    // MARK: Sequence
+
+    struct Iterator: IteratorProtocol {
+        fileprivate let slots: ContiguousArray<Slot>
+        fileprivate var index = 0
+
+        mutating func next() -> UDPFlow? {
+            while index < slots.count {
+                defer { index += 1 }
+                if slots[index].distance >= 0 { return slots[index].flow }
+            }
+            return nil
+        }
+    }
+
+    /// Iterates a snapshot, so the table may be mutated mid-loop.
+    func makeIterator() -> Iterator {
+        Iterator(slots: slots)
+    }
+}
@@ -0,0 +1,122 @@
+//
+//  UDPPendingRing.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Datagrams a ``UDPFlow`` holds while its outbound dials, copied into one
+/// `capacity`-byte slab with a FIFO of (offset, length) records. A datagram is
+/// stored contiguously, restarting at the slab's start when the tail runs out;
+/// past capacity the oldest datagrams are dropped to make room. The slab is
+/// allocated on the first push, so a flow that never buffers costs nothing, and
+/// at this size it comes zero-filled from fresh pages that only become resident
+/// where written. Not thread-safe — the owning flow's queue confines it.
+struct UDPPendingRing {
+
+    private let capacity: Int
+    /// Uniquely held between drains, so writes land in place.
+    private var slab: Data?
+    private var records: [(offset: Int, length: Int)] = []
+    /// Index of the oldest live record; the ones before it are spent.
+    private var first = 0
+    private var writeOffset = 0
+    /// The newest datagrams restarted at offset 0, behind the oldest one.
+    private var wrapped = false
+    private(set) var byteCount = 0
+
+    init(capacity: Int) {
+        self.capacity = capacity
+    }
+
+    var isEmpty: Bool { first == records.count }
+    var count: Int { records.count - first }
+
+    /// Copies `payload` in, dropping the oldest datagrams until it fits. Returns
+    /// how many datagrams were dropped, counting `payload` itself when it is
+    /// larger than the whole slab.
+    mutating func push(_ payload: Data) -> Int {
+        let length = payload.count
+        guard length <= capacity else { return 1 }
+        if slab == nil { slab = Data(count: capacity) }
+
+        var dropped = 0
+        while true {
+            if let offset = placement(for: length) {
+                slab?.withUnsafeMutableBytes { slabBytes in
+                    payload.withUnsafeBytes { bytes in
+                        guard let base = bytes.baseAddress, let destination = slabBytes.baseAddress else { return }
+                        (destination + offset).copyMemory(from: base, byteCount: length)
+                    }
+                }
+                records.append((offset, length))
+                writeOffset = offset + length
+                byteCount += length
+                return dropped
+            }
+            dropOldest()
+            dropped += 1
+        }
+    }
+
+    /// Everything buffered, oldest first, as slices of the slab, which they now
+    /// own; the next push allocates a fresh one. No bytes are copied.
+    mutating func drain() -> [Data] {
+        guard !isEmpty, let storage = slab else {
+            removeAll()
+            return []
+        }
+        let datagrams = records[first...].map { storage[$0.offset..<($0.offset + $0.length)] }
+        slab = nil
+        reset()
+        return datagrams
+    }
+
+    /// Drops everything and releases the slab.
+    mutating func removeAll() {
+        slab = nil
+        reset()
+    }
+
+    // MARK: - Private
+
+    /// Where a `length`-byte datagram fits without touching a live one, or nil.
+    private mutating func placement(for length: Int) -> Int? {
+        if isEmpty {
+            reset()
+            return 0
+        }
+        let oldest = records[first].offset
+        if wrapped { return writeOffset + length <= oldest ? writeOffset : nil }
+        if writeOffset + length <= capacity { return writeOffset }
+        guard length <= oldest else { return nil }
+        wrapped = true
+        return 0
+    }
+
+    private mutating func dropOldest() {
+        let dropped = records[first]
+        first += 1
+        byteCount -= dropped.length
+        if isEmpty {
+            reset()
+        } else {
+            // The oldest record is now behind the one dropped: the head crossed the wrap.
+            if wrapped && records[first].offset < dropped.offset { wrapped = false }
+            if first >= 64 && first * 2 >= records.count {
+                records.removeFirst(first)
+                first = 0
+            }
+        }
+    }
+
+    private mutating func reset() {
+        records.removeAll(keepingCapacity: true)
+        first = 0
+        writeOffset = 0
+        wrapped = false
+        byteCount = 0
+    }
+}
@@ -0,0 +1,191 @@
+//
+//  UDPShard.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "UDPShard")
+
+/// One slice of the UDP data plane: a serial queue and everything it owns —
+/// the flows whose source hashes here, their idle reaping, and the per-tunnel
+/// UDP transports (Vision mux, shared Shadowsocks sessions) those flows borrow.
+/// Sharding on the source (address, port) rather than the full 5-tuple keeps
+/// every flow of one app socket on one shard, so a shared Shadowsocks session
+/// still gives that socket one outer mapping (full-cone NAT).
+final class UDPShard {
+
+    let index: Int
+    /// All state below is confined to this queue.
+    let queue: DispatchQueue
+
+    /// Active flows keyed by 5-tuple.
+    private(set) var flows: UDPFlowTable
+
+    /// Most flows this shard admits; ``TunnelConstants/udpMaxFlows`` split
+    /// evenly across shards.
+    let flowCap: Int
+
+    /// Rising-edge latch so a sustained flow storm logs once, not per evicted flow.
+    private var flowCapWarned = false
+
+    /// Every registered flow, scheduled by idle deadline.
+    private var expiryWheel = UDPExpiryWheel(now: MonotonicClock.now)
+
+    /// Mux manager for multiplexing UDP flows (created when Vision flow is active).
+    var multiplexerPool: VLESSVisionUDPMultiplexerPool?
+
+    /// Shared Shadowsocks UDP sessions keyed by configuration id: one session
+    /// serves every flow for that configuration.
+    private var ssUDPSessions: [UUID: ShadowsocksUDPSession] = [:]
+
+    init(index: Int, count: Int) {
+        self.index = index
+        self.queue = DispatchQueue(label: "\(AWCore.Identifier.udpQueue).\(index)",
+                                   qos: .userInitiated,
+                                   autoreleaseFrequency: .workItem)
+        self.flowCap = max(1, TunnelConstants.udpMaxFlows / count)
+        self.flows = UDPFlowTable(capacity: flowCap)
+    }
+
+    /// Shard for an inbound datagram's source; `p` is the IP header, with at
+    /// least 2 bytes of UDP header past `transportOffset`.
+    static func index(forSourceOf p: UnsafePointer<UInt8>, transportOffset: Int, isIPv6: Bool, shardCount: Int) -> Int {
+        guard shardCount > 1 else { return 0 }
+        // FNV-1a over source address and port.
+        var hash: UInt32 = 2166136261
+        let addressStart = isIPv6 ? 8 : 12
+        for i in addressStart..<(addressStart + (isIPv6 ? 16 : 4)) {
+            hash = (hash ^ UInt32(p[i])) &* 16777619
+        }
+        hash = (hash ^ UInt32(p[transportOffset])) &* 16777619
+        hash = (hash ^ UInt32(p[transportOffset + 1])) &* 16777619
+        return Int(hash % UInt32(shardCount))
+    }
+
+    // MARK: - Flow Registry
+
+    /// Removes `flow` only if it is still the registered flow for its key — a
+    /// stale teardown callback must not orphan a recreated flow for the same
+    /// 5-tuple.
+    func remove(_ flow: UDPFlow) {
+        if flows[flow.flowKey] === flow {
+            flows.removeValue(forKey: flow.flowKey)
+            expiryWheel.remove(flow)
+        }
+    }
+
+    /// Registers a new flow, first evicting the flow with the smallest idle
+    /// deadline if the shard is full — unreplied flows time out sooner, so
+    /// one-way NAT probes shed first.
+    func admit(_ flow: UDPFlow) {
+        // Runs before every insert and frees at most one slot, so a single pass suffices.
+        if flows.count >= flowCap {
+            var victim: UDPFlow?
+            var victimDeadline = TimeInterval.greatestFiniteMagnitude
+            for candidate in flows {
+                let deadline = candidate.idleDeadline
+                if deadline < victimDeadline { victimDeadline = deadline; victim = candidate }
+            }
+            if let victim {
+                if !flowCapWarned {
+                    flowCapWarned = true
+                    logger.warning("[UDP] Shard \(index) flow table at capacity (\(flowCap)); evicting flow with least time left to bound memory")
+                }
+                victim.close()
+                remove(victim)
+            }
+        }
+        if let replaced = flows.updateValue(flow, forKey: flow.flowKey) {
+            expiryWheel.remove(replaced)
+        }
+        expiryWheel.insert(flow)
+    }
+
+    /// Closes flows past their idle deadline, touching only the wheel slots
+    /// that came due since the last reap.
+    func reapIdleFlows(now: TimeInterval) {
+        expiryWheel.advance(to: now) { flow in
+            flow.close()
+            flows.removeValue(forKey: flow.flowKey)
+        }
+        // Re-arm the flow-cap warning so a later storm logs its own rising edge.
+        if flowCapWarned && flows.count < flowCap {
+            flowCapWarned = false
+        }
+    }
+
+    /// Closes every flow and per-tunnel transport, installing `multiplexerPool`
+    /// as the replacement mux.
+    func reclaimAll(replacingMultiplexerPool pool: VLESSVisionUDPMultiplexerPool?) {
+        multiplexerPool?.closeAll()
+        multiplexerPool = pool
+        purgeShadowsocksUDPSessions()
+        for flow in flows {
+            flow.close()
+        }
+        flows.removeAll()
+        expiryWheel.removeAll()
+    }
+
+    /// Closes the flows `shouldClose` picks, leaving the rest and the per-tunnel transports.
+    func closeFlows(where shouldClose: (UDPFlow) -> Bool) {
+        for flow in flows.filter(shouldClose) {
+            flow.close()
+            remove(flow)
+        }
+    }
+
+    // MARK: - Shadowsocks UDP Sessions
+
+    /// Returns the shard's shared SS UDP session for `configuration`, creating
+    /// or replacing terminal ones; sharing one sessionID + socket across flows
+    /// restores full-cone NAT.
+    func shadowsocksUDPSession(for configuration: ProxyConfiguration) -> Result<ShadowsocksUDPSession, Error> {
+        if let existing = ssUDPSessions[configuration.id], existing.isUsable {
+            return .success(existing)
+        }
+        ssUDPSessions.removeValue(forKey: configuration.id)
+
+        guard case .shadowsocks(let password, let method) = configuration.outbound else {
+            return .failure(ProxyError.protocolError("Shadowsocks password not set"))
+        }
+        guard let cipher = ShadowsocksCipher(method: method) else {
+            return .failure(ShadowsocksError.invalidMethod(method))
+        }
+
+        let mode: ShadowsocksUDPSession.Mode
+        if cipher.isSS2022 {
+            guard let pskList = ShadowsocksKeyDerivation.decodePSKList(password: password, keySize: cipher.keySize) else {
+                return .failure(ShadowsocksError.invalidPSK)
+            }
+            if cipher == .blake3chacha20poly1305 {
+                mode = .ss2022ChaCha(psk: pskList.last!)
+            } else {
+                mode = .ss2022AES(cipher: cipher, pskList: pskList)
+            }
+        } else {
+            let masterKey = ShadowsocksKeyDerivation.deriveKey(password: password, keySize: cipher.keySize)
+            mode = .legacy(cipher: cipher, masterKey: masterKey)
+        }
+
+        let session = ShadowsocksUDPSession(
+            mode: mode,
+            serverHost: configuration.serverAddress,
+            serverPort: configuration.serverPort,
+            delegateQueue: queue
+        )
+        ssUDPSessions[configuration.id] = session
+        return .success(session)
+    }
+
+    /// Cancels and forgets every SS UDP session.
+    private func purgeShadowsocksUDPSessions() {
+        for (_, session) in ssUDPSessions {
+            session.cancel()
+        }
+        ssUDPSessions.removeAll()
+    }
+}
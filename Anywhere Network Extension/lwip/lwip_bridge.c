@@ -6,8 +6,14 @@
 #include "lwip/tcp.h"
 #include "lwip/priv/tcp_priv.h"
 #include "lwip/timeouts.h"
+#include "lwip/sys.h"
 #include "lwip/ip.h"
 #include "lwip/ip_addr.h"
+#include "lwip/mem.h"
+#include "lwip/prot/icmp.h"
+#include "lwip/prot/icmp6.h"
+
+#include "packet_checksum.h"
 
 #include <string.h>
 #include <arpa/inet.h>
@@ -20,10 +26,19 @@ static os_log_t s_log = NULL;
  * ======================================================================== */
 
 static lwip_output_fn     s_output_fn     = NULL;
+static lwip_output_chain_fn s_output_chain_fn = NULL;
 static lwip_tcp_accept_fn s_tcp_accept_fn = NULL;
 static lwip_tcp_recv_fn   s_tcp_recv_fn   = NULL;
+static lwip_tcp_recv_vec_fn s_tcp_recv_vec_fn = NULL;
 static lwip_tcp_sent_fn   s_tcp_sent_fn   = NULL;
 static lwip_tcp_err_fn    s_tcp_err_fn    = NULL;
+static lwip_tcp_write_refs_destroyed_fn s_tcp_write_refs_destroyed_fn = NULL;
+static lwip_timer_kick_fn s_timer_kick_fn = NULL;
+
+/* ext_args slots: each PCB's reference-write owner, and its input-batch
+ * dirty-list position. */
+static u8_t s_write_refs_ext_id;
+static u8_t s_batch_dirty_ext_id;
 
 /* Storage for the SYN filter pointer declared in `lwip/priv/tcp_priv.h`.
  * The vendored `tcp_listen_input` patch calls this directly — keeping it
@@ -35,19 +50,49 @@ int (*lwip_anywhere_tcp_syn_filter)(const void *src_ip, u16_t src_port,
                                      int is_ipv6) = NULL;
 
 void lwip_bridge_set_output_fn(lwip_output_fn fn)     { s_output_fn = fn; }
+void lwip_bridge_set_output_chain_fn(lwip_output_chain_fn fn) { s_output_chain_fn = fn; }
 void lwip_bridge_set_tcp_accept_fn(lwip_tcp_accept_fn fn) { s_tcp_accept_fn = fn; }
 void lwip_bridge_set_tcp_syn_filter_fn(lwip_tcp_syn_filter_fn fn) {
     lwip_anywhere_tcp_syn_filter = fn;
 }
 void lwip_bridge_set_tcp_recv_fn(lwip_tcp_recv_fn fn)   { s_tcp_recv_fn = fn; }
+void lwip_bridge_set_tcp_recv_vec_fn(lwip_tcp_recv_vec_fn fn) { s_tcp_recv_vec_fn = fn; }
 void lwip_bridge_set_tcp_sent_fn(lwip_tcp_sent_fn fn)   { s_tcp_sent_fn = fn; }
 void lwip_bridge_set_tcp_err_fn(lwip_tcp_err_fn fn)     { s_tcp_err_fn = fn; }
+void lwip_bridge_set_tcp_write_refs_destroyed_fn(lwip_tcp_write_refs_destroyed_fn fn) {
+    s_tcp_write_refs_destroyed_fn = fn;
+}
+void lwip_bridge_set_timer_kick_fn(lwip_timer_kick_fn fn) { s_timer_kick_fn = fn; }
+
+/* Whether the caller's timer sleeps past lwIP's next tcp_tmr: until
+ * `s_timer_wake` (sys_now() ms), or until the next kick; see
+ * lwip_bridge_check_timeouts. */
+enum { TIMER_ARMED, TIMER_DEFERRED_UNTIL_WAKE, TIMER_DEFERRED_UNTIL_KICK };
+static int s_timer_deferred = TIMER_ARMED;
+static u32_t s_timer_wake = 0;
+
+/* Called before any bridge operation that can start a retransmit, persist or
+ * state timer. Replays the ticks slept through so far first — otherwise
+ * they would land on the new state and age a fresh segment's rtime — then
+ * asks the caller to re-evaluate the deadline. Before `s_timer_wake` none of
+ * those ticks acts on a PCB, so the replay fires no callbacks; past it the
+ * caller's timer is already due and replays them itself. */
+static void timer_wake(void) {
+    if (s_timer_deferred == TIMER_ARMED) return;
+    if (s_timer_deferred == TIMER_DEFERRED_UNTIL_KICK ||
+        (s32_t)(sys_now() - s_timer_wake) < 0) {
+        sys_check_timeouts();
+    }
+    s_timer_deferred = TIMER_ARMED;
+    if (s_timer_kick_fn) s_timer_kick_fn();
+}
 
 /* ========================================================================
  *  Network interface
  * ======================================================================== */
 
 static struct netif tun_netif;
+static u16_t s_netif_mtu = 1500;
 static struct tcp_pcb *tcp_listen_pcb_v4 = NULL;
 static struct tcp_pcb *tcp_listen_pcb_v6 = NULL;
 
@@ -55,31 +100,63 @@ static struct tcp_pcb *tcp_listen_pcb_v6 = NULL;
  *  Netif output callback
  * ======================================================================== */
 
-/* Release helpers handed to Swift via the output callback. Both run on
- * lwipQueue (Swift's deallocator hops there before invoking) because pbuf_free
- * and mem_free are not thread-safe under NO_SYS=1. */
-static void lwip_bridge_release_pbuf(void *ctx) { pbuf_free((struct pbuf *)ctx); }
-static void lwip_bridge_release_buf(void *ctx)  { mem_free(ctx); }
+/* Output release ctxs are either a `pbuf*` or a `mem_malloc`'d flatten
+ * buffer; both are MEM_ALIGNMENT-aligned, so the low bit tags the latter and
+ * one ctx array can free a whole write window in a single call. */
+#define RELEASE_CTX_HEAP ((uintptr_t)1)
+
+void lwip_bridge_release_batch(void *const *ctxs, int n) {
+    for (int i = 0; i < n; i++) {
+        uintptr_t ctx = (uintptr_t)ctxs[i];
+        if (ctx == 0) continue;
+        if (ctx & RELEASE_CTX_HEAP) {
+            mem_free((void *)(ctx & ~RELEASE_CTX_HEAP));
+        } else {
+            pbuf_free((struct pbuf *)ctx);
+        }
+    }
+}
 
 /* Hand a single-pbuf payload to Swift without copying. `pbuf_ref` keeps the
  * pbuf alive past lwIP's own `pbuf_free` after the netif output returns, so
- * the data stays valid until Swift's Data deallocator drops our extra ref. */
+ * the data stays valid until Swift releases our extra ref. */
 static void output_single_pbuf(struct pbuf *p, int is_ipv6) {
     pbuf_ref(p);
-    s_output_fn(p->payload, p->tot_len, is_ipv6, p, lwip_bridge_release_pbuf);
+    s_output_fn(p->payload, p->tot_len, is_ipv6, p);
+}
+
+/* Hand a pbuf chain (TCP_OVERSIZE / TCP_WRITE_FLAG_COPY segments: header
+ * pbuf + data pbufs) to Swift as payload regions. The ref on the head keeps
+ * every pbuf behind it alive, so the release ctx is the plain `pbuf*` and
+ * `lwip_bridge_release_batch` frees it like a single pbuf. Returns 0 when the
+ * chain is too long for the vec array and must be flattened instead. */
+static int output_pbuf_chain_vecs(struct pbuf *p, int is_ipv6) {
+    lwip_bridge_iovec vecs[LWIP_BRIDGE_MAX_OUTPUT_VECS];
+    int nvecs = 0;
+    for (struct pbuf *q = p; q != NULL; q = q->next) {
+        if (q->len == 0) continue;
+        if (nvecs == LWIP_BRIDGE_MAX_OUTPUT_VECS) return 0;
+        vecs[nvecs].base = q->payload;
+        vecs[nvecs].len = q->len;
+        nvecs++;
+    }
+    pbuf_ref(p);
+    s_output_chain_fn(vecs, nvecs, p->tot_len, is_ipv6, p);
+    return 1;
 }
 
-/* Flatten a chained pbuf into a heap buffer Swift owns. Saves the second
- * Data(bytes:count:) memcpy that the previous bridge required by handing
- * Swift a buffer it can wrap with `bytesNoCopy`. */
+/* Output a chained pbuf: scatter-gather when Swift registered the chain
+ * callback, otherwise flatten into a heap buffer Swift owns (wrapped with
+ * `bytesNoCopy`, so the bytes are copied once here and once into utun). */
 static void output_chained_pbuf(struct pbuf *p, int is_ipv6, const char *tag) {
+    if (s_output_chain_fn && output_pbuf_chain_vecs(p, is_ipv6)) return;
     void *buf = mem_malloc(p->tot_len);
     if (!buf) {
         os_log_error(s_log, "[Bridge] %s: mem_malloc failed for %u bytes", tag, p->tot_len);
         return;
     }
     pbuf_copy_partial(p, buf, p->tot_len, 0);
-    s_output_fn(buf, p->tot_len, is_ipv6, buf, lwip_bridge_release_buf);
+    s_output_fn(buf, p->tot_len, is_ipv6, (void *)((uintptr_t)buf | RELEASE_CTX_HEAP));
 }
 
 static err_t netif_output_ip4(struct netif *netif, struct pbuf *p,
@@ -109,7 +186,7 @@ static err_t netif_output_ip6(struct netif *netif, struct pbuf *p,
 static err_t tun_netif_init_fn(struct netif *netif) {
     netif->name[0] = 't';
     netif->name[1] = 'n';
-    netif->mtu = 1500;
+    netif->mtu = s_netif_mtu;
     netif->output = netif_output_ip4;
     netif->output_ip6 = netif_output_ip6;
     netif->flags = NETIF_FLAG_UP | NETIF_FLAG_LINK_UP;
@@ -170,6 +247,23 @@ static err_t tcp_accept_cb(void *arg, struct tcp_pcb *newpcb, err_t err) {
     return ERR_OK;
 }
 
+/* Hand a received pbuf chain to Swift region by region, so the bytes are
+ * copied once (into the upload buffer) instead of flattened here first.
+ * Returns 0 when the chain is too long for the vec array. */
+static int deliver_recv_chain(void *arg, struct pbuf *p) {
+    lwip_bridge_iovec vecs[LWIP_BRIDGE_MAX_RECV_VECS];
+    int nvecs = 0;
+    for (struct pbuf *q = p; q != NULL; q = q->next) {
+        if (q->len == 0) continue;
+        if (nvecs == LWIP_BRIDGE_MAX_RECV_VECS) return 0;
+        vecs[nvecs].base = q->payload;
+        vecs[nvecs].len = q->len;
+        nvecs++;
+    }
+    s_tcp_recv_vec_fn(arg, vecs, nvecs, p->tot_len);
+    return 1;
+}
+
 static err_t tcp_recv_cb(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
     (void)err;
     if (!arg) {
@@ -186,7 +280,9 @@ static err_t tcp_recv_cb(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t
         return ERR_OK;
     }
 
-    if (s_tcp_recv_fn) {
+    if (p->next != NULL && s_tcp_recv_vec_fn && deliver_recv_chain(arg, p)) {
+        /* Delivered without flattening. */
+    } else if (s_tcp_recv_fn) {
         if (p->next != NULL) {
             void *buf = mem_malloc(p->tot_len);
             if (buf) {
@@ -227,6 +323,13 @@ static void tcp_err_cb(void *arg, err_t err) {
  *  Initialization / Shutdown
  * ======================================================================== */
 
+void lwip_bridge_set_mtu(uint16_t mtu) {
+    s_netif_mtu = mtu;
+}
+
+uint32_t lwip_bridge_tcp_wnd(void)      { return TCP_WND; }
+uint32_t lwip_bridge_tcp_snd_buf(void)  { return TCP_SND_BUF; }
+
 void lwip_bridge_init(void) {
     /* IMPORTANT: lwip_init() must only be called ONCE per process lifetime.
      * It calls memp_init() which reinitializes all memory pools, corrupting
@@ -240,6 +343,8 @@ void lwip_bridge_init(void) {
     if (!initialized) {
         s_log = os_log_create("com.argsment.Anywhere.Network-Extension", "LWIP-Bridge");
         lwip_init();
+        s_write_refs_ext_id = tcp_ext_arg_alloc_id();
+        s_batch_dirty_ext_id = tcp_ext_arg_alloc_id();
         initialized = 1;
     }
 
@@ -344,6 +449,20 @@ int lwip_bridge_active_tcp_count(void) {
     return count;
 }
 
+/* Per-class mem_malloc usage since the process started; the high-water marks
+ * are what the class sizes and cache limits in port/mem_slab.c are tuned
+ * from. */
+static void log_mem_stats(void) {
+    lwip_slab_class_stats stats[LWIP_SLAB_NUM_CLASSES + 1];
+    lwip_slab_get_stats(stats);
+    for (int i = 0; i <= LWIP_SLAB_NUM_CLASSES; i++) {
+        os_log_info(s_log, "[Bridge] mem class %u: in_use=%u high_water=%u cached=%u/%u allocs=%llu misses=%llu",
+                    stats[i].chunk_size, stats[i].in_use, stats[i].high_water,
+                    stats[i].cached, stats[i].cache_limit,
+                    (unsigned long long)stats[i].allocs, (unsigned long long)stats[i].misses);
+    }
+}
+
 void lwip_bridge_shutdown(void) {
     lwip_bridge_abort_all_tcp();
 
@@ -351,6 +470,15 @@ void lwip_bridge_shutdown(void) {
     if (tcp_listen_pcb_v6) { tcp_close(tcp_listen_pcb_v6); tcp_listen_pcb_v6 = NULL; }
     netif_set_down(&tun_netif);
     netif_remove(&tun_netif);
+
+    log_mem_stats();
+    /* Hand the burst caches back while the stack is down (stop, or between
+     * restarts). */
+    lwip_slab_trim();
+}
+
+void lwip_bridge_trim_caches(void) {
+    lwip_slab_trim();
 }
 
 /* ========================================================================
@@ -361,26 +489,157 @@ void lwip_bridge_shutdown(void) {
  * Single-threaded under NO_SYS=1, so a plain int is fine. */
 int lwip_anywhere_input_batch_mode = 0;
 
+/* PCBs the tcp_in.c patch marked during the current batch. Each PCB's
+ * ext-arg slot holds its index + 1 while listed, so a second mark is a no-op,
+ * and the slot's destroy hook clears the entry if lwIP frees the PCB before
+ * batch end. At most one entry per PCB, so MEMP_NUM_TCP_PCB bounds it. */
+static struct tcp_pcb *s_batch_dirty[MEMP_NUM_TCP_PCB];
+static int s_batch_dirty_count = 0;
+
+static void batch_dirty_destroyed(u8_t id, void *data) {
+    (void)id;
+    if (data) s_batch_dirty[(uintptr_t)data - 1] = NULL;
+}
+
+static const struct tcp_ext_arg_callbacks s_batch_dirty_callbacks = {
+    batch_dirty_destroyed, NULL
+};
+
+void lwip_anywhere_input_batch_mark(struct tcp_pcb *pcb) {
+    if (tcp_ext_arg_get(pcb, s_batch_dirty_ext_id) != NULL) return;
+    if (s_batch_dirty_count == MEMP_NUM_TCP_PCB) {
+        /* Unreachable while each PCB is listed at most once; flush now
+         * rather than lose the ACK. */
+        tcp_output(pcb);
+        return;
+    }
+    tcp_ext_arg_set_callbacks(pcb, s_batch_dirty_ext_id, &s_batch_dirty_callbacks);
+    tcp_ext_arg_set(pcb, s_batch_dirty_ext_id, (void *)(uintptr_t)(s_batch_dirty_count + 1));
+    s_batch_dirty[s_batch_dirty_count++] = pcb;
+}
+
 void lwip_bridge_input_batch_begin(void) {
+    timer_wake();
     lwip_anywhere_input_batch_mode = 1;
 }
 
 void lwip_bridge_input_batch_end(void) {
     lwip_anywhere_input_batch_mode = 0;
-    /* One tcp_output per PCB flushes the per-segment TF_ACK_NOW flags
-     * accumulated during the batch (and any pcb->unsent unlocked by
-     * those ACKs). Capture `next` before tcp_output in case a callback
-     * it triggers aborts the PCB and unlinks it from the list. */
-    struct tcp_pcb *pcb = tcp_active_pcbs;
-    while (pcb != NULL) {
-        struct tcp_pcb *next = pcb->next;
+    /* One tcp_output per dirty PCB flushes the per-segment TF_ACK_NOW flags
+     * accumulated during the batch (and any pcb->unsent unlocked by those
+     * ACKs); idle PCBs are never touched. Each entry is unlisted before its
+     * tcp_output, and read only when reached, so a callback that aborts this
+     * or a later PCB just leaves a NULL behind. */
+    for (int i = 0; i < s_batch_dirty_count; i++) {
+        struct tcp_pcb *pcb = s_batch_dirty[i];
+        if (pcb == NULL) continue;
+        s_batch_dirty[i] = NULL;
+        tcp_ext_arg_set(pcb, s_batch_dirty_ext_id, NULL);
         tcp_output(pcb);
-        pcb = next;
     }
+    s_batch_dirty_count = 0;
+}
+
+/* ========================================================================
+ *  Echo fast path
+ * ======================================================================== */
+
+/* Whether one's-complement partial sums from packet_checksum_sum, added
+ * together, cover a correct checksum: a valid one makes them fold to 0xFFFF. */
+static int checksum_sums_valid(uint32_t sum) {
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    return sum == 0xFFFF;
+}
+
+/* Answers an ICMPv4 / ICMPv6 echo request the way lwIP's icmp_input /
+ * icmp6_input would (addresses swapped, type flipped, TTL / hop limit reset),
+ * but straight from the TUN buffer: one copy into a heap release ctx and two
+ * RFC 1624 checksum adjustments, with no pbuf, no ip_input and no output
+ * routing. A ping flood never reaches lwIP. Returns 0 for anything lwIP
+ * should see instead — fragments, extension headers, multicast or broadcast
+ * addresses — so those keep lwIP's behaviour. A request whose IPv4 header or
+ * ICMP / ICMPv6 checksum is wrong is dropped (returns 1): the incremental
+ * adjustment would carry the error into the reply, and lwIP, built with
+ * CHECKSUM_CHECK_* off, would not catch it either. */
+static int answer_echo_request(const uint8_t *in, int len) {
+    int version = in[0] >> 4;
+    if (version != 4 && version != 6) return 0;
+    int is_ipv6 = version == 6;
+    int total;
+    if (is_ipv6) {
+        if (len < 48 || in[6] != IP6_NEXTH_ICMP6 || in[40] != ICMP6_TYPE_EREQ) return 0;
+        total = 40 + ((int)in[4] << 8 | in[5]);
+        /* ff00::/8 on either side. */
+        if (total < 48 || total > len || in[8] == 0xFF || in[24] == 0xFF) return 0;
+        /* Pseudo-header (RFC 8200 §8.1): addresses, upper-layer length, next header. */
+        uint32_t icmp_len = (uint32_t)(total - 40);
+        const uint8_t pseudo[8] = { (uint8_t)(icmp_len >> 24), (uint8_t)(icmp_len >> 16),
+                                    (uint8_t)(icmp_len >> 8), (uint8_t)icmp_len, 0, 0, 0, IP6_NEXTH_ICMP6 };
+        uint32_t sum = (uint32_t)packet_checksum_sum(in + 8, 32) + packet_checksum_sum(pseudo, 8)
+                       + packet_checksum_sum(in + 40, (int)icmp_len);
+        if (!checksum_sums_valid(sum)) return 1;
+    } else {
+        int hlen = (in[0] & 0x0F) * 4;
+        if (hlen < 20 || len < hlen + 8 || in[9] != IP_PROTO_ICMP || in[hlen] != ICMP_ECHO) return 0;
+        total = (int)in[2] << 8 | in[3];
+        if (total < hlen + 8 || total > len || ((in[6] & 0x3F) | in[7]) != 0) return 0;
+        /* Multicast (224/4), limited broadcast and 0.0.0.0, as the source or destination. */
+        for (int a = 12; a <= 16; a += 4) {
+            uint32_t address = (uint32_t)in[a] << 24 | (uint32_t)in[a + 1] << 16 | (uint32_t)in[a + 2] << 8 | in[a + 3];
+            if ((address >> 28) == 0xE || address == 0xFFFFFFFFu || address == 0) return 0;
+        }
+        if (!checksum_sums_valid(packet_checksum_sum(in, hlen))
+            || !checksum_sums_valid(packet_checksum_sum(in + hlen, total - hlen))) return 1;
+    }
+
+    uint8_t *out = (uint8_t *)mem_malloc((mem_size_t)total);
+    if (!out) {
+        os_log_error(s_log, "[Bridge] echo: mem_malloc failed for %d bytes", total);
+        return 1;
+    }
+    memcpy(out, in, (size_t)total);
+
+    /* Swapping source and destination leaves the IPv4 header sum and the
+     * ICMPv6 pseudo-header sum unchanged; only the rewritten words move them. */
+    uint16_t old_word, new_word, checksum;
+    if (is_ipv6) {
+        memcpy(out + 8, in + 24, 16);
+        memcpy(out + 24, in + 8, 16);
+        out[7] = LWIP_ICMP6_HL;
+        uint8_t *icmp = out + 40;
+        memcpy(&old_word, icmp, 2);
+        icmp[0] = ICMP6_TYPE_EREP;
+        memcpy(&new_word, icmp, 2);
+        memcpy(&checksum, icmp + 2, 2);
+        checksum = packet_checksum_adjust(checksum, old_word, new_word);
+        memcpy(icmp + 2, &checksum, 2);
+    } else {
+        memcpy(out + 12, in + 16, 4);
+        memcpy(out + 16, in + 12, 4);
+        memcpy(&old_word, out + 8, 2);
+        out[8] = ICMP_TTL;
+        memcpy(&new_word, out + 8, 2);
+        memcpy(&checksum, out + 10, 2);
+        checksum = packet_checksum_adjust(checksum, old_word, new_word);
+        memcpy(out + 10, &checksum, 2);
+
+        uint8_t *icmp = out + (in[0] & 0x0F) * 4;
+        memcpy(&old_word, icmp, 2);
+        icmp[0] = ICMP_ER;
+        memcpy(&new_word, icmp, 2);
+        memcpy(&checksum, icmp + 2, 2);
+        checksum = packet_checksum_adjust(checksum, old_word, new_word);
+        memcpy(icmp + 2, &checksum, 2);
+    }
+
+    s_output_fn(out, total, is_ipv6, (void *)((uintptr_t)out | RELEASE_CTX_HEAP));
+    return 1;
 }
 
 void lwip_bridge_input(const void *data, int len) {
     if (!data || len <= 0) return;
+    if (s_output_fn && answer_echo_request((const uint8_t *)data, len)) return;
+    timer_wake();
 
     /* Only TCP/ICMP reach here — UDP is intercepted in Swift (TunnelStack+IO
      * routes it to UDPPacket/handleInboundUDP) before this call, so lwIP is
@@ -418,9 +677,9 @@ void lwip_bridge_input(const void *data, int len) {
  *  TCP Operations
  * ======================================================================== */
 
-int lwip_bridge_tcp_write(void *pcb, const void *data, uint16_t len) {
+static int bridge_tcp_write(void *pcb, const void *data, uint16_t len, u8_t apiflags) {
     struct tcp_pcb *tpcb = (struct tcp_pcb *)pcb;
-    err_t err = tcp_write(tpcb, data, len, TCP_WRITE_FLAG_COPY);
+    err_t err = tcp_write(tpcb, data, len, apiflags);
     if (err == ERR_MEM) {
         /* Transient — snd_buf, queuelen, or pbuf/seg pool is tight. The
          * caller's drain path retries once ACKs free space, so this is
@@ -434,16 +693,91 @@ int lwip_bridge_tcp_write(void *pcb, const void *data, uint16_t len) {
     return (int)err;
 }
 
+int lwip_bridge_tcp_write_v(void *pcb, const lwip_bridge_iovec *vecs, int nvecs, int flags) {
+    struct tcp_pcb *tpcb = (struct tcp_pcb *)pcb;
+    u8_t apiflags = (flags & LWIP_BRIDGE_WRITE_REF) ? 0 : TCP_WRITE_FLAG_COPY;
+    int retried = !(flags & LWIP_BRIDGE_WRITE_RETRY);
+    int accepted = 0;
+
+    timer_wake();
+    for (int i = 0; i < nvecs; i++) {
+        const uint8_t *base = (const uint8_t *)vecs[i].base;
+        int offset = 0;
+        while (offset < vecs[i].len) {
+            int sndbuf = (int)tcp_sndbuf(tpcb);
+            if (sndbuf <= 0 && !retried) {
+                /* Push what's queued so incoming ACKs can free snd_buf. */
+                retried = 1;
+                tcp_output(tpcb);
+                sndbuf = (int)tcp_sndbuf(tpcb);
+            }
+            if (sndbuf <= 0) goto done;
+            int chunk = vecs[i].len - offset;
+            if (chunk > sndbuf) chunk = sndbuf;
+            if (chunk > LWIP_BRIDGE_TCP_MAX_WRITE) chunk = LWIP_BRIDGE_TCP_MAX_WRITE;
+            int err = bridge_tcp_write(pcb, base + offset, (uint16_t)chunk, apiflags);
+            if (err == ERR_MEM) goto done;
+            if (err != ERR_OK) return -1;
+            offset += chunk;
+            accepted += chunk;
+        }
+    }
+
+done:
+    if (accepted > 0 && (flags & LWIP_BRIDGE_WRITE_FLUSH)) {
+        tcp_output(tpcb);
+    }
+    return accepted;
+}
+
+static void write_refs_destroyed(u8_t id, void *data) {
+    (void)id;
+    if (data && s_tcp_write_refs_destroyed_fn) {
+        s_tcp_write_refs_destroyed_fn(data);
+    }
+}
+
+static const struct tcp_ext_arg_callbacks s_write_refs_callbacks = {
+    write_refs_destroyed, NULL
+};
+
+void lwip_bridge_tcp_set_write_refs(void *pcb, void *owner) {
+    struct tcp_pcb *tpcb = (struct tcp_pcb *)pcb;
+    tcp_ext_arg_set_callbacks(tpcb, s_write_refs_ext_id, &s_write_refs_callbacks);
+    tcp_ext_arg_set(tpcb, s_write_refs_ext_id, owner);
+}
+
+uint32_t lwip_bridge_tcp_snd_lbb(void *pcb) {
+    return ((struct tcp_pcb *)pcb)->snd_lbb;
+}
+
+uint32_t lwip_bridge_tcp_ref_floor(void *pcb) {
+    struct tcp_pcb *tpcb = (struct tcp_pcb *)pcb;
+    uint32_t floor = tpcb->snd_lbb;
+    /* A retransmit moves unacked segments back onto unsent, so either head
+     * can hold the oldest byte. */
+    if (tpcb->unacked && TCP_SEQ_LT(lwip_ntohl(tpcb->unacked->tcphdr->seqno), floor)) {
+        floor = lwip_ntohl(tpcb->unacked->tcphdr->seqno);
+    }
+    if (tpcb->unsent && TCP_SEQ_LT(lwip_ntohl(tpcb->unsent->tcphdr->seqno), floor)) {
+        floor = lwip_ntohl(tpcb->unsent->tcphdr->seqno);
+    }
+    return floor;
+}
+
 void lwip_bridge_tcp_output(void *pcb) {
+    timer_wake();
     tcp_output((struct tcp_pcb *)pcb);
 }
 
 void lwip_bridge_tcp_recved(void *pcb, uint16_t len) {
+    timer_wake();
     tcp_recved((struct tcp_pcb *)pcb, len);
 }
 
 void lwip_bridge_tcp_close(void *pcb) {
     struct tcp_pcb *tpcb = (struct tcp_pcb *)pcb;
+    timer_wake();
     tcp_arg(tpcb, NULL);
     tcp_recv(tpcb, NULL);
     tcp_sent(tpcb, NULL);
@@ -476,13 +810,80 @@ int lwip_bridge_tcp_snd_queuelen(void *pcb) {
  *  Timer
  * ======================================================================== */
 
-int lwip_bridge_check_timeouts(void) {
+/* Mirrors tcp_persist_backoff in src/core/tcp.c (slow ticks per persist
+ * slot). */
+static const u8_t s_persist_backoff[7] = { 3, 6, 12, 24, 48, 96, 120 };
+
+/* Slow-timer runs (TCP_SLOW_INTERVAL apart) tcp_slowtmr can make on `pcb`
+ * without acting on it: 0 when the next tcp_tmr may act, UINT32_MAX when only
+ * input or a write can give it a deadline. Anything tcp_fasttmr would act on,
+ * and every state with a tcp_ticks-based timeout, counts as 0. */
+static u32_t pcb_idle_slow_ticks(const struct tcp_pcb *pcb) {
+    if ((pcb->flags & (TF_ACK_DELAY | TF_ACK_NOW | TF_CLOSEPEND)) ||
+        pcb->refused_data != NULL || pcb->poll != NULL ||
+        ip_get_option(pcb, SOF_KEEPALIVE)) {
+        return 0;
+    }
+    if (pcb->state != ESTABLISHED && pcb->state != CLOSE_WAIT) return 0;
+    if (pcb->nrtx >= TCP_MAXRTX) return 0;
+    if (pcb->persist_backoff > 0) {
+        /* tcp_slowtmr bumps persist_cnt, then probes once it reaches the
+         * slot's count. */
+        int left = (int)s_persist_backoff[pcb->persist_backoff - 1] - (int)pcb->persist_cnt - 1;
+        return left > 0 ? (u32_t)left : 0;
+    }
+    if (pcb->unacked != NULL || pcb->unsent != NULL) {
+        /* Same for rtime against rto. */
+        if (pcb->rtime < 0) return 0;
+        int left = (int)pcb->rto - (int)pcb->rtime - 1;
+        return left > 0 ? (u32_t)left : 0;
+    }
+    return UINT32_MAX;
+}
+
+uint32_t lwip_bridge_check_timeouts(void) {
+    s_timer_deferred = TIMER_ARMED;
     sys_check_timeouts();
     /* With every cyclic timer but tcp_tmr disabled at build time (see
-     * lwipopts.h), an empty timeout list means no TCP PCB is active or in
-     * TIME_WAIT — nothing to tick for. Report that so the caller can suspend the
-     * tick until fresh input revives it. */
-    return sys_timeouts_sleeptime() == SYS_TIMEOUTS_SLEEPTIME_INFINITE;
+     * lwipopts.h), the list holds at most the tcp timer, and an empty list
+     * means no TCP PCB is active or in TIME_WAIT. */
+    u32_t sleep = sys_timeouts_sleeptime();
+    if (sleep == SYS_TIMEOUTS_SLEEPTIME_INFINITE) {
+        s_timer_deferred = TIMER_DEFERRED_UNTIL_KICK;
+        return LWIP_BRIDGE_TIMER_NONE;
+    }
+
+    u32_t idle = UINT32_MAX;
+    for (struct tcp_pcb *pcb = tcp_active_pcbs; pcb != NULL && idle > 0; pcb = pcb->next) {
+        u32_t left = pcb_idle_slow_ticks(pcb);
+        if (left < idle) idle = left;
+    }
+    for (struct tcp_pcb *pcb = tcp_tw_pcbs; pcb != NULL && idle > 0; pcb = pcb->next) {
+        /* Removed once tcp_ticks - tmr exceeds 2 * TCP_MSL. */
+        u32_t age = (u32_t)(tcp_ticks - pcb->tmr);
+        u32_t limit = 2 * TCP_MSL / TCP_SLOW_INTERVAL;
+        u32_t left = age < limit ? limit - age : 0;
+        if (left < idle) idle = left;
+    }
+    if (idle == 0) return sleep;
+    if (idle == UINT32_MAX) {
+        /* Idle ESTABLISHED / CLOSE_WAIT PCBs only: tcp_tmr has nothing to do
+         * until input or a write, and timer_wake replays what was skipped. */
+        s_timer_deferred = TIMER_DEFERRED_UNTIL_KICK;
+        return LWIP_BRIDGE_TIMER_NONE;
+    }
+
+    /* Waking at the (2 * idle)-th tcp_tmr tick replays 2 * idle ticks,
+     * exactly idle slow runs whatever tcp_timer's parity, so the run that
+     * acts is still ahead of the replay. */
+    u32_t deadline = LWIP_BRIDGE_TIMER_MAX_SLEEP_MS;
+    if (idle <= LWIP_BRIDGE_TIMER_MAX_SLEEP_MS / TCP_SLOW_INTERVAL) {
+        deadline = LWIP_MIN(sleep + (idle - 1) * TCP_SLOW_INTERVAL + TCP_TMR_INTERVAL,
+                            (u32_t)LWIP_BRIDGE_TIMER_MAX_SLEEP_MS);
+    }
+    s_timer_deferred = TIMER_DEFERRED_UNTIL_WAKE;
+    s_timer_wake = sys_now() + deadline;
+    return deadline;
 }
 
 /* ========================================================================
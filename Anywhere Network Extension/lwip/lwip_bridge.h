@@ -6,23 +6,35 @@
 
 /* --- Callback types (implemented in Swift with @convention(c)) --- */
 
-/* Release callback: called by Swift after the output packet's `Data` is
- * released. `release_ctx` is whatever the bridge passed in `lwip_output_fn`'s
- * `release_ctx` argument — either the underlying `pbuf*` (zero-copy single-pbuf
- * path, freed via `pbuf_free`) or a `mem_malloc`'d buffer (chained-pbuf flatten
- * path, freed via `mem_free`). MUST be invoked on `lwipQueue` since both
- * `pbuf_free` and `mem_free` are not thread-safe under NO_SYS=1. */
-typedef void (*lwip_release_fn)(void *release_ctx);
-
 /* Netif output: lwIP wants to send an IP packet back to the TUN interface.
  *
- * Swift constructs `Data(bytesNoCopy: data, count: len, deallocator: ...)` and
- * the deallocator hops to `lwipQueue` to call `release(release_ctx)`. This
- * lets `NEPacketTunnelFlow.writePackets` consume the bytes directly out of
- * lwIP's pbuf payload (or a flattened chain copy) without an extra
- * `Data(bytes:count:)` memcpy. */
+ * Swift wraps the bytes in `Data(bytesNoCopy:count:deallocator: .none)` so
+ * `NEPacketTunnelFlow.writePackets` consumes them directly out of lwIP's pbuf
+ * payload (or a flattened chain copy) without an extra memcpy, and keeps
+ * `release_ctx` as the buffer's sole owner. Once the packet is written, the
+ * ctx goes back through `lwip_bridge_release_batch`. The ctx is opaque to
+ * Swift: either the underlying `pbuf*` or a tagged `mem_malloc`'d buffer. */
 typedef void (*lwip_output_fn)(const void *data, int len, int is_ipv6,
-                                void *release_ctx, lwip_release_fn release);
+                                void *release_ctx);
+
+/* One contiguous region of a chained output packet. */
+typedef struct lwip_bridge_iovec {
+    const void *base;
+    int len;
+} lwip_bridge_iovec;
+
+/* Chains longer than this are flattened and go through `lwip_output_fn`. */
+#define LWIP_BRIDGE_MAX_OUTPUT_VECS 16
+
+/* Chained netif output: same contract as `lwip_output_fn`, but the packet is
+ * handed over as the pbuf chain's payload regions (`tot_len` bytes across
+ * `nvecs` entries, valid only for the duration of the call — the regions
+ * themselves stay valid until `release_ctx` is released), so Swift can stitch
+ * them into one `Data` instead of the bridge copying into a heap buffer. When
+ * unset, chains are flattened as before. */
+typedef void (*lwip_output_chain_fn)(const lwip_bridge_iovec *vecs, int nvecs,
+                                      int tot_len, int is_ipv6,
+                                      void *release_ctx);
 
 /* TCP accept: new TCP connection accepted. Returning a non-NULL pointer
  * stores it as the PCB's tcp_arg; returning NULL aborts (RST). Rule-based
@@ -49,6 +61,23 @@ typedef int (*lwip_tcp_syn_filter_fn)(const void *src_ip, uint16_t src_port,
 /* TCP recv: data received on a TCP connection */
 typedef void (*lwip_tcp_recv_fn)(void *conn, const void *data, int len);
 
+/* TCP recv, chained segment: the pbuf chain's payload regions (`tot_len`
+ * bytes across `nvecs` entries), valid only for the duration of the call.
+ * Chains longer than `LWIP_BRIDGE_MAX_RECV_VECS`, or any chain when this is
+ * unset, are flattened into one buffer and delivered through
+ * `lwip_tcp_recv_fn`. Delivered in a single call because the handler may
+ * close or abort the connection, after which `conn` is gone. */
+#define LWIP_BRIDGE_MAX_RECV_VECS 64
+typedef void (*lwip_tcp_recv_vec_fn)(void *conn, const lwip_bridge_iovec *vecs,
+                                      int nvecs, int tot_len);
+
+/* Reference-write owner release: lwIP freed the PCB (all of its segments are
+ * gone), so nothing inside lwIP points into the owner's buffers any more.
+ * `owner` is whatever was passed to `lwip_bridge_tcp_set_write_refs`. May fire
+ * from inside `lwip_bridge_tcp_abort` / `_close` or a timer tick, always on
+ * lwipQueue. */
+typedef void (*lwip_tcp_write_refs_destroyed_fn)(void *owner);
+
 /* TCP sent: send buffer space freed (bytes acknowledged) */
 typedef void (*lwip_tcp_sent_fn)(void *conn, uint16_t len);
 
@@ -57,16 +86,36 @@ typedef void (*lwip_tcp_err_fn)(void *conn, int err);
 
 /* --- Callback registration --- */
 void lwip_bridge_set_output_fn(lwip_output_fn fn);
+void lwip_bridge_set_output_chain_fn(lwip_output_chain_fn fn);
 void lwip_bridge_set_tcp_accept_fn(lwip_tcp_accept_fn fn);
 void lwip_bridge_set_tcp_syn_filter_fn(lwip_tcp_syn_filter_fn fn);
 void lwip_bridge_set_tcp_recv_fn(lwip_tcp_recv_fn fn);
+void lwip_bridge_set_tcp_recv_vec_fn(lwip_tcp_recv_vec_fn fn);
 void lwip_bridge_set_tcp_sent_fn(lwip_tcp_sent_fn fn);
 void lwip_bridge_set_tcp_err_fn(lwip_tcp_err_fn fn);
+void lwip_bridge_set_tcp_write_refs_destroyed_fn(lwip_tcp_write_refs_destroyed_fn fn);
+
+/* Frees `n` output buffers previously handed out as `release_ctx` (NULL
+ * entries are skipped). MUST be called on `lwipQueue` since both `pbuf_free`
+ * and `mem_free` are not thread-safe under NO_SYS=1. */
+void lwip_bridge_release_batch(void *const *ctxs, int n);
 
 /* --- Lifecycle --- */
+/* MTU of the TUN netif, applied by the next lwip_bridge_init; it caps the MSS
+ * every later PCB negotiates and must match the tunnel settings' `mtu`.
+ * Defaults to 1500. */
+void lwip_bridge_set_mtu(uint16_t mtu);
+/* The build's TCP_WND and TCP_SND_BUF (lwipopts.h, per platform), so Swift-side
+ * caps sized off them follow. */
+uint32_t lwip_bridge_tcp_wnd(void);
+uint32_t lwip_bridge_tcp_snd_buf(void);
 void lwip_bridge_init(void);
 void lwip_bridge_shutdown(void);
 
+/* Hands mem_malloc's cached free chunks back to the system allocator while the
+ * stack keeps running (memory pressure); live chunks are untouched. */
+void lwip_bridge_trim_caches(void);
+
 /* Abort every active TCP PCB and clear TIME_WAIT, keeping the netif and
  * listeners intact. The blanket RST is the right tool for a full stack
  * shutdown/restart; the network-recovery path uses lwip_bridge_for_each_tcp
@@ -100,7 +149,6 @@ void lwip_bridge_input_batch_end(void);
 void lwip_bridge_input(const void *data, int len);
 
 /* --- TCP operations (called from Swift on lwipQueue) --- */
-int  lwip_bridge_tcp_write(void *pcb, const void *data, uint16_t len);
 void lwip_bridge_tcp_output(void *pcb);
 void lwip_bridge_tcp_recved(void *pcb, uint16_t len);
 void lwip_bridge_tcp_close(void *pcb);
@@ -108,16 +156,54 @@ void lwip_bridge_tcp_abort(void *pcb);
 int  lwip_bridge_tcp_sndbuf(void *pcb);
 int  lwip_bridge_tcp_snd_queuelen(void *pcb);
 
+/* Vectored tcp_write: queues the `nvecs` regions in order, in pieces of at
+ * most LWIP_BRIDGE_TCP_MAX_WRITE, until snd_buf or a pool runs out (ERR_MEM
+ * stops quietly — the caller retries once ACKs free space). Returns the bytes
+ * accepted, or -1 on a fatal tcp_write error. One call replaces a
+ * write/sndbuf/output round trip per piece. */
+#define LWIP_BRIDGE_WRITE_REF    0x1  /* by reference, see below */
+#define LWIP_BRIDGE_WRITE_RETRY  0x2  /* on a full snd_buf, tcp_output once and retry */
+#define LWIP_BRIDGE_WRITE_FLUSH  0x4  /* tcp_output once if anything was accepted */
+/* 16 KB ≈ 12 segments at a 1500-byte MTU; bounds each tcp_write's segment burst. */
+#define LWIP_BRIDGE_TCP_MAX_WRITE (16 * 1024)
+int  lwip_bridge_tcp_write_v(void *pcb, const lwip_bridge_iovec *vecs, int nvecs, int flags);
+
+/* With LWIP_BRIDGE_WRITE_REF, lwIP's segments point at the regions instead of
+ * copying them, so the caller must keep those bytes alive and unmodified until
+ * `lwip_bridge_tcp_ref_floor` has moved past them *and* any output packets
+ * already handed out have been released. `set_write_refs` attaches the owner
+ * of such buffers to the PCB (once); the destroyed fn receives it back when
+ * the PCB is freed, which covers connections closed while data was in flight. */
+/* Sequence number of the next byte tcp_write would queue. */
+uint32_t lwip_bridge_tcp_snd_lbb(void *pcb);
+/* Sequence number of the oldest byte still held by an unsent or unacked
+ * segment (`snd_lbb` when none): bytes before it are no longer referenced. */
+uint32_t lwip_bridge_tcp_ref_floor(void *pcb);
+
 /* UDP is handled in Swift (UDPPacket / TunnelStack+UDP), so lwIP is built
  * TCP-only (LWIP_UDP=0) and exposes no UDP bridge entry points. */
 
 /* --- Timer ---
  *
- * Services lwIP's timeout list (TCP retransmit, persist, TIME_WAIT, etc.).
- * Returns nonzero once nothing remains pending, so the caller can suspend the
- * periodic tick until fresh input re-arms it; zero while timeouts are still due.
- * Must be called on lwipQueue. */
-int lwip_bridge_check_timeouts(void);
+ * Services lwIP's timeout list (TCP retransmit, persist, TIME_WAIT, etc.) and
+ * returns the milliseconds until the next tick that can change anything: the
+ * next `tcp_tmr` while some PCB has a delayed ACK, a pending FIN or a state
+ * timeout running, otherwise the earliest retransmit / persist / TIME_WAIT
+ * expiry, capped at `LWIP_BRIDGE_TIMER_MAX_SLEEP_MS`. `LWIP_BRIDGE_TIMER_NONE`
+ * means nothing is due until fresh input or a write. Ticks slept through are
+ * replayed later (see the tcp timer catch-up patch in ANYWHERE_PATCHES.md);
+ * once input or a write changes the state the delay was computed from, the
+ * bridge calls the kick function. Must be called on lwipQueue. */
+#define LWIP_BRIDGE_TIMER_NONE UINT32_MAX
+#define LWIP_BRIDGE_TIMER_MAX_SLEEP_MS 2000
+uint32_t lwip_bridge_check_timeouts(void);
+
+/* Timer kick: called on lwipQueue, from inside a bridge call, when that call
+ * is about to invalidate the delay `lwip_bridge_check_timeouts` returned. The
+ * handler must not re-enter lwIP; it should schedule
+ * `lwip_bridge_check_timeouts` to run again promptly. */
+typedef void (*lwip_timer_kick_fn)(void);
+void lwip_bridge_set_timer_kick_fn(lwip_timer_kick_fn fn);
 
 /* --- IP address utility --- */
 
@@ -0,0 +1,71 @@
+#include "packet_checksum.h"
+
+#include <string.h>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/* Bytes folded into the NEON lanes before they're drained into the 64-bit
+ * total: each 16-byte load adds at most 2 × 0xFFFF per 32-bit lane, so a lane
+ * holds 2^15 loads per accumulator; 1 MiB over four accumulators stays clear. */
+#define PACKET_CHECKSUM_NEON_SPAN (1 << 20)
+
+uint16_t packet_checksum_sum(const void *data, int len) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint64_t sum = 0;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    while (len >= 64) {
+        uint32x4_t acc0 = vdupq_n_u32(0);
+        uint32x4_t acc1 = vdupq_n_u32(0);
+        uint32x4_t acc2 = vdupq_n_u32(0);
+        uint32x4_t acc3 = vdupq_n_u32(0);
+        int span = len < PACKET_CHECKSUM_NEON_SPAN ? len : PACKET_CHECKSUM_NEON_SPAN;
+        len -= span & ~63;
+        for (; span >= 64; span -= 64, p += 64) {
+            acc0 = vpadalq_u16(acc0, vreinterpretq_u16_u8(vld1q_u8(p)));
+            acc1 = vpadalq_u16(acc1, vreinterpretq_u16_u8(vld1q_u8(p + 16)));
+            acc2 = vpadalq_u16(acc2, vreinterpretq_u16_u8(vld1q_u8(p + 32)));
+            acc3 = vpadalq_u16(acc3, vreinterpretq_u16_u8(vld1q_u8(p + 48)));
+        }
+        sum += vaddlvq_u32(acc0) + vaddlvq_u32(acc1) + vaddlvq_u32(acc2) + vaddlvq_u32(acc3);
+    }
+#endif
+
+    /* Summing native 32-bit words and folding gives the same one's-complement
+     * result as summing their 16-bit halves. */
+    while (len >= 4) {
+        uint32_t word;
+        memcpy(&word, p, 4);
+        sum += word;
+        p += 4;
+        len -= 4;
+    }
+    if (len >= 2) {
+        uint16_t half;
+        memcpy(&half, p, 2);
+        sum += half;
+        p += 2;
+        len -= 2;
+    }
+    if (len > 0) {
+        /* A dangling byte is the high-order byte of a zero-padded word. */
+        uint16_t tail = 0;
+        ((uint8_t *)&tail)[0] = *p;
+        sum += tail;
+    }
+
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return (uint16_t)sum;
+}
+
+uint16_t packet_checksum_adjust(uint16_t checksum, uint16_t old_word, uint16_t new_word) {
+    /* HC' = ~(~HC + ~m + m') */
+    uint32_t sum = (uint16_t)~checksum + (uint32_t)(uint16_t)~old_word + new_word;
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)~sum;
+}
@@ -0,0 +1,22 @@
+#ifndef PACKET_CHECKSUM_H
+#define PACKET_CHECKSUM_H
+
+#include <stdint.h>
+
+/* Internet checksum (RFC 1071) shared by lwIP and the packets the tunnel
+ * synthesizes itself. lwipopts.h installs it as LWIP_CHKSUM, so every
+ * segment lwIP checksums goes through it too. Pure and callable from any
+ * queue. */
+
+/* Non-inverted one's-complement sum of `len` bytes, folded to 16 bits and
+ * in the byte order of the words read from memory (lwIP's LWIP_CHKSUM
+ * contract), so partial sums of separate buffers add before a final fold.
+ * Sums 64 bytes per NEON iteration; `data` needs no alignment. */
+uint16_t packet_checksum_sum(const void *data, int len);
+
+/* Incremental update (RFC 1624 eqn. 3): the header checksum `checksum` after
+ * one covered 16-bit word changes from `old_word` to `new_word`. All three
+ * are taken as they sit in the packet; the sum is byte-order independent. */
+uint16_t packet_checksum_adjust(uint16_t checksum, uint16_t old_word, uint16_t new_word);
+
+#endif /* PACKET_CHECKSUM_H */
@@ -0,0 +1,43 @@
+#ifndef MEM_SLAB_H
+#define MEM_SLAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Size-class allocator behind lwIP's mem_malloc (MEM_CUSTOM_ALLOCATOR, see
+ * lwipopts.h). Serves PBUF_RAM pbufs (ACK/header pbufs, copy-mode tcp_write
+ * segments) and the bridge's chain-flatten buffers from per-class free lists,
+ * so the steady-state data path never reaches the system allocator.
+ *
+ * Not thread-safe: every caller runs on lwipQueue (NO_SYS=1). */
+
+void *lwip_slab_malloc(size_t size);
+void *lwip_slab_calloc(size_t count, size_t size);
+void lwip_slab_free(void *mem);
+
+/* Returns every cached free chunk to the system allocator. Live chunks are
+ * untouched and go back onto the free lists as usual when freed. */
+void lwip_slab_trim(void);
+
+#define LWIP_SLAB_NUM_CLASSES 4
+
+/* One size class; `chunk_size` 0 is the row for blocks larger than every
+ * class, which are malloc'd individually. */
+typedef struct lwip_slab_class_stats {
+    uint32_t chunk_size;
+    /* Chunks handed out and not yet freed, and the most ever at once. */
+    uint32_t in_use;
+    uint32_t high_water;
+    /* Free chunks held for reuse, and the most this class may hold. */
+    uint32_t cached;
+    uint32_t cache_limit;
+    /* Allocations the free list couldn't serve (went to malloc). */
+    uint64_t misses;
+    uint64_t allocs;
+} lwip_slab_class_stats;
+
+/* Fills `out[0..LWIP_SLAB_NUM_CLASSES]` (LWIP_SLAB_NUM_CLASSES + 1 rows, the
+ * last one for oversized blocks). */
+void lwip_slab_get_stats(lwip_slab_class_stats *out);
+
+#endif /* MEM_SLAB_H */
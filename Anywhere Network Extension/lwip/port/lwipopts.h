@@ -44,7 +44,14 @@
 #define LWIP_CALLBACK_API               1
 
 /* --- Memory configuration --- */
-#define MEM_LIBC_MALLOC                 1
+/* mem_malloc (PBUF_RAM pbufs, flatten buffers) goes to the size-class free
+ * lists in port/mem_slab.c rather than straight to malloc. The memp pools
+ * below (TCP segments, REF pbufs, PCBs) are static arrays either way. */
+#define MEM_CUSTOM_ALLOCATOR            1
+#define MEM_CUSTOM_MALLOC               lwip_slab_malloc
+#define MEM_CUSTOM_CALLOC               lwip_slab_calloc
+#define MEM_CUSTOM_FREE                 lwip_slab_free
+#include "arch/mem_slab.h"
 #define MEM_ALIGNMENT                   8
 #define MEMP_OVERFLOW_CHECK             0
 #define MEMP_SANITY_CHECK               0
@@ -54,7 +61,11 @@
 #define MEMP_NUM_TCP_PCB                1024
 #define MEMP_NUM_TCP_PCB_LISTEN         2
 #define MEMP_NUM_TCP_SEG                32768
-#define MEMP_NUM_PBUF                   64
+/* PBUF_ROM/REF headers: one per segment queued by a reference-mode
+ * tcp_write (lwip_bridge_tcp_write_v with LWIP_BRIDGE_WRITE_REF), so this bounds how much downlink can
+ * sit in lwIP without a copy; past it tcp_write returns ERR_MEM and the caller
+ * falls back to copying. */
+#define MEMP_NUM_PBUF                   4096
 #define MEMP_NUM_NETBUF                 0
 #define MEMP_NUM_NETCONN                0
 
@@ -63,14 +74,32 @@
 #define PBUF_POOL_BUFSIZE               1500
 
 /* --- TCP configuration --- */
-#define TCP_MSS                         1460
-#define TCP_WND                         (1024 * TCP_MSS)
-#define TCP_SND_BUF                     (1024 * TCP_MSS)
-#define TCP_SND_QUEUELEN                (4 * TCP_SND_BUF / TCP_MSS)
-#define TCP_SNDLOWAT                    ((2 * TCP_MSS) + 1)
+/* TCP_MSS is only the ceiling, sized for the largest TunnelMTU (15000 - 40;
+ * init.c's TCP_SNDLOWAT sanity check rules out a 16 KB MTU).
+ * The MSS a PCB actually uses comes from the netif MTU set through
+ * lwip_bridge_set_mtu (TCP_CALCULATE_EFF_SEND_MSS), so a standard 1500-byte
+ * tunnel still negotiates 1460. Windows and buffers are sized off that
+ * standard segment so jumbo mode doesn't also grow them tenfold. */
+#define TCP_MSS                         14960
+#define LWIP_ANYWHERE_BASE_MSS          1460
+/* Window and send buffer, in base segments. Apple TV is wired and streams 4K
+ * with memory to spare, so it gets twice the iPhone window; the Swift side's
+ * TuningProfile makes the matching split. */
+#if defined(__APPLE__)
+#include <TargetConditionals.h>
+#endif
+#if defined(TARGET_OS_TV) && TARGET_OS_TV
+#define LWIP_ANYWHERE_WND_SEGMENTS      2048
+#else
+#define LWIP_ANYWHERE_WND_SEGMENTS      1024
+#endif
+#define TCP_WND                         (LWIP_ANYWHERE_WND_SEGMENTS * LWIP_ANYWHERE_BASE_MSS)
+#define TCP_SND_BUF                     (LWIP_ANYWHERE_WND_SEGMENTS * LWIP_ANYWHERE_BASE_MSS)
+#define TCP_SND_QUEUELEN                (4 * TCP_SND_BUF / LWIP_ANYWHERE_BASE_MSS)
+#define TCP_SNDLOWAT                    ((2 * LWIP_ANYWHERE_BASE_MSS) + 1)
 #define TCP_QUEUE_OOSEQ                 0
-#define TCP_OVERSIZE                    (4 * TCP_MSS)
-#define TCP_WND_UPDATE_THRESHOLD        LWIP_MIN((TCP_WND / 4), (TCP_MSS * 8))
+#define TCP_OVERSIZE                    (4 * LWIP_ANYWHERE_BASE_MSS)
+#define TCP_WND_UPDATE_THRESHOLD        LWIP_MIN((TCP_WND / 4), (LWIP_ANYWHERE_BASE_MSS * 8))
 #define TCP_MAXRTX                      8
 #define TCP_SYNMAXRTX                   3
 #define TCP_MSL                         1000
@@ -79,7 +108,15 @@
 #define LWIP_TCP_CALC_INITIAL_CWND(mss) ((tcpwnd_size_t)(32U * (mss)))
 #define LWIP_TCP_RTO_TIME               1000
 #define TCP_TMR_INTERVAL                100
+/* How far behind the tcp timer may fall and still replay every missed tick
+ * (Anywhere patch in src/core/timeouts.c). Must exceed the bridge's longest
+ * finite sleep, LWIP_BRIDGE_TIMER_MAX_SLEEP_MS. */
+#define LWIP_ANYWHERE_TCP_TMR_CATCHUP_MS 4000
 #define TCP_LISTEN_BACKLOG              0
+/* Two slots: the owner of a PCB's reference-mode write buffers, released from
+ * the destroy hook once lwIP has freed every segment pointing into them; and
+ * the PCB's position in the bridge's input-batch dirty list. */
+#define LWIP_TCP_PCB_NUM_EXT_ARGS       2
 
 /* --- TCP window scaling (RFC 1323) --- */
 #define LWIP_WND_SCALE                  1
@@ -87,6 +124,12 @@
 
 /* --- Checksum configuration --- */
 #define LWIP_CHKSUM_ALGORITHM           3
+/* Every checksum lwIP computes goes through the NEON sum in packet_checksum.c,
+ * shared with the packets the tunnel builds itself; LWIP_CHKSUM_ALGORITHM
+ * still compiles the portable routine, now unused. */
+#include <stdint.h>
+uint16_t packet_checksum_sum(const void *data, int len);
+#define LWIP_CHKSUM                     packet_checksum_sum
 /* Trust incoming packets from iOS TUN interface */
 #define CHECKSUM_CHECK_IP               0
 #define CHECKSUM_CHECK_TCP              0
@@ -111,7 +154,10 @@
 #define IP_OPTIONS_ALLOWED              0
 
 /* --- Misc --- */
-#define LWIP_NETIF_TX_SINGLE_PBUF       1
+/* 0 so tcp_write honours non-copy writes (1 forces TCP_WRITE_FLAG_COPY).
+ * Segments then leave as header + data pbuf chains, which the bridge hands to
+ * Swift as scatter-gather regions without flattening. */
+#define LWIP_NETIF_TX_SINGLE_PBUF       0
 #define LWIP_HAVE_LOOPIF                0
 #define LWIP_NETIF_LOOPBACK             0
 #define LWIP_RANDOMIZE_INITIAL_LOCAL_PORTS 1
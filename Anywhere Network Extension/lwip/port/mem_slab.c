@@ -0,0 +1,109 @@
+#include "arch/mem_slab.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Classes sized for what lwIP actually allocates: header-only and ACK pbufs,
+ * one MSS segment (1460 + headers + struct pbuf), reassembled receive chains
+ * and jumbo-MTU segments, and chain-flatten buffers up to a 64 KB IP packet.
+ * `cache_limit` bounds the memory a class keeps after a burst. */
+static const struct {
+    uint32_t chunk_size;
+    uint32_t cache_limit;
+} s_class_spec[LWIP_SLAB_NUM_CLASSES] = {
+    {   256, 1024 },
+    {  2048,  512 },
+    { 16384,  128 },
+    { 65536,    8 },
+};
+
+#define OVERSIZED_CLASS LWIP_SLAB_NUM_CLASSES
+
+/* Precedes every chunk; 16 bytes keeps the payload 16-aligned like malloc's,
+ * comfortably above MEM_ALIGNMENT. */
+typedef union chunk_header {
+    struct {
+        uint32_t cls;
+        union chunk_header *next_free;
+    } h;
+    max_align_t align;
+} chunk_header;
+
+typedef struct {
+    chunk_header *free_list;
+    lwip_slab_class_stats stats;
+} slab_class;
+
+static slab_class s_classes[LWIP_SLAB_NUM_CLASSES + 1];
+
+static uint32_t class_for_size(size_t size) {
+    for (uint32_t i = 0; i < LWIP_SLAB_NUM_CLASSES; i++) {
+        if (size <= s_class_spec[i].chunk_size) return i;
+    }
+    return OVERSIZED_CLASS;
+}
+
+void *lwip_slab_malloc(size_t size) {
+    uint32_t cls = class_for_size(size);
+    slab_class *c = &s_classes[cls];
+    chunk_header *hdr = c->free_list;
+
+    if (hdr != NULL) {
+        c->free_list = hdr->h.next_free;
+        c->stats.cached--;
+    } else {
+        size_t chunk = cls == OVERSIZED_CLASS ? size : s_class_spec[cls].chunk_size;
+        hdr = malloc(sizeof(chunk_header) + chunk);
+        if (hdr == NULL) return NULL;
+        hdr->h.cls = cls;
+        c->stats.misses++;
+    }
+    c->stats.allocs++;
+    if (++c->stats.in_use > c->stats.high_water) {
+        c->stats.high_water = c->stats.in_use;
+    }
+    return hdr + 1;
+}
+
+void *lwip_slab_calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+    void *mem = lwip_slab_malloc(count * size);
+    if (mem != NULL) memset(mem, 0, count * size);
+    return mem;
+}
+
+void lwip_slab_free(void *mem) {
+    if (mem == NULL) return;
+    chunk_header *hdr = (chunk_header *)mem - 1;
+    slab_class *c = &s_classes[hdr->h.cls];
+
+    c->stats.in_use--;
+    if (hdr->h.cls == OVERSIZED_CLASS ||
+        c->stats.cached >= s_class_spec[hdr->h.cls].cache_limit) {
+        free(hdr);
+        return;
+    }
+    hdr->h.next_free = c->free_list;
+    c->free_list = hdr;
+    c->stats.cached++;
+}
+
+void lwip_slab_trim(void) {
+    for (uint32_t i = 0; i < LWIP_SLAB_NUM_CLASSES; i++) {
+        slab_class *c = &s_classes[i];
+        while (c->free_list != NULL) {
+            chunk_header *next = c->free_list->h.next_free;
+            free(c->free_list);
+            c->free_list = next;
+        }
+        c->stats.cached = 0;
+    }
+}
+
+void lwip_slab_get_stats(lwip_slab_class_stats *out) {
+    for (uint32_t i = 0; i <= LWIP_SLAB_NUM_CLASSES; i++) {
+        out[i] = s_classes[i].stats;
+        out[i].chunk_size = i < LWIP_SLAB_NUM_CLASSES ? s_class_spec[i].chunk_size : 0;
+        out[i].cache_limit = i < LWIP_SLAB_NUM_CLASSES ? s_class_spec[i].cache_limit : 0;
+    }
+}
@@ -570,8 +570,9 @@ tcp_input(struct pbuf *p, struct netif *inp)
          * The bridge processes a kernel readPackets batch as a tight
          * loop of `lwip_bridge_input()` calls. Combined with Patch 2's
          * immediate-ACK, the per-call flush emits one ACK packet per
-         * input segment. In batch mode, skip the implicit flush; the
-         * bridge calls `tcp_output` once per active PCB in
+         * input segment. In batch mode, skip the implicit flush and mark
+         * the PCB dirty if it has an ACK or data to send; the bridge
+         * calls `tcp_output` once per dirty PCB in
          * `lwip_bridge_input_batch_end()`, collapsing accumulated
          * TF_ACK_NOW flags into one ACK per PCB and shipping any
          * pcb->unsent that the freed snd_buf opened up. TF_ACK_NOW is
@@ -581,6 +582,8 @@ tcp_input(struct pbuf *p, struct netif *inp)
          */
         if (!lwip_anywhere_input_batch_mode) {
           tcp_output(pcb);
+        } else if ((pcb->flags & TF_ACK_NOW) || pcb->unsent != NULL) {
+          lwip_anywhere_input_batch_mark(pcb);
         }
         /* --- END Anywhere Patch --- */
 #if TCP_INPUT_DEBUG
@@ -135,6 +135,17 @@ sys_timeouts_get_next_timeout(void)
 /** global variable that shows if the tcp timer is currently scheduled or not */
 static int tcpip_tcp_timer_active;
 
+/* --- BEGIN Anywhere Patch: tcp timer catch-up --- */
+#ifndef LWIP_ANYWHERE_TCP_TMR_CATCHUP_MS
+#define LWIP_ANYWHERE_TCP_TMR_CATCHUP_MS 0
+#endif
+#if LWIP_DEBUG_TIMERNAMES
+static void sys_timeout_abs(u32_t abs_time, sys_timeout_handler handler, void *arg, const char *handler_name);
+#else
+static void sys_timeout_abs(u32_t abs_time, sys_timeout_handler handler, void *arg);
+#endif
+/* --- END Anywhere Patch --- */
+
 /**
  * Timer callback function that calls tcp_tmr() and reschedules itself.
  *
@@ -149,8 +160,22 @@ tcpip_tcp_timer(void *arg)
   tcp_tmr();
   /* timer still needed? */
   if (tcp_active_pcbs || tcp_tw_pcbs) {
-    /* restart timer */
-    sys_timeout(TCP_TMR_INTERVAL, tcpip_tcp_timer, NULL);
+    /* --- BEGIN Anywhere Patch: tcp timer catch-up --- */
+    /* Restart from the due time rather than from now, so ticks the host
+     * skipped while sleeping towards a later PCB deadline are replayed by
+     * sys_check_timeouts (tcp_ticks and the per-PCB counters keep real time).
+     * A backlog past LWIP_ANYWHERE_TCP_TMR_CATCHUP_MS is dropped instead. */
+    u32_t now = sys_now();
+    u32_t next_timeout_time = (u32_t)(current_timeout_due_time + TCP_TMR_INTERVAL);
+    if (TIME_LESS_THAN(next_timeout_time, (u32_t)(now - LWIP_ANYWHERE_TCP_TMR_CATCHUP_MS))) {
+      next_timeout_time = (u32_t)(now + TCP_TMR_INTERVAL);
+    }
+#if LWIP_DEBUG_TIMERNAMES
+    sys_timeout_abs(next_timeout_time, tcpip_tcp_timer, NULL, "tcpip_tcp_timer");
+#else
+    sys_timeout_abs(next_timeout_time, tcpip_tcp_timer, NULL);
+#endif
+    /* --- END Anywhere Patch --- */
   } else {
     /* disable timer */
     tcpip_tcp_timer_active = 0;
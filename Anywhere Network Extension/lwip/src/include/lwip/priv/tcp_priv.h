@@ -463,10 +463,13 @@ struct tcp_seg *tcp_seg_copy(struct tcp_seg *seg);
  * Set to 1 by the bridge around a kernel readPackets batch. Read by the
  * tcp_input gating patch (`src/core/tcp_in.c`) to suppress the implicit
  * per-segment `tcp_output(pcb)` flush at the bottom of the input loop,
- * collapsing N per-segment ACKs to one end-of-batch ACK per PCB.
+ * collapsing N per-segment ACKs to one end-of-batch ACK per PCB. The
+ * patch marks each PCB left with something to send; the bridge flushes
+ * only those at batch end. Both live in `lwip_bridge.c`.
  * See lwip/ANYWHERE_PATCHES.md.
  */
 extern int lwip_anywhere_input_batch_mode;
+void lwip_anywhere_input_batch_mark(struct tcp_pcb *pcb);
 /* --- END Anywhere Patch --- */
 
 /* --- BEGIN Anywhere Patch: SYN filter ---
@@ -0,0 +1,253 @@
+#include "udp_packet.h"
+#include "packet_checksum.h"
+
+#include "lwip/def.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/prot/ip.h"
+#include "lwip/prot/ip6.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <os/lock.h>
+
+/* Free buffers kept for reuse per size class; a burst beyond this goes back
+ * to malloc. The jumbo class only fills under a jumbo TunnelMTU. */
+static const struct {
+    int size;
+    int limit;
+} s_pool_spec[] = {
+    { UDP_PACKET_POOLED_SIZE,       256 },
+    { UDP_PACKET_POOLED_JUMBO_SIZE,  32 },
+};
+
+#define UDP_PACKET_POOL_COUNT ((int)(sizeof(s_pool_spec) / sizeof(s_pool_spec[0])))
+
+/* Precedes every buffer; 16 bytes keeps the packet 16-aligned like malloc's
+ * and records the pool the buffer belongs to (-1 for none). */
+typedef union pool_header {
+    struct {
+        int pool;
+        union pool_header *next_free;
+    } h;
+    max_align_t align;
+} pool_header;
+
+static os_unfair_lock s_pool_lock = OS_UNFAIR_LOCK_INIT;
+static pool_header *s_pool_free[UDP_PACKET_POOL_COUNT];
+static int s_pool_cached[UDP_PACKET_POOL_COUNT];
+
+void *udp_packet_buffer_alloc(int len) {
+    if (len < 0) return NULL;
+    int pool = 0;
+    while (pool < UDP_PACKET_POOL_COUNT && len > s_pool_spec[pool].size) pool++;
+
+    pool_header *hdr = NULL;
+    if (pool < UDP_PACKET_POOL_COUNT) {
+        os_unfair_lock_lock(&s_pool_lock);
+        hdr = s_pool_free[pool];
+        if (hdr != NULL) {
+            s_pool_free[pool] = hdr->h.next_free;
+            s_pool_cached[pool]--;
+        }
+        os_unfair_lock_unlock(&s_pool_lock);
+        if (hdr == NULL) {
+            hdr = malloc(sizeof(pool_header) + (size_t)s_pool_spec[pool].size);
+            if (hdr == NULL) return NULL;
+            hdr->h.pool = pool;
+        }
+    } else {
+        hdr = malloc(sizeof(pool_header) + (size_t)len);
+        if (hdr == NULL) return NULL;
+        hdr->h.pool = -1;
+    }
+    return hdr + 1;
+}
+
+void udp_packet_buffer_free(void *buf) {
+    if (buf == NULL) return;
+    pool_header *hdr = (pool_header *)buf - 1;
+    int pool = hdr->h.pool;
+    if (pool >= 0) {
+        os_unfair_lock_lock(&s_pool_lock);
+        if (s_pool_cached[pool] < s_pool_spec[pool].limit) {
+            hdr->h.next_free = s_pool_free[pool];
+            s_pool_free[pool] = hdr;
+            s_pool_cached[pool]++;
+            hdr = NULL;
+        }
+        os_unfair_lock_unlock(&s_pool_lock);
+    }
+    free(hdr);
+}
+
+void udp_packet_buffer_trim(void) {
+    pool_header *lists[UDP_PACKET_POOL_COUNT];
+    os_unfair_lock_lock(&s_pool_lock);
+    for (int pool = 0; pool < UDP_PACKET_POOL_COUNT; pool++) {
+        lists[pool] = s_pool_free[pool];
+        s_pool_free[pool] = NULL;
+        s_pool_cached[pool] = 0;
+    }
+    os_unfair_lock_unlock(&s_pool_lock);
+    for (int pool = 0; pool < UDP_PACKET_POOL_COUNT; pool++) {
+        while (lists[pool] != NULL) {
+            pool_header *next = lists[pool]->h.next_free;
+            free(lists[pool]);
+            lists[pool] = next;
+        }
+    }
+}
+
+/* Non-inverted Internet sum of `len` bytes, host order like lwIP's. */
+static u32_t partial_sum(const void *data, u16_t len) {
+    return packet_checksum_sum(data, len);
+}
+
+int udp_packet_build(uint8_t *out, int is_ipv6,
+                     const void *src_ip, uint16_t src_port,
+                     const void *dst_ip, uint16_t dst_port,
+                     const void *payload, int payload_len) {
+    int udp_len = 8 + payload_len;
+    if (payload_len < 0 || udp_len > 0xFFFF) return -1;
+
+    int addr_len = is_ipv6 ? 16 : 4;
+    int ip_len = is_ipv6 ? 40 : 20;
+    int total = ip_len + udp_len;
+    uint8_t *udp = out + ip_len;
+
+    if (is_ipv6) {
+        out[0] = 0x60; out[1] = 0; out[2] = 0; out[3] = 0;   /* version 6, TC/flow 0 */
+        out[4] = (uint8_t)(udp_len >> 8); out[5] = (uint8_t)udp_len;
+        out[6] = IP_PROTO_UDP;                               /* next header */
+        out[7] = 64;                                         /* hop limit */
+        memcpy(out + 8, src_ip, 16);
+        memcpy(out + 24, dst_ip, 16);
+    } else {
+        out[0] = 0x45; out[1] = 0;                           /* version 4, IHL 5 */
+        out[2] = (uint8_t)(total >> 8); out[3] = (uint8_t)total;
+        out[4] = 0; out[5] = 0;                              /* identification */
+        out[6] = 0; out[7] = 0;                              /* flags + fragment offset */
+        out[8] = 64;                                         /* TTL */
+        out[9] = IP_PROTO_UDP;
+        out[10] = 0; out[11] = 0;
+        memcpy(out + 12, src_ip, 4);
+        memcpy(out + 16, dst_ip, 4);
+        /* 0 is a valid header checksum; no all-ones rule here. */
+        u16_t ip_chksum = inet_chksum(out, 20);
+        memcpy(out + 10, &ip_chksum, 2);
+    }
+
+    udp[0] = (uint8_t)(src_port >> 8); udp[1] = (uint8_t)src_port;
+    udp[2] = (uint8_t)(dst_port >> 8); udp[3] = (uint8_t)dst_port;
+    udp[4] = (uint8_t)(udp_len >> 8);  udp[5] = (uint8_t)udp_len;
+    udp[6] = 0; udp[7] = 0;
+    if (payload_len > 0) memcpy(udp + 8, payload, (size_t)payload_len);
+
+    /* Pseudo-header (RFC 768 / RFC 8200 §8.1) plus the segment; the sum is
+     * byte-order agnostic, so lwIP's host-order words fold straight in. The
+     * checksum is mandatory over IPv6 and 0 means "none" over IPv4, so a
+     * computed 0 goes out as all-ones. */
+    u32_t acc = partial_sum(src_ip, (u16_t)addr_len) + partial_sum(dst_ip, (u16_t)addr_len);
+    acc += lwip_htons(IP_PROTO_UDP) + lwip_htons((u16_t)udp_len);
+    acc += partial_sum(udp, (u16_t)udp_len);
+    acc = FOLD_U32T(acc);
+    acc = FOLD_U32T(acc);
+    u16_t udp_chksum = (u16_t)~acc;
+    if (udp_chksum == 0) udp_chksum = 0xFFFF;
+    memcpy(udp + 6, &udp_chksum, 2);
+
+    return total;
+}
+
+int icmp_port_unreachable_build(uint8_t *out, int is_ipv6,
+                                const void *src_ip, uint16_t src_port,
+                                const void *dst_ip, uint16_t dst_port,
+                                int udp_payload_len) {
+    int udp_len = 8 + udp_payload_len;
+    if (udp_payload_len < 0 || udp_len > 0xFFFF) return -1;
+
+    if (is_ipv6) {
+        int icmp_len = ICMP_PORT_UNREACHABLE_LEN_V6 - 40;
+        uint8_t *icmp = out + 40;
+        uint8_t *inner = icmp + 8;
+
+        /* Outer IPv6 header: from the unreachable destination back to the sender. */
+        out[0] = 0x60; out[1] = 0; out[2] = 0; out[3] = 0;
+        out[4] = (uint8_t)(icmp_len >> 8); out[5] = (uint8_t)icmp_len;
+        out[6] = IP6_NEXTH_ICMP6;
+        out[7] = 64;
+        memcpy(out + 8, dst_ip, 16);
+        memcpy(out + 24, src_ip, 16);
+
+        /* ICMPv6 Destination Unreachable (type 1), port unreachable (code 4). */
+        icmp[0] = 1; icmp[1] = 4;
+        memset(icmp + 2, 0, 6);
+
+        /* The offending datagram's IPv6 header and UDP header (RFC 4443 §3.1). */
+        inner[0] = 0x60; inner[1] = 0; inner[2] = 0; inner[3] = 0;
+        inner[4] = (uint8_t)(udp_len >> 8); inner[5] = (uint8_t)udp_len;
+        inner[6] = IP_PROTO_UDP;
+        inner[7] = 64;
+        memcpy(inner + 8, src_ip, 16);
+        memcpy(inner + 24, dst_ip, 16);
+        uint8_t *udp = inner + 40;
+        udp[0] = (uint8_t)(src_port >> 8); udp[1] = (uint8_t)src_port;
+        udp[2] = (uint8_t)(dst_port >> 8); udp[3] = (uint8_t)dst_port;
+        udp[4] = (uint8_t)(udp_len >> 8);  udp[5] = (uint8_t)udp_len;
+        udp[6] = 0; udp[7] = 0;
+
+        /* Pseudo-header (RFC 4443 §2.3) plus the message. */
+        u32_t acc = partial_sum(out + 8, 32);
+        acc += lwip_htons(IP6_NEXTH_ICMP6) + lwip_htons((u16_t)icmp_len);
+        acc += partial_sum(icmp, (u16_t)icmp_len);
+        acc = FOLD_U32T(acc);
+        acc = FOLD_U32T(acc);
+        u16_t icmp_chksum = (u16_t)~acc;
+        memcpy(icmp + 2, &icmp_chksum, 2);
+        return ICMP_PORT_UNREACHABLE_LEN_V6;
+    }
+
+    int total = ICMP_PORT_UNREACHABLE_LEN_V4;
+    uint8_t *icmp = out + 20;
+    uint8_t *inner = icmp + 8;
+    int inner_total = 20 + udp_len;
+    if (inner_total > 0xFFFF) return -1;
+
+    /* Outer IPv4 header: from the unreachable destination back to the sender. */
+    out[0] = 0x45; out[1] = 0;
+    out[2] = (uint8_t)(total >> 8); out[3] = (uint8_t)total;
+    out[4] = 0; out[5] = 0; out[6] = 0; out[7] = 0;
+    out[8] = 64;
+    out[9] = IP_PROTO_ICMP;
+    out[10] = 0; out[11] = 0;
+    memcpy(out + 12, dst_ip, 4);
+    memcpy(out + 16, src_ip, 4);
+    u16_t ip_chksum = inet_chksum(out, 20);
+    memcpy(out + 10, &ip_chksum, 2);
+
+    /* ICMP Destination Unreachable (type 3), port unreachable (code 3). */
+    icmp[0] = 3; icmp[1] = 3;
+    memset(icmp + 2, 0, 6);
+
+    /* The offending datagram's IPv4 header and first 8 bytes (RFC 792). Its
+     * header checksum is left 0; receivers match on addresses and ports. */
+    inner[0] = 0x45; inner[1] = 0;
+    inner[2] = (uint8_t)(inner_total >> 8); inner[3] = (uint8_t)inner_total;
+    inner[4] = 0; inner[5] = 0; inner[6] = 0; inner[7] = 0;
+    inner[8] = 64;
+    inner[9] = IP_PROTO_UDP;
+    inner[10] = 0; inner[11] = 0;
+    memcpy(inner + 12, src_ip, 4);
+    memcpy(inner + 16, dst_ip, 4);
+    uint8_t *udp = inner + 20;
+    udp[0] = (uint8_t)(src_port >> 8); udp[1] = (uint8_t)src_port;
+    udp[2] = (uint8_t)(dst_port >> 8); udp[3] = (uint8_t)dst_port;
+    udp[4] = (uint8_t)(udp_len >> 8);  udp[5] = (uint8_t)udp_len;
+    udp[6] = 0; udp[7] = 0;
+
+    /* ICMPv4 covers only the message, not the addresses. */
+    u16_t icmp_chksum = inet_chksum(icmp, (u16_t)(total - 20));
+    memcpy(icmp + 2, &icmp_chksum, 2);
+    return total;
+}
@@ -0,0 +1,55 @@
+#ifndef UDP_PACKET_H
+#define UDP_PACKET_H
+
+#include <stdint.h>
+
+/* Outbound IP+UDP and ICMP packet builders for the Swift UDP path (lwIP is
+ * built LWIP_UDP 0, so it never builds these itself). Checksums use the NEON
+ * sum in packet_checksum.h. Unlike the bridge, nothing here touches lwIP
+ * state: every function is callable from any queue. */
+
+#define UDP_PACKET_HLEN_V4 28 /* IPv4 (20) + UDP (8) */
+#define UDP_PACKET_HLEN_V6 48 /* IPv6 (40) + UDP (8) */
+
+/* Pooled buffers hold packets up to these sizes: a full datagram at the
+ * standard 1500 MTU, and one at the largest jumbo TunnelMTU. Larger ones are
+ * malloc'd individually. */
+#define UDP_PACKET_POOLED_SIZE 2048
+#define UDP_PACKET_POOLED_JUMBO_SIZE 16384
+
+/* Returns a buffer of at least `len` bytes, or NULL. Thread-safe. */
+void *udp_packet_buffer_alloc(int len);
+
+/* Returns a buffer from `udp_packet_buffer_alloc` to the pool. Thread-safe. */
+void udp_packet_buffer_free(void *buf);
+
+/* Frees every pooled buffer not in use; the pools refill on demand. Thread-safe. */
+void udp_packet_buffer_trim(void);
+
+/* Writes a complete IPv4/IPv6 UDP packet into `out`: header, `payload`
+ * (`payload_len` bytes, copied in), and both checksums. `src_ip`/`dst_ip` are
+ * 4 or 16 raw bytes, ports are host order. `out` must hold
+ * UDP_PACKET_HLEN_V4/V6 + `payload_len` bytes. Returns the packet length, or
+ * -1 if the datagram would exceed 65535 bytes of UDP. */
+int udp_packet_build(uint8_t *out, int is_ipv6,
+                     const void *src_ip, uint16_t src_port,
+                     const void *dst_ip, uint16_t dst_port,
+                     const void *payload, int payload_len);
+
+/* ICMP port-unreachable replies: outer IP (20 / 40) + ICMP header (8) +
+ * the offending IP header (20 / 40) + its UDP header (8). */
+#define ICMP_PORT_UNREACHABLE_LEN_V4 56
+#define ICMP_PORT_UNREACHABLE_LEN_V6 96
+
+/* Writes an ICMPv4 type 3 code 3 / ICMPv6 type 1 code 4 reply to a UDP
+ * datagram from `src_ip`:`src_port` to `dst_ip`:`dst_port` carrying
+ * `udp_payload_len` bytes. The reply comes from `dst_ip` and quotes the
+ * datagram's reconstructed IP and UDP headers. `out` must hold
+ * ICMP_PORT_UNREACHABLE_LEN_V4/V6 bytes. Returns the packet length, or -1 if
+ * the quoted datagram would exceed 65535 bytes. */
+int icmp_port_unreachable_build(uint8_t *out, int is_ipv6,
+                                const void *src_ip, uint16_t src_port,
+                                const void *dst_ip, uint16_t dst_port,
+                                int udp_payload_len);
+
+#endif /* UDP_PACKET_H */
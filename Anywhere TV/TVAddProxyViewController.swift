@@ -211,6 +211,12 @@ class TVAddProxyViewController: UITableViewController {
     private func importFromString(_ string: String) {
         let trimmed = string.trimmingCharacters(in: .whitespacesAndNewlines)
 
+        // A pasted list of links imports as a batch.
+        if trimmed.contains(where: \.isNewline) {
+            importLinks(trimmed)
+            return
+        }
+
         // Only schemes the parser knows take the proxy-link path;
         // everything else is treated as a subscription URL.
         if ProxyConfiguration.canParseURL(trimmed) {
@@ -247,6 +253,22 @@ class TVAddProxyViewController: UITableViewController {
         }
     }
 
+    private func importLinks(_ text: String) {
+        isLoading = true
+        updateContinueButton()
+        Task {
+            let configurations = await ShareLinkBatchParser.parse(text)
+            if let first = configurations.first {
+                ConfigurationStore.shared.add(contentsOf: configurations); self.viewModel.selectIfNone(first)
+                dismiss(animated: true)
+            } else {
+                showError(String(localized: "No valid proxy links found."))
+            }
+            isLoading = false
+            updateContinueButton()
+        }
+    }
+
     private func showError(_ message: String) {
         let alert = UIAlertController(title: String(localized: "Import Failed"), message: message, preferredStyle: .alert)
         alert.addAction(UIAlertAction(title: String(localized: "OK"), style: .cancel))
@@ -13,6 +13,8 @@ class TVProxyCell: UITableViewCell {
 
     private let nameLabel = UILabel()
     private let checkmarkView = UIImageView()
+    private let degradedView = UIImageView()
+    private let connectLabel = UILabel()
 
     // Tags: protocol, transport, security, vision
     private let tagsRow = UIStackView()
@@ -59,6 +61,13 @@ class TVProxyCell: UITableViewCell {
         checkmarkView.setContentHuggingPriority(.required, for: .horizontal)
         nameRow.addArrangedSubview(checkmarkView)
 
+        let degradedConfig = UIImage.SymbolConfiguration(pointSize: 24, weight: .medium)
+        degradedView.image = UIImage(systemName: "exclamationmark.triangle.fill", withConfiguration: degradedConfig)
+        degradedView.tintColor = .systemOrange
+        degradedView.accessibilityLabel = String(localized: "Failing on live traffic")
+        degradedView.setContentHuggingPriority(.required, for: .horizontal)
+        nameRow.addArrangedSubview(degradedView)
+
         vStack.addArrangedSubview(nameRow)
 
         tagsRow.axis = .horizontal
@@ -86,6 +95,10 @@ class TVProxyCell: UITableViewCell {
             tagContainers.append((container, label))
         }
 
+        connectLabel.font = .monospacedDigitSystemFont(ofSize: 20, weight: .medium)
+        connectLabel.textColor = .secondaryLabel
+        tagsRow.addArrangedSubview(connectLabel)
+
         vStack.addArrangedSubview(tagsRow)
     }
 
@@ -94,6 +107,7 @@ class TVProxyCell: UITableViewCell {
     func configure(_ item: ProxyListItem) {
         nameLabel.text = item.name
         checkmarkView.isHidden = !item.isSelected
+        degradedView.isHidden = item.health?.isDegraded != true
 
         let tags = item.tags
         for (index, pair) in tagContainers.enumerated() {
@@ -105,6 +119,13 @@ class TVProxyCell: UITableViewCell {
             }
         }
 
+        if let connectMs = item.health?.connectMs {
+            connectLabel.text = String(localized: "Connect \(connectMs) ms")
+            connectLabel.isHidden = false
+        } else {
+            connectLabel.isHidden = true
+        }
+
         applyLatency(item.latency)
     }
 
@@ -44,7 +44,17 @@ class TVProxyListViewController: UITableViewController {
         collapsedSubscriptions = Set(SubscriptionStore.shared.subscriptions.filter(\.collapsed).map(\.id))
         configureDataSource()
     }
-    
+
+    override func viewWillAppear(_ animated: Bool) {
+        super.viewWillAppear(animated)
+        NodeHealthModel.shared.startPolling()
+    }
+
+    override func viewDidDisappear(_ animated: Bool) {
+        super.viewDidDisappear(animated)
+        NodeHealthModel.shared.stopPolling()
+    }
+
     override func updateProperties() {
         super.updateProperties()
         applySnapshot()
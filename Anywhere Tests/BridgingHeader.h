@@ -0,0 +1,19 @@
+//
+//  BridgingHeader.h
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+#ifndef BridgingHeader_h
+#define BridgingHeader_h
+
+#include "../Anywhere Network Extension/lwip/lwip_bridge.h"
+#include "../Anywhere Network Extension/lwip/udp_packet.h"
+#include "arch/mem_slab.h"
+#include "ngtcp2_bridge.h"
+#include "blake2.h"
+#include "blake3.h"
+#include "yaml.h"
+
+#endif /* BridgingHeader_h */
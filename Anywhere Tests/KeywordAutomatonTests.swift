@@ -0,0 +1,84 @@
+//
+//  KeywordAutomatonTests.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Testing
+import Foundation
+@testable import Anywhere
+
+/// The trigram prefilter in front of ``KeywordAutomatonView`` may only reject hosts that
+/// contain no keyword. Keyword rules are compiled into an image on their own, and every
+/// host must match exactly when a brute-force substring scan says it does.
+struct KeywordAutomatonTests {
+
+    /// One- and two-byte keywords sit below the trigram width and are probed separately.
+    private static let shortKeywords = ["x", "q", "-", "ad", "zz", "é"]
+    private static let longKeywords = ["cdn", "ads", "track", "analytics", "xn--", "中国", "例子"]
+    private static let alphabet: [String] = ["a", "b", "c", "d", "e", "q", "x", "z", "s", "n", "-", ".", "é", "中", "国", "例"]
+
+    private struct KeywordImage {
+        let image: RoutingImage
+
+        /// The tier's keywords all route to `.reject`, so any match is a non-nil lookup.
+        init?(keywords: [String]) {
+            let entry = RoutingPayload.Entry(tier: .user, target: .reject,
+                                             rules: keywords.map { RoutingRule(type: .domainKeyword, value: $0) })
+            guard let image = RoutingPayload.image([entry]) else { return nil }
+            self.image = image
+        }
+
+        func matches(_ host: String) -> Bool {
+            var host = host
+            return host.withUTF8 { image.lookupDomain($0) } != nil
+        }
+    }
+
+    private func expectMatchesBruteForce(keywords: [String], extraHosts: [String] = [], seed: UInt64) throws {
+        let automaton = try #require(KeywordImage(keywords: keywords))
+        var generator = SeededGenerator(seed: seed)
+        func random(_ length: ClosedRange<Int>) -> String {
+            (0..<Int.random(in: length, using: &generator)).map { _ in Self.alphabet.randomElement(using: &generator)! }.joined()
+        }
+
+        var hosts = extraHosts + ["", "a", "ab", "abc"]
+        for keyword in keywords {
+            hosts.append(keyword)
+            hosts.append("\(keyword)\(random(1...12))")
+            hosts.append("\(random(1...12))\(keyword)")
+            hosts.append("\(random(0...6))\(keyword)\(random(0...6))")
+            hosts.append(String(keyword.dropLast()))
+            hosts.append(String(keyword.dropFirst()))
+        }
+        for _ in 0..<3000 { hosts.append(random(0...24)) }
+
+        for host in hosts {
+            #expect(automaton.matches(host) == keywords.contains { host.contains($0) }, "keyword match differs for \(host)")
+        }
+    }
+
+    @Test func shortKeywordsMatchLikeBruteForce() throws {
+        try expectMatchesBruteForce(keywords: Self.shortKeywords, seed: 1)
+    }
+
+    @Test func longKeywordsMatchLikeBruteForce() throws {
+        try expectMatchesBruteForce(keywords: Self.longKeywords, extraHosts: ["cd", "track.example", "example.track"], seed: 2)
+    }
+
+    @Test func mixedKeywordsMatchLikeBruteForce() throws {
+        try expectMatchesBruteForce(keywords: Self.shortKeywords + Self.longKeywords,
+                                    extraHosts: ["x.example.com", "example.com.x", "adserver", "server.ad"], seed: 3)
+    }
+
+    @Test func randomKeywordSetsMatchLikeBruteForce() throws {
+        var generator = SeededGenerator(seed: 143)
+        let pool = Self.shortKeywords + Self.longKeywords
+        for round in 0..<16 {
+            let keywords = pool.filter { _ in Bool.random(using: &generator) }
+            guard !keywords.isEmpty else { continue }
+            try expectMatchesBruteForce(keywords: keywords, seed: 1000 + UInt64(round))
+        }
+    }
+}
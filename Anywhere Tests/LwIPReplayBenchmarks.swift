@@ -0,0 +1,64 @@
+//
+//  LwIPReplayBenchmarks.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import XCTest
+import Foundation
+@testable import Anywhere
+
+/// Packet-path numbers for the lwIP bridge without a device network: ``LwIPReplay`` feeds
+/// a capture (`ANYWHERE_REPLAY_PCAP`, or the synthetic bulk upload) through
+/// `lwip_bridge_input` against loopback echo connections. Run before and after a bridge or
+/// lwIP patch on the same device and capture; the report is attached to the test result.
+final class LwIPReplayBenchmarks: XCTestCase {
+
+    private let options: XCTMeasureOptions = {
+        let options = XCTMeasureOptions()
+        options.iterationCount = 10
+        return options
+    }()
+
+    private func capture() throws -> [Data] {
+        if let path = TestEnvironment.replayCapturePath {
+            return try PcapCapture.packets(contentsOf: URL(fileURLWithPath: path))
+        }
+        // Round-trip through the pcap encoding so the synthetic path reads what a file would.
+        return try PcapCapture.packets(in: PcapCapture.encode(SyntheticCapture.bulkUpload()))
+    }
+
+    func testReplayReport() throws {
+        let replay = LwIPReplay(packets: try capture())
+        // The first run warms the slab, so the second shows steady-state allocations.
+        _ = replay.run()
+        let report = replay.run()
+        let attachment = XCTAttachment(string: report.description)
+        attachment.name = "LwIPReplay report"
+        attachment.lifetime = .keepAlways
+        add(attachment)
+        XCTAssertGreaterThan(report.packets, 0)
+        XCTAssertGreaterThan(report.outputPackets, 0)
+        if TestEnvironment.replayCapturePath == nil {
+            XCTAssertEqual(report.skipped, 0)
+            XCTAssertGreaterThan(report.echoedBytes, 0)
+        }
+    }
+
+    func testReplayThroughput() throws {
+        let replay = LwIPReplay(packets: try capture())
+        _ = replay.run()
+        measure(metrics: [XCTClockMetric()], options: options) {
+            _ = replay.run()
+        }
+    }
+
+    func testReplayWithoutBatching() throws {
+        let replay = LwIPReplay(packets: try capture(), batchSize: 1)
+        _ = replay.run()
+        measure(metrics: [XCTClockMetric()], options: options) {
+            _ = replay.run()
+        }
+    }
+}
@@ -0,0 +1,178 @@
+//
+//  ProtocolBenchmarks.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import XCTest
+import Foundation
+@testable import Anywhere
+
+/// Hot-path micro-benchmarks over fixed `DeterministicBytes` inputs. Each `measure` block
+/// does a fixed amount of work, so Xcode baselines (set per device from the test report)
+/// turn a slowdown into a local failure. DomainRouter lives outside the app module and isn't
+/// reachable from here; the lwIP bridge is compiled into this target for
+/// ``LwIPReplayBenchmarks``.
+final class ProtocolBenchmarks: XCTestCase {
+
+    /// One full TLS record's worth of plaintext per seal/open.
+    private static let record = DeterministicBytes.generate(seed: 1, count: 16_384)
+    /// Enough records per iteration to dominate timer noise.
+    private static let iterations = 256
+
+    private let options: XCTMeasureOptions = {
+        let options = XCTMeasureOptions()
+        options.iterationCount = 10
+        return options
+    }()
+
+    // MARK: - TLS
+
+    func testTLSRecordSealAESGCM() throws {
+        try measureTLSSeal(cipherSuite: 0x1301)
+    }
+
+    func testTLSRecordSealChaCha20() throws {
+        try measureTLSSeal(cipherSuite: 0x1303)
+    }
+
+    func testTLSRecordOpenAESGCM() throws {
+        let cipher = TLSTrafficCipher(
+            cipherSuite: 0x1301,
+            key: DeterministicBytes.generate(seed: 2, count: 16),
+            iv: DeterministicBytes.generate(seed: 3, count: 12))
+        let aad = Data([0x17, 0x03, 0x03, 0x40, 0x11])
+        var sealed: [Data] = []
+        for counter in 0..<Self.iterations {
+            var out = Data()
+            try cipher.seal(Self.record, counter: UInt64(counter), aad: aad, appendingTo: &out)
+            sealed.append(out)
+        }
+        measure(metrics: [XCTClockMetric()], options: options) {
+            for (counter, box) in sealed.enumerated() {
+                let tagStart = box.endIndex - 16
+                _ = try? cipher.open(ciphertext: box[..<tagStart], tag: box[tagStart...],
+                                     counter: UInt64(counter), aad: aad)
+            }
+        }
+    }
+
+    private func measureTLSSeal(cipherSuite: UInt16) throws {
+        let cipher = TLSTrafficCipher(
+            cipherSuite: cipherSuite,
+            key: DeterministicBytes.generate(seed: 2, count: 32).prefix(cipherSuite == 0x1301 ? 16 : 32),
+            iv: DeterministicBytes.generate(seed: 3, count: 12))
+        let aad = Data([0x17, 0x03, 0x03, 0x40, 0x11])
+        var out = Data(capacity: Self.record.count + 16)
+        measure(metrics: [XCTClockMetric()], options: options) {
+            for counter in 0..<Self.iterations {
+                out.removeAll(keepingCapacity: true)
+                try? cipher.seal(Self.record, counter: UInt64(counter), aad: aad, appendingTo: &out)
+            }
+        }
+    }
+
+    // MARK: - Shadowsocks
+
+    func testShadowsocksAEADChunking() {
+        let subkey = DeterministicBytes.generate(seed: 4, count: 32)
+        let payload = DeterministicBytes.generate(seed: 5, count: 256 * 1024)
+        var out = Data()
+        measure(metrics: [XCTClockMetric()], options: options) {
+            var cipher = ShadowsocksChunkCipher(cipher: .aes256gcm, subkey: subkey)
+            out.removeAll(keepingCapacity: true)
+            try? cipher.sealChunks(payload, maxPayloadSize: 0x3FFF, appendingTo: &out)
+        }
+    }
+
+    // MARK: - Vision
+
+    func testVisionPaddingRoundTrip() {
+        let uuid = DeterministicBytes.generate(seed: 6, count: 16)
+        let payload = DeterministicBytes.generate(seed: 7, count: 64 * 1024)
+        var ranges: [Range<Int>] = []
+        payload.withUnsafeBytes { raw in
+            reshapeRanges(raw.bindMemory(to: UInt8.self), 0..<payload.count, into: &ranges)
+        }
+        let frames = ranges.map { VisionFrame(content: $0, command: .paddingContinue, longPadding: true) }
+        measure(metrics: [XCTClockMetric()], options: options) {
+            for _ in 0..<32 {
+                let writer = VisionTrafficState(userUUID: uuid)
+                var padded = visionPadding(payload, frames: frames, state: writer)
+                let reader = VisionTrafficState(userUUID: uuid)
+                _ = visionUnpadding(data: &padded, state: reader)
+            }
+        }
+    }
+
+    // MARK: - WebSocket
+
+    func testWebSocketMasking() {
+        var payload = DeterministicBytes.generate(seed: 8, count: 1 << 20)
+        measure(metrics: [XCTClockMetric()], options: options) {
+            for key: UInt32 in 0..<16 {
+                payload.withUnsafeMutableBytes { WebSocketMaskKeys.apply(0x9E37_79B9 &* (key + 1), to: $0) }
+            }
+        }
+    }
+
+    // MARK: - Sudoku
+
+    func testSudokuEncodeDecode() throws {
+        let pair = try SudokuTablePair(key: "benchmark", asciiMode: "prefer_entropy",
+                                       customUplink: "", customDownlink: "")
+        let payload = DeterministicBytes.generate(seed: 9, count: 32 * 1024)
+        measure(metrics: [XCTClockMetric()], options: options) {
+            var rng = SudokuXorshift64Star(seed: 42)
+            let encoded = pair.uplink.encode(payload, rng: &rng, paddingThreshold: 0)
+            var decoder = SudokuPureDecoder()
+            _ = try? decoder.decode(encoded, table: pair.uplink, limit: payload.count)
+        }
+    }
+
+    // MARK: - Salamander
+
+    func testSalamanderSealOpen() {
+        let obfuscator = SalamanderObfuscator(password: "benchmark")
+        let packet = DeterministicBytes.generate(seed: 10, count: 1200)
+        var wire = [UInt8](repeating: 0, count: 1200 + SalamanderObfuscator.saltLength)
+        var plain = [UInt8](repeating: 0, count: 1200)
+        measure(metrics: [XCTClockMetric()], options: options) {
+            packet.withUnsafeBytes { packet in
+                wire.withUnsafeMutableBytes { wire in
+                    plain.withUnsafeMutableBytes { plain in
+                        for _ in 0..<4096 {
+                            guard let sealed = obfuscator.seal(packet, into: wire) else { return }
+                            _ = obfuscator.open(UnsafeRawBufferPointer(rebasing: wire[..<sealed]), into: plain)
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // MARK: - Hashing
+
+    func testBLAKE2bHashing() {
+        let input = DeterministicBytes.generate(seed: 11, count: 1 << 20)
+        measure(metrics: [XCTClockMetric()], options: options) {
+            for _ in 0..<8 {
+                var hasher = BLAKE2bHasher()
+                hasher.update(input)
+                _ = hasher.finalize()
+            }
+        }
+    }
+
+    func testBLAKE3Hashing() {
+        let input = DeterministicBytes.generate(seed: 12, count: 1 << 20)
+        measure(metrics: [XCTClockMetric()], options: options) {
+            for _ in 0..<8 {
+                var hasher = BLAKE3Hasher()
+                hasher.update(input)
+                _ = hasher.finalizeData()
+            }
+        }
+    }
+}
@@ -0,0 +1,258 @@
+//
+//  RoutingImageTests.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Testing
+import Foundation
+@testable import Anywhere
+
+/// A compiled ``RoutingImage`` must answer every lookup the way the rules read: the first
+/// tier with a match wins, and within a tier a suffix beats a keyword. The image prunes,
+/// merges tiers and rules out hosts with ``DomainSuffixFilter`` before walking the suffix
+/// trie; the reference here does none of that, so a pruned rule that mattered or a false
+/// negative from the filter shows up as a differing probe.
+struct RoutingImageTests {
+
+    private static let proxyA = RouteTarget.proxy(UUID(uuidString: "6F1D2C43-7C4B-4E0A-9C31-2D6B5A1E0F01")!)
+    private static let proxyB = RouteTarget.proxy(UUID(uuidString: "0B6F8E2A-3D41-4C77-8F10-9A2E4C6D8B02")!)
+
+    private static let labels = ["com", "net", "cn", "example", "Example", "www", "WWW", "api", "cdn", "ads", "a", "b",
+                                 "xn--fiqs8s", "XN--55QX5D", "中国", "例子", "bücher", "BÜCHER"]
+    private static let keywordPool = ["a", "x", "ad", "ds", "cdn", "ads", "track", "xn--", "例", "中国", "mple", "WW"]
+
+    // MARK: - Reference
+
+    /// Resolves straight from the rules: plain `insert`/`freeze` suffix tries, one per
+    /// tier, and brute-force keyword and CIDR matching.
+    private struct Reference {
+        private var suffixTries = [FlatLabelTrie<RouteTarget>](repeating: FlatLabelTrie(), count: RoutingCompiler.tierCount)
+        private var keywords = [[(pattern: [UInt8], target: RouteTarget)]](repeating: [], count: RoutingCompiler.tierCount)
+        private var ipv4Rules = [[(network: UInt32, length: Int, target: RouteTarget)]](repeating: [], count: RoutingCompiler.tierCount)
+        private var ipv6Rules = [[(hi: UInt64, lo: UInt64, length: Int, target: RouteTarget)]](repeating: [], count: RoutingCompiler.tierCount)
+
+        init(_ entries: [RoutingPayload.Entry]) {
+            for entry in entries {
+                let t = Int(entry.tier.rawValue)
+                for rule in entry.rules {
+                    switch rule.type {
+                    case .domainSuffix:
+                        suffixTries[t].insert(suffix: rule.value.lowercased(), payload: entry.target)
+                    case .domainKeyword:
+                        if !rule.value.isEmpty { keywords[t].append((Array(rule.value.lowercased().utf8), entry.target)) }
+                    case .ipCIDR:
+                        let parts = rule.value.split(separator: "/")
+                        let length = Int(parts[1])!
+                        ipv4Rules[t].append((RoutingImageTests.mask(RoutingCompiler.parseIPv4(String(parts[0]))!, length), length, entry.target))
+                    case .ipCIDR6:
+                        let parts = rule.value.split(separator: "/")
+                        let length = Int(parts[1])!
+                        var address = in6_addr()
+                        let parsed = inet_pton(AF_INET6, String(parts[0]), &address)
+                        #expect(parsed == 1)
+                        let (hi, lo) = withUnsafeBytes(of: &address) { CIDRv6Trie.pack16($0.bindMemory(to: UInt8.self)) }
+                        let masked = RoutingImageTests.mask(hi, lo, length)
+                        ipv6Rules[t].append((masked.hi, masked.lo, length, entry.target))
+                    }
+                }
+            }
+            for t in suffixTries.indices { suffixTries[t].freeze() }
+        }
+
+        func domain(_ host: String) -> RouteTarget? {
+            var host = host
+            let bytes = Array(host.utf8)
+            for t in 0..<RoutingCompiler.tierCount {
+                if let target = host.withUTF8({ suffixTries[t].lookup($0) }) { return target }
+                // Longest keyword wins; of equal lengths, the later one.
+                var best: (length: Int, target: RouteTarget)?
+                for keyword in keywords[t] where keyword.pattern.count >= (best?.length ?? 0)
+                    && bytes.firstRange(of: keyword.pattern) != nil {
+                    best = (keyword.pattern.count, keyword.target)
+                }
+                if let best { return best.target }
+            }
+            return nil
+        }
+
+        /// Most specific prefix of the first tier that covers `address`; a repeated prefix, its last rule.
+        func ipv4(_ address: UInt32) -> RouteTarget? {
+            for rules in ipv4Rules {
+                var best: (length: Int, target: RouteTarget)?
+                for rule in rules where rule.length >= (best?.length ?? 0) && RoutingImageTests.mask(address, rule.length) == rule.network {
+                    best = (rule.length, rule.target)
+                }
+                if let best { return best.target }
+            }
+            return nil
+        }
+
+        func ipv6(hi: UInt64, lo: UInt64) -> RouteTarget? {
+            for rules in ipv6Rules {
+                var best: (length: Int, target: RouteTarget)?
+                for rule in rules where rule.length >= (best?.length ?? 0) {
+                    let masked = RoutingImageTests.mask(hi, lo, rule.length)
+                    if masked.hi == rule.hi && masked.lo == rule.lo { best = (rule.length, rule.target) }
+                }
+                if let best { return best.target }
+            }
+            return nil
+        }
+    }
+
+    private static func mask(_ address: UInt32, _ length: Int) -> UInt32 {
+        length == 0 ? 0 : address & (~UInt32(0) << (32 - length))
+    }
+
+    private static func mask(_ hi: UInt64, _ lo: UInt64, _ length: Int) -> (hi: UInt64, lo: UInt64) {
+        if length == 0 { return (0, 0) }
+        if length <= 64 { return (hi & (~UInt64(0) << (64 - length)), 0) }
+        return (hi, lo & (~UInt64(0) << (128 - length)))
+    }
+
+    private static func ipv4String(_ address: UInt32) -> String {
+        "\(address >> 24).\(address >> 16 & 0xFF).\(address >> 8 & 0xFF).\(address & 0xFF)"
+    }
+
+    private static func ipv6String(hi: UInt64, lo: UInt64) -> String {
+        (0..<8).map { i in
+            let half = i < 4 ? hi : lo
+            return String(half >> UInt64(48 - 16 * (i % 4)) & 0xFFFF, radix: 16)
+        }.joined(separator: ":")
+    }
+
+    // MARK: - Checks
+
+    private func expectMatchesReference(_ entries: [RoutingPayload.Entry], hosts: [String],
+                                        ipv4: [UInt32] = [], ipv6: [(hi: UInt64, lo: UInt64)] = []) throws {
+        let image = try #require(RoutingPayload.image(entries))
+        let reference = Reference(entries)
+        for probe in hosts {
+            // Lowercased as DomainRouter lowercases before the lookup.
+            var host = probe.lowercased()
+            let found = host.withUTF8 { image.lookupDomain($0) }
+            #expect(found == reference.domain(host), "domain lookup differs for \(probe)")
+        }
+        for address in ipv4 {
+            #expect(image.lookupIPv4(address) == reference.ipv4(address), "IPv4 lookup differs for \(Self.ipv4String(address))")
+        }
+        for address in ipv6 {
+            #expect(image.lookupIPv6(hi: address.hi, lo: address.lo) == reference.ipv6(hi: address.hi, lo: address.lo),
+                    "IPv6 lookup differs for \(Self.ipv6String(hi: address.hi, lo: address.lo))")
+        }
+    }
+
+    private static func rules(_ type: RoutingRuleType, _ values: [String]) -> [RoutingRule] {
+        values.map { RoutingRule(type: type, value: $0) }
+    }
+
+    @Test func tiersSuffixesAndKeywordsResolveInPriorityOrder() throws {
+        let entries: [RoutingPayload.Entry] = [
+            .init(tier: .user, target: .direct, rules: Self.rules(.domainSuffix, ["Example.com", "例子.中国"])
+                  + Self.rules(.ipCIDR, ["10.1.0.0/16"])),
+            .init(tier: .user, target: Self.proxyA, rules: Self.rules(.domainKeyword, ["track"])
+                  + Self.rules(.domainSuffix, ["api.example.com", "xn--fiqs8s"])),
+            .init(tier: .adBlock, target: .reject, rules: Self.rules(.domainKeyword, ["ads"])
+                  + Self.rules(.domainSuffix, ["ads.example.net", "ads.example.com", "bücher.de"])
+                  + Self.rules(.ipCIDR, ["10.0.0.0/8", "10.1.2.0/24"])
+                  + Self.rules(.ipCIDR6, ["2001:db8::/32"])),
+            .init(tier: .builtIn, target: .direct, rules: Self.rules(.domainSuffix, ["net", "cn"])
+                  + Self.rules(.ipCIDR6, ["2001:db8:1::/48", "::/0"])),
+            .init(tier: .builtIn, target: Self.proxyB, rules: Self.rules(.domainSuffix, ["EXAMPLE.NET", "www.example.net"])
+                  + Self.rules(.domainKeyword, ["xn--"])),
+            .init(tier: .bypass, target: .direct, rules: Self.rules(.ipCIDR, ["0.0.0.0/0"])),
+        ]
+        let hosts = [
+            "example.com", "EXAMPLE.COM", "ads.example.com", "tracker.example.com", "API.example.com",
+            "x.api.example.com", "notexample.com", "tracker.org", "ads.example.net", "x.ads.example.net",
+            "example.net", "www.example.net", "cdn.example.net", "foo.net", "foo.cn", "xn--fiqs8s", "a.xn--fiqs8s",
+            "xn--55qx5d.com", "例子.中国", "www.例子.中国", "中国", "BÜCHER.de", "www.bücher.de", "", ".", "..",
+        ]
+        let ipv4 = [0x0A01_0203, 0x0A01_0000, 0x0A02_0000, 0x0A01_02FF, 0x0A01_0300, 0xC0A8_0001] as [UInt32]
+        let ipv6: [(hi: UInt64, lo: UInt64)] = [
+            (0x2001_0DB8_0000_0000, 1), (0x2001_0DB8_0001_0000, 0), (0x2001_0DB8_0001_FFFF, .max), (0x2001_0DB9_0000_0000, 0),
+        ]
+        try expectMatchesReference(entries, hosts: hosts, ipv4: ipv4, ipv6: ipv6)
+
+        let image = try #require(RoutingPayload.image(entries))
+        func domain(_ host: String) -> RouteTarget? {
+            var host = host
+            return host.withUTF8 { image.lookupDomain($0) }
+        }
+        #expect(domain("ads.example.com") == .direct)           // user suffix beats ad-block keyword and suffix
+        #expect(domain("tracker.example.com") == .direct)       // own tier: suffix beats keyword
+        #expect(domain("tracker.org") == Self.proxyA)
+        #expect(domain("x.ads.example.net") == .reject)         // ad-block beats a built-in suffix
+        #expect(domain("www.example.net") == Self.proxyB)
+        #expect(domain("foo.net") == .direct)
+        #expect(domain("xn--55qx5d.com") == Self.proxyB)
+        #expect(image.lookupIPv4(0x0A01_0203) == .direct)       // user /16 beats ad-block /24
+        #expect(image.lookupIPv4(0x0A02_0000) == .reject)
+        #expect(image.lookupIPv6(hi: 0x2001_0DB8_0001_0000, lo: 0) == .reject)
+        #expect(image.lookupIPv6(hi: 0x2001_0DB9_0000_0000, lo: 0) == .direct)
+    }
+
+    @Test func randomRuleSetsResolveLikeTheirRules() throws {
+        var generator = SeededGenerator(seed: 109)
+        let targets: [RouteTarget] = [.direct, .reject, Self.proxyA, Self.proxyB]
+        func domain(_ labelCount: ClosedRange<Int>) -> String {
+            (0..<Int.random(in: labelCount, using: &generator))
+                .map { _ in Self.labels.randomElement(using: &generator)! }
+                .joined(separator: ".")
+        }
+        func scrambledCase(_ host: String) -> String {
+            host.map { Bool.random(using: &generator) ? $0.uppercased() : String($0) }.joined()
+        }
+
+        // The last round is large enough for the suffix filter to span many blocks.
+        for suffixCount in [40, 200, 200, 5000] {
+            var entries: [RoutingPayload.Entry] = []
+            var suffixes: [String] = []
+            var ipv4Rules: [UInt32] = []
+            var ipv6Rules: [(hi: UInt64, lo: UInt64)] = []
+            for tier in [RoutingBinaryFormat.Tier.user, .adBlock, .builtIn, .bypass] {
+                for target in targets.shuffled(using: &generator).prefix(3) {
+                    let tierSuffixes = (0..<(suffixCount / 12)).map { _ in domain(1...4) }
+                    suffixes += tierSuffixes
+                    let keywords = (0..<Int.random(in: 0...2, using: &generator)).map { _ in
+                        Self.keywordPool.randomElement(using: &generator)!
+                    }
+                    let v4 = (0..<20).map { _ -> (UInt32, Int) in
+                        (0x0A00_0000 | UInt32.random(in: 0..<(1 << 18), using: &generator), Int.random(in: 10...32, using: &generator))
+                    }
+                    let v6 = (0..<20).map { _ -> (UInt64, UInt64, Int) in
+                        (0x2001_0DB8_0000_0000 | UInt64.random(in: 0..<16, using: &generator),
+                         UInt64.random(in: .min ... .max, using: &generator), Int.random(in: 28...80, using: &generator))
+                    }
+                    ipv4Rules += v4.map { $0.0 }
+                    ipv6Rules += v6.map { ($0.0, $0.1) }
+                    entries.append(.init(tier: tier, target: target,
+                                         rules: Self.rules(.domainSuffix, tierSuffixes)
+                                            + Self.rules(.domainKeyword, keywords)
+                                            + Self.rules(.ipCIDR, v4.map { "\(Self.ipv4String($0.0))/\($0.1)" })
+                                            + Self.rules(.ipCIDR6, v6.map { "\(Self.ipv6String(hi: $0.0, lo: $0.1))/\($0.2)" })))
+                }
+            }
+
+            var hosts: [String] = []
+            for suffix in suffixes {
+                hosts.append(scrambledCase(suffix))
+                hosts.append("\(domain(1...2)).\(suffix)")
+                hosts.append("\(Self.labels.randomElement(using: &generator)!)\(suffix)")
+            }
+            for _ in 0..<2000 { hosts.append(scrambledCase(domain(1...6))) }
+
+            var ipv4 = ipv4Rules.flatMap { [$0, $0 &- 1, $0 &+ 1] }
+            for _ in 0..<2000 { ipv4.append(UInt32.random(in: 0x0900_0000...0x0B00_0000, using: &generator)) }
+            var ipv6 = ipv6Rules
+            for _ in 0..<2000 {
+                ipv6.append((0x2001_0DB8_0000_0000 | UInt64.random(in: 0..<32, using: &generator),
+                             UInt64.random(in: .min ... .max, using: &generator)))
+            }
+
+            try expectMatchesReference(entries, hosts: hosts, ipv4: ipv4, ipv6: ipv6)
+        }
+    }
+}
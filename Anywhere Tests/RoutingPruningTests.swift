@@ -0,0 +1,299 @@
+//
+//  RoutingPruningTests.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Testing
+import Foundation
+@testable import Anywhere
+
+/// Pruning a tier's rules must never change a lookup. Each test resolves the same probes
+/// against a matcher built from every rule and one built from the pruned rules, and
+/// expects the same answer for every probe.
+struct RoutingPruningTests {
+
+    // MARK: - Suffix rules
+
+    private static let labels = ["com", "net", "cn", "example", "Example", "www", "WWW", "api", "cdn", "a", "b",
+                                 "xn--fiqs8s", "XN--55QX5D", "中国", "例子", "bücher", "BÜCHER"]
+
+    private struct SuffixResults {
+        var plain: [Int16?] = []
+        var bulk: [Int16?] = []
+        var pruned: [Int16?] = []
+        var keptCount = 0
+    }
+
+    /// Resolves `probes` against tries built by `insert`/`freeze`, by `buildBulk` alone,
+    /// and by `pruneRedundant` then `buildBulk`. Rules and probes are lowercased the way
+    /// the payload writer and ``DomainRouter`` lowercase them.
+    private func resolveSuffixes(rules: [(suffix: String, action: Int16)], probes: [String]) -> SuffixResults {
+        let folded = rules.map { (suffix: $0.suffix.lowercased(), action: $0.action) }
+
+        var plain = FlatLabelTrie<Int16>()
+        for rule in folded { plain.insert(suffix: rule.suffix, payload: rule.action) }
+        plain.freeze()
+
+        var base: [UInt8] = []
+        var entries: [FlatLabelTrie<Int16>.BulkEntry] = []
+        for rule in folded {
+            entries.append(.init(offset: Int32(base.count), length: Int32(rule.suffix.utf8.count),
+                                 payload: rule.action, order: Int32(entries.count)))
+            base.append(contentsOf: rule.suffix.utf8)
+        }
+        var bulk = FlatLabelTrie<Int16>()
+        var pruned = FlatLabelTrie<Int16>()
+        var results = SuffixResults()
+        base.withUnsafeBufferPointer { base in
+            var bulkEntries = entries
+            bulk.buildBulk(base: base, entries: &bulkEntries)
+            FlatLabelTrie<Int16>.pruneRedundant(base: base, entries: &entries)
+            pruned.buildBulk(base: base, entries: &entries)
+        }
+        results.keptCount = entries.count
+
+        func resolve(_ trie: FlatLabelTrie<Int16>) -> [Int16?] {
+            probes.map { probe in
+                var host = probe.lowercased()
+                return host.withUTF8 { trie.lookup($0) }
+            }
+        }
+        results.plain = resolve(plain)
+        results.bulk = resolve(bulk)
+        results.pruned = resolve(pruned)
+        return results
+    }
+
+    private func expectSameSuffixResults(_ results: SuffixResults, probes: [String]) {
+        for (i, probe) in probes.enumerated() {
+            #expect(results.bulk[i] == results.plain[i], "unpruned bulk build differs for \(probe)")
+            #expect(results.pruned[i] == results.plain[i], "pruned build differs for \(probe)")
+        }
+    }
+
+    @Test func prunedSuffixesResolveExactAndSubdomainHostsUnchanged() {
+        let rules: [(suffix: String, action: Int16)] = [
+            ("com", 0), ("example.com", 0), ("www.example.com", 1), ("a.www.example.com", 1),
+            ("cdn.example.com", 0), ("api.example.com", 2),
+            // A repeat, differently cased: the last copy wins, which un-shadows cdn.example.com.
+            ("Example.COM", 2),
+            (".", 1), ("", 1), ("b..example.com", 1), ("example.net.", 2),
+            ("中国", 2), ("例子.中国", 2), ("xn--fiqs8s", 1), ("WWW.xn--fiqs8s", 1), ("bücher.de", 0),
+        ]
+        let probes = [
+            "com", "example.com", "EXAMPLE.com", "x.example.com", "www.example.com", "WWW.Example.Com",
+            "a.www.example.com", "b.a.www.example.com", "cdn.example.com", "x.CDN.example.com",
+            "api.example.com", "notexample.com", "example.net", "x.example.net", "b.example.com",
+            "b..example.com", "example.com.", ".example.com", "..", ".", "", "net", "de",
+            "中国", "例子.中国", "www.例子.中国", "xn--fiqs8s", "WWW.XN--FIQS8S", "BÜCHER.de", "x.bücher.DE",
+        ]
+        let results = resolveSuffixes(rules: rules, probes: probes)
+        expectSameSuffixResults(results, probes: probes)
+        #expect(results.keptCount < rules.count)
+
+        func pruned(_ host: String) -> Int16? { results.pruned[probes.firstIndex(of: host)!] }
+        #expect(pruned("x.example.com") == 2)
+        #expect(pruned("cdn.example.com") == 0)
+        #expect(pruned("WWW.Example.Com") == 1)
+        #expect(pruned("notexample.com") == 0)
+        #expect(pruned("b..example.com") == 1)
+        #expect(pruned("www.例子.中国") == 2)
+        #expect(pruned("de") == nil)
+    }
+
+    @Test func prunedSuffixesResolveRandomRuleSetsUnchanged() {
+        var generator = SeededGenerator(seed: 108)
+        func domain(_ labelCount: ClosedRange<Int>) -> String {
+            (0..<Int.random(in: labelCount, using: &generator))
+                .map { _ in Self.labels.randomElement(using: &generator)! }
+                .joined(separator: ".")
+        }
+
+        for _ in 0..<8 {
+            let rules = (0..<300).map { _ in (suffix: domain(1...4), action: Int16.random(in: 0...2, using: &generator)) }
+            var probes: [String] = []
+            for rule in rules {
+                probes.append(rule.suffix)
+                probes.append("\(domain(1...2)).\(rule.suffix)")
+                probes.append("\(Self.labels.randomElement(using: &generator)!)\(rule.suffix)")
+            }
+            for _ in 0..<1000 { probes.append(domain(1...6)) }
+
+            let results = resolveSuffixes(rules: rules, probes: probes)
+            expectSameSuffixResults(results, probes: probes)
+            #expect(results.keptCount < rules.count)
+        }
+    }
+
+    // MARK: - IPv4 CIDR rules
+
+    private typealias V4Prefix = (network: UInt32, length: UInt8, actionID: Int16)
+
+    private static func mask(_ address: UInt32, _ length: UInt8) -> UInt32 {
+        length == 0 ? 0 : address & (~UInt32(0) << (32 - UInt32(length)))
+    }
+
+    private static func prefixes(of trie: CIDRv4Trie) -> [V4Prefix] {
+        var prefixes: [V4Prefix] = []
+        trie.forEachPrefix { prefixes.append(($0, $1, $2)) }
+        return prefixes
+    }
+
+    /// Longest-prefix match by brute force over every prefix the trie holds.
+    private static func longestMatch(_ prefixes: [V4Prefix], _ address: UInt32) -> Int16? {
+        var best: V4Prefix?
+        for prefix in prefixes where mask(address, prefix.length) == prefix.network {
+            if best == nil || prefix.length > best!.length { best = prefix }
+        }
+        return best?.actionID
+    }
+
+    /// Builds the trie from `rules`, compacts a copy, and expects both to resolve `probes`
+    /// the same. Returns the prefix counts before and after compaction.
+    @discardableResult
+    private func expectCompactedV4Unchanged(rules: [V4Prefix], probes: [UInt32]) -> (plain: Int, compacted: Int) {
+        var plain = CIDRv4Trie()
+        for rule in rules { plain.insert(network: rule.network, prefixLen: Int(rule.length), actionID: rule.actionID) }
+        var compacted = plain
+        compacted.compact()
+
+        let plainPrefixes = Self.prefixes(of: plain)
+        let compactedPrefixes = Self.prefixes(of: compacted)
+        for address in probes {
+            #expect(Self.longestMatch(compactedPrefixes, address) == Self.longestMatch(plainPrefixes, address),
+                    "compacted trie differs for \(address >> 24).\(address >> 16 & 0xFF).\(address >> 8 & 0xFF).\(address & 0xFF)")
+        }
+        return (plainPrefixes.count, compactedPrefixes.count)
+    }
+
+    /// Every rule's first and last address and the addresses either side of them.
+    private static func boundaryProbes(_ rules: [V4Prefix]) -> [UInt32] {
+        rules.flatMap { rule -> [UInt32] in
+            let first = mask(rule.network, rule.length)
+            let last = first | ~(rule.length == 0 ? 0 : ~UInt32(0) << (32 - UInt32(rule.length)))
+            return [first, first &- 1, first &+ 1, last, last &- 1, last &+ 1]
+        }
+    }
+
+    @Test func compactedIPv4TrieResolvesOverlappingPrefixesUnchanged() {
+        let rules: [V4Prefix] = [
+            (0x0A00_0000, 8, 0),        // 10.0.0.0/8
+            (0x0A00_0000, 24, 1),       // 10.0.0.0/24, shadowed by the two /25s
+            (0x0A00_0000, 25, 2),
+            (0x0A00_0080, 25, 2),
+            (0x0A01_0000, 16, 0),       // same action as the enclosing /8
+            (0x0A01_0200, 24, 1),
+            (0x0A01_0200, 24, 0),       // duplicate prefix overwrites
+            (0xC0A8_0000, 16, 1),       // 192.168.0.0/16
+            (0xC0A8_0100, 24, 1),
+            (0xC0A8_0200, 24, 0),
+            (0xAC10_0504, 32, 0),       // 172.16.5.4/32 and /5 merge to a /31
+            (0xAC10_0505, 32, 0),
+            (0xAC10_05FF, 20, 1),       // host bits set; masked on insert
+            (0x0000_0000, 0, 2),
+        ]
+        var probes = Self.boundaryProbes(rules)
+        var generator = SeededGenerator(seed: 4)
+        for _ in 0..<2000 { probes.append(UInt32.random(in: 0x0A00_0000...0x0A02_FFFF, using: &generator)) }
+        for _ in 0..<2000 { probes.append(UInt32.random(in: .min ... .max, using: &generator)) }
+
+        let counts = expectCompactedV4Unchanged(rules: rules, probes: probes)
+        #expect(counts.compacted < counts.plain)
+    }
+
+    @Test func compactedIPv4TrieResolvesRandomRuleSetsUnchanged() {
+        var generator = SeededGenerator(seed: 109)
+        for _ in 0..<8 {
+            // Clustered in 10.0.0.0/14 so that prefixes nest and touch.
+            let rules: [V4Prefix] = (0..<400).map { _ in
+                (0x0A00_0000 | UInt32.random(in: 0..<(1 << 18), using: &generator),
+                 UInt8.random(in: 12...32, using: &generator), Int16.random(in: 0...1, using: &generator))
+            }
+            var probes = Self.boundaryProbes(rules)
+            for _ in 0..<4000 { probes.append(UInt32.random(in: 0x0900_0000...0x0B00_0000, using: &generator)) }
+            expectCompactedV4Unchanged(rules: rules, probes: probes)
+        }
+    }
+
+    // MARK: - IPv6 CIDR rules
+
+    private typealias V6Prefix = (hi: UInt64, lo: UInt64, length: UInt8, actionID: Int16)
+
+    private static func mask(_ hi: UInt64, _ lo: UInt64, _ length: UInt8) -> (hi: UInt64, lo: UInt64) {
+        if length == 0 { return (0, 0) }
+        if length <= 64 { return (hi & (~UInt64(0) << (64 - UInt64(length))), 0) }
+        return (hi, lo & (~UInt64(0) << (128 - UInt64(length))))
+    }
+
+    private static func longestMatch(_ prefixes: [V6Prefix], _ hi: UInt64, _ lo: UInt64) -> Int16? {
+        var best: V6Prefix?
+        for prefix in prefixes {
+            let masked = mask(hi, lo, prefix.length)
+            guard masked.hi == prefix.hi, masked.lo == prefix.lo else { continue }
+            if best == nil || prefix.length > best!.length { best = prefix }
+        }
+        return best?.actionID
+    }
+
+    private func expectCompactedV6Unchanged(rules: [V6Prefix], probes: [(hi: UInt64, lo: UInt64)]) -> (plain: Int, compacted: Int) {
+        var plain = CIDRv6Trie()
+        for rule in rules {
+            plain.insert(hi: rule.hi, lo: rule.lo, prefixLen: Int(rule.length), actionID: rule.actionID)
+        }
+        var compacted = plain
+        compacted.compact()
+
+        func prefixes(_ trie: CIDRv6Trie) -> [V6Prefix] {
+            var prefixes: [V6Prefix] = []
+            trie.forEachPrefix { prefixes.append(($0, $1, $2, $3)) }
+            return prefixes
+        }
+        let plainPrefixes = prefixes(plain)
+        let compactedPrefixes = prefixes(compacted)
+        for probe in probes {
+            #expect(Self.longestMatch(compactedPrefixes, probe.hi, probe.lo) == Self.longestMatch(plainPrefixes, probe.hi, probe.lo),
+                    "compacted trie differs for \(String(probe.hi, radix: 16)):\(String(probe.lo, radix: 16))")
+        }
+        return (plainPrefixes.count, compactedPrefixes.count)
+    }
+
+    @Test func compactedIPv6TrieResolvesOverlappingPrefixesUnchanged() {
+        let documentation: UInt64 = 0x2001_0DB8_0000_0000
+        var generator = SeededGenerator(seed: 6)
+        var rules: [V6Prefix] = [
+            (documentation, 0, 32, 0),                              // 2001:db8::/32
+            (documentation, 0, 48, 1),
+            (documentation, 0, 49, 0),                              // siblings merging into the /48
+            (documentation | 0x0000_0000_8000_0000, 0, 49, 0),
+            (documentation | 0x0001_0000_0000, 0, 64, 0),           // same action as the /32
+            (documentation | 0x0002_0000_0000, 0x1, 128, 1),
+            (documentation | 0x0002_0000_0000, 0x0, 128, 1),        // merge to a /127
+            (documentation | 0x0003_0000_0000, 0x8000_0000_0000_0000, 65, 1),
+            (documentation | 0x0003_0000_0000, 0x8000_0000_0000_0000, 65, 0),  // duplicate overwrites
+            (0xFC00_0000_0000_0000, 0, 7, 2),
+        ]
+        // Clustered around the 64-bit boundary, where the trie splits its halves.
+        for _ in 0..<300 {
+            rules.append((documentation | UInt64.random(in: 0..<16, using: &generator),
+                          UInt64.random(in: .min ... .max, using: &generator) & 0xF000_0000_0000_00FF,
+                          UInt8.random(in: 56...72, using: &generator), Int16.random(in: 0...1, using: &generator)))
+        }
+
+        var probes: [(hi: UInt64, lo: UInt64)] = []
+        for rule in rules {
+            let first = Self.mask(rule.hi, rule.lo, rule.length)
+            probes.append(first)
+            probes.append((first.hi, first.lo &- 1))
+            probes.append((first.hi, first.lo &+ 1))
+        }
+        for _ in 0..<4000 {
+            probes.append((documentation | UInt64.random(in: 0..<(1 << 34), using: &generator),
+                           UInt64.random(in: .min ... .max, using: &generator)))
+        }
+
+        let counts = expectCompactedV6Unchanged(rules: rules, probes: probes)
+        #expect(counts.compacted < counts.plain)
+    }
+}
@@ -0,0 +1,440 @@
+//
+//  LwIPReplay.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+@testable import Anywhere
+
+/// Replays captured app-side packets through the extension's lwIP bridge the way
+/// `TunnelStack+IO` feeds a `readPackets` batch: one header peek per packet routes TCP/ICMP
+/// into `lwip_bridge_input` inside a batch bracket, and UDP to the reply builder the UDP
+/// leg uses. Every accepted TCP flow is served by a ``LoopbackEchoConnection``, so lwIP's
+/// receive, write and output paths all run.
+///
+/// Only client→server packets are fed. lwIP picks its own ISN, so each fed ACK is
+/// rewritten to acknowledge everything lwIP has sent on that flow so far, like a client
+/// that keeps up; that also keeps the echo's send buffer draining. TCP checksums are left
+/// stale, as lwIP is built without checksum checks. Flows whose SYN isn't in the capture
+/// are skipped. Single-threaded: the calling thread stands in for `lwipQueue`, and only
+/// one replay may run at a time.
+final class LwIPReplay {
+
+    struct Report: CustomStringConvertible {
+        var packets = 0
+        var bytes = 0
+        var tcpPackets = 0
+        var udpPackets = 0
+        /// Server→client packets, and packets of flows whose SYN the capture missed.
+        var skipped = 0
+        var outputPackets = 0
+        var outputBytes = 0
+        var echoedBytes = 0
+        var elapsed: CFAbsoluteTime = 0
+        /// `mem_malloc` calls, and how many of them missed the slab and reached malloc. memp
+        /// pool takes (PCBs, segments, reference pbufs) are fixed arrays and not counted.
+        var allocations: UInt64 = 0
+        var systemAllocations: UInt64 = 0
+
+        var packetsPerSecond: Double { elapsed > 0 ? Double(packets) / elapsed : 0 }
+        var bytesPerSecond: Double { elapsed > 0 ? Double(bytes) / elapsed : 0 }
+        var allocationsPerPacket: Double { packets > 0 ? Double(allocations) / Double(packets) : 0 }
+        var systemAllocationsPerPacket: Double {
+            packets > 0 ? Double(systemAllocations) / Double(packets) : 0
+        }
+
+        var description: String {
+            String(format: "%d packets (%d TCP, %d UDP, %d skipped) in %.1f ms: %.0f packets/s, %.1f MB/s, "
+                   + "%.2f allocations/packet (%.3f malloc); %d packets / %d bytes out, %d bytes echoed",
+                   packets, tcpPackets, udpPackets, skipped, elapsed * 1000, packetsPerSecond,
+                   bytesPerSecond / 1_000_000, allocationsPerPacket, systemAllocationsPerPacket,
+                   outputPackets, outputBytes, echoedBytes)
+        }
+    }
+
+    private enum Route {
+        /// `ackOffset` is the acknowledgment number's offset within the packet.
+        case lwip(flow: Int?, ackOffset: Int?)
+        case udp(isIPv6: Bool, transportOffset: Int)
+        case skip
+    }
+
+    private struct Entry {
+        let offset: Int
+        let length: Int
+        let route: Route
+    }
+
+    /// A TCP flow by its client and server ends.
+    private struct FlowKey: Hashable {
+        let clientHigh: UInt64
+        let clientLow: UInt64
+        let serverHigh: UInt64
+        let serverLow: UInt64
+        let ports: UInt32
+
+        /// `reversed` reads a server→client packet.
+        init(_ packet: UnsafePointer<UInt8>, isIPv6: Bool, transport: UnsafePointer<UInt8>, reversed: Bool) {
+            let source = LwIPReplay.address(packet, isIPv6 ? 8 : 12, isIPv6: isIPv6)
+            let destination = LwIPReplay.address(packet, isIPv6 ? 24 : 16, isIPv6: isIPv6)
+            let sourcePort = UInt32(transport[0]) << 8 | UInt32(transport[1])
+            let destinationPort = UInt32(transport[2]) << 8 | UInt32(transport[3])
+            let client = reversed ? destination : source
+            let server = reversed ? source : destination
+            clientHigh = client.0
+            clientLow = client.1
+            serverHigh = server.0
+            serverLow = server.1
+            ports = reversed ? (destinationPort << 16 | sourcePort) : (sourcePort << 16 | destinationPort)
+        }
+    }
+
+    /// lwIP's side of a flow, as seen in its output.
+    private struct FlowState {
+        var synced = false
+        /// One past the last sequence number lwIP sent, SYN and FIN included.
+        var lwipNext: UInt32 = 0
+    }
+
+    private static weak var active: LwIPReplay?
+
+    private let batchSize: Int
+    private var storage: [UInt8] = []
+    private var entries: [Entry] = []
+    private var flowIndex: [FlowKey: Int] = [:]
+    private var flows: [FlowState] = []
+    private var legs: [EchoLeg] = []
+    private var releaseContexts: [UnsafeMutableRawPointer?] = []
+    private var report = Report()
+
+    /// `batchSize` packets share one `lwip_bridge_input_batch_begin`/`_end` bracket, like one
+    /// `readPackets` delivery.
+    init(packets: [Data], batchSize: Int = 64) {
+        self.batchSize = max(1, batchSize)
+        storage.reserveCapacity(packets.reduce(0) { $0 + $1.count })
+        entries.reserveCapacity(packets.count)
+        for packet in packets where !packet.isEmpty {
+            let offset = storage.count
+            storage.append(contentsOf: packet)
+            let route = packet.withUnsafeBytes { raw in
+                classify(raw.bindMemory(to: UInt8.self))
+            }
+            entries.append(Entry(offset: offset, length: packet.count, route: route))
+        }
+    }
+
+    // MARK: - Replay
+
+    /// Replays every packet once on a freshly initialised stack and tears it down after.
+    func run() -> Report {
+        precondition(LwIPReplay.active == nil, "one LwIPReplay at a time")
+        LwIPReplay.active = self
+        defer { LwIPReplay.active = nil }
+        report = Report()
+        for index in flows.indices { flows[index] = FlowState() }
+        installCallbacks()
+        lwip_bridge_set_mtu(1500)
+        lwip_bridge_init()
+
+        let udpBuffer = UnsafeMutablePointer<UInt8>.allocate(capacity: 65_535 + Int(UDP_PACKET_HLEN_V6))
+        defer { udpBuffer.deallocate() }
+        let before = Self.slabTotals()
+        let start = CFAbsoluteTimeGetCurrent()
+        storage.withUnsafeMutableBufferPointer { arena in
+            guard let base = arena.baseAddress else { return }
+            var index = 0
+            while index < entries.count {
+                let end = min(index + batchSize, entries.count)
+                lwip_bridge_input_batch_begin()
+                for entry in entries[index..<end] {
+                    feed(entry, base + entry.offset, udpBuffer: udpBuffer)
+                }
+                lwip_bridge_input_batch_end()
+                releaseOutput()
+                _ = lwip_bridge_check_timeouts()
+                index = end
+            }
+        }
+        report.elapsed = CFAbsoluteTimeGetCurrent() - start
+        let after = Self.slabTotals()
+        report.allocations = after.allocations - before.allocations
+        report.systemAllocations = after.misses - before.misses
+
+        lwip_bridge_abort_all_tcp()
+        releaseOutput()
+        lwip_bridge_shutdown()
+        for leg in legs { leg.close() }
+        legs.removeAll()
+        return report
+    }
+
+    private func feed(_ entry: Entry, _ packet: UnsafeMutablePointer<UInt8>, udpBuffer: UnsafeMutablePointer<UInt8>) {
+        switch entry.route {
+        case .skip:
+            report.skipped += 1
+            return
+        case .lwip(let flow, let ackOffset):
+            if let flow, let ackOffset, flows[flow].synced {
+                let ack = flows[flow].lwipNext
+                packet[ackOffset] = UInt8(ack >> 24)
+                packet[ackOffset + 1] = UInt8((ack >> 16) & 0xFF)
+                packet[ackOffset + 2] = UInt8((ack >> 8) & 0xFF)
+                packet[ackOffset + 3] = UInt8(ack & 0xFF)
+            }
+            report.tcpPackets += 1
+            lwip_bridge_input(packet, Int32(entry.length))
+        case .udp(let isIPv6, let transportOffset):
+            // The UDP leg's reply: the datagram comes back from where it was sent.
+            report.udpPackets += 1
+            let udp = packet + transportOffset
+            let payloadLength = entry.length - transportOffset - 8
+            let length = udp_packet_build(
+                udpBuffer, isIPv6 ? 1 : 0,
+                packet + (isIPv6 ? 24 : 16), UInt16(udp[2]) << 8 | UInt16(udp[3]),
+                packet + (isIPv6 ? 8 : 12), UInt16(udp[0]) << 8 | UInt16(udp[1]),
+                udp + 8, Int32(payloadLength))
+            if length > 0 {
+                report.outputPackets += 1
+                report.outputBytes += Int(length)
+            }
+        }
+        report.packets += 1
+        report.bytes += entry.length
+    }
+
+    /// Hands lwIP back every output buffer of the batch, as the output ring does.
+    private func releaseOutput() {
+        guard !releaseContexts.isEmpty else { return }
+        releaseContexts.withUnsafeBufferPointer { contexts in
+            lwip_bridge_release_batch(contexts.baseAddress, Int32(contexts.count))
+        }
+        releaseContexts.removeAll(keepingCapacity: true)
+    }
+
+    // MARK: - Classification
+
+    /// The `TunnelStack+IO` header peek, plus the flow bookkeeping the ACK rewrite needs.
+    private func classify(_ packet: UnsafeBufferPointer<UInt8>) -> Route {
+        guard let p = packet.baseAddress, packet.count >= 1 else { return .skip }
+        let proto: UInt8
+        let isIPv6: Bool
+        let transportOffset: Int
+        switch p[0] >> 4 {
+        case 4 where packet.count >= 20: proto = p[9]; isIPv6 = false; transportOffset = Int(p[0] & 0x0F) * 4
+        case 6 where packet.count >= 40: proto = p[6]; isIPv6 = true; transportOffset = 40
+        default: return .skip
+        }
+        switch proto {
+        case 17:
+            return packet.count >= transportOffset + 8 ? .udp(isIPv6: isIPv6, transportOffset: transportOffset) : .skip
+        case 6:
+            guard packet.count >= transportOffset + 20 else { return .skip }
+            let tcp = p + transportOffset
+            let flags = tcp[13]
+            let key = FlowKey(p, isIPv6: isIPv6, transport: tcp, reversed: false)
+            var flow = flowIndex[key]
+            if flow == nil, flags & 0x12 == 0x02 {
+                flow = flows.count
+                flowIndex[key] = flows.count
+                flows.append(FlowState())
+            }
+            guard let flow else { return .skip }
+            return .lwip(flow: flow, ackOffset: flags & 0x10 != 0 ? transportOffset + 8 : nil)
+        default:
+            return .lwip(flow: nil, ackOffset: nil)
+        }
+    }
+
+    /// Tracks how far lwIP has sent on its flow so the next fed ACK can cover it.
+    private func noteOutput(_ p: UnsafePointer<UInt8>, available: Int, total: Int, isIPv6: Bool) {
+        report.outputPackets += 1
+        report.outputBytes += total
+        let ipHeaderLength: Int
+        let proto: UInt8
+        if isIPv6 {
+            guard available >= 40 else { return }
+            ipHeaderLength = 40
+            proto = p[6]
+        } else {
+            guard available >= 20 else { return }
+            ipHeaderLength = Int(p[0] & 0x0F) * 4
+            proto = p[9]
+        }
+        guard proto == 6, available >= ipHeaderLength + 20 else { return }
+        let tcp = p + ipHeaderLength
+        guard let flow = flowIndex[FlowKey(p, isIPv6: isIPv6, transport: tcp, reversed: true)] else { return }
+        let flags = tcp[13]
+        guard flags & 0x04 == 0 else { return }
+        let seq = UInt32(tcp[4]) << 24 | UInt32(tcp[5]) << 16 | UInt32(tcp[6]) << 8 | UInt32(tcp[7])
+        let dataLength = total - ipHeaderLength - Int(tcp[12] >> 4) * 4
+        let next = seq &+ UInt32(max(0, dataLength)) &+ UInt32(flags & 0x02 != 0 ? 1 : 0) &+ UInt32(flags & 0x01)
+        if !flows[flow].synced || Int32(bitPattern: next &- flows[flow].lwipNext) > 0 {
+            flows[flow].lwipNext = next
+            flows[flow].synced = true
+        }
+    }
+
+    private static func address(_ packet: UnsafePointer<UInt8>, _ offset: Int, isIPv6: Bool) -> (UInt64, UInt64) {
+        let raw = UnsafeRawPointer(packet + offset)
+        if isIPv6 {
+            return (raw.loadUnaligned(as: UInt64.self), raw.loadUnaligned(fromByteOffset: 8, as: UInt64.self))
+        }
+        return (0, UInt64(raw.loadUnaligned(as: UInt32.self)))
+    }
+
+    private static func slabTotals() -> (allocations: UInt64, misses: UInt64) {
+        var stats = [lwip_slab_class_stats](repeating: lwip_slab_class_stats(), count: Int(LWIP_SLAB_NUM_CLASSES) + 1)
+        lwip_slab_get_stats(&stats)
+        return stats.reduce((UInt64(0), UInt64(0))) { ($0.0 + $1.allocs, $0.1 + $1.misses) }
+    }
+
+    // MARK: - Bridge Callbacks
+
+    private static func leg(_ conn: UnsafeMutableRawPointer?) -> EchoLeg? {
+        conn.map { Unmanaged<EchoLeg>.fromOpaque($0).takeUnretainedValue() }
+    }
+
+    private func installCallbacks() {
+        lwip_bridge_set_output_fn { data, len, isIPv6, releaseCtx in
+            guard let replay = LwIPReplay.active else { return }
+            replay.releaseContexts.append(releaseCtx)
+            guard let data else { return }
+            replay.noteOutput(data.assumingMemoryBound(to: UInt8.self), available: Int(len),
+                              total: Int(len), isIPv6: isIPv6 != 0)
+        }
+        // lwIP builds the IP and TCP headers in the chain's first pbuf.
+        lwip_bridge_set_output_chain_fn { vecs, nvecs, totLen, isIPv6, releaseCtx in
+            guard let replay = LwIPReplay.active else { return }
+            replay.releaseContexts.append(releaseCtx)
+            guard let vecs, nvecs > 0, let base = vecs[0].base else { return }
+            replay.noteOutput(base.assumingMemoryBound(to: UInt8.self), available: Int(vecs[0].len),
+                              total: Int(totLen), isIPv6: isIPv6 != 0)
+        }
+        lwip_bridge_set_tcp_syn_filter_fn(nil)
+        lwip_bridge_set_timer_kick_fn(nil)
+        lwip_bridge_set_tcp_accept_fn { _, _, _, _, _, pcb in
+            guard let replay = LwIPReplay.active, let pcb else { return nil }
+            let leg = EchoLeg(pcb: pcb) { replay.report.echoedBytes += $0 }
+            replay.legs.append(leg)
+            return Unmanaged.passUnretained(leg).toOpaque()
+        }
+        lwip_bridge_set_tcp_recv_fn { conn, data, len in
+            guard let leg = LwIPReplay.leg(conn) else { return }
+            if let data, len > 0 {
+                leg.received(Data(bytes: data, count: Int(len)))
+            } else {
+                leg.finish()
+            }
+        }
+        lwip_bridge_set_tcp_recv_vec_fn { conn, vecs, nvecs, totLen in
+            guard let leg = LwIPReplay.leg(conn), let vecs else { return }
+            var data = Data(capacity: Int(totLen))
+            for index in 0..<Int(nvecs) {
+                guard let base = vecs[index].base else { continue }
+                data.append(base.assumingMemoryBound(to: UInt8.self), count: Int(vecs[index].len))
+            }
+            leg.received(data)
+        }
+        lwip_bridge_set_tcp_sent_fn { _, _ in }
+        lwip_bridge_set_tcp_err_fn { conn, _ in
+            LwIPReplay.leg(conn)?.close()
+        }
+        lwip_bridge_set_tcp_write_refs_destroyed_fn(nil)
+    }
+}
+
+// MARK: - EchoLeg
+
+/// Joins one lwIP PCB to its ``LoopbackEchoConnection``: received bytes go out through
+/// the connection and come straight back as a copy-mode write.
+private final class EchoLeg {
+    private let pcb: UnsafeMutableRawPointer
+    private let connection = LoopbackEchoConnection()
+    private let onEcho: (Int) -> Void
+    private var open = true
+
+    init(pcb: UnsafeMutableRawPointer, onEcho: @escaping (Int) -> Void) {
+        self.pcb = pcb
+        self.onEcho = onEcho
+        connection.startReceiving(handler: { [unowned self] data in
+            self.write(data)
+        }, errorHandler: { _ in })
+    }
+
+    func received(_ data: Data) {
+        guard open else { return }
+        connection.send(data: data)
+        lwip_bridge_tcp_recved(pcb, UInt16(clamping: data.count))
+    }
+
+    /// The client's FIN: close our side too.
+    func finish() {
+        guard open else { return }
+        open = false
+        connection.cancel()
+        lwip_bridge_tcp_close(pcb)
+    }
+
+    /// The PCB is gone (aborted, reset, or torn down with the stack).
+    func close() {
+        open = false
+        connection.cancel()
+    }
+
+    private func write(_ data: Data) {
+        guard open else { return }
+        let accepted = data.withUnsafeBytes { raw -> Int32 in
+            var vec = lwip_bridge_iovec(base: raw.baseAddress, len: Int32(raw.count))
+            return lwip_bridge_tcp_write_v(pcb, &vec, 1, Int32(LWIP_BRIDGE_WRITE_FLUSH))
+        }
+        if accepted > 0 { onEcho(Int(accepted)) }
+    }
+}
+
+// MARK: - LoopbackEchoConnection
+
+/// A ``ProxyConnection`` whose far end echoes: every send is delivered back to the next
+/// receive, synchronously and on the caller's thread.
+final class LoopbackEchoConnection: ProxyConnection {
+    private var queued: [Data] = []
+    private var pendingReceive: ((Data?, Error?) -> Void)?
+    private var closed = false
+
+    override var isConnected: Bool { !closed }
+
+    override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
+        sendRaw(data: data)
+        completion(nil)
+    }
+
+    override func sendRaw(data: Data) {
+        guard !closed, !data.isEmpty else { return }
+        if let pending = pendingReceive {
+            pendingReceive = nil
+            pending(data, nil)
+        } else {
+            queued.append(data)
+        }
+    }
+
+    override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
+        if !queued.isEmpty {
+            completion(queued.removeFirst(), nil)
+        } else if closed {
+            completion(nil, nil)
+        } else {
+            pendingReceive = completion
+        }
+    }
+
+    override func cancel() {
+        guard !closed else { return }
+        closed = true
+        queued.removeAll()
+        let pending = pendingReceive
+        pendingReceive = nil
+        pending?(nil, nil)
+    }
+}
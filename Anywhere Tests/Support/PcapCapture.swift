@@ -0,0 +1,138 @@
+//
+//  PcapCapture.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+enum PcapError: Error, CustomStringConvertible {
+    case truncated
+    case unsupportedFormat(UInt32)
+    case unsupportedLinkType(UInt32)
+
+    var description: String {
+        switch self {
+        case .truncated: return "Truncated pcap file"
+        case .unsupportedFormat(let magic): return String(format: "Unsupported capture format (magic 0x%08x); save as classic pcap", magic)
+        case .unsupportedLinkType(let type): return "Unsupported pcap link type \(type)"
+        }
+    }
+}
+
+/// Classic libpcap files, as `tcpdump -w` writes them. pcapng is not read; convert with
+/// `editcap -F pcap`. Only the IP packets are kept, with their link-layer header stripped,
+/// so they're exactly what `NEPacketTunnelFlow.readPackets` would hand the tunnel.
+enum PcapCapture {
+
+    private static let linkTypeNull: UInt32 = 0
+    private static let linkTypeEthernet: UInt32 = 1
+    private static let linkTypeRaw: UInt32 = 101
+    private static let linkTypeLoop: UInt32 = 108
+    private static let linkTypeLinuxSLL: UInt32 = 113
+    private static let linkTypeIPv4: UInt32 = 228
+    private static let linkTypeIPv6: UInt32 = 229
+
+    static func packets(contentsOf url: URL) throws -> [Data] {
+        try packets(in: Data(contentsOf: url, options: .mappedIfSafe))
+    }
+
+    /// The IP packets in `capture`, in capture order. Frames that aren't IPv4/IPv6, and
+    /// frames cut short by the snap length, are skipped.
+    static func packets(in capture: Data) throws -> [Data] {
+        let bytes = [UInt8](capture)
+        guard bytes.count >= 24 else { throw PcapError.truncated }
+        let magic = readU32(bytes, 0, bigEndian: false)
+        let bigEndian: Bool
+        switch magic {
+        case 0xA1B2_C3D4, 0xA1B2_3C4D: bigEndian = false
+        case 0xD4C3_B2A1, 0x4D3C_B2A1: bigEndian = true
+        default: throw PcapError.unsupportedFormat(magic)
+        }
+        let linkType = readU32(bytes, 20, bigEndian: bigEndian) & 0x0FFF_FFFF
+
+        var packets: [Data] = []
+        var offset = 24
+        while offset + 16 <= bytes.count {
+            let captured = Int(readU32(bytes, offset + 8, bigEndian: bigEndian))
+            let original = Int(readU32(bytes, offset + 12, bigEndian: bigEndian))
+            let start = offset + 16
+            guard start + captured <= bytes.count else { throw PcapError.truncated }
+            offset = start + captured
+            guard captured == original,
+                  let ipOffset = try ipOffset(bytes, start, captured, linkType, bigEndian: bigEndian),
+                  ipOffset < captured else { continue }
+            let version = bytes[start + ipOffset] >> 4
+            guard version == 4 || version == 6 else { continue }
+            packets.append(Data(bytes[(start + ipOffset)..<(start + captured)]))
+        }
+        return packets
+    }
+
+    /// Encodes `packets` as a raw-IP (link type 101) capture with zeroed timestamps.
+    static func encode(_ packets: [Data]) -> Data {
+        var out = Data(capacity: 24 + packets.reduce(0) { $0 + 16 + $1.count })
+        appendU32(&out, 0xA1B2_C3D4)
+        appendU16(&out, 2)
+        appendU16(&out, 4)
+        appendU32(&out, 0)
+        appendU32(&out, 0)
+        appendU32(&out, 65_535)
+        appendU32(&out, linkTypeRaw)
+        for packet in packets {
+            appendU32(&out, 0)
+            appendU32(&out, 0)
+            appendU32(&out, UInt32(packet.count))
+            appendU32(&out, UInt32(packet.count))
+            out.append(packet)
+        }
+        return out
+    }
+
+    // MARK: - Helpers
+
+    /// Where the IP header starts inside a frame, or nil for a non-IP frame.
+    private static func ipOffset(_ bytes: [UInt8], _ start: Int, _ count: Int,
+                                 _ linkType: UInt32, bigEndian: Bool) throws -> Int? {
+        switch linkType {
+        case linkTypeRaw, linkTypeIPv4, linkTypeIPv6:
+            return 0
+        case linkTypeNull, linkTypeLoop:
+            // A 4-byte address family; the IP version nibble decides the rest.
+            return 4
+        case linkTypeEthernet:
+            guard count >= 14 else { return nil }
+            var etherType = readU16(bytes, start + 12)
+            var headerLength = 14
+            if etherType == 0x8100, count >= 18 {
+                etherType = readU16(bytes, start + 16)
+                headerLength = 18
+            }
+            return etherType == 0x0800 || etherType == 0x86DD ? headerLength : nil
+        case linkTypeLinuxSLL:
+            guard count >= 16 else { return nil }
+            let protocolType = readU16(bytes, start + 14)
+            return protocolType == 0x0800 || protocolType == 0x86DD ? 16 : nil
+        default:
+            throw PcapError.unsupportedLinkType(linkType)
+        }
+    }
+
+    private static func readU16(_ bytes: [UInt8], _ offset: Int) -> UInt16 {
+        UInt16(bytes[offset]) << 8 | UInt16(bytes[offset + 1])
+    }
+
+    private static func readU32(_ bytes: [UInt8], _ offset: Int, bigEndian: Bool) -> UInt32 {
+        let value = bytes[offset..<(offset + 4)].reversed().reduce(UInt32(0)) { $0 << 8 | UInt32($1) }
+        return bigEndian ? value.byteSwapped : value
+    }
+
+    private static func appendU16(_ data: inout Data, _ value: UInt16) {
+        withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+    }
+
+    private static func appendU32(_ data: inout Data, _ value: UInt32) {
+        withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+    }
+}
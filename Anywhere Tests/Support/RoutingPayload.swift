@@ -0,0 +1,60 @@
+//
+//  RoutingPayload.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+@testable import Anywhere
+
+/// Builds "ARB2" routing payloads for ``RoutingCompiler`` the way the app's
+/// `RoutingBinaryWriter` does, domain values lowercased, with an empty
+/// configuration table. See ``RoutingBinaryFormat`` for the layout.
+enum RoutingPayload {
+    struct Entry {
+        let tier: RoutingBinaryFormat.Tier
+        let target: RouteTarget
+        let rules: [RoutingRule]
+    }
+
+    static func encode(_ entries: [Entry]) -> Data {
+        var bytes = RoutingBinaryFormat.magic
+        append(UInt32(4), to: &bytes)       // configuration table: count only
+        append(UInt32(0), to: &bytes)
+        append(UInt32(entries.count), to: &bytes)
+        for entry in entries {
+            bytes.append(entry.tier.rawValue)
+            switch entry.target {
+            case .direct:
+                bytes.append(RoutingBinaryFormat.Action.direct.rawValue)
+            case .reject:
+                bytes.append(RoutingBinaryFormat.Action.reject.rawValue)
+            case .proxy(let id):
+                bytes.append(RoutingBinaryFormat.Action.proxy.rawValue)
+                bytes.append(contentsOf: withUnsafeBytes(of: id.uuid) { Array($0) })
+            }
+            append(UInt32(entry.rules.count), to: &bytes)
+            for rule in entry.rules {
+                let value: String
+                switch rule.type {
+                case .domainSuffix, .domainKeyword: value = rule.value.lowercased()
+                case .ipCIDR, .ipCIDR6: value = rule.value
+                }
+                bytes.append(UInt8(rule.type.rawValue))
+                append(UInt16(value.utf8.count), to: &bytes)
+                bytes.append(contentsOf: value.utf8)
+            }
+        }
+        return Data(bytes)
+    }
+
+    /// Compiles `entries` and loads the result.
+    static func image(_ entries: [Entry]) -> RoutingImage? {
+        RoutingCompiler.compileImage(routingData: encode(entries)).flatMap { RoutingImage(bytes: $0) }
+    }
+
+    private static func append<T: FixedWidthInteger>(_ value: T, to bytes: inout [UInt8]) {
+        withUnsafeBytes(of: value.littleEndian) { bytes.append(contentsOf: $0) }
+    }
+}
@@ -0,0 +1,128 @@
+//
+//  SyntheticCapture.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Deterministic app-side traffic for ``LwIPReplay`` when no capture is supplied: IPv4 TCP
+/// uploads (handshake, full-MSS segments round-robin across flows, FIN) interleaved with
+/// UDP datagrams. Only client→server packets are generated; the replay answers the rest.
+/// Acknowledgment numbers are left zero for the replay to fill in.
+enum SyntheticCapture {
+
+    private static let clientAddress: [UInt8] = [10, 7, 0, 2]
+    private static let mss: UInt16 = 1460
+
+    static func bulkUpload(flows: Int = 16, segmentsPerFlow: Int = 256, segmentSize: Int = 1400,
+                           udpDatagrams: Int = 512, udpSize: Int = 1200) -> [Data] {
+        let payload = DeterministicBytes.generate(seed: 13, count: segmentSize)
+        let datagram = DeterministicBytes.generate(seed: 14, count: udpSize)
+        let isns = (0..<flows).map { UInt32(truncatingIfNeeded: 0x1000_0000 &* ($0 + 1)) }
+        var packets: [Data] = []
+        packets.reserveCapacity(flows * (segmentsPerFlow + 3) + udpDatagrams)
+
+        for flow in 0..<flows {
+            packets.append(tcp(flow: flow, seq: isns[flow], flags: 0x02, payload: Data()))
+        }
+        for flow in 0..<flows {
+            packets.append(tcp(flow: flow, seq: isns[flow] &+ 1, flags: 0x10, payload: Data()))
+        }
+        let udpEvery = udpDatagrams > 0 ? max(1, segmentsPerFlow * flows / udpDatagrams) : Int.max
+        var udpSent = 0
+        for segment in 0..<segmentsPerFlow {
+            for flow in 0..<flows {
+                let seq = isns[flow] &+ 1 &+ UInt32(segment * segmentSize)
+                packets.append(tcp(flow: flow, seq: seq, flags: 0x18, payload: payload))
+                if udpSent < udpDatagrams, (segment * flows + flow) % udpEvery == 0 {
+                    packets.append(udp(sourcePort: 50_000 + UInt16(udpSent % 8), payload: datagram))
+                    udpSent += 1
+                }
+            }
+        }
+        for flow in 0..<flows {
+            let seq = isns[flow] &+ 1 &+ UInt32(segmentsPerFlow * segmentSize)
+            packets.append(tcp(flow: flow, seq: seq, flags: 0x11, payload: Data()))
+        }
+        return packets
+    }
+
+    // MARK: - Packets
+
+    private static func serverAddress(flow: Int) -> [UInt8] {
+        [198, 18, 0, UInt8(1 + flow % 200)]
+    }
+
+    private static func tcp(flow: Int, seq: UInt32, flags: UInt8, payload: Data) -> Data {
+        let isSYN = flags & 0x02 != 0
+        let headerLength = isSYN ? 24 : 20
+        var segment = [UInt8](repeating: 0, count: headerLength)
+        put16(&segment, 0, 40_000 + UInt16(flow))
+        put16(&segment, 2, 443)
+        put32(&segment, 4, seq)
+        segment[12] = UInt8(headerLength / 4) << 4
+        segment[13] = flags
+        put16(&segment, 14, 65_535)
+        if isSYN {
+            segment[20] = 2
+            segment[21] = 4
+            put16(&segment, 22, mss)
+        }
+        segment += payload
+        return ipv4(protocolNumber: 6, destination: serverAddress(flow: flow), transport: segment)
+    }
+
+    private static func udp(sourcePort: UInt16, payload: Data) -> Data {
+        var datagram = [UInt8](repeating: 0, count: 8)
+        put16(&datagram, 0, sourcePort)
+        put16(&datagram, 2, 443)
+        put16(&datagram, 4, UInt16(8 + payload.count))
+        datagram += payload
+        return ipv4(protocolNumber: 17, destination: [198, 18, 1, 1], transport: datagram)
+    }
+
+    /// Wraps `transport` in an IPv4 header and fills in both checksums, so the capture
+    /// also reads cleanly in Wireshark.
+    private static func ipv4(protocolNumber: UInt8, destination: [UInt8], transport: [UInt8]) -> Data {
+        var transport = transport
+        var pseudo = clientAddress + destination + [0, protocolNumber]
+        pseudo += [UInt8(transport.count >> 8), UInt8(transport.count & 0xFF)]
+        let checksumOffset = protocolNumber == 6 ? 16 : 6
+        put16(&transport, checksumOffset, checksum(pseudo + transport))
+
+        var header = [UInt8](repeating: 0, count: 20)
+        header[0] = 0x45
+        put16(&header, 2, UInt16(20 + transport.count))
+        header[6] = 0x40
+        header[8] = 64
+        header[9] = protocolNumber
+        header.replaceSubrange(12..<16, with: clientAddress)
+        header.replaceSubrange(16..<20, with: destination)
+        put16(&header, 10, checksum(header))
+        return Data(header + transport)
+    }
+
+    private static func checksum(_ bytes: [UInt8]) -> UInt16 {
+        var sum: UInt32 = 0
+        var index = 0
+        while index + 1 < bytes.count {
+            sum += UInt32(bytes[index]) << 8 | UInt32(bytes[index + 1])
+            index += 2
+        }
+        if index < bytes.count { sum += UInt32(bytes[index]) << 8 }
+        while sum > 0xFFFF { sum = (sum & 0xFFFF) + (sum >> 16) }
+        return ~UInt16(sum)
+    }
+
+    private static func put16(_ bytes: inout [UInt8], _ offset: Int, _ value: UInt16) {
+        bytes[offset] = UInt8(value >> 8)
+        bytes[offset + 1] = UInt8(value & 0xFF)
+    }
+
+    private static func put32(_ bytes: inout [UInt8], _ offset: Int, _ value: UInt32) {
+        put16(&bytes, offset, UInt16(value >> 16))
+        put16(&bytes, offset + 2, UInt16(value & 0xFFFF))
+    }
+}
@@ -33,8 +33,18 @@ enum TestEnvironment {
     static var httpPort: UInt16 { string("ANYWHERE_TEST_HTTP_PORT").flatMap(UInt16.init) ?? defaultHTTPPort }
     static var httpsPort: UInt16 { string("ANYWHERE_TEST_HTTPS_PORT").flatMap(UInt16.init) ?? defaultHTTPSPort }
     static var allowInsecure: Bool { string("ANYWHERE_TEST_ALLOW_INSECURE") != "0" }
+    /// A classic pcap of app-side traffic for ``LwIPReplay``; the synthetic workload otherwise.
+    static var replayCapturePath: String? { string("ANYWHERE_REPLAY_PCAP") }
+    /// Proxy URLs for ``TunnelLoadGenerator``, one per protocol, separated by whitespace
+    /// (share links may contain commas).
+    static var loadProxyURLs: [String] {
+        string("ANYWHERE_LOAD_PROXY_URLS")?.split(whereSeparator: \.isWhitespace).map(String.init) ?? []
+    }
+    static var loadConnections: Int { string("ANYWHERE_LOAD_CONNECTIONS").flatMap(Int.init) ?? 16 }
+    static var loadBytesPerConnection: Int { string("ANYWHERE_LOAD_BYTES").flatMap(Int.init) ?? 1 << 20 }
     
     static var isConfigured: Bool { proxyURL != nil }
+    static var isLoadConfigured: Bool { !loadProxyURLs.isEmpty }
     
     static func requireTargetHost() throws -> String { targetHost }
     
@@ -43,6 +53,10 @@ enum TestEnvironment {
         return try ProxyConfiguration.parse(url: url)
     }
     
+    static func loadConfigurations() throws -> [ProxyConfiguration] {
+        try loadProxyURLs.map { try ProxyConfiguration.parse(url: $0) }
+    }
+    
     static func applyInsecureOverrideIfNeeded() {
         guard allowInsecure else { return }
         AWCore.setAllowInsecure(true)
@@ -0,0 +1,110 @@
+//
+//  TunnelLoadGenerator.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+@testable import Anywhere
+
+/// Opens `connections` tunnels at once through one configuration and pulls a `/bytes` body
+/// over each with ``TunneledHTTP1Client``. Connection `i` asks for seed `seed + i`, so a run
+/// is reproducible and every body is checked byte-exact against ``DeterministicBytes``.
+///
+/// CPU time is the whole test process's (`getrusage`), which is where the protocol clients
+/// run; keep other suites out of the run for clean numbers.
+struct TunnelLoadGenerator {
+
+    struct Report: CustomStringConvertible {
+        let protocolName: String
+        let connections: Int
+        let failures: Int
+        /// Connect latencies of the successful connections, sorted ascending.
+        let connectLatencies: [Double]
+        let bytes: Int
+        let wallTime: Double
+        let cpuTime: Double
+
+        var p50: Double { percentile(0.50) }
+        var p99: Double { percentile(0.99) }
+        var goodput: Double { wallTime > 0 ? Double(bytes) / wallTime : 0 }
+        var cpuSecondsPerMB: Double { bytes > 0 ? cpuTime / (Double(bytes) / 1_048_576) : 0 }
+
+        private func percentile(_ fraction: Double) -> Double {
+            guard !connectLatencies.isEmpty else { return 0 }
+            let rank = Int((fraction * Double(connectLatencies.count)).rounded(.up)) - 1
+            return connectLatencies[min(max(rank, 0), connectLatencies.count - 1)]
+        }
+
+        var description: String {
+            String(format: "%@ x%d: connect p50 %.1f ms, p99 %.1f ms; %.2f MB/s goodput; %.1f ms CPU/MB; %d failed",
+                   protocolName, connections, p50 * 1000, p99 * 1000,
+                   goodput / 1_048_576, cpuSecondsPerMB * 1000, failures)
+        }
+    }
+
+    let configuration: ProxyConfiguration
+    let host: String
+    let port: UInt16
+    var connections = 16
+    var bytesPerConnection = 1 << 20
+    var seed: UInt64 = 0x10AD
+    var timeout: Double = 60
+
+    func run() async -> Report {
+        let cpuStart = Self.processCPUTime()
+        let wallStart = DispatchTime.now().uptimeNanoseconds
+
+        var latencies: [Double] = []
+        var bytes = 0
+        var failures = 0
+        await withTaskGroup(of: (latency: Double, bytes: Int)?.self) { group in
+            for index in 0..<connections {
+                group.addTask { try? await fetch(seed: seed &+ UInt64(index)) }
+            }
+            for await outcome in group {
+                guard let outcome else { failures += 1; continue }
+                latencies.append(outcome.latency)
+                bytes += outcome.bytes
+            }
+        }
+
+        let wallTime = Double(DispatchTime.now().uptimeNanoseconds - wallStart) / 1e9
+        return Report(protocolName: configuration.outboundProtocol.name, connections: connections,
+                      failures: failures, connectLatencies: latencies.sorted(), bytes: bytes,
+                      wallTime: wallTime, cpuTime: Self.processCPUTime() - cpuStart)
+    }
+
+    /// One connection: its connect latency and the verified body length. Throws on any
+    /// failure, including a body that doesn't match its seed.
+    private func fetch(seed: UInt64) async throws -> (latency: Double, bytes: Int) {
+        let count = bytesPerConnection
+        return try await withTimeout(timeout) { () async throws -> (latency: Double, bytes: Int) in
+            let start = DispatchTime.now().uptimeNanoseconds
+            let tunnel = try await ProxyTunnel.open(configuration: configuration, host: host, port: port)
+            let latency = Double(DispatchTime.now().uptimeNanoseconds - start) / 1e9
+            let response: HTTPResponse
+            do {
+                response = try await TunneledHTTP1Client.get(
+                    stream: tunnel.rawStream, host: host, path: "/bytes?n=\(count)&seed=\(seed)")
+                await tunnel.close()
+            } catch {
+                await tunnel.close()
+                throw error
+            }
+            guard response.statusCode == 200,
+                  response.body == DeterministicBytes.generate(seed: seed, count: count) else {
+                throw HTTPClientError.malformedResponse("/bytes body does not match seed \(seed)")
+            }
+            return (latency, response.body.count)
+        }
+    }
+
+    private static func processCPUTime() -> Double {
+        var usage = rusage()
+        getrusage(RUSAGE_SELF, &usage)
+        func seconds(_ time: timeval) -> Double { Double(time.tv_sec) + Double(time.tv_usec) / 1e6 }
+        return seconds(usage.ru_utime) + seconds(usage.ru_stime)
+    }
+}
@@ -0,0 +1,38 @@
+//
+//  TunnelLoadTests.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Testing
+import Foundation
+@testable import Anywhere
+
+/// Load mode: ``TunnelLoadGenerator`` against each `ANYWHERE_LOAD_PROXY_URLS` entry in turn
+/// (VLESS, Shadowsocks, Trojan, Hysteria, AnyTLS, Naive, ...), pulling from the plaintext
+/// port of the local test server. Each report is attached to the test result; compare them
+/// across builds on the same machine and server.
+@Suite(.enabled(if: TestEnvironment.isLoadConfigured), .serialized)
+struct TunnelLoadTests {
+
+    init() {
+        TestEnvironment.applyInsecureOverrideIfNeeded()
+    }
+
+    @Test func concurrentTunnelsDeliverDeterministicBodies() async throws {
+        for configuration in try TestEnvironment.loadConfigurations() {
+            let generator = TunnelLoadGenerator(
+                configuration: configuration,
+                host: try TestEnvironment.requireTargetHost(),
+                port: TestEnvironment.httpPort,
+                connections: TestEnvironment.loadConnections,
+                bytesPerConnection: TestEnvironment.loadBytesPerConnection)
+            let report = await generator.run()
+            Attachment.record(report.description, named: "TunnelLoad \(report.protocolName).txt")
+            #expect(report.failures == 0, "\(report.protocolName): \(report.failures) connections failed")
+            #expect(report.bytes == (report.connections - report.failures) * TestEnvironment.loadBytesPerConnection,
+                    "\(report.protocolName): \(report.bytes) bytes delivered")
+        }
+    }
+}
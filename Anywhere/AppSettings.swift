@@ -94,6 +94,13 @@ final class AppSettings {
         }
     }
 
+    var vlessMuxEnabled: Bool {
+        didSet {
+            AWCore.setVLESSMuxEnabled(vlessMuxEnabled)
+            AWNotificationCenter.notifyTunnelSettingsChanged()
+        }
+    }
+
     var hideVPNIcon: Bool {
         didSet {
             AWCore.setHideVPNIcon(hideVPNIcon)
@@ -191,6 +198,27 @@ final class AppSettings {
         }
     }
 
+    var kernelBypassEnabled: Bool {
+        didSet {
+            AWCore.setKernelBypassEnabled(kernelBypassEnabled)
+            VPNViewModel.shared.reconnectVPN()
+        }
+    }
+
+    var tunnelMTU: TunnelMTU {
+        didSet {
+            AWCore.setTunnelMTU(tunnelMTU)
+            VPNViewModel.shared.reconnectVPN()
+        }
+    }
+
+    var socketTransportEnabled: Bool {
+        didSet {
+            AWCore.setSocketTransportEnabled(socketTransportEnabled)
+            VPNViewModel.shared.reconnectVPN()
+        }
+    }
+
     // MARK: - Settings Visibility
 
     func isVisible(_ item: SettingsItem) -> Bool {
@@ -221,6 +249,7 @@ final class AppSettings {
         alwaysUntrustCellular = AWCore.getAlwaysUntrustCellular()
         blockUDP = AWCore.getBlockUDP()
         blockWebRTC = AWCore.getBlockWebRTC()
+        vlessMuxEnabled = AWCore.getVLESSMuxEnabled()
         hideVPNIcon = AWCore.getHideVPNIcon()
         proxyMode = AWCore.getProxyMode()
         quicPolicy = AWCore.getQUICPolicy()
@@ -235,5 +264,8 @@ final class AppSettings {
         includeAPNs = AWCore.getTunnelIncludeAPNs()
         includeCellularServices = AWCore.getTunnelIncludeCellularServices()
         includeLocalNetworks = AWCore.getTunnelIncludeLocalNetworks()
+        kernelBypassEnabled = AWCore.getKernelBypassEnabled()
+        tunnelMTU = AWCore.getTunnelMTU()
+        socketTransportEnabled = AWCore.getSocketTransportEnabled()
     }
 }
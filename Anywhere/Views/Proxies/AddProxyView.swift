@@ -257,6 +257,12 @@ struct AddProxyView: View {
     private func importFromString(_ string: String) {
         let trimmedURL = string.trimmingCharacters(in: .whitespacesAndNewlines)
 
+        // A pasted list of links imports as a batch.
+        if trimmedURL.contains(where: \.isNewline) {
+            importLinks(trimmedURL)
+            return
+        }
+
         // Only schemes the parser knows take the proxy-link path; everything else is a subscription URL.
         if ProxyConfiguration.canParseURL(trimmedURL) {
             do {
@@ -278,6 +284,21 @@ struct AddProxyView: View {
         }
     }
 
+    private func importLinks(_ text: String) {
+        isLoading = true
+        Task {
+            let configurations = await ShareLinkBatchParser.parse(text)
+            if let first = configurations.first {
+                configStore.add(contentsOf: configurations); viewModel.selectIfNone(first)
+                dismiss()
+            } else {
+                errorMessage = String(localized: "No valid proxy links found.")
+                showingError = true
+            }
+            isLoading = false
+        }
+    }
+
     private func fetchSubscription(url: String, withRemnawaveHWID: Bool) {
         isLoading = true
         Task {
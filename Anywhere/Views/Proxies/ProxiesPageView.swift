@@ -68,6 +68,14 @@ struct ProxiesPageView: View {
                 }
             }
         }
+        .refreshable {
+            guard proxyType == .servers, updatingSubscription == nil else { return }
+            let failures = await subscriptionStore.refreshAll()
+            if let failure = failures.first {
+                subscriptionErrorMessage = "\(failure.subscription.name): \(failure.error.localizedDescription)"
+                showingSubscriptionError = true
+            }
+        }
         .overlay {
             if proxyType == .servers, configStore.configurations.isEmpty {
                 ContentUnavailableView("No Proxies", systemImage: "network")
@@ -196,7 +204,9 @@ struct ProxiesPageView: View {
         }
         .onAppear {
             collapsedSubscriptions = Set(subscriptionStore.subscriptions.filter(\.collapsed).map(\.id))
+            NodeHealthModel.shared.startPolling()
         }
+        .onDisappear { NodeHealthModel.shared.stopPolling() }
     }
 
     // MARK: - Subscription Header
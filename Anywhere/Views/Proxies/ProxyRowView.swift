@@ -28,12 +28,23 @@ struct ProxyRowView: View {
                                 .font(.caption.bold())
                                 .foregroundStyle(.tint)
                         }
+                        if item.health?.isDegraded == true {
+                            Image(systemName: "exclamationmark.triangle.fill")
+                                .font(.caption)
+                                .foregroundStyle(.orange)
+                                .accessibilityLabel("Failing on live traffic")
+                        }
                     }
                     HStack(spacing: 4) {
                         ForEach(Array(item.tags.enumerated()), id: \.offset) { index, tag in
                             if index > 0 { Text("·") }
                             Text(tag)
                         }
+                        if let connectMs = item.health?.connectMs {
+                            Text("·")
+                            Text("Connect \(connectMs) ms")
+                                .monospacedDigit()
+                        }
                     }
                     .font(.caption)
                     .foregroundStyle(.secondary)
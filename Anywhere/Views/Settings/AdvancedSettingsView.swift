@@ -42,6 +42,7 @@ struct AdvancedSettingsView: View {
                 NavigationLink("IPv6") {
                     IPv6SettingsView()
                 }
+                Toggle("VLESS Mux", isOn: $settings.vlessMuxEnabled)
             }
 
             Section("Other") {
@@ -244,14 +244,12 @@ final class ImportRuleSetsModel {
                 fail(id: id, message: "HTTP \(http.statusCode)")
                 return
             }
-            guard let body = String(data: data, encoding: .utf8) else {
-                fail(id: id, message: String(localized: "Unknown content."))
-                return
-            }
-
             switch kind {
             case .routing:
-                let parsed = RoutingRuleSetParser.parse(body)
+                guard let parsed = RoutingRuleSetParser.parse(data) else {
+                    fail(id: id, message: String(localized: "Unknown content."))
+                    return
+                }
                 guard parsed.rules.count <= CustomRoutingRuleSet.maxRuleCount else {
                     fail(id: id, message: String(localized: "Rule set is too large."))
                     return
@@ -268,6 +266,10 @@ final class ImportRuleSetsModel {
                 }
 
             case .mitm:
+                guard let body = String(data: data, encoding: .utf8) else {
+                    fail(id: id, message: String(localized: "Unknown content."))
+                    return
+                }
                 let parsed = MITMRuleSetParser.parse(body)
                 guard parsed.rules.count <= MITMRuleSet.maxRuleCount else {
                     fail(id: id, message: String(localized: "Rule set is too large."))
@@ -8,7 +8,7 @@
 import Foundation
 
 /// The initial route a rule-set file requests via its `routing` header.
-enum RuleSetImportRoute: Int {
+nonisolated enum RuleSetImportRoute: Int {
     case `default` = 0
     case direct = 1
     case reject = 2
@@ -26,14 +26,38 @@ enum RuleSetImportRoute: Int {
 /// case-insensitive key) and rule lines (`<type>, <value>`); `#` or `//`
 /// start comments. Parsing never fails: an unrecognized header or invalid
 /// rule line is dropped silently, so a partially-valid file still imports.
+/// A file may instead be binary (``RoutingRuleSetColumns``), told apart by its magic.
 /// Full format reference: `Documentations/Routing.md`.
-enum RoutingRuleSetParser {
+nonisolated enum RoutingRuleSetParser {
     struct ParseResult {
         var name: String
         var rules: [RoutingRule]
         var routing: RuleSetImportRoute
     }
 
+    /// Either form of a downloaded file; nil if it is neither valid binary nor UTF-8 text.
+    static func parse(_ data: Data) -> ParseResult? {
+        if RoutingRuleSetColumns.isBinary(data) {
+            guard let columns = RoutingRuleSetColumns(data: data) else { return nil }
+            return ParseResult(name: columns.name, rules: columns.rules(),
+                               routing: RuleSetImportRoute(rawValue: Int(columns.routingCode)) ?? .default)
+        }
+        guard let text = String(data: data, encoding: .utf8) else { return nil }
+        return parse(text)
+    }
+
+    /// Either form of a downloaded file as columns: a binary file is only
+    /// validated, a text one parsed and encoded.
+    static func parseColumns(_ data: Data) -> RoutingRuleSetColumns? {
+        if RoutingRuleSetColumns.isBinary(data) {
+            return RoutingRuleSetColumns(data: data)
+        }
+        guard let text = String(data: data, encoding: .utf8) else { return nil }
+        let parsed = parse(text)
+        return RoutingRuleSetColumns(data: RoutingRuleSetColumns.encode(
+            name: parsed.name, routingCode: UInt8(parsed.routing.rawValue), rules: parsed.rules))
+    }
+
     static func parse(_ text: String) -> ParseResult {
         var name = ""
         var rules: [RoutingRule] = []
@@ -250,11 +250,10 @@ struct RuleSetListView: View {
                     subscribeError = "HTTP \(http.statusCode)"
                     return
                 }
-                guard let body = String(data: data, encoding: .utf8) else {
+                guard let parsed = RoutingRuleSetParser.parse(data) else {
                     subscribeError = String(localized: "Unknown content.")
                     return
                 }
-                let parsed = RoutingRuleSetParser.parse(body)
                 guard parsed.rules.count <= CustomRoutingRuleSet.maxRuleCount else {
                     subscribeError = String(localized: "Rule set is too large.")
                     return
@@ -23,6 +23,30 @@ struct TunnelSettingsView: View {
                 Toggle("Include Cellular Services", isOn: $settings.includeCellularServices)
             }
             .disabled(!settings.includeAllNetworks)
+
+            Section {
+                Toggle("Kernel Bypass", isOn: $settings.kernelBypassEnabled)
+            } footer: {
+                Text("Routes Country Bypass IP ranges around the tunnel, so IP-literal domestic traffic skips the extension entirely. Domain rules no longer apply to that traffic.")
+            }
+
+            Section {
+                Picker("MTU", selection: $settings.tunnelMTU) {
+                    ForEach(TunnelMTU.allCases, id: \.self) { mtu in
+                        Text(mtu.title).tag(mtu)
+                    }
+                }
+            } footer: {
+                Text("A larger MTU moves more data per packet between the system and the tunnel, which lowers CPU use on fast connections.")
+            }
+
+            if settings.experimentalEnabled {
+                Section {
+                    Toggle("Socket Transport", isOn: $settings.socketTransportEnabled)
+                } footer: {
+                    Text("Connects to proxy servers over BSD sockets instead of Network.framework, for comparing throughput. QUIC connections don't migrate between networks while this is on.")
+                }
+            }
         }
         .navigationTitle("Tunnel")
         .disabled(viewModel.pendingReconnect)
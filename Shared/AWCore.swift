@@ -23,17 +23,26 @@ nonisolated final class AWCore {
         static let outputQueue = "\(bundle).output"
         static let pathMonitorQueue = "\(bundle).path-monitor"
         static let quicQueue = "\(bundle).quic"
+        static let routingLoadQueue = "\(bundle).routing-load"
+        static let tcpProxyQueue = "\(bundle).tcp-proxy"
         static let udpQueue = "\(bundle).udp"
         
         // MARK: Transport queue labels
         static let nwTCPTransportQueue = "\(bundle).nw-tcp-transport"
         static let nwUDPTransportQueue = "\(bundle).nw-udp-transport"
+        static let socketTCPTransportQueue = "\(bundle).socket-tcp-transport"
+        static let socketUDPTransportQueue = "\(bundle).socket-udp-transport"
 
         // MARK: Protocol queue labels
         static let http11Queue = "\(bundle).http11"
         static let http2SessionQueue = "\(bundle).http2-session"
         static let multiplexerEvictionQueue = "\(bundle).multiplexer-eviction"
         static let anyTLSSessionTimerQueue = "\(bundle).anytls-session-timer"
+        static let anyTLSWriteQueue = "\(bundle).anytls-write"
+        static let trojanUDPWriteQueue = "\(bundle).trojan-udp-write"
+        static let preDialExpiryQueue = "\(bundle).pre-dial-expiry"
+        static let realityPrecomputeQueue = "\(bundle).reality-precompute"
+        static let vlessKeyPoolQueue = "\(bundle).vless-key-pool"
 
         static let sudokuTCPReadQueue = "\(bundle).sudoku.tcp.read"
         static let sudokuTCPWriteQueue = "\(bundle).sudoku.tcp.write"
@@ -41,6 +50,7 @@ nonisolated final class AWCore {
         static let sudokuMuxWriteQueue = "\(bundle).sudoku.mux.write"
         static let sudokuUDPReadQueue = "\(bundle).sudoku.udp.read"
         static let sudokuUDPWriteQueue = "\(bundle).sudoku.udp.write"
+        static let sudokuHTTPMaskQueue = "\(bundle).sudoku.httpmask"
 
         // MARK: MITM supervisor queue labels
         //
@@ -89,6 +99,7 @@ nonisolated final class AWCore {
         static let homeColorScheme = "homeColorScheme"
         static let iCloudSyncEnabled = "iCloudSyncEnabled"
         static let identifier = "identifier"
+        static let kernelBypassEnabled = "kernelBypassEnabled"
         static let lastConfigurationData = "lastConfigurationData"
         static let onboardingCompleted = "onboardingCompleted"
         static let preventDNSLeak = "preventDNSLeak"
@@ -100,12 +111,15 @@ nonisolated final class AWCore {
         static let ruleSetAssignments = "ruleSetAssignments"
         static let selectedChainId = "selectedChainId"
         static let selectedConfigurationId = "selectedConfigurationId"
+        static let socketTransportEnabled = "socketTransportEnabled"
         static let trustedCertificateSHA256s = "trustedCertificateSHA256s"
         static let trustedSSIDs = "trustedSSIDs"
         static let tunnelIncludeAllNetworks = "tunnelIncludeAllNetworks"
         static let tunnelIncludeAPNs = "tunnelIncludeAPNs"
         static let tunnelIncludeCellularServices = "tunnelIncludeCellularServices"
         static let tunnelIncludeLocalNetworks = "tunnelIncludeLocalNetworks"
+        static let tunnelMTU = "tunnelMTU"
+        static let vlessMuxEnabled = "vlessMuxEnabled"
         static let voyagerMembership = "voyagerMembership"
     }
 
@@ -344,6 +358,14 @@ nonisolated final class AWCore {
         userDefaults.set(value, forKey: UserDefaultsKey.blockWebRTC)
     }
 
+    static func getVLESSMuxEnabled() -> Bool {
+        userDefaults.bool(forKey: UserDefaultsKey.vlessMuxEnabled)
+    }
+
+    static func setVLESSMuxEnabled(_ value: Bool) {
+        userDefaults.set(value, forKey: UserDefaultsKey.vlessMuxEnabled)
+    }
+
     static func getPreventDNSLeak() -> Bool {
         userDefaults.bool(forKey: UserDefaultsKey.preventDNSLeak)
     }
@@ -368,6 +390,14 @@ nonisolated final class AWCore {
         userDefaults.set(value, forKey: UserDefaultsKey.remnawaveHWIDEnabled)
     }
 
+    static func getKernelBypassEnabled() -> Bool {
+        userDefaults.bool(forKey: UserDefaultsKey.kernelBypassEnabled)
+    }
+
+    static func setKernelBypassEnabled(_ value: Bool) {
+        userDefaults.set(value, forKey: UserDefaultsKey.kernelBypassEnabled)
+    }
+
     static func getTunnelIncludeAllNetworks() -> Bool {
         userDefaults.bool(forKey: UserDefaultsKey.tunnelIncludeAllNetworks)
     }
@@ -399,6 +429,22 @@ nonisolated final class AWCore {
     static func setTunnelIncludeCellularServices(_ value: Bool) {
         userDefaults.set(value, forKey: UserDefaultsKey.tunnelIncludeCellularServices)
     }
+
+    static func getSocketTransportEnabled() -> Bool {
+        userDefaults.bool(forKey: UserDefaultsKey.socketTransportEnabled)
+    }
+
+    static func setSocketTransportEnabled(_ value: Bool) {
+        userDefaults.set(value, forKey: UserDefaultsKey.socketTransportEnabled)
+    }
+
+    static func getTunnelMTU() -> TunnelMTU {
+        TunnelMTU(rawValue: userDefaults.integer(forKey: UserDefaultsKey.tunnelMTU)) ?? .standard
+    }
+
+    static func setTunnelMTU(_ value: TunnelMTU) {
+        userDefaults.set(value.rawValue, forKey: UserDefaultsKey.tunnelMTU)
+    }
     
     // MARK: - Routing Data
 
@@ -420,6 +466,42 @@ nonisolated final class AWCore {
         }
     }
 
+    /// Compiled form of the routing data (see ``RoutingImage``), which the
+    /// extension maps instead of parsing `routing.bin` itself.
+    static let routingImageURL = FileManager.default
+        .containerURL(forSecurityApplicationGroupIdentifier: Identifier.appGroupSuite)!
+        .appendingPathComponent("routing.img")
+
+    /// Writes `data`, or removes the image when nil or when the write fails, so
+    /// the extension never maps an image that disagrees with the routing data.
+    static func setRoutingImage(_ data: Data?) {
+        guard let data else {
+            try? FileManager.default.removeItem(at: routingImageURL)
+            return
+        }
+        do {
+            try data.write(to: routingImageURL, options: [.atomic, .noFileProtection])
+        } catch {
+            logger.error("Failed to write routing image: \(error)")
+            try? FileManager.default.removeItem(at: routingImageURL)
+        }
+    }
+
+    /// Country ranges for Country Bypass (see ``GeoIPTable``), written by the
+    /// app once per build and mapped by the extension.
+    static let geoIPTableURL = FileManager.default
+        .containerURL(forSecurityApplicationGroupIdentifier: Identifier.appGroupSuite)!
+        .appendingPathComponent("geoip.bin")
+
+    static func setGeoIPTable(_ data: Data) {
+        do {
+            try data.write(to: geoIPTableURL, options: [.atomic, .noFileProtection])
+        } catch {
+            logger.error("Failed to write GeoIP table: \(error)")
+            try? FileManager.default.removeItem(at: geoIPTableURL)
+        }
+    }
+
     // MARK: - MITM Data
 
     private static let mitmDataURL = FileManager.default
@@ -24,6 +24,22 @@ struct CountryBypassCatalog {
         RoutingRulesDatabase.shared.loadRules(for: countryCode)
     }
 
+    /// The App Group's GeoIP table, first rebuilt from every supported
+    /// country's IPv4 CIDRs when it is missing or from another build. Nil when
+    /// the file can't be written, since the extension would not find it either.
+    func installedGeoIPTable() -> GeoIPTable? {
+        let info = Bundle.main.infoDictionary
+        let stamp = "\(info?["CFBundleShortVersionString"] as? String ?? "")(\(info?["CFBundleVersion"] as? String ?? ""))"
+        if let table = GeoIPTable(contentsOf: AWCore.geoIPTableURL), table.stamp == stamp {
+            return table
+        }
+        let countries = supportedCountryCodes.map { code in
+            (code: code, cidrs: rules(for: code).compactMap { $0.type == .ipCIDR ? $0.value : nil })
+        }
+        AWCore.setGeoIPTable(GeoIPTable.encode(stamp: stamp, countries: countries))
+        return GeoIPTable(contentsOf: AWCore.geoIPTableURL)
+    }
+
     private static func load() -> CountryBypassCatalog {
         CountryBypassCatalog(
             supportedCountryCodes: RoutingRulesDatabase.shared.loadStringArray("supportedCountryCodes"),
@@ -65,6 +65,16 @@ class ConfigurationStore {
         coordinate()
     }
 
+    /// Adds a batch with one save, for bulk imports.
+    func add(contentsOf newConfigurations: [ProxyConfiguration]) {
+        guard !newConfigurations.isEmpty else { return }
+        let ids = Set(newConfigurations.map(\.id))
+        tombstones.removeAll { ids.contains($0.id) }
+        configurations.append(contentsOf: newConfigurations)
+        save()
+        coordinate()
+    }
+
     func update(_ configuration: ProxyConfiguration) {
         if let index = configurations.firstIndex(where: { $0.id == configuration.id }) {
             configurations[index] = configuration
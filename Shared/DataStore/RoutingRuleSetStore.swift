@@ -89,6 +89,9 @@ class RoutingRuleSetStore {
     /// Tail of the sync chain; each scheduled run awaits its predecessor.
     @ObservationIgnored private var queuedSync: Task<Void, Never>?
 
+    /// Tiers compiled by the last sync; an edit recompiles only the tiers it touched.
+    @ObservationIgnored private let routingTierCache = RoutingCompiler.TierCache()
+
     private static let syncDebounceInterval: Duration = .seconds(2)
 
     var adBlockRuleSet: RoutingRuleSet? {
@@ -105,6 +108,20 @@ class RoutingRuleSetStore {
     private static let serviceCatalog = ServiceCatalog.load()
     
     @ObservationIgnored private var loadedBlob: Data?
+    /// BLAKE3 of the last `.arrs` body applied per subscribed set; an unchanged download skips parse and rebuild.
+    @ObservationIgnored private var subscriptionDigests: [UUID: Data] = [:]
+    /// Mapped column files of subscribed sets whose rules still match them; the sync writes
+    /// these sets' payload rules straight from the columns. Dropped once the rules change.
+    @ObservationIgnored private var subscriptionColumns: [UUID: RoutingRuleSetColumns] = [:]
+    @ObservationIgnored private var saveTask: Task<Void, Never>?
+
+    nonisolated private static let columnsDirectory = FileManager.default
+        .containerURL(forSecurityApplicationGroupIdentifier: AWCore.Identifier.appGroupSuite)!
+        .appendingPathComponent("RuleSets", isDirectory: true)
+
+    nonisolated private static func columnsURL(for id: UUID) -> URL {
+        columnsDirectory.appendingPathComponent(id.uuidString + ".arrs")
+    }
 
     private init() {
         bypassCountryCode = AWCore.getBypassCountryCode()
@@ -115,6 +132,7 @@ class RoutingRuleSetStore {
         let split = Self.decodeCustomSplit(from: data)
         customRuleSets = split.live
         customTombstones = split.tombstones
+        subscriptionColumns = Self.loadColumns(for: split.live)
 
         rebuildRuleSets(assignments: assignments)
         scheduleSyncToAppGroup()
@@ -123,16 +141,18 @@ class RoutingRuleSetStore {
     func reload() async {
         let previous = loadedBlob
         let outcome = await Task.detached(priority: .utility) {
-            () -> (data: Data?, live: [CustomRoutingRuleSet], tombstones: [CustomRoutingRuleSet])? in
+            () -> (data: Data?, live: [CustomRoutingRuleSet], tombstones: [CustomRoutingRuleSet],
+                   columns: [UUID: RoutingRuleSetColumns])? in
             let data = JSONBlobStore.shared.load(.customRuleSets)
             guard data != previous else { return nil }
             let split = Self.decodeCustomSplit(from: data)
-            return (data, split.live, split.tombstones)
+            return (data, split.live, split.tombstones, Self.loadColumns(for: split.live))
         }.value
         guard let outcome else { return }
         loadedBlob = outcome.data
         customRuleSets = outcome.live
         customTombstones = outcome.tombstones
+        subscriptionColumns = outcome.columns
         rebuildRuleSets()
         scheduleSyncToAppGroup()
     }
@@ -226,6 +246,7 @@ class RoutingRuleSetStore {
             recordTombstone(removed)
         }
         customRuleSets.removeAll { $0.id == id }
+        dropColumns(for: id)
         saveCustomRuleSets()
 
         var assignments = AWCore.getRuleSetAssignments()
@@ -238,7 +259,10 @@ class RoutingRuleSetStore {
     func updateCustomRuleSet(_ id: UUID, name: String? = nil, rules: [RoutingRule]? = nil) {
         guard let index = customRuleSets.firstIndex(where: { $0.id == id }) else { return }
         if let name { customRuleSets[index].name = name }
-        if let rules { customRuleSets[index].rules = rules }
+        if let rules {
+            customRuleSets[index].rules = rules
+            dropColumns(for: id)
+        }
         saveCustomRuleSets()
         rebuildRuleSets()
     }
@@ -253,8 +277,7 @@ class RoutingRuleSetStore {
 
     /// Fetches and parses the subscription `.arrs` file, replacing the set's rules; the user-given name is preserved.
     func refreshCustomRuleSet(_ id: UUID) async throws {
-        guard let index = customRuleSets.firstIndex(where: { $0.id == id }),
-              let url = customRuleSets[index].subscriptionURL else {
+        guard let url = customRuleSets.first(where: { $0.id == id })?.subscriptionURL else {
             throw CustomRoutingRuleSetRefreshError.missingSubscriptionURL
         }
 
@@ -262,15 +285,35 @@ class RoutingRuleSetStore {
         if let http = response as? HTTPURLResponse, !(200...299).contains(http.statusCode) {
             throw CustomRoutingRuleSetRefreshError.invalidStatusCode(http.statusCode)
         }
-        guard let body = String(data: data, encoding: .utf8) else {
+        let digest = await Task.detached(priority: .utility) {
+            BLAKE3Hasher.hashParallel(data)
+        }.value
+        if subscriptionDigests[id] == digest,
+           customRuleSet(for: id)?.rules.isEmpty == false {
+            return
+        }
+        let parsed = await Task.detached(priority: .utility) {
+            RoutingRuleSetParser.parseColumns(data)
+        }.value
+        guard let parsed else {
             throw CustomRoutingRuleSetRefreshError.undecodableBody
         }
-
-        let parsed = RoutingRuleSetParser.parse(body)
-        guard parsed.rules.count <= CustomRoutingRuleSet.maxRuleCount else {
+        guard parsed.ruleCount <= CustomRoutingRuleSet.maxRuleCount else {
             throw CustomRoutingRuleSetRefreshError.tooManyRules
         }
-        customRuleSets[index].rules = parsed.rules
+        // The set's rules become the columns' values, so the mapped file keeps matching them.
+        let stored = await Task.detached(priority: .utility) {
+            () -> (columns: RoutingRuleSetColumns, rules: [RoutingRule]) in
+            (Self.storeColumns(parsed, for: id), parsed.rules())
+        }.value
+        // Re-resolve: the set may have been removed or reordered across the awaits.
+        guard let index = customRuleSets.firstIndex(where: { $0.id == id }) else {
+            try? FileManager.default.removeItem(at: Self.columnsURL(for: id))
+            return
+        }
+        customRuleSets[index].rules = stored.rules
+        subscriptionColumns[id] = stored.columns
+        subscriptionDigests[id] = digest
         saveCustomRuleSets()
         rebuildRuleSets()
     }
@@ -279,6 +322,38 @@ class RoutingRuleSetStore {
         customRuleSets.first { $0.id == id }
     }
 
+    // MARK: - Subscription Columns
+
+    /// Writes `columns` to the set's file and returns them mapped from it, or
+    /// unchanged in memory if the write fails.
+    nonisolated private static func storeColumns(_ columns: RoutingRuleSetColumns, for id: UUID) -> RoutingRuleSetColumns {
+        let url = columnsURL(for: id)
+        do {
+            try FileManager.default.createDirectory(at: columnsDirectory, withIntermediateDirectories: true)
+            try columns.data.write(to: url, options: [.atomic, .noFileProtection])
+        } catch {
+            logger.error("Failed to write rule set columns: \(error)")
+            return columns
+        }
+        return RoutingRuleSetColumns(contentsOf: url) ?? columns
+    }
+
+    /// Maps the column file of each subscribed set in `sets` whose rules it still matches.
+    nonisolated private static func loadColumns(for sets: [CustomRoutingRuleSet]) -> [UUID: RoutingRuleSetColumns] {
+        var loaded: [UUID: RoutingRuleSetColumns] = [:]
+        for set in sets where set.subscriptionURL != nil {
+            guard let columns = RoutingRuleSetColumns(contentsOf: columnsURL(for: set.id)),
+                  columns.matches(set.rules) else { continue }
+            loaded[set.id] = columns
+        }
+        return loaded
+    }
+
+    private func dropColumns(for id: UUID) {
+        guard subscriptionColumns.removeValue(forKey: id) != nil else { return }
+        try? FileManager.default.removeItem(at: Self.columnsURL(for: id))
+    }
+
     // MARK: - Rules
 
     /// Loads rules for a built-in rule set name. Thread-safe — no instance state accessed.
@@ -294,6 +369,7 @@ class RoutingRuleSetStore {
     private func syncToAppGroup(configurations: [ProxyConfiguration], chains: [ProxyChain]) async {
         let snapshot = ruleSets
         let customSnapshot = customRuleSets
+        let columnsSnapshot = subscriptionColumns
         
         var resolvedTargets: [String: ProxyConfiguration] = [:]
         for ruleSet in snapshot {
@@ -306,6 +382,7 @@ class RoutingRuleSetStore {
                 resolvedTargets[assignedId] = composite
             }
         }
+        let tierCache = routingTierCache
 
         await Task.detached {
             var entries: [RoutingBinaryWriter.Entry] = []
@@ -315,10 +392,12 @@ class RoutingRuleSetStore {
                 guard let assignedId = ruleSet.assignedConfigurationId else { continue }
 
                 let rules: [RoutingRule]
+                var columns: RoutingRuleSetColumns?
                 if ruleSet.isCustom,
                    let customId = UUID(uuidString: ruleSet.id),
                    let custom = customSnapshot.first(where: { $0.id == customId }) {
                     rules = custom.rules
+                    columns = columnsSnapshot[customId]
                 } else {
                     rules = await Self.loadRules(for: ruleSet.name)
                 }
@@ -342,12 +421,21 @@ class RoutingRuleSetStore {
 
                 let tier: RoutingBinaryFormat.Tier = ruleSet.isCustom ? .user
                     : (ruleSet.name == "ADBlock" ? .adBlock : .builtIn)
-                entries.append(.init(tier: tier, action: action, configId: configId, rules: rules))
+                if let columns {
+                    entries.append(.init(tier: tier, action: action, configId: configId, rules: [], columns: columns))
+                } else {
+                    entries.append(.init(tier: tier, action: action, configId: configId, rules: rules))
+                }
             }
 
             let countryCode = AWCore.getBypassCountryCode()
             if !countryCode.isEmpty {
-                let bypass = await CountryBypassCatalog.shared.rules(for: countryCode)
+                var bypass = await CountryBypassCatalog.shared.rules(for: countryCode)
+                // The extension answers the country's IPv4 ranges from the GeoIP
+                // table, so only its domain and IPv6 rules ride in the payload.
+                if await CountryBypassCatalog.shared.installedGeoIPTable()?.countryIndex(for: countryCode) != nil {
+                    bypass.removeAll { $0.type == .ipCIDR }
+                }
                 if !bypass.isEmpty {
                     entries.append(.init(tier: .bypass, action: .direct, configId: nil, rules: bypass))
                 }
@@ -355,10 +443,17 @@ class RoutingRuleSetStore {
             
             let encoder = JSONEncoder()
             encoder.outputFormatting = .sortedKeys
-            let configurationData = (try? encoder.encode(configurationsById)) ?? Data([0x7B, 0x7D])  // "{}"
-            let data = RoutingBinaryWriter.encode(configurationData: configurationData, entries: entries)
+            let configurations: [(id: UUID, json: Data)] = configurationsById.keys.sorted().compactMap { key in
+                guard let id = UUID(uuidString: key),
+                      let json = try? encoder.encode(configurationsById[key]) else { return nil }
+                return (id, json)
+            }
+            let data = RoutingBinaryWriter.encode(configurations: configurations, entries: entries)
 
-            if data != AWCore.getRoutingData() {
+            if data != AWCore.getRoutingData() || !RoutingImage.isCurrent(at: AWCore.routingImageURL) {
+                // Image first: the extension falls back to compiling the data
+                // itself only when no current image is present.
+                AWCore.setRoutingImage(RoutingCompiler.compileImage(routingData: data, reusing: tierCache))
                 AWCore.setRoutingData(data)
                 AWNotificationCenter.notifyRoutingChanged()
             }
@@ -390,9 +485,16 @@ class RoutingRuleSetStore {
         customTombstones.append(tomb)
     }
 
+    /// Encodes off the main actor: a subscribed set can hold ``CustomRoutingRuleSet/maxRuleCount``
+    /// rules. Saves stay in order by awaiting their predecessor.
     private func saveCustomRuleSets() {
-        if let data = try? JSONEncoder().encode(customRuleSets + customTombstones) {
-            JSONBlobStore.shared.save(.customRuleSets, data: data)
+        let snapshot = customRuleSets + customTombstones
+        let previous = saveTask
+        saveTask = Task.detached(priority: .utility) {
+            await previous?.value
+            if let data = try? JSONEncoder().encode(snapshot) {
+                JSONBlobStore.shared.save(.customRuleSets, data: data)
+            }
         }
         scheduleSyncToAppGroup()
     }
@@ -438,17 +540,26 @@ private struct RoutingBinaryWriter {
         let action: RoutingBinaryFormat.Action
         let configId: UUID?
         let rules: [RoutingRule]
+        /// When set, the rules are written from these instead of `rules`; they are folded already.
+        var columns: RoutingRuleSetColumns? = nil
     }
 
     private var bytes: [UInt8] = []
 
-    static func encode(configurationData: Data, entries: [Entry]) -> Data {
+    static func encode(configurations: [(id: UUID, json: Data)], entries: [Entry]) -> Data {
         var writer = RoutingBinaryWriter()
-        writer.bytes.reserveCapacity(configurationData.count + entries.reduce(0) { $0 + $1.rules.count * 24 } + 16)
+        let configurationTableLength = configurations.reduce(4) { $0 + 20 + $1.json.count }
+        writer.bytes.reserveCapacity(configurationTableLength
+            + entries.reduce(0) { $0 + $1.rules.count * 24 + ($1.columns?.data.count ?? 0) } + 16)
 
         writer.append(RoutingBinaryFormat.magic)
-        writer.u32(UInt32(configurationData.count))
-        writer.append(configurationData)
+        writer.u32(UInt32(configurationTableLength))
+        writer.u32(UInt32(configurations.count))
+        for configuration in configurations {
+            writer.append(withUnsafeBytes(of: configuration.id.uuid) { Array($0) })
+            writer.u32(UInt32(configuration.json.count))
+            writer.append(configuration.json)
+        }
         writer.u32(UInt32(entries.count))
 
         for entry in entries {
@@ -460,6 +571,12 @@ private struct RoutingBinaryWriter {
             let ruleCountOffset = writer.bytes.count
             writer.u32(0)  // back-patched once the kept rules are counted
             var kept: UInt32 = 0
+            entry.columns?.forEachValue { type, value in
+                writer.bytes.append(UInt8(type.rawValue))
+                writer.u16(UInt16(value.count))
+                writer.bytes.append(contentsOf: value)
+                kept += 1
+            }
             for rule in entry.rules {
                 // Case-fold domain values here, on the host: the extension stores
                 // suffix rules straight from these bytes (no per-rule folding),
@@ -18,6 +18,11 @@ class SubscriptionStore {
     private var tombstones: [Subscription] = []
     
     @ObservationIgnored private var loadedBlob: Data?
+    /// BLAKE3 of the last body applied per subscription; an unchanged download skips parse and the configuration rewrite.
+    @ObservationIgnored private var bodyDigests: [UUID: Data] = [:]
+
+    /// Downloads in flight at once for `refreshAll`.
+    private static let maxConcurrentRefreshes = 4
 
     private init() {
         let data = JSONBlobStore.shared.load(.subscriptions)
@@ -154,10 +159,75 @@ extension SubscriptionStore {
     /// Re-fetches a subscription and replaces its configurations, matching new configs to
     /// old ones by name to preserve IDs (and routing-rule assignments).
     func refresh(_ subscription: Subscription) async throws {
-        let result = try await SubscriptionFetcher.fetch(url: subscription.url)
+        let result = try await SubscriptionFetcher.fetch(url: subscription.url, knownDigest: knownDigest(for: subscription))
+        apply(result, to: subscription.id)
+    }
+
+    /// Refreshes every subscription, `maxConcurrentRefreshes` downloads at a time. Fetching and
+    /// parsing run off the main actor; each result is applied here as it lands. Returns the failures.
+    @discardableResult
+    func refreshAll() async -> [(subscription: Subscription, error: Error)] {
+        var queue = subscriptions[...]
+        var failures: [(subscription: Subscription, error: Error)] = []
+        await withTaskGroup(of: (Subscription, Swift.Result<SubscriptionFetcher.Result, Error>).self) { group in
+            func enqueueNext() {
+                guard let subscription = queue.popFirst() else { return }
+                let digest = knownDigest(for: subscription)
+                group.addTask {
+                    do {
+                        return (subscription, .success(try await SubscriptionFetcher.fetch(url: subscription.url, knownDigest: digest)))
+                    } catch {
+                        return (subscription, .failure(error))
+                    }
+                }
+            }
+            for _ in 0..<Self.maxConcurrentRefreshes { enqueueNext() }
+            for await (subscription, outcome) in group {
+                switch outcome {
+                case .success(let result): apply(result, to: subscription.id)
+                case .failure(let error):  failures.append((subscription, error))
+                }
+                enqueueNext()
+            }
+        }
+        return failures
+    }
+
+    /// A digest is only trusted while the configurations it produced are still there.
+    private func knownDigest(for subscription: Subscription) -> Data? {
+        guard !ConfigurationStore.shared.configurations(for: subscription).isEmpty else { return nil }
+        return bodyDigests[subscription.id]
+    }
+
+    private func apply(_ result: SubscriptionFetcher.Result, to subscriptionId: UUID) {
+        // Re-resolve: the subscription may have been renamed or deleted across the await.
+        guard let subscription = subscriptions.first(where: { $0.id == subscriptionId }) else { return }
+
+        if !result.isUnchanged {
+            let oldConfigurations = ConfigurationStore.shared.configurations(for: subscription)
+            let newConfigurations = Self.matchingIDs(of: result.configurations, to: oldConfigurations, subscriptionId: subscription.id)
+            // A body that changed only in ways that don't reach the configurations (comments, rules,
+            // ordering of other sections) leaves the store — and the tunnel — untouched.
+            if newConfigurations != oldConfigurations {
+                ConfigurationStore.shared.replaceConfigurations(for: subscription.id, with: newConfigurations)
+            }
+        }
+        bodyDigests[subscription.id] = result.digest
+
+        var updated = subscription
+        updated.lastUpdate = Date()
+        updated.upload = result.upload ?? subscription.upload
+        updated.download = result.download ?? subscription.download
+        updated.total = result.total ?? subscription.total
+        updated.expire = result.expire ?? subscription.expire
+        if let name = result.name, !updated.isNameCustomized {
+            updated.name = name
+        }
+        update(updated)
+    }
 
-        // Configs sharing a name match positionally within that group.
-        let oldConfigurations = ConfigurationStore.shared.configurations(for: subscription)
+    /// Configs sharing a name match positionally within that group.
+    private static func matchingIDs(of fetched: [ProxyConfiguration], to oldConfigurations: [ProxyConfiguration], subscriptionId: UUID) -> [ProxyConfiguration] {
         var oldByName: [String: [ProxyConfiguration]] = [:]
         for old in oldConfigurations {
             oldByName[old.name, default: []].append(old)
@@ -165,7 +235,7 @@ extension SubscriptionStore {
         var oldNameCursor: [String: Int] = [:]
 
         var newConfigurations: [ProxyConfiguration] = []
-        for configuration in result.configurations {
+        for configuration in fetched {
             let name = configuration.name
             let cursor = oldNameCursor[name, default: 0]
             let id: UUID
@@ -178,22 +248,10 @@ extension SubscriptionStore {
             newConfigurations.append(ProxyConfiguration(
                 id: id, name: configuration.name,
                 serverAddress: configuration.serverAddress, serverPort: configuration.serverPort,
-                subscriptionId: subscription.id,
+                subscriptionId: subscriptionId,
                 outbound: configuration.outbound
             ))
         }
-
-        ConfigurationStore.shared.replaceConfigurations(for: subscription.id, with: newConfigurations)
-
-        var updated = subscription
-        updated.lastUpdate = Date()
-        updated.upload = result.upload ?? subscription.upload
-        updated.download = result.download ?? subscription.download
-        updated.total = result.total ?? subscription.total
-        updated.expire = result.expire ?? subscription.expire
-        if let name = result.name, !updated.isNameCustomized {
-            updated.name = name
-        }
-        update(updated)
+        return newConfigurations
     }
 }
@@ -31,6 +31,7 @@ final class MITMCertificateStore {
     private static let privateKeyTag = "\(service).caPrivateKey".data(using: .utf8)!
     private static let certAccount = "\(service).caCertificate"
     private static let serialAccount = "\(service).caSerial"
+    private static let leafCacheKeyAccount = "\(service).leafCacheKey"
 
     private static let caSubjectCN = "Anywhere Root Certificate"
     private static let caOrganization = "Anywhere"
@@ -258,6 +259,7 @@ final class MITMCertificateStore {
         deletePrivateKey()
         deleteCertificate()
         deleteSerial()
+        deleteLeafCacheKey()
     }
 
     // MARK: - Private — Keychain (Private Key)
@@ -387,6 +389,58 @@ final class MITMCertificateStore {
         SecItemDelete(query as CFDictionary)
     }
 
+    // MARK: - Leaf Cache Key
+
+    /// AES-256 key sealing the Network Extension's on-disk leaf cache; created on first use and
+    /// dropped with the CA, which orphans every leaf sealed under it.
+    func loadOrCreateLeafCacheKey() -> SymmetricKey? {
+        lock.lock()
+        defer { lock.unlock() }
+        if let existing = readLeafCacheKeyUnlocked() {
+            return existing
+        }
+        let key = SymmetricKey(size: .bits256)
+        let data = key.withUnsafeBytes { Data($0) }
+        let attributes: [String: Any] = [
+            kSecClass as String: kSecClassGenericPassword,
+            kSecAttrService as String: Self.service,
+            kSecAttrAccount as String: Self.leafCacheKeyAccount,
+            kSecValueData as String: data,
+            kSecAttrAccessible as String: kSecAttrAccessibleAfterFirstUnlockThisDeviceOnly,
+            kSecAttrAccessGroup as String: accessGroup,
+        ]
+        let status = SecItemAdd(attributes as CFDictionary, nil)
+        if status == errSecDuplicateItem {
+            // The other App Group process won the race.
+            return readLeafCacheKeyUnlocked()
+        }
+        return status == errSecSuccess ? key : nil
+    }
+
+    private func readLeafCacheKeyUnlocked() -> SymmetricKey? {
+        let query: [String: Any] = [
+            kSecClass as String: kSecClassGenericPassword,
+            kSecAttrService as String: Self.service,
+            kSecAttrAccount as String: Self.leafCacheKeyAccount,
+            kSecReturnData as String: true,
+            kSecAttrAccessGroup as String: accessGroup,
+        ]
+        var item: CFTypeRef?
+        let status = SecItemCopyMatching(query as CFDictionary, &item)
+        guard status == errSecSuccess, let data = item as? Data, data.count == 32 else { return nil }
+        return SymmetricKey(data: data)
+    }
+
+    private func deleteLeafCacheKey() {
+        let query: [String: Any] = [
+            kSecClass as String: kSecClassGenericPassword,
+            kSecAttrService as String: Self.service,
+            kSecAttrAccount as String: Self.leafCacheKeyAccount,
+            kSecAttrAccessGroup as String: accessGroup,
+        ]
+        SecItemDelete(query as CFDictionary)
+    }
+
     // MARK: - Private — Keychain (Legacy serial item)
 
     /// Purges the legacy monotonic-counter serial item left behind by old installs; serials are now random.
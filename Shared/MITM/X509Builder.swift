@@ -66,9 +66,66 @@ enum X509Builder {
         notBefore: Date,
         notAfter: Date
     ) throws -> Data {
+        let template = try makeLeafTemplate(
+            leafPublicKey: leafPublicKey,
+            caCertificateDER: caCertificateDER,
+            notBefore: notBefore,
+            notAfter: notAfter
+        )
+        return try buildLeafCertificate(template: template, caPrivateKey: caPrivateKey, hostname: hostname, serial: serial)
+    }
+
+    /// The hostname-independent parts of a leaf TBSCertificate, encoded once per CA, leaf
+    /// key and validity window. DER lengths depend on the hostname, so a leaf is assembled
+    /// from these segments around its serial, subject and SAN rather than patched in place.
+    struct LeafTemplate {
+        let caCertificateDER: Data
+        let notBefore: Date
+        let notAfter: Date
+        /// signature algorithm, issuer and validity: everything between serial and subject.
+        fileprivate let signatureIssuerValidity: Data
+        fileprivate let spki: Data
+        /// basicConstraints, keyUsage, extKeyUsage, SKI and AKID, each fully encoded.
+        fileprivate let fixedExtensions: Data
+    }
+
+    /// Parses the CA and encodes everything a leaf shares with its siblings.
+    static func makeLeafTemplate(
+        leafPublicKey: P256.Signing.PublicKey,
+        caCertificateDER: Data,
+        notBefore: Date,
+        notAfter: Date
+    ) throws -> LeafTemplate {
         let leafSPKI = try buildECP256SPKI(publicKeyX963: leafPublicKey.x963Representation)
         let caComponents = try parseCAComponents(certDER: caCertificateDER)
 
+        var signatureIssuerValidity = algorithmECDSAWithSHA256
+        signatureIssuerValidity.append(caComponents.subjectDN)
+        signatureIssuerValidity.append(encodeValidity(notBefore: notBefore, notAfter: notAfter))
+
+        var fixedExtensions = encodeBasicConstraintsLeaf()
+        fixedExtensions.append(encodeKeyUsage(keyCertSign: false, cRLSign: false, digitalSignature: true))
+        fixedExtensions.append(encodeExtendedKeyUsageServerAuth())
+        fixedExtensions.append(try encodeSubjectKeyIdentifier(spki: leafSPKI))
+        fixedExtensions.append(encodeAuthorityKeyIdentifier(keyIdentifier: caComponents.subjectKeyIdentifier))
+
+        return LeafTemplate(
+            caCertificateDER: caCertificateDER,
+            notBefore: notBefore,
+            notAfter: notAfter,
+            signatureIssuerValidity: signatureIssuerValidity,
+            spki: leafSPKI,
+            fixedExtensions: fixedExtensions
+        )
+    }
+
+    /// Builds a leaf from `template`; byte-identical to the untemplated path. Returns DER.
+    static func buildLeafCertificate(
+        template: LeafTemplate,
+        caPrivateKey: SecKey,
+        hostname: String,
+        serial: Data
+    ) throws -> Data {
         // Strip IPv6 URI brackets so the CN matches the bracket-free SAN address.
         let cnHostname: String
         if hostname.hasPrefix("["), hostname.hasSuffix("]"), hostname.count >= 2 {
@@ -76,29 +133,20 @@ enum X509Builder {
         } else {
             cnHostname = hostname
         }
-        let subject = encodeName(commonName: cnHostname, organization: "Anywhere")
-        let validity = encodeValidity(notBefore: notBefore, notAfter: notAfter)
 
-        let extensions = encodeExtensions([
-            encodeBasicConstraintsLeaf(),
-            encodeKeyUsage(keyCertSign: false, cRLSign: false, digitalSignature: true),
-            encodeExtendedKeyUsageServerAuth(),
-            try encodeSubjectKeyIdentifier(spki: leafSPKI),
-            encodeAuthorityKeyIdentifier(keyIdentifier: caComponents.subjectKeyIdentifier),
-            encodeSubjectAltName(hostname: hostname),
-        ])
+        var extensionList = template.fixedExtensions
+        extensionList.append(encodeSubjectAltName(hostname: hostname))
 
-        let tbs = encodeTBSCertificate(
-            serial: normalizeSerial(serial),
-            issuer: caComponents.subjectDN,
-            validity: validity,
-            subject: subject,
-            spki: leafSPKI,
-            extensions: extensions
-        )
+        var tbs = tbsVersionV3
+        tbs.append(ASN1.rawInteger(normalizeSerial(serial)))
+        tbs.append(template.signatureIssuerValidity)
+        tbs.append(encodeName(commonName: cnHostname, organization: "Anywhere"))
+        tbs.append(template.spki)
+        tbs.append(ASN1.contextSpecific(tag: 3, constructed: true, content: ASN1.sequence(extensionList)))
+        let tbsDER = ASN1.sequence(tbs)
 
-        let signature = try sign(privateKey: caPrivateKey, data: tbs)
-        return encodeCertificate(tbs: tbs, signature: signature)
+        let signature = try sign(privateKey: caPrivateKey, data: tbsDER)
+        return encodeCertificate(tbs: tbsDER, signature: signature)
     }
 
     /// Builds a short-lived leaf certificate issued by the CA for signing a
@@ -532,6 +580,11 @@ enum X509Builder {
 
     // MARK: - TBSCertificate
 
+    /// version [0] EXPLICIT INTEGER (v3 = 2)
+    private static let tbsVersionV3: Data = {
+        ASN1.contextSpecific(tag: 0, constructed: true, content: ASN1.integer(2))
+    }()
+
     private static func encodeTBSCertificate(
         serial: Data,
         issuer: Data,
@@ -540,11 +593,7 @@ enum X509Builder {
         spki: Data,
         extensions: Data
     ) -> Data {
-        var tbs = Data()
-        // version [0] EXPLICIT INTEGER (v3 = 2)
-        let versionInner = ASN1.integer(2)
-        let versionWrapped = ASN1.contextSpecific(tag: 0, constructed: true, content: versionInner)
-        tbs.append(versionWrapped)
+        var tbs = tbsVersionV3
         tbs.append(ASN1.rawInteger(serial))
         tbs.append(algorithmECDSAWithSHA256)
         tbs.append(issuer)
@@ -21,6 +21,8 @@ final class ProxyListItem: Identifiable {
     var isVision: Bool
     var isSelected: Bool
     var latency: LatencyResult?
+    /// Live-traffic record from the running tunnel; nil while it is down or the node unused.
+    var health: NodeHealthEntry?
 
     var tags: [String] {
         var result = [protocolName]
@@ -30,7 +32,7 @@ final class ProxyListItem: Identifiable {
         return result
     }
 
-    init(_ configuration: ProxyConfiguration, isSelected: Bool, latency: LatencyResult?) {
+    init(_ configuration: ProxyConfiguration, isSelected: Bool, latency: LatencyResult?, health: NodeHealthEntry?) {
         id = configuration.id
         subscriptionId = configuration.subscriptionId
         name = configuration.name
@@ -40,10 +42,11 @@ final class ProxyListItem: Identifiable {
         isVision = configuration.hasVisionFlow
         self.isSelected = isSelected
         self.latency = latency
+        self.health = health
     }
 
     /// Assigns only changed fields so observation fires for exactly what moved.
-    func update(_ configuration: ProxyConfiguration, isSelected: Bool, latency: LatencyResult?) {
+    func update(_ configuration: ProxyConfiguration, isSelected: Bool, latency: LatencyResult?, health: NodeHealthEntry?) {
         if name != configuration.name { name = configuration.name }
         if protocolName != configuration.outboundProtocol.name { protocolName = configuration.outboundProtocol.name }
         if transportLayerTag != configuration.displayTransportLayerTag { transportLayerTag = configuration.displayTransportLayerTag }
@@ -51,6 +54,7 @@ final class ProxyListItem: Identifiable {
         if isVision != configuration.hasVisionFlow { isVision = configuration.hasVisionFlow }
         if self.isSelected != isSelected { self.isSelected = isSelected }
         if self.latency != latency { self.latency = latency }
+        if self.health != health { self.health = health }
     }
 }
 
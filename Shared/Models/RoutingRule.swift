@@ -71,9 +71,9 @@ struct RoutingRule: Codable, Equatable, Identifiable {
 ///
 /// All integers little-endian. Layout:
 /// ```
-/// magic       "ARB1"              4 bytes
-/// configLen   UInt32              byte length of the configs JSON blob
-/// configBytes [configLen]         {"<uuid>": {…}, …} (sortedKeys), or "{}"
+/// magic       "ARB2"              4 bytes
+/// configLen   UInt32              byte length of the configuration table
+/// configBytes [configLen]         ConfigurationTable
 /// entryCount  UInt32
 /// entries     entryCount × Entry
 ///
@@ -88,9 +88,19 @@ struct RoutingRule: Codable, Equatable, Identifiable {
 ///   type      UInt8               RoutingRuleType raw value
 ///   valueLen  UInt16              UTF-8 byte length
 ///   value     [valueLen]          UTF-8 domain/CIDR (folded to lowercase on read)
+///
+/// ConfigurationTable:
+///   count     UInt32
+///   configs   count × Configuration, sorted by UUID string
+///
+/// Configuration:
+///   id        [16]                raw UUID bytes
+///   jsonLen   UInt32
+///   json      [jsonLen]           one ProxyConfiguration (sortedKeys); decoded
+///                                 only when a connection first routes to it
 /// ```
 enum RoutingBinaryFormat {
-    static let magic: [UInt8] = [0x41, 0x52, 0x42, 0x31]  // "ARB1"
+    static let magic: [UInt8] = [0x41, 0x52, 0x42, 0x32]  // "ARB2"
 
     enum Tier: UInt8 { case user = 0, adBlock = 1, builtIn = 2, bypass = 3 }
     enum Action: UInt8 { case direct = 0, reject = 1, proxy = 2 }
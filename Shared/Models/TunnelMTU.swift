@@ -0,0 +1,26 @@
+//
+//  TunnelMTU.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// The utun interface MTU. Nothing leaves utun onto a physical link, so a jumbo MTU only
+/// changes how much each packet handed between the kernel and lwIP carries: fewer, larger
+/// segments per byte means fewer `readPackets`/`writePackets` round trips and lwIP calls.
+/// Capped at 15000 by lwIP's `TCP_MSS` ceiling (lwipopts.h).
+enum TunnelMTU: Int, CaseIterable {
+    case standard = 1500
+    case jumbo = 9000
+    case maximum = 15000
+
+    var title: String {
+        switch self {
+        case .standard: return String(localized: "Standard (1500)")
+        case .jumbo: return String(localized: "Jumbo (9000)")
+        case .maximum: return String(localized: "Maximum (15000)")
+        }
+    }
+}
@@ -18,6 +18,18 @@ enum TunnelMessage: Codable, Sendable {
     /// Latency-test the given configuration, independent of the active tunnel. Reply: `LatencyTestResponse`.
     case testLatency(ProxyConfiguration)
 
+    /// Health-probe the group's candidates and keep the default outbound on the best one; nil
+    /// stops auto-selection and leaves the current node in place. No reply.
+    case setAutoSelectGroup(AutoSelectGroup?)
+
+    /// Turn the extension's data-path os_signpost intervals on or off, for an Instruments
+    /// trace of a slow session. Off at every tunnel start. No reply.
+    case setDataPathTracing(Bool)
+
+    /// Turn per-connection qlog capture (`QUICQlogSink`) on or off for QUIC connections opened
+    /// from now on. Off at every tunnel start. No reply.
+    case setQlogCapture(Bool)
+
     /// Query current byte counters. Reply: `StatsResponse`.
     case fetchStats
 
@@ -26,6 +38,9 @@ enum TunnelMessage: Codable, Sendable {
 
     /// Query the recent request log. Reply: `RequestsResponse`.
     case fetchRequests
+
+    /// Query live-traffic health per node. Reply: `NodeHealthResponse`.
+    case fetchNodeHealth
 }
 
 // MARK: - Responses
@@ -39,6 +54,19 @@ struct RouteTrafficEntry: Codable, Sendable, Identifiable, Hashable {
     var totalBytes: Int64 { bytesIn + bytesOut }
 }
 
+/// One row of the extension's per-domain top-K table. Totals may overstate the domain's
+/// true bytes by up to `errorBytes`, inherited from the entry it displaced.
+struct DomainTrafficEntry: Codable, Sendable, Identifiable, Hashable {
+    var domain: String
+    var target: RouteTarget
+    var bytesIn: Int64
+    var bytesOut: Int64
+    var errorBytes: Int64
+
+    var id: String { domain }
+    var totalBytes: Int64 { bytesIn + bytesOut }
+}
+
 /// Point-in-time tunnel telemetry snapshot. Byte counters are cumulative
 /// **payload** bytes since tunnel start (no IP/transport headers), split per route.
 struct StatsResponse: Codable, Sendable {
@@ -61,6 +89,10 @@ struct StatsResponse: Codable, Sendable {
     var avgDialMs: Int?
     /// Session-average proxy handshake time in ms.
     var avgHandshakeMs: Int?
+    /// Data-plane counters; nil from an extension that predates them.
+    var hotPath: HotPathStats?
+    /// Heaviest domains by payload bytes, descending; empty from an older extension.
+    var domains: [DomainTrafficEntry]
 
     init(
         bytesIn: Int64,
@@ -74,7 +106,9 @@ struct StatsResponse: Codable, Sendable {
         dialMs: Int? = nil,
         handshakeMs: Int? = nil,
         avgDialMs: Int? = nil,
-        avgHandshakeMs: Int? = nil
+        avgHandshakeMs: Int? = nil,
+        hotPath: HotPathStats? = nil,
+        domains: [DomainTrafficEntry] = []
     ) {
         self.bytesIn = bytesIn
         self.bytesOut = bytesOut
@@ -88,6 +122,8 @@ struct StatsResponse: Codable, Sendable {
         self.handshakeMs = handshakeMs
         self.avgDialMs = avgDialMs
         self.avgHandshakeMs = avgHandshakeMs
+        self.hotPath = hotPath
+        self.domains = domains
     }
 
     // Tolerant decoder: missing keys default to zero/nil so app and extension
@@ -106,7 +142,43 @@ struct StatsResponse: Codable, Sendable {
         handshakeMs = try c.decodeIfPresent(Int.self, forKey: .handshakeMs)
         avgDialMs = try c.decodeIfPresent(Int.self, forKey: .avgDialMs)
         avgHandshakeMs = try c.decodeIfPresent(Int.self, forKey: .avgHandshakeMs)
+        hotPath = try c.decodeIfPresent(HotPathStats.self, forKey: .hotPath)
+        domains = try c.decodeIfPresent([DomainTrafficEntry].self, forKey: .domains) ?? []
+    }
+}
+
+/// Cumulative data-plane counters since tunnel start, for tuning; rates and ratios are left
+/// to the reader (packets per batch, cache hit rate, crypto throughput).
+struct HotPathStats: Codable, Sendable {
+    struct Crypto: Codable, Sendable, Hashable {
+        /// Record-protection layer, e.g. "TLS".
+        var layer: String
+        var sealBytes: Int64
+        var sealNanoseconds: Int64
+        var openBytes: Int64
+        var openNanoseconds: Int64
     }
+
+    var tunReadBatches: Int64
+    var tunReadPackets: Int64
+    var tunWriteBatches: Int64
+    var tunWritePackets: Int64
+    /// Downlink drains lwIP accepted nothing from (ERR_MEM or a zero window) and retried later.
+    var lwipWriteStalls: Int64
+    /// Forwarded DNS queries answered from the extension's response cache, and those sent upstream.
+    var dnsAnswerCacheHits: Int64
+    var dnsAnswerCacheMisses: Int64
+    /// Proxy-server lookups served from `DNSResolver`'s cache, and those that ran `getaddrinfo`.
+    var dnsResolverHits: Int64
+    var dnsResolverMisses: Int64
+    /// Uplink datagrams dropped from a UDP flow's backlog while its outbound connected.
+    var udpPendingDrops: Int64
+    var crypto: [Crypto]
+    /// Packets waiting in the TUN output ring — the output queue's backlog.
+    var outputQueueDepth: Int
+    /// How long a no-op waited to run on the lwIP queue, and on the slowest UDP shard queue, in µs.
+    var lwipQueueDelayMicroseconds: Int
+    var udpQueueDelayMicroseconds: Int
 }
 
 struct LogsResponse: Codable, Sendable {
@@ -117,6 +189,23 @@ struct RequestsResponse: Codable, Sendable {
     var requests: [TunnelRequestEntry]
 }
 
+/// One node's record in the extension's live-traffic table, decayed to the time of the query.
+struct NodeHealthEntry: Codable, Sendable, Identifiable, Hashable {
+    /// The node's `ProxyConfiguration.id`.
+    var id: UUID
+    /// Share of recent dials and connections that failed; nil until there were enough to judge.
+    var failureRate: Double?
+    /// Smoothed dial-to-ready time in ms; nil until a dial succeeded.
+    var connectMs: Int?
+
+    /// Failing often enough that the extension demotes the node in an auto-select group.
+    var isDegraded: Bool { (failureRate ?? 0) >= 0.5 }
+}
+
+struct NodeHealthResponse: Codable, Sendable {
+    var nodes: [NodeHealthEntry]
+}
+
 struct LatencyTestResponse: Codable, Sendable {
     enum Kind: String, Codable, Sendable {
         case success
@@ -148,6 +237,21 @@ extension LatencyTestResponse {
 
 // MARK: - Shared Types
 
+/// Nodes the extension scores in the background and picks the default outbound from, in the
+/// manner of Clash's `url-test` and `fallback` groups.
+struct AutoSelectGroup: Codable, Sendable {
+    enum Policy: String, Codable, Sendable {
+        /// Lowest smoothed latency among healthy candidates.
+        case urlTest
+        /// First healthy candidate in list order.
+        case fallback
+    }
+
+    var policy: Policy
+    /// In preference order, which only `fallback` consults.
+    var candidates: [ProxyConfiguration]
+}
+
 struct TunnelLogEntry: Codable, Sendable, Hashable {
     var id: UUID = UUID()
     /// Seconds since CFAbsoluteTime reference date (Jan 1 2001 UTC).
@@ -33,6 +33,9 @@ nonisolated final class DNSResolver {
     static let echMaxTTL: TimeInterval = 86_400
     static let echNegativeTTL: TimeInterval = 30
     static let echQueryTimeout: TimeInterval = 5
+    /// Lifetime of retry_configs learned from a rejection; the DNS record they replace
+    /// is evidently stale, so they outrank it until then.
+    static let echRetryTTL: TimeInterval = 3600
 
     private struct CacheEntry {
         let ips: [String]
@@ -82,13 +85,18 @@ nonisolated final class DNSResolver {
         let cached = entry?.ips
         let expired = entry.map { $0.expiry <= CFAbsoluteTimeGetCurrent() } ?? false
 
-        if let cached, !expired { return cached }
+        if let cached, !expired {
+            HotPathMetrics.shared.add(.dnsResolverHits)
+            return cached
+        }
 
         if let cached, expired, !forceFresh {
+            HotPathMetrics.shared.add(.dnsResolverHits)
             scheduleBackgroundRefresh(key: key, host: bare)
             return cached
         }
 
+        HotPathMetrics.shared.add(.dnsResolverMisses)
         let ips = Self.resolveViaGetaddrinfo(bare)
         guard !ips.isEmpty else {
             if let cached { return cached }
@@ -320,6 +328,23 @@ nonisolated final class DNSResolver {
         }
     }
 
+    /// Replaces `host`'s cached ECHConfigList with the `retry_configs` its server sent
+    /// on rejecting ECH, so the next dial seals against the current key instead of the
+    /// stale record. The caller must have authenticated the outer handshake.
+    func storeECHRetryConfigs(_ configList: Data, for host: String) {
+        let bare = Self.stripBrackets(host)
+        guard !bare.isEmpty, !Self.isIPAddress(bare),
+              let configs = try? ECHConfigParser.parseConfigList(configList),
+              ECHConfig.pick(from: configs) != nil else { return }
+        let key = Self.cacheKey(for: bare)
+        lock.withWriteLock {
+            let now = CFAbsoluteTimeGetCurrent()
+            echCache[key] = ECHCacheEntry(config: configList, expiry: now + Self.echRetryTTL)
+            compactECHUnlocked(now: now)
+        }
+        logger.debug("[DNS] Cached ECH retry configs for \(bare)")
+    }
+
     /// Blocking system-resolver query for `host`'s HTTPS record, returning the
     /// `ech` SvcParam bytes and the record's TTL, or nil on miss/timeout. Drives
     /// the dns_sd request to completion on the calling (background) queue.
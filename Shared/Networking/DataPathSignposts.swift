@@ -0,0 +1,36 @@
+//
+//  DataPathSignposts.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import os
+
+/// os_signpost intervals around the data-path hot spots, for an Instruments trace of a slow
+/// session. Off by default and toggled from the app (`TunnelMessage.setDataPathTracing`); while
+/// off, `begin` is one relaxed flag load and `end` a nil check.
+///
+///     let signpost = DataPathSignposts.begin("feedLwip")
+///     defer { DataPathSignposts.end("feedLwip", signpost) }
+nonisolated enum DataPathSignposts {
+
+    private static let signposter = OSSignposter(subsystem: "com.argsment.Anywhere", category: "DataPath")
+
+    /// Written only by the app-message handler; a racy read just starts or stops a trace one
+    /// interval late.
+    nonisolated(unsafe) static var isEnabled = false
+
+    @inline(__always)
+    static func begin(_ name: StaticString) -> OSSignpostIntervalState? {
+        guard isEnabled else { return nil }
+        return signposter.beginInterval(name, id: signposter.makeSignpostID())
+    }
+
+    @inline(__always)
+    static func end(_ name: StaticString, _ state: OSSignpostIntervalState?) {
+        guard let state else { return }
+        signposter.endInterval(name, state)
+    }
+}
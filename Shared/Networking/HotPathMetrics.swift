@@ -0,0 +1,146 @@
+//
+//  HotPathMetrics.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Cumulative data-plane counters for the stats snapshot. Writers add into one of a few
+/// independently locked stripes picked by thread, so the queues bumping counters at packet
+/// rate rarely meet on a lock; `snapshot` merges the stripes.
+nonisolated final class HotPathMetrics: @unchecked Sendable {
+    static let shared = HotPathMetrics()
+
+    enum Counter: Int, CaseIterable {
+        case tunReadBatches
+        case tunReadPackets
+        case tunWriteBatches
+        case tunWritePackets
+        /// `drainPendingWrite` placed nothing (ERR_MEM or a zero window) and scheduled a retry.
+        case lwipWriteStalls
+        /// Forwarded (non-A/AAAA) DNS queries answered from `DNSResponseCache`.
+        case dnsAnswerCacheHits
+        case dnsAnswerCacheMisses
+        /// Proxy server lookups `DNSResolver` answered without `getaddrinfo`.
+        case dnsResolverHits
+        case dnsResolverMisses
+        /// Datagrams a connecting UDP flow dropped, oldest first, to stay within its pending ring.
+        case udpPendingDrops
+    }
+
+    /// Record-protection layers with their own seal/open accounting.
+    enum CryptoLayer: Int, CaseIterable {
+        case tls
+        case shadowsocks
+
+        var name: String {
+            switch self {
+            case .tls: return "TLS"
+            case .shadowsocks: return "Shadowsocks"
+            }
+        }
+    }
+
+    enum CryptoDirection: Int, CaseIterable {
+        case seal
+        case open
+    }
+
+    private static let stripeCount = 8
+
+    /// Per crypto layer and direction: bytes, then nanoseconds.
+    private static let cryptoBase = Counter.allCases.count
+    private static let slotCount = cryptoBase + CryptoLayer.allCases.count * CryptoDirection.allCases.count * 2
+
+    private final class Stripe {
+        let lock = UnfairLock()
+        var values = [Int64](repeating: 0, count: HotPathMetrics.slotCount)
+    }
+
+    private let stripes = (0..<HotPathMetrics.stripeCount).map { _ in Stripe() }
+
+    private init() {}
+
+    /// A monotonic nanosecond stamp for timing crypto calls.
+    @inline(__always)
+    static func now() -> UInt64 {
+        clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+    }
+
+    @inline(__always)
+    func add(_ counter: Counter, _ amount: Int = 1) {
+        add(slot: counter.rawValue, amount)
+    }
+
+    /// Folds one seal/open of `bytes` that began at `start` (from `now()`).
+    @inline(__always)
+    func recordCrypto(_ layer: CryptoLayer, _ direction: CryptoDirection, bytes: Int, since start: UInt64) {
+        let elapsed = Self.now() &- start
+        let slot = Self.cryptoSlot(layer, direction)
+        let stripe = currentStripe()
+        stripe.lock.lock()
+        stripe.values[slot] &+= Int64(bytes)
+        stripe.values[slot + 1] &+= Int64(truncatingIfNeeded: elapsed)
+        stripe.lock.unlock()
+    }
+
+    struct Snapshot {
+        private let values: [Int64]
+
+        fileprivate init(values: [Int64]) {
+            self.values = values
+        }
+
+        subscript(_ counter: Counter) -> Int64 { values[counter.rawValue] }
+
+        func cryptoBytes(_ layer: CryptoLayer, _ direction: CryptoDirection) -> Int64 {
+            values[HotPathMetrics.cryptoSlot(layer, direction)]
+        }
+
+        func cryptoNanoseconds(_ layer: CryptoLayer, _ direction: CryptoDirection) -> Int64 {
+            values[HotPathMetrics.cryptoSlot(layer, direction) + 1]
+        }
+    }
+
+    func snapshot() -> Snapshot {
+        var merged = [Int64](repeating: 0, count: Self.slotCount)
+        for stripe in stripes {
+            stripe.lock.lock()
+            for slot in 0..<Self.slotCount {
+                merged[slot] &+= stripe.values[slot]
+            }
+            stripe.lock.unlock()
+        }
+        return Snapshot(values: merged)
+    }
+
+    func reset() {
+        for stripe in stripes {
+            stripe.lock.withLock {
+                stripe.values = [Int64](repeating: 0, count: Self.slotCount)
+            }
+        }
+    }
+
+    // MARK: - Private
+
+    private static func cryptoSlot(_ layer: CryptoLayer, _ direction: CryptoDirection) -> Int {
+        cryptoBase + (layer.rawValue * CryptoDirection.allCases.count + direction.rawValue) * 2
+    }
+
+    @inline(__always)
+    private func add(slot: Int, _ amount: Int) {
+        let stripe = currentStripe()
+        stripe.lock.lock()
+        stripe.values[slot] &+= Int64(amount)
+        stripe.lock.unlock()
+    }
+
+    /// Threads map to stripes by Mach thread port, stable for a thread's lifetime.
+    @inline(__always)
+    private func currentStripe() -> Stripe {
+        stripes[Int(pthread_mach_thread_np(pthread_self())) % Self.stripeCount]
+    }
+}
@@ -26,119 +26,330 @@ nonisolated enum LatencyTester {
     private static let latencyHost = "captive.apple.com"
     private static let latencyPort: UInt16 = 80
 
+    /// Plain-HTTP endpoint serving exactly the requested number of bytes, for throughput probes.
+    private static let downloadHost = "speed.cloudflare.com"
+    private static let downloadTimeout: Duration = .seconds(5)
+
+    /// Upper bound on a probe's download, whatever the caller asks for.
+    static let maxDownloadBytes = 8 << 20
+
+    /// Result of `probe`. `latency` carries the median RTT on success, so callers that rank only by
+    /// latency read it exactly like `test`'s result.
+    struct Probe: Sendable, Hashable {
+        var latency: LatencyResult
+        /// Timed RTTs in ms, in sample order; empty unless the probe succeeded.
+        var samplesMs: [Int] = []
+        /// Mean absolute difference between consecutive samples (RFC 3550 style); nil below two samples.
+        var jitterMs: Int?
+        /// Download rate in bytes/s; nil when not requested or nothing arrived.
+        var throughputBytesPerSecond: Int?
+    }
+
+    /// In-flight cap for batch runs; each test holds one proxy connection for up to `timeout`.
+    static let maxConcurrentTests = 8
+
     /// Only the receive is timed, so the result is the network RTT through the
-    /// full proxy chain; DNS is excluded via pre-warming.
+    /// full proxy chain; DNS is excluded by resolving every hop up front.
     nonisolated static func test(_ configuration: ProxyConfiguration) async -> LatencyResult {
         // Keep probe timings out of the live dial/handshake gauges.
         ConnectionMetrics.shared.suspendRecording()
         defer { ConnectionMetrics.shared.resumeRecording() }
 
-        let testConfiguration = resolvedConfiguration(configuration)
+        let addresses = await resolveHosts(serverAddresses(of: [configuration]))
+        return await measure(configuration, addresses: addresses)
+    }
 
-        do {
-            let latencyMilliseconds = try await withThrowingTaskGroup(of: Int.self) { group in
-                group.addTask {
-                    try await Self.performTest(testConfiguration)
-                }
-                group.addTask {
-                    try await Task.sleep(for: Self.timeout)
-                    throw CancellationError()
+    /// Tests `configurations` with at most `maxConcurrent` in flight, yielding each result as it
+    /// lands. Every distinct server address across all hops is resolved once for the whole batch,
+    /// so nodes sharing a server (or a chain's common entry hop) don't each pay a `getaddrinfo`.
+    /// Finishing or cancelling the consumer's iteration cancels the tests still running.
+    nonisolated static func test(
+        _ configurations: [ProxyConfiguration],
+        maxConcurrent: Int = maxConcurrentTests
+    ) -> AsyncStream<(id: UUID, result: LatencyResult)> {
+        AsyncStream { continuation in
+            let task = Task {
+                ConnectionMetrics.shared.suspendRecording()
+                defer { ConnectionMetrics.shared.resumeRecording() }
+
+                let addresses = await resolveHosts(serverAddresses(of: configurations))
+                await withTaskGroup(of: (id: UUID, result: LatencyResult).self) { group in
+                    var pending = configurations.makeIterator()
+                    func startNext() {
+                        guard let configuration = pending.next() else { return }
+                        group.addTask { (configuration.id, await measure(configuration, addresses: addresses)) }
+                    }
+                    for _ in 0..<max(1, maxConcurrent) { startNext() }
+                    for await outcome in group {
+                        continuation.yield(outcome)
+                        startNext()
+                    }
                 }
-
-                let result = try await group.next()!
-                group.cancelAll()
-                return result
+                continuation.finish()
             }
-            return .success(latencyMilliseconds)
-        } catch let error as TLSError {
-            if case .certificateValidationFailed = error {
-                logger.error("Latency test insecure for \(configuration.name): \(error.localizedDescription)")
-                return .insecure
+            continuation.onTermination = { _ in task.cancel() }
+        }
+    }
+
+    /// Takes `samples` timed round-trips over one warmed connection and reports their median and
+    /// jitter. With `downloadBytes`, it then fetches that many bytes (capped at `maxDownloadBytes`,
+    /// bounded by `downloadTimeout`) through a second connection of the same node to estimate
+    /// throughput; a timed-out download still reports the rate seen so far.
+    nonisolated static func probe(
+        _ configuration: ProxyConfiguration,
+        samples: Int = 5,
+        downloadBytes: Int? = nil
+    ) async -> Probe {
+        ConnectionMetrics.shared.suspendRecording()
+        defer { ConnectionMetrics.shared.resumeRecording() }
+
+        let addresses = await resolveHosts(serverAddresses(of: [configuration]))
+        let testConfiguration = resolvedConfiguration(configuration, addresses: addresses)
+
+        let rtts: [Int]
+        do {
+            // Each sample gets its own timeout budget, so a slow node isn't failed on sample count alone.
+            rtts = try await withTimeout(Self.timeout * max(1, samples)) {
+                try await Self.performTest(testConfiguration, samples: max(1, samples))
             }
-            logger.error("Latency test failed for \(configuration.name): \(error.localizedDescription)")
-            return .failed
         } catch {
-            logger.error("Latency test failed for \(configuration.name): \(error.localizedDescription)")
-            return .failed
+            return Probe(latency: failure(error, configuration: configuration))
+        }
+
+        var probe = Probe(latency: .success(median(rtts)), samplesMs: rtts)
+        if rtts.count > 1 {
+            let deltas = zip(rtts, rtts.dropFirst()).map { abs($1 - $0) }
+            probe.jitterMs = deltas.reduce(0, +) / deltas.count
+        }
+        if let downloadBytes, downloadBytes > 0 {
+            probe.throughputBytesPerSecond = await measureThroughput(
+                testConfiguration,
+                bytes: min(downloadBytes, Self.maxDownloadBytes)
+            )
         }
+        return probe
     }
 
     // MARK: - Private
 
-    /// Re-resolves each hop with NE-process `getaddrinfo` and discards any
-    /// main-app `resolvedIP`: while the tunnel is up, main-app DNS returns lwIP
-    /// fake IPs (198.18.0.0/15) unroutable from the NE's kernel-bypassed sockets.
-    private static func resolvedConfiguration(_ configuration: ProxyConfiguration) -> ProxyConfiguration {
-        let resolvedChain = configuration.chain?.map(resolvedConfiguration)
+    private static func measure(_ configuration: ProxyConfiguration, addresses: [String: String]) async -> LatencyResult {
+        let testConfiguration = resolvedConfiguration(configuration, addresses: addresses)
+
+        do {
+            let latencyMilliseconds = try await withTimeout(Self.timeout) {
+                try await Self.performTest(testConfiguration, samples: 1)[0]
+            }
+            return .success(latencyMilliseconds)
+        } catch {
+            return failure(error, configuration: configuration)
+        }
+    }
+
+    /// Races `operation` against `duration`; the loser is cancelled.
+    private static func withTimeout<T: Sendable>(
+        _ duration: Duration,
+        _ operation: @escaping @Sendable () async throws -> T
+    ) async throws -> T {
+        try await withThrowingTaskGroup(of: T.self) { group in
+            group.addTask {
+                try await operation()
+            }
+            group.addTask {
+                try await Task.sleep(for: duration)
+                throw CancellationError()
+            }
+
+            let result = try await group.next()!
+            group.cancelAll()
+            return result
+        }
+    }
+
+    private static func failure(_ error: Error, configuration: ProxyConfiguration) -> LatencyResult {
+        if let error = error as? TLSError, case .certificateValidationFailed = error {
+            logger.error("Latency test insecure for \(configuration.name): \(error.localizedDescription)")
+            return .insecure
+        }
+        logger.error("Latency test failed for \(configuration.name): \(error.localizedDescription)")
+        return .failed
+    }
+
+    private static func median(_ values: [Int]) -> Int {
+        let sorted = values.sorted()
+        let middle = sorted.count / 2
+        return sorted.count % 2 == 0 ? (sorted[middle - 1] + sorted[middle]) / 2 : sorted[middle]
+    }
+
+    /// Distinct server addresses across every hop, chains included.
+    private static func serverAddresses(of configurations: [ProxyConfiguration]) -> Set<String> {
+        var hosts = Set<String>()
+        func collect(_ configuration: ProxyConfiguration) {
+            hosts.insert(configuration.serverAddress)
+            configuration.chain?.forEach(collect)
+        }
+        configurations.forEach(collect)
+        return hosts
+    }
+
+    /// Resolves each host once with NE-process `getaddrinfo`, `maxConcurrentTests` lookups at a
+    /// time; forceFresh because tests must measure against a fresh address, never a stale one.
+    /// Hosts that fail to resolve are absent from the result.
+    private static func resolveHosts(_ hosts: Set<String>) async -> [String: String] {
+        await withTaskGroup(of: (String, String?).self) { group in
+            var pending = hosts.makeIterator()
+            func startNext() {
+                guard let host = pending.next() else { return }
+                group.addTask { (host, DNSResolver.shared.resolveHost(host, forceFresh: true)) }
+            }
+            for _ in 0..<maxConcurrentTests { startNext() }
+            var addresses: [String: String] = [:]
+            addresses.reserveCapacity(hosts.count)
+            for await (host, address) in group {
+                addresses[host] = address
+                startNext()
+            }
+            return addresses
+        }
+    }
+
+    /// Applies the batch's resolutions to each hop and discards any main-app
+    /// `resolvedIP`: while the tunnel is up, main-app DNS returns lwIP fake IPs
+    /// (198.18.0.0/15) unroutable from the NE's kernel-bypassed sockets.
+    private static func resolvedConfiguration(_ configuration: ProxyConfiguration, addresses: [String: String]) -> ProxyConfiguration {
+        let resolvedChain = configuration.chain?.map { resolvedConfiguration($0, addresses: addresses) }
         return ProxyConfiguration(
             id: configuration.id,
             name: configuration.name,
             serverAddress: configuration.serverAddress,
             serverPort: configuration.serverPort,
-            resolvedIP: DNSResolver.shared.resolveHost(configuration.serverAddress, forceFresh: true),
+            resolvedIP: addresses[configuration.serverAddress],
             subscriptionId: configuration.subscriptionId,
             outbound: configuration.outbound,
             chain: resolvedChain
         )
     }
 
-    private static func performTest(_ configuration: ProxyConfiguration) async throws -> Int {
-        // forceFresh: tests must measure against a fresh address, never a stale one.
-        DNSResolver.shared.prewarm(configuration.serverAddress, forceFresh: true)
-        if let chain = configuration.chain {
-            for proxy in chain {
-                DNSResolver.shared.prewarm(proxy.serverAddress, forceFresh: true)
-            }
-        }
-
+    /// Returns one RTT per sample; every request but the last keeps the connection alive.
+    private static func performTest(_ configuration: ProxyConfiguration, samples: Int) async throws -> [Int] {
         let client = ProxyClient(configuration: configuration, useResolvedAddressForDirectDial: true)
         let resumer = LatencyTester.PendingResumer()
 
         do {
-            let ms = try await withTaskCancellationHandler {
+            let result = try await withTaskCancellationHandler {
                 let proxyConnection = try await Self.establishWarmedConnection(client: client, resumer: resumer)
 
-                // Phase 3 (untimed): send the request.
-                let httpRequest = "HEAD / HTTP/1.1\r\nHost: \(Self.latencyHost)\r\nConnection: close\r\n\r\n".data(using: .utf8)!
-
-                try await awaitCallback(resumer: resumer) { (complete: @escaping (Result<Void, Error>) -> Void) in
-                    proxyConnection.send(data: httpRequest) { error in
-                        if let error { complete(.failure(error)) } else { complete(.success(())) }
+                var rtts: [Int] = []
+                rtts.reserveCapacity(samples)
+                for index in 0..<samples {
+                    // Phase 3 (untimed): send the request.
+                    let connectionHeader = index == samples - 1 ? "close" : "keep-alive"
+                    let httpRequest = "HEAD / HTTP/1.1\r\nHost: \(Self.latencyHost)\r\nConnection: \(connectionHeader)\r\n\r\n".data(using: .utf8)!
+
+                    try await awaitCallback(resumer: resumer) { (complete: @escaping (Result<Void, Error>) -> Void) in
+                        proxyConnection.send(data: httpRequest) { error in
+                            if let error { complete(.failure(error)) } else { complete(.success(())) }
+                        }
                     }
-                }
 
-                // Phase 4 (timed): timer starts after the send completes.
-                let clock = ContinuousClock()
-                let start = clock.now
+                    // Phase 4 (timed): timer starts after the send completes.
+                    let clock = ContinuousClock()
+                    let start = clock.now
 
-                let responseData: Data? = try await awaitCallback(resumer: resumer) { (complete: @escaping (Result<Data?, Error>) -> Void) in
-                    proxyConnection.receive { data, error in
-                        if let error { complete(.failure(error)) } else { complete(.success(data)) }
+                    let responseData: Data? = try await awaitCallback(resumer: resumer) { (complete: @escaping (Result<Data?, Error>) -> Void) in
+                        proxyConnection.receive { data, error in
+                            if let error { complete(.failure(error)) } else { complete(.success(data)) }
+                        }
                     }
-                }
 
-                let elapsed = clock.now - start
+                    let elapsed = clock.now - start
 
-                let statusLine = responseData.flatMap { String(data: $0, encoding: .utf8) }?
-                    .split(separator: "\r\n", maxSplits: 1).first.map(String.init)
-                guard let statusLine, statusLine.contains("200") else {
-                    throw LatencyTestError.unexpectedStatus(statusLine ?? "no response")
-                }
+                    let statusLine = responseData.flatMap { String(data: $0, encoding: .utf8) }?
+                        .split(separator: "\r\n", maxSplits: 1).first.map(String.init)
+                    guard let statusLine, statusLine.contains("200") else {
+                        throw LatencyTestError.unexpectedStatus(statusLine ?? "no response")
+                    }
 
-                return Int(elapsed.components.seconds * 1000 + elapsed.components.attoseconds / 1_000_000_000_000_000)
+                    rtts.append(Int(elapsed.components.seconds * 1000 + elapsed.components.attoseconds / 1_000_000_000_000_000))
+                }
+                return rtts
             } onCancel: {
                 // Unblock the awaiting callback. Do NOT call client.cancel()
                 // here — it races with awaitClientCancel.
                 resumer.cancel()
             }
             await awaitClientCancel(client)
-            return ms
+            return result
         } catch {
             await awaitClientCancel(client)
             throw error
         }
     }
 
+    /// Bytes/s over the bounded download through a fresh client of `configuration`, or nil when
+    /// nothing past the first chunk arrived. The race against `downloadTimeout` keeps whatever
+    /// progress the download made before it lost.
+    private static func measureThroughput(_ configuration: ProxyConfiguration, bytes: Int) async -> Int? {
+        let client = ProxyClient(configuration: configuration, useResolvedAddressForDirectDial: true)
+        let resumer = LatencyTester.PendingResumer()
+        let progress = DownloadProgress()
+
+        await withTaskGroup(of: Void.self) { group in
+            group.addTask {
+                _ = try? await withTaskCancellationHandler {
+                    try await Self.download(bytes, client: client, resumer: resumer, progress: progress)
+                } onCancel: {
+                    resumer.cancel()
+                }
+            }
+            group.addTask {
+                _ = try? await Task.sleep(for: Self.downloadTimeout)
+            }
+            _ = await group.next()
+            group.cancelAll()
+        }
+        await awaitClientCancel(client)
+        return progress.bytesPerSecond
+    }
+
+    private static func download(
+        _ bytes: Int,
+        client: ProxyClient,
+        resumer: PendingResumer,
+        progress: DownloadProgress
+    ) async throws {
+        let proxyConnection: ProxyConnection = try await awaitCallback(resumer: resumer) { complete in
+            client.connect(to: Self.downloadHost, port: Self.latencyPort) { complete($0) }
+        }
+
+        let request = "GET /__down?bytes=\(bytes) HTTP/1.1\r\nHost: \(Self.downloadHost)\r\nConnection: close\r\n\r\n".data(using: .utf8)!
+        try await awaitCallback(resumer: resumer) { (complete: @escaping (Result<Void, Error>) -> Void) in
+            proxyConnection.send(data: request) { error in
+                if let error { complete(.failure(error)) } else { complete(.success(())) }
+            }
+        }
+
+        // Header bytes count toward the bound; the overshoot is a few hundred bytes at most.
+        var received = 0
+        while received < bytes {
+            let data: Data? = try await awaitCallback(resumer: resumer) { (complete: @escaping (Result<Data?, Error>) -> Void) in
+                proxyConnection.receive { data, error in
+                    if let error { complete(.failure(error)) } else { complete(.success(data)) }
+                }
+            }
+            guard let data, !data.isEmpty else { return }
+            if received == 0 {
+                // The body is binary, so only the status line is decoded.
+                let statusLine = String(decoding: data.prefix(32), as: UTF8.self)
+                    .split(separator: "\r\n", maxSplits: 1).first.map(String.init)
+                guard let statusLine, statusLine.contains("200") else {
+                    throw LatencyTestError.unexpectedStatus(statusLine ?? "no response")
+                }
+            }
+            progress.record(data.count)
+            received += data.count
+        }
+    }
+
     /// Waits until the underlying fd is fully closed before the next test runs.
     private static func awaitClientCancel(_ client: ProxyClient) async {
         await withCheckedContinuation { continuation in
@@ -177,6 +388,35 @@ nonisolated enum LatencyTester {
         return proxyConnection
     }
 
+    /// Download byte count and timing. The clock starts at the first chunk, so the handshake and
+    /// time-to-first-byte stay out of the rate and that chunk's bytes are not counted.
+    private final class DownloadProgress: @unchecked Sendable {
+        private let lock = UnfairLock()
+        private var firstChunkAt: ContinuousClock.Instant?
+        private var lastChunkAt: ContinuousClock.Instant?
+        private var bytes = 0
+
+        func record(_ count: Int) {
+            let now = ContinuousClock.now
+            lock.lock(); defer { lock.unlock() }
+            guard firstChunkAt != nil else {
+                firstChunkAt = now
+                return
+            }
+            bytes += count
+            lastChunkAt = now
+        }
+
+        var bytesPerSecond: Int? {
+            lock.lock(); defer { lock.unlock() }
+            guard let firstChunkAt, let lastChunkAt, bytes > 0 else { return nil }
+            let elapsed = lastChunkAt - firstChunkAt
+            let seconds = Double(elapsed.components.seconds) + Double(elapsed.components.attoseconds) / 1e18
+            guard seconds > 0 else { return nil }
+            return Int(Double(bytes) / seconds)
+        }
+    }
+
     /// Cancellation hook that fails whichever phase is currently awaiting.
     private final class PendingResumer: @unchecked Sendable {
         private let lock = UnfairLock()
@@ -37,6 +37,15 @@ nonisolated final class AnyTLSMultiplexer: Multiplexer {
     var seq: UInt64 = 0
 
     private let timerQueue = DispatchQueue(label: AWCore.Identifier.anyTLSSessionTimerQueue)
+
+    /// Past the padding phase, frames from every stream gather here and leave as one inner
+    /// write per `writeQueue` turn, so small frames share a TLS record instead of each
+    /// sealing and sending its own.
+    private let writeQueue = DispatchQueue(label: AWCore.Identifier.anyTLSWriteQueue)
+    private var coalescedWrites: [(bytes: Data, completion: (Error?) -> Void)] = []
+    private var coalesceFlushScheduled = false
+    /// One TLS record's plaintext; a lone larger frame still goes out whole.
+    private static let maxCoalescedBytes = 16_384
     private var synDoneTimer: DispatchSourceTimer?
 
     /// Buffer for partial inbound frames (TLS records don't align with AnyTLS frames).
@@ -217,7 +226,7 @@ nonisolated final class AnyTLSMultiplexer: Multiplexer {
     }
 
     /// Padding-aware writer: buffers while `buffering`, otherwise slices output per the
-    /// padding schedule, topping up with cmdWaste.
+    /// padding schedule, topping up with cmdWaste. Once padding stops, writes are coalesced.
     private func writeConnLocked(_ bytes: Data, completion: @escaping (Error?) -> Void) {
         lock.lock()
         if closed {
@@ -242,11 +251,10 @@ nonisolated final class AnyTLSMultiplexer: Multiplexer {
         }
 
         if !sendPadding {
-            lock.unlock()
             if prependedBufferSize > 0 {
                 logger.debug("[AnyTLSMultiplexer] writeConn flush+raw \(pending.count)B (was buffered=\(prependedBufferSize))")
             }
-            inner.send(data: pending, completion: completion)
+            enqueueCoalescedLocked(pending, completion: completion)
             return
         }
 
@@ -255,9 +263,8 @@ nonisolated final class AnyTLSMultiplexer: Multiplexer {
         let scheme = padding
         if packet >= scheme.stop {
             sendPadding = false
-            lock.unlock()
             logger.debug("[AnyTLSMultiplexer] writeConn pkt=\(packet) ≥ stop=\(scheme.stop) — sending raw, padding off")
-            inner.send(data: pending, completion: completion)
+            enqueueCoalescedLocked(pending, completion: completion)
             return
         }
         let schedule = scheme.generateRecordPayloadSizes(packet: packet)
@@ -310,6 +317,58 @@ nonisolated final class AnyTLSMultiplexer: Multiplexer {
         inner.send(data: output, completion: completion)
     }
 
+    // MARK: - Write Coalescing
+
+    /// Queues `bytes` for the next coalesced write. Caller holds `lock`; returns with it released.
+    private func enqueueCoalescedLocked(_ bytes: Data, completion: @escaping (Error?) -> Void) {
+        coalescedWrites.append((bytes, completion))
+        let schedules = !coalesceFlushScheduled
+        coalesceFlushScheduled = true
+        lock.unlock()
+        if schedules {
+            writeQueue.async { [self] in flushCoalescedWrites() }
+        }
+    }
+
+    /// Joins queued frames, whole, up to `maxCoalescedBytes` into one inner write; whatever is
+    /// left goes out on the next turn. Runs on `writeQueue`, which keeps the writes in order.
+    private func flushCoalescedWrites() {
+        lock.lock()
+        if closed {
+            let abandoned = coalescedWrites
+            coalescedWrites.removeAll()
+            coalesceFlushScheduled = false
+            lock.unlock()
+            for write in abandoned {
+                write.completion(ProxyError.connectionFailed("AnyTLS multiplexer closed"))
+            }
+            return
+        }
+        var output = Data()
+        var completions: [(Error?) -> Void] = []
+        var taken = 0
+        while taken < coalescedWrites.count {
+            let bytes = coalescedWrites[taken].bytes
+            if !output.isEmpty && output.count + bytes.count > Self.maxCoalescedBytes { break }
+            output.append(bytes)
+            completions.append(coalescedWrites[taken].completion)
+            taken += 1
+        }
+        coalescedWrites.removeFirst(taken)
+        let hasMore = !coalescedWrites.isEmpty
+        coalesceFlushScheduled = hasMore
+        lock.unlock()
+
+        inner.send(data: output) { error in
+            for completion in completions {
+                completion(error)
+            }
+        }
+        if hasMore {
+            writeQueue.async { [self] in flushCoalescedWrites() }
+        }
+    }
+
     // MARK: - Read Loop
 
     private func startReadLoop() {
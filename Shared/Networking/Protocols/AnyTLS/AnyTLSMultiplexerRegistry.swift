@@ -71,6 +71,16 @@ nonisolated final class AnyTLSMultiplexerRegistry {
     }
 }
 
+extension AnyTLSMultiplexerRegistry {
+    /// Closes the sessions with no open stream in every pool; the pools stay registered.
+    func closeIdle() {
+        let snapshot = lock.withLock { Array(clients.values) }
+        for client in snapshot {
+            client.closeIdle()
+        }
+    }
+}
+
 extension AnyTLSMultiplexerRegistry: TransportPool {
     func reclaim() { closeAll() }
 }
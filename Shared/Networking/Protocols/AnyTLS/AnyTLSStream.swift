@@ -29,6 +29,9 @@ nonisolated final class AnyTLSStream: ProxyConnection, MultiplexerStreamSink {
     /// Fires exactly once when the stream ends; used to return the multiplexer to the idle pool.
     var onEnd: (() -> Void)?
 
+    /// Destination bootstrap held for the first send (see `deferBootstrap`); guarded by `lock`.
+    private var deferredBootstrap: Data?
+
     init(sid: UInt32, multiplexer: AnyTLSMultiplexer, outerTLSVersion: TLSVersion?) {
         self.sid = sid
         self.multiplexer = multiplexer
@@ -48,11 +51,30 @@ nonisolated final class AnyTLSStream: ProxyConnection, MultiplexerStreamSink {
             completion(ProxyError.connectionFailed("AnyTLS multiplexer deallocated"))
             return
         }
-        multiplexer.writeData(sid: sid, data: data, completion: completion)
+        multiplexer.writeData(sid: sid, data: consumeBootstrap().map { $0 + data } ?? data, completion: completion)
     }
 
     override func sendRaw(data: Data) {
-        multiplexer?.writeData(sid: sid, data: data, completion: { _ in })
+        multiplexer?.writeData(sid: sid, data: consumeBootstrap().map { $0 + data } ?? data, completion: { _ in })
+    }
+
+    /// Holds the first cmdPSH's destination for the first send so the two share one frame.
+    func deferBootstrap(_ bootstrap: Data) {
+        lock.withLock { deferredBootstrap = bootstrap }
+    }
+
+    override func flushDeferredHeader() {
+        if let bootstrap = consumeBootstrap() {
+            multiplexer?.writeData(sid: sid, data: bootstrap, completion: { _ in })
+        }
+    }
+
+    private func consumeBootstrap() -> Data? {
+        lock.lock()
+        defer { lock.unlock() }
+        let bootstrap = deferredBootstrap
+        deferredBootstrap = nil
+        return bootstrap
     }
 
     // MARK: Receive
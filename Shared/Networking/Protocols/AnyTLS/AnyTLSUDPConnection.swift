@@ -35,6 +35,10 @@ nonisolated final class AnyTLSUDPConnection: ProxyConnection, UDPFramingCapable
         super.send(data: frameUDPPacket(data))
     }
 
+    override func send(datagrams: [Data], completion: @escaping (Error?) -> Void) {
+        super.send(data: frameUDPPackets(datagrams), completion: completion)
+    }
+
     override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
         inner.sendRaw(data: data, completion: completion)
     }
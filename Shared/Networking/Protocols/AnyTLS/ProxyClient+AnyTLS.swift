@@ -85,9 +85,13 @@ extension ProxyClient {
                     var bootstrap = AnyTLSProtocol.encodeAddrPort(
                         host: destinationHost, port: destinationPort
                     )
-                    if let initialData, !initialData.isEmpty {
-                        bootstrap.append(initialData)
+                    guard let initialData, !initialData.isEmpty else {
+                        // No payload yet; the first send carries the destination instead.
+                        stream.deferBootstrap(bootstrap)
+                        completion(.success(stream))
+                        return
                     }
+                    bootstrap.append(initialData)
                     logger.debug("[AnyTLS] tcp bootstrap sid=\(stream.sid) bytes=\(bootstrap.count)")
                     stream.send(data: bootstrap) { error in
                         if let error {
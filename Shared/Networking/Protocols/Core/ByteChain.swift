@@ -0,0 +1,84 @@
+//
+//  ByteChain.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// A non-contiguous byte sequence: an ordered list of `Data` segments that share storage with
+/// the buffers they came from. Framers prepend headers and slice payloads without copying; the
+/// bytes are gathered once, where a layer actually needs them contiguous (TLS sealing), or
+/// handed to the socket segment by segment.
+nonisolated struct ByteChain {
+    private(set) var segments: [Data] = []
+    private(set) var count = 0
+
+    init() {}
+
+    init(_ data: Data) {
+        append(data)
+    }
+
+    var isEmpty: Bool { count == 0 }
+
+    mutating func append(_ data: Data) {
+        guard !data.isEmpty else { return }
+        segments.append(data)
+        count += data.count
+    }
+
+    mutating func append(_ chain: ByteChain) {
+        segments.append(contentsOf: chain.segments)
+        count += chain.count
+    }
+
+    mutating func prepend(_ data: Data) {
+        guard !data.isEmpty else { return }
+        segments.insert(data, at: 0)
+        count += data.count
+    }
+
+    /// Bytes `range` (offsets from the start of the chain) as a chain of slices; nothing is copied.
+    func slice(_ range: Range<Int>) -> ByteChain {
+        precondition(range.lowerBound >= 0 && range.upperBound <= count, "ByteChain slice out of bounds")
+        var result = ByteChain()
+        var segmentStart = 0
+        for segment in segments {
+            let segmentEnd = segmentStart + segment.count
+            defer { segmentStart = segmentEnd }
+            guard segmentEnd > range.lowerBound else { continue }
+            guard segmentStart < range.upperBound else { break }
+            let lower = max(range.lowerBound, segmentStart) - segmentStart
+            let upper = min(range.upperBound, segmentEnd) - segmentStart
+            if lower == 0 && upper == segment.count {
+                result.append(segment)
+            } else {
+                result.append(segment[(segment.startIndex + lower)..<(segment.startIndex + upper)])
+            }
+        }
+        return result
+    }
+
+    /// Gathers every segment onto the end of `out`.
+    func copyBytes(appendingTo out: inout Data) {
+        for segment in segments {
+            out.append(segment)
+        }
+    }
+
+    func copyBytes(appendingTo out: inout [UInt8]) {
+        for segment in segments {
+            out.append(contentsOf: segment)
+        }
+    }
+
+    /// The bytes as one `Data`; a single-segment chain returns its segment without copying.
+    func flattened() -> Data {
+        if segments.count == 1 { return segments[0] }
+        var out = Data(capacity: count)
+        copyBytes(appendingTo: &out)
+        return out
+    }
+}
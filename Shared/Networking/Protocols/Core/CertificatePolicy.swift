@@ -16,6 +16,13 @@ nonisolated enum CertificatePolicy {
 
     private static var observerRegistered = false
 
+    /// BLAKE3(chain ‖ hostname) → wall-clock expiry of a passed system trust evaluation.
+    private static var verifiedChains: [Data: CFAbsoluteTime] = [:]
+    private static let maxVerifiedChains = 256
+    /// Bounds a cached result below the leaf's notAfter, so revocation and trust-store
+    /// updates still land within the hour.
+    private static let verifiedChainTTL: CFAbsoluteTime = 3600
+
     /// Idempotent.
     static func startObserving() {
         lock.lock()
@@ -37,9 +44,12 @@ nonisolated enum CertificatePolicy {
 
     static func reload() {
         lock.lock()
-        defer { lock.unlock() }
         _allowInsecure = AWCore.getAllowInsecure()
         _trustedFingerprints = AWCore.getTrustedCertificateFingerprints()
+        verifiedChains.removeAll()
+        lock.unlock()
+        // Resumed sessions skip verification; drop tickets issued under the old policy.
+        TLSSessionTicketCache.shared.removeAll()
     }
 
     static var allowInsecure: Bool {
@@ -62,9 +72,20 @@ nonisolated enum CertificatePolicy {
         case rejected(reason: String)
     }
 
+    /// Whether a connection verified for one name may also carry `serverName` (RFC 9113
+    /// §9.1.1). Only a full trust evaluation counts: `allowInsecure` and a pin vouch for the
+    /// configured server alone.
+    static func covers(chain: [SecCertificate], serverName: String) -> Bool {
+        guard !allowInsecure, let leaf = chain.first, !isPinned(leaf) else { return false }
+        if case .trusted = verify(chain: chain, serverName: serverName) { return true }
+        return false
+    }
+
     /// `chain` is leaf-first. A user-pinned leaf SHA-256 match short-circuits all other
     /// checks: the pin is the user's full trust decision, so chain-of-trust, hostname/SAN,
-    /// and validity-period are not verified. Otherwise standard system SSL trust evaluation.
+    /// and validity-period are not verified. Otherwise standard system SSL trust evaluation,
+    /// whose passes are cached per chain and hostname until the leaf expires (at most
+    /// ``verifiedChainTTL``).
     static func verify(chain: [SecCertificate], serverName: String) -> Verification {
         if allowInsecure {
             return .trusted
@@ -78,6 +99,18 @@ nonisolated enum CertificatePolicy {
             return .trusted
         }
 
+        let cacheKey = verificationCacheKey(chain: chain, serverName: serverName)
+        let now = CFAbsoluteTimeGetCurrent()
+        let cached: Bool = lock.withLock {
+            guard let expiry = verifiedChains[cacheKey] else { return false }
+            if expiry > now { return true }
+            verifiedChains.removeValue(forKey: cacheKey)
+            return false
+        }
+        if cached {
+            return .trusted
+        }
+
         var trust: SecTrust?
         let policy = SecPolicyCreateSSL(true, serverName as CFString)
         guard SecTrustCreateWithCertificates(chain as CFArray, policy, &trust) == errSecSuccess,
@@ -87,6 +120,8 @@ nonisolated enum CertificatePolicy {
 
         var cfError: CFError?
         if SecTrustEvaluateWithError(trust, &cfError) {
+            let leafExpiry = notAfter(of: leaf) ?? now
+            rememberVerified(cacheKey, until: min(leafExpiry, now + verifiedChainTTL), now: now)
             return .trusted
         }
 
@@ -94,6 +129,87 @@ nonisolated enum CertificatePolicy {
         return .rejected(reason: message)
     }
 
+    // MARK: - Verification Cache
+
+    /// Length-prefixed DER per certificate, so differently split chains can't collide.
+    private static func verificationCacheKey(chain: [SecCertificate], serverName: String) -> Data {
+        var hasher = BLAKE3Hasher()
+        for certificate in chain {
+            let der = SecCertificateCopyData(certificate) as Data
+            var length = UInt32(der.count).bigEndian
+            hasher.update(Data(bytes: &length, count: 4))
+            hasher.update(der)
+        }
+        hasher.update(Data(serverName.lowercased().utf8))
+        return hasher.finalizeData()
+    }
+
+    private static func rememberVerified(_ key: Data, until expiry: CFAbsoluteTime, now: CFAbsoluteTime) {
+        guard expiry > now else { return }
+        lock.lock()
+        defer { lock.unlock() }
+        if verifiedChains.count >= maxVerifiedChains {
+            verifiedChains = verifiedChains.filter { $0.value > now }
+            if verifiedChains.count >= maxVerifiedChains {
+                verifiedChains.removeAll()
+            }
+        }
+        verifiedChains[key] = expiry
+    }
+
+    /// The leaf's notAfter as an absolute time, read from the DER:
+    /// Certificate ::= SEQUENCE { tbsCertificate SEQUENCE { [0] version OPTIONAL,
+    /// serialNumber, signature, issuer, validity SEQUENCE { notBefore, notAfter }, ... } ... }
+    private static func notAfter(of certificate: SecCertificate) -> CFAbsoluteTime? {
+        let der = [UInt8](SecCertificateCopyData(certificate) as Data)
+
+        /// Returns (tag, contentStart, contentEnd) of the TLV at `offset`.
+        func element(at offset: Int, end: Int) -> (tag: UInt8, start: Int, end: Int)? {
+            guard offset + 2 <= end else { return nil }
+            let tag = der[offset]
+            var length = Int(der[offset + 1])
+            var start = offset + 2
+            if length & 0x80 != 0 {
+                let count = length & 0x7F
+                guard count >= 1, count <= 4, start + count <= end else { return nil }
+                length = 0
+                for byte in der[start..<(start + count)] { length = length << 8 | Int(byte) }
+                start += count
+            }
+            guard start + length <= end else { return nil }
+            return (tag, start, start + length)
+        }
+
+        guard let certificateSequence = element(at: 0, end: der.count),
+              let tbs = element(at: certificateSequence.start, end: certificateSequence.end) else { return nil }
+        var offset = tbs.start
+        if let version = element(at: offset, end: tbs.end), version.tag == 0xA0 {
+            offset = version.end
+        }
+        // serialNumber, signature, issuer
+        for _ in 0..<3 {
+            guard let skipped = element(at: offset, end: tbs.end) else { return nil }
+            offset = skipped.end
+        }
+        guard let validity = element(at: offset, end: tbs.end),
+              let notBefore = element(at: validity.start, end: validity.end),
+              let notAfter = element(at: notBefore.end, end: validity.end),
+              let text = String(bytes: der[notAfter.start..<notAfter.end], encoding: .ascii) else { return nil }
+
+        // UTCTime (0x17) is YYMMDDHHMMSSZ; GeneralizedTime (0x18) is YYYYMMDDHHMMSSZ.
+        let formatter = DateFormatter()
+        formatter.locale = Locale(identifier: "en_US_POSIX")
+        formatter.timeZone = TimeZone(identifier: "UTC")
+        switch notAfter.tag {
+        case 0x17: formatter.dateFormat = "yyMMddHHmmss'Z'"
+        case 0x18: formatter.dateFormat = "yyyyMMddHHmmss'Z'"
+        default: return nil
+        }
+        // RFC 5280 §4.1.2.5.1: two-digit years 50–99 are 19xx.
+        formatter.twoDigitStartDate = Date(timeIntervalSince1970: -631152000)
+        return formatter.date(from: text)?.timeIntervalSinceReferenceDate
+    }
+
     private static func isPinned(_ leaf: SecCertificate) -> Bool {
         let trusted = trustedFingerprints
         guard !trusted.isEmpty else { return false }
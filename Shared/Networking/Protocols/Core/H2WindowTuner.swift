@@ -0,0 +1,76 @@
+//
+//  H2WindowTuner.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+// MARK: - H2WindowTuner
+
+/// Grows an HTTP/2 receive window to the path's bandwidth-delay product, after gRPC's BDP
+/// estimator: the first DATA after an idle sample sends a PING, bytes received until its
+/// ACK approximate one RTT's worth, and when that sample nearly fills the window while
+/// bandwidth is at its peak the window doubles past it, up to `limit`. A fixed window caps
+/// one stream at window/RTT, which on a 200 ms path is well below link speed.
+/// Not thread-safe; callers guard it with their connection lock.
+nonisolated struct H2WindowTuner {
+
+    /// Opaque PING payload marking BDP probes, so their ACKs aren't confused with keepalives.
+    static let pingPayload = Data([0x42, 0x44, 0x50, 0x50, 0x49, 0x4E, 0x47, 0x00]) // "BDPPING\0"
+
+    /// Upper bound on the tuned window; also bounds per-stream receive buffering.
+    static let defaultLimit = TuningProfile.current.h2WindowLimit
+
+    /// Current window estimate in bytes.
+    private(set) var window: Int
+    private let limit: Int
+
+    private var sample = 0
+    private var sampleCount = 0
+    private var pingSentAt: TimeInterval?
+    private var rtt: TimeInterval = 0
+    private var peakBandwidth: Double = 0
+
+    init(initialWindow: Int, limit: Int = H2WindowTuner.defaultLimit) {
+        self.window = initialWindow
+        self.limit = max(limit, initialWindow)
+    }
+
+    /// Counts `bytes` of received DATA; true when the caller should send a BDP PING now.
+    mutating func noteReceived(_ bytes: Int) -> Bool {
+        guard window < limit, bytes > 0 else { return false }
+        if pingSentAt == nil {
+            pingSentAt = MonotonicClock.now
+            sample = bytes
+            sampleCount += 1
+            return true
+        }
+        sample += bytes
+        return false
+    }
+
+    /// Closes the sample on the probe's ACK; returns the grown window, or nil if unchanged.
+    mutating func pingAcknowledged() -> Int? {
+        guard let sentAt = pingSentAt else { return nil }
+        pingSentAt = nil
+
+        let rttSample = max(MonotonicClock.now - sentAt, 0.001)
+        // Plain mean over the first samples, then an exponential moving average.
+        if sampleCount < 10 {
+            rtt += (rttSample - rtt) / Double(sampleCount)
+        } else {
+            rtt += (rttSample - rtt) * 0.9
+        }
+        // 1.5 × RTT absorbs the ACK's own queueing delay.
+        let bandwidth = Double(sample) / (rtt * 1.5)
+        if bandwidth > peakBandwidth { peakBandwidth = bandwidth }
+
+        guard Double(sample) >= Double(window) * 0.66, bandwidth == peakBandwidth else { return nil }
+        let grown = min(2 * sample, limit)
+        guard grown > window else { return nil }
+        window = grown
+        return grown
+    }
+}
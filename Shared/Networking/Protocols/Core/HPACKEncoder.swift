@@ -7,6 +7,50 @@
 
 import Foundation
 
+/// HPACK dynamic table (RFC 7541 §2.3.2) as a ring buffer: inserting the newest entry and evicting
+/// the oldest are O(1), where an array would shift every entry on each insert.
+nonisolated struct HPACKDynamicTable {
+
+    private var slots: [(name: String, value: String)?] = []
+    /// Slot of the oldest entry.
+    private var head = 0
+    private(set) var count = 0
+
+    var isEmpty: Bool { count == 0 }
+
+    /// The entry `index` positions from the newest (0 = most recently inserted), i.e. HPACK index
+    /// `62 + index`.
+    subscript(index: Int) -> (name: String, value: String) {
+        slots[(head + count - 1 - index) % slots.count]!
+    }
+
+    var oldest: (name: String, value: String)? {
+        count == 0 ? nil : slots[head]
+    }
+
+    mutating func insert(_ entry: (name: String, value: String)) {
+        if count == slots.count { grow() }
+        slots[(head + count) % slots.count] = entry
+        count += 1
+    }
+
+    mutating func removeOldest() {
+        guard count > 0 else { return }
+        slots[head] = nil
+        head = (head + 1) % slots.count
+        count -= 1
+    }
+
+    private mutating func grow() {
+        var grown = [(name: String, value: String)?](repeating: nil, count: max(8, slots.count * 2))
+        for i in 0..<count {
+            grown[i] = slots[(head + i) % slots.count]
+        }
+        slots = grown
+        head = 0
+    }
+}
+
 /// Connection-scoped: the dynamic table persists across all HEADERS frames on one connection
 /// (RFC 7541 §2.2) and is bounded by §4 eviction so a peer cannot grow it unbounded.
 nonisolated class HPACKDecoder {
@@ -25,7 +69,7 @@ nonisolated class HPACKDecoder {
     /// via SETTINGS_MAX_HEADER_LIST_SIZE; mirror it here and advertise the same value in the preface.
     static let maxDecodedHeaderListSize = 256 * 1024
 
-    private var dynamicTable: [(name: String, value: String)] = []
+    private var dynamicTable = HPACKDynamicTable()
 
     /// Running dynamic-table size in octets (RFC 7541 §4.1).
     private var currentSize = 0
@@ -123,23 +167,23 @@ nonisolated class HPACKDecoder {
     private func insertWithEviction(name: String, value: String) {
         let size = entrySize(name: name, value: value)
         // §4.4: evict until the new entry fits, or the table is empty.
-        while currentSize + size > maxSize, let last = dynamicTable.last {
-            currentSize -= entrySize(name: last.name, value: last.value)
-            dynamicTable.removeLast()
+        while currentSize + size > maxSize, let oldest = dynamicTable.oldest {
+            currentSize -= entrySize(name: oldest.name, value: oldest.value)
+            dynamicTable.removeOldest()
         }
         guard size <= maxSize else {
             // §4.4: an over-sized entry empties the table and is not inserted.
             return
         }
-        dynamicTable.insert((name, value), at: 0)
+        dynamicTable.insert((name, value))
         currentSize += size
     }
 
     /// Evicts from the oldest end until the table fits maxSize (RFC 7541 §4.3).
     private func evictToFit() {
-        while currentSize > maxSize, let last = dynamicTable.last {
-            currentSize -= entrySize(name: last.name, value: last.value)
-            dynamicTable.removeLast()
+        while currentSize > maxSize, let oldest = dynamicTable.oldest {
+            currentSize -= entrySize(name: oldest.name, value: oldest.value)
+            dynamicTable.removeOldest()
         }
     }
 }
@@ -204,7 +248,7 @@ enum HPACKEncoder {
     static func decodeHeaders(from data: Data) -> [(name: String, value: String)]? {
         var headers: [(name: String, value: String)] = []
         var offset = data.startIndex
-        var dynamicTable: [(name: String, value: String)] = []
+        var dynamicTable = HPACKDynamicTable()
 
         while offset < data.endIndex {
             let byte = data[offset]
@@ -222,7 +266,7 @@ enum HPACKEncoder {
                 guard let (name, value) = decodeLiteral(from: data, at: &offset, prefixBits: 6,
                                                         dynamicTable: dynamicTable) else { return nil }
                 headers.append((name, value))
-                dynamicTable.insert((name, value), at: 0)
+                dynamicTable.insert((name, value))
 
             } else if byte & 0xF0 == 0x00 || byte & 0xF0 == 0x10 {
                 // §6.2.2/§6.2.3 Literal without Indexing / Never Indexed (0000xxxx / 0001xxxx)
@@ -246,13 +290,13 @@ enum HPACKEncoder {
 
     /// Encodes an integer with the given prefix bit width, appending to `data`.
     ///
-    /// The first byte written shares bits with a `prefix` byte — caller must OR in the high bits.
-    static func encodeInteger(_ value: Int, prefixBits: Int, into data: inout Data) {
+    /// `flags` supplies the representation bits above the prefix in the first byte.
+    static func encodeInteger(_ value: Int, prefixBits: Int, flags: UInt8 = 0, into data: inout Data) {
         let maxPrefix = (1 << prefixBits) - 1
         if value < maxPrefix {
-            data.append(UInt8(value))
+            data.append(flags | UInt8(value))
         } else {
-            data.append(UInt8(maxPrefix))
+            data.append(flags | UInt8(maxPrefix))
             var remaining = value - maxPrefix
             while remaining >= 128 {
                 data.append(UInt8(remaining % 128 + 128))
@@ -306,10 +350,7 @@ enum HPACKEncoder {
             bytes = [UInt8](string.utf8)
         }
         // H=0 (raw), length
-        var lengthData = Data()
-        encodeInteger(bytes.count, prefixBits: 7, into: &lengthData)
-        lengthData[lengthData.startIndex] &= 0x7F  // Clear H bit
-        data.append(lengthData)
+        encodeInteger(bytes.count, prefixBits: 7, into: &data)
         data.append(contentsOf: bytes)
     }
 
@@ -341,25 +382,34 @@ enum HPACKEncoder {
     /// Encodes a §6.1 Indexed Header Field; only called with static indices (1–61),
     /// which fit the 7-bit prefix in a single byte.
     private static func encodeIndexed(_ index: Int, into data: inout Data) {
-        var indexData = Data()
-        encodeInteger(index, prefixBits: 7, into: &indexData)
-        indexData[indexData.startIndex] |= 0x80  // 1xxxxxxx — Indexed Header Field
-        data.append(indexData)
+        encodeInteger(index, prefixBits: 7, flags: 0x80, into: &data)  // 1xxxxxxx — Indexed Header Field
     }
 
     // MARK: - Literal Header Encoding
 
+    /// Encodes a §6.2.1 literal header with incremental indexing, using an indexed name from the
+    /// static table. Meant for request headers repeated on every stream of a connection, so the
+    /// peer can index them.
+    static func encodeLiteralWithIndexing(nameIndex: Int, value: String, into data: inout Data) {
+        encodeInteger(nameIndex, prefixBits: 6, flags: 0x40, into: &data)  // 01xxxxxx prefix
+        encodeString(value, into: &data)
+    }
+
+    /// Encodes a §6.2.1 literal header with incremental indexing, using a literal name.
+    static func encodeLiteralWithIndexing(name: String, value: String, into data: inout Data) {
+        data.append(0x40)  // 0100 0000 — literal name, incremental indexing
+        encodeString(name.lowercased(), into: &data)
+        encodeString(value, into: &data)
+    }
+
     /// Encodes a literal header without indexing, using an indexed name from the static table.
-    private static func encodeLiteralWithoutIndexing(nameIndex: Int, value: String, into data: inout Data) {
-        var indexData = Data()
-        encodeInteger(nameIndex, prefixBits: 4, into: &indexData)
-        indexData[indexData.startIndex] &= 0x0F  // 0000xxxx prefix
-        data.append(indexData)
+    static func encodeLiteralWithoutIndexing(nameIndex: Int, value: String, into data: inout Data) {
+        encodeInteger(nameIndex, prefixBits: 4, into: &data)  // 0000xxxx prefix
         encodeString(value, into: &data)
     }
 
     /// Encodes a literal header without indexing, using a literal name.
-    private static func encodeLiteralWithoutIndexing(name: String, value: String, into data: inout Data) {
+    static func encodeLiteralWithoutIndexing(name: String, value: String, into data: inout Data) {
         data.append(0x00)  // 0000 0000 — literal name, no indexing
         encodeString(name.lowercased(), into: &data)
         encodeString(value, into: &data)
@@ -368,11 +418,7 @@ enum HPACKEncoder {
     /// Encodes a §6.2.3 "Literal Header Field Never Indexed" with an indexed name;
     /// the 0001 prefix forbids every downstream decoder from indexing the field (RFC 7541 §7.1.3).
     private static func encodeLiteralNeverIndexed(nameIndex: Int, value: String, into data: inout Data) {
-        var indexData = Data()
-        encodeInteger(nameIndex, prefixBits: 4, into: &indexData)
-        indexData[indexData.startIndex] &= 0x0F
-        indexData[indexData.startIndex] |= 0x10  // 0001xxxx — never indexed
-        data.append(indexData)
+        encodeInteger(nameIndex, prefixBits: 4, flags: 0x10, into: &data)  // 0001xxxx — never indexed
         encodeString(value, into: &data)
     }
 
@@ -390,7 +436,7 @@ enum HPACKEncoder {
         from data: Data,
         at offset: inout Int,
         prefixBits: Int,
-        dynamicTable: [(name: String, value: String)]
+        dynamicTable: HPACKDynamicTable
     ) -> (name: String, value: String)? {
         guard let nameIndex = decodeInteger(from: data, at: &offset, prefixBits: prefixBits) else {
             return nil
@@ -415,7 +461,7 @@ enum HPACKEncoder {
     /// dynamic table starts at 62.
     static func lookupEntry(
         _ index: Int,
-        dynamicTable: [(name: String, value: String)]
+        dynamicTable: HPACKDynamicTable
     ) -> (name: String, value: String)? {
         guard index >= 1 else { return nil }
         if index <= staticTable.count {
@@ -516,38 +562,73 @@ enum HPACKEncoder {
 
 enum HPACKHuffman {
 
-    /// Trie node for Huffman decoding. Children are array indices; -1 = no child.
-    private struct Node {
-        var left: Int32 = -1
-        var right: Int32 = -1
-        var symbol: Int16 = -1  // >= 0 for leaf nodes, 256 = EOS
-    }
-
-    /// Lazily-built decode trie.
-    private static let tree: [Node] = {
-        var nodes = [Node()]
+    /// One step of the byte-at-a-time decoder, packed as: next state (bits 0–7), the first and
+    /// second symbol completed by the byte (8–15, 16–23), how many it completed (24–25; codes are
+    /// at least 5 bits, so a byte finishes at most two), and `decodeFailure` (26).
+    private typealias Transition = UInt32
+
+    /// Set on a transition that decodes EOS, which §5.2 makes a decoding error.
+    private static let decodeFailure: Transition = 1 << 26
+
+    /// Decode state machine, built once from the code table. The states are the 256 internal
+    /// nodes of the code trie (root = 0), `transitions` is indexed by `state << 8 | byte`, and
+    /// `accepting` marks the states a string may end in: the root, or 1–7 bits down the all-ones
+    /// EOS path (§5.2 padding).
+    private static let decodeTable: (transitions: [Transition], accepting: [Bool]) = {
+        // Trie with children as node indices (-1 = none) and a symbol on each leaf.
+        var left = [-1], right = [-1], symbol = [-1]
         for (sym, entry) in huffmanTable.enumerated() {
             let (code, bits) = entry
-            var index = 0
+            var node = 0
             for bitPos in 0..<Int(bits) {
-                let bit = (code >> (31 - UInt32(bitPos))) & 1
-                if bit == 0 {
-                    if nodes[index].left < 0 {
-                        nodes.append(Node())
-                        nodes[index].left = Int32(nodes.count - 1)
-                    }
-                    index = Int(nodes[index].left)
-                } else {
-                    if nodes[index].right < 0 {
-                        nodes.append(Node())
-                        nodes[index].right = Int32(nodes.count - 1)
-                    }
-                    index = Int(nodes[index].right)
+                let isOne = (code >> (31 - UInt32(bitPos))) & 1 == 1
+                var child = isOne ? right[node] : left[node]
+                if child < 0 {
+                    child = symbol.count
+                    left.append(-1); right.append(-1); symbol.append(-1)
+                    if isOne { right[node] = child } else { left[node] = child }
+                }
+                node = child
+            }
+            symbol[node] = sym
+        }
+
+        var stateOfNode = [Int](repeating: -1, count: symbol.count)
+        var nodeOfState: [Int] = []
+        for node in symbol.indices where symbol[node] < 0 {
+            stateOfNode[node] = nodeOfState.count
+            nodeOfState.append(node)
+        }
+
+        var accepting = [Bool](repeating: false, count: nodeOfState.count)
+        accepting[0] = true
+        var onesPath = 0
+        for _ in 0..<7 {
+            onesPath = right[onesPath]
+            accepting[stateOfNode[onesPath]] = true
+        }
+
+        var transitions = [Transition](repeating: decodeFailure, count: nodeOfState.count << 8)
+        for state in nodeOfState.indices {
+            for byte in 0..<256 {
+                var node = nodeOfState[state]
+                var emitted: Transition = 0
+                var emittedCount: Transition = 0
+                var sawEOS = false
+                for bitPos in stride(from: 7, through: 0, by: -1) {
+                    node = (byte >> bitPos) & 1 == 1 ? right[node] : left[node]
+                    let sym = symbol[node]
+                    guard sym >= 0 else { continue }
+                    if sym == 256 { sawEOS = true; break }
+                    emitted |= Transition(sym) << (8 + 8 * emittedCount)
+                    emittedCount += 1
+                    node = 0
                 }
+                guard !sawEOS else { continue }
+                transitions[(state << 8) | byte] = Transition(stateOfNode[node]) | emitted | (emittedCount << 24)
             }
-            nodes[index].symbol = Int16(sym)
         }
-        return nodes
+        return (transitions, accepting)
     }()
 
     /// Byte length of `string` once Huffman-encoded per RFC 7541 Appendix B.
@@ -559,41 +640,27 @@ enum HPACKHuffman {
         return (bits + 7) / 8
     }
 
-    /// Decodes Huffman bytes, rejecting any RFC 7541 §5.2 violation (off-tree bit,
-    /// explicit EOS, bad padding) so the MITM never re-emits "laundered" malformed input.
+    /// Decodes Huffman bytes a byte at a time, rejecting any RFC 7541 §5.2 violation (explicit
+    /// EOS, bad padding) so the MITM never re-emits "laundered" malformed input.
     static func decode(_ data: some Collection<UInt8>) -> [UInt8]? {
+        let table = decodeTable
         var result: [UInt8] = []
-        var nodeIdx = 0
-        // Bits since the last completed symbol, for validating the trailing padding.
-        var bitsSinceSymbol = 0
-        var paddingAllOnes = true
+        // Codes are at least 5 bits, so n bytes decode to at most 8n/5 symbols.
+        result.reserveCapacity(data.count * 8 / 5)
+        var state = 0
 
         for byte in data {
-            for bitPos in stride(from: 7, through: 0, by: -1) {
-                let bit = (byte >> bitPos) & 1
-                bitsSinceSymbol += 1
-                if bit == 0 { paddingAllOnes = false }
-                let next = bit == 0 ? tree[nodeIdx].left : tree[nodeIdx].right
-                guard next >= 0 else { return nil }
-                nodeIdx = Int(next)
-
-                let sym = tree[nodeIdx].symbol
-                if sym >= 0 {
-                    // RFC 7541 §5.2: an explicit EOS symbol is a decoding error.
-                    if sym == 256 { return nil }
-                    result.append(UInt8(sym))
-                    nodeIdx = 0
-                    bitsSinceSymbol = 0
-                    paddingAllOnes = true
-                }
-            }
+            let transition = table.transitions[(state << 8) | Int(byte)]
+            guard transition & decodeFailure == 0 else { return nil }
+            let emittedCount = (transition >> 24) & 0x3
+            if emittedCount > 0 { result.append(UInt8(truncatingIfNeeded: transition >> 8)) }
+            if emittedCount > 1 { result.append(UInt8(truncatingIfNeeded: transition >> 16)) }
+            state = Int(transition & 0xFF)
         }
 
         // RFC 7541 §5.2: any trailing partial code must be all-ones EOS padding,
-        // strictly fewer than 8 bits; nodeIdx == 0 means no padding at all.
-        if nodeIdx != 0 {
-            guard paddingAllOnes, bitsSinceSymbol < 8 else { return nil }
-        }
+        // strictly fewer than 8 bits.
+        guard table.accepting[state] else { return nil }
         return result
     }
 
@@ -128,6 +128,25 @@ nonisolated class MultiplexerPool<S: Multiplexer> {
         lock.unlock()
     }
 
+    /// Closes every pooled multiplexer with no open stream, ahead of the idle timeout and
+    /// regardless of `minIdleKeep`; the memory-pressure tier that still spares live streams.
+    func closeIdle() {
+        var toClose: [S] = []
+        lock.lock()
+        for key in Array(multiplexers.keys) {
+            guard let muxes = multiplexers[key] else { continue }
+            let idle = muxes.filter { $0.activeStreamCount == 0 }
+            guard !idle.isEmpty else { continue }
+            for mux in idle { lastActivity.removeValue(forKey: ObjectIdentifier(mux)) }
+            let remaining = muxes.filter { mux in !idle.contains { $0 === mux } }
+            multiplexers[key] = remaining.isEmpty ? nil : remaining
+            toClose += idle
+        }
+        lock.unlock()
+
+        for mux in toClose { mux.close(error: nil) }
+    }
+
     /// Closes every pooled multiplexer. Leaves the idle timer running so reused singletons
     /// keep sweeping; per-config pools cancel it in `deinit` when dropped.
     func closeAll() {
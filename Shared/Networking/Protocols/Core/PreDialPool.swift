@@ -0,0 +1,188 @@
+//
+//  PreDialPool.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "PreDialPool")
+
+// MARK: - PreDialPool
+
+/// Warm transports for one outbound, TCP-connected and TLS/REALITY-handshaken where
+/// configured, so the next flow only pays for its protocol header. The target size is the
+/// recent flow arrival rate times the measured dial time: bursts keep a few warm, an idle
+/// outbound keeps none.
+nonisolated final class PreDialPool {
+
+    /// Dials one transport, ready for a protocol handshake on top.
+    typealias Dial = (@escaping (Result<ProxyConnection, Error>) -> Void) -> Void
+
+    /// Under Xray's default 4 s handshake policy, after which the server drops a connection
+    /// that hasn't sent its request header.
+    private static let warmTTL: TimeInterval = 3
+
+    /// Arrivals older than this no longer count toward the rate.
+    private static let arrivalWindow: TimeInterval = 5
+
+    private static let maxWarm = TuningProfile.current.preDialMaxWarm
+
+    private static let expiryQueue = DispatchQueue(label: AWCore.Identifier.preDialExpiryQueue, qos: .utility)
+
+    private let dial: Dial
+
+    private let lock = UnfairLock()
+    private var idle: [(connection: ProxyConnection, readyAt: TimeInterval)] = []
+    private var preparing = 0
+    private var arrivals: [TimeInterval] = []
+    /// Smoothed dial duration; seeded at a typical one-RTT-plus-handshake dial.
+    private var dialTime: TimeInterval = 0.3
+    private var closed = false
+
+    init(dial: @escaping Dial) {
+        self.dial = dial
+    }
+
+    /// Takes a warm transport, or nil when none is ready; either way records the arrival and
+    /// dials toward the target in the background.
+    func take() -> ProxyConnection? {
+        let now = MonotonicClock.now
+        var stale: [ProxyConnection] = []
+        let (selected, dials): (ProxyConnection?, Int) = lock.withLock {
+            guard !closed else { return (nil, 0) }
+            arrivals.append(now)
+            if let firstLive = arrivals.firstIndex(where: { now - $0 < Self.arrivalWindow }), firstLive > 0 {
+                arrivals.removeFirst(firstLive)
+            }
+            var selected: ProxyConnection?
+            while let candidate = idle.popLast() {
+                if now - candidate.readyAt < Self.warmTTL, candidate.connection.isConnected {
+                    selected = candidate.connection
+                    break
+                }
+                stale.append(candidate.connection)
+            }
+            let dials = max(0, targetSizeLocked() - idle.count - preparing)
+            preparing += dials
+            return (selected, dials)
+        }
+        for connection in stale { connection.cancel() }
+        for _ in 0..<dials { startDial() }
+        return selected
+    }
+
+    func closeAll() {
+        let connections: [ProxyConnection] = lock.withLock {
+            closed = true
+            let snapshot = idle.map(\.connection)
+            idle.removeAll()
+            return snapshot
+        }
+        for connection in connections { connection.cancel() }
+    }
+
+    /// A single flow doesn't predict another; two within the window do.
+    private func targetSizeLocked() -> Int {
+        guard arrivals.count >= 2 else { return 0 }
+        let rate = Double(arrivals.count) / Self.arrivalWindow
+        return min(Self.maxWarm, Int((rate * dialTime).rounded(.up)))
+    }
+
+    private func startDial() {
+        let started = MonotonicClock.now
+        dial { [weak self] result in
+            guard let self else {
+                if case .success(let connection) = result { connection.cancel() }
+                return
+            }
+            self.finishDial(result, elapsed: MonotonicClock.now - started)
+        }
+    }
+
+    private func finishDial(_ result: Result<ProxyConnection, Error>, elapsed: TimeInterval) {
+        guard case .success(let connection) = result else {
+            lock.withLock { preparing -= 1 }
+            if case .failure(let error) = result {
+                logger.debug("[PreDialPool] dial failed: \(error.localizedDescription)")
+            }
+            return
+        }
+        let keep: Bool = lock.withLock {
+            preparing -= 1
+            dialTime = dialTime * 0.75 + elapsed * 0.25
+            guard !closed, idle.count < targetSizeLocked() else { return false }
+            idle.append((connection, MonotonicClock.now))
+            return true
+        }
+        guard keep else {
+            connection.cancel()
+            return
+        }
+        Self.expiryQueue.asyncAfter(deadline: .now() + Self.warmTTL) { [weak self] in
+            self?.dropExpired()
+        }
+    }
+
+    /// Closes warm transports past their TTL so they don't sit until the server drops them.
+    private func dropExpired() {
+        let now = MonotonicClock.now
+        let expired: [ProxyConnection] = lock.withLock {
+            let expired = idle.filter { now - $0.readyAt >= Self.warmTTL }.map(\.connection)
+            idle.removeAll { now - $0.readyAt >= Self.warmTTL }
+            return expired
+        }
+        for connection in expired { connection.cancel() }
+    }
+}
+
+// MARK: - PreDialPoolRegistry
+
+/// One ``PreDialPool`` per configuration; a changed configuration replaces its pool.
+nonisolated final class PreDialPoolRegistry {
+
+    static let shared = PreDialPoolRegistry()
+
+    private struct Entry {
+        let configurationHash: Int
+        let outboundProtocol: OutboundProtocol
+        let pool: PreDialPool
+    }
+
+    private let lock = UnfairLock()
+    private var entries: [UUID: Entry] = [:]
+
+    private init() {}
+
+    /// Creates the pool on first use; on reuse the passed `dial` is dropped.
+    func pool(for configuration: ProxyConfiguration, dial: @escaping PreDialPool.Dial) -> PreDialPool {
+        let hash = configuration.hashValue
+        var replaced: PreDialPool?
+        let pool: PreDialPool = lock.withLock {
+            if let entry = entries[configuration.id], entry.configurationHash == hash {
+                return entry.pool
+            }
+            replaced = entries[configuration.id]?.pool
+            let pool = PreDialPool(dial: dial)
+            entries[configuration.id] = Entry(
+                configurationHash: hash,
+                outboundProtocol: configuration.outboundProtocol,
+                pool: pool
+            )
+            return pool
+        }
+        replaced?.closeAll()
+        return pool
+    }
+
+    /// Closes and drops every pool dialing `outboundProtocol`.
+    func reclaim(_ outboundProtocol: OutboundProtocol) {
+        let pools: [PreDialPool] = lock.withLock {
+            let matching = entries.filter { $0.value.outboundProtocol == outboundProtocol }
+            for id in matching.keys { entries.removeValue(forKey: id) }
+            return matching.values.map(\.pool)
+        }
+        for pool in pools { pool.closeAll() }
+    }
+}
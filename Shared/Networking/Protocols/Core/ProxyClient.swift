@@ -31,7 +31,7 @@ private final class TeardownCounter: @unchecked Sendable {
 nonisolated class ProxyClient {
     let configuration: ProxyConfiguration
     let useResolvedAddressForDirectDial: Bool
-    var connection: NWTCPTransport?
+    var connection: (any TCPDialTransport)?
     private var realityClient: RealityClient?
     private var realityConnection: TLSRecordConnection?
     var tlsClient: TLSClient?
@@ -42,6 +42,7 @@ nonisolated class ProxyClient {
     private var webSocketConnection: WebSocketConnection?
     private var httpUpgradeConnection: HTTPUpgradeConnection?
     private var grpcConnection: GRPCConnection?
+    private var grpcStream: GRPCStream?
     private var xhttpConnection: XHTTPConnection?
 
     /// Proxy tunnel from a previous chain link (for proxy chaining).
@@ -368,6 +369,8 @@ nonisolated class ProxyClient {
         webSocketConnection = nil
         httpUpgradeConnection?.cancel()
         httpUpgradeConnection = nil
+        grpcStream?.cancel()
+        grpcStream = nil
         grpcConnection?.cancel()
         grpcConnection = nil
         xhttpConnection?.cancel()
@@ -537,8 +540,16 @@ nonisolated class ProxyClient {
             return
         }
 
-        // Only VLESS reaches this point; Vision needs a TLS-record-like layer
-        // (VLESS Encryption, or a raw TCP transport carrying TLS/Reality).
+        // Only VLESS reaches this point. Direct-route TCP may share a pooled mux.cool
+        // connection; Vision is excluded since Xray refuses TCP sub-connections under it.
+        if command == .tcp, tunnel == nil, !useResolvedAddressForDirectDial, !isVisionFlow,
+           VLESSMuxMultiplexerPool.shared.isEnabled {
+            connectWithVLESSMux(destinationHost: destinationHost, destinationPort: destinationPort, initialData: initialData, completion: completion)
+            return
+        }
+
+        // Vision needs a TLS-record-like layer (VLESS Encryption, or a raw TCP
+        // transport carrying TLS/Reality).
         switch configuration.xrayTransportLayer {
         case .ws:
             connectWithWebSocket(command: command, destinationHost: destinationHost, destinationPort: destinationPort, initialData: initialData, completion: completion)
@@ -576,8 +587,14 @@ nonisolated class ProxyClient {
                 destinationPort: destinationPort, initialData: initialData,
                 supportsVision: transportSupportsVision, completion: completion
             )
+        } else if let warm = takePreDialed(security: .none) {
+            sendProtocolHandshake(
+                over: warm, command: command, destinationHost: destinationHost,
+                destinationPort: destinationPort, initialData: initialData,
+                supportsVision: transportSupportsVision, completion: completion
+            )
         } else {
-            let transport = NWTCPTransport()
+            let transport = DialTransports.tcp()
             self.connection = transport
 
             transport.connect(host: directDialHost, port: configuration.serverPort) { [weak self] error in
@@ -609,6 +626,15 @@ nonisolated class ProxyClient {
         initialData: Data?,
         completion: @escaping (Result<ProxyConnection, Error>) -> Void
     ) {
+        if let warm = takePreDialed(security: .tls(tlsConfig)) {
+            sendProtocolHandshake(
+                over: warm, command: command, destinationHost: destinationHost,
+                destinationPort: destinationPort, initialData: initialData,
+                supportsVision: true, completion: completion
+            )
+            return
+        }
+
         let tlsClient = TLSClient(configuration: tlsConfig)
         self.tlsClient = tlsClient
 
@@ -648,6 +674,15 @@ nonisolated class ProxyClient {
         initialData: Data?,
         completion: @escaping (Result<ProxyConnection, Error>) -> Void
     ) {
+        if let warm = takePreDialed(security: .reality(realityConfig)) {
+            sendProtocolHandshake(
+                over: warm, command: command, destinationHost: destinationHost,
+                destinationPort: destinationPort, initialData: initialData,
+                supportsVision: true, completion: completion
+            )
+            return
+        }
+
         let realityClient = RealityClient(configuration: realityConfig)
         self.realityClient = realityClient
 
@@ -677,6 +712,51 @@ nonisolated class ProxyClient {
         }
     }
 
+    // MARK: - Pre-dialed Transport
+
+    /// A warm transport for this outbound from ``PreDialPoolRegistry``, or nil (dial as
+    /// usual). Chained dials ride a unique tunnel and latency probes must measure a fresh
+    /// handshake, so neither takes one or feeds the pool's arrival rate.
+    func takePreDialed(security: XraySecurityLayer) -> ProxyConnection? {
+        guard tunnel == nil, !useResolvedAddressForDirectDial else { return nil }
+        let host = configuration.serverAddress
+        let port = configuration.serverPort
+        return PreDialPoolRegistry.shared.pool(for: configuration) { completion in
+            ProxyClient.preDial(host: host, port: port, security: security, completion: completion)
+        }.take()
+    }
+
+    private static func preDial(
+        host: String,
+        port: UInt16,
+        security: XraySecurityLayer,
+        completion: @escaping (Result<ProxyConnection, Error>) -> Void
+    ) {
+        switch security {
+        case .none:
+            let transport = DialTransports.tcp()
+            transport.connect(host: host, port: port) { error in
+                if let error { completion(.failure(error)); return }
+                completion(.success(DirectProxyConnection(connection: transport)))
+            }
+        case .tls(let tlsConfig):
+            let client = TLSClient(configuration: tlsConfig)
+            // Anchor the client until its async connect finishes.
+            client.connect(host: host, port: port) { result in
+                withExtendedLifetime(client) {
+                    completion(result.map { TLSProxyConnection(tlsConnection: $0) })
+                }
+            }
+        case .reality(let realityConfig):
+            let client = RealityClient(configuration: realityConfig)
+            client.connect(host: host, port: port) { result in
+                withExtendedLifetime(client) {
+                    completion(result.map { RealityProxyConnection(realityConnection: $0) })
+                }
+            }
+        }
+    }
+
     // MARK: - WebSocket Connection
 
     private func connectWithWebSocket(
@@ -733,7 +813,7 @@ nonisolated class ProxyClient {
                     destinationPort: destinationPort, initialData: initialData, completion: completion
                 )
             } else {
-                let transport = NWTCPTransport()
+                let transport = DialTransports.tcp()
                 self.connection = transport
 
                 transport.connect(host: directDialHost, port: configuration.serverPort) { [weak self] error in
@@ -832,7 +912,7 @@ nonisolated class ProxyClient {
                     destinationPort: destinationPort, initialData: initialData, completion: completion
                 )
             } else {
-                let transport = NWTCPTransport()
+                let transport = DialTransports.tcp()
                 self.connection = transport
 
                 transport.connect(host: directDialHost, port: configuration.serverPort) { [weak self] error in
@@ -885,7 +965,7 @@ nonisolated class ProxyClient {
     // MARK: - gRPC Connection
 
     /// ALPN is forced to `h2` because gRPC requires HTTP/2.
-    private func sanitizedGRPCTLSConfiguration(from base: TLSConfiguration) -> TLSConfiguration {
+    private static func sanitizedGRPCTLSConfiguration(from base: TLSConfiguration) -> TLSConfiguration {
         TLSConfiguration(
             serverName: base.serverName,
             alpn: ["h2"],
@@ -920,6 +1000,39 @@ nonisolated class ProxyClient {
             serverAddress: configuration.serverAddress
         )
 
+        // Direct routes share pooled connections, one stream per tunnel. Chained dials ride a
+        // unique transport and resolved-address dials (latency tests) must measure a fresh
+        // handshake, so both keep a dedicated connection.
+        if tunnel == nil, !useResolvedAddressForDirectDial {
+            let host = configuration.serverAddress
+            let port = configuration.serverPort
+            let security = configuration.xraySecurityLayer
+            let key = "grpc|" + GRPCConnectionPool.makeKey(host: host, port: port, sni: authority)
+                + "|\(grpcConfig.hashValue)|\(security.hashValue)"
+            GRPCConnectionPool.shared.acquireStream(key: key, dialOut: { connectionCompletion in
+                ProxyClient.dialPooledGRPC(
+                    host: host, port: port, security: security,
+                    grpcConfig: grpcConfig, authority: authority, completion: connectionCompletion
+                )
+            }) { [weak self] result in
+                switch result {
+                case .success(let stream):
+                    guard let self else {
+                        stream.cancel()
+                        completion(.failure(ProxyError.connectionFailed("Client deallocated")))
+                        return
+                    }
+                    self.startGRPCTunnel(
+                        stream: stream, command: command, destinationHost: destinationHost,
+                        destinationPort: destinationPort, initialData: initialData, completion: completion
+                    )
+                case .failure(let error):
+                    completion(.failure(error))
+                }
+            }
+            return
+        }
+
         if case .reality(let realityConfig) = configuration.xraySecurityLayer {
             // Reality handles its own ALPN internally; layer gRPC on top.
             let realityClient = RealityClient(configuration: realityConfig)
@@ -956,7 +1069,7 @@ nonisolated class ProxyClient {
         }
 
         if case .tls(let baseTLSConfig) = configuration.xraySecurityLayer {
-            let grpcTLSConfig = sanitizedGRPCTLSConfiguration(from: baseTLSConfig)
+            let grpcTLSConfig = Self.sanitizedGRPCTLSConfiguration(from: baseTLSConfig)
             let tlsClient = TLSClient(configuration: grpcTLSConfig)
             self.tlsClient = tlsClient
 
@@ -997,7 +1110,7 @@ nonisolated class ProxyClient {
                 destinationPort: destinationPort, initialData: initialData, completion: completion
             )
         } else {
-            let transport = NWTCPTransport()
+            let transport = DialTransports.tcp()
             self.connection = transport
             transport.connect(host: directDialHost, port: configuration.serverPort) { [weak self] error in
                 if let error {
@@ -1027,21 +1140,80 @@ nonisolated class ProxyClient {
     ) {
         self.grpcConnection = grpcConnection
 
-        grpcConnection.performSetup { [weak self] error in
-            if let error {
+        grpcConnection.performSetup { [weak self] result in
+            switch result {
+            case .failure(let error):
                 completion(.failure(error))
-                return
-            }
-            guard let self else {
-                completion(.failure(ProxyError.connectionFailed("Client deallocated")))
-                return
+            case .success(let stream):
+                guard let self else {
+                    completion(.failure(ProxyError.connectionFailed("Client deallocated")))
+                    return
+                }
+                self.startGRPCTunnel(
+                    stream: stream, command: command, destinationHost: destinationHost,
+                    destinationPort: destinationPort, initialData: initialData, completion: completion
+                )
             }
-            let grpcProxyConnection = GRPCProxyConnection(grpcConnection: grpcConnection)
-            self.sendProtocolHandshake(
-                over: grpcProxyConnection, command: command, destinationHost: destinationHost,
-                destinationPort: destinationPort, initialData: initialData,
-                supportsVision: transportSupportsVision, completion: completion
+        }
+    }
+
+    private func startGRPCTunnel(
+        stream: GRPCStream,
+        command: ProxyCommand,
+        destinationHost: String,
+        destinationPort: UInt16,
+        initialData: Data?,
+        completion: @escaping (Result<ProxyConnection, Error>) -> Void
+    ) {
+        self.grpcStream = stream
+        let grpcProxyConnection = GRPCProxyConnection(stream: stream)
+        sendProtocolHandshake(
+            over: grpcProxyConnection, command: command, destinationHost: destinationHost,
+            destinationPort: destinationPort, initialData: initialData,
+            supportsVision: transportSupportsVision, completion: completion
+        )
+    }
+
+    /// Dials a transport for a pooled gRPC connection; destination-bound (captures no
+    /// per-flow state) so any flow on the pool key can trigger it.
+    private static func dialPooledGRPC(
+        host: String,
+        port: UInt16,
+        security: XraySecurityLayer,
+        grpcConfig: GRPCConfiguration,
+        authority: String,
+        completion: @escaping (Result<GRPCConnection, Error>) -> Void
+    ) {
+        func bringUp(_ closures: TransportClosures, retaining object: AnyObject) {
+            let connection = GRPCConnection(
+                transport: closures, configuration: grpcConfig, authority: authority, isPooled: true
             )
+            connection.retain(object)
+            completion(.success(connection))
+        }
+        switch security {
+        case .none:
+            let transport = DialTransports.tcp()
+            transport.connect(host: host, port: port) { error in
+                if let error { completion(.failure(error)); return }
+                bringUp(TransportClosures(tcp: transport), retaining: transport)
+            }
+        case .tls(let tlsConfig):
+            let client = TLSClient(configuration: sanitizedGRPCTLSConfiguration(from: tlsConfig))
+            client.connect(host: host, port: port) { result in
+                switch result {
+                case .success(let connection): bringUp(TransportClosures(tls: connection), retaining: client)
+                case .failure(let error): completion(.failure(error))
+                }
+            }
+        case .reality(let realityConfig):
+            let client = RealityClient(configuration: realityConfig)
+            client.connect(host: host, port: port) { result in
+                switch result {
+                case .success(let connection): bringUp(TransportClosures(tls: connection), retaining: client)
+                case .failure(let error): completion(.failure(error))
+                }
+            }
         }
     }
 
@@ -1504,7 +1676,7 @@ nonisolated class ProxyClient {
         }
         switch security {
         case .none:
-            let transport = NWTCPTransport()
+            let transport = DialTransports.tcp()
             transport.connect(host: host, port: port) { error in
                 if let error { completion(.failure(error)); return }
                 bringUp(TransportClosures(tcp: transport), retaining: transport)
@@ -1584,7 +1756,7 @@ nonisolated class ProxyClient {
             if let tunnel = overTunnel {
                 completion(.success(.byteStream(TransportClosures(tunnel: tunnel))))
             } else {
-                let transport = NWTCPTransport()
+                let transport = DialTransports.tcp()
                 retainedXHTTPObjects.append(transport)
                 transport.connect(host: host, port: port) { error in
                     if let error { completion(.failure(error)); return }
@@ -1731,7 +1903,7 @@ nonisolated class ProxyClient {
         }
         switch security {
         case .none:
-            let transport = NWTCPTransport()
+            let transport = DialTransports.tcp()
             transport.connect(host: host, port: port) { error in
                 if error != nil { completion(nil); return }
                 wrap(TransportClosures(tcp: transport), retaining: transport)
@@ -9,7 +9,8 @@ import Foundation
 
 // MARK: - URL Parsing
 
-extension ProxyConfiguration {
+/// Nonisolated so ``ShareLinkBatchParser`` can parse links on concurrent tasks.
+nonisolated extension ProxyConfiguration {
 
     static let parsableURLPrefixes = ["vless://", "hysteria2://", "hy2://", "nowhere://", "trojan://", "anytls://", "ss://", "socks5://", "socks://", "sudoku://"]
 
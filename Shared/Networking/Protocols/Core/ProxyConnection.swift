@@ -58,6 +58,18 @@ nonisolated class ProxyConnection: ProxyConnectionProtocol {
         sendRaw(data: data)
     }
 
+    /// Sends `datagrams` in order, each keeping its boundary, for connections that
+    /// ``deliversDatagrams``; `completion` fires once, with the last send's result. By
+    /// default one `send` each; stream-framed ones override it to make a single write.
+    func send(datagrams: [Data], completion: @escaping (Error?) -> Void) {
+        guard let last = datagrams.last else {
+            completion(nil)
+            return
+        }
+        for datagram in datagrams.dropLast() { send(data: datagram) }
+        send(data: last, completion: completion)
+    }
+
     func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
         fatalError("Subclass must override sendRaw")
     }
@@ -66,6 +78,10 @@ nonisolated class ProxyConnection: ProxyConnectionProtocol {
         fatalError("Subclass must override sendRaw")
     }
 
+    /// Sends on its own a request header held back to share the first payload's write, for
+    /// server-speaks-first sessions that have no payload to carry it. No-op once it's out.
+    func flushDeferredHeader() {}
+
     // MARK: Receive
 
     func receive(completion: @escaping (Data?, Error?) -> Void) {
@@ -95,6 +111,16 @@ nonisolated class ProxyConnection: ProxyConnectionProtocol {
         sendRaw(data: data)
     }
 
+    // MARK: Splice
+
+    /// The socket-level transport once every layer above it passes the downlink
+    /// through untouched (Vision direct copy) and holds nothing read ahead;
+    /// lets the tunnel splice receives past the layer chain. `nil` by default.
+    var directReceiveTransport: (any RawTransport)? { nil }
+
+    /// Uplink counterpart of ``directReceiveTransport``.
+    var directSendTransport: (any RawTransport)? { nil }
+
     // MARK: Receive Loop
 
     /// Starts a continuous receive loop. `errorHandler` receives `nil` on a clean close.
@@ -11,18 +11,35 @@ import Foundation
 
 struct TransportClosures {
     let send: (Data, @escaping (Error?) -> Void) -> Void
+    /// Sends a ``ByteChain``; transports that can't take one natively get it flattened.
+    let sendChain: (ByteChain, @escaping (Error?) -> Void) -> Void
     let receive: (@escaping (Data?, Bool, Error?) -> Void) -> Void
     let cancel: () -> Void
+
+    init(
+        send: @escaping (Data, @escaping (Error?) -> Void) -> Void,
+        sendChain: ((ByteChain, @escaping (Error?) -> Void) -> Void)? = nil,
+        receive: @escaping (@escaping (Data?, Bool, Error?) -> Void) -> Void,
+        cancel: @escaping () -> Void
+    ) {
+        self.send = send
+        self.sendChain = sendChain ?? { chain, completion in send(chain.flattened(), completion) }
+        self.receive = receive
+        self.cancel = cancel
+    }
 }
 
 // MARK: - Transport adapters
 
 extension TransportClosures {
-    init(tcp transport: NWTCPTransport) {
+    init(tcp transport: any TCPDialTransport) {
         self.init(
             send: { data, completion in
                 transport.send(data: data, completion: completion)
             },
+            sendChain: { chain, completion in
+                transport.send(chain: chain, completion: completion)
+            },
             receive: { completion in
                 transport.receive(completion: completion)
             },
@@ -38,6 +55,9 @@ extension TransportClosures {
             send: { data, completion in
                 tlsConnection.send(data: data, completion: completion)
             },
+            sendChain: { chain, completion in
+                tlsConnection.send(chain: chain, completion: completion)
+            },
             receive: { completion in
                 tlsConnection.receive { data, error in
                     completion(data, false, error)
@@ -25,16 +25,43 @@ enum TransportReclaim {
         for proto in OutboundProtocol.allCases {
             switch proto {
             case .vless:
-                VLESSEncryption0RTTCache.shared.clear()
+                PreDialPoolRegistry.shared.reclaim(.vless)
                 XHTTPXMUXMultiplexerRegistry.shared.reclaim()
+                GRPCConnectionPool.shared.reclaim()
+                VLESSMuxMultiplexerPool.shared.reclaim()
             case .hysteria: HysteriaClient.pool.reclaim()
             case .nowhere:  NowhereClient.pool.reclaim()
             case .anytls:   AnyTLSMultiplexerRegistry.shared.reclaim()
             case .sudoku:   SudokuTransportPool.pool.reclaim()
             case .http2:    NaiveHTTP2MultiplexerPool.shared.reclaim()
             case .http3:    NaiveHTTP3MultiplexerPool.shared.reclaim()
+            case .trojan:   PreDialPoolRegistry.shared.reclaim(.trojan)
+            case .shadowsocks: PreDialPoolRegistry.shared.reclaim(.shadowsocks)
             // Per-connection or instance-tier only — no process-wide warm state.
-            case .trojan, .shadowsocks, .socks5, .http11:
+            case .socks5, .http11:
+                break
+            }
+        }
+    }
+
+    /// Called from `lwipQueue` under memory pressure: closes pre-warmed sockets and pooled
+    /// multiplexers carrying no stream, leaving every live session up. Pools that can't tell
+    /// idle from busy are left for `reclaimAll`.
+    static func reclaimIdle() {
+        for proto in OutboundProtocol.allCases {
+            switch proto {
+            case .vless:
+                // XHTTP XMUX managers expose no idle signal; they wait for `reclaimAll`.
+                PreDialPoolRegistry.shared.reclaim(.vless)
+                GRPCConnectionPool.shared.closeIdle()
+                VLESSMuxMultiplexerPool.shared.closeIdle()
+            case .anytls:   AnyTLSMultiplexerRegistry.shared.closeIdle()
+            case .http2:    NaiveHTTP2MultiplexerPool.shared.closeIdle()
+            case .http3:    NaiveHTTP3MultiplexerPool.shared.closeIdle()
+            case .trojan:   PreDialPoolRegistry.shared.reclaim(.trojan)
+            case .shadowsocks: PreDialPoolRegistry.shared.reclaim(.shadowsocks)
+            // Sessions carry live flows with no idle signal exposed, or no warm state at all.
+            case .hysteria, .nowhere, .sudoku, .socks5, .http11:
                 break
             }
         }
@@ -9,7 +9,7 @@ import Foundation
 
 /// Adapts a ``ProxyConnection`` to ``RawTransport`` for proxy chaining: one link's output becomes the next link's socket.
 /// Sends/receives bypass the tunnel's traffic stats (each link tracks its own).
-nonisolated class TunneledTransport: RawTransport {
+nonisolated final class TunneledTransport: RawTransport {
     private let tunnel: ProxyConnection
 
     init(tunnel: ProxyConnection) {
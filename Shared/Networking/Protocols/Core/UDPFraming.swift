@@ -24,6 +24,18 @@ extension UDPFramingCapable {
         return framedData
     }
 
+    /// Frames `datagrams` back to back into one buffer, for a single write.
+    func frameUDPPackets(_ datagrams: [Data]) -> Data {
+        var framedData = Data(capacity: datagrams.reduce(0) { $0 + 2 + $1.count })
+        for data in datagrams {
+            let length = UInt16(data.count)
+            framedData.append(UInt8(length >> 8))
+            framedData.append(UInt8(length & 0xFF))
+            framedData.append(data)
+        }
+        return framedData
+    }
+
     func extractUDPPacket() -> Data? {
         let available = udpBuffer.count - udpBufferOffset
         guard available >= 2 else { return nil }
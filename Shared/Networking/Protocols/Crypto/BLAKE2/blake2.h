@@ -178,6 +178,9 @@ extern "C" {
   /* Simple API */
   int blake2s( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen );
   int blake2b( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen );
+  /* prefixlen + suffixlen <= BLAKE2B_BLOCKBYTES; a single compression. */
+  int blake2b_short( void *out, size_t outlen, const void *prefix, size_t prefixlen,
+                     const void *suffix, size_t suffixlen );
 
   int blake2sp( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen );
   int blake2bp( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen );
@@ -150,6 +150,125 @@ int blake2b_init_key( blake2b_state *S, size_t outlen, const void *key, size_t k
   return 0;
 }
 
+/*
+   Compression of one block into `h` under counter `t` and finalization flags `f`.
+   arm64 builds use the NEON rows below; everything else the reference G/ROUND.
+*/
+#if defined(__aarch64__) && defined(__ARM_NEON)
+
+#include <arm_neon.h>
+
+/* rotr64 on both lanes; right-shift-insert fuses the two shifts and the or. */
+#define NEON_ROTR(x, n) vsriq_n_u64(vshlq_n_u64((x), 64 - (n)), (x), (n))
+#define NEON_ROTR32(x)  vreinterpretq_u64_u32(vrev64q_u32(vreinterpretq_u32_u64(x)))
+
+#define NEON_MSG(a, b) vcombine_u64(vld1_u64(&m[(a)]), vld1_u64(&m[(b)]))
+
+/* Four G functions at once: rows are (l, h) lane pairs of v[0..3], v[4..7], v[8..11], v[12..15]. */
+#define NEON_G(ml, mh, rot_d, rot_b)                                 \
+  do {                                                               \
+    row1l = vaddq_u64(vaddq_u64(row1l, row2l), (ml));                \
+    row1h = vaddq_u64(vaddq_u64(row1h, row2h), (mh));                \
+    row4l = rot_d(veorq_u64(row4l, row1l));                          \
+    row4h = rot_d(veorq_u64(row4h, row1h));                          \
+    row3l = vaddq_u64(row3l, row4l);                                 \
+    row3h = vaddq_u64(row3h, row4h);                                 \
+    row2l = rot_b(veorq_u64(row2l, row3l));                          \
+    row2h = rot_b(veorq_u64(row2h, row3h));                          \
+  } while(0)
+
+#define NEON_ROTR24(x) NEON_ROTR(x, 24)
+#define NEON_ROTR16(x) NEON_ROTR(x, 16)
+#define NEON_ROTR63(x) NEON_ROTR(x, 63)
+
+/* Rotates rows 2-4 left by 1, 2 and 3 lanes so the diagonals line up as columns. */
+#define NEON_DIAGONALIZE()                                           \
+  do {                                                               \
+    uint64x2_t t0 = vextq_u64(row2l, row2h, 1);                      \
+    uint64x2_t t1 = vextq_u64(row2h, row2l, 1);                      \
+    row2l = t0; row2h = t1;                                          \
+    t0 = row3l; row3l = row3h; row3h = t0;                           \
+    t0 = vextq_u64(row4h, row4l, 1);                                 \
+    t1 = vextq_u64(row4l, row4h, 1);                                 \
+    row4l = t0; row4h = t1;                                          \
+  } while(0)
+
+#define NEON_UNDIAGONALIZE()                                         \
+  do {                                                               \
+    uint64x2_t t0 = vextq_u64(row2h, row2l, 1);                      \
+    uint64x2_t t1 = vextq_u64(row2l, row2h, 1);                      \
+    row2l = t0; row2h = t1;                                          \
+    t0 = row3l; row3l = row3h; row3h = t0;                           \
+    t0 = vextq_u64(row4l, row4h, 1);                                 \
+    t1 = vextq_u64(row4h, row4l, 1);                                 \
+    row4l = t0; row4h = t1;                                          \
+  } while(0)
+
+#define NEON_ROUND(r)                                                \
+  do {                                                               \
+    const uint8_t *s = blake2b_sigma[r];                             \
+    NEON_G(NEON_MSG(s[ 0], s[ 2]), NEON_MSG(s[ 4], s[ 6]), NEON_ROTR32, NEON_ROTR24); \
+    NEON_G(NEON_MSG(s[ 1], s[ 3]), NEON_MSG(s[ 5], s[ 7]), NEON_ROTR16, NEON_ROTR63); \
+    NEON_DIAGONALIZE();                                              \
+    NEON_G(NEON_MSG(s[ 8], s[10]), NEON_MSG(s[12], s[14]), NEON_ROTR32, NEON_ROTR24); \
+    NEON_G(NEON_MSG(s[ 9], s[11]), NEON_MSG(s[13], s[15]), NEON_ROTR16, NEON_ROTR63); \
+    NEON_UNDIAGONALIZE();                                            \
+  } while(0)
+
+static void blake2b_compress_block( uint64_t h[8], const uint8_t block[BLAKE2B_BLOCKBYTES],
+                                    const uint64_t t[2], const uint64_t f[2] )
+{
+  uint64_t m[16];
+  size_t i;
+
+  for( i = 0; i < 16; ++i ) {
+    m[i] = load64( block + i * sizeof( m[i] ) );
+  }
+
+  const uint64x2_t h01 = vld1q_u64( &h[0] );
+  const uint64x2_t h23 = vld1q_u64( &h[2] );
+  const uint64x2_t h45 = vld1q_u64( &h[4] );
+  const uint64x2_t h67 = vld1q_u64( &h[6] );
+
+  uint64x2_t row1l = h01, row1h = h23;
+  uint64x2_t row2l = h45, row2h = h67;
+  uint64x2_t row3l = vld1q_u64( &blake2b_IV[0] );
+  uint64x2_t row3h = vld1q_u64( &blake2b_IV[2] );
+  uint64x2_t row4l = veorq_u64( vld1q_u64( &blake2b_IV[4] ), vld1q_u64( t ) );
+  uint64x2_t row4h = veorq_u64( vld1q_u64( &blake2b_IV[6] ), vld1q_u64( f ) );
+
+  NEON_ROUND( 0 );
+  NEON_ROUND( 1 );
+  NEON_ROUND( 2 );
+  NEON_ROUND( 3 );
+  NEON_ROUND( 4 );
+  NEON_ROUND( 5 );
+  NEON_ROUND( 6 );
+  NEON_ROUND( 7 );
+  NEON_ROUND( 8 );
+  NEON_ROUND( 9 );
+  NEON_ROUND( 10 );
+  NEON_ROUND( 11 );
+
+  vst1q_u64( &h[0], veorq_u64( h01, veorq_u64( row1l, row3l ) ) );
+  vst1q_u64( &h[2], veorq_u64( h23, veorq_u64( row1h, row3h ) ) );
+  vst1q_u64( &h[4], veorq_u64( h45, veorq_u64( row2l, row4l ) ) );
+  vst1q_u64( &h[6], veorq_u64( h67, veorq_u64( row2h, row4h ) ) );
+}
+
+#undef NEON_ROTR
+#undef NEON_ROTR32
+#undef NEON_ROTR24
+#undef NEON_ROTR16
+#undef NEON_ROTR63
+#undef NEON_MSG
+#undef NEON_G
+#undef NEON_DIAGONALIZE
+#undef NEON_UNDIAGONALIZE
+#undef NEON_ROUND
+
+#else
+
 #define G(r,i,a,b,c,d)                      \
   do {                                      \
     a = a + b + m[blake2b_sigma[r][2*i+0]]; \
@@ -174,7 +293,8 @@ int blake2b_init_key( blake2b_state *S, size_t outlen, const void *key, size_t k
     G(r,7,v[ 3],v[ 4],v[ 9],v[14]); \
   } while(0)
 
-static void blake2b_compress( blake2b_state *S, const uint8_t block[BLAKE2B_BLOCKBYTES] )
+static void blake2b_compress_block( uint64_t h[8], const uint8_t block[BLAKE2B_BLOCKBYTES],
+                                    const uint64_t t[2], const uint64_t f[2] )
 {
   uint64_t m[16];
   uint64_t v[16];
@@ -185,17 +305,17 @@ static void blake2b_compress( blake2b_state *S, const uint8_t block[BLAKE2B_BLOC
   }
 
   for( i = 0; i < 8; ++i ) {
-    v[i] = S->h[i];
+    v[i] = h[i];
   }
 
   v[ 8] = blake2b_IV[0];
   v[ 9] = blake2b_IV[1];
   v[10] = blake2b_IV[2];
   v[11] = blake2b_IV[3];
-  v[12] = blake2b_IV[4] ^ S->t[0];
-  v[13] = blake2b_IV[5] ^ S->t[1];
-  v[14] = blake2b_IV[6] ^ S->f[0];
-  v[15] = blake2b_IV[7] ^ S->f[1];
+  v[12] = blake2b_IV[4] ^ t[0];
+  v[13] = blake2b_IV[5] ^ t[1];
+  v[14] = blake2b_IV[6] ^ f[0];
+  v[15] = blake2b_IV[7] ^ f[1];
 
   ROUND( 0 );
   ROUND( 1 );
@@ -211,13 +331,20 @@ static void blake2b_compress( blake2b_state *S, const uint8_t block[BLAKE2B_BLOC
   ROUND( 11 );
 
   for( i = 0; i < 8; ++i ) {
-    S->h[i] = S->h[i] ^ v[i] ^ v[i + 8];
+    h[i] = h[i] ^ v[i] ^ v[i + 8];
   }
 }
 
 #undef G
 #undef ROUND
 
+#endif
+
+static void blake2b_compress( blake2b_state *S, const uint8_t block[BLAKE2B_BLOCKBYTES] )
+{
+  blake2b_compress_block( S->h, block, S->t, S->f );
+}
+
 int blake2b_update( blake2b_state *S, const void *pin, size_t inlen )
 {
   const unsigned char * in = (const unsigned char *)pin;
@@ -269,6 +396,44 @@ int blake2b_final( blake2b_state *S, void *out, size_t outlen )
   return 0;
 }
 
+/*
+   One-block unkeyed hash of prefix || suffix (at most BLAKE2B_BLOCKBYTES together): no
+   state struct, no update/final buffering, one compression. Salamander's per-packet
+   BLAKE2b-256(password || salt) lands here.
+*/
+int blake2b_short( void *out, size_t outlen, const void *prefix, size_t prefixlen,
+                   const void *suffix, size_t suffixlen )
+{
+  uint8_t block[BLAKE2B_BLOCKBYTES] = {0};
+  uint8_t buffer[BLAKE2B_OUTBYTES];
+  uint64_t h[8];
+  uint64_t t[2];
+  const uint64_t f[2] = { (uint64_t)-1, 0 };
+  size_t i;
+
+  if ( NULL == out || !outlen || outlen > BLAKE2B_OUTBYTES ) return -1;
+  if ( prefixlen + suffixlen > BLAKE2B_BLOCKBYTES ) return -1;
+  if ( ( NULL == prefix && prefixlen > 0 ) || ( NULL == suffix && suffixlen > 0 ) ) return -1;
+
+  if ( prefixlen > 0 ) memcpy( block, prefix, prefixlen );
+  if ( suffixlen > 0 ) memcpy( block + prefixlen, suffix, suffixlen );
+
+  /* Parameter block word 0: digest_length, key_length 0, fanout 1, depth 1. */
+  for( i = 0; i < 8; ++i ) h[i] = blake2b_IV[i];
+  h[0] ^= 0x01010000ULL ^ (uint64_t)outlen;
+  t[0] = (uint64_t)( prefixlen + suffixlen );
+  t[1] = 0;
+
+  blake2b_compress_block( h, block, t, f );
+
+  for( i = 0; i < 8; ++i )
+    store64( buffer + sizeof( h[i] ) * i, h[i] );
+  memcpy( out, buffer, outlen );
+  secure_zero_memory( block, sizeof( block ) );
+  secure_zero_memory( buffer, sizeof( buffer ) );
+  return 0;
+}
+
 /* inlen, at least, should be uint64_t. Others can be size_t. */
 int blake2b( void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen )
 {
@@ -31,6 +31,11 @@ struct BLAKE2bHasher {
             _ = blake2b_update(&state, raw.baseAddress, raw.count)
         }
     }
+
+    mutating func update(_ raw: UnsafeRawBufferPointer) {
+        guard !raw.isEmpty else { return }
+        _ = blake2b_update(&state, raw.baseAddress, raw.count)
+    }
     
     func finalize() -> [UInt8] {
         var finalState = state
@@ -41,8 +46,25 @@ struct BLAKE2bHasher {
         return out
     }
 
+    /// Writes the digest to `out`, which must hold `outputLength` bytes; no allocation.
+    func finalize(into out: UnsafeMutableRawPointer) {
+        var finalState = state
+        _ = blake2b_final(&finalState, out, outputLength)
+    }
+
     // MARK: - Convenience
     
+    /// Largest `prefix + suffix` ``hashShort(_:_:outputLength:into:)`` takes: one block.
+    static let shortInputLimit = 128
+
+    /// Unkeyed BLAKE2b of `prefix || suffix` in a single compression, skipping the state and its
+    /// buffering. The inputs must total at most ``shortInputLimit`` bytes.
+    static func hashShort(_ prefix: UnsafeRawBufferPointer, _ suffix: UnsafeRawBufferPointer,
+                          outputLength: Int, into out: UnsafeMutableRawPointer) {
+        precondition(prefix.count + suffix.count <= shortInputLimit, "BLAKE2b short input exceeds one block")
+        _ = blake2b_short(out, outputLength, prefix.baseAddress, prefix.count, suffix.baseAddress, suffix.count)
+    }
+
     static func hash256(_ prefix: [UInt8], _ suffix: [UInt8]) -> [UInt8] {
         var hasher = BLAKE2bHasher(outputLength: 32)
         hasher.update(prefix)
@@ -6,6 +6,15 @@
 #include "blake3.h"
 #include "blake3_impl.h"
 
+// On Apple platforms the parallel update path forks subtrees onto libdispatch
+// instead of TBB. Both halves of a split must be at least this long to be worth
+// the hop to another worker thread.
+#if !defined(BLAKE3_USE_TBB) && defined(__APPLE__)
+#define BLAKE3_USE_GCD 1
+#include <dispatch/dispatch.h>
+#define BLAKE3_GCD_MIN_SPLIT_LEN (64 * BLAKE3_CHUNK_LEN)
+#endif
+
 const char *blake3_version(void) { return BLAKE3_VERSION_STRING; }
 
 INLINE void chunk_state_init(blake3_chunk_state *self, const uint32_t key[8],
@@ -249,6 +258,26 @@ INLINE size_t compress_parents_parallel(const uint8_t *child_chaining_values,
   }
 }
 
+#if defined(BLAKE3_USE_GCD)
+// One side of a subtree split, handed to dispatch_apply_f.
+typedef struct {
+  const uint8_t *input;
+  size_t input_len;
+  const uint32_t *key;
+  uint64_t chunk_counter;
+  uint8_t flags;
+  uint8_t *out;
+  size_t n;
+} blake3_subtree_job;
+
+static void blake3_subtree_job_run(void *context, size_t index) {
+  blake3_subtree_job *job = &((blake3_subtree_job *)context)[index];
+  job->n = blake3_compress_subtree_wide(job->input, job->input_len, job->key,
+                                        job->chunk_counter, job->flags,
+                                        job->out, true);
+}
+#endif // BLAKE3_USE_GCD
+
 // The wide helper function returns (writes out) an array of chaining values
 // and returns the length of that array. The number of chaining values returned
 // is the dynamically detected SIMD degree, at most MAX_SIMD_DEGREE. Or fewer,
@@ -314,6 +343,23 @@ size_t blake3_compress_subtree_wide(const uint8_t *input, size_t input_len,
       input, left_input_len, chunk_counter, cv_array, &left_n,
       // right-hand side
       right_input, right_input_len, right_chunk_counter, right_cvs, &right_n);
+#elif defined(BLAKE3_USE_GCD)
+  if (use_tbb && right_input_len >= BLAKE3_GCD_MIN_SPLIT_LEN) {
+    blake3_subtree_job jobs[2] = {
+        {input, left_input_len, key, chunk_counter, flags, cv_array, SIZE_MAX},
+        {right_input, right_input_len, key, right_chunk_counter, flags,
+         right_cvs, SIZE_MAX},
+    };
+    dispatch_apply_f(2, DISPATCH_APPLY_AUTO, jobs, blake3_subtree_job_run);
+    left_n = jobs[0].n;
+    right_n = jobs[1].n;
+  } else {
+    left_n = blake3_compress_subtree_wide(
+        input, left_input_len, key, chunk_counter, flags, cv_array, use_tbb);
+    right_n = blake3_compress_subtree_wide(right_input, right_input_len, key,
+                                           right_chunk_counter, flags,
+                                           right_cvs, use_tbb);
+  }
 #else
   left_n = blake3_compress_subtree_wide(
       input, left_input_len, key, chunk_counter, flags, cv_array, use_tbb);
@@ -596,6 +642,16 @@ void blake3_hasher_update_tbb(blake3_hasher *self, const void *input,
 }
 #endif // BLAKE3_USE_TBB
 
+void blake3_hasher_update_parallel(blake3_hasher *self, const void *input,
+                                   size_t input_len) {
+#if defined(BLAKE3_USE_TBB) || defined(BLAKE3_USE_GCD)
+  bool use_tbb = true;
+#else
+  bool use_tbb = false;
+#endif
+  blake3_hasher_update_base(self, input, input_len, use_tbb);
+}
+
 void blake3_hasher_finalize(const blake3_hasher *self, uint8_t *out,
                             size_t out_len) {
   blake3_hasher_finalize_seek(self, 0, out, out_len);
@@ -73,6 +73,12 @@ BLAKE3_API void blake3_hasher_update(blake3_hasher *self, const void *input,
 BLAKE3_API void blake3_hasher_update_tbb(blake3_hasher *self, const void *input,
                                          size_t input_len);
 #endif // BLAKE3_USE_TBB
+// Like blake3_hasher_update, but hashes large aligned subtrees on multiple
+// threads (TBB when enabled, libdispatch on Apple platforms). Falls back to
+// the serial path elsewhere. Output is identical to blake3_hasher_update.
+BLAKE3_API void blake3_hasher_update_parallel(blake3_hasher *self,
+                                              const void *input,
+                                              size_t input_len);
 BLAKE3_API void blake3_hasher_finalize(const blake3_hasher *self, uint8_t *out,
                                        size_t out_len);
 BLAKE3_API void blake3_hasher_finalize_seek(const blake3_hasher *self, uint64_t seek,
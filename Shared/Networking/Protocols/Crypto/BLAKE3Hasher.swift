@@ -44,6 +44,19 @@ struct BLAKE3Hasher {
         }
     }
 
+    /// Same digest as `update(_:)`; inputs of `parallelThreshold` bytes or more hash
+    /// their aligned subtrees across cores instead of chunk after chunk.
+    mutating func updateParallel(_ data: Data) {
+        guard !data.isEmpty else { return }
+        data.withUnsafeBytes { raw in
+            if raw.count >= Self.parallelThreshold {
+                blake3_hasher_update_parallel(&state, raw.baseAddress, raw.count)
+            } else {
+                blake3_hasher_update(&state, raw.baseAddress, raw.count)
+            }
+        }
+    }
+
     func finalizeData(count: Int = 32) -> Data {
         var out = [UInt8](repeating: 0, count: count)
         withUnsafePointer(to: state) { statePtr in
@@ -56,12 +69,22 @@ struct BLAKE3Hasher {
 
     // MARK: - Convenience
 
+    /// Below this, the fork/join overhead outweighs what extra cores save.
+    static let parallelThreshold = 128 * 1024
+
     static func hash(_ data: Data, count: Int = 32) -> Data {
         var h = BLAKE3Hasher()
         h.update(data)
         return h.finalizeData(count: count)
     }
 
+    /// Digest for multi-megabyte payloads (rule-set and subscription downloads).
+    static func hashParallel(_ data: Data, count: Int = 32) -> Data {
+        var h = BLAKE3Hasher()
+        h.updateParallel(data)
+        return h.finalizeData(count: count)
+    }
+
     static func deriveKey(context: String, input: Data, count: Int = 32) -> Data {
         var h = BLAKE3Hasher(deriveKeyContext: context)
         h.update(input)
@@ -7,10 +7,10 @@
 
 import Foundation
 
-/// Adapts a push-based `NWUDPTransport` to a pull-based `ProxyConnection`; the receive loop is armed lazily on the first `receiveRaw`.
+/// Adapts a push-based ``UDPDialTransport`` to a pull-based `ProxyConnection`; the receive loop is armed lazily on the first `receiveRaw`.
 nonisolated final class DirectUDPProxyConnection: ProxyConnection {
 
-    private let transport: NWUDPTransport
+    private let transport: any UDPDialTransport
 
     private let recvLock = UnfairLock()
     private var recvBuffer: [Data] = []
@@ -22,7 +22,7 @@ nonisolated final class DirectUDPProxyConnection: ProxyConnection {
     /// Bounds memory under a burst the consumer hasn't drained yet.
     private static let maxBufferedDatagrams = 1024
 
-    init(transport: NWUDPTransport) {
+    init(transport: any UDPDialTransport) {
         self.transport = transport
         super.init()
     }
@@ -93,19 +93,27 @@ enum HTTP3Framer {
     }
 
     static func dataFrame(payload: Data) -> Data {
-        var frame = Data()
-        frame.append(contentsOf: QUICVarInt.encode(HTTP3FrameType.data.rawValue))
-        frame.append(contentsOf: QUICVarInt.encode(UInt64(payload.count)))
+        var frame = dataFrameHeader(length: payload.count)
         frame.append(payload)
         return frame
     }
 
+    /// The type and length varints of a DATA frame, for writers that send the payload as
+    /// a separate buffer.
+    static func dataFrameHeader(length: Int) -> Data {
+        var header = Data(capacity: 9)
+        header.append(contentsOf: QUICVarInt.encode(HTTP3FrameType.data.rawValue))
+        header.append(contentsOf: QUICVarInt.encode(UInt64(length)))
+        return header
+    }
+
     static func clientSettingsFrame() -> Data {
         var payload = Data()
 
         payload.append(contentsOf: QUICVarInt.encode(HTTP3SettingsID.qpackMaxTableCapacity.rawValue))
-        payload.append(contentsOf: QUICVarInt.encode(0))
+        payload.append(contentsOf: QUICVarInt.encode(UInt64(QPACKDynamicDecoder.maxTableCapacity)))
 
+        // No blocked streams: a response may only reference inserts already received.
         payload.append(contentsOf: QUICVarInt.encode(HTTP3SettingsID.qpackBlockedStreams.rawValue))
         payload.append(contentsOf: QUICVarInt.encode(0))
 
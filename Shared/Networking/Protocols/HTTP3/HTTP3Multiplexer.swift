@@ -61,14 +61,29 @@ nonisolated class HTTP3Multiplexer: Multiplexer {
     /// RFC 9297: true when the peer enables H3_DATAGRAM (required for CONNECT-UDP).
     private(set) var peerSupportsH3Datagram = false
 
+    /// QPACK dynamic tables (RFC 9204): the encoder exists once the peer's SETTINGS allow a
+    /// table (until then sections reference only the static table); the decoder holds the
+    /// peer's table within the capacity we advertise.
+    private var qpackEncoder: QPACKDynamicEncoder?
+    private let qpackDecoder = QPACKDynamicDecoder()
+    private var encoderStreamID: Int64?
+    private var decoderStreamID: Int64?
+    private var serverEncoderStreamID: Int64?
+    private var serverDecoderStreamID: Int64?
+
     // Pool-visible state, accessed under _poolLock from arbitrary threads; must not
     // touch `streams` or other queue-protected state.
     private let _poolLock = UnfairLock()
     private(set) var isClosed = false
     /// True when ngtcp2 signals STREAM_ID_BLOCKED; the pool creates a new multiplexer instead.
     private(set) var poolIsStreamBlocked = false
+    /// True once the peer's stream credit or connection send window runs low; the pool
+    /// opens a spare multiplexer so a burst never waits on MAX_STREAMS or MAX_DATA.
+    private(set) var poolIsRunningLow = false
     private var _poolStreamCount = 0
     private var _reservedStreams = 0
+    private static let lowStreamHeadroom: UInt64 = 32
+    private static let lowSendWindow: UInt64 = 256 * 1024
     /// Must match `QUICTuning.naive.initialMaxStreamsBidi`; undersizing forces premature multiplexer churn.
     private let maxConcurrentStreams = 512
 
@@ -159,6 +174,7 @@ nonisolated class HTTP3Multiplexer: Multiplexer {
         // Called on queue
         switch state {
         case .ready:
+            refreshHeadroom()
             completion(nil)
         case .draining:
             completion(HTTP3Error.connectionFailed("Session draining (GOAWAY)"))
@@ -174,8 +190,6 @@ nonisolated class HTTP3Multiplexer: Multiplexer {
     }
 
     private func startConnection() {
-        QUICCrypto.registerCallbacks()
-
         // Drain pool entries eagerly on close so no new streams go to a dead multiplexer.
         quic.connectionClosedHandler = { [weak self] error in
             guard let self else { return }
@@ -198,6 +212,7 @@ nonisolated class HTTP3Multiplexer: Multiplexer {
                 }
 
                 self.state = .ready
+                self.refreshHeadroom()
                 let callbacks = self.readyCallbacks
                 self.readyCallbacks.removeAll()
                 for callback in callbacks { callback(nil) }
@@ -215,23 +230,86 @@ nonisolated class HTTP3Multiplexer: Multiplexer {
         }
         // QPACK encoder (type 0x02) and decoder (type 0x03)
         if let sid = quic.openUniStream() {
+            encoderStreamID = sid
             quic.writeStream(sid, data: Data([0x02])) { _ in }
         }
         if let sid = quic.openUniStream() {
+            decoderStreamID = sid
             quic.writeStream(sid, data: Data([0x03])) { _ in }
         }
     }
 
+    // MARK: - QPACK (called on queue)
+
+    /// Encodes a request's field section for `streamID`, writing any dynamic-table inserts to
+    /// the encoder stream ahead of it.
+    func encodeHeaderBlock(_ fields: [(name: String, value: String)], streamID: Int64) -> Data {
+        guard let qpackEncoder else { return QPACKEncoder.encodeFieldSection(fields) }
+        let block = qpackEncoder.encode(fields, streamID: streamID)
+        let instructions = qpackEncoder.takeInstructions()
+        if !instructions.isEmpty, let encoderStreamID {
+            quic.writeStream(encoderStreamID, data: instructions) { _ in }
+        }
+        return block
+    }
+
+    /// Decodes a response field section received on `streamID`, acknowledging it to the
+    /// peer's encoder when it referenced the dynamic table.
+    func decodeHeaderBlock(_ block: Data, streamID: Int64) -> [(name: String, value: String)]? {
+        guard let (fields, requiredInsertCount) =
+                QPACKEncoder.decodeHeaders(from: block, dynamicTable: qpackDecoder) else { return nil }
+        qpackDecoder.acknowledgeSection(streamID: streamID, requiredInsertCount: requiredInsertCount)
+        flushDecoderInstructions()
+        return fields
+    }
+
+    private func flushDecoderInstructions() {
+        let instructions = qpackDecoder.takeInstructions()
+        guard !instructions.isEmpty, let decoderStreamID else { return }
+        quic.writeStream(decoderStreamID, data: instructions) { _ in }
+    }
+
+    private func handleServerEncoderStream(_ data: Data) {
+        guard qpackDecoder.processEncoderStream(data) else {
+            failSession(HTTP3Error.connectionFailed("QPACK encoder stream error"))
+            return
+        }
+        flushDecoderInstructions()
+    }
+
+    private func handleServerDecoderStream(_ data: Data) {
+        guard data.isEmpty || qpackEncoder?.processDecoderStream(data) == true else {
+            failSession(HTTP3Error.connectionFailed("QPACK decoder stream error"))
+            return
+        }
+    }
+
     // MARK: - Stream Operations (called on queue)
 
     func openBidiStream() -> Int64? {
-        quic.openBidiStream()
+        let streamID = quic.openBidiStream()
+        refreshHeadroom()
+        return streamID
+    }
+
+    /// Republishes `poolIsRunningLow`; MAX_STREAMS and MAX_DATA clear it on the next stream.
+    private func refreshHeadroom() {
+        let low = quic.availableBidiStreams < Self.lowStreamHeadroom
+            || quic.availableSendWindow < Self.lowSendWindow
+        _poolLock.lock()
+        poolIsRunningLow = low
+        _poolLock.unlock()
     }
 
     func writeStream(_ streamID: Int64, data: Data, fin: Bool = false, completion: @escaping (Error?) -> Void) {
         quic.writeStream(streamID, data: data, fin: fin, completion: completion)
     }
 
+    func writeStream(_ streamID: Int64, header: Data, payload: Data, fin: Bool = false,
+                     completion: @escaping (Error?) -> Void) {
+        quic.writeStream(streamID, header: header, payload: payload, fin: fin, completion: completion)
+    }
+
     func extendStreamOffset(_ streamID: Int64, count: Int) {
         quic.extendStreamOffset(streamID, count: count)
     }
@@ -259,6 +337,10 @@ nonisolated class HTTP3Multiplexer: Multiplexer {
         if streamID == serverControlStreamID {
             serverControlBuffer.append(data)
             processServerControlFrames()
+        } else if streamID == serverEncoderStreamID {
+            handleServerEncoderStream(data)
+        } else if streamID == serverDecoderStreamID {
+            handleServerDecoderStream(data)
         } else {
             var buffer = pendingServerStreams.removeValue(forKey: streamID) ?? Data()
             buffer.append(data)
@@ -276,9 +358,20 @@ nonisolated class HTTP3Multiplexer: Multiplexer {
                 processServerControlFrames()
             case 0x01: // Push (RFC 9114 §6.2.2) — we never send MAX_PUSH_ID
                 failSession(HTTP3Error.connectionFailed("Server opened push stream without MAX_PUSH_ID"))
-            case 0x02, 0x03: // QPACK encoder / decoder (RFC 9204 §4.2)
-                // We advertised QPACK_MAX_TABLE_CAPACITY=0; drain silently.
-                break
+            case 0x02: // QPACK encoder stream (RFC 9204 §4.2): inserts into our decoder's table
+                guard serverEncoderStreamID == nil else {
+                    failSession(HTTP3Error.connectionFailed("Duplicate QPACK encoder stream"))
+                    return
+                }
+                serverEncoderStreamID = streamID
+                handleServerEncoderStream(Data(buffer.dropFirst()))
+            case 0x03: // QPACK decoder stream: acknowledgments for our encoder
+                guard serverDecoderStreamID == nil else {
+                    failSession(HTTP3Error.connectionFailed("Duplicate QPACK decoder stream"))
+                    return
+                }
+                serverDecoderStreamID = streamID
+                handleServerDecoderStream(Data(buffer.dropFirst()))
             default:
                 // RFC 9114 §6.2: tolerate reserved grease types (0x1f * N + 0x21);
                 // abort anything else with STOP_SENDING.
@@ -339,6 +432,8 @@ nonisolated class HTTP3Multiplexer: Multiplexer {
     private func parseServerSettings(_ payload: Data) -> Bool {
         var offset = 0
         var seen = Set<UInt64>()
+        var qpackMaxTableCapacity: UInt64 = 0
+        var qpackBlockedStreams: UInt64 = 0
         while offset < payload.count {
             guard let (id, idLen) = QUICVarInt.decode(from: payload, offset: offset) else {
                 return false
@@ -363,13 +458,18 @@ nonisolated class HTTP3Multiplexer: Multiplexer {
                 // RFC 9297 §2.1: only 0 or 1 are valid.
                 guard value == 0 || value == 1 else { return false }
                 peerSupportsH3Datagram = (value == 1)
-            case HTTP3SettingsID.qpackMaxTableCapacity.rawValue,
-                 HTTP3SettingsID.qpackBlockedStreams.rawValue:
-                break // Dynamic table not used; no reaction needed.
+            case HTTP3SettingsID.qpackMaxTableCapacity.rawValue:
+                qpackMaxTableCapacity = value
+            case HTTP3SettingsID.qpackBlockedStreams.rawValue:
+                qpackBlockedStreams = value
             default:
                 break
             }
         }
+        qpackEncoder = QPACKDynamicEncoder(
+            peerMaxTableCapacity: qpackMaxTableCapacity,
+            peerBlockedStreams: qpackBlockedStreams
+        )
         return true
     }
 
@@ -0,0 +1,433 @@
+//
+//  QPACKDynamicTable.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+// MARK: - QPACKDynamicEncoder
+
+/// Our side of the peer's QPACK dynamic table (RFC 9204 §2.1, §4.3). A field is inserted
+/// the second time it is sent on the connection, so per-request values (paths, sequence numbers,
+/// padding) never occupy the table while the authority, user-agent, and session headers shrink
+/// to a byte or two. Entries the peer hasn't acknowledged are referenced on no more than its
+/// `QPACK_BLOCKED_STREAMS` streams at once; other sections send them as literals.
+/// Confined to the multiplexer queue.
+nonisolated final class QPACKDynamicEncoder {
+
+    /// Capacity used even when the peer allows more: request headers repeat only a handful of
+    /// fields, and every byte is decoder memory on the server.
+    private static let capacityLimit = 4096
+    /// Distinct fields remembered while waiting for a second sighting.
+    private static let maxSeenFields = 256
+    private static let maxDecoderStreamBuffer = 4096
+
+    private struct FieldKey: Hashable {
+        let name: String
+        let value: String
+    }
+
+    /// One unacknowledged field section.
+    private struct Section {
+        let requiredInsertCount: Int
+        /// Smallest absolute index referenced; that entry and newer can't be evicted.
+        let minReference: Int
+    }
+
+    private enum FieldLine {
+        case staticIndexed(Int)
+        case dynamicIndexed(absolute: Int)
+        case staticNameReference(Int, value: String)
+        case dynamicNameReference(absolute: Int, value: String)
+        case literal(name: String, value: String)
+    }
+
+    /// `MaxEntries` (RFC 9204 §3.2.2) from the peer's advertised maximum, not our capacity.
+    private let maxEntries: Int
+    private let capacity: Int
+    private let maxBlockedStreams: Int
+
+    private var table = HPACKDynamicTable()
+    private var tableSize = 0
+    private var insertCount = 0
+    private var knownReceivedCount = 0
+    private var outstanding: [Int64: [Section]] = [:]
+    private var seenFields: Set<FieldKey> = []
+
+    private var capacitySent = false
+    private var instructions = Data()
+    private var decoderStreamBuffer = Data()
+
+    /// nil when the peer's SETTINGS leave no room for an entry.
+    init?(peerMaxTableCapacity: UInt64, peerBlockedStreams: UInt64) {
+        guard peerMaxTableCapacity >= 32 else { return nil }
+        self.capacity = Int(min(peerMaxTableCapacity, UInt64(Self.capacityLimit)))
+        self.maxEntries = Int(min(peerMaxTableCapacity, UInt64(Int32.max)) / 32)
+        self.maxBlockedStreams = Int(min(peerBlockedStreams, 100))
+    }
+
+    /// Encoder-stream bytes produced since the last call; written before the field section
+    /// that needs them.
+    func takeInstructions() -> Data {
+        defer { instructions.removeAll(keepingCapacity: true) }
+        return instructions
+    }
+
+    // MARK: Field Sections
+
+    /// Encodes `fields` for a request on `streamID`, inserting repeated fields as it goes.
+    func encode(_ fields: [(name: String, value: String)], streamID: Int64) -> Data {
+        let mayBlock = maxBlockedStreams > 0
+            && (isBlocking(streamID) || blockedStreamCount() < maxBlockedStreams)
+        var lines: [FieldLine] = []
+        lines.reserveCapacity(fields.count)
+        var requiredInsertCount = 0
+        var minReference = Int.max
+
+        func usable(_ absolute: Int) -> Bool {
+            absolute < knownReceivedCount || mayBlock
+        }
+        func reference(_ absolute: Int) {
+            requiredInsertCount = max(requiredInsertCount, absolute + 1)
+            minReference = min(minReference, absolute)
+        }
+
+        for field in fields {
+            if let index = QPACKStaticTable.index(name: field.name, value: field.value) {
+                lines.append(.staticIndexed(index))
+                continue
+            }
+            if let absolute = lookup(field.name, field.value) {
+                if usable(absolute) {
+                    reference(absolute)
+                    lines.append(.dynamicIndexed(absolute: absolute))
+                    continue
+                }
+            } else if shouldInsert(field.name, field.value),
+                      insert(field.name, field.value, pinnedFrom: minReference) {
+                // Fresh entries are unacknowledged; a section that may not block sends the
+                // literal this time and references the entry once it's acknowledged.
+                if mayBlock {
+                    reference(insertCount - 1)
+                    lines.append(.dynamicIndexed(absolute: insertCount - 1))
+                    continue
+                }
+            }
+            if let nameIndex = QPACKStaticTable.nameIndex(field.name) {
+                lines.append(.staticNameReference(nameIndex, value: field.value))
+            } else if let absolute = lookup(field.name, nil), usable(absolute) {
+                reference(absolute)
+                lines.append(.dynamicNameReference(absolute: absolute, value: field.value))
+            } else {
+                lines.append(.literal(name: field.name, value: field.value))
+            }
+        }
+
+        var block = Data()
+        // Base is the insert count after this section's inserts, so every reference is
+        // pre-base and Delta Base is non-negative.
+        let base = insertCount
+        if requiredInsertCount == 0 {
+            block.append(0x00)
+            block.append(0x00)
+        } else {
+            let encodedInsertCount = requiredInsertCount % (2 * maxEntries) + 1
+            block.append(contentsOf: QPACKEncoder.encodeVarIntWithPrefix(UInt64(encodedInsertCount), prefixBits: 8, prefix: 0x00))
+            block.append(contentsOf: QPACKEncoder.encodeVarIntWithPrefix(UInt64(base - requiredInsertCount), prefixBits: 7, prefix: 0x00))
+            outstanding[streamID, default: []].append(
+                Section(requiredInsertCount: requiredInsertCount, minReference: minReference)
+            )
+        }
+
+        for line in lines {
+            switch line {
+            case .staticIndexed(let index):
+                block.append(contentsOf: QPACKEncoder.encodeIndexedFieldLine(index))
+            case .dynamicIndexed(let absolute):
+                // 1 T=0 relative-index(6+)
+                block.append(contentsOf: QPACKEncoder.encodeVarIntWithPrefix(UInt64(base - 1 - absolute), prefixBits: 6, prefix: 0x80))
+            case .staticNameReference(let index, let value):
+                block.append(contentsOf: QPACKEncoder.encodeLiteralWithNameRef(staticIndex: index, value: value))
+            case .dynamicNameReference(let absolute, let value):
+                // 01 N=0 T=0 relative-index(4+) value
+                block.append(contentsOf: QPACKEncoder.encodeVarIntWithPrefix(UInt64(base - 1 - absolute), prefixBits: 4, prefix: 0x40))
+                block.append(contentsOf: QPACKEncoder.encodeStringLiteral(value))
+            case .literal(let name, let value):
+                block.append(contentsOf: QPACKEncoder.encodeLiteralFieldLine(name: name, value: value))
+            }
+        }
+        return block
+    }
+
+    // MARK: Decoder Stream
+
+    /// Applies the peer's decoder-stream instructions (RFC 9204 §4.4); false on a malformed
+    /// one (QPACK_DECODER_STREAM_ERROR).
+    func processDecoderStream(_ data: Data) -> Bool {
+        decoderStreamBuffer.append(data)
+        let base = decoderStreamBuffer.startIndex
+        var offset = 0
+        while offset < decoderStreamBuffer.count {
+            let byte = decoderStreamBuffer[base + offset]
+            let prefixBits = byte & 0x80 != 0 ? 7 : 6
+            guard let (value, length) = QPACKEncoder.decodeVarIntPrefix(
+                from: decoderStreamBuffer, offset: offset, prefixBits: prefixBits
+            ) else { break }
+            offset += length
+
+            if byte & 0x80 != 0 {
+                // Section Acknowledgment: the stream's oldest outstanding section.
+                let streamID = Int64(value)
+                guard var sections = outstanding[streamID], !sections.isEmpty else { return false }
+                let section = sections.removeFirst()
+                outstanding[streamID] = sections.isEmpty ? nil : sections
+                knownReceivedCount = max(knownReceivedCount, section.requiredInsertCount)
+            } else if byte & 0x40 != 0 {
+                // Stream Cancellation.
+                outstanding.removeValue(forKey: Int64(value))
+            } else {
+                // Insert Count Increment.
+                guard value > 0, UInt64(knownReceivedCount) + value <= UInt64(insertCount) else { return false }
+                knownReceivedCount += Int(value)
+            }
+        }
+        decoderStreamBuffer.removeFirst(offset)
+        return decoderStreamBuffer.count <= Self.maxDecoderStreamBuffer
+    }
+
+    // MARK: Table
+
+    private func isBlocking(_ streamID: Int64) -> Bool {
+        outstanding[streamID]?.contains { $0.requiredInsertCount > knownReceivedCount } ?? false
+    }
+
+    private func blockedStreamCount() -> Int {
+        outstanding.values.reduce(0) { count, sections in
+            count + (sections.contains { $0.requiredInsertCount > knownReceivedCount } ? 1 : 0)
+        }
+    }
+
+    /// Absolute index of the newest entry matching `name` (and `value`, when given).
+    private func lookup(_ name: String, _ value: String?) -> Int? {
+        for index in 0..<table.count {
+            let entry = table[index]
+            if entry.name == name, value == nil || entry.value == value {
+                return insertCount - 1 - index
+            }
+        }
+        return nil
+    }
+
+    private func entrySize(_ name: String, _ value: String) -> Int {
+        name.utf8.count + value.utf8.count + 32
+    }
+
+    /// True on a field's second sighting, when it fits a quarter of the table.
+    private func shouldInsert(_ name: String, _ value: String) -> Bool {
+        guard entrySize(name, value) <= capacity / 4 else { return false }
+        let key = FieldKey(name: name, value: value)
+        if seenFields.contains(key) { return true }
+        if seenFields.count >= Self.maxSeenFields { seenFields.removeAll(keepingCapacity: true) }
+        seenFields.insert(key)
+        return false
+    }
+
+    /// Inserts a field, evicting only acknowledged entries that no outstanding section —
+    /// nor the one being encoded, which references from `pinnedFrom` — still needs (§2.1.1).
+    /// False, leaving the table unchanged, when that can't free enough room.
+    private func insert(_ name: String, _ value: String, pinnedFrom: Int) -> Bool {
+        let size = entrySize(name, value)
+        let oldest = insertCount - table.count
+        let minOutstanding = outstanding.values.lazy.flatMap { $0 }.map(\.minReference).min() ?? Int.max
+        let evictableBelow = min(knownReceivedCount, minOutstanding, pinnedFrom)
+
+        var evictions = 0
+        var freed = 0
+        while tableSize - freed + size > capacity {
+            let absolute = oldest + evictions
+            guard evictions < table.count, absolute < evictableBelow else { return false }
+            let entry = table[table.count - 1 - evictions]
+            freed += entrySize(entry.name, entry.value)
+            evictions += 1
+        }
+
+        if !capacitySent {
+            capacitySent = true
+            // Set Dynamic Table Capacity: 001 capacity(5+)
+            instructions.append(contentsOf: QPACKEncoder.encodeVarIntWithPrefix(UInt64(capacity), prefixBits: 5, prefix: 0x20))
+        }
+        if let nameIndex = QPACKStaticTable.nameIndex(name) {
+            // Insert with Name Reference: 1 T=1 index(6+) value
+            instructions.append(contentsOf: QPACKEncoder.encodeVarIntWithPrefix(UInt64(nameIndex), prefixBits: 6, prefix: 0xC0))
+        } else if let absolute = lookup(name, nil), absolute >= oldest + evictions {
+            // Insert with Name Reference: 1 T=0 relative-index(6+) value; the decoder reads it
+            // in encoder-stream order, so it never blocks.
+            instructions.append(contentsOf: QPACKEncoder.encodeVarIntWithPrefix(UInt64(insertCount - 1 - absolute), prefixBits: 6, prefix: 0x80))
+        } else {
+            // Insert with Literal Name: 01 H=0 length(5+) name value
+            let nameBytes = Data(name.utf8)
+            instructions.append(contentsOf: QPACKEncoder.encodeVarIntWithPrefix(UInt64(nameBytes.count), prefixBits: 5, prefix: 0x40))
+            instructions.append(nameBytes)
+        }
+        instructions.append(contentsOf: QPACKEncoder.encodeStringLiteral(value))
+
+        for _ in 0..<evictions { table.removeOldest() }
+        tableSize += size - freed
+        table.insert((name, value))
+        insertCount += 1
+        return true
+    }
+}
+
+// MARK: - QPACKDynamicDecoder
+
+/// Our copy of the peer's QPACK dynamic table, built from its encoder stream (RFC 9204 §4.3)
+/// and bounded by the `QPACK_MAX_TABLE_CAPACITY` we advertise. Produces the decoder-stream
+/// acknowledgments the peer's encoder needs to evict. Confined to the multiplexer queue.
+nonisolated final class QPACKDynamicDecoder {
+
+    /// Advertised in our SETTINGS; `QPACK_BLOCKED_STREAMS` is advertised as 0.
+    static let maxTableCapacity = 4096
+    private static let maxEntries = maxTableCapacity / 32
+    private static let maxEncoderStreamBuffer = 64 * 1024
+
+    private var table = HPACKDynamicTable()
+    private var capacity = 0
+    private var tableSize = 0
+    private(set) var insertCount = 0
+    /// Insert count the peer's encoder has been told about.
+    private var acknowledgedInsertCount = 0
+
+    private var encoderStreamBuffer = Data()
+    private var instructions = Data()
+
+    /// Decoder-stream bytes produced since the last call.
+    func takeInstructions() -> Data {
+        defer { instructions.removeAll(keepingCapacity: true) }
+        return instructions
+    }
+
+    func entry(absolute: Int) -> (name: String, value: String)? {
+        guard absolute < insertCount, absolute >= insertCount - table.count else { return nil }
+        return table[insertCount - 1 - absolute]
+    }
+
+    /// Decodes a section prefix's Encoded Required Insert Count (RFC 9204 §4.5.1.1).
+    func requiredInsertCount(encoded: UInt64) -> Int? {
+        guard encoded != 0 else { return 0 }
+        let fullRange = 2 * Self.maxEntries
+        guard encoded <= UInt64(fullRange) else { return nil }
+        let maxValue = insertCount + Self.maxEntries
+        let maxWrapped = (maxValue / fullRange) * fullRange
+        var required = maxWrapped + Int(encoded) - 1
+        if required > maxValue {
+            guard required > fullRange else { return nil }
+            required -= fullRange
+        }
+        guard required != 0 else { return nil }
+        return required
+    }
+
+    /// Section Acknowledgment (RFC 9204 §4.4.1), owed for every section with a non-zero
+    /// Required Insert Count.
+    func acknowledgeSection(streamID: Int64, requiredInsertCount: Int) {
+        guard requiredInsertCount > 0 else { return }
+        instructions.append(contentsOf: QPACKEncoder.encodeVarIntWithPrefix(UInt64(streamID), prefixBits: 7, prefix: 0x80))
+        acknowledgedInsertCount = max(acknowledgedInsertCount, requiredInsertCount)
+    }
+
+    /// Applies the peer's encoder-stream instructions; false on a malformed one
+    /// (QPACK_ENCODER_STREAM_ERROR). New inserts are acknowledged with an Insert Count
+    /// Increment so the peer can reference and evict them.
+    func processEncoderStream(_ data: Data) -> Bool {
+        encoderStreamBuffer.append(data)
+        let base = encoderStreamBuffer.startIndex
+        var offset = 0
+        // A truncated instruction fails to decode; it is retried once more bytes arrive.
+        parse: while offset < encoderStreamBuffer.count {
+            let start = offset
+            let byte = encoderStreamBuffer[base + offset]
+
+            if byte & 0x80 != 0 {
+                // Insert with Name Reference: 1 T index(6+) value
+                let isStatic = byte & 0x40 != 0
+                guard let (index, indexLength) = QPACKEncoder.decodeVarIntPrefix(
+                    from: encoderStreamBuffer, offset: offset, prefixBits: 6
+                ) else { break parse }
+                offset += indexLength
+                guard let (value, valueLength) = QPACKEncoder.decodeString(
+                    from: encoderStreamBuffer, offset: offset
+                ) else { offset = start; break parse }
+                offset += valueLength
+                let name: String
+                if isStatic {
+                    guard index < UInt64(QPACKStaticTable.entries.count) else { return false }
+                    name = QPACKStaticTable.entries[Int(index)].name
+                } else {
+                    guard index < UInt64(insertCount),
+                          let entry = self.entry(absolute: insertCount - 1 - Int(index)) else { return false }
+                    name = entry.name
+                }
+                guard insert(name, value) else { return false }
+            } else if byte & 0x40 != 0 {
+                // Insert with Literal Name: 01 H length(5+) name value
+                guard let (name, nameLength) = QPACKEncoder.decodeString(
+                    from: encoderStreamBuffer, offset: offset, prefixBits: 5
+                ) else { break parse }
+                offset += nameLength
+                guard let (value, valueLength) = QPACKEncoder.decodeString(
+                    from: encoderStreamBuffer, offset: offset
+                ) else { offset = start; break parse }
+                offset += valueLength
+                guard insert(name, value) else { return false }
+            } else if byte & 0x20 != 0 {
+                // Set Dynamic Table Capacity: 001 capacity(5+)
+                guard let (newCapacity, length) = QPACKEncoder.decodeVarIntPrefix(
+                    from: encoderStreamBuffer, offset: offset, prefixBits: 5
+                ) else { break parse }
+                offset += length
+                guard newCapacity <= UInt64(Self.maxTableCapacity) else { return false }
+                capacity = Int(newCapacity)
+                evict(toFit: 0)
+            } else {
+                // Duplicate: 000 index(5+)
+                guard let (index, length) = QPACKEncoder.decodeVarIntPrefix(
+                    from: encoderStreamBuffer, offset: offset, prefixBits: 5
+                ) else { break parse }
+                offset += length
+                guard index < UInt64(insertCount),
+                      let entry = self.entry(absolute: insertCount - 1 - Int(index)),
+                      insert(entry.name, entry.value) else { return false }
+            }
+        }
+        encoderStreamBuffer.removeFirst(offset)
+
+        if insertCount > acknowledgedInsertCount {
+            // Insert Count Increment: 00 increment(6+)
+            instructions.append(contentsOf: QPACKEncoder.encodeVarIntWithPrefix(
+                UInt64(insertCount - acknowledgedInsertCount), prefixBits: 6, prefix: 0x00
+            ))
+            acknowledgedInsertCount = insertCount
+        }
+        return encoderStreamBuffer.count <= Self.maxEncoderStreamBuffer
+    }
+
+    private func insert(_ name: String, _ value: String) -> Bool {
+        let size = name.utf8.count + value.utf8.count + 32
+        guard size <= capacity else { return false }
+        evict(toFit: size)
+        table.insert((name, value))
+        tableSize += size
+        insertCount += 1
+        return true
+    }
+
+    private func evict(toFit size: Int) {
+        while tableSize + size > capacity, let oldest = table.oldest {
+            tableSize -= oldest.name.utf8.count + oldest.value.utf8.count + 32
+            table.removeOldest()
+        }
+    }
+}
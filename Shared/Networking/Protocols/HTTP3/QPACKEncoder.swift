@@ -7,63 +7,168 @@
 
 import Foundation
 
-// MARK: - QPACK Static Table (Subset)
+// MARK: - QPACK Static Table
+
+/// The QPACK static table (RFC 9204, Appendix A).
+nonisolated enum QPACKStaticTable {
+
+    static let entries: [(name: String, value: String)] = [
+        (":authority", ""), (":path", "/"), ("age", "0"), ("content-disposition", ""),
+        ("content-length", "0"), ("cookie", ""), ("date", ""), ("etag", ""),
+        ("if-modified-since", ""), ("if-none-match", ""), ("last-modified", ""), ("link", ""),
+        ("location", ""), ("referer", ""), ("set-cookie", ""),
+        (":method", "CONNECT"), (":method", "DELETE"), (":method", "GET"), (":method", "HEAD"),
+        (":method", "OPTIONS"), (":method", "POST"), (":method", "PUT"),
+        (":scheme", "http"), (":scheme", "https"),
+        (":status", "103"), (":status", "200"), (":status", "304"), (":status", "404"), (":status", "503"),
+        ("accept", "*/*"), ("accept", "application/dns-message"),
+        ("accept-encoding", "gzip, deflate, br"), ("accept-ranges", "bytes"),
+        ("access-control-allow-headers", "cache-control"), ("access-control-allow-headers", "content-type"),
+        ("access-control-allow-origin", "*"),
+        ("cache-control", "max-age=0"), ("cache-control", "max-age=2592000"), ("cache-control", "max-age=604800"),
+        ("cache-control", "no-cache"), ("cache-control", "no-store"), ("cache-control", "public, max-age=31536000"),
+        ("content-encoding", "br"), ("content-encoding", "gzip"),
+        ("content-type", "application/dns-message"), ("content-type", "application/javascript"),
+        ("content-type", "application/json"), ("content-type", "application/x-www-form-urlencoded"),
+        ("content-type", "image/gif"), ("content-type", "image/jpeg"), ("content-type", "image/png"),
+        ("content-type", "text/css"), ("content-type", "text/html; charset=utf-8"),
+        ("content-type", "text/plain"), ("content-type", "text/plain;charset=utf-8"),
+        ("range", "bytes=0-"),
+        ("strict-transport-security", "max-age=31536000"),
+        ("strict-transport-security", "max-age=31536000; includesubdomains"),
+        ("strict-transport-security", "max-age=31536000; includesubdomains; preload"),
+        ("vary", "accept-encoding"), ("vary", "origin"),
+        ("x-content-type-options", "nosniff"), ("x-xss-protection", "1; mode=block"),
+        (":status", "100"), (":status", "204"), (":status", "206"), (":status", "302"), (":status", "400"),
+        (":status", "403"), (":status", "421"), (":status", "425"), (":status", "500"),
+        ("accept-language", ""),
+        ("access-control-allow-credentials", "FALSE"), ("access-control-allow-credentials", "TRUE"),
+        ("access-control-allow-headers", "*"),
+        ("access-control-allow-methods", "get"), ("access-control-allow-methods", "get, post, options"),
+        ("access-control-allow-methods", "options"),
+        ("access-control-expose-headers", "content-length"), ("access-control-request-headers", "content-type"),
+        ("access-control-request-method", "get"), ("access-control-request-method", "post"),
+        ("alt-svc", "clear"), ("authorization", ""),
+        ("content-security-policy", "script-src 'none'; object-src 'none'; base-uri 'none'"),
+        ("early-data", "1"), ("expect-ct", ""), ("forwarded", ""), ("if-range", ""), ("origin", ""),
+        ("purpose", "prefetch"), ("server", ""), ("timing-allow-origin", "*"),
+        ("upgrade-insecure-requests", "1"), ("user-agent", ""), ("x-forwarded-for", ""),
+        ("x-frame-options", "deny"), ("x-frame-options", "sameorigin"),
+    ]
+
+    private struct FieldKey: Hashable {
+        let name: String
+        let value: String
+    }
+
+    private static let fieldIndices: [FieldKey: Int] = {
+        var indices: [FieldKey: Int] = [:]
+        for (index, entry) in entries.enumerated() {
+            indices[FieldKey(name: entry.name, value: entry.value)] = index
+        }
+        return indices
+    }()
+
+    private static let nameIndices: [String: Int] = {
+        var indices: [String: Int] = [:]
+        for (index, entry) in entries.enumerated() where indices[entry.name] == nil {
+            indices[entry.name] = index
+        }
+        return indices
+    }()
+
+    static func index(name: String, value: String) -> Int? {
+        fieldIndices[FieldKey(name: name, value: value)]
+    }
 
-/// Indices into the QPACK static table (RFC 9204, Appendix A).
-private enum QPACKStaticIndex: Int {
-    case methodConnect  = 15  // :method = CONNECT
-    case status200      = 25  // :status = 200
+    static func nameIndex(_ name: String) -> Int? {
+        nameIndices[name]
+    }
 }
 
 // MARK: - QPACKEncoder
 
 enum QPACKEncoder {
 
-    /// Encodes CONNECT headers: classic CONNECT (RFC 9114 §4.4) sends only `:method` and
-    /// `:authority`; extended CONNECT (RFC 9220/9298) adds `:protocol`, `:scheme`, `:path`.
-    static func encodeConnectHeaders(
+    /// Largest decoded field section accepted: the MAX_FIELD_SECTION_SIZE we advertise. A
+    /// dynamic-table reference is a byte on the wire for up to a table's worth of decoded
+    /// headers, so an uncapped section is a memory-amplification vector.
+    static let maxDecodedFieldSectionSize = 262_144
+
+    /// CONNECT fields: classic CONNECT (RFC 9114 §4.4) sends only `:method` and `:authority`;
+    /// extended CONNECT (RFC 9220/9298) adds `:protocol`, `:scheme`, `:path`.
+    static func connectFields(
         authority: String,
         protocolPseudo: String? = nil,
         path: String? = nil,
         extraHeaders: [(name: String, value: String)]
-    ) -> Data {
-        var block = Data()
-
-        // Header block prefix: Required Insert Count 0, Delta Base 0 (no dynamic table).
-        block.append(0x00)
-        block.append(0x00)
-
-        block.append(contentsOf: encodeIndexedFieldLine(QPACKStaticIndex.methodConnect.rawValue))
-
+    ) -> [(name: String, value: String)] {
+        var fields: [(name: String, value: String)] = [(":method", "CONNECT")]
         if let protocolPseudo {
             // Extended CONNECT (RFC 9220 §3 / RFC 9298 §3): :protocol, :scheme,
             // and :path are all mandatory alongside :method and :authority.
-            block.append(contentsOf: encodeLiteralFieldLine(
-                name: ":protocol", value: protocolPseudo
-            ))
-            block.append(contentsOf: encodeIndexedFieldLine(23))  // :scheme = https (index 23)
-            block.append(contentsOf: encodeLiteralWithNameRef(
-                staticIndex: 1, value: path ?? "/"
-            ))
+            fields.append((":protocol", protocolPseudo))
+            fields.append((":scheme", "https"))
+            fields.append((":path", path ?? "/"))
         }
+        fields.append((":authority", authority))
+        for header in extraHeaders {
+            fields.append((header.name.lowercased(), header.value))
+        }
+        return fields
+    }
 
-        // :authority (literal with name ref, static index 0)
-        block.append(contentsOf: encodeLiteralWithNameRef(
-            staticIndex: 0, value: authority
-        ))
-
+    /// Request fields for an arbitrary method.
+    static func requestFields(
+        method: String,
+        authority: String,
+        path: String,
+        extraHeaders: [(name: String, value: String)]
+    ) -> [(name: String, value: String)] {
+        let upper = method.uppercased()
+        var fields: [(name: String, value: String)] = [
+            (":method", upper == "GET" || upper == "POST" ? upper : method),
+            (":scheme", "https"),
+            (":authority", authority),
+            (":path", path),
+        ]
         for header in extraHeaders {
-            block.append(contentsOf: encodeLiteralFieldLine(
-                name: header.name, value: header.value
-            ))
+            fields.append((header.name.lowercased(), header.value))
         }
+        return fields
+    }
 
+    /// A field section referencing only the static table; used until the peer's SETTINGS
+    /// allow a dynamic table.
+    static func encodeFieldSection(_ fields: [(name: String, value: String)]) -> Data {
+        var block = Data()
+        // Header block prefix: Required Insert Count 0, Delta Base 0 (no dynamic references).
+        block.append(0x00)
+        block.append(0x00)
+        for field in fields {
+            appendStaticFieldLine(name: field.name, value: field.value, to: &block)
+        }
         return block
     }
 
-    /// Decodes a QPACK header block; nil if malformed or it references the dynamic
-    /// table — a protocol violation since we advertise `QPACK_MAX_TABLE_CAPACITY=0`.
-    static func decodeHeaders(from data: Data) -> [(name: String, value: String)]? {
+    static func appendStaticFieldLine(name: String, value: String, to block: inout Data) {
+        if let index = QPACKStaticTable.index(name: name, value: value) {
+            block.append(contentsOf: encodeIndexedFieldLine(index))
+        } else if let nameIndex = QPACKStaticTable.nameIndex(name) {
+            block.append(contentsOf: encodeLiteralWithNameRef(staticIndex: nameIndex, value: value))
+        } else {
+            block.append(contentsOf: encodeLiteralFieldLine(name: name, value: value))
+        }
+    }
+
+    /// Decodes a QPACK header block, resolving dynamic references against `dynamicTable`
+    /// (RFC 9204 §4.5). nil if malformed, over ``maxDecodedFieldSectionSize``, or it needs
+    /// inserts not yet received: we advertise `QPACK_BLOCKED_STREAMS=0`, so a blocked
+    /// section is a protocol violation. Without a table any dynamic reference is malformed.
+    static func decodeHeaders(
+        from data: Data,
+        dynamicTable: QPACKDynamicDecoder? = nil
+    ) -> (fields: [(name: String, value: String)], requiredInsertCount: Int)? {
         var headers: [(name: String, value: String)] = []
         guard data.count >= 2 else { return nil }
 
@@ -71,139 +176,128 @@ enum QPACKEncoder {
         let base = data.startIndex
         var offset = 0
 
-        // QPACK prefix: Required Insert Count MUST be 0 (dynamic table disabled).
-        guard let (requiredInsertCount, ricLen) =
+        guard let (encodedInsertCount, ricLen) =
                 decodeVarIntPrefix(from: data, offset: offset, prefixBits: 8) else { return nil }
         offset += ricLen
-        guard requiredInsertCount == 0 else { return nil }
+        let requiredInsertCount: Int
+        if let dynamicTable {
+            guard let decoded = dynamicTable.requiredInsertCount(encoded: encodedInsertCount),
+                  decoded <= dynamicTable.insertCount else { return nil }
+            requiredInsertCount = decoded
+        } else {
+            guard encodedInsertCount == 0 else { return nil }
+            requiredInsertCount = 0
+        }
 
         guard offset < data.count else { return nil }
-        // Delta Base: 7-bit prefix after the sign bit; value unused (no dynamic table).
-        guard let (_, dbLen) = decodeVarIntPrefix(from: data, offset: offset, prefixBits: 7) else {
+        // Delta Base: sign bit, then a 7-bit prefix (RFC 9204 §4.5.1.2).
+        let baseIsBelow = data[base + offset] & 0x80 != 0
+        guard let (deltaBase, dbLen) = decodeVarIntPrefix(from: data, offset: offset, prefixBits: 7) else {
             return nil
         }
         offset += dbLen
+        let sectionBase: Int
+        if baseIsBelow {
+            guard UInt64(requiredInsertCount) > deltaBase else { return nil }
+            sectionBase = requiredInsertCount - Int(deltaBase) - 1
+        } else {
+            guard deltaBase <= UInt64(Int32.max) else { return nil }
+            sectionBase = requiredInsertCount + Int(deltaBase)
+        }
+
+        /// A dynamic entry by absolute index; it must fall below the section's Required Insert Count.
+        func dynamicEntry(_ absolute: Int) -> (name: String, value: String)? {
+            guard absolute >= 0, absolute < requiredInsertCount else { return nil }
+            return dynamicTable?.entry(absolute: absolute)
+        }
+
+        var decodedSize = 0
+        func emit(_ name: String, _ value: String) -> Bool {
+            decodedSize += name.utf8.count + value.utf8.count + 32
+            guard decodedSize <= maxDecodedFieldSectionSize else { return false }
+            headers.append((name: name, value: value))
+            return true
+        }
 
         while offset < data.count {
             let byte = data[base + offset]
 
             if byte & 0x80 != 0 {
-                // Indexed field line: 1 T index(6+). T=0 (dynamic) is not supported.
+                // Indexed field line: 1 T index(6+); T=0 is relative to Base.
                 let isStatic = (byte & 0x40) != 0
-                guard isStatic else { return nil }
                 guard let (index, len) =
                         decodeVarIntPrefix(from: data, offset: offset, prefixBits: 6) else { return nil }
                 offset += len
-                // Indices outside our RFC 9204 Appendix A subset are skipped, not
-                // failed, so unknown headers don't break origin-server interop.
-                if let entry = staticTableEntry(Int(index)) {
-                    headers.append(entry)
+                if isStatic {
+                    guard index < UInt64(QPACKStaticTable.entries.count) else { return nil }
+                    let entry = QPACKStaticTable.entries[Int(index)]
+                    guard emit(entry.name, entry.value) else { return nil }
+                } else {
+                    guard index < UInt64(sectionBase),
+                          let entry = dynamicEntry(sectionBase - 1 - Int(index)),
+                          emit(entry.name, entry.value) else { return nil }
                 }
             } else if byte & 0x40 != 0 {
-                // Literal with name ref: 01 N T name-index(4+) value. T=0 (dynamic) not supported.
+                // Literal with name ref: 01 N T name-index(4+) value; T=0 is relative to Base.
                 let isStatic = (byte & 0x10) != 0
-                guard isStatic else { return nil }
                 guard let (nameIdx, nameLen) =
                         decodeVarIntPrefix(from: data, offset: offset, prefixBits: 4) else { return nil }
                 offset += nameLen
                 guard let (value, valueLen) = decodeString(from: data, offset: offset) else { return nil }
                 offset += valueLen
-                if let name = staticTableName(Int(nameIdx)) {
-                    headers.append((name: name, value: value))
+                let name: String
+                if isStatic {
+                    guard nameIdx < UInt64(QPACKStaticTable.entries.count) else { return nil }
+                    name = QPACKStaticTable.entries[Int(nameIdx)].name
+                } else {
+                    guard nameIdx < UInt64(sectionBase),
+                          let entry = dynamicEntry(sectionBase - 1 - Int(nameIdx)) else { return nil }
+                    name = entry.name
                 }
+                guard emit(name, value) else { return nil }
             } else if byte & 0x20 != 0 {
                 // Literal field line with literal name: 001 N H nameLen(3+) name value
-                let nameHuffman = (byte & 0x08) != 0
-                guard let (nameLen, nameLenBytes) =
-                        decodeVarIntPrefix(from: data, offset: offset, prefixBits: 3) else { return nil }
-                offset += nameLenBytes
-                guard offset + Int(nameLen) <= data.count else { return nil }
-                let nameStart = base + offset
-                let nameEnd = nameStart + Int(nameLen)
-                let nameData = Data(data[nameStart..<nameEnd])
-                offset += Int(nameLen)
-                let nameStr: String?
-                if nameHuffman {
-                    if let decoded = HPACKHuffman.decode(nameData) {
-                        nameStr = String(bytes: decoded, encoding: .utf8)
-                    } else { nameStr = nil }
-                } else {
-                    nameStr = String(data: nameData, encoding: .utf8)
+                guard let (name, nameLen) = decodeString(from: data, offset: offset, prefixBits: 3) else {
+                    return nil
                 }
-                guard let name = nameStr else { return nil }
-
+                offset += nameLen
                 guard let (value, vLen) = decodeString(from: data, offset: offset) else { return nil }
                 offset += vLen
-                headers.append((name: name, value: value))
+                guard emit(name, value) else { return nil }
+            } else if byte & 0x10 != 0 {
+                // Indexed field line with post-base index: 0001 index(4+).
+                guard let (index, len) =
+                        decodeVarIntPrefix(from: data, offset: offset, prefixBits: 4) else { return nil }
+                offset += len
+                guard index < UInt64(Int32.max),
+                      let entry = dynamicEntry(sectionBase + Int(index)),
+                      emit(entry.name, entry.value) else { return nil }
             } else {
-                // Post-base forms (0001xxxx / 0000xxxx) require the dynamic table — not supported.
-                return nil
+                // Literal with post-base name ref: 0000 N index(3+) value.
+                guard let (nameIdx, nameLen) =
+                        decodeVarIntPrefix(from: data, offset: offset, prefixBits: 3) else { return nil }
+                offset += nameLen
+                guard let (value, valueLen) = decodeString(from: data, offset: offset) else { return nil }
+                offset += valueLen
+                guard nameIdx < UInt64(Int32.max),
+                      let entry = dynamicEntry(sectionBase + Int(nameIdx)),
+                      emit(entry.name, value) else { return nil }
             }
         }
 
-        return headers
-    }
-
-    /// Encodes HTTP/3 POST request headers into a QPACK header block.
-    static func encodePostHeaders(
-        authority: String,
-        path: String,
-        extraHeaders: [(name: String, value: String)]
-    ) -> Data {
-        var block = Data()
-        block.append(0x00)
-        block.append(0x00)
-
-        block.append(contentsOf: encodeIndexedFieldLine(20))  // :method POST
-        block.append(contentsOf: encodeIndexedFieldLine(23))  // :scheme https
-        block.append(contentsOf: encodeLiteralWithNameRef(staticIndex: 0, value: authority))
-        block.append(contentsOf: encodeLiteralWithNameRef(staticIndex: 1, value: path))
-
-        for header in extraHeaders {
-            block.append(contentsOf: encodeLiteralFieldLine(name: header.name, value: header.value))
-        }
-        return block
-    }
-
-    /// Encodes HTTP/3 request headers for an arbitrary method into a QPACK header block.
-    static func encodeRequestHeaders(
-        method: String,
-        authority: String,
-        path: String,
-        extraHeaders: [(name: String, value: String)]
-    ) -> Data {
-        var block = Data()
-        block.append(0x00)
-        block.append(0x00)
-
-        switch method.uppercased() {
-        case "GET":
-            block.append(contentsOf: encodeIndexedFieldLine(17))  // :method GET
-        case "POST":
-            block.append(contentsOf: encodeIndexedFieldLine(20))  // :method POST
-        default:
-            block.append(contentsOf: encodeLiteralFieldLine(name: ":method", value: method))
-        }
-        block.append(contentsOf: encodeIndexedFieldLine(23))  // :scheme https
-        block.append(contentsOf: encodeLiteralWithNameRef(staticIndex: 0, value: authority))
-        block.append(contentsOf: encodeLiteralWithNameRef(staticIndex: 1, value: path))
-
-        for header in extraHeaders {
-            block.append(contentsOf: encodeLiteralFieldLine(name: header.name, value: header.value))
-        }
-        return block
+        return (headers, requiredInsertCount)
     }
 
     // MARK: - Encoding Helpers
 
     /// Indexed field line: 1 T(1) index(6+). T=1 → prefix byte 0xC0.
-    private static func encodeIndexedFieldLine(_ index: Int) -> Data {
+    static func encodeIndexedFieldLine(_ index: Int) -> Data {
         return encodeVarIntWithPrefix(UInt64(index), prefixBits: 6, prefix: 0xC0)
     }
 
     /// Literal field line with name reference: 01 N T nameIndex(4+) value.
     /// N=0 T=1 (static) → prefix 0x50.
-    private static func encodeLiteralWithNameRef(staticIndex: Int, value: String) -> Data {
+    static func encodeLiteralWithNameRef(staticIndex: Int, value: String) -> Data {
         var data = Data()
         data.append(contentsOf: encodeVarIntWithPrefix(UInt64(staticIndex), prefixBits: 4, prefix: 0x50))
         data.append(contentsOf: encodeStringLiteral(value))
@@ -212,7 +306,7 @@ enum QPACKEncoder {
 
     /// Literal field line with literal name: 001 N H nameLen(3+) name value.
     /// N=0 → prefix 0x20.
-    private static func encodeLiteralFieldLine(name: String, value: String) -> Data {
+    static func encodeLiteralFieldLine(name: String, value: String) -> Data {
         var data = Data()
         let nameBytes = Data(name.lowercased().utf8)
         data.append(contentsOf: encodeVarIntWithPrefix(UInt64(nameBytes.count), prefixBits: 3, prefix: 0x20))
@@ -222,7 +316,7 @@ enum QPACKEncoder {
     }
 
     /// String literal: H=0 (no Huffman), 7-bit length prefix.
-    private static func encodeStringLiteral(_ string: String) -> Data {
+    static func encodeStringLiteral(_ string: String) -> Data {
         let bytes = Data(string.utf8)
         var data = Data()
         data.append(contentsOf: encodeVarIntWithPrefix(UInt64(bytes.count), prefixBits: 7, prefix: 0x00))
@@ -230,7 +324,7 @@ enum QPACKEncoder {
         return data
     }
 
-    private static func encodeVarIntWithPrefix(_ value: UInt64, prefixBits: Int, prefix: UInt8) -> Data {
+    static func encodeVarIntWithPrefix(_ value: UInt64, prefixBits: Int, prefix: UInt8) -> Data {
         let maxPrefix = (1 << prefixBits) - 1
         var data = Data()
 
@@ -254,7 +348,7 @@ enum QPACKEncoder {
     /// cap at 2^62 − 1 (RFC 9204 §4.1.1); overflow is malformed input, not a trap.
     private static let qpackIntMax: UInt64 = (1 << 62) - 1
 
-    private static func decodeVarIntPrefix(from data: Data, offset: Int, prefixBits: Int) -> (UInt64, Int)? {
+    static func decodeVarIntPrefix(from data: Data, offset: Int, prefixBits: Int) -> (UInt64, Int)? {
         guard offset < data.count else { return nil }
         let base = data.startIndex
         let mask = UInt8((1 << prefixBits) - 1)
@@ -284,16 +378,18 @@ enum QPACKEncoder {
         return nil
     }
 
-    /// `offset` is relative to `data.startIndex`; slice-safe.
-    private static func decodeString(from data: Data, offset: Int) -> (String, Int)? {
+    /// A string literal whose length has a `prefixBits`-bit prefix, with the Huffman flag
+    /// just above it: 7 for values, 3 and 5 for the literal-name forms. `offset` is relative
+    /// to `data.startIndex`; slice-safe.
+    static func decodeString(from data: Data, offset: Int, prefixBits: Int = 7) -> (String, Int)? {
         guard offset < data.count else { return nil }
         let base = data.startIndex
-        let isHuffman = (data[base + offset] & 0x80) != 0
-        guard let (length, lenBytes) = decodeVarIntPrefix(from: data, offset: offset, prefixBits: 7) else {
+        let isHuffman = (data[base + offset] & UInt8(1 << prefixBits)) != 0
+        guard let (length, lenBytes) = decodeVarIntPrefix(from: data, offset: offset, prefixBits: prefixBits) else {
             return nil
         }
         let strStart = offset + lenBytes
-        guard strStart + Int(length) <= data.count else { return nil }
+        guard length <= UInt64(data.count), strStart + Int(length) <= data.count else { return nil }
 
         let absStart = base + strStart
         let absEnd = absStart + Int(length)
@@ -311,92 +407,4 @@ enum QPACKEncoder {
         guard let string else { return nil }
         return (string, lenBytes + Int(length))
     }
-
-    /// `offset` is relative to `data.startIndex`; slice-safe.
-    private static func decodeStringAfterPrefix(from data: Data, offset: Int, prefixBits: Int) -> (String, Int)? {
-        guard let (nameLen, nLenBytes) = decodeVarIntPrefix(from: data, offset: offset, prefixBits: prefixBits) else {
-            return nil
-        }
-        let strStart = offset + nLenBytes
-        guard strStart + Int(nameLen) <= data.count else { return nil }
-        let base = data.startIndex
-        let absStart = base + strStart
-        let absEnd = absStart + Int(nameLen)
-        let strData = Data(data[absStart..<absEnd])
-        guard let string = String(data: strData, encoding: .utf8) else { return nil }
-        return (string, nLenBytes + Int(nameLen))
-    }
-
-    // MARK: - Static Table
-
-    private static func staticTableEntry(_ index: Int) -> (name: String, value: String)? {
-        switch index {
-        case 0: return (":authority", "")
-        case 1: return (":path", "/")
-        case 15: return (":method", "CONNECT")
-        case 16: return (":method", "DELETE")
-        case 17: return (":method", "GET")
-        case 18: return (":method", "HEAD")
-        case 19: return (":method", "OPTIONS")
-        case 20: return (":method", "POST")
-        case 21: return (":method", "PUT")
-        case 22: return (":scheme", "http")
-        case 23: return (":scheme", "https")
-        case 24: return (":status", "103")
-        case 25: return (":status", "200")
-        case 26: return (":status", "304")
-        case 27: return (":status", "404")
-        case 28: return (":status", "503")
-        case 29: return ("accept", "*/*")
-        case 30: return ("accept", "application/dns-message")
-        case 31: return ("accept-encoding", "gzip, deflate, br")
-        case 32: return ("accept-ranges", "bytes")
-        case 33: return ("access-control-allow-headers", "cache-control")
-        case 34: return ("access-control-allow-headers", "content-type")
-        // Statuses 100–500 live non-contiguously at 63–71 in RFC 9204 Appendix A;
-        // they must resolve here or an indexed `:status` would go missing.
-        case 63: return (":status", "100")
-        case 64: return (":status", "204")
-        case 65: return (":status", "206")
-        case 66: return (":status", "302")
-        case 67: return (":status", "400")
-        case 68: return (":status", "403")
-        case 69: return (":status", "421")
-        case 70: return (":status", "425")
-        case 71: return (":status", "500")
-        default: return nil
-        }
-    }
-
-    private static func staticTableName(_ index: Int) -> String? {
-        switch index {
-        case 0: return ":authority"
-        case 1: return ":path"
-        case 2: return "age"
-        case 3: return "content-disposition"
-        case 4: return "content-length"
-        case 5: return "cookie"
-        case 6: return "date"
-        case 7: return "etag"
-        case 8: return "if-modified-since"
-        case 9: return "if-none-match"
-        case 10: return "last-modified"
-        case 11: return "link"
-        case 12: return "location"
-        case 13: return "referer"
-        case 14: return "set-cookie"
-        case 15: return ":method"
-        case 16: return ":method"
-        case 17: return ":method"
-        case 18: return ":method"
-        case 19: return ":method"
-        case 20: return ":method"
-        case 21: return ":method"
-        case 22: return ":scheme"
-        case 23: return ":scheme"
-        case 24: return ":status"
-        case 25: return ":status"
-        default: return nil
-        }
-    }
 }
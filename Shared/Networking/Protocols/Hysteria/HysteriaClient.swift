@@ -10,6 +10,13 @@ import Foundation
 /// Reconnectable wrapper around `HysteriaSession`; dead sessions clear via
 /// `onClose` and callers reconnect on the next acquire. Chained entries are
 /// removed on close because their transport is one-shot.
+///
+/// Pooled clients are keyed by what the wire sees: server, port, SNI, auth and
+/// obfuscation, plus the hops of a chain by endpoint rather than by ID. So the same
+/// node imported by several subscriptions or reused across chains shares one QUIC
+/// connection, one keepalive and one Brutal controller. The first configuration to
+/// build a session sets its congestion control and bandwidth. A session closes
+/// itself once its last stream has been idle for a while.
 nonisolated final class HysteriaClient {
 
     private struct Key: Hashable {
@@ -17,8 +24,31 @@ nonisolated final class HysteriaClient {
         let port: UInt16
         let sni: String
         let password: String
-        /// Empty for direct entries; colon-joined chain hop IDs otherwise.
-        let chainSignature: String
+        let obfuscation: HysteriaObfuscation?
+        /// Empty for direct entries.
+        let chain: [ChainHop]
+
+        init(_ configuration: HysteriaConfiguration, chain: [ChainHop]) {
+            host = configuration.proxyHost.lowercased()
+            port = configuration.proxyPort
+            sni = configuration.sni.lowercased()
+            password = configuration.password
+            obfuscation = configuration.obfuscation
+            self.chain = chain
+        }
+    }
+
+    /// A chain hop as it dials, so duplicate nodes with distinct IDs compare equal.
+    struct ChainHop: Hashable {
+        let host: String
+        let port: UInt16
+        let outbound: Outbound
+
+        init(_ configuration: ProxyConfiguration) {
+            host = configuration.serverAddress.lowercased()
+            port = configuration.serverPort
+            outbound = configuration.outbound
+        }
     }
 
     private static let registryLock = UnfairLock()
@@ -27,13 +57,7 @@ nonisolated final class HysteriaClient {
     private static var pending: [Key: [(Result<HysteriaClient, Error>) -> Void]] = [:]
 
     static func shared(for configuration: HysteriaConfiguration) -> HysteriaClient {
-        let key = Key(
-            host: configuration.proxyHost,
-            port: configuration.proxyPort,
-            sni: configuration.sni,
-            password: configuration.password,
-            chainSignature: ""
-        )
+        let key = Key(configuration, chain: [])
         registryLock.lock()
         defer { registryLock.unlock() }
         if let existing = registry[key] { return existing }
@@ -61,21 +85,15 @@ nonisolated final class HysteriaClient {
         )
     }
 
-    /// Pooled chained dial. Shares one client per `(server, chainSignature)`.
+    /// Pooled chained dial. Shares one client per `(server, chain)`.
     /// Concurrent cache misses coalesce to a single build.
     static func acquireChained(
         configuration: HysteriaConfiguration,
-        chainSignature: String,
+        chain: [ChainHop],
         builder: @escaping (@escaping (Result<(QUICDatagramTransport, [ProxyClient]), Error>) -> Void) -> Void,
         completion: @escaping (Result<HysteriaClient, Error>) -> Void
     ) {
-        let key = Key(
-            host: configuration.proxyHost,
-            port: configuration.proxyPort,
-            sni: configuration.sni,
-            password: configuration.password,
-            chainSignature: chainSignature
-        )
+        let key = Key(configuration, chain: chain)
 
         registryLock.lock()
         if let existing = registry[key] {
@@ -15,11 +15,12 @@ struct HysteriaConfiguration {
     
     let congestionControl: HysteriaCongestionControl
 
-    /// Client-declared upload bandwidth in Mbit/s; drives Brutal's tx rate. Ignored under `.bbr`.
+    /// Client-declared upload bandwidth in Mbit/s; drives Brutal's tx rate, and 0 has Brutal
+    /// detect it. Ignored unless `.brutal`.
     let uploadMbps: Int
 
     /// Client-declared download bandwidth in Mbit/s; advertised so the server
-    /// paces our downlink under Brutal. Ignored under `.bbr`.
+    /// paces our downlink under Brutal. Ignored unless `.brutal`.
     let downloadMbps: Int
 
     /// Bytes/sec conversion; Brutal uses this unit internally.
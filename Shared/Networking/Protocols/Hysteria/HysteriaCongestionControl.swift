@@ -7,16 +7,22 @@
 
 import Foundation
 
-/// `brutal` paces each direction at a fixed user-configured rate; `bbr` adapts
-/// and asks the server to run its own bandwidth detection.
+/// `brutal` paces each direction at a fixed user-configured rate, or for an upload of 0 at
+/// a rate it measures during the first seconds of a session; the others adapt
+/// and ask the server to run its own bandwidth detection. `auto` picks CUBIC or
+/// BBR per server from the goodput earlier connections achieved.
 enum HysteriaCongestionControl: String, Codable, Hashable, CaseIterable {
     case brutal
     case bbr
+    case cubic
+    case auto
 
     var displayName: String {
         switch self {
         case .brutal: return "Brutal"
         case .bbr: return "BBR"
+        case .cubic: return "CUBIC"
+        case .auto: return "Auto"
         }
     }
 
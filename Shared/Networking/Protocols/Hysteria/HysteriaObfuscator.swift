@@ -12,48 +12,104 @@ import Security
 
 /// XOR obfuscation: every datagram is `salt(8) || (packet XOR keystream)`, where the keystream is
 /// BLAKE2b-256 over `password || salt` cycled to the packet length.
+///
+/// `password || salt` fitting one BLAKE2b block (any password up to 120 bytes) is hashed in a single
+/// compression; longer passwords keep the hasher state with the password absorbed, so a packet only
+/// hashes its salt. The keystream lives on the stack and is applied 32 bytes (four words) at a time.
 final class SalamanderObfuscator: QUICPacketObfuscator {
     static let saltLength = 8
     private static let keyLength = 32  // BLAKE2b-256 digest
 
+    private typealias Keystream = (UInt64, UInt64, UInt64, UInt64)
+
     private let passwordBytes: [UInt8]
+    private let fitsOneBlock: Bool
+    private let passwordState: BLAKE2bHasher
 
     init(password: String) {
         self.passwordBytes = Array(password.utf8)
+        self.fitsOneBlock = passwordBytes.count + Self.saltLength <= BLAKE2bHasher.shortInputLimit
+        var hasher = BLAKE2bHasher(outputLength: Self.keyLength)
+        hasher.update(passwordBytes)
+        self.passwordState = hasher
     }
 
-    private func keystream(salt: [UInt8]) -> [UInt8] {
-        BLAKE2bHasher.hash256(passwordBytes, salt)
+    private func keystream(salt: UnsafeRawPointer) -> Keystream {
+        let saltBytes = UnsafeRawBufferPointer(start: salt, count: Self.saltLength)
+        var key: Keystream = (0, 0, 0, 0)
+        withUnsafeMutableBytes(of: &key) { out in
+            if fitsOneBlock {
+                passwordBytes.withUnsafeBytes { password in
+                    BLAKE2bHasher.hashShort(password, saltBytes, outputLength: Self.keyLength, into: out.baseAddress!)
+                }
+            } else {
+                var hasher = passwordState
+                hasher.update(saltBytes)
+                hasher.finalize(into: out.baseAddress!)
+            }
+        }
+        return key
     }
 
-    func seal(_ packet: UnsafeRawBufferPointer) -> [Data] {
-        var salt = [UInt8](repeating: 0, count: Self.saltLength)
-        _ = SecRandomCopyBytes(kSecRandomDefault, salt.count, &salt)
-        let key = keystream(salt: salt)
+    /// `destination[i] = source[i] ^ key[i % 32]`; the two may be the same buffer.
+    private static func xor(_ source: UnsafeRawPointer, into destination: UnsafeMutableRawPointer, count: Int, key: Keystream) {
+        var offset = 0
+        while offset + keyLength <= count {
+            destination.storeBytes(of: source.loadUnaligned(fromByteOffset: offset, as: UInt64.self) ^ key.0,
+                                   toByteOffset: offset, as: UInt64.self)
+            destination.storeBytes(of: source.loadUnaligned(fromByteOffset: offset + 8, as: UInt64.self) ^ key.1,
+                                   toByteOffset: offset + 8, as: UInt64.self)
+            destination.storeBytes(of: source.loadUnaligned(fromByteOffset: offset + 16, as: UInt64.self) ^ key.2,
+                                   toByteOffset: offset + 16, as: UInt64.self)
+            destination.storeBytes(of: source.loadUnaligned(fromByteOffset: offset + 24, as: UInt64.self) ^ key.3,
+                                   toByteOffset: offset + 24, as: UInt64.self)
+            offset += keyLength
+        }
+        guard offset < count else { return }
+        withUnsafeBytes(of: key) { keyBytes in
+            for index in offset..<count {
+                destination.storeBytes(of: source.load(fromByteOffset: index, as: UInt8.self) ^ keyBytes[index - offset],
+                                       toByteOffset: index, as: UInt8.self)
+            }
+        }
+    }
 
-        var out = [UInt8]()
-        out.reserveCapacity(Self.saltLength + packet.count)
-        out.append(contentsOf: salt)
-        for index in 0..<packet.count {
-            out.append(packet[index] ^ key[index % Self.keyLength])
+    func seal(_ packet: UnsafeRawBufferPointer, into out: UnsafeMutableRawBufferPointer) -> Int? {
+        let length = Self.saltLength + packet.count
+        guard let base = out.baseAddress, out.count >= length else { return nil }
+        _ = SecRandomCopyBytes(kSecRandomDefault, Self.saltLength, base)
+        if let source = packet.baseAddress {
+            Self.xor(source, into: base + Self.saltLength, count: packet.count, key: keystream(salt: base))
         }
-        return [Data(out)]
+        return length
     }
 
-    func open(_ datagram: Data) -> Data? {
-        let count = datagram.count
+    func open(_ datagram: UnsafeRawBufferPointer, into out: UnsafeMutableRawBufferPointer) -> Int? {
+        guard let source = datagram.baseAddress, let base = out.baseAddress else { return 0 }
         // Too short to carry a salt; pass through untouched.
-        guard count > Self.saltLength else { return datagram }
-        return datagram.withUnsafeBytes { raw -> Data in
-            let source = raw.bindMemory(to: UInt8.self)
-            let salt = Array(UnsafeBufferPointer(start: source.baseAddress, count: Self.saltLength))
-            let key = keystream(salt: salt)
-            var out = [UInt8](repeating: 0, count: count - Self.saltLength)
-            for index in 0..<out.count {
-                out[index] = source[Self.saltLength + index] ^ key[index % Self.keyLength]
-            }
-            return Data(out)
+        guard datagram.count > Self.saltLength else {
+            guard out.count >= datagram.count else { return nil }
+            base.copyMemory(from: source, byteCount: datagram.count)
+            return datagram.count
         }
+        let length = datagram.count - Self.saltLength
+        guard out.count >= length else { return nil }
+        Self.xor(source + Self.saltLength, into: base, count: length, key: keystream(salt: source))
+        return length
+    }
+
+    func seal(_ packet: UnsafeRawBufferPointer) -> [Data] {
+        var out = Data(count: Self.saltLength + packet.count)
+        _ = out.withUnsafeMutableBytes { seal(packet, into: $0) }
+        return [out]
+    }
+
+    func open(_ datagram: Data) -> Data? {
+        var out = Data(count: datagram.count > Self.saltLength ? datagram.count - Self.saltLength : datagram.count)
+        let length = datagram.withUnsafeBytes { raw in
+            out.withUnsafeMutableBytes { open(raw, into: $0) }
+        }
+        return length == out.count ? out : nil
     }
 }
 
@@ -141,6 +197,12 @@ final class GeckoObfuscator: QUICPacketObfuscator {
         return result
     }
 
+    /// A 1-RTT packet rides Salamander's single-datagram path; handshake packets fragment.
+    func seal(_ packet: UnsafeRawBufferPointer, into out: UnsafeMutableRawBufferPointer) -> Int? {
+        guard !packet.isEmpty, packet[0] & Self.fragmentFlag == 0 else { return nil }
+        return inner.seal(packet, into: out)
+    }
+
     /// Pads a chunk so the on-wire datagram (salt + header + padding + chunk) lands within the
     /// configured size window; returns 0 when even the unpadded packet already exceeds the max.
     private func randomPadLength(chunkLength: Int) -> UInt16 {
@@ -156,8 +218,20 @@ final class GeckoObfuscator: QUICPacketObfuscator {
         guard let opened = inner.open(datagram), let first = opened.first else { return nil }
         // 1-RTT (short header) passes straight through.
         guard first & Self.fragmentFlag != 0 else { return opened }
+        return acceptFragment([UInt8](opened))
+    }
+
+    func open(_ datagram: UnsafeRawBufferPointer, into out: UnsafeMutableRawBufferPointer) -> Int? {
+        guard let length = inner.open(datagram, into: out) else { return nil }
+        guard length > 0, out[0] & Self.fragmentFlag != 0 else { return length }
+        guard let packet = acceptFragment(Array(UnsafeRawBufferPointer(rebasing: out[0..<length]))),
+              packet.count <= out.count else { return 0 }
+        packet.copyBytes(to: out)
+        return packet.count
+    }
 
-        let bytes = [UInt8](opened)
+    /// Parses one Salamander-opened fragment frame and feeds it to reassembly.
+    private func acceptFragment(_ bytes: [UInt8]) -> Data? {
         guard bytes.count >= Self.headerLength else { return nil }
         let msgID = bytes[1]
         let chunkIdx = Int(bytes[2] >> 4)
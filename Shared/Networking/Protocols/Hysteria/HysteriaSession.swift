@@ -77,6 +77,12 @@ nonisolated final class HysteriaSession {
     private var udpSessions: [UInt32: HysteriaUDPConnection] = [:]
     private var nextUDPSessionID: UInt32 = 1
 
+    /// Datagrams submitted by every UDP session during one `queue` turn, drained by a
+    /// single QUIC write so small datagrams from different flows share UDP packets.
+    /// Accessed only on `queue`.
+    private var coalescedDatagrams: [(data: Data, completion: (Error?) -> Void)] = []
+    private var datagramDrainScheduled = false
+
     /// Pending idle close; without it the QUIC connection (socket, ngtcp2
     /// state, keep-alive PING) stays resident forever after the last consumer
     /// goes away. Accessed only on `queue`.
@@ -130,6 +136,8 @@ nonisolated final class HysteriaSession {
             serverName: configuration.sni,
             alpn: ["h3"],
             datagramsEnabled: true,
+            // The auth request is idempotent, so a resumed session sends it as 0-RTT.
+            earlyData: true,
             tuning: .hysteria(congestionControl: configuration.congestionControl, uploadMbps: configuration.uploadMbps),
             obfuscator: obfuscator,
             transport: transport
@@ -159,8 +167,6 @@ nonisolated final class HysteriaSession {
     }
 
     private func startConnection() {
-        QUICCrypto.registerCallbacks()
-
         quic.connectionClosedHandler = { [weak self] error in
             self?.failSession(error)
         }
@@ -349,9 +355,11 @@ nonisolated final class HysteriaSession {
 
             if serverRxAuto {
                 quic.uninstallBrutalCC()
+            } else if configuration.uploadBytesPerSec == 0 {
+                // Detected tx rate; the server's rx, when it states one, caps it.
+                quic.setBrutalBandwidth(serverRxBytesPerSec)
             } else {
-                // Brutal tx = min(server_rx, client_max_tx); 0 means no cap
-                // on either side (client 0 leaves CUBIC driving).
+                // Brutal tx = min(server_rx, client_max_tx); a server 0 means no cap.
                 let clientTxBps = configuration.uploadBytesPerSec
                 let effectiveTxBps: UInt64 = serverRxBytesPerSec == 0
                     ? clientTxBps
@@ -513,8 +521,40 @@ nonisolated final class HysteriaSession {
         queue.asyncAfter(deadline: .now() + Self.idleCloseDelay, execute: work)
     }
 
+    /// `completion` fires on `queue` once every datagram reaches a terminal state, with the
+    /// first error or `nil`. Called on `queue`.
     func writeDatagrams(_ datagrams: [Data], completion: @escaping (Error?) -> Void) {
-        quic.writeDatagrams(datagrams, completion: completion)
+        dispatchPrecondition(condition: .onQueue(queue))
+        guard !datagrams.isEmpty else {
+            completion(nil)
+            return
+        }
+        var remaining = datagrams.count
+        var firstError: Error?
+        let onEach: (Error?) -> Void = { error in
+            if let error, firstError == nil { firstError = error }
+            remaining -= 1
+            if remaining == 0 { completion(firstError) }
+        }
+        for datagram in datagrams {
+            coalescedDatagrams.append((datagram, onEach))
+        }
+        guard !datagramDrainScheduled else { return }
+        datagramDrainScheduled = true
+        // Behind the sends already queued, so the whole turn drains together. Strong
+        // `self` so queued completions always fire.
+        queue.async { self.drainCoalescedDatagrams() }
+    }
+
+    private func drainCoalescedDatagrams() {
+        datagramDrainScheduled = false
+        let batch = coalescedDatagrams
+        coalescedDatagrams.removeAll(keepingCapacity: true)
+        guard !closed else {
+            for entry in batch { entry.completion(HysteriaError.streamClosed) }
+            return
+        }
+        quic.writeDatagramBatch(batch)
     }
 
     var maxDatagramPayloadSize: Int {
@@ -18,7 +18,7 @@ nonisolated final class HysteriaUDPConnection: ProxyConnection {
 
     /// Confined to `session.queue`. The setter mirrors readiness into
     /// `_isReady` so `isConnected` avoids a sync hop onto `session.queue` —
-    /// one half of a udpQueue⇄quic.queue deadlock.
+    /// one half of a UDP shard queue⇄quic.queue deadlock.
     private var _state: State = .idle
     private var state: State {
         get { _state }
@@ -42,19 +42,62 @@ nonisolated final class HysteriaUDPConnection: ProxyConnection {
     /// surfaced on the next `receiveRaw`.
     private var closureError: Error?
 
-    /// Per-PacketID reassembly slot; fragments arrive interleaved, so each
-    /// PacketID owns one. Evicted on completion, TTL expiry, or cap overflow.
+    /// Reassembly slab: one reusable slot per in-flight PacketID (fragments arrive
+    /// interleaved). A slot appends fragments to one contiguous buffer in arrival order,
+    /// recording each fragment's range and a received bitmap, and keeps the buffer's
+    /// capacity across packets. Recycled on completion, TTL expiry, or LRU at the cap.
     private struct DefragSlot {
-        var fragments: [Data?]
-        var received: Int
-        let fragmentCount: Int
-        let createdAt: DispatchTime
+        var inUse = false
+        var packetID: UInt16 = 0
+        var fragmentCount = 0
+        var received = 0
+        /// One bit per fragID; fragCount is a UInt8.
+        var bitmap: [UInt64] = [0, 0, 0, 0]
+        /// `(offset, length)` in `buffer` per fragID.
+        var ranges: [(offset: Int, length: Int)] = []
+        var buffer: [UInt8] = []
+        var createdAt: UInt64 = 0
+        var lastTouched: UInt64 = 0
+
+        mutating func start(packetID: UInt16, fragmentCount: Int, now: UInt64) {
+            inUse = true
+            self.packetID = packetID
+            self.fragmentCount = fragmentCount
+            received = 0
+            for word in bitmap.indices { bitmap[word] = 0 }
+            ranges.removeAll(keepingCapacity: true)
+            ranges.append(contentsOf: repeatElement((0, 0), count: fragmentCount))
+            buffer.removeAll(keepingCapacity: true)
+            createdAt = now
+            lastTouched = now
+        }
+
+        /// The datagram in fragID order; fragments that arrived in order are already laid
+        /// out that way, so the buffer is handed over as-is.
+        func assembled() -> Data {
+            var expected = 0
+            var inOrder = true
+            for range in ranges {
+                guard range.offset == expected else { inOrder = false; break }
+                expected += range.length
+            }
+            if inOrder { return Data(buffer) }
+            var out = Data(capacity: buffer.count)
+            buffer.withUnsafeBufferPointer { bytes in
+                for range in ranges {
+                    out.append(bytes.baseAddress! + range.offset, count: range.length)
+                }
+            }
+            return out
+        }
     }
-    private var defragSlots: [UInt16: DefragSlot] = [:]
+    private var defragSlots: [DefragSlot] = []
     private static let defragSlotTTLNanos: UInt64 = 10 * 1_000_000_000
-    /// Concurrent reassembly cap; 32 bounds worst-case memory to ~11 MB
-    /// while keeping LRU eviction rare.
+    /// Concurrent reassembly cap; with ``maxAssembledSize`` this bounds the slab to ~2 MB
+    /// however many fragments are lost.
     private static let maxDefragSlots = 32
+    /// Largest reassembled datagram (the UDP payload limit); bigger fragment sets are dropped.
+    private static let maxAssembledSize = 65_535
 
     /// Monotonic PacketID, wrapping 0xFFFF → 1 and skipping 0 ("unfragmented"
     /// to some servers); colliding IDs would merge two packets into one
@@ -122,62 +165,65 @@ nonisolated final class HysteriaUDPConnection: ProxyConnection {
     private func assembleFragment(_ message: HysteriaProtocol.UDPMessage) -> Data? {
         guard message.fragID < message.fragCount, message.fragCount > 0 else { return nil }
 
-        let now = DispatchTime.now()
-        let nowNs = now.uptimeNanoseconds
-
-        // Lazy TTL eviction: a full-dict scan per fragment is noticeable at the cap.
-        let existing = defragSlots[message.packetID]
-        let existingIsExpired = existing.map {
-            nowNs &- $0.createdAt.uptimeNanoseconds > Self.defragSlotTTLNanos
-        } ?? false
-
-        var slot: DefragSlot
-        if let existing, !existingIsExpired,
-           existing.fragmentCount == Int(message.fragCount) {
-            slot = existing
-        } else {
-            // New slot at cap: evict expired slots first, else the oldest.
-            if existing == nil || existingIsExpired,
-               defragSlots.count >= Self.maxDefragSlots {
-                let victim: UInt16? = defragSlots
-                    .lazy
-                    .map { (key: $0.key, slot: $0.value) }
-                    .min { lhs, rhs in
-                        // Prefer expired slots over live ones, then oldest.
-                        let lhsExpired = nowNs &- lhs.slot.createdAt.uptimeNanoseconds > Self.defragSlotTTLNanos
-                        let rhsExpired = nowNs &- rhs.slot.createdAt.uptimeNanoseconds > Self.defragSlotTTLNanos
-                        if lhsExpired != rhsExpired { return lhsExpired }
-                        return lhs.slot.createdAt < rhs.slot.createdAt
-                    }?.key
-                if let victim {
-                    defragSlots.removeValue(forKey: victim)
-                }
+        let now = DispatchTime.now().uptimeNanoseconds
+        let fragmentCount = Int(message.fragCount)
+        let fragID = Int(message.fragID)
+
+        let index: Int
+        if let existing = defragSlots.firstIndex(where: { $0.inUse && $0.packetID == message.packetID }) {
+            index = existing
+            // Expired, or the ID wrapped onto a different packet: restart the slot.
+            if now &- defragSlots[index].createdAt > Self.defragSlotTTLNanos
+                || defragSlots[index].fragmentCount != fragmentCount {
+                defragSlots[index].start(packetID: message.packetID, fragmentCount: fragmentCount, now: now)
             }
-            slot = DefragSlot(
-                fragments: Array(repeating: nil, count: Int(message.fragCount)),
-                received: 0,
-                fragmentCount: Int(message.fragCount),
-                createdAt: now
-            )
-        }
-
-        if slot.fragments[Int(message.fragID)] == nil {
-            slot.fragments[Int(message.fragID)] = message.data
-            slot.received += 1
+        } else {
+            index = claimDefragSlot(now: now)
+            defragSlots[index].start(packetID: message.packetID, fragmentCount: fragmentCount, now: now)
         }
 
-        if slot.received < slot.fragmentCount {
-            defragSlots[message.packetID] = slot
+        let word = fragID >> 6
+        let bit = UInt64(1) << UInt64(fragID & 63)
+        guard defragSlots[index].bitmap[word] & bit == 0 else { return nil }
+        guard defragSlots[index].buffer.count + message.data.count <= Self.maxAssembledSize else {
+            defragSlots[index].inUse = false
             return nil
         }
 
-        defragSlots.removeValue(forKey: message.packetID)
-        var full = Data()
-        for part in slot.fragments {
-            guard let part else { return nil }
-            full.append(part)
+        defragSlots[index].ranges[fragID] = (defragSlots[index].buffer.count, message.data.count)
+        defragSlots[index].buffer.append(contentsOf: message.data)
+        defragSlots[index].bitmap[word] |= bit
+        defragSlots[index].received += 1
+        defragSlots[index].lastTouched = now
+
+        guard defragSlots[index].received == fragmentCount else { return nil }
+        defragSlots[index].inUse = false
+        return defragSlots[index].assembled()
+    }
+
+    /// A free slot, growing the slab up to its cap; once full, the least recently touched
+    /// slot (expired ones first) is evicted.
+    private func claimDefragSlot(now: UInt64) -> Int {
+        if let free = defragSlots.firstIndex(where: { !$0.inUse }) {
+            return free
+        }
+        if defragSlots.count < Self.maxDefragSlots {
+            defragSlots.append(DefragSlot())
+            return defragSlots.count - 1
+        }
+        var victim = 0
+        for index in defragSlots.indices.dropFirst() {
+            let candidate = defragSlots[index]
+            let current = defragSlots[victim]
+            let candidateExpired = now &- candidate.createdAt > Self.defragSlotTTLNanos
+            let currentExpired = now &- current.createdAt > Self.defragSlotTTLNanos
+            if candidateExpired != currentExpired {
+                if candidateExpired { victim = index }
+            } else if candidate.lastTouched < current.lastTouched {
+                victim = index
+            }
         }
-        return full
+        return victim
     }
 
     // MARK: - ProxyConnection overrides
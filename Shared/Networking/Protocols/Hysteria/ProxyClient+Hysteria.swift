@@ -84,8 +84,6 @@ extension ProxyClient {
         destination: String,
         completion: @escaping (Result<ProxyConnection, Error>) -> Void
     ) {
-        let chainSignature = chain.map { $0.id.uuidString }.joined(separator: ":")
-
         // Validate the chain synchronously so config errors aren't deferred behind pool registration.
         let cascadeCommands: [ProxyCommand]
         switch Self.computeChainHopCommands(
@@ -106,7 +104,7 @@ extension ProxyClient {
 
         HysteriaClient.acquireChained(
             configuration: hysteriaConfiguration,
-            chainSignature: chainSignature,
+            chain: chain.map(HysteriaClient.ChainHop.init),
             // Builder must be self-free: one build is shared across concurrent
             // waiters and outlives any single caller's ProxyClient.
             builder: { builderCompletion in
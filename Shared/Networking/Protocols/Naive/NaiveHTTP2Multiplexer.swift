@@ -6,6 +6,7 @@
 //
 
 import Foundation
+import Security
 
 nonisolated private let logger = AnywhereLogger(category: "NaiveHTTP2Multiplexer")
 
@@ -33,8 +34,6 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
     let sni: String
 
     private let transport: TLSStreamTransport
-    /// Invoked once per stream so randomized values (auth, padding) differ per request.
-    private let connectHeaders: () -> [(name: String, value: String)]
 
     private(set) var state: State = .idle
 
@@ -43,6 +42,10 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
     private var _poolState: State = .idle
     private var _poolStreamCount: Int = 0
     private var _poolMaxConcurrent: UInt32 = 100
+    /// Captured once the handshake completes; see ``TLSStreamTransport/peerIdentity``.
+    private var _poolPeer: (address: Data, certificates: [SecCertificate])?
+    /// Server names this connection answered 421 for; never coalesced onto it again.
+    private var _poolMisdirected: Set<String> = []
 
     /// Serial queue guarding all mutable multiplexer + stream state; `.userInitiated` to match the data-plane chain.
     let queue = DispatchQueue(label: AWCore.Identifier.http2SessionQueue, qos: .userInitiated)
@@ -65,17 +68,23 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
 
     private var readyCallbacks: [(Error?) -> Void] = []
 
+    /// Streams with pending DATA, in deficit-round-robin service order.
+    private var dataRing: [NaiveHTTP2Stream] = []
+    /// The ring head was cut off by a full batch and resumes its turn without a new quantum.
+    private var dataRingHeadInService = false
+    private var dataWriteInFlight = false
+    /// DATA bytes one scheduling pass batches into a single transport write.
+    private static let maxDataBatch = 65_536
+
     /// Called when the multiplexer becomes permanently unusable so the pool can evict it.
     var onClose: (() -> Void)?
 
     // MARK: - Initialization
 
-    init(host: String, port: UInt16, sni: String, tunnel: ProxyConnection?,
-         connectHeaders: @escaping () -> [(name: String, value: String)]) {
+    init(host: String, port: UInt16, sni: String, tunnel: ProxyConnection?) {
         self.host = host
         self.port = port
         self.sni = sni
-        self.connectHeaders = connectHeaders
         self.transport = TLSStreamTransport(
             host: host,
             port: port,
@@ -121,6 +130,20 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
         }
     }
 
+    /// Thread-safe: the peer another server name may coalesce onto, while the multiplexer is
+    /// ready and hasn't refused that name.
+    func coalescingPeer(for sni: String) -> (address: Data, certificates: [SecCertificate])? {
+        _poolLock.withLock {
+            guard _poolState == .ready, !_poolMisdirected.contains(sni) else { return nil }
+            return _poolPeer
+        }
+    }
+
+    /// Thread-safe: the server answered 421 Misdirected Request for a coalesced `sni`.
+    func refuseCoalescing(_ sni: String) {
+        _poolLock.withLock { _ = _poolMisdirected.insert(sni) }
+    }
+
     /// Syncs the pool-visible snapshot; must be called on `queue`.
     private func updatePoolSnapshot() {
         _poolLock.withLock {
@@ -159,6 +182,8 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
                     self.completeReadyCallbacks(error)
                     return
                 }
+                let peer = self.transport.peerIdentity
+                self._poolLock.withLock { self._poolPeer = peer }
                 self.sendConnectionPreface()
             }
         }
@@ -166,14 +191,21 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
 
     // MARK: - Stream Lifecycle
 
-    /// Must be called on `queue`.
-    func openStream(destination: String) -> NaiveHTTP2Stream {
+    /// Must be called on `queue`. `coalescedSNI` is set when the stream's own server name
+    /// differs from the connection's.
+    func openStream(
+        destination: String,
+        connectHeaders: @escaping () -> [(name: String, value: String)],
+        coalescedSNI: String? = nil
+    ) -> NaiveHTTP2Stream {
         let streamID = nextStreamID
         nextStreamID += 2  // Client streams are odd-numbered
         let stream = NaiveHTTP2Stream(
             streamID: streamID,
             multiplexer: self,
-            destination: destination
+            destination: destination,
+            connectHeaders: connectHeaders,
+            coalescedSNI: coalescedSNI
         )
         streams[streamID] = stream
         updatePoolSnapshot()
@@ -183,6 +215,7 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
     /// Must be called on `queue`.
     func removeStream(_ stream: NaiveHTTP2Stream) {
         streams.removeValue(forKey: stream.streamID)
+        failPendingWrites(of: stream, error: NaiveHTTP2Error.connectionFailed("Stream closed"))
         updatePoolSnapshot()
     }
 
@@ -311,6 +344,7 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
                 for (_, stream) in streams {
                     stream.adjustSendWindow(delta: delta)
                 }
+                if delta > 0 { pumpData() }
             default:
                 break
             }
@@ -347,6 +381,7 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
         } else if let stream = streams[frame.streamID] {
             stream.adjustSendWindow(delta: Int(increment))
         }
+        pumpData()
     }
 
     private func handleDataFrame(_ frame: NaiveHTTP2Frame, stream: NaiveHTTP2Stream) {
@@ -367,7 +402,7 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
     // MARK: - Send (called by streams)
 
     func sendConnect(stream: NaiveHTTP2Stream, completion: @escaping (Error?) -> Void) {
-        let extraHeaders = connectHeaders()
+        let extraHeaders = stream.connectHeaders()
 
         let headerBlock = HPACKEncoder.encodeConnectRequest(
             authority: stream.destination,
@@ -382,59 +417,131 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
         transport.send(data: headersFrame.serialized, completion: completion)
     }
 
-    /// Sends DATA frames for a stream, respecting connection + stream flow control.
-    func sendData(_ data: Data, on stream: NaiveHTTP2Stream, offset: Int = 0,
-                  completion: @escaping (Error?) -> Void) {
-        guard offset < data.count else {
+    /// Queues DATA for a stream. Frames leave through ``pumpData()``, which interleaves every
+    /// stream with pending writes so one bulk upload can't starve the rest. Must be called on `queue`.
+    func sendData(_ data: Data, on stream: NaiveHTTP2Stream, completion: @escaping (Error?) -> Void) {
+        guard !data.isEmpty else {
             completion(nil)
             return
         }
+        if stream.pendingWrites.isEmpty {
+            dataRing.append(stream)
+        }
+        stream.pendingWrites.append((data, 0, completion))
+        pumpData()
+    }
 
-        let maxPayload = NaiveHTTP2Framer.maxDataPayload
-        var currentOffset = offset
-        var frames = Data()
-
-        while currentOffset < data.count {
-            let remaining = data.count - currentOffset
-            let maxByFlow = min(connectionSendWindow, stream.sendWindow)
-            let chunkSize = min(remaining, min(maxPayload, maxByFlow))
+    // MARK: - DATA Scheduling
 
-            guard chunkSize > 0 else { break }
+    /// Deficit round robin: each turn grants a stream `maxDataPayload × weight / 16` bytes of
+    /// credit and frames its writes up to that credit and both flow-control windows. Streams
+    /// blocked on their own window keep their place; a WINDOW_UPDATE pumps again. One batch is
+    /// in flight at a time, so the writes that queue behind it get interleaved into the next.
+    private func pumpData() {
+        guard !dataWriteInFlight, state != .closed, !dataRing.isEmpty else { return }
 
-            connectionSendWindow -= chunkSize
-            stream.consumeSendWindow(chunkSize)
+        let maxPayload = NaiveHTTP2Framer.maxDataPayload
+        var frames = Data()
+        var finished: [(Error?) -> Void] = []
+        var index = 0
+        var servedThisRound = false
+        var batchFull = false
+
+        while !dataRing.isEmpty, connectionSendWindow > 0 {
+            if index >= dataRing.count {
+                // A full round with nothing sendable means every stream is window-blocked.
+                guard servedThisRound else { break }
+                index = 0
+                servedThisRound = false
+            }
+            let stream = dataRing[index]
+            guard stream.sendWindow > 0 else {
+                index += 1
+                continue
+            }
+            if index == 0 && dataRingHeadInService {
+                dataRingHeadInService = false
+            } else {
+                stream.deficit += max(1, maxPayload * stream.weight / 16)
+            }
 
-            let chunk = Data(data[currentOffset..<(currentOffset + chunkSize)])
-            let frame = NaiveHTTP2Framer.dataFrame(streamID: stream.streamID, payload: chunk)
-            frames.append(frame.serialized)
-            currentOffset += chunkSize
-        }
+            while stream.deficit > 0, connectionSendWindow > 0, stream.sendWindow > 0,
+                  let write = stream.pendingWrites.first {
+                if frames.count >= Self.maxDataBatch {
+                    batchFull = true
+                    break
+                }
+                let chunkSize = min(write.data.count - write.offset, maxPayload,
+                                    connectionSendWindow, stream.sendWindow, stream.deficit)
+                let start = write.data.startIndex + write.offset
+                let frame = NaiveHTTP2Framer.dataFrame(streamID: stream.streamID,
+                                                       payload: Data(write.data[start..<(start + chunkSize)]))
+                frames.append(frame.serialized)
+                connectionSendWindow -= chunkSize
+                stream.consumeSendWindow(chunkSize)
+                stream.deficit -= chunkSize
+                servedThisRound = true
+                if write.offset + chunkSize == write.data.count {
+                    finished.append(write.completion)
+                    stream.pendingWrites.removeFirst()
+                } else {
+                    stream.pendingWrites[0].offset += chunkSize
+                }
+            }
 
-        if frames.isEmpty {
-            // Flow control window exhausted — wait for WINDOW_UPDATE and retry
-            queue.asyncAfter(deadline: .now() + .milliseconds(50)) { [weak self] in
-                self?.sendData(data, on: stream, offset: offset, completion: completion)
+            if stream.pendingWrites.isEmpty {
+                stream.deficit = 0
+                dataRing.remove(at: index)
+            } else if batchFull {
+                // Resume here next pass, mid-turn, so later streams aren't skipped.
+                dataRing = Array(dataRing[index...] + dataRing[..<index])
+                dataRingHeadInService = stream.deficit > 0
+                break
+            } else {
+                index += 1
+            }
+            if frames.count >= Self.maxDataBatch {
+                if index < dataRing.count {
+                    dataRing = Array(dataRing[index...] + dataRing[..<index])
+                }
+                break
             }
-            return
         }
 
-        let nextOffset = currentOffset
+        guard !frames.isEmpty else { return }
+        dataWriteInFlight = true
         transport.send(data: frames) { [weak self] error in
             guard let self else { return }
             self.queue.async {
-                if let error {
+                self.dataWriteInFlight = false
+                for completion in finished {
                     completion(error)
-                    return
                 }
-                if nextOffset < data.count {
-                    self.sendData(data, on: stream, offset: nextOffset, completion: completion)
-                } else {
-                    completion(nil)
+                if let error {
+                    for stream in self.dataRing {
+                        self.failPendingWrites(of: stream, error: error)
+                    }
+                    return
                 }
+                self.pumpData()
             }
         }
     }
 
+    private func failPendingWrites(of stream: NaiveHTTP2Stream, error: Error) {
+        guard !stream.pendingWrites.isEmpty else { return }
+        let writes = stream.pendingWrites
+        stream.pendingWrites.removeAll()
+        stream.deficit = 0
+        if let position = dataRing.firstIndex(where: { $0 === stream }) {
+            if position == 0 { dataRingHeadInService = false }
+            dataRing.remove(at: position)
+        }
+        for write in writes {
+            write.completion(error)
+        }
+    }
+
     /// Sends a control frame (SETTINGS ACK, PING ACK, WINDOW_UPDATE). Fire-and-forget.
     func sendControlFrame(_ frame: NaiveHTTP2Frame) {
         transport.send(data: frame.serialized) { error in
@@ -479,6 +586,9 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
         for (_, stream) in streams {
             stream.handleSessionError(error)
         }
+        for stream in dataRing {
+            failPendingWrites(of: stream, error: error)
+        }
         streams.removeAll()
         updatePoolSnapshot()
         onClose?()
@@ -500,6 +610,9 @@ nonisolated class NaiveHTTP2Multiplexer: Multiplexer {
             for (_, stream) in streams {
                 stream.handleSessionError(NaiveHTTP2Error.connectionFailed("Session closed"))
             }
+            for stream in dataRing {
+                failPendingWrites(of: stream, error: NaiveHTTP2Error.connectionFailed("Session closed"))
+            }
             streams.removeAll()
             updatePoolSnapshot()
             onClose?()
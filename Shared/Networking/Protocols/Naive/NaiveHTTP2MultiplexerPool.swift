@@ -11,6 +11,9 @@ nonisolated private let logger = AnywhereLogger(category: "NaiveHTTP2Pool")
 
 /// Pools HTTP/2 multiplexers keyed by `host:port:sni` so many CONNECT tunnels share one
 /// TCP/TLS connection; multiplexers self-evict via `onClose` on GOAWAY or transport close.
+/// A key with no multiplexer of its own may coalesce onto another key's (RFC 9113 §9.1.1)
+/// when that connection landed on an address the new host resolves to and its certificate
+/// covers the new server name, so many node names on one server share one handshake.
 nonisolated final class NaiveHTTP2MultiplexerPool: MultiplexerPool<NaiveHTTP2Multiplexer> {
 
     static let shared = NaiveHTTP2MultiplexerPool()
@@ -45,8 +48,7 @@ nonisolated final class NaiveHTTP2MultiplexerPool: MultiplexerPool<NaiveHTTP2Mul
     ) {
         if tunnel != nil {
             let multiplexer = NaiveHTTP2Multiplexer(
-                host: host, port: port, sni: sni,
-                tunnel: tunnel, connectHeaders: connectHeaders
+                host: host, port: port, sni: sni, tunnel: tunnel
             )
             let multiplexerID = ObjectIdentifier(multiplexer)
             lock.lock()
@@ -59,16 +61,11 @@ nonisolated final class NaiveHTTP2MultiplexerPool: MultiplexerPool<NaiveHTTP2Mul
                 self.lock.unlock()
                 logger.debug("[NaiveHTTP2Pool] Evicted dedicated multiplexer")
             }
-            multiplexer.queue.async {
-                let stream = multiplexer.openStream(destination: destination)
-                completion(stream)
-            }
+            open(on: multiplexer, destination: destination, connectHeaders: connectHeaders, completion: completion)
             return
         }
 
         let key = Self.makeKey(host: host, port: port, sni: sni)
-        let multiplexer: NaiveHTTP2Multiplexer
-
         lock.lock()
         // Park GOAWAY multiplexers in dedicatedMultiplexers to drain, then evict them from the active bucket.
         if let array = multiplexers[key] {
@@ -79,12 +76,34 @@ nonisolated final class NaiveHTTP2MultiplexerPool: MultiplexerPool<NaiveHTTP2Mul
         multiplexers[key]?.removeAll { $0.isClosed || $0.poolIsGoingAway }
 
         if let existing = multiplexers[key]?.first(where: { $0.tryReserveStream() }) {
+            lastActivity[ObjectIdentifier(existing)] = MonotonicClock.now
+            lock.unlock()
+            open(on: existing, destination: destination, connectHeaders: connectHeaders, completion: completion)
+            return
+        }
+        let candidates = coalescingCandidates(port: port, excluding: key)
+        lock.unlock()
+
+        if let shared = coalesce(among: candidates, host: host, sni: sni) {
+            lock.withLock {
+                let id = ObjectIdentifier(shared)
+                if lastActivity[id] != nil { lastActivity[id] = MonotonicClock.now }
+            }
+            logger.debug("[NaiveHTTP2Pool] Coalesced \(sni) onto the connection for \(shared.sni)")
+            open(on: shared, destination: destination, connectHeaders: connectHeaders,
+                 coalescedSNI: sni, completion: completion)
+            return
+        }
+
+        let multiplexer: NaiveHTTP2Multiplexer
+        lock.lock()
+        if let existing = multiplexers[key]?.first(where: { $0.tryReserveStream() }) {
+            // Another acquire for this key dialed while the lock was dropped.
             lastActivity[ObjectIdentifier(existing)] = MonotonicClock.now
             multiplexer = existing
         } else {
             let new = NaiveHTTP2Multiplexer(
-                host: host, port: port, sni: sni,
-                tunnel: nil, connectHeaders: connectHeaders
+                host: host, port: port, sni: sni, tunnel: nil
             )
             let capturedKey = key
             new.onClose = { [weak self, weak new] in
@@ -97,12 +116,64 @@ nonisolated final class NaiveHTTP2MultiplexerPool: MultiplexerPool<NaiveHTTP2Mul
         }
         lock.unlock()
 
+        open(on: multiplexer, destination: destination, connectHeaders: connectHeaders, completion: completion)
+    }
+
+    private func open(
+        on multiplexer: NaiveHTTP2Multiplexer,
+        destination: String,
+        connectHeaders: @escaping () -> [(name: String, value: String)],
+        coalescedSNI: String? = nil,
+        completion: @escaping (NaiveHTTP2Stream) -> Void
+    ) {
         multiplexer.queue.async {
-            let stream = multiplexer.openStream(destination: destination)
+            let stream = multiplexer.openStream(
+                destination: destination, connectHeaders: connectHeaders, coalescedSNI: coalescedSNI
+            )
             completion(stream)
         }
     }
 
+    // MARK: - Coalescing
+
+    /// Pooled multiplexers on other keys for `port` that could carry another server name.
+    /// Must be called with `lock` held.
+    private func coalescingCandidates(port: UInt16, excluding key: String) -> [NaiveHTTP2Multiplexer] {
+        var candidates: [NaiveHTTP2Multiplexer] = []
+        for (otherKey, bucket) in multiplexers where otherKey != key {
+            for multiplexer in bucket where multiplexer.port == port {
+                candidates.append(multiplexer)
+            }
+        }
+        return candidates
+    }
+
+    /// The first candidate whose peer address `host` resolves to and whose certificate covers
+    /// `sni`, with a stream slot reserved on it. Runs off `lock`: trust evaluation may be slow.
+    /// Only cached answers count, so a host not yet resolved is warmed for the next acquire
+    /// rather than blocking this one.
+    private func coalesce(
+        among candidates: [NaiveHTTP2Multiplexer],
+        host: String,
+        sni: String
+    ) -> NaiveHTTP2Multiplexer? {
+        let peers = candidates.compactMap { multiplexer in
+            multiplexer.coalescingPeer(for: sni).map { (multiplexer, $0) }
+        }
+        guard !peers.isEmpty else { return nil }
+        guard let ips = DNSResolver.shared.cachedIPs(for: host) else {
+            DispatchQueue.global(qos: .utility).async { DNSResolver.shared.prewarm(host) }
+            return nil
+        }
+        let addresses = Set(ips.compactMap(ipAddressBytes(fromIPLiteral:)))
+        for (multiplexer, peer) in peers where addresses.contains(peer.address) {
+            guard CertificatePolicy.covers(chain: peer.certificates, serverName: sni),
+                  multiplexer.tryReserveStream() else { continue }
+            return multiplexer
+        }
+        return nil
+    }
+
     // MARK: - Eviction
 
     override func removeMultiplexer(_ multiplexer: NaiveHTTP2Multiplexer, key: String) {
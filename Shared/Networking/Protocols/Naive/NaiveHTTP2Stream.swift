@@ -26,6 +26,11 @@ nonisolated class NaiveHTTP2Stream: HTTPTunnel {
 
     let streamID: UInt32
     let destination: String
+    /// Invoked once per CONNECT so randomized values (auth, padding) differ per request; held
+    /// per stream because a coalesced connection carries streams of several configurations.
+    let connectHeaders: () -> [(name: String, value: String)]
+    /// This stream's server name when the pool coalesced it onto a connection made for another.
+    let coalescedSNI: String?
 
     private weak var multiplexer: NaiveHTTP2Multiplexer?
 
@@ -33,6 +38,16 @@ nonisolated class NaiveHTTP2Stream: HTTPTunnel {
 
     private(set) var sendWindow: Int
 
+    // DATA scheduling state, owned by the multiplexer on `multiplexer.queue`.
+    /// Writes waiting for the multiplexer's DATA scheduler, oldest first; `offset` is how much
+    /// of `data` has been framed.
+    var pendingWrites: [(data: Data, offset: Int, completion: (Error?) -> Void)] = []
+    /// Round-robin weight in RFC 9113 §5.3.2 terms (1...256, default 16); a stream's quantum
+    /// per scheduling round scales with it.
+    var weight = 16
+    /// Deficit-round-robin credit in bytes; cleared whenever the stream runs out of writes.
+    var deficit = 0
+
     private var recvConsumed: Int = 0
     private var recvWindowSize: Int = NaiveHTTP2FlowControl.naiveInitialWindowSize
 
@@ -50,10 +65,18 @@ nonisolated class NaiveHTTP2Stream: HTTPTunnel {
 
     // MARK: - Init
 
-    init(streamID: UInt32, multiplexer: NaiveHTTP2Multiplexer, destination: String) {
+    init(
+        streamID: UInt32,
+        multiplexer: NaiveHTTP2Multiplexer,
+        destination: String,
+        connectHeaders: @escaping () -> [(name: String, value: String)],
+        coalescedSNI: String?
+    ) {
         self.streamID = streamID
         self.multiplexer = multiplexer
         self.destination = destination
+        self.connectHeaders = connectHeaders
+        self.coalescedSNI = coalescedSNI
         self.sendWindow = NaiveHTTP2FlowControl.defaultInitialWindowSize
     }
 
@@ -195,6 +218,10 @@ nonisolated class NaiveHTTP2Stream: HTTPTunnel {
                 callback?(nil)
             } else if status == "407" {
                 handleStreamError(NaiveHTTP2Error.authenticationRequired)
+            } else if status == "421", let coalescedSNI {
+                // RFC 9113 §9.1.2: the server won't serve this name here; the next acquire dials its own.
+                multiplexer.refuseCoalescing(coalescedSNI)
+                handleStreamError(NaiveHTTP2Error.tunnelFailed(statusCode: status))
             } else {
                 handleStreamError(NaiveHTTP2Error.tunnelFailed(statusCode: status))
             }
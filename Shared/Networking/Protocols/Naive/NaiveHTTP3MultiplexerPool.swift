@@ -37,15 +37,21 @@ nonisolated final class NaiveHTTP3MultiplexerPool: MultiplexerPool<HTTP3Multiple
     ) {
         let key = Self.makeKey(host: host, port: port, sni: sni)
         let multiplexer: HTTP3Multiplexer
+        var spare: HTTP3Multiplexer?
 
         lock.lock()
 
         // Prune dead/stream-blocked muxes here; age-based idle eviction is the base's sweep.
         pruneDead(key: key)
 
-        if let existing = multiplexers[key]?.first(where: { $0.tryReserveStream() }) {
+        // Prefer a multiplexer with headroom; one running low still serves while its spare connects.
+        if let existing = multiplexers[key]?.first(where: { !$0.poolIsRunningLow && $0.tryReserveStream() })
+            ?? multiplexers[key]?.first(where: { $0.tryReserveStream() }) {
             lastActivity[ObjectIdentifier(existing)] = MonotonicClock.now
             multiplexer = existing
+            if existing.poolIsRunningLow {
+                spare = openSpare(key: key, host: host, port: port, sni: sni)
+            }
         } else if let overflow = overflowSession(key: key) {
             lastActivity[ObjectIdentifier(overflow)] = MonotonicClock.now
             multiplexer = overflow
@@ -63,20 +69,14 @@ nonisolated final class NaiveHTTP3MultiplexerPool: MultiplexerPool<HTTP3Multiple
                 }
             }
 
-            let new = HTTP3Multiplexer(
-                host: host, port: port, serverName: sni
-            )
-            let capturedKey = key
-            new.onClose = { [weak self, weak new] in
-                guard let self, let new else { return }
-                self.removeMultiplexer(new, key: capturedKey)
-            }
-            multiplexers[key, default: []].append(new)
-            lastActivity[ObjectIdentifier(new)] = MonotonicClock.now
-            multiplexer = new
+            multiplexer = makeMultiplexer(key: key, host: host, port: port, sni: sni)
         }
         lock.unlock()
 
+        if let spare {
+            spare.queue.async { spare.ensureReady { _ in } }
+        }
+
         multiplexer.queue.async {
             multiplexer.noteStreamStarted()
             let stream = NaiveHTTP3Stream(multiplexer: multiplexer, configuration: configuration, destination: destination)
@@ -84,6 +84,31 @@ nonisolated final class NaiveHTTP3MultiplexerPool: MultiplexerPool<HTTP3Multiple
         }
     }
 
+    /// Must be called with `lock` held.
+    private func makeMultiplexer(key: String, host: String, port: UInt16, sni: String) -> HTTP3Multiplexer {
+        let new = HTTP3Multiplexer(
+            host: host, port: port, serverName: sni
+        )
+        new.onClose = { [weak self, weak new] in
+            guard let self, let new else { return }
+            self.removeMultiplexer(new, key: key)
+        }
+        multiplexers[key, default: []].append(new)
+        lastActivity[ObjectIdentifier(new)] = MonotonicClock.now
+        return new
+    }
+
+    /// Adds a multiplexer for the caller to connect in the background, unless one with
+    /// headroom is already pooled or the pool is at its hard cap. Must be called with `lock` held.
+    private func openSpare(key: String, host: String, port: UInt16, sni: String) -> HTTP3Multiplexer? {
+        let pool = multiplexers[key] ?? []
+        let hardCap = policy?.hardCapPerKey ?? 0
+        guard !pool.contains(where: { !$0.isClosed && !$0.poolIsStreamBlocked && !$0.poolIsRunningLow }),
+              hardCap == 0 || pool.count < hardCap else { return nil }
+        logger.debug("[HTTP3Pool] Opening a spare multiplexer for \(key) ahead of stream exhaustion")
+        return makeMultiplexer(key: key, host: host, port: port, sni: sni)
+    }
+
     /// Returns the least-loaded multiplexer when the pool is at its hard cap.
     /// Must be called with `lock` held.
     private func overflowSession(key: String) -> HTTP3Multiplexer? {
@@ -104,8 +104,9 @@ nonisolated class NaiveHTTP3Stream: NaiveTunnel, HTTP3StreamHandler {
                     return
                 }
 
-                let headerBlock = QPACKEncoder.encodeConnectHeaders(
-                    authority: self.destination, extraHeaders: extraHeaders
+                let headerBlock = multiplexer.encodeHeaderBlock(
+                    QPACKEncoder.connectFields(authority: self.destination, extraHeaders: extraHeaders),
+                    streamID: streamID
                 )
                 let headersFrame = HTTP3Framer.headersFrame(headerBlock: headerBlock)
 
@@ -272,7 +273,8 @@ nonisolated class NaiveHTTP3Stream: NaiveTunnel, HTTP3StreamHandler {
             return
         }
 
-        guard let headers = QPACKEncoder.decodeHeaders(from: frame.payload) else {
+        guard let streamID = quicStreamID,
+              let headers = multiplexer?.decodeHeaderBlock(frame.payload, streamID: streamID) else {
             handleStreamError(HTTP3Error.connectionFailed("Malformed QPACK header block"))
             return
         }
@@ -272,6 +272,10 @@ nonisolated final class NowhereTCPUDPConnection: ProxyConnection, UDPFramingCapa
         super.send(data: frameUDPPacket(data))
     }
 
+    override func send(datagrams: [Data], completion: @escaping (Error?) -> Void) {
+        super.send(data: frameUDPPackets(datagrams), completion: completion)
+    }
+
     override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
         inner.sendRaw(data: data, completion: completion)
     }
@@ -378,7 +382,6 @@ nonisolated final class NowhereTCPConnection: ProxyConnection {
         let auth: Data
         do {
             auth = try NowhereProtocol.makeAuthFrame(
-                key: configuration.key,
                 protocolSpec: configuration.protocolSpec
             )
         } catch {
@@ -397,7 +400,6 @@ nonisolated final class NowhereTCPConnection: ProxyConnection {
         let bootstrap: Data
         do {
             bootstrap = try NowhereProtocol.makeAuthFrame(
-                key: configuration.key,
                 protocolSpec: configuration.protocolSpec
             ) + requestPayload(destination: destination, mode: mode)
         } catch {
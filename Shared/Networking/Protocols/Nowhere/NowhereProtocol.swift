@@ -73,6 +73,8 @@ enum NowhereProtocol {
         let tcpPaddingKey: Data
         let tcpFrameOrder: [FrameElement]
         let udpFrameOrder: [FrameElement]
+        /// HMAC key for the auth tag, hashed from the shared key once per configuration.
+        let authKey: Data
     }
 
     enum UDPType: UInt8 {
@@ -136,11 +138,12 @@ enum NowhereProtocol {
             tcpPaddingLength: UInt8(tcpPaddingLengthValue),
             tcpPaddingKey: hkdfExpand(prk: specPRK, info: tcpPaddingKeyLabel, count: tcpPaddingKeyLength),
             tcpFrameOrder: frameOrder.tcp,
-            udpFrameOrder: frameOrder.udp
+            udpFrameOrder: frameOrder.udp,
+            authKey: Data(SHA256.hash(data: keyBytes))
         )
     }
 
-    static func makeAuthFrame(key: String, protocolSpec: EffectiveSpec) throws -> Data {
+    static func makeAuthFrame(protocolSpec: EffectiveSpec) throws -> Data {
         var nonce = Data(count: 32)
         let randomStatus = nonce.withUnsafeMutableBytes { raw -> Int32 in
             guard let pointer = raw.baseAddress else { return errSecAllocate }
@@ -158,10 +161,9 @@ enum NowhereProtocol {
         message.append(protocolSpec.authPaddingLength)
         message.append(padding)
 
-        let authKey = Data(SHA256.hash(data: Data(key.utf8)))
         let tag = HMAC<SHA256>.authenticationCode(
             for: message,
-            using: SymmetricKey(data: authKey)
+            using: SymmetricKey(data: protocolSpec.authKey)
         )
 
         var paddingBlock = Data(capacity: 1 + padding.count)
@@ -207,20 +209,20 @@ enum NowhereProtocol {
         return Data(code)
     }
 
+    /// The PRKs are derived once per configuration, so each call is a single Expand. The HMAC
+    /// is keyed once and its state copied per block, rather than re-keyed for every block.
     private static func hkdfExpand(prk: Data, info: Data, count: Int) -> Data {
-        var output = Data()
+        let keyed = HMAC<SHA256>(key: SymmetricKey(data: prk))
+        var output = Data(capacity: count + SHA256.byteCount)
         var previous = Data()
         var counter: UInt8 = 1
 
         while output.count < count {
-            var message = Data()
-            message.append(previous)
-            message.append(info)
-            message.append(counter)
-            previous = Data(HMAC<SHA256>.authenticationCode(
-                for: message,
-                using: SymmetricKey(data: prk)
-            ))
+            var hmac = keyed
+            hmac.update(data: previous)
+            hmac.update(data: info)
+            hmac.update(data: [counter])
+            previous = Data(hmac.finalize())
             output.append(previous)
             counter &+= 1
         }
@@ -314,6 +316,12 @@ enum NowhereProtocol {
 
     static func encodeUDPDatagram(type: UDPType, flowID: UInt64, target: String, payload: Data, protocolSpec: EffectiveSpec) throws -> Data {
         let header = try encodeUDPHeader(type: type, flowID: flowID, target: target, protocolSpec: protocolSpec)
+        return encodeUDPDatagram(header: header, payload: payload)
+    }
+
+    /// Frames `payload` behind a header from ``encodeUDPHeader(type:flowID:target:protocolSpec:)``,
+    /// for senders that encode their fixed header once and reuse it for every datagram.
+    static func encodeUDPDatagram(header: Data, payload: Data) -> Data {
         var out = Data(capacity: header.count + payload.count)
         out.append(header)
         out.append(payload)
@@ -324,7 +332,7 @@ enum NowhereProtocol {
         try encodeTarget(target)
     }
 
-    private static func encodeUDPHeader(type: UDPType, flowID: UInt64, target: String, protocolSpec: EffectiveSpec) throws -> Data {
+    static func encodeUDPHeader(type: UDPType, flowID: UInt64, target: String, protocolSpec: EffectiveSpec) throws -> Data {
         let targetBytes = try encodeTarget(target)
         var out = Data(capacity: udpHeaderSize(target: target, protocolSpec: protocolSpec))
         for element in protocolSpec.udpFrameOrder {
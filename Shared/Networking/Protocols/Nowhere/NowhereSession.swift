@@ -105,8 +105,6 @@ nonisolated final class NowhereSession {
     }
 
     private func startConnection() {
-        QUICCrypto.registerCallbacks()
-
         quic.connectionClosedHandler = { [weak self] error in
             self?.failSession(error)
         }
@@ -146,7 +144,6 @@ nonisolated final class NowhereSession {
         let frame: Data
         do {
             frame = try NowhereProtocol.makeAuthFrame(
-                key: configuration.key,
                 protocolSpec: configuration.protocolSpec
             )
         } catch {
@@ -26,6 +26,8 @@ nonisolated final class NowhereUDPConnection: ProxyConnection {
     private var _isReady = false
 
     private var flowID: UInt64 = 0
+    /// The request header depends only on the flow and destination, so it is encoded once.
+    private var requestHeader: Data?
     private var packetQueue: [Data] = []
     private static let maxQueuedPackets = 1024
     private var pendingReceive: ((Data?, Error?) -> Void)?
@@ -108,20 +110,25 @@ nonisolated final class NowhereUDPConnection: ProxyConnection {
             return
         }
 
-        let frame: Data
-        do {
-            frame = try NowhereProtocol.encodeUDPDatagram(
-                type: .request,
-                flowID: flowID,
-                target: destination,
-                payload: payload,
-                protocolSpec: session.protocolSpec
-            )
-        } catch {
-            completion(error)
-            return
+        let header: Data
+        if let requestHeader {
+            header = requestHeader
+        } else {
+            do {
+                header = try NowhereProtocol.encodeUDPHeader(
+                    type: .request,
+                    flowID: flowID,
+                    target: destination,
+                    protocolSpec: session.protocolSpec
+                )
+            } catch {
+                completion(error)
+                return
+            }
+            requestHeader = header
         }
-        session.writeDatagram(frame, completion: completion)
+        session.writeDatagram(NowhereProtocol.encodeUDPDatagram(header: header, payload: payload),
+                              completion: completion)
     }
 
     override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
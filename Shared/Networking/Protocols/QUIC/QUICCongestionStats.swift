@@ -0,0 +1,111 @@
+//
+//  QUICCongestionStats.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "QUICCongestionStats")
+
+// MARK: - QUICCongestionReport
+
+/// One closed connection's congestion-control outcome, taken just before `ngtcp2_conn_del`.
+nonisolated struct QUICCongestionReport {
+    let algorithm: ngtcp2_cc_algo
+    /// Application bytes delivered in both directions (stream data received + stream data acked
+    /// by the peer + datagrams), i.e. what the user actually got out of the connection.
+    let goodputBytes: UInt64
+    /// Seconds from handshake completion to close.
+    let duration: Double
+    let packetsSent: UInt64
+    let packetsLost: UInt64
+
+    var goodputBytesPerSec: Double { duration > 0 ? Double(goodputBytes) / duration : 0 }
+    var lossRate: Double { packetsSent > 0 ? Double(packetsLost) / Double(packetsSent) : 0 }
+}
+
+// MARK: - QUICCongestionStats
+
+/// Per-destination goodput and loss history for each ngtcp2 congestion controller, and the
+/// `.auto` policy that reads it: try every candidate until each has `minSamples` connections,
+/// then keep the best goodput, re-exploring every `exploreInterval`-th connection so a path
+/// that changed (Wi-Fi → cellular) can flip the choice. In-memory only; resets with the tunnel.
+nonisolated final class QUICCongestionStats {
+
+    static let shared = QUICCongestionStats()
+
+    /// Controllers `.auto` chooses between. Brutal needs a configured rate, so it stays explicit.
+    static let autoCandidates: [ngtcp2_cc_algo] = [NGTCP2_CC_ALGO_CUBIC, NGTCP2_CC_ALGO_BBR]
+
+    private static let minSamples = 3
+    private static let exploreInterval = 8
+    /// Connections shorter than this carry too little data to say anything about the controller.
+    private static let minDuration = 2.0
+    /// Weight of the newest sample in the running averages.
+    private static let smoothing = 0.3
+
+    private struct Aggregate {
+        var samples = 0
+        var goodputBytesPerSec = 0.0
+        var lossRate = 0.0
+    }
+
+    private struct Destination {
+        var byAlgorithm: [UInt32: Aggregate] = [:]
+        var selections = 0
+    }
+
+    private let lock = UnfairLock()
+    private var destinations: [String: Destination] = [:]
+
+    /// Picks the controller for a new `.auto` connection to `key` (`host:port`).
+    func selectAlgorithm(for key: String) -> ngtcp2_cc_algo {
+        lock.withLock {
+            var destination = destinations[key] ?? Destination()
+            destination.selections += 1
+            defer { destinations[key] = destination }
+
+            let candidates = Self.autoCandidates
+            // Explore: the least-sampled candidate until every one has enough data.
+            if let undersampled = candidates.min(by: {
+                (destination.byAlgorithm[$0.rawValue]?.samples ?? 0) < (destination.byAlgorithm[$1.rawValue]?.samples ?? 0)
+            }), (destination.byAlgorithm[undersampled.rawValue]?.samples ?? 0) < Self.minSamples {
+                return undersampled
+            }
+            let ranked = candidates.sorted {
+                score(destination.byAlgorithm[$0.rawValue]) > score(destination.byAlgorithm[$1.rawValue])
+            }
+            if destination.selections % Self.exploreInterval == 0, ranked.count > 1 {
+                return ranked[1]
+            }
+            return ranked[0]
+        }
+    }
+
+    /// Folds a closed connection's outcome into `key`'s history.
+    func record(_ report: QUICCongestionReport, for key: String) {
+        logger.debug("[QUIC] \(key) cc=\(report.algorithm.rawValue) goodput=\(Int(report.goodputBytesPerSec)) B/s loss=\(report.packetsLost)/\(report.packetsSent)")
+        guard report.duration >= Self.minDuration, report.goodputBytes > 0 else { return }
+        lock.withLock {
+            var aggregate = destinations[key, default: Destination()].byAlgorithm[report.algorithm.rawValue] ?? Aggregate()
+            if aggregate.samples == 0 {
+                aggregate.goodputBytesPerSec = report.goodputBytesPerSec
+                aggregate.lossRate = report.lossRate
+            } else {
+                aggregate.goodputBytesPerSec += Self.smoothing * (report.goodputBytesPerSec - aggregate.goodputBytesPerSec)
+                aggregate.lossRate += Self.smoothing * (report.lossRate - aggregate.lossRate)
+            }
+            aggregate.samples += 1
+            destinations[key, default: Destination()].byAlgorithm[report.algorithm.rawValue] = aggregate
+        }
+    }
+
+    /// Goodput discounted by loss: on a lossy mobile path the controller that gets the same
+    /// throughput with fewer retransmits wins.
+    private func score(_ aggregate: Aggregate?) -> Double {
+        guard let aggregate, aggregate.samples > 0 else { return 0 }
+        return aggregate.goodputBytesPerSec * (1 - min(aggregate.lossRate, 1))
+    }
+}
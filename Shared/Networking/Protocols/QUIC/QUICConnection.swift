@@ -24,14 +24,29 @@ protocol QUICPacketObfuscator: AnyObject {
     /// Transforms one received wire datagram into a complete QUIC datagram, or `nil` when it yields
     /// none (a Gecko fragment awaiting reassembly, or a malformed packet).
     func open(_ datagram: Data) -> Data?
+
+    /// Single-datagram fast path of `seal(_:)`: writes the wire datagram into `out` and returns its
+    /// length, or `nil` when the packet needs `seal(_:)` (it fragments, or `out` is too small).
+    func seal(_ packet: UnsafeRawBufferPointer, into out: UnsafeMutableRawBufferPointer) -> Int?
+
+    /// Allocation-free `open(_:)`: writes the QUIC datagram into `out` and returns its length, 0 when
+    /// the datagram yields none, or `nil` when `out` is too small and `open(_:)` must be used.
+    func open(_ datagram: UnsafeRawBufferPointer, into out: UnsafeMutableRawBufferPointer) -> Int?
+}
+
+extension QUICPacketObfuscator {
+    func seal(_ packet: UnsafeRawBufferPointer, into out: UnsafeMutableRawBufferPointer) -> Int? { nil }
+    func open(_ datagram: UnsafeRawBufferPointer, into out: UnsafeMutableRawBufferPointer) -> Int? { nil }
 }
 
 // MARK: - QUICConnection
 
 nonisolated class QUICConnection {
 
+    /// `earlyData` sits between `handshaking` and `connected` when a resumption ticket lets
+    /// 0-RTT streams and datagrams ride the first flight.
     enum State {
-        case idle, connecting, handshaking, connected, closing, closed
+        case idle, connecting, handshaking, earlyData, connected, closing, closed
     }
 
     enum QUICError: Error, LocalizedError {
@@ -72,6 +87,9 @@ nonisolated class QUICConnection {
     private let serverName: String
     private let alpn: [String]
     private let tuning: QUICTuning
+    /// Resumed connections complete `connect` before the handshake and carry writes as 0-RTT.
+    /// Only for application protocols whose first requests are safe to replay.
+    private let earlyDataEnabled: Bool
 
     /// When set, ngtcp2 rides this instead of the direct UDP carrier (QUIC through a proxy chain's UDP relay).
     private let transport: QUICDatagramTransport?
@@ -84,6 +102,9 @@ nonisolated class QUICConnection {
     private static let queueKey = DispatchSpecificKey<Bool>()
 
     fileprivate var connectionOpaquePointer: OpaquePointer?
+    /// Slab arena behind every ngtcp2 allocation for `connectionOpaquePointer`; freed in
+    /// one pass right after `ngtcp2_conn_del`, so a closed connection leaves no heap fragments.
+    private var connectionMem: UnsafeMutablePointer<ngtcp2_mem>?
     private var connRefStorage = ngtcp2_crypto_conn_ref()
 
     /// True while inside `ngtcp2_swift_conn_read_pkt`; callbacks fired during read
@@ -98,6 +119,17 @@ nonisolated class QUICConnection {
     /// A coalesced flush is queued; drained by one `writeToUDP` at the end of the queue cycle.
     private var flushScheduled = false
 
+    /// Nesting depth of `handleReceivedBatch`; while > 0 the per-packet flush is deferred to
+    /// the batch end, which runs one write/ACK pass and one timer reschedule.
+    private var rxBatchDepth = 0
+    private var rxBatchNeedsFlush = false
+
+    /// Chained-transport datagrams handed over from the transport's queue. One hop to `queue`
+    /// drains everything that arrived meanwhile as a single receive batch.
+    private let rxInboxLock = UnfairLock()
+    private var rxInbox: [Data] = []
+    private var rxDrainScheduled = false
+
     /// Direct-dial UDP carrier (the active path). `nil` when QUIC rides a `QUICDatagramTransport`.
     private var carrier: QUICDatagramCarrier?
 
@@ -150,41 +182,102 @@ nonisolated class QUICConnection {
     /// current packet-processing batch, so handlers may safely open streams.
     var bidiCreditHandler: ((UInt64) -> Void)?
 
-    private var brutalCC: BrutalCongestionControl?
-    /// Registry key (`ngtcp2_cc *`) for the `@_cdecl` trampolines.
-    private var brutalCCKey: OpaquePointer?
+    /// The controller ngtcp2 was initialized with (`.auto` resolved), for the close-time report.
+    private var ccAlgo: ngtcp2_cc_algo = NGTCP2_CC_ALGO_CUBIC
+    /// Application bytes delivered: stream data received, stream data acked, datagrams received.
+    fileprivate var goodputBytes: UInt64 = 0
+    /// When the handshake completed; the goodput clock starts here.
+    fileprivate var handshakeCompletedTs: ngtcp2_tstamp?
+    /// `QUICCongestionStats` key for this destination.
+    private var ccStatsKey: String { "\(host):\(port)" }
+
+    /// This connection's qlog capture, when `QUICQlogSink.isEnabled` was set at init.
+    fileprivate var qlog: QUICQlogSink?
 
     private let datagramsEnabled: Bool
     static let maxDatagramFrameSize: UInt64 = 65535
 
-    /// Writes blocked by stream flow control; flushed on MAX_STREAM_DATA.
-    private var pendingWrites: [PendingWrite] = []
+    /// Streams opened during `.earlyData`, in open order; reopened under the same IDs if
+    /// the server rejects 0-RTT.
+    fileprivate var earlyStreams: [Int64] = []
+
+    /// 0-RTT was refused and its streams await replay at handshake completion,
+    /// so nothing may be opened or drained until then.
+    private var awaitingEarlyDataReplay: Bool {
+        state == .earlyData && tlsHandler?.earlyDataRejected == true
+    }
+
+    /// Stream and datagram writes are accepted: after the handshake, or under 0-RTT keys.
+    private var acceptsWrites: Bool { state == .connected || state == .earlyData }
+
+    /// Per-stream scatter-gather send queues; drained once per queue cycle and again after
+    /// packets that may carry MAX_STREAM_DATA. Touched only on `queue`.
+    private var streamSendQueues: [Int64: StreamSendQueue] = [:]
+
+    /// Upper bound on the `ngtcp2_vec` array one `writev_stream` call receives.
+    private static let maxStreamVecs = 64
+
+    /// A stream's writes as pinned heap copies in stream order. ngtcp2's `writev_stream` is
+    /// zero-copy and re-reads the pointers on every retransmission, so each buffer stays valid
+    /// until acked. All unsent tails go to ngtcp2 as one `ngtcp2_vec` array, so many small
+    /// writes pack into one packet without concatenation.
+    private final class StreamSendQueue {
+        /// Buffers not yet acked, ascending end offset. `buffers[..<firstUnsent]` are fully
+        /// accepted by ngtcp2; `buffers[firstUnsent]` has `unsentOffset` bytes accepted.
+        var buffers: [InflightStreamBuffer] = []
+        var firstUnsent = 0
+        var unsentOffset = 0
+        /// Absolute stream offset one past the last queued byte.
+        var nextOffset: UInt64 = 0
+        /// A FIN is queued after the last buffer / has been written.
+        var fin = false
+        var finSent = false
+
+        var hasUnsent: Bool { firstUnsent < buffers.count || (fin && !finSent) }
+
+        /// Detaches every completion not yet fired (unsent writes, and a FIN write still
+        /// waiting for its FIN) and stops sending; pinned bytes stay until acked or released.
+        func takeUnfiredCompletions() -> [(Error?) -> Void] {
+            var completions: [(Error?) -> Void] = []
+            for buffer in buffers {
+                if let completion = buffer.completion {
+                    buffer.completion = nil
+                    completions.append(completion)
+                }
+            }
+            firstUnsent = buffers.count
+            unsentOffset = 0
+            fin = false
+            return completions
+        }
 
-    private struct PendingWrite {
-        let streamId: Int64
-        var data: Data
-        let fin: Bool
-        let completion: (Error?) -> Void
+        /// Marks every retained byte unsent again after 0-RTT rejection. No 0-RTT data is
+        /// ever acked, so `buffers` still starts at stream offset 0.
+        func rewind() {
+            firstUnsent = 0
+            unsentOffset = 0
+            finSent = false
+        }
     }
 
-    /// Heap copies of stream bytes per stream, ascending end-offset order. ngtcp2's
-    /// `writev_stream` is zero-copy and re-reads the pointer on every retransmission,
-    /// so bytes must stay valid until acked. Touched only on `queue`.
-    private var inflightStreamBuffers: [Int64: [InflightStreamBuffer]] = [:]
-    /// Absolute tx offset per stream, labeling retained buffers for the ack callback.
-    /// Touched only on `queue`.
-    private var streamTxOffset: [Int64: UInt64] = [:]
-
     /// Stable heap copy of stream bytes handed to ngtcp2.
     private final class InflightStreamBuffer {
         let storage: UnsafeMutableBufferPointer<UInt8>
-        /// Absolute stream offset one past this buffer's last accepted byte.
-        var endOffset: UInt64 = 0
+        /// Absolute stream offset one past this buffer's last byte.
+        let endOffset: UInt64
+        /// This write carried the stream's FIN.
+        let fin: Bool
+        /// Fires once ngtcp2 accepted every byte (and the FIN, if `fin`); nil for a header
+        /// buffer, whose write completes with the payload after it.
+        var completion: ((Error?) -> Void)?
 
-        init(copying data: Data) {
+        init(copying data: Data, endOffset: UInt64, fin: Bool, completion: ((Error?) -> Void)?) {
             let buffer = UnsafeMutableBufferPointer<UInt8>.allocate(capacity: data.count)
             _ = data.copyBytes(to: buffer)
             storage = buffer
+            self.endOffset = endOffset
+            self.fin = fin
+            self.completion = completion
         }
 
         deinit { storage.deallocate() }
@@ -200,7 +293,9 @@ nonisolated class QUICConnection {
     private static let maxPendingDatagrams = 1024
     private var didWarnDatagramOverflow = false
 
-    static let maxUDPPayload = 1452
+    /// Largest UDP payload ever sent: an IPv4 path with a 1500-byte MTU. Direct paths start
+    /// at the 1200-byte floor and PMTUD climbs to what the path carries (see `QUICPathMTU`).
+    static let maxUDPPayload = 1472
 
     /// UDP payload ceiling when riding a `QUICDatagramTransport`: the RFC 9000 §14 floor (1200 B)
     /// always fits the inner transport — larger sizes forced inner fragmentation and, with PMTUD
@@ -210,16 +305,29 @@ nonisolated class QUICConnection {
     /// Reusable tx buffer; one slot suffices because ngtcp2 is single-threaded on `queue`.
     private var txBuffer = [UInt8](repeating: 0, count: QUICConnection.maxUDPPayload)
 
-    /// PMTUD probe sizes, ascending. Must be in (1200, max_tx_udp_payload_size] —
-    /// ngtcp2 silently skips larger probes. Copied by ngtcp2 at conn-new time.
-    private static let pmtudProbes: [UInt16] = [1350, 1400, 1452]
+    /// Obfuscated wire datagrams are sealed into / opened from these instead of a `Data` per packet.
+    /// The rx side covers any UDP datagram, so Gecko's reassembled packets fit too.
+    private var obfuscationTxBuffer = [UInt8](repeating: 0, count: QUICConnection.maxUDPPayload + 64)
+    private var obfuscationRxBuffer = [UInt8](repeating: 0, count: 65536)
+
+    /// Packets `writeToUDP`'s bulk loop packs back-to-back before submitting them as one batch.
+    private static let txBatchCapacity = 16
+
+    /// Multi-packet tx arena for the bulk write loop (GSO-style): packets are written
+    /// contiguously, `txBatchLengths` records each one's size and outbound carrier.
+    private var txArena = [UInt8](repeating: 0, count: QUICConnection.maxUDPPayload * QUICConnection.txBatchCapacity)
+    private var txBatchLengths: [(length: Int, carrier: QUICDatagramCarrier?)] = []
+
+    /// `QUICPathMTU` network the current path's PMTUD result is recorded under; nil on
+    /// chained transports and when the network is unknown.
+    private var pathMTUKey: String?
 
     // MARK: Init
 
     var isOnQueue: Bool { DispatchQueue.getSpecific(key: Self.queueKey) == true }
 
     init(host: String, port: UInt16, serverName: String? = nil, alpn: [String],
-         datagramsEnabled: Bool = false, tuning: QUICTuning,
+         datagramsEnabled: Bool = false, earlyData: Bool = false, tuning: QUICTuning,
          obfuscator: QUICPacketObfuscator? = nil,
          transport: QUICDatagramTransport? = nil) {
         self.host = host
@@ -227,6 +335,7 @@ nonisolated class QUICConnection {
         self.serverName = serverName ?? host
         self.alpn = alpn
         self.datagramsEnabled = datagramsEnabled
+        self.earlyDataEnabled = earlyData
         self.tuning = tuning
         self.obfuscator = obfuscator
         self.transport = transport
@@ -242,7 +351,6 @@ nonisolated class QUICConnection {
                 completion(QUICError.connectionFailed("Invalid state"))
                 return
             }
-            QUICCrypto.registerCallbacks()
             self.state = .connecting
             self.connectCompletion = completion
             self.setupUDP(completion: completion)
@@ -252,13 +360,14 @@ nonisolated class QUICConnection {
     // MARK: Streams
 
     func openBidiStream() -> Int64? {
-        guard state == .connected, let connectionOpaquePointer else { return nil }
+        guard acceptsWrites, !awaitingEarlyDataReplay, let connectionOpaquePointer else { return nil }
         var streamId: Int64 = -1
         let streamData: UnsafeMutableRawPointer? = nil
         let rv = ngtcp2_conn_open_bidi_stream(connectionOpaquePointer, &streamId, streamData)
         if rv != 0 {
             return nil
         }
+        if state == .earlyData { earlyStreams.append(streamId) }
         return streamId
     }
 
@@ -266,18 +375,27 @@ nonisolated class QUICConnection {
     /// Access is serialized on ``queue``.
     var availableBidiStreams: UInt64 {
         dispatchPrecondition(condition: .onQueue(queue))
-        guard state == .connected, let connectionOpaquePointer else { return 0 }
+        guard acceptsWrites, !awaitingEarlyDataReplay, let connectionOpaquePointer else { return 0 }
         return ngtcp2_conn_get_streams_bidi_left2(connectionOpaquePointer)
     }
 
+    /// Connection-level flow-control credit the peer has left us, in bytes.
+    /// Access is serialized on ``queue``.
+    var availableSendWindow: UInt64 {
+        dispatchPrecondition(condition: .onQueue(queue))
+        guard acceptsWrites, let connectionOpaquePointer else { return 0 }
+        return ngtcp2_conn_get_max_data_left2(connectionOpaquePointer)
+    }
+
     func openUniStream() -> Int64? {
-        guard state == .connected, let connectionOpaquePointer else { return nil }
+        guard acceptsWrites, !awaitingEarlyDataReplay, let connectionOpaquePointer else { return nil }
         var streamId: Int64 = -1
         let streamData: UnsafeMutableRawPointer? = nil
         let rv = ngtcp2_conn_open_uni_stream(connectionOpaquePointer, &streamId, streamData)
         if rv != 0 {
             return nil
         }
+        if state == .earlyData { earlyStreams.append(streamId) }
         return streamId
     }
 
@@ -310,7 +428,7 @@ nonisolated class QUICConnection {
             guard let self else { return }
             self.flushScheduled = false
             self.writeToUDP()
-            self.flushPendingWrites()
+            self.flushStreamQueues()
         }
     }
 
@@ -329,12 +447,27 @@ nonisolated class QUICConnection {
         queue.async { [weak self] in
             // Split guards so the completion fires even when `self` is gone.
             guard let self else { completion(QUICError.closed); return }
-            guard let connectionOpaquePointer, self.state == .connected else {
+            guard self.connectionOpaquePointer != nil, self.acceptsWrites else {
                 completion(QUICError.closed)
                 return
             }
-            self.writeStreamImpl(conn: connectionOpaquePointer, streamId: streamId,
-                                 data: data, fin: fin, completion: completion)
+            self.enqueueStreamWrite(streamId: streamId, data: data, fin: fin, completion: completion)
+        }
+    }
+
+    /// Writes `header` and `payload` as two pinned buffers, so a frame header goes out ahead of
+    /// its payload as its own `ngtcp2_vec` without the two being concatenated first.
+    func writeStream(_ streamId: Int64, header: Data, payload: Data, fin: Bool = false,
+                     completion: @escaping (Error?) -> Void) {
+        queue.async { [weak self] in
+            // Split guards so the completion fires even when `self` is gone.
+            guard let self else { completion(QUICError.closed); return }
+            guard self.connectionOpaquePointer != nil, self.acceptsWrites else {
+                completion(QUICError.closed)
+                return
+            }
+            self.enqueueStreamWrite(streamId: streamId, header: header, data: payload, fin: fin,
+                                    completion: completion)
         }
     }
 
@@ -345,7 +478,7 @@ nonisolated class QUICConnection {
         queue.async { [weak self] in
             // Split guards so the completion fires even when `self` is gone.
             guard let self else { completion(QUICError.closed); return }
-            guard self.connectionOpaquePointer != nil, self.state == .connected else {
+            guard self.connectionOpaquePointer != nil, self.acceptsWrites else {
                 completion(QUICError.closed)
                 return
             }
@@ -360,7 +493,7 @@ nonisolated class QUICConnection {
         queue.async { [weak self] in
             // Split guards so the completion fires even when `self` is gone.
             guard let self else { completion(QUICError.closed); return }
-            guard self.connectionOpaquePointer != nil, self.state == .connected else {
+            guard self.connectionOpaquePointer != nil, self.acceptsWrites else {
                 completion(QUICError.closed)
                 return
             }
@@ -384,6 +517,19 @@ nonisolated class QUICConnection {
         }
     }
 
+    /// Queues DATAGRAM frames gathered from several callers and writes them in one
+    /// `writeToUDP()` pass, so `WRITE_DATAGRAM_FLAG_MORE` packs them across callers.
+    /// Each completion fires once. On `queue`.
+    func writeDatagramBatch(_ batch: [(data: Data, completion: (Error?) -> Void)]) {
+        dispatchPrecondition(condition: .onQueue(queue))
+        guard connectionOpaquePointer != nil, acceptsWrites else {
+            for entry in batch { entry.completion(QUICError.closed) }
+            return
+        }
+        enqueueDatagrams(batch.map { PendingDatagram(data: $0.data, completion: $0.completion) })
+        writeToUDP()
+    }
+
     /// Appends with drop-oldest at `maxPendingDatagrams`; dropped completions fire so callers observe the overflow.
     private func enqueueDatagrams(_ datagrams: [PendingDatagram]) {
         pendingDatagrams.append(contentsOf: datagrams)
@@ -414,166 +560,208 @@ nonisolated class QUICConnection {
         return min(frameLimit, pathLimit)
     }
 
-    /// Sends as much stream data as flow control allows, queuing the remainder.
-    private func writeStreamImpl(conn: OpaquePointer, streamId: Int64,
-                                  data: Data, fin: Bool,
-                                  completion: @escaping (Error?) -> Void) {
-        let sent = writeStreamSync(conn: conn, streamId: streamId,
-                                    data: data, fin: fin)
-
-        if sent >= data.count {
+    /// Pins `data` at the tail of the stream's send queue; the next flush hands it to ngtcp2
+    /// together with everything else queued this cycle. A non-empty `header` is pinned as its
+    /// own buffer ahead of `data`. An empty non-FIN write completes at once.
+    private func enqueueStreamWrite(streamId: Int64, header: Data = Data(), data: Data, fin: Bool,
+                                    completion: @escaping (Error?) -> Void) {
+        if header.isEmpty && data.isEmpty && !fin {
             completion(nil)
+            return
+        }
+        let sendQueue: StreamSendQueue
+        if let existing = streamSendQueues[streamId] {
+            sendQueue = existing
         } else {
-            let remaining = Data(data[sent...])
-            pendingWrites.append(PendingWrite(
-                streamId: streamId, data: remaining,
-                fin: fin, completion: completion
-            ))
+            sendQueue = StreamSendQueue()
+            streamSendQueues[streamId] = sendQueue
+        }
+        // Nothing may follow a FIN.
+        guard !sendQueue.fin else {
+            completion(QUICError.closed)
+            return
+        }
+        if !header.isEmpty {
+            sendQueue.nextOffset += UInt64(header.count)
+            sendQueue.buffers.append(InflightStreamBuffer(copying: header, endOffset: sendQueue.nextOffset,
+                                                          fin: false, completion: nil))
         }
+        let endOffset = sendQueue.nextOffset + UInt64(data.count)
+        sendQueue.buffers.append(InflightStreamBuffer(copying: data, endOffset: endOffset,
+                                                      fin: fin, completion: completion))
+        sendQueue.nextOffset = endOffset
+        sendQueue.fin = fin
+        scheduleFlush()
     }
 
-    /// Writes as much stream data as ngtcp2 will accept. Returns bytes accepted.
-    private func writeStreamSync(conn: OpaquePointer, streamId: Int64,
-                                  data: Data, fin: Bool) -> Int {
-        let ts = currentTimestamp()
-        var offset = 0
+    /// Writes every stream's queued bytes that flow and congestion control allow. Runs on `queue`.
+    private func flushStreamQueues() {
+        guard !streamSendQueues.isEmpty, let connectionOpaquePointer else { return }
+        // A completion may call close(); ngtcp2Busy defers teardown so `conn`
+        // isn't freed mid-loop.
+        let prevBusy = ngtcp2Busy
+        ngtcp2Busy = true
+        defer { ngtcp2Busy = prevBusy }
 
-        guard !data.isEmpty else {
-            writeToUDP()
-            return 0
+        var completions: [((Error?) -> Void, Error?)] = []
+        if !acceptsWrites {
+            for sendQueue in streamSendQueues.values {
+                completions += sendQueue.takeUnfiredCompletions().map { ($0, QUICError.closed) }
+            }
+        } else if !awaitingEarlyDataReplay {
+            let ts = currentTimestamp()
+            var wrote = false
+            for (streamId, sendQueue) in streamSendQueues where sendQueue.hasUnsent {
+                wrote = drainStreamQueue(conn: connectionOpaquePointer, streamId: streamId,
+                                         sendQueue, ts: ts, completions: &completions) || wrote
+            }
+            if wrote {
+                ngtcp2_conn_update_pkt_tx_time(connectionOpaquePointer, ts)
+                pacedBurstBytes = 0
+                rescheduleTimer()
+            }
         }
+        // Fire after all ngtcp2 work; completions may enqueue more writes.
+        for (completion, error) in completions { completion(error) }
+    }
+
+    /// Hands the stream's unsent bytes to ngtcp2 as one vec array per packet until it stops
+    /// accepting them. Returns whether any packet was sent.
+    private func drainStreamQueue(conn: OpaquePointer, streamId: Int64, _ sendQueue: StreamSendQueue,
+                                  ts: ngtcp2_tstamp,
+                                  completions: inout [((Error?) -> Void, Error?)]) -> Bool {
+        var vecs: [ngtcp2_vec] = []
+        vecs.reserveCapacity(Self.maxStreamVecs)
+        var wrote = false
+
+        while sendQueue.hasUnsent {
+            vecs.removeAll(keepingCapacity: true)
+            var index = sendQueue.firstUnsent
+            var skip = sendQueue.unsentOffset
+            while index < sendQueue.buffers.count && vecs.count < Self.maxStreamVecs {
+                let storage = sendQueue.buffers[index].storage
+                if storage.count > skip, let base = storage.baseAddress {
+                    vecs.append(ngtcp2_vec(base: base + skip, len: storage.count - skip))
+                }
+                skip = 0
+                index += 1
+            }
+            let carriesFin = sendQueue.fin && index == sendQueue.buffers.count
+            let flags: UInt32 = carriesFin ? UInt32(NGTCP2_WRITE_STREAM_FLAG_FIN) : 0
 
-        // ngtcp2 retains the pointer until the bytes are acked; copy to a heap
-        // buffer released by the ack callback.
-        let baseOffset = streamTxOffset[streamId] ?? 0
-        let inflight = InflightStreamBuffer(copying: data)
-        let stableBase = inflight.storage.baseAddress!
-
-        while offset < data.count {
             var pi = ngtcp2_pkt_info()
-            var pdatalen: ngtcp2_ssize = 0
-
-            let remaining = data.count - offset
-            let isLast = (offset + remaining >= data.count)
-            let flags: UInt32 = {
-                var f: UInt32 = 0
-                if fin && isLast { f |= UInt32(NGTCP2_WRITE_STREAM_FLAG_FIN) }
-                if !isLast { f |= UInt32(NGTCP2_WRITE_STREAM_FLAG_MORE) }
-                return f
-            }()
-
-            var vec = ngtcp2_vec(base: stableBase.advanced(by: offset),
-                                 len: remaining)
+            // Stays -1 when ngtcp2 wrote no STREAM frame.
+            var pdatalen: ngtcp2_ssize = -1
             let (nwrite, outCarrier) = writeReportingCarrier { pathPtr in
                 txBuffer.withUnsafeMutableBufferPointer { destination -> ngtcp2_ssize in
-                    ngtcp2_swift_conn_writev_stream(
-                        conn, pathPtr, &pi, destination.baseAddress, destination.count,
-                        &pdatalen, flags,
-                        streamId, &vec, 1, ts
-                    )
+                    vecs.withUnsafeBufferPointer { vecBuffer in
+                        ngtcp2_swift_conn_writev_stream(
+                            conn, pathPtr, &pi, destination.baseAddress, destination.count,
+                            &pdatalen, flags, streamId, vecBuffer.baseAddress, vecBuffer.count, ts
+                        )
+                    }
                 }
             }
 
-            if nwrite == 0 { break }
+            if pdatalen > 0 {
+                advanceStreamQueue(sendQueue, by: Int(pdatalen), completions: &completions)
+            }
+            if carriesFin && pdatalen >= 0 && sendQueue.firstUnsent == sendQueue.buffers.count {
+                sendQueue.finSent = true
+                if let last = sendQueue.buffers.last, let completion = last.completion {
+                    last.completion = nil
+                    completions.append((completion, nil))
+                }
+            }
 
             if nwrite < 0 {
                 let code = Int32(nwrite)
-                if code == NGTCP2_ERR_WRITE_MORE {
-                    if pdatalen > 0 { offset += Int(pdatalen) }
-                    continue
-                }
-                if code == NGTCP2_ERR_STREAM_DATA_BLOCKED {
-                    if pdatalen > 0 { offset += Int(pdatalen) }
-                    break
-                }
                 if code == NGTCP2_ERR_STREAM_NOT_FOUND || code == NGTCP2_ERR_STREAM_SHUT_WR {
-                    break
+                    completions += sendQueue.takeUnfiredCompletions().map { ($0, QUICError.closed) }
                 }
+                // STREAM_DATA_BLOCKED waits for MAX_STREAM_DATA; anything else is retried next flush.
                 break
             }
-
+            if nwrite == 0 { break }
             sendTxBuf(length: Int(nwrite), to: outCarrier)
-            if pdatalen > 0 { offset += Int(pdatalen) }
-            if pdatalen == 0 { break }
+            notePacedPacket(Int(nwrite), conn: conn, ts: ts)
+            wrote = true
+            if pdatalen <= 0 { break }
+        }
+        return wrote
+    }
+
+    /// Marks `count` more bytes as accepted by ngtcp2, completing each write it finishes. A FIN
+    /// write completes only once its FIN is written.
+    private func advanceStreamQueue(_ sendQueue: StreamSendQueue, by count: Int,
+                                    completions: inout [((Error?) -> Void, Error?)]) {
+        var remaining = count
+        while remaining > 0 && sendQueue.firstUnsent < sendQueue.buffers.count {
+            let buffer = sendQueue.buffers[sendQueue.firstUnsent]
+            let left = buffer.storage.count - sendQueue.unsentOffset
+            if remaining < left {
+                sendQueue.unsentOffset += remaining
+                return
+            }
+            remaining -= left
+            sendQueue.firstUnsent += 1
+            sendQueue.unsentOffset = 0
+            if !buffer.fin, let completion = buffer.completion {
+                buffer.completion = nil
+                completions.append((completion, nil))
+            }
         }
+    }
 
-        // Retain only if bytes were accepted; freed when acked.
-        if offset > 0 {
-            inflight.endOffset = baseOffset + UInt64(offset)
-            inflightStreamBuffers[streamId, default: []].append(inflight)
-            streamTxOffset[streamId] = inflight.endOffset
+    /// Reopens the streams ngtcp2 discarded when the server rejected 0-RTT, in their original
+    /// order so sequential allocation hands each its old ID back, and rewinds their queues so
+    /// the bytes go out again under 1-RTT keys. Runs on `queue` once the handshake completes.
+    fileprivate func replayRejectedEarlyData() {
+        guard let connectionOpaquePointer else { return }
+        let streams = earlyStreams
+        earlyStreams.removeAll()
+        for streamId in streams {
+            var reopened: Int64 = -1
+            let streamData: UnsafeMutableRawPointer? = nil
+            // Bit 1 of a stream ID marks it unidirectional (RFC 9000 §2.1).
+            let rv = streamId & 0x2 == 0
+                ? ngtcp2_conn_open_bidi_stream(connectionOpaquePointer, &reopened, streamData)
+                : ngtcp2_conn_open_uni_stream(connectionOpaquePointer, &reopened, streamData)
+            if rv == 0 && reopened == streamId {
+                streamSendQueues[streamId]?.rewind()
+                continue
+            }
+            if rv == 0 {
+                ngtcp2_conn_shutdown_stream(connectionOpaquePointer, 0, reopened, 0)
+            }
+            failPendingWrites(streamId: streamId, error: QUICError.closed)
+            releaseStreamSendState(streamId: streamId)
+            streamTerminationHandler?(streamId, QUICError.closed)
         }
-
-        writeToUDP()
-        return offset
+        logger.debug("[QUIC] 0-RTT rejected by \(serverName); replayed \(streams.count) streams")
     }
 
     /// Releases retained buffers with `endOffset <= ackedOffset` — they can never be retransmitted. Runs on `queue`.
     fileprivate func releaseAckedStreamData(streamId: Int64, ackedOffset: UInt64) {
-        guard var buffers = inflightStreamBuffers[streamId] else { return }
+        guard let sendQueue = streamSendQueues[streamId] else { return }
         var drop = 0
-        while drop < buffers.count && buffers[drop].endOffset <= ackedOffset {
+        while drop < sendQueue.firstUnsent && sendQueue.buffers[drop].endOffset <= ackedOffset {
             drop += 1
         }
         guard drop > 0 else { return }
-        buffers.removeFirst(drop)
-        inflightStreamBuffers[streamId] = buffers.isEmpty ? nil : buffers
+        sendQueue.buffers.removeFirst(drop)
+        sendQueue.firstUnsent -= drop
     }
 
     /// Drops all retained send state for a stream after ngtcp2 frees it.
     fileprivate func releaseStreamSendState(streamId: Int64) {
-        inflightStreamBuffers[streamId] = nil
-        streamTxOffset[streamId] = nil
+        streamSendQueues[streamId] = nil
     }
 
     /// Fails queued writes for a terminated stream so their completions don't leak. Runs on `queue`.
     fileprivate func failPendingWrites(streamId: Int64, error: Error) {
-        guard !pendingWrites.isEmpty else { return }
-        var remaining: [PendingWrite] = []
-        remaining.reserveCapacity(pendingWrites.count)
-        var failed: [(Error?) -> Void] = []
-        for pendingWrite in pendingWrites {
-            if pendingWrite.streamId == streamId {
-                failed.append(pendingWrite.completion)
-            } else {
-                remaining.append(pendingWrite)
-            }
-        }
-        pendingWrites = remaining
-        for callback in failed { callback(error) }
-    }
-
-    /// Retries flow-control-blocked writes after packets that may carry MAX_STREAM_DATA.
-    private func flushPendingWrites() {
-        guard !pendingWrites.isEmpty, let connectionOpaquePointer else { return }
-        // A completion may call close(); ngtcp2Busy defers teardown so `conn`
-        // isn't freed mid-loop.
-        let prevBusy = ngtcp2Busy
-        ngtcp2Busy = true
-        defer { ngtcp2Busy = prevBusy }
-        guard state == .connected else {
-            let writes = pendingWrites
-            pendingWrites.removeAll()
-            for pendingWrite in writes { pendingWrite.completion(QUICError.closed) }
-            return
-        }
-
-        var remaining: [PendingWrite] = []
-        for pendingWrite in pendingWrites {
-            let sent = writeStreamSync(conn: connectionOpaquePointer, streamId: pendingWrite.streamId,
-                                        data: pendingWrite.data, fin: pendingWrite.fin)
-            if sent >= pendingWrite.data.count {
-                pendingWrite.completion(nil)
-            } else {
-                remaining.append(PendingWrite(
-                    streamId: pendingWrite.streamId,
-                    data: Data(pendingWrite.data[sent...]),
-                    fin: pendingWrite.fin,
-                    completion: pendingWrite.completion
-                ))
-            }
-        }
-        pendingWrites = remaining
+        guard let sendQueue = streamSendQueues[streamId] else { return }
+        for callback in sendQueue.takeUnfiredCompletions() { callback(error) }
     }
 
     // MARK: Close
@@ -591,30 +779,29 @@ nonisolated class QUICConnection {
             // Closed before .connected means TLS didn't complete — invalidate the
             // cached ticket, or a rotated-key ticket causes a permanent HANDSHAKE_TIMEOUT loop.
             if self.state != .connected {
-                QUICSessionTicketCache.invalidate(serverName: self.serverName, alpn: self.alpn)
+                QUICSessionTicketCache.invalidate(server: self.ccStatsKey, serverName: self.serverName, alpn: self.alpn)
             }
             self.retransmitTimer?.cancel()
             self.retransmitTimer = nil
-            // Unregister Brutal before ngtcp2_conn_del frees conn->cc, or late
-            // trampolines look up a dangling key.
-            if let key = self.brutalCCKey {
-                BrutalCongestionControl.unregister(cc: key)
-                self.brutalCCKey = nil
-                self.brutalCC = nil
-            }
             if let connectionOpaquePointer = self.connectionOpaquePointer {
+                self.recordCongestionReport(connectionOpaquePointer)
+                self.recordPathMTU(connectionOpaquePointer)
                 ngtcp2_conn_del(connectionOpaquePointer)
                 self.connectionOpaquePointer = nil
             }
+            self.qlog?.finish()
+            self.qlog = nil
+            if let connectionMem = self.connectionMem {
+                ngtcp2_apple_mem_del(connectionMem)
+                self.connectionMem = nil
+            }
             self.transport?.cancel()
             self.closeCarrier()
             self.state = .closed
-            let writes = self.pendingWrites
-            self.pendingWrites.removeAll()
+            let writes = self.streamSendQueues.values.flatMap { $0.takeUnfiredCompletions() }
+            self.streamSendQueues.removeAll()
             let datagrams = self.pendingDatagrams
             self.pendingDatagrams.removeAll()
-            self.inflightStreamBuffers.removeAll()
-            self.streamTxOffset.removeAll()
             let closeError = error ?? QUICError.closed
             // Fire any still-pending connect callback — the carrier's non-EAGAIN
             // recv error path calls close() directly.
@@ -622,7 +809,7 @@ nonisolated class QUICConnection {
                 self.connectCompletion = nil
                 callback(closeError)
             }
-            for pendingWrite in writes { pendingWrite.completion(closeError) }
+            for completion in writes { completion(closeError) }
             for d in datagrams { d.completion?(closeError) }
             self.connectionClosedHandler?(closeError)
             self.connectionClosedHandler = nil
@@ -683,9 +870,7 @@ nonisolated class QUICConnection {
             state = .handshaking
             let placeholderLocal = localAddr
             transport.startReceiving { [weak self] data in
-                self?.queue.async {
-                    self?.handleReceivedPacket(data, localAddr: placeholderLocal)
-                }
+                self?.enqueueReceived(data, localAddr: placeholderLocal)
             } errorHandler: { [weak self] error in
                 self?.queue.async {
                     guard let self else { return }
@@ -956,6 +1141,7 @@ nonisolated class QUICConnection {
         }
 
         let newLocal = makeMigrationLocalAddr()
+        replanPathMTU(conn)
         let ts = currentTimestamp()
         // Bracket the ngtcp2 call so a synchronously-closing callback can't free `conn`.
         let prevBusy = ngtcp2Busy
@@ -1034,6 +1220,7 @@ nonisolated class QUICConnection {
                 self.abortProactiveMigration(countAsFailure: false)
                 return
             }
+            self.replanPathMTU(conn)
             let ts = self.currentTimestamp()
             let prevBusy = self.ngtcp2Busy
             self.ngtcp2Busy = true
@@ -1112,6 +1299,8 @@ nonisolated class QUICConnection {
             logger.info("[QUIC] Migration validated; new path active")
         } else {
             logger.warning("[QUIC] Migration path validation failed")
+            // The ladder and key were replanned for the abandoned path.
+            pathMTUKey = nil
             if kind == .proactive {
                 abortProactiveMigration(countAsFailure: true)
             } else {
@@ -1142,28 +1331,79 @@ nonisolated class QUICConnection {
     /// Sends `length` bytes from `txBuffer` to the given `carrier`. Drop-on-error; ngtcp2 retransmits.
     private func sendTxBuf(length: Int, to carrier: QUICDatagramCarrier?) {
         guard length > 0 else { return }
+        txBuffer.withUnsafeBytes { raw in
+            sendPacket(UnsafeRawBufferPointer(rebasing: raw[0..<length]), to: carrier)
+        }
+    }
+
+    /// Sends one ngtcp2 packet through the obfuscator, chained transport, or direct carrier.
+    /// `packet` points into a reused buffer and is copied before this returns.
+    private func sendPacket(_ packet: UnsafeRawBufferPointer, to carrier: QUICDatagramCarrier?) {
         if let obfuscator {
-            let datagrams = txBuffer.withUnsafeBytes { raw in
-                obfuscator.seal(UnsafeRawBufferPointer(rebasing: raw[0..<length]))
+            let sent: Bool = obfuscationTxBuffer.withUnsafeMutableBytes { out in
+                guard let length = obfuscator.seal(packet, into: out) else { return false }
+                sendWireBytes(UnsafeRawBufferPointer(rebasing: out[0..<length]), to: carrier)
+                return true
+            }
+            if !sent {
+                for datagram in obfuscator.seal(packet) { sendDatagram(datagram, to: carrier) }
             }
-            for datagram in datagrams { sendDatagram(datagram, to: carrier) }
             return
         }
         if let transport {
-            // Copy out before the next ngtcp2 write reuses txBuffer.
-            let datagram = txBuffer.withUnsafeBufferPointer { buffer -> Data in
-                Data(bytes: buffer.baseAddress!, count: length)
-            }
-            transport.sendDatagram(datagram)
+            transport.sendDatagram(Data(packet))
             return
         }
-        guard let carrier else { return }
-        txBuffer.withUnsafeBufferPointer { buffer in
-            guard let base = buffer.baseAddress else { return }
-            carrier.send(base, length: length)
+        guard let carrier, let base = packet.baseAddress?.assumingMemoryBound(to: UInt8.self) else { return }
+        carrier.send(base, length: packet.count)
+    }
+
+    /// Submits the packets packed in `txArena`. Direct-carrier runs that share a carrier go out
+    /// as one `NWConnection` batch; obfuscated and chained packets are sent one at a time.
+    private func flushTxArena() {
+        guard !txBatchLengths.isEmpty else { return }
+        defer { txBatchLengths.removeAll(keepingCapacity: true) }
+        txArena.withUnsafeBytes { arena in
+            guard let arenaBase = arena.baseAddress else { return }
+            if obfuscator != nil || transport != nil {
+                var offset = 0
+                for (length, outCarrier) in txBatchLengths {
+                    sendPacket(UnsafeRawBufferPointer(start: arenaBase + offset, count: length), to: outCarrier)
+                    offset += length
+                }
+                return
+            }
+            // Two carriers interleave only during a proactive migration; split on each change.
+            var runStart = 0
+            var runOffset = 0
+            var offset = 0
+            for index in txBatchLengths.indices {
+                let outCarrier = txBatchLengths[index].carrier
+                let isRunEnd = index == txBatchLengths.count - 1
+                    || txBatchLengths[index + 1].carrier !== outCarrier
+                offset += txBatchLengths[index].length
+                guard isRunEnd else { continue }
+                if let outCarrier {
+                    let lengths = txBatchLengths[runStart...index].map(\.length)
+                    outCarrier.sendBatch(arenaBase.advanced(by: runOffset).assumingMemoryBound(to: UInt8.self),
+                                         lengths: lengths)
+                }
+                runStart = index + 1
+                runOffset = offset
+            }
         }
     }
 
+    /// `sendDatagram(_:to:)` for bytes in a scratch buffer; copied only for a chained transport.
+    private func sendWireBytes(_ datagram: UnsafeRawBufferPointer, to carrier: QUICDatagramCarrier?) {
+        if let transport {
+            transport.sendDatagram(Data(datagram))
+            return
+        }
+        guard let carrier, let base = datagram.baseAddress?.assumingMemoryBound(to: UInt8.self) else { return }
+        carrier.send(base, length: datagram.count)
+    }
+
     /// Routes one wire datagram to the chained transport or the given direct carrier.
     private func sendDatagram(_ datagram: Data, to carrier: QUICDatagramCarrier?) {
         if let transport {
@@ -1183,7 +1423,8 @@ nonisolated class QUICConnection {
         generateConnectionID(&dcid, length: 16)
         generateConnectionID(&scid, length: 16)
 
-        tlsHandler = QUICTLSHandler(serverName: serverName, alpn: alpn)
+        tlsHandler = QUICTLSHandler(server: ccStatsKey, serverName: serverName, alpn: alpn,
+                                    earlyData: earlyDataEnabled)
 
         var callbacks = ngtcp2_callbacks()
         callbacks.client_initial = quicClientInitialCB
@@ -1213,12 +1454,26 @@ nonisolated class QUICConnection {
         var settings = ngtcp2_settings()
         ngtcp2_swift_settings_default(&settings)
         settings.initial_ts = currentTimestamp()
+        // PMTUD only over the direct carrier: chained probes don't reflect the
+        // wire MTU, and a probe failure trips blackhole detection on a routine inner drop.
         // Chained transports use the RFC 9000 §14 floor; see chainedMaxUDPPayload.
-        settings.max_tx_udp_payload_size = (transport != nil) ? Self.chainedMaxUDPPayload : Self.maxUDPPayload
-        settings.cc_algo = tuning.ngtcp2CCAlgo
-        settings.max_stream_window = tuning.maxStreamWindow
-        settings.max_window = tuning.maxWindow
+        let pmtudPlan = (transport == nil) ? QUICPathMTU.shared.plan(family: Int32(remoteAddr.ss_family)) : nil
+        pathMTUKey = pmtudPlan?.networkKey
+        settings.max_tx_udp_payload_size = pmtudPlan?.maxPayload ?? Self.chainedMaxUDPPayload
+        if case .auto = tuning.cc {
+            ccAlgo = QUICCongestionStats.shared.selectAlgorithm(for: ccStatsKey)
+        } else {
+            ccAlgo = tuning.ngtcp2CCAlgo
+        }
+        settings.cc_algo = ccAlgo
+        let windows = tuning.memoryBoundedWindows
+        settings.max_stream_window = windows.stream
+        settings.max_window = windows.connection
         settings.handshake_timeout = tuning.handshakeTimeout
+        if QUICQlogSink.isEnabled, let sink = QUICQlogSink(label: "\(serverName)-\(port)") {
+            qlog = sink
+            settings.qlog_write = quicQlogWriteCB
+        }
         var parameters = ngtcp2_transport_params()
         ngtcp2_swift_transport_params_default(&parameters)
         parameters.initial_max_streams_bidi = tuning.initialMaxStreamsBidi
@@ -1254,24 +1509,26 @@ nonisolated class QUICConnection {
             return Unmanaged<QUICConnection>.fromOpaque(userData).takeUnretainedValue().connectionOpaquePointer
         }
 
-        // PMTUD only over the direct carrier: chained probes don't reflect the
-        // wire MTU, and a probe failure trips blackhole detection on a routine inner drop.
-        let usePMTUD = (transport == nil)
+        guard let connectionMem = ngtcp2_apple_mem_new() else {
+            throw QUICError.connectionFailed("ngtcp2_apple_mem_new")
+        }
         var connectionOpaquePointer: OpaquePointer?
-        let rv = Self.pmtudProbes.withUnsafeBufferPointer { probes -> Int32 in
-            if usePMTUD {
+        let rv = (pmtudPlan?.probes ?? []).withUnsafeBufferPointer { probes -> Int32 in
+            if pmtudPlan != nil {
                 settings.pmtud_probes = probes.baseAddress
                 settings.pmtud_probeslen = probes.count
             }
             return ngtcp2_swift_conn_client_new(
                 &connectionOpaquePointer, &dcid, &scid, &path, NGTCP2_PROTO_VER_V1,
-                &callbacks, &settings, &parameters, nil, &connRefStorage
+                &callbacks, &settings, &parameters, connectionMem, &connRefStorage
             )
         }
         guard rv == 0, let connectionOpaquePointer else {
+            ngtcp2_apple_mem_del(connectionMem)
             throw QUICError.connectionFailed("ngtcp2_conn_client_new: \(rv)")
         }
         self.connectionOpaquePointer = connectionOpaquePointer
+        self.connectionMem = connectionMem
 
         // Keep-alive PINGs detect silently-broken UDP paths (NAT rebind, idle sweep).
         ngtcp2_conn_set_keep_alive_timeout(connectionOpaquePointer, tuning.keepAliveTimeout)
@@ -1282,32 +1539,62 @@ nonisolated class QUICConnection {
         // Install Brutal after conn_client_new and before any packets, so no
         // stale CUBIC decisions leak through.
         if case .brutal(let initialBps) = tuning.cc {
-            let brutal = BrutalCongestionControl(initialBps: initialBps)
-            if let ccKey = ngtcp2_swift_install_brutal(connectionOpaquePointer) {
-                BrutalCongestionControl.register(brutal, for: ccKey)
-                self.brutalCC = brutal
-                self.brutalCCKey = ccKey
-            }
+            ngtcp2_swift_install_brutal(connectionOpaquePointer, initialBps)
         }
     }
 
+    /// Records the payload size PMTUD reached on the current path under its network.
+    private func recordPathMTU(_ conn: OpaquePointer) {
+        guard let key = pathMTUKey, handshakeCompletedTs != nil else { return }
+        QUICPathMTU.shared.record(
+            payload: Int(ngtcp2_conn_get_path_max_tx_udp_payload_size(conn)),
+            settled: ngtcp2_swift_conn_pmtud_running(conn) == 0,
+            for: key
+        )
+    }
+
+    /// Before a migration: records the path being left, then rewrites the ladder for the
+    /// network now current, which ngtcp2 searches once the new path validates.
+    private func replanPathMTU(_ conn: OpaquePointer) {
+        recordPathMTU(conn)
+        let plan = QUICPathMTU.shared.plan(family: Int32(remoteAddr.ss_family))
+        pathMTUKey = plan.networkKey
+        plan.probes.withUnsafeBufferPointer { probes in
+            ngtcp2_swift_set_pmtud_ladder(conn, probes.baseAddress, probes.count, plan.maxPayload)
+        }
+    }
+
+    /// Feeds this connection's goodput and loss into `QUICCongestionStats`. Brutal connections
+    /// are skipped: their rate is configured, not discovered, so they say nothing about CUBIC/BBR.
+    private func recordCongestionReport(_ conn: OpaquePointer) {
+        if case .brutal = tuning.cc { return }
+        guard let startTs = handshakeCompletedTs else { return }
+        var info = ngtcp2_conn_info()
+        ngtcp2_swift_conn_get_conn_info(conn, &info)
+        let now = currentTimestamp()
+        let report = QUICCongestionReport(
+            algorithm: ccAlgo,
+            goodputBytes: goodputBytes,
+            duration: Double(now > startTs ? now - startTs : 0) / 1_000_000_000,
+            packetsSent: info.pkt_sent,
+            packetsLost: info.pkt_lost
+        )
+        QUICCongestionStats.shared.record(report, for: ccStatsKey)
+    }
+
     /// Updates the Brutal target send rate (bytes/sec); no-op if Brutal isn't installed. Safe off-queue.
     func setBrutalBandwidth(_ bps: UInt64) {
         queue.async { [weak self] in
-            self?.brutalCC?.setTargetBandwidth(bps)
+            guard let connectionOpaquePointer = self?.connectionOpaquePointer else { return }
+            ngtcp2_swift_brutal_set_bandwidth(connectionOpaquePointer, bps)
         }
     }
 
-    /// Reverts to CUBIC (`Hysteria-CC-RX: auto`); safe off-queue. Unregisters BEFORE rewiring
-    /// the CC table so a racing trampoline no-ops rather than touching a half-initialized CUBIC struct.
+    /// Reverts to CUBIC (`Hysteria-CC-RX: auto`); safe off-queue. Runs on `queue`, so it never
+    /// races a CC callback mid-packet.
     func uninstallBrutalCC() {
         queue.async { [weak self] in
-            guard let self, let connectionOpaquePointer = self.connectionOpaquePointer else { return }
-            if let key = self.brutalCCKey {
-                BrutalCongestionControl.unregister(cc: key)
-                self.brutalCCKey = nil
-                self.brutalCC = nil
-            }
+            guard let connectionOpaquePointer = self?.connectionOpaquePointer else { return }
             ngtcp2_swift_uninstall_brutal(connectionOpaquePointer)
         }
     }
@@ -1326,18 +1613,70 @@ nonisolated class QUICConnection {
         return false
     }
 
+    /// Queues a datagram from the chained transport; the first arrival of a burst schedules
+    /// the drain. Safe off-queue.
+    private func enqueueReceived(_ data: Data, localAddr: sockaddr_storage) {
+        let shouldSchedule: Bool = rxInboxLock.withLock {
+            rxInbox.append(data)
+            if rxDrainScheduled { return false }
+            rxDrainScheduled = true
+            return true
+        }
+        guard shouldSchedule else { return }
+        queue.async { [weak self] in
+            guard let self else { return }
+            let packets: [Data] = self.rxInboxLock.withLock {
+                self.rxDrainScheduled = false
+                defer { self.rxInbox.removeAll(keepingCapacity: true) }
+                return self.rxInbox
+            }
+            self.handleReceivedBatch(packets, localAddr: localAddr)
+        }
+    }
+
+    /// Feeds a burst of datagrams to ngtcp2 back-to-back, then runs a single write/ACK pass
+    /// (and with it a single timer reschedule) for the whole batch.
+    private func handleReceivedBatch(_ packets: [Data], localAddr: sockaddr_storage) {
+        rxBatchDepth += 1
+        for packet in packets {
+            // A terminal read_pkt closes the connection; drop the rest of the batch.
+            guard connectionOpaquePointer != nil else { break }
+            handleReceivedPacket(packet, localAddr: localAddr)
+        }
+        rxBatchDepth -= 1
+        guard rxBatchDepth == 0, rxBatchNeedsFlush else { return }
+        rxBatchNeedsFlush = false
+        writeToUDP()
+        flushStreamQueues()
+    }
+
     fileprivate func handleReceivedPacket(_ data: Data, localAddr: sockaddr_storage) {
-        guard let connectionOpaquePointer else { return }
+        guard connectionOpaquePointer != nil else { return }
 
-        // Deobfuscate first; a `nil` result is an incomplete fragment or malformed packet — nothing
-        // to feed ngtcp2 yet.
-        let packet: Data
+        // Deobfuscate first, into the rx scratch buffer when it fits; an empty result is an
+        // incomplete fragment or malformed packet — nothing to feed ngtcp2 yet.
         if let obfuscator {
+            let openedLength = data.withUnsafeBytes { raw in
+                obfuscationRxBuffer.withUnsafeMutableBytes { obfuscator.open(raw, into: $0) }
+            }
+            if let openedLength {
+                guard openedLength > 0 else { return }
+                // Not reentrant: ngtcp2 consumes the packet within read_pkt.
+                obfuscationRxBuffer.withUnsafeBytes { raw in
+                    readPacket(UnsafeRawBufferPointer(rebasing: raw[0..<openedLength]), localAddr: localAddr)
+                }
+                return
+            }
             guard let opened = obfuscator.open(data) else { return }
-            packet = opened
-        } else {
-            packet = data
+            opened.withUnsafeBytes { readPacket($0, localAddr: localAddr) }
+            return
         }
+        data.withUnsafeBytes { readPacket($0, localAddr: localAddr) }
+    }
+
+    /// Feeds one plain QUIC datagram to ngtcp2.
+    private func readPacket(_ packet: UnsafeRawBufferPointer, localAddr: sockaddr_storage) {
+        guard let connectionOpaquePointer else { return }
 
         let ts = currentTimestamp()
         var pi = ngtcp2_pkt_info()
@@ -1348,11 +1687,13 @@ nonisolated class QUICConnection {
         // Guard close() from freeing `conn` while ngtcp2 is still on the stack.
         let prevBusy = ngtcp2Busy
         ngtcp2Busy = true
-        let rv: Int32 = packet.withUnsafeBytes { raw -> Int32 in
-            guard let pointer = raw.baseAddress?.assumingMemoryBound(to: UInt8.self) else { return -1 }
-            return withPath(local: localAddr, remote: remoteAddr, addrLen: addrLen) { pathPtr in
+        let rv: Int32
+        if let pointer = packet.baseAddress?.assumingMemoryBound(to: UInt8.self) {
+            rv = withPath(local: localAddr, remote: remoteAddr, addrLen: addrLen) { pathPtr in
                 ngtcp2_swift_conn_read_pkt(connectionOpaquePointer, pathPtr, &pi, pointer, packet.count, ts)
             }
+        } else {
+            rv = -1
         }
         ngtcp2Busy = prevBusy
 
@@ -1383,11 +1724,54 @@ nonisolated class QUICConnection {
             close(error: error)
             return
         }
+        updateAckThreshold(conn: connectionOpaquePointer, ts: ts)
+        if rxBatchDepth > 0 {
+            rxBatchNeedsFlush = true
+            return
+        }
         scheduleFlush()
     }
 
+    // MARK: ACK Policy
+
+    /// ngtcp2's default: an ACK every second ack-eliciting packet.
+    private static let minAckThreshold = 2
+    /// Past this the peer's loss detection and cwnd growth lag the ACK stream.
+    private static let maxAckThreshold = 10
+    /// ACKs per RTT at full rate, enough to keep the peer's sender ACK-clocked.
+    private static let acksPerRTT = 4
+
+    private var ackThreshold = QUICConnection.minAckThreshold
+    private var ackWindowPackets = 0
+    private var ackWindowStart: ngtcp2_tstamp = 0
+
+    /// Re-sizes the immediate-ACK threshold once per smoothed RTT from the packets read in it,
+    /// so a bulk download ACKs about `acksPerRTT` times per RTT instead of every other packet.
+    /// Each ACK is its own uplink send; on half-duplex Wi-Fi that airtime comes out of the
+    /// downlink. A slow flow stays at the default, so no ACK waits on the delayed-ACK timer.
+    private func updateAckThreshold(conn: OpaquePointer, ts: ngtcp2_tstamp) {
+        guard handshakeCompletedTs != nil else { return }
+        ackWindowPackets += 1
+        if ackWindowStart == 0 {
+            ackWindowStart = ts
+            return
+        }
+        var info = ngtcp2_conn_info()
+        ngtcp2_swift_conn_get_conn_info(conn, &info)
+        guard ts > ackWindowStart, ts - ackWindowStart >= info.smoothed_rtt else { return }
+        let threshold = min(Self.maxAckThreshold,
+                            max(Self.minAckThreshold, ackWindowPackets / Self.acksPerRTT))
+        ackWindowPackets = 0
+        ackWindowStart = ts
+        guard threshold != ackThreshold else { return }
+        ackThreshold = threshold
+        ngtcp2_swift_set_ack_thresh(conn, threshold)
+    }
+
     fileprivate func writeToUDP() {
         guard let connectionOpaquePointer else { return }
+        let signpost = DataPathSignposts.begin("writeToUDP")
+        defer { DataPathSignposts.end("writeToUDP", signpost) }
         // Defer close() until we return; tail completions may re-enter ngtcp2.
         let prevBusy = ngtcp2Busy
         ngtcp2Busy = true
@@ -1437,6 +1821,7 @@ nonisolated class QUICConnection {
             }
             if nwrite > 0 {
                 sendTxBuf(length: Int(nwrite), to: outCarrier)
+                notePacedPacket(Int(nwrite), conn: connectionOpaquePointer, ts: ts)
             }
             if accepted != 0 {
                 let popped = pendingDatagrams.removeFirst()
@@ -1460,18 +1845,31 @@ nonisolated class QUICConnection {
             break
         }
 
+        // Bulk path: pack packets back-to-back into the tx arena and submit each full arena
+        // as one batch, instead of one send (and one Data) per packet.
+        var arenaUsed = 0
         while true {
+            if arenaUsed + Self.maxUDPPayload > txArena.count {
+                flushTxArena()
+                arenaUsed = 0
+            }
+            let offset = arenaUsed
             let (nwrite, outCarrier) = writeReportingCarrier { pathPtr in
-                txBuffer.withUnsafeMutableBufferPointer { destination -> ngtcp2_ssize in
-                    ngtcp2_swift_conn_write_pkt(connectionOpaquePointer, pathPtr, &pi, destination.baseAddress, destination.count, ts)
+                txArena.withUnsafeMutableBufferPointer { arena -> ngtcp2_ssize in
+                    ngtcp2_swift_conn_write_pkt(connectionOpaquePointer, pathPtr, &pi,
+                                                arena.baseAddress! + offset, Self.maxUDPPayload, ts)
                 }
             }
             if nwrite <= 0 { break }
-            sendTxBuf(length: Int(nwrite), to: outCarrier)
+            txBatchLengths.append((Int(nwrite), outCarrier))
+            arenaUsed += Int(nwrite)
+            notePacedPacket(Int(nwrite), conn: connectionOpaquePointer, ts: ts)
         }
+        flushTxArena()
 
         // Updates conn->tx.pacing.next_ts; without it the pacer is disabled and sends burst cwnd-wide.
         ngtcp2_conn_update_pkt_tx_time(connectionOpaquePointer, ts)
+        pacedBurstBytes = 0
 
         rescheduleTimer()
 
@@ -1479,6 +1877,19 @@ nonisolated class QUICConnection {
         for (callback, error) in pendingCompletions { callback?(error) }
     }
 
+    /// Bytes written since the pacer was last advanced.
+    private var pacedBurstBytes = 0
+
+    /// Ends the burst once it reaches ngtcp2's send quantum: advancing the pacer makes every
+    /// further write return 0 until `pacing.next_ts`, which the timer wakes for. Without this
+    /// a pass releases the whole congestion window back to back and paces only the gap after.
+    private func notePacedPacket(_ length: Int, conn: OpaquePointer, ts: ngtcp2_tstamp) {
+        pacedBurstBytes += length
+        guard pacedBurstBytes >= Int(ngtcp2_conn_get_send_quantum2(conn)) else { return }
+        ngtcp2_conn_update_pkt_tx_time(conn, ts)
+        pacedBurstBytes = 0
+    }
+
     // MARK: Timer
 
     /// Last deadline armed, to avoid recreating a DispatchSourceTimer on every ACK.
@@ -1492,7 +1903,9 @@ nonisolated class QUICConnection {
         lastScheduledExpiry = expiry
 
         if retransmitTimer == nil {
-            let timer = DispatchSource.makeTimerSource(queue: queue)
+            // Strict: the pacing deadline is the next burst's release time, and the system
+            // would otherwise coalesce it with other wakeups regardless of leeway.
+            let timer = DispatchSource.makeTimerSource(flags: .strict, queue: queue)
             timer.setEventHandler { [weak self] in
                 guard let self, let connectionOpaquePointer = self.connectionOpaquePointer else { return }
                 self.lastScheduledExpiry = 0
@@ -1512,6 +1925,8 @@ nonisolated class QUICConnection {
                     return
                 }
                 self.writeToUDP()
+                // A paced burst can leave stream bytes queued; release the next quantum.
+                self.flushStreamQueues()
             }
             retransmitTimer = timer
             timer.resume()
@@ -1558,6 +1973,19 @@ private func qcFromUserData(_ userData: UnsafeMutableRawPointer?) -> QUICConnect
     return Unmanaged<QUICConnection>.fromOpaque(p).takeUnretainedValue()
 }
 
+/// Called on `queue` from inside ngtcp2; the FIN write comes from `ngtcp2_conn_del`.
+private let quicQlogWriteCB: @convention(c) (
+    UnsafeMutableRawPointer?, UInt32, UnsafeRawPointer?, Int
+) -> Void = { userData, flags, data, count in
+    guard let connection = qcFromUserData(userData), let sink = connection.qlog else { return }
+    if let data, count > 0 {
+        sink.write(data, count: count)
+    }
+    if flags & NGTCP2_QLOG_WRITE_FLAG_FIN != 0 {
+        sink.finish()
+    }
+}
+
 private let quicClientInitialCB: @convention(c) (
     OpaquePointer?, UnsafeMutableRawPointer?
 ) -> Int32 = { conn, userData in
@@ -1576,15 +2004,27 @@ private let quicClientInitialCB: @convention(c) (
     var paramsBuffer = [UInt8](repeating: 0, count: 256)
     let paramsLength = ngtcp2_conn_encode_local_transport_params(conn, &paramsBuffer, paramsBuffer.count)
     guard paramsLength >= 0 else { return NGTCP2_ERR_CALLBACK_FAILURE }
-    guard let clientHello = tls.buildClientHello(transportParams: Data(paramsBuffer.prefix(Int(paramsLength)))) else {
+    guard let clientHello = tls.buildClientHello(transportParams: Data(paramsBuffer.prefix(Int(paramsLength))),
+                                                 conn: conn) else {
         return NGTCP2_ERR_CALLBACK_FAILURE
     }
-    return clientHello.withUnsafeBytes { buffer -> Int32 in
+    let rv = clientHello.withUnsafeBytes { buffer -> Int32 in
         guard let p = buffer.baseAddress?.assumingMemoryBound(to: UInt8.self) else {
             return NGTCP2_ERR_CALLBACK_FAILURE
         }
         return ngtcp2_conn_submit_crypto_data(conn, NGTCP2_ENCRYPTION_LEVEL_INITIAL, p, clientHello.count)
     }
+    // With the 0-RTT key installed, hand the connection to the caller now; its first
+    // writes follow the Initial without waiting for the server.
+    if rv == 0 && tls.offersEarlyData {
+        connection.queue.async {
+            guard connection.state == .handshaking else { return }
+            connection.state = .earlyData
+            connection.connectCompletion?(nil)
+            connection.connectCompletion = nil
+        }
+    }
+    return rv
 }
 
 private let quicRecvCryptoDataCB: @convention(c) (
@@ -1609,6 +2049,7 @@ private let quicRecvStreamDataCB: @convention(c) (
 ) -> Int32 = { conn, flags, sid, offset, data, datalen, userData, _ in
     guard let conn, let connection = qcFromUserData(userData) else { return 0 }
     let fin = (flags & NGTCP2_STREAM_DATA_FLAG_FIN) != 0
+    connection.goodputBytes &+= UInt64(datalen)
     if let data, datalen > 0 {
         // Zero-copy view into ngtcp2's buffer; the handler must copy before returning.
         let view = Data(
@@ -1631,6 +2072,7 @@ private let quicAckedCB: @convention(c) (
     UnsafeMutableRawPointer?, UnsafeMutableRawPointer?
 ) -> Int32 = { _, streamId, offset, datalen, userData, _ in
     guard let connection = qcFromUserData(userData) else { return 0 }
+    connection.goodputBytes &+= datalen
     connection.releaseAckedStreamData(streamId: streamId, ackedOffset: offset + datalen)
     return 0
 }
@@ -1726,6 +2168,11 @@ private let quicHandshakeCompletedCB: @convention(c) (
 ) -> Int32 = { _, userData in
     guard let connection = qcFromUserData(userData) else { return 0 }
     connection.queue.async {
+        connection.handshakeCompletedTs = connection.currentTimestamp()
+        if connection.tlsHandler?.earlyDataRejected == true {
+            connection.replayRejectedEarlyData()
+        }
+        connection.earlyStreams.removeAll()
         connection.state = .connected
         connection.connectCompletion?(nil)
         connection.connectCompletion = nil
@@ -1757,6 +2204,7 @@ private let quicRecvDatagramCB: @convention(c) (
     OpaquePointer?, UInt32, UnsafePointer<UInt8>?, Int, UnsafeMutableRawPointer?
 ) -> Int32 = { _, _, data, datalen, userData in
     guard let data, datalen > 0, let connection = qcFromUserData(userData) else { return 0 }
+    connection.goodputBytes &+= UInt64(datalen)
     // Zero-copy view; handler must not retain it past this synchronous call.
     let view = Data(
         bytesNoCopy: UnsafeMutableRawPointer(mutating: data),
@@ -0,0 +1,188 @@
+//
+//  QUICPathMTU.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import Darwin
+
+nonisolated private let logger = AnywhereLogger(category: "QUICPathMTU")
+
+// MARK: - QUICPMTUDPlan
+
+/// One path's PMTUD setup: the probe ladder handed to ngtcp2, the hard payload cap, and the
+/// network the result is recorded under.
+nonisolated struct QUICPMTUDPlan {
+    let probes: [UInt16]
+    let maxPayload: Int
+    /// Nil when the network is unknown; nothing is recorded then.
+    let networkKey: String?
+}
+
+// MARK: - QUICPathMTU
+
+/// Per-network PMTUD memory. The ceiling comes from the egress interface's MTU, and the
+/// probes between the RFC 9000 floor and it are ordered so ngtcp2's ladder walk is a binary
+/// search: it skips sizes at or below the largest success and at or above the smallest
+/// failure, so in breadth-first order over the balanced search tree each probe it actually
+/// sends halves the interval. A network's settled result is tried first next time and the
+/// search above it skipped. Persisted in the App Group across tunnel restarts.
+nonisolated final class QUICPathMTU {
+
+    static let shared = QUICPathMTU()
+
+    /// ngtcp2 only probes sizes above the RFC 9000 §14 minimum.
+    static let floor = 1200
+    /// Probe granularity; the search resolves the path to within this many bytes.
+    private static let step = 16
+    /// Fixed ladder length: ngtcp2 copies the ladder at connection setup and a migration
+    /// rewrites it in place, so every plan pads to this.
+    static let ladderLength = 24
+    /// A settled result skips the search above it until this old, so a network whose
+    /// MTU grew is found again.
+    private static let settledLifetime: TimeInterval = 24 * 3600
+    private static let entryLifetime: TimeInterval = 30 * 24 * 3600
+    private static let maxEntries = 64
+
+    private struct Entry: Codable {
+        var payload: Int
+        /// The search ran to completion, so every candidate above `payload` failed.
+        var settled: Bool
+        var updated: Date
+    }
+
+    private let snapshotURL: URL? = FileManager.default
+        .containerURL(forSecurityApplicationGroupIdentifier: AWCore.Identifier.appGroupSuite)?
+        .appendingPathComponent("quic-pmtu.plist")
+
+    private let lock = UnfairLock()
+    private var networkKey: String?
+    private var interfaceMTU: Int?
+    private var entries: [String: Entry] = [:]
+
+    private init() {}
+
+    // MARK: Network
+
+    /// Called on every egress change: `key` identifies the network (SSID, or interface
+    /// and gateway), `interfaceName` the BSD interface whose MTU bounds the search.
+    func setNetwork(key: String?, interfaceName: String?) {
+        let mtu = interfaceName.flatMap(Self.mtu(ofInterface:))
+        lock.withLock {
+            networkKey = key
+            interfaceMTU = mtu
+        }
+    }
+
+    // MARK: Planning
+
+    /// The ladder for a new path to a remote of `family` on the current network.
+    func plan(family: Int32) -> QUICPMTUDPlan {
+        let headers = family == AF_INET6 ? 48 : 28
+        let (key, mtu, entry): (String?, Int?, Entry?) = lock.withLock {
+            (networkKey, interfaceMTU, networkKey.flatMap { entries[Self.entryKey($0, family: family)] })
+        }
+        let ceiling = max(Self.floor + Self.step,
+                          min(QUICConnection.maxUDPPayload, (mtu ?? 1500) - headers))
+        var candidates = Array(stride(from: Self.floor + Self.step, to: ceiling, by: Self.step))
+        candidates.append(ceiling)
+
+        var ladder: [Int]
+        if let entry, entry.payload > Self.floor, entry.payload <= ceiling {
+            let known = entry.payload
+            let skipAbove = entry.settled && Date().timeIntervalSince(entry.updated) < Self.settledLifetime
+            ladder = [known]
+            if !skipAbove { ladder += Self.bisectionOrder(candidates.filter { $0 > known }) }
+            ladder += Self.bisectionOrder(candidates.filter { $0 < known })
+        } else {
+            ladder = Self.bisectionOrder(candidates)
+        }
+        ladder = Array(ladder.prefix(Self.ladderLength))
+        if let last = ladder.last, ladder.count < Self.ladderLength {
+            ladder += repeatElement(last, count: Self.ladderLength - ladder.count)
+        }
+        return QUICPMTUDPlan(
+            probes: ladder.map { UInt16($0) },
+            maxPayload: ceiling,
+            networkKey: key.map { Self.entryKey($0, family: family) }
+        )
+    }
+
+    /// Notes the payload size `plan`'s path reached. `settled` when the search finished;
+    /// a partial search only ever raises what is known.
+    func record(payload: Int, settled: Bool, for networkKey: String) {
+        lock.withLock {
+            if !settled, let existing = entries[networkKey], existing.payload >= payload { return }
+            entries[networkKey] = Entry(payload: payload, settled: settled, updated: Date())
+            guard entries.count > Self.maxEntries,
+                  let oldest = entries.min(by: { $0.value.updated < $1.value.updated })?.key else { return }
+            entries.removeValue(forKey: oldest)
+        }
+        logger.debug("[QUIC] PMTU \(networkKey): \(payload) B\(settled ? "" : " (partial)")")
+    }
+
+    // MARK: Persistence
+
+    /// Called on tunnel stop.
+    func saveSnapshot() {
+        guard let snapshotURL else { return }
+        let snapshot = lock.withLock { entries }
+        guard !snapshot.isEmpty else { return }
+        do {
+            let data = try PropertyListEncoder().encode(snapshot)
+            try data.write(to: snapshotURL, options: [.atomic, .completeFileProtectionUntilFirstUserAuthentication])
+        } catch {
+            logger.error("[QUICPathMTU] Failed to write snapshot: \(error)")
+        }
+    }
+
+    /// Called on tunnel start. Unlike session secrets the file is kept: a network's
+    /// MTU stays useful across many tunnel sessions.
+    func restoreSnapshot() {
+        guard let snapshotURL,
+              let data = try? Data(contentsOf: snapshotURL),
+              let snapshot = try? PropertyListDecoder().decode([String: Entry].self, from: data) else { return }
+        let now = Date()
+        let live = snapshot.filter { now.timeIntervalSince($0.value.updated) < Self.entryLifetime }
+        lock.withLock { entries.merge(live) { current, _ in current } }
+    }
+
+    // MARK: Helpers
+
+    private static func entryKey(_ network: String, family: Int32) -> String {
+        "\(network)\u{0}\(family == AF_INET6 ? "6" : "4")"
+    }
+
+    /// Breadth-first order of the balanced search tree over ascending `sizes`.
+    private static func bisectionOrder(_ sizes: [Int]) -> [Int] {
+        var order: [Int] = []
+        var ranges = [sizes.indices]
+        var head = 0
+        while head < ranges.count {
+            let range = ranges[head]
+            head += 1
+            guard !range.isEmpty else { continue }
+            let mid = range.lowerBound + (range.count - 1) / 2
+            order.append(sizes[mid])
+            ranges.append(range.lowerBound..<mid)
+            ranges.append((mid + 1)..<range.upperBound)
+        }
+        return order
+    }
+
+    private static func mtu(ofInterface name: String) -> Int? {
+        var head: UnsafeMutablePointer<ifaddrs>?
+        guard getifaddrs(&head) == 0, let first = head else { return nil }
+        defer { freeifaddrs(head) }
+        for pointer in sequence(first: first, next: { $0.pointee.ifa_next }) {
+            let ifa = pointer.pointee
+            guard let address = ifa.ifa_addr, address.pointee.sa_family == sa_family_t(AF_LINK),
+                  let data = ifa.ifa_data, String(cString: ifa.ifa_name) == name else { continue }
+            let mtu = Int(data.assumingMemoryBound(to: if_data.self).pointee.ifi_mtu)
+            return mtu > 0 ? mtu : nil
+        }
+        return nil
+    }
+}
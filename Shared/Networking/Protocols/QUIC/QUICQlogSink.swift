@@ -0,0 +1,109 @@
+//
+//  QUICQlogSink.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "QUICQlogSink")
+
+/// Streams one connection's ngtcp2 qlog (JSON-SEQ, loadable in qvis as `.sqlog`) into a
+/// memory-mapped file in the App Group's `Qlog` directory, where the app can pick it up for
+/// export. The file is mapped at `maxFileBytes` up front, so a write is a `memcpy` with no
+/// syscall; output past the cap is dropped, and `finish` trims the file to what was written.
+/// Opt-in (`isEnabled`, toggled by `TunnelMessage.setQlogCapture`) and only the newest
+/// `maxFiles` captures are kept. Called only on `QUICConnection.queue`, so it needs no locking.
+nonisolated final class QUICQlogSink {
+
+    /// Written only by the app-message handler; read once per new connection.
+    nonisolated(unsafe) static var isEnabled = false
+
+    static let maxFileBytes = 4 << 20
+    static let maxFiles = 16
+
+    static var directory: URL? {
+        FileManager.default
+            .containerURL(forSecurityApplicationGroupIdentifier: AWCore.Identifier.appGroupSuite)?
+            .appendingPathComponent("Qlog", isDirectory: true)
+    }
+
+    /// Finished and in-progress captures, newest first.
+    static func capturedFiles() -> [URL] {
+        guard let directory,
+              let files = try? FileManager.default.contentsOfDirectory(
+                at: directory, includingPropertiesForKeys: [.contentModificationDateKey])
+        else { return [] }
+        let dated = files.filter { $0.pathExtension == "sqlog" }.map { url in
+            (url, (try? url.resourceValues(forKeys: [.contentModificationDateKey]))?.contentModificationDate ?? .distantPast)
+        }
+        return dated.sorted { $0.1 > $1.1 }.map(\.0)
+    }
+
+    static func removeAll() {
+        for url in capturedFiles() {
+            try? FileManager.default.removeItem(at: url)
+        }
+    }
+
+    private let fd: Int32
+    private let base: UnsafeMutableRawPointer
+    private var written = 0
+    private var finished = false
+
+    /// Nil when the directory or mapping can't be set up; the connection then runs without qlog.
+    init?(label: String) {
+        guard let directory = Self.directory else { return nil }
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        Self.prune(keeping: Self.maxFiles - 1)
+
+        let stamp = Int(Date().timeIntervalSince1970 * 1000)
+        let safeLabel = String(label.map { $0.isLetter || $0.isNumber || $0 == "." || $0 == "-" ? $0 : "_" })
+        let url = directory.appendingPathComponent("\(stamp)-\(safeLabel).sqlog")
+
+        let fd = open(url.path, O_RDWR | O_CREAT | O_TRUNC, 0o644)
+        guard fd >= 0 else {
+            logger.warning("[QUIC] qlog open failed: errno \(errno)")
+            return nil
+        }
+        guard ftruncate(fd, off_t(Self.maxFileBytes)) == 0,
+              let base = mmap(nil, Self.maxFileBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0),
+              base != MAP_FAILED else {
+            logger.warning("[QUIC] qlog map failed: errno \(errno)")
+            Darwin.close(fd)
+            try? FileManager.default.removeItem(at: url)
+            return nil
+        }
+        self.fd = fd
+        self.base = base
+    }
+
+    deinit {
+        finish()
+    }
+
+    func write(_ data: UnsafeRawPointer, count: Int) {
+        guard !finished else { return }
+        let take = min(count, Self.maxFileBytes - written)
+        guard take > 0 else { return }
+        (base + written).copyMemory(from: data, byteCount: take)
+        written += take
+    }
+
+    /// Unmaps and trims the file to the bytes written; idempotent.
+    func finish() {
+        guard !finished else { return }
+        finished = true
+        munmap(base, Self.maxFileBytes)
+        ftruncate(fd, off_t(written))
+        Darwin.close(fd)
+    }
+
+    /// Deletes all but the newest `count` captures.
+    private static func prune(keeping count: Int) {
+        for url in capturedFiles().dropFirst(max(0, count)) {
+            try? FileManager.default.removeItem(at: url)
+        }
+    }
+}
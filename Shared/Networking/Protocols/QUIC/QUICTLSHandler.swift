@@ -21,30 +21,44 @@ struct QUICSessionTicket {
     let issued: CFAbsoluteTime
     let lifetime: UInt32
     let ticketAgeAdd: UInt32
+    /// `max_early_data_size` from the ticket's early_data extension; 0 when absent.
+    let maxEarlyData: UInt32
+    /// ALPN negotiated on the connection that received the ticket.
+    let alpn: String?
+    /// The server's 0-RTT transport parameters from that connection, encoded by ngtcp2;
+    /// flow-control limits for early data come from these.
+    let transportParams: Data?
 }
 
 extension QUICSessionTicket {
     /// The maximum cache lifetime allowed by RFC 8446.
     static let maxLifetime = UInt32(604800)
+
+    /// RFC 9001 §4.6.1: a QUIC server permits 0-RTT by sending `max_early_data_size` 0xffffffff.
+    var allowsEarlyData: Bool {
+        maxEarlyData == 0xFFFF_FFFF && alpn != nil && transportParams != nil
+    }
 }
 
+/// Keyed by server endpoint, SNI and offered ALPN: a ticket (and the transport parameters
+/// remembered with it) is only valid against the same server under the same protocol.
 enum QUICSessionTicketCache {
     private static let lock = UnfairLock()
     private static var cache: [String: QUICSessionTicket] = [:]
     private static let maxEntries = 64
 
-    private static func key(serverName: String, alpn: [String]) -> String {
-        "\(serverName)\u{0}\(alpn.joined(separator: ","))"
+    private static func key(server: String, serverName: String, alpn: [String]) -> String {
+        "\(server)\u{0}\(serverName)\u{0}\(alpn.joined(separator: ","))"
     }
 
-    static func lookup(serverName: String, alpn: [String]) -> QUICSessionTicket? {
-        let k = key(serverName: serverName, alpn: alpn)
+    static func lookup(server: String, serverName: String, alpn: [String]) -> QUICSessionTicket? {
+        let k = key(server: server, serverName: serverName, alpn: alpn)
         lock.lock(); defer { lock.unlock() }
         return cache[k]
     }
 
-    static func store(_ ticket: QUICSessionTicket, serverName: String, alpn: [String]) {
-        let k = key(serverName: serverName, alpn: alpn)
+    static func store(_ ticket: QUICSessionTicket, server: String, serverName: String, alpn: [String]) {
+        let k = key(server: server, serverName: serverName, alpn: alpn)
         lock.lock(); defer { lock.unlock() }
         cache[k] = ticket
         guard cache.count > maxEntries else { return }
@@ -56,8 +70,8 @@ enum QUICSessionTicketCache {
         }
     }
 
-    static func invalidate(serverName: String, alpn: [String]) {
-        let k = key(serverName: serverName, alpn: alpn)
+    static func invalidate(server: String, serverName: String, alpn: [String]) {
+        let k = key(server: server, serverName: serverName, alpn: alpn)
         lock.lock(); defer { lock.unlock() }
         cache.removeValue(forKey: k)
     }
@@ -84,8 +98,12 @@ nonisolated class QUICTLSHandler {
 
     // MARK: - Properties
 
+    /// `host:port` the connection dials; scopes the ticket cache.
+    private let server: String
     private let serverName: String
     private let alpn: [String]
+    /// Whether a cached ticket that allows it may carry 0-RTT data.
+    private let earlyDataEnabled: Bool
     private var state: HandshakeState = .initial
 
     private var keyDerivation: TLS13KeyDerivation?
@@ -121,11 +139,19 @@ nonisolated class QUICTLSHandler {
 
     private(set) var negotiatedALPN: String?
 
+    /// The ClientHello offered early_data and the 0-RTT key is installed.
+    private(set) var offersEarlyData = false
+    /// The server declined the 0-RTT offer; ngtcp2 has discarded every stream opened under it.
+    private(set) var earlyDataRejected = false
+    private var earlyDataALPN: String?
+
     // MARK: - Initialization
 
-    init(serverName: String, alpn: [String]) {
+    init(server: String, serverName: String, alpn: [String], earlyData: Bool = false) {
+        self.server = server
         self.serverName = serverName
         self.alpn = alpn
+        self.earlyDataEnabled = earlyData
 
         privateKeyP256 = P256.KeyAgreement.PrivateKey()
         privateKeyX25519 = Curve25519.KeyAgreement.PrivateKey()
@@ -137,7 +163,9 @@ nonisolated class QUICTLSHandler {
 
     // MARK: - Build ClientHello
 
-    func buildClientHello(transportParams: Data) -> Data? {
+    /// Offers the cached ticket for resumption and, when it allows early data, installs
+    /// the 0-RTT key on `conn` so stream data can ride the first flight.
+    func buildClientHello(transportParams: Data, conn: OpaquePointer) -> Data? {
         guard let privateKeyP256, let privateKeyX25519 else { return nil }
 
         let p256Public = privateKeyP256.publicKey.x963Representation
@@ -152,7 +180,9 @@ nonisolated class QUICTLSHandler {
         var candidatePSK: Data?
         var candidateCipherSuite: UInt16 = TLSCipherSuite.TLS_AES_128_GCM_SHA256
 
-        let cachedTicket = QUICSessionTicketCache.lookup(serverName: serverName, alpn: alpn)
+        var earlyTicket: QUICSessionTicket?
+
+        let cachedTicket = QUICSessionTicketCache.lookup(server: server, serverName: serverName, alpn: alpn)
 
         if let ticket = cachedTicket,
            CFAbsoluteTimeGetCurrent() - ticket.issued < Double(ticket.lifetime) {
@@ -161,6 +191,9 @@ nonisolated class QUICTLSHandler {
             pskBinderLength = binderLen
             candidatePSK = ticket.psk
             candidateCipherSuite = ticket.cipherSuite
+            if earlyDataEnabled, ticket.allowsEarlyData {
+                earlyTicket = ticket
+            }
         }
 
         var clientHello = TLSClientHelloBuilder.buildQUICClientHello(
@@ -169,6 +202,7 @@ nonisolated class QUICTLSHandler {
             alpn: alpn,
             keyShares: keyShares,
             quicTransportParams: transportParams,
+            earlyData: earlyTicket != nil,
             pskExtension: pskExtData
         )
 
@@ -179,6 +213,13 @@ nonisolated class QUICTLSHandler {
             offeredPSKCipherSuite = candidateCipherSuite
         }
 
+        // Offering early_data but sending none is legal, so a failed install only
+        // costs the 0-RTT flight.
+        if let earlyTicket, installEarlyDataKeys(conn: conn, ticket: earlyTicket, clientHello: clientHello) {
+            offersEarlyData = true
+            earlyDataALPN = earlyTicket.alpn
+        }
+
         transcript.append(clientHello)
         state = .clientHelloSent
 
@@ -245,7 +286,7 @@ nonisolated class QUICTLSHandler {
         case TLSHandshakeType.certificate:         return processCertificate(body)
         case TLSHandshakeType.certificateVerify:   return processCertificateVerify(body)
         case TLSHandshakeType.finished:            return processServerFinished(body, conn: conn)
-        case TLSHandshakeType.newSessionTicket:    return processNewSessionTicket(body)
+        case TLSHandshakeType.newSessionTicket:    return processNewSessionTicket(body, conn: conn)
         default:
             logger.warning("[QUIC-TLS] Unknown message type: \(msgType)")
             return .success
@@ -309,6 +350,7 @@ nonisolated class QUICTLSHandler {
         var supportedVersionsSeen = false
         var negotiatedVersion: UInt16 = 0
         var observedExtensionTypes = Set<UInt16>()
+        var earlyDataAccepted = false
         let extEnd = offset + extLen
         while offset + 4 <= extEnd && offset + 4 <= body.count {
             let extType = (UInt16(body[offset]) << 8) | UInt16(body[offset + 1])
@@ -455,6 +497,8 @@ nonisolated class QUICTLSHandler {
                         }
                     }
                 }
+            } else if extType == TLSExtensionType.earlyData {
+                earlyDataAccepted = true
             }
             offset += extDataLen
         }
@@ -465,6 +509,18 @@ nonisolated class QUICTLSHandler {
             }
         }
 
+        if earlyDataAccepted {
+            // Unsolicited acceptance, or 0-RTT carried under a different ALPN (RFC 8446 §4.2.10).
+            guard offersEarlyData, pskAccepted, negotiatedALPN == earlyDataALPN else {
+                return .error(NGTCP2_ERR_CALLBACK_FAILURE)
+            }
+        } else if offersEarlyData {
+            earlyDataRejected = true
+            guard ngtcp2_conn_tls_early_data_rejected(conn) == 0 else {
+                return .error(NGTCP2_ERR_CALLBACK_FAILURE)
+            }
+        }
+
         return .success
     }
 
@@ -676,9 +732,48 @@ nonisolated class QUICTLSHandler {
         }
     }
 
+    /// Derives `c e traffic` from the ticket's PSK and the ClientHello, installs it as the
+    /// 0-RTT key, and restores the transport parameters remembered with the ticket.
+    private func installEarlyDataKeys(conn: OpaquePointer, ticket: QUICSessionTicket, clientHello: Data) -> Bool {
+        guard let parameters = ticket.transportParams else { return false }
+        let rv = parameters.withUnsafeBytes { buffer -> Int32 in
+            guard let pointer = buffer.baseAddress?.assumingMemoryBound(to: UInt8.self) else {
+                return -1
+            }
+            return ngtcp2_conn_decode_and_set_0rtt_transport_params(conn, pointer, parameters.count)
+        }
+        guard rv == 0 else { return false }
+
+        let kd = TLS13KeyDerivation(cipherSuite: ticket.cipherSuite)
+        let (_, earlyKey) = kd.extract(inputKeyMaterial: ticket.psk, salt: Data())
+        let clientETS = SymmetricKey(data: kd.deriveSecret(secret: earlyKey, label: "c e traffic", messages: clientHello))
+        let txKey = kd.expandLabel(secret: clientETS, label: "quic key", context: Data(), length: kd.keyLength)
+        let txIV = kd.expandLabel(secret: clientETS, label: "quic iv", context: Data(), length: 12)
+        let txHP = kd.expandLabel(secret: clientETS, label: "quic hp", context: Data(), length: kd.keyLength)
+
+        var context = ngtcp2_crypto_ctx()
+        ngtcp2_crypto_ctx_tls(&context, UnsafeMutableRawPointer(bitPattern: UInt(ticket.cipherSuite)))
+        ngtcp2_conn_set_0rtt_crypto_ctx(conn, &context)
+
+        var txAeadCtx = ngtcp2_crypto_aead_ctx()
+        var txHPCtx = ngtcp2_crypto_cipher_ctx()
+        txKey.withUnsafeBytes { buffer in
+            ngtcp2_crypto_aead_ctx_encrypt_init(&txAeadCtx, &context.aead,
+                buffer.baseAddress!.assumingMemoryBound(to: UInt8.self), 12)
+        }
+        txHP.withUnsafeBytes { buffer in
+            ngtcp2_crypto_cipher_ctx_encrypt_init(&txHPCtx, &context.hp,
+                buffer.baseAddress!.assumingMemoryBound(to: UInt8.self))
+        }
+        return txIV.withUnsafeBytes { ivBuf in
+            ngtcp2_conn_install_0rtt_key(conn, &txAeadCtx,
+                ivBuf.baseAddress!.assumingMemoryBound(to: UInt8.self), 12, &txHPCtx)
+        } == 0
+    }
+
     // MARK: - Session Tickets
 
-    private func processNewSessionTicket(_ body: Data) -> QUICTLSResult {
+    private func processNewSessionTicket(_ body: Data, conn: OpaquePointer) -> QUICTLSResult {
         guard body.count >= 11 else { return .success }
 
         var offset = 0
@@ -702,6 +797,34 @@ nonisolated class QUICTLSHandler {
         offset += 2
         guard offset + ticketLen <= body.count else { return .success }
         let ticket = Data(body[offset..<(offset + ticketLen)])
+        offset += ticketLen
+
+        var maxEarlyData: UInt32 = 0
+        if offset + 2 <= body.count {
+            let extensionsEnd = min(offset + 2 + (Int(body[offset]) << 8 | Int(body[offset + 1])), body.count)
+            offset += 2
+            while offset + 4 <= extensionsEnd {
+                let extType = UInt16(body[offset]) << 8 | UInt16(body[offset + 1])
+                let extLen = Int(body[offset + 2]) << 8 | Int(body[offset + 3])
+                offset += 4
+                if extType == TLSExtensionType.earlyData, extLen == 4, offset + 4 <= extensionsEnd {
+                    maxEarlyData = UInt32(body[offset]) << 24 | UInt32(body[offset + 1]) << 16
+                                 | UInt32(body[offset + 2]) << 8  | UInt32(body[offset + 3])
+                }
+                offset += extLen
+            }
+        }
+
+        // Remembered with the ticket so the next connection's 0-RTT data honours
+        // the limits this server granted.
+        var transportParams: Data?
+        if maxEarlyData == 0xFFFF_FFFF {
+            var buffer = [UInt8](repeating: 0, count: 256)
+            let length = ngtcp2_conn_encode_0rtt_transport_params2(conn, &buffer, buffer.count)
+            if length > 0 {
+                transportParams = Data(buffer.prefix(Int(length)))
+            }
+        }
 
         guard let kd = keyDerivation, let rms = resumptionMasterSecret else { return .success }
         let psk = kd.expandLabel(
@@ -714,9 +837,10 @@ nonisolated class QUICTLSHandler {
         let cached = QUICSessionTicket(
             ticket: ticket, nonce: nonce, psk: psk,
             cipherSuite: cipherSuite, issued: CFAbsoluteTimeGetCurrent(),
-            lifetime: lifetime, ticketAgeAdd: ticketAgeAdd
+            lifetime: lifetime, ticketAgeAdd: ticketAgeAdd,
+            maxEarlyData: maxEarlyData, alpn: negotiatedALPN, transportParams: transportParams
         )
-        QUICSessionTicketCache.store(cached, serverName: serverName, alpn: alpn)
+        QUICSessionTicketCache.store(cached, server: server, serverName: serverName, alpn: alpn)
 
         return .success
     }
@@ -6,6 +6,7 @@
 //
 
 import Foundation
+import os
 
 struct QUICTuning {
 
@@ -18,18 +19,25 @@ struct QUICTuning {
         case cubic
         case bbr
         /// Hysteria Brutal CC with an initial target send rate (bytes/sec),
-        /// typically updated post-auth from the server's Hysteria-CC-RX.
+        /// typically updated post-auth from the server's Hysteria-CC-RX. 0 detects
+        /// the rate from the path instead.
         case brutal(initialBps: UInt64)
+        /// CUBIC or BBR, chosen per destination by `QUICCongestionStats` from the
+        /// goodput and loss of earlier connections.
+        case auto
     }
 
     var cc: CongestionControl
 
+    /// The algorithm ngtcp2 is initialized with. `.auto` is resolved per connection by
+    /// `QUICConnection`; CUBIC is only its fallback here.
     var ngtcp2CCAlgo: ngtcp2_cc_algo {
         switch cc {
         case .reno:    return NGTCP2_CC_ALGO_RENO
         case .cubic:   return NGTCP2_CC_ALGO_CUBIC
         case .bbr:     return NGTCP2_CC_ALGO_BBR
         case .brutal:  return NGTCP2_CC_ALGO_CUBIC
+        case .auto:    return NGTCP2_CC_ALGO_CUBIC
         }
     }
 
@@ -40,6 +48,17 @@ struct QUICTuning {
     /// Connection-level auto-tuning upper bound.
     var maxWindow: UInt64
 
+    /// Auto-tuned receive credit is memory the peer may fill while downstream is slow, so
+    /// the connection bound is held to a quarter of what the process may still allocate,
+    /// and a stream to half of that. Never below the advertised initial windows.
+    var memoryBoundedWindows: (stream: UInt64, connection: UInt64) {
+        let budget = UInt64(os_proc_available_memory()) / 4
+        guard budget > 0 else { return (maxStreamWindow, maxWindow) }
+        let connection = max(initialMaxData, min(maxWindow, budget))
+        let stream = max(initialMaxStreamDataBidiLocal, min(maxStreamWindow, connection / 2))
+        return (stream, connection)
+    }
+
     // MARK: Initial transport parameters (what we advertise)
 
     var initialMaxData: UInt64
@@ -87,7 +106,9 @@ extension QUICTuning {
     /// Brutal windows are deliberately small — ~2× the proxied stream's `TCP_SND_BUF` (≈696 KB)
     /// prevents burst-then-stall without capping throughput — and `max == initial` disables
     /// ngtcp2's window auto-tuner. BBR paces from its own estimate, so its windows may auto-scale
-    /// (`max > initial`).
+    /// (`max > initial`); CUBIC and `.auto` share BBR's windows. Their streams start at 512 KB and
+    /// ngtcp2 doubles a window each time it is consumed within 2 RTTs, so only a stream that is
+    /// actually moving bulk data grows toward full BDP.
     static func hysteria(congestionControl: HysteriaCongestionControl, uploadMbps: Int) -> QUICTuning {
         switch congestionControl {
         case .brutal:
@@ -107,14 +128,20 @@ extension QUICTuning {
                 keepAliveTimeout: 10 * 1_000_000_000,
                 disableActiveMigration: false
             )
-        case .bbr:
+        case .bbr, .cubic, .auto:
+            let cc: CongestionControl
+            switch congestionControl {
+            case .cubic: cc = .cubic
+            case .auto:  cc = .auto
+            default:     cc = .bbr
+            }
             return QUICTuning(
-                cc: .bbr,
+                cc: cc,
                 maxStreamWindow: 16 * 1024 * 1024,
                 maxWindow: 32 * 1024 * 1024,
                 initialMaxData: 8 * 1024 * 1024,
-                initialMaxStreamDataBidiLocal: 2 * 1024 * 1024,
-                initialMaxStreamDataBidiRemote: 2 * 1024 * 1024,
+                initialMaxStreamDataBidiLocal: 512 * 1024,
+                initialMaxStreamDataBidiRemote: 512 * 1024,
                 initialMaxStreamDataUni: 2 * 1024 * 1024,
                 initialMaxStreamsBidi: 1024,
                 initialMaxStreamsUni: 16,
@@ -129,8 +156,9 @@ extension QUICTuning {
     /// Nowhere's auth and TCP streams are client-initiated, so `bidiLocal`
     /// controls the server-to-client download window. Receive credit is kept
     /// deliberately small because it can become resident buffered data when the
-    /// Network Extension experiences downstream backpressure. Each stream may
-    /// auto-tune independently while concurrent streams share the larger
+    /// Network Extension experiences downstream backpressure. Each stream starts
+    /// at 512 KB and auto-tunes independently, doubling when its window is
+    /// consumed within 2 RTTs, while concurrent streams share the larger
     /// connection cap. The Portal's unused server-initiated stream credit
     /// remains zero.
     static let nowhere = QUICTuning(
@@ -138,7 +166,7 @@ extension QUICTuning {
         maxStreamWindow: 16 * 1024 * 1024,
         maxWindow: 32 * 1024 * 1024,
         initialMaxData: 8 * 1024 * 1024,
-        initialMaxStreamDataBidiLocal: 4 * 1024 * 1024,
+        initialMaxStreamDataBidiLocal: 512 * 1024,
         initialMaxStreamDataBidiRemote: 0,
         initialMaxStreamDataUni: 0,
         initialMaxStreamsBidi: 0,
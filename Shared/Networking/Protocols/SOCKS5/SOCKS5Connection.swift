@@ -432,12 +432,19 @@ nonisolated class TLSRecordTransport: RawTransport {
 
 /// SOCKS5 UDP ASSOCIATE relay: prepends/strips the SOCKS5 UDP header per datagram.
 /// The TCP control connection is retained because closing it ends the UDP session.
+///
+/// The flow has one destination, so its header is encoded once. A send copies it and the
+/// payload into one buffer sized up front. On receive, a reply that starts with the last
+/// header seen is stripped by a byte comparison; that header begins as the destination's,
+/// and becomes the server's own form (say, the resolved IP for a domain) once one is parsed.
 nonisolated class SOCKS5UDPProxyConnection: ProxyConnection {
     private let tcpTransport: any RawTransport
     private let tlsClient: TLSClient?
     private let tlsConnection: TLSRecordConnection?
     private let relay: ProxyConnection
     private let udpHeader: Data
+    /// Reply header the last datagram carried; receives are serial, so it needs no lock.
+    private var replyHeader: Data
     private var cancelled = false
 
     init(
@@ -459,6 +466,7 @@ nonisolated class SOCKS5UDPProxyConnection: ProxyConnection {
         header.append(UInt8(destinationPort >> 8))
         header.append(UInt8(destinationPort & 0xFF))
         self.udpHeader = header
+        self.replyHeader = header
 
         super.init()
     }
@@ -471,17 +479,13 @@ nonisolated class SOCKS5UDPProxyConnection: ProxyConnection {
             completion(ProxyError.connectionFailed("SOCKS5 UDP not connected"))
             return
         }
-        var packet = udpHeader
-        packet.append(data)
         // `relay.send` so any chain-level framing wraps each datagram.
-        relay.send(data: packet, completion: completion)
+        relay.send(data: encapsulate(data), completion: completion)
     }
 
     override func sendRaw(data: Data) {
         guard !cancelled else { return }
-        var packet = udpHeader
-        packet.append(data)
-        relay.send(data: packet)
+        relay.send(data: encapsulate(data))
     }
 
     override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
@@ -517,7 +521,33 @@ nonisolated class SOCKS5UDPProxyConnection: ProxyConnection {
         tcpTransport.forceCancel()
     }
 
+    /// Header and payload in one allocation.
+    private func encapsulate(_ payload: Data) -> Data {
+        var packet = Data(capacity: udpHeader.count + payload.count)
+        packet.append(udpHeader)
+        packet.append(payload)
+        return packet
+    }
+
     private func stripUDPHeader(_ data: Data) -> Data? {
+        let cached = replyHeader.count
+        if data.count > cached, Self.hasPrefix(data, replyHeader) {
+            return data.subdata(in: (data.startIndex + cached)..<data.endIndex)
+        }
+        guard let headerEnd = Self.parseUDPHeaderLength(data), data.count > headerEnd else { return nil }
+        replyHeader = data.subdata(in: data.startIndex..<(data.startIndex + headerEnd))
+        return data.subdata(in: (data.startIndex + headerEnd)..<data.endIndex)
+    }
+
+    private static func hasPrefix(_ data: Data, _ prefix: Data) -> Bool {
+        data.withUnsafeBytes { bytes in
+            prefix.withUnsafeBytes { memcmp(bytes.baseAddress!, $0.baseAddress!, $0.count) == 0 }
+        }
+    }
+
+    /// Length of the RSV/FRAG/ATYP/address/port header, or nil for a fragment or a
+    /// malformed header.
+    private static func parseUDPHeaderLength(_ data: Data) -> Int? {
         guard data.count >= 4 else { return nil }
         guard data[2] == 0x00 else { return nil } // reject fragments
 
@@ -530,8 +560,6 @@ nonisolated class SOCKS5UDPProxyConnection: ProxyConnection {
             headerEnd = 4 + 1 + Int(data[4]) + 2
         default: return nil
         }
-
-        guard data.count > headerEnd else { return nil }
-        return Data(data[headerEnd...])
+        return headerEnd
     }
 }
@@ -60,7 +60,7 @@ extension ProxyClient {
             self.tunnel = nil
             wrapAndComplete(tunnel)
         } else {
-            let transport = NWUDPTransport()
+            let transport = DialTransports.udp()
             transport.connect(host: directDialHost,
                            port: configuration.serverPort,
                            completionQueue: .global()) { error in
@@ -31,12 +31,10 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
     private let pskHashes: [Data]     // BLAKE3 hash of pskList[1..], first 16 bytes each
 
     private var requestSalt: Data?
-    private var writeNonce: ShadowsocksNonce
-    private var writeSubkey: Data?
+    private var writeCipher: ShadowsocksChunkCipher?
     private var handshakeSent = false
 
-    private var readNonce: ShadowsocksNonce
-    private var readSubkey: Data?
+    private var readCipher: ShadowsocksChunkCipher?
     private var readBuffer = Data()
     private var responseHeaderParsed = false
     private var pendingVarHeaderLen: Int? = nil    // fixed header parsed, variable header not yet buffered
@@ -57,8 +55,6 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
         }
         self.pskHashes = hashes
 
-        self.writeNonce = ShadowsocksNonce(size: cipher.nonceSize)
-        self.readNonce = ShadowsocksNonce(size: cipher.nonceSize)
         super.init()
     }
 
@@ -91,6 +87,14 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
         sendRaw(data: data) { _ in }
     }
 
+    /// The request's padding covers the empty payload, as SIP022 requires.
+    override func flushDeferredHeader() {
+        let pending = lock.withLock { !handshakeSent }
+        if pending {
+            sendRaw(data: Data())
+        }
+    }
+
     override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
         inner.receiveRaw { [weak self] data, error in
             guard let self else {
@@ -133,7 +137,7 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
         self.requestSalt = salt
 
         let sessionKey = ShadowsocksKeyDerivation.deriveSessionKey(psk: psk, salt: salt, keySize: keySize)
-        self.writeSubkey = sessionKey
+        var writeCipher = ShadowsocksChunkCipher(cipher: cipher, subkey: sessionKey)
 
         var output = Data()
         output.append(salt)
@@ -153,11 +157,7 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
         var varLenBE = UInt16(variableHeaderLen).bigEndian
         withUnsafeBytes(of: &varLenBE) { fixedHeader.append(contentsOf: $0) }
 
-        let nonce0 = writeNonce.next()
-        let sealedFixed = try ShadowsocksAEADCrypto.seal(
-            cipher: cipher, key: sessionKey, nonce: nonce0, plaintext: fixedHeader
-        )
-        output.append(sealedFixed)
+        try writeCipher.seal(fixedHeader, appendingTo: &output)
 
         // Variable header: address + paddingLen(2) + padding + payload
         var variableHeader = Data(capacity: variableHeaderLen)
@@ -169,11 +169,8 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
         }
         variableHeader.append(payload)
 
-        let nonce1 = writeNonce.next()
-        let sealedVariable = try ShadowsocksAEADCrypto.seal(
-            cipher: cipher, key: sessionKey, nonce: nonce1, plaintext: variableHeader
-        )
-        output.append(sealedVariable)
+        try writeCipher.seal(variableHeader, appendingTo: &output)
+        self.writeCipher = writeCipher
 
         return output
     }
@@ -192,30 +189,10 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
     }
 
     private func sealChunks(plaintext: Data) throws -> Data {
-        guard let subkey = writeSubkey else { throw ShadowsocksError.decryptionFailed }
-        let maxPayload = ShadowsocksAEADWriter.maxPayloadSize
+        guard var writeCipher else { throw ShadowsocksError.decryptionFailed }
         var output = Data()
-        var offset = 0
-
-        while offset < plaintext.count {
-            let remaining = plaintext.count - offset
-            let chunkSize = min(remaining, maxPayload)
-            let chunk = plaintext[plaintext.startIndex.advanced(by: offset)..<plaintext.startIndex.advanced(by: offset + chunkSize)]
-
-            let lengthBytes = Data([UInt8(chunkSize >> 8), UInt8(chunkSize & 0xFF)])
-            let encLen = try ShadowsocksAEADCrypto.seal(
-                cipher: cipher, key: subkey, nonce: writeNonce.next(), plaintext: lengthBytes
-            )
-            output.append(encLen)
-
-            let encPayload = try ShadowsocksAEADCrypto.seal(
-                cipher: cipher, key: subkey, nonce: writeNonce.next(), plaintext: chunk
-            )
-            output.append(encPayload)
-
-            offset += chunkSize
-        }
-
+        try writeCipher.sealChunks(plaintext, maxPayloadSize: ShadowsocksAEADWriter.maxPayloadSize, appendingTo: &output)
+        self.writeCipher = writeCipher
         return output
     }
 
@@ -258,7 +235,7 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
         let salt = readBuffer.prefix(keySize)
 
         let sessionKey = ShadowsocksKeyDerivation.deriveSessionKey(psk: psk, salt: salt, keySize: keySize)
-        self.readSubkey = sessionKey
+        var readCipher = ShadowsocksChunkCipher(cipher: cipher, subkey: sessionKey)
 
         let fixedChunkLen = fixedHeaderPlainLen + tagSize
         let fixedChunkStart = keySize
@@ -267,9 +244,8 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
         readBuffer.removeFirst(keySize + fixedChunkLen)
         if readBuffer.isEmpty { readBuffer = Data() } else { readBuffer = Data(readBuffer) }
 
-        let fixedHeader = try ShadowsocksAEADCrypto.open(
-            cipher: cipher, key: sessionKey, nonce: readNonce.next(), ciphertext: fixedChunk
-        )
+        let fixedHeader = try readCipher.open(fixedChunk)
+        self.readCipher = readCipher
 
         // Parse fixed header: type(1) + timestamp(8) + requestSalt(keySize) + length(2)
         guard fixedHeader.count == fixedHeaderPlainLen else {
@@ -322,13 +298,11 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
         readBuffer.removeFirst(varChunkLen)
         if readBuffer.isEmpty { readBuffer = Data() } else { readBuffer = Data(readBuffer) }
 
-        guard let subkey = readSubkey else {
+        guard readCipher != nil else {
             throw ShadowsocksError.decryptionFailed
         }
 
-        let varData = try ShadowsocksAEADCrypto.open(
-            cipher: cipher, key: subkey, nonce: readNonce.next(), ciphertext: varChunk
-        )
+        let varData = try readCipher!.open(varChunk)
 
         pendingVarHeaderLen = nil
         responseHeaderParsed = true
@@ -336,7 +310,8 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
     }
 
     private func decryptChunks() throws -> Data {
-        guard let subkey = readSubkey else { return Data() }
+        guard var readCipher else { return Data() }
+        defer { self.readCipher = readCipher }
         var output = Data()
         let base = readBuffer.startIndex
         var offset = 0  // relative to base
@@ -352,13 +327,8 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
                 guard remaining >= lenNeeded else { break }
 
                 let encLen = readBuffer[(base + offset)..<(base + offset + lenNeeded)]
-                let lenData = try ShadowsocksAEADCrypto.open(
-                    cipher: cipher, key: subkey, nonce: readNonce.next(), ciphertext: encLen
-                )
-                guard lenData.count == 2 else { throw ShadowsocksError.decryptionFailed }
+                payloadLen = try readCipher.openLength(encLen)
                 offset += lenNeeded
-
-                payloadLen = Int(UInt16(lenData[lenData.startIndex]) << 8 | UInt16(lenData[lenData.startIndex + 1]))
             }
 
             let payloadNeeded = payloadLen + tagSize
@@ -374,10 +344,12 @@ nonisolated class Shadowsocks2022Connection: ProxyConnection {
             let encPayload = readBuffer[(base + offset)..<(base + offset + payloadNeeded)]
             offset += payloadNeeded
 
-            let payload = try ShadowsocksAEADCrypto.open(
-                cipher: cipher, key: subkey, nonce: readNonce.next(), ciphertext: encPayload
-            )
-            output.append(payload)
+            let payload = try readCipher.open(encPayload)
+            if output.isEmpty {
+                output = payload
+            } else {
+                output.append(payload)
+            }
         }
 
         if offset > 0 {
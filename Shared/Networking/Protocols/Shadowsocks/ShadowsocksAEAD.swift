@@ -13,9 +13,14 @@ import CommonCrypto
 
 enum ShadowsocksKeyDerivation {
 
-    /// Derives a master key from a password via EVP_BytesToKey (MD5).
+    /// Master key from a password via EVP_BytesToKey (MD5), memoized per password and size.
     static func deriveKey(password: String, keySize: Int) -> Data {
         guard keySize > 0 else { return Data() }
+        let cacheKey = ShadowsocksKeyCache.PasswordKey(password: password, keySize: keySize)
+        if let cached = ShadowsocksKeyCache.masterKey(for: cacheKey) {
+            return cached
+        }
+
         let passwordData = Array(password.utf8)
         var result = Data()
         var previous = Data()
@@ -34,20 +39,52 @@ enum ShadowsocksKeyDerivation {
             result.append(previous)
         }
 
-        return Data(result.prefix(keySize))
+        let masterKey = Data(result.prefix(keySize))
+        ShadowsocksKeyCache.storeMasterKey(masterKey, for: cacheKey)
+        return masterKey
     }
 
-    /// Derives a per-salt subkey via HKDF-SHA1 with info "ss-subkey".
+    private static let subkeyInfo = Array("ss-subkey".utf8)
+
+    /// Derives a per-salt subkey via HKDF-SHA1 (RFC 5869) with info "ss-subkey". The salt
+    /// keys the extract step, so nothing carries over between salts; instead the whole
+    /// derivation runs through CommonCrypto's HMAC on stack scratch, with no key objects.
     static func deriveSubkey(masterKey: Data, salt: Data, keySize: Int) -> Data {
-        let symmetricKey = SymmetricKey(data: masterKey)
-        let info = "ss-subkey".data(using: .utf8)!
-        let derivedKey = HKDF<Insecure.SHA1>.deriveKey(
-            inputKeyMaterial: symmetricKey,
-            salt: salt,
-            info: info,
-            outputByteCount: keySize
-        )
-        return derivedKey.withUnsafeBytes { Data($0) }
+        guard keySize > 0 else { return Data() }
+        let hashLength = Int(CC_SHA1_DIGEST_LENGTH)
+        let algorithm = CCHmacAlgorithm(kCCHmacAlgSHA1)
+        var subkey = Data(count: keySize)
+
+        withUnsafeTemporaryAllocation(of: UInt8.self, capacity: 2 * hashLength) { scratch in
+            let prk = scratch.baseAddress!
+            let block = prk + hashLength
+            // Extract: PRK = HMAC(salt, IKM).
+            salt.withUnsafeBytes { saltBytes in
+                masterKey.withUnsafeBytes { keyBytes in
+                    CCHmac(algorithm, saltBytes.baseAddress, saltBytes.count, keyBytes.baseAddress, keyBytes.count, prk)
+                }
+            }
+            // Expand: T(i) = HMAC(PRK, T(i-1) | info | i).
+            subkey.withUnsafeMutableBytes { out in
+                var written = 0
+                var counter: UInt8 = 1
+                while written < keySize {
+                    var context = CCHmacContext()
+                    CCHmacInit(&context, algorithm, prk, hashLength)
+                    if counter > 1 {
+                        CCHmacUpdate(&context, block, hashLength)
+                    }
+                    subkeyInfo.withUnsafeBufferPointer { CCHmacUpdate(&context, $0.baseAddress, $0.count) }
+                    CCHmacUpdate(&context, &counter, 1)
+                    CCHmacFinal(&context, block)
+                    let take = min(hashLength, keySize - written)
+                    memcpy(out.baseAddress! + written, block, take)
+                    written += take
+                    counter += 1
+                }
+            }
+        }
+        return subkey
     }
 
     /// Decodes a base64 PSK for Shadowsocks 2022; must be exactly keySize bytes.
@@ -64,8 +101,14 @@ enum ShadowsocksKeyDerivation {
         return psk
     }
 
-    /// Decodes all colon-separated base64 PSKs; nil if any fails to decode or has the wrong size.
+    /// Decodes all colon-separated base64 PSKs, memoized per password and size; nil if any
+    /// fails to decode or has the wrong size.
     static func decodePSKList(password: String, keySize: Int) -> [Data]? {
+        let cacheKey = ShadowsocksKeyCache.PasswordKey(password: password, keySize: keySize)
+        if let cached = ShadowsocksKeyCache.pskList(for: cacheKey) {
+            return cached
+        }
+
         let parts = password.split(separator: ":")
         var psks: [Data] = []
         for part in parts {
@@ -77,25 +120,30 @@ enum ShadowsocksKeyDerivation {
             }
             psks.append(psk)
         }
-        return psks.isEmpty ? nil : psks
+        guard !psks.isEmpty else { return nil }
+        ShadowsocksKeyCache.storePSKList(psks, for: cacheKey)
+        return psks
     }
 
     static func blake3Hash16(_ data: Data) -> Data {
         BLAKE3Hasher.hash(data, count: 16)
     }
 
+    private static let identityContext = "shadowsocks 2022 identity subkey"
+    private static let sessionContext = "shadowsocks 2022 session subkey"
+
     static func deriveIdentitySubkey(psk: Data, salt: Data, keySize: Int) -> Data {
-        var input = Data(psk)
-        input.append(salt)
-        return BLAKE3Hasher.deriveKey(context: "shadowsocks 2022 identity subkey",
-                                     input: input, count: keySize)
+        var hasher = ShadowsocksKeyCache.derivationState(context: identityContext, psk: psk)
+        hasher.update(salt)
+        return hasher.finalizeData(count: keySize)
     }
 
+    /// BLAKE3 derive_key(context, psk | salt), resumed from a cached state that has already
+    /// absorbed the context and PSK, so a session costs only its salt and finalization.
     static func deriveSessionKey(psk: Data, salt: Data, keySize: Int) -> Data {
-        var input = Data(psk)
-        input.append(salt)
-        return BLAKE3Hasher.deriveKey(context: "shadowsocks 2022 session subkey",
-                                     input: input, count: keySize)
+        var hasher = ShadowsocksKeyCache.derivationState(context: sessionContext, psk: psk)
+        hasher.update(salt)
+        return hasher.finalizeData(count: keySize)
     }
 
     private static func padBase64(_ string: String) -> String {
@@ -105,22 +153,168 @@ enum ShadowsocksKeyDerivation {
     }
 }
 
-// MARK: - Nonce Generator
+// MARK: - Key Cache
+
+/// Per-configuration key material: master keys, decoded PSK lists, and BLAKE3 derivation
+/// states primed with a context and PSK. Small and reset wholesale when full, since a
+/// device only ever holds a handful of Shadowsocks configurations.
+private enum ShadowsocksKeyCache {
+
+    struct PasswordKey: Hashable {
+        let password: String
+        let keySize: Int
+    }
+
+    private struct DerivationKey: Hashable {
+        let context: String
+        let psk: Data
+    }
+
+    private static let lock = UnfairLock()
+    private static let maxEntries = 16
+    private static var masterKeys: [PasswordKey: Data] = [:]
+    private static var pskLists: [PasswordKey: [Data]] = [:]
+    private static var derivationStates: [DerivationKey: BLAKE3Hasher] = [:]
+
+    static func masterKey(for key: PasswordKey) -> Data? {
+        lock.withLock { masterKeys[key] }
+    }
 
-/// Incrementing little-endian AEAD nonce: starts at all 0xFF, so the first returned nonce is all zeros.
-struct ShadowsocksNonce {
-    private var bytes: [UInt8]
+    static func storeMasterKey(_ masterKey: Data, for key: PasswordKey) {
+        lock.withLock {
+            if masterKeys.count >= maxEntries { masterKeys.removeAll() }
+            masterKeys[key] = masterKey
+        }
+    }
 
-    init(size: Int) {
-        bytes = [UInt8](repeating: 0xFF, count: size)
+    static func pskList(for key: PasswordKey) -> [Data]? {
+        lock.withLock { pskLists[key] }
     }
 
-    mutating func next() -> Data {
-        for i in 0..<bytes.count {
-            bytes[i] &+= 1
-            if bytes[i] != 0 { break }
+    static func storePSKList(_ pskList: [Data], for key: PasswordKey) {
+        lock.withLock {
+            if pskLists.count >= maxEntries { pskLists.removeAll() }
+            pskLists[key] = pskList
         }
-        return Data(bytes)
+    }
+
+    /// A copy of the derive_key state after `context` and `psk`; callers add the salt.
+    static func derivationState(context: String, psk: Data) -> BLAKE3Hasher {
+        let key = DerivationKey(context: context, psk: psk)
+        if let cached = lock.withLock({ derivationStates[key] }) {
+            return cached
+        }
+        var hasher = BLAKE3Hasher(deriveKeyContext: context)
+        hasher.update(psk)
+        lock.withLock {
+            if derivationStates.count >= maxEntries { derivationStates.removeAll() }
+            derivationStates[key] = hasher
+        }
+        return hasher
+    }
+}
+
+// MARK: - Chunk Cipher
+
+/// One direction of a Shadowsocks AEAD stream: the subkey resolved once into a
+/// `SymmetricKey`, and the little-endian nonce counter held as integers so each
+/// chunk's nonce is laid out on the stack. The first nonce is all zeros.
+nonisolated struct ShadowsocksChunkCipher {
+
+    private enum Kind {
+        case aesGCM
+        case chaChaPoly
+    }
+
+    private static let tagSize = 16
+
+    private let kind: Kind
+    private let key: SymmetricKey
+    /// Nonce bytes 0..<8 and 8..<12.
+    private var counterLow: UInt64 = 0
+    private var counterHigh: UInt32 = 0
+
+    init(cipher: ShadowsocksCipher, subkey: Data) {
+        switch cipher {
+        case .chacha20poly1305, .blake3chacha20poly1305: kind = .chaChaPoly
+        default: kind = .aesGCM
+        }
+        key = SymmetricKey(data: subkey)
+    }
+
+    @inline(__always)
+    private mutating func nextNonce() -> (UInt64, UInt32) {
+        let nonce = (counterLow.littleEndian, counterHigh.littleEndian)
+        counterLow &+= 1
+        if counterLow == 0 { counterHigh &+= 1 }
+        return nonce
+    }
+
+    /// Appends ciphertext then tag to `output`, copied once out of the sealed box.
+    mutating func seal<Plaintext: DataProtocol>(_ plaintext: Plaintext, appendingTo output: inout Data) throws {
+        let start = HotPathMetrics.now()
+        defer { HotPathMetrics.shared.recordCrypto(.shadowsocks, .seal, bytes: plaintext.count, since: start) }
+        let nonce = nextNonce()
+        switch kind {
+        case .chaChaPoly:
+            let sealedBox = try withUnsafeBytes(of: nonce) { nonce in
+                try ChaChaPoly.seal(plaintext, using: key, nonce: ChaChaPoly.Nonce(data: nonce))
+            }
+            output.append(sealedBox.combined.dropFirst(12))
+        case .aesGCM:
+            let sealedBox = try withUnsafeBytes(of: nonce) { nonce in
+                try AES.GCM.seal(plaintext, using: key, nonce: AES.GCM.Nonce(data: nonce))
+            }
+            guard let combined = sealedBox.combined else { throw ShadowsocksError.decryptionFailed }
+            output.append(combined.dropFirst(12))
+        }
+    }
+
+    /// Seals `plaintext` as a run of `[sealed 2-byte length][sealed payload]` chunks
+    /// straight into `output`, reserved once for the whole run.
+    mutating func sealChunks(_ plaintext: Data, maxPayloadSize: Int, appendingTo output: inout Data) throws {
+        let chunkCount = (plaintext.count + maxPayloadSize - 1) / maxPayloadSize
+        output.reserveCapacity(output.count + plaintext.count + chunkCount * (2 + 2 * Self.tagSize))
+
+        var offset = plaintext.startIndex
+        while offset < plaintext.endIndex {
+            let chunkSize = min(plaintext.endIndex - offset, maxPayloadSize)
+            let length = (UInt8(chunkSize >> 8), UInt8(chunkSize & 0xFF))
+            try withUnsafeBytes(of: length) { try seal($0, appendingTo: &output) }
+            try seal(plaintext[offset..<(offset + chunkSize)], appendingTo: &output)
+            offset += chunkSize
+        }
+    }
+
+    /// Opens ciphertext followed by its tag; `sealed` may be a slice of the receive
+    /// buffer. The sealed box copies it once and its plaintext is returned as is.
+    mutating func open(_ sealed: Data) throws -> Data {
+        guard sealed.count >= Self.tagSize else { throw ShadowsocksError.decryptionFailed }
+        let start = HotPathMetrics.now()
+        defer { HotPathMetrics.shared.recordCrypto(.shadowsocks, .open, bytes: sealed.count - Self.tagSize, since: start) }
+        let nonce = nextNonce()
+        let tagStart = sealed.endIndex - Self.tagSize
+        let ciphertext = sealed[sealed.startIndex..<tagStart]
+        let tag = sealed[tagStart...]
+        switch kind {
+        case .chaChaPoly:
+            let sealedBox = try withUnsafeBytes(of: nonce) { nonce in
+                try ChaChaPoly.SealedBox(nonce: ChaChaPoly.Nonce(data: nonce), ciphertext: ciphertext, tag: tag)
+            }
+            return try ChaChaPoly.open(sealedBox, using: key)
+        case .aesGCM:
+            let sealedBox = try withUnsafeBytes(of: nonce) { nonce in
+                try AES.GCM.SealedBox(nonce: AES.GCM.Nonce(data: nonce), ciphertext: ciphertext, tag: tag)
+            }
+            return try AES.GCM.open(sealedBox, using: key)
+        }
+    }
+
+    /// Opens a sealed 2-byte big-endian chunk length.
+    mutating func openLength(_ sealed: Data) throws -> Int {
+        let length = try open(sealed)
+        guard length.count == 2 else { throw ShadowsocksError.decryptionFailed }
+        return Int(length[length.startIndex]) << 8 | Int(length[length.startIndex + 1])
     }
 }
 
@@ -185,8 +379,7 @@ enum ShadowsocksAEADCrypto {
 /// with the salt prepended to the first output.
 nonisolated class ShadowsocksAEADWriter {
     private let cipher: ShadowsocksCipher
-    private let subkey: Data
-    private var nonce: ShadowsocksNonce
+    private var chunkCipher: ShadowsocksChunkCipher?
     private var salt: Data
     private var saltWritten = false
 
@@ -194,11 +387,9 @@ nonisolated class ShadowsocksAEADWriter {
 
     init(cipher: ShadowsocksCipher, masterKey: Data) {
         self.cipher = cipher
-        self.nonce = ShadowsocksNonce(size: cipher.nonceSize)
 
         guard cipher != .none else {
             self.salt = Data()
-            self.subkey = Data()
             return
         }
 
@@ -206,43 +397,24 @@ nonisolated class ShadowsocksAEADWriter {
         _ = SecRandomCopyBytes(kSecRandomDefault, saltBytes.count, &saltBytes)
         self.salt = Data(saltBytes)
 
-        self.subkey = ShadowsocksKeyDerivation.deriveSubkey(
+        let subkey = ShadowsocksKeyDerivation.deriveSubkey(
             masterKey: masterKey, salt: salt, keySize: cipher.keySize
         )
+        self.chunkCipher = ShadowsocksChunkCipher(cipher: cipher, subkey: subkey)
     }
 
     func seal(plaintext: Data) throws -> Data {
-        guard cipher != .none else {
+        guard var chunkCipher else {
             return plaintext
         }
 
         var output = Data()
-
         if !saltWritten {
             output.append(salt)
             saltWritten = true
         }
-
-        var offset = 0
-        while offset < plaintext.count {
-            let remaining = plaintext.count - offset
-            let chunkSize = min(remaining, Self.maxPayloadSize)
-            let chunk = plaintext[plaintext.startIndex.advanced(by: offset)..<plaintext.startIndex.advanced(by: offset + chunkSize)]
-
-            let lengthBytes = Data([UInt8(chunkSize >> 8), UInt8(chunkSize & 0xFF)])
-            let encryptedLength = try ShadowsocksAEADCrypto.seal(
-                cipher: cipher, key: subkey, nonce: nonce.next(), plaintext: lengthBytes
-            )
-            output.append(encryptedLength)
-
-            let encryptedPayload = try ShadowsocksAEADCrypto.seal(
-                cipher: cipher, key: subkey, nonce: nonce.next(), plaintext: chunk
-            )
-            output.append(encryptedPayload)
-
-            offset += chunkSize
-        }
-
+        try chunkCipher.sealChunks(plaintext, maxPayloadSize: Self.maxPayloadSize, appendingTo: &output)
+        self.chunkCipher = chunkCipher
         return output
     }
 }
@@ -252,9 +424,10 @@ nonisolated class ShadowsocksAEADWriter {
 nonisolated class ShadowsocksAEADReader {
     private let cipher: ShadowsocksCipher
     private let masterKey: Data
-    private var subkey: Data?
-    private var nonce: ShadowsocksNonce
+    private var chunkCipher: ShadowsocksChunkCipher?
     private var state: State = .waitingSalt
+    /// Unconsumed bytes start at `buffer.startIndex + bufferOffset`; `buffer` may be a
+    /// receive slice adopted without a copy.
     private var buffer = Data()
     private var bufferOffset = 0
     private var pendingPayloadLength = 0
@@ -271,10 +444,8 @@ nonisolated class ShadowsocksAEADReader {
     init(cipher: ShadowsocksCipher, masterKey: Data) {
         self.cipher = cipher
         self.masterKey = masterKey
-        self.nonce = ShadowsocksNonce(size: cipher.nonceSize)
 
         if cipher == .none {
-            self.subkey = Data()
             self.state = .readingLength
         }
     }
@@ -282,51 +453,52 @@ nonisolated class ShadowsocksAEADReader {
     func open(ciphertext: Data) throws -> Data {
         guard cipher != .none else { return ciphertext }
 
-        buffer.append(ciphertext)
+        if bufferOffset == buffer.count {
+            buffer = ciphertext
+            bufferOffset = 0
+        } else {
+            buffer.append(ciphertext)
+        }
         var output = Data()
 
         while true {
             let remaining = buffer.count - bufferOffset
+            let start = buffer.startIndex + bufferOffset
             switch state {
             case .waitingSalt:
                 guard remaining >= cipher.saltSize else { break }
-                let salt = buffer[bufferOffset..<(bufferOffset + cipher.saltSize)]
+                let salt = buffer[start..<(start + cipher.saltSize)]
                 bufferOffset += cipher.saltSize
-                self.subkey = ShadowsocksKeyDerivation.deriveSubkey(
+                let subkey = ShadowsocksKeyDerivation.deriveSubkey(
                     masterKey: masterKey, salt: salt, keySize: cipher.keySize
                 )
+                chunkCipher = ShadowsocksChunkCipher(cipher: cipher, subkey: subkey)
                 state = .readingLength
                 continue
 
             case .readingLength:
                 let needed = 2 + cipher.tagSize
                 guard remaining >= needed else { break }
+                guard chunkCipher != nil else { throw ShadowsocksError.decryptionFailed }
 
-                let encryptedLength = buffer[bufferOffset..<(bufferOffset + needed)]
+                pendingPayloadLength = try chunkCipher!.openLength(buffer[start..<(start + needed)])
                 bufferOffset += needed
-
-                guard let subkey else { throw ShadowsocksError.decryptionFailed }
-                let lengthData = try ShadowsocksAEADCrypto.open(
-                    cipher: cipher, key: subkey, nonce: nonce.next(), ciphertext: encryptedLength
-                )
-                guard lengthData.count == 2 else { throw ShadowsocksError.decryptionFailed }
-
-                pendingPayloadLength = Int(UInt16(lengthData[lengthData.startIndex]) << 8 | UInt16(lengthData[lengthData.startIndex + 1]))
                 state = .readingPayload
                 continue
 
             case .readingPayload:
                 let needed = pendingPayloadLength + cipher.tagSize
                 guard remaining >= needed else { break }
+                guard chunkCipher != nil else { throw ShadowsocksError.decryptionFailed }
 
-                let encryptedPayload = buffer[bufferOffset..<(bufferOffset + needed)]
+                let payload = try chunkCipher!.open(buffer[start..<(start + needed)])
                 bufferOffset += needed
-
-                guard let subkey else { throw ShadowsocksError.decryptionFailed }
-                let payload = try ShadowsocksAEADCrypto.open(
-                    cipher: cipher, key: subkey, nonce: nonce.next(), ciphertext: encryptedPayload
-                )
-                output.append(payload)
+                // A lone chunk's plaintext is returned as is; only a batch is concatenated.
+                if output.isEmpty {
+                    output = payload
+                } else {
+                    output.append(payload)
+                }
 
                 state = .readingLength
                 continue
@@ -334,11 +506,11 @@ nonisolated class ShadowsocksAEADReader {
             break
         }
 
-        if bufferOffset > Self.compactThreshold {
-            buffer.removeSubrange(0..<bufferOffset)
+        if bufferOffset == buffer.count {
+            buffer = Data()
             bufferOffset = 0
-        } else if bufferOffset > 0 && bufferOffset == buffer.count {
-            buffer.removeAll(keepingCapacity: true)
+        } else if bufferOffset > Self.compactThreshold {
+            buffer = Data(buffer[(buffer.startIndex + bufferOffset)...])
             bufferOffset = 0
         }
 
@@ -30,14 +30,15 @@ nonisolated class ShadowsocksConnection: ProxyConnection {
 
     override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
         do {
-            var plaintext = Data()
             lock.lock()
-            if let header = addressHeader {
-                plaintext.append(header)
-                addressHeader = nil
-            }
+            let header = addressHeader
+            addressHeader = nil
             lock.unlock()
-            plaintext.append(data)
+            // Only the first write pays for joining the header to the payload.
+            var plaintext = data
+            if let header {
+                plaintext = header + data
+            }
 
             let encrypted = try writer.seal(plaintext: plaintext)
             inner.sendRaw(data: encrypted, completion: completion)
@@ -50,6 +51,13 @@ nonisolated class ShadowsocksConnection: ProxyConnection {
         sendRaw(data: data) { _ in }
     }
 
+    override func flushDeferredHeader() {
+        let pending = lock.withLock { addressHeader != nil }
+        if pending {
+            sendRaw(data: Data())
+        }
+    }
+
     override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
         inner.receiveRaw { [weak self] data, error in
             guard let self else {
@@ -36,7 +36,10 @@ nonisolated final class ShadowsocksUDPSession {
 
     private final class Registration {
         let token: Token
+        let dstHost: String
         let port: UInt16
+        /// SOCKS-style address of (`dstHost`, `port`), encoded once for every datagram.
+        let addressHeader: Data
         /// Reply hosts matching this flow: destination host, owner hints, and hosts learned via port-only fallback.
         var responseHosts: Set<String>
         /// True once a reply source is pinned; port-only fallback prefers unpinned flows.
@@ -44,12 +47,14 @@ nonisolated final class ShadowsocksUDPSession {
         let handler: (Data) -> Void
         let errorHandler: ((Error) -> Void)?
 
-        init(token: Token, port: UInt16, responseHosts: Set<String>,
+        init(token: Token, dstHost: String, port: UInt16, responseHosts: Set<String>,
              hasLearnedSource: Bool,
              handler: @escaping (Data) -> Void,
              errorHandler: ((Error) -> Void)?) {
             self.token = token
+            self.dstHost = dstHost
             self.port = port
+            self.addressHeader = ShadowsocksProtocol.buildAddressHeader(host: dstHost, port: port)
             self.responseHosts = responseHosts
             self.hasLearnedSource = hasLearnedSource
             self.handler = handler
@@ -101,11 +106,21 @@ nonisolated final class ShadowsocksUDPSession {
     private var sessionID: UInt64 = 0
     private var packetIDCounter: UInt64 = 0
     /// Outbound AEAD key for the AES variant, derived once from sessionID + user PSK.
-    private var outboundCipherKey: Data?
+    private var outboundKey: SymmetricKey?
+
+    /// AES-ECB key schedules for the AES variant's 16-byte packet headers, expanded once:
+    /// outbound under `pskList[0]`, inbound under the user PSK, and one per identity header.
+    private var headerEncryptor: SSAESBlockCipher?
+    private var headerDecryptor: SSAESBlockCipher?
+    private var identityEncryptors: [SSAESBlockCipher] = []
+
+    /// Inbound keys by server sessionID, newest first. Keeping the previous session's key
+    /// lets datagrams still in flight across a server rotation open without re-deriving.
+    private var remoteKeys: [(sessionID: UInt64, key: SymmetricKey)] = []
+    private static let remoteKeyCapacity = 2
 
-    /// Last seen server sessionID + derived inbound key; re-derived only when the server rotates.
-    private var remoteSessionID: UInt64 = 0
-    private var remoteCipherKey: Data?
+    /// SS 2022 AEAD plaintext staged for sealing, reused across datagrams.
+    private var bodyScratch = Data()
 
     /// First 16 BLAKE3 bytes of each `pskList[i]` for i >= 1, for multi-PSK identity headers.
     private let pskHashes: [Data]
@@ -130,8 +145,13 @@ nonisolated final class ShadowsocksUDPSession {
             self.sessionID = sid
             var sidBE = sid.bigEndian
             let sidData = Data(bytes: &sidBE, count: 8)
-            self.outboundCipherKey = ShadowsocksKeyDerivation.deriveSessionKey(
-                psk: pskList.last!, salt: sidData, keySize: cipher.keySize)
+            self.outboundKey = SymmetricKey(data: ShadowsocksKeyDerivation.deriveSessionKey(
+                psk: pskList.last!, salt: sidData, keySize: cipher.keySize))
+            self.headerEncryptor = SSAESBlockCipher(key: pskList.first!, operation: kCCEncrypt)
+            self.headerDecryptor = SSAESBlockCipher(key: pskList.last!, operation: kCCDecrypt)
+            self.identityEncryptors = pskList.dropLast().compactMap {
+                SSAESBlockCipher(key: $0, operation: kCCEncrypt)
+            }
 
             var hashes: [Data] = []
             if pskList.count >= 2 {
@@ -180,7 +200,7 @@ nonisolated final class ShadowsocksUDPSession {
         // Pre-supplied hints count as a pinned source; `dstHost` alone does not.
         let pinned = hosts.count > 1
 
-        let registration = Registration(token: token, port: dstPort,
+        let registration = Registration(token: token, dstHost: dstHost, port: dstPort,
                                responseHosts: hosts,
                                hasLearnedSource: pinned,
                                handler: handler,
@@ -237,7 +257,7 @@ nonisolated final class ShadowsocksUDPSession {
                                             payload: payload,
                                             completion: completion))
         case .ready:
-            sendNow(dstHost: dstHost, dstPort: dstPort,
+            sendNow(token: token, dstHost: dstHost, dstPort: dstPort,
                     payload: payload, completion: completion)
         case .failed(let error):
             completion?(error)
@@ -246,6 +266,38 @@ nonisolated final class ShadowsocksUDPSession {
         }
     }
 
+    /// ``send(token:dstHost:dstPort:payload:completion:)`` for a run of datagrams to one
+    /// destination: each is sealed in turn and the run goes to the transport as one batch.
+    /// `completion` fires once, for the run.
+    func send(token: Token,
+              dstHost: String,
+              dstPort: UInt16,
+              payloads: [Data],
+              completion: ((Error?) -> Void)? = nil) {
+        guard !payloads.isEmpty else {
+            completion?(nil)
+            return
+        }
+        guard registrations[token] != nil else {
+            completion?(ShadowsocksError.invalidAddress)
+            return
+        }
+        let sends = payloads.indices.map { index in
+            PendingSend(token: token, dstHost: dstHost, dstPort: dstPort, payload: payloads[index],
+                        completion: index == payloads.count - 1 ? completion : nil)
+        }
+        switch state {
+        case .idle, .connecting:
+            pendingSends.append(contentsOf: sends)
+        case .ready:
+            sendNow(sends)
+        case .failed(let error):
+            completion?(error)
+        case .cancelled:
+            completion?(ProxyError.connectionFailed("Session cancelled"))
+        }
+    }
+
     /// In-flight send completions may still fire after this returns.
     func cancel() {
         if case .cancelled = state { return }
@@ -282,13 +334,10 @@ nonisolated final class ShadowsocksUDPSession {
                 self?.handleTransportError(error)
             })
 
-            // Drain anything queued while connecting, preserving order.
+            // Drain anything queued while connecting, preserving order, as one batch.
             let flushes = self.pendingSends
             self.pendingSends.removeAll()
-            for pendingSend in flushes {
-                self.sendNow(dstHost: pendingSend.dstHost, dstPort: pendingSend.dstPort,
-                             payload: pendingSend.payload, completion: pendingSend.completion)
-            }
+            self.sendNow(flushes)
         }
     }
 
@@ -307,11 +356,11 @@ nonisolated final class ShadowsocksUDPSession {
 
     // MARK: - Send
 
-    private func sendNow(dstHost: String, dstPort: UInt16, payload: Data,
+    private func sendNow(token: Token, dstHost: String, dstPort: UInt16, payload: Data,
                          completion: ((Error?) -> Void)?) {
         do {
             let encrypted = try encryptPacket(payload: payload,
-                                              dstHost: dstHost,
+                                              addressHeader: addressHeader(token: token, dstHost: dstHost, dstPort: dstPort),
                                               dstPort: dstPort)
             transport.send(data: encrypted) { error in
                 completion?(error)
@@ -321,6 +370,41 @@ nonisolated final class ShadowsocksUDPSession {
         }
     }
 
+    /// Seals every send and hands the datagrams to the transport as one batch; a send that
+    /// fails to seal completes with its error and drops out of the batch.
+    private func sendNow(_ sends: [PendingSend]) {
+        guard !sends.isEmpty else { return }
+        var datagrams: [Data] = []
+        datagrams.reserveCapacity(sends.count)
+        var completions: [(Error?) -> Void] = []
+        for send in sends {
+            do {
+                datagrams.append(try encryptPacket(
+                    payload: send.payload,
+                    addressHeader: addressHeader(token: send.token, dstHost: send.dstHost, dstPort: send.dstPort),
+                    dstPort: send.dstPort))
+                if let completion = send.completion { completions.append(completion) }
+            } catch {
+                send.completion?(error)
+            }
+        }
+        guard !datagrams.isEmpty else { return }
+        transport.send(batch: datagrams) { error in
+            for completion in completions {
+                completion(error)
+            }
+        }
+    }
+
+    /// The registration's pre-encoded address when the send targets its own destination.
+    private func addressHeader(token: Token, dstHost: String, dstPort: UInt16) -> Data {
+        if let registration = registrations[token],
+           registration.port == dstPort, registration.dstHost == dstHost {
+            return registration.addressHeader
+        }
+        return ShadowsocksProtocol.buildAddressHeader(host: dstHost, port: dstPort)
+    }
+
     // MARK: - Receive & Route
 
     private func handleReceivedDatagram(_ data: Data) {
@@ -382,83 +466,90 @@ nonisolated final class ShadowsocksUDPSession {
         return packetIDCounter
     }
 
-    private func encryptPacket(payload: Data, dstHost: String, dstPort: UInt16) throws -> Data {
+    private func encryptPacket(payload: Data, addressHeader: Data, dstPort: UInt16) throws -> Data {
         switch mode {
         case .legacy(let cipher, let masterKey):
-            let packet = ShadowsocksProtocol.encodeUDPPacket(host: dstHost, port: dstPort, payload: payload)
+            var packet = Data(capacity: addressHeader.count + payload.count)
+            packet.append(addressHeader)
+            packet.append(payload)
             return try ShadowsocksUDPCrypto.encrypt(cipher: cipher, masterKey: masterKey, payload: packet)
 
-        case .ss2022AES(let cipher, let pskList):
-            return try encryptSS2022AES(payload: payload, dstHost: dstHost, dstPort: dstPort,
-                                        cipher: cipher, pskList: pskList)
+        case .ss2022AES:
+            return try encryptSS2022AES(payload: payload, addressHeader: addressHeader, dstPort: dstPort)
 
         case .ss2022ChaCha(let psk):
-            return try encryptSS2022ChaCha(payload: payload, dstHost: dstHost,
+            return try encryptSS2022ChaCha(payload: payload, addressHeader: addressHeader,
                                            dstPort: dstPort, psk: psk)
         }
     }
 
-    private func encryptSS2022AES(payload: Data,
-                                  dstHost: String,
-                                  dstPort: UInt16,
-                                  cipher: ShadowsocksCipher,
-                                  pskList: [Data]) throws -> Data {
-        guard let sessionKey = outboundCipherKey else { throw ShadowsocksError.decryptionFailed }
-
-        // 16-byte packet header: sessionID(8) + packetID(8), both big-endian.
-        var header = Data(capacity: 16)
-        var sidBE = sessionID.bigEndian
-        withUnsafeBytes(of: &sidBE) { header.append(contentsOf: $0) }
-        var pidBE = nextPacketID().bigEndian
-        withUnsafeBytes(of: &pidBE) { header.append(contentsOf: $0) }
-
-        // Multi-PSK identity headers (skipped when only one PSK is configured).
-        var identityData = Data()
-        if pskList.count >= 2 {
-            for i in 0..<(pskList.count - 1) {
-                let hash = pskHashes[i]
-                var xored = Data(count: 16)
-                for j in 0..<16 { xored[j] = hash[j] ^ header[j] }
-                let encrypted = try ssAESECBEncryptBlock(key: pskList[i], block: xored)
-                identityData.append(encrypted)
-            }
-        }
-
-        // AEAD body: type(0) + ts(8) + paddingLen(2) + padding + addr + payload.
-        let addressHeader = ShadowsocksProtocol.buildAddressHeader(host: dstHost, port: dstPort)
+    /// Stages `type(0) + ts(8) + paddingLen(2) + padding + addr + payload` after whatever
+    /// `bodyScratch` already holds.
+    private func appendClientBody(payload: Data, addressHeader: Data, dstPort: UInt16) {
         let paddingLen = (dstPort == 53 && payload.count < 900)
             ? Int.random(in: 1...(900 - payload.count))
             : 0
 
-        var body = Data()
-        body.append(0) // HeaderTypeClient
+        bodyScratch.append(0) // HeaderTypeClient
         var timestamp = UInt64(Date().timeIntervalSince1970).bigEndian
-        withUnsafeBytes(of: &timestamp) { body.append(contentsOf: $0) }
+        withUnsafeBytes(of: &timestamp) { bodyScratch.append(contentsOf: $0) }
         var paddingLenBE = UInt16(paddingLen).bigEndian
-        withUnsafeBytes(of: &paddingLenBE) { body.append(contentsOf: $0) }
+        withUnsafeBytes(of: &paddingLenBE) { bodyScratch.append(contentsOf: $0) }
         if paddingLen > 0 {
-            body.append(Data(repeating: 0, count: paddingLen))
+            bodyScratch.append(Data(repeating: 0, count: paddingLen))
         }
-        body.append(addressHeader)
-        body.append(payload)
+        bodyScratch.append(addressHeader)
+        bodyScratch.append(payload)
+    }
 
-        // AEAD nonce = last 12 bytes of the 16-byte header.
-        let nonce = Data(header[4..<16])
-        let sealedBody = try ShadowsocksAEADCrypto.seal(
-            cipher: cipher, key: sessionKey, nonce: nonce, plaintext: body)
+    /// Lays the datagram out in one buffer: the encrypted packet header, any identity
+    /// headers, then the sealed body's ciphertext and tag.
+    private func encryptSS2022AES(payload: Data, addressHeader: Data, dstPort: UInt16) throws -> Data {
+        guard let sessionKey = outboundKey, let headerEncryptor else { throw ShadowsocksError.decryptionFailed }
+
+        // 16-byte packet header: sessionID(8) + packetID(8), both big-endian.
+        var header = (sessionID.bigEndian, nextPacketID().bigEndian)
 
-        // Header is AES-ECB encrypted with pskList[0]: the iPSK, or the user PSK when single.
-        let encryptedHeader = try ssAESECBEncryptBlock(key: pskList.first!, block: header)
+        bodyScratch.removeAll(keepingCapacity: true)
+        appendClientBody(payload: payload, addressHeader: addressHeader, dstPort: dstPort)
 
-        var packet = Data(capacity: encryptedHeader.count + identityData.count + sealedBody.count)
-        packet.append(encryptedHeader)
-        packet.append(identityData)
-        packet.append(sealedBody)
+        // AEAD nonce = last 12 bytes of the 16-byte header.
+        let sealed = try withUnsafeBytes(of: &header) { header in
+            try AES.GCM.seal(bodyScratch, using: sessionKey,
+                             nonce: AES.GCM.Nonce(data: UnsafeRawBufferPointer(rebasing: header[4..<16])))
+        }
+
+        var packet = Data(capacity: 16 * (1 + identityEncryptors.count) + sealed.ciphertext.count + sealed.tag.count)
+        var block = (UInt64(0), UInt64(0))
+        try withUnsafeBytes(of: &header) { header in
+            try withUnsafeMutableBytes(of: &block) { block in
+                // Header is AES-ECB encrypted with pskList[0]: the iPSK, or the user PSK when single.
+                try headerEncryptor.process(header.baseAddress!, into: block.baseAddress!)
+                packet.append(contentsOf: UnsafeRawBufferPointer(block))
+
+                // Multi-PSK identity headers: BLAKE3(next PSK)[0..<16] XOR the plain header,
+                // encrypted with each iPSK (none when only one PSK is configured).
+                var xored = (UInt64(0), UInt64(0))
+                for (index, encryptor) in identityEncryptors.enumerated() {
+                    withUnsafeMutableBytes(of: &xored) { xored in
+                        pskHashes[index].withUnsafeBytes { hash in
+                            for j in 0..<16 { xored[j] = hash[j] ^ header[j] }
+                        }
+                    }
+                    try withUnsafeBytes(of: &xored) { xored in
+                        try encryptor.process(xored.baseAddress!, into: block.baseAddress!)
+                    }
+                    packet.append(contentsOf: UnsafeRawBufferPointer(block))
+                }
+            }
+        }
+        packet.append(sealed.ciphertext)
+        packet.append(sealed.tag)
         return packet
     }
 
     private func encryptSS2022ChaCha(payload: Data,
-                                     dstHost: String,
+                                     addressHeader: Data,
                                      dstPort: UInt16,
                                      psk: Data) throws -> Data {
         // 24-byte random nonce prepended as cleartext.
@@ -466,28 +557,14 @@ nonisolated final class ShadowsocksUDPSession {
         _ = SecRandomCopyBytes(kSecRandomDefault, 24, &nonceBytes)
         let nonce = Data(nonceBytes)
 
-        let addressHeader = ShadowsocksProtocol.buildAddressHeader(host: dstHost, port: dstPort)
-        let paddingLen = (dstPort == 53 && payload.count < 900)
-            ? Int.random(in: 1...(900 - payload.count))
-            : 0
-
-        var body = Data()
+        bodyScratch.removeAll(keepingCapacity: true)
         var sidBE = sessionID.bigEndian
-        withUnsafeBytes(of: &sidBE) { body.append(contentsOf: $0) }
+        withUnsafeBytes(of: &sidBE) { bodyScratch.append(contentsOf: $0) }
         var pidBE = nextPacketID().bigEndian
-        withUnsafeBytes(of: &pidBE) { body.append(contentsOf: $0) }
-        body.append(0) // HeaderTypeClient
-        var timestamp = UInt64(Date().timeIntervalSince1970).bigEndian
-        withUnsafeBytes(of: &timestamp) { body.append(contentsOf: $0) }
-        var paddingLenBE = UInt16(paddingLen).bigEndian
-        withUnsafeBytes(of: &paddingLenBE) { body.append(contentsOf: $0) }
-        if paddingLen > 0 {
-            body.append(Data(repeating: 0, count: paddingLen))
-        }
-        body.append(addressHeader)
-        body.append(payload)
+        withUnsafeBytes(of: &pidBE) { bodyScratch.append(contentsOf: $0) }
+        appendClientBody(payload: payload, addressHeader: addressHeader, dstPort: dstPort)
 
-        let sealed = try XChaCha20Poly1305.seal(key: psk, nonce: nonce, plaintext: body)
+        let sealed = try XChaCha20Poly1305.seal(key: psk, nonce: nonce, plaintext: bodyScratch)
 
         var packet = Data(capacity: nonce.count + sealed.count)
         packet.append(nonce)
@@ -495,6 +572,7 @@ nonisolated final class ShadowsocksUDPSession {
         return packet
     }
 
+    /// `data` is opened in place: the AEAD reads its ciphertext and tag as slices.
     private func decryptPacket(_ data: Data) throws -> (host: String, port: UInt16, payload: Data) {
         switch mode {
         case .legacy(let cipher, let masterKey):
@@ -505,48 +583,55 @@ nonisolated final class ShadowsocksUDPSession {
             return parsed
 
         case .ss2022AES(let cipher, let pskList):
-            guard data.count >= 16 + 16 else { throw ShadowsocksError.decryptionFailed }
+            guard data.count >= 16 + 16, let headerDecryptor else { throw ShadowsocksError.decryptionFailed }
 
             // Header AES-ECB decrypt uses the user PSK (pskList.last).
-            let header = try ssAESECBDecryptBlock(key: pskList.last!, block: Data(data.prefix(16)))
-
-            var sidBE: UInt64 = 0
-            _ = withUnsafeMutableBytes(of: &sidBE) { pointer in
-                header[0..<8].copyBytes(to: pointer)
+            var header = (UInt64(0), UInt64(0))
+            try withUnsafeMutableBytes(of: &header) { header in
+                try data.withUnsafeBytes { try headerDecryptor.process($0.baseAddress!, into: header.baseAddress!) }
             }
-            let serverSession = UInt64(bigEndian: sidBE)
+            let serverSession = UInt64(bigEndian: header.0)
 
-            let cipherKey: Data
-            if serverSession == remoteSessionID, let cached = remoteCipherKey {
+            let cached = remoteKeys.first { $0.sessionID == serverSession }?.key
+            let cipherKey: SymmetricKey
+            if let cached {
                 cipherKey = cached
             } else {
                 var rsBE = serverSession.bigEndian
                 let rsData = Data(bytes: &rsBE, count: 8)
-                cipherKey = ShadowsocksKeyDerivation.deriveSessionKey(
-                    psk: pskList.last!, salt: rsData, keySize: cipher.keySize)
-                remoteSessionID = serverSession
-                remoteCipherKey = cipherKey
+                cipherKey = SymmetricKey(data: ShadowsocksKeyDerivation.deriveSessionKey(
+                    psk: pskList.last!, salt: rsData, keySize: cipher.keySize))
             }
 
-            let nonce = Data(header[4..<16])
-            let sealedBody = Data(data.suffix(from: data.startIndex + 16))
-            let body = try ShadowsocksAEADCrypto.open(
-                cipher: cipher, key: cipherKey, nonce: nonce, ciphertext: sealedBody)
+            let tagStart = data.endIndex - 16
+            let sealedBox = try withUnsafeBytes(of: &header) { header in
+                try AES.GCM.SealedBox(
+                    nonce: AES.GCM.Nonce(data: UnsafeRawBufferPointer(rebasing: header[4..<16])),
+                    ciphertext: data[(data.startIndex + 16)..<tagStart],
+                    tag: data[tagStart...])
+            }
+            let body = try AES.GCM.open(sealedBox, using: cipherKey)
 
+            // Only a session whose first datagram authenticated earns a cache slot.
+            if cached == nil {
+                remoteKeys.insert((serverSession, cipherKey), at: 0)
+                if remoteKeys.count > Self.remoteKeyCapacity {
+                    remoteKeys.removeLast()
+                }
+            }
             return try parseServerUDPBody(body)
 
         case .ss2022ChaCha(let psk):
             guard data.count >= 24 + 16 else { throw ShadowsocksError.decryptionFailed }
 
-            let nonce = Data(data.prefix(24))
-            let ciphertext = Data(data.suffix(from: data.startIndex + 24))
+            let nonce = data.prefix(24)
+            let ciphertext = data[(data.startIndex + 24)...]
             let body = try XChaCha20Poly1305.open(key: psk, nonce: nonce, ciphertext: ciphertext)
 
             // Body: sessionID(8) + packetID(8) + standard server body. No sliding-window
             // validation — the AEAD tag + timestamp already gate acceptance.
             guard body.count >= 16 else { throw ShadowsocksError.decryptionFailed }
-            let innerBody = Data(body.suffix(from: body.startIndex + 16))
-            return try parseServerUDPBody(innerBody)
+            return try parseServerUDPBody(body[(body.startIndex + 16)...])
         }
     }
 
@@ -586,9 +671,10 @@ nonisolated final class ShadowsocksUDPSession {
         guard body.endIndex - offset >= 2 else { throw ShadowsocksError.decryptionFailed }
         let paddingLen = Int(UInt16(body[offset]) << 8 | UInt16(body[offset + 1]))
         offset += 2
+        guard body.endIndex - offset >= paddingLen else { throw ShadowsocksError.decryptionFailed }
         offset += paddingLen
 
-        guard let parsed = ShadowsocksProtocol.decodeUDPPacket(data: Data(body[offset...])) else {
+        guard let parsed = ShadowsocksProtocol.decodeUDPPacket(data: body[offset...]) else {
             throw ShadowsocksError.invalidAddress
         }
         return parsed
@@ -609,46 +695,35 @@ nonisolated final class ShadowsocksUDPSession {
 
 // MARK: - AES-ECB Single Block
 
-private func ssAESECBEncryptBlock(key: Data, block: Data) throws -> Data {
-    guard block.count == 16 else { throw ShadowsocksError.decryptionFailed }
-    var outBytes = [UInt8](repeating: 0, count: 16 + kCCBlockSizeAES128)
-    var outLen: Int = 0
-    let status = key.withUnsafeBytes { keyPtr in
-        block.withUnsafeBytes { blockPtr in
-            CCCrypt(
-                CCOperation(kCCEncrypt),
+/// One AES-ECB key schedule, expanded once and reused for every 16-byte block where a
+/// one-shot `CCCrypt` would expand it per call.
+nonisolated private final class SSAESBlockCipher {
+    private let cryptor: CCCryptorRef
+
+    init?(key: Data, operation: Int) {
+        var cryptor: CCCryptorRef?
+        let status = key.withUnsafeBytes { keyPtr in
+            CCCryptorCreate(
+                CCOperation(operation),
                 CCAlgorithm(kCCAlgorithmAES),
                 CCOptions(kCCOptionECBMode),
                 keyPtr.baseAddress!, key.count,
                 nil,
-                blockPtr.baseAddress!, 16,
-                &outBytes, outBytes.count,
-                &outLen
+                &cryptor
             )
         }
+        guard status == kCCSuccess, let cryptor else { return nil }
+        self.cryptor = cryptor
     }
-    guard status == kCCSuccess else { throw ShadowsocksError.decryptionFailed }
-    return Data(outBytes.prefix(16))
-}
 
-private func ssAESECBDecryptBlock(key: Data, block: Data) throws -> Data {
-    guard block.count == 16 else { throw ShadowsocksError.decryptionFailed }
-    var outBytes = [UInt8](repeating: 0, count: 16 + kCCBlockSizeAES128)
-    var outLen: Int = 0
-    let status = key.withUnsafeBytes { keyPtr in
-        block.withUnsafeBytes { blockPtr in
-            CCCrypt(
-                CCOperation(kCCDecrypt),
-                CCAlgorithm(kCCAlgorithmAES),
-                CCOptions(kCCOptionECBMode),
-                keyPtr.baseAddress!, key.count,
-                nil,
-                blockPtr.baseAddress!, 16,
-                &outBytes, outBytes.count,
-                &outLen
-            )
-        }
+    deinit {
+        CCCryptorRelease(cryptor)
+    }
+
+    /// Transforms the 16 bytes at `block` into `out`; ECB carries no state between blocks.
+    func process(_ block: UnsafeRawPointer, into out: UnsafeMutableRawPointer) throws {
+        var moved = 0
+        let status = CCCryptorUpdate(cryptor, block, 16, out, 16, &moved)
+        guard status == kCCSuccess, moved == 16 else { throw ShadowsocksError.decryptionFailed }
     }
-    guard status == kCCSuccess else { throw ShadowsocksError.decryptionFailed }
-    return Data(outBytes.prefix(16))
 }
@@ -26,59 +26,98 @@ extension ProxyClient {
             directDialHost: directDialHost
         )
 
-        DispatchQueue.global(qos: .userInitiated).async {
-            do {
-                let client = try SudokuNativeClient(configuration: self.configuration, factory: factory)
-                let connection: ProxyConnection
-                switch command {
-                case .tcp:
-                    if client.shouldUseNativeMux {
-                        if self.tunnel == nil {
-                            let lease = try SudokuSharedMuxPool.dialTCP(
-                                configuration: self.configuration,
-                                directDialHost: self.directDialHost,
-                                host: destinationHost,
-                                port: destinationPort
-                            )
+        let client: SudokuNativeClient
+        do {
+            client = try SudokuNativeClient(configuration: configuration, factory: factory)
+        } catch {
+            factory.closeAll()
+            completion(.failure(error))
+            return
+        }
+        let fail: (Error) -> Void = { error in
+            factory.closeAll()
+            completion(.failure(error))
+        }
+
+        switch command {
+        case .tcp where client.shouldUseNativeMux:
+            if tunnel == nil {
+                SudokuSharedMuxPool.dialTCP(
+                    configuration: configuration,
+                    directDialHost: directDialHost,
+                    host: destinationHost,
+                    port: destinationPort
+                ) { result in
+                    switch result {
+                    case .failure(let error):
+                        fail(error)
+                    case .success(let lease):
+                        do {
+                            try ProxyClient.sendSudokuInitialData(initialData, to: lease.stream)
+                            completion(.success(SudokuMuxTCPProxyConnection(
+                                client: lease.client,
+                                stream: lease.stream,
+                                closesClientOnClose: false,
+                                onClose: lease.release
+                            )))
+                        } catch {
+                            lease.stream.close()
+                            lease.release()
+                            fail(error)
+                        }
+                    }
+                }
+            } else {
+                client.openMux { result in
+                    switch result {
+                    case .failure(let error):
+                        fail(error)
+                    case .success(let multiplexer):
+                        // Mux dials and sends still block on the record stream, so they
+                        // leave the connection queue this completion runs on.
+                        DispatchQueue.global(qos: .userInitiated).async {
                             do {
-                                try ProxyClient.sendSudokuInitialData(initialData, to: lease.stream)
-                                connection = SudokuMuxTCPProxyConnection(
-                                    client: lease.client,
-                                    stream: lease.stream,
-                                    closesClientOnClose: false,
-                                    onClose: lease.release
-                                )
+                                let stream = try multiplexer.dialTCP(host: destinationHost, port: destinationPort)
+                                try ProxyClient.sendSudokuInitialData(initialData, to: stream)
+                                completion(.success(SudokuMuxTCPProxyConnection(client: multiplexer, stream: stream)))
                             } catch {
-                                lease.stream.close()
-                                lease.release()
-                                throw error
+                                fail(error)
                             }
-                        } else {
-                            let multiplexer = try client.openMux()
-                            let stream = try multiplexer.dialTCP(host: destinationHost, port: destinationPort)
-                            try ProxyClient.sendSudokuInitialData(initialData, to: stream)
-                            connection = SudokuMuxTCPProxyConnection(client: multiplexer, stream: stream)
                         }
-                    } else {
-                        let stream = try client.openTCP(host: destinationHost, port: destinationPort)
-                        try stream.sendInitialDataIfNeeded(initialData)
-                        connection = SudokuTCPProxyConnection(stream: stream)
                     }
-                case .udp:
-                    let stream = try client.openUoT()
-                    connection = SudokuUDPProxyConnection(
+                }
+            }
+        case .tcp:
+            client.openTCP(host: destinationHost, port: destinationPort) { result in
+                switch result {
+                case .failure(let error):
+                    fail(error)
+                case .success(let stream):
+                    let connection = SudokuTCPProxyConnection(stream: stream)
+                    guard let initialData, !initialData.isEmpty else {
+                        completion(.success(connection))
+                        return
+                    }
+                    stream.sendAsync(initialData) { error in
+                        if let error { fail(error) } else { completion(.success(connection)) }
+                    }
+                }
+            }
+        case .udp:
+            client.openUoT { result in
+                switch result {
+                case .failure(let error):
+                    fail(error)
+                case .success(let stream):
+                    completion(.success(SudokuUDPProxyConnection(
                         stream: stream,
                         destinationHost: destinationHost,
                         destinationPort: destinationPort
-                    )
-                case .mux:
-                    throw ProxyError.protocolError("Sudoku does not use the host mux manager")
+                    )))
                 }
-                completion(.success(connection))
-            } catch {
-                factory.closeAll()
-                completion(.failure(error))
             }
+        case .mux:
+            fail(ProxyError.protocolError("Sudoku does not use the host mux manager"))
         }
     }
 
@@ -88,13 +127,6 @@ extension ProxyClient {
     }
 }
 
-private extension SudokuRecordStream {
-    func sendInitialDataIfNeeded(_ data: Data?) throws {
-        guard let data, !data.isEmpty else { return }
-        try send(data)
-    }
-}
-
 private struct SudokuSharedMuxKey: Hashable {
     let serverAddress: String
     let serverPort: UInt16
@@ -121,12 +153,14 @@ private enum SudokuSharedMuxPool {
     private static var clients: [SudokuSharedMuxKey: SudokuSharedMuxClient] = [:]
     private static var accessOrder: [SudokuSharedMuxKey] = []
 
+    /// Completes on a global queue, where the lease's first mux send may block.
     static func dialTCP(
         configuration: ProxyConfiguration,
         directDialHost: String,
         host: String,
-        port: UInt16
-    ) throws -> SudokuSharedMuxLease {
+        port: UInt16,
+        completion: @escaping (Result<SudokuSharedMuxLease, Error>) -> Void
+    ) {
         let key = SudokuSharedMuxKey(configuration: configuration, directDialHost: directDialHost)
         let (shared, evicted) = lock.withLock { () -> (SudokuSharedMuxClient, [SudokuSharedMuxClient]) in
             let shared: SudokuSharedMuxClient
@@ -141,19 +175,21 @@ private enum SudokuSharedMuxPool {
         }
         for client in evicted { client.close() }
         shared.retainStream()
-        do {
-            let (client, stream) = try shared.dialTCP(host: host, port: port)
-            touch(key)
-            return SudokuSharedMuxLease(client: client, stream: stream) {
+        shared.dialTCP(host: host, port: port) { result in
+            switch result {
+            case .success(let (client, stream)):
+                touch(key)
+                completion(.success(SudokuSharedMuxLease(client: client, stream: stream) {
+                    shared.releaseStream()
+                    trimIfNeeded()
+                }))
+            case .failure(let error):
                 shared.releaseStream()
-                trimIfNeeded()
-            }
-        } catch {
-            shared.releaseStream()
-            if shared.isClosed {
-                remove(key: key, closing: false)
+                if shared.isClosed {
+                    remove(key: key, closing: false)
+                }
+                completion(.failure(error))
             }
-            throw error
         }
     }
 
@@ -221,9 +257,10 @@ enum SudokuTransportPool {
 private final class SudokuSharedMuxClient {
     private let configuration: ProxyConfiguration
     private let directDialHost: String
-    private let condition = NSCondition()
+    private let lock = UnfairLock()
     private var client: SudokuMuxClient?
-    private var creating = false
+    /// Callers waiting for the mux being opened; nil unless one is.
+    private var waiters: [(Result<SudokuMuxClient, Error>) -> Void]?
     private var activeStreams = 0
 
     init(configuration: ProxyConfiguration, directDialHost: String) {
@@ -232,102 +269,106 @@ private final class SudokuSharedMuxClient {
     }
 
     var canEvict: Bool {
-        condition.lock()
-        defer { condition.unlock() }
-        return activeStreams == 0
+        lock.withLock { activeStreams == 0 }
     }
 
     var isClosed: Bool {
-        condition.lock()
-        defer { condition.unlock() }
-        return client?.isClosed ?? true
+        lock.withLock { client?.isClosed ?? true }
     }
 
     func retainStream() {
-        condition.lock()
-        activeStreams += 1
-        condition.unlock()
+        lock.withLock { activeStreams += 1 }
     }
 
     func releaseStream() {
-        condition.lock()
-        activeStreams = max(0, activeStreams - 1)
-        condition.broadcast()
-        condition.unlock()
+        lock.withLock { activeStreams = max(0, activeStreams - 1) }
     }
 
-    func dialTCP(host: String, port: UInt16) throws -> (SudokuMuxClient, SudokuMuxStream) {
-        let multiplexer = try getOrCreateMux()
-        do {
-            return (multiplexer, try multiplexer.dialTCP(host: host, port: port))
-        } catch {
-            reset(multiplexer)
-            let retry = try getOrCreateMux()
-            return (retry, try retry.dialTCP(host: host, port: port))
+    /// Dials over the shared mux, reopening it once if the dial fails. Completes on a
+    /// global queue, since mux dials still block on the record stream.
+    func dialTCP(host: String, port: UInt16, completion: @escaping (Result<(SudokuMuxClient, SudokuMuxStream), Error>) -> Void) {
+        func dial(retrying: Bool) {
+            muxClient { result in
+                let multiplexer: SudokuMuxClient
+                switch result {
+                case .failure(let error): completion(.failure(error)); return
+                case .success(let opened): multiplexer = opened
+                }
+                DispatchQueue.global(qos: .userInitiated).async {
+                    let stream: SudokuMuxStream
+                    do {
+                        stream = try multiplexer.dialTCP(host: host, port: port)
+                    } catch {
+                        guard retrying else { completion(.failure(error)); return }
+                        self.reset(multiplexer)
+                        dial(retrying: false)
+                        return
+                    }
+                    completion(.success((multiplexer, stream)))
+                }
+            }
         }
+        dial(retrying: true)
     }
 
     func close() {
-        condition.lock()
-        let old = client
-        client = nil
-        creating = false
-        condition.broadcast()
-        condition.unlock()
+        let old = lock.withLock { () -> SudokuMuxClient? in
+            defer { client = nil }
+            return client
+        }
         old?.close()
     }
 
-    private func getOrCreateMux() throws -> SudokuMuxClient {
-        condition.lock()
-        while true {
-            if let existing = client, !existing.isClosed {
-                condition.unlock()
-                return existing
-            }
-            if let stale = client {
-                client = nil
-                condition.unlock()
-                stale.close()
-                condition.lock()
-                continue
-            }
-            if !creating {
-                creating = true
-                break
+    /// The live mux, opening one if needed; concurrent callers share a single open.
+    private func muxClient(completion: @escaping (Result<SudokuMuxClient, Error>) -> Void) {
+        let (ready, stale, opens) = lock.withLock { () -> (SudokuMuxClient?, SudokuMuxClient?, Bool) in
+            if let existing = client, !existing.isClosed { return (existing, nil, false) }
+            let stale = client
+            client = nil
+            if waiters != nil {
+                waiters?.append(completion)
+                return (nil, stale, false)
             }
-            condition.wait()
+            waiters = [completion]
+            return (nil, stale, true)
         }
-        condition.unlock()
+        stale?.close()
+        if let ready { completion(.success(ready)); return }
+        guard opens else { return }
 
+        let factory = SudokuConnectionFactory(
+            configuration: configuration,
+            initialTunnel: nil,
+            directDialHost: directDialHost
+        )
+        let native: SudokuNativeClient
         do {
-            let factory = SudokuConnectionFactory(
-                configuration: configuration,
-                initialTunnel: nil,
-                directDialHost: directDialHost
-            )
-            let native = try SudokuNativeClient(configuration: configuration, factory: factory)
-            let created = try native.openMux()
-            condition.lock()
-            client = created
-            creating = false
-            condition.broadcast()
-            condition.unlock()
-            return created
+            native = try SudokuNativeClient(configuration: configuration, factory: factory)
         } catch {
-            condition.lock()
-            creating = false
-            condition.broadcast()
-            condition.unlock()
-            throw error
+            finishOpening(.failure(error))
+            return
+        }
+        native.openMux { result in
+            if case .failure = result { factory.closeAll() }
+            self.finishOpening(result)
         }
     }
 
+    private func finishOpening(_ result: Result<SudokuMuxClient, Error>) {
+        let waiting = lock.withLock { () -> [(Result<SudokuMuxClient, Error>) -> Void] in
+            if case .success(let created) = result { client = created }
+            defer { waiters = nil }
+            return waiters ?? []
+        }
+        for waiter in waiting { waiter(result) }
+    }
+
     private func reset(_ mux: SudokuMuxClient) {
-        condition.lock()
-        if client === mux {
-            client = nil
+        lock.withLock {
+            if client === mux {
+                client = nil
+            }
         }
-        condition.unlock()
         mux.close()
     }
 }
@@ -77,13 +77,16 @@ struct SudokuXorshift64Star {
     }
 }
 
-private let sudokuPermutations: [[Int]] = [
-    [0, 1, 2, 3], [0, 1, 3, 2], [0, 2, 1, 3], [0, 2, 3, 1],
-    [0, 3, 1, 2], [0, 3, 2, 1], [1, 0, 2, 3], [1, 0, 3, 2],
-    [1, 2, 0, 3], [1, 2, 3, 0], [1, 3, 0, 2], [1, 3, 2, 0],
-    [2, 0, 1, 3], [2, 0, 3, 1], [2, 1, 0, 3], [2, 1, 3, 0],
-    [2, 3, 0, 1], [2, 3, 1, 0], [3, 0, 1, 2], [3, 0, 2, 1],
-    [3, 1, 0, 2], [3, 1, 2, 0], [3, 2, 0, 1], [3, 2, 1, 0]
+/// The 24 orderings of a puzzle's four hints, two bits per slot (slot 0 in
+/// the low bits), so a shuffle is one byte load instead of an [Int] walk.
+private let sudokuPermutationCodes: [UInt8] = {
+    var codes = [UInt8]()
+    for a in 0..<4 { for b in 0..<4 where b != a { for c in 0..<4 where c != a && c != b {
+        let d = 6 - a - b - c
+        codes.append(UInt8(a | (b << 2) | (c << 4) | (d << 6)))
+    } } }
+    return codes
+}()
 ]
 
 private let sudokuGoCooked: [Int64] = [
@@ -310,6 +313,10 @@ private struct SudokuGoSource {
 private struct SudokuStaticTables {
     let grids: [[UInt8]]
     let hintPositions: [[UInt8]]
+    /// For each grid, the `hintPositions` indices whose four values no other
+    /// grid shares. Key-independent, so it is worked out once per process
+    /// and every table build just permutes grids over it.
+    let uniqueClues: [[Int]]
 
     static let shared = SudokuStaticTables()
 
@@ -327,6 +334,23 @@ private struct SudokuStaticTables {
         }
         grids = builtGrids
         hintPositions = positions
+        uniqueClues = Self.findUniqueClues(grids: builtGrids, positions: positions)
+    }
+
+    /// Buckets the grids by their four values at each position set (two bits
+    /// per value), so uniqueness is one counting pass instead of comparing
+    /// every grid against every other.
+    private static func findUniqueClues(grids: [[UInt8]], positions: [[UInt8]]) -> [[Int]] {
+        var clues = Array(repeating: [Int](), count: grids.count)
+        var counts = Array(repeating: 0, count: 256)
+        for (index, position) in positions.enumerated() {
+            let p0 = Int(position[0]), p1 = Int(position[1]), p2 = Int(position[2]), p3 = Int(position[3])
+            func code(_ grid: [UInt8]) -> Int { Int(grid[p0] - 1) | Int(grid[p1] - 1) << 2 | Int(grid[p2] - 1) << 4 | Int(grid[p3] - 1) << 6 }
+            for i in 0..<256 { counts[i] = 0 }
+            for grid in grids { counts[code(grid)] += 1 }
+            for (gridIndex, grid) in grids.enumerated() where counts[code(grid)] == 1 { clues[gridIndex].append(index) }
+        }
+        return clues
     }
 
     private static func valid(_ grid: [UInt8], index: Int, number: UInt8) -> Bool {
@@ -430,32 +454,40 @@ private struct SudokuLayout {
 private func sudokuSHA256(_ string: String) -> [UInt8] { Array(SHA256.hash(data: Data(string.utf8))) }
 private func sudokuSHA256(_ data: Data) -> [UInt8] { Array(SHA256.hash(data: data)) }
 
+/// Packs four hint bytes, sorted ascending, into the order-independent key a
+/// puzzle decodes by. A five-exchange sorting network keeps it allocation-free.
+@inline(__always)
 private func sudokuPackHints(_ a: UInt8, _ b: UInt8, _ c: UInt8, _ d: UInt8) -> UInt32 {
-    let h = [a, b, c, d].sorted()
-    return (UInt32(h[0]) << 24) | (UInt32(h[1]) << 16) | (UInt32(h[2]) << 8) | UInt32(h[3])
-}
-
-private func sudokuHasUniqueMatch(grids: [[UInt8]], positions: [UInt8], values: [UInt8]) -> Bool {
-    var count = 0
-    for grid in grids where grid[Int(positions[0])] == values[0] && grid[Int(positions[1])] == values[1] && grid[Int(positions[2])] == values[2] && grid[Int(positions[3])] == values[3] {
-        count += 1
-        if count > 1 { return false }
-    }
-    return count == 1
+    var h0 = a, h1 = b, h2 = c, h3 = d
+    if h0 > h1 { swap(&h0, &h1) }
+    if h2 > h3 { swap(&h2, &h3) }
+    if h0 > h2 { swap(&h0, &h2) }
+    if h1 > h3 { swap(&h1, &h3) }
+    if h1 > h2 { swap(&h1, &h2) }
+    return (UInt32(h0) << 24) | (UInt32(h1) << 16) | (UInt32(h2) << 8) | UInt32(h3)
 }
 
 nonisolated final class SudokuTable {
     fileprivate let layout: SudokuLayout
-    var hint: UInt32 = 0
-    private let encodeTable: [[[UInt8]]]
-    private let decodeMap: [UInt32: UInt8]
+    /// Every puzzle for every byte, four hint bytes packed little-endian
+    /// (hint 0 in the low byte); byte `b` owns
+    /// `encodePuzzles[encodeOffsets[b]..<encodeOffsets[b + 1]]`.
+    private let encodePuzzles: [UInt32]
+    private let encodeOffsets: [Int32]
+    /// Open-addressed decode table indexed by a 16-bit hash of the packed
+    /// key. A table holds roughly 23k puzzles, so 64K slots keep probes to
+    /// one or two; 0 marks an empty slot (distinct hints never pack to 0).
+    private let decodeKeys: [UInt32]
+    private let decodeValues: [UInt8]
+
+    private static let decodeSlotCount = 1 << 16
 
     init(key: String, token: String, customPattern: String) throws {
         if token == "ascii" { layout = .ascii() }
         else if !customPattern.isEmpty { layout = try .custom(customPattern) }
         else { layout = .entropy() }
         let statics = SudokuStaticTables.shared
-        var shuffled = statics.grids
+        var shuffled = Array(statics.grids.indices)
         let sum = sudokuSHA256(key)
         var seed = UInt64(0)
         for b in sum.prefix(8) { seed = (seed << 8) | UInt64(b) }
@@ -466,65 +498,116 @@ nonisolated final class SudokuTable {
                 shuffled.swapAt(i, j)
             }
         }
-        var encodeTableBuilder = Array(repeating: [[UInt8]](), count: 256)
-        var decodeMapBuilder = [UInt32: UInt8]()
-        decodeMapBuilder.reserveCapacity(8192)
+        var puzzlesBuilder = [UInt32]()
+        puzzlesBuilder.reserveCapacity(24576)
+        var offsetsBuilder = [Int32](repeating: 0, count: 257)
+        var keysBuilder = [UInt32](repeating: 0, count: Self.decodeSlotCount)
+        var valuesBuilder = [UInt8](repeating: 0, count: Self.decodeSlotCount)
         for byteValue in 0..<256 {
-            let target = shuffled[byteValue]
-            for positions in statics.hintPositions {
+            offsetsBuilder[byteValue] = Int32(puzzlesBuilder.count)
+            let target = statics.grids[shuffled[byteValue]]
+            for clue in statics.uniqueClues[shuffled[byteValue]] {
+                let positions = statics.hintPositions[clue]
                 let values = [target[Int(positions[0])], target[Int(positions[1])], target[Int(positions[2])], target[Int(positions[3])]]
-                guard sudokuHasUniqueMatch(grids: statics.grids, positions: positions, values: values) else { continue }
-                let hints = [
-                    layout.encodeHint[Int(values[0] - 1)][Int(positions[0])],
-                    layout.encodeHint[Int(values[1] - 1)][Int(positions[1])],
-                    layout.encodeHint[Int(values[2] - 1)][Int(positions[2])],
-                    layout.encodeHint[Int(values[3] - 1)][Int(positions[3])]
-                ]
-                encodeTableBuilder[byteValue].append(hints)
-                decodeMapBuilder[sudokuPackHints(hints[0], hints[1], hints[2], hints[3])] = UInt8(byteValue)
+                let h0 = layout.encodeHint[Int(values[0] - 1)][Int(positions[0])]
+                let h1 = layout.encodeHint[Int(values[1] - 1)][Int(positions[1])]
+                let h2 = layout.encodeHint[Int(values[2] - 1)][Int(positions[2])]
+                let h3 = layout.encodeHint[Int(values[3] - 1)][Int(positions[3])]
+                puzzlesBuilder.append(UInt32(h0) | (UInt32(h1) << 8) | (UInt32(h2) << 16) | (UInt32(h3) << 24))
+                let packed = sudokuPackHints(h0, h1, h2, h3)
+                var slot = Self.decodeSlot(packed)
+                while keysBuilder[slot] != 0 && keysBuilder[slot] != packed {
+                    slot = (slot + 1) & (Self.decodeSlotCount - 1)
+                }
+                keysBuilder[slot] = packed
+                valuesBuilder[slot] = UInt8(byteValue)
             }
         }
-        encodeTable = encodeTableBuilder
-        decodeMap = decodeMapBuilder
+        offsetsBuilder[256] = Int32(puzzlesBuilder.count)
+        encodePuzzles = puzzlesBuilder
+        encodeOffsets = offsetsBuilder
+        decodeKeys = keysBuilder
+        decodeValues = valuesBuilder
+    }
+
+    @inline(__always)
+    private static func decodeSlot(_ packed: UInt32) -> Int {
+        Int((packed &* 0x9e3779b1) >> 16)
     }
 
     func encode(_ data: Data, rng: inout SudokuXorshift64Star, paddingThreshold: UInt64) -> Data {
-        var out = Data(capacity: data.count * 6 + 8)
-        for byte in data {
-            if rng.shouldPad(threshold: paddingThreshold) { out.append(layout.paddingPool[rng.intn(layout.paddingPool.count)]) }
-            let entries = encodeTable[Int(byte)]
-            let puzzle = entries[rng.intn(entries.count)]
-            let perm = sudokuPermutations[rng.intn(24)]
-            for index in perm {
-                if rng.shouldPad(threshold: paddingThreshold) { out.append(layout.paddingPool[rng.intn(layout.paddingPool.count)]) }
-                out.append(puzzle[index])
+        // Worst case is a pad before every hint plus the trailing one.
+        var out = Data(count: data.count * 9 + 1)
+        var written = 0
+        let padding = layout.paddingPool
+        let padCount = padding.count
+        // Decided once per call: with padding off, shouldPad never draws, so
+        // the loop skips the test entirely.
+        let padNever = paddingThreshold == 0
+        out.withUnsafeMutableBytes { rawOut in
+            guard let o = rawOut.bindMemory(to: UInt8.self).baseAddress else { return }
+            encodePuzzles.withUnsafeBufferPointer { puzzles in
+                encodeOffsets.withUnsafeBufferPointer { offsets in
+                    padding.withUnsafeBufferPointer { pads in
+                        sudokuPermutationCodes.withUnsafeBufferPointer { perms in
+                            data.withUnsafeBytes { rawInput in
+                                for byte in rawInput.bindMemory(to: UInt8.self) {
+                                    if !padNever, rng.shouldPad(threshold: paddingThreshold) {
+                                        o[written] = pads[rng.intn(padCount)]; written += 1
+                                    }
+                                    let first = Int(offsets[Int(byte)])
+                                    let count = Int(offsets[Int(byte) + 1]) - first
+                                    let puzzle = puzzles[first + rng.intn(count)]
+                                    var perm = perms[rng.intn(24)]
+                                    for _ in 0..<4 {
+                                        if !padNever, rng.shouldPad(threshold: paddingThreshold) {
+                                            o[written] = pads[rng.intn(padCount)]; written += 1
+                                        }
+                                        o[written] = UInt8(truncatingIfNeeded: puzzle >> (UInt32(perm & 3) << 3))
+                                        written += 1
+                                        perm >>= 2
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            if !padNever, rng.shouldPad(threshold: paddingThreshold) {
+                o[written] = padding[rng.intn(padCount)]; written += 1
             }
         }
-        if rng.shouldPad(threshold: paddingThreshold) { out.append(layout.paddingPool[rng.intn(layout.paddingPool.count)]) }
+        if written < out.count { out.removeSubrange(written..<out.count) }
         return out
     }
 
-    fileprivate func decodePackedKey(_ key: UInt32) -> UInt8? { decodeMap[key] }
+    @inline(__always)
+    fileprivate func decodePackedKey(_ key: UInt32) -> UInt8? {
+        decodeKeys.withUnsafeBufferPointer { keys in
+            var slot = Self.decodeSlot(key)
+            while true {
+                let stored = keys[slot]
+                if stored == key { return decodeValues[slot] }
+                if stored == 0 { return nil }
+                slot = (slot + 1) & (Self.decodeSlotCount - 1)
+            }
+        }
+    }
 }
 
 nonisolated final class SudokuTablePair {
     let uplink: SudokuTable
     let downlink: SudokuTable
+    let hint: UInt32
 
     init(key: String, asciiMode: String, customUplink: String, customDownlink: String) throws {
         let mode = try Self.parseMode(asciiMode)
         let uplinkPattern = mode.uplink == "entropy" ? customUplink : ""
         let downlinkPattern = mode.downlink == "entropy" ? customDownlink : ""
-        uplink = try SudokuTable(key: key, token: mode.uplink, customPattern: uplinkPattern)
-        if mode.uplink == mode.downlink && uplinkPattern == downlinkPattern {
-            downlink = uplink
-        } else {
-            downlink = try SudokuTable(key: key, token: mode.downlink, customPattern: downlinkPattern)
-        }
+        uplink = try SudokuFinalizedTableCache.table(key: key, token: mode.uplink, customPattern: uplinkPattern)
+        downlink = try SudokuFinalizedTableCache.table(key: key, token: mode.downlink, customPattern: downlinkPattern)
         let canonical = mode.uplink == "ascii" && mode.downlink == "ascii" ? "prefer_ascii" : (mode.uplink == "entropy" && mode.downlink == "entropy" ? "prefer_entropy" : asciiMode)
-        let hint = Self.tableHintFingerprint(key: key, mode: canonical, uplinkPattern: uplinkPattern, downlinkPattern: downlinkPattern)
-        uplink.hint = hint
-        downlink.hint = hint
+        hint = Self.tableHintFingerprint(key: key, mode: canonical, uplinkPattern: uplinkPattern, downlinkPattern: downlinkPattern)
     }
 
     private static func parseMode(_ raw: String) throws -> (uplink: String, downlink: String) {
@@ -555,6 +638,33 @@ nonisolated final class SudokuTablePair {
     }
 }
 
+/// Finished tables shared process-wide. A table depends only on its key,
+/// layout token and custom pattern, so pairs that differ elsewhere (mode
+/// hint, the other direction's layout) reuse the same instance.
+private enum SudokuFinalizedTableCache {
+    private struct Key: Hashable {
+        let key: String
+        let token: String
+        let customPattern: String
+    }
+
+    private static let lock = UnfairLock()
+    private static let maxEntries = 16
+    private static var tables: [Key: SudokuTable] = [:]
+
+    static func table(key: String, token: String, customPattern: String) throws -> SudokuTable {
+        let cacheKey = Key(key: key, token: token, customPattern: token == "ascii" ? "" : customPattern)
+        if let table = lock.withLock({ tables[cacheKey] }) { return table }
+        let table = try SudokuTable(key: key, token: token, customPattern: cacheKey.customPattern)
+        return lock.withLock {
+            if let existing = tables[cacheKey] { return existing }
+            if tables.count >= maxEntries { tables.removeAll() }
+            tables[cacheKey] = table
+            return table
+        }
+    }
+}
+
 private struct SudokuDecodedPending {
     private var storage = Data()
     private var offset = 0
@@ -603,7 +713,9 @@ private struct SudokuDecodedPending {
 }
 
 struct SudokuPureDecoder {
-    private var hintBuffer = Array(repeating: UInt8(0), count: 4)
+    private var hint0: UInt8 = 0
+    private var hint1: UInt8 = 0
+    private var hint2: UInt8 = 0
     private var hintCount = 0
     private var pending = SudokuDecodedPending()
 
@@ -618,17 +730,21 @@ struct SudokuPureDecoder {
             let outBytes = rawOut.bindMemory(to: UInt8.self)
             pending.drain(into: outBytes, written: &written, limit: outputLimit)
             guard written < outputLimit else { return }
-            try data.withUnsafeBytes { rawInput in
-                let input = rawInput.bindMemory(to: UInt8.self)
-                for b in input {
-                    guard hintTable[Int(b)] else { continue }
-                    hintBuffer[hintCount] = b
-                    hintCount += 1
-                    guard hintCount == 4 else { continue }
-                    let key = sudokuPackHints(hintBuffer[0], hintBuffer[1], hintBuffer[2], hintBuffer[3])
-                    hintCount = 0
-                    guard let value = table.decodePackedKey(key) else { throw SudokuNativeError.protocolError("Sudoku decode failed") }
-                    appendDecoded(value, to: outBytes, written: &written, limit: outputLimit)
+            try hintTable.withUnsafeBufferPointer { isHint in
+                try data.withUnsafeBytes { rawInput in
+                    let input = rawInput.bindMemory(to: UInt8.self)
+                    for b in input {
+                        guard isHint[Int(b)] else { continue }
+                        switch hintCount {
+                        case 0: hint0 = b; hintCount = 1; continue
+                        case 1: hint1 = b; hintCount = 2; continue
+                        case 2: hint2 = b; hintCount = 3; continue
+                        default: hintCount = 0
+                        }
+                        let key = sudokuPackHints(hint0, hint1, hint2, b)
+                        guard let value = table.decodePackedKey(key) else { throw SudokuNativeError.protocolError("Sudoku decode failed") }
+                        appendDecoded(value, to: outBytes, written: &written, limit: outputLimit)
+                    }
                 }
             }
         }
@@ -728,44 +844,68 @@ struct SudokuPackedDecoder {
     }
 }
 
+/// 128-bit accumulator for the schoolbook limb products.
 private struct SudokuUInt128 {
     var hi: UInt64
     var lo: UInt64
-    static let zero = SudokuUInt128(hi: 0, lo: 0)
-    init(_ value: UInt64) { hi = 0; lo = value }
-    init(hi: UInt64, lo: UInt64) { self.hi = hi; self.lo = lo }
-    mutating func add(_ other: SudokuUInt128) { let (newLo, carry) = lo.addingReportingOverflow(other.lo); lo = newLo; hi = hi &+ other.hi &+ (carry ? 1 : 0) }
-    mutating func addProduct(_ a: UInt64, _ b: UInt64, multiplier: UInt64 = 1) { var wide = a.multipliedFullWidth(by: b); if multiplier != 1 { let loWide = wide.low.multipliedFullWidth(by: multiplier); let hiLow = wide.high &* multiplier; wide = (high: loWide.high &+ hiLow, low: loWide.low) }; add(SudokuUInt128(hi: wide.high, lo: wide.low)) }
-    func shiftedRight(_ bits: UInt64) -> UInt64 { bits == 0 ? lo : ((hi << (64 - bits)) | (lo >> bits)) }
+    @inline(__always) init(_ a: UInt64, _ b: UInt64) { (hi, lo) = a.multipliedFullWidth(by: b) }
+    @inline(__always) mutating func add(_ value: UInt64) { let (newLo, carry) = lo.addingReportingOverflow(value); lo = newLo; hi = hi &+ (carry ? 1 : 0) }
+    @inline(__always) mutating func addProduct(_ a: UInt64, _ b: UInt64) { let wide = a.multipliedFullWidth(by: b); let (newLo, carry) = lo.addingReportingOverflow(wide.low); lo = newLo; hi = hi &+ wide.high &+ (carry ? 1 : 0) }
+    @inline(__always) func shiftedRight51() -> UInt64 { (hi << 13) | (lo >> 51) }
 }
 
+/// GF(2^255 - 19) element in five 51-bit limbs held inline, so arithmetic
+/// never touches the heap.
 private struct SudokuFE25519 {
     static let mask: UInt64 = (1 << 51) - 1
-    static let p: [UInt64] = [2251799813685229, 2251799813685247, 2251799813685247, 2251799813685247, 2251799813685247]
-    static let d2 = SudokuFE25519([1859910466990425, 932731440258426, 1072319116312658, 1815898335770999, 633789495995903])
-    static let baseX = SudokuFE25519([1738742601995546, 1146398526822698, 2070867633025821, 562264141797630, 587772402128613])
-    static let baseY = SudokuFE25519([1801439850948184, 1351079888211148, 450359962737049, 900719925474099, 1801439850948198])
-    var v: [UInt64]
-    init(_ v: [UInt64] = [0, 0, 0, 0, 0]) { self.v = v }
-    static var one: SudokuFE25519 { SudokuFE25519([1, 0, 0, 0, 0]) }
-    mutating func carry() { var c = v[0] >> 51; v[0] &= Self.mask; v[1] += c; c = v[1] >> 51; v[1] &= Self.mask; v[2] += c; c = v[2] >> 51; v[2] &= Self.mask; v[3] += c; c = v[3] >> 51; v[3] &= Self.mask; v[4] += c; c = v[4] >> 51; v[4] &= Self.mask; v[0] += c * 19; c = v[0] >> 51; v[0] &= Self.mask; v[1] += c }
-    mutating func normalize() { carry(); carry(); if gteP() { subP() } }
-    func gteP() -> Bool { for i in stride(from: 4, through: 0, by: -1) { if v[i] > Self.p[i] { return true }; if v[i] < Self.p[i] { return false } }; return true }
-    mutating func subP() { var borrow: UInt64 = 0; for i in 0..<5 { let sub = Self.p[i] + borrow; let next = v[i] < sub ? UInt64(1) : UInt64(0); v[i] = v[i] &- sub; borrow = next } }
-    static func + (f: SudokuFE25519, g: SudokuFE25519) -> SudokuFE25519 { var h = SudokuFE25519(); for i in 0..<5 { h.v[i] = f.v[i] + g.v[i] }; h.carry(); return h }
-    static func - (f: SudokuFE25519, g: SudokuFE25519) -> SudokuFE25519 { var h = SudokuFE25519(); for i in 0..<5 { h.v[i] = f.v[i] + 4 * Self.p[i] - g.v[i] }; h.carry(); return h }
+    static let d2 = SudokuFE25519(1859910466990425, 932731440258426, 1072319116312658, 1815898335770999, 633789495995903)
+    static let baseX = SudokuFE25519(1738742601995546, 1146398526822698, 2070867633025821, 562264141797630, 587772402128613)
+    static let baseY = SudokuFE25519(1801439850948184, 1351079888211148, 450359962737049, 900719925474099, 1801439850948198)
+    /// 4p limb-wise, added before subtracting so limbs never underflow.
+    private static let p4: (UInt64, UInt64) = (4 * 2251799813685229, 4 * 2251799813685247)
+    var v0: UInt64, v1: UInt64, v2: UInt64, v3: UInt64, v4: UInt64
+    init(_ v0: UInt64 = 0, _ v1: UInt64 = 0, _ v2: UInt64 = 0, _ v3: UInt64 = 0, _ v4: UInt64 = 0) { self.v0 = v0; self.v1 = v1; self.v2 = v2; self.v3 = v3; self.v4 = v4 }
+    static var one: SudokuFE25519 { SudokuFE25519(1) }
+    @inline(__always) mutating func carry() { var c = v0 >> 51; v0 &= Self.mask; v1 += c; c = v1 >> 51; v1 &= Self.mask; v2 += c; c = v2 >> 51; v2 &= Self.mask; v3 += c; c = v3 >> 51; v3 &= Self.mask; v4 += c; c = v4 >> 51; v4 &= Self.mask; v0 += c * 19; c = v0 >> 51; v0 &= Self.mask; v1 += c }
+    /// Fully reduces into [0, p): adding 19 carries out of bit 255 exactly
+    /// when the value is at least p, and that carry selects the subtraction.
+    mutating func normalize() {
+        carry(); carry()
+        var c = (v0 + 19) >> 51; c = (v1 + c) >> 51; c = (v2 + c) >> 51; c = (v3 + c) >> 51; c = (v4 + c) >> 51
+        v0 += 19 * c
+        c = v0 >> 51; v0 &= Self.mask; v1 += c; c = v1 >> 51; v1 &= Self.mask; v2 += c; c = v2 >> 51; v2 &= Self.mask; v3 += c; c = v3 >> 51; v3 &= Self.mask; v4 += c; v4 &= Self.mask
+    }
+    static func + (f: SudokuFE25519, g: SudokuFE25519) -> SudokuFE25519 { var h = SudokuFE25519(f.v0 + g.v0, f.v1 + g.v1, f.v2 + g.v2, f.v3 + g.v3, f.v4 + g.v4); h.carry(); return h }
+    static func - (f: SudokuFE25519, g: SudokuFE25519) -> SudokuFE25519 { var h = SudokuFE25519(f.v0 + p4.0 - g.v0, f.v1 + p4.1 - g.v1, f.v2 + p4.1 - g.v2, f.v3 + p4.1 - g.v3, f.v4 + p4.1 - g.v4); h.carry(); return h }
     static func * (f: SudokuFE25519, g: SudokuFE25519) -> SudokuFE25519 {
-        var t = Array(repeating: SudokuUInt128.zero, count: 5)
-        t[0].addProduct(f.v[0], g.v[0]); t[0].addProduct(f.v[1], g.v[4], multiplier: 19); t[0].addProduct(f.v[2], g.v[3], multiplier: 19); t[0].addProduct(f.v[3], g.v[2], multiplier: 19); t[0].addProduct(f.v[4], g.v[1], multiplier: 19)
-        t[1].addProduct(f.v[0], g.v[1]); t[1].addProduct(f.v[1], g.v[0]); t[1].addProduct(f.v[2], g.v[4], multiplier: 19); t[1].addProduct(f.v[3], g.v[3], multiplier: 19); t[1].addProduct(f.v[4], g.v[2], multiplier: 19)
-        t[2].addProduct(f.v[0], g.v[2]); t[2].addProduct(f.v[1], g.v[1]); t[2].addProduct(f.v[2], g.v[0]); t[2].addProduct(f.v[3], g.v[4], multiplier: 19); t[2].addProduct(f.v[4], g.v[3], multiplier: 19)
-        t[3].addProduct(f.v[0], g.v[3]); t[3].addProduct(f.v[1], g.v[2]); t[3].addProduct(f.v[2], g.v[1]); t[3].addProduct(f.v[3], g.v[0]); t[3].addProduct(f.v[4], g.v[4], multiplier: 19)
-        t[4].addProduct(f.v[0], g.v[4]); t[4].addProduct(f.v[1], g.v[3]); t[4].addProduct(f.v[2], g.v[2]); t[4].addProduct(f.v[3], g.v[1]); t[4].addProduct(f.v[4], g.v[0])
-        var h = SudokuFE25519(); var carry = t[0].shiftedRight(51); t[1].add(SudokuUInt128(carry)); h.v[0] = t[0].lo & mask; carry = t[1].shiftedRight(51); t[2].add(SudokuUInt128(carry)); h.v[1] = t[1].lo & mask; carry = t[2].shiftedRight(51); t[3].add(SudokuUInt128(carry)); h.v[2] = t[2].lo & mask; carry = t[3].shiftedRight(51); t[4].add(SudokuUInt128(carry)); h.v[3] = t[3].lo & mask; carry = t[4].shiftedRight(51); h.v[4] = t[4].lo & mask; h.v[0] += carry * 19; h.carry(); return h
+        // Limbs are carried below 2^52, so 19x still fits in 64 bits and the
+        // wrap-around terms fold in without widening the multiplier.
+        let g1 = g.v1 * 19, g2 = g.v2 * 19, g3 = g.v3 * 19, g4 = g.v4 * 19
+        var t0 = SudokuUInt128(f.v0, g.v0); t0.addProduct(f.v1, g4); t0.addProduct(f.v2, g3); t0.addProduct(f.v3, g2); t0.addProduct(f.v4, g1)
+        var t1 = SudokuUInt128(f.v0, g.v1); t1.addProduct(f.v1, g.v0); t1.addProduct(f.v2, g4); t1.addProduct(f.v3, g3); t1.addProduct(f.v4, g2)
+        var t2 = SudokuUInt128(f.v0, g.v2); t2.addProduct(f.v1, g.v1); t2.addProduct(f.v2, g.v0); t2.addProduct(f.v3, g4); t2.addProduct(f.v4, g3)
+        var t3 = SudokuUInt128(f.v0, g.v3); t3.addProduct(f.v1, g.v2); t3.addProduct(f.v2, g.v1); t3.addProduct(f.v3, g.v0); t3.addProduct(f.v4, g4)
+        var t4 = SudokuUInt128(f.v0, g.v4); t4.addProduct(f.v1, g.v3); t4.addProduct(f.v2, g.v2); t4.addProduct(f.v3, g.v1); t4.addProduct(f.v4, g.v0)
+        var h = SudokuFE25519()
+        t1.add(t0.shiftedRight51()); h.v0 = t0.lo & mask
+        t2.add(t1.shiftedRight51()); h.v1 = t1.lo & mask
+        t3.add(t2.shiftedRight51()); h.v2 = t2.lo & mask
+        t4.add(t3.shiftedRight51()); h.v3 = t3.lo & mask
+        let carry = t4.shiftedRight51(); h.v4 = t4.lo & mask
+        h.v0 += carry * 19; h.carry(); return h
     }
     func squared() -> SudokuFE25519 { self * self }
     func inverted() -> SudokuFE25519 { var r = SudokuFE25519.one; let exp = SudokuKeyRecovery.pMinus2; for bit in stride(from: 254, through: 0, by: -1) { r = r.squared(); if ((exp[bit >> 3] >> UInt8(bit & 7)) & 1) != 0 { r = r * self } }; return r }
-    func toBytes() -> [UInt8] { var h = self; h.normalize(); var out = Array(repeating: UInt8(0), count: 32); for i in 0..<32 { let bit = i * 8; let limb = bit / 51; let shift = bit % 51; var value = h.v[limb] >> UInt64(shift); if limb + 1 < 5 && shift > 43 { value |= h.v[limb + 1] << UInt64(51 - shift) }; out[i] = UInt8(truncatingIfNeeded: value) }; return out }
+    /// `a` when `mask` is 0, `b` when it is all ones, without branching.
+    @inline(__always) static func select(_ a: SudokuFE25519, _ b: SudokuFE25519, mask: UInt64) -> SudokuFE25519 { SudokuFE25519(a.v0 ^ (mask & (a.v0 ^ b.v0)), a.v1 ^ (mask & (a.v1 ^ b.v1)), a.v2 ^ (mask & (a.v2 ^ b.v2)), a.v3 ^ (mask & (a.v3 ^ b.v3)), a.v4 ^ (mask & (a.v4 ^ b.v4))) }
+    func toBytes() -> [UInt8] {
+        var h = self; h.normalize()
+        // 255 bits little-endian; the top limb's last bit is always clear.
+        let lo0 = h.v0 | (h.v1 << 51), lo1 = (h.v1 >> 13) | (h.v2 << 38), lo2 = (h.v2 >> 26) | (h.v3 << 25), lo3 = (h.v3 >> 39) | (h.v4 << 12)
+        var out = [UInt8](repeating: 0, count: 32)
+        for (i, word) in [lo0, lo1, lo2, lo3].enumerated() { for j in 0..<8 { out[i * 8 + j] = UInt8(truncatingIfNeeded: word >> UInt64(j * 8)) } }
+        return out
+    }
     func isOdd() -> Bool { (toBytes()[0] & 1) != 0 }
 }
 
@@ -807,14 +947,37 @@ private struct SudokuEdPoint {
         let h = d - b
         return SudokuEdPoint(x: e * f, y: g * h, z: f * g, t: e * h)
     }
+
+    @inline(__always) static func select(_ a: SudokuEdPoint, _ b: SudokuEdPoint, mask: UInt64) -> SudokuEdPoint {
+        SudokuEdPoint(x: .select(a.x, b.x, mask: mask), y: .select(a.y, b.y, mask: mask), z: .select(a.z, b.z, mask: mask), t: .select(a.t, b.t, mask: mask))
+    }
 }
 
 enum SudokuKeyRecovery {
     fileprivate static let l: [UInt8] = [0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10]
     fileprivate static let pMinus2: [UInt8] = [0xeb, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f]
-    static func recoverPublicKeyHex(_ keyHex: String) -> String? { guard let raw = Data(hexString: keyHex), raw.count == 32 || raw.count == 64 else { return nil }; if raw.count == 32 { return raw.hexEncodedString() }; let scalar = scalarAdd(Array(raw.prefix(32)), Array(raw.suffix(32))); return Data(scalarBasePublic(scalar)).hexEncodedString() }
+    /// Keys are per configuration, so the scalar multiply runs once per key
+    /// rather than once per connection.
+    private static let lock = UnfairLock()
+    private static let maxEntries = 16
+    private static var recovered: [String: String] = [:]
+
+    static func recoverPublicKeyHex(_ keyHex: String) -> String? {
+        if let cached = lock.withLock({ recovered[keyHex] }) { return cached }
+        guard let raw = Data(hexString: keyHex), raw.count == 32 || raw.count == 64 else { return nil }
+        if raw.count == 32 { return raw.hexEncodedString() }
+        let scalar = scalarAdd(Array(raw.prefix(32)), Array(raw.suffix(32)))
+        let publicHex = Data(scalarBasePublic(scalar)).hexEncodedString()
+        lock.withLock {
+            if recovered.count >= maxEntries { recovered.removeAll() }
+            recovered[keyHex] = publicHex
+        }
+        return publicHex
+    }
     private static func scalarAdd(_ a: [UInt8], _ b: [UInt8]) -> [UInt8] { var out = Array(repeating: UInt8(0), count: 32); var carry = 0; for i in 0..<32 { let sum = Int(a[i]) + Int(b[i]) + carry; out[i] = UInt8(truncatingIfNeeded: sum); carry = sum >> 8 }; if carry != 0 || scalarGteL(out) { scalarSubL(&out) }; return out }
     private static func scalarGteL(_ s: [UInt8]) -> Bool { for i in stride(from: 31, through: 0, by: -1) { if s[i] > l[i] { return true }; if s[i] < l[i] { return false } }; return true }
     private static func scalarSubL(_ s: inout [UInt8]) { var borrow = 0; for i in 0..<32 { let sub = Int(l[i]) + borrow; let current = Int(s[i]); s[i] = UInt8(truncatingIfNeeded: current - sub); borrow = current < sub ? 1 : 0 } }
-    private static func scalarBasePublic(_ scalar: [UInt8]) -> [UInt8] { var result = SudokuEdPoint.identity; let base = SudokuEdPoint.base; for bit in stride(from: 255, through: 0, by: -1) { result = result.doubled(); if ((scalar[bit >> 3] >> UInt8(bit & 7)) & 1) != 0 { result = result.adding(base) } }; let zInv = result.z.inverted(); let x = result.x * zInv; let y = result.y * zInv; var out = y.toBytes(); if x.isOdd() { out[31] |= 0x80 } else { out[31] &= 0x7f }; return out }
+    /// Double-and-always-add: each bit's addition is computed and kept or
+    /// discarded by mask, so timing does not depend on the secret scalar.
+    private static func scalarBasePublic(_ scalar: [UInt8]) -> [UInt8] { var result = SudokuEdPoint.identity; let base = SudokuEdPoint.base; for bit in stride(from: 255, through: 0, by: -1) { result = result.doubled(); let mask = 0 &- UInt64((scalar[bit >> 3] >> UInt8(bit & 7)) & 1); result = .select(result, result.adding(base), mask: mask) }; let zInv = result.z.inverted(); let x = result.x * zInv; let y = result.y * zInv; var out = y.toBytes(); if x.isOdd() { out[31] |= 0x80 } else { out[31] &= 0x7f }; return out }
 }
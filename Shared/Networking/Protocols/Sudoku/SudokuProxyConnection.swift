@@ -429,32 +429,70 @@ nonisolated final class SudokuTables {
         try lock.withLock { try body(pair.downlink) }
     }
 
-    var hint: UInt32 { lock.withLock { pair.uplink.hint } }
+    var hint: UInt32 { pair.hint }
 }
 
-nonisolated final class BlockingProxyStream {
-    private let connection: ProxyConnection
+/// A byte stream over one factory connection. Writes are queued and issued one at a time
+/// from completions, so no thread waits on a send. The mux reader and writer, which own
+/// their thread, still use the blocking reads and `sendAll`.
+nonisolated final class SudokuProxyStream {
+    fileprivate let connection: ProxyConnection
     private let stateLock = UnfairLock()
     private let readLock = UnfairLock()
-    private let writeLock = UnfairLock()
     private var pending = SudokuDataQueue()
     private var closed = false
+    private var writing = false
+    private var writeBacklog: [(data: Data, completion: (Error?) -> Void)] = []
 
     init(connection: ProxyConnection) { self.connection = connection }
 
+    func send(_ data: Data, completion: @escaping (Error?) -> Void) {
+        if data.isEmpty { completion(nil); return }
+        stateLock.lock()
+        if closed {
+            stateLock.unlock()
+            completion(SudokuNativeError.closed)
+            return
+        }
+        if writing {
+            writeBacklog.append((data, completion))
+            stateLock.unlock()
+            return
+        }
+        writing = true
+        stateLock.unlock()
+        write(data, completion: completion)
+    }
+
+    private func write(_ data: Data, completion: @escaping (Error?) -> Void) {
+        connection.sendRaw(data: data) { [weak self] error in
+            completion(error)
+            self?.writeNext()
+        }
+    }
+
+    private func writeNext() {
+        stateLock.lock()
+        guard !writeBacklog.isEmpty else {
+            writing = false
+            stateLock.unlock()
+            return
+        }
+        let next = writeBacklog.removeFirst()
+        stateLock.unlock()
+        write(next.data, completion: next.completion)
+    }
+
     func sendAll(_ data: Data) throws {
         if data.isEmpty { return }
-        try writeLock.withLock {
-            if isClosed { throw SudokuNativeError.closed }
-            let sema = DispatchSemaphore(value: 0)
-            var sentError: Error?
-            connection.sendRaw(data: data) { error in
-                sentError = error
-                sema.signal()
-            }
-            sema.wait()
-            if let sentError { throw sentError }
+        let sema = DispatchSemaphore(value: 0)
+        var sentError: Error?
+        send(data) { error in
+            sentError = error
+            sema.signal()
         }
+        sema.wait()
+        if let sentError { throw sentError }
     }
 
     func readSome(max: Int) throws -> Data {
@@ -544,8 +582,13 @@ nonisolated final class BlockingProxyStream {
     }
 
     func cancel() {
-        markClosed()
+        let backlog: [(data: Data, completion: (Error?) -> Void)] = stateLock.withLock {
+            closed = true
+            defer { writeBacklog.removeAll() }
+            return writeBacklog
+        }
         connection.cancel()
+        for entry in backlog { entry.completion(SudokuNativeError.closed) }
     }
 
     private var isClosed: Bool {
@@ -598,6 +641,48 @@ private extension Data {
     }
 }
 
+/// Delivers the first of an open's result or its timeout; later results are dropped.
+private final class SudokuOneShot {
+    typealias Value = Result<SudokuProxyStream, Error>
+
+    private let lock = UnfairLock()
+    private var completion: ((Value) -> Void)?
+    private var timer: DispatchWorkItem?
+    private var onTimeout: (() -> Void)?
+
+    init(_ completion: @escaping (Value) -> Void) { self.completion = completion }
+
+    /// Starts (or restarts) the deadline; `cleanup` runs if it fires first.
+    func arm(timeout: TimeInterval, error: Error, cleanup: (() -> Void)? = nil) {
+        let work = DispatchWorkItem { [weak self] in
+            guard let self else { return }
+            let cleanup = self.lock.withLock { self.onTimeout }
+            if self.fire(.failure(error)) { cleanup?() }
+        }
+        let previous: DispatchWorkItem? = lock.withLock {
+            defer { timer = work; onTimeout = cleanup }
+            return timer
+        }
+        previous?.cancel()
+        DispatchQueue.global(qos: .userInitiated).asyncAfter(deadline: .now() + timeout, execute: work)
+    }
+
+    var isPending: Bool { lock.withLock { completion != nil } }
+
+    /// Returns false when something was already delivered.
+    @discardableResult
+    func fire(_ value: Value) -> Bool {
+        let (pending, timer): (((Value) -> Void)?, DispatchWorkItem?) = lock.withLock {
+            defer { completion = nil; self.timer = nil; onTimeout = nil }
+            return (completion, self.timer)
+        }
+        timer?.cancel()
+        guard let pending else { return false }
+        pending(value)
+        return true
+    }
+}
+
 nonisolated final class SudokuConnectionFactory {
     private let configuration: ProxyConfiguration
     private let directDialHost: String
@@ -605,7 +690,7 @@ nonisolated final class SudokuConnectionFactory {
     private var initialTunnel: ProxyConnection?
     private var retainedClients: [ProxyClient] = []
     private var retainedTLSClients: [TLSClient] = []
-    private var retainedTransports: [NWTCPTransport] = []
+    private var retainedTransports: [any TCPDialTransport] = []
     private var connections: [ProxyConnection] = []
     private var closed = false
 
@@ -615,26 +700,31 @@ nonisolated final class SudokuConnectionFactory {
         self.directDialHost = directDialHost
     }
 
-    func open(host: String, port: UInt16, useTLS: Bool, serverName: String?) throws -> BlockingProxyStream {
-        if stateLock.withLock({ closed }) { throw SudokuNativeError.closed }
-        let sema = DispatchSemaphore(value: 0)
-        var result: Result<ProxyConnection, Error>?
-        openProxyConnection(host: host, port: port, useTLS: useTLS, serverName: serverName) { openResult in
-            result = openResult
-            sema.signal()
-        }
-        if sema.wait(timeout: .now() + 30) == .timedOut {
-            throw SudokuNativeError.connectionFailed("timeout opening transport")
-        }
-        guard let result else {
-            throw SudokuNativeError.connectionFailed("transport open completed without result")
-        }
-        let connection = try result.get()
-        guard retainConnection(connection) else {
-            connection.cancel()
-            throw SudokuNativeError.closed
+    func open(
+        host: String,
+        port: UInt16,
+        useTLS: Bool,
+        serverName: String?,
+        completion: @escaping (Result<SudokuProxyStream, Error>) -> Void
+    ) {
+        if stateLock.withLock({ closed }) { completion(.failure(SudokuNativeError.closed)); return }
+        let once = SudokuOneShot(completion)
+        once.arm(timeout: 30, error: SudokuNativeError.connectionFailed("timeout opening transport"))
+        openProxyConnection(host: host, port: port, useTLS: useTLS, serverName: serverName) { [weak self] result in
+            let connection: ProxyConnection
+            switch result {
+            case .failure(let error): once.fire(.failure(error)); return
+            case .success(let opened): connection = opened
+            }
+            guard let self, self.retainConnection(connection) else {
+                connection.cancel()
+                once.fire(.failure(SudokuNativeError.closed))
+                return
+            }
+            if !once.fire(.success(SudokuProxyStream(connection: connection))) {
+                self.release(connection)
+            }
         }
-        return BlockingProxyStream(connection: connection)
     }
 
     func openWebSocket(
@@ -644,66 +734,76 @@ nonisolated final class SudokuConnectionFactory {
         serverName: String?,
         hostHeader: String,
         path: String,
-        headers: [String: String]
-    ) throws -> BlockingProxyStream {
-        if stateLock.withLock({ closed }) { throw SudokuNativeError.closed }
-        let sema = DispatchSemaphore(value: 0)
-        var result: Result<ProxyConnection, Error>?
-        openProxyConnection(host: host, port: port, useTLS: useTLS, serverName: serverName) { openResult in
-            result = openResult
-            sema.signal()
-        }
-        if sema.wait(timeout: .now() + 30) == .timedOut {
-            throw SudokuNativeError.connectionFailed("timeout opening WebSocket transport")
-        }
-        guard let result else {
-            throw SudokuNativeError.connectionFailed("WebSocket transport open completed without result")
-        }
-        let base = try result.get()
-        guard retainConnection(base) else {
-            base.cancel()
-            throw SudokuNativeError.closed
-        }
-        let ws = WebSocketConnection(
-            tunnel: base,
-            configuration: WebSocketConfiguration(
-                host: hostHeader,
-                path: path,
-                headers: headers,
-                heartbeatPeriod: 30
+        headers: [String: String],
+        completion: @escaping (Result<SudokuProxyStream, Error>) -> Void
+    ) {
+        if stateLock.withLock({ closed }) { completion(.failure(SudokuNativeError.closed)); return }
+        let once = SudokuOneShot(completion)
+        once.arm(timeout: 30, error: SudokuNativeError.connectionFailed("timeout opening WebSocket transport"))
+        openProxyConnection(host: host, port: port, useTLS: useTLS, serverName: serverName) { [weak self] result in
+            let base: ProxyConnection
+            switch result {
+            case .failure(let error): once.fire(.failure(error)); return
+            case .success(let opened): base = opened
+            }
+            guard once.isPending, let self, self.retainConnection(base) else {
+                base.cancel()
+                once.fire(.failure(SudokuNativeError.closed))
+                return
+            }
+            let ws = WebSocketConnection(
+                tunnel: base,
+                configuration: WebSocketConfiguration(
+                    host: hostHeader,
+                    path: path,
+                    headers: headers,
+                    heartbeatPeriod: 30
+                )
             )
-        )
-        let upgrade = DispatchSemaphore(value: 0)
-        var upgradeError: Error?
-        ws.performUpgrade { error in
-            upgradeError = error
-            upgrade.signal()
-        }
-        if upgrade.wait(timeout: .now() + 30) == .timedOut {
-            releaseConnection(base)
-            ws.cancel()
-            base.cancel()
-            throw SudokuNativeError.connectionFailed("timeout upgrading WebSocket transport")
-        }
-        if let upgradeError {
-            releaseConnection(base)
-            ws.cancel()
-            base.cancel()
-            throw upgradeError
-        }
-        let connection = WebSocketProxyConnection(wsConnection: ws)
-        guard replaceConnection(base, with: connection) else {
-            connection.cancel()
-            throw SudokuNativeError.closed
+            // Re-armed so the upgrade gets its own 30 s, as the dial did.
+            once.arm(timeout: 30, error: SudokuNativeError.connectionFailed("timeout upgrading WebSocket transport")) {
+                self.releaseConnection(base)
+                ws.cancel()
+                base.cancel()
+            }
+            ws.performUpgrade { error in
+                if let error {
+                    self.releaseConnection(base)
+                    ws.cancel()
+                    base.cancel()
+                    once.fire(.failure(error))
+                    return
+                }
+                let connection = WebSocketProxyConnection(wsConnection: ws)
+                guard self.replaceConnection(base, with: connection) else {
+                    connection.cancel()
+                    once.fire(.failure(SudokuNativeError.closed))
+                    return
+                }
+                if !once.fire(.success(SudokuProxyStream(connection: connection))) {
+                    self.release(connection)
+                }
+            }
         }
-        return BlockingProxyStream(connection: connection)
+    }
+
+    /// Closes a stream whose exchange is over and stops retaining its connection, so a
+    /// long-lived HTTP-mask session doesn't accumulate one entry per request.
+    func release(_ stream: SudokuProxyStream) {
+        release(stream.connection)
+        stream.cancel()
+    }
+
+    private func release(_ connection: ProxyConnection) {
+        releaseConnection(connection)
+        connection.cancel()
     }
 
     func closeAll() {
         let toClose: [ProxyConnection]
         let clients: [ProxyClient]
         let tlsClients: [TLSClient]
-        let transports: [NWTCPTransport]
+        let transports: [any TCPDialTransport]
         stateLock.lock()
         if closed {
             stateLock.unlock()
@@ -763,7 +863,7 @@ nonisolated final class SudokuConnectionFactory {
             return
         }
 
-        let transport = NWTCPTransport()
+        let transport = DialTransports.tcp()
         guard retainTransport(transport) else {
             completion(.failure(SudokuNativeError.closed))
             return
@@ -836,7 +936,7 @@ nonisolated final class SudokuConnectionFactory {
         }
     }
 
-    private func retainTransport(_ transport: NWTCPTransport) -> Bool {
+    private func retainTransport(_ transport: any TCPDialTransport) -> Bool {
         stateLock.withLock {
             guard !closed else { return false }
             retainedTransports.append(transport)
@@ -844,7 +944,7 @@ nonisolated final class SudokuConnectionFactory {
         }
     }
 
-    private func releaseTransport(_ transport: NWTCPTransport) {
+    private func releaseTransport(_ transport: any TCPDialTransport) {
         stateLock.withLock {
             retainedTransports.removeAll { $0 === transport }
         }
@@ -874,141 +974,509 @@ nonisolated final class SudokuConnectionFactory {
     }
 }
 
-private final class SudokuHTTPBodyReader {
-    let stream: BlockingProxyStream
-    let status: Int
-    let chunked: Bool
-    let closeDelimited: Bool
-    var contentRemaining: Int
-    var chunkRemaining = 0
-    var done = false
-
-    init(stream: BlockingProxyStream, status: Int, chunked: Bool, contentLength: Int?) {
+/// One `Connection: close` HTTP/1.1 response, parsed as its bytes arrive: the head, then a
+/// chunked, length-delimited or close-delimited body. `finish()` releases the connection.
+private final class SudokuHTTPResponse {
+    private let stream: SudokuProxyStream
+    private let factory: SudokuConnectionFactory
+    private(set) var status = 0
+    private var chunked = false
+    private var closeDelimited = false
+    private var contentRemaining = 0
+    private var chunkRemaining = 0
+    private var done = false
+    /// Bytes read past the last parsed line.
+    private var buffer = Data()
+    private let finishLock = UnfairLock()
+    private var finished = false
+
+    private init(stream: SudokuProxyStream, factory: SudokuConnectionFactory) {
         self.stream = stream
-        self.status = status
-        self.chunked = chunked
-        self.contentRemaining = contentLength ?? 0
-        self.closeDelimited = !chunked && contentLength == nil
+        self.factory = factory
+    }
+
+    /// Sends `request` in one write and parses the response head.
+    static func exchange(
+        _ request: Data,
+        over stream: SudokuProxyStream,
+        factory: SudokuConnectionFactory,
+        completion: @escaping (Result<SudokuHTTPResponse, Error>) -> Void
+    ) {
+        let response = SudokuHTTPResponse(stream: stream, factory: factory)
+        stream.send(request) { error in
+            if let error {
+                response.finish()
+                completion(.failure(error))
+                return
+            }
+            response.readHead { error in
+                if let error {
+                    response.finish()
+                    completion(.failure(error))
+                } else {
+                    completion(.success(response))
+                }
+            }
+        }
+    }
+
+    /// Idempotent; a read in flight fails once the connection is gone.
+    func finish() {
+        let first = finishLock.withLock { () -> Bool in
+            defer { finished = true }
+            return !finished
+        }
+        if first { factory.release(stream) }
     }
 
-    func readSome(max: Int = 32 * 1024) throws -> Data {
-        if done { return Data() }
+    /// Up to `max` body bytes; empty once the body is complete.
+    func readChunk(max: Int, completion: @escaping (Result<Data, Error>) -> Void) {
+        if done { completion(.success(Data())); return }
         if chunked {
-            while chunkRemaining == 0 {
-                let line = try readLine()
-                let lenText = line.split(separator: ";", maxSplits: 1).first.map(String.init) ?? line
+            if chunkRemaining > 0 {
+                readBytes(max: min(max, chunkRemaining)) { result in
+                    guard case .success(let data) = result else { completion(result); return }
+                    self.chunkRemaining -= data.count
+                    guard self.chunkRemaining == 0 else { completion(result); return }
+                    // The CRLF closing the chunk.
+                    self.readLine { line in
+                        if case .failure(let error) = line { completion(.failure(error)) } else { completion(result) }
+                    }
+                }
+                return
+            }
+            readLine { line in
+                let text: String
+                switch line {
+                case .failure(let error): completion(.failure(error)); return
+                case .success(let value): text = value
+                }
+                let lenText = text.split(separator: ";", maxSplits: 1).first.map(String.init) ?? text
                 guard let length = Int(lenText.trimmingCharacters(in: .whitespacesAndNewlines), radix: 16) else {
-                    throw SudokuNativeError.protocolError("bad chunk length")
+                    completion(.failure(SudokuNativeError.protocolError("bad chunk length")))
+                    return
                 }
                 if length == 0 {
-                    repeat { if try readLine().isEmpty { break } } while true
-                    done = true
-                    return Data()
+                    self.skipTrailers { error in
+                        if let error { completion(.failure(error)); return }
+                        self.done = true
+                        completion(.success(Data()))
+                    }
+                    return
                 }
-                chunkRemaining = length
+                self.chunkRemaining = length
+                self.readChunk(max: max, completion: completion)
             }
-            let n = min(max, chunkRemaining)
-            let data = try stream.readExact(n)
-            chunkRemaining -= n
-            if chunkRemaining == 0 { _ = try stream.readExact(2) }
-            return data
+            return
         }
         if !closeDelimited {
             if contentRemaining == 0 {
                 done = true
-                return Data()
+                completion(.success(Data()))
+                return
             }
-            let n = min(max, contentRemaining)
-            let data = try stream.readExact(n)
-            contentRemaining -= n
-            if contentRemaining == 0 { done = true }
-            return data
+            readBytes(max: min(max, contentRemaining)) { result in
+                if case .success(let data) = result {
+                    self.contentRemaining -= data.count
+                    if self.contentRemaining == 0 { self.done = true }
+                }
+                completion(result)
+            }
+            return
+        }
+        readBytes(max: max) { result in
+            guard case .success = result else {
+                self.done = true
+                completion(.success(Data()))
+                return
+            }
+            completion(result)
         }
-        do { return try stream.readSome(max: max) }
-        catch { done = true; return Data() }
     }
 
-    func readAll(limit: Int) throws -> Data {
+    func readAll(limit: Int, completion: @escaping (Result<Data, Error>) -> Void) {
         var out = Data()
-        while out.count < limit {
-            let part = try readSome(max: min(4096, limit - out.count))
-            if part.isEmpty { break }
-            out.append(part)
+        func step() {
+            guard out.count < limit else { completion(.success(out)); return }
+            readChunk(max: min(4096, limit - out.count)) { result in
+                switch result {
+                case .failure(let error):
+                    completion(.failure(error))
+                case .success(let part):
+                    if part.isEmpty { completion(.success(out)); return }
+                    out.append(part)
+                    step()
+                }
+            }
         }
-        return out
+        step()
     }
 
-    private func readLine() throws -> String {
-        var data = Data()
-        while true {
-            let byte = try stream.readExact(1)[0]
-            if byte == 0x0a { break }
-            if byte != 0x0d { data.append(byte) }
-            if data.count > 8192 { throw SudokuNativeError.protocolError("HTTP line too long") }
+    private func readHead(completion: @escaping (Error?) -> Void) {
+        readLine { line in
+            let statusLine: String
+            switch line {
+            case .failure(let error): completion(error); return
+            case .success(let value): statusLine = value
+            }
+            let parts = statusLine.split(separator: " ")
+            guard parts.count >= 2, let status = Int(parts[1]) else {
+                completion(SudokuNativeError.protocolError("bad HTTP response"))
+                return
+            }
+            self.status = status
+            self.readHeaders(contentLength: nil, completion: completion)
+        }
+    }
+
+    private func readHeaders(contentLength: Int?, completion: @escaping (Error?) -> Void) {
+        readLine { line in
+            let header: String
+            switch line {
+            case .failure(let error): completion(error); return
+            case .success(let value): header = value
+            }
+            if header.isEmpty {
+                self.contentRemaining = contentLength ?? 0
+                self.closeDelimited = !self.chunked && contentLength == nil
+                completion(nil)
+                return
+            }
+            var contentLength = contentLength
+            let lower = header.lowercased()
+            if lower.hasPrefix("transfer-encoding:") && lower.contains("chunked") { self.chunked = true }
+            if lower.hasPrefix("content-length:"), let value = Int(header.split(separator: ":", maxSplits: 1)[1].trimmingCharacters(in: .whitespaces)) { contentLength = value }
+            self.readHeaders(contentLength: contentLength, completion: completion)
+        }
+    }
+
+    private func skipTrailers(completion: @escaping (Error?) -> Void) {
+        readLine { line in
+            switch line {
+            case .failure(let error): completion(error)
+            case .success(let text) where text.isEmpty: completion(nil)
+            case .success: self.skipTrailers(completion: completion)
+            }
+        }
+    }
+
+    private func readLine(completion: @escaping (Result<String, Error>) -> Void) {
+        if let newline = buffer.firstIndex(of: 0x0a) {
+            let line = buffer[buffer.startIndex..<newline].filter { $0 != 0x0d }
+            buffer.removeSubrange(buffer.startIndex...newline)
+            completion(.success(String(decoding: line, as: UTF8.self)))
+            return
+        }
+        guard buffer.count <= 8192 else {
+            completion(.failure(SudokuNativeError.protocolError("HTTP line too long")))
+            return
+        }
+        stream.readSomeAsync(max: 16 * 1024) { data, error in
+            if let error { completion(.failure(error)); return }
+            guard let data, !data.isEmpty else { completion(.failure(SudokuNativeError.closed)); return }
+            self.buffer.append(data)
+            self.readLine(completion: completion)
+        }
+    }
+
+    private func readBytes(max: Int, completion: @escaping (Result<Data, Error>) -> Void) {
+        if !buffer.isEmpty {
+            let end = buffer.startIndex + min(max, buffer.count)
+            let out = Data(buffer[buffer.startIndex..<end])
+            buffer.removeSubrange(buffer.startIndex..<end)
+            completion(.success(out))
+            return
+        }
+        stream.readSomeAsync(max: max) { data, error in
+            if let error { completion(.failure(error)); return }
+            guard let data, !data.isEmpty else { completion(.failure(SudokuNativeError.closed)); return }
+            completion(.success(data))
+        }
+    }
+}
+
+/// Builds and issues the HTTP-mask requests of one session, each on a fresh connection.
+private struct SudokuHTTPMaskRequester {
+    let config: SudokuNativeConfig
+    let factory: SudokuConnectionFactory
+    let modeName: String
+
+    private var hostHeader: String {
+        let host = config.httpMask.host.isEmpty ? config.serverHost : config.httpMask.host
+        if (config.httpMask.tls && config.serverPort == 443) || (!config.httpMask.tls && config.serverPort == 80) { return host }
+        return "\(host):\(config.serverPort)"
+    }
+
+    private func authToken(method: String, path: String) -> String {
+        SudokuHTTPMaskAuth.token(key: config.key, mode: modeName, method: method, path: path)
+    }
+
+    private func appendAuth(_ path: String, token: String) -> String {
+        path + (path.contains("?") ? "&" : "?") + "auth=\(token)"
+    }
+
+    func perform(
+        method: String,
+        requestPath: String,
+        authPath: String,
+        contentType: String? = nil,
+        body: Data,
+        completion: @escaping (Result<SudokuHTTPResponse, Error>) -> Void
+    ) {
+        let auth = authToken(method: method, path: authPath)
+        let path = appendAuth(requestPath, token: auth)
+        var requestHead = "\(method) \(path) HTTP/1.1\r\nHost: \(hostHeader)\r\nUser-Agent: \(ProxyUserAgent.chrome)\r\nAccept: */*\r\nCache-Control: no-cache\r\nPragma: no-cache\r\nConnection: close\r\nX-Sudoku-Tunnel: \(modeName)\r\nAuthorization: Bearer \(auth)\r\n"
+        if let contentType { requestHead += "Content-Type: \(contentType)\r\n" }
+        requestHead += "Content-Length: \(body.count)\r\n\r\n"
+        var request = Data(requestHead.utf8)
+        request.append(body)
+        let factory = factory
+        let serverName = config.httpMask.host.isEmpty ? config.serverHost : config.httpMask.host
+        factory.open(host: config.serverHost, port: config.serverPort, useTLS: config.httpMask.tls, serverName: serverName) { result in
+            switch result {
+            case .failure(let error):
+                completion(.failure(error))
+            case .success(let stream):
+                SudokuHTTPResponse.exchange(request, over: stream, factory: factory, completion: completion)
+            }
         }
-        return String(data: data, encoding: .utf8) ?? ""
     }
 }
 
+/// An HTTP-mask `stream` or `poll` session. Pulls and pushes are chains of exchanges
+/// driven from completions, so a session holds no thread between them; a full receive
+/// queue parks the pull until a receive drains it. The blocking `send` and `receive`
+/// remain for the mux, whose reader and writer own their thread.
 nonisolated final class SudokuHTTPMaskTransport {
-    private let config: SudokuNativeConfig
-    private let factory: SudokuConnectionFactory
+    private let requester: SudokuHTTPMaskRequester
     private let mode: SudokuHTTPMaskMode
+    private let pullPath: String
+    private let pushPath: String
+    private let closePath: String
+    let earlyResponsePayload: Data
+    /// Runs the pull loop's steps, so a run of buffered chunks doesn't nest completions.
+    private let queue = DispatchQueue(label: AWCore.Identifier.sudokuHTTPMaskQueue, qos: .userInitiated)
     private let condition = NSCondition()
     private var rxQueue = SudokuDataQueue()
     private var txQueue = SudokuDataQueue()
     private var closed = false
     private var fatal = false
-    private var token = ""
-    private var pullPath = ""
-    private var pushPath = ""
-    private var closePath = ""
-    private let earlyRequestPayload: Data?
-    private(set) var earlyResponsePayload = Data()
     private var pendingReceive: ((Data?, Error?) -> Void)?
     private var pendingMax = 0
-
-    init(config: SudokuNativeConfig, factory: SudokuConnectionFactory, mode: SudokuHTTPMaskMode, earlyRequestPayload: Data? = nil) throws {
-        self.config = config
-        self.factory = factory
+    /// Async sends waiting for room in `txQueue`, in order.
+    private var pendingSends: [(data: Data, completion: (Error?) -> Void)] = []
+    private var pushInFlight = false
+    /// Set by `close()`: the close request follows the last push.
+    private var closeRequested = false
+    /// The pull step parked on a full `rxQueue`.
+    private var pausedPull: (() -> Void)?
+    /// The pull exchange in flight, finished early by a close.
+    private var pullResponse: SudokuHTTPResponse?
+
+    private init(requester: SudokuHTTPMaskRequester, mode: SudokuHTTPMaskMode, token: String, earlyResponsePayload: Data) {
+        self.requester = requester
         self.mode = mode
-        self.earlyRequestPayload = earlyRequestPayload?.isEmpty == false ? earlyRequestPayload : nil
-        try authorize()
-        DispatchQueue.global(qos: .userInitiated).async { self.pullLoop() }
-        DispatchQueue.global(qos: .userInitiated).async { self.pushLoop() }
+        self.earlyResponsePayload = earlyResponsePayload
+        let pathRoot = requester.config.httpMask.pathRoot
+        let streamPath = SudokuHTTPMaskPathRoot.apply(pathRoot, to: "/stream")
+        let uploadPath = SudokuHTTPMaskPathRoot.apply(pathRoot, to: "/api/v1/upload")
+        pullPath = "\(streamPath)?token=\(token)"
+        pushPath = "\(uploadPath)?token=\(token)"
+        closePath = "\(pushPath)&close=1"
     }
 
+    /// Authorizes a session, carrying the early handshake when there is one, and starts
+    /// its pull loop.
+    static func open(
+        config: SudokuNativeConfig,
+        factory: SudokuConnectionFactory,
+        mode: SudokuHTTPMaskMode,
+        earlyRequestPayload: Data? = nil,
+        completion: @escaping (Result<SudokuHTTPMaskTransport, Error>) -> Void
+    ) {
+        let requester = SudokuHTTPMaskRequester(config: config, factory: factory, modeName: mode == .poll ? "poll" : "stream")
+        let sessionPath = SudokuHTTPMaskPathRoot.apply(config.httpMask.pathRoot, to: "/session")
+        let early = earlyRequestPayload?.isEmpty == false ? earlyRequestPayload : nil
+        requester.perform(method: "GET", requestPath: appendEarlyData(sessionPath, payload: early), authPath: "/session", body: Data()) { result in
+            let response: SudokuHTTPResponse
+            switch result {
+            case .failure(let error): completion(.failure(error)); return
+            case .success(let value): response = value
+            }
+            guard response.status == 200 else {
+                response.finish()
+                completion(.failure(SudokuNativeError.connectionFailed("HTTPMask authorize status \(response.status)")))
+                return
+            }
+            response.readAll(limit: 4096) { body in
+                response.finish()
+                do {
+                    let session = try SudokuHTTPMaskTransport.parseSession(try body.get())
+                    let transport = SudokuHTTPMaskTransport(
+                        requester: requester,
+                        mode: mode,
+                        token: session.token,
+                        earlyResponsePayload: session.earlyResponse
+                    )
+                    transport.schedulePull()
+                    completion(.success(transport))
+                } catch {
+                    completion(.failure(error))
+                }
+            }
+        }
+    }
+
+    private static func parseSession(_ body: Data) throws -> (token: String, earlyResponse: Data) {
+        guard let text = String(data: body, encoding: .utf8), let range = text.range(of: "token=") else {
+            throw SudokuNativeError.connectionFailed("HTTPMask authorize missing token")
+        }
+        let tail = text[range.upperBound...]
+        let token = String(tail.prefix { $0.isLetter || $0.isNumber || $0 == "-" || $0 == "_" })
+        guard !token.isEmpty else { throw SudokuNativeError.connectionFailed("HTTPMask empty token") }
+        var earlyResponse = Data()
+        for line in text.split(whereSeparator: \.isNewline) {
+            let trimmed = line.trimmingCharacters(in: .whitespacesAndNewlines)
+            guard trimmed.hasPrefix("ed=") else { continue }
+            let encoded = String(trimmed.dropFirst(3))
+            if let decoded = Data(base64URLEncoded: encoded) {
+                earlyResponse = decoded
+            }
+            break
+        }
+        return (token, earlyResponse)
+    }
+
+    private static func appendEarlyData(_ path: String, payload: Data?) -> String {
+        guard let payload, !payload.isEmpty else { return path }
+        let encoded = payload.base64URLEncodedString()
+        return path + (path.contains("?") ? "&" : "?") + "ed=\(encoded)"
+    }
+
+    // MARK: Send
+
+    /// Blocks while the send queue is full; the mux writer only.
     func send(_ data: Data) throws {
         condition.lock()
-        defer { condition.unlock() }
-        if closed { throw SudokuNativeError.closed }
+        if closed { condition.unlock(); throw SudokuNativeError.closed }
         let queueLimit = max(sudokuHTTPMaskMaxQueueBytes, data.count)
         while txQueue.count + data.count > queueLimit && !closed {
             condition.wait()
         }
-        if closed { throw SudokuNativeError.closed }
+        if closed { condition.unlock(); throw SudokuNativeError.closed }
         txQueue.append(data)
-        condition.signal()
+        condition.unlock()
+        kickPush()
+    }
+
+    /// Completes once `data` is queued for a push; a full queue defers the completion.
+    func sendAsync(_ data: Data, completion: @escaping (Error?) -> Void) {
+        condition.lock()
+        if closed {
+            condition.unlock()
+            completion(SudokuNativeError.closed)
+            return
+        }
+        if pendingSends.isEmpty, txQueue.count + data.count <= max(sudokuHTTPMaskMaxQueueBytes, data.count) {
+            txQueue.append(data)
+            condition.unlock()
+            completion(nil)
+        } else {
+            pendingSends.append((data, completion))
+            condition.unlock()
+        }
+        kickPush()
     }
 
+    /// Starts the next push unless one is in flight. Queued bytes still go out after a
+    /// graceful close, and the close request goes once they have.
+    private func kickPush() {
+        condition.lock()
+        guard !pushInFlight, !fatal else {
+            condition.unlock()
+            return
+        }
+        if txQueue.isEmpty {
+            let sendClose = closed && closeRequested
+            closeRequested = false
+            condition.unlock()
+            if sendClose { postClose() }
+            return
+        }
+        pushInFlight = true
+        let batch = txQueue.read(max: mode == .poll ? 49_152 : 262_144)
+        if txQueue.isEmpty { txQueue.removeAll(keepingCapacity: false) }
+        var admitted: [(Error?) -> Void] = []
+        while let next = pendingSends.first,
+              txQueue.count + next.data.count <= max(sudokuHTTPMaskMaxQueueBytes, next.data.count) {
+            pendingSends.removeFirst()
+            txQueue.append(next.data)
+            admitted.append(next.completion)
+        }
+        condition.broadcast()
+        condition.unlock()
+        for completion in admitted { completion(nil) }
+        push(batch)
+    }
+
+    private func push(_ batch: Data) {
+        let body: Data
+        let contentType: String
+        if mode == .poll {
+            var encoded = Data(batch.base64EncodedString().utf8)
+            encoded.append(0x0a)
+            body = encoded
+            contentType = "text/plain"
+        } else {
+            body = batch
+            contentType = "application/octet-stream"
+        }
+        requester.perform(method: "POST", requestPath: pushPath, authPath: "/api/v1/upload", contentType: contentType, body: body) { [self] result in
+            guard case .success(let response) = result else {
+                markClosed(fatal: true)
+                return
+            }
+            response.readAll(limit: 256) { [self] drained in
+                response.finish()
+                guard case .success = drained, response.status == 200 else {
+                    markClosed(fatal: true)
+                    return
+                }
+                condition.lock()
+                pushInFlight = false
+                condition.unlock()
+                kickPush()
+            }
+        }
+    }
+
+    // MARK: Receive
+
+    /// Blocks until data arrives; the mux reader only.
     func receive(max: Int) throws -> Data {
         condition.lock()
-        defer { condition.unlock() }
         while rxQueue.isEmpty && !closed { condition.wait() }
-        if rxQueue.isEmpty && closed { throw fatal ? SudokuNativeError.connectionFailed("HTTPMask closed") : SudokuNativeError.closed }
+        if rxQueue.isEmpty && closed {
+            let error: Error = fatal ? SudokuNativeError.connectionFailed("HTTPMask closed") : SudokuNativeError.closed
+            condition.unlock()
+            throw error
+        }
         let out = rxQueue.read(max: max)
         if rxQueue.isEmpty { rxQueue.removeAll(keepingCapacity: false) }
-        condition.signal()
+        let resume = takePausedPullLocked()
+        condition.unlock()
+        resume?()
         return out
     }
-    
+
     func receiveAsync(max: Int, completion: @escaping (Data?, Error?) -> Void) {
         var deliver: (() -> Void)?
+        var resume: (() -> Void)?
         condition.lock()
         if !rxQueue.isEmpty {
             let out = rxQueue.read(max: max)
             if rxQueue.isEmpty { rxQueue.removeAll(keepingCapacity: false) }
-            condition.signal()
+            resume = takePausedPullLocked()
             deliver = { completion(out, nil) }
         } else if closed {
             let error: Error = fatal ? SudokuNativeError.connectionFailed("HTTPMask closed") : SudokuNativeError.closed
@@ -1020,229 +1488,183 @@ nonisolated final class SudokuHTTPMaskTransport {
             pendingReceive = completion
         }
         condition.unlock()
+        resume?()
         deliver?()
     }
 
-    func close() {
-        markClosed(fatal: false)
-        if !closePath.isEmpty, let opened = try? request(method: "POST", requestPath: closePath, authPath: "/api/v1/upload", body: Data()) {
-            _ = try? opened.body.readAll(limit: 256)
-        }
-    }
-
-    private var hostHeader: String {
-        let host = config.httpMask.host.isEmpty ? config.serverHost : config.httpMask.host
-        if (config.httpMask.tls && config.serverPort == 443) || (!config.httpMask.tls && config.serverPort == 80) { return host }
-        return "\(host):\(config.serverPort)"
-    }
-
-    private func applyPathRoot(_ path: String) -> String {
-        SudokuHTTPMaskPathRoot.apply(config.httpMask.pathRoot, to: path)
-    }
-
-    private func authToken(mode: String, method: String, path: String) -> String {
-        SudokuHTTPMaskAuth.token(key: config.key, mode: mode, method: method, path: path)
-    }
-
-    private func appendAuth(_ path: String, token: String) -> String {
-        path + (path.contains("?") ? "&" : "?") + "auth=\(token)"
+    private func takePausedPullLocked() -> (() -> Void)? {
+        guard rxQueue.count < sudokuHTTPMaskMaxQueueBytes, let paused = pausedPull else { return nil }
+        pausedPull = nil
+        return paused
     }
 
-    private func appendEarlyData(_ path: String, payload: Data?) -> String {
-        guard let payload, !payload.isEmpty else { return path }
-        let encoded = payload.base64URLEncodedString()
-        return path + (path.contains("?") ? "&" : "?") + "ed=\(encoded)"
-    }
+    // MARK: Pull
 
-    private func request(method: String, requestPath: String, authPath: String, contentType: String? = nil, body: Data) throws -> (stream: BlockingProxyStream, body: SudokuHTTPBodyReader) {
-        let stream = try factory.open(host: config.serverHost, port: config.serverPort, useTLS: config.httpMask.tls, serverName: config.httpMask.host.isEmpty ? config.serverHost : config.httpMask.host)
-        let modeName = mode == .poll ? "poll" : "stream"
-        let auth = authToken(mode: modeName, method: method, path: authPath)
-        let path = appendAuth(requestPath, token: auth)
-        var requestHead = "\(method) \(path) HTTP/1.1\r\nHost: \(hostHeader)\r\nUser-Agent: \(ProxyUserAgent.chrome)\r\nAccept: */*\r\nCache-Control: no-cache\r\nPragma: no-cache\r\nConnection: close\r\nX-Sudoku-Tunnel: \(modeName)\r\nAuthorization: Bearer \(auth)\r\n"
-        if let contentType { requestHead += "Content-Type: \(contentType)\r\n" }
-        requestHead += "Content-Length: \(body.count)\r\n\r\n"
-        var data = Data(requestHead.utf8)
-        data.append(body)
-        try stream.sendAll(data)
-        let reader = try readHeaders(stream: stream)
-        return (stream, reader)
+    private func schedulePull(after delay: TimeInterval = 0) {
+        if delay > 0 {
+            queue.asyncAfter(deadline: .now() + delay) { [self] in pull() }
+        } else {
+            queue.async { [self] in pull() }
+        }
     }
 
-    private func readHeaders(stream: BlockingProxyStream) throws -> SudokuHTTPBodyReader {
-        func line() throws -> String {
-            var data = Data()
-            while true {
-                let b = try stream.readExact(1)[0]
-                if b == 0x0a { break }
-                if b != 0x0d { data.append(b) }
+    private func pull() {
+        if isClosed { return }
+        requester.perform(method: "GET", requestPath: pullPath, authPath: "/stream", body: Data()) { [self] result in
+            let response: SudokuHTTPResponse
+            switch result {
+            case .failure: markClosed(fatal: true); return
+            case .success(let value): response = value
             }
-            return String(data: data, encoding: .utf8) ?? ""
-        }
-        let statusLine = try line()
-        let parts = statusLine.split(separator: " ")
-        guard parts.count >= 2, let status = Int(parts[1]) else { throw SudokuNativeError.protocolError("bad HTTP response") }
-        var chunked = false
-        var contentLength: Int?
-        while true {
-            let header = try line()
-            if header.isEmpty { break }
-            let lower = header.lowercased()
-            if lower.hasPrefix("transfer-encoding:") && lower.contains("chunked") { chunked = true }
-            if lower.hasPrefix("content-length:"), let value = Int(header.split(separator: ":", maxSplits: 1)[1].trimmingCharacters(in: .whitespaces)) { contentLength = value }
+            guard response.status == 200 else {
+                response.finish()
+                markClosed(fatal: true)
+                return
+            }
+            guard track(response) else {
+                response.finish()
+                return
+            }
+            readPull(response, sawAny: false, pollLine: Data())
         }
-        return SudokuHTTPBodyReader(stream: stream, status: status, chunked: chunked, contentLength: contentLength)
     }
 
-    private func authorize() throws {
-        let sessionPath = applyPathRoot("/session")
-        let opened = try request(method: "GET", requestPath: appendEarlyData(sessionPath, payload: earlyRequestPayload), authPath: "/session", body: Data())
-        guard opened.body.status == 200 else { throw SudokuNativeError.connectionFailed("HTTPMask authorize status \(opened.body.status)") }
-        let body = try opened.body.readAll(limit: 4096)
-        guard let text = String(data: body, encoding: .utf8), let range = text.range(of: "token=") else {
-            throw SudokuNativeError.connectionFailed("HTTPMask authorize missing token")
-        }
-        let tail = text[range.upperBound...]
-        token = String(tail.prefix { $0.isLetter || $0.isNumber || $0 == "-" || $0 == "_" })
-        guard !token.isEmpty else { throw SudokuNativeError.connectionFailed("HTTPMask empty token") }
-        for line in text.split(whereSeparator: \.isNewline) {
-            let trimmed = line.trimmingCharacters(in: .whitespacesAndNewlines)
-            guard trimmed.hasPrefix("ed=") else { continue }
-            let encoded = String(trimmed.dropFirst(3))
-            if let decoded = Data(base64URLEncoded: encoded) {
-                earlyResponsePayload = decoded
+    private func readPull(_ response: SudokuHTTPResponse, sawAny: Bool, pollLine: Data) {
+        response.readChunk(max: 32 * 1024) { [self] result in
+            let data: Data
+            switch result {
+            case .failure:
+                response.finish()
+                markClosed(fatal: true)
+                return
+            case .success(let value): data = value
+            }
+            if data.isEmpty {
+                response.finish()
+                condition.lock()
+                pullResponse = nil
+                condition.unlock()
+                schedulePull(after: sawAny ? 0 : 0.025)
+                return
+            }
+            var line = pollLine
+            var payload = data
+            if mode == .poll {
+                payload = Data()
+                for byte in data where byte != 0x0d {
+                    if byte == 0x0a {
+                        if !line.isEmpty {
+                            if let decoded = Data(base64Encoded: String(data: line, encoding: .ascii) ?? "") { payload.append(decoded) }
+                            line.removeAll()
+                        }
+                    } else {
+                        line.append(byte)
+                        if line.count > sudokuHTTPMaskMaxPollLineBytes {
+                            response.finish()
+                            markClosed(fatal: true)
+                            return
+                        }
+                    }
+                }
+            }
+            let nextLine = line
+            enqueueRX(payload) { [self] in
+                queue.async { [self] in readPull(response, sawAny: true, pollLine: nextLine) }
             }
-            break
         }
-        let streamPath = applyPathRoot("/stream")
-        let uploadPath = applyPathRoot("/api/v1/upload")
-        pullPath = "\(streamPath)?token=\(token)"
-        pushPath = "\(uploadPath)?token=\(token)"
-        closePath = "\(pushPath)&close=1"
     }
 
-    private func markClosed(fatal: Bool) {
+    /// Hands `data` to a waiting receive or queues it, then runs `resume` unless the
+    /// queue is now full, in which case the receive that drains it does.
+    private func enqueueRX(_ data: Data, resume: @escaping () -> Void) {
         var deliver: (() -> Void)?
         condition.lock()
-        self.fatal = self.fatal || fatal
-        closed = true
-        if let pending = pendingReceive {
-            pendingReceive = nil
-            let error: Error = self.fatal ? SudokuNativeError.connectionFailed("HTTPMask closed") : SudokuNativeError.closed
-            deliver = { pending(nil, error) }
+        if closed { condition.unlock(); return }
+        if !data.isEmpty {
+            if let pending = pendingReceive {
+                pendingReceive = nil
+                let out: Data
+                if data.count <= pendingMax {
+                    out = data
+                } else {
+                    out = data.prefixData(pendingMax)
+                    rxQueue.append(data, from: pendingMax)
+                }
+                deliver = { pending(out, nil) }
+            } else {
+                rxQueue.append(data)
+                condition.signal()
+            }
         }
-        condition.broadcast()
+        let full = rxQueue.count >= sudokuHTTPMaskMaxQueueBytes
+        if full { pausedPull = resume }
         condition.unlock()
         deliver?()
+        if !full { resume() }
     }
 
-    private func pullLoop() {
-        while true {
-            condition.lock(); let shouldStop = closed; condition.unlock()
-            if shouldStop { return }
-            do {
-                let opened = try request(method: "GET", requestPath: pullPath, authPath: "/stream", body: Data())
-                guard opened.body.status == 200 else { throw SudokuNativeError.connectionFailed("HTTPMask pull status \(opened.body.status)") }
-                var sawAny = false
-                var pollLine = Data()
-                while true {
-                    let data = try opened.body.readSome()
-                    if data.isEmpty { break }
-                    sawAny = true
-                    if mode == .poll {
-                        for byte in data where byte != 0x0d {
-                            if byte == 0x0a {
-                                if !pollLine.isEmpty {
-                                    if let decoded = Data(base64Encoded: String(data: pollLine, encoding: .ascii) ?? "") { enqueueRX(decoded) }
-                                    pollLine.removeAll()
-                                }
-                            } else {
-                                pollLine.append(byte)
-                                if pollLine.count > sudokuHTTPMaskMaxPollLineBytes {
-                                    throw SudokuNativeError.protocolError("HTTPMask poll line too long")
-                                }
-                            }
-                        }
-                    } else {
-                        enqueueRX(data)
-                    }
-                }
-                if !sawAny { usleep(25_000) }
-            } catch {
-                markClosed(fatal: true)
-                return
-            }
+    // MARK: Close
+
+    func close() {
+        markClosed(fatal: false)
+        condition.lock()
+        closeRequested = true
+        condition.unlock()
+        kickPush()
+    }
+
+    private func postClose() {
+        requester.perform(method: "POST", requestPath: closePath, authPath: "/api/v1/upload", body: Data()) { result in
+            guard case .success(let response) = result else { return }
+            response.readAll(limit: 256) { _ in response.finish() }
         }
     }
 
-    private func enqueueRX(_ data: Data) {
+    private var isClosed: Bool {
         condition.lock()
-        if !closed, let pending = pendingReceive {
-            pendingReceive = nil
-            let out: Data
-            if data.count <= pendingMax {
-                out = data
-            } else {
-                out = data.prefixData(pendingMax)
-                rxQueue.append(data, from: pendingMax)
-            }
+        defer { condition.unlock() }
+        return closed
+    }
+
+    /// Records `response` as the pull's exchange; false once closed.
+    private func track(_ response: SudokuHTTPResponse) -> Bool {
+        condition.lock()
+        defer { condition.unlock() }
+        guard !closed else { return false }
+        pullResponse = response
+        return true
+    }
+
+    private func markClosed(fatal: Bool) {
+        var deliver: (() -> Void)?
+        condition.lock()
+        guard !closed else {
             condition.unlock()
-            pending(out, nil)
             return
         }
-        let queueLimit = max(sudokuHTTPMaskMaxQueueBytes, data.count)
-        while rxQueue.count + data.count > queueLimit && !closed {
-            condition.wait()
-        }
-        if !closed {
-            rxQueue.append(data)
-            condition.signal()
+        self.fatal = fatal
+        closed = true
+        let error: Error = fatal ? SudokuNativeError.connectionFailed("HTTPMask closed") : SudokuNativeError.closed
+        if let pending = pendingReceive {
+            pendingReceive = nil
+            deliver = { pending(nil, error) }
         }
+        let sends = pendingSends
+        pendingSends.removeAll()
+        pausedPull = nil
+        let pull = pullResponse
+        pullResponse = nil
+        condition.broadcast()
         condition.unlock()
-    }
-
-    private func pushLoop() {
-        let maxBatchBytes = mode == .poll ? 49_152 : 262_144
-        while true {
-            let batch: Data
-            condition.lock()
-            while txQueue.isEmpty && !closed {
-                condition.wait(until: Date().addingTimeInterval(0.005))
-                if !txQueue.isEmpty || closed { break }
-            }
-            if txQueue.isEmpty && closed { condition.unlock(); return }
-            let n = min(maxBatchBytes, txQueue.count)
-            batch = txQueue.read(max: n)
-            if txQueue.isEmpty { txQueue.removeAll(keepingCapacity: false) }
-            condition.signal()
-            condition.unlock()
-
-            do {
-                let body: Data
-                let contentType: String
-                if mode == .poll {
-                    var encoded = Data(batch.base64EncodedString().utf8)
-                    encoded.append(0x0a)
-                    body = encoded
-                    contentType = "text/plain"
-                } else {
-                    body = batch
-                    contentType = "application/octet-stream"
-                }
-                let opened = try request(method: "POST", requestPath: pushPath, authPath: "/api/v1/upload", contentType: contentType, body: body)
-                _ = try opened.body.readAll(limit: 256)
-                guard opened.body.status == 200 else { throw SudokuNativeError.connectionFailed("HTTPMask push status \(opened.body.status)") }
-            } catch {
-                markClosed(fatal: true)
-                return
-            }
-        }
+        deliver?()
+        for send in sends { send.completion(SudokuNativeError.closed) }
+        pull?.finish()
     }
 }
 
 nonisolated final class SudokuObfsTransport {
     enum Wire {
-        case stream(BlockingProxyStream)
+        case stream(SudokuProxyStream)
         case httpMask(SudokuHTTPMaskTransport)
     }
 
@@ -1275,6 +1697,18 @@ nonisolated final class SudokuObfsTransport {
         }
     }
 
+    /// Encodes under `writeLock` and issues the write outside it, so a completion that
+    /// runs inline may send again. Callers keep sends serial, which keeps them in order.
+    func sendAsync(_ data: Data, completion: @escaping (Error?) -> Void) {
+        let encoded = writeLock.withLock {
+            tables.withUplink { $0.encode(data, rng: &rng, paddingThreshold: threshold) }
+        }
+        switch wire {
+        case .stream(let stream): stream.send(encoded, completion: completion)
+        case .httpMask(let mask): mask.sendAsync(encoded, completion: completion)
+        }
+    }
+
     func receive(max: Int) throws -> Data {
         try readLock.withLock {
             guard max > 0 else { return Data() }
@@ -1437,33 +1871,49 @@ nonisolated final class SudokuRecordStream {
 
     func send(_ data: Data) throws {
         if data.isEmpty { return }
-        try writeLock.withLock {
-            if method == .none {
-                try transport.send(data)
-                return
-            }
-            var offset = 0
-            while offset < data.count {
-                let maxPlain = 65535 - 12 - 16
-                let count = min(maxPlain, data.count - offset)
-                let chunk = data.rangeData(offset: offset, count: count)
-                var header = Data()
-                var epochBE = sendEpoch.bigEndian
-                var seqBE = sendSeq.bigEndian
-                header.append(Data(bytes: &epochBE, count: 4))
-                header.append(Data(bytes: &seqBE, count: 8))
-                sendSeq &+= 1
-                let key = SudokuNativeCrypto.recordEpochKey(base: baseSend, method: method, epoch: sendEpoch)
-                let cipher = try SudokuNativeCrypto.seal(method: method, key: key, nonce: header, plaintext: chunk, aad: header)
-                var bodyLen = UInt16(header.count + cipher.count).bigEndian
-                var frame = Data(bytes: &bodyLen, count: 2)
-                frame.append(header)
-                frame.append(cipher)
-                try transport.send(frame)
-                offset += count
-                try maybeBumpSendEpoch(added: count)
-            }
+        try writeLock.withLock { try transport.send(try sealLocked(data)) }
+    }
+
+    /// Seals under `writeLock` and writes outside it; callers keep sends serial.
+    func sendAsync(_ data: Data, completion: @escaping (Error?) -> Void) {
+        if data.isEmpty { completion(nil); return }
+        let sealed: Data
+        do {
+            sealed = try writeLock.withLock { try sealLocked(data) }
+        } catch {
+            completion(error)
+            return
+        }
+        transport.sendAsync(sealed, completion: completion)
+    }
+
+    /// `data` as consecutive record frames, or unchanged for `.none`. Caller must hold
+    /// `writeLock`.
+    private func sealLocked(_ data: Data) throws -> Data {
+        if method == .none { return data }
+        var out = Data()
+        var offset = 0
+        while offset < data.count {
+            let maxPlain = 65535 - 12 - 16
+            let count = min(maxPlain, data.count - offset)
+            let chunk = data.rangeData(offset: offset, count: count)
+            var header = Data()
+            var epochBE = sendEpoch.bigEndian
+            var seqBE = sendSeq.bigEndian
+            header.append(Data(bytes: &epochBE, count: 4))
+            header.append(Data(bytes: &seqBE, count: 8))
+            sendSeq &+= 1
+            let key = SudokuNativeCrypto.recordEpochKey(base: baseSend, method: method, epoch: sendEpoch)
+            let cipher = try SudokuNativeCrypto.seal(method: method, key: key, nonce: header, plaintext: chunk, aad: header)
+            var bodyLen = UInt16(header.count + cipher.count).bigEndian
+            var frame = Data(bytes: &bodyLen, count: 2)
+            frame.append(header)
+            frame.append(cipher)
+            out.append(frame)
+            offset += count
+            try maybeBumpSendEpoch(added: count)
         }
+        return out
     }
 
     func receive(max: Int) throws -> Data {
@@ -1582,7 +2032,7 @@ nonisolated final class SudokuRecordStream {
         return plain
     }
 
-    private static func mapTruncation(_ error: Error, what: String) -> Error {
+    fileprivate static func mapTruncation(_ error: Error, what: String) -> Error {
         if case SudokuNativeError.closed = error { return SudokuNativeError.protocolError("truncated \(what)") }
         return error
     }
@@ -1618,68 +2068,144 @@ nonisolated final class SudokuNativeClient {
 
     var shouldUseNativeMux: Bool { config.nativeMuxEnabled }
 
-    func openTCP(host: String, port: UInt16) throws -> SudokuRecordStream {
-        let record = try connectBase()
-        try writeKIP(record: record, type: 0x10, payload: SudokuAddress.encode(host: host, port: port))
-        return record
+    func openTCP(host: String, port: UInt16, completion: @escaping (Result<SudokuRecordStream, Error>) -> Void) {
+        let address: Data
+        do {
+            address = try SudokuAddress.encode(host: host, port: port)
+        } catch {
+            completion(.failure(error))
+            return
+        }
+        open(type: 0x10, payload: address, completion: completion)
+    }
+
+    func openUoT(completion: @escaping (Result<SudokuRecordStream, Error>) -> Void) {
+        open(type: 0x12, payload: Data(), completion: completion)
     }
 
-    func openUoT() throws -> SudokuRecordStream {
-        let record = try connectBase()
-        try writeKIP(record: record, type: 0x12, payload: Data())
-        return record
+    func openMux(completion: @escaping (Result<SudokuMuxClient, Error>) -> Void) {
+        open(type: 0x11, payload: Data()) { result in
+            completion(result.map { SudokuMuxClient(record: $0) })
+        }
     }
 
-    func openMux() throws -> SudokuMuxClient {
-        let record = try connectBase()
-        try writeKIP(record: record, type: 0x11, payload: Data())
-        return SudokuMuxClient(record: record)
+    /// Connects and announces what the session carries.
+    private func open(type: UInt8, payload: Data, completion: @escaping (Result<SudokuRecordStream, Error>) -> Void) {
+        connectBase { result in
+            switch result {
+            case .failure(let error):
+                completion(.failure(error))
+            case .success(let record):
+                self.writeKIP(record: record, type: type, payload: payload) { error in
+                    if let error {
+                        record.close()
+                        completion(.failure(error))
+                    } else {
+                        completion(.success(record))
+                    }
+                }
+            }
+        }
     }
 
-    private func connectBase() throws -> SudokuRecordStream {
-        let wire: SudokuObfsTransport.Wire
+    private func connectBase(completion: @escaping (Result<SudokuRecordStream, Error>) -> Void) {
         if !config.httpMask.disable && config.httpMask.mode == .ws {
-            wire = .stream(try openHTTPMaskWebSocket())
+            openHTTPMaskWebSocket { result in
+                switch result {
+                case .failure(let error): completion(.failure(error))
+                case .success(let stream): self.startSession(wire: .stream(stream), completion: completion)
+                }
+            }
         } else if !config.httpMask.disable && [SudokuHTTPMaskMode.stream, .poll, .auto].contains(config.httpMask.mode) {
-            let early = try buildEarlyHandshakePayload()
-            let mask: SudokuHTTPMaskTransport
-            if config.httpMask.mode == .poll {
-                mask = try SudokuHTTPMaskTransport(config: config, factory: factory, mode: .poll, earlyRequestPayload: early.request)
-            } else if config.httpMask.mode == .stream {
-                mask = try SudokuHTTPMaskTransport(config: config, factory: factory, mode: .stream, earlyRequestPayload: early.request)
-            } else {
+            let early: (request: Data, state: SudokuKIPClientState)
+            do {
+                early = try buildEarlyHandshakePayload()
+            } catch {
+                completion(.failure(error))
+                return
+            }
+            openHTTPMask(earlyRequestPayload: early.request) { result in
+                let mask: SudokuHTTPMaskTransport
+                switch result {
+                case .failure(let error): completion(.failure(error)); return
+                case .success(let opened): mask = opened
+                }
+                guard !mask.earlyResponsePayload.isEmpty else {
+                    self.startSession(wire: .httpMask(mask), completion: completion)
+                    return
+                }
                 do {
-                    mask = try SudokuHTTPMaskTransport(config: config, factory: factory, mode: .stream, earlyRequestPayload: early.request)
+                    let transport = try SudokuObfsTransport(wire: .httpMask(mask), tables: self.tables, config: self.config)
+                    let session = try self.completeEarlyHandshake(state: early.state, response: mask.earlyResponsePayload)
+                    completion(.success(try SudokuRecordStream(transport: transport, method: self.config.aeadMethod, baseSend: session.c2s, baseRecv: session.s2c)))
                 } catch {
-                    mask = try SudokuHTTPMaskTransport(config: config, factory: factory, mode: .poll, earlyRequestPayload: early.request)
+                    mask.close()
+                    completion(.failure(error))
                 }
             }
-            wire = .httpMask(mask)
-            let transport = try SudokuObfsTransport(wire: wire, tables: tables, config: config)
-            if !mask.earlyResponsePayload.isEmpty {
-                let session = try completeEarlyHandshake(state: early.state, response: mask.earlyResponsePayload)
-                return try SudokuRecordStream(transport: transport, method: config.aeadMethod, baseSend: session.c2s, baseRecv: session.s2c)
-            }
-            let bases = SudokuNativeCrypto.pskBases(config.key)
-            let record = try SudokuRecordStream(transport: transport, method: config.aeadMethod, baseSend: bases.c2s, baseRecv: bases.s2c)
-            try performKIP(record: record)
-            return record
         } else {
-            let stream = try factory.open(host: config.serverHost, port: config.serverPort, useTLS: false, serverName: nil)
-            if !config.httpMask.disable && config.httpMask.mode == .legacy {
-                let path = SudokuHTTPMaskPathRoot.apply(config.httpMask.pathRoot, to: "/api")
-                let host = config.httpMask.host.isEmpty ? config.serverHost : config.httpMask.host
+            factory.open(host: config.serverHost, port: config.serverPort, useTLS: false, serverName: nil) { result in
+                let stream: SudokuProxyStream
+                switch result {
+                case .failure(let error): completion(.failure(error)); return
+                case .success(let opened): stream = opened
+                }
+                guard !self.config.httpMask.disable && self.config.httpMask.mode == .legacy else {
+                    self.startSession(wire: .stream(stream), completion: completion)
+                    return
+                }
+                let path = SudokuHTTPMaskPathRoot.apply(self.config.httpMask.pathRoot, to: "/api")
+                let host = self.config.httpMask.host.isEmpty ? self.config.serverHost : self.config.httpMask.host
                 let request = "POST \(path) HTTP/1.1\r\nHost: \(host)\r\nUser-Agent: Mozilla/5.0\r\nAccept: */*\r\nConnection: keep-alive\r\nContent-Type: application/octet-stream\r\nContent-Length: 1048576\r\n\r\n"
-                try stream.sendAll(Data(request.utf8))
+                stream.send(Data(request.utf8)) { error in
+                    if let error {
+                        self.factory.release(stream)
+                        completion(.failure(error))
+                        return
+                    }
+                    self.startSession(wire: .stream(stream), completion: completion)
+                }
             }
-            wire = .stream(stream)
         }
+    }
 
-        let transport = try SudokuObfsTransport(wire: wire, tables: tables, config: config)
-        let bases = SudokuNativeCrypto.pskBases(config.key)
-        let record = try SudokuRecordStream(transport: transport, method: config.aeadMethod, baseSend: bases.c2s, baseRecv: bases.s2c)
-        try performKIP(record: record)
-        return record
+    /// `auto` tries a streaming session first and falls back to polling.
+    private func openHTTPMask(earlyRequestPayload: Data, completion: @escaping (Result<SudokuHTTPMaskTransport, Error>) -> Void) {
+        let mode = config.httpMask.mode
+        guard mode == .auto else {
+            SudokuHTTPMaskTransport.open(config: config, factory: factory, mode: mode, earlyRequestPayload: earlyRequestPayload, completion: completion)
+            return
+        }
+        SudokuHTTPMaskTransport.open(config: config, factory: factory, mode: .stream, earlyRequestPayload: earlyRequestPayload) { result in
+            guard case .failure = result else { completion(result); return }
+            SudokuHTTPMaskTransport.open(config: self.config, factory: self.factory, mode: .poll, earlyRequestPayload: earlyRequestPayload, completion: completion)
+        }
+    }
+
+    /// Layers obfuscation and PSK records over `wire` and runs the KIP handshake.
+    private func startSession(wire: SudokuObfsTransport.Wire, completion: @escaping (Result<SudokuRecordStream, Error>) -> Void) {
+        let transport: SudokuObfsTransport
+        let record: SudokuRecordStream
+        do {
+            transport = try SudokuObfsTransport(wire: wire, tables: tables, config: config)
+            let bases = SudokuNativeCrypto.pskBases(config.key)
+            record = try SudokuRecordStream(transport: transport, method: config.aeadMethod, baseSend: bases.c2s, baseRecv: bases.s2c)
+        } catch {
+            switch wire {
+            case .stream(let stream): factory.release(stream)
+            case .httpMask(let mask): mask.close()
+            }
+            completion(.failure(error))
+            return
+        }
+        performKIP(record: record) { error in
+            if let error {
+                record.close()
+                completion(.failure(error))
+            } else {
+                completion(.success(record))
+            }
+        }
     }
 
     private func buildEarlyHandshakePayload() throws -> (request: Data, state: SudokuKIPClientState) {
@@ -1760,13 +2286,13 @@ nonisolated final class SudokuNativeClient {
         return out
     }
 
-    private func openHTTPMaskWebSocket() throws -> BlockingProxyStream {
+    private func openHTTPMaskWebSocket(completion: @escaping (Result<SudokuProxyStream, Error>) -> Void) {
         let host = config.httpMask.host.isEmpty ? config.serverHost : config.httpMask.host
         let defaultPort = config.httpMask.tls ? UInt16(443) : UInt16(80)
         let hostHeader = config.serverPort == defaultPort ? host : "\(host):\(config.serverPort)"
         let auth = httpMaskAuthToken(mode: "ws", method: "GET", path: "/ws")
         let path = appendHTTPMaskAuth(applyHTTPMaskPathRoot("/ws"), token: auth)
-        return try factory.openWebSocket(
+        factory.openWebSocket(
             host: config.serverHost,
             port: config.serverPort,
             useTLS: config.httpMask.tls,
@@ -1780,7 +2306,8 @@ nonisolated final class SudokuNativeClient {
                 "Pragma": "no-cache",
                 "X-Sudoku-Tunnel": "ws",
                 "Authorization": "Bearer \(auth)"
-            ]
+            ],
+            completion: completion
         )
     }
 
@@ -1796,12 +2323,26 @@ nonisolated final class SudokuNativeClient {
         SudokuHTTPMaskAuth.token(key: config.key, mode: mode, method: method, path: path)
     }
 
-    private func performKIP(record: SudokuRecordStream) throws {
-        let (state, payload) = try makeKIPClientHelloPayload()
-        try writeKIP(record: record, type: 0x01, payload: payload)
-        let message = try readKIP(record: record)
-        let session = try finishKIP(state: state, message: message)
-        try record.rekey(send: session.c2s, recv: session.s2c)
+    private func performKIP(record: SudokuRecordStream, completion: @escaping (Error?) -> Void) {
+        let hello: (state: SudokuKIPClientState, payload: Data)
+        do {
+            hello = try makeKIPClientHelloPayload()
+        } catch {
+            completion(error)
+            return
+        }
+        writeKIP(record: record, type: 0x01, payload: hello.payload) { error in
+            if let error { completion(error); return }
+            self.readKIP(record: record) { result in
+                do {
+                    let session = try self.finishKIP(state: hello.state, message: try result.get())
+                    try record.rekey(send: session.c2s, recv: session.s2c)
+                    completion(nil)
+                } catch {
+                    completion(error)
+                }
+            }
+        }
     }
 
     private func makeKIPClientHelloPayload() throws -> (SudokuKIPClientState, Data) {
@@ -1832,8 +2373,8 @@ nonisolated final class SudokuNativeClient {
         return SudokuNativeCrypto.sessionBases(psk: config.key, shared: shared, nonce: state.nonce)
     }
 
-    private func writeKIP(record: SudokuRecordStream, type: UInt8, payload: Data) throws {
-        try record.send(encodeKIP(type: type, payload: payload))
+    private func writeKIP(record: SudokuRecordStream, type: UInt8, payload: Data, completion: @escaping (Error?) -> Void) {
+        record.sendAsync(encodeKIP(type: type, payload: payload), completion: completion)
     }
 
     private func encodeKIP(type: UInt8, payload: Data) -> Data {
@@ -1842,19 +2383,19 @@ nonisolated final class SudokuNativeClient {
         return frame
     }
 
-    private func readKIP(record: SudokuRecordStream) throws -> (type: UInt8, payload: Data) {
-        let header: Data
-        do {
-            header = try record.readExact(6)
-        } catch SudokuNativeError.closed {
-            throw SudokuNativeError.protocolError("truncated KIP header")
-        }
-        guard header[0] == 0x6b, header[1] == 0x69, header[2] == 0x70 else { throw SudokuNativeError.protocolError("bad KIP magic") }
-        let length = Int(UInt16(header[4]) << 8 | UInt16(header[5]))
-        do {
-            return (header[3], try record.readExact(length))
-        } catch SudokuNativeError.closed {
-            throw SudokuNativeError.protocolError("truncated KIP payload")
+    private func readKIP(record: SudokuRecordStream, completion: @escaping (Result<(type: UInt8, payload: Data), Error>) -> Void) {
+        record.readExactAsync(6) { header, error in
+            if let error { completion(.failure(SudokuRecordStream.mapTruncation(error, what: "KIP header"))); return }
+            guard let header, header.count == 6 else { completion(.failure(SudokuNativeError.protocolError("truncated KIP header"))); return }
+            guard header[0] == 0x6b, header[1] == 0x69, header[2] == 0x70 else {
+                completion(.failure(SudokuNativeError.protocolError("bad KIP magic")))
+                return
+            }
+            let length = Int(UInt16(header[4]) << 8 | UInt16(header[5]))
+            record.readExactAsync(length) { payload, error in
+                if let error { completion(.failure(SudokuRecordStream.mapTruncation(error, what: "KIP payload"))); return }
+                completion(.success((type: header[3], payload: payload ?? Data())))
+            }
         }
     }
 
@@ -2109,11 +2650,8 @@ nonisolated final class SudokuTCPProxyConnection: ProxyConnection {
 
     override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
         writeQueue.async {
-            do {
-                if self.lock.withLock({ self.closed }) { throw SudokuNativeError.closed }
-                try self.stream.send(data)
-                completion(nil)
-            } catch { completion(error) }
+            if self.lock.withLock({ self.closed }) { completion(SudokuNativeError.closed); return }
+            self.stream.sendAsync(data, completion: completion)
         }
     }
 
@@ -2243,17 +2781,21 @@ nonisolated final class SudokuUDPProxyConnection: ProxyConnection {
 
     override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
         writeQueue.async {
+            let frame: Data
             do {
                 if self.lock.withLock({ self.closed }) { throw SudokuNativeError.closed }
                 let address = try SudokuAddress.encode(host: self.destinationHost, port: self.destinationPort)
                 guard address.count <= UInt16.max else { throw SudokuNativeError.protocolError("UoT address too large") }
                 guard data.count <= UInt16.max else { throw SudokuNativeError.protocolError("UoT payload too large") }
-                var frame = Data([UInt8(address.count >> 8), UInt8(address.count & 0xff), UInt8(data.count >> 8), UInt8(data.count & 0xff)])
-                frame.append(address)
-                frame.append(data)
-                try self.stream.send(frame)
-                completion(nil)
-            } catch { completion(error) }
+                var header = Data([UInt8(address.count >> 8), UInt8(address.count & 0xff), UInt8(data.count >> 8), UInt8(data.count & 0xff)])
+                header.append(address)
+                header.append(data)
+                frame = header
+            } catch {
+                completion(error)
+                return
+            }
+            self.stream.sendAsync(frame, completion: completion)
         }
     }
 
@@ -896,6 +896,9 @@ extension TLSClient {
         )
         tlsConnection.connection = self.connection
         tlsConnection.negotiatedALPN = self.negotiatedALPN
+        if !configuration.insecureSkipVerify {
+            tlsConnection.peerCertificates = serverCertificates
+        }
         self.connection = nil
 
         if let remaining = remainingBuffer, !remaining.isEmpty {
@@ -14,6 +14,13 @@ extension TLSRecordConnection {
     // MARK: - TLS 1.2 Record Crypto
 
     func encryptTLS12Record(plaintext: Data, contentType: UInt8 = TLSContentType.applicationData) throws -> Data {
+        var record = Data(capacity: 5 + plaintext.count + 85)
+        try appendTLS12Record(plaintext: plaintext, contentType: contentType, to: &record)
+        return record
+    }
+
+    /// Seals one record onto the end of `records`.
+    func appendTLS12Record(plaintext: Data, contentType: UInt8, to records: inout Data) throws {
         seqLock.lock()
         let seqNum: UInt64
         if direction == .server {
@@ -28,53 +35,39 @@ extension TLSRecordConnection {
         let version = tlsVersion
 
         if TLSCipherSuite.isAEAD(cipherSuite) {
-            return try encryptTLS12AEAD(plaintext: plaintext, contentType: contentType, seqNum: seqNum, version: version)
+            try appendTLS12AEAD(plaintext: plaintext, contentType: contentType, seqNum: seqNum, version: version, to: &records)
         } else {
-            return try encryptTLS12CBC(plaintext: plaintext, contentType: contentType, seqNum: seqNum, version: version)
+            records.append(try encryptTLS12CBC(plaintext: plaintext, contentType: contentType, seqNum: seqNum, version: version))
         }
     }
 
-    private func encryptTLS12AEAD(plaintext: Data, contentType: UInt8, seqNum: UInt64, version: UInt16) throws -> Data {
-        let isChaCha = TLSCipherSuite.isChaCha20(cipherSuite)
-        let explicitNonceLen = isChaCha ? 0 : 8
-
-        let nonce: Data
-        let explicitNonce: Data
-        if isChaCha {
-            var n = egressIV
-            xorSeqIntoNonce(&n, seqNum: seqNum)
-            nonce = n
-            explicitNonce = Data()
-        } else {
-            var seqBytes = Data(count: 8)
-            for i in 0..<8 { seqBytes[i] = UInt8((seqNum >> ((7 - i) * 8)) & 0xFF) }
-            var n = egressIV
-            n.append(seqBytes)
-            nonce = n
-            explicitNonce = seqBytes
+    private func appendTLS12AEAD(plaintext: Data, contentType: UInt8, seqNum: UInt64, version: UInt16,
+                                 to records: inout Data) throws {
+        // ChaCha20 has no explicit nonce (RFC 7905); AES-GCM sends the
+        // sequence number as one (RFC 5288).
+        let explicitNonceLen = TLSCipherSuite.isChaCha20(cipherSuite) ? 0 : 8
+
+        let aad = Self.tls12AAD(seqNum: seqNum, contentType: contentType, version: version, length: plaintext.count)
+
+        let recordPayloadLen = explicitNonceLen + plaintext.count + 16
+        records.append(contentType)
+        records.append(UInt8(version >> 8))
+        records.append(UInt8(version & 0xFF))
+        records.append(UInt8((recordPayloadLen >> 8) & 0xFF))
+        records.append(UInt8(recordPayloadLen & 0xFF))
+        if explicitNonceLen > 0 {
+            withUnsafeBytes(of: seqNum.bigEndian) { records.append(contentsOf: $0) }
         }
+        try withUnsafeBytes(of: aad) { aad in
+            try egressCipher.seal(plaintext, counter: seqNum, aad: aad, appendingTo: &records)
+        }
+    }
 
-        var aad = Data(capacity: 13)
-        for i in 0..<8 { aad.append(UInt8((seqNum >> ((7 - i) * 8)) & 0xFF)) }
-        aad.append(contentType)
-        aad.append(UInt8(version >> 8))
-        aad.append(UInt8(version & 0xFF))
-        aad.append(UInt8((plaintext.count >> 8) & 0xFF))
-        aad.append(UInt8(plaintext.count & 0xFF))
-
-        let (ct, tag) = try sealAEAD(plaintext: plaintext, nonce: nonce, aad: aad, key: egressSymmetricKey)
-
-        let recordPayloadLen = explicitNonceLen + ct.count + tag.count
-        var record = Data(capacity: 5 + recordPayloadLen)
-        record.append(contentType)
-        record.append(UInt8(version >> 8))
-        record.append(UInt8(version & 0xFF))
-        record.append(UInt8((recordPayloadLen >> 8) & 0xFF))
-        record.append(UInt8(recordPayloadLen & 0xFF))
-        record.append(explicitNonce)
-        record.append(ct)
-        record.append(tag)
-        return record
+    /// seq_num ‖ type ‖ version ‖ length (RFC 5246 §6.2.3.3), laid out in memory in that order.
+    private static func tls12AAD(seqNum: UInt64, contentType: UInt8, version: UInt16, length: Int)
+        -> (UInt64, UInt8, UInt8, UInt8, UInt8, UInt8) {
+        (seqNum.bigEndian, contentType, UInt8(version >> 8), UInt8(version & 0xFF),
+         UInt8((length >> 8) & 0xFF), UInt8(length & 0xFF))
     }
 
     private func encryptTLS12CBC(plaintext: Data, contentType: UInt8, seqNum: UInt64, version: UInt16) throws -> Data {
@@ -165,33 +158,23 @@ extension TLSRecordConnection {
             throw TLSRecordError.ciphertextTooShort
         }
 
-        let explicitNonce = isChaCha ? Data() : Data(ciphertext.prefix(explicitNonceLen))
-        let payload = Data(ciphertext.suffix(from: ciphertext.startIndex + explicitNonceLen))
+        // Slices of the receive buffer throughout; only the sealed box copies.
+        let payload = ciphertext.suffix(from: ciphertext.startIndex + explicitNonceLen)
 
-        let nonce: Data
-        if isChaCha {
-            var n = ingressIV
-            xorSeqIntoNonce(&n, seqNum: seqNum)
-            nonce = n
-        } else {
-            var n = ingressIV
-            n.append(explicitNonce)
-            nonce = n
+        var counter = seqNum
+        if !isChaCha {
+            counter = ciphertext.prefix(explicitNonceLen).reduce(0) { $0 << 8 | UInt64($1) }
         }
 
         let plaintextLen = payload.count - 16
-        var aad = Data(capacity: 13)
-        for i in 0..<8 { aad.append(UInt8((seqNum >> ((7 - i) * 8)) & 0xFF)) }
-        aad.append(contentType)
-        aad.append(UInt8(version >> 8))
-        aad.append(UInt8(version & 0xFF))
-        aad.append(UInt8((plaintextLen >> 8) & 0xFF))
-        aad.append(UInt8(plaintextLen & 0xFF))
-
-        let ct = Data(payload.prefix(payload.count - 16))
-        let tag = Data(payload.suffix(16))
-
-        return try openAEAD(ciphertext: ct, tag: tag, nonce: nonce, aad: aad, key: ingressSymmetricKey)
+        let aad = Self.tls12AAD(seqNum: seqNum, contentType: contentType, version: version, length: plaintextLen)
+
+        let ct = payload.prefix(payload.count - 16)
+        let tag = payload.suffix(16)
+
+        return try withUnsafeBytes(of: aad) { aad in
+            try ingressCipher.open(ciphertext: ct, tag: tag, counter: counter, aad: aad)
+        }
     }
 
     private func decryptTLS12CBC(ciphertext: Data, header: Data, seqNum: UInt64) throws -> Data {
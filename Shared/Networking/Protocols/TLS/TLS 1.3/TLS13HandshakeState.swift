@@ -22,5 +22,12 @@ struct TLS13HandshakeState {
 
     var handshakeTranscript: Data?
 
+    /// The session ticket offered in the ClientHello's pre_shared_key extension.
+    var offeredTicket: TLSSessionTicketCache.Ticket?
+
+    /// Set when the ServerHello selects the offered PSK: the server authenticates with
+    /// the PSK alone, sending no Certificate or CertificateVerify.
+    var resumed = false
+
     var serverHandshakeSeqNum: UInt64 = 0
 }
@@ -152,6 +152,30 @@ struct TLS13KeyDerivation {
         )
     }
 
+    // MARK: - Resumption (RFC 8446 §4.6.1, §7.1)
+
+    /// `resumption_master_secret`, over the transcript through the client Finished.
+    func deriveResumptionMasterSecret(handshakeSecret: Data, transcript: Data) -> Data {
+        let hsKey = SymmetricKey(data: handshakeSecret)
+        let derivedHS = deriveSecret(secret: hsKey, label: "derived", messages: Data())
+        let (_, masterKey) = extract(inputKeyMaterial: Data(repeating: 0, count: hashLength), salt: derivedHS)
+        return deriveSecret(secret: masterKey, label: "res master", messages: transcript)
+    }
+
+    /// The PSK a NewSessionTicket grants: `HKDF-Expand-Label(rms, "resumption", nonce, Hash.length)`.
+    func resumptionPSK(resumptionMasterSecret: Data, ticketNonce: Data) -> Data {
+        expandLabel(secret: SymmetricKey(data: resumptionMasterSecret),
+                    label: "resumption", context: ticketNonce, length: hashLength)
+    }
+
+    /// PSK binder over the ClientHello truncated before its binders list, keyed from the
+    /// early secret's `"res binder"` key.
+    func pskBinder(psk: Data, truncatedClientHello: Data) -> Data {
+        let (_, earlyKey) = extract(inputKeyMaterial: psk, salt: Data())
+        let binderKey = deriveSecret(secret: earlyKey, label: "res binder", messages: Data())
+        return finishedPayload(trafficSecret: binderKey, transcript: truncatedClientHello)
+    }
+
     /// Advance an application traffic secret to its next generation and derive the matching
     /// AEAD key + IV, per RFC 8446 §7.2:
     ///   application_traffic_secret_N+1 = HKDF-Expand-Label(secret_N, "traffic upd", "", Hash.length)
@@ -56,7 +56,11 @@ extension TLSClient {
             transcript.append(effectiveClientHello)
             transcript.append(serverHello)
 
-            let (handshakeSecret, keys) = tls13.keyDerivation!.deriveHandshakeKeys(sharedSecret: sharedSecretData, transcript: transcript)
+            let (handshakeSecret, keys) = tls13.keyDerivation!.deriveHandshakeKeys(
+                sharedSecret: sharedSecretData,
+                transcript: transcript,
+                psk: tls13.resumed ? tls13.offeredTicket?.psk : nil
+            )
             tls13.handshakeSecret = handshakeSecret
             tls13.handshakeKeys = keys
             tls13.handshakeTranscript = transcript
@@ -186,6 +190,11 @@ extension TLSClient {
                                 self.negotiatedALPN = alpn
                             }
 
+                        case TLSHandshakeType.certificate where tls13.resumed,
+                             TLSHandshakeType.compressedCertificate where tls13.resumed:
+                            completion(.failure(TLSError.handshakeFailed("Certificate in a PSK-resumed handshake")))
+                            return
+
                         case TLSHandshakeType.certificate:
                             fullTranscript.append(hsMessage)
                             parseTLS13CertificateMessage(hsBody)
@@ -252,10 +261,31 @@ extension TLSClient {
             // the intended server. Surface the rejection (with any retry configs)
             // rather than validating the wrong certificate.
             if let ech = echContext, ech.rejected {
+                // A DNS-sourced config is stale: keep the server's retry_configs for the
+                // next dial, but only once the outer handshake authenticates as the cover
+                // name (RFC 9849 §6.1.6), so an on-path box can't plant its own key.
+                if let retryConfigList = ech.retryConfigList,
+                   configuration.echIsOpportunistic,
+                   !serverCertificates.isEmpty,
+                   case .trusted = CertificatePolicy.verify(chain: serverCertificates, serverName: ech.config.publicName),
+                   let transcript = transcriptBeforeCertVerify,
+                   let signature = certificateVerifySignature,
+                   (try? verifyCertificateVerify(transcript: transcript,
+                                                 algorithm: certificateVerifyAlgorithm,
+                                                 signature: signature)) != nil {
+                    DNSResolver.shared.storeECHRetryConfigs(retryConfigList, for: configuration.serverName)
+                }
                 completion(.failure(TLSError.echRejected(retryConfigList: ech.retryConfigList)))
                 return
             }
 
+            // The PSK authenticates the server: its Finished verified above under keys only
+            // the ticket holder and the original server can derive.
+            if tls13.resumed {
+                finishTLS13Handshake(fullTranscript: fullTranscript, completion: completion)
+                return
+            }
+
             validateCertificate { [weak self] result in
                 guard let self else { return }
 
@@ -417,7 +447,11 @@ extension TLSClient {
             )
             tlsConnection.connection = self.connection
             tlsConnection.negotiatedALPN = self.negotiatedALPN
+            if !self.configuration.insecureSkipVerify {
+                tlsConnection.peerCertificates = self.serverCertificates
+            }
             self.connection = nil
+            self.installSessionTicketHandler(on: tlsConnection, fullTranscript: fullTranscript)
 
             if let remaining = self.postHandshakeBuffer, !remaining.isEmpty {
                 tlsConnection.prependToReceiveBuffer(remaining)
@@ -428,15 +462,33 @@ extension TLSClient {
         }
     }
 
-    private func sendTLS13ClientFinished(completion: @escaping (Error?) -> Void) {
-        guard let keys = tls13.handshakeKeys,
-              let transcript = tls13.handshakeTranscript,
-              let kd = tls13.keyDerivation else {
-            completion(TLSError.handshakeFailed("Missing handshake keys"))
-            return
+    /// Routes the server's NewSessionTickets into ``TLSSessionTicketCache``. Skipped under ECH,
+    /// whose hellos never offer a PSK.
+    private func installSessionTicketHandler(on tlsConnection: TLSRecordConnection, fullTranscript: Data) {
+        guard echContext == nil,
+              let key = sessionCacheKey,
+              let kd = tls13.keyDerivation,
+              let hs = tls13.handshakeSecret,
+              let finishedMsg = tls13ClientFinishedMessage() else { return }
+
+        var transcript = fullTranscript
+        transcript.append(finishedMsg)
+        let resumptionMasterSecret = kd.deriveResumptionMasterSecret(handshakeSecret: hs, transcript: transcript)
+        let cipherSuite = kd.cipherSuite
+        tlsConnection.sessionTicketHandler = { body in
+            TLSSessionTicketCache.shared.store(
+                newSessionTicket: body,
+                key: key,
+                resumptionMasterSecret: resumptionMasterSecret,
+                cipherSuite: cipherSuite
+            )
         }
+    }
 
-        var ccsRecord = Data([TLSContentType.changeCipherSpec, 0x03, 0x03, 0x00, 0x01, 0x01])
+    private func tls13ClientFinishedMessage() -> Data? {
+        guard let keys = tls13.handshakeKeys,
+              let transcript = tls13.handshakeTranscript,
+              let kd = tls13.keyDerivation else { return nil }
 
         let verifyData = kd.clientFinishedPayload(clientTrafficSecret: keys.clientTrafficSecret, transcript: transcript)
 
@@ -446,6 +498,17 @@ extension TLSClient {
         finishedMsg.append(0x00)
         finishedMsg.append(UInt8(verifyData.count))
         finishedMsg.append(verifyData)
+        return finishedMsg
+    }
+
+    private func sendTLS13ClientFinished(completion: @escaping (Error?) -> Void) {
+        guard let keys = tls13.handshakeKeys,
+              let finishedMsg = tls13ClientFinishedMessage() else {
+            completion(TLSError.handshakeFailed("Missing handshake keys"))
+            return
+        }
+
+        var ccsRecord = Data([TLSContentType.changeCipherSpec, 0x03, 0x03, 0x00, 0x01, 0x01])
 
         do {
             let finishedRecord = try TLSRecordCrypto.encryptHandshakeRecord(
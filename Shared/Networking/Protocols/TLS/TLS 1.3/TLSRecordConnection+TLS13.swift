@@ -14,6 +14,32 @@ extension TLSRecordConnection {
     // MARK: - TLS 1.3 Record Crypto
 
     func encryptTLS13Record(plaintext: Data, contentType: UInt8 = TLSContentType.applicationData) throws -> Data {
+        var record = Data(capacity: 5 + plaintext.count + 17)
+        try appendTLS13Record(plaintext: plaintext, contentType: contentType, to: &record)
+        return record
+    }
+
+    /// Seals one record onto the end of `records`. Caller holds `sendLock`
+    /// (the inner plaintext is staged in `sealScratch`).
+    func appendTLS13Record(plaintext: Data, contentType: UInt8, to records: inout Data) throws {
+        try appendTLS13Record(plaintextCount: plaintext.count, contentType: contentType, to: &records) {
+            $0.append(contentsOf: plaintext)
+        }
+    }
+
+    /// A chain's segments are gathered straight into the seal scratch.
+    func appendTLS13Record(plaintext: ByteChain, contentType: UInt8, to records: inout Data) throws {
+        try appendTLS13Record(plaintextCount: plaintext.count, contentType: contentType, to: &records) {
+            plaintext.copyBytes(appendingTo: &$0)
+        }
+    }
+
+    private func appendTLS13Record(
+        plaintextCount: Int,
+        contentType: UInt8,
+        to records: inout Data,
+        fill: (inout [UInt8]) -> Void
+    ) throws {
         seqLock.lock()
         let seqNum: UInt64
         if direction == .server {
@@ -25,27 +51,19 @@ extension TLSRecordConnection {
         }
         seqLock.unlock()
 
-        let innerLen = plaintext.count + 1
+        let innerLen = plaintextCount + 1
         let encryptedLen = innerLen + 16
 
-        var nonce = egressIV
-        xorSeqIntoNonce(&nonce, seqNum: seqNum)
+        sealScratch.removeAll(keepingCapacity: true)
+        fill(&sealScratch)
+        sealScratch.append(contentType)
 
-        var innerPlaintext = Data(count: innerLen)
-        innerPlaintext.withUnsafeMutableBytes { buffer in
-            plaintext.copyBytes(to: buffer)
-            buffer[plaintext.count] = contentType
+        // The record header doubles as the AAD.
+        let header = (TLSContentType.applicationData, UInt8(0x03), UInt8(0x03), UInt8(encryptedLen >> 8), UInt8(encryptedLen & 0xFF))
+        try withUnsafeBytes(of: header) { aad in
+            records.append(contentsOf: aad)
+            try egressCipher.seal(sealScratch, counter: seqNum, aad: aad, appendingTo: &records)
         }
-
-        let aad = Data([TLSContentType.applicationData, 0x03, 0x03, UInt8(encryptedLen >> 8), UInt8(encryptedLen & 0xFF)])
-
-        let (sealedCt, sealedTag) = try sealAEAD(plaintext: innerPlaintext, nonce: nonce, aad: aad, key: egressSymmetricKey)
-
-        var record = Data(capacity: 5 + encryptedLen)
-        record.append(aad)
-        record.append(sealedCt)
-        record.append(sealedTag)
-        return record
     }
 
     func decryptTLS13Record(ciphertext: Data, header: Data, seqNum: UInt64) throws -> Data {
@@ -53,13 +71,10 @@ extension TLSRecordConnection {
             throw TLSRecordError.ciphertextTooShort
         }
 
-        var nonce = ingressIV
-        xorSeqIntoNonce(&nonce, seqNum: seqNum)
-
         let ct = ciphertext.prefix(ciphertext.count - 16)
         let tag = ciphertext.suffix(16)
 
-        let decrypted = try openAEAD(ciphertext: ct, tag: tag, nonce: nonce, aad: header, key: ingressSymmetricKey)
+        let decrypted = try ingressCipher.open(ciphertext: ct, tag: tag, counter: seqNum, aad: header)
 
         guard !decrypted.isEmpty else {
             throw TLSRecordError.emptyDecryptedData
@@ -100,7 +115,7 @@ extension TLSRecordConnection {
         return decrypted.prefix(Int(contentLen))
     }
 
-    // MARK: - TLS 1.3 KeyUpdate (RFC 8446 §7.2)
+    // MARK: - TLS 1.3 Post-Handshake Messages (RFC 8446 §4.6)
 
     /// Runs on the receive path with `receiveLock` held (and never `seqLock`).
     private func handlePostHandshakeTLS13(_ messages: Data) {
@@ -121,6 +136,8 @@ extension TLSRecordConnection {
                 if requestUpdate == 1 {
                     keyUpdateResponsePending = true
                 }
+            } else if type == TLSHandshakeType.newSessionTicket, direction == .client {
+                sessionTicketHandler?(Data(messages[bodyStart..<bodyEnd]))
             }
             i = bodyEnd
         }
@@ -137,7 +154,7 @@ extension TLSRecordConnection {
             clientAppSecret = next.secret
             clientKey = next.key
             clientIV = next.iv
-            clientSymmetricKey = SymmetricKey(data: next.key)
+            clientCipher = TLSTrafficCipher(cipherSuite: cipherSuite, key: next.key, iv: next.iv)
             clientSeqNum = 0
             seqLock.unlock()
         } else {
@@ -147,7 +164,7 @@ extension TLSRecordConnection {
             serverAppSecret = next.secret
             serverKey = next.key
             serverIV = next.iv
-            serverSymmetricKey = SymmetricKey(data: next.key)
+            serverCipher = TLSTrafficCipher(cipherSuite: cipherSuite, key: next.key, iv: next.iv)
             serverSeqNum = 0
             seqLock.unlock()
         }
@@ -179,7 +196,7 @@ extension TLSRecordConnection {
             serverAppSecret = next.secret
             serverKey = next.key
             serverIV = next.iv
-            serverSymmetricKey = SymmetricKey(data: next.key)
+            serverCipher = TLSTrafficCipher(cipherSuite: cipherSuite, key: next.key, iv: next.iv)
             serverSeqNum = 0
             seqLock.unlock()
         } else {
@@ -189,7 +206,7 @@ extension TLSRecordConnection {
             clientAppSecret = next.secret
             clientKey = next.key
             clientIV = next.iv
-            clientSymmetricKey = SymmetricKey(data: next.key)
+            clientCipher = TLSTrafficCipher(cipherSuite: cipherSuite, key: next.key, iv: next.iv)
             clientSeqNum = 0
             seqLock.unlock()
         }
@@ -0,0 +1,109 @@
+//
+//  TLSServerSessionTickets.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import CryptoKit
+
+/// Stateless TLS 1.3 session tickets for ``TLSServer`` (RFC 8446 §4.6.1). A ticket is the
+/// resumption state sealed under a key generated once per Network Extension process, so
+/// tickets die with the tunnel and nothing is persisted or shared between clients.
+nonisolated final class TLSServerSessionTickets {
+
+    static let shared = TLSServerSessionTickets()
+
+    /// Well under RFC 8446's 7-day cap: a resumed session skips the leaf certificate,
+    /// so it must not outlive the CA the app currently trusts by much.
+    static let lifetime: UInt32 = 2 * 3600
+    /// Slack for clock skew and one-way delay when checking `obfuscated_ticket_age`.
+    private static let ageTolerance: CFAbsoluteTime = 10
+
+    struct State {
+        let psk: Data
+        let cipherSuite: UInt16
+        let sni: String
+        let alpn: String
+        let ageAdd: UInt32
+        let issuedAt: CFAbsoluteTime
+    }
+
+    private let key = SymmetricKey(size: .bits256)
+
+    private init() {}
+
+    // MARK: Issue
+
+    /// Seals `state` into a ticket identity.
+    func seal(_ state: State) -> Data? {
+        var plain = Data()
+        appendU16(&plain, state.cipherSuite)
+        appendU32(&plain, state.ageAdd)
+        appendU64(&plain, state.issuedAt.bitPattern)
+        plain.append(UInt8(state.psk.count))
+        plain.append(state.psk)
+        let sni = Data(state.sni.utf8.prefix(255))
+        plain.append(UInt8(sni.count))
+        plain.append(sni)
+        let alpn = Data(state.alpn.utf8.prefix(255))
+        plain.append(UInt8(alpn.count))
+        plain.append(alpn)
+        return try? AES.GCM.seal(plain, using: key).combined
+    }
+
+    // MARK: Redeem
+
+    /// Opens `identity` and returns its state when it is live and its age, as the client
+    /// reports it, is consistent with when it was issued.
+    func open(_ identity: Data, obfuscatedTicketAge: UInt32) -> State? {
+        guard let box = try? AES.GCM.SealedBox(combined: identity),
+              let plain = try? AES.GCM.open(box, using: key) else { return nil }
+        let bytes = [UInt8](plain)
+        guard bytes.count >= 15 else { return nil }
+        let cipherSuite = UInt16(bytes[0]) << 8 | UInt16(bytes[1])
+        let ageAdd = bytes[2..<6].reduce(UInt32(0)) { $0 << 8 | UInt32($1) }
+        let issuedAt = CFAbsoluteTime(bitPattern: bytes[6..<14].reduce(UInt64(0)) { $0 << 8 | UInt64($1) })
+        var offset = 14
+        guard let psk = readField(bytes, &offset), !psk.isEmpty,
+              let sni = readField(bytes, &offset),
+              let alpn = readField(bytes, &offset) else { return nil }
+
+        let age = CFAbsoluteTimeGetCurrent() - issuedAt
+        guard age >= 0, age < CFAbsoluteTime(Self.lifetime) else { return nil }
+        let reportedAge = CFAbsoluteTime(obfuscatedTicketAge &- ageAdd) / 1000
+        guard abs(reportedAge - age) <= Self.ageTolerance else { return nil }
+
+        return State(
+            psk: Data(psk),
+            cipherSuite: cipherSuite,
+            sni: String(decoding: sni, as: UTF8.self),
+            alpn: String(decoding: alpn, as: UTF8.self),
+            ageAdd: ageAdd,
+            issuedAt: issuedAt
+        )
+    }
+
+    // MARK: Helpers
+
+    private func readField(_ bytes: [UInt8], _ offset: inout Int) -> ArraySlice<UInt8>? {
+        guard offset < bytes.count else { return nil }
+        let length = Int(bytes[offset])
+        guard offset + 1 + length <= bytes.count else { return nil }
+        defer { offset += 1 + length }
+        return bytes[(offset + 1)..<(offset + 1 + length)]
+    }
+
+    private func appendU16(_ data: inout Data, _ value: UInt16) {
+        withUnsafeBytes(of: value.bigEndian) { data.append(contentsOf: $0) }
+    }
+
+    private func appendU32(_ data: inout Data, _ value: UInt32) {
+        withUnsafeBytes(of: value.bigEndian) { data.append(contentsOf: $0) }
+    }
+
+    private func appendU64(_ data: inout Data, _ value: UInt64) {
+        withUnsafeBytes(of: value.bigEndian) { data.append(contentsOf: $0) }
+    }
+}
@@ -0,0 +1,179 @@
+//
+//  TLSSessionTicketCache.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "TLSSessionTicketCache")
+
+/// Process-wide cache of TLS 1.3 session tickets (RFC 8446 §4.6.1), keyed by
+/// `(server, SNI, ALPN, verification policy)`, so the next ``TLSClient`` dial to the same
+/// server resumes with a PSK and skips the certificate chain and its verification.
+/// Tickets are single-use; servers typically issue two per handshake.
+nonisolated final class TLSSessionTicketCache {
+
+    static let shared = TLSSessionTicketCache()
+
+    struct Ticket: Codable {
+        let identity: Data
+        /// `HKDF-Expand-Label(resumption_master_secret, "resumption", ticket_nonce, Hash.length)`.
+        let psk: Data
+        /// The PSK is bound to this suite's hash; the resumed handshake must negotiate a suite on it.
+        let cipherSuite: UInt16
+        let ageAdd: UInt32
+        let receivedAt: CFAbsoluteTime
+        let expire: CFAbsoluteTime
+
+        /// `obfuscated_ticket_age` for a ClientHello sent now.
+        var obfuscatedAge: UInt32 {
+            let ageMilliseconds = UInt32(clamping: Int64(max(0, CFAbsoluteTimeGetCurrent() - receivedAt) * 1000))
+            return ageMilliseconds &+ ageAdd
+        }
+    }
+
+    private struct Snapshot: Codable {
+        let savedAt: CFAbsoluteTime
+        let entries: [String: [Ticket]]
+    }
+
+    /// RFC 8446 caps ticket_lifetime at 7 days.
+    private static let maxLifetime: CFAbsoluteTime = 7 * 24 * 3600
+    private static let maxTicketsPerKey = 4
+    private static let maxKeys = 64
+    /// A snapshot older than this is discarded on restore, so tickets only persist across
+    /// tunnel restarts and reconnects, not across days of the tunnel being off.
+    private static let snapshotWindow: CFAbsoluteTime = 15 * 60
+
+    private let snapshotURL: URL? = FileManager.default
+        .containerURL(forSecurityApplicationGroupIdentifier: AWCore.Identifier.appGroupSuite)?
+        .appendingPathComponent("tls-tickets.bin")
+
+    private let lock = UnfairLock()
+    private var entries: [String: [Ticket]] = [:]
+
+    private init() {}
+
+    /// A ticket issued under a skipped verification must never resume a verifying client,
+    /// so the policy is part of the key.
+    static func cacheKey(server: String, port: UInt16, configuration: TLSConfiguration) -> String {
+        let alpn = (configuration.alpn ?? ["h2", "http/1.1"]).joined(separator: ",")
+        let verify = configuration.insecureSkipVerify ? "insecure" : "verify"
+        return "\(server.lowercased()):\(port)|\(configuration.serverName.lowercased())|\(alpn)|\(verify)"
+    }
+
+    /// Removes and returns the freshest live ticket for `key`.
+    func take(key: String) -> Ticket? {
+        let now = CFAbsoluteTimeGetCurrent()
+        return lock.withLock {
+            guard var tickets = entries[key] else { return nil }
+            tickets.removeAll { $0.expire <= now }
+            let ticket = tickets.popLast()
+            entries[key] = tickets.isEmpty ? nil : tickets
+            return ticket
+        }
+    }
+
+    /// Parses a NewSessionTicket body and stores the ticket under `key`, deriving its PSK
+    /// from the connection's resumption master secret.
+    func store(
+        newSessionTicket body: Data,
+        key: String,
+        resumptionMasterSecret: Data,
+        cipherSuite: UInt16
+    ) {
+        // struct { uint32 lifetime; uint32 age_add; opaque nonce<0..255>;
+        //          opaque ticket<1..2^16-1>; Extension extensions<0..2^16-2>; }
+        let bytes = [UInt8](body)
+        guard bytes.count >= 9 else { return }
+        let lifetime = UInt32(bytes[0]) << 24 | UInt32(bytes[1]) << 16 | UInt32(bytes[2]) << 8 | UInt32(bytes[3])
+        let ageAdd = UInt32(bytes[4]) << 24 | UInt32(bytes[5]) << 16 | UInt32(bytes[6]) << 8 | UInt32(bytes[7])
+        let nonceLength = Int(bytes[8])
+        var offset = 9 + nonceLength
+        guard offset + 2 <= bytes.count else { return }
+        let nonce = Data(bytes[9..<offset])
+        let ticketLength = Int(bytes[offset]) << 8 | Int(bytes[offset + 1])
+        offset += 2
+        guard ticketLength > 0, offset + ticketLength <= bytes.count, lifetime > 0 else { return }
+        let identity = Data(bytes[offset..<(offset + ticketLength)])
+
+        let kd = TLS13KeyDerivation(cipherSuite: cipherSuite)
+        let now = CFAbsoluteTimeGetCurrent()
+        let ticket = Ticket(
+            identity: identity,
+            psk: kd.resumptionPSK(resumptionMasterSecret: resumptionMasterSecret, ticketNonce: nonce),
+            cipherSuite: cipherSuite,
+            ageAdd: ageAdd,
+            receivedAt: now,
+            expire: now + min(CFAbsoluteTime(lifetime), Self.maxLifetime)
+        )
+
+        lock.withLock {
+            if entries[key] == nil, entries.count >= Self.maxKeys {
+                // Drop the key whose newest ticket is oldest.
+                if let stalest = entries.min(by: { ($0.value.last?.receivedAt ?? 0) < ($1.value.last?.receivedAt ?? 0) })?.key {
+                    entries.removeValue(forKey: stalest)
+                }
+            }
+            var tickets = entries[key] ?? []
+            tickets.append(ticket)
+            if tickets.count > Self.maxTicketsPerKey {
+                tickets.removeFirst(tickets.count - Self.maxTicketsPerKey)
+            }
+            entries[key] = tickets
+        }
+    }
+
+    /// Wired to certificate-policy changes: a resumed session skips verification, so a
+    /// ticket must not outlive the trust decision it was issued under.
+    func removeAll() {
+        lock.withLock { entries.removeAll(keepingCapacity: false) }
+    }
+
+    // MARK: - Snapshot
+
+    /// Persists live tickets to the app group so the next tunnel start resumes instead of
+    /// paying full handshakes. Call on clean shutdown.
+    func saveSnapshot() {
+        guard let snapshotURL else { return }
+        let now = CFAbsoluteTimeGetCurrent()
+        let live: [String: [Ticket]] = lock.withLock {
+            entries.compactMapValues { tickets in
+                let live = tickets.filter { $0.expire > now }
+                return live.isEmpty ? nil : live
+            }
+        }
+        guard !live.isEmpty else {
+            try? FileManager.default.removeItem(at: snapshotURL)
+            return
+        }
+        do {
+            let data = try PropertyListEncoder().encode(Snapshot(savedAt: now, entries: live))
+            try data.write(to: snapshotURL, options: [.atomic, .completeFileProtectionUntilFirstUserAuthentication])
+        } catch {
+            logger.error("[TLSSessionTicketCache] Failed to write snapshot: \(error)")
+        }
+    }
+
+    /// Restores tickets written by ``saveSnapshot()``. The file is consumed, so a ticket is
+    /// never offered twice across an unclean exit.
+    func restoreSnapshot() {
+        guard let snapshotURL,
+              let data = try? Data(contentsOf: snapshotURL) else { return }
+        try? FileManager.default.removeItem(at: snapshotURL)
+
+        let now = CFAbsoluteTimeGetCurrent()
+        guard let snapshot = try? PropertyListDecoder().decode(Snapshot.self, from: data),
+              now - snapshot.savedAt < Self.snapshotWindow else { return }
+        let restored = snapshot.entries.compactMapValues { tickets in
+            let live = tickets.filter { $0.expire > now }
+            return live.isEmpty ? nil : live
+        }
+        lock.withLock {
+            entries.merge(restored) { current, _ in current }
+        }
+        logger.debug("[TLSSessionTicketCache] Restored tickets for \(restored.count) servers")
+    }
+}
@@ -40,6 +40,9 @@ nonisolated class TLSClient {
     /// ECHConfigList discovered from DNS HTTPS record by `prepareECH`, when ECH is enabled without an inline `echConfig`.
     private var resolvedECHConfigList: Data?
 
+    /// ``TLSSessionTicketCache`` key for this dial; set by `connect`.
+    var sessionCacheKey: String?
+
     // Cleared after handshake.
     var tls13 = TLS13HandshakeState()
 
@@ -115,7 +118,7 @@ nonisolated class TLSClient {
         completion: @escaping (Result<TLSRecordConnection, Error>) -> Void
     ) {
         let completion = releasingConnectionOnFailure(completion)
-        prepareECH { [weak self] echError in
+        prepareECH(dialHost: host) { [weak self] echError in
             guard let self else {
                 completion(.failure(TLSError.connectionFailed("Client deallocated")))
                 return
@@ -125,6 +128,7 @@ nonisolated class TLSClient {
                 return
             }
 
+            self.sessionCacheKey = TLSSessionTicketCache.cacheKey(server: host, port: port, configuration: self.configuration)
             self.ephemeralPrivateKey = Curve25519.KeyAgreement.PrivateKey()
             guard let privateKey = self.ephemeralPrivateKey else {
                 completion(.failure(TLSError.handshakeFailed("No ephemeral key")))
@@ -140,7 +144,7 @@ nonisolated class TLSClient {
             }
             self.storedClientHello = clientHello.subdata(in: 5..<clientHello.count)
 
-            let transport = NWTCPTransport()
+            let transport = DialTransports.tcp()
             self.connection = transport
 
             transport.connect(host: host, port: port, initialData: clientHello) { [weak self] error in
@@ -173,6 +177,9 @@ nonisolated class TLSClient {
                 completion(.failure(echError))
                 return
             }
+            // The tunnel hides the destination; the SNI stands in for the server.
+            self.sessionCacheKey = TLSSessionTicketCache.cacheKey(
+                server: self.configuration.serverName, port: 0, configuration: self.configuration)
             self.ephemeralPrivateKey = Curve25519.KeyAgreement.PrivateKey()
             self.connection = TunneledTransport(tunnel: tunnel)
             self.performTLSHandshake(completion: completion)
@@ -236,11 +243,16 @@ nonisolated class TLSClient {
 
     /// Resolves an opportunistic ECHConfigList from DNS before the handshake.
     /// Fail-closed: a discovery miss errors so the caller never falls back to a cleartext-SNI handshake.
-    private func prepareECH(completion: @escaping (Error?) -> Void) {
+    /// `dialHost`'s address lookup runs alongside the HTTPS-record query, so the connect
+    /// that follows finds it cached.
+    private func prepareECH(dialHost: String? = nil, completion: @escaping (Error?) -> Void) {
         guard configuration.echIsOpportunistic else {
             completion(nil)
             return
         }
+        if let dialHost {
+            DispatchQueue.global(qos: .userInitiated).async { DNSResolver.shared.prewarm(dialHost) }
+        }
         let serverName = configuration.serverName
         DNSResolver.shared.resolveECHConfigList(for: serverName) { [weak self] config in
             guard let self else {
@@ -318,11 +330,30 @@ nonisolated class TLSClient {
 
         if let maxVersion = configuration.maxVersion, maxVersion.rawValue <= 0x0303 {
             rawClientHello = TLSClientHelloBuilder.clampSupportedVersionsToTLS12(rawClientHello)
+        } else if let key = sessionCacheKey, let ticket = TLSSessionTicketCache.shared.take(key: key) {
+            rawClientHello = offerSessionTicket(ticket, in: rawClientHello)
         }
 
         return TLSClientHelloBuilder.wrapInTLSRecord(clientHello: rawClientHello)
     }
 
+    /// Appends a pre_shared_key offer for `ticket`, keeping the psk_dhe_ke key share so the
+    /// resumed session still gets forward secrecy. Falls back to the plain hello if it can't.
+    private func offerSessionTicket(_ ticket: TLSSessionTicketCache.Ticket, in clientHello: Data) -> Data {
+        let kd = TLS13KeyDerivation(cipherSuite: ticket.cipherSuite)
+        guard let offered = TLSClientHelloBuilder.appendPreSharedKey(
+            to: clientHello,
+            identity: ticket.identity,
+            obfuscatedTicketAge: ticket.obfuscatedAge,
+            binderLength: kd.hashLength,
+            binder: { kd.pskBinder(psk: ticket.psk, truncatedClientHello: $0) }
+        ) else {
+            return clientHello
+        }
+        tls13.offeredTicket = ticket
+        return offered
+    }
+
     // MARK: - Server Response Processing
 
     /// Buffers until a complete TLS record header arrives, then dispatches on content type.
@@ -533,6 +564,7 @@ nonisolated class TLSClient {
             var foundVersion: UInt16 = 0
             var keyShareData: Data?
             var hasEMS = false
+            var selectedIdentity: UInt16?
             var observedExtensionTypes = Set<UInt16>()
 
             var extOffset = shOffset
@@ -566,6 +598,11 @@ nonisolated class TLSClient {
                 case TLSExtensionType.extendedMasterSecret:
                     hasEMS = true
 
+                case TLSExtensionType.preSharedKey:
+                    if extDataLen == 2 {
+                        selectedIdentity = UInt16(data[extOffset]) << 8 | UInt16(data[extOffset + 1])
+                    }
+
                 case TLSExtensionType.applicationLayerProtocolNegotiation:
                     if extDataLen >= 3 {
                         let listLen = Int(data[extOffset]) << 8 | Int(data[extOffset + 1])
@@ -605,6 +642,15 @@ nonisolated class TLSClient {
                 default:
                     return nil
                 }
+                if let selectedIdentity {
+                    // Only one identity is offered, and its PSK is bound to its suite's hash.
+                    guard selectedIdentity == 0, let ticket = tls13.offeredTicket,
+                          TLS13KeyDerivation(cipherSuite: ticket.cipherSuite).hashLength
+                            == TLS13KeyDerivation(cipherSuite: cipherSuite).hashLength else {
+                        return nil
+                    }
+                    tls13.resumed = true
+                }
                 if let keyShare = keyShareData {
                     return .tls13(keyShare: keyShare, cipherSuite: cipherSuite)
                 }
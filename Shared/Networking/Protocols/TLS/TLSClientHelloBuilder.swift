@@ -1218,6 +1218,7 @@ struct TLSClientHelloBuilder {
         alpn: [String],
         keyShares: [(group: UInt16, keyData: Data)],
         quicTransportParams: Data,
+        earlyData: Bool = false,
         pskExtension: Data? = nil
     ) -> Data {
         let suites = cipherSuitesData([
@@ -1235,7 +1236,11 @@ struct TLSClientHelloBuilder {
         extsData.append(pskKeyExchangeModesExt())
         extsData.append(keyShareExt(keyShares))
         extsData.append(ext(TLSExtensionType.quicTransportParameters, quicTransportParams))
+        if earlyData {
+            extsData.append(ext(TLSExtensionType.earlyData, Data()))
+        }
 
+        // pre_shared_key must be the last extension (RFC 8446 §4.2.11).
         if let pskExtension {
             extsData.append(pskExtension)
         }
@@ -1336,4 +1341,66 @@ struct TLSClientHelloBuilder {
 
         return clientHello
     }
+
+    /// Appends a single-identity pre_shared_key extension (RFC 8446 §4.2.11), which must be
+    /// last. `binder` receives the ClientHello truncated before the binders list and returns
+    /// the binder, whose length must be `binderLength`. Returns nil for a malformed hello.
+    static func appendPreSharedKey(
+        to clientHello: Data,
+        identity: Data,
+        obfuscatedTicketAge: UInt32,
+        binderLength: Int,
+        binder: (Data) -> Data
+    ) -> Data? {
+        let bytes = [UInt8](clientHello)
+        guard bytes.count >= 4, bytes[0] == TLSHandshakeType.clientHello else { return nil }
+
+        var position = 4 + 2 + 32                                          // hs header + legacy_version + random
+        guard position < bytes.count else { return nil }
+        position += 1 + Int(bytes[position])
+        guard position + 2 <= bytes.count else { return nil }
+        position += 2 + ((Int(bytes[position]) << 8) | Int(bytes[position + 1]))
+        guard position < bytes.count else { return nil }
+        position += 1 + Int(bytes[position])
+        guard position + 2 <= bytes.count else { return nil }
+        let extsLenOffset = position
+        let extsLen = (Int(bytes[position]) << 8) | Int(bytes[position + 1])
+        guard extsLenOffset + 2 + extsLen == bytes.count else { return nil }
+
+        // identities<7..2^16-1> { identity<1..2^16-1>, uint32 obfuscated_ticket_age }
+        var identities = Data()
+        appendU16(&identities, UInt16(identity.count))
+        identities.append(identity)
+        identities.append(contentsOf: withUnsafeBytes(of: obfuscatedTicketAge.bigEndian) { Array($0) })
+        // binders<33..2^16-1> { PskBinderEntry<32..255> }
+        let bindersLength = 2 + 1 + binderLength
+
+        var payload = Data()
+        appendU16(&payload, UInt16(identities.count))
+        payload.append(identities)
+
+        var result = clientHello
+        result.append(ext(TLSExtensionType.preSharedKey, payload))
+        // The extension's declared length covers the binders still to be appended.
+        let extHeaderOffset = result.count - payload.count - 2
+        let extDataLen = payload.count + bindersLength
+        result[extHeaderOffset] = UInt8((extDataLen >> 8) & 0xFF)
+        result[extHeaderOffset + 1] = UInt8(extDataLen & 0xFF)
+
+        let newExtsLen = extsLen + 4 + extDataLen
+        result[extsLenOffset] = UInt8((newExtsLen >> 8) & 0xFF)
+        result[extsLenOffset + 1] = UInt8(newExtsLen & 0xFF)
+        let newHsLen = result.count + bindersLength - 4
+        result[1] = UInt8((newHsLen >> 16) & 0xFF)
+        result[2] = UInt8((newHsLen >> 8) & 0xFF)
+        result[3] = UInt8(newHsLen & 0xFF)
+
+        // The binder covers the hello with its final lengths, up to the binders list.
+        let binderValue = binder(result)
+        guard binderValue.count == binderLength else { return nil }
+        appendU16(&result, UInt16(1 + binderLength))
+        result.append(UInt8(binderLength))
+        result.append(binderValue)
+        return result
+    }
 }
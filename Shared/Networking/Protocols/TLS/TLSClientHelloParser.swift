@@ -22,6 +22,18 @@ struct TLSClientHelloParsed {
     let extendedMasterSecret: Bool
     let secureRenegotiation: Bool
     let handshakeMessage: Data
+    /// `psk_key_exchange_modes`; empty when absent.
+    let pskKeyExchangeModes: [UInt8]
+    /// `pre_shared_key` offer, which the parser guarantees was the last extension.
+    let preSharedKey: TLSClientHelloPSKOffer?
+}
+
+struct TLSClientHelloPSKOffer {
+    let identities: [(identity: Data, obfuscatedTicketAge: UInt32)]
+    let binders: [Data]
+    /// Size of the binders list including its 2-byte length; the binder transcript is
+    /// the ClientHello with this many trailing bytes removed.
+    let bindersLength: Int
 }
 
 enum TLSClientHelloParserError: Error {
@@ -108,7 +120,9 @@ enum TLSClientHelloParser {
             compressionMethods: compressionMethods,
             extendedMasterSecret: parsedExtensions.extendedMasterSecret,
             secureRenegotiation: secureRenegotiation,
-            handshakeMessage: handshakeMessage
+            handshakeMessage: handshakeMessage,
+            pskKeyExchangeModes: parsedExtensions.pskKeyExchangeModes,
+            preSharedKey: parsedExtensions.preSharedKey
         )
     }
 
@@ -121,6 +135,8 @@ enum TLSClientHelloParser {
         var keyShares: [UInt16: Data] = [:]
         var extendedMasterSecret: Bool = false
         var renegotiationInfo: Bool = false
+        var pskKeyExchangeModes: [UInt8] = []
+        var preSharedKey: TLSClientHelloPSKOffer? = nil
     }
 
     private static func parseExtensions(_ buf: Data) throws -> ParsedExtensions {
@@ -128,6 +144,10 @@ enum TLSClientHelloParser {
         var observedExtensionTypes = Set<UInt16>()
         var current = Cursor(buf)
         while !current.isAtEnd {
+            // RFC 8446 §4.2.11: pre_shared_key MUST be the last extension.
+            if result.preSharedKey != nil {
+                throw TLSClientHelloParserError.malformed("pre_shared_key not last")
+            }
             guard let extType = current.readU16(),
                   let extLen = current.readU16(),
                   let extData = current.readBytes(extLen) else {
@@ -154,6 +174,13 @@ enum TLSClientHelloParser {
                 result.keyShares = parseKeyShares(extData)
             case TLSExtensionType.renegotiationInfo:
                 result.renegotiationInfo = true
+            case TLSExtensionType.preSharedKeyKexModes:
+                var modesCursor = Cursor(extData)
+                if let count = modesCursor.readU8(), let modes = modesCursor.readBytes(Int(count)) {
+                    result.pskKeyExchangeModes = [UInt8](modes)
+                }
+            case TLSExtensionType.preSharedKey:
+                result.preSharedKey = try parsePreSharedKey(extData)
             default:
                 continue
             }
@@ -207,6 +234,36 @@ enum TLSClientHelloParser {
         return protocols
     }
 
+    private static func parsePreSharedKey(_ buf: Data) throws -> TLSClientHelloPSKOffer {
+        var current = Cursor(buf)
+        guard let identitiesLength = current.readU16(), let identitiesData = current.readBytes(identitiesLength),
+              let bindersLength = current.readU16(), let bindersData = current.readBytes(bindersLength),
+              current.isAtEnd else {
+            throw TLSClientHelloParserError.malformed("pre_shared_key")
+        }
+        var identities: [(identity: Data, obfuscatedTicketAge: UInt32)] = []
+        var identityCursor = Cursor(identitiesData)
+        while !identityCursor.isAtEnd {
+            guard let length = identityCursor.readU16(), length > 0, let identity = identityCursor.readBytes(length),
+                  let ageHigh = identityCursor.readU16(), let ageLow = identityCursor.readU16() else {
+                throw TLSClientHelloParserError.malformed("pre_shared_key identity")
+            }
+            identities.append((Data(identity), UInt32(ageHigh) << 16 | UInt32(ageLow)))
+        }
+        var binders: [Data] = []
+        var binderCursor = Cursor(bindersData)
+        while !binderCursor.isAtEnd {
+            guard let length = binderCursor.readU8(), length >= 32, let binder = binderCursor.readBytes(Int(length)) else {
+                throw TLSClientHelloParserError.malformed("pre_shared_key binder")
+            }
+            binders.append(Data(binder))
+        }
+        guard !identities.isEmpty, identities.count == binders.count else {
+            throw TLSClientHelloParserError.malformed("pre_shared_key identity/binder count")
+        }
+        return TLSClientHelloPSKOffer(identities: identities, binders: binders, bindersLength: 2 + bindersLength)
+    }
+
     private static func parseKeyShares(_ buf: Data) -> [UInt16: Data] {
         var result: [UInt16: Data] = [:]
         var current = Cursor(buf)
@@ -47,4 +47,12 @@ nonisolated class TLSProxyConnection: ProxyConnection {
     override func sendDirectRaw(data: Data) {
         tlsConnection.sendRaw(data: data)
     }
+
+    override var directReceiveTransport: (any RawTransport)? {
+        tlsConnection.hasBufferedRawBytes ? nil : tlsConnection.connection
+    }
+
+    override var directSendTransport: (any RawTransport)? {
+        tlsConnection.connection
+    }
 }
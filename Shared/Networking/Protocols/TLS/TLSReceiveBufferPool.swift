@@ -0,0 +1,48 @@
+//
+//  TLSReceiveBufferPool.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Recycles the buffers ``TLSRecordConnection`` carries a split record in. A delivery that
+/// ends mid-record is copied once into a pooled buffer, and the deliveries after it append
+/// into capacity that buffer already owns rather than growing a fresh allocation per read.
+/// A connection holds a buffer only while a record is split and returns it once drained,
+/// so idle connections hold none.
+nonisolated final class TLSReceiveBufferPool {
+
+    static let shared = TLSReceiveBufferPool()
+
+    /// One maximal transport delivery behind the largest partial TLS 1.2 record.
+    private static let bufferCapacity = 256 * 1024 + 5 + 16_384 + 2048
+    private static let maxPooled = 8
+
+    private let lock = UnfairLock()
+    private var free: [Data] = []
+
+    private init() {}
+
+    /// An empty buffer with room for `bufferCapacity` bytes.
+    func take() -> Data {
+        lock.withLock { free.popLast() } ?? Data(capacity: Self.bufferCapacity)
+    }
+
+    /// Takes `buffer`'s storage back, leaving it empty. Swapped out first so the pool holds
+    /// the only reference and `removeAll(keepingCapacity:)` keeps the allocation.
+    func recycle(_ buffer: inout Data) {
+        var spent = Data()
+        swap(&spent, &buffer)
+        spent.removeAll(keepingCapacity: true)
+        lock.withLock {
+            if free.count < Self.maxPooled { free.append(spent) }
+        }
+    }
+
+    /// Drops every spare buffer; called under memory pressure.
+    func trim() {
+        lock.withLock { free.removeAll() }
+    }
+}
@@ -8,6 +8,7 @@
 import Foundation
 import CryptoKit
 import CommonCrypto
+import Security
 
 nonisolated private let logger = AnywhereLogger(category: "TLSRecordConnection")
 
@@ -24,6 +25,11 @@ nonisolated class TLSRecordConnection {
     /// The value of the ALPN sent by the peer; empty when the peer selected none.
     var negotiatedALPN: String = ""
 
+    /// The leaf-first chain a verified full handshake presented; empty after resumption, with
+    /// verification skipped, and on the server side. Lets a pool coalesce another server name
+    /// onto this connection (see ``CertificatePolicy/covers(chain:serverName:)``).
+    var peerCertificates: [SecCertificate] = []
+
     // Mutable so a TLS 1.3 post-handshake KeyUpdate (RFC 8446 §7.2) can install the next
     // key generation. Egress (`*Key`/`*IV` for our send direction) is only mutated under
     // `sendLock`; ingress (our read direction) only from the receive path. See `rekeyIngress`.
@@ -37,8 +43,10 @@ nonisolated class TLSRecordConnection {
 
     let cipherSuite: UInt16
 
-    var clientSymmetricKey: SymmetricKey
-    var serverSymmetricKey: SymmetricKey
+    /// AEAD state for each direction's current key generation; replaced
+    /// together with the key and IV it was derived from.
+    var clientCipher: TLSTrafficCipher
+    var serverCipher: TLSTrafficCipher
 
     /// TLS 1.3 application traffic secrets, retained so KeyUpdate can derive the next
     /// generation. `nil` for TLS 1.2 (which has no KeyUpdate) and disables KeyUpdate handling.
@@ -49,6 +57,10 @@ nonisolated class TLSRecordConnection {
     /// `receiveLock` is released so we can send our own KeyUpdate without holding it.
     var keyUpdateResponsePending = false
 
+    /// Receives each TLS 1.3 NewSessionTicket body; set by ``TLSClient`` to feed
+    /// ``TLSSessionTicketCache``. Called on the receive path with `receiveLock` held.
+    var sessionTicketHandler: ((Data) -> Void)?
+
     var clientSeqNum: UInt64 = 0
     var serverSeqNum: UInt64 = 0
     let seqLock = UnfairLock()
@@ -56,8 +68,22 @@ nonisolated class TLSRecordConnection {
     let sendLock = UnfairLock()
 
     private static let maxRecordPlaintext = 16384
-
-    private var receiveBuffer = Data(capacity: 256 * 1024)
+    /// Header + CBC IV + SHA-384 MAC + padding; AEAD records need less.
+    private static let maxRecordOverhead = 5 + 16 + 48 + 16
+    /// Header + inner content type + AEAD tag.
+    private static let tls13RecordOverhead = 5 + 1 + 16
+    /// What the hop beneath a chained connection reseals in one unit: the smaller of an
+    /// outer TLS record's plaintext and a Shadowsocks AEAD chunk.
+    private static let nestedRecordTarget = 16_383
+
+    /// TLS 1.3 inner plaintext staged for sealing, reused across records.
+    /// Egress only, so guarded by `sendLock`.
+    var sealScratch: [UInt8] = []
+
+    /// Either a transport delivery adopted as-is or, while a record is split across
+    /// deliveries, a buffer borrowed from ``TLSReceiveBufferPool``.
+    private var receiveBuffer = Data()
+    private var receiveBufferPooled = false
     private let receiveLock = UnfairLock()
     
     var receivedCloseNotify = false
@@ -83,8 +109,8 @@ nonisolated class TLSRecordConnection {
         self.clientMACKey = Data()
         self.serverMACKey = Data()
         self.cipherSuite = cipherSuite
-        self.clientSymmetricKey = SymmetricKey(data: clientKey)
-        self.serverSymmetricKey = SymmetricKey(data: serverKey)
+        self.clientCipher = TLSTrafficCipher(cipherSuite: cipherSuite, key: clientKey, iv: clientIV)
+        self.serverCipher = TLSTrafficCipher(cipherSuite: cipherSuite, key: serverKey, iv: serverIV)
         self.clientAppSecret = clientAppSecret
         self.serverAppSecret = serverAppSecret
         self.direction = direction
@@ -113,8 +139,8 @@ nonisolated class TLSRecordConnection {
         self.cipherSuite = cipherSuite
         self.clientSeqNum = initialClientSeqNum
         self.serverSeqNum = initialServerSeqNum
-        self.clientSymmetricKey = SymmetricKey(data: clientKey)
-        self.serverSymmetricKey = SymmetricKey(data: serverKey)
+        self.clientCipher = TLSTrafficCipher(cipherSuite: cipherSuite, key: clientKey, iv: clientIV)
+        self.serverCipher = TLSTrafficCipher(cipherSuite: cipherSuite, key: serverKey, iv: serverIV)
         self.direction = direction
     }
 
@@ -128,17 +154,11 @@ nonisolated class TLSRecordConnection {
     // MARK: - Direction-aware Key/IV Selection
 
     var egressKey: Data { direction == .server ? serverKey : clientKey }
-    var egressIV: Data { direction == .server ? serverIV : clientIV }
-    var egressSymmetricKey: SymmetricKey {
-        direction == .server ? serverSymmetricKey : clientSymmetricKey
-    }
+    var egressCipher: TLSTrafficCipher { direction == .server ? serverCipher : clientCipher }
     var egressMACKey: Data { direction == .server ? serverMACKey : clientMACKey }
 
     var ingressKey: Data { direction == .server ? clientKey : serverKey }
-    var ingressIV: Data { direction == .server ? clientIV : serverIV }
-    var ingressSymmetricKey: SymmetricKey {
-        direction == .server ? clientSymmetricKey : serverSymmetricKey
-    }
+    var ingressCipher: TLSTrafficCipher { direction == .server ? clientCipher : serverCipher }
     var ingressMACKey: Data { direction == .server ? clientMACKey : serverMACKey }
 
     // MARK: - Send (Encrypted)
@@ -160,6 +180,25 @@ nonisolated class TLSRecordConnection {
         }
     }
 
+    /// ``send(data:completion:)`` for a chain: each record's plaintext is gathered from the
+    /// segments as it is sealed, so the chain is never joined first.
+    func send(chain: ByteChain, completion: @escaping (Error?) -> Void) {
+        sendLock.lock()
+        guard let connection else {
+            sendLock.unlock()
+            completion(TLSRecordError.connectionUnavailable)
+            return
+        }
+        do {
+            let record = try buildTLSRecords(for: chain)
+            connection.send(data: record, completion: completion)
+            sendLock.unlock()
+        } catch {
+            sendLock.unlock()
+            completion(error)
+        }
+    }
+
     func send(data: Data) {
         sendLock.lock()
         guard let connection else {
@@ -213,7 +252,8 @@ nonisolated class TLSRecordConnection {
         receiveLock.lock()
         if !receiveBuffer.isEmpty {
             let data = receiveBuffer
-            receiveBuffer.removeAll()
+            receiveBuffer = Data()
+            receiveBufferPooled = false
             receiveLock.unlock()
             completion(data, nil)
             return
@@ -243,6 +283,12 @@ nonisolated class TLSRecordConnection {
         }
     }
 
+    /// Whether socket bytes read past the last record are still queued for
+    /// ``receiveRaw(completion:)``.
+    var hasBufferedRawBytes: Bool {
+        receiveLock.withLock { !receiveBuffer.isEmpty }
+    }
+
     func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
         guard let connection else {
             completion(TLSRecordError.connectionUnavailable)
@@ -262,7 +308,7 @@ nonisolated class TLSRecordConnection {
         sendCloseNotify()
 
         receiveLock.lock()
-        receiveBuffer.removeAll()
+        releaseReceiveBuffer()
         receiveLock.unlock()
 
         connection?.forceCancel()
@@ -327,7 +373,7 @@ nonisolated class TLSRecordConnection {
             }
 
             self.receiveLock.lock()
-            self.receiveBuffer.append(data)
+            self.bufferDelivery(data)
             let processed = self.processBuffer()
             let needsKeyUpdateResponse = self.keyUpdateResponsePending
             self.keyUpdateResponsePending = false
@@ -365,7 +411,9 @@ nonisolated class TLSRecordConnection {
             return nil
         }
 
-        var batchedData = Data(capacity: receiveBuffer.count)
+        // Stays empty until a record decrypts; a lone record's plaintext is
+        // returned as-is and only a batch of several is concatenated.
+        var batchedData = Data()
         var hasError: Error? = nil
         var recordsProcessed = 0
         var bytesPendingReplay: Data? = nil
@@ -384,7 +432,7 @@ nonisolated class TLSRecordConnection {
 
             let maxCiphertext = tlsVersion >= 0x0304 ? 16384 + 256 : 16384 + 2048
             guard Int(recordLen) <= maxCiphertext else {
-                receiveBuffer.removeAll()
+                releaseReceiveBuffer()
                 return .error(TLSRecordError.malformedRecord("record overflow (\(recordLen) bytes)"))
             }
 
@@ -416,19 +464,21 @@ nonisolated class TLSRecordConnection {
                 do {
                     let decrypted = try decryptTLSRecord(ciphertext: body, header: header, seqNum: seqNum)
                     consumed += totalLen
-                    if !decrypted.isEmpty {
+                    if batchedData.isEmpty {
+                        batchedData = decrypted
+                    } else {
                         batchedData.append(decrypted)
                     }
                     if receivedCloseNotify { break }
                 } catch {
                     if case TLSRecordError.tlsAlert = error {
-                        receiveBuffer.removeAll()
+                        releaseReceiveBuffer()
                         consumed = 0
                         hasError = error
                         break
                     }
                     let pending = Data(receiveBuffer[(base + consumed)...])
-                    receiveBuffer.removeAll()
+                    releaseReceiveBuffer()
                     consumed = 0
                     bytesPendingReplay = pending
                     hasError = error
@@ -470,11 +520,7 @@ nonisolated class TLSRecordConnection {
         }
 
         if consumed > 0 {
-            if consumed >= receiveBuffer.count {
-                receiveBuffer = Data()
-            } else {
-                receiveBuffer = Data(receiveBuffer.suffix(from: receiveBuffer.startIndex + consumed))
-            }
+            dropConsumed(consumed)
         }
 
         if let error = hasError {
@@ -507,76 +553,101 @@ nonisolated class TLSRecordConnection {
 
     // MARK: - TLS Record Crypto (Dispatch)
 
+    /// Seals `data` as application-data records into one buffer reserved up
+    /// front. Records are sealed straight from slices of `data` and land in
+    /// `records` without a `Data` per record. Caller holds `sendLock`.
     private func buildTLSRecords(for data: Data) throws -> Data {
-        if data.count <= Self.maxRecordPlaintext {
-            return try encryptSingleRecord(plaintext: data, contentType: TLSContentType.applicationData)
-        }
+        let limit = recordPlaintextLimit
+        let chunkCount = max(1, (data.count + limit - 1) / limit)
+        var records = Data(capacity: data.count + chunkCount * Self.maxRecordOverhead)
+        var offset = data.startIndex
+        repeat {
+            let end = min(offset + limit, data.endIndex)
+            if tlsVersion >= 0x0304 {
+                try appendTLS13Record(plaintext: data[offset..<end], contentType: TLSContentType.applicationData, to: &records)
+            } else {
+                try appendTLS12Record(plaintext: data[offset..<end], contentType: TLSContentType.applicationData, to: &records)
+            }
+            offset = end
+        } while offset < data.endIndex
+        return records
+    }
 
-        let chunkCount = (data.count + Self.maxRecordPlaintext - 1) / Self.maxRecordPlaintext
-        var records = Data(capacity: data.count + chunkCount * 64)
+    private func buildTLSRecords(for chain: ByteChain) throws -> Data {
+        let limit = recordPlaintextLimit
+        let chunkCount = max(1, (chain.count + limit - 1) / limit)
+        var records = Data(capacity: chain.count + chunkCount * Self.maxRecordOverhead)
         var offset = 0
-        while offset < data.count {
-            let end = min(offset + Self.maxRecordPlaintext, data.count)
-            records.append(try encryptSingleRecord(plaintext: Data(data[offset..<end]), contentType: TLSContentType.applicationData))
+        repeat {
+            let end = min(offset + limit, chain.count)
+            let plaintext = chain.slice(offset..<end)
+            if tlsVersion >= 0x0304 {
+                try appendTLS13Record(plaintext: plaintext, contentType: TLSContentType.applicationData, to: &records)
+            } else {
+                try appendTLS12Record(plaintext: plaintext.flattened(), contentType: TLSContentType.applicationData, to: &records)
+            }
             offset = end
-        }
+        } while offset < chain.count
         return records
     }
 
-    private func encryptSingleRecord(plaintext: Data, contentType: UInt8) throws -> Data {
-        if tlsVersion >= 0x0304 {
-            return try encryptTLS13Record(plaintext: plaintext, contentType: contentType)
-        } else {
-            return try encryptTLS12Record(plaintext: plaintext, contentType: contentType)
-        }
+    /// Plaintext per record. Over a chained hop every record is sealed again by the hop
+    /// beneath, so records are trimmed to fit one of its units whole; full-size records
+    /// would straddle two and leave that hop sealing a sliver record per write.
+    private var recordPlaintextLimit: Int {
+        guard connection is TunneledTransport else { return Self.maxRecordPlaintext }
+        let overhead = tlsVersion >= 0x0304 ? Self.tls13RecordOverhead : Self.maxRecordOverhead
+        return Self.nestedRecordTarget - overhead
     }
 
-    private func decryptTLSRecord(ciphertext: Data, header: Data, seqNum: UInt64) throws -> Data {
-        if tlsVersion >= 0x0304 {
-            return try decryptTLS13Record(ciphertext: ciphertext, header: header, seqNum: seqNum)
-        } else {
-            return try decryptTLS12Record(ciphertext: ciphertext, header: header, seqNum: seqNum)
+    // MARK: - Receive Buffer
+
+    /// Adopts `data` when nothing is carried over, so its records are parsed in the
+    /// transport's own storage; behind a split record, appends into a pooled buffer.
+    /// Called with `receiveLock` held.
+    private func bufferDelivery(_ data: Data) {
+        if receiveBuffer.isEmpty {
+            releaseReceiveBuffer()
+            receiveBuffer = data
+            return
+        }
+        if !receiveBufferPooled {
+            var carry = TLSReceiveBufferPool.shared.take()
+            carry.append(receiveBuffer)
+            receiveBuffer = carry
+            receiveBufferPooled = true
         }
+        receiveBuffer.append(data)
     }
 
-    // MARK: - AEAD Helpers
-
-    func sealAEAD(plaintext: Data, nonce: Data, aad: Data, key: SymmetricKey) throws -> (ciphertext: Data, tag: Data) {
-        if TLSCipherSuite.isChaCha20(cipherSuite) {
-            let nonceObj = try ChaChaPoly.Nonce(data: nonce)
-            let sealedBox = try ChaChaPoly.seal(plaintext, using: key, nonce: nonceObj, authenticating: aad)
-            return (Data(sealedBox.ciphertext), Data(sealedBox.tag))
+    /// Drops the first `consumed` bytes: a pooled buffer shifts its tail down in place, an
+    /// adopted delivery keeps a copy of just the tail. Called with `receiveLock` held.
+    private func dropConsumed(_ consumed: Int) {
+        let base = receiveBuffer.startIndex
+        if consumed >= receiveBuffer.count {
+            releaseReceiveBuffer()
+        } else if receiveBufferPooled {
+            receiveBuffer.removeSubrange(base..<(base + consumed))
         } else {
-            let nonceObj = try AES.GCM.Nonce(data: nonce)
-            let sealedBox = try AES.GCM.seal(plaintext, using: key, nonce: nonceObj, authenticating: aad)
-            return (Data(sealedBox.ciphertext), Data(sealedBox.tag))
+            receiveBuffer = Data(receiveBuffer.suffix(from: base + consumed))
         }
     }
 
-    func openAEAD(ciphertext: Data, tag: Data, nonce: Data, aad: Data, key: SymmetricKey) throws -> Data {
-        do {
-            if TLSCipherSuite.isChaCha20(cipherSuite) {
-                let nonceObj = try ChaChaPoly.Nonce(data: nonce)
-                let sealedBox = try ChaChaPoly.SealedBox(nonce: nonceObj, ciphertext: ciphertext, tag: tag)
-                return Data(try ChaChaPoly.open(sealedBox, using: key, authenticating: aad))
-            } else {
-                let nonceObj = try AES.GCM.Nonce(data: nonce)
-                let sealedBox = try AES.GCM.SealedBox(nonce: nonceObj, ciphertext: ciphertext, tag: tag)
-                return Data(try AES.GCM.open(sealedBox, using: key, authenticating: aad))
-            }
-        } catch CryptoKitError.authenticationFailure {
-            throw TLSRecordError.recordAuthenticationFailed
+    /// Called with `receiveLock` held.
+    private func releaseReceiveBuffer() {
+        if receiveBufferPooled {
+            TLSReceiveBufferPool.shared.recycle(&receiveBuffer)
+            receiveBufferPooled = false
+        } else {
+            receiveBuffer = Data()
         }
     }
 
-    @inline(__always)
-    func xorSeqIntoNonce(_ nonce: inout Data, seqNum: UInt64) {
-        nonce.withUnsafeMutableBytes { pointer in
-            let p = pointer.bindMemory(to: UInt8.self)
-            let base = p.count - 8
-            for i in 0..<8 {
-                p[base + i] ^= UInt8((seqNum >> ((7 - i) * 8)) & 0xFF)
-            }
+    private func decryptTLSRecord(ciphertext: Data, header: Data, seqNum: UInt64) throws -> Data {
+        if tlsVersion >= 0x0304 {
+            return try decryptTLS13Record(ciphertext: ciphertext, header: header, seqNum: seqNum)
+        } else {
+            return try decryptTLS12Record(ciphertext: ciphertext, header: header, seqNum: seqNum)
         }
     }
 }
@@ -73,6 +73,11 @@ nonisolated final class TLSServer {
     var handshake12 = TLS12ServerHandshakeState()
     /// First ClientHello bytes, kept across HRR for the synthetic message_hash transcript record.
     private var firstClientHelloBytes: Data?
+    /// Resumed from one of our session tickets: the server flight omits Certificate and CertificateVerify.
+    private var resumedWithPSK = false
+
+    /// `psk_dhe_ke`, the only PSK mode accepted: resumption still runs a fresh ECDHE.
+    private static let pskDHEKE: UInt8 = 1
 
     // MARK: - Init
 
@@ -199,10 +204,19 @@ nonisolated final class TLSServer {
         }
 
         if let clientKeyShare = parsed.keyShares[TLSNamedGroup.x25519] {
+            let resumption: (psk: Data, identity: UInt16)?
+            switch verifyPSKOffer(parsed: parsed, cipherSuite: suite) {
+            case .accepted(let psk, let identity): resumption = (psk, identity)
+            case .fullHandshake: resumption = nil
+            case .badBinder:
+                sendAlertAndFail(level: TLSAlertLevel.fatal, description: TLSAlertDescription.decryptError, message: "PSK binder mismatch")
+                return
+            }
             try sendServerHello(
                 parsed: parsed,
                 clientKeyShare: clientKeyShare,
-                cipherSuite: suite
+                cipherSuite: suite,
+                resumption: resumption
             )
         } else {
             if state == .waitingClientHelloAfterHRR {
@@ -213,6 +227,42 @@ nonisolated final class TLSServer {
         }
     }
 
+    private enum PSKVerdict {
+        case accepted(psk: Data, identity: UInt16)
+        case fullHandshake
+        case badBinder
+    }
+
+    /// Picks the first offered identity that is one of our live tickets for this SNI, ALPN
+    /// and suite. Foreign or stale tickets fall back to a full handshake; a ticket of ours
+    /// whose binder fails aborts, per RFC 8446 §4.2.11.
+    private func verifyPSKOffer(parsed: TLSClientHelloParsed, cipherSuite: UInt16) -> PSKVerdict {
+        guard let offer = parsed.preSharedKey,
+              parsed.pskKeyExchangeModes.contains(Self.pskDHEKE) else { return .fullHandshake }
+        for (index, offered) in offer.identities.enumerated() {
+            guard let ticket = TLSServerSessionTickets.shared.open(
+                      offered.identity, obfuscatedTicketAge: offered.obfuscatedTicketAge),
+                  ticket.cipherSuite == cipherSuite,
+                  ticket.sni == (parsed.serverName ?? ""),
+                  ticket.alpn == negotiatedALPN else { continue }
+
+            // After HRR the binder also covers message_hash(ClientHello1) || HelloRetryRequest.
+            var truncated = state == .waitingClientHelloAfterHRR ? handshake.transcript : Data()
+            let message = parsed.handshakeMessage
+            truncated.append(message.prefix(message.count - offer.bindersLength))
+            let expected = TLS13KeyDerivation(cipherSuite: cipherSuite)
+                .pskBinder(psk: ticket.psk, truncatedClientHello: truncated)
+            let received = offer.binders[index]
+            guard expected.count == received.count else { return .badBinder }
+            var diff: UInt8 = 0
+            for i in 0..<expected.count {
+                diff |= expected[expected.startIndex + i] ^ received[received.startIndex + i]
+            }
+            return diff == 0 ? .accepted(psk: ticket.psk, identity: UInt16(index)) : .badBinder
+        }
+        return .fullHandshake
+    }
+
     private func sendHelloRetryRequest(parsed: TLSClientHelloParsed, cipherSuite: UInt16) {
         firstClientHelloBytes = parsed.handshakeMessage
         sessionID = parsed.legacySessionID
@@ -239,10 +289,12 @@ nonisolated final class TLSServer {
     private func sendServerHello(
         parsed: TLSClientHelloParsed,
         clientKeyShare: Data,
-        cipherSuite: UInt16
+        cipherSuite: UInt16,
+        resumption: (psk: Data, identity: UInt16)?
     ) throws {
         sni = parsed.serverName
         sessionID = parsed.legacySessionID
+        resumedWithPSK = resumption != nil
 
         let kd: TLS13KeyDerivation
         if let existing = handshake.keyDerivation {
@@ -264,7 +316,8 @@ nonisolated final class TLSServer {
         let serverHello = TLSServerHelloBuilder.buildServerHello(
             legacySessionID: parsed.legacySessionID,
             cipherSuite: cipherSuite,
-            x25519PublicKey: serverPriv.publicKey.rawRepresentation
+            x25519PublicKey: serverPriv.publicKey.rawRepresentation,
+            selectedIdentity: resumption?.identity
         )
         handshake.transcript.append(serverHello)
 
@@ -277,7 +330,8 @@ nonisolated final class TLSServer {
         let shared = try serverPriv.sharedSecretFromKeyAgreement(with: clientPub)
         let sharedData = shared.withUnsafeBytes { Data($0) }
 
-        let (hsSecret, keys) = kd.deriveHandshakeKeys(sharedSecret: sharedData, transcript: handshake.transcript)
+        let (hsSecret, keys) = kd.deriveHandshakeKeys(sharedSecret: sharedData, transcript: handshake.transcript,
+                                                      psk: resumption?.psk)
         handshake.handshakeSecret = hsSecret
         handshake.handshakeKeys = keys
 
@@ -290,18 +344,26 @@ nonisolated final class TLSServer {
         let ee = TLSServerHelloBuilder.buildEncryptedExtensions(alpn: negotiatedALPN.isEmpty ? nil : negotiatedALPN)
         appendToTranscript(ee)
 
-        let cert = TLSServerHelloBuilder.buildCertificate(leafCertDER: leafCertDER)
-        appendToTranscript(cert)
+        var combined = Data()
+        combined.append(ee)
 
-        let transcriptHash = kd.transcriptHash(handshake.transcript)
-        let cvContext = TLSServerHelloBuilder.certificateVerifyContext(transcriptHash: transcriptHash)
-        let signature = try leafSigningKeyP256.signature(for: cvContext)
+        // A PSK authenticates the resumed session; the leaf and its signature are skipped.
+        if !resumedWithPSK {
+            let cert = TLSServerHelloBuilder.buildCertificate(leafCertDER: leafCertDER)
+            appendToTranscript(cert)
 
-        let cv = TLSServerHelloBuilder.buildCertificateVerify(
-            signatureAlgorithm: TLSSignatureScheme.ecdsa_secp256r1_sha256,
-            signature: signature.derRepresentation
-        )
-        appendToTranscript(cv)
+            let transcriptHash = kd.transcriptHash(handshake.transcript)
+            let cvContext = TLSServerHelloBuilder.certificateVerifyContext(transcriptHash: transcriptHash)
+            let signature = try leafSigningKeyP256.signature(for: cvContext)
+
+            let cv = TLSServerHelloBuilder.buildCertificateVerify(
+                signatureAlgorithm: TLSSignatureScheme.ecdsa_secp256r1_sha256,
+                signature: signature.derRepresentation
+            )
+            appendToTranscript(cv)
+            combined.append(cert)
+            combined.append(cv)
+        }
 
         let serverFinishedVerify = kd.serverFinishedPayload(
             serverTrafficSecret: keys.serverTrafficSecret,
@@ -309,11 +371,6 @@ nonisolated final class TLSServer {
         )
         let fin = TLSServerHelloBuilder.buildFinished(verifyData: serverFinishedVerify)
         appendToTranscript(fin)
-
-        var combined = Data()
-        combined.append(ee)
-        combined.append(cert)
-        combined.append(cv)
         combined.append(fin)
 
         let encrypted = try encryptHandshakeRecord(content: combined, contentType: TLSContentType.handshake, keys: keys, kd: kd)
@@ -413,7 +470,11 @@ nonisolated final class TLSServer {
                 handshake.transcript.append(message)
                 offset += total
 
-                completeHandshake(applicationKeys: appKeys)
+                let resumptionMasterSecret = kd.deriveResumptionMasterSecret(
+                    handshakeSecret: hsSecret,
+                    transcript: handshake.transcript
+                )
+                completeHandshake(applicationKeys: appKeys, resumptionMasterSecret: resumptionMasterSecret, kd: kd)
                 return
 
             default:
@@ -423,7 +484,8 @@ nonisolated final class TLSServer {
         }
     }
 
-    private func completeHandshake(applicationKeys: TLS13ApplicationKeys) {
+    private func completeHandshake(applicationKeys: TLS13ApplicationKeys, resumptionMasterSecret: Data,
+                                   kd: TLS13KeyDerivation) {
         let record = TLSRecordConnection(
             clientKey: applicationKeys.clientKey,
             clientIV: applicationKeys.clientIV,
@@ -435,6 +497,7 @@ nonisolated final class TLSServer {
             direction: .server
         )
         record.negotiatedALPN = negotiatedALPN
+        sendNewSessionTicket(on: record, resumptionMasterSecret: resumptionMasterSecret, kd: kd)
         let trailer = rxBuffer
         rxBuffer = Data()
 
@@ -448,6 +511,35 @@ nonisolated final class TLSServer {
         )
     }
 
+    /// Issues one ticket as the first server application-key record, so the app's next
+    /// connection to this host resumes without the certificate flight.
+    private func sendNewSessionTicket(on record: TLSRecordConnection, resumptionMasterSecret: Data,
+                                      kd: TLS13KeyDerivation) {
+        var nonce = Data(count: 8)
+        nonce.withUnsafeMutableBytes { _ = SecRandomCopyBytes(kSecRandomDefault, 8, $0.baseAddress!) }
+        let state = TLSServerSessionTickets.State(
+            psk: kd.resumptionPSK(resumptionMasterSecret: resumptionMasterSecret, ticketNonce: nonce),
+            cipherSuite: chosenCipherSuite,
+            sni: sni ?? "",
+            alpn: negotiatedALPN,
+            ageAdd: UInt32.random(in: .min ... .max),
+            issuedAt: CFAbsoluteTimeGetCurrent()
+        )
+        guard let ticket = TLSServerSessionTickets.shared.seal(state) else { return }
+        let message = TLSServerHelloBuilder.buildNewSessionTicket(
+            lifetime: TLSServerSessionTickets.lifetime,
+            ageAdd: state.ageAdd,
+            nonce: nonce,
+            ticket: ticket
+        )
+        let sealed = record.sendLock.withLock {
+            try? record.encryptTLS13Record(plaintext: message, contentType: TLSContentType.handshake)
+        }
+        if let sealed {
+            delegate?.tlsServer(self, didProduceOutput: sealed)
+        }
+    }
+
     // MARK: - Output Helpers
 
     func emitPlainHandshakeRecord(_ payload: Data) {
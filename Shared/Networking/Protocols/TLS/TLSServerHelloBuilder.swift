@@ -11,10 +11,12 @@ enum TLSServerHelloBuilder {
 
     // MARK: - ServerHello
 
+    /// - Parameter selectedIdentity: The accepted `pre_shared_key` identity on resumption.
     static func buildServerHello(
         legacySessionID: Data,
         cipherSuite: UInt16,
-        x25519PublicKey: Data
+        x25519PublicKey: Data,
+        selectedIdentity: UInt16? = nil
     ) -> Data {
         var random = Data(count: 32)
         random.withUnsafeMutableBytes { pointer in
@@ -33,6 +35,11 @@ enum TLSServerHelloBuilder {
         var extensions = Data()
         extensions.append(buildSupportedVersionsServerExt())
         extensions.append(buildKeyShareServerExt(group: TLSNamedGroup.x25519, key: x25519PublicKey))
+        if let selectedIdentity {
+            appendU16(&extensions, TLSExtensionType.preSharedKey)
+            appendU16(&extensions, 0x0002)
+            appendU16(&extensions, selectedIdentity)
+        }
         body.append(UInt8((extensions.count >> 8) & 0xFF))
         body.append(UInt8(extensions.count & 0xFF))
         body.append(extensions)
@@ -228,6 +235,20 @@ enum TLSServerHelloBuilder {
         wrapHandshake(type: TLSHandshakeType.finished, body: verifyData)
     }
 
+    // MARK: - NewSessionTicket
+
+    static func buildNewSessionTicket(lifetime: UInt32, ageAdd: UInt32, nonce: Data, ticket: Data) -> Data {
+        var body = Data()
+        withUnsafeBytes(of: lifetime.bigEndian) { body.append(contentsOf: $0) }
+        withUnsafeBytes(of: ageAdd.bigEndian) { body.append(contentsOf: $0) }
+        body.append(UInt8(nonce.count))
+        body.append(nonce)
+        appendU16(&body, UInt16(ticket.count))
+        body.append(ticket)
+        appendU16(&body, 0x0000)
+        return wrapHandshake(type: TLSHandshakeType.newSessionTicket, body: body)
+    }
+
     // MARK: - CertificateVerify Signing Helpers
 
     static func certificateVerifyContext(transcriptHash: Data) -> Data {
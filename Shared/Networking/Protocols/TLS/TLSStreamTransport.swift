@@ -6,6 +6,7 @@
 //
 
 import Foundation
+import Security
 
 nonisolated private let logger = AnywhereLogger(category: "TLSStreamTransport")
 
@@ -38,6 +39,17 @@ nonisolated class TLSStreamTransport {
 
     private(set) var isReady = false
 
+    /// Where a direct connection landed and the chain that verified it; `nil` before ready,
+    /// over a tunnel, or when the handshake kept no certificates (resumption).
+    var peerIdentity: (address: Data, certificates: [SecCertificate])? {
+        guard tunnel == nil, isReady, let tlsConnection,
+              !tlsConnection.peerCertificates.isEmpty,
+              let address = (tlsConnection.connection as? any TCPDialTransport)?.remoteAddress else {
+            return nil
+        }
+        return (address, tlsConnection.peerCertificates)
+    }
+
     // MARK: Initialization
 
     /// - Parameter sni: TLS SNI hostname; defaults to `host` when `nil`.
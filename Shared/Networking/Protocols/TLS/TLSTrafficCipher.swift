@@ -0,0 +1,105 @@
+//
+//  TLSTrafficCipher.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import CryptoKit
+
+/// One direction's AEAD record protection, resolved once per traffic key: the
+/// cipher kind, the `SymmetricKey`, and the static IV held as integers, so a
+/// record's nonce is built on the stack rather than from a `Data` copy.
+///
+/// Nonces are the IV XOR a 64-bit counter (RFC 8446 §5.3, RFC 7905). A TLS 1.2
+/// AES-GCM IV is RFC 5288's 4-byte salt; zero-extended, the same XOR yields
+/// salt ‖ explicit nonce, so the counter there is the record's explicit nonce.
+nonisolated struct TLSTrafficCipher {
+
+    private enum Kind {
+        case aesGCM
+        case chaChaPoly
+    }
+
+    private let kind: Kind
+    private let key: SymmetricKey
+    /// IV bytes 0..<4 and 4..<12, as big-endian integers.
+    private let ivHead: UInt32
+    private let ivTail: UInt64
+
+    init(cipherSuite: UInt16, key: Data, iv: Data) {
+        kind = TLSCipherSuite.isChaCha20(cipherSuite) ? .chaChaPoly : .aesGCM
+        self.key = SymmetricKey(data: key)
+        var head: UInt32 = 0
+        var tail: UInt64 = 0
+        for (i, byte) in iv.prefix(12).enumerated() {
+            if i < 4 {
+                head |= UInt32(byte) << ((3 - i) * 8)
+            } else {
+                tail |= UInt64(byte) << ((11 - i) * 8)
+            }
+        }
+        ivHead = head
+        ivTail = tail
+    }
+
+    @inline(__always)
+    private func withNonce<R>(_ counter: UInt64, _ body: (UnsafeRawBufferPointer) throws -> R) rethrows -> R {
+        let tail = ivTail ^ counter
+        let nonce = (ivHead.bigEndian, UInt32(truncatingIfNeeded: tail >> 32).bigEndian, UInt32(truncatingIfNeeded: tail).bigEndian)
+        return try withUnsafeBytes(of: nonce, body)
+    }
+
+    /// Appends ciphertext then tag to `records`, copied once out of the
+    /// sealed box's combined representation.
+    func seal<Plaintext: DataProtocol, AAD: DataProtocol>(_ plaintext: Plaintext, counter: UInt64, aad: AAD,
+                                                          appendingTo records: inout Data) throws {
+        let signpost = DataPathSignposts.begin("tlsSeal")
+        let start = HotPathMetrics.now()
+        defer {
+            HotPathMetrics.shared.recordCrypto(.tls, .seal, bytes: plaintext.count, since: start)
+            DataPathSignposts.end("tlsSeal", signpost)
+        }
+        switch kind {
+        case .chaChaPoly:
+            let sealedBox = try withNonce(counter) { nonce in
+                try ChaChaPoly.seal(plaintext, using: key, nonce: ChaChaPoly.Nonce(data: nonce), authenticating: aad)
+            }
+            records.append(sealedBox.combined.dropFirst(12))
+        case .aesGCM:
+            let sealedBox = try withNonce(counter) { nonce in
+                try AES.GCM.seal(plaintext, using: key, nonce: AES.GCM.Nonce(data: nonce), authenticating: aad)
+            }
+            guard let combined = sealedBox.combined else { throw TLSRecordError.encryptionFailed }
+            records.append(combined.dropFirst(12))
+        }
+    }
+
+    /// `ciphertext` and `tag` may be slices of the receive buffer; the sealed
+    /// box copies them once, and its plaintext is returned without another.
+    func open<AAD: DataProtocol>(ciphertext: Data, tag: Data, counter: UInt64, aad: AAD) throws -> Data {
+        let signpost = DataPathSignposts.begin("tlsOpen")
+        let start = HotPathMetrics.now()
+        defer {
+            HotPathMetrics.shared.recordCrypto(.tls, .open, bytes: ciphertext.count, since: start)
+            DataPathSignposts.end("tlsOpen", signpost)
+        }
+        do {
+            switch kind {
+            case .chaChaPoly:
+                let sealedBox = try withNonce(counter) { nonce in
+                    try ChaChaPoly.SealedBox(nonce: ChaChaPoly.Nonce(data: nonce), ciphertext: ciphertext, tag: tag)
+                }
+                return try ChaChaPoly.open(sealedBox, using: key, authenticating: aad)
+            case .aesGCM:
+                let sealedBox = try withNonce(counter) { nonce in
+                    try AES.GCM.SealedBox(nonce: AES.GCM.Nonce(data: nonce), ciphertext: ciphertext, tag: tag)
+                }
+                return try AES.GCM.open(sealedBox, using: key, authenticating: aad)
+            }
+        } catch CryptoKitError.authenticationFailure {
+            throw TLSRecordError.recordAuthenticationFailed
+        }
+    }
+}
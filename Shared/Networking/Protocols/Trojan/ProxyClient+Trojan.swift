@@ -22,6 +22,19 @@ extension ProxyClient {
             return
         }
 
+        if let warm = takePreDialed(security: .tls(tlsConfig)) {
+            wrapTrojan(
+                over: warm,
+                password: password,
+                command: command,
+                destinationHost: destinationHost,
+                destinationPort: destinationPort,
+                initialData: initialData,
+                completion: completion
+            )
+            return
+        }
+
         let tlsClient = TLSClient(configuration: tlsConfig)
 
         let handleTLSResult: (Result<TLSRecordConnection, Error>) -> Void = { [weak self] result in
@@ -38,6 +38,12 @@ nonisolated final class TrojanConnection: ProxyConnection {
         inner.sendRaw(data: consumeHeader().map { $0 + data } ?? data)
     }
 
+    override func flushDeferredHeader() {
+        if let header = consumeHeader() {
+            inner.sendRaw(data: header)
+        }
+    }
+
     override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
         inner.receiveRaw(completion: completion)
     }
@@ -78,15 +78,18 @@ enum TrojanProtocol {
     static func encodeUDPPacket(host: String, port: UInt16, payload: Data) -> Data {
         let address = encodeAddressPort(host: host, port: port)
         var out = Data(capacity: address.count + 4 + payload.count)
-        out.append(address)
-        let length = UInt16(min(payload.count, maxUDPPayloadLength))
-        out.append(UInt8(length >> 8))
-        out.append(UInt8(length & 0xFF))
-        out.append(0x0D); out.append(0x0A)
-        out.append(payload.prefix(Int(length)))
+        appendUDPPacket(to: &out, addressPort: address, payload: payload)
         return out
     }
 
+    /// Appends one UDP packet to `out`; `addressPort` is `encodeAddressPort`'s output.
+    static func appendUDPPacket(to out: inout Data, addressPort: Data, payload: Data) {
+        let length = min(payload.count, maxUDPPayloadLength)
+        out.append(addressPort)
+        out.append(contentsOf: [UInt8(length >> 8), UInt8(length & 0xFF), 0x0D, 0x0A])
+        out.append(payload.prefix(length))
+    }
+
     /// Parses one UDP packet from a buffered stream; nil when the buffer is short,
     /// throws on malformed framing so the caller tears down rather than desynchronize.
     static func tryDecodeUDPPacket(buffer: Data) throws -> (payload: Data, consumed: Int)? {
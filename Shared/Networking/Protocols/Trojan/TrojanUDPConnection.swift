@@ -12,21 +12,34 @@ nonisolated private let logger = AnywhereLogger(category: "TrojanUDPConnection")
 // MARK: - TrojanUDPConnection
 
 /// Each datagram is framed as `addr:port + length + CRLF + payload`, after a one-shot UDP request header.
+/// Datagrams sent in the same `writeQueue` turn share one inner write, and so one TLS record.
 nonisolated final class TrojanUDPConnection: ProxyConnection {
     private let inner: ProxyConnection
     private let passwordKey: Data
     private let destinationHost: String
     private let destinationPort: UInt16
+    /// Encoded once; every packet carries the same destination.
+    private let addressPort: Data
 
     private var headerSent = false
     /// Leftover TLS stream bytes carried across receives until a full packet is framed.
     private var receiveBuffer = Data()
+    /// Start of the unparsed bytes in `receiveBuffer`; consumed packets are dropped in one
+    /// go when the next record arrives rather than one at a time.
+    private var receiveOffset = 0
+
+    private let writeQueue = DispatchQueue(label: AWCore.Identifier.trojanUDPWriteQueue)
+    private var pendingWrites: [(payload: Data, completion: (Error?) -> Void)] = []
+    private var flushScheduled = false
+    /// One TLS record's plaintext; a lone larger packet still goes out whole.
+    private static let maxCoalescedBytes = 16_384
 
     init(inner: ProxyConnection, password: String, destinationHost: String, destinationPort: UInt16) {
         self.inner = inner
         self.passwordKey = TrojanProtocol.passwordKey(password)
         self.destinationHost = destinationHost
         self.destinationPort = destinationPort
+        self.addressPort = TrojanProtocol.encodeAddressPort(host: destinationHost, port: destinationPort)
         super.init()
     }
 
@@ -35,11 +48,18 @@ nonisolated final class TrojanUDPConnection: ProxyConnection {
     override var deliversDatagrams: Bool { true }
 
     override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
-        inner.sendRaw(data: frame(data), completion: completion)
+        lock.lock()
+        pendingWrites.append((data, completion))
+        let schedules = !flushScheduled
+        flushScheduled = true
+        lock.unlock()
+        if schedules {
+            writeQueue.async { [self] in flushPendingWrites() }
+        }
     }
 
     override func sendRaw(data: Data) {
-        inner.sendRaw(data: frame(data))
+        sendRaw(data: data, completion: { _ in })
     }
 
     override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
@@ -52,31 +72,67 @@ nonisolated final class TrojanUDPConnection: ProxyConnection {
 
     // MARK: - Framing
 
-    private func frame(_ payload: Data) -> Data {
-        var out = Data()
+    /// Frames queued datagrams, whole, up to `maxCoalescedBytes` straight into one buffer
+    /// and sends it; whatever is left goes out on the next turn. Runs on `writeQueue`,
+    /// which keeps the writes in order.
+    private func flushPendingWrites() {
         lock.lock()
-        if !headerSent {
-            out.append(TrojanProtocol.buildRequestHeader(
-                passwordKey: passwordKey,
-                command: TrojanProtocol.commandUDP,
-                host: destinationHost,
-                port: destinationPort
-            ))
-            headerSent = true
+        var size = 0
+        var taken = 0
+        while taken < pendingWrites.count {
+            let packetSize = addressPort.count + 4 + min(pendingWrites[taken].payload.count, TrojanProtocol.maxUDPPayloadLength)
+            if taken > 0 && size + packetSize > Self.maxCoalescedBytes { break }
+            size += packetSize
+            taken += 1
         }
+        let batch = pendingWrites.prefix(taken)
+        pendingWrites.removeFirst(taken)
+        let hasMore = !pendingWrites.isEmpty
+        flushScheduled = hasMore
+        let header: Data? = headerSent ? nil : TrojanProtocol.buildRequestHeader(
+            passwordKey: passwordKey,
+            command: TrojanProtocol.commandUDP,
+            host: destinationHost,
+            port: destinationPort
+        )
+        headerSent = true
         lock.unlock()
-        out.append(TrojanProtocol.encodeUDPPacket(host: destinationHost, port: destinationPort, payload: payload))
-        return out
+
+        var output = Data(capacity: (header?.count ?? 0) + size)
+        if let header { output.append(header) }
+        for write in batch {
+            TrojanProtocol.appendUDPPacket(to: &output, addressPort: addressPort, payload: write.payload)
+        }
+        let completions = batch.map(\.completion)
+        inner.sendRaw(data: output) { error in
+            for completion in completions {
+                completion(error)
+            }
+        }
+        if hasMore {
+            writeQueue.async { [self] in flushPendingWrites() }
+        }
     }
 
+    /// Serves packets from the buffered record bytes and reads another record only once
+    /// they hold no complete packet.
     private func deliverNextPacket(completion: @escaping (Data?, Error?) -> Void) {
         do {
-            let parsed: (payload: Data, consumed: Int)? = try lock.withLock {
-                try TrojanProtocol.tryDecodeUDPPacket(buffer: receiveBuffer)
+            let payload: Data? = try lock.withLock {
+                guard let parsed = try TrojanProtocol.tryDecodeUDPPacket(
+                    buffer: receiveBuffer[(receiveBuffer.startIndex + receiveOffset)...]
+                ) else {
+                    return nil
+                }
+                receiveOffset += parsed.consumed
+                if receiveOffset == receiveBuffer.count {
+                    receiveBuffer.removeAll(keepingCapacity: true)
+                    receiveOffset = 0
+                }
+                return parsed.payload
             }
-            if let parsed {
-                lock.withLock { receiveBuffer.removeFirst(parsed.consumed) }
-                completion(parsed.payload, nil)
+            if let payload {
+                completion(payload, nil)
                 return
             }
         } catch {
@@ -97,7 +153,14 @@ nonisolated final class TrojanUDPConnection: ProxyConnection {
                 completion(nil, nil)
                 return
             }
-            self.lock.withLock { self.receiveBuffer.append(data) }
+            self.lock.withLock {
+                if self.receiveOffset > 0 {
+                    let start = self.receiveBuffer.startIndex
+                    self.receiveBuffer.removeSubrange(start..<(start + self.receiveOffset))
+                    self.receiveOffset = 0
+                }
+                self.receiveBuffer.append(data)
+            }
             self.deliverNextPacket(completion: completion)
         }
     }
@@ -9,11 +9,16 @@ import Foundation
 
 // MARK: - GRPCConnection
 
-nonisolated class GRPCConnection {
+/// One HTTP/2 connection carrying gRPC `Tun` calls, each a ``GRPCStream`` on its own stream ID.
+/// A dedicated connection carries a single stream and is torn down with it; a pooled one
+/// (see ``GRPCConnectionPool``) opens further streams via `tryReserveStream`/`openReservedStream`
+/// and outlives them. One read loop, started after setup, demultiplexes frames to the streams.
+nonisolated class GRPCConnection: Multiplexer {
 
     // MARK: Transport closures
 
     private let transportSend: (Data, @escaping (Error?) -> Void) -> Void
+    private let transportSendChain: (ByteChain, @escaping (Error?) -> Void) -> Void
     private let transportReceive: (@escaping (Data?, Bool, Error?) -> Void) -> Void
     private let transportCancel: () -> Void
 
@@ -22,43 +27,52 @@ nonisolated class GRPCConnection {
     private let configuration: GRPCConfiguration
     private let authority: String
 
+    /// Whether the connection is shared through ``GRPCConnectionPool``.
+    let isPooled: Bool
+
     // MARK: State
 
+    /// Guards the connection state and every ``GRPCStream`` field.
     private let lock = UnfairLock()
     private var _isConnected = false
 
-    /// First client-initiated stream ID (odd per RFC 7540 §5.1.1).
-    private static let streamId: UInt32 = 1
+    /// Open streams by ID; a stream leaves when its caller cancels it or the connection closes.
+    private var streams: [UInt32: GRPCStream] = [:]
+    /// Next client-initiated stream ID (odd per RFC 7540 §5.1.1).
+    private var nextStreamId: UInt32 = 1
+    /// Streams promised by `tryReserveStream` but not yet opened.
+    private var reservedStreams = 0
+    /// Serializes stream-ID allocation with the HEADERS write, so streams open in ID order
+    /// (RFC 7540 §5.1.1). Never held together with a transport completion.
+    private let openLock = UnfairLock()
+    /// Set on GOAWAY: no new streams, and the connection closes once its streams drain.
+    private var goingAway = false
 
     /// Raw HTTP/2 byte buffer (accumulates transport reads until a full frame is parseable).
     private var h2ReadBuffer = Data()
-    /// Reassembles HTTP/2 DATA payloads into length-prefixed gRPC frames.
-    private var grpcFrameBuffer = Data()
-    /// Decoded app-layer bytes awaiting delivery to the caller.
-    private var decodedBuffer = Data()
 
     /// Consecutive synchronous frame parses; trampolined every 16th to avoid stack overflow.
     private var h2ReadDepth: Int = 0
 
-    /// Whether the gRPC response HEADERS (status 200) have been validated.
-    private var h2ResponseReceived = false
-    /// Whether the server has closed its side of the stream (END_STREAM flag on HEADERS or DATA).
-    private var h2StreamClosed = false
-
-    /// Peer's flow-control windows (bytes we can still send without another WINDOW_UPDATE).
+    /// Peer's connection flow-control window (bytes we can still send without another WINDOW_UPDATE).
     private var h2PeerConnectionWindow: Int = 65535
-    private var h2PeerStreamSendWindow: Int = 65535
     private var h2PeerInitialWindowSize: Int = 65535
 
-    /// Local window size, advertised at setup and used as the WINDOW_UPDATE threshold.
+    /// SETTINGS_MAX_CONCURRENT_STREAMS from the peer; unlimited until it says otherwise.
+    private var h2PeerMaxConcurrentStreams = Int.max
+
+    /// Local stream window size, advertised at setup and used as the WINDOW_UPDATE threshold.
     private var h2LocalWindowSize: Int = 4_194_304 // 4 MB
 
+    /// Grows `h2LocalWindowSize` to the measured BDP; nil when `initialWindowsSize` pins the
+    /// window, matching grpc-go, where an explicit window disables BDP estimation.
+    private var windowTuner: H2WindowTuner?
+
     /// Maximum HTTP/2 frame payload size (SETTINGS_MAX_FRAME_SIZE default, updated by peer).
     private var h2MaxFrameSize: Int = 16384
 
-    /// Bytes received but not yet acknowledged via WINDOW_UPDATE.
+    /// Bytes received but not yet acknowledged via a connection WINDOW_UPDATE.
     private var h2ConnectionReceiveConsumed: Int = 0
-    private var h2StreamReceiveConsumed: Int = 0
 
     /// Send-side continuations waiting for a WINDOW_UPDATE that re-opens flow control.
     private var h2FlowResumptions: [() -> Void] = []
@@ -66,6 +80,12 @@ nonisolated class GRPCConnection {
     /// Keepalive ping timer (nil when idleTimeout == 0).
     private var keepaliveTimer: DispatchSourceTimer?
 
+    /// Fired once when the connection closes, so a pool can evict it.
+    var onClose: (() -> Void)?
+
+    /// Dial-time objects (TLS/Reality client) kept alive for a pooled connection's lifetime.
+    private var retained: [AnyObject] = []
+
     /// Safety cap on the raw H2 buffer so a misbehaving peer can't grow memory without bound.
     private static let maxH2ReadBufferSize = 2_097_152 // 2 MB
     /// Safety cap on the gRPC reassembly buffer (individual messages > this are an error).
@@ -78,38 +98,50 @@ nonisolated class GRPCConnection {
         return connected
     }
 
+    /// Whether the peer sent GOAWAY; the pool stops handing out streams on it.
+    var isGoingAway: Bool {
+        lock.withLock { goingAway }
+    }
+
     // MARK: - Initializers
 
-    init(transport: TransportClosures, configuration: GRPCConfiguration, authority: String) {
+    init(transport: TransportClosures, configuration: GRPCConfiguration, authority: String, isPooled: Bool = false) {
         self.configuration = configuration
         self.authority = authority
+        self.isPooled = isPooled
         self.transportSend = transport.send
+        self.transportSendChain = transport.sendChain
         self.transportReceive = transport.receive
         self.transportCancel = transport.cancel
         self._isConnected = true
 
         if configuration.initialWindowsSize > 0 {
             self.h2LocalWindowSize = configuration.initialWindowsSize
+        } else {
+            self.windowTuner = H2WindowTuner(initialWindow: h2LocalWindowSize)
         }
     }
 
-    convenience init(transport: NWTCPTransport, configuration: GRPCConfiguration, authority: String) {
-        self.init(transport: TransportClosures(tcp: transport), configuration: configuration, authority: authority)
+    convenience init(transport: any TCPDialTransport, configuration: GRPCConfiguration, authority: String, isPooled: Bool = false) {
+        self.init(transport: TransportClosures(tcp: transport), configuration: configuration, authority: authority, isPooled: isPooled)
     }
 
-    convenience init(tlsConnection: TLSRecordConnection, configuration: GRPCConfiguration, authority: String) {
-        self.init(transport: TransportClosures(tls: tlsConnection), configuration: configuration, authority: authority)
+    convenience init(tlsConnection: TLSRecordConnection, configuration: GRPCConfiguration, authority: String, isPooled: Bool = false) {
+        self.init(transport: TransportClosures(tls: tlsConnection), configuration: configuration, authority: authority, isPooled: isPooled)
     }
 
     convenience init(tunnel: ProxyConnection, configuration: GRPCConfiguration, authority: String) {
         self.init(transport: TransportClosures(tunnel: tunnel), configuration: configuration, authority: authority)
     }
 
+    /// Keeps a dial-time object (TLS/Reality client) alive for the connection's lifetime.
+    func retain(_ object: AnyObject) { lock.lock(); retained.append(object); lock.unlock() }
+
     // MARK: - Setup
 
-    /// Sends the HTTP/2 preface + SETTINGS and opens the gRPC stream without waiting for
+    /// Sends the HTTP/2 preface + SETTINGS and opens the first gRPC stream without waiting for
     /// the server's SETTINGS; some CDNs defer response HEADERS until the first DATA frame.
-    func performSetup(completion: @escaping (Error?) -> Void) {
+    func performSetup(completion: @escaping (Result<GRPCStream, Error>) -> Void) {
         var initData = Data()
 
         // HTTP/2 connection preface (RFC 7540 §3.5).
@@ -128,43 +160,38 @@ nonisolated class GRPCConnection {
         initData.append(buildH2Frame(type: Self.h2FrameSettings, flags: 0, streamId: 0, payload: settingsPayload))
 
         // Connection-level WINDOW_UPDATE (1 GB).
-        let connWindowInc = Self.h2ConnectionWindowSize
-        var windowUpdatePayload = Data(count: 4)
-        windowUpdatePayload[0] = UInt8((connWindowInc >> 24) & 0xFF)
-        windowUpdatePayload[1] = UInt8((connWindowInc >> 16) & 0xFF)
-        windowUpdatePayload[2] = UInt8((connWindowInc >> 8) & 0xFF)
-        windowUpdatePayload[3] = UInt8(connWindowInc & 0xFF)
-        initData.append(buildH2Frame(type: Self.h2FrameWindowUpdate, flags: 0, streamId: 0, payload: windowUpdatePayload))
+        initData.append(windowUpdateFrame(streamId: 0, increment: Self.h2ConnectionWindowSize))
 
         // HEADERS for the gRPC stream; END_STREAM deliberately unset — the tunnel keeps sending DATA.
-        let headerBlock = encodeGRPCRequestHeaders()
+        let stream = lock.withLock { makeStreamLocked() }
         initData.append(buildH2Frame(
             type: Self.h2FrameHeaders,
             flags: Self.h2FlagEndHeaders,
-            streamId: Self.streamId,
-            payload: headerBlock
+            streamId: stream.streamId,
+            payload: encodeGRPCRequestHeaders()
         ))
 
         transportSend(initData) { [weak self] error in
             if let error {
-                completion(GRPCError.setupFailed("H2 preface/HEADERS write failed: \(error.localizedDescription)"))
+                completion(.failure(GRPCError.setupFailed("H2 preface/HEADERS write failed: \(error.localizedDescription)")))
                 return
             }
-            self?.processInitialServerFrames(completion: completion)
+            self?.processInitialServerFrames(stream: stream, completion: completion)
         }
     }
 
     /// Reads frames until the server's SETTINGS is received and ACKed, handling
     /// WINDOW_UPDATE/PING and absorbing an early response HEADERS along the way.
-    private func processInitialServerFrames(completion: @escaping (Error?) -> Void) {
+    /// On success the read loop takes over.
+    private func processInitialServerFrames(stream: GRPCStream, completion: @escaping (Result<GRPCStream, Error>) -> Void) {
         readH2Frame { [weak self] result in
             guard let self else {
-                completion(GRPCError.connectionClosed)
+                completion(.failure(GRPCError.connectionClosed))
                 return
             }
             switch result {
             case .failure(let error):
-                completion(GRPCError.setupFailed("H2 setup read failed: \(error.localizedDescription)"))
+                completion(.failure(GRPCError.setupFailed("H2 setup read failed: \(error.localizedDescription)")))
 
             case .success(let frame):
                 switch frame.type {
@@ -173,115 +200,247 @@ nonisolated class GRPCConnection {
                         self.parseH2Settings(frame.payload)
                         let ack = self.buildH2Frame(type: Self.h2FrameSettings, flags: Self.h2FlagAck, streamId: 0, payload: Data())
                         self.transportSend(ack) { _ in }
-                        self.startKeepaliveIfNeeded()
-                        completion(nil)
+                        self.finishSetup(stream: stream, completion: completion)
                     } else {
                         // ACK for our own SETTINGS; keep reading for the server's.
-                        self.processInitialServerFrames(completion: completion)
+                        self.processInitialServerFrames(stream: stream, completion: completion)
                     }
 
                 case Self.h2FrameHeaders:
-                    if frame.streamId == Self.streamId {
+                    if frame.streamId == stream.streamId {
                         if let rejection = self.checkH2ResponseStatus(frame.payload) {
-                            completion(GRPCError.setupFailed("gRPC response rejected: \(rejection)"))
+                            completion(.failure(GRPCError.setupFailed("gRPC response rejected: \(rejection)")))
                             return
                         }
                         // Trailers-only response: HTTP 200 but the gRPC call itself failed.
                         if frame.flags & Self.h2FlagEndStream != 0 {
                             if let grpcError = Self.parseGRPCTrailer(frame.payload) {
                                 self.lock.lock()
-                                self.h2StreamClosed = true
+                                stream.remoteClosed = true
                                 self.lock.unlock()
-                                completion(GRPCError.setupFailed(grpcError.localizedDescription))
+                                completion(.failure(GRPCError.setupFailed(grpcError.localizedDescription)))
                                 return
                             }
                         }
                         self.lock.lock()
-                        self.h2ResponseReceived = true
+                        stream.responseReceived = true
                         self.lock.unlock()
                     }
-                    self.startKeepaliveIfNeeded()
-                    completion(nil)
+                    self.finishSetup(stream: stream, completion: completion)
 
                 case Self.h2FrameWindowUpdate:
                     self.handleWindowUpdate(frame: frame)
-                    self.processInitialServerFrames(completion: completion)
+                    self.processInitialServerFrames(stream: stream, completion: completion)
 
                 case Self.h2FramePing:
                     if frame.flags & Self.h2FlagAck == 0 {
                         let pong = self.buildH2Frame(type: Self.h2FramePing, flags: Self.h2FlagAck, streamId: 0, payload: frame.payload)
                         self.transportSend(pong) { _ in }
                     }
-                    self.processInitialServerFrames(completion: completion)
+                    self.processInitialServerFrames(stream: stream, completion: completion)
 
                 case Self.h2FrameGoaway:
                     let reason = Self.describeGoawayPayload(frame.payload)
-                    completion(GRPCError.setupFailed("Server sent GOAWAY during setup (\(reason))"))
+                    completion(.failure(GRPCError.setupFailed("Server sent GOAWAY during setup (\(reason))")))
 
                 case Self.h2FrameRstStream:
-                    if frame.streamId == Self.streamId {
+                    if frame.streamId == stream.streamId {
                         let reason = Self.describeRstStreamPayload(frame.payload)
-                        completion(GRPCError.setupFailed("Server reset the stream during setup (\(reason))"))
+                        completion(.failure(GRPCError.setupFailed("Server reset the stream during setup (\(reason))")))
                         return
                     }
-                    self.processInitialServerFrames(completion: completion)
+                    self.processInitialServerFrames(stream: stream, completion: completion)
 
                 default:
-                    self.processInitialServerFrames(completion: completion)
+                    self.processInitialServerFrames(stream: stream, completion: completion)
                 }
             }
         }
     }
 
-    // MARK: - Public send / receive
+    private func finishSetup(stream: GRPCStream, completion: @escaping (Result<GRPCStream, Error>) -> Void) {
+        startKeepaliveIfNeeded()
+        readNextFrame()
+        completion(.success(stream))
+    }
+
+    // MARK: - Streams
 
-    /// Sends a raw byte chunk as one gRPC `Hunk` message on the open stream.
-    func send(data: Data, completion: @escaping (Error?) -> Void) {
-        let message = Self.encodeHunk(data)
-        let framed = Self.wrapGRPCMessage(message)
-        sendH2Data(data: framed, offset: 0, completion: completion)
+    /// Allocates the next stream ID. Caller holds `lock` (and `openLock` once the connection is shared).
+    private func makeStreamLocked() -> GRPCStream {
+        let stream = GRPCStream(streamId: nextStreamId, connection: self, peerSendWindow: h2PeerInitialWindowSize)
+        nextStreamId += 2
+        streams[stream.streamId] = stream
+        return stream
     }
 
-    func send(data: Data) {
-        send(data: data) { _ in }
+    /// Claims a slot for one more stream, within the peer's concurrency limit and the stream-ID
+    /// space. Must be followed by `openReservedStream`.
+    func tryReserveStream() -> Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        guard _isConnected, !goingAway,
+              streams.count + reservedStreams < h2PeerMaxConcurrentStreams,
+              UInt64(nextStreamId) + 2 * UInt64(reservedStreams) <= 0x7FFF_FFFF else { return false }
+        reservedStreams += 1
+        return true
     }
 
-    /// Delivers the next decoded payload, or `nil` on EOF; buffered leftovers are returned first.
-    func receive(completion: @escaping (Data?, Error?) -> Void) {
+    /// Opens a stream reserved by `tryReserveStream` by sending its HEADERS; nil if the
+    /// connection closed or went away in between.
+    func openReservedStream() -> GRPCStream? {
+        openLock.lock()
+        defer { openLock.unlock() }
+
         lock.lock()
-        if !decodedBuffer.isEmpty {
-            let out = decodedBuffer
-            decodedBuffer.removeAll(keepingCapacity: true)
+        reservedStreams -= 1
+        guard _isConnected, !goingAway else {
             lock.unlock()
-            completion(out, nil)
-            return
+            return nil
+        }
+        let stream = makeStreamLocked()
+        lock.unlock()
+
+        let headers = buildH2Frame(
+            type: Self.h2FrameHeaders,
+            flags: Self.h2FlagEndHeaders,
+            streamId: stream.streamId,
+            payload: encodeGRPCRequestHeaders()
+        )
+        transportSend(headers) { [weak self] error in
+            if let error { self?.close(error: error) }
         }
-        if h2StreamClosed {
+        return stream
+    }
+
+    /// Number of open and reserved streams, for idle eviction.
+    var activeStreamCount: Int {
+        lock.withLock { streams.count + reservedStreams }
+    }
+
+    var isClosed: Bool {
+        !isConnected
+    }
+
+    func isStreamConnected(_ stream: GRPCStream) -> Bool {
+        lock.withLock { _isConnected && !stream.cancelled }
+    }
+
+    // MARK: - Public send / receive
+
+    /// Sends a raw byte chunk on `stream`. The first chunk goes out at once; chunks that
+    /// arrive while it is on the wire queue and leave together when it completes, as one
+    /// `MultiHunk` in multi mode or back-to-back `Hunk` messages otherwise, so a burst of
+    /// small writes costs one transport write rather than one each.
+    func send(data: Data, on stream: GRPCStream, completion: @escaping (Error?) -> Void) {
+        lock.lock()
+        if stream.sendInFlight {
+            stream.pendingSends.append((data, completion))
             lock.unlock()
-            completion(nil, nil)
             return
         }
+        stream.sendInFlight = true
         lock.unlock()
+        sendBatch([(data, completion)], on: stream)
+    }
+
+    private func sendBatch(_ batch: [(data: Data, completion: (Error?) -> Void)], on stream: GRPCStream) {
+        let framed = Self.frameHunks(batch.map(\.data), multi: configuration.multiMode)
+        sendH2Data(data: framed, offset: 0, on: stream) { [weak self] error in
+            for entry in batch { entry.completion(error) }
+            guard let self else { return }
+            self.lock.lock()
+            var next: [(data: Data, completion: (Error?) -> Void)] = []
+            var nextBytes = 0
+            while !stream.pendingSends.isEmpty, next.isEmpty || nextBytes < Self.maxCoalescedSendBytes {
+                let entry = stream.pendingSends.removeFirst()
+                nextBytes += entry.data.count
+                next.append(entry)
+            }
+            if next.isEmpty { stream.sendInFlight = false }
+            self.lock.unlock()
+            if !next.isEmpty { self.sendBatch(next, on: stream) }
+        }
+    }
 
-        readAndDecode(completion: completion)
+    /// Delivers `stream`'s next decoded payload, or `nil` on EOF; buffered leftovers are returned first.
+    func receive(on stream: GRPCStream, completion: @escaping (Data?, Error?) -> Void) {
+        lock.lock()
+        stream.pendingReceive = completion
+        let delivery = takeDeliveryLocked(stream)
+        lock.unlock()
+        delivery?()
     }
 
     // MARK: - Cancel
 
+    /// Ends `stream`. A dedicated connection goes down with it; a pooled one resets just the
+    /// stream and stays up for others.
+    func cancel(_ stream: GRPCStream) {
+        guard isPooled else {
+            close(error: nil)
+            return
+        }
+        lock.lock()
+        guard !stream.cancelled else {
+            lock.unlock()
+            return
+        }
+        stream.cancelled = true
+        let sendReset = _isConnected && !stream.remoteClosed
+        stream.grpcFrameBuffer = Data()
+        stream.decodedBuffer = Data()
+        let pending = stream.pendingReceive
+        stream.pendingReceive = nil
+        streams.removeValue(forKey: stream.streamId)
+        let drained = goingAway && streams.isEmpty && reservedStreams == 0
+        lock.unlock()
+
+        if sendReset {
+            transportSend(rstStreamFrame(streamId: stream.streamId, errorCode: Self.h2ErrorCancel)) { _ in }
+        }
+        pending?(nil, nil)
+        if drained { close(error: nil) }
+    }
+
+    /// Tears down the whole connection.
     func cancel() {
+        close(error: nil)
+    }
+
+    /// Closes the connection: every stream sees its buffered data and then `error` (EOF when
+    /// nil), blocked sends are woken to fail, and the transport is cancelled.
+    func close(error: Error?) {
         lock.lock()
+        guard _isConnected else {
+            lock.unlock()
+            return
+        }
         _isConnected = false
-        h2StreamClosed = true
         h2ReadBuffer.removeAll()
-        grpcFrameBuffer.removeAll()
-        decodedBuffer.removeAll()
         keepaliveTimer?.cancel()
         keepaliveTimer = nil
+        var deliveries: [() -> Void] = []
+        for stream in streams.values {
+            stream.remoteClosed = true
+            if let error, stream.failure == nil {
+                stream.failure = error
+            }
+            if let delivery = takeDeliveryLocked(stream) {
+                deliveries.append(delivery)
+            }
+        }
+        streams.removeAll()
         let waiters = h2FlowResumptions
         h2FlowResumptions.removeAll()
+        let onClose = self.onClose
+        self.onClose = nil
         lock.unlock()
+
         for r in waiters { r() }
+        for delivery in deliveries { delivery() }
         transportCancel()
+        onClose?()
     }
 
     deinit {
@@ -306,10 +465,14 @@ extension GRPCConnection {
     static let h2FrameGoaway: UInt8 = 0x07
     static let h2FrameWindowUpdate: UInt8 = 0x08
 
+    static let h2SettingsMaxConcurrentStreams: UInt16 = 0x03
+
     static let h2FlagEndStream: UInt8 = 0x01
     static let h2FlagEndHeaders: UInt8 = 0x04
     static let h2FlagAck: UInt8 = 0x01
 
+    static let h2ErrorCancel: UInt32 = 0x08
+
     static let h2ConnectionWindowSize: UInt32 = 1_073_741_824 // 1 GB
 }
 
@@ -416,9 +579,12 @@ extension GRPCConnection {
         }
     }
 
-    /// Parses a server SETTINGS payload and applies INITIAL_WINDOW_SIZE / MAX_FRAME_SIZE.
+    /// Parses a server SETTINGS payload and applies MAX_CONCURRENT_STREAMS /
+    /// INITIAL_WINDOW_SIZE / MAX_FRAME_SIZE.
     fileprivate func parseH2Settings(_ payload: Data) {
         var offset = payload.startIndex
+        var resumptions: [() -> Void] = []
+        lock.lock()
         while offset + 6 <= payload.endIndex {
             let id = (UInt16(payload[offset]) << 8) | UInt16(payload[offset + 1])
             let value = (UInt32(payload[offset + 2]) << 24)
@@ -428,20 +594,26 @@ extension GRPCConnection {
             offset += 6
 
             switch id {
-            case 0x04: // INITIAL_WINDOW_SIZE — adjusts only stream windows (RFC 7540 §6.9.2).
-                lock.lock()
+            case Self.h2SettingsMaxConcurrentStreams:
+                h2PeerMaxConcurrentStreams = Int(value)
+            case 0x04: // INITIAL_WINDOW_SIZE — adjusts every stream window, not the connection's (RFC 7540 §6.9.2).
                 let delta = Int(value) - h2PeerInitialWindowSize
                 h2PeerInitialWindowSize = Int(value)
-                h2PeerStreamSendWindow += delta
-                lock.unlock()
+                for stream in streams.values {
+                    stream.peerSendWindow += delta
+                }
+                if delta > 0 {
+                    resumptions = h2FlowResumptions
+                    h2FlowResumptions.removeAll()
+                }
             case 0x05: // MAX_FRAME_SIZE
-                lock.lock()
                 h2MaxFrameSize = Int(value)
-                lock.unlock()
             default:
                 break
             }
         }
+        lock.unlock()
+        for r in resumptions { r() }
     }
 
     /// Applies a WINDOW_UPDATE to the send windows and wakes blocked sends.
@@ -452,8 +624,8 @@ extension GRPCConnection {
             let increment = Int(raw & 0x7FFFFFFF)
             if frame.streamId == 0 {
                 h2PeerConnectionWindow += increment
-            } else if frame.streamId == Self.streamId {
-                h2PeerStreamSendWindow += increment
+            } else {
+                streams[frame.streamId]?.peerSendWindow += increment
             }
         }
         let resumptions = h2FlowResumptions
@@ -461,6 +633,20 @@ extension GRPCConnection {
         lock.unlock()
         for r in resumptions { r() }
     }
+
+    fileprivate func windowUpdateFrame(streamId: UInt32, increment: UInt32) -> Data {
+        var payload = Data(count: 4)
+        payload[0] = UInt8((increment >> 24) & 0xFF); payload[1] = UInt8((increment >> 16) & 0xFF)
+        payload[2] = UInt8((increment >> 8) & 0xFF); payload[3] = UInt8(increment & 0xFF)
+        return buildH2Frame(type: Self.h2FrameWindowUpdate, flags: 0, streamId: streamId, payload: payload)
+    }
+
+    fileprivate func rstStreamFrame(streamId: UInt32, errorCode: UInt32) -> Data {
+        var payload = Data(count: 4)
+        payload[0] = UInt8((errorCode >> 24) & 0xFF); payload[1] = UInt8((errorCode >> 16) & 0xFF)
+        payload[2] = UInt8((errorCode >> 8) & 0xFF); payload[3] = UInt8(errorCode & 0xFF)
+        return buildH2Frame(type: Self.h2FrameRstStream, flags: 0, streamId: streamId, payload: payload)
+    }
 }
 
 // MARK: - HPACK encoding for request HEADERS
@@ -475,79 +661,36 @@ extension GRPCConnection {
         // Pseudo-header order required by RFC 7540 §8.1.2.1: :authority, :method, :path, :scheme.
 
         // :authority — literal w/ incremental indexing, static-table name index 1.
-        var authBytes = Self.hpackEncodeInteger(1, prefixBits: 6)
-        authBytes[0] |= 0x40
-        block.append(contentsOf: authBytes)
-        block.append(contentsOf: Self.hpackEncodeString(authority))
+        HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 1, value: authority, into: &block)
 
         // :method POST — static-table entry 3.
         block.append(0x83)
 
         // :path — literal w/ incremental indexing, static-table name index 4.
         let path = configuration.resolvedPath()
-        var pathBytes = Self.hpackEncodeInteger(4, prefixBits: 6)
-        pathBytes[0] |= 0x40
-        block.append(contentsOf: pathBytes)
-        block.append(contentsOf: Self.hpackEncodeString(path))
+        HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 4, value: path, into: &block)
 
         // :scheme https — static-table entry 7.
         block.append(0x87)
 
         // content-type: application/grpc — literal w/ incremental indexing, name index 31.
-        var ctBytes = Self.hpackEncodeInteger(31, prefixBits: 6)
-        ctBytes[0] |= 0x40
-        block.append(contentsOf: ctBytes)
-        block.append(contentsOf: Self.hpackEncodeString("application/grpc"))
+        HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 31, value: "application/grpc", into: &block)
 
         // `te: trailers` is required by the gRPC spec; servers reject requests without it.
-        block.append(0x40)
-        block.append(contentsOf: Self.hpackEncodeString("te"))
-        block.append(contentsOf: Self.hpackEncodeString("trailers"))
+        HPACKEncoder.encodeLiteralWithIndexing(name: "te", value: "trailers", into: &block)
 
         // grpc-encoding: identity — outgoing messages are not compressed.
-        block.append(0x40)
-        block.append(contentsOf: Self.hpackEncodeString("grpc-encoding"))
-        block.append(contentsOf: Self.hpackEncodeString("identity"))
+        HPACKEncoder.encodeLiteralWithIndexing(name: "grpc-encoding", value: "identity", into: &block)
 
         // grpc-accept-encoding: identity — only identity encoding is decodable here.
-        block.append(0x40)
-        block.append(contentsOf: Self.hpackEncodeString("grpc-accept-encoding"))
-        block.append(contentsOf: Self.hpackEncodeString("identity"))
+        HPACKEncoder.encodeLiteralWithIndexing(name: "grpc-accept-encoding", value: "identity", into: &block)
 
         // user-agent — literal w/ incremental indexing, static-table name index 58.
         let ua = configuration.userAgent.isEmpty ? ProxyUserAgent.default : configuration.userAgent
-        var uaBytes = Self.hpackEncodeInteger(58, prefixBits: 6)
-        uaBytes[0] |= 0x40
-        block.append(contentsOf: uaBytes)
-        block.append(contentsOf: Self.hpackEncodeString(ua))
+        HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 58, value: ua, into: &block)
 
         return block
     }
-
-    /// HPACK integer encoding (RFC 7541 §5.1).
-    fileprivate static func hpackEncodeInteger(_ value: Int, prefixBits: Int) -> [UInt8] {
-        let maxPrefix = (1 << prefixBits) - 1
-        if value < maxPrefix {
-            return [UInt8(value)]
-        }
-        var bytes: [UInt8] = [UInt8(maxPrefix)]
-        var remaining = value - maxPrefix
-        while remaining >= 128 {
-            bytes.append(UInt8(remaining & 0x7F) | 0x80)
-            remaining >>= 7
-        }
-        bytes.append(UInt8(remaining))
-        return bytes
-    }
-
-    /// HPACK string encoding — plain bytes, no Huffman (RFC 7541 §5.2).
-    fileprivate static func hpackEncodeString(_ string: String) -> [UInt8] {
-        let bytes = Array(string.utf8)
-        var result = hpackEncodeInteger(bytes.count, prefixBits: 7)
-        result[0] &= 0x7F
-        result.append(contentsOf: bytes)
-        return result
-    }
 }
 
 // MARK: - HPACK decoding for response :status
@@ -614,85 +757,89 @@ extension GRPCConnection {
             let status = String(data: valueData, encoding: .ascii) ?? "?"
             return status == "200" ? nil : "status \(status)"
         }
-        let status = Self.huffmanDecodeDigits(valueData)
+        let status = HPACKHuffman.decode(valueData).flatMap { String(bytes: $0, encoding: .ascii) } ?? ""
         if status.isEmpty { return "status (huffman)" }
         return status == "200" ? nil : "status \(status)"
     }
-
-    /// Decodes a Huffman-encoded digit-only value (RFC 7541 App. B: '0'..'2' are 5-bit, '3'..'9' 6-bit).
-    private static func huffmanDecodeDigits(_ data: Data) -> String {
-        var result = ""
-        var bits: UInt32 = 0
-        var numBits = 0
-        for byte in data {
-            bits = (bits << 8) | UInt32(byte)
-            numBits += 8
-        }
-        while numBits >= 5 {
-            let top5 = Int((bits >> (numBits - 5)) & 0x1F)
-            if top5 <= 0x02 {
-                result.append(Character(UnicodeScalar(48 + top5)!))
-                numBits -= 5
-                continue
-            }
-            guard numBits >= 6 else { break }
-            let top6 = Int((bits >> (numBits - 6)) & 0x3F)
-            if top6 >= 0x19 && top6 <= 0x1F {
-                let digit = top6 - 0x19 + 3
-                result.append(Character(UnicodeScalar(48 + digit)!))
-                numBits -= 6
-                continue
-            }
-            break
-        }
-        return result
-    }
 }
 
 // MARK: - gRPC / protobuf framing
 
 extension GRPCConnection {
 
-    /// Encodes a `Hunk` protobuf (`bytes data = 1`): `0x0A <varint length> <bytes>`.
-    fileprivate static func encodeHunk(_ data: Data) -> Data {
-        var out = Data(capacity: 1 + 10 + data.count)
-        out.append(0x0A) // (field 1 << 3) | wire type 2 (length-delimited)
-        out.append(varintEncode(UInt64(data.count)))
-        out.append(data)
-        return out
+    /// Bytes of queued chunks one coalesced send takes; the rest wait for the next.
+    fileprivate static let maxCoalescedSendBytes = 64 * 1024
+
+    /// Frames `payloads` as gRPC messages: each message is the 5-byte prefix
+    /// `[compressed=0][u32be length]` and then one `0x0A <varint length> <bytes>` field per
+    /// payload (`bytes data = 1`, field 1 << 3 | wire type 2). `multi` packs every payload into
+    /// one `MultiHunk` (`repeated bytes data = 1`); otherwise each is its own `Hunk`. All
+    /// headers are written into one buffer and the payloads follow it by reference.
+    fileprivate static func frameHunks(_ payloads: [Data], multi: Bool) -> ByteChain {
+        var headers = Data(capacity: 5 + payloads.count * (multi ? 6 : 11))
+        // (end of the header run, payload) pairs, in wire order.
+        var pieces: [(headerEnd: Int, payload: Data)] = []
+        pieces.reserveCapacity(payloads.count)
+
+        if multi {
+            let fieldsLength = payloads.reduce(0) { $0 + 1 + varintLength(UInt64($1.count)) + $1.count }
+            appendMessagePrefix(length: fieldsLength, to: &headers)
+        }
+        for payload in payloads {
+            if !multi {
+                appendMessagePrefix(length: 1 + varintLength(UInt64(payload.count)) + payload.count, to: &headers)
+            }
+            headers.append(0x0A)
+            appendVarint(UInt64(payload.count), to: &headers)
+            pieces.append((headers.count, payload))
+        }
+
+        var chain = ByteChain()
+        var headerStart = 0
+        for piece in pieces {
+            chain.append(headers[headerStart..<piece.headerEnd])
+            chain.append(piece.payload)
+            headerStart = piece.headerEnd
+        }
+        return chain
     }
 
-    /// Wraps a protobuf message in the 5-byte gRPC prefix: `[compressed=0][u32be length][message]`.
-    fileprivate static func wrapGRPCMessage(_ message: Data) -> Data {
-        var out = Data(capacity: 5 + message.count)
+    private static func appendMessagePrefix(length: Int, to out: inout Data) {
+        let length = UInt32(length)
         out.append(0x00)
-        let length = UInt32(message.count)
         out.append(UInt8((length >> 24) & 0xFF))
         out.append(UInt8((length >> 16) & 0xFF))
         out.append(UInt8((length >> 8) & 0xFF))
         out.append(UInt8(length & 0xFF))
-        out.append(message)
-        return out
     }
 
-    private static func varintEncode(_ value: UInt64) -> Data {
-        var out = Data()
+    private static func appendVarint(_ value: UInt64, to out: inout Data) {
         var v = value
         while v >= 0x80 {
             out.append(UInt8((v & 0x7F) | 0x80))
             v >>= 7
         }
         out.append(UInt8(v))
-        return out
     }
 
-    /// Protobuf varint decoder. Returns `(value, bytesConsumed)` or `nil` if truncated.
-    fileprivate static func varintDecode(_ data: Data, at startOffset: Int) -> (value: UInt64, consumed: Int)? {
+    private static func varintLength(_ value: UInt64) -> Int {
+        var length = 1
+        var v = value
+        while v >= 0x80 {
+            length += 1
+            v >>= 7
+        }
+        return length
+    }
+
+    /// Protobuf varint decoder over `bytes[offset..<end]`. Returns `(value, bytesConsumed)`
+    /// or `nil` if truncated.
+    private static func varintDecode(_ bytes: UnsafeRawBufferPointer, at startOffset: Int, end: Int) -> (value: UInt64, consumed: Int)? {
         var value: UInt64 = 0
         var shift: UInt64 = 0
         var offset = startOffset
-        while offset < data.count {
-            let b = data[data.startIndex + offset]
+        while offset < end {
+            let b = bytes[offset]
             value |= UInt64(b & 0x7F) << shift
             offset += 1
             if b & 0x80 == 0 {
@@ -704,86 +851,94 @@ extension GRPCConnection {
         return nil
     }
 
-    /// Decodes a `Hunk` or `MultiHunk` into concatenated raw bytes: both carry `data` as
-    /// field 1 (wire type 2), so every field-1 occurrence is appended; unknown fields are skipped.
-    fileprivate static func decodeHunkPayload(_ message: Data) throws -> Data {
-        var out = Data()
-        var offset = 0
-        while offset < message.count {
-            guard let (tag, tagConsumed) = varintDecode(message, at: offset) else {
-                throw GRPCError.invalidResponse("truncated protobuf tag")
-            }
-            offset += tagConsumed
-            let fieldNumber = Int(tag >> 3)
-            let wireType = Int(tag & 0x07)
-
-            switch wireType {
-            case 2: // length-delimited
-                guard let (length, lenConsumed) = varintDecode(message, at: offset) else {
-                    throw GRPCError.invalidResponse("truncated protobuf length")
-                }
-                offset += lenConsumed
-                let lenInt = Int(length)
-                guard offset + lenInt <= message.count else {
-                    throw GRPCError.invalidResponse("truncated protobuf value")
-                }
-                if fieldNumber == 1 {
-                    out.append(message.subdata(in: message.startIndex + offset ..< message.startIndex + offset + lenInt))
+    /// Decodes the `Hunk` or `MultiHunk` at `range` of `buffer` (absolute indices) straight
+    /// into `out`: both carry `data` as field 1 (wire type 2), so every field-1 occurrence is
+    /// appended; unknown fields are skipped.
+    fileprivate static func decodeHunkPayload(_ buffer: Data, in range: Range<Int>, into out: inout Data) throws {
+        try buffer.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+            let end = range.upperBound - buffer.startIndex
+            var offset = range.lowerBound - buffer.startIndex
+            while offset < end {
+                guard let (tag, tagConsumed) = varintDecode(bytes, at: offset, end: end) else {
+                    throw GRPCError.invalidResponse("truncated protobuf tag")
                 }
-                offset += lenInt
-            case 0: // varint — skip
-                guard let (_, vConsumed) = varintDecode(message, at: offset) else {
-                    throw GRPCError.invalidResponse("truncated varint field")
-                }
-                offset += vConsumed
-            case 5: // fixed32 — skip
-                guard offset + 4 <= message.count else {
-                    throw GRPCError.invalidResponse("truncated fixed32 field")
-                }
-                offset += 4
-            case 1: // fixed64 — skip
-                guard offset + 8 <= message.count else {
-                    throw GRPCError.invalidResponse("truncated fixed64 field")
+                offset += tagConsumed
+                let fieldNumber = Int(tag >> 3)
+                let wireType = Int(tag & 0x07)
+
+                switch wireType {
+                case 2: // length-delimited
+                    guard let (length, lenConsumed) = varintDecode(bytes, at: offset, end: end) else {
+                        throw GRPCError.invalidResponse("truncated protobuf length")
+                    }
+                    offset += lenConsumed
+                    guard length <= UInt64(end - offset) else {
+                        throw GRPCError.invalidResponse("truncated protobuf value")
+                    }
+                    let lenInt = Int(length)
+                    if fieldNumber == 1, lenInt > 0 {
+                        out.append(UnsafeRawBufferPointer(rebasing: bytes[offset..<(offset + lenInt)]))
+                    }
+                    offset += lenInt
+                case 0: // varint — skip
+                    guard let (_, vConsumed) = varintDecode(bytes, at: offset, end: end) else {
+                        throw GRPCError.invalidResponse("truncated varint field")
+                    }
+                    offset += vConsumed
+                case 5: // fixed32 — skip
+                    guard offset + 4 <= end else {
+                        throw GRPCError.invalidResponse("truncated fixed32 field")
+                    }
+                    offset += 4
+                case 1: // fixed64 — skip
+                    guard offset + 8 <= end else {
+                        throw GRPCError.invalidResponse("truncated fixed64 field")
+                    }
+                    offset += 8
+                default:
+                    throw GRPCError.invalidResponse("unknown protobuf wire type \(wireType)")
                 }
-                offset += 8
-            default:
-                throw GRPCError.invalidResponse("unknown protobuf wire type \(wireType)")
             }
         }
-        return out
     }
 }
 
+
 // MARK: - HTTP/2 DATA send (respects flow control)
 
 extension GRPCConnection {
 
-    /// Sends `data` as DATA frames, batching as much as the flow-control window allows
-    /// into one transport write; the remainder waits for a WINDOW_UPDATE.
-    fileprivate func sendH2Data(data: Data, offset: Int, completion: @escaping (Error?) -> Void) {
+    /// Sends `data` as DATA frames on `stream`, batching as much as the connection and stream
+    /// windows allow into one transport write; the remainder waits for a WINDOW_UPDATE.
+    fileprivate func sendH2Data(data: ByteChain, offset: Int, on stream: GRPCStream, completion: @escaping (Error?) -> Void) {
         guard offset < data.count else {
             completion(nil)
             return
         }
 
         lock.lock()
-        if h2StreamClosed {
+        if !_isConnected || stream.cancelled || stream.remoteClosed {
             lock.unlock()
             completion(GRPCError.connectionClosed)
             return
         }
         let maxSize = h2MaxFrameSize
-        let window = min(h2PeerConnectionWindow, h2PeerStreamSendWindow)
+        let window = min(h2PeerConnectionWindow, stream.peerSendWindow)
 
         guard window > 0 else {
             h2FlowResumptions.append { [weak self] in
-                self?.sendH2Data(data: data, offset: offset, completion: completion)
+                guard let self else {
+                    completion(GRPCError.connectionClosed)
+                    return
+                }
+                self.sendH2Data(data: data, offset: offset, on: stream, completion: completion)
             }
             lock.unlock()
             return
         }
 
-        var frames = Data()
+        // Frames reference the message by slice; the bytes are gathered once, at the transport.
+        var frames = ByteChain()
         var currentOffset = offset
         var windowRemaining = window
         while currentOffset < data.count {
@@ -791,297 +946,293 @@ extension GRPCConnection {
             let chunkSize = min(remaining, min(maxSize, windowRemaining))
             guard chunkSize > 0 else { break }
 
-            let chunk = Data(data[data.startIndex + currentOffset ..< data.startIndex + currentOffset + chunkSize])
-            frames.append(buildH2Frame(type: Self.h2FrameData, flags: 0, streamId: Self.streamId, payload: chunk))
+            let chunk = data.slice(currentOffset ..< currentOffset + chunkSize)
+            H2Framing.appendFrame(type: Self.h2FrameData, flags: 0, streamId: stream.streamId, payload: chunk, to: &frames)
             currentOffset += chunkSize
             windowRemaining -= chunkSize
         }
         let totalSent = window - windowRemaining
         h2PeerConnectionWindow -= totalSent
-        h2PeerStreamSendWindow -= totalSent
+        stream.peerSendWindow -= totalSent
         lock.unlock()
 
         let nextOffset = currentOffset
-        transportSend(frames) { [weak self] error in
+        transportSendChain(frames) { [weak self] error in
             if let error {
-                self?.markClosed()
+                self?.close(error: error)
                 completion(error)
                 return
             }
             if nextOffset < data.count {
-                self?.sendH2Data(data: data, offset: nextOffset, completion: completion)
+                self?.sendH2Data(data: data, offset: nextOffset, on: stream, completion: completion)
             } else {
                 completion(nil)
             }
         }
     }
-
-    private func markClosed() {
-        lock.lock()
-        h2StreamClosed = true
-        lock.unlock()
-    }
 }
 
 // MARK: - Receive pipeline
 
 extension GRPCConnection {
 
-    /// Pulls H2 frames until an application payload is ready; management frames are handled inline.
-    fileprivate func readAndDecode(completion: @escaping (Data?, Error?) -> Void) {
+    /// The connection's read loop: demultiplexes every frame to its stream until the
+    /// transport ends. Started once setup completes.
+    fileprivate func readNextFrame() {
         readH2Frame { [weak self] result in
-            guard let self else {
-                completion(nil, GRPCError.connectionClosed)
-                return
-            }
+            guard let self else { return }
             switch result {
             case .failure(let error):
                 if let grpcError = error as? GRPCError, case .streamEnded = grpcError {
-                    // Graceful end of stream → flush any buffered payload, then EOF.
-                    self.lock.lock()
-                    self.h2StreamClosed = true
-                    let leftover = self.decodedBuffer
-                    self.decodedBuffer.removeAll(keepingCapacity: true)
-                    self.lock.unlock()
-                    completion(leftover.isEmpty ? nil : leftover, nil)
+                    // Graceful transport FIN: streams flush their buffers, then see EOF.
+                    self.close(error: nil)
                 } else {
-                    completion(nil, error)
+                    self.close(error: error)
                 }
-
             case .success(let frame):
-                let isOurStream = frame.streamId == Self.streamId
-
-                switch frame.type {
-                case Self.h2FrameData:
-                    self.handleDataFrame(frame: frame, isOurStream: isOurStream, completion: completion)
+                self.handleFrame(frame)
+                if self.isConnected {
+                    self.readNextFrame()
+                }
+            }
+        }
+    }
 
-                case Self.h2FrameHeaders:
-                    // Could be the initial 200 OK response or the terminal trailer HEADERS.
-                    if isOurStream {
-                        let endOfStream = (frame.flags & Self.h2FlagEndStream) != 0
-                        if !self.markResponseReceivedIfNeeded(frame.payload, completion: completion) {
-                            return
-                        }
-                        if endOfStream {
-                            // Trailer HEADERS end the stream; non-zero grpc-status surfaces as an error, not silent EOF.
-                            let grpcError = Self.parseGRPCTrailer(frame.payload)
-                            self.lock.lock()
-                            self.h2StreamClosed = true
-                            let leftover = self.decodedBuffer
-                            self.decodedBuffer.removeAll(keepingCapacity: true)
-                            self.lock.unlock()
-                            if let grpcError {
-                                completion(nil, grpcError)
-                            } else if leftover.isEmpty {
-                                completion(nil, nil)
-                            } else {
-                                completion(leftover, nil)
-                            }
-                            return
-                        }
-                    }
-                    self.readAndDecode(completion: completion)
+    private func handleFrame(_ frame: (type: UInt8, flags: UInt8, streamId: UInt32, payload: Data)) {
+        switch frame.type {
+        case Self.h2FrameData:
+            handleDataFrame(frame: frame)
 
-                case Self.h2FrameSettings:
-                    if frame.flags & Self.h2FlagAck == 0 {
-                        self.parseH2Settings(frame.payload)
-                        let ack = self.buildH2Frame(type: Self.h2FrameSettings, flags: Self.h2FlagAck, streamId: 0, payload: Data())
-                        self.transportSend(ack) { _ in }
-                    }
-                    self.readAndDecode(completion: completion)
+        case Self.h2FrameHeaders:
+            handleHeadersFrame(frame: frame)
 
-                case Self.h2FrameWindowUpdate:
-                    self.handleWindowUpdate(frame: frame)
-                    self.readAndDecode(completion: completion)
+        case Self.h2FrameSettings:
+            if frame.flags & Self.h2FlagAck == 0 {
+                parseH2Settings(frame.payload)
+                let ack = buildH2Frame(type: Self.h2FrameSettings, flags: Self.h2FlagAck, streamId: 0, payload: Data())
+                transportSend(ack) { _ in }
+            }
 
-                case Self.h2FramePing:
-                    if frame.flags & Self.h2FlagAck == 0 {
-                        let pong = self.buildH2Frame(type: Self.h2FramePing, flags: Self.h2FlagAck, streamId: 0, payload: frame.payload)
-                        self.transportSend(pong) { _ in }
-                    }
-                    self.readAndDecode(completion: completion)
+        case Self.h2FrameWindowUpdate:
+            handleWindowUpdate(frame: frame)
 
-                case Self.h2FrameGoaway:
-                    self.lock.lock()
-                    self.h2StreamClosed = true
-                    let leftover = self.decodedBuffer
-                    self.decodedBuffer.removeAll(keepingCapacity: true)
-                    self.lock.unlock()
-                    if leftover.isEmpty {
-                        completion(nil, nil)
-                    } else {
-                        completion(leftover, nil)
-                    }
+        case Self.h2FramePing:
+            if frame.flags & Self.h2FlagAck == 0 {
+                let pong = buildH2Frame(type: Self.h2FramePing, flags: Self.h2FlagAck, streamId: 0, payload: frame.payload)
+                transportSend(pong) { _ in }
+            } else if frame.payload == H2WindowTuner.pingPayload {
+                handleBDPPingAck()
+            }
 
-                case Self.h2FrameRstStream:
-                    if isOurStream {
-                        self.lock.lock()
-                        self.h2StreamClosed = true
-                        let leftover = self.decodedBuffer
-                        self.decodedBuffer.removeAll(keepingCapacity: true)
-                        self.lock.unlock()
-                        if leftover.isEmpty {
-                            completion(nil, nil)
-                        } else {
-                            completion(leftover, nil)
-                        }
-                    } else {
-                        self.readAndDecode(completion: completion)
-                    }
+        case Self.h2FrameGoaway:
+            handleGoaway(frame: frame)
 
-                default:
-                    self.readAndDecode(completion: completion)
-                }
+        case Self.h2FrameRstStream:
+            lock.lock()
+            var delivery: (() -> Void)?
+            if let stream = streams[frame.streamId] {
+                stream.remoteClosed = true
+                delivery = takeDeliveryLocked(stream)
             }
+            lock.unlock()
+            delivery?()
+
+        default:
+            break
         }
     }
 
-    /// Validates the first HEADERS on our stream; returns `false` if an error was already
-    /// delivered to `completion`.
-    private func markResponseReceivedIfNeeded(_ payload: Data, completion: @escaping (Data?, Error?) -> Void) -> Bool {
+    /// Validates the response HEADERS, or applies the trailer HEADERS that end the stream;
+    /// a non-zero grpc-status surfaces as an error after any buffered data, not silent EOF.
+    private func handleHeadersFrame(frame: (type: UInt8, flags: UInt8, streamId: UInt32, payload: Data)) {
         lock.lock()
-        if h2ResponseReceived {
+        guard let stream = streams[frame.streamId] else {
             lock.unlock()
-            return true
+            return
         }
+        let needsStatus = !stream.responseReceived
         lock.unlock()
 
-        if let rejection = checkH2ResponseStatus(payload) {
-            lock.lock()
-            h2StreamClosed = true
-            lock.unlock()
-            completion(nil, GRPCError.invalidResponse("gRPC response rejected: \(rejection)"))
-            return false
+        var failure: Error?
+        if needsStatus, let rejection = checkH2ResponseStatus(frame.payload) {
+            failure = GRPCError.invalidResponse("gRPC response rejected: \(rejection)")
+        }
+        let endOfStream = (frame.flags & Self.h2FlagEndStream) != 0
+        if failure == nil, endOfStream {
+            failure = Self.parseGRPCTrailer(frame.payload)
         }
+
         lock.lock()
-        h2ResponseReceived = true
+        stream.responseReceived = true
+        if failure != nil || endOfStream {
+            stream.remoteClosed = true
+            if stream.failure == nil { stream.failure = failure }
+        }
+        let delivery = takeDeliveryLocked(stream)
         lock.unlock()
-        return true
+        delivery?()
     }
 
-    /// Buffers a DATA payload, decodes all complete gRPC messages, and delivers the bytes.
-    private func handleDataFrame(
-        frame: (type: UInt8, flags: UInt8, streamId: UInt32, payload: Data),
-        isOurStream: Bool,
-        completion: @escaping (Data?, Error?) -> Void
-    ) {
-        let endOfStream = (frame.flags & Self.h2FlagEndStream) != 0
+    /// Buffers a DATA payload into its stream and decodes all complete gRPC messages.
+    /// The connection window is re-opened at once; the stream window only as the caller
+    /// drains the stream, so a slow stream throttles its own sender and no other.
+    private func handleDataFrame(frame: (type: UInt8, flags: UInt8, streamId: UInt32, payload: Data)) {
+        let received = frame.payload.count
+        var updates = Data()
 
-        // Ack bytes even on unexpected streams so the connection window stays open.
-        emitWindowUpdatesIfNeeded(receivedBytes: frame.payload.count, onOurStream: isOurStream)
+        lock.lock()
+        let threshold = h2LocalWindowSize / 2
+        // Ack bytes even on unknown or reset streams so the connection window stays open.
+        h2ConnectionReceiveConsumed += received
+        if h2ConnectionReceiveConsumed >= threshold {
+            updates.append(windowUpdateFrame(streamId: 0, increment: UInt32(h2ConnectionReceiveConsumed)))
+            h2ConnectionReceiveConsumed = 0
+        }
 
-        guard isOurStream else {
-            readAndDecode(completion: completion)
-            return
+        if windowTuner?.noteReceived(received) == true {
+            updates.append(buildH2Frame(type: Self.h2FramePing, flags: 0, streamId: 0, payload: H2WindowTuner.pingPayload))
         }
 
-        var decoded = Data()
-        var streamClosed = false
-        var decodeError: Error?
+        guard let stream = streams[frame.streamId] else {
+            lock.unlock()
+            if !updates.isEmpty { transportSend(updates) { _ in } }
+            return
+        }
 
-        lock.lock()
-        if !frame.payload.isEmpty {
-            grpcFrameBuffer.append(frame.payload)
-            if grpcFrameBuffer.count > Self.maxGRPCFrameBufferSize {
-                grpcFrameBuffer.removeAll()
-                lock.unlock()
-                completion(nil, GRPCError.invalidResponse("gRPC frame buffer overflow"))
-                return
+        stream.receiveConsumed += received
+        if !frame.payload.isEmpty, stream.failure == nil {
+            stream.grpcFrameBuffer.append(frame.payload)
+            if stream.grpcFrameBuffer.count > Self.maxGRPCFrameBufferSize {
+                stream.grpcFrameBuffer.removeAll()
+                stream.failure = GRPCError.invalidResponse("gRPC frame buffer overflow")
             }
         }
 
-        while grpcFrameBuffer.count >= 5 {
-            let compressed = grpcFrameBuffer[grpcFrameBuffer.startIndex]
-            let length = (UInt32(grpcFrameBuffer[grpcFrameBuffer.startIndex + 1]) << 24)
-                | (UInt32(grpcFrameBuffer[grpcFrameBuffer.startIndex + 2]) << 16)
-                | (UInt32(grpcFrameBuffer[grpcFrameBuffer.startIndex + 3]) << 8)
-                | UInt32(grpcFrameBuffer[grpcFrameBuffer.startIndex + 4])
+        // Every complete message is decoded where it lies; the consumed prefix is dropped once.
+        let buffer = stream.grpcFrameBuffer
+        var consumed = 0
+        while stream.failure == nil, buffer.count - consumed >= 5 {
+            let base = buffer.startIndex + consumed
+            let compressed = buffer[base]
+            let length = (UInt32(buffer[base + 1]) << 24)
+                | (UInt32(buffer[base + 2]) << 16)
+                | (UInt32(buffer[base + 3]) << 8)
+                | UInt32(buffer[base + 4])
             let total = 5 + Int(length)
-            guard grpcFrameBuffer.count >= total else { break }
-
-            let messageData = grpcFrameBuffer.subdata(
-                in: grpcFrameBuffer.startIndex + 5 ..< grpcFrameBuffer.startIndex + total
-            )
-            grpcFrameBuffer.removeFirst(total)
-            if grpcFrameBuffer.isEmpty {
-                grpcFrameBuffer = Data()
-            } else {
-                grpcFrameBuffer = Data(grpcFrameBuffer)
-            }
+            guard buffer.count - consumed >= total else { break }
+            consumed += total
 
             if compressed != 0 {
-                decodeError = GRPCError.compressedMessageUnsupported
+                stream.failure = GRPCError.compressedMessageUnsupported
                 break
             }
             do {
-                let payload = try Self.decodeHunkPayload(messageData)
-                if !payload.isEmpty {
-                    decoded.append(payload)
-                }
+                try Self.decodeHunkPayload(buffer, in: (base + 5)..<(base + total), into: &stream.decodedBuffer)
             } catch {
-                decodeError = error
-                break
+                stream.failure = error
             }
         }
+        if consumed == buffer.count || stream.failure != nil {
+            stream.grpcFrameBuffer = Data()
+        } else if consumed > 0 {
+            stream.grpcFrameBuffer = buffer.subdata(in: (buffer.startIndex + consumed)..<buffer.endIndex)
+        }
 
-        if endOfStream {
-            h2StreamClosed = true
-            streamClosed = true
+        if stream.failure != nil || (frame.flags & Self.h2FlagEndStream) != 0 {
+            stream.remoteClosed = true
         }
+        if let update = streamWindowUpdateLocked(stream) {
+            updates.append(update)
+        }
+        let delivery = takeDeliveryLocked(stream)
         lock.unlock()
 
-        if let decodeError {
-            completion(nil, decodeError)
-            return
-        }
+        if !updates.isEmpty { transportSend(updates) { _ in } }
+        delivery?()
+    }
 
-        if decoded.isEmpty {
-            if streamClosed {
-                completion(nil, nil)
-            } else {
-                readAndDecode(completion: completion)
-            }
+    /// Applies a grown BDP estimate by raising SETTINGS_INITIAL_WINDOW_SIZE, which widens every
+    /// open stream's window by the delta (RFC 7540 §6.9.2) and sizes new streams to match.
+    private func handleBDPPingAck() {
+        lock.lock()
+        guard let grown = windowTuner?.pingAcknowledged() else {
+            lock.unlock()
             return
         }
+        h2LocalWindowSize = grown
+        lock.unlock()
 
-        completion(decoded, nil)
+        let size = UInt32(grown)
+        let payload = Data([
+            0x00, 0x04,
+            UInt8((size >> 24) & 0xFF), UInt8((size >> 16) & 0xFF),
+            UInt8((size >> 8) & 0xFF), UInt8(size & 0xFF),
+        ])
+        transportSend(buildH2Frame(type: Self.h2FrameSettings, flags: 0, streamId: 0, payload: payload)) { _ in }
     }
 
-    /// Emits WINDOW_UPDATEs once half the local window is consumed, batching flow-control updates.
-    private func emitWindowUpdatesIfNeeded(receivedBytes: Int, onOurStream: Bool) {
-        guard receivedBytes > 0 else { return }
+    /// Stops new streams and ends those the server won't process (ID above `lastStreamId`,
+    /// RFC 7540 §6.8); the rest run to completion, after which the connection closes.
+    private func handleGoaway(frame: (type: UInt8, flags: UInt8, streamId: UInt32, payload: Data)) {
+        var lastStreamId = UInt32(0x7FFF_FFFF)
+        if frame.payload.count >= 4 {
+            let raw = frame.payload.prefix(4).withUnsafeBytes { $0.load(as: UInt32.self).bigEndian }
+            lastStreamId = raw & 0x7FFFFFFF
+        }
 
         lock.lock()
-        h2ConnectionReceiveConsumed += receivedBytes
-        if onOurStream {
-            h2StreamReceiveConsumed += receivedBytes
+        goingAway = true
+        var deliveries: [() -> Void] = []
+        for (id, stream) in streams where id > lastStreamId {
+            stream.remoteClosed = true
+            streams.removeValue(forKey: id)
+            if let delivery = takeDeliveryLocked(stream) {
+                deliveries.append(delivery)
+            }
         }
-        let windowSize = h2LocalWindowSize
-        let threshold = windowSize / 2
-        let connConsumed = h2ConnectionReceiveConsumed
-        let streamConsumed = h2StreamReceiveConsumed
-        if connConsumed >= threshold { h2ConnectionReceiveConsumed = 0 }
-        if onOurStream, streamConsumed >= threshold { h2StreamReceiveConsumed = 0 }
+        let drained = streams.isEmpty && reservedStreams == 0
         lock.unlock()
 
-        var updates = Data()
-        if connConsumed >= threshold {
-            let increment = UInt32(connConsumed)
-            var payload = Data(count: 4)
-            payload[0] = UInt8((increment >> 24) & 0xFF); payload[1] = UInt8((increment >> 16) & 0xFF)
-            payload[2] = UInt8((increment >> 8) & 0xFF); payload[3] = UInt8(increment & 0xFF)
-            updates.append(buildH2Frame(type: Self.h2FrameWindowUpdate, flags: 0, streamId: 0, payload: payload))
+        for delivery in deliveries { delivery() }
+        if drained { close(error: nil) }
+    }
+
+    /// Completes `stream`'s pending receive if something can be delivered: buffered data
+    /// first, then the terminal error or EOF. Caller holds `lock`; run the result after
+    /// releasing it.
+    fileprivate func takeDeliveryLocked(_ stream: GRPCStream) -> (() -> Void)? {
+        guard let pending = stream.pendingReceive else { return nil }
+
+        if !stream.decodedBuffer.isEmpty {
+            let out = stream.decodedBuffer
+            stream.decodedBuffer = Data()
+            stream.pendingReceive = nil
+            let update = _isConnected ? streamWindowUpdateLocked(stream) : nil
+            return { [weak self] in
+                if let update { self?.transportSend(update) { _ in } }
+                pending(out, nil)
+            }
         }
-        if onOurStream, streamConsumed >= threshold {
-            let increment = UInt32(streamConsumed)
-            var payload = Data(count: 4)
-            payload[0] = UInt8((increment >> 24) & 0xFF); payload[1] = UInt8((increment >> 16) & 0xFF)
-            payload[2] = UInt8((increment >> 8) & 0xFF); payload[3] = UInt8(increment & 0xFF)
-            updates.append(buildH2Frame(type: Self.h2FrameWindowUpdate, flags: 0, streamId: Self.streamId, payload: payload))
+        if let failure = stream.failure {
+            stream.pendingReceive = nil
+            return { pending(nil, failure) }
         }
-        if !updates.isEmpty {
-            transportSend(updates) { _ in }
+        if stream.remoteClosed || stream.cancelled || !_isConnected {
+            stream.pendingReceive = nil
+            return { pending(nil, nil) }
         }
+        return nil
+    }
+
+    /// A stream WINDOW_UPDATE once half the local window is consumed and nothing is left
+    /// waiting for the caller. Caller holds `lock`.
+    private func streamWindowUpdateLocked(_ stream: GRPCStream) -> Data? {
+        guard !stream.remoteClosed,
+              stream.decodedBuffer.isEmpty,
+              stream.receiveConsumed >= h2LocalWindowSize / 2 else { return nil }
+        let increment = UInt32(stream.receiveConsumed)
+        stream.receiveConsumed = 0
+        return windowUpdateFrame(streamId: stream.streamId, increment: increment)
     }
 }
 
@@ -1110,9 +1261,11 @@ extension GRPCConnection {
         timer.resume()
     }
 
+    /// Pings only while streams are open, unless `permitWithoutStream` keeps an idle pooled
+    /// connection warm too.
     private func sendKeepalivePing() {
         lock.lock()
-        if h2StreamClosed {
+        if !_isConnected || (streams.isEmpty && !configuration.permitWithoutStream) {
             lock.unlock()
             return
         }
@@ -1190,7 +1343,7 @@ extension GRPCConnection {
 
     /// Returns `.callFailed` when the trailer's `grpc-status` is non-zero; `nil` on OK or absent.
     fileprivate static func parseGRPCTrailer(_ payload: Data) -> GRPCError? {
-        let headers = decodeHPACKHeaders(payload)
+        let headers = decodeTrailerHeaders(payload)
         guard let statusStr = headers["grpc-status"], let status = Int(statusStr), status != 0 else {
             return nil
         }
@@ -1222,251 +1375,14 @@ extension GRPCConnection {
         }
     }
 
-    /// Minimal HPACK decoder for trailer HEADERS; dynamic-table entries are parsed but not
-    /// stored. Names are lowercased, last value wins.
-    fileprivate static func decodeHPACKHeaders(_ payload: Data) -> [String: String] {
+    /// Decodes a trailer HEADERS block with the shared HPACK codec. Names are lowercased, last
+    /// value wins; a block that fails to decode (e.g. one referencing the connection's dynamic
+    /// table, which is not tracked here) yields no headers.
+    fileprivate static func decodeTrailerHeaders(_ payload: Data) -> [String: String] {
         var headers: [String: String] = [:]
-        var offset = payload.startIndex
-
-        while offset < payload.endIndex {
-            let b = payload[offset]
-
-            // 1xxxxxxx — indexed header field
-            if b & 0x80 != 0 {
-                let (idx, consumed) = decodeHPACKInteger(payload, at: offset, prefixBits: 7)
-                offset += consumed
-                if let entry = staticTableEntry(at: idx), let value = entry.value {
-                    headers[entry.name] = value
-                }
-                continue
-            }
-
-            // 01xxxxxx — literal with incremental indexing
-            if b & 0xC0 == 0x40 {
-                let (nameIdx, nameConsumed) = decodeHPACKInteger(payload, at: offset, prefixBits: 6)
-                offset += nameConsumed
-                let name: String
-                if nameIdx == 0 {
-                    guard let (n, c) = decodeHPACKString(payload, at: offset) else { return headers }
-                    name = n
-                    offset += c
-                } else {
-                    name = staticTableEntry(at: nameIdx)?.name ?? ""
-                }
-                guard let (value, vc) = decodeHPACKString(payload, at: offset) else { return headers }
-                offset += vc
-                if !name.isEmpty { headers[name.lowercased()] = value }
-                continue
-            }
-
-            // 001xxxxx — dynamic table size update
-            if b & 0xE0 == 0x20 {
-                let (_, consumed) = decodeHPACKInteger(payload, at: offset, prefixBits: 5)
-                offset += consumed
-                continue
-            }
-
-            // 0000xxxx — literal without indexing, 0001xxxx — literal never indexed
-            if b & 0xF0 == 0x00 || b & 0xF0 == 0x10 {
-                let (nameIdx, nameConsumed) = decodeHPACKInteger(payload, at: offset, prefixBits: 4)
-                offset += nameConsumed
-                let name: String
-                if nameIdx == 0 {
-                    guard let (n, c) = decodeHPACKString(payload, at: offset) else { return headers }
-                    name = n
-                    offset += c
-                } else {
-                    name = staticTableEntry(at: nameIdx)?.name ?? ""
-                }
-                guard let (value, vc) = decodeHPACKString(payload, at: offset) else { return headers }
-                offset += vc
-                if !name.isEmpty { headers[name.lowercased()] = value }
-                continue
-            }
-
-            return headers
+        for field in HPACKEncoder.decodeHeaders(from: payload) ?? [] {
+            headers[field.name.lowercased()] = field.value
         }
         return headers
     }
-
-    /// HPACK integer decoder (RFC 7541 §5.1). Returns (value, bytesConsumed).
-    private static func decodeHPACKInteger(_ data: Data, at start: Int, prefixBits: Int) -> (Int, Int) {
-        let maxPrefix = (1 << prefixBits) - 1
-        guard start < data.endIndex else { return (0, 0) }
-        let first = Int(data[start] & UInt8(maxPrefix))
-        if first < maxPrefix { return (first, 1) }
-        var value = maxPrefix
-        var shift = 0
-        var offset = start + 1
-        while offset < data.endIndex {
-            let b = data[offset]
-            value += (Int(b & 0x7F)) << shift
-            offset += 1
-            shift += 7
-            if b & 0x80 == 0 { return (value, offset - start) }
-            if shift >= 64 { return (value, offset - start) }
-        }
-        return (value, offset - start)
-    }
-
-    /// HPACK string decoder (RFC 7541 §5.2). Returns (string, bytesConsumed).
-    private static func decodeHPACKString(_ data: Data, at start: Int) -> (String, Int)? {
-        guard start < data.endIndex else { return nil }
-        let meta = data[start]
-        let isHuffman = (meta & 0x80) != 0
-        let (length, lenConsumed) = decodeHPACKInteger(data, at: start, prefixBits: 7)
-        let bytesStart = start + lenConsumed
-        guard bytesStart + length <= data.endIndex else { return nil }
-        let bytes = data.subdata(in: bytesStart ..< bytesStart + length)
-        let string: String
-        if isHuffman {
-            string = huffmanDecode(bytes) ?? ""
-        } else {
-            string = String(data: bytes, encoding: .utf8) ?? ""
-        }
-        return (string, lenConsumed + length)
-    }
-
-    /// Static-table entry (RFC 7541 App. A); only entries expected in gRPC headers are returned.
-    private static func staticTableEntry(at index: Int) -> (name: String, value: String?)? {
-        switch index {
-        case 1:  return (":authority", nil)
-        case 2:  return (":method", "GET")
-        case 3:  return (":method", "POST")
-        case 4:  return (":path", "/")
-        case 5:  return (":path", "/index.html")
-        case 6:  return (":scheme", "http")
-        case 7:  return (":scheme", "https")
-        case 8:  return (":status", "200")
-        case 9:  return (":status", "204")
-        case 10: return (":status", "206")
-        case 11: return (":status", "304")
-        case 12: return (":status", "400")
-        case 13: return (":status", "404")
-        case 14: return (":status", "500")
-        case 31: return ("content-type", nil)
-        case 28: return ("content-length", nil)
-        case 58: return ("user-agent", nil)
-        default: return nil
-        }
-    }
-
-    /// Decodes an HPACK Huffman string (RFC 7541 App. B); `nil` on malformed input.
-    private static func huffmanDecode(_ data: Data) -> String? {
-        var result = [UInt8]()
-        var code: UInt32 = 0
-        var bits = 0
-
-        for byte in data {
-            code = (code << 8) | UInt32(byte)
-            bits += 8
-            while bits >= 5 {
-                // Try code lengths 5...30 smallest-first; each symbol has a unique length+prefix.
-                var matched = false
-                for length in 5...min(bits, 30) {
-                    let candidate = (code >> (bits - length)) & ((1 << length) - 1)
-                    if let symbol = huffmanLookup(code: candidate, length: length) {
-                        if symbol == 256 { return String(bytes: result, encoding: .utf8) }
-                        result.append(UInt8(symbol & 0xFF))
-                        bits -= length
-                        matched = true
-                        break
-                    }
-                }
-                if !matched { break }
-            }
-        }
-
-        // Any remaining bits must be the EOS prefix (all ones).
-        if bits > 0 {
-            let trailing = code & ((1 << bits) - 1)
-            let allOnes: UInt32 = (1 << bits) - 1
-            if trailing != allOnes { return nil }
-        }
-
-        return String(bytes: result, encoding: .utf8)
-    }
-
-    private static func huffmanLookup(code: UInt32, length: Int) -> Int? {
-        return huffmanTable[HuffmanKey(code: code, length: length)]
-    }
-
-    private struct HuffmanKey: Hashable { let code: UInt32; let length: Int }
-
-    /// HPACK Huffman code table (RFC 7541 Appendix B). Symbol `256` is EOS.
-    private static let huffmanTable: [HuffmanKey: Int] = {
-        let entries: [(code: UInt32, length: Int, symbol: Int)] = [
-            (0x1ff8, 13, 0), (0x7fffd8, 23, 1), (0xfffffe2, 28, 2), (0xfffffe3, 28, 3),
-            (0xfffffe4, 28, 4), (0xfffffe5, 28, 5), (0xfffffe6, 28, 6), (0xfffffe7, 28, 7),
-            (0xfffffe8, 28, 8), (0xffffea, 24, 9), (0x3ffffffc, 30, 10), (0xfffffe9, 28, 11),
-            (0xfffffea, 28, 12), (0x3ffffffd, 30, 13), (0xfffffeb, 28, 14), (0xfffffec, 28, 15),
-            (0xfffffed, 28, 16), (0xfffffee, 28, 17), (0xfffffef, 28, 18), (0xffffff0, 28, 19),
-            (0xffffff1, 28, 20), (0xffffff2, 28, 21), (0x3ffffffe, 30, 22), (0xffffff3, 28, 23),
-            (0xffffff4, 28, 24), (0xffffff5, 28, 25), (0xffffff6, 28, 26), (0xffffff7, 28, 27),
-            (0xffffff8, 28, 28), (0xffffff9, 28, 29), (0xffffffa, 28, 30), (0xffffffb, 28, 31),
-            (0x14, 6, 32), (0x3f8, 10, 33), (0x3f9, 10, 34), (0xffa, 12, 35),
-            (0x1ff9, 13, 36), (0x15, 6, 37), (0xf8, 8, 38), (0x7fa, 11, 39),
-            (0x3fa, 10, 40), (0x3fb, 10, 41), (0xf9, 8, 42), (0x7fb, 11, 43),
-            (0xfa, 8, 44), (0x16, 6, 45), (0x17, 6, 46), (0x18, 6, 47),
-            (0x0, 5, 48), (0x1, 5, 49), (0x2, 5, 50), (0x19, 6, 51),
-            (0x1a, 6, 52), (0x1b, 6, 53), (0x1c, 6, 54), (0x1d, 6, 55),
-            (0x1e, 6, 56), (0x1f, 6, 57), (0x5c, 7, 58), (0xfb, 8, 59),
-            (0x7ffc, 15, 60), (0x20, 6, 61), (0xffb, 12, 62), (0x3fc, 10, 63),
-            (0x1ffa, 13, 64), (0x21, 6, 65), (0x5d, 7, 66), (0x5e, 7, 67),
-            (0x5f, 7, 68), (0x60, 7, 69), (0x61, 7, 70), (0x62, 7, 71),
-            (0x63, 7, 72), (0x64, 7, 73), (0x65, 7, 74), (0x66, 7, 75),
-            (0x67, 7, 76), (0x68, 7, 77), (0x69, 7, 78), (0x6a, 7, 79),
-            (0x6b, 7, 80), (0x6c, 7, 81), (0x6d, 7, 82), (0x6e, 7, 83),
-            (0x6f, 7, 84), (0x70, 7, 85), (0x71, 7, 86), (0x72, 7, 87),
-            (0xfc, 8, 88), (0x73, 7, 89), (0xfd, 8, 90), (0x1ffb, 13, 91),
-            (0x7fff0, 19, 92), (0x1ffc, 13, 93), (0x3ffc, 14, 94), (0x22, 6, 95),
-            (0x7ffd, 15, 96), (0x3, 5, 97), (0x23, 6, 98), (0x4, 5, 99),
-            (0x24, 6, 100), (0x5, 5, 101), (0x25, 6, 102), (0x26, 6, 103),
-            (0x27, 6, 104), (0x6, 5, 105), (0x74, 7, 106), (0x75, 7, 107),
-            (0x28, 6, 108), (0x29, 6, 109), (0x2a, 6, 110), (0x7, 5, 111),
-            (0x2b, 6, 112), (0x76, 7, 113), (0x2c, 6, 114), (0x8, 5, 115),
-            (0x9, 5, 116), (0x2d, 6, 117), (0x77, 7, 118), (0x78, 7, 119),
-            (0x79, 7, 120), (0x7a, 7, 121), (0x7b, 7, 122), (0x7ffe, 15, 123),
-            (0x7fc, 11, 124), (0x3ffd, 14, 125), (0x1ffd, 13, 126), (0xffffffc, 28, 127),
-            (0xfffe6, 20, 128), (0x3fffd2, 22, 129), (0xfffe7, 20, 130), (0xfffe8, 20, 131),
-            (0x3fffd3, 22, 132), (0x3fffd4, 22, 133), (0x3fffd5, 22, 134), (0x7fffd9, 23, 135),
-            (0x3fffd6, 22, 136), (0x7fffda, 23, 137), (0x7fffdb, 23, 138), (0x7fffdc, 23, 139),
-            (0x7fffdd, 23, 140), (0x7fffde, 23, 141), (0xffffeb, 24, 142), (0x7fffdf, 23, 143),
-            (0xffffec, 24, 144), (0xffffed, 24, 145), (0x3fffd7, 22, 146), (0x7fffe0, 23, 147),
-            (0xffffee, 24, 148), (0x7fffe1, 23, 149), (0x7fffe2, 23, 150), (0x7fffe3, 23, 151),
-            (0x7fffe4, 23, 152), (0x1fffdc, 21, 153), (0x3fffd8, 22, 154), (0x7fffe5, 23, 155),
-            (0x3fffd9, 22, 156), (0x7fffe6, 23, 157), (0x7fffe7, 23, 158), (0xffffef, 24, 159),
-            (0x3fffda, 22, 160), (0x1fffdd, 21, 161), (0xfffe9, 20, 162), (0x3fffdb, 22, 163),
-            (0x3fffdc, 22, 164), (0x7fffe8, 23, 165), (0x7fffe9, 23, 166), (0x1fffde, 21, 167),
-            (0x7fffea, 23, 168), (0x3fffdd, 22, 169), (0x3fffde, 22, 170), (0xfffff0, 24, 171),
-            (0x1fffdf, 21, 172), (0x3fffdf, 22, 173), (0x7fffeb, 23, 174), (0x7fffec, 23, 175),
-            (0x1fffe0, 21, 176), (0x1fffe1, 21, 177), (0x3fffe0, 22, 178), (0x1fffe2, 21, 179),
-            (0x7fffed, 23, 180), (0x3fffe1, 22, 181), (0x7fffee, 23, 182), (0x7fffef, 23, 183),
-            (0xfffea, 20, 184), (0x3fffe2, 22, 185), (0x3fffe3, 22, 186), (0x3fffe4, 22, 187),
-            (0x7ffff0, 23, 188), (0x3fffe5, 22, 189), (0x3fffe6, 22, 190), (0x7ffff1, 23, 191),
-            (0x3ffffe0, 26, 192), (0x3ffffe1, 26, 193), (0xfffeb, 20, 194), (0x7fff1, 19, 195),
-            (0x3fffe7, 22, 196), (0x7ffff2, 23, 197), (0x3fffe8, 22, 198), (0x1ffffec, 25, 199),
-            (0x3ffffe2, 26, 200), (0x3ffffe3, 26, 201), (0x3ffffe4, 26, 202), (0x7ffffde, 27, 203),
-            (0x7ffffdf, 27, 204), (0x3ffffe5, 26, 205), (0xfffff1, 24, 206), (0x1ffffed, 25, 207),
-            (0x7fff2, 19, 208), (0x1fffe3, 21, 209), (0x3ffffe6, 26, 210), (0x7ffffe0, 27, 211),
-            (0x7ffffe1, 27, 212), (0x3ffffe7, 26, 213), (0x7ffffe2, 27, 214), (0xfffff2, 24, 215),
-            (0x1fffe4, 21, 216), (0x1fffe5, 21, 217), (0x3ffffe8, 26, 218), (0x3ffffe9, 26, 219),
-            (0xffffffd, 28, 220), (0x7ffffe3, 27, 221), (0x7ffffe4, 27, 222), (0x7ffffe5, 27, 223),
-            (0xfffec, 20, 224), (0xfffff3, 24, 225), (0xfffed, 20, 226), (0x1fffe6, 21, 227),
-            (0x3fffe9, 22, 228), (0x1fffe7, 21, 229), (0x1fffe8, 21, 230), (0x7ffff3, 23, 231),
-            (0x3fffea, 22, 232), (0x3fffeb, 22, 233), (0x1ffffee, 25, 234), (0x1ffffef, 25, 235),
-            (0xfffff4, 24, 236), (0xfffff5, 24, 237), (0x3ffffea, 26, 238), (0x7ffff4, 23, 239),
-            (0x3ffffeb, 26, 240), (0x7ffffe6, 27, 241), (0x3ffffec, 26, 242), (0x3ffffed, 26, 243),
-            (0x7ffffe7, 27, 244), (0x7ffffe8, 27, 245), (0x7ffffe9, 27, 246), (0x7ffffea, 27, 247),
-            (0x7ffffeb, 27, 248), (0xffffffe, 28, 249), (0x7ffffec, 27, 250), (0x7ffffed, 27, 251),
-            (0x7ffffee, 27, 252), (0x7ffffef, 27, 253), (0x7fffff0, 27, 254), (0x3ffffee, 26, 255),
-            (0x3fffffff, 30, 256),
-        ]
-        var table: [HuffmanKey: Int] = [:]
-        table.reserveCapacity(entries.count)
-        for entry in entries {
-            table[HuffmanKey(code: entry.code, length: entry.length)] = entry.symbol
-        }
-        return table
-    }()
 }
@@ -0,0 +1,128 @@
+//
+//  GRPCConnectionPool.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "GRPCPool")
+
+/// Pools gRPC HTTP/2 connections so many direct-route tunnels share one TCP/TLS connection,
+/// each as its own `Tun` stream. Connections self-evict via `onClose`; one that received
+/// GOAWAY leaves the bucket and lives on only through its draining streams.
+nonisolated final class GRPCConnectionPool: MultiplexerPool<GRPCConnection> {
+
+    static let shared = GRPCConnectionPool()
+
+    /// Dials and wraps a fresh transport in a pooled ``GRPCConnection`` (setup not yet run).
+    typealias DialOut = (@escaping (Result<GRPCConnection, Error>) -> Void) -> Void
+
+    /// Callers waiting on a dial already in flight for their key; coalesced so a burst of
+    /// flows opens one connection rather than one each.
+    private var pendingDials: [String: [(Result<GRPCStream, Error>) -> Void]] = [:]
+
+    /// Unbounded connection count per key — a connection only fills up at the peer's
+    /// MAX_CONCURRENT_STREAMS, after which the next acquire dials another.
+    private static let poolPolicy = MultiplexerPolicy(
+        idleTimeout: 60,
+        idleCheckInterval: 60
+    )
+
+    private override init() {
+        super.init()
+        startIdleEviction(Self.poolPolicy)
+    }
+
+    // MARK: - Acquire
+
+    /// Opens a stream on a pooled connection for `key`, dialing one via `dialOut` when none
+    /// has room. `key` must cover everything that shapes the connection (endpoint, security,
+    /// gRPC settings), since any stream may land on any connection under it.
+    func acquireStream(
+        key: String,
+        dialOut: @escaping DialOut,
+        completion: @escaping (Result<GRPCStream, Error>) -> Void
+    ) {
+        lock.lock()
+        multiplexers[key]?.removeAll { $0.isClosed || $0.isGoingAway }
+        if let existing = multiplexers[key]?.first(where: { $0.tryReserveStream() }) {
+            lastActivity[ObjectIdentifier(existing)] = MonotonicClock.now
+            lock.unlock()
+            if let stream = existing.openReservedStream() {
+                completion(.success(stream))
+            } else {
+                acquireStream(key: key, dialOut: dialOut, completion: completion)
+            }
+            return
+        }
+        if pendingDials[key] != nil {
+            pendingDials[key]?.append(completion)
+            lock.unlock()
+            return
+        }
+        pendingDials[key] = []
+        lock.unlock()
+
+        dialOut { [weak self] result in
+            guard let self else {
+                completion(.failure(GRPCError.connectionClosed))
+                return
+            }
+            switch result {
+            case .failure(let error):
+                self.finishDial(key: key, dialOut: dialOut, result: .failure(error), completion: completion)
+            case .success(let connection):
+                connection.performSetup { [weak self] setupResult in
+                    guard let self else {
+                        completion(setupResult)
+                        return
+                    }
+                    if case .success = setupResult {
+                        connection.onClose = { [weak self, weak connection] in
+                            guard let self, let connection else { return }
+                            self.removeMultiplexer(connection, key: key)
+                        }
+                        self.lock.lock()
+                        self.multiplexers[key, default: []].append(connection)
+                        self.lastActivity[ObjectIdentifier(connection)] = MonotonicClock.now
+                        self.lock.unlock()
+                    } else {
+                        connection.cancel()
+                    }
+                    self.finishDial(key: key, dialOut: dialOut, result: setupResult, completion: completion)
+                }
+            }
+        }
+    }
+
+    /// Hands the dial's outcome to its initiator, then to the waiters: on success they
+    /// re-run the acquire and find the new connection, on failure they share the error.
+    private func finishDial(
+        key: String,
+        dialOut: @escaping DialOut,
+        result: Result<GRPCStream, Error>,
+        completion: @escaping (Result<GRPCStream, Error>) -> Void
+    ) {
+        lock.lock()
+        let waiters = pendingDials.removeValue(forKey: key) ?? []
+        lock.unlock()
+
+        completion(result)
+        if case .failure(let error) = result {
+            for waiter in waiters { waiter(.failure(error)) }
+            return
+        }
+        for waiter in waiters {
+            acquireStream(key: key, dialOut: dialOut, completion: waiter)
+        }
+    }
+
+    // MARK: - Eviction
+
+    override func removeMultiplexer(_ multiplexer: GRPCConnection, key: String) {
+        super.removeMultiplexer(multiplexer, key: key)
+        logger.debug("[GRPCPool] Evicted connection for \(key)")
+    }
+}
@@ -8,31 +8,31 @@
 import Foundation
 
 nonisolated class GRPCProxyConnection: ProxyConnection {
-    private let grpcConnection: GRPCConnection
+    private let stream: GRPCStream
 
-    init(grpcConnection: GRPCConnection) {
-        self.grpcConnection = grpcConnection
+    init(stream: GRPCStream) {
+        self.stream = stream
     }
 
     override var isConnected: Bool {
-        grpcConnection.isConnected
+        stream.isConnected
     }
 
     override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
-        grpcConnection.send(data: data, completion: completion)
+        stream.send(data: data, completion: completion)
     }
 
     override func sendRaw(data: Data) {
-        grpcConnection.send(data: data)
+        stream.send(data: data)
     }
 
     override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
-        grpcConnection.receive { data, error in
+        stream.receive { data, error in
             completion(data, error)
         }
     }
 
     override func cancel() {
-        grpcConnection.cancel()
+        stream.cancel()
     }
 }
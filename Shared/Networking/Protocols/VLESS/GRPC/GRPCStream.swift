@@ -0,0 +1,73 @@
+//
+//  GRPCStream.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+// MARK: - GRPCStream
+
+/// One gRPC `Tun` call on a ``GRPCConnection``: an HTTP/2 stream with its own message
+/// reassembly and flow-control windows. Every mutable field is guarded by the owning
+/// connection's lock; the connection's read loop fills the buffers, callers drain them.
+nonisolated final class GRPCStream {
+
+    let streamId: UInt32
+    let connection: GRPCConnection
+
+    /// Reassembles HTTP/2 DATA payloads into length-prefixed gRPC frames.
+    var grpcFrameBuffer = Data()
+    /// Decoded app-layer bytes awaiting delivery to the caller.
+    var decodedBuffer = Data()
+    /// The caller's outstanding `receive`, completed when data, an error or EOF arrives.
+    var pendingReceive: ((Data?, Error?) -> Void)?
+    /// Terminal error, delivered after any buffered data.
+    var failure: Error?
+
+    /// Whether the gRPC response HEADERS (status 200) have been validated.
+    var responseReceived = false
+    /// Whether the server has closed its side (END_STREAM, RST_STREAM or GOAWAY).
+    var remoteClosed = false
+    /// Whether the caller cancelled the stream.
+    var cancelled = false
+
+    /// Peer's stream flow-control window (bytes we can still send on this stream).
+    var peerSendWindow: Int
+    /// DATA bytes received on this stream but not yet acknowledged via WINDOW_UPDATE.
+    var receiveConsumed = 0
+
+    /// Whether a send is on the wire; sends arriving meanwhile queue in `pendingSends`.
+    var sendInFlight = false
+    /// Chunks queued behind the send in flight, framed together once it completes.
+    var pendingSends: [(data: Data, completion: (Error?) -> Void)] = []
+
+    init(streamId: UInt32, connection: GRPCConnection, peerSendWindow: Int) {
+        self.streamId = streamId
+        self.connection = connection
+        self.peerSendWindow = peerSendWindow
+    }
+
+    var isConnected: Bool {
+        connection.isStreamConnected(self)
+    }
+
+    /// Sends a raw byte chunk; chunks queued behind a send in flight go out together.
+    func send(data: Data, completion: @escaping (Error?) -> Void) {
+        connection.send(data: data, on: self, completion: completion)
+    }
+
+    func send(data: Data) {
+        send(data: data) { _ in }
+    }
+
+    /// Delivers the next decoded payload, or `nil` on EOF.
+    func receive(completion: @escaping (Data?, Error?) -> Void) {
+        connection.receive(on: self, completion: completion)
+    }
+
+    func cancel() {
+        connection.cancel(self)
+    }
+}
@@ -45,7 +45,7 @@ nonisolated class HTTPUpgradeConnection {
         self._isConnected = true
     }
 
-    convenience init(transport: NWTCPTransport, configuration: HTTPUpgradeConfiguration) {
+    convenience init(transport: any TCPDialTransport, configuration: HTTPUpgradeConfiguration) {
         self.init(transport: TransportClosures(tcp: transport), configuration: configuration)
     }
 
@@ -138,6 +138,13 @@ extension ProxyClient {
         )
 
         let vless = VLESSConnection(inner: connection)
+        // Nothing to carry yet: hold the header for the first send rather than writing it
+        // alone. Vision writes its padded intro right away, so it sends the header now.
+        if command == .tcp, !isVision, initialData?.isEmpty ?? true {
+            vless.deferHandshake(requestHeader: requestHeader)
+            completion(.success(vless))
+            return
+        }
         // For Vision flow, initial data needs separate padding — don't append to the header.
         let handshakeInitialData = isVision ? nil : initialData
         vless.sendHandshake(requestHeader: requestHeader, initialData: handshakeInitialData) { [weak self] error in
@@ -180,6 +187,43 @@ extension ProxyClient {
         }
     }
 
+    // MARK: - Mux
+
+    /// Opens the TCP flow as a sub-connection of a pooled `v1.mux.cool` connection, so it
+    /// skips the transport and TLS/REALITY handshakes when one has room.
+    func connectWithVLESSMux(
+        destinationHost: String,
+        destinationPort: UInt16,
+        initialData: Data?,
+        completion: @escaping (Result<ProxyConnection, Error>) -> Void
+    ) {
+        // Don't capture self in the dial closure: the pool outlives this client.
+        let configuration = self.configuration
+        let dialOut: VLESSMuxMultiplexerPool.DialOut = { dialCompletion in
+            // The flow's own connect already times the handshake, pooled or not.
+            let client = ProxyClient(configuration: configuration)
+            client.connectMultiplexer { result in
+                switch result {
+                case .success(let connection):
+                    dialCompletion(.success(VLESSMuxMultiplexer(connection: connection, client: client)))
+                case .failure(let error):
+                    client.cancel()
+                    dialCompletion(.failure(error))
+                }
+            }
+        }
+
+        VLESSMuxMultiplexerPool.shared.acquireStream(
+            key: VLESSMuxMultiplexerPool.makeKey(for: configuration),
+            host: destinationHost,
+            port: destinationPort,
+            initialData: initialData,
+            dialOut: dialOut
+        ) { result in
+            completion(result.map { $0 as ProxyConnection })
+        }
+    }
+
     // MARK: - Vision
 
     /// Vision requires outer TLS 1.3; VLESS encryption is exempt because its AEAD
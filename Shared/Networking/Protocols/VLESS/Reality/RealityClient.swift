@@ -8,7 +8,6 @@
 import Foundation
 import Compression
 import CryptoKit
-import Security
 
 nonisolated private let logger = AnywhereLogger(category: "RealityClient")
 
@@ -42,23 +41,16 @@ nonisolated class RealityClient {
         port: UInt16,
         completion: @escaping (Result<TLSRecordConnection, Error>) -> Void
     ) {
-        ephemeralPrivateKey = Curve25519.KeyAgreement.PrivateKey()
-
-        guard let privateKey = ephemeralPrivateKey else {
-            completion(.failure(RealityError.handshakeFailed("No ephemeral key")))
-            return
-        }
-
         let clientHello: Data
         do {
-            clientHello = try buildRealityClientHello(privateKey: privateKey)
+            clientHello = try buildRealityClientHello()
         } catch {
             completion(.failure(error))
             return
         }
         storedClientHello = clientHello.subdata(in: 5..<clientHello.count)
 
-        let transport = NWTCPTransport()
+        let transport = DialTransports.tcp()
         self.connection = transport
 
         transport.connect(host: host, port: port, initialData: clientHello) { [weak self] error in
@@ -81,7 +73,6 @@ nonisolated class RealityClient {
         overTunnel tunnel: ProxyConnection,
         completion: @escaping (Result<TLSRecordConnection, Error>) -> Void
     ) {
-        ephemeralPrivateKey = Curve25519.KeyAgreement.PrivateKey()
         self.connection = TunneledTransport(tunnel: tunnel)
         performRealityHandshake(completion: completion)
     }
@@ -97,13 +88,8 @@ nonisolated class RealityClient {
     private func performRealityHandshake(
         completion: @escaping (Result<TLSRecordConnection, Error>) -> Void
     ) {
-        guard let privateKey = ephemeralPrivateKey else {
-            completion(.failure(RealityError.handshakeFailed("No ephemeral key")))
-            return
-        }
-
         do {
-            let clientHello = try buildRealityClientHello(privateKey: privateKey)
+            let clientHello = try buildRealityClientHello()
 
             storedClientHello = clientHello.subdata(in: 5..<clientHello.count)
 
@@ -128,11 +114,14 @@ nonisolated class RealityClient {
 
     // MARK: - ClientHello
 
-    private func buildRealityClientHello(privateKey: Curve25519.KeyAgreement.PrivateKey) throws -> Data {
-        var random = Data(count: 32)
-        guard random.withUnsafeMutableBytes({ SecRandomCopyBytes(kSecRandomDefault, 32, $0.baseAddress!) }) == errSecSuccess else {
-            throw RealityError.handshakeFailed("Failed to generate random bytes")
-        }
+    /// Takes prepared key shares and ClientHello from ``RealityHandshakePrecompute``, then
+    /// fills in the per-connection SessionId (version, timestamp, short ID), encrypted under
+    /// the auth key with the zero-SessionId hello as AAD.
+    private func buildRealityClientHello() throws -> Data {
+        let prepared = try RealityHandshakePrecompute.shared.take(for: configuration)
+        ephemeralPrivateKey = prepared.privateKey
+        authKey = prepared.authKey
+        mlkemPrivateKeyStorage = prepared.mlkemPrivateKey
 
         // SessionId carries the Reality metadata in the first 16 bytes.
         var sessionId = Data(count: 32)
@@ -152,48 +141,17 @@ nonisolated class RealityClient {
             sessionId[8 + i] = configuration.shortId[i]
         }
 
-        let serverPublicKey = try Curve25519.KeyAgreement.PublicKey(rawRepresentation: configuration.publicKey)
-        let sharedSecret = try privateKey.sharedSecretFromKeyAgreement(with: serverPublicKey)
-
-        let salt = random.prefix(20)
-        let info = "REALITY".data(using: .utf8)!
-        authKey = deriveKey(sharedSecret: sharedSecret, salt: salt, info: info, outputLength: 32)
-
-        guard let authKey else {
-            throw RealityError.handshakeFailed("Failed to derive auth key")
-        }
-
-        var mlkemEncapsulationKey: Data?
-        #if compiler(>=6.2)
-        if #available(iOS 26.0, macOS 26.0, tvOS 26.0, watchOS 26.0, visionOS 26.0, *) {
-            if let mlkemPrivateKey = try? CryptoKit.MLKEM768.PrivateKey() {
-                mlkemPrivateKeyStorage = mlkemPrivateKey
-                mlkemEncapsulationKey = Data(mlkemPrivateKey.publicKey.rawRepresentation)
-            }
-        }
-        #endif
-
-        // The zero-SessionId ClientHello is the AES-GCM AAD; the field is patched in place below.
-        let zeroSessionId = Data(count: 32)
-        var rawClientHello = TLSClientHelloBuilder.buildRawClientHello(
-            fingerprint: configuration.fingerprint,
-            random: random,
-            sessionId: zeroSessionId,
-            serverName: configuration.serverName,
-            publicKey: privateKey.publicKey.rawRepresentation,
-            mlkemEncapsulationKey: mlkemEncapsulationKey
-        )
-
-        let nonce = random.suffix(12)
+        let nonce = prepared.random.suffix(12)
         let plaintext = sessionId.prefix(16)
 
         let encryptedSessionId = try TLSRecordCrypto.encryptAESGCM(
             plaintext: Data(plaintext),
-            key: SymmetricKey(data: authKey),
+            key: SymmetricKey(data: prepared.authKey),
             nonce: Data(nonce),
-            aad: rawClientHello
+            aad: prepared.rawClientHello
         )
 
+        var rawClientHello = prepared.rawClientHello
         let sessionIdOffset = 1 + 3 + 2 + 32 + 1
         rawClientHello.replaceSubrange(sessionIdOffset..<(sessionIdOffset + 32), with: encryptedSessionId)
         sentSessionID = encryptedSessionId
@@ -851,14 +809,4 @@ nonisolated class RealityClient {
         throw RealityError.handshakeFailed("ML-KEM not supported on this platform")
     }
 
-    private func deriveKey(sharedSecret: SharedSecret, salt: Data, info: Data, outputLength: Int) -> Data? {
-        let derivedKey = sharedSecret.hkdfDerivedSymmetricKey(
-            using: SHA256.self,
-            salt: salt,
-            sharedInfo: info,
-            outputByteCount: outputLength
-        )
-        return derivedKey.withUnsafeBytes { Data($0) }
-    }
-
 }
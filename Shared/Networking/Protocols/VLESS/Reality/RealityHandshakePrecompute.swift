@@ -0,0 +1,141 @@
+//
+//  RealityHandshakePrecompute.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import CryptoKit
+import Security
+
+// MARK: - RealityPreparedHello
+
+/// Single-use Reality ClientHello material: the ephemeral key shares, the zero-SessionId
+/// ClientHello (the SessionId's AES-GCM AAD), and the auth key derived from its random.
+/// Only the timestamped SessionId and its encryption are left for dial time.
+nonisolated struct RealityPreparedHello {
+    let privateKey: Curve25519.KeyAgreement.PrivateKey
+    /// `CryptoKit.MLKEM768.PrivateKey` where available.
+    let mlkemPrivateKey: Any?
+    let random: Data
+    let authKey: Data
+    let rawClientHello: Data
+
+    /// Builds a fresh hello: key generation, the agreement against the server key, HKDF,
+    /// and the fingerprinted ClientHello layout.
+    static func make(for configuration: RealityConfiguration) throws -> RealityPreparedHello {
+        var random = Data(count: 32)
+        guard random.withUnsafeMutableBytes({ SecRandomCopyBytes(kSecRandomDefault, 32, $0.baseAddress!) }) == errSecSuccess else {
+            throw RealityError.handshakeFailed("Failed to generate random bytes")
+        }
+
+        let privateKey = Curve25519.KeyAgreement.PrivateKey()
+        let serverPublicKey = try Curve25519.KeyAgreement.PublicKey(rawRepresentation: configuration.publicKey)
+        let sharedSecret = try privateKey.sharedSecretFromKeyAgreement(with: serverPublicKey)
+        let authKey = sharedSecret.hkdfDerivedSymmetricKey(
+            using: SHA256.self,
+            salt: random.prefix(20),
+            sharedInfo: Data("REALITY".utf8),
+            outputByteCount: 32
+        ).withUnsafeBytes { Data($0) }
+
+        var mlkemPrivateKey: Any?
+        var mlkemEncapsulationKey: Data?
+        #if compiler(>=6.2)
+        if #available(iOS 26.0, macOS 26.0, tvOS 26.0, watchOS 26.0, visionOS 26.0, *) {
+            if let key = try? CryptoKit.MLKEM768.PrivateKey() {
+                mlkemPrivateKey = key
+                mlkemEncapsulationKey = Data(key.publicKey.rawRepresentation)
+            }
+        }
+        #endif
+
+        let rawClientHello = TLSClientHelloBuilder.buildRawClientHello(
+            fingerprint: configuration.fingerprint,
+            random: random,
+            sessionId: Data(count: 32),
+            serverName: configuration.serverName,
+            publicKey: privateKey.publicKey.rawRepresentation,
+            mlkemEncapsulationKey: mlkemEncapsulationKey
+        )
+
+        return RealityPreparedHello(
+            privateKey: privateKey,
+            mlkemPrivateKey: mlkemPrivateKey,
+            random: random,
+            authKey: authKey,
+            rawClientHello: rawClientHello
+        )
+    }
+}
+
+// MARK: - RealityHandshakePrecompute
+
+/// Keeps a few ``RealityPreparedHello``s ready per Reality configuration, built on a utility
+/// queue, so a burst of dials (tunnel start, app launch) skips the key generation and
+/// ClientHello layout. Each entry is handed out once; an empty queue falls back to building
+/// inline.
+nonisolated final class RealityHandshakePrecompute {
+
+    static let shared = RealityHandshakePrecompute()
+
+    private static let depth = 4
+    private static let maxConfigurations = 8
+
+    private let queue = DispatchQueue(label: AWCore.Identifier.realityPrecomputeQueue, qos: .utility)
+    private let lock = UnfairLock()
+    private var ready: [RealityConfiguration: [RealityPreparedHello]] = [:]
+    private var refilling: Set<RealityConfiguration> = []
+
+    private init() {}
+
+    /// A prepared hello for `configuration`, built inline when none is queued; either way
+    /// the queue is topped back up in the background.
+    func take(for configuration: RealityConfiguration) throws -> RealityPreparedHello {
+        let prepared: RealityPreparedHello? = lock.withLock {
+            guard var queued = ready[configuration], !queued.isEmpty else { return nil }
+            let first = queued.removeFirst()
+            ready[configuration] = queued
+            return first
+        }
+        prewarm(configuration)
+        if let prepared { return prepared }
+        return try RealityPreparedHello.make(for: configuration)
+    }
+
+    /// Fills `configuration`'s queue to ``depth`` in the background.
+    func prewarm(_ configuration: RealityConfiguration) {
+        let start: Bool = lock.withLock {
+            guard !refilling.contains(configuration),
+                  (ready[configuration]?.count ?? 0) < Self.depth else { return false }
+            if ready[configuration] == nil, ready.count >= Self.maxConfigurations {
+                ready.removeAll()
+            }
+            refilling.insert(configuration)
+            return true
+        }
+        guard start else { return }
+        queue.async { [self] in
+            while true {
+                let needed: Bool = lock.withLock {
+                    guard (ready[configuration]?.count ?? 0) < Self.depth else {
+                        refilling.remove(configuration)
+                        return false
+                    }
+                    return true
+                }
+                guard needed else { return }
+                guard let prepared = try? RealityPreparedHello.make(for: configuration) else {
+                    lock.withLock { _ = refilling.remove(configuration) }
+                    return
+                }
+                lock.withLock { ready[configuration, default: []].append(prepared) }
+            }
+        }
+    }
+
+    func removeAll() {
+        lock.withLock { ready.removeAll() }
+    }
+}
@@ -16,6 +16,9 @@ nonisolated final class VLESSConnection: ProxyConnection {
     private var responseHeaderReceived = false
     private var pendingResponseBuffer = Data()
 
+    /// Request header held for the first send (see `deferHandshake`); guarded by `lock`.
+    private var deferredRequestHeader: Data?
+
     init(inner: ProxyConnection) {
         self.inner = inner
     }
@@ -38,14 +41,34 @@ nonisolated final class VLESSConnection: ProxyConnection {
         inner.sendRaw(data: payload, completion: completion)
     }
 
+    /// Holds the request header for the first send so it shares that payload's write
+    /// (and outer TLS record); the alternative to `sendHandshake` with no payload yet.
+    func deferHandshake(requestHeader: Data) {
+        lock.withLock { deferredRequestHeader = requestHeader }
+    }
+
     // MARK: - Send (passthrough)
 
     override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
-        inner.sendRaw(data: data, completion: completion)
+        inner.sendRaw(data: consumeDeferredHeader().map { $0 + data } ?? data, completion: completion)
     }
 
     override func sendRaw(data: Data) {
-        inner.sendRaw(data: data)
+        inner.sendRaw(data: consumeDeferredHeader().map { $0 + data } ?? data)
+    }
+
+    override func flushDeferredHeader() {
+        if let header = consumeDeferredHeader() {
+            inner.sendRaw(data: header)
+        }
+    }
+
+    private func consumeDeferredHeader() -> Data? {
+        lock.lock()
+        defer { lock.unlock() }
+        let header = deferredRequestHeader
+        deferredRequestHeader = nil
+        return header
     }
 
     // MARK: - Receive (strip VLESS response header on first bytes)
@@ -133,6 +156,10 @@ nonisolated final class VLESSConnection: ProxyConnection {
         inner.sendDirectRaw(data: data)
     }
 
+    override var directReceiveTransport: (any RawTransport)? { inner.directReceiveTransport }
+
+    override var directSendTransport: (any RawTransport)? { inner.directSendTransport }
+
     // MARK: - Cancel
 
     override func cancel() {
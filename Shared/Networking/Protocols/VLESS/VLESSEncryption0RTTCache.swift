@@ -7,6 +7,8 @@
 
 import Foundation
 
+nonisolated private let logger = AnywhereLogger(category: "VLESSEncryption0RTTCache")
+
 /// Process-wide cache of 0-RTT resumption tickets, keyed by
 /// `(host, port, encryption config)` so differing configs don't collide.
 final class VLESSEncryption0RTTCache {
@@ -15,12 +17,24 @@ final class VLESSEncryption0RTTCache {
 
     /// Snapshot used for compare-and-invalidate, so callers remove the entry they
     /// actually used and not a newer one that raced in.
-    struct Entry {
+    struct Entry: Codable {
         let pfsKey: Data
         let ticket: Data       // 16 bytes
         let expire: CFAbsoluteTime
     }
 
+    private struct Snapshot: Codable {
+        let savedAt: CFAbsoluteTime
+        let entries: [String: Entry]
+    }
+
+    /// A snapshot older than this is discarded on restore; see ``TLSSessionTicketCache``.
+    private static let snapshotWindow: CFAbsoluteTime = 15 * 60
+
+    private let snapshotURL: URL? = FileManager.default
+        .containerURL(forSecurityApplicationGroupIdentifier: AWCore.Identifier.appGroupSuite)?
+        .appendingPathComponent("vless-0rtt-tickets.bin")
+
     private let lock = UnfairLock()
     private var entries: [String: Entry] = [:]
 
@@ -58,8 +72,44 @@ final class VLESSEncryption0RTTCache {
         }
     }
 
-    /// Wired to VPN disconnect so a fresh connect doesn't reuse stale tickets.
-    func clear() {
-        lock.withLock { entries.removeAll(keepingCapacity: false) }
+    // MARK: - Snapshot
+    //
+    // A ticket is bound to the server, not the network path, so it outlives wake,
+    // Wi-Fi/cellular switches and tunnel restarts until it expires or the server
+    // rejects it (see ``invalidate(key:matching:)``).
+
+    /// Persists unexpired tickets to the app group, protected until first unlock, so
+    /// the next tunnel start dials 0-RTT. Call on clean shutdown.
+    func saveSnapshot() {
+        guard let snapshotURL else { return }
+        let now = CFAbsoluteTimeGetCurrent()
+        let live = lock.withLock { entries.filter { $0.value.expire > now } }
+        guard !live.isEmpty else {
+            try? FileManager.default.removeItem(at: snapshotURL)
+            return
+        }
+        do {
+            let data = try PropertyListEncoder().encode(Snapshot(savedAt: now, entries: live))
+            try data.write(to: snapshotURL, options: [.atomic, .completeFileProtectionUntilFirstUserAuthentication])
+        } catch {
+            logger.error("[VLESSEncryption0RTTCache] Failed to write snapshot: \(error)")
+        }
+    }
+
+    /// Restores tickets written by ``saveSnapshot()``, consuming the file. Entries
+    /// stored since launch win over restored ones.
+    func restoreSnapshot() {
+        guard let snapshotURL,
+              let data = try? Data(contentsOf: snapshotURL) else { return }
+        try? FileManager.default.removeItem(at: snapshotURL)
+
+        let now = CFAbsoluteTimeGetCurrent()
+        guard let snapshot = try? PropertyListDecoder().decode(Snapshot.self, from: data),
+              now - snapshot.savedAt < Self.snapshotWindow else { return }
+        let restored = snapshot.entries.filter { $0.value.expire > now }
+        lock.withLock {
+            entries.merge(restored) { current, _ in current }
+        }
+        logger.debug("[VLESSEncryption0RTTCache] Restored tickets for \(restored.count) servers")
     }
 }
@@ -75,14 +75,20 @@ final class VLESSEncryptionCTR {
     /// XOR keystream bytes directly into a mutable buffer, avoiding an extra copy.
     func processInPlace(_ buffer: UnsafeMutableRawBufferPointer) {
         if buffer.count == 0 { return }
-        lock.withLock {
-            var dataOutMoved: Int = 0
-            _ = CCCryptorUpdate(
-                cryptor,
-                buffer.baseAddress, buffer.count,
-                buffer.baseAddress, buffer.count,
-                &dataOutMoved
-            )
-        }
+        lock.withLock { processInPlaceUnlocked(buffer) }
+    }
+
+    /// ``processInPlace(_:)`` without the lock, for an owner that already
+    /// serializes every use of this keystream (``VLESSXORConnection``'s
+    /// per-direction locks).
+    func processInPlaceUnlocked(_ buffer: UnsafeMutableRawBufferPointer) {
+        if buffer.count == 0 { return }
+        var dataOutMoved: Int = 0
+        _ = CCCryptorUpdate(
+            cryptor,
+            buffer.baseAddress, buffer.count,
+            buffer.baseAddress, buffer.count,
+            &dataOutMoved
+        )
     }
 }
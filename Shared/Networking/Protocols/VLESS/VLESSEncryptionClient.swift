@@ -261,7 +261,7 @@ struct VLESSEncryptionPadding {
 // MARK: - NFS public key (parsed)
 
 @available(iOS 26.0, macOS 26.0, tvOS 26.0, *)
-private enum VLESSNfsPublicKey {
+nonisolated enum VLESSNfsPublicKey {
     case x25519(Curve25519.KeyAgreement.PublicKey, raw: Data)
     case mlkem768(MLKEM768.PublicKey, raw: Data)
 
@@ -279,6 +279,21 @@ private enum VLESSNfsPublicKey {
         }
     }
 
+    /// A fresh ephemeral agreement with this relay; see ``VLESSEncryptionKeyPool``.
+    func makeShare() throws -> VLESSRelayShare {
+        switch self {
+        case .x25519(let serverPub, _):
+            let priv = Curve25519.KeyAgreement.PrivateKey()
+            let shared = try priv.sharedSecretFromKeyAgreement(with: serverPub)
+            return VLESSRelayShare(sharedSecret: shared.withUnsafeBytes { Data($0) },
+                                   wireBytes: priv.publicKey.rawRepresentation)
+        case .mlkem768(let serverPub, _):
+            let result = try serverPub.encapsulate()
+            return VLESSRelayShare(sharedSecret: result.sharedSecret.withUnsafeBytes { Data($0) },
+                                   wireBytes: result.encapsulated)
+        }
+    }
+
     static func parse(_ raw: Data) throws -> VLESSNfsPublicKey {
         switch raw.count {
         case 32:
@@ -378,18 +393,9 @@ nonisolated final class VLESSEncryptionClient {
         var nfsKey = Data()
         var lastCTR: VLESSEncryptionCTR? = nil
         for j in 0..<nfsKeys.count {
-            var publicKeyOrCiphertext = Data()
-            switch nfsKeys[j] {
-            case .x25519(let serverPub, _):
-                let priv = Curve25519.KeyAgreement.PrivateKey()
-                let shared = try priv.sharedSecretFromKeyAgreement(with: serverPub)
-                nfsKey = shared.withUnsafeBytes { Data($0) }
-                publicKeyOrCiphertext = priv.publicKey.rawRepresentation
-            case .mlkem768(let serverPub, _):
-                let result = try serverPub.encapsulate()
-                nfsKey = result.sharedSecret.withUnsafeBytes { Data($0) }
-                publicKeyOrCiphertext = result.encapsulated
-            }
+            let share = try VLESSEncryptionKeyPool.shared.takeRelayShare(for: nfsKeys[j])
+            nfsKey = share.sharedSecret
+            var publicKeyOrCiphertext = share.wireBytes
             if xorMode != .native {
                 let ctr = try VLESSEncryptionCTR(key: nfsKeysRaw[j], iv: iv)
                 publicKeyOrCiphertext = ctr.process(publicKeyOrCiphertext)
@@ -500,11 +506,8 @@ nonisolated final class VLESSEncryptionClient {
         let (relayBlock, nfsKey) = try buildRelayBlock(iv: iv)
         let nfsAEAD = VLESSEncryptionAEAD(context: iv, key: nfsKey, useAES: useAES)
 
-        let mlkemPriv = try MLKEM768.PrivateKey()
-        let x25519Priv = Curve25519.KeyAgreement.PrivateKey()
-        var pfsPublic = Data()
-        pfsPublic.append(mlkemPriv.publicKey.rawRepresentation)        // 1184 bytes
-        pfsPublic.append(x25519Priv.publicKey.rawRepresentation)       // 32 bytes
+        let keyPair = try VLESSEncryptionKeyPool.shared.takeKeyPair()
+        let pfsPublic = keyPair.publicKey                              // 1184 + 32 bytes
 
         // Length frame encodes the SEALED body size (plaintext + AEAD tag), not the
         // plaintext size — the server reads exactly that many bytes as ciphertext+tag.
@@ -543,8 +546,8 @@ nonisolated final class VLESSEncryptionClient {
         let state = InFlightHandshake(
             iv: iv,
             nfsKey: nfsKey,
-            mlkemPriv: mlkemPriv,
-            x25519Priv: x25519Priv,
+            mlkemPriv: keyPair.mlkem,
+            x25519Priv: keyPair.x25519,
             pfsClientPublicKey: pfsPublic,
             nfsAEAD: nfsAEAD
         )
@@ -0,0 +1,152 @@
+//
+//  VLESSEncryptionKeyPool.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import CryptoKit
+
+// MARK: - Pooled material
+
+/// Single-use PFS key shares for a 1-RTT client hello.
+@available(iOS 26.0, macOS 26.0, tvOS 26.0, *)
+nonisolated struct VLESSEncryptionKeyPair {
+    let mlkem: MLKEM768.PrivateKey
+    let x25519: Curve25519.KeyAgreement.PrivateKey
+    /// ML-KEM encapsulation key (1184) + X25519 public key (32), as sent.
+    let publicKey: Data
+
+    static func make() throws -> VLESSEncryptionKeyPair {
+        let mlkem = try MLKEM768.PrivateKey()
+        let x25519 = Curve25519.KeyAgreement.PrivateKey()
+        var publicKey = Data(capacity: 1216)
+        publicKey.append(mlkem.publicKey.rawRepresentation)
+        publicKey.append(x25519.publicKey.rawRepresentation)
+        return VLESSEncryptionKeyPair(mlkem: mlkem, x25519: x25519, publicKey: publicKey)
+    }
+}
+
+/// Single-use agreement with one relay's key: the X25519 public key or ML-KEM
+/// ciphertext for the relay block, and the secret it yields.
+nonisolated struct VLESSRelayShare {
+    let sharedSecret: Data
+    /// Before any XOR masking.
+    let wireBytes: Data
+}
+
+// MARK: - VLESSEncryptionKeyPool
+
+/// Keeps a few ephemeral PFS key pairs, and relay shares per server key, ready on a
+/// utility queue, so a dial that misses the 0-RTT cache skips ML-KEM key generation
+/// and encapsulation. Each item is handed out once and only within ``maxAge`` of its
+/// generation; an empty pool falls back to generating inline.
+@available(iOS 26.0, macOS 26.0, tvOS 26.0, *)
+nonisolated final class VLESSEncryptionKeyPool {
+
+    static let shared = VLESSEncryptionKeyPool()
+
+    /// Ephemeral secrets don't linger in memory past this.
+    private static let maxAge: CFAbsoluteTime = 60
+
+    private let queue = DispatchQueue(label: AWCore.Identifier.vlessKeyPoolQueue, qos: .utility)
+    private let keyPairs: Reservoir<Int, VLESSEncryptionKeyPair>
+    private let relayShares: Reservoir<Data, VLESSRelayShare>
+
+    private init() {
+        keyPairs = Reservoir(queue: queue, depth: 4, maxKeys: 1, maxAge: Self.maxAge)
+        relayShares = Reservoir(queue: queue, depth: 4, maxKeys: 8, maxAge: Self.maxAge)
+    }
+
+    func takeKeyPair() throws -> VLESSEncryptionKeyPair {
+        try keyPairs.take(0, make: VLESSEncryptionKeyPair.make)
+    }
+
+    func takeRelayShare(for key: VLESSNfsPublicKey) throws -> VLESSRelayShare {
+        try relayShares.take(key.rawBytes, make: key.makeShare)
+    }
+
+    /// Fills the pools `config`'s handshakes draw on, ahead of the first dial.
+    func prewarm(_ config: VLESSEncryptionConfig) {
+        keyPairs.prewarm(0, make: VLESSEncryptionKeyPair.make)
+        for raw in config.publicKeys {
+            guard let key = try? VLESSNfsPublicKey.parse(raw) else { continue }
+            relayShares.prewarm(raw, make: key.makeShare)
+        }
+    }
+
+    func removeAll() {
+        keyPairs.removeAll()
+        relayShares.removeAll()
+    }
+}
+
+// MARK: - Reservoir
+
+/// Per-key queues of single-use items, topped up to `depth` on `queue`.
+nonisolated private final class Reservoir<Key: Hashable, Item> {
+    private let queue: DispatchQueue
+    private let depth: Int
+    private let maxKeys: Int
+    private let maxAge: CFAbsoluteTime
+    private let lock = UnfairLock()
+    private var ready: [Key: [(item: Item, created: CFAbsoluteTime)]] = [:]
+    private var refilling: Set<Key> = []
+
+    init(queue: DispatchQueue, depth: Int, maxKeys: Int, maxAge: CFAbsoluteTime) {
+        self.queue = queue
+        self.depth = depth
+        self.maxKeys = maxKeys
+        self.maxAge = maxAge
+    }
+
+    /// The oldest fresh item for `key`, made inline when none is queued; either
+    /// way the queue is topped back up in the background.
+    func take(_ key: Key, make: @escaping () throws -> Item) throws -> Item {
+        let now = CFAbsoluteTimeGetCurrent()
+        let item: Item? = lock.withLock {
+            guard var queued = ready[key] else { return nil }
+            queued.removeAll { now - $0.created > maxAge }
+            let first = queued.isEmpty ? nil : queued.removeFirst().item
+            ready[key] = queued
+            return first
+        }
+        prewarm(key, make: make)
+        if let item { return item }
+        return try make()
+    }
+
+    func prewarm(_ key: Key, make: @escaping () throws -> Item) {
+        let start: Bool = lock.withLock {
+            guard !refilling.contains(key), (ready[key]?.count ?? 0) < depth else { return false }
+            if ready[key] == nil, ready.count >= maxKeys {
+                ready.removeAll()
+            }
+            refilling.insert(key)
+            return true
+        }
+        guard start else { return }
+        queue.async { [self] in
+            while true {
+                let needed: Bool = lock.withLock {
+                    guard (ready[key]?.count ?? 0) < depth else {
+                        refilling.remove(key)
+                        return false
+                    }
+                    return true
+                }
+                guard needed else { return }
+                guard let item = try? make() else {
+                    lock.withLock { _ = refilling.remove(key) }
+                    return
+                }
+                lock.withLock { ready[key, default: []].append((item, CFAbsoluteTimeGetCurrent())) }
+            }
+        }
+    }
+
+    func removeAll() {
+        lock.withLock { ready.removeAll() }
+    }
+}
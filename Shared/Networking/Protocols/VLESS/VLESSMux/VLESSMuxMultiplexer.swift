@@ -0,0 +1,256 @@
+//
+//  VLESSMuxMultiplexer.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "VLESSMuxMultiplexer")
+
+/// One VLESS `v1.mux.cool` connection carrying up to ``maxConcurrentStreams`` TCP flows as
+/// mux.cool sub-connections, so they share its transport and TLS/REALITY handshake.
+nonisolated final class VLESSMuxMultiplexer: Multiplexer {
+
+    /// Concurrent sub-connections per mux connection; Xray's default `concurrency`.
+    static let maxConcurrentStreams = 8
+
+    /// Sub-connections over the connection's lifetime before it stops taking new ones and
+    /// drains (Xray's client strategy); also keeps 16-bit session IDs from wrapping.
+    static let maxLifetimeStreams = 128
+
+    /// Payload bytes per Keep frame; longer writes are split.
+    private static let maxFramePayload = 8192
+
+    private let connection: ProxyConnection
+    /// Owns the socket and TLS objects beneath `connection`; released on close.
+    private var client: ProxyClient?
+    private let outerTLSVersion: TLSVersion?
+
+    private let lock = UnfairLock()
+    private var streams: [UInt16: VLESSMuxStream] = [:]
+    private var reserved = 0
+    private var opened = 0
+    private var nextSessionID: UInt16 = 1
+    private var closed = false
+
+    // Write serialization (frames must not interleave)
+    private var writeQueue: [(Data, (Error?) -> Void)] = []
+    private var isWriting = false
+
+    /// Touched only from the receive loop, which delivers serially.
+    private let frameParser = VLESSVisionUDPFrameParser()
+
+    /// Fires once when the connection closes; the pool uses it to evict.
+    var onClose: (() -> Void)?
+
+    init(connection: ProxyConnection, client: ProxyClient) {
+        self.connection = connection
+        self.client = client
+        self.outerTLSVersion = connection.outerTLSVersion
+    }
+
+    // MARK: - Capacity
+
+    var isClosed: Bool { lock.withLock { closed } }
+    var activeStreamCount: Int { lock.withLock { streams.count + reserved } }
+
+    /// Claims a slot for ``openReservedStream(host:port:initialData:completion:)``; false
+    /// when closed or at either stream cap.
+    func tryReserveStream() -> Bool {
+        lock.withLock {
+            guard !closed,
+                  streams.count + reserved < Self.maxConcurrentStreams,
+                  opened + reserved < Self.maxLifetimeStreams else { return false }
+            reserved += 1
+            return true
+        }
+    }
+
+    // MARK: - Lifecycle
+
+    func start() {
+        connection.startReceiving(handler: { [weak self] data in
+            self?.handleInbound(data)
+        }, errorHandler: { [weak self] error in
+            self?.close(error: error)
+        })
+    }
+
+    /// Consumes a reservation and opens a session to `host:port`. The New frame carries the
+    /// first chunk of `initialData`, so the destination and first bytes share one write.
+    func openReservedStream(
+        host: String,
+        port: UInt16,
+        initialData: Data?,
+        completion: @escaping (Result<VLESSMuxStream, Error>) -> Void
+    ) {
+        lock.lock()
+        reserved -= 1
+        guard !closed else {
+            lock.unlock()
+            completion(.failure(ProxyError.connectionFailed("Mux connection closed")))
+            return
+        }
+        let sessionID = nextSessionID
+        nextSessionID &+= 1
+        opened += 1
+        let stream = VLESSMuxStream(sessionID: sessionID, multiplexer: self, outerTLSVersion: outerTLSVersion)
+        streams[sessionID] = stream
+        lock.unlock()
+
+        let initialData = initialData ?? Data()
+        let firstEnd = initialData.startIndex + min(initialData.count, Self.maxFramePayload)
+        let firstChunk = initialData[initialData.startIndex..<firstEnd]
+        let metadata = VLESSVisionUDPFrameMetadata(
+            sessionID: sessionID,
+            status: .new,
+            option: firstChunk.isEmpty ? [] : .data,
+            network: .tcp,
+            targetHost: host,
+            targetPort: port
+        )
+        var frame = VLESSVisionUDPFrame.encode(metadata: metadata, payload: firstChunk.isEmpty ? nil : Data(firstChunk))
+        appendKeepFrames(sessionID: sessionID, data: initialData[firstEnd...], into: &frame)
+
+        logger.debug("[VLESSMux] open session=\(sessionID) initialData=\(initialData.count)B")
+        enqueueWrite(frame) { [weak self] error in
+            if let error {
+                if let self {
+                    self.lock.withLock { _ = self.streams.removeValue(forKey: sessionID) }
+                }
+                completion(.failure(error))
+            } else {
+                completion(.success(stream))
+            }
+        }
+    }
+
+    /// Ends `sessionID` toward the server; a no-op once the server ended it or the connection closed.
+    func removeStream(sessionID: UInt16) {
+        lock.lock()
+        guard !closed, streams.removeValue(forKey: sessionID) != nil else {
+            lock.unlock()
+            return
+        }
+        lock.unlock()
+
+        let metadata = VLESSVisionUDPFrameMetadata(sessionID: sessionID, status: .end, option: [])
+        enqueueWrite(VLESSVisionUDPFrame.encode(metadata: metadata, payload: nil), completion: { _ in })
+    }
+
+    // MARK: - Send
+
+    func writeData(sessionID: UInt16, data: Data, completion: @escaping (Error?) -> Void) {
+        guard !data.isEmpty else { completion(nil); return }
+        var frames = Data(capacity: data.count + (data.count / Self.maxFramePayload + 1) * 8)
+        appendKeepFrames(sessionID: sessionID, data: data[...], into: &frames)
+        enqueueWrite(frames, completion: completion)
+    }
+
+    private func appendKeepFrames(sessionID: UInt16, data: Data.SubSequence, into out: inout Data) {
+        let metadata = VLESSVisionUDPFrameMetadata(sessionID: sessionID, status: .keep, option: .data)
+        var offset = data.startIndex
+        while offset < data.endIndex {
+            let end = min(offset + Self.maxFramePayload, data.endIndex)
+            out.append(VLESSVisionUDPFrame.encode(metadata: metadata, payload: Data(data[offset..<end])))
+            offset = end
+        }
+    }
+
+    private func enqueueWrite(_ data: Data, completion: @escaping (Error?) -> Void) {
+        lock.lock()
+        guard !closed else {
+            lock.unlock()
+            completion(ProxyError.connectionFailed("Mux connection closed"))
+            return
+        }
+        writeQueue.append((data, completion))
+        guard !isWriting else {
+            lock.unlock()
+            return
+        }
+        isWriting = true
+        lock.unlock()
+        drainWriteQueue()
+    }
+
+    /// Sends one queued write at a time; the caller has set `isWriting`.
+    private func drainWriteQueue() {
+        lock.lock()
+        guard !closed, !writeQueue.isEmpty else {
+            isWriting = false
+            lock.unlock()
+            return
+        }
+        let (data, completion) = writeQueue.removeFirst()
+        lock.unlock()
+
+        connection.sendRaw(data: data) { [weak self] error in
+            completion(error)
+            guard let self else { return }
+            if let error {
+                self.close(error: error)
+            } else {
+                self.drainWriteQueue()
+            }
+        }
+    }
+
+    // MARK: - Demux
+
+    private func handleInbound(_ data: Data) {
+        for (metadata, payload) in frameParser.feed(data) {
+            switch metadata.status {
+            case .keep:
+                guard let payload, !payload.isEmpty else { continue }
+                let stream = lock.withLock { streams[metadata.sessionID] }
+                stream?.deliverData(Data(payload))
+
+            case .end:
+                let stream = lock.withLock { streams.removeValue(forKey: metadata.sessionID) }
+                guard let stream else { continue }
+                if let payload, !payload.isEmpty {
+                    stream.deliverData(Data(payload))
+                }
+                let error: Error? = metadata.option.contains(.error)
+                    ? ProxyError.connectionFailed("Mux session closed by server")
+                    : nil
+                stream.deliverClose(error: error)
+
+            case .new, .keepAlive:
+                // Server-initiated sessions aren't used outbound; keep-alives need no reply.
+                break
+            }
+        }
+    }
+
+    // MARK: - Close
+
+    /// Idempotent; a non-nil error propagates to every live stream.
+    func close(error: Error?) {
+        lock.lock()
+        guard !closed else { lock.unlock(); return }
+        closed = true
+        let liveStreams = Array(streams.values)
+        streams.removeAll()
+        let queued = writeQueue
+        writeQueue.removeAll()
+        let client = self.client
+        self.client = nil
+        lock.unlock()
+
+        let reasonText = error.map { $0.localizedDescription } ?? "clean"
+        logger.debug("[VLESSMux] close streams=\(liveStreams.count) reason=\(reasonText)")
+        for stream in liveStreams {
+            stream.deliverClose(error: error)
+        }
+        for (_, completion) in queued {
+            completion(ProxyError.connectionFailed("Mux connection closed"))
+        }
+        connection.cancel()
+        client?.cancel()
+        onClose?()
+    }
+}
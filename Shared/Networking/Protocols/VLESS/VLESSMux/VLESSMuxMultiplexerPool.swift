@@ -0,0 +1,138 @@
+//
+//  VLESSMuxMultiplexerPool.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "VLESSMuxPool")
+
+/// Pools VLESS mux.cool connections so direct-route TCP flows share a transport and its
+/// TLS/REALITY handshake, up to ``VLESSMuxMultiplexer/maxConcurrentStreams`` each.
+/// Opt-in via ``isEnabled``; connections self-evict via `onClose`.
+nonisolated final class VLESSMuxMultiplexerPool: MultiplexerPool<VLESSMuxMultiplexer> {
+
+    static let shared = VLESSMuxMultiplexerPool()
+
+    /// Dials a `v1.mux.cool` connection and wraps it in a pooled ``VLESSMuxMultiplexer``.
+    typealias DialOut = (@escaping (Result<VLESSMuxMultiplexer, Error>) -> Void) -> Void
+
+    /// Set by the tunnel from the VLESS Mux setting; checked per flow.
+    var isEnabled: Bool {
+        get { lock.withLock { enabled } }
+        set { lock.withLock { enabled = newValue } }
+    }
+    private var enabled = false
+
+    /// Callers waiting on a dial already in flight for their key, called with the dial's error
+    /// or nil to retry; coalesced so a burst of flows opens one connection rather than one each.
+    private var pendingDials: [String: [(Error?) -> Void]] = [:]
+
+    private static let poolPolicy = MultiplexerPolicy(
+        idleTimeout: 30,
+        idleCheckInterval: 15
+    )
+
+    private override init() {
+        super.init()
+        startIdleEviction(Self.poolPolicy)
+    }
+
+    /// Any configuration change (server, transport, security, UUID) dials a fresh bucket;
+    /// the old one idles out.
+    static func makeKey(for configuration: ProxyConfiguration) -> String {
+        "vless-mux|\(configuration.id)|\(configuration.hashValue)"
+    }
+
+    // MARK: - Acquire
+
+    /// Opens a sub-connection to `host:port` on a pooled connection for `key`, dialing one via
+    /// `dialOut` when every connection is at its stream cap.
+    func acquireStream(
+        key: String,
+        host: String,
+        port: UInt16,
+        initialData: Data?,
+        dialOut: @escaping DialOut,
+        completion: @escaping (Result<VLESSMuxStream, Error>) -> Void
+    ) {
+        lock.lock()
+        multiplexers[key]?.removeAll { $0.isClosed }
+        if let existing = multiplexers[key]?.first(where: { $0.tryReserveStream() }) {
+            lastActivity[ObjectIdentifier(existing)] = MonotonicClock.now
+            lock.unlock()
+            existing.openReservedStream(host: host, port: port, initialData: initialData, completion: completion)
+            return
+        }
+        if pendingDials[key] != nil {
+            pendingDials[key]?.append { [weak self] error in
+                guard let self else {
+                    completion(.failure(ProxyError.connectionFailed("Mux pool deallocated")))
+                    return
+                }
+                if let error {
+                    completion(.failure(error))
+                } else {
+                    self.acquireStream(
+                        key: key, host: host, port: port, initialData: initialData,
+                        dialOut: dialOut, completion: completion
+                    )
+                }
+            }
+            lock.unlock()
+            return
+        }
+        pendingDials[key] = []
+        lock.unlock()
+
+        logger.debug("[VLESSMuxPool] dialing mux connection for \(key)")
+        dialOut { [weak self] result in
+            guard let self else {
+                if case .success(let multiplexer) = result { multiplexer.close(error: nil) }
+                completion(.failure(ProxyError.connectionFailed("Mux pool deallocated")))
+                return
+            }
+            switch result {
+            case .failure(let error):
+                logger.debug("[VLESSMuxPool] dial failed: \(error.localizedDescription)")
+                self.finishDial(key: key, error: error)
+                completion(.failure(error))
+
+            case .success(let multiplexer):
+                multiplexer.onClose = { [weak self, weak multiplexer] in
+                    guard let self, let multiplexer else { return }
+                    self.removeMultiplexer(multiplexer, key: key)
+                }
+                // Reserve the initiator's slot before publishing, so waiters can't take it.
+                _ = multiplexer.tryReserveStream()
+                self.lock.lock()
+                self.multiplexers[key, default: []].append(multiplexer)
+                self.lastActivity[ObjectIdentifier(multiplexer)] = MonotonicClock.now
+                self.lock.unlock()
+                multiplexer.start()
+
+                multiplexer.openReservedStream(host: host, port: port, initialData: initialData, completion: completion)
+                self.finishDial(key: key, error: nil)
+            }
+        }
+    }
+
+    /// Releases the waiters on `key`: on success they re-run the acquire and land on the new
+    /// connection (or dial the next when it filled up), on failure they share the error.
+    private func finishDial(key: String, error: Error?) {
+        lock.lock()
+        let waiters = pendingDials.removeValue(forKey: key) ?? []
+        lock.unlock()
+
+        for waiter in waiters { waiter(error) }
+    }
+
+    // MARK: - Eviction
+
+    override func removeMultiplexer(_ multiplexer: VLESSMuxMultiplexer, key: String) {
+        super.removeMultiplexer(multiplexer, key: key)
+        logger.debug("[VLESSMuxPool] Evicted connection for \(key)")
+    }
+}
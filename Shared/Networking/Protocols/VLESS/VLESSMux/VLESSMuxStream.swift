@@ -0,0 +1,121 @@
+//
+//  VLESSMuxStream.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "VLESSMuxStream")
+
+/// One proxied TCP flow carried as a mux.cool sub-connection of a pooled
+/// ``VLESSMuxMultiplexer``.
+nonisolated final class VLESSMuxStream: ProxyConnection, MultiplexerStreamSink {
+
+    let sessionID: UInt16
+    private weak var multiplexer: VLESSMuxMultiplexer?
+
+    /// Captured at construction so `outerTLSVersion` keeps working after the multiplexer goes away.
+    private let cachedTLSVersion: TLSVersion?
+
+    private let receiveLock = UnfairLock()
+    private var pendingReceive: ((Data?, Error?) -> Void)?
+    private var incoming: [Data] = []
+    private var receiveError: Error?
+    private var eof: Bool = false
+    private var locallyCancelled: Bool = false
+
+    init(sessionID: UInt16, multiplexer: VLESSMuxMultiplexer, outerTLSVersion: TLSVersion?) {
+        self.sessionID = sessionID
+        self.multiplexer = multiplexer
+        self.cachedTLSVersion = outerTLSVersion
+    }
+
+    override var isConnected: Bool {
+        receiveLock.withLock { !eof && receiveError == nil } && !(multiplexer?.isClosed ?? true)
+    }
+
+    override var outerTLSVersion: TLSVersion? { cachedTLSVersion }
+
+    // MARK: Send
+
+    override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
+        guard let multiplexer else {
+            completion(ProxyError.connectionFailed("Mux multiplexer deallocated"))
+            return
+        }
+        multiplexer.writeData(sessionID: sessionID, data: data, completion: completion)
+    }
+
+    override func sendRaw(data: Data) {
+        multiplexer?.writeData(sessionID: sessionID, data: data, completion: { _ in })
+    }
+
+    // MARK: Receive
+
+    override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
+        receiveLock.lock()
+        if !incoming.isEmpty {
+            let chunk = incoming.removeFirst()
+            receiveLock.unlock()
+            completion(chunk, nil)
+            return
+        }
+        if let error = receiveError {
+            receiveLock.unlock()
+            completion(nil, error)
+            return
+        }
+        if eof {
+            receiveLock.unlock()
+            completion(nil, nil)
+            return
+        }
+        pendingReceive = completion
+        receiveLock.unlock()
+    }
+
+    // MARK: Cancel
+
+    /// Sends the End frame for this session; the mux connection stays up for its siblings.
+    override func cancel() {
+        receiveLock.lock()
+        let already = locallyCancelled
+        locallyCancelled = true
+        receiveLock.unlock()
+        guard !already else { return }
+        logger.debug("[VLESSMuxStream] cancel session=\(sessionID)")
+        multiplexer?.removeStream(sessionID: sessionID)
+        deliverClose(error: nil)
+    }
+
+    // MARK: - Called by VLESSMuxMultiplexer on the recv loop
+
+    func deliverData(_ data: Data) {
+        receiveLock.lock()
+        if let callback = pendingReceive {
+            pendingReceive = nil
+            receiveLock.unlock()
+            callback(data, nil)
+        } else {
+            incoming.append(data)
+            receiveLock.unlock()
+        }
+    }
+
+    /// Delivers a clean EOF (`nil`) or failure; bytes already queued are still readable.
+    func deliverClose(error: Error?) {
+        receiveLock.lock()
+        if eof {
+            receiveLock.unlock()
+            return
+        }
+        receiveError = error
+        eof = true
+        let callback = pendingReceive
+        pendingReceive = nil
+        receiveLock.unlock()
+        callback?(nil, error)
+    }
+}
@@ -73,38 +73,43 @@ private let visionBufSize: Int32 = 8192
 /// Buffers >= this are split to leave room for the 21-byte padding header.
 private let reshapeThreshold: Int = 8192 - 21
 
-/// Splits data too large for one Vision-padded frame at the last TLS application-data
-/// boundary (midpoint fallback), recursing until every chunk is below reshapeThreshold.
-private func reshapeData(_ data: Data) -> [Data] {
-    guard data.count >= reshapeThreshold else {
-        return [data]
+/// Splits `range` of a send buffer into content ranges small enough for one
+/// Vision frame, cutting at the last TLS application-data boundary (midpoint
+/// fallback) and recursing until every chunk is below reshapeThreshold.
+/// Works on offsets so a send is split without copying any chunk.
+func reshapeRanges(_ bytes: UnsafeBufferPointer<UInt8>, _ range: Range<Int>, into ranges: inout [Range<Int>]) {
+    guard range.count >= reshapeThreshold else {
+        ranges.append(range)
+        return
     }
 
-    var splitIndex = data.count / 2
-    data.withUnsafeBytes { pointer in
-        let bytes = pointer.bindMemory(to: UInt8.self)
-        for i in stride(from: bytes.count - 3, through: 0, by: -1) {
-            if bytes[i] == 0x17 && bytes[i + 1] == 0x03 && bytes[i + 2] == 0x03 {
-                if i >= 21 && i <= reshapeThreshold {
-                    splitIndex = i
-                    break
-                }
+    var splitIndex = range.count / 2
+    for i in stride(from: range.count - 3, through: 0, by: -1) {
+        let at = range.lowerBound + i
+        if bytes[at] == 0x17 && bytes[at + 1] == 0x03 && bytes[at + 2] == 0x03 {
+            if i >= 21 && i <= reshapeThreshold {
+                splitIndex = i
+                break
             }
         }
     }
 
-    let first = data.prefix(splitIndex)
-    let second = data.suffix(from: data.index(data.startIndex, offsetBy: splitIndex))
     // Either chunk may still exceed reshapeThreshold (peer buffers are capped at 8192).
-    return reshapeData(first) + reshapeData(second)
+    reshapeRanges(bytes, range.lowerBound..<(range.lowerBound + splitIndex), into: &ranges)
+    reshapeRanges(bytes, (range.lowerBound + splitIndex)..<range.upperBound, into: &ranges)
 }
 
 // MARK: - Padding Functions
 
-/// Frame layout: `[UUID (16 bytes, first packet only)] [command (1)] [contentLen (2)] [paddingLen (2)] [content] [padding]`.
+/// One frame of a send: a content range of the send buffer and its command.
+struct VisionFrame {
+    let content: Range<Int>
+    let command: VisionCommand
+    let longPadding: Bool
+}
+
 /// `longPadding` pads short content with a large random block to obscure the VLESS header.
-private func visionPadding(data: Data?, command: VisionCommand, state: VisionTrafficState, longPadding: Bool) -> Data {
-    let contentLen = Int32(data?.count ?? 0)
+private func visionPaddingLength(contentLen: Int32, longPadding: Bool) -> Int32 {
     var paddingLen: Int32 = 0
 
     if contentLen < Int32(visionPaddingSeed[0]) && longPadding {
@@ -122,32 +127,51 @@ private func visionPadding(data: Data?, command: VisionCommand, state: VisionTra
     if paddingLen < 0 {
         paddingLen = 0
     }
+    return paddingLen
+}
+
+/// Frame layout: `[UUID (16 bytes, first packet only)] [command (1)] [contentLen (2)] [paddingLen (2)] [content] [padding]`.
+/// Every frame of a send is sized up front and written into one buffer.
+func visionPadding(_ data: Data, frames: [VisionFrame], state: VisionTrafficState) -> Data {
+    var paddingLens = [Int32]()
+    paddingLens.reserveCapacity(frames.count)
+    var totalLen = state.writeOnceUserUUID != nil ? 16 : 0
+    for frame in frames {
+        let paddingLen = visionPaddingLength(contentLen: Int32(frame.content.count), longPadding: frame.longPadding)
+        paddingLens.append(paddingLen)
+        totalLen += 5 + frame.content.count + Int(paddingLen)
+    }
 
-    let uuidLen = state.writeOnceUserUUID != nil ? 16 : 0
-    let totalLen = uuidLen + 5 + Int(contentLen) + Int(paddingLen)
     var result = Data(count: totalLen)
     result.withUnsafeMutableBytes { pointer in
-        let p = pointer.bindMemory(to: UInt8.self)
+        let p = pointer.bindMemory(to: UInt8.self).baseAddress!
         var offset = 0
 
         if let uuid = state.writeOnceUserUUID {
-            uuid.copyBytes(to: p.baseAddress! + offset, count: 16)
+            uuid.copyBytes(to: p + offset, count: 16)
             offset += 16
         }
 
-        p[offset] = command.rawValue; offset += 1
-        p[offset] = UInt8(contentLen >> 8); offset += 1
-        p[offset] = UInt8(contentLen & 0xFF); offset += 1
-        p[offset] = UInt8(paddingLen >> 8); offset += 1
-        p[offset] = UInt8(paddingLen & 0xFF); offset += 1
-
-        if let data = data {
-            data.copyBytes(to: p.baseAddress! + offset, count: data.count)
-            offset += data.count
-        }
+        data.withUnsafeBytes { source in
+            for (frame, paddingLen) in zip(frames, paddingLens) {
+                let contentLen = frame.content.count
+                p[offset] = frame.command.rawValue
+                p[offset + 1] = UInt8(contentLen >> 8)
+                p[offset + 2] = UInt8(contentLen & 0xFF)
+                p[offset + 3] = UInt8(paddingLen >> 8)
+                p[offset + 4] = UInt8(paddingLen & 0xFF)
+                offset += 5
+
+                if contentLen > 0 {
+                    memcpy(p + offset, source.baseAddress! + frame.content.lowerBound, contentLen)
+                    offset += contentLen
+                }
 
-        if paddingLen > 0 {
-            _ = SecRandomCopyBytes(kSecRandomDefault, Int(paddingLen), p.baseAddress! + offset)
+                if paddingLen > 0 {
+                    _ = SecRandomCopyBytes(kSecRandomDefault, Int(paddingLen), p + offset)
+                    offset += Int(paddingLen)
+                }
+            }
         }
     }
     state.writeOnceUserUUID = nil
@@ -155,10 +179,12 @@ private func visionPadding(data: Data?, command: VisionCommand, state: VisionTra
     return result
 }
 
-private func visionUnpadding(data: inout Data, state: VisionTrafficState) -> Data {
+/// Strips Vision framing from `data`, carrying header/content/padding
+/// progress across reads in `state`. Contiguous content is copied straight
+/// from the read buffer into one result sized for the whole read.
+func visionUnpadding(data: inout Data, state: VisionTrafficState) -> Data {
     var readOffset = 0
     let dataCount = data.count
-    let startIdx = data.startIndex
 
     if state.remainingCommand == -1 && state.remainingContent == -1 && state.remainingPadding == -1 {
         if dataCount >= 21 && data.prefix(16) == state.userUUID {
@@ -169,62 +195,67 @@ private func visionUnpadding(data: inout Data, state: VisionTrafficState) -> Dat
         }
     }
 
-    var result = Data()
-
-    while readOffset < dataCount {
-        if state.remainingCommand > 0 {
-            let byte = data[startIdx + readOffset]
-            readOffset += 1
-            switch state.remainingCommand {
-            case 5:
-                state.currentCommand = Int(byte)
-            case 4:
-                state.remainingContent = Int32(byte) << 8
-            case 3:
-                state.remainingContent |= Int32(byte)
-            case 2:
-                state.remainingPadding = Int32(byte) << 8
-            case 1:
-                state.remainingPadding |= Int32(byte)
-            default:
-                break
-            }
-            state.remainingCommand -= 1
-        } else if state.remainingContent > 0 {
-            let remaining = dataCount - readOffset
-            let toRead = min(Int(state.remainingContent), remaining)
-            result.append(data[(startIdx + readOffset)..<(startIdx + readOffset + toRead)])
-            readOffset += toRead
-            state.remainingContent -= Int32(toRead)
-        } else if state.remainingPadding > 0 {
-            let remaining = dataCount - readOffset
-            let toSkip = min(Int(state.remainingPadding), remaining)
-            readOffset += toSkip
-            state.remainingPadding -= Int32(toSkip)
-        }
+    var result = Data(count: dataCount)
+    var written = 0
+
+    result.withUnsafeMutableBytes { output in
+        let out = output.bindMemory(to: UInt8.self).baseAddress!
+        data.withUnsafeBytes { input in
+            let bytes = input.bindMemory(to: UInt8.self)
+
+            while readOffset < dataCount {
+                if state.remainingCommand > 0 {
+                    let byte = bytes[readOffset]
+                    readOffset += 1
+                    switch state.remainingCommand {
+                    case 5:
+                        state.currentCommand = Int(byte)
+                    case 4:
+                        state.remainingContent = Int32(byte) << 8
+                    case 3:
+                        state.remainingContent |= Int32(byte)
+                    case 2:
+                        state.remainingPadding = Int32(byte) << 8
+                    case 1:
+                        state.remainingPadding |= Int32(byte)
+                    default:
+                        break
+                    }
+                    state.remainingCommand -= 1
+                } else if state.remainingContent > 0 {
+                    let toRead = min(Int(state.remainingContent), dataCount - readOffset)
+                    memcpy(out + written, bytes.baseAddress! + readOffset, toRead)
+                    written += toRead
+                    readOffset += toRead
+                    state.remainingContent -= Int32(toRead)
+                } else if state.remainingPadding > 0 {
+                    let toSkip = min(Int(state.remainingPadding), dataCount - readOffset)
+                    readOffset += toSkip
+                    state.remainingPadding -= Int32(toSkip)
+                }
 
-        if state.remainingCommand <= 0 && state.remainingContent <= 0 && state.remainingPadding <= 0 {
-            if state.currentCommand == 0 {
-                state.remainingCommand = 5
-            } else {
-                state.remainingCommand = -1
-                state.remainingContent = -1
-                state.remainingPadding = -1
-                if readOffset < dataCount {
-                    result.append(data[(startIdx + readOffset)..<(startIdx + dataCount)])
-                    readOffset = dataCount
+                if state.remainingCommand <= 0 && state.remainingContent <= 0 && state.remainingPadding <= 0 {
+                    if state.currentCommand == 0 {
+                        state.remainingCommand = 5
+                    } else {
+                        state.remainingCommand = -1
+                        state.remainingContent = -1
+                        state.remainingPadding = -1
+                        if readOffset < dataCount {
+                            memcpy(out + written, bytes.baseAddress! + readOffset, dataCount - readOffset)
+                            written += dataCount - readOffset
+                            readOffset = dataCount
+                        }
+                        break
+                    }
                 }
-                break
             }
         }
     }
 
-    if readOffset >= dataCount {
-        data = Data()
-    } else {
-        data = Data(data[(startIdx + readOffset)...])
-    }
-
+    // Every path above consumes the whole read.
+    data = Data()
+    if written < dataCount { result.removeSubrange(written..<dataCount) }
     return result
 }
 
@@ -297,39 +328,22 @@ private func visionDetectClientHello(data: Data, state: VisionTrafficState) {
     }
 }
 
-private func isCompleteTLSRecord(data: Data) -> Bool {
-    let totalLen = data.count
-
-    guard totalLen >= 5 else { return false }
-
-    let startIdx = data.startIndex
-    guard data[startIdx] == 0x17 &&
-          data[data.index(startIdx, offsetBy: 1)] == 0x03 &&
-          data[data.index(startIdx, offsetBy: 2)] == 0x03 else { return false }
-
+/// Whether `bytes` is a whole number of TLS 1.2+ application-data records,
+/// walked header to header in one pass.
+private func isCompleteTLSRecord(_ bytes: UnsafeBufferPointer<UInt8>) -> Bool {
+    let totalLen = bytes.count
     var offset = 0
 
     while offset < totalLen {
-        guard offset + 5 <= totalLen else { return false }
+        guard offset + 5 <= totalLen,
+              bytes[offset] == 0x17,
+              bytes[offset + 1] == 0x03,
+              bytes[offset + 2] == 0x03 else { return false }
 
-        let idx0 = data.index(startIdx, offsetBy: offset)
-        let idx1 = data.index(startIdx, offsetBy: offset + 1)
-        let idx2 = data.index(startIdx, offsetBy: offset + 2)
-        let idx3 = data.index(startIdx, offsetBy: offset + 3)
-        let idx4 = data.index(startIdx, offsetBy: offset + 4)
-
-        guard data[idx0] == 0x17,
-              data[idx1] == 0x03,
-              data[idx2] == 0x03 else { return false }
-
-        let recordLen = Int(data[idx3]) << 8 | Int(data[idx4])
-        offset += 5
-
-        guard offset + recordLen <= totalLen else { return false }
-        offset += recordLen
+        offset += 5 + (Int(bytes[offset + 3]) << 8 | Int(bytes[offset + 4]))
     }
 
-    return offset == totalLen
+    return totalLen >= 5 && offset == totalLen
 }
 
 // MARK: - Vision Connection Wrapper
@@ -348,7 +362,7 @@ nonisolated class VLESSVisionConnection: ProxyConnection {
     /// data is available. Callers must wait on `completion` before subsequent sends.
     func sendEmptyPadding(completion: @escaping (Error?) -> Void) {
         lock.lock()
-        let padded = visionPadding(data: nil, command: .paddingContinue, state: trafficState, longPadding: true)
+        let padded = visionPadding(Data(), frames: [VisionFrame(content: 0..<0, command: .paddingContinue, longPadding: true)], state: trafficState)
         lock.unlock()
         innerConnection.send(data: padded, completion: completion)
     }
@@ -397,51 +411,42 @@ nonisolated class VLESSVisionConnection: ProxyConnection {
         }
 
         let longPadding = trafficState.isTLS
-        let isComplete = isCompleteTLSRecord(data: data)
-
-        let chunks = reshapeData(data)
-
-        // A complete TLS application-data record ends padding mode.
-        let startIdx = data.startIndex
-        if trafficState.isTLS && data.count >= 6 &&
-           data[startIdx] == tlsApplicationDataStart[0] &&
-           data[data.index(startIdx, offsetBy: 1)] == tlsApplicationDataStart[1] &&
-           data[data.index(startIdx, offsetBy: 2)] == tlsApplicationDataStart[2] &&
-           isComplete {
-
-            var result = Data()
-            for (i, chunk) in chunks.enumerated() {
-                if i == chunks.count - 1 {
-                    var command: VisionCommand = .paddingEnd
-                    if trafficState.enableXtls {
-                        command = .paddingDirect
-                        trafficState.writerDirectCopy = true
-                    }
-                    trafficState.writerIsPadding = false
-                    result.append(visionPadding(data: chunk, command: command, state: trafficState, longPadding: false))
-                } else {
-                    result.append(visionPadding(data: chunk, command: .paddingContinue, state: trafficState, longPadding: true))
-                }
+
+        // One pass over the send: frame boundaries and whether it is all
+        // complete TLS application-data records (which ends padding mode).
+        var chunks = [Range<Int>]()
+        let endsPadding: Bool = data.withUnsafeBytes { raw in
+            let bytes = raw.bindMemory(to: UInt8.self)
+            reshapeRanges(bytes, 0..<bytes.count, into: &chunks)
+            return trafficState.isTLS && bytes.count >= 6 && isCompleteTLSRecord(bytes)
+        }
+
+        if endsPadding {
+            var command: VisionCommand = .paddingEnd
+            if trafficState.enableXtls {
+                command = .paddingDirect
+                trafficState.writerDirectCopy = true
+            }
+            trafficState.writerIsPadding = false
+            let frames = chunks.enumerated().map { i, chunk in
+                i == chunks.count - 1
+                    ? VisionFrame(content: chunk, command: command, longPadding: false)
+                    : VisionFrame(content: chunk, command: .paddingContinue, longPadding: true)
             }
-            return result
+            return visionPadding(data, frames: frames, state: trafficState)
         }
 
         // Finish padding one packet early for older Vision receivers (the `<= 1` boundary).
         if !trafficState.isTLS12orAbove && trafficState.numberOfPacketsToFilter <= 1 {
             trafficState.writerIsPadding = false
-            var result = Data()
-            for (i, chunk) in chunks.enumerated() {
-                let cmd: VisionCommand = (i == chunks.count - 1) ? .paddingEnd : .paddingContinue
-                result.append(visionPadding(data: chunk, command: cmd, state: trafficState, longPadding: longPadding))
+            let frames = chunks.enumerated().map { i, chunk in
+                VisionFrame(content: chunk, command: i == chunks.count - 1 ? .paddingEnd : .paddingContinue, longPadding: longPadding)
             }
-            return result
+            return visionPadding(data, frames: frames, state: trafficState)
         }
 
-        var result = Data()
-        for chunk in chunks {
-            result.append(visionPadding(data: chunk, command: .paddingContinue, state: trafficState, longPadding: longPadding))
-        }
-        return result
+        let frames = chunks.map { VisionFrame(content: $0, command: .paddingContinue, longPadding: longPadding) }
+        return visionPadding(data, frames: frames, state: trafficState)
     }
 
     override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
@@ -499,6 +504,14 @@ nonisolated class VLESSVisionConnection: ProxyConnection {
         }
     }
 
+    override var directReceiveTransport: (any RawTransport)? {
+        lock.withLock { trafficState.readerDirectCopy } ? innerConnection.directReceiveTransport : nil
+    }
+
+    override var directSendTransport: (any RawTransport)? {
+        lock.withLock { trafficState.writerDirectCopy } ? innerConnection.directSendTransport : nil
+    }
+
     // The inner connection already handles response-header processing.
     override func receive(completion: @escaping (Data?, Error?) -> Void) {
         receiveRaw(completion: completion)
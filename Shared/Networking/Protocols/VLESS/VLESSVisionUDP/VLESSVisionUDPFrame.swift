@@ -216,31 +216,40 @@ enum VLESSVisionUDPFrame {
 // MARK: - Streaming Frame Parser
 
 nonisolated class VLESSVisionUDPFrameParser {
+    /// Only the incomplete frame left at the end of the last delivery.
     private var buffer = Data()
-    private var bufferOffset = 0
-
-    /// Compaction threshold — avoid O(n) shifts until dead space is significant.
-    private static let compactThreshold = 4096
 
+    /// Frames are parsed in place: straight out of `data` when nothing is carried over,
+    /// otherwise out of the carry with `data` appended. Payloads are slices of that
+    /// storage, and only a trailing partial frame is copied out to wait for the rest.
     func feed(_ data: Data) -> [(metadata: VLESSVisionUDPFrameMetadata, payload: Data?)] {
-        buffer.append(data)
+        let input: Data
+        if buffer.isEmpty {
+            input = data
+        } else {
+            buffer.append(data)
+            input = buffer
+        }
+        buffer = Data()
+
         var results: [(VLESSVisionUDPFrameMetadata, Data?)] = []
+        let base = input.startIndex
+        var offset = 0
 
         while true {
-            let remaining = buffer.count - bufferOffset
+            let remaining = input.count - offset
             guard remaining >= 2 else { break }
 
-            let metaLen = Int(UInt16(buffer[bufferOffset]) << 8 | UInt16(buffer[bufferOffset + 1]))
+            let frameStart = base + offset
+            let metaLen = Int(UInt16(input[frameStart]) << 8 | UInt16(input[frameStart + 1]))
 
             guard remaining >= 2 + metaLen else { break }
 
-            let metaStart = bufferOffset + 2
-            let metaSlice = buffer[metaStart..<(metaStart + metaLen)]
+            let metaStart = frameStart + 2
+            let metaSlice = input[metaStart..<(metaStart + metaLen)]
             guard let (metadata, _) = VLESSVisionUDPFrameMetadata.decode(from: metaSlice) else {
                 // Corrupt frame — discard buffer
-                buffer.removeAll()
-                bufferOffset = 0
-                break
+                return results
             }
 
             var consumed = 2 + metaLen
@@ -249,7 +258,7 @@ nonisolated class VLESSVisionUDPFrameParser {
             if metadata.option.contains(.data) {
                 guard remaining >= consumed + 2 else { break }
 
-                let payloadLen = Int(UInt16(buffer[bufferOffset + consumed]) << 8 | UInt16(buffer[bufferOffset + consumed + 1]))
+                let payloadLen = Int(UInt16(input[frameStart + consumed]) << 8 | UInt16(input[frameStart + consumed + 1]))
                 consumed += 2
 
                 guard remaining >= consumed + payloadLen else {
@@ -258,28 +267,22 @@ nonisolated class VLESSVisionUDPFrameParser {
                 }
 
                 if payloadLen > 0 {
-                    payload = buffer[(bufferOffset + consumed)..<(bufferOffset + consumed + payloadLen)]
+                    payload = input[(frameStart + consumed)..<(frameStart + consumed + payloadLen)]
                 }
                 consumed += payloadLen
             }
 
             results.append((metadata, payload))
-            bufferOffset += consumed
+            offset += consumed
         }
 
-        if bufferOffset > Self.compactThreshold {
-            buffer.removeSubrange(0..<bufferOffset)
-            bufferOffset = 0
-        } else if bufferOffset > 0 && bufferOffset == buffer.count {
-            buffer.removeAll(keepingCapacity: true)
-            bufferOffset = 0
+        if offset < input.count {
+            buffer = Data(input[(base + offset)...])
         }
-
         return results
     }
 
     func reset() {
         buffer.removeAll()
-        bufferOffset = 0
     }
 }
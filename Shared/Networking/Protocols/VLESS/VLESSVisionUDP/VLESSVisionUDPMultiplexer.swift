@@ -33,6 +33,9 @@ nonisolated class VLESSVisionUDPMultiplexer: Multiplexer {
     // Write serialization (frames must not interleave)
     private var writeQueue: [(Data, (Error?) -> Void)] = []
     private var isWriting = false
+    /// Frames queued behind an in-flight write are packed into one write of up to this many
+    /// bytes (always at least one frame).
+    private static let maxBatchBytes = 64 * 1024
 
     private var frameParser = VLESSVisionUDPFrameParser()
 
@@ -242,14 +245,39 @@ nonisolated class VLESSVisionUDPMultiplexer: Multiplexer {
         guard !isWriting, !writeQueue.isEmpty, let connection = proxyConnection else { return }
 
         isWriting = true
-        let (data, completion) = writeQueue.removeFirst()
+        // XUDP frames are self-delimiting, so everything queued while the last write was
+        // in flight goes out back to back in one write.
+        var batchCount = 1
+        var batchBytes = writeQueue[0].0.count
+        while batchCount < writeQueue.count,
+              batchBytes + writeQueue[batchCount].0.count <= Self.maxBatchBytes {
+            batchBytes += writeQueue[batchCount].0.count
+            batchCount += 1
+        }
+        let data: Data
+        let completions: [(Error?) -> Void]
+        if batchCount == 1 {
+            let (frame, completion) = writeQueue.removeFirst()
+            data = frame
+            completions = [completion]
+        } else {
+            var packed = Data(capacity: batchBytes)
+            for (frame, _) in writeQueue[..<batchCount] {
+                packed.append(frame)
+            }
+            data = packed
+            completions = writeQueue[..<batchCount].map(\.1)
+            writeQueue.removeFirst(batchCount)
+        }
 
         connection.sendRaw(data: data) { [weak self] (error: Error?) in
             guard let self else { return }
             self.flowQueue.async { [weak self] in
                 guard let self else { return }
                 self.isWriting = false
-                completion(error)
+                for completion in completions {
+                    completion(error)
+                }
 
                 if let error {
                     self.close(error: error)
@@ -9,6 +9,9 @@ import Foundation
 
 /// Stream-XOR wrapper for VLESS encryption's `random` XOR mode. Per direction:
 /// skip N bytes → XOR the 5-byte record header → skip the decoded body → repeat.
+/// Each buffer is masked in place in one pass, with the keystream run only over
+/// header bytes; the per-direction locks serialize each CTR, so it is driven
+/// without its own lock.
 nonisolated final class VLESSXORConnection: ProxyConnection {
     private let inner: ProxyConnection
 
@@ -16,12 +19,8 @@ nonisolated final class VLESSXORConnection: ProxyConnection {
     /// Nil until `installInboundCTR`: 0-RTT derives the inbound key from the first 16 server bytes.
     private var inCTR: VLESSEncryptionCTR?
 
-    private var outSkip: Int
-    private var inSkip: Int
-
-    /// XOR'd header bytes accumulated across call boundaries; decoded at 5 bytes.
-    private var outHeader = Data()
-    private var inHeader = Data()
+    private var outMask: RecordHeaderMask
+    private var inMask: RecordHeaderMask
 
     /// Bytes past the inSkip region that arrived before `inCTR` was set; stashed
     /// verbatim and replayed through the state machine once it's installed.
@@ -38,8 +37,8 @@ nonisolated final class VLESSXORConnection: ProxyConnection {
         self.inner = inner
         self.outCTR = outCTR
         self.inCTR = inCTR
-        self.outSkip = outSkip
-        self.inSkip = inSkip
+        self.outMask = RecordHeaderMask(skip: outSkip)
+        self.inMask = RecordHeaderMask(skip: inSkip)
     }
 
     override var isConnected: Bool { inner.isConnected }
@@ -54,48 +53,19 @@ nonisolated final class VLESSXORConnection: ProxyConnection {
 
     override func sendRaw(data: Data, completion: @escaping (Error?) -> Void) {
         if data.isEmpty { completion(nil); return }
-        var bytes = [UInt8](data)
+        var masked = data
         sendLock.withLock {
-            applyOutboundMask(&bytes)
+            // A buffer wholly inside a sealed body goes out as it came, uncopied.
+            guard !outMask.skipAll(masked.count) else { return }
+            masked.withUnsafeMutableBytes { outMask.apply($0, ctr: outCTR, outbound: true) }
         }
-        inner.sendRaw(data: Data(bytes), completion: completion)
+        inner.sendRaw(data: masked, completion: completion)
     }
 
     override func sendRaw(data: Data) {
         sendRaw(data: data, completion: { _ in })
     }
 
-    /// XORs each TLS-record header in place, leaving sealed bodies and the skip region alone.
-    private func applyOutboundMask(_ bytes: inout [UInt8]) {
-        var offset = 0
-        while offset < bytes.count {
-            if outSkip > 0 {
-                let consume = min(outSkip, bytes.count - offset)
-                outSkip -= consume
-                offset += consume
-                continue
-            }
-            let needed = 5 - outHeader.count
-            let avail = bytes.count - offset
-            let chunk = min(needed, avail)
-            bytes.withUnsafeMutableBufferPointer { pointer in
-                let region = UnsafeMutableRawBufferPointer(
-                    rebasing: UnsafeMutableRawBufferPointer(pointer)[offset..<(offset + chunk)]
-                )
-                outCTR.processInPlace(region)
-            }
-            outHeader.append(contentsOf: bytes[offset..<(offset + chunk)])
-            offset += chunk
-            if outHeader.count == 5 {
-                let length = decodeHeaderLength(outHeader)
-                outHeader.removeAll(keepingCapacity: true)
-                outSkip = length
-            } else {
-                break
-            }
-        }
-    }
-
     // MARK: Receive
 
     override func receiveRaw(completion: @escaping (Data?, Error?) -> Void) {
@@ -128,44 +98,17 @@ nonisolated final class VLESSXORConnection: ProxyConnection {
         }
     }
 
-    /// Inbound counterpart of `applyOutboundMask`. Caller must hold `recvLock`;
-    /// while `inCTR` is nil, bytes past the skip region are stashed and truncated.
+    /// Unmasks `data` in place. Caller must hold `recvLock`; while `inCTR` is nil,
+    /// bytes past the skip region are stashed and truncated.
     private func applyInboundMaskLocked(_ data: inout Data) {
-        guard data.count > 0 else { return }
-        var bytes = [UInt8](data)
-        var offset = 0
-        while offset < bytes.count {
-            if inSkip > 0 {
-                let consume = min(inSkip, bytes.count - offset)
-                inSkip -= consume
-                offset += consume
-                continue
-            }
-            guard let inCTR else {
-                pendingPostSkip.append(contentsOf: bytes[offset..<bytes.count])
-                bytes.removeSubrange(offset..<bytes.count)
-                break
-            }
-            let needed = 5 - inHeader.count
-            let avail = bytes.count - offset
-            let chunk = min(needed, avail)
-            bytes.withUnsafeMutableBufferPointer { pointer in
-                let region = UnsafeMutableRawBufferPointer(
-                    rebasing: UnsafeMutableRawBufferPointer(pointer)[offset..<(offset + chunk)]
-                )
-                inCTR.processInPlace(region)
-            }
-            inHeader.append(contentsOf: bytes[offset..<(offset + chunk)])
-            offset += chunk
-            if inHeader.count == 5 {
-                let length = decodeHeaderLength(inHeader)
-                inHeader.removeAll(keepingCapacity: true)
-                inSkip = length
-            } else {
-                break
-            }
+        guard !data.isEmpty, !inMask.skipAll(data.count) else { return }
+        guard let inCTR else {
+            let kept = inMask.skipPrefix(data.count)
+            pendingPostSkip.append(data.dropFirst(kept))
+            data.removeSubrange((data.startIndex + kept)...)
+            return
         }
-        data = Data(bytes)
+        data.withUnsafeMutableBytes { inMask.apply($0, ctr: inCTR, outbound: false) }
     }
 
     // MARK: Cancel
@@ -173,17 +116,74 @@ nonisolated final class VLESSXORConnection: ProxyConnection {
     override func cancel() {
         inner.cancel()
     }
+}
 
-    // MARK: - Helpers
+// MARK: - RecordHeaderMask
 
-    /// Decodes bytes 3–4 of a TLS `application_data` header. Returns 0 on mismatch or
-    /// out-of-range length so a corrupted stream re-enters header mode.
-    private func decodeHeaderLength(_ header: Data) -> Int {
-        let base = header.startIndex
-        if header[base] != 23 || header[base + 1] != 3 || header[base + 2] != 3 {
-            return 0
+/// One direction's position in the skip → header → body cycle.
+nonisolated private struct RecordHeaderMask {
+    private var skip: Int
+    /// Plaintext header bytes seen so far, big-endian; a header may straddle buffers.
+    private var header: UInt64 = 0
+    private var headerCount = 0
+
+    init(skip: Int) {
+        self.skip = skip
+    }
+
+    /// Consumes `count` bytes when all of them fall in the skip region.
+    mutating func skipAll(_ count: Int) -> Bool {
+        guard skip >= count else { return false }
+        skip -= count
+        return true
+    }
+
+    /// Consumes up to `count` skip-region bytes and returns how many.
+    mutating func skipPrefix(_ count: Int) -> Int {
+        let consumed = min(skip, count)
+        skip -= consumed
+        return consumed
+    }
+
+    /// XORs every header run in `buffer` with `ctr`, one keystream call per run.
+    /// Outbound bytes are plaintext before the XOR, inbound ones after, and the
+    /// header length is always read from the plaintext.
+    mutating func apply(_ buffer: UnsafeMutableRawBufferPointer, ctr: VLESSEncryptionCTR, outbound: Bool) {
+        var offset = 0
+        while offset < buffer.count {
+            if skip > 0 {
+                let consumed = min(skip, buffer.count - offset)
+                skip -= consumed
+                offset += consumed
+                continue
+            }
+            let run = UnsafeMutableRawBufferPointer(
+                rebasing: buffer[offset..<min(offset + 5 - headerCount, buffer.count)]
+            )
+            if outbound { absorb(run) }
+            ctr.processInPlaceUnlocked(run)
+            if !outbound { absorb(run) }
+            offset += run.count
+            if headerCount == 5 {
+                skip = decodedLength()
+                header = 0
+                headerCount = 0
+            }
+        }
+    }
+
+    private mutating func absorb(_ bytes: UnsafeMutableRawBufferPointer) {
+        for byte in bytes {
+            header = header << 8 | UInt64(byte)
         }
-        let length = (Int(header[base + 3]) << 8) | Int(header[base + 4])
+        headerCount += bytes.count
+    }
+
+    /// Length from a TLS `application_data` header. 0 on mismatch or an
+    /// out-of-range length, so a corrupted stream re-enters header mode.
+    private func decodedLength() -> Int {
+        guard header >> 16 == 0x17_0303 else { return 0 }
+        let length = Int(header & 0xFFFF)
         if length < 17 || length > 16640 { return 0 }
         return length
     }
@@ -22,6 +22,15 @@ nonisolated class WebSocketConnection {
 
     private let configuration: WebSocketConfiguration
     private var receiveBuffer = Data()
+    /// Bytes at the front of `receiveBuffer` already parsed. The buffer is
+    /// dropped once fully parsed and compacted at most once per transport read,
+    /// rather than copied down after every frame.
+    private var receiveConsumed = 0
+    /// Payload bytes still owed by the data frame being streamed; 0 between frames.
+    private var streamRemaining: UInt64 = 0
+    private var streamMaskKey: UInt32?
+    /// Payload bytes of the current frame already unmasked, mod 4.
+    private var streamMaskPhase = 0
     private let lock = UnfairLock()
     private var _isConnected = false
     private var upgraded = false
@@ -46,7 +55,7 @@ nonisolated class WebSocketConnection {
         self._isConnected = true
     }
 
-    convenience init(transport: NWTCPTransport, configuration: WebSocketConfiguration) {
+    convenience init(transport: any TCPDialTransport, configuration: WebSocketConfiguration) {
         self.init(transport: TransportClosures(tcp: transport), configuration: configuration)
     }
 
@@ -181,6 +190,8 @@ nonisolated class WebSocketConnection {
         lock.withLock {
             _isConnected = false
             receiveBuffer.removeAll()
+            receiveConsumed = 0
+            streamRemaining = 0
             heartbeatTimer?.cancel()
             heartbeatTimer = nil
         }
@@ -227,39 +238,39 @@ nonisolated class WebSocketConnection {
 
     // MARK: - Frame Building (Client → Server, MUST be masked)
 
+    /// Builds a masked frame in one buffer sized exactly for header and payload.
     private func buildFrame(opcode: UInt8, payload: Data) -> Data {
-        var frame = Data()
-
-        // First byte: 0x80 sets FIN bit, low nibble is the opcode.
-        frame.append(0x80 | opcode)
-
-        // 0x80 on length byte sets the mask bit; client frames MUST be masked (RFC 6455 5.3).
         let length = payload.count
-        if length <= 125 {
-            frame.append(UInt8(length) | 0x80)
-        } else if length <= 65535 {
-            frame.append(126 | 0x80)
-            frame.append(UInt8((length >> 8) & 0xFF))
-            frame.append(UInt8(length & 0xFF))
-        } else {
-            frame.append(127 | 0x80)
-            for i in (0..<8).reversed() {
-                frame.append(UInt8((length >> (i * 8)) & 0xFF))
+        // 0x80 on length byte sets the mask bit; client frames MUST be masked (RFC 6455 5.3).
+        let extendedLengthSize = length <= 125 ? 0 : (length <= 65535 ? 2 : 8)
+        let headerSize = 2 + extendedLengthSize + 4
+        let maskKey = WebSocketMaskKeys.next()
+
+        var frame = Data(capacity: headerSize + length)
+        withUnsafeTemporaryAllocation(of: UInt8.self, capacity: 14) { header in
+            // First byte: 0x80 sets FIN bit, low nibble is the opcode.
+            header[0] = 0x80 | opcode
+            switch extendedLengthSize {
+            case 0:
+                header[1] = UInt8(length) | 0x80
+            case 2:
+                header[1] = 126 | 0x80
+                header[2] = UInt8((length >> 8) & 0xFF)
+                header[3] = UInt8(length & 0xFF)
+            default:
+                header[1] = 127 | 0x80
+                for i in 0..<8 {
+                    header[2 + i] = UInt8((length >> ((7 - i) * 8)) & 0xFF)
+                }
             }
+            UnsafeMutableRawPointer(header.baseAddress! + 2 + extendedLengthSize).storeBytes(of: maskKey, as: UInt32.self)
+            frame.append(header.baseAddress!, count: headerSize)
         }
 
-        var maskKey = [UInt8](repeating: 0, count: 4)
-        _ = SecRandomCopyBytes(kSecRandomDefault, 4, &maskKey)
-        frame.append(contentsOf: maskKey)
-
         // XOR-masked payload — append then mask in-place to avoid a temporary copy
-        let maskOffset = frame.count
         frame.append(payload)
         frame.withUnsafeMutableBytes { pointer in
-            guard let base = pointer.baseAddress?.assumingMemoryBound(to: UInt8.self) else { return }
-            for i in 0..<length {
-                base[maskOffset + i] ^= maskKey[i & 3]
-            }
+            WebSocketMaskKeys.apply(maskKey, to: UnsafeMutableRawBufferPointer(rebasing: pointer[headerSize...]))
         }
 
         return frame
@@ -274,26 +285,42 @@ nonisolated class WebSocketConnection {
         case close(UInt16, String)
     }
 
-    /// Tries to extract a complete frame from `receiveBuffer`. Must be called with `lock` held.
+    /// Tries to extract the next frame from `receiveBuffer`. Data frames are
+    /// streamed: their payload is delivered as `.binary` pieces as it arrives,
+    /// so a large frame is never buffered whole. Control frames (at most 125
+    /// bytes, RFC 6455 §5.5) are extracted whole. Must be called with `lock` held.
     private func tryExtractFrame() -> FrameResult? {
-        guard receiveBuffer.count >= 2 else { return nil }
+        if streamRemaining > 0 {
+            let available = receiveBuffer.count - receiveConsumed
+            guard available > 0 else { return nil }
+            let count = Int(min(UInt64(available), streamRemaining))
+            let start = receiveBuffer.startIndex + receiveConsumed
+            var payload = receiveBuffer.subdata(in: start..<start + count)
+            consumeReceived(count)
+            unmaskStreamed(&payload)
+            return .binary(payload)
+        }
 
-        let byte0 = receiveBuffer[receiveBuffer.startIndex]
-        let byte1 = receiveBuffer[receiveBuffer.startIndex + 1]
+        let available = receiveBuffer.count - receiveConsumed
+        guard available >= 2 else { return nil }
+        let frameStart = receiveBuffer.startIndex + receiveConsumed
+
+        let byte0 = receiveBuffer[frameStart]
+        let byte1 = receiveBuffer[frameStart + 1]
         let isMasked = (byte1 & 0x80) != 0
         var payloadLength = UInt64(byte1 & 0x7F)
         var headerSize = 2
 
         if payloadLength == 126 {
-            guard receiveBuffer.count >= 4 else { return nil }
-            payloadLength = UInt64(receiveBuffer[receiveBuffer.startIndex + 2]) << 8
-                          | UInt64(receiveBuffer[receiveBuffer.startIndex + 3])
+            guard available >= 4 else { return nil }
+            payloadLength = UInt64(receiveBuffer[frameStart + 2]) << 8
+                          | UInt64(receiveBuffer[frameStart + 3])
             headerSize = 4
         } else if payloadLength == 127 {
-            guard receiveBuffer.count >= 10 else { return nil }
+            guard available >= 10 else { return nil }
             payloadLength = 0
             for i in 0..<8 {
-                payloadLength = (payloadLength << 8) | UInt64(receiveBuffer[receiveBuffer.startIndex + 2 + i])
+                payloadLength = (payloadLength << 8) | UInt64(receiveBuffer[frameStart + 2 + i])
             }
             headerSize = 10
         }
@@ -301,41 +328,34 @@ nonisolated class WebSocketConnection {
         if isMasked {
             headerSize += 4
         }
+        guard available >= headerSize else { return nil }
 
-        let totalFrameSize = headerSize + Int(payloadLength)
-        guard receiveBuffer.count >= totalFrameSize else { return nil }
+        let maskKey: UInt32? = isMasked
+            ? receiveBuffer.withUnsafeBytes { $0.loadUnaligned(fromByteOffset: receiveConsumed + headerSize - 4, as: UInt32.self) }
+            : nil
 
-        var payload: Data
-        if isMasked {
-            let maskStart = headerSize - 4
-            let maskKey = [
-                receiveBuffer[receiveBuffer.startIndex + maskStart],
-                receiveBuffer[receiveBuffer.startIndex + maskStart + 1],
-                receiveBuffer[receiveBuffer.startIndex + maskStart + 2],
-                receiveBuffer[receiveBuffer.startIndex + maskStart + 3]
-            ]
-            let payloadStart = receiveBuffer.startIndex + headerSize
-            var bytes = [UInt8](repeating: 0, count: Int(payloadLength))
-            for i in 0..<Int(payloadLength) {
-                bytes[i] = receiveBuffer[payloadStart + i] ^ maskKey[i & 3]
-            }
-            payload = Data(bytes)
-        } else {
-            let payloadStart = receiveBuffer.startIndex + headerSize
-            payload = receiveBuffer.subdata(in: payloadStart..<payloadStart + Int(payloadLength))
+        let opcode = byte0 & 0x0F
+        guard opcode & 0x08 != 0 else {
+            // Data frame: consume the header and stream whatever payload is here.
+            consumeReceived(headerSize)
+            guard payloadLength > 0 else { return .binary(Data()) }
+            streamRemaining = payloadLength
+            streamMaskKey = maskKey
+            streamMaskPhase = 0
+            return tryExtractFrame()
         }
 
-        // Copying the remainder into a new Data releases the original backing store.
-        if totalFrameSize >= receiveBuffer.count {
-            receiveBuffer = Data()
-        } else {
-            receiveBuffer = Data(receiveBuffer.suffix(from: receiveBuffer.startIndex + totalFrameSize))
+        let totalFrameSize = headerSize + Int(payloadLength)
+        guard available >= totalFrameSize else { return nil }
+
+        let payloadStart = frameStart + headerSize
+        var payload = receiveBuffer.subdata(in: payloadStart..<payloadStart + Int(payloadLength))
+        if let maskKey {
+            payload.withUnsafeMutableBytes { WebSocketMaskKeys.apply(maskKey, to: $0) }
         }
+        consumeReceived(totalFrameSize)
 
-        let opcode = byte0 & 0x0F
         switch opcode {
-        case 0x01, 0x02: // Text or Binary
-            return .binary(payload)
         case 0x08: // Close
             var code: UInt16 = 1005 // No status code
             var reason = ""
@@ -350,11 +370,31 @@ nonisolated class WebSocketConnection {
             return .ping(payload)
         case 0x0A: // Pong
             return .pong(payload)
-        default:
-            return .binary(payload)
+        default: // Reserved control opcode; dropped like a pong
+            return .pong(payload)
+        }
+    }
+
+    /// Marks `count` bytes parsed, releasing the buffer once all of it is.
+    private func consumeReceived(_ count: Int) {
+        receiveConsumed += count
+        if receiveConsumed >= receiveBuffer.count {
+            receiveBuffer = Data()
+            receiveConsumed = 0
         }
     }
 
+    /// Unmasks the next piece of a streamed payload and advances the stream.
+    private func unmaskStreamed(_ payload: inout Data) {
+        streamRemaining -= UInt64(payload.count)
+        guard let key = streamMaskKey else { return }
+        // Rotate so the key's first byte lines up with this piece's first byte.
+        let shift = UInt32(streamMaskPhase * 8)
+        let phased = shift == 0 ? key : (key >> shift) | (key << (32 - shift))
+        payload.withUnsafeMutableBytes { WebSocketMaskKeys.apply(phased, to: $0) }
+        streamMaskPhase = (streamMaskPhase + payload.count) & 3
+    }
+
     /// Handles a parsed frame result, auto-responding to pings and propagating close.
     private func handleFrameResult(_ result: FrameResult, completion: @escaping (Data?, Error?) -> Void) {
         switch result {
@@ -409,10 +449,27 @@ nonisolated class WebSocketConnection {
             }
 
             let status: ExtractResult = self.lock.withLock {
+                // Mid-frame with nothing buffered: the read's leading payload
+                // bytes are handed on as a slice of it, never copied in.
+                if self.streamRemaining > 0, self.receiveBuffer.isEmpty {
+                    let count = Int(min(UInt64(data.count), self.streamRemaining))
+                    var payload = data.prefix(count)
+                    if count < data.count {
+                        self.receiveBuffer = Data(data.suffix(from: data.startIndex + count))
+                    }
+                    self.unmaskStreamed(&payload)
+                    return .frame(.binary(payload))
+                }
+
+                if self.receiveConsumed > 0, self.receiveConsumed >= self.receiveBuffer.count / 2 {
+                    self.receiveBuffer = Data(self.receiveBuffer.suffix(from: self.receiveBuffer.startIndex + self.receiveConsumed))
+                    self.receiveConsumed = 0
+                }
                 self.receiveBuffer.append(data)
 
-                if self.receiveBuffer.count > Self.maxReceiveBufferSize {
+                if self.receiveBuffer.count - self.receiveConsumed > Self.maxReceiveBufferSize {
                     self.receiveBuffer.removeAll()
+                    self.receiveConsumed = 0
                     return .overflow
                 }
 
@@ -434,3 +491,60 @@ nonisolated class WebSocketConnection {
     }
 
 }
+
+// MARK: - Masking
+
+/// Client mask keys and the masking XOR. Keys come from a shared buffer of
+/// CSPRNG output refilled 64 keys at a time, so a frame costs one short lock
+/// rather than a `SecRandomCopyBytes` call.
+nonisolated enum WebSocketMaskKeys {
+
+    private static let lock = UnfairLock()
+    private static let keysPerRefill = 64
+    nonisolated(unsafe) private static var pool = [UInt32](repeating: 0, count: keysPerRefill)
+    nonisolated(unsafe) private static var remaining = 0
+
+    /// The next key, in the byte order it goes on the wire.
+    static func next() -> UInt32 {
+        lock.withLock {
+            if remaining == 0 {
+                _ = pool.withUnsafeMutableBytes { SecRandomCopyBytes(kSecRandomDefault, $0.count, $0.baseAddress!) }
+                remaining = keysPerRefill
+            }
+            remaining -= 1
+            return pool[remaining]
+        }
+    }
+
+    /// XORs `bytes` with `key` repeated, 32 bytes per step. `key` is in
+    /// memory (wire) order, as is every 4-byte lane of the widened mask.
+    static func apply(_ key: UInt32, to bytes: UnsafeMutableRawBufferPointer) {
+        guard let base = bytes.baseAddress else { return }
+        let count = bytes.count
+        var offset = 0
+
+        let wide = SIMD8<UInt32>(repeating: key)
+        let mask32 = unsafeBitCast(wide, to: SIMD32<UInt8>.self)
+        while count - offset >= 32 {
+            let chunk = (base + offset).loadUnaligned(as: SIMD32<UInt8>.self)
+            (base + offset).storeBytes(of: chunk ^ mask32, as: SIMD32<UInt8>.self)
+            offset += 32
+        }
+
+        let mask8 = UInt64(key) | UInt64(key) << 32
+        while count - offset >= 8 {
+            let word = (base + offset).loadUnaligned(as: UInt64.self)
+            (base + offset).storeBytes(of: word ^ mask8, as: UInt64.self)
+            offset += 8
+        }
+
+        // Offsets so far are multiples of 8, so the tail phase is `offset & 3`.
+        withUnsafeBytes(of: key) { keyBytes in
+            while offset < count {
+                base.storeBytes(of: base.load(fromByteOffset: offset, as: UInt8.self) ^ keyBytes[offset & 3],
+                                toByteOffset: offset, as: UInt8.self)
+                offset += 1
+            }
+        }
+    }
+}
@@ -148,6 +148,9 @@ struct XHTTPConfiguration: Codable, Equatable, Hashable {
     let noGRPCHeader: Bool
     let scMaxEachPostBytes: Int
     let scMinPostsIntervalMs: Int
+    /// Upper bound on packet-up POSTs in flight over a multiplexed (H2/H3) transport;
+    /// the live window adapts below it.
+    let scMaxConcurrentPosts: Int
 
     // X-Padding settings (from extra)
     let xPaddingBytesFrom: Int
@@ -199,6 +202,7 @@ struct XHTTPConfiguration: Codable, Equatable, Hashable {
         noGRPCHeader: Bool = false,
         scMaxEachPostBytes: Int = 1_000_000,
         scMinPostsIntervalMs: Int = 30,
+        scMaxConcurrentPosts: Int = 8,
         xPaddingBytesFrom: Int = 100,
         xPaddingBytesTo: Int = 1000,
         xPaddingObfsMode: Bool = false,
@@ -227,6 +231,7 @@ struct XHTTPConfiguration: Codable, Equatable, Hashable {
         self.noGRPCHeader = noGRPCHeader
         self.scMaxEachPostBytes = scMaxEachPostBytes
         self.scMinPostsIntervalMs = scMinPostsIntervalMs
+        self.scMaxConcurrentPosts = scMaxConcurrentPosts
         self.xPaddingBytesFrom = xPaddingBytesFrom
         self.xPaddingBytesTo = xPaddingBytesTo
         self.xPaddingObfsMode = xPaddingObfsMode
@@ -258,6 +263,7 @@ struct XHTTPConfiguration: Codable, Equatable, Hashable {
         noGRPCHeader = try c.decode(Bool.self, forKey: .noGRPCHeader)
         scMaxEachPostBytes = try c.decode(Int.self, forKey: .scMaxEachPostBytes)
         scMinPostsIntervalMs = try c.decode(Int.self, forKey: .scMinPostsIntervalMs)
+        scMaxConcurrentPosts = try c.decodeIfPresent(Int.self, forKey: .scMaxConcurrentPosts) ?? 8
         xPaddingBytesFrom = try c.decodeIfPresent(Int.self, forKey: .xPaddingBytesFrom) ?? 100
         xPaddingBytesTo = try c.decodeIfPresent(Int.self, forKey: .xPaddingBytesTo) ?? 1000
         xPaddingObfsMode = try c.decodeIfPresent(Bool.self, forKey: .xPaddingObfsMode) ?? false
@@ -375,6 +381,13 @@ struct XHTTPConfiguration: Codable, Equatable, Hashable {
         }
     }
 
+    /// ``generatePadding()`` as bytes; `repeatX` skips the String round trip.
+    func generatePaddingBytes() -> [UInt8] {
+        guard xPaddingMethod == .repeatX else { return Array(generatePadding().utf8) }
+        let length = Int.random(in: xPaddingBytesFrom...max(xPaddingBytesFrom, xPaddingBytesTo))
+        return [UInt8](repeating: UInt8(ascii: "X"), count: length)
+    }
+
     /// Generates base62 "tokenish" padding whose *Huffman-encoded* length is within ±2 bytes of `targetBytes`.
     private func generateTokenishPadding(targetBytes: Int) -> String {
         let charset = Array("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz")
@@ -525,6 +538,14 @@ struct XHTTPConfiguration: Codable, Equatable, Hashable {
             scMinPostsIntervalMs = value
         }
 
+        // scMaxConcurrentPosts likewise.
+        var scMaxConcurrentPosts = 8
+        if let range = extra["scMaxConcurrentPosts"] as? [String: Any] {
+            scMaxConcurrentPosts = range["to"] as? Int ?? 8
+        } else if let value = extra["scMaxConcurrentPosts"] as? Int {
+            scMaxConcurrentPosts = value
+        }
+
         // xPaddingBytes may be an int, {"from":a,"to":b}, or an "a-b" string (the form used in
         // subscription URLs). The server validates each request's padding length against this
         // range, so an unparsed "a-b" silently falling back to the default makes a fraction of
@@ -589,6 +610,7 @@ struct XHTTPConfiguration: Codable, Equatable, Hashable {
             noGRPCHeader: noGRPCHeader,
             scMaxEachPostBytes: scMaxEachPostBytes,
             scMinPostsIntervalMs: scMinPostsIntervalMs,
+            scMaxConcurrentPosts: scMaxConcurrentPosts,
             xPaddingBytesFrom: xPaddingFrom,
             xPaddingBytesTo: xPaddingTo,
             xPaddingObfsMode: xPaddingObfsMode,
@@ -623,6 +645,7 @@ extension XHTTPConfiguration {
         if noGRPCHeader { dictionary["noGRPCHeader"] = true }
         if scMaxEachPostBytes != 1_000_000 { dictionary["scMaxEachPostBytes"] = scMaxEachPostBytes }
         if scMinPostsIntervalMs != 30 { dictionary["scMinPostsIntervalMs"] = scMinPostsIntervalMs }
+        if scMaxConcurrentPosts != 8 { dictionary["scMaxConcurrentPosts"] = scMaxConcurrentPosts }
         if xPaddingBytesFrom != 100 || xPaddingBytesTo != 1000 {
             dictionary["xPaddingBytes"] = ["from": xPaddingBytesFrom, "to": xPaddingBytesTo]
         }
@@ -31,7 +31,7 @@ extension XHTTPConnection {
     static let h2SettingsEnablePush: UInt16 = 0x02
     static let h2SettingsInitialWindowSize: UInt16 = 0x04
 
-    static let h2StreamWindowSize: UInt32 = 4_194_304  // 4MB
+    static let h2StreamWindowSize = UInt32(TuningProfile.current.h2StreamWindowSize)
     static let h2ConnectionWindowSize: UInt32 = 1_073_741_824  // 1GB
 
     // MARK: HTTP/2 Frame I/O
@@ -40,33 +40,7 @@ extension XHTTPConnection {
         H2Framing.frame(type: type, flags: flags, streamId: streamId, payload: payload)
     }
 
-    // MARK: HTTP/2 HPACK Encoder (simplified, no Huffman)
-
-    /// Encodes an integer with the given prefix bit width (RFC 7541 §5.1).
-    static func hpackEncodeInteger(_ value: Int, prefixBits: Int) -> [UInt8] {
-        let maxPrefix = (1 << prefixBits) - 1
-        if value < maxPrefix {
-            return [UInt8(value)]
-        }
-        var bytes: [UInt8] = [UInt8(maxPrefix)]
-        var remaining = value - maxPrefix
-        while remaining >= 128 {
-            bytes.append(UInt8(remaining & 0x7F) | 0x80)
-            remaining >>= 7
-        }
-        bytes.append(UInt8(remaining))
-        return bytes
-    }
-
-    /// Encodes a plain (non-Huffman) string (RFC 7541 §5.2).
-    static func hpackEncodeString(_ string: String) -> [UInt8] {
-        let bytes = Array(string.utf8)
-        // H=0 (no Huffman), length with 7-bit prefix
-        var result = hpackEncodeInteger(bytes.count, prefixBits: 7)
-        result[0] &= 0x7F
-        result.append(contentsOf: bytes)
-        return result
-    }
+    // MARK: HTTP/2 Request Headers (HPACKEncoder, no Huffman)
 
     /// Encodes a request header block for HTTP/2 HEADERS; `includeMeta` adds the session ID per placement.
     func encodeH2RequestHeaders(method: String = "POST", includeMeta: Bool = false) -> Data {
@@ -74,11 +48,8 @@ extension XHTTPConnection {
 
         // Pseudo-header order: :authority, :method, :path, :scheme
 
-        // :authority — literal without indexing, name index 1
-        var authBytes = Self.hpackEncodeInteger(1, prefixBits: 6)
-        authBytes[0] |= 0x40
-        block.append(contentsOf: authBytes)
-        block.append(contentsOf: Self.hpackEncodeString(configuration.host))
+        // :authority — literal with incremental indexing, name index 1
+        HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 1, value: configuration.host, into: &block)
 
         if method == "GET" {
             block.append(0x82) // GET = index 2
@@ -108,10 +79,7 @@ extension XHTTPConnection {
         if path == "/" {
             block.append(0x84) // Indexed: :path / (index 4)
         } else {
-            var pathBytes = Self.hpackEncodeInteger(4, prefixBits: 6)
-            pathBytes[0] |= 0x40
-            block.append(contentsOf: pathBytes)
-            block.append(contentsOf: Self.hpackEncodeString(path))
+            HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 4, value: path, into: &block)
         }
 
         // :scheme https — static table index 7
@@ -119,24 +87,16 @@ extension XHTTPConnection {
 
         if method != "GET" && !configuration.noGRPCHeader {
             // content-type name index 31
-            var ctBytes = Self.hpackEncodeInteger(31, prefixBits: 6)
-            ctBytes[0] |= 0x40
-            block.append(contentsOf: ctBytes)
-            block.append(contentsOf: Self.hpackEncodeString("application/grpc"))
+            HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 31, value: "application/grpc", into: &block)
         }
 
         // Session metadata — non-path placements
         if includeMeta && !sessionId.isEmpty {
             switch configuration.sessionPlacement {
             case .header:
-                block.append(0x40)
-                block.append(contentsOf: Self.hpackEncodeString(configuration.normalizedSessionKey.lowercased()))
-                block.append(contentsOf: Self.hpackEncodeString(sessionId))
+                HPACKEncoder.encodeLiteralWithIndexing(name: configuration.normalizedSessionKey, value: sessionId, into: &block)
             case .cookie:
-                var cookieBytes = Self.hpackEncodeInteger(32, prefixBits: 6)
-                cookieBytes[0] |= 0x40
-                block.append(contentsOf: cookieBytes)
-                block.append(contentsOf: Self.hpackEncodeString("\(configuration.normalizedSessionKey)=\(sessionId)"))
+                HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 32, value: "\(configuration.normalizedSessionKey)=\(sessionId)", into: &block)
             default:
                 break // path and query handled above
             }
@@ -154,11 +114,8 @@ extension XHTTPConnection {
 
         // Pseudo-header order: :authority, :method, :path, :scheme
 
-        // :authority — literal without indexing, name index 1
-        var authBytes = Self.hpackEncodeInteger(1, prefixBits: 6)
-        authBytes[0] |= 0x40
-        block.append(contentsOf: authBytes)
-        block.append(contentsOf: Self.hpackEncodeString(configuration.host))
+        // :authority — literal with incremental indexing, name index 1
+        HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 1, value: configuration.host, into: &block)
 
         let method = configuration.uplinkHTTPMethod
         if method == "POST" {
@@ -166,10 +123,7 @@ extension XHTTPConnection {
         } else if method == "GET" {
             block.append(0x82) // GET = index 2
         } else {
-            var methodBytes = Self.hpackEncodeInteger(2, prefixBits: 6)
-            methodBytes[0] |= 0x40
-            block.append(contentsOf: methodBytes)
-            block.append(contentsOf: Self.hpackEncodeString(method))
+            HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 2, value: method, into: &block)
         }
 
         var path = configuration.normalizedPath
@@ -194,41 +148,27 @@ extension XHTTPConnection {
             path += "?" + queryParts.joined(separator: "&")
         }
 
-        var pathBytes = Self.hpackEncodeInteger(4, prefixBits: 6)
-        pathBytes[0] |= 0x40
-        block.append(contentsOf: pathBytes)
-        block.append(contentsOf: Self.hpackEncodeString(path))
+        HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 4, value: path, into: &block)
 
         // :scheme https — static table index 7
         block.append(0x87)
 
         // packet-up omits Content-Type; only stream-up sends application/grpc.
         if seq == nil, !configuration.noGRPCHeader {
-            var ctBytes = Self.hpackEncodeInteger(31, prefixBits: 6)
-            ctBytes[0] |= 0x40
-            block.append(contentsOf: ctBytes)
-            block.append(contentsOf: Self.hpackEncodeString("application/grpc"))
+            HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 31, value: "application/grpc", into: &block)
         }
 
         if let contentLength {
-            var clBytes = Self.hpackEncodeInteger(28, prefixBits: 6)
-            clBytes[0] |= 0x40
-            block.append(contentsOf: clBytes)
-            block.append(contentsOf: Self.hpackEncodeString("\(contentLength)"))
+            HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 28, value: "\(contentLength)", into: &block)
         }
 
         // Session metadata — non-path placements
         if !sessionId.isEmpty {
             switch configuration.sessionPlacement {
             case .header:
-                block.append(0x40)
-                block.append(contentsOf: Self.hpackEncodeString(configuration.normalizedSessionKey.lowercased()))
-                block.append(contentsOf: Self.hpackEncodeString(sessionId))
+                HPACKEncoder.encodeLiteralWithIndexing(name: configuration.normalizedSessionKey, value: sessionId, into: &block)
             case .cookie:
-                var cookieBytes = Self.hpackEncodeInteger(32, prefixBits: 6)
-                cookieBytes[0] |= 0x40
-                block.append(contentsOf: cookieBytes)
-                block.append(contentsOf: Self.hpackEncodeString("\(configuration.normalizedSessionKey)=\(sessionId)"))
+                HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 32, value: "\(configuration.normalizedSessionKey)=\(sessionId)", into: &block)
             default:
                 break
             }
@@ -238,14 +178,9 @@ extension XHTTPConnection {
         if let seq {
             switch configuration.seqPlacement {
             case .header:
-                block.append(0x40)
-                block.append(contentsOf: Self.hpackEncodeString(configuration.normalizedSeqKey.lowercased()))
-                block.append(contentsOf: Self.hpackEncodeString("\(seq)"))
+                HPACKEncoder.encodeLiteralWithIndexing(name: configuration.normalizedSeqKey, value: "\(seq)", into: &block)
             case .cookie:
-                var cookieBytes = Self.hpackEncodeInteger(32, prefixBits: 6)
-                cookieBytes[0] |= 0x40
-                block.append(contentsOf: cookieBytes)
-                block.append(contentsOf: Self.hpackEncodeString("\(configuration.normalizedSeqKey)=\(seq)"))
+                HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 32, value: "\(configuration.normalizedSeqKey)=\(seq)", into: &block)
             default:
                 break
             }
@@ -256,13 +191,10 @@ extension XHTTPConnection {
         for field in uplinkData {
             switch field {
             case .header(let name, let value):
-                block.append(0x00) // literal header field without indexing, new name
-                block.append(contentsOf: Self.hpackEncodeString(name.lowercased()))
-                block.append(contentsOf: Self.hpackEncodeString(value))
+                HPACKEncoder.encodeLiteralWithoutIndexing(name: name, value: value, into: &block)
             case .cookie(let pair):
-                // cookie (static index 32) without indexing → 4-bit prefix, high nibble 0.
-                block.append(contentsOf: Self.hpackEncodeInteger(32, prefixBits: 4))
-                block.append(contentsOf: Self.hpackEncodeString(pair))
+                // cookie is static index 32.
+                HPACKEncoder.encodeLiteralWithoutIndexing(nameIndex: 32, value: pair, into: &block)
             }
         }
 
@@ -275,35 +207,22 @@ extension XHTTPConnection {
     private func appendH2CommonHeaders(to block: inout Data, path: String) {
         // user-agent — name index 58 (RFC 7541 Appendix A)
         let ua = configuration.headers["User-Agent"] ?? ProxyUserAgent.default
-        var uaBytes = Self.hpackEncodeInteger(58, prefixBits: 6)
-        uaBytes[0] |= 0x40
-        block.append(contentsOf: uaBytes)
-        block.append(contentsOf: Self.hpackEncodeString(ua))
+        HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 58, value: ua, into: &block)
 
         let padding = configuration.generatePadding()
         let paddingPath = configuration.normalizedPath
         if !configuration.xPaddingObfsMode {
             let referer = "https://\(configuration.host)\(paddingPath)?x_padding=\(padding)"
-            var refBytes = Self.hpackEncodeInteger(51, prefixBits: 6)
-            refBytes[0] |= 0x40
-            block.append(contentsOf: refBytes)
-            block.append(contentsOf: Self.hpackEncodeString(referer))
+            HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 51, value: referer, into: &block)
         } else {
             switch configuration.xPaddingPlacement {
             case .header:
-                block.append(0x40)
-                block.append(contentsOf: Self.hpackEncodeString(configuration.xPaddingHeader.lowercased()))
-                block.append(contentsOf: Self.hpackEncodeString(padding))
+                HPACKEncoder.encodeLiteralWithIndexing(name: configuration.xPaddingHeader, value: padding, into: &block)
             case .queryInHeader:
                 let headerValue = "https://\(configuration.host)\(paddingPath)?\(configuration.xPaddingKey)=\(padding)"
-                block.append(0x40)
-                block.append(contentsOf: Self.hpackEncodeString(configuration.xPaddingHeader.lowercased()))
-                block.append(contentsOf: Self.hpackEncodeString(headerValue))
+                HPACKEncoder.encodeLiteralWithIndexing(name: configuration.xPaddingHeader, value: headerValue, into: &block)
             case .cookie:
-                var cookieBytes = Self.hpackEncodeInteger(32, prefixBits: 6)
-                cookieBytes[0] |= 0x40
-                block.append(contentsOf: cookieBytes)
-                block.append(contentsOf: Self.hpackEncodeString("\(configuration.xPaddingKey)=\(padding)"))
+                HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 32, value: "\(configuration.xPaddingKey)=\(padding)", into: &block)
             default:
                 break
             }
@@ -318,9 +237,7 @@ extension XHTTPConnection {
         for (key, value) in configuration.headers {
             let lk = key.lowercased()
             if h2ForbiddenHeaders.contains(lk) { continue }
-            block.append(0x40)
-            block.append(contentsOf: Self.hpackEncodeString(lk))
-            block.append(contentsOf: Self.hpackEncodeString(value))
+            HPACKEncoder.encodeLiteralWithIndexing(name: lk, value: value, into: &block)
         }
     }
 
@@ -392,7 +309,7 @@ extension XHTTPConnection {
             return status == "200" ? nil : "status \(status)"
         }
 
-        let status = Self.huffmanDecodeDigits(valueData)
+        let status = HPACKHuffman.decode(valueData).flatMap { String(bytes: $0, encoding: .ascii) } ?? ""
         if status.isEmpty {
             let hex = valueData.map { String(format: "%02x", $0) }.joined(separator: " ")
             return "status (huffman: \(hex))"
@@ -400,39 +317,6 @@ extension XHTTPConnection {
         return status == "200" ? nil : "status \(status)"
     }
 
-    /// Huffman-decodes a byte sequence containing only ASCII digits (RFC 7541 Appendix B).
-    private static func huffmanDecodeDigits(_ data: Data) -> String {
-        var result = ""
-        var bits: UInt32 = 0
-        var numBits = 0
-
-        for byte in data {
-            bits = (bits << 8) | UInt32(byte)
-            numBits += 8
-        }
-
-        while numBits >= 5 {
-            let top5 = Int((bits >> (numBits - 5)) & 0x1F)
-            // 5-bit codes: '0'=0x00, '1'=0x01, '2'=0x02
-            if top5 <= 0x02 {
-                result.append(Character(UnicodeScalar(48 + top5)!))
-                numBits -= 5
-                continue
-            }
-            // 6-bit codes: '3'=0x19...'9'=0x1f
-            guard numBits >= 6 else { break }
-            let top6 = Int((bits >> (numBits - 6)) & 0x3F)
-            if top6 >= 0x19 && top6 <= 0x1F {
-                let digit = top6 - 0x19 + 3 // '3'..'9'
-                result.append(Character(UnicodeScalar(48 + digit)!))
-                numBits -= 6
-                continue
-            }
-            break // Unknown code or EOS padding
-        }
-        return result
-    }
-
     // MARK: HTTP/2 Settings
 
     /// Parses server SETTINGS payload to extract initial window size and max frame size.
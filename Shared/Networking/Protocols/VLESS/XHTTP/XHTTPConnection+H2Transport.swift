@@ -214,7 +214,8 @@ extension XHTTPConnection {
             return
         }
 
-        var frames = Data()
+        // Frames reference `data` by slice; the bytes are gathered once, at the transport.
+        var frames = ByteChain()
         var currentOffset = offset
         var windowRemaining = window
 
@@ -223,8 +224,8 @@ extension XHTTPConnection {
             let chunkSize = min(remaining, min(maxSize, windowRemaining))
             guard chunkSize > 0 else { break }
 
-            let chunk = Data(data[data.startIndex + currentOffset ..< data.startIndex + currentOffset + chunkSize])
-            frames.append(buildH2Frame(type: Self.h2FrameData, flags: 0, streamId: streamId, payload: chunk))
+            let chunk = ByteChain(data[data.startIndex + currentOffset ..< data.startIndex + currentOffset + chunkSize])
+            H2Framing.appendFrame(type: Self.h2FrameData, flags: 0, streamId: streamId, payload: chunk, to: &frames)
             currentOffset += chunkSize
             windowRemaining -= chunkSize
         }
@@ -235,7 +236,7 @@ extension XHTTPConnection {
         lock.unlock()
 
         let nextOffset = currentOffset
-        downloadSend(frames) { [weak self] error in
+        downloadSendChain(frames) { [weak self] error in
             if let error {
                 self?.markH2Closed()
                 completion(error)
@@ -270,17 +271,17 @@ extension XHTTPConnection {
         let dataFields = uplinkDataFields(for: data)
         let bodyInHeaders = !dataFields.isEmpty
         let bodyLength = bodyInHeaders ? 0 : data.count
-        let headerBlock = encodeH2UploadHeaders(seq: seq, contentLength: bodyLength, uplinkData: dataFields)
+        let headerBlock = packetUpTemplate(.hpack).render(seq: seq, contentLength: bodyLength, uplinkData: dataFields)
         let sendsBody = !bodyInHeaders && !data.isEmpty
         let headerFlags: UInt8 = sendsBody
             ? Self.h2FlagEndHeaders
             : (Self.h2FlagEndHeaders | Self.h2FlagEndStream)
-        var outbound = buildH2Frame(type: Self.h2FrameHeaders, flags: headerFlags, streamId: streamId, payload: headerBlock)
+        var outbound = ByteChain(buildH2Frame(type: Self.h2FrameHeaders, flags: headerFlags, streamId: streamId, payload: headerBlock))
 
         guard sendsBody else {
             lock.unlock()
             // Rate limiting between POSTs is handled upstream by flushPacketUpBatch.
-            downloadSend(outbound) { [weak self] error in
+            downloadSendChain(outbound) { [weak self] error in
                 if error != nil {
                     self?.markH2Closed()
                 }
@@ -300,8 +301,8 @@ extension XHTTPConnection {
 
             let isLast = (currentOffset + chunkSize) >= data.count
             let flags: UInt8 = isLast ? Self.h2FlagEndStream : 0
-            let chunk = Data(data[data.startIndex + currentOffset ..< data.startIndex + currentOffset + chunkSize])
-            outbound.append(buildH2Frame(type: Self.h2FrameData, flags: flags, streamId: streamId, payload: chunk))
+            let chunk = ByteChain(data[data.startIndex + currentOffset ..< data.startIndex + currentOffset + chunkSize])
+            H2Framing.appendFrame(type: Self.h2FrameData, flags: flags, streamId: streamId, payload: chunk, to: &outbound)
             currentOffset += chunkSize
             windowRemaining -= chunkSize
         }
@@ -313,7 +314,7 @@ extension XHTTPConnection {
         lock.unlock()
 
         let nextOffset = currentOffset
-        downloadSend(outbound) { [weak self] error in
+        downloadSendChain(outbound) { [weak self] error in
             if let error {
                 self?.markH2Closed()
                 completion(error)
@@ -359,7 +360,7 @@ extension XHTTPConnection {
             return
         }
 
-        var frames = Data()
+        var frames = ByteChain()
         var currentOffset = offset
         var windowRemaining = window
 
@@ -370,8 +371,8 @@ extension XHTTPConnection {
 
             let isLast = (currentOffset + chunkSize) >= data.count
             let flags: UInt8 = isLast ? Self.h2FlagEndStream : 0
-            let chunk = Data(data[data.startIndex + currentOffset ..< data.startIndex + currentOffset + chunkSize])
-            frames.append(buildH2Frame(type: Self.h2FrameData, flags: flags, streamId: streamId, payload: chunk))
+            let chunk = ByteChain(data[data.startIndex + currentOffset ..< data.startIndex + currentOffset + chunkSize])
+            H2Framing.appendFrame(type: Self.h2FrameData, flags: flags, streamId: streamId, payload: chunk, to: &frames)
             currentOffset += chunkSize
             windowRemaining -= chunkSize
         }
@@ -382,7 +383,7 @@ extension XHTTPConnection {
         lock.unlock()
 
         let nextOffset = currentOffset
-        downloadSend(frames) { [weak self] error in
+        downloadSendChain(frames) { [weak self] error in
             if let error {
                 self?.markH2Closed()
                 completion(error)
@@ -453,9 +454,13 @@ extension XHTTPConnection {
                         let threshold = windowSize / 2
                         if connConsumed >= threshold { self.h2ConnectionReceiveConsumed = 0 }
                         if streamConsumed >= threshold { self.h2StreamReceiveConsumed = 0 }
+                        let sendProbe = isDownloadStream && self.h2WindowTuner.noteReceived(frame.payload.count)
                         self.lock.unlock()
 
                         var updates = Data()
+                        if sendProbe {
+                            updates.append(self.buildH2Frame(type: Self.h2FramePing, flags: 0, streamId: 0, payload: H2WindowTuner.pingPayload))
+                        }
                         if connConsumed >= threshold {
                             let increment = UInt32(connConsumed)
                             var windowUpdatePayload = Data(count: 4)
@@ -547,8 +552,12 @@ extension XHTTPConnection {
                     self.receiveH2Data(completion: completion)
 
                 case Self.h2FramePing:
-                    let pong = self.buildH2Frame(type: Self.h2FramePing, flags: Self.h2FlagAck, streamId: 0, payload: frame.payload)
-                    self.downloadSend(pong) { _ in }
+                    if frame.flags & Self.h2FlagAck == 0 {
+                        let pong = self.buildH2Frame(type: Self.h2FramePing, flags: Self.h2FlagAck, streamId: 0, payload: frame.payload)
+                        self.downloadSend(pong) { _ in }
+                    } else if frame.payload == H2WindowTuner.pingPayload {
+                        self.growDownloadWindowIfNeeded()
+                    }
                     self.receiveH2Data(completion: completion)
 
                 case Self.h2FrameGoaway:
@@ -575,6 +584,26 @@ extension XHTTPConnection {
         }
     }
 
+    /// Applies a grown BDP estimate to the download stream: the WINDOW_UPDATE hands the peer
+    /// the extra credit at once, and the larger `h2LocalWindowSize` keeps later updates
+    /// batched at half the new window.
+    private func growDownloadWindowIfNeeded() {
+        lock.lock()
+        guard !h2StreamClosed, let grown = h2WindowTuner.pingAcknowledged() else {
+            lock.unlock()
+            return
+        }
+        let increment = UInt32(grown - h2LocalWindowSize)
+        h2LocalWindowSize = grown
+        let streamId = h2DownloadStreamId
+        lock.unlock()
+
+        var payload = Data(count: 4)
+        payload[0] = UInt8((increment >> 24) & 0xFF); payload[1] = UInt8((increment >> 16) & 0xFF)
+        payload[2] = UInt8((increment >> 8) & 0xFF); payload[3] = UInt8(increment & 0xFF)
+        downloadSend(buildH2Frame(type: Self.h2FrameWindowUpdate, flags: 0, streamId: streamId, payload: payload)) { _ in }
+    }
+
     // MARK: Shared-H2 (xmux) session setup & send
 
     /// Setup over a shared multiplexing H2 connection; mirrors the H3 path but with HPACK headers.
@@ -638,14 +667,14 @@ extension XHTTPConnection {
     /// Sends one packet-up batch as its own shared-H2 stream; the response only acks receipt.
     func sendSharedH2PacketUp(data: Data, completion: @escaping (Error?) -> Void) {
         guard let shared = sharedH2 else { completion(XHTTPError.connectionClosed); return }
-        lock.lock(); let seq = nextSeq; nextSeq += 1; lock.unlock()
+        lock.lock(); let seq = nextSeq; nextSeq += 1; let template = packetUpTemplate(.hpack); lock.unlock()
         xmuxLease?.noteRequest()
 
         // Header/cookie placement carries the payload in the HEADERS block; the body stays empty.
         let dataFields = uplinkDataFields(for: data)
         let bodyInHeaders = !dataFields.isEmpty
         let bodyLength = bodyInHeaders ? 0 : data.count
-        let headers = encodeH2UploadHeaders(seq: seq, contentLength: bodyLength, uplinkData: dataFields)
+        let headers = template.render(seq: seq, contentLength: bodyLength, uplinkData: dataFields)
         let stream = shared.openStream()
 
         if bodyInHeaders || data.isEmpty {
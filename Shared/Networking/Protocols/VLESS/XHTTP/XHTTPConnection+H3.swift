@@ -41,8 +41,8 @@ extension XHTTPConnection {
                 // Can't wait for the response: the server only replies after seeing upload body.
                 let stream = XHTTPH3RequestStream(multiplexer: multiplexer)
                 lock.lock(); h3Download = stream; lock.unlock()
-                let headers = h3RequestHeaderBlock(method: "POST", includeMeta: false)
-                stream.sendRequest(headerBlock: headers, endStream: false) { error in
+                let headers = h3RequestHeaders(method: "POST", includeMeta: false)
+                stream.sendRequest(headers: headers, endStream: false) { error in
                     if let error {
                         completion(XHTTPError.setupFailed("H3 stream-one request failed: \(error.localizedDescription)"))
                     } else {
@@ -69,8 +69,8 @@ extension XHTTPConnection {
         let upload = XHTTPH3RequestStream(multiplexer: multiplexer)
         lock.lock(); h3Upload = upload; lock.unlock()
         xmuxLease?.noteRequest()
-        let headers = h3UploadHeaderBlock(seq: nil, contentLength: nil)
-        upload.sendRequest(headerBlock: headers, endStream: false) { upErr in
+        let headers = h3UploadHeaders(seq: nil, contentLength: nil)
+        upload.sendRequest(headers: headers, endStream: false) { upErr in
             if let upErr {
                 completion(XHTTPError.setupFailed("H3 upload stream open failed: \(upErr.localizedDescription)"))
             } else {
@@ -85,12 +85,12 @@ extension XHTTPConnection {
         let stream = XHTTPH3RequestStream(multiplexer: multiplexer)
         lock.lock(); h3Download = stream; lock.unlock()
         xmuxLease?.noteRequest()
-        let headers = h3RequestHeaderBlock(method: "GET", includeMeta: true)
+        let headers = h3RequestHeaders(method: "GET", includeMeta: true)
 
         // Both callbacks run on the multiplexer queue, so `settled` is race-free.
         var settled = false
         stream.sendRequest(
-            headerBlock: headers,
+            headers: headers,
             endStream: true,
             onResponse: { result in
                 guard !settled else { return }
@@ -135,10 +135,10 @@ extension XHTTPConnection {
         let bodyInHeaders = !dataFields.isEmpty
         let bodyLength = bodyInHeaders ? 0 : data.count
         let stream = XHTTPH3RequestStream(multiplexer: multiplexer)
-        let headers = h3UploadHeaderBlock(seq: seq, contentLength: bodyLength, uplinkData: dataFields)
+        let headers = h3UploadHeaders(seq: seq, contentLength: bodyLength, uplinkData: dataFields)
 
         guard !bodyInHeaders, !data.isEmpty else {
-            stream.sendRequest(headerBlock: headers, endStream: true) { error in
+            stream.sendRequest(headers: headers, endStream: true) { error in
                 if let error {
                     stream.close()
                     completion(error)
@@ -150,7 +150,7 @@ extension XHTTPConnection {
             return
         }
 
-        stream.sendRequest(headerBlock: headers, endStream: false) { error in
+        stream.sendRequest(headers: headers, endStream: false) { error in
             if let error {
                 stream.close()
                 completion(error)
@@ -180,8 +180,8 @@ extension XHTTPConnection {
 
     // MARK: Header construction (QPACK)
 
-    /// Builds the QPACK header block for the download GET or the stream-one POST.
-    func h3RequestHeaderBlock(method: String, includeMeta: Bool) -> Data {
+    /// Request fields for the download GET or the stream-one POST; QPACK-encoded once the stream opens.
+    func h3RequestHeaders(method: String, includeMeta: Bool) -> [(name: String, value: String)] {
         var path = configuration.normalizedPath
         if includeMeta, !sessionId.isEmpty, configuration.sessionPlacement == .path {
             path = appendToPath(path, sessionId)
@@ -203,14 +203,14 @@ extension XHTTPConnection {
         }
         if includeMeta { h3AppendSessionMeta(to: &headers) }
 
-        return QPACKEncoder.encodeRequestHeaders(
+        return QPACKEncoder.requestFields(
             method: method, authority: configuration.host, path: path, extraHeaders: headers
         )
     }
 
-    /// QPACK header block for an upload POST; `seq` is nil for stream-up, set per batch for packet-up.
+    /// Request fields for an upload POST; `seq` is nil for stream-up, set per batch for packet-up.
     /// `uplinkData` carries a packet-up payload in headers/cookies under non-body placement.
-    func h3UploadHeaderBlock(seq: Int64?, contentLength: Int?, uplinkData: [UplinkDataField] = []) -> Data {
+    func h3UploadHeaders(seq: Int64?, contentLength: Int?, uplinkData: [UplinkDataField] = []) -> [(name: String, value: String)] {
         var path = configuration.normalizedPath
         if !sessionId.isEmpty, configuration.sessionPlacement == .path {
             path = appendToPath(path, sessionId)
@@ -250,7 +250,7 @@ extension XHTTPConnection {
             }
         }
 
-        return QPACKEncoder.encodeRequestHeaders(
+        return QPACKEncoder.requestFields(
             method: configuration.uplinkHTTPMethod, authority: configuration.host, path: path, extraHeaders: headers
         )
     }
@@ -366,45 +366,14 @@ extension XHTTPConnection {
         uploadSend: @escaping (Data, @escaping (Error?) -> Void) -> Void,
         completion: @escaping (Error?) -> Void
     ) {
-        let method = configuration.uplinkHTTPMethod
-        var path = configuration.normalizedPath
-        var headerBlock = ""
-
-        applySessionId(to: &headerBlock, path: &path)
-        applySeq(to: &headerBlock, path: &path, seq: seq)
-
         // Header/cookie placement carries the payload outside the body.
-        let bodyData: Data
         let dataFields = uplinkDataFields(for: data)
-        if dataFields.isEmpty {
-            bodyData = data
-        } else {
-            for field in dataFields {
-                switch field {
-                case .header(let name, let value): headerBlock += "\(name): \(value)\r\n"
-                case .cookie(let pair):            headerBlock += "Cookie: \(pair)\r\n"
-                }
-            }
-            bodyData = Data()
-        }
-
-        let metaQuery = queryParamsForMeta(seq: seq)
-        var request = buildRequestLine(method: method, path: path, queryParts: [metaQuery])
-        request += "Host: \(configuration.host)\r\n"
-        request += "User-Agent: \(configuration.headers["User-Agent"] ?? ProxyUserAgent.default)\r\n"
-        request += headerBlock
-        applyPadding(to: &request, forPath: path)
-        request += "Content-Length: \(bodyData.count)\r\n"
-        request += "Connection: keep-alive\r\n"
-        for (key, value) in configuration.headers where key != "User-Agent" {
-            request += "\(key): \(value)\r\n"
-        }
-        request += "\r\n"
+        let bodyData = dataFields.isEmpty ? data : Data()
 
-        guard var requestData = request.data(using: .utf8) else {
-            completion(XHTTPError.setupFailed("Failed to encode POST request"))
-            return
-        }
+        lock.lock()
+        let template = packetUpTemplate(.http11)
+        lock.unlock()
+        var requestData = template.render(seq: seq, contentLength: bodyData.count, uplinkData: dataFields)
         requestData.append(bodyData)
 
         // Rate limiting between POSTs is enforced upstream by flushPacketUpBatch.
@@ -28,6 +28,7 @@ nonisolated class XHTTPConnection {
 
     // Download / stream-one connection
     let downloadSend: (Data, @escaping (Error?) -> Void) -> Void
+    let downloadSendChain: (ByteChain, @escaping (Error?) -> Void) -> Void
     let downloadReceive: (@escaping (Data?, Bool, Error?) -> Void) -> Void
     let downloadCancel: () -> Void
 
@@ -54,10 +55,19 @@ nonisolated class XHTTPConnection {
     var _isConnected = false
     let lock = UnfairLock()
 
-    // Packet-up batching: sends queue here; a single in-flight flush drains one POST per `scMinPostsIntervalMs`.
+    // Packet-up batching: sends queue here; a single flush chain starts one POST per `scMinPostsIntervalMs`,
+    // keeping up to `packetUpWindow` of them in flight.
     var packetUpQueue: [(Data, (Error?) -> Void)] = []
     var packetUpFlushPending = false
     var packetUpLastFlushTime: UInt64 = 0
+    var packetUpInFlight = 0
+    /// EWMA of POST start-to-write-completion time, 0 until the first sample.
+    var packetUpSmoothedLatencyNs: UInt64 = 0
+    /// EWMA of POST body size.
+    var packetUpSmoothedPostBytes = 0
+    /// Packet-up request heads compiled on first use; guarded by `lock`.
+    var http11UploadTemplate: XHTTPUploadTemplate?
+    var hpackUploadTemplate: XHTTPUploadTemplate?
 
     /// Leftover data after HTTP response headers.
     var headerBuffer = Data()
@@ -75,7 +85,9 @@ nonisolated class XHTTPConnection {
     /// Send window for the active upload stream; updated by SETTINGS INITIAL_WINDOW_SIZE and stream WINDOW_UPDATE.
     var h2PeerStreamSendWindow: Int = 65535
     var h2PeerInitialWindowSize: Int = 65535
-    var h2LocalWindowSize: Int = 4_194_304  // Match h2StreamWindowSize (4MB)
+    var h2LocalWindowSize = Int(XHTTPConnection.h2StreamWindowSize)
+    /// Grows the download stream's window to the measured BDP (see ``H2WindowTuner``).
+    var h2WindowTuner = H2WindowTuner(initialWindow: Int(XHTTPConnection.h2StreamWindowSize))
     var h2MaxFrameSize: Int = 16384
     var h2ResponseReceived = false
     var h2StreamClosed = false
@@ -192,23 +204,6 @@ nonisolated class XHTTPConnection {
         return parts.joined(separator: "&")
     }
 
-    func applySeq(to request: inout String, path: inout String, seq: Int64) {
-        let key = configuration.normalizedSeqKey
-        switch configuration.seqPlacement {
-        case .path:
-            path = appendToPath(path, "\(seq)")
-        case .query:
-            // Handled in queryParamsForMeta
-            break
-        case .header:
-            request += "\(key): \(seq)\r\n"
-        case .cookie:
-            request += "Cookie: \(key)=\(seq)\r\n"
-        default:
-            break
-        }
-    }
-
     func appendToPath(_ path: String, _ segment: String) -> String {
         if path.hasSuffix("/") {
             return path + segment
@@ -258,6 +253,22 @@ nonisolated class XHTTPConnection {
         return fields
     }
 
+    /// The cached packet-up template for `framing`, compiled on first call. Caller holds `lock`.
+    func packetUpTemplate(_ framing: XHTTPUploadTemplate.Framing) -> XHTTPUploadTemplate {
+        switch framing {
+        case .http11:
+            if let http11UploadTemplate { return http11UploadTemplate }
+            let template = XHTTPUploadTemplate.http11(configuration: configuration, sessionId: sessionId)
+            http11UploadTemplate = template
+            return template
+        case .hpack:
+            if let hpackUploadTemplate { return hpackUploadTemplate }
+            let template = XHTTPUploadTemplate.hpack(configuration: configuration, sessionId: sessionId)
+            hpackUploadTemplate = template
+            return template
+        }
+    }
+
     func buildRequestLine(method: String, path: String, queryParts: [String]) -> String {
         var url = path
         var allQuery = queryParts.filter { !$0.isEmpty }
@@ -285,13 +296,14 @@ nonisolated class XHTTPConnection {
         self.useHTTP2 = useHTTP2
         self.uploadConnectionFactory = uploadConnectionFactory
         self.downloadSend = download.send
+        self.downloadSendChain = download.sendChain
         self.downloadReceive = download.receive
         self.downloadCancel = download.cancel
         self.h2FrameReader = H2FrameReader(maxBufferSize: Self.maxH2ReadBufferSize, receive: download.receive)
         self._isConnected = true
     }
 
-    convenience init(transport: NWTCPTransport, configuration: XHTTPConfiguration, mode: XHTTPMode, sessionId: String, useHTTP2: Bool = false, uploadConnectionFactory: ((@escaping (Result<TransportClosures, Error>) -> Void) -> Void)? = nil) {
+    convenience init(transport: any TCPDialTransport, configuration: XHTTPConfiguration, mode: XHTTPMode, sessionId: String, useHTTP2: Bool = false, uploadConnectionFactory: ((@escaping (Result<TransportClosures, Error>) -> Void) -> Void)? = nil) {
         self.init(download: TransportClosures(tcp: transport), configuration: configuration, mode: mode, sessionId: sessionId, useHTTP2: useHTTP2, uploadConnectionFactory: uploadConnectionFactory)
     }
 
@@ -493,6 +505,7 @@ nonisolated class XHTTPConnection {
         let pendingPackets = packetUpQueue
         packetUpQueue.removeAll()
         packetUpFlushPending = false
+        packetUpInFlight = 0
         // Sends parked on H2 flow control; each re-enters its send, sees the closed stream,
         // and completes with `.connectionClosed` rather than hanging forever.
         let flowResumptions = h2FlowResumptions
@@ -566,7 +579,27 @@ nonisolated class XHTTPConnection {
         }
     }
 
-    /// Drains the queue (up to `scMaxEachPostBytes`) into one POST, then chains into the next flush if needed.
+    /// Bytes the in-flight window may hold at the smoothed POST size.
+    private static let packetUpMaxInFlightBytes = 4 * 1024 * 1024
+
+    /// POSTs to keep in flight: enough to cover one smoothed POST latency at
+    /// `scMinPostsIntervalMs` spacing, bounded by `packetUpMaxInFlightBytes` at the smoothed POST
+    /// size and by `scMaxConcurrentPosts`. A POST that outgrows its stream's flow-control window
+    /// takes a round trip to finish, so a lone in-flight POST caps throughput at one
+    /// POST per RTT. HTTP/1.1 stays at one, since its keep-alive upload connection
+    /// serializes requests anyway. Caller holds `lock`.
+    private var packetUpWindow: Int {
+        guard usesSharedH2 || useHTTP2 || useHTTP3 else { return 1 }
+        let cap = max(1, configuration.scMaxConcurrentPosts)
+        guard packetUpSmoothedLatencyNs > 0 else { return min(2, cap) }
+        let intervalNs = UInt64(max(1, configuration.scMinPostsIntervalMs)) * 1_000_000
+        let latencyWindow = Int(min((packetUpSmoothedLatencyNs + intervalNs - 1) / intervalNs, UInt64(cap))) + 1
+        let bytesWindow = Self.packetUpMaxInFlightBytes / max(1, packetUpSmoothedPostBytes)
+        return max(1, min(latencyWindow, bytesWindow, cap))
+    }
+
+    /// Drains the queue (up to `scMaxEachPostBytes`) into one POST, then chains into the next flush
+    /// while the window has room; a completing POST restarts the chain if it had stopped.
     private func flushPacketUpBatch() {
         lock.lock()
 
@@ -581,7 +614,7 @@ nonisolated class XHTTPConnection {
             return
         }
 
-        guard !packetUpQueue.isEmpty else {
+        guard !packetUpQueue.isEmpty, packetUpInFlight < packetUpWindow else {
             packetUpFlushPending = false
             lock.unlock()
             return
@@ -592,19 +625,28 @@ nonisolated class XHTTPConnection {
         var batchedCompletions: [(Error?) -> Void] = []
         while !packetUpQueue.isEmpty {
             let (chunk, completion) = packetUpQueue[0]
-            // The first chunk may exceed maxSize on its own (sendPacketUp re-splits it).
             if !batchedData.isEmpty && batchedData.count + chunk.count > maxSize {
                 break
             }
+            if chunk.count > maxSize {
+                // Split here rather than in the send path, so every POST takes its seq in queue order;
+                // the completion rides on the final piece.
+                batchedData = Data(chunk.prefix(maxSize))
+                packetUpQueue[0].0 = Data(chunk.suffix(from: chunk.startIndex + maxSize))
+                break
+            }
             batchedData.append(chunk)
             batchedCompletions.append(completion)
             packetUpQueue.removeFirst()
         }
 
-        packetUpLastFlushTime = DispatchTime.now().uptimeNanoseconds
+        let startTime = DispatchTime.now().uptimeNanoseconds
+        packetUpLastFlushTime = startTime
+        packetUpInFlight += 1
         let isShared = usesSharedH2
         let isH2 = useHTTP2
         let isH3 = useHTTP3
+        let postBytes = batchedData.count
         lock.unlock()
 
         let onComplete: (Error?) -> Void = { [weak self] error in
@@ -613,16 +655,31 @@ nonisolated class XHTTPConnection {
             }
             guard let self else { return }
             self.lock.lock()
-            if error != nil || self.packetUpQueue.isEmpty {
-                self.packetUpFlushPending = false
+            self.packetUpInFlight = max(0, self.packetUpInFlight - 1)
+            guard error == nil else {
                 self.lock.unlock()
                 return
             }
-            // packetUpFlushPending stays true; chain into the next flush.
+            let latency = DispatchTime.now().uptimeNanoseconds &- startTime
+            if self.packetUpSmoothedLatencyNs == 0 {
+                self.packetUpSmoothedLatencyNs = latency
+                self.packetUpSmoothedPostBytes = postBytes
+            } else {
+                self.packetUpSmoothedLatencyNs = (self.packetUpSmoothedLatencyNs * 7 + latency) / 8
+                self.packetUpSmoothedPostBytes = (self.packetUpSmoothedPostBytes * 7 + postBytes) / 8
+            }
+            let restartsChain = !self.packetUpFlushPending && !self.packetUpQueue.isEmpty
+            if restartsChain {
+                self.packetUpFlushPending = true
+            }
             self.lock.unlock()
-            self.schedulePacketUpFlush()
+            if restartsChain {
+                self.schedulePacketUpFlush()
+            }
         }
 
+        // Each send takes its seq and issues its first write before returning, and the chain stays
+        // pending until then, so seq and stream order follow queue order.
         if isShared {
             sendSharedH2PacketUp(data: batchedData, completion: onComplete)
         } else if isH3 {
@@ -632,6 +689,14 @@ nonisolated class XHTTPConnection {
         } else {
             sendPacketUp(data: batchedData, completion: onComplete)
         }
+
+        lock.lock()
+        let chainsNext = !packetUpQueue.isEmpty && packetUpInFlight < packetUpWindow
+        packetUpFlushPending = chainsNext
+        lock.unlock()
+        if chainsNext {
+            schedulePacketUpFlush()
+        }
     }
 }
 
@@ -958,6 +1023,7 @@ nonisolated final class XHTTPH2Stream {
 /// One always-on read loop demuxes frames to per-stream buffers. State under `lock`.
 nonisolated final class XHTTPH2Multiplexer: XHTTPXMUXMultiplexerPoolable {
     private let transportSend: (Data, @escaping (Error?) -> Void) -> Void
+    private let transportSendChain: (ByteChain, @escaping (Error?) -> Void) -> Void
     private let transportCancel: () -> Void
     /// Demuxes the shared socket into H2 frames; one always-on read loop drives it.
     private let frameReader: H2FrameReader
@@ -983,6 +1049,7 @@ nonisolated final class XHTTPH2Multiplexer: XHTTPXMUXMultiplexerPoolable {
 
     init(transport: TransportClosures) {
         transportSend = transport.send
+        transportSendChain = transport.sendChain
         transportCancel = transport.cancel
         frameReader = H2FrameReader(maxBufferSize: Self.maxReadBuffer, receive: transport.receive)
     }
@@ -1238,7 +1305,8 @@ nonisolated final class XHTTPH2Multiplexer: XHTTPXMUXMultiplexerPoolable {
             lock.unlock()
             return
         }
-        var frames = Data()
+        // Frames reference `data` by slice; the bytes are gathered once, at the transport.
+        var frames = ByteChain()
         var current = offset
         var remainingWindow = window
         while current < data.count {
@@ -1246,8 +1314,9 @@ nonisolated final class XHTTPH2Multiplexer: XHTTPXMUXMultiplexerPoolable {
             guard chunk > 0 else { break }
             let isLast = (current + chunk) >= data.count
             let flags: UInt8 = (isLast && endStream) ? XHTTPConnection.h2FlagEndStream : 0
-            frames.append(frame(type: XHTTPConnection.h2FrameData, flags: flags, streamId: stream.streamId,
-                                payload: Data(data[data.startIndex + current ..< data.startIndex + current + chunk])))
+            H2Framing.appendFrame(type: XHTTPConnection.h2FrameData, flags: flags, streamId: stream.streamId,
+                                  payload: ByteChain(data[data.startIndex + current ..< data.startIndex + current + chunk]),
+                                  to: &frames)
             current += chunk
             remainingWindow -= chunk
         }
@@ -1257,7 +1326,7 @@ nonisolated final class XHTTPH2Multiplexer: XHTTPXMUXMultiplexerPoolable {
         lock.unlock()
 
         let nextOffset = current
-        transportSend(frames) { [weak self] error in
+        transportSendChain(frames) { [weak self] error in
             if let error { completion(error); return }
             if nextOffset < data.count {
                 self?.sendData(stream: stream, data: data, offset: nextOffset, endStream: endStream, completion: completion)
@@ -19,21 +19,33 @@ enum H2Framing {
     /// Serializes a frame: 24-bit length, 8-bit type, 8-bit flags, 31-bit stream id, payload.
     static func frame(type: UInt8, flags: UInt8, streamId: UInt32, payload: Data) -> Data {
         var frameData = Data(capacity: headerSize + payload.count)
-        let length = UInt32(payload.count)
-        frameData.append(UInt8((length >> 16) & 0xFF))
-        frameData.append(UInt8((length >> 8) & 0xFF))
-        frameData.append(UInt8(length & 0xFF))
-        frameData.append(type)
-        frameData.append(flags)
-        let sid = streamId & 0x7FFFFFFF
-        frameData.append(UInt8((sid >> 24) & 0xFF))
-        frameData.append(UInt8((sid >> 16) & 0xFF))
-        frameData.append(UInt8((sid >> 8) & 0xFF))
-        frameData.append(UInt8(sid & 0xFF))
+        appendHeader(type: type, flags: flags, streamId: streamId, length: payload.count, to: &frameData)
         frameData.append(payload)
         return frameData
     }
 
+    /// Appends a frame to `chain` as its 9-byte header plus `payload` by reference.
+    static func appendFrame(type: UInt8, flags: UInt8, streamId: UInt32, payload: ByteChain, to chain: inout ByteChain) {
+        var header = Data(capacity: headerSize)
+        appendHeader(type: type, flags: flags, streamId: streamId, length: payload.count, to: &header)
+        chain.append(header)
+        chain.append(payload)
+    }
+
+    private static func appendHeader(type: UInt8, flags: UInt8, streamId: UInt32, length: Int, to data: inout Data) {
+        let length = UInt32(length)
+        data.append(UInt8((length >> 16) & 0xFF))
+        data.append(UInt8((length >> 8) & 0xFF))
+        data.append(UInt8(length & 0xFF))
+        data.append(type)
+        data.append(flags)
+        let sid = streamId & 0x7FFFFFFF
+        data.append(UInt8((sid >> 24) & 0xFF))
+        data.append(UInt8((sid >> 16) & 0xFF))
+        data.append(UInt8((sid >> 8) & 0xFF))
+        data.append(UInt8(sid & 0xFF))
+    }
+
     /// Consumes one complete frame from the front of `buffer`; nil until a full frame is buffered.
     static func parseFrame(from buffer: inout Data) -> Frame? {
         guard buffer.count >= headerSize else { return nil }
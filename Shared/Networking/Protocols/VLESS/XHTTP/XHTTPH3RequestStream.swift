@@ -38,10 +38,14 @@ nonisolated final class XHTTPH3RequestStream: HTTP3StreamHandler {
     private var endStreamReceived = false
     private var streamError: Error?
 
-    // Frames may span QUIC deliveries; offset-based parsing with lazy compaction
-    // keeps cost amortized O(1).
+    // Holds one QUIC delivery (copied once out of ngtcp2's buffer) plus any partial frame
+    // left over from the last. DATA payloads are handed up as slices of it as they arrive,
+    // so a frame spanning deliveries is never reassembled; only a split frame header or a
+    // non-DATA frame is carried over.
     private var frameBuffer = Data()
     private var frameBufferOffset = 0
+    /// Payload bytes of the current DATA frame not yet received.
+    private var dataRemaining = 0
 
     // MARK: - Init
 
@@ -51,10 +55,11 @@ nonisolated final class XHTTPH3RequestStream: HTTP3StreamHandler {
 
     // MARK: - Request
 
-    /// Opens a bidirectional QUIC stream and writes the request HEADERS frame;
+    /// Opens a bidirectional QUIC stream and writes the request HEADERS frame, QPACK-encoding
+    /// `headers` against the multiplexer's tables;
     /// `completion` fires once the HEADERS are written (or the stream fails),
     /// `onResponse` when the response `:status` arrives.
-    func sendRequest(headerBlock: Data,
+    func sendRequest(headers: [(name: String, value: String)],
                      endStream: Bool,
                      onResponse: ((Result<Int, Error>) -> Void)? = nil,
                      completion: @escaping (Error?) -> Void) {
@@ -83,6 +88,7 @@ nonisolated final class XHTTPH3RequestStream: HTTP3StreamHandler {
                 multiplexer.registerStream(self, streamID: streamID)
                 self.state = .requestSent
 
+                let headerBlock = multiplexer.encodeHeaderBlock(headers, streamID: streamID)
                 let frame = HTTP3Framer.headersFrame(headerBlock: headerBlock)
                 multiplexer.writeStream(streamID, data: frame, fin: endStream) { [weak self] error in
                     if let error {
@@ -106,8 +112,14 @@ nonisolated final class XHTTPH3RequestStream: HTTP3StreamHandler {
                 return
             }
             // An empty payload with fin==true is a bare half-close (FIN, no DATA frame).
-            let frame = data.isEmpty ? Data() : HTTP3Framer.dataFrame(payload: data)
-            multiplexer.writeStream(sid, data: frame, fin: fin, completion: completion)
+            guard !data.isEmpty else {
+                multiplexer.writeStream(sid, data: Data(), fin: true, completion: completion)
+                return
+            }
+            // Header and payload go to ngtcp2 as separate vecs; the payload is never
+            // concatenated into a frame first.
+            multiplexer.writeStream(sid, header: HTTP3Framer.dataFrameHeader(length: data.count),
+                                    payload: data, fin: fin, completion: completion)
         }
         if multiplexer.isOnQueue { block() } else { multiplexer.queue.async(execute: block) }
     }
@@ -208,9 +220,30 @@ nonisolated final class XHTTPH3RequestStream: HTTP3StreamHandler {
     // MARK: - Frame processing
 
     private func processFrameBuffer() {
-        // Only DATA frames reach the app; control frames are acked in batch.
+        // Only DATA payloads reach the app; frame headers and control frames are acked in batch.
         var controlBytes = 0
         while frameBufferOffset < frameBuffer.count {
+            if dataRemaining > 0 {
+                let start = frameBuffer.startIndex + frameBufferOffset
+                let count = min(dataRemaining, frameBuffer.count - frameBufferOffset)
+                dataRemaining -= count
+                frameBufferOffset += count
+                deliverData(frameBuffer[start..<(start + count)], quicBytes: count)
+                continue
+            }
+            if headersReceived,
+               let (type, typeLength) = QUICVarInt.decode(from: frameBuffer, offset: frameBufferOffset),
+               type == HTTP3FrameType.data.rawValue {
+                guard let (length, lengthLength) = QUICVarInt.decode(
+                    from: frameBuffer, offset: frameBufferOffset + typeLength
+                ) else {
+                    break
+                }
+                frameBufferOffset += typeLength + lengthLength
+                controlBytes += typeLength + lengthLength
+                dataRemaining = Int(length)
+                continue
+            }
             guard let (frame, consumed) = HTTP3Framer.parseFrame(
                 from: frameBuffer, offset: frameBufferOffset
             ) else {
@@ -221,8 +254,6 @@ nonisolated final class XHTTPH3RequestStream: HTTP3StreamHandler {
             if !headersReceived {
                 processResponseHeaders(frame)
                 controlBytes += consumed
-            } else if frame.type == HTTP3FrameType.data.rawValue {
-                deliverData(frame.payload, quicBytes: consumed)
             } else {
                 // Trailers / unknown frames after the response headers.
                 controlBytes += consumed
@@ -232,10 +263,11 @@ nonisolated final class XHTTPH3RequestStream: HTTP3StreamHandler {
             ackQuicBytes(controlBytes)
         }
 
+        // Delivered slices keep their own reference, so what's left is always small.
         if frameBufferOffset >= frameBuffer.count {
             frameBuffer = Data()
             frameBufferOffset = 0
-        } else if frameBufferOffset > 64 * 1024 {
+        } else if frameBufferOffset > 0 {
             frameBuffer = Data(frameBuffer[(frameBuffer.startIndex + frameBufferOffset)...])
             frameBufferOffset = 0
         }
@@ -246,7 +278,8 @@ nonisolated final class XHTTPH3RequestStream: HTTP3StreamHandler {
             handleStreamError(HTTP3Error.connectionFailed("Expected HEADERS, got type \(frame.type)"))
             return
         }
-        guard let headers = QPACKEncoder.decodeHeaders(from: frame.payload) else {
+        guard let streamID = quicStreamID,
+              let headers = multiplexer?.decodeHeaderBlock(frame.payload, streamID: streamID) else {
             handleStreamError(HTTP3Error.connectionFailed("Malformed QPACK header block"))
             return
         }
@@ -0,0 +1,381 @@
+//
+//  XHTTPUploadTemplate.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// A packet-up upload request compiled once per connection: the request line or HEADERS block
+/// as precomputed bytes with slots for the sequence number, padding, and content length,
+/// filled per POST without building Strings. HTTP/1.1 slots are written raw; HPACK slots get
+/// their string-length prefix from the filled size.
+nonisolated struct XHTTPUploadTemplate {
+
+    enum Framing { case http11, hpack }
+
+    private enum Slot { case seq, padding, contentLength }
+
+    private enum Part {
+        case bytes([UInt8])
+        case slot(Slot)
+    }
+
+    private enum Piece {
+        case bytes([UInt8])
+        /// A value with slots; under HPACK a raw string literal (length prefix, then bytes).
+        case value([Part])
+        /// The packet-up payload under header/cookie placement.
+        case uplinkData
+    }
+
+    private let framing: Framing
+    private let pieces: [Piece]
+    private let usesPadding: Bool
+    private let configuration: XHTTPConfiguration
+
+    private init(framing: Framing, pieces: [Piece], configuration: XHTTPConfiguration) {
+        self.framing = framing
+        self.pieces = pieces
+        self.configuration = configuration
+        self.usesPadding = pieces.contains { piece in
+            guard case .value(let parts) = piece else { return false }
+            return parts.contains { if case .slot(.padding) = $0 { return true } else { return false } }
+        }
+    }
+
+    /// One request's bytes: the full HTTP/1.1 head (blank line included) or the HPACK block.
+    func render(seq: Int64, contentLength: Int, uplinkData: [XHTTPConnection.UplinkDataField]) -> Data {
+        let padding = usesPadding ? configuration.generatePaddingBytes() : []
+        var out = Data()
+        out.reserveCapacity(512 + padding.count)
+
+        func length(of part: Part) -> Int {
+            switch part {
+            case .bytes(let bytes): return bytes.count
+            case .slot(.seq): return Self.decimalLength(seq)
+            case .slot(.padding): return padding.count
+            case .slot(.contentLength): return Self.decimalLength(Int64(contentLength))
+            }
+        }
+
+        for piece in pieces {
+            switch piece {
+            case .bytes(let bytes):
+                out.append(contentsOf: bytes)
+            case .value(let parts):
+                if framing == .hpack {
+                    HPACKEncoder.encodeInteger(parts.reduce(0) { $0 + length(of: $1) }, prefixBits: 7, into: &out)
+                }
+                for part in parts {
+                    switch part {
+                    case .bytes(let bytes): out.append(contentsOf: bytes)
+                    case .slot(.seq): Self.appendDecimal(seq, to: &out)
+                    case .slot(.padding): out.append(contentsOf: padding)
+                    case .slot(.contentLength): Self.appendDecimal(Int64(contentLength), to: &out)
+                    }
+                }
+            case .uplinkData:
+                for field in uplinkData {
+                    switch (framing, field) {
+                    case (.http11, .header(let name, let value)):
+                        out.append(contentsOf: Array("\(name): \(value)\r\n".utf8))
+                    case (.http11, .cookie(let pair)):
+                        out.append(contentsOf: Array("Cookie: \(pair)\r\n".utf8))
+                    // Large, single-use values: without indexing.
+                    case (.hpack, .header(let name, let value)):
+                        HPACKEncoder.encodeLiteralWithoutIndexing(name: name, value: value, into: &out)
+                    case (.hpack, .cookie(let pair)):
+                        HPACKEncoder.encodeLiteralWithoutIndexing(nameIndex: 32, value: pair, into: &out)
+                    }
+                }
+            }
+        }
+        return out
+    }
+
+    private static func decimalLength(_ value: Int64) -> Int {
+        var remaining = value.magnitude
+        var digits = 1
+        while remaining >= 10 {
+            remaining /= 10
+            digits += 1
+        }
+        return value < 0 ? digits + 1 : digits
+    }
+
+    private static func appendDecimal(_ value: Int64, to out: inout Data) {
+        if value < 0 { out.append(UInt8(ascii: "-")) }
+        var remaining = value.magnitude
+        var divisor: UInt64 = 1
+        while remaining / divisor >= 10 { divisor *= 10 }
+        while divisor > 0 {
+            out.append(UInt8(ascii: "0") + UInt8(remaining / divisor))
+            remaining %= divisor
+            divisor /= 10
+        }
+    }
+
+    // MARK: - Compilation
+
+    private struct Builder {
+        let framing: Framing
+        var pieces: [Piece] = []
+
+        /// Bytes as the framing writes strings: UTF-8 for HTTP/1.1, latin-1 where it fits for
+        /// HPACK (matching ``HPACKEncoder/encodeString(_:into:)``).
+        func bytes(_ string: String) -> [UInt8] {
+            if framing == .hpack, let latin1 = string.data(using: .isoLatin1) {
+                return [UInt8](latin1)
+            }
+            return Array(string.utf8)
+        }
+
+        mutating func append(_ bytes: [UInt8]) {
+            guard !bytes.isEmpty else { return }
+            if case .bytes(let existing) = pieces.last {
+                pieces[pieces.count - 1] = .bytes(existing + bytes)
+            } else {
+                pieces.append(.bytes(bytes))
+            }
+        }
+
+        mutating func text(_ string: String) {
+            append(bytes(string))
+        }
+
+        mutating func hpack(_ encode: (inout Data) -> Void) {
+            var block = Data()
+            encode(&block)
+            append([UInt8](block))
+        }
+
+        /// Under HTTP/1.1 a value is inlined; under HPACK it becomes a length-prefixed string.
+        mutating func value(_ parts: [Part]) {
+            if framing == .http11 {
+                for part in parts {
+                    if case .bytes(let bytes) = part { append(bytes) } else { pieces.append(.value([part])) }
+                }
+            } else {
+                pieces.append(.value(parts))
+            }
+        }
+
+        mutating func uplinkData() {
+            pieces.append(.uplinkData)
+        }
+    }
+
+    /// `normalizedPath` plus the session and seq path segments, joined like ``XHTTPConnection/appendToPath(_:_:)``.
+    private static func pathParts(configuration: XHTTPConfiguration, sessionId: String, builder: Builder) -> [Part] {
+        var path = configuration.normalizedPath
+        func separated(_ path: String) -> String { path.hasSuffix("/") ? path : path + "/" }
+        if !sessionId.isEmpty, configuration.sessionPlacement == .path {
+            path = separated(path) + sessionId
+        }
+        guard configuration.seqPlacement == .path else { return [.bytes(builder.bytes(path))] }
+        return [.bytes(builder.bytes(separated(path))), .slot(.seq)]
+    }
+
+    /// The HTTP/1.1 packet-up POST head, matching what `sendSinglePost` wrote field by field.
+    static func http11(configuration: XHTTPConfiguration, sessionId: String) -> XHTTPUploadTemplate {
+        var builder = Builder(framing: .http11)
+        let path = pathParts(configuration: configuration, sessionId: sessionId, builder: builder)
+
+        // Request line: config query, session and seq query meta, then query padding.
+        builder.text("\(configuration.uplinkHTTPMethod) ")
+        var query: [[Part]] = []
+        if !configuration.normalizedQuery.isEmpty {
+            query.append([.bytes(builder.bytes(configuration.normalizedQuery))])
+        }
+        if !sessionId.isEmpty, configuration.sessionPlacement == .query {
+            query.append([.bytes(builder.bytes("\(configuration.normalizedSessionKey)=\(sessionId)"))])
+        }
+        if configuration.seqPlacement == .query {
+            query.append([.bytes(builder.bytes("\(configuration.normalizedSeqKey)=")), .slot(.seq)])
+        }
+        if configuration.xPaddingObfsMode, configuration.xPaddingPlacement == .query {
+            query.append([.bytes(builder.bytes("\(configuration.xPaddingKey)=")), .slot(.padding)])
+        }
+        var requestURI = path
+        for (index, parts) in query.enumerated() {
+            requestURI.append(.bytes(builder.bytes(index == 0 ? "?" : "&")))
+            requestURI.append(contentsOf: parts)
+        }
+        builder.value(requestURI)
+        builder.text(" HTTP/1.1\r\n")
+
+        builder.text("Host: \(configuration.host)\r\n")
+        builder.text("User-Agent: \(configuration.headers["User-Agent"] ?? ProxyUserAgent.default)\r\n")
+
+        if !sessionId.isEmpty {
+            let key = configuration.normalizedSessionKey
+            switch configuration.sessionPlacement {
+            case .header: builder.text("\(key): \(sessionId)\r\n")
+            case .cookie: builder.text("Cookie: \(key)=\(sessionId)\r\n")
+            default: break
+            }
+        }
+        let seqKey = configuration.normalizedSeqKey
+        switch configuration.seqPlacement {
+        case .header:
+            builder.text("\(seqKey): ")
+            builder.value([.slot(.seq)])
+            builder.text("\r\n")
+        case .cookie:
+            builder.text("Cookie: \(seqKey)=")
+            builder.value([.slot(.seq)])
+            builder.text("\r\n")
+        default:
+            break
+        }
+        builder.uplinkData()
+
+        // X-Padding, as `applyPadding(to:forPath:)` places it.
+        let paddedURL: [Part] = [.bytes(builder.bytes("https://\(configuration.host)"))] + path
+            + [.bytes(builder.bytes("?\(configuration.xPaddingKey)=")), .slot(.padding)]
+        if !configuration.xPaddingObfsMode {
+            builder.text("Referer: ")
+            builder.value(paddedURL)
+            builder.text("\r\n")
+        } else {
+            switch configuration.xPaddingPlacement {
+            case .header:
+                builder.text("\(configuration.xPaddingHeader): ")
+                builder.value([.slot(.padding)])
+                builder.text("\r\n")
+            case .queryInHeader:
+                builder.text("\(configuration.xPaddingHeader): ")
+                builder.value(paddedURL)
+                builder.text("\r\n")
+            case .cookie:
+                builder.text("Cookie: \(configuration.xPaddingKey)=")
+                builder.value([.slot(.padding)])
+                builder.text("\r\n")
+            default:
+                break
+            }
+        }
+
+        builder.text("Content-Length: ")
+        builder.value([.slot(.contentLength)])
+        builder.text("\r\nConnection: keep-alive\r\n")
+        for (key, value) in configuration.headers where key != "User-Agent" {
+            builder.text("\(key): \(value)\r\n")
+        }
+        builder.text("\r\n")
+        return XHTTPUploadTemplate(framing: .http11, pieces: builder.pieces, configuration: configuration)
+    }
+
+    /// The HTTP/2 packet-up HEADERS block, matching `encodeH2UploadHeaders` for a set `seq`.
+    static func hpack(configuration: XHTTPConfiguration, sessionId: String) -> XHTTPUploadTemplate {
+        var builder = Builder(framing: .hpack)
+        let path = pathParts(configuration: configuration, sessionId: sessionId, builder: builder)
+
+        // Pseudo-header order: :authority, :method, :path, :scheme
+        builder.hpack { HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 1, value: configuration.host, into: &$0) }
+        let method = configuration.uplinkHTTPMethod
+        if method == "POST" {
+            builder.append([0x83])
+        } else if method == "GET" {
+            builder.append([0x82])
+        } else {
+            builder.hpack { HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 2, value: method, into: &$0) }
+        }
+
+        var requestURI = path
+        var query: [[Part]] = []
+        if !configuration.normalizedQuery.isEmpty {
+            query.append([.bytes(builder.bytes(configuration.normalizedQuery))])
+        }
+        if !sessionId.isEmpty, configuration.sessionPlacement == .query {
+            query.append([.bytes(builder.bytes("\(configuration.normalizedSessionKey)=\(sessionId)"))])
+        }
+        if configuration.seqPlacement == .query {
+            query.append([.bytes(builder.bytes("\(configuration.normalizedSeqKey)=")), .slot(.seq)])
+        }
+        for (index, parts) in query.enumerated() {
+            requestURI.append(.bytes(builder.bytes(index == 0 ? "?" : "&")))
+            requestURI.append(contentsOf: parts)
+        }
+        builder.append(literalWithIndexingPrefix(nameIndex: 4))
+        builder.value(requestURI)
+
+        builder.append([0x87])  // :scheme https
+
+        builder.append(literalWithIndexingPrefix(nameIndex: 28))  // content-length
+        builder.value([.slot(.contentLength)])
+
+        if !sessionId.isEmpty {
+            let key = configuration.normalizedSessionKey
+            switch configuration.sessionPlacement {
+            case .header:
+                builder.hpack { HPACKEncoder.encodeLiteralWithIndexing(name: key, value: sessionId, into: &$0) }
+            case .cookie:
+                builder.hpack { HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 32, value: "\(key)=\(sessionId)", into: &$0) }
+            default:
+                break
+            }
+        }
+        let seqKey = configuration.normalizedSeqKey
+        switch configuration.seqPlacement {
+        case .header:
+            builder.append([0x40])
+            builder.hpack { HPACKEncoder.encodeString(seqKey.lowercased(), into: &$0) }
+            builder.value([.slot(.seq)])
+        case .cookie:
+            builder.append(literalWithIndexingPrefix(nameIndex: 32))
+            builder.value([.bytes(builder.bytes("\(seqKey)=")), .slot(.seq)])
+        default:
+            break
+        }
+        builder.uplinkData()
+
+        // Common headers, as `appendH2CommonHeaders(to:path:)` writes them.
+        let userAgent = configuration.headers["User-Agent"] ?? ProxyUserAgent.default
+        builder.hpack { HPACKEncoder.encodeLiteralWithIndexing(nameIndex: 58, value: userAgent, into: &$0) }
+        let paddingPath = configuration.normalizedPath
+        if !configuration.xPaddingObfsMode {
+            builder.append(literalWithIndexingPrefix(nameIndex: 51))  // referer
+            builder.value([.bytes(builder.bytes("https://\(configuration.host)\(paddingPath)?x_padding=")), .slot(.padding)])
+        } else {
+            switch configuration.xPaddingPlacement {
+            case .header:
+                builder.append([0x40])
+                builder.hpack { HPACKEncoder.encodeString(configuration.xPaddingHeader.lowercased(), into: &$0) }
+                builder.value([.slot(.padding)])
+            case .queryInHeader:
+                builder.append([0x40])
+                builder.hpack { HPACKEncoder.encodeString(configuration.xPaddingHeader.lowercased(), into: &$0) }
+                builder.value([
+                    .bytes(builder.bytes("https://\(configuration.host)\(paddingPath)?\(configuration.xPaddingKey)=")),
+                    .slot(.padding),
+                ])
+            case .cookie:
+                builder.append(literalWithIndexingPrefix(nameIndex: 32))
+                builder.value([.bytes(builder.bytes("\(configuration.xPaddingKey)=")), .slot(.padding)])
+            default:
+                break
+            }
+        }
+
+        let forbidden: Set<String> = [
+            "host", "connection", "proxy-connection", "transfer-encoding",
+            "upgrade", "keep-alive", "content-length", "user-agent"
+        ]
+        for (key, value) in configuration.headers {
+            let lowercasedKey = key.lowercased()
+            if forbidden.contains(lowercasedKey) { continue }
+            builder.hpack { HPACKEncoder.encodeLiteralWithIndexing(name: lowercasedKey, value: value, into: &$0) }
+        }
+        return XHTTPUploadTemplate(framing: .hpack, pieces: builder.pieces, configuration: configuration)
+    }
+
+    /// §6.2.1 literal-with-incremental-indexing prefix for a static name; the value follows.
+    private static func literalWithIndexingPrefix(nameIndex: Int) -> [UInt8] {
+        var prefix = Data()
+        HPACKEncoder.encodeInteger(nameIndex, prefixBits: 6, flags: 0x40, into: &prefix)
+        return [UInt8](prefix)
+    }
+}
@@ -0,0 +1,172 @@
+//
+//  StatsRing.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "StatsRing")
+
+/// Tunnel stats shared through a memory-mapped file in the App Group, so the app reads them
+/// without a `fetchStats` round trip that wakes the extension. The extension is the single
+/// writer: it fills the older of two slots between an odd and an even slot sequence and then
+/// advances the header's `latest`, seqlock-style. A reader copies the newest slot and keeps it
+/// only if the sequence held still. Swift has no cross-process fences, so every slot also
+/// carries a checksum; a reader that races a write sees the mismatch and falls back to IPC.
+/// Readers stamp a heartbeat, and the writer publishes only while one is recent.
+nonisolated enum StatsRing {
+
+    /// Snapshots encode to a few KB; one that doesn't fit is left to the app message.
+    static let slotCapacity = 64 << 10
+    /// A slot older than this means the writer is gone (tunnel stopped or crashed).
+    static let maxAge: CFAbsoluteTime = 5
+    /// The writer keeps publishing this long after the last read.
+    static let readerTimeout: CFAbsoluteTime = 5
+
+    private static let magic: UInt32 = 0x4157_5352   // "AWSR"
+
+    // Header: magic u32 @0, latest u64 @8 (0 = nothing published), reader heartbeat f64 @16.
+    private static let headerSize = 64
+    private static let latestOffset = 8
+    private static let heartbeatOffset = 16
+
+    // Slot header: sequence u64 @0 (odd while writing), length u32 @8, checksum u32 @12,
+    // publishedAt f64 @16; the payload follows.
+    private static let slotHeaderSize = 32
+    private static let slotStride = slotHeaderSize + slotCapacity
+    private static let slotCount = 2
+    private static let fileSize = headerSize + slotCount * slotStride
+
+    static var url: URL? {
+        FileManager.default
+            .containerURL(forSecurityApplicationGroupIdentifier: AWCore.Identifier.appGroupSuite)?
+            .appendingPathComponent("stats.ring")
+    }
+
+    /// Maps the ring file read-write; `create` sizes it first. Readers never create it, and a
+    /// file shorter than the ring is not mapped (touching past EOF raises SIGBUS).
+    private static func map(create: Bool) -> UnsafeMutableRawPointer? {
+        guard let url else { return nil }
+        let fd = open(url.path, create ? (O_RDWR | O_CREAT) : O_RDWR, 0o644)
+        guard fd >= 0 else { return nil }
+        defer { Darwin.close(fd) }
+        if create {
+            guard ftruncate(fd, off_t(fileSize)) == 0 else {
+                logger.warning("[Stats] ring resize failed: errno \(errno)")
+                return nil
+            }
+        } else {
+            var info = stat()
+            guard fstat(fd, &info) == 0, info.st_size >= off_t(fileSize) else { return nil }
+        }
+        guard let base = mmap(nil, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0),
+              base != MAP_FAILED else {
+            logger.warning("[Stats] ring map failed: errno \(errno)")
+            return nil
+        }
+        return base
+    }
+
+    /// FNV-1a over `publishedAt` and the payload.
+    private static func checksum(publishedAt: CFAbsoluteTime, payload: UnsafeRawBufferPointer) -> UInt32 {
+        var hash: UInt32 = 0x811C_9DC5
+        withUnsafeBytes(of: publishedAt.bitPattern) { stamp in
+            for byte in stamp { hash = (hash ^ UInt32(byte)) &* 0x0100_0193 }
+        }
+        for byte in payload { hash = (hash ^ UInt32(byte)) &* 0x0100_0193 }
+        return hash
+    }
+
+    // MARK: - Writer
+
+    /// Owned by the extension's `StatsRecorder`; driven from one queue.
+    final class Writer {
+        private let base: UnsafeMutableRawPointer
+        private var published: UInt64 = 0
+
+        init?() {
+            guard let base = StatsRing.map(create: true) else { return nil }
+            self.base = base
+            base.storeBytes(of: UInt64(0), toByteOffset: StatsRing.latestOffset, as: UInt64.self)
+            base.storeBytes(of: StatsRing.magic, as: UInt32.self)
+        }
+
+        deinit {
+            munmap(base, StatsRing.fileSize)
+        }
+
+        /// Whether an app read the ring recently enough to be worth a snapshot.
+        var hasReader: Bool {
+            let heartbeat = base.load(fromByteOffset: StatsRing.heartbeatOffset, as: CFAbsoluteTime.self)
+            return CFAbsoluteTimeGetCurrent() - heartbeat < StatsRing.readerTimeout
+        }
+
+        func publish(_ stats: StatsResponse) {
+            guard let payload = try? JSONEncoder().encode(stats),
+                  payload.count <= StatsRing.slotCapacity else { return }
+            let next = published &+ 1
+            let slot = base + StatsRing.headerSize + Int(next % UInt64(StatsRing.slotCount)) * StatsRing.slotStride
+            let sequence = slot.load(as: UInt64.self) | 1
+            let publishedAt = CFAbsoluteTimeGetCurrent()
+
+            slot.storeBytes(of: sequence, as: UInt64.self)
+            let sum = payload.withUnsafeBytes { bytes -> UInt32 in
+                (slot + StatsRing.slotHeaderSize).copyMemory(from: bytes.baseAddress!, byteCount: bytes.count)
+                return StatsRing.checksum(publishedAt: publishedAt, payload: bytes)
+            }
+            slot.storeBytes(of: UInt32(payload.count), toByteOffset: 8, as: UInt32.self)
+            slot.storeBytes(of: sum, toByteOffset: 12, as: UInt32.self)
+            slot.storeBytes(of: publishedAt, toByteOffset: 16, as: CFAbsoluteTime.self)
+            slot.storeBytes(of: sequence &+ 1, as: UInt64.self)
+
+            base.storeBytes(of: next, toByteOffset: StatsRing.latestOffset, as: UInt64.self)
+            published = next
+        }
+
+        /// Called on tunnel stop so readers fall back at once rather than after `maxAge`.
+        func clear() {
+            base.storeBytes(of: UInt64(0), toByteOffset: StatsRing.latestOffset, as: UInt64.self)
+        }
+    }
+
+    // MARK: - Reader
+
+    /// Used by the app's stats polling; maps lazily, since the file appears with the tunnel.
+    final class Reader {
+        private var base: UnsafeMutableRawPointer?
+
+        init() {}
+
+        deinit {
+            if let base { munmap(base, StatsRing.fileSize) }
+        }
+
+        /// The newest published snapshot, or nil when there is none, it is stale, or a
+        /// write raced the copy.
+        func read() -> StatsResponse? {
+            guard let base = base ?? StatsRing.map(create: false) else { return nil }
+            self.base = base
+            let now = CFAbsoluteTimeGetCurrent()
+            base.storeBytes(of: now, toByteOffset: StatsRing.heartbeatOffset, as: CFAbsoluteTime.self)
+
+            guard base.load(as: UInt32.self) == StatsRing.magic else { return nil }
+            let latest = base.load(fromByteOffset: StatsRing.latestOffset, as: UInt64.self)
+            guard latest > 0 else { return nil }
+            let slot = UnsafeRawPointer(base + StatsRing.headerSize + Int(latest % UInt64(StatsRing.slotCount)) * StatsRing.slotStride)
+
+            let before = slot.load(as: UInt64.self)
+            guard before & 1 == 0 else { return nil }
+            let length = Int(slot.load(fromByteOffset: 8, as: UInt32.self))
+            let sum = slot.load(fromByteOffset: 12, as: UInt32.self)
+            let publishedAt = slot.load(fromByteOffset: 16, as: CFAbsoluteTime.self)
+            guard length <= StatsRing.slotCapacity, now - publishedAt < StatsRing.maxAge else { return nil }
+            let payload = Data(bytes: slot + StatsRing.slotHeaderSize, count: length)
+            guard slot.load(as: UInt64.self) == before,
+                  payload.withUnsafeBytes({ StatsRing.checksum(publishedAt: publishedAt, payload: $0) }) == sum
+            else { return nil }
+            return try? JSONDecoder().decode(StatsResponse.self, from: payload)
+        }
+    }
+}
@@ -49,12 +49,21 @@ nonisolated func nwHost(fromIPLiteral ip: String) -> NWEndpoint.Host? {
     return IPv4Address(ip).map { .ipv4($0) }
 }
 
+/// Network-order bytes of an IPv4/IPv6 literal, comparable across text spellings.
+nonisolated func ipAddressBytes(fromIPLiteral ip: String) -> Data? {
+    switch nwHost(fromIPLiteral: ip) {
+    case .ipv4(let address): return address.rawValue
+    case .ipv6(let address): return address.rawValue
+    default: return nil
+    }
+}
+
 // MARK: - NWTCPTransport
 
 /// A TCP transport over `NWConnection`. All callbacks and state mutations run on
 /// the serial `queue`; `state` is additionally lock-protected so `isTransportReady`
 /// and `forceCancel()` are safe from any thread.
-nonisolated final class NWTCPTransport: RawTransport, @unchecked Sendable {
+nonisolated final class NWTCPTransport: TCPDialTransport, @unchecked Sendable {
 
     enum State {
         case setup
@@ -68,7 +77,14 @@ nonisolated final class NWTCPTransport: RawTransport, @unchecked Sendable {
     /// Per-attempt connect timeout (seconds).
     private static let connectTimeout: Int = 16
 
-    private static let maxReceiveLength = 65535
+    /// Bounds for the adaptive receive size: a bulk downlink that keeps filling its
+    /// receives grows toward `maxReceiveLength` so each callback carries more; a flow whose
+    /// deliveries stay small (interactive) shrinks back toward `minReceiveLength`.
+    private static let minReceiveLength = TuningProfile.current.minReceiveLength
+    private static let initialReceiveLength = TuningProfile.current.initialReceiveLength
+    private static let maxReceiveLength = TuningProfile.current.maxReceiveLength
+    /// Consecutive deliveries under a quarter of the receive size before it halves.
+    private static let receiveShrinkAfter = 8
 
     // MARK: State
 
@@ -115,6 +131,14 @@ nonisolated final class NWTCPTransport: RawTransport, @unchecked Sendable {
     /// Latched on remote half-close; later receives return EOF immediately.
     private var receivedEOF = false
 
+    /// Current `maximumLength` for `NWConnection.receive`; adapted on `queue`.
+    private var receiveLength = NWTCPTransport.initialReceiveLength
+    private var shortReceiveRun = 0
+
+    /// Network-order bytes of the address Happy Eyeballs settled on. Written on `queue`
+    /// before the connect completion fires and never after, so readers past it need no lock.
+    private(set) var remoteAddress: Data?
+
     // MARK: - Lifecycle
 
     init() {}
@@ -130,7 +154,7 @@ nonisolated final class NWTCPTransport: RawTransport, @unchecked Sendable {
     /// directly when it's an IP literal) and races addresses (Happy Eyeballs);
     /// `initialData` is sent once ready. `completion` fires on `queue`.
     func connect(host: String, port: UInt16,
-                 initialData: Data? = nil,
+                 initialData: Data?,
                  completion: @escaping (Error?) -> Void) {
         queue.async { [self] in
             if case .cancelled = state {
@@ -182,6 +206,38 @@ nonisolated final class NWTCPTransport: RawTransport, @unchecked Sendable {
         }
     }
 
+    /// Ordered send of a multi-segment chain as one batched write; each segment goes to
+    /// `NWConnection` as-is rather than being joined first.
+    func send(chain: ByteChain, completion: @escaping (Error?) -> Void) {
+        guard chain.segments.count > 1 else {
+            send(data: chain.flattened(), completion: completion)
+            return
+        }
+        queue.async { [self] in
+            switch state {
+            case .ready:
+                guard let connection else {
+                    completion(TransportError.notConnected)
+                    return
+                }
+                let segments = chain.segments
+                connection.batch {
+                    // A failed segment fails every later one too, so the last reports for all.
+                    for segment in segments.dropLast() {
+                        connection.send(content: segment, completion: .idempotent)
+                    }
+                    connection.send(content: segments[segments.count - 1], completion: .contentProcessed { error in
+                        completion(error.map { mapNWError($0, op: .send) })
+                    })
+                }
+            case .failed(let error):
+                completion(error)
+            default:
+                completion(TransportError.notConnected)
+            }
+        }
+    }
+
     /// Fire-and-forget send.
     func send(data: Data) {
         queue.async { [self] in
@@ -219,7 +275,7 @@ nonisolated final class NWTCPTransport: RawTransport, @unchecked Sendable {
             }
             pendingReceiveCompletion = completion
             connection.receive(minimumIncompleteLength: 1,
-                               maximumLength: Self.maxReceiveLength) { [weak self] data, _, isComplete, error in
+                               maximumLength: receiveLength) { [weak self] data, _, isComplete, error in
                 self?.handleReceive(data: data, isComplete: isComplete, error: error)
             }
         }
@@ -317,6 +373,14 @@ nonisolated final class NWTCPTransport: RawTransport, @unchecked Sendable {
 
         dialTimer.stop()
 
+        if case .hostPort(let host, _)? = connection?.currentPath?.remoteEndpoint {
+            switch host {
+            case .ipv4(let address): remoteAddress = address.rawValue
+            case .ipv6(let address): remoteAddress = address.rawValue
+            default: break
+            }
+        }
+
         // Send initial data before the completion so it precedes any caller send
         // issued from the completion (NWConnection preserves send order).
         if let data = pendingInitialData, !data.isEmpty, let connection {
@@ -400,6 +464,7 @@ nonisolated final class NWTCPTransport: RawTransport, @unchecked Sendable {
         }
 
         if let data, !data.isEmpty {
+            adaptReceiveLength(delivered: data.count)
             // Final segment may arrive with data; deliver it now and latch EOF
             // so the next receive returns end-of-stream.
             if isComplete { receivedEOF = true }
@@ -423,11 +488,28 @@ nonisolated final class NWTCPTransport: RawTransport, @unchecked Sendable {
             return
         }
         connection.receive(minimumIncompleteLength: 1,
-                           maximumLength: Self.maxReceiveLength) { [weak self] data, _, isComplete, error in
+                           maximumLength: receiveLength) { [weak self] data, _, isComplete, error in
             self?.handleReceive(data: data, isComplete: isComplete, error: error)
         }
     }
 
+    /// A delivery that filled the receive means more was already queued, so the next one
+    /// asks for twice as much; a run of small ones halves it. Must run on `queue`.
+    private func adaptReceiveLength(delivered count: Int) {
+        if count >= receiveLength {
+            receiveLength = min(receiveLength * 2, Self.maxReceiveLength)
+            shortReceiveRun = 0
+        } else if count < receiveLength / 4 {
+            shortReceiveRun += 1
+            if shortReceiveRun >= Self.receiveShrinkAfter {
+                receiveLength = max(receiveLength / 2, Self.minReceiveLength)
+                shortReceiveRun = 0
+            }
+        } else {
+            shortReceiveRun = 0
+        }
+    }
+
     // MARK: - State transitions
 
     /// Transitions only from `.setup`, keeping `.cancelled` sticky. Returns
@@ -16,7 +16,7 @@ nonisolated private let logger = AnywhereLogger(category: "NWUDPTransport")
 /// transitions run on the internal `queue`; `send`, `startReceiving`, and `cancel`
 /// are safe from any thread. Datagrams arriving before `startReceiving` arms a
 /// handler are buffered (bounded) and flushed when it does.
-nonisolated final class NWUDPTransport: @unchecked Sendable {
+nonisolated final class NWUDPTransport: UDPDialTransport, @unchecked Sendable {
 
     enum State {
         case setup
@@ -263,6 +263,26 @@ nonisolated final class NWUDPTransport: @unchecked Sendable {
         }
     }
 
+    /// Sends `datagrams` in order as one `NWConnection` batch. `completion` fires once, when
+    /// the last has been processed; like any UDP send, an earlier loss goes unreported.
+    func send(batch datagrams: [Data], completion: @escaping (Error?) -> Void) {
+        queue.async { [weak self] in
+            guard let self else { completion(TransportError.notConnected); return }
+            guard case .ready = self.state, let connection = self.connection, let last = datagrams.last else {
+                completion(datagrams.isEmpty ? nil : TransportError.notConnected)
+                return
+            }
+            connection.batch {
+                for datagram in datagrams.dropLast() {
+                    connection.send(content: datagram, completion: .idempotent)
+                }
+                connection.send(content: last, completion: .contentProcessed { error in
+                    completion(error.map { mapNWError($0, op: .send) })
+                })
+            }
+        }
+    }
+
     // MARK: - Cancel
 
     /// Latches cancelled state and tears down on `queue`. Safe from any thread;
@@ -12,9 +12,10 @@ import Dispatch
 
 // MARK: - QUICDatagramCarrier
 
-/// The direct UDP carrier for ngtcp2, backed by a connected `NWConnection.udp`.
-/// I/O runs inline on `queue` (ngtcp2 is single-threaded). Path identity is owned
-/// by `QUICConnection`, so this 4-tuple is cosmetic — `connect` fills a family `ANY`.
+/// The direct UDP carrier for ngtcp2, backed by a connected `NWConnection.udp`, or by a
+/// connected BSD socket when ``DialTransports/useSockets`` is on. I/O runs inline on
+/// `queue` (ngtcp2 is single-threaded). Path identity is owned by `QUICConnection`, so
+/// this 4-tuple is cosmetic — `connect` fills a family `ANY`.
 nonisolated final class QUICDatagramCarrier: @unchecked Sendable {
 
     private typealias QUICError = QUICConnection.QUICError
@@ -23,6 +24,13 @@ nonisolated final class QUICDatagramCarrier: @unchecked Sendable {
 
     private var connection: NWConnection?
 
+    /// Chosen once per carrier, so a migration target matches the carrier it replaces.
+    private let usesSocket = DialTransports.useSockets
+    private var socketFD: Int32 = -1
+    private var readSource: DispatchSourceRead?
+    /// One datagram's worth of receive space, reused across reads; freed with the socket.
+    private var receiveSlab: UnsafeMutableRawPointer?
+
     private var packetHandler: ((Data) -> Void)?
     /// Fires once with the `errno` on terminal failure.
     private var recvErrorHandler: ((Int32) -> Void)?
@@ -40,15 +48,26 @@ nonisolated final class QUICDatagramCarrier: @unchecked Sendable {
     var onReady: (() -> Void)?
 
     private var ready = false
-    /// Guards against double-arming the receive loop.
+    /// Guards against double-arming the receive loops.
     private var receiving = false
 
+    /// Receives kept in flight at once. A burst that lands together completes as
+    /// back-to-back blocks on `queue`, so the owner's coalesced flush runs once
+    /// after the whole burst has been read instead of once per datagram.
+    private static let receiveDepth = 8
+
+    /// Datagrams read per socket wakeup before yielding `queue`; the level-triggered
+    /// source fires again for whatever is left.
+    private static let socketReadBudget = 64
+    private static let socketSlabSize = 65_536
+
     init(queue: DispatchQueue) {
         self.queue = queue
     }
 
     /// The egress interface type in use, or nil before `.ready`. Lets the owner
     /// confirm a migration target is a *different* interface. Read on `queue`.
+    /// Always nil on a socket carrier, which has no path monitor to migrate on.
     var currentInterfaceType: NWInterface.InterfaceType? {
         connection?.currentPath?.availableInterfaces.first?.type
     }
@@ -64,6 +83,10 @@ nonisolated final class QUICDatagramCarrier: @unchecked Sendable {
             throw QUICError.connectionFailed("invalid remote address")
         }
         Self.fillAnyLocalAddr(&localAddr, family: remoteAddr.ss_family)
+        if usesSocket {
+            try connectSocket(remoteAddr)
+            return
+        }
 
         let connection = NWConnection(to: endpoint, using: .udp)
         self.connection = connection
@@ -90,6 +113,48 @@ nonisolated final class QUICDatagramCarrier: @unchecked Sendable {
         connection.start(queue: queue)
     }
 
+    /// Opens a non-blocking UDP socket connected to `remoteAddr`. A connected UDP socket
+    /// is usable at once, so readiness is reported on the next `queue` turn, after the
+    /// owner has installed `onReady`. Must run on `queue`.
+    private func connectSocket(_ remoteAddr: sockaddr_storage) throws {
+        let fd = Darwin.socket(Int32(remoteAddr.ss_family), SOCK_DGRAM, IPPROTO_UDP)
+        guard fd >= 0 else {
+            throw QUICError.connectionFailed("socket: \(String(cString: strerror(errno)))")
+        }
+        let flags = fcntl(fd, F_GETFL)
+        _ = fcntl(fd, F_SETFL, flags | O_NONBLOCK)
+        var remote = remoteAddr
+        let length = socklen_t(Int32(remoteAddr.ss_family) == AF_INET
+            ? MemoryLayout<sockaddr_in>.size : MemoryLayout<sockaddr_in6>.size)
+        let rc = withUnsafePointer(to: &remote) {
+            $0.withMemoryRebound(to: sockaddr.self, capacity: 1) { Darwin.connect(fd, $0, length) }
+        }
+        guard rc == 0 else {
+            let code = errno
+            Darwin.close(fd)
+            throw QUICError.connectionFailed("connect: \(String(cString: strerror(code)))")
+        }
+
+        let slab = UnsafeMutableRawPointer.allocate(byteCount: Self.socketSlabSize, alignment: 16)
+        let source = DispatchSource.makeReadSource(fileDescriptor: fd, queue: queue)
+        source.setEventHandler { [weak self] in
+            self?.drainSocket(fd)
+        }
+        source.setCancelHandler {
+            Darwin.close(fd)
+            slab.deallocate()
+        }
+        socketFD = fd
+        readSource = source
+        receiveSlab = slab
+        ready = true
+        queue.async { [weak self] in
+            guard let self, self.socketFD == fd, let onReady = self.onReady else { return }
+            self.onReady = nil
+            onReady()
+        }
+    }
+
     /// Tracks readiness and arms the receive loop once ready. Stale callbacks from
     /// a superseded connection are ignored. Must run on `queue`.
     private func handleState(_ state: NWConnection.State, for connection: NWConnection) {
@@ -99,7 +164,7 @@ nonisolated final class QUICDatagramCarrier: @unchecked Sendable {
             ready = true
             if packetHandler != nil, !receiving {
                 receiving = true
-                receiveLoop(connection)
+                armReceiveLoops(connection)
             }
             if let onReady {
                 self.onReady = nil
@@ -127,8 +192,20 @@ nonisolated final class QUICDatagramCarrier: @unchecked Sendable {
             onError(pendingError)
             return
         }
-        if ready, let connection, !receiving {
-            receiving = true
+        if ready, !receiving {
+            if let readSource {
+                receiving = true
+                readSource.activate()
+            } else if let connection {
+                receiving = true
+                armReceiveLoops(connection)
+            }
+        }
+    }
+
+    /// Starts `receiveDepth` independent receive loops. Must run on `queue`.
+    private func armReceiveLoops(_ connection: NWConnection) {
+        for _ in 0..<Self.receiveDepth {
             receiveLoop(connection)
         }
     }
@@ -151,10 +228,38 @@ nonisolated final class QUICDatagramCarrier: @unchecked Sendable {
         }
     }
 
-    /// Maps an `NWError` to an `errno` and delivers it once, or latches it until
-    /// `startReceiving` arms the handler. Must run on `queue`.
+    /// Reads queued datagrams straight into `receiveSlab` until the socket runs dry or
+    /// the budget is spent. Darwin has no public `recvmmsg`, so batching here means one
+    /// wakeup per burst rather than one syscall per burst. Must run on `queue`.
+    private func drainSocket(_ fd: Int32) {
+        guard let slab = receiveSlab else { return }
+        var budget = Self.socketReadBudget
+        while budget > 0, socketFD == fd {
+            let count = Darwin.recv(fd, slab, Self.socketSlabSize, 0)
+            if count > 0 {
+                budget -= 1
+                packetHandler?(Data(bytes: slab, count: count))
+                continue
+            }
+            if count == 0 { budget -= 1; continue }
+            let code = errno
+            if code == EINTR { continue }
+            if code != EAGAIN, code != EWOULDBLOCK {
+                deliverErrno(code)
+            }
+            return
+        }
+    }
+
+    /// Maps an `NWError` to an `errno` and delivers it via ``deliverErrno(_:)``.
     private func deliverError(_ error: NWError) {
         let code: Int32 = { if case .posix(let posix) = error { return posix.rawValue }; return -1 }()
+        deliverErrno(code)
+    }
+
+    /// Delivers `code` once, or latches it until `startReceiving` arms the handler.
+    /// Must run on `queue`.
+    private func deliverErrno(_ code: Int32) {
         if let handler = recvErrorHandler {
             recvErrorHandler = nil
             handler(code)
@@ -168,11 +273,49 @@ nonisolated final class QUICDatagramCarrier: @unchecked Sendable {
     /// Sends `length` bytes; errors drop the packet (ngtcp2's loss recovery
     /// retransmits). Copies out of ngtcp2's reused buffer. Must run on `queue`.
     func send(_ bytes: UnsafePointer<UInt8>, length: Int) {
+        if socketFD >= 0 {
+            sendSocket(bytes, length: length)
+            return
+        }
         guard let connection, length > 0 else { return }
         let datagram = Data(bytes: bytes, count: length)
         connection.send(content: datagram, completion: .idempotent)
     }
 
+    /// Sends back-to-back datagrams packed in `bytes` (one entry in `lengths` per datagram)
+    /// as a single `NWConnection` batch. The run is copied once; each datagram is a slice
+    /// of that copy. Must run on `queue`.
+    func sendBatch(_ bytes: UnsafePointer<UInt8>, lengths: [Int]) {
+        if socketFD >= 0 {
+            var offset = 0
+            for length in lengths {
+                sendSocket(bytes + offset, length: length)
+                offset += length
+            }
+            return
+        }
+        guard let connection, !lengths.isEmpty else { return }
+        if lengths.count == 1 {
+            send(bytes, length: lengths[0])
+            return
+        }
+        let run = Data(bytes: bytes, count: lengths.reduce(0, +))
+        connection.batch {
+            var offset = 0
+            for length in lengths where length > 0 {
+                connection.send(content: run[offset..<offset + length], completion: .idempotent)
+                offset += length
+            }
+        }
+    }
+
+    /// Sends one datagram straight from ngtcp2's buffer, no copy. A full socket buffer
+    /// (`EAGAIN`, `ENOBUFS`) or any other error drops it like a lost packet.
+    private func sendSocket(_ bytes: UnsafePointer<UInt8>, length: Int) {
+        guard length > 0 else { return }
+        while Darwin.send(socketFD, bytes, length, 0) < 0, errno == EINTR {}
+    }
+
     // MARK: - Close
 
     /// Cancels the connection. Idempotent; must run on `queue`.
@@ -182,6 +325,15 @@ nonisolated final class QUICDatagramCarrier: @unchecked Sendable {
             connection.stateUpdateHandler = nil
             connection.cancel()
         }
+        if let readSource {
+            self.readSource = nil
+            // The cancel handler closes the fd and frees the slab; an inactive source only
+            // runs it once activated.
+            readSource.cancel()
+            if !receiving { readSource.activate() }
+            socketFD = -1
+            receiveSlab = nil
+        }
         packetHandler = nil
         recvErrorHandler = nil
         onPathDown = nil
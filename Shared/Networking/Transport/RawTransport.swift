@@ -22,6 +22,79 @@ protocol RawTransport: AnyObject {
     func forceCancel()
 }
 
+// MARK: - TCPDialTransport
+
+/// A ``RawTransport`` that dials a proxy leg itself. ``DialTransports/tcp()`` picks the
+/// implementation: ``NWTCPTransport`` by default, ``SocketTCPTransport`` when opted in.
+protocol TCPDialTransport: RawTransport {
+    /// Times the dial for the live "Dial" stat.
+    var dialTimer: MetricTimer { get set }
+
+    /// Network-order bytes of the connected peer address, once ready.
+    var remoteAddress: Data? { get }
+
+    /// `initialData` is sent once connected, ahead of any send issued from `completion`.
+    func connect(host: String, port: UInt16, initialData: Data?, completion: @escaping (Error?) -> Void)
+
+    func send(chain: ByteChain, completion: @escaping (Error?) -> Void)
+}
+
+extension TCPDialTransport {
+    func connect(host: String, port: UInt16, completion: @escaping (Error?) -> Void) {
+        connect(host: host, port: port, initialData: nil, completion: completion)
+    }
+}
+
+// MARK: - UDPDialTransport
+
+/// A connected UDP transport. ``DialTransports/udp()`` picks the implementation:
+/// ``NWUDPTransport`` by default, ``SocketUDPTransport`` when opted in.
+protocol UDPDialTransport: AnyObject {
+    var isReady: Bool { get }
+
+    func connect(host: String, port: UInt16,
+                 completionQueue: DispatchQueue,
+                 completion: @escaping (Error?) -> Void)
+
+    func startReceiving(queue handlerQueue: DispatchQueue?,
+                        handler: @escaping (Data) -> Void,
+                        errorHandler: ((Error) -> Void)?)
+
+    func send(data: Data)
+
+    func send(data: Data, completion: @escaping (Error?) -> Void)
+
+    func send(batch datagrams: [Data], completion: @escaping (Error?) -> Void)
+
+    func cancel()
+}
+
+extension UDPDialTransport {
+    func startReceiving(handler: @escaping (Data) -> Void,
+                        errorHandler: ((Error) -> Void)? = nil) {
+        startReceiving(queue: nil, handler: handler, errorHandler: errorHandler)
+    }
+}
+
+// MARK: - DialTransports
+
+/// Chooses the socket layer under proxy legs and direct UDP flows. Network.framework is
+/// the default; the BSD socket backends exist to be benchmarked against it on bulk and
+/// high packet-rate traffic.
+nonisolated enum DialTransports {
+    /// Loaded from ``AWCore/getSocketTransportEnabled()`` when the tunnel starts; read on
+    /// every dial.
+    nonisolated(unsafe) static var useSockets = false
+
+    static func tcp() -> any TCPDialTransport {
+        useSockets ? SocketTCPTransport() : NWTCPTransport()
+    }
+
+    static func udp() -> any UDPDialTransport {
+        useSockets ? SocketUDPTransport() : NWUDPTransport()
+    }
+}
+
 // MARK: - TransportError
 
 enum TransportError: Error, LocalizedError {
@@ -0,0 +1,595 @@
+//
+//  SocketTCPTransport.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import Darwin
+
+nonisolated private let logger = AnywhereLogger(category: "SocketTCPTransport")
+
+// MARK: - SocketTCPTransport
+
+/// A TCP transport over a non-blocking BSD socket, the opt-in alternative to
+/// ``NWTCPTransport`` (see ``DialTransports``). Readiness comes from kqueue-backed dispatch
+/// sources on one serial `queue`, which owns all state; `state` is additionally
+/// lock-protected so `isTransportReady` and `forceCancel()` are safe from any thread.
+///
+/// Sends go out as one vectored `sendmsg` over every queued buffer, with no per-send
+/// object; a receive sizes its `Data` from `FIONREAD` and reads into it directly. The
+/// address list comes from ``DNSResolver`` and is tried in order, without Happy Eyeballs
+/// racing, and the connection doesn't follow path changes the way `NWConnection` does.
+nonisolated final class SocketTCPTransport: TCPDialTransport, @unchecked Sendable {
+
+    enum State {
+        case setup
+        case ready
+        case failed(Error)
+        case cancelled
+    }
+
+    // MARK: Constants
+
+    /// Whole-dial budget across every resolved address (seconds).
+    private static let connectTimeout: TimeInterval = 16
+    /// Per-address budget while later addresses remain to try.
+    private static let attemptTimeout: TimeInterval = 4
+
+    private static let maxReceiveLength = TuningProfile.current.maxReceiveLength
+    /// Queued buffers one `sendmsg` gathers.
+    private static let maxIOVecs = 64
+
+    // MARK: State
+
+    private let stateLock = UnfairLock()
+    private var _state: State = .setup
+
+    var state: State {
+        stateLock.withLock { _state }
+    }
+
+    var isTransportReady: Bool {
+        if case .ready = state { return true }
+        return false
+    }
+
+    /// Serial queue for every socket event and state transition.
+    private let queue = DispatchQueue(label: AWCore.Identifier.socketTCPTransportQueue,
+                                      qos: .userInitiated,
+                                      autoreleaseFrequency: .workItem)
+
+    private var fd: Int32 = -1
+    private var readSource: DispatchSourceRead?
+    private var writeSource: DispatchSourceWrite?
+    /// Dispatch sources are created active and suspended while unneeded; a suspended source
+    /// must be resumed before it is cancelled.
+    private var readArmed = false
+    private var writeArmed = false
+    /// The write source signals connect completion until the socket is connected.
+    private var connecting = false
+
+    var dialTimer = MetricTimer(.dial)
+
+    /// Written on `queue` before the connect completion fires and never after.
+    private(set) var remoteAddress: Data?
+
+    // MARK: Connect pipeline
+
+    private var connectCompletion: ((Error?) -> Void)?
+    private var pendingInitialData: Data?
+    private var addresses: [String] = []
+    private var port: UInt16 = 0
+    private var dialDeadline: TimeInterval = 0
+    /// Bumped per attempt so a stale attempt timeout is ignored.
+    private var attemptGeneration = 0
+    private var connectingAddress = ""
+
+    // MARK: Receive / send pipeline
+
+    private var pendingReceiveCompletion: ((Data?, Bool, Error?) -> Void)?
+    private var receivedEOF = false
+
+    /// Buffers not yet fully written, oldest first; `offset` is how much already went out.
+    private var sendQueue: [(data: Data, offset: Int, completion: ((Error?) -> Void)?)] = []
+
+    init() {}
+
+    deinit {
+        closeSocket()
+    }
+
+    // MARK: - Connect
+
+    /// Resolves `host` off the tunnel via ``DNSResolver`` (IP literals pass through) and
+    /// tries each address in turn. `completion` fires on `queue`.
+    func connect(host: String, port: UInt16,
+                 initialData: Data?,
+                 completion: @escaping (Error?) -> Void) {
+        queue.async { [self] in
+            if case .cancelled = state {
+                completion(TransportError.connectionFailed("Cancelled"))
+                return
+            }
+            let resolved = DNSResolver.shared.resolveAll(host)
+            guard !resolved.isEmpty else {
+                finishConnect(TransportError.resolutionFailed(host), completion: completion)
+                return
+            }
+            addresses = resolved
+            self.port = port
+            pendingInitialData = initialData
+            connectCompletion = completion
+            dialTimer.start()
+            dialDeadline = MonotonicClock.now + Self.connectTimeout
+            attemptNext(lastErrno: ECONNREFUSED)
+        }
+    }
+
+    /// Dials the next address, or fails the connect with the last attempt's `errno`.
+    /// Must run on `queue`.
+    private func attemptNext(lastErrno: Int32) {
+        guard case .setup = state, connectCompletion != nil else { return }
+        let now = MonotonicClock.now
+        guard !addresses.isEmpty, now < dialDeadline else {
+            finishConnect(TransportError.posixError(.connect, errno: now < dialDeadline ? lastErrno : ETIMEDOUT))
+            return
+        }
+        let address = addresses.removeFirst()
+        guard var storage = Self.socketAddress(address, port: port) else {
+            attemptNext(lastErrno: EADDRNOTAVAIL)
+            return
+        }
+
+        let socketFD = socket(Int32(storage.ss_family), SOCK_STREAM, IPPROTO_TCP)
+        guard socketFD >= 0 else {
+            attemptNext(lastErrno: errno)
+            return
+        }
+        Self.configure(socketFD)
+        fd = socketFD
+        openSources()
+
+        let result = withUnsafePointer(to: &storage) { pointer in
+            pointer.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+                Darwin.connect(socketFD, $0, socklen_t(storage.ss_len))
+            }
+        }
+        if result == 0 {
+            connectDidSucceed(address: address)
+            return
+        }
+        let code = errno
+        guard code == EINPROGRESS else {
+            closeSocket()
+            attemptNext(lastErrno: code)
+            return
+        }
+
+        attemptGeneration += 1
+        let generation = attemptGeneration
+        connectingAddress = address
+        connecting = true
+        armWrite()
+
+        let budget = addresses.isEmpty ? dialDeadline - now : min(Self.attemptTimeout, dialDeadline - now)
+        queue.asyncAfter(deadline: .now() + budget) { [weak self] in
+            guard let self, self.connecting, self.attemptGeneration == generation else { return }
+            self.connecting = false
+            self.closeSocket()
+            self.attemptNext(lastErrno: ETIMEDOUT)
+        }
+    }
+
+    /// The in-progress connect resolved one way or the other. Must run on `queue`.
+    private func connectWritable() {
+        connecting = false
+        attemptGeneration += 1
+        disarmWrite()
+        var error: Int32 = 0
+        var length = socklen_t(MemoryLayout<Int32>.size)
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length)
+        if error == 0 {
+            connectDidSucceed(address: connectingAddress)
+        } else {
+            closeSocket()
+            attemptNext(lastErrno: error)
+        }
+    }
+
+    /// Promotes to `.ready`, queues `initialData` ahead of any caller send, and fires the
+    /// connect completion. Must run on `queue`.
+    private func connectDidSucceed(address: String) {
+        stateLock.withLock {
+            if case .setup = _state { _state = .ready }
+        }
+        guard case .ready = state else { return }
+        dialTimer.stop()
+        remoteAddress = ipAddressBytes(fromIPLiteral: address)
+        addresses.removeAll()
+
+        if let data = pendingInitialData, !data.isEmpty {
+            enqueueSend(data, completion: nil)
+        }
+        pendingInitialData = nil
+
+        let completion = connectCompletion
+        connectCompletion = nil
+        completion?(nil)
+    }
+
+    /// Fails the connect once, unless a racing `forceCancel()` already latched `.cancelled`
+    /// (teardown then fires the completion). Must run on `queue`.
+    private func finishConnect(_ error: Error, completion: ((Error?) -> Void)? = nil) {
+        stateLock.withLock {
+            if case .setup = _state { _state = .failed(error) }
+        }
+        guard case .failed = state else { return }
+        logger.debug("[TCP] socket connect failed: \(error.localizedDescription)")
+        closeSocket()
+        let pending = completion ?? connectCompletion
+        connectCompletion = nil
+        pending?(error)
+    }
+
+    // MARK: - Send
+
+    func send(data: Data, completion: @escaping (Error?) -> Void) {
+        queue.async { [self] in
+            switch state {
+            case .ready:
+                enqueueSend(data, completion: completion)
+            case .failed(let error):
+                completion(error)
+            default:
+                completion(TransportError.notConnected)
+            }
+        }
+    }
+
+    func send(data: Data) {
+        queue.async { [self] in
+            guard case .ready = state else { return }
+            enqueueSend(data, completion: nil)
+        }
+    }
+
+    /// Every segment joins the send queue as-is and goes out in the same `sendmsg`; the
+    /// last segment reports for the chain.
+    func send(chain: ByteChain, completion: @escaping (Error?) -> Void) {
+        queue.async { [self] in
+            switch state {
+            case .ready:
+                let segments = chain.segments
+                guard !segments.isEmpty else {
+                    completion(nil)
+                    return
+                }
+                for segment in segments.dropLast() {
+                    enqueueSend(segment, completion: nil)
+                }
+                enqueueSend(segments[segments.count - 1], completion: completion)
+            case .failed(let error):
+                completion(error)
+            default:
+                completion(TransportError.notConnected)
+            }
+        }
+    }
+
+    /// Must run on `queue`.
+    private func enqueueSend(_ data: Data, completion: ((Error?) -> Void)?) {
+        guard !data.isEmpty else {
+            if sendQueue.isEmpty {
+                completion?(nil)
+            } else {
+                sendQueue.append((data, 0, completion))
+            }
+            return
+        }
+        sendQueue.append((data, 0, completion))
+        // While the write source is armed the socket is full; its event drains the queue.
+        if !writeArmed {
+            flushSends()
+        }
+    }
+
+    /// Writes as much of the queue as the socket takes, arming the write source on
+    /// `EAGAIN`. Must run on `queue`.
+    private func flushSends() {
+        while !sendQueue.isEmpty {
+            var iovecs: [iovec] = []
+            iovecs.reserveCapacity(min(sendQueue.count, Self.maxIOVecs))
+            let written: Int = withIOVecs(from: 0, into: &iovecs) { iovecs in
+                iovecs.withUnsafeMutableBufferPointer { buffer in
+                    var message = msghdr()
+                    message.msg_iov = buffer.baseAddress
+                    message.msg_iovlen = Int32(buffer.count)
+                    return Darwin.sendmsg(fd, &message, 0)
+                }
+            }
+            if written < 0 {
+                let code = errno
+                if code == EINTR { continue }
+                if code == EAGAIN {
+                    armWrite()
+                    return
+                }
+                failActive(with: TransportError.posixError(.send, errno: code))
+                return
+            }
+            consumeSent(written)
+        }
+        disarmWrite()
+    }
+
+    /// Pins each queued buffer's bytes for the duration of `body`, one nested
+    /// `withUnsafeBytes` per buffer. Must run on `queue`.
+    private func withIOVecs<R>(from index: Int, into iovecs: inout [iovec], _ body: (inout [iovec]) -> R) -> R {
+        guard index < sendQueue.count, index < Self.maxIOVecs else { return body(&iovecs) }
+        let entry = sendQueue[index]
+        return entry.data.withUnsafeBytes { raw in
+            let remaining = raw.count - entry.offset
+            if remaining > 0, let base = raw.baseAddress {
+                iovecs.append(iovec(iov_base: UnsafeMutableRawPointer(mutating: base + entry.offset),
+                                    iov_len: remaining))
+            }
+            return withIOVecs(from: index + 1, into: &iovecs, body)
+        }
+    }
+
+    /// Pops fully written buffers, completing each, and advances a partial one.
+    /// Must run on `queue`.
+    private func consumeSent(_ written: Int) {
+        var remaining = written
+        while let first = sendQueue.first {
+            let left = first.data.count - first.offset
+            if remaining < left {
+                sendQueue[0].offset += remaining
+                return
+            }
+            remaining -= left
+            sendQueue.removeFirst()
+            first.completion?(nil)
+        }
+    }
+
+    // MARK: - Receive
+
+    /// Receives once. Completion: `(data, false, nil)` on data,
+    /// `(nil, true, nil)` on EOF, `(nil, true, error)` on failure.
+    func receive(completion: @escaping (Data?, Bool, Error?) -> Void) {
+        queue.async { [self] in
+            if receivedEOF {
+                completion(nil, true, nil)
+                return
+            }
+            switch state {
+            case .ready:
+                break
+            case .failed(let error):
+                completion(nil, true, error)
+                return
+            case .cancelled, .setup:
+                completion(nil, true, TransportError.notConnected)
+                return
+            }
+            guard pendingReceiveCompletion == nil else {
+                completion(nil, true, TransportError.receiveFailed("Concurrent receive"))
+                return
+            }
+            pendingReceiveCompletion = completion
+            performRead()
+        }
+    }
+
+    /// Reads what the socket holds straight into a buffer sized from `FIONREAD` that the
+    /// returned `Data` then owns, or arms the read source when it holds nothing.
+    /// Must run on `queue`.
+    private func performRead() {
+        guard let completion = pendingReceiveCompletion else {
+            disarmRead()
+            return
+        }
+        var available: Int32 = 0
+        if ioctl(fd, FIONREAD, &available) != 0 { available = 0 }
+        // Zero still reads: it tells end-of-stream and errors apart from "nothing yet".
+        let length = min(max(Int(available), 1), Self.maxReceiveLength)
+        guard let buffer = malloc(length) else {
+            failActive(with: TransportError.posixError(.receive, errno: ENOMEM))
+            return
+        }
+        let count = Darwin.recv(fd, buffer, length, 0)
+
+        if count > 0 {
+            let data = Data(bytesNoCopy: buffer, count: count, deallocator: .free)
+            pendingReceiveCompletion = nil
+            disarmRead()
+            completion(data, false, nil)
+            return
+        }
+        free(buffer)
+        if count == 0 {
+            receivedEOF = true
+            pendingReceiveCompletion = nil
+            disarmRead()
+            completion(nil, true, nil)
+        } else {
+            let code = errno
+            if code == EAGAIN || code == EINTR {
+                armRead()
+                return
+            }
+            failActive(with: TransportError.posixError(.receive, errno: code))
+        }
+    }
+
+    // MARK: - Sources
+
+    /// Creates both sources for the new `fd`, suspended. Must run on `queue`.
+    private func openSources() {
+        let read = DispatchSource.makeReadSource(fileDescriptor: fd, queue: queue)
+        read.setEventHandler { [weak self] in self?.performRead() }
+        read.activate()
+        read.suspend()
+        readSource = read
+
+        let write = DispatchSource.makeWriteSource(fileDescriptor: fd, queue: queue)
+        write.setEventHandler { [weak self] in
+            guard let self else { return }
+            if self.connecting {
+                self.connectWritable()
+            } else {
+                self.flushSends()
+            }
+        }
+        write.activate()
+        write.suspend()
+        writeSource = write
+    }
+
+    private func armRead() {
+        guard !readArmed, let readSource else { return }
+        readArmed = true
+        readSource.resume()
+    }
+
+    private func disarmRead() {
+        guard readArmed, let readSource else { return }
+        readArmed = false
+        readSource.suspend()
+    }
+
+    private func armWrite() {
+        guard !writeArmed, let writeSource else { return }
+        writeArmed = true
+        writeSource.resume()
+    }
+
+    private func disarmWrite() {
+        guard writeArmed, let writeSource else { return }
+        writeArmed = false
+        writeSource.suspend()
+    }
+
+    // MARK: - Failure / teardown
+
+    /// Moves to `.failed` and fails the in-flight receive and queued sends. Must run on `queue`.
+    private func failActive(with error: Error) {
+        let changed: Bool = stateLock.withLock {
+            if case .ready = _state { _state = .failed(error); return true }
+            return false
+        }
+        guard changed else { return }
+        failPending(with: error)
+        closeSocket()
+    }
+
+    private func failPending(with error: Error) {
+        if let completion = pendingReceiveCompletion {
+            pendingReceiveCompletion = nil
+            completion(nil, true, error)
+        }
+        let sends = sendQueue
+        sendQueue.removeAll()
+        for entry in sends {
+            entry.completion?(error)
+        }
+    }
+
+    /// Safe from any thread; latches `.cancelled` synchronously, then tears down on `queue`.
+    func forceCancel() {
+        let shouldTearDown: Bool = stateLock.withLock {
+            if case .cancelled = _state { return false }
+            _state = .cancelled
+            return true
+        }
+        guard shouldTearDown else { return }
+        queue.async { [self] in
+            attemptGeneration += 1
+            if let completion = connectCompletion {
+                connectCompletion = nil
+                completion(TransportError.connectionFailed("Cancelled"))
+            }
+            failPending(with: TransportError.notConnected)
+            closeSocket()
+        }
+    }
+
+    /// Cancels the sources (resuming suspended ones first, as dispatch requires) and closes
+    /// the descriptor once both cancellation handlers have run, never while a source may
+    /// still be watching it. Must run on `queue`.
+    private func closeSocket() {
+        connecting = false
+        let socketFD = fd
+        fd = -1
+        let sources: [(source: DispatchSourceProtocol, armed: Bool)] =
+            [readSource.map { ($0, readArmed) }, writeSource.map { ($0, writeArmed) }].compactMap { $0 }
+        readSource = nil
+        writeSource = nil
+        readArmed = false
+        writeArmed = false
+        guard socketFD >= 0 else { return }
+        guard !sources.isEmpty else {
+            Darwin.close(socketFD)
+            return
+        }
+        var outstanding = sources.count
+        for (source, armed) in sources {
+            source.setCancelHandler {
+                outstanding -= 1
+                if outstanding == 0 { Darwin.close(socketFD) }
+            }
+            if !armed { source.resume() }
+            source.cancel()
+        }
+    }
+
+    // MARK: - Socket setup
+
+    /// Non-blocking, no SIGPIPE, and the same Nagle/keepalive tuning as ``NWTCPTransport``.
+    private static func configure(_ fd: Int32) {
+        _ = fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK)
+        var on: Int32 = 1
+        let size = socklen_t(MemoryLayout<Int32>.size)
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, size)
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, size)
+        setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, size)
+        var idle: Int32 = 30
+        var interval: Int32 = 10
+        var count: Int32 = 3
+        setsockopt(fd, IPPROTO_TCP, TCP_KEEPALIVE, &idle, size)
+        setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval, size)
+        setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &count, size)
+    }
+
+    /// A `sockaddr_in`/`sockaddr_in6` for an IP literal, in a `sockaddr_storage`.
+    static func socketAddress(_ ip: String, port: UInt16) -> sockaddr_storage? {
+        var storage = sockaddr_storage()
+        if ip.contains(":") {
+            var address = in6_addr()
+            guard inet_pton(AF_INET6, ip, &address) == 1 else { return nil }
+            withUnsafeMutablePointer(to: &storage) { pointer in
+                pointer.withMemoryRebound(to: sockaddr_in6.self, capacity: 1) { sin6 in
+                    sin6.pointee.sin6_len = UInt8(MemoryLayout<sockaddr_in6>.size)
+                    sin6.pointee.sin6_family = sa_family_t(AF_INET6)
+                    sin6.pointee.sin6_port = port.bigEndian
+                    sin6.pointee.sin6_addr = address
+                }
+            }
+        } else {
+            var address = in_addr()
+            guard inet_pton(AF_INET, ip, &address) == 1 else { return nil }
+            withUnsafeMutablePointer(to: &storage) { pointer in
+                pointer.withMemoryRebound(to: sockaddr_in.self, capacity: 1) { sin in
+                    sin.pointee.sin_len = UInt8(MemoryLayout<sockaddr_in>.size)
+                    sin.pointee.sin_family = sa_family_t(AF_INET)
+                    sin.pointee.sin_port = port.bigEndian
+                    sin.pointee.sin_addr = address
+                }
+            }
+        }
+        return storage
+    }
+}
@@ -0,0 +1,277 @@
+//
+//  SocketUDPTransport.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import Darwin
+
+nonisolated private let logger = AnywhereLogger(category: "SocketUDPTransport")
+
+// MARK: - SocketUDPTransport
+
+/// UDP over a connected, non-blocking BSD socket, the opt-in alternative to
+/// ``NWUDPTransport`` (see ``DialTransports``). All state lives on the serial `queue`;
+/// `state` is additionally lock-protected so `isReady` and `cancel()` are safe from any
+/// thread.
+///
+/// A level-triggered read source drains every queued datagram per wakeup, up to a
+/// budget, through one reused slab, and hands the run to the handler queue in one hop.
+/// Sends go straight to the socket with no per-datagram object. Darwin has no public
+/// `sendmmsg`/`recvmmsg`, so a batch is one syscall per datagram but a single queue
+/// turn. The first address from ``DNSResolver`` is used, and the socket doesn't follow
+/// path changes the way `NWConnection` does.
+nonisolated final class SocketUDPTransport: UDPDialTransport, @unchecked Sendable {
+
+    enum State {
+        case setup
+        case ready
+        case cancelled
+    }
+
+    // MARK: Constants
+
+    /// Datagrams read per wakeup before yielding `queue`; the source fires again for the rest.
+    private static let readBudget = 64
+    private static let slabSize = 65_536
+
+    // MARK: State
+
+    private let stateLock = UnfairLock()
+    private var _state: State = .setup
+
+    private var state: State {
+        stateLock.withLock { _state }
+    }
+
+    var isReady: Bool {
+        if case .ready = state { return true }
+        return false
+    }
+
+    /// Serial queue for every socket event and state transition.
+    private let queue = DispatchQueue(label: AWCore.Identifier.socketUDPTransportQueue,
+                                      qos: .userInitiated,
+                                      autoreleaseFrequency: .workItem)
+
+    private var fd: Int32 = -1
+    /// Created inactive; activated by `startReceiving`, so datagrams wait in the socket
+    /// buffer until a handler is armed.
+    private var readSource: DispatchSourceRead?
+    private var receiving = false
+    private var slab: UnsafeMutableRawPointer?
+
+    // MARK: Receive
+
+    private var receiveHandler: ((Data) -> Void)?
+    private var receiveErrorHandler: ((Error) -> Void)?
+    private var receiveHandlerQueue: DispatchQueue?
+
+    init() {}
+
+    deinit {
+        closeSocket()
+    }
+
+    // MARK: - Connect
+
+    /// Resolves `host` off the tunnel via ``DNSResolver`` (IP literals pass through) and
+    /// connects the socket, which is usable at once.
+    func connect(host: String, port: UInt16,
+                 completionQueue: DispatchQueue,
+                 completion: @escaping (Error?) -> Void) {
+        queue.async { [self] in
+            let error = openSocket(host: host, port: port)
+            completionQueue.async { completion(error) }
+        }
+    }
+
+    /// Must run on `queue`.
+    private func openSocket(host: String, port: UInt16) -> Error? {
+        guard case .setup = state else { return TransportError.connectionFailed("Cancelled") }
+        guard let address = DNSResolver.shared.resolveAll(host).first else {
+            return TransportError.resolutionFailed(host)
+        }
+        guard var storage = SocketTCPTransport.socketAddress(address, port: port) else {
+            return TransportError.posixError(.connect, errno: EADDRNOTAVAIL)
+        }
+        let socketFD = socket(Int32(storage.ss_family), SOCK_DGRAM, IPPROTO_UDP)
+        guard socketFD >= 0 else { return TransportError.posixError(.connect, errno: errno) }
+        _ = fcntl(socketFD, F_SETFL, fcntl(socketFD, F_GETFL) | O_NONBLOCK)
+        var on: Int32 = 1
+        setsockopt(socketFD, SOL_SOCKET, SO_NOSIGPIPE, &on, socklen_t(MemoryLayout<Int32>.size))
+        let result = withUnsafePointer(to: &storage) { pointer in
+            pointer.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+                Darwin.connect(socketFD, $0, socklen_t(storage.ss_len))
+            }
+        }
+        guard result == 0 else {
+            let code = errno
+            Darwin.close(socketFD)
+            return TransportError.posixError(.connect, errno: code)
+        }
+
+        let promoted: Bool = stateLock.withLock {
+            if case .setup = _state { _state = .ready; return true }
+            return false
+        }
+        guard promoted else {
+            Darwin.close(socketFD)
+            return TransportError.connectionFailed("Cancelled")
+        }
+        fd = socketFD
+        let buffer = UnsafeMutableRawPointer.allocate(byteCount: Self.slabSize, alignment: 16)
+        slab = buffer
+        let source = DispatchSource.makeReadSource(fileDescriptor: socketFD, queue: queue)
+        source.setEventHandler { [weak self] in self?.drain() }
+        source.setCancelHandler {
+            Darwin.close(socketFD)
+            buffer.deallocate()
+        }
+        readSource = source
+        return nil
+    }
+
+    // MARK: - Receive
+
+    /// Handler fires on `handlerQueue`, or `queue` if nil. `errorHandler` fires once on a
+    /// terminal receive failure; the source then stops.
+    func startReceiving(queue handlerQueue: DispatchQueue?,
+                        handler: @escaping (Data) -> Void,
+                        errorHandler: ((Error) -> Void)?) {
+        queue.async { [self] in
+            receiveHandler = handler
+            receiveErrorHandler = errorHandler
+            receiveHandlerQueue = handlerQueue
+            guard case .ready = state, let readSource, !receiving else { return }
+            receiving = true
+            readSource.activate()
+        }
+    }
+
+    /// Reads until the socket runs dry or the budget is spent, then delivers the run.
+    /// Must run on `queue`.
+    private func drain() {
+        guard let slab, let handler = receiveHandler else { return }
+        var datagrams: [Data] = []
+        var failure: Int32?
+        while datagrams.count < Self.readBudget {
+            let count = Darwin.recv(fd, slab, Self.slabSize, 0)
+            if count >= 0 {
+                if count > 0 { datagrams.append(Data(bytes: slab, count: count)) }
+                continue
+            }
+            let code = errno
+            if code == EINTR { continue }
+            if code != EAGAIN && code != EWOULDBLOCK { failure = code }
+            break
+        }
+        if !datagrams.isEmpty {
+            if let handlerQueue = receiveHandlerQueue {
+                handlerQueue.async { for datagram in datagrams { handler(datagram) } }
+            } else {
+                for datagram in datagrams { handler(datagram) }
+            }
+        }
+        if let failure {
+            surfaceTerminalError(TransportError.posixError(.receive, errno: failure))
+        }
+    }
+
+    /// Closes the socket and delivers a terminal error at most once. Must run on `queue`.
+    private func surfaceTerminalError(_ error: Error) {
+        closeSocket()
+        guard let handler = receiveErrorHandler else { return }
+        receiveErrorHandler = nil
+        receiveHandler = nil
+        logger.debug("[UDP] socket receive failed: \(error.localizedDescription)")
+        if let handlerQueue = receiveHandlerQueue {
+            handlerQueue.async { handler(error) }
+        } else {
+            handler(error)
+        }
+    }
+
+    // MARK: - Send
+
+    func send(data: Data) {
+        queue.async { [self] in
+            guard case .ready = state else { return }
+            _ = write(data)
+        }
+    }
+
+    func send(data: Data, completion: @escaping (Error?) -> Void) {
+        queue.async { [self] in
+            guard case .ready = state else {
+                completion(TransportError.notConnected)
+                return
+            }
+            completion(write(data))
+        }
+    }
+
+    /// Writes `datagrams` in order in one queue turn; `completion` reports the last, as a
+    /// lost earlier datagram would go unreported anyway.
+    func send(batch datagrams: [Data], completion: @escaping (Error?) -> Void) {
+        queue.async { [self] in
+            guard case .ready = state else {
+                completion(datagrams.isEmpty ? nil : TransportError.notConnected)
+                return
+            }
+            var error: Error?
+            for datagram in datagrams {
+                error = write(datagram)
+            }
+            completion(error)
+        }
+    }
+
+    /// One `send` straight from `data`'s bytes. A full socket buffer drops the datagram,
+    /// like any other UDP loss. Must run on `queue`.
+    private func write(_ data: Data) -> Error? {
+        guard fd >= 0 else { return TransportError.notConnected }
+        guard !data.isEmpty else { return nil }
+        let sent: Int = data.withUnsafeBytes { raw in
+            var result: Int
+            repeat {
+                result = Darwin.send(fd, raw.baseAddress, raw.count, 0)
+            } while result < 0 && errno == EINTR
+            return result
+        }
+        return sent < 0 ? TransportError.posixError(.send, errno: errno) : nil
+    }
+
+    // MARK: - Cancel
+
+    /// Latches cancelled state and tears down on `queue`. Safe from any thread;
+    /// idempotent.
+    func cancel() {
+        let shouldTearDown: Bool = stateLock.withLock {
+            if case .cancelled = _state { return false }
+            _state = .cancelled
+            return true
+        }
+        guard shouldTearDown else { return }
+        queue.async { [self] in
+            receiveHandler = nil
+            receiveErrorHandler = nil
+            receiveHandlerQueue = nil
+            closeSocket()
+        }
+    }
+
+    /// Cancels the read source, whose cancel handler closes the descriptor and frees the
+    /// slab; an inactive source runs it only once activated.
+    private func closeSocket() {
+        guard let readSource else { return }
+        self.readSource = nil
+        readSource.cancel()
+        if !receiving { readSource.activate() }
+        receiving = false
+        fd = -1
+        slab = nil
+    }
+}
@@ -0,0 +1,75 @@
+//
+//  TuningProfile.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Buffer sizes and concurrency the data path is sized to, per platform. The iPhone
+/// profile fits the extension's ~50 MB jetsam limit on battery and cellular; Apple TV is
+/// wired, mains-powered and streams 4K, so it trades memory for larger receives, windows
+/// and more warm connections. lwIP's `TCP_WND` / `TCP_SND_BUF` make the same split at
+/// compile time (`port/lwipopts.h`).
+nonisolated struct TuningProfile {
+    let name: String
+
+    /// Bounds for ``NWTCPTransport``'s adaptive receive size; the maximum also caps one
+    /// ``SocketTCPTransport`` read.
+    let minReceiveLength: Int
+    let initialReceiveLength: Int
+    let maxReceiveLength: Int
+
+    /// Process-wide cap on TCP connections' Swift-side buffers (``TCPBufferGovernor``).
+    let tcpBufferBudget: Int
+    /// Bytes one UDP flow holds while its outbound dials.
+    let udpPendingBufferSize: Int
+    /// Hard ceiling on concurrent UDP flows.
+    let udpMaxFlows: Int
+
+    /// Stream window XHTTP advertises in its HTTP/2 SETTINGS, and the ceiling
+    /// ``H2WindowTuner`` may grow a window to.
+    let h2StreamWindowSize: Int
+    let h2WindowLimit: Int
+
+    /// Most connections ``PreDialPool`` keeps dialed ahead of demand for one outbound.
+    let preDialMaxWarm: Int
+
+    static let iPhone = TuningProfile(
+        name: "iPhone",
+        minReceiveLength: 16 * 1024,
+        initialReceiveLength: 64 * 1024,
+        maxReceiveLength: 256 * 1024,
+        tcpBufferBudget: 24 * 1024 * 1024,
+        udpPendingBufferSize: 256 * 1024,
+        udpMaxFlows: 256,
+        h2StreamWindowSize: 4 * 1024 * 1024,
+        h2WindowLimit: 16 * 1024 * 1024,
+        preDialMaxWarm: 4
+    )
+
+    static let appleTV = TuningProfile(
+        name: "Apple TV",
+        minReceiveLength: 32 * 1024,
+        initialReceiveLength: 128 * 1024,
+        maxReceiveLength: 1024 * 1024,
+        tcpBufferBudget: 48 * 1024 * 1024,
+        udpPendingBufferSize: 1024 * 1024,
+        udpMaxFlows: 512,
+        h2StreamWindowSize: 8 * 1024 * 1024,
+        h2WindowLimit: 32 * 1024 * 1024,
+        preDialMaxWarm: 8
+    )
+
+    /// Fixed per process by the platform it was built for; `PacketTunnelProvider` logs it
+    /// at tunnel start. Resolved on first read, so it is settled before the stack's
+    /// governor and UDP shards size themselves.
+    static let current: TuningProfile = {
+#if os(tvOS)
+        return .appleTV
+#else
+        return .iPhone
+#endif
+    }()
+}
@@ -36,4 +36,10 @@
 /* No debug output */
 /* #undef DEBUGBUILD */
 
+/* Skip-list fan-out: a client holds tens of streams and in-flight packets,
+   not a server's thousands, so blocks of at most 16 keys keep each linear
+   in-block search within a few cache lines. Upstream default is 16 (32 keys).
+   Honoured by the carried patch in ngtcp2_ksl.h; see UPSTREAM_MAP.md. */
+#define NGTCP2_KSL_DEGR 8
+
 #endif /* NGTCP2_CONFIG_H */
@@ -0,0 +1,610 @@
+//
+//  ngtcp2_apple_aead.c
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+#include "ngtcp2_apple_aead.h"
+
+#include <string.h>
+
+/* Counter blocks are encrypted in batches so one CCCryptorUpdate call covers
+ * a full-size QUIC packet. */
+#define GCM_BATCH_BLOCKS 16
+
+static uint64_t load64_be(const uint8_t *p) {
+  return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) |
+         ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+         ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) |
+         ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
+static void store64_be(uint8_t *p, uint64_t v) {
+  p[0] = (uint8_t)(v >> 56);
+  p[1] = (uint8_t)(v >> 48);
+  p[2] = (uint8_t)(v >> 40);
+  p[3] = (uint8_t)(v >> 32);
+  p[4] = (uint8_t)(v >> 24);
+  p[5] = (uint8_t)(v >> 16);
+  p[6] = (uint8_t)(v >> 8);
+  p[7] = (uint8_t)v;
+}
+
+static uint32_t load32_le(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static void store32_le(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static void store64_le(uint8_t *p, uint64_t v) {
+  store32_le(p, (uint32_t)v);
+  store32_le(p + 4, (uint32_t)(v >> 32));
+}
+
+static int ecb_encrypt(CCCryptorRef ecb, const uint8_t *in, uint8_t *out,
+                       size_t len) {
+  size_t moved = 0;
+  if (CCCryptorUpdate(ecb, in, len, out, len, &moved) != kCCSuccess ||
+      moved != len) {
+    return -1;
+  }
+  return 0;
+}
+
+/* --- GHASH ---
+ *
+ * Blocks are loaded big-endian into two 64-bit words, which leaves each
+ * GF(2^128) element bit-reflected: the coefficient of x^i is bit 127 - i.
+ * The product is three carry-less 64x64 multiplies (Karatsuba) on the PMULL
+ * (ARMv8 Crypto Extensions) or PCLMULQDQ unit, so no step indexes memory by
+ * secret data and every block takes the same time. */
+
+#if defined(__aarch64__) || defined(__arm64__)
+/* Every Apple arm64 target (A7 onwards) has the Crypto Extensions enabled. */
+#  if !defined(__ARM_FEATURE_AES) && !defined(__ARM_FEATURE_CRYPTO)
+#    error "AES-GCM needs the ARMv8 Crypto Extensions for PMULL"
+#  endif
+#  include <arm_neon.h>
+
+static inline void
+clmul64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo) {
+  uint64x2_t p = vreinterpretq_u64_p128(vmull_p64((poly64_t)a, (poly64_t)b));
+  *lo = vgetq_lane_u64(p, 0);
+  *hi = vgetq_lane_u64(p, 1);
+}
+#elif defined(__x86_64__)
+#  include <wmmintrin.h>
+
+__attribute__((target("pclmul,sse2"))) static inline void
+clmul64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo) {
+  __m128i p = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)a),
+                                   _mm_cvtsi64_si128((long long)b), 0x00);
+  *lo = (uint64_t)_mm_cvtsi128_si64(p);
+  *hi = (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(p, p));
+}
+#else
+#  error "AES-GCM needs a carry-less multiply instruction (PMULL or PCLMULQDQ)"
+#endif
+
+/* x = x * H */
+static void gcm_mult(const ngtcp2_apple_gcm *gcm, uint8_t x[16]) {
+  uint64_t xh = load64_be(x), xl = load64_be(x + 8);
+  uint64_t p3, p2, p1, p0, mh, ml, t;
+  uint64_t z3, z2, z1, z0;
+
+  clmul64(xh, gcm->hh, &p3, &p2);
+  clmul64(xl, gcm->hl, &p1, &p0);
+  clmul64(xh ^ xl, gcm->hh ^ gcm->hl, &mh, &ml);
+  /* Karatsuba: the middle term is (xh + xl)(hh + hl) - xh*hh - xl*hl. */
+  mh ^= p3 ^ p1;
+  ml ^= p2 ^ p0;
+  p2 ^= mh;
+  p1 ^= ml;
+
+  /* The reflected product is one bit short of the true one; shift it up. */
+  z3 = (p3 << 1) | (p2 >> 63);
+  z2 = (p2 << 1) | (p1 >> 63);
+  z1 = (p1 << 1) | (p0 >> 63);
+  z0 = p0 << 1;
+
+  /* z3:z2 holds x^0..x^127 and z1:z0 x^128..x^255. Fold the high half down
+   * with x^128 = x^7 + x^2 + x + 1: multiplying by x^s is a right shift by s
+   * here, and the bits shifted out of z0 are x^128.. once more, folded the
+   * same way. */
+  t = (z0 << 63) ^ (z0 << 62) ^ (z0 << 57);
+  z3 ^= z1 ^ (z1 >> 1) ^ (z1 >> 2) ^ (z1 >> 7);
+  z2 ^= z0 ^ ((z0 >> 1) | (z1 << 63)) ^ ((z0 >> 2) | (z1 << 62)) ^
+        ((z0 >> 7) | (z1 << 57));
+  z3 ^= t ^ (t >> 1) ^ (t >> 2) ^ (t >> 7);
+
+  store64_be(x, z3);
+  store64_be(x + 8, z2);
+}
+
+static void ghash_update(const ngtcp2_apple_gcm *gcm, uint8_t y[16],
+                         const uint8_t *data, size_t len) {
+  size_t i;
+
+  while (len >= 16) {
+    for (i = 0; i < 16; ++i) {
+      y[i] ^= data[i];
+    }
+    gcm_mult(gcm, y);
+    data += 16;
+    len -= 16;
+  }
+
+  if (len) {
+    for (i = 0; i < len; ++i) {
+      y[i] ^= data[i];
+    }
+    gcm_mult(gcm, y);
+  }
+}
+
+/* Computes the tag over aad/ciphertext into `tag`. */
+static int gcm_tag(const ngtcp2_apple_gcm *gcm, uint8_t tag[16],
+                   const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN],
+                   const uint8_t *ciphertext, size_t ciphertextlen,
+                   const uint8_t *aad, size_t aadlen) {
+  uint8_t y[16] = {0};
+  uint8_t lens[16];
+  uint8_t j0[16];
+  uint8_t ekj0[16];
+  size_t i;
+
+  ghash_update(gcm, y, aad, aadlen);
+  ghash_update(gcm, y, ciphertext, ciphertextlen);
+  store64_be(lens, (uint64_t)aadlen * 8);
+  store64_be(lens + 8, (uint64_t)ciphertextlen * 8);
+  ghash_update(gcm, y, lens, sizeof(lens));
+
+  memcpy(j0, nonce, NGTCP2_APPLE_AEAD_NONCELEN);
+  j0[12] = 0;
+  j0[13] = 0;
+  j0[14] = 0;
+  j0[15] = 1;
+  if (ecb_encrypt(gcm->ecb, j0, ekj0, sizeof(j0)) != 0) {
+    return -1;
+  }
+
+  for (i = 0; i < 16; ++i) {
+    tag[i] = y[i] ^ ekj0[i];
+  }
+  return 0;
+}
+
+/* XORs the CTR keystream starting at counter 2 (J0 + 1) into `in`. */
+static int gcm_ctr(const ngtcp2_apple_gcm *gcm, uint8_t *out,
+                   const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN],
+                   const uint8_t *in, size_t len) {
+  uint8_t ctrblk[GCM_BATCH_BLOCKS * 16];
+  uint8_t ks[GCM_BATCH_BLOCKS * 16];
+  uint32_t counter = 2;
+  size_t nblocks, n, i;
+
+  while (len) {
+    nblocks = (len + 15) / 16;
+    if (nblocks > GCM_BATCH_BLOCKS) {
+      nblocks = GCM_BATCH_BLOCKS;
+    }
+
+    for (i = 0; i < nblocks; ++i, ++counter) {
+      uint8_t *blk = &ctrblk[i * 16];
+      memcpy(blk, nonce, NGTCP2_APPLE_AEAD_NONCELEN);
+      blk[12] = (uint8_t)(counter >> 24);
+      blk[13] = (uint8_t)(counter >> 16);
+      blk[14] = (uint8_t)(counter >> 8);
+      blk[15] = (uint8_t)counter;
+    }
+
+    if (ecb_encrypt(gcm->ecb, ctrblk, ks, nblocks * 16) != 0) {
+      return -1;
+    }
+
+    n = nblocks * 16;
+    if (n > len) {
+      n = len;
+    }
+    for (i = 0; i < n; ++i) {
+      out[i] = in[i] ^ ks[i];
+    }
+
+    in += n;
+    out += n;
+    len -= n;
+  }
+
+  return 0;
+}
+
+int ngtcp2_apple_gcm_init(ngtcp2_apple_gcm *gcm, const uint8_t *key,
+                          size_t keylen) {
+  static const uint8_t zero[16] = {0};
+  uint8_t h[16];
+
+  gcm->ecb = NULL;
+  if (CCCryptorCreateWithMode(kCCEncrypt, kCCModeECB, kCCAlgorithmAES,
+                              ccNoPadding, NULL, key, keylen, NULL, 0, 0, 0,
+                              &gcm->ecb) != kCCSuccess) {
+    gcm->ecb = NULL;
+    return -1;
+  }
+
+  if (ecb_encrypt(gcm->ecb, zero, h, sizeof(h)) != 0) {
+    ngtcp2_apple_gcm_free(gcm);
+    return -1;
+  }
+
+  gcm->hh = load64_be(h);
+  gcm->hl = load64_be(h + 8);
+  return 0;
+}
+
+void ngtcp2_apple_gcm_free(ngtcp2_apple_gcm *gcm) {
+  if (gcm->ecb) {
+    CCCryptorRelease(gcm->ecb);
+    gcm->ecb = NULL;
+  }
+}
+
+int ngtcp2_apple_gcm_seal(const ngtcp2_apple_gcm *gcm, uint8_t *dest,
+                          const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN],
+                          const uint8_t *plaintext, size_t plaintextlen,
+                          const uint8_t *aad, size_t aadlen) {
+  if (gcm_ctr(gcm, dest, nonce, plaintext, plaintextlen) != 0) {
+    return -1;
+  }
+  return gcm_tag(gcm, dest + plaintextlen, nonce, dest, plaintextlen, aad,
+                 aadlen);
+}
+
+int ngtcp2_apple_gcm_open(const ngtcp2_apple_gcm *gcm, uint8_t *dest,
+                          const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN],
+                          const uint8_t *ciphertext, size_t ciphertextlen,
+                          const uint8_t *aad, size_t aadlen) {
+  uint8_t tag[16];
+  uint8_t diff = 0;
+  size_t payloadlen, i;
+
+  if (ciphertextlen < NGTCP2_APPLE_AEAD_TAGLEN) {
+    return -1;
+  }
+  payloadlen = ciphertextlen - NGTCP2_APPLE_AEAD_TAGLEN;
+
+  if (gcm_tag(gcm, tag, nonce, ciphertext, payloadlen, aad, aadlen) != 0) {
+    return -1;
+  }
+  for (i = 0; i < NGTCP2_APPLE_AEAD_TAGLEN; ++i) {
+    diff |= tag[i] ^ ciphertext[payloadlen + i];
+  }
+  if (diff) {
+    return -1;
+  }
+
+  return gcm_ctr(gcm, dest, nonce, ciphertext, payloadlen);
+}
+
+/* --- ChaCha20 --- */
+
+#define CHACHA_ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define CHACHA_QR(a, b, c, d)                                                  \
+  do {                                                                         \
+    a += b;                                                                    \
+    d ^= a;                                                                    \
+    d = CHACHA_ROTL(d, 16);                                                    \
+    c += d;                                                                    \
+    b ^= c;                                                                    \
+    b = CHACHA_ROTL(b, 12);                                                    \
+    a += b;                                                                    \
+    d ^= a;                                                                    \
+    d = CHACHA_ROTL(d, 8);                                                     \
+    c += d;                                                                    \
+    b ^= c;                                                                    \
+    b = CHACHA_ROTL(b, 7);                                                     \
+  } while (0)
+
+static void chacha20_block(const ngtcp2_apple_chacha20 *chacha,
+                           uint32_t counter, const uint8_t nonce[12],
+                           uint8_t out[64]) {
+  uint32_t in[16], x[16];
+  size_t i;
+
+  in[0] = 0x61707865;
+  in[1] = 0x3320646e;
+  in[2] = 0x79622d32;
+  in[3] = 0x6b206574;
+  memcpy(&in[4], chacha->key, sizeof(chacha->key));
+  in[12] = counter;
+  in[13] = load32_le(nonce);
+  in[14] = load32_le(nonce + 4);
+  in[15] = load32_le(nonce + 8);
+
+  memcpy(x, in, sizeof(x));
+  for (i = 0; i < 10; ++i) {
+    CHACHA_QR(x[0], x[4], x[8], x[12]);
+    CHACHA_QR(x[1], x[5], x[9], x[13]);
+    CHACHA_QR(x[2], x[6], x[10], x[14]);
+    CHACHA_QR(x[3], x[7], x[11], x[15]);
+    CHACHA_QR(x[0], x[5], x[10], x[15]);
+    CHACHA_QR(x[1], x[6], x[11], x[12]);
+    CHACHA_QR(x[2], x[7], x[8], x[13]);
+    CHACHA_QR(x[3], x[4], x[9], x[14]);
+  }
+
+  for (i = 0; i < 16; ++i) {
+    store32_le(&out[i * 4], x[i] + in[i]);
+  }
+}
+
+static void chacha20_xor(const ngtcp2_apple_chacha20 *chacha, uint8_t *out,
+                         const uint8_t nonce[12], uint32_t counter,
+                         const uint8_t *in, size_t len) {
+  uint8_t ks[64];
+  size_t n, i;
+
+  while (len) {
+    chacha20_block(chacha, counter++, nonce, ks);
+    n = len < sizeof(ks) ? len : sizeof(ks);
+    for (i = 0; i < n; ++i) {
+      out[i] = in[i] ^ ks[i];
+    }
+    in += n;
+    out += n;
+    len -= n;
+  }
+}
+
+void ngtcp2_apple_chacha20_init(ngtcp2_apple_chacha20 *chacha,
+                                const uint8_t key[32]) {
+  size_t i;
+
+  for (i = 0; i < 8; ++i) {
+    chacha->key[i] = load32_le(key + i * 4);
+  }
+}
+
+void ngtcp2_apple_chacha20_hp_mask(const ngtcp2_apple_chacha20 *chacha,
+                                   uint8_t dest[5], const uint8_t sample[16]) {
+  uint8_t block[64];
+
+  chacha20_block(chacha, load32_le(sample), sample + 4, block);
+  memcpy(dest, block, 5);
+}
+
+/* --- Poly1305 (26-bit limbs) --- */
+
+typedef struct {
+  uint32_t r[5];
+  uint32_t h[5];
+  uint32_t pad[4];
+} poly1305_state;
+
+static void poly1305_init(poly1305_state *st, const uint8_t key[32]) {
+  st->r[0] = load32_le(key + 0) & 0x3ffffff;
+  st->r[1] = (load32_le(key + 3) >> 2) & 0x3ffff03;
+  st->r[2] = (load32_le(key + 6) >> 4) & 0x3ffc0ff;
+  st->r[3] = (load32_le(key + 9) >> 6) & 0x3f03fff;
+  st->r[4] = (load32_le(key + 12) >> 8) & 0x00fffff;
+
+  memset(st->h, 0, sizeof(st->h));
+
+  st->pad[0] = load32_le(key + 16);
+  st->pad[1] = load32_le(key + 20);
+  st->pad[2] = load32_le(key + 24);
+  st->pad[3] = load32_le(key + 28);
+}
+
+/* Absorbs whole 16-byte blocks. */
+static void poly1305_blocks(poly1305_state *st, const uint8_t *m,
+                            size_t len) {
+  const uint32_t hibit = 1UL << 24;
+  const uint32_t r0 = st->r[0], r1 = st->r[1], r2 = st->r[2], r3 = st->r[3],
+                 r4 = st->r[4];
+  const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+  uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3],
+           h4 = st->h[4];
+  uint64_t d0, d1, d2, d3, d4;
+  uint32_t c;
+
+  while (len >= 16) {
+    h0 += load32_le(m + 0) & 0x3ffffff;
+    h1 += (load32_le(m + 3) >> 2) & 0x3ffffff;
+    h2 += (load32_le(m + 6) >> 4) & 0x3ffffff;
+    h3 += (load32_le(m + 9) >> 6) & 0x3ffffff;
+    h4 += (load32_le(m + 12) >> 8) | hibit;
+
+    d0 = ((uint64_t)h0 * r0) + ((uint64_t)h1 * s4) + ((uint64_t)h2 * s3) +
+         ((uint64_t)h3 * s2) + ((uint64_t)h4 * s1);
+    d1 = ((uint64_t)h0 * r1) + ((uint64_t)h1 * r0) + ((uint64_t)h2 * s4) +
+         ((uint64_t)h3 * s3) + ((uint64_t)h4 * s2);
+    d2 = ((uint64_t)h0 * r2) + ((uint64_t)h1 * r1) + ((uint64_t)h2 * r0) +
+         ((uint64_t)h3 * s4) + ((uint64_t)h4 * s3);
+    d3 = ((uint64_t)h0 * r3) + ((uint64_t)h1 * r2) + ((uint64_t)h2 * r1) +
+         ((uint64_t)h3 * r0) + ((uint64_t)h4 * s4);
+    d4 = ((uint64_t)h0 * r4) + ((uint64_t)h1 * r3) + ((uint64_t)h2 * r2) +
+         ((uint64_t)h3 * r1) + ((uint64_t)h4 * r0);
+
+    c = (uint32_t)(d0 >> 26);
+    h0 = (uint32_t)d0 & 0x3ffffff;
+    d1 += c;
+    c = (uint32_t)(d1 >> 26);
+    h1 = (uint32_t)d1 & 0x3ffffff;
+    d2 += c;
+    c = (uint32_t)(d2 >> 26);
+    h2 = (uint32_t)d2 & 0x3ffffff;
+    d3 += c;
+    c = (uint32_t)(d3 >> 26);
+    h3 = (uint32_t)d3 & 0x3ffffff;
+    d4 += c;
+    c = (uint32_t)(d4 >> 26);
+    h4 = (uint32_t)d4 & 0x3ffffff;
+    h0 += c * 5;
+    c = h0 >> 26;
+    h0 &= 0x3ffffff;
+    h1 += c;
+
+    m += 16;
+    len -= 16;
+  }
+
+  st->h[0] = h0;
+  st->h[1] = h1;
+  st->h[2] = h2;
+  st->h[3] = h3;
+  st->h[4] = h4;
+}
+
+/* Absorbs `data` zero-padded to a multiple of 16, as the AEAD construction
+ * prescribes for both the AAD and the ciphertext. */
+static void poly1305_update_padded(poly1305_state *st, const uint8_t *data,
+                                   size_t len) {
+  uint8_t block[16] = {0};
+  size_t full = len & ~(size_t)15;
+
+  poly1305_blocks(st, data, full);
+  if (len > full) {
+    memcpy(block, data + full, len - full);
+    poly1305_blocks(st, block, sizeof(block));
+  }
+}
+
+static void poly1305_finish(poly1305_state *st, uint8_t mac[16]) {
+  uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3],
+           h4 = st->h[4];
+  uint32_t g0, g1, g2, g3, g4, c, mask;
+  uint64_t f;
+
+  c = h1 >> 26;
+  h1 &= 0x3ffffff;
+  h2 += c;
+  c = h2 >> 26;
+  h2 &= 0x3ffffff;
+  h3 += c;
+  c = h3 >> 26;
+  h3 &= 0x3ffffff;
+  h4 += c;
+  c = h4 >> 26;
+  h4 &= 0x3ffffff;
+  h0 += c * 5;
+  c = h0 >> 26;
+  h0 &= 0x3ffffff;
+  h1 += c;
+
+  /* g = h + -p */
+  g0 = h0 + 5;
+  c = g0 >> 26;
+  g0 &= 0x3ffffff;
+  g1 = h1 + c;
+  c = g1 >> 26;
+  g1 &= 0x3ffffff;
+  g2 = h2 + c;
+  c = g2 >> 26;
+  g2 &= 0x3ffffff;
+  g3 = h3 + c;
+  c = g3 >> 26;
+  g3 &= 0x3ffffff;
+  g4 = h4 + c - (1UL << 26);
+
+  /* Select h if h < p, else h - p, without branching. */
+  mask = (g4 >> 31) - 1;
+  g0 &= mask;
+  g1 &= mask;
+  g2 &= mask;
+  g3 &= mask;
+  g4 &= mask;
+  mask = ~mask;
+  h0 = (h0 & mask) | g0;
+  h1 = (h1 & mask) | g1;
+  h2 = (h2 & mask) | g2;
+  h3 = (h3 & mask) | g3;
+  h4 = (h4 & mask) | g4;
+
+  h0 = h0 | (h1 << 26);
+  h1 = (h1 >> 6) | (h2 << 20);
+  h2 = (h2 >> 12) | (h3 << 14);
+  h3 = (h3 >> 18) | (h4 << 8);
+
+  f = (uint64_t)h0 + st->pad[0];
+  h0 = (uint32_t)f;
+  f = (uint64_t)h1 + st->pad[1] + (f >> 32);
+  h1 = (uint32_t)f;
+  f = (uint64_t)h2 + st->pad[2] + (f >> 32);
+  h2 = (uint32_t)f;
+  f = (uint64_t)h3 + st->pad[3] + (f >> 32);
+  h3 = (uint32_t)f;
+
+  store32_le(mac + 0, h0);
+  store32_le(mac + 4, h1);
+  store32_le(mac + 8, h2);
+  store32_le(mac + 12, h3);
+}
+
+/* --- AEAD_CHACHA20_POLY1305 --- */
+
+static void chacha20_poly1305_tag(const ngtcp2_apple_chacha20 *chacha,
+                                  uint8_t tag[16],
+                                  const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN],
+                                  const uint8_t *ciphertext,
+                                  size_t ciphertextlen, const uint8_t *aad,
+                                  size_t aadlen) {
+  uint8_t block0[64];
+  uint8_t lens[16];
+  poly1305_state st;
+
+  /* The one-time Poly1305 key is the first half of keystream block 0. */
+  chacha20_block(chacha, 0, nonce, block0);
+  poly1305_init(&st, block0);
+
+  poly1305_update_padded(&st, aad, aadlen);
+  poly1305_update_padded(&st, ciphertext, ciphertextlen);
+  store64_le(lens, aadlen);
+  store64_le(lens + 8, ciphertextlen);
+  poly1305_blocks(&st, lens, sizeof(lens));
+
+  poly1305_finish(&st, tag);
+}
+
+int ngtcp2_apple_chacha20_poly1305_seal(
+    const ngtcp2_apple_chacha20 *chacha, uint8_t *dest,
+    const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN], const uint8_t *plaintext,
+    size_t plaintextlen, const uint8_t *aad, size_t aadlen) {
+  chacha20_xor(chacha, dest, nonce, 1, plaintext, plaintextlen);
+  chacha20_poly1305_tag(chacha, dest + plaintextlen, nonce, dest, plaintextlen,
+                        aad, aadlen);
+  return 0;
+}
+
+int ngtcp2_apple_chacha20_poly1305_open(
+    const ngtcp2_apple_chacha20 *chacha, uint8_t *dest,
+    const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN], const uint8_t *ciphertext,
+    size_t ciphertextlen, const uint8_t *aad, size_t aadlen) {
+  uint8_t tag[16];
+  uint8_t diff = 0;
+  size_t payloadlen, i;
+
+  if (ciphertextlen < NGTCP2_APPLE_AEAD_TAGLEN) {
+    return -1;
+  }
+  payloadlen = ciphertextlen - NGTCP2_APPLE_AEAD_TAGLEN;
+
+  chacha20_poly1305_tag(chacha, tag, nonce, ciphertext, payloadlen, aad,
+                        aadlen);
+  for (i = 0; i < NGTCP2_APPLE_AEAD_TAGLEN; ++i) {
+    diff |= tag[i] ^ ciphertext[payloadlen + i];
+  }
+  if (diff) {
+    return -1;
+  }
+
+  chacha20_xor(chacha, dest, nonce, 1, ciphertext, payloadlen);
+  return 0;
+}
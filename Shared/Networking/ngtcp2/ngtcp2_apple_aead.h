@@ -0,0 +1,82 @@
+//
+//  ngtcp2_apple_aead.h
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+#ifndef NGTCP2_APPLE_AEAD_H
+#define NGTCP2_APPLE_AEAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <CommonCrypto/CommonCrypto.h>
+
+/* Native packet-protection AEADs for the Apple crypto backend. Everything
+ * per-key (AES round keys, GHASH subkey, ChaCha20 key words) is
+ * derived once when ngtcp2 installs a key, so sealing/opening a packet never
+ * leaves C and never re-expands key material. */
+
+#define NGTCP2_APPLE_AEAD_TAGLEN 16
+#define NGTCP2_APPLE_AEAD_NONCELEN 12
+
+/* --- AES-GCM (RFC 5116 AEAD_AES_128_GCM / AEAD_AES_256_GCM) --- */
+
+typedef struct {
+  /* AES-ECB cryptor; holds the expanded key schedule for the CTR keystream
+   * and the GHASH subkey. */
+  CCCryptorRef ecb;
+  /* GHASH subkey H as big-endian words, multiplied in with PMULL/PCLMULQDQ. */
+  uint64_t hh;
+  uint64_t hl;
+} ngtcp2_apple_gcm;
+
+int ngtcp2_apple_gcm_init(ngtcp2_apple_gcm *gcm, const uint8_t *key,
+                          size_t keylen);
+
+void ngtcp2_apple_gcm_free(ngtcp2_apple_gcm *gcm);
+
+/* Writes `plaintextlen` bytes of ciphertext followed by the 16-byte tag to
+ * `dest`. `dest` may alias `plaintext`. */
+int ngtcp2_apple_gcm_seal(const ngtcp2_apple_gcm *gcm, uint8_t *dest,
+                          const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN],
+                          const uint8_t *plaintext, size_t plaintextlen,
+                          const uint8_t *aad, size_t aadlen);
+
+/* `ciphertextlen` includes the trailing tag. The tag is verified before any
+ * plaintext is written; returns -1 on mismatch. `dest` may alias
+ * `ciphertext`. */
+int ngtcp2_apple_gcm_open(const ngtcp2_apple_gcm *gcm, uint8_t *dest,
+                          const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN],
+                          const uint8_t *ciphertext, size_t ciphertextlen,
+                          const uint8_t *aad, size_t aadlen);
+
+/* --- ChaCha20 (RFC 8439) and AEAD_CHACHA20_POLY1305 --- */
+
+typedef struct {
+  /* Key as little-endian words; this is ChaCha20's entire key schedule. */
+  uint32_t key[8];
+} ngtcp2_apple_chacha20;
+
+void ngtcp2_apple_chacha20_init(ngtcp2_apple_chacha20 *chacha,
+                                const uint8_t key[32]);
+
+/* RFC 9001 section 5.4.4: the first 5 keystream bytes for the block whose
+ * counter is sample[0..3] and nonce is sample[4..15]. */
+void ngtcp2_apple_chacha20_hp_mask(const ngtcp2_apple_chacha20 *chacha,
+                                   uint8_t dest[5], const uint8_t sample[16]);
+
+/* Same contract as ngtcp2_apple_gcm_seal. */
+int ngtcp2_apple_chacha20_poly1305_seal(
+    const ngtcp2_apple_chacha20 *chacha, uint8_t *dest,
+    const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN], const uint8_t *plaintext,
+    size_t plaintextlen, const uint8_t *aad, size_t aadlen);
+
+/* Same contract as ngtcp2_apple_gcm_open. */
+int ngtcp2_apple_chacha20_poly1305_open(
+    const ngtcp2_apple_chacha20 *chacha, uint8_t *dest,
+    const uint8_t nonce[NGTCP2_APPLE_AEAD_NONCELEN], const uint8_t *ciphertext,
+    size_t ciphertextlen, const uint8_t *aad, size_t aadlen);
+
+#endif /* NGTCP2_APPLE_AEAD_H */
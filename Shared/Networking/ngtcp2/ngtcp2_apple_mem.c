@@ -0,0 +1,235 @@
+//
+//  ngtcp2_apple_mem.c
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+#include "ngtcp2_apple_mem.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Size classes 32, 64, ..., 8192 bytes. */
+#define MEM_MIN_SHIFT 5
+#define MEM_NUM_CLASSES 9
+#define MEM_MAX_SMALL ((size_t)1 << (MEM_MIN_SHIFT + MEM_NUM_CLASSES - 1))
+#define MEM_SLAB_SIZE (64 * 1024)
+#define MEM_CLASS_LARGE UINT32_MAX
+
+/* Precedes every allocation; 16 bytes keeps the payload 16-byte aligned. */
+typedef struct mem_hd {
+  uint32_t cls;
+  uint32_t pad;
+  size_t size;
+} mem_hd;
+
+/* A small chunk on its class free list reuses the payload for the link. */
+typedef struct mem_free_chunk {
+  struct mem_free_chunk *next;
+} mem_free_chunk;
+
+typedef struct mem_slab {
+  struct mem_slab *next;
+  uint8_t pad[16 - sizeof(struct mem_slab *)];
+} mem_slab;
+
+typedef struct mem_large {
+  struct mem_large *prev, *next;
+  mem_hd hd;
+} mem_large;
+
+typedef struct mem_arena {
+  /* Must stay first: callbacks get the arena back from mem.user_data. */
+  ngtcp2_mem mem;
+  mem_free_chunk *free_lists[MEM_NUM_CLASSES];
+  mem_slab *slabs;
+  mem_large *large;
+} mem_arena;
+
+static uint32_t mem_class_for(size_t size) {
+  uint32_t cls = 0;
+  size_t cap = (size_t)1 << MEM_MIN_SHIFT;
+
+  while (cap < size) {
+    cap <<= 1;
+    ++cls;
+  }
+  return cls;
+}
+
+static size_t mem_class_size(uint32_t cls) {
+  return (size_t)1 << (MEM_MIN_SHIFT + cls);
+}
+
+/* Carves a fresh slab into chunks of class |cls|. */
+static int mem_refill(mem_arena *arena, uint32_t cls) {
+  size_t stride = sizeof(mem_hd) + mem_class_size(cls);
+  mem_slab *slab = malloc(MEM_SLAB_SIZE);
+  uint8_t *p, *end;
+  mem_hd *hd;
+  mem_free_chunk *chunk;
+
+  if (slab == NULL) {
+    return -1;
+  }
+  slab->next = arena->slabs;
+  arena->slabs = slab;
+
+  p = (uint8_t *)(slab + 1);
+  end = (uint8_t *)slab + MEM_SLAB_SIZE;
+  for (; p + stride <= end; p += stride) {
+    hd = (mem_hd *)p;
+    hd->cls = cls;
+    chunk = (mem_free_chunk *)(hd + 1);
+    chunk->next = arena->free_lists[cls];
+    arena->free_lists[cls] = chunk;
+  }
+  return 0;
+}
+
+static void *mem_malloc(size_t size, void *user_data) {
+  mem_arena *arena = user_data;
+  mem_large *large;
+  mem_free_chunk *chunk;
+  mem_hd *hd;
+  uint32_t cls;
+
+  if (size > MEM_MAX_SMALL) {
+    large = malloc(sizeof(*large) + size);
+    if (large == NULL) {
+      return NULL;
+    }
+    large->hd.cls = MEM_CLASS_LARGE;
+    large->hd.size = size;
+    large->prev = NULL;
+    large->next = arena->large;
+    if (arena->large) {
+      arena->large->prev = large;
+    }
+    arena->large = large;
+    return &large->hd + 1;
+  }
+
+  cls = mem_class_for(size);
+  if (arena->free_lists[cls] == NULL && mem_refill(arena, cls) != 0) {
+    return NULL;
+  }
+  chunk = arena->free_lists[cls];
+  arena->free_lists[cls] = chunk->next;
+  hd = (mem_hd *)chunk - 1;
+  hd->size = size;
+  return chunk;
+}
+
+static void mem_free(void *ptr, void *user_data) {
+  mem_arena *arena = user_data;
+  mem_hd *hd;
+  mem_large *large;
+  mem_free_chunk *chunk;
+
+  if (ptr == NULL) {
+    return;
+  }
+
+  hd = (mem_hd *)ptr - 1;
+  if (hd->cls == MEM_CLASS_LARGE) {
+    large = (mem_large *)((uint8_t *)hd - offsetof(mem_large, hd));
+    if (large->prev) {
+      large->prev->next = large->next;
+    } else {
+      arena->large = large->next;
+    }
+    if (large->next) {
+      large->next->prev = large->prev;
+    }
+    free(large);
+    return;
+  }
+
+  chunk = ptr;
+  chunk->next = arena->free_lists[hd->cls];
+  arena->free_lists[hd->cls] = chunk;
+}
+
+static void *mem_calloc(size_t nmemb, size_t size, void *user_data) {
+  size_t total;
+  void *p;
+
+  if (size && nmemb > SIZE_MAX / size) {
+    return NULL;
+  }
+  total = nmemb * size;
+  p = mem_malloc(total, user_data);
+  if (p) {
+    memset(p, 0, total);
+  }
+  return p;
+}
+
+static void *mem_realloc(void *ptr, size_t size, void *user_data) {
+  mem_hd *hd;
+  void *p;
+  size_t oldsize;
+
+  if (ptr == NULL) {
+    return mem_malloc(size, user_data);
+  }
+  if (size == 0) {
+    mem_free(ptr, user_data);
+    return NULL;
+  }
+
+  hd = (mem_hd *)ptr - 1;
+  /* Still fits the chunk it already has. */
+  if (hd->cls != MEM_CLASS_LARGE && size <= mem_class_size(hd->cls)) {
+    hd->size = size;
+    return ptr;
+  }
+
+  oldsize = hd->size;
+  p = mem_malloc(size, user_data);
+  if (p == NULL) {
+    return NULL;
+  }
+  memcpy(p, ptr, oldsize < size ? oldsize : size);
+  mem_free(ptr, user_data);
+  return p;
+}
+
+ngtcp2_mem *ngtcp2_apple_mem_new(void) {
+  mem_arena *arena = calloc(1, sizeof(*arena));
+
+  if (arena == NULL) {
+    return NULL;
+  }
+  arena->mem.user_data = arena;
+  arena->mem.malloc = mem_malloc;
+  arena->mem.free = mem_free;
+  arena->mem.calloc = mem_calloc;
+  arena->mem.realloc = mem_realloc;
+  return &arena->mem;
+}
+
+void ngtcp2_apple_mem_del(ngtcp2_mem *mem) {
+  mem_arena *arena;
+  mem_slab *slab, *next_slab;
+  mem_large *large, *next_large;
+
+  if (mem == NULL) {
+    return;
+  }
+  arena = mem->user_data;
+
+  for (slab = arena->slabs; slab; slab = next_slab) {
+    next_slab = slab->next;
+    free(slab);
+  }
+  for (large = arena->large; large; large = next_large) {
+    next_large = large->next;
+    free(large);
+  }
+  free(arena);
+}
@@ -0,0 +1,30 @@
+//
+//  ngtcp2_apple_mem.h
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+#ifndef NGTCP2_APPLE_MEM_H
+#define NGTCP2_APPLE_MEM_H
+
+#include <ngtcp2/ngtcp2.h>
+
+/* Per-connection slab arena behind an ngtcp2_mem. Requests up to 8 KB (every
+ * frame chain, rtb entry, ksl node and objalloc block a connection makes)
+ * come from power-of-two size classes carved out of 64 KB slabs and are
+ * recycled through per-class free lists, so a long-lived session reuses the
+ * same few slabs instead of fragmenting the malloc heap. Larger requests go
+ * to malloc but are tracked, and ngtcp2_apple_mem_del releases everything in
+ * one pass.
+ *
+ * Not thread-safe: an arena belongs to one ngtcp2_conn, which is only driven
+ * from one queue. */
+
+/* Returns a new arena, or NULL on allocation failure. */
+ngtcp2_mem *ngtcp2_apple_mem_new(void);
+
+/* Frees every slab and large block. Call only after ngtcp2_conn_del. */
+void ngtcp2_apple_mem_del(ngtcp2_mem *mem);
+
+#endif /* NGTCP2_APPLE_MEM_H */
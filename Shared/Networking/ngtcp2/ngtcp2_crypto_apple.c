@@ -17,6 +17,7 @@
 
 #include "ngtcp2_macro.h"
 #include "shared.h"
+#include "ngtcp2_apple_aead.h"
 
 #include <CommonCrypto/CommonHMAC.h>
 #include <CommonCrypto/CommonCrypto.h>
@@ -65,46 +66,29 @@ typedef struct {
 static ngtcp2_apple_md md_sha256 = {NGTCP2_APPLE_MD_SHA256};
 static ngtcp2_apple_md md_sha384 = {NGTCP2_APPLE_MD_SHA384};
 
-/* --- AEAD context (stores key + cipher type) --- */
+/* --- AEAD context ---
+   AES-GCM keeps its expanded key schedule and GHASH table, ChaCha20-Poly1305
+   its key words, so every packet is sealed/opened natively. */
 
 typedef struct {
   ngtcp2_apple_aead_type type;
-  uint8_t key[32]; /* max key size */
   size_t keylen;
+  ngtcp2_apple_gcm gcm;
+  ngtcp2_apple_chacha20 chacha;
 } ngtcp2_apple_aead_ctx;
 
-/* --- Cipher context (for header protection) --- */
+/* --- Cipher context (for header protection) ---
+   AES keeps a keyed ECB cryptor so each mask is a single block encryption
+   against an already-expanded key schedule; ChaCha20 computes one keystream
+   block per mask. */
 
 typedef struct {
   ngtcp2_apple_cipher_type type;
-  uint8_t key[32];
   size_t keylen;
+  CCCryptorRef ecb;
+  ngtcp2_apple_chacha20 chacha;
 } ngtcp2_apple_hp_ctx;
 
-/* --- Swift CryptoKit callback function pointers ---
-   These are set from Swift during initialization.
-   They bridge the C crypto backend to Swift CryptoKit. */
-
-typedef int (*ngtcp2_apple_aead_encrypt_fn)(
-    uint8_t *dest, const uint8_t *key, size_t keylen, const uint8_t *nonce,
-    size_t noncelen, const uint8_t *plaintext, size_t plaintextlen,
-    const uint8_t *aad, size_t aadlen, int aead_type);
-
-typedef int (*ngtcp2_apple_aead_decrypt_fn)(
-    uint8_t *dest, const uint8_t *key, size_t keylen, const uint8_t *nonce,
-    size_t noncelen, const uint8_t *ciphertext, size_t ciphertextlen,
-    const uint8_t *aad, size_t aadlen, int aead_type);
-
-static ngtcp2_apple_aead_encrypt_fn _aead_encrypt_fn = NULL;
-static ngtcp2_apple_aead_decrypt_fn _aead_decrypt_fn = NULL;
-
-void ngtcp2_crypto_apple_set_aead_callbacks(
-    ngtcp2_apple_aead_encrypt_fn encrypt_fn,
-    ngtcp2_apple_aead_decrypt_fn decrypt_fn) {
-  _aead_encrypt_fn = encrypt_fn;
-  _aead_decrypt_fn = decrypt_fn;
-}
-
 /* --- Basic initialization functions --- */
 
 ngtcp2_crypto_aead *ngtcp2_crypto_aead_aes_128_gcm(ngtcp2_crypto_aead *aead) {
@@ -273,7 +257,20 @@ int ngtcp2_crypto_aead_ctx_encrypt_init(ngtcp2_crypto_aead_ctx *aead_ctx,
 
   ctx->type = a->type;
   ctx->keylen = ngtcp2_crypto_aead_keylen(aead);
-  memcpy(ctx->key, key, ctx->keylen);
+  ctx->gcm.ecb = NULL;
+
+  switch (ctx->type) {
+  case NGTCP2_APPLE_AEAD_AES_128_GCM:
+  case NGTCP2_APPLE_AEAD_AES_256_GCM:
+    if (ngtcp2_apple_gcm_init(&ctx->gcm, key, ctx->keylen) != 0) {
+      free(ctx);
+      return -1;
+    }
+    break;
+  case NGTCP2_APPLE_AEAD_CHACHA20_POLY1305:
+    ngtcp2_apple_chacha20_init(&ctx->chacha, key);
+    break;
+  }
 
   aead_ctx->native_handle = ctx;
   return 0;
@@ -286,8 +283,11 @@ int ngtcp2_crypto_aead_ctx_decrypt_init(ngtcp2_crypto_aead_ctx *aead_ctx,
 }
 
 void ngtcp2_crypto_aead_ctx_free(ngtcp2_crypto_aead_ctx *aead_ctx) {
-  if (aead_ctx->native_handle) {
-    free(aead_ctx->native_handle);
+  ngtcp2_apple_aead_ctx *ctx = (ngtcp2_apple_aead_ctx *)aead_ctx->native_handle;
+
+  if (ctx) {
+    ngtcp2_apple_gcm_free(&ctx->gcm);
+    free(ctx);
   }
 }
 
@@ -314,20 +314,40 @@ int ngtcp2_crypto_cipher_ctx_encrypt_init(ngtcp2_crypto_cipher_ctx *cipher_ctx,
     ctx->keylen = 32;
     break;
   }
-  memcpy(ctx->key, key, ctx->keylen);
+  ctx->ecb = NULL;
+
+  switch (c->type) {
+  case NGTCP2_APPLE_CIPHER_AES_128:
+  case NGTCP2_APPLE_CIPHER_AES_256:
+    if (CCCryptorCreateWithMode(kCCEncrypt, kCCModeECB, kCCAlgorithmAES,
+                                ccNoPadding, NULL, key, ctx->keylen, NULL, 0,
+                                0, 0, &ctx->ecb) != kCCSuccess) {
+      free(ctx);
+      return -1;
+    }
+    break;
+  case NGTCP2_APPLE_CIPHER_CHACHA20:
+    ngtcp2_apple_chacha20_init(&ctx->chacha, key);
+    break;
+  }
 
   cipher_ctx->native_handle = ctx;
   return 0;
 }
 
 void ngtcp2_crypto_cipher_ctx_free(ngtcp2_crypto_cipher_ctx *cipher_ctx) {
-  if (!cipher_ctx->native_handle) {
+  ngtcp2_apple_hp_ctx *ctx = (ngtcp2_apple_hp_ctx *)cipher_ctx->native_handle;
+
+  if (!ctx) {
     return;
   }
-  free(cipher_ctx->native_handle);
+  if (ctx->ecb) {
+    CCCryptorRelease(ctx->ecb);
+  }
+  free(ctx);
 }
 
-/* --- Encrypt/Decrypt via Swift CryptoKit callbacks --- */
+/* --- Encrypt/Decrypt --- */
 
 int ngtcp2_crypto_encrypt(uint8_t *dest, const ngtcp2_crypto_aead *aead,
                           const ngtcp2_crypto_aead_ctx *aead_ctx,
@@ -338,12 +358,22 @@ int ngtcp2_crypto_encrypt(uint8_t *dest, const ngtcp2_crypto_aead *aead,
 
   (void)aead;
 
-  if (!_aead_encrypt_fn) {
+  if (noncelen != NGTCP2_APPLE_AEAD_NONCELEN) {
     return -1;
   }
 
-  return _aead_encrypt_fn(dest, ctx->key, ctx->keylen, nonce, noncelen,
-                          plaintext, plaintextlen, aad, aadlen, (int)ctx->type);
+  switch (ctx->type) {
+  case NGTCP2_APPLE_AEAD_AES_128_GCM:
+  case NGTCP2_APPLE_AEAD_AES_256_GCM:
+    return ngtcp2_apple_gcm_seal(&ctx->gcm, dest, nonce, plaintext,
+                                 plaintextlen, aad, aadlen);
+  case NGTCP2_APPLE_AEAD_CHACHA20_POLY1305:
+    return ngtcp2_apple_chacha20_poly1305_seal(&ctx->chacha, dest, nonce,
+                                               plaintext, plaintextlen, aad,
+                                               aadlen);
+  default:
+    return -1;
+  }
 }
 
 int ngtcp2_crypto_decrypt(uint8_t *dest, const ngtcp2_crypto_aead *aead,
@@ -355,17 +385,28 @@ int ngtcp2_crypto_decrypt(uint8_t *dest, const ngtcp2_crypto_aead *aead,
 
   (void)aead;
 
-  if (!_aead_decrypt_fn) {
+  if (noncelen != NGTCP2_APPLE_AEAD_NONCELEN) {
     return -1;
   }
 
-  return _aead_decrypt_fn(dest, ctx->key, ctx->keylen, nonce, noncelen,
-                          ciphertext, ciphertextlen, aad, aadlen,
-                          (int)ctx->type);
+  switch (ctx->type) {
+  case NGTCP2_APPLE_AEAD_AES_128_GCM:
+  case NGTCP2_APPLE_AEAD_AES_256_GCM:
+    return ngtcp2_apple_gcm_open(&ctx->gcm, dest, nonce, ciphertext,
+                                 ciphertextlen, aad, aadlen);
+  case NGTCP2_APPLE_AEAD_CHACHA20_POLY1305:
+    return ngtcp2_apple_chacha20_poly1305_open(&ctx->chacha, dest, nonce,
+                                               ciphertext, ciphertextlen, aad,
+                                               aadlen);
+  default:
+    return -1;
+  }
 }
 
 /* --- Header Protection mask ---
-   AES-ECB is available in CommonCrypto's public API. */
+   AES-ECB is available in CommonCrypto's public API; the cryptor is created
+   once in ngtcp2_crypto_cipher_ctx_encrypt_init. ChaCha20 (RFC 9001 section
+   5.4.4) takes its block counter and nonce from the sample. */
 
 int ngtcp2_crypto_hp_mask(uint8_t *dest, const ngtcp2_crypto_cipher *hp,
                           const ngtcp2_crypto_cipher_ctx *hp_ctx,
@@ -380,14 +421,12 @@ int ngtcp2_crypto_hp_mask(uint8_t *dest, const ngtcp2_crypto_cipher *hp,
     /* AES-ECB encrypt single 16-byte block */
     size_t outlen = 0;
     CCCryptorStatus status =
-        CCCrypt(kCCEncrypt, kCCAlgorithmAES, kCCOptionECBMode, ctx->key,
-                ctx->keylen, NULL, sample, 16, dest, 16, &outlen);
-    return status == kCCSuccess ? 0 : -1;
+        CCCryptorUpdate(ctx->ecb, sample, 16, dest, 16, &outlen);
+    return status == kCCSuccess && outlen == 16 ? 0 : -1;
   }
   case NGTCP2_APPLE_CIPHER_CHACHA20:
-    /* ChaCha20 HP: counter from sample[0..3], nonce from sample[4..15],
-       encrypt 5 zero bytes. Handled via Swift callback if needed. */
-    return -1;
+    ngtcp2_apple_chacha20_hp_mask(&ctx->chacha, dest, sample);
+    return 0;
   default:
     return -1;
   }
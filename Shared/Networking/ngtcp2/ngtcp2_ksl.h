@@ -36,7 +36,9 @@
 #include "ngtcp2_objalloc.h"
 #include "ngtcp2_range.h"
 
-#define NGTCP2_KSL_DEGR 16
+#ifndef NGTCP2_KSL_DEGR
+#  define NGTCP2_KSL_DEGR 16
+#endif /* !defined(NGTCP2_KSL_DEGR) */
 /* NGTCP2_KSL_MAX_NBLK is the maximum number of nodes which a single
    block can contain. */
 #define NGTCP2_KSL_MAX_NBLK (2 * NGTCP2_KSL_DEGR)
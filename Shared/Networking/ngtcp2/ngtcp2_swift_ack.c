@@ -0,0 +1,16 @@
+//
+//  ngtcp2_swift_ack.c
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+#include "ngtcp2_conn.h"
+#include "ngtcp2_swift_bridge.h"
+
+void ngtcp2_swift_set_ack_thresh(ngtcp2_conn *conn, size_t ack_thresh) {
+  /* Read per packet in conn_recv_pkt, so the new threshold applies from the
+   * next ack-eliciting packet. Reordering and ECN-CE still ACK at once, and
+   * the max_ack_delay timer bounds how long a short run waits. */
+  conn->local.settings.ack_thresh = ack_thresh < 2 ? 2 : ack_thresh;
+}
@@ -10,21 +10,6 @@
 
 #include <ngtcp2/ngtcp2.h>
 #include "shared.h"
-/* Exposes `ngtcp2_conn_stat` (cwnd / pacing_interval_m / smoothed_rtt / …)
- * to Swift so BrutalCongestionControl can read and write the fields the
- * ngtcp2 CC callbacks hand it. Safe to include from Swift — this header
- * only depends on the public ngtcp2.h and a plain enum. */
-#include "ngtcp2_conn_stat.h"
-
-/* `ngtcp2_cc`, `ngtcp2_cc_pkt` and `ngtcp2_cc_ack` live in the internal
- * `ngtcp2_cc.h` which transitively pulls in ngtcp2-crypto types that we
- * don't want to bridge into Swift. Forward-declare them as opaque so the
- * extern prototypes below type-check everywhere without leaking those
- * dependencies. Swift sees these as `OpaquePointer`s; the C side that
- * implements the trampolines pulls in `ngtcp2_cc.h` normally. */
-typedef struct ngtcp2_cc ngtcp2_cc;
-typedef struct ngtcp2_cc_pkt ngtcp2_cc_pkt;
-typedef struct ngtcp2_cc_ack ngtcp2_cc_ack;
 
 /* Wrappers for versioned API macros */
 
@@ -84,53 +69,80 @@ static inline ngtcp2_ssize ngtcp2_swift_conn_write_datagram(
                                      data, datalen, ts);
 }
 
+static inline void ngtcp2_swift_conn_get_conn_info(ngtcp2_conn *conn,
+                                                   ngtcp2_conn_info *cinfo) {
+  ngtcp2_conn_get_conn_info(conn, cinfo);
+}
+
 /* ----- Brutal CC hook -----------------------------------------------------
  *
  * Hysteria v2 runs a custom congestion controller ("Brutal") that picks a
  * target send rate rather than probing for one. Since ngtcp2 doesn't expose a
  * plug-in CC API, we initialize `conn` with a built-in CC (CUBIC, via
- * `settings.cc_algo`) and then overwrite the CC callback table with Swift
- * trampolines. The underlying CC-specific state (cubic_vars, etc.) is simply
- * left untouched — none of Brutal's callbacks look at it.
- *
- * The Swift side defines the trampolines via `@_cdecl`; we forward-declare
- * them here so the install helper can assign them. The `cc` pointer that
- * trampolines receive matches `&conn->cc` of the connection being driven,
- * which Swift uses as a key to locate the `BrutalCongestionControl` instance.
+ * `settings.cc_algo`) and then replace the CC callback table and state with
+ * the native Brutal implementation in `ngtcp2_swift_brutal.c`. Swift only
+ * sets the target bandwidth; per-packet CC work never leaves C.
  */
 
-extern void ngtcp2_swift_brutal_on_pkt_acked(
-    ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
-    const ngtcp2_cc_pkt *pkt, ngtcp2_tstamp ts);
-
-extern void ngtcp2_swift_brutal_on_pkt_lost(
-    ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
-    const ngtcp2_cc_pkt *pkt, ngtcp2_tstamp ts);
-
-extern void ngtcp2_swift_brutal_on_ack_recv(
-    ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
-    const ngtcp2_cc_ack *ack, ngtcp2_tstamp ts);
-
-extern void ngtcp2_swift_brutal_on_pkt_sent(
-    ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
-    const ngtcp2_cc_pkt *pkt);
-
-extern void ngtcp2_swift_brutal_reset(
-    ngtcp2_cc *cc, ngtcp2_conn_stat *cstat, ngtcp2_tstamp ts);
-
-/// Overwrites `conn`'s CC callback table with Swift Brutal trampolines and
-/// returns the `ngtcp2_cc *` Swift should use as a registry key. Defined in
+/// Overwrites `conn`'s CC with Brutal pacing at `target_bps` bytes/sec. A `target_bps`
+/// of 0 detects the rate instead: a BBR-style startup measures the bottleneck, Brutal
+/// then holds 90% of it and re-estimates from the ack rate and loss every 10 s. Defined in
 /// `ngtcp2_swift_brutal.c` — not inlined here because reaching into
 /// `conn->cc` pulls in ngtcp2-internal crypto types that we don't want
-/// bridged into Swift.
-ngtcp2_cc *ngtcp2_swift_install_brutal(ngtcp2_conn *conn);
+/// bridged into Swift. Call after conn_client_new and before any packets.
+void ngtcp2_swift_install_brutal(ngtcp2_conn *conn, uint64_t target_bps);
+
+/// Updates Brutal's target send rate (bytes/sec); no-op unless Brutal is installed.
+/// Under detection `bps` caps the detected rate instead (0 = no cap).
+void ngtcp2_swift_brutal_set_bandwidth(ngtcp2_conn *conn, uint64_t bps);
 
 /// Restores `conn->cc` to the CUBIC callbacks. Used when the Hysteria
 /// server returns `Hysteria-CC-RX: auto`, asking the client to defer
-/// pacing to its own bandwidth estimator. After this returns, the Swift
-/// caller MUST clear its `brutalCC` and remove its registry entry — the
-/// Brutal trampolines are no longer reachable from ngtcp2 anyway, but the
-/// Swift instance otherwise leaks.
+/// pacing to its own bandwidth estimator.
 void ngtcp2_swift_uninstall_brutal(ngtcp2_conn *conn);
 
+/* ----- PMTUD ladder ---------------------------------------------------------
+ *
+ * ngtcp2 reads `settings.pmtud_probes` once per path, when PMTUD starts after
+ * the handshake or a validated migration. Swift plans a ladder per network
+ * and rewrites it before migrating; both live in `ngtcp2_swift_pmtud.c`.
+ */
+
+/// Overwrites the ladder ngtcp2 copied at conn_client_new (its length is
+/// fixed there) and the PMTUD hard cap, and stops the current path's search.
+/// Call just before initiating migration to a path on another network.
+void ngtcp2_swift_set_pmtud_ladder(ngtcp2_conn *conn, const uint16_t *probes,
+                                   size_t probeslen,
+                                   size_t max_tx_udp_payload_size);
+
+/// Nonzero while PMTUD is still searching the current path.
+int ngtcp2_swift_conn_pmtud_running(ngtcp2_conn *conn);
+
+/* ----- ACK threshold --------------------------------------------------------
+ *
+ * No peer we talk to sends ACK_FREQUENCY, so the receiver sets its own pace:
+ * Swift sizes the immediate-ACK threshold from the packets it reads per RTT,
+ * in `ngtcp2_swift_ack.c`.
+ */
+
+/// Replaces `settings.ack_thresh`, the ack-eliciting packets received before
+/// an ACK is sent without waiting for max_ack_delay. Floored at 2 (RFC 9000
+/// §13.2.2).
+void ngtcp2_swift_set_ack_thresh(ngtcp2_conn *conn, size_t ack_thresh);
+
+/* ----- Sent-packet pools ---------------------------------------------------
+ *
+ * Every sent packet takes an rtb entry and usually a frame chain from the
+ * connection's objalloc pools, which recycle through a per-connection free
+ * list but grow sixteen objects at a time. At Brutal rates the ramp to a full
+ * flight would grow them thousands of times; `ngtcp2_swift_rtb.c` fills them
+ * up front instead.
+ */
+
+/// Leaves enough free rtb entries and frame chains in `conn`'s pools for
+/// `flight_bytes` of packets in flight (capped), so the send path draws from
+/// the free lists instead of growing them.
+void ngtcp2_swift_reserve_sent_packets(ngtcp2_conn *conn,
+                                       uint64_t flight_bytes);
+
 #endif /* NGTCP2_SWIFT_BRIDGE_H */
@@ -5,45 +5,376 @@
 //  Created by NodePassProject on 4/13/26.
 //
 
+#include <string.h>
+
 #include "ngtcp2_conn.h"
 #include "ngtcp2_cc.h"
 #include "ngtcp2_swift_bridge.h"
 
-/* Forward-declare the Swift @_cdecl'd trampolines. Swift emits matching C
- * symbols; see BrutalCongestionControl.swift. */
-extern void ngtcp2_swift_brutal_on_pkt_acked(
-    ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
-    const ngtcp2_cc_pkt *pkt, ngtcp2_tstamp ts);
-
-extern void ngtcp2_swift_brutal_on_pkt_lost(
-    ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
-    const ngtcp2_cc_pkt *pkt, ngtcp2_tstamp ts);
-
-extern void ngtcp2_swift_brutal_on_ack_recv(
-    ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
-    const ngtcp2_cc_ack *ack, ngtcp2_tstamp ts);
-
-extern void ngtcp2_swift_brutal_on_pkt_sent(
-    ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
-    const ngtcp2_cc_pkt *pkt);
-
-extern void ngtcp2_swift_brutal_reset(
-    ngtcp2_cc *cc, ngtcp2_conn_stat *cstat, ngtcp2_tstamp ts);
-
-ngtcp2_cc *ngtcp2_swift_install_brutal(ngtcp2_conn *conn) {
-  ngtcp2_cc *cc = &conn->cc;
-  cc->on_pkt_acked = ngtcp2_swift_brutal_on_pkt_acked;
-  cc->on_pkt_lost = ngtcp2_swift_brutal_on_pkt_lost;
-  cc->on_ack_recv = ngtcp2_swift_brutal_on_ack_recv;
-  cc->on_pkt_sent = ngtcp2_swift_brutal_on_pkt_sent;
-  cc->reset = ngtcp2_swift_brutal_reset;
+/* Seconds of per-second ack/loss slots over which the loss rate is computed. */
+#define BRUTAL_SLOT_COUNT 5
+/* Below this many ack+loss samples the loss rate is treated as 0. */
+#define BRUTAL_MIN_SAMPLE_COUNT 50
+/* Loss-rate cap; beyond this the cwnd grows pathologically and floods the
+ * link. */
+#define BRUTAL_MAX_LOSS_RATE 0.2
+#define BRUTAL_CWND_MULTIPLIER 2.0
+/* 10 MSS matches RFC 6928 initial cwnd. */
+#define BRUTAL_MIN_CWND_PACKETS 10
+/* Flat cwnd seed until the first RTT sample; the Brutal formula with a
+ * synthetic RTT floor inflates cwnd to multiple MB and causes startup burst
+ * loss. */
+#define BRUTAL_INITIAL_CWND 10240
+#define BRUTAL_MAX_SEND_QUANTUM (64 * 1024)
+
+/* Auto-detection (installed without a target): a BBR-style startup finds
+ * the bottleneck, then Brutal holds a fraction of it and re-estimates. */
+/* 2/ln(2), BBR's startup gain: doubles the delivery rate every round. */
+#define BRUTAL_AUTO_STARTUP_GAIN 2.885
+/* Startup ends after this many rounds that grew the max rate under 25%. */
+#define BRUTAL_AUTO_FULL_BW_ROUNDS 3
+#define BRUTAL_AUTO_FULL_BW_GROWTH 1.25
+/* Startup also ends once the path drops this share of packets. */
+#define BRUTAL_AUTO_STARTUP_MAX_LOSS 0.05
+/* Brutal's target as a share of the measured bottleneck. */
+#define BRUTAL_AUTO_TARGET_FRACTION 0.9
+#define BRUTAL_AUTO_REESTIMATE_INTERVAL (10 * NGTCP2_SECONDS)
+/* Above this loss rate a re-estimate trusts the ack rate over the target. */
+#define BRUTAL_AUTO_STEADY_MAX_LOSS 0.1
+/* A path that kept up with the target gets this much more to probe. */
+#define BRUTAL_AUTO_PROBE_GAIN 1.25
+/* Floor for the detected target: 1 Mbit/s. */
+#define BRUTAL_AUTO_MIN_BPS 125000
+
+typedef enum ngtcp2_swift_brutal_phase {
+  /* Fixed user-configured target. */
+  BRUTAL_PHASE_FIXED,
+  BRUTAL_PHASE_STARTUP,
+  BRUTAL_PHASE_STEADY,
+} ngtcp2_swift_brutal_phase;
+
+typedef struct ngtcp2_swift_brutal_slot {
+  uint64_t second_mark;
+  uint64_t ack_count;
+  uint64_t loss_count;
+} ngtcp2_swift_brutal_slot;
+
+/* Lives in `conn`'s CC union in place of ngtcp2_cc_cubic, so it needs no
+ * allocation and the CC callbacks reach their state by casting `cc`. */
+typedef struct ngtcp2_swift_brutal {
+  ngtcp2_cc cc;
+  /* Target send rate in bytes/sec. Updated post-auth, or detected. */
+  uint64_t target_bps;
+  ngtcp2_swift_brutal_slot slots[BRUTAL_SLOT_COUNT];
+  /* Auto-detection state; unused in BRUTAL_PHASE_FIXED. */
+  ngtcp2_rst *rst;
+  ngtcp2_swift_brutal_phase phase;
+  /* Server-imposed ceiling on the detected target; 0 is none. */
+  uint64_t cap_bps;
+  /* Max delivery rate since startup began or the last re-estimate. */
+  uint64_t max_bw;
+  /* Startup plateau tracking, per round of one smoothed RTT. */
+  uint64_t full_bw;
+  size_t full_bw_rounds;
+  ngtcp2_tstamp round_end_ts;
+  ngtcp2_tstamp reestimate_ts;
+} ngtcp2_swift_brutal;
+
+typedef char ngtcp2_swift_brutal_fits_cc_union
+    [sizeof(ngtcp2_swift_brutal) <= sizeof(ngtcp2_cc_cubic) ? 1 : -1];
+
+static void brutal_reset_slots(ngtcp2_swift_brutal *brutal) {
+  size_t i;
+
+  for (i = 0; i < BRUTAL_SLOT_COUNT; ++i) {
+    brutal->slots[i].second_mark = UINT64_MAX;
+    brutal->slots[i].ack_count = 0;
+    brutal->slots[i].loss_count = 0;
+  }
+}
+
+static ngtcp2_swift_brutal_slot *brutal_slot(ngtcp2_swift_brutal *brutal,
+                                             ngtcp2_tstamp ts) {
+  uint64_t second = ts / NGTCP2_SECONDS;
+  ngtcp2_swift_brutal_slot *slot = &brutal->slots[second % BRUTAL_SLOT_COUNT];
+
+  if (slot->second_mark != second) {
+    slot->second_mark = second;
+    slot->ack_count = 0;
+    slot->loss_count = 0;
+  }
+  return slot;
+}
+
+/* Loss rate over the last BRUTAL_SLOT_COUNT seconds including the
+ * in-progress one; excluding it pins the ack rate at 1.0 during bursty-loss
+ * startups. */
+static double brutal_loss_rate(const ngtcp2_swift_brutal *brutal,
+                               ngtcp2_tstamp ts) {
+  uint64_t now = ts / NGTCP2_SECONDS;
+  uint64_t total_ack = 0, total_loss = 0, target;
+  const ngtcp2_swift_brutal_slot *slot;
+  size_t i;
+
+  for (i = 0; i < BRUTAL_SLOT_COUNT; ++i) {
+    target = now - i;
+    slot = &brutal->slots[target % BRUTAL_SLOT_COUNT];
+    if (slot->second_mark != target) {
+      continue;
+    }
+    total_ack += slot->ack_count;
+    total_loss += slot->loss_count;
+  }
+
+  if (total_ack + total_loss < BRUTAL_MIN_SAMPLE_COUNT) {
+    return 0;
+  }
+  return (double)total_loss / (double)(total_ack + total_loss);
+}
+
+static uint64_t brutal_auto_target(const ngtcp2_swift_brutal *brutal,
+                                   uint64_t bps) {
+  if (bps < BRUTAL_AUTO_MIN_BPS) {
+    bps = BRUTAL_AUTO_MIN_BPS;
+  }
+  if (brutal->cap_bps && bps > brutal->cap_bps) {
+    bps = brutal->cap_bps;
+  }
+  return bps;
+}
+
+/* Fills the sent-packet pools for the flight a `bps` target settles at: the
+ * cwnd formula's bps * RTT * multiplier, over the current smoothed RTT
+ * (initial_rtt before the first sample). */
+static void brutal_reserve_flight(ngtcp2_swift_brutal *brutal, uint64_t bps) {
+  ngtcp2_conn *conn = ngtcp2_struct_of(&brutal->cc, ngtcp2_conn, cc);
+  ngtcp2_duration rtt = conn->cstat.smoothed_rtt;
+
+  if (bps == 0 || rtt == 0) {
+    return;
+  }
+  ngtcp2_swift_reserve_sent_packets(
+      conn, (uint64_t)((double)bps * BRUTAL_CWND_MULTIPLIER * (double)rtt /
+                       (double)NGTCP2_SECONDS));
+}
+
+static void brutal_auto_enter_steady(ngtcp2_swift_brutal *brutal,
+                                     ngtcp2_tstamp ts) {
+  brutal->phase = BRUTAL_PHASE_STEADY;
+  brutal->target_bps = brutal_auto_target(
+      brutal, (uint64_t)((double)brutal->max_bw * BRUTAL_AUTO_TARGET_FRACTION));
+  brutal->max_bw = 0;
+  brutal->reestimate_ts = ts + BRUTAL_AUTO_REESTIMATE_INTERVAL;
+  brutal_reserve_flight(brutal, brutal->target_bps);
+}
+
+/* Folds the delivery rate ngtcp2's rate sampler just produced. Samples
+ * taken while the sender was app-limited only count when they raise the
+ * max, as in BBR. */
+static void brutal_auto_on_ack(ngtcp2_swift_brutal *brutal,
+                               ngtcp2_conn_stat *cstat, ngtcp2_tstamp ts) {
+  uint64_t rate = cstat->delivery_rate_sec;
+  int app_limited = brutal->rst->rs.is_app_limited;
+  double loss_rate;
+
+  if (rate > brutal->max_bw) {
+    brutal->max_bw = rate;
+  }
+
+  if (brutal->phase == BRUTAL_PHASE_STARTUP) {
+    if (cstat->smoothed_rtt == 0 || ts < brutal->round_end_ts) {
+      return;
+    }
+    brutal->round_end_ts = ts + cstat->smoothed_rtt;
+    if ((double)brutal->max_bw >=
+        (double)brutal->full_bw * BRUTAL_AUTO_FULL_BW_GROWTH) {
+      brutal->full_bw = brutal->max_bw;
+      brutal->full_bw_rounds = 0;
+    } else if (!app_limited) {
+      ++brutal->full_bw_rounds;
+    }
+    if (brutal->full_bw_rounds >= BRUTAL_AUTO_FULL_BW_ROUNDS ||
+        brutal_loss_rate(brutal, ts) > BRUTAL_AUTO_STARTUP_MAX_LOSS) {
+      brutal_auto_enter_steady(brutal, ts);
+    }
+    return;
+  }
+
+  if (ts < brutal->reestimate_ts) {
+    return;
+  }
+  brutal->reestimate_ts = ts + BRUTAL_AUTO_REESTIMATE_INTERVAL;
+  if (brutal->max_bw == 0) {
+    return;
+  }
+  loss_rate = brutal_loss_rate(brutal, ts);
+  if (loss_rate > BRUTAL_AUTO_STEADY_MAX_LOSS) {
+    /* Flooding: what came back is what the path carries. */
+    brutal->target_bps = brutal_auto_target(
+        brutal, (uint64_t)((double)brutal->max_bw * (1.0 - loss_rate) *
+                           BRUTAL_AUTO_TARGET_FRACTION));
+  } else if ((double)brutal->max_bw >= (double)brutal->target_bps * 0.95) {
+    /* The path kept up; there may be headroom. */
+    brutal->target_bps = brutal_auto_target(
+        brutal,
+        (uint64_t)((double)brutal->target_bps * BRUTAL_AUTO_PROBE_GAIN));
+  }
+  /* Otherwise the sender was app-limited and says nothing new. */
+  brutal->max_bw = 0;
+}
+
+static void brutal_update_cwnd(ngtcp2_swift_brutal *brutal,
+                               ngtcp2_conn_stat *cstat, ngtcp2_tstamp ts) {
+  uint64_t mss, min_cwnd, cwnd, quantum, startup_bw;
+  double loss_rate, pacing_bps, cwnd_bytes, bytes_per_ms;
+  double cwnd_multiplier = BRUTAL_CWND_MULTIPLIER;
+
+  mss = cstat->max_tx_udp_payload_size ? cstat->max_tx_udp_payload_size : 1;
+  min_cwnd = BRUTAL_MIN_CWND_PACKETS * mss;
+
+  if (brutal->phase == BRUTAL_PHASE_STARTUP) {
+    /* Until a rate is measured, the seed window over the RTT stands in. */
+    startup_bw = brutal->max_bw;
+    if (startup_bw == 0 && cstat->smoothed_rtt) {
+      startup_bw = (uint64_t)((double)BRUTAL_INITIAL_CWND * NGTCP2_SECONDS /
+                              (double)cstat->smoothed_rtt);
+    }
+    pacing_bps = (double)startup_bw * BRUTAL_AUTO_STARTUP_GAIN;
+    /* The gain already leaves headroom over the measured BDP. */
+    cwnd_multiplier = 1.0;
+    if (brutal->cap_bps && pacing_bps > (double)brutal->cap_bps) {
+      pacing_bps = (double)brutal->cap_bps;
+    }
+  } else {
+    if (brutal->target_bps == 0) {
+      return;
+    }
+
+    loss_rate = brutal_loss_rate(brutal, ts);
+    if (loss_rate > BRUTAL_MAX_LOSS_RATE) {
+      loss_rate = BRUTAL_MAX_LOSS_RATE;
+    }
+
+    /* Pace at target / ack_rate so that over time paced_rate * ack_rate ≈
+     * target. */
+    pacing_bps = (double)brutal->target_bps / (1.0 - loss_rate);
+  }
+
+  if (cstat->smoothed_rtt == 0) {
+    /* Flat seed until ngtcp2 produces a real smoothed RTT. */
+    cwnd = BRUTAL_INITIAL_CWND > min_cwnd ? BRUTAL_INITIAL_CWND : min_cwnd;
+  } else {
+    /* bps * RTT * 2 / ack_rate, raw RTT with no floor (a 50 ms clamp
+     * inflated cwnd 5-50x on low-RTT links). */
+    cwnd_bytes = pacing_bps * cwnd_multiplier *
+                 (double)cstat->smoothed_rtt / (double)NGTCP2_SECONDS;
+    cwnd = (uint64_t)cwnd_bytes > min_cwnd ? (uint64_t)cwnd_bytes : min_cwnd;
+  }
+
+  /* pacing_interval_m is (ns/byte) << 10; 0 selects the library default. */
+  cstat->pacing_interval_m =
+      pacing_bps >= 1.0
+          ? (ngtcp2_duration)((double)NGTCP2_SECONDS / pacing_bps * 1024.0)
+          : 0;
+
+  /* send_quantum = 1 ms of bytes (floor 10 MSS, cap 64 KB); otherwise we'd
+   * inherit CUBIC's static 10 MSS (~14 KB). */
+  bytes_per_ms = pacing_bps / 1000.0;
+  quantum = bytes_per_ms < BRUTAL_MAX_SEND_QUANTUM ? (uint64_t)bytes_per_ms
+                                                   : BRUTAL_MAX_SEND_QUANTUM;
+  if (quantum < min_cwnd) {
+    quantum = min_cwnd;
+  }
+
+  cstat->cwnd = cwnd;
+  cstat->send_quantum = (size_t)quantum;
+}
+
+static void brutal_on_pkt_acked(ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
+                                const ngtcp2_cc_pkt *pkt, ngtcp2_tstamp ts) {
+  ngtcp2_swift_brutal *brutal = (ngtcp2_swift_brutal *)cc;
+  (void)pkt;
+
+  ++brutal_slot(brutal, ts)->ack_count;
+  brutal_update_cwnd(brutal, cstat, ts);
+}
+
+static void brutal_on_pkt_lost(ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
+                               const ngtcp2_cc_pkt *pkt, ngtcp2_tstamp ts) {
+  ngtcp2_swift_brutal *brutal = (ngtcp2_swift_brutal *)cc;
+  (void)pkt;
+
+  ++brutal_slot(brutal, ts)->loss_count;
+  brutal_update_cwnd(brutal, cstat, ts);
+}
+
+static void brutal_on_ack_recv(ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
+                               const ngtcp2_cc_ack *ack, ngtcp2_tstamp ts) {
+  ngtcp2_swift_brutal *brutal = (ngtcp2_swift_brutal *)cc;
+  (void)ack;
+
+  if (brutal->phase != BRUTAL_PHASE_FIXED) {
+    brutal_auto_on_ack(brutal, cstat, ts);
+  }
+  brutal_update_cwnd(brutal, cstat, ts);
+}
+
+static void brutal_on_pkt_sent(ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
+                               const ngtcp2_cc_pkt *pkt) {
+  /* on_pkt_sent has no ts argument; the packet's send time is the same
+   * clock. */
+  brutal_update_cwnd((ngtcp2_swift_brutal *)cc, cstat, pkt->sent_ts);
+}
+
+static void brutal_reset(ngtcp2_cc *cc, ngtcp2_conn_stat *cstat,
+                         ngtcp2_tstamp ts) {
+  ngtcp2_swift_brutal *brutal = (ngtcp2_swift_brutal *)cc;
+
+  brutal_reset_slots(brutal);
+  brutal_update_cwnd(brutal, cstat, ts);
+}
+
+void ngtcp2_swift_install_brutal(ngtcp2_conn *conn, uint64_t target_bps) {
+  ngtcp2_swift_brutal *brutal = (ngtcp2_swift_brutal *)&conn->cc;
+  ngtcp2_log *log = conn->cc.log;
+
+  /* Take over the CUBIC state in the CC union; nothing reads it again
+   * until ngtcp2_swift_uninstall_brutal re-initializes CUBIC. */
+  memset(brutal, 0, sizeof(*brutal));
+  brutal->cc.log = log;
+  brutal->cc.on_pkt_acked = brutal_on_pkt_acked;
+  brutal->cc.on_pkt_lost = brutal_on_pkt_lost;
+  brutal->cc.on_ack_recv = brutal_on_ack_recv;
+  brutal->cc.on_pkt_sent = brutal_on_pkt_sent;
+  brutal->cc.reset = brutal_reset;
   /* Brutal handles loss through on_pkt_lost; other congestion events do
    * not affect cwnd. NULL'ing these hooks is allowed by ngtcp2_cc.h
    * ("All callback functions are optional"). */
-  cc->congestion_event = NULL;
-  cc->on_spurious_congestion = NULL;
-  cc->on_persistent_congestion = NULL;
-  return cc;
+  brutal->cc.congestion_event = NULL;
+  brutal->cc.on_spurious_congestion = NULL;
+  brutal->cc.on_persistent_congestion = NULL;
+  brutal->target_bps = target_bps;
+  brutal->rst = &conn->rst;
+  brutal->phase = target_bps ? BRUTAL_PHASE_FIXED : BRUTAL_PHASE_STARTUP;
+  brutal_reset_slots(brutal);
+  brutal_reserve_flight(brutal, target_bps);
+}
+
+void ngtcp2_swift_brutal_set_bandwidth(ngtcp2_conn *conn, uint64_t bps) {
+  ngtcp2_swift_brutal *brutal = (ngtcp2_swift_brutal *)&conn->cc;
+
+  if (conn->cc.on_pkt_acked != brutal_on_pkt_acked) {
+    return;
+  }
+  if (brutal->phase == BRUTAL_PHASE_FIXED) {
+    brutal->target_bps = bps;
+    brutal_reserve_flight(brutal, bps);
+    return;
+  }
+  brutal->cap_bps = bps;
+  if (brutal->phase == BRUTAL_PHASE_STEADY) {
+    brutal->target_bps = brutal_auto_target(brutal, brutal->target_bps);
+  }
 }
 
 /* Restores the CUBIC callbacks on `conn->cc`, used when the Hysteria server
@@ -53,7 +384,7 @@ ngtcp2_cc *ngtcp2_swift_install_brutal(ngtcp2_conn *conn) {
  * with for the `.brutal` tuning case, so the cstat fields (cwnd, ssthresh,
  * bytes_in_flight) carry over from Brutal cleanly. `ngtcp2_cc_cubic_init`
  * re-zeros the cubic-internal struct (which shared union memory with the
- * Brutal callbacks) and resets `cstat`'s pacing rate — that's the intended
+ * Brutal state) and resets `cstat`'s pacing rate — that's the intended
  * effect since Brutal was driving the pacer with its own interval. */
 void ngtcp2_swift_uninstall_brutal(ngtcp2_conn *conn) {
   ngtcp2_cc_cubic_init(&conn->cubic, &conn->log, &conn->cstat, &conn->rst);
@@ -0,0 +1,36 @@
+//
+//  ngtcp2_swift_pmtud.c
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+#include "ngtcp2_conn.h"
+#include "ngtcp2_swift_bridge.h"
+
+void ngtcp2_swift_set_pmtud_ladder(ngtcp2_conn *conn, const uint16_t *probes,
+                                   size_t probeslen,
+                                   size_t max_tx_udp_payload_size) {
+  /* conn_client_new copied the ladder into |conn|'s own allocation, so the
+   * length is fixed; a shorter ladder is padded with its last size, which
+   * ngtcp2 skips once that size has been probed. */
+  uint16_t *ladder = (uint16_t *)conn->local.settings.pmtud_probes;
+  size_t i;
+
+  if (ladder == NULL || probeslen == 0) {
+    return;
+  }
+
+  for (i = 0; i < conn->local.settings.pmtud_probeslen; ++i) {
+    ladder[i] = probes[i < probeslen ? i : probeslen - 1];
+  }
+  conn->local.settings.max_tx_udp_payload_size = max_tx_udp_payload_size;
+
+  /* The running search measures the path being left; validating the new path
+   * starts a fresh one over the rewritten ladder. */
+  ngtcp2_conn_stop_pmtud(conn);
+}
+
+int ngtcp2_swift_conn_pmtud_running(ngtcp2_conn *conn) {
+  return conn->pmtud != NULL;
+}
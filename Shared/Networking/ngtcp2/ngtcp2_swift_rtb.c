@@ -0,0 +1,71 @@
+//
+//  ngtcp2_swift_rtb.c
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+#include "ngtcp2_conn.h"
+#include "ngtcp2_rtb.h"
+#include "ngtcp2_frame_chain.h"
+#include "ngtcp2_swift_bridge.h"
+
+/* Ceiling on one reservation, in packets: about 5 MB in flight at 1200-byte
+ * packets, and roughly 1 MB of entries and chains held per connection. */
+#define SWIFT_RTB_RESERVE_MAX_PKTS 4096
+
+#ifndef NOMEMPOOL
+static ngtcp2_opl_entry *get_rtb_entry(ngtcp2_objalloc *objalloc) {
+  ngtcp2_rtb_entry *ent = ngtcp2_objalloc_rtb_entry_get(objalloc);
+  return ent ? &ent->oplent : NULL;
+}
+
+static ngtcp2_opl_entry *get_frame_chain(ngtcp2_objalloc *objalloc) {
+  ngtcp2_frame_chain *frc = ngtcp2_objalloc_frame_chain_get(objalloc);
+  return frc ? &frc->oplent : NULL;
+}
+
+/* Takes |n| objects (free ones first, then fresh balloc blocks) and hands
+ * them all back, so at least |n| sit on the pool's free list afterwards. */
+static void reserve(ngtcp2_objalloc *objalloc, size_t n,
+                    ngtcp2_opl_entry *(*get)(ngtcp2_objalloc *)) {
+  ngtcp2_opl held;
+  ngtcp2_opl_entry *oplent;
+  size_t i;
+
+  ngtcp2_opl_init(&held);
+  for (i = 0; i < n; ++i) {
+    oplent = get(objalloc);
+    if (oplent == NULL) {
+      break;
+    }
+    ngtcp2_opl_push(&held, oplent);
+  }
+  while ((oplent = ngtcp2_opl_pop(&held)) != NULL) {
+    ngtcp2_opl_push(&objalloc->opl, oplent);
+  }
+}
+#endif /* !defined(NOMEMPOOL) */
+
+void ngtcp2_swift_reserve_sent_packets(ngtcp2_conn *conn,
+                                       uint64_t flight_bytes) {
+#ifndef NOMEMPOOL
+  uint64_t mss = conn->cstat.max_tx_udp_payload_size;
+  uint64_t npkts;
+
+  if (mss == 0) {
+    return;
+  }
+  npkts = flight_bytes / mss;
+  if (npkts > SWIFT_RTB_RESERVE_MAX_PKTS) {
+    npkts = SWIFT_RTB_RESERVE_MAX_PKTS;
+  }
+  /* One entry per packet, and one chain for the STREAM frame most of them
+   * carry. */
+  reserve(&conn->rtb_entry_objalloc, (size_t)npkts, get_rtb_entry);
+  reserve(&conn->frc_objalloc, (size_t)npkts, get_frame_chain);
+#else  /* defined(NOMEMPOOL) */
+  (void)conn;
+  (void)flight_bytes;
+#endif /* defined(NOMEMPOOL) */
+}
@@ -0,0 +1,683 @@
+//
+//  CIDRTrie.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+// MARK: - CIDR Patricia tries
+//
+// Path-compressed binary tries for longest-prefix match, nodes in one contiguous
+// arena; v4 and v6 are separate types so the v4 hot loop avoids 128-bit shifts.
+
+nonisolated struct CIDRv4Trie {
+    /// 4 + 4 + 4 + 2 + 1 + 1 padding = 16 bytes, 4-byte aligned.
+    private struct Node {
+        var bits: UInt32 = 0        // MSB-aligned edge bits; bits past `bitLen` are zero
+        var left: Int32 = -1        // index into `nodes`, or -1 for none
+        var right: Int32 = -1
+        var actionID: Int16 = ActionTable.noneID
+        var bitLen: UInt8 = 0       // 0…32
+    }
+
+    private var nodes: [Node] = [Node()]
+
+    // MARK: - Insert
+
+    /// More-specific prefixes win at lookup; duplicate prefixes overwrite.
+    mutating func insert(network: UInt32, prefixLen: Int, actionID: Int16) {
+        let length = UInt8(prefixLen)
+        let bits = Self.maskTop(network, length)
+        insertCore(bits: bits, bitLen: length, actionID: actionID)
+    }
+
+    // MARK: - Merging
+
+    /// Visits every prefix carrying an action, each before any longer prefix
+    /// inside it — so painting in visit order lets longer prefixes win.
+    func forEachPrefix(_ body: (_ network: UInt32, _ length: UInt8, _ actionID: Int16) -> Void) {
+        var stack: [(node: Int32, bits: UInt32, length: UInt8)] = [(0, 0, 0)]
+        while let (nodeID, bits, length) = stack.popLast() {
+            let node = nodes[Int(nodeID)]
+            if node.actionID != ActionTable.noneID { body(bits, length, node.actionID) }
+            for childID in [node.right, node.left] where childID >= 0 {
+                let child = nodes[Int(childID)]
+                stack.append((childID, bits | (child.bits >> UInt32(length)), length + child.bitLen))
+            }
+        }
+    }
+
+    /// Whether a prefix no longer than `length` covers `network/length`.
+    func hasPrefix(covering network: UInt32, length: UInt8) -> Bool {
+        if nodes[0].actionID != ActionTable.noneID { return true }
+        var bits = network
+        var remaining = length
+        var nodeID = 0
+        while remaining > 0 {
+            let childID = (bits >> 31 == 0) ? nodes[nodeID].left : nodes[nodeID].right
+            if childID < 0 { return false }
+            let child = nodes[Int(childID)]
+            if child.bitLen > remaining || Self.lcp(bits, child.bits, cap: child.bitLen) < child.bitLen { return false }
+            if child.actionID != ActionTable.noneID { return true }
+            bits = Self.shiftLeft(bits, child.bitLen)
+            remaining -= child.bitLen
+            nodeID = Int(childID)
+        }
+        return false
+    }
+
+    // MARK: - Compaction
+
+    /// Rebuilds the trie from the fewest prefixes that resolve every address the
+    /// same. Sibling prefixes sharing an action merge into their parent, replacing
+    /// any action the parent had (they shadowed it entirely), and a prefix whose
+    /// nearest enclosing prefix has the same action is dropped.
+    mutating func compact() {
+        var actions: [UInt64: Int16] = [:]
+        var byLength = [[UInt32]](repeating: [], count: 33)
+        forEachPrefix { network, length, actionID in
+            actions[Self.key(network, length)] = actionID
+            byLength[Int(length)].append(network)
+        }
+        guard actions.count > 1 else { return }
+
+        // Longest first, so a merged parent can merge again with its own sibling.
+        for length in stride(from: 32, to: 0, by: -1) {
+            let bit = UInt32(1) << (32 - length)
+            for network in byLength[length] {
+                let key = Self.key(network, UInt8(length))
+                let siblingKey = Self.key(network ^ bit, UInt8(length))
+                guard let action = actions[key], actions[siblingKey] == action else { continue }
+                actions[key] = nil
+                actions[siblingKey] = nil
+                let parent = network & ~bit
+                let parentKey = Self.key(parent, UInt8(length - 1))
+                if actions[parentKey] == nil { byLength[length - 1].append(parent) }
+                actions[parentKey] = action
+            }
+        }
+
+        var compacted = CIDRv4Trie()
+        for key in actions.keys.sorted() {
+            let network = UInt32(truncatingIfNeeded: key >> 8)
+            let length = UInt8(truncatingIfNeeded: key)
+            let action = actions[key]!
+            var enclosing: Int16?
+            var outer = Int(length) - 1
+            while outer >= 0, enclosing == nil {
+                enclosing = actions[Self.key(Self.maskTop(network, UInt8(outer)), UInt8(outer))]
+                outer -= 1
+            }
+            if enclosing == action { continue }
+            compacted.insert(network: network, prefixLen: Int(length), actionID: action)
+        }
+        self = compacted
+    }
+
+    private static func key(_ network: UInt32, _ length: UInt8) -> UInt64 {
+        UInt64(network) << 8 | UInt64(length)
+    }
+
+    // MARK: - Patricia core
+
+    private mutating func insertCore(bits: UInt32, bitLen: UInt8, actionID: Int16) {
+        var workingBits = bits
+        var remaining = bitLen
+        var nodeID: Int32 = 0
+
+        while remaining > 0 {
+            let firstBit = UInt8(workingBits >> 31)
+            let childID = (firstBit == 0) ? nodes[Int(nodeID)].left : nodes[Int(nodeID)].right
+
+            if childID < 0 {
+                let leafID = makeLeaf(bits: workingBits, bitLen: remaining, actionID: actionID)
+                if firstBit == 0 { nodes[Int(nodeID)].left = leafID }
+                else { nodes[Int(nodeID)].right = leafID }
+                return
+            }
+
+            let childBits = nodes[Int(childID)].bits
+            let childBitLen = nodes[Int(childID)].bitLen
+            let lcp = Self.lcp(workingBits, childBits, cap: min(remaining, childBitLen))
+
+            if lcp == childBitLen {
+                workingBits = Self.shiftLeft(workingBits, lcp)
+                remaining -= lcp
+                nodeID = childID
+                continue
+            }
+
+            // Partial match: split `child`'s edge at position `lcp`.
+            let midBits = Self.maskTop(childBits, lcp)
+            let existingNewBits = Self.shiftLeft(childBits, lcp)
+
+            var mid = Node()
+            mid.bits = midBits
+            mid.bitLen = lcp
+            let midID = Int32(nodes.count)
+            nodes.append(mid)
+
+            // Rewrite the existing child to carry only the tail of its edge.
+            nodes[Int(childID)].bits = existingNewBits
+            nodes[Int(childID)].bitLen = childBitLen - lcp
+
+            if UInt8(existingNewBits >> 31) == 0 { nodes[Int(midID)].left = childID }
+            else { nodes[Int(midID)].right = childID }
+
+            let newBits = Self.shiftLeft(workingBits, lcp)
+            let newRemaining = remaining - lcp
+            if newRemaining == 0 {
+                nodes[Int(midID)].actionID = actionID
+            } else {
+                let leafID = makeLeaf(bits: newBits, bitLen: newRemaining, actionID: actionID)
+                if UInt8(newBits >> 31) == 0 { nodes[Int(midID)].left = leafID }
+                else { nodes[Int(midID)].right = leafID }
+            }
+
+            if firstBit == 0 { nodes[Int(nodeID)].left = midID }
+            else { nodes[Int(nodeID)].right = midID }
+            return
+        }
+
+        // Key fully consumed; payload attaches to the current node.
+        nodes[Int(nodeID)].actionID = actionID
+    }
+
+    private mutating func makeLeaf(bits: UInt32, bitLen: UInt8, actionID: Int16) -> Int32 {
+        var leaf = Node()
+        leaf.bits = bits
+        leaf.bitLen = bitLen
+        leaf.actionID = actionID
+        let id = Int32(nodes.count)
+        nodes.append(leaf)
+        return id
+    }
+
+    // MARK: - 32-bit bit ops
+
+    /// Shift left, capped at 32 bits (returns 0 when `n >= 32`).
+    private static func shiftLeft(_ bits: UInt32, _ n: UInt8) -> UInt32 {
+        if n == 0 { return bits }
+        if n >= 32 { return 0 }
+        return bits << n
+    }
+
+    /// Keep only the top `n` bits; zero the rest.
+    private static func maskTop(_ bits: UInt32, _ n: UInt8) -> UInt32 {
+        if n == 0 { return 0 }
+        if n >= 32 { return bits }
+        return bits & (~UInt32(0) << (32 - n))
+    }
+
+    /// Longest common prefix of two MSB-aligned 32-bit edges, capped at `cap`.
+    private static func lcp(_ a: UInt32, _ b: UInt32, cap: UInt8) -> UInt8 {
+        if cap == 0 { return 0 }
+        let d = a ^ b
+        if d == 0 { return cap }
+        return min(cap, UInt8(d.leadingZeroBitCount))
+    }
+}
+
+nonisolated struct CIDRv6Trie {
+    /// 8 + 8 + 4 + 4 + 2 + 1 + 5 padding = 32 bytes, 8-byte aligned. Edge bits are
+    /// MSB-first across (bitsHi, bitsLo); bits past `bitLen` stay zero by invariant.
+    private struct Node {
+        var bitsHi: UInt64 = 0
+        var bitsLo: UInt64 = 0
+        var left: Int32 = -1
+        var right: Int32 = -1
+        var actionID: Int16 = ActionTable.noneID
+        var bitLen: UInt8 = 0       // 0…128
+    }
+
+    private var nodes: [Node] = [Node()]
+
+    // MARK: - Insert
+
+    mutating func insert(network: [UInt8], prefixLen: Int, actionID: Int16) {
+        let (hi, lo) = network.withUnsafeBufferPointer { Self.pack16($0) }
+        insert(hi: hi, lo: lo, prefixLen: prefixLen, actionID: actionID)
+    }
+
+    mutating func insert(hi: UInt64, lo: UInt64, prefixLen: Int, actionID: Int16) {
+        let length = UInt8(prefixLen)
+        let (mHi, mLo) = Self.maskTop(hi, lo, length)
+        insertCore(bitsHi: mHi, bitsLo: mLo, bitLen: length, actionID: actionID)
+    }
+
+    // MARK: - Merging
+
+    /// Visits every prefix carrying an action, each before any longer prefix inside it.
+    func forEachPrefix(_ body: (_ hi: UInt64, _ lo: UInt64, _ length: UInt8, _ actionID: Int16) -> Void) {
+        var stack: [(node: Int32, hi: UInt64, lo: UInt64, length: UInt8)] = [(0, 0, 0, 0)]
+        while let (nodeID, hi, lo, length) = stack.popLast() {
+            let node = nodes[Int(nodeID)]
+            if node.actionID != ActionTable.noneID { body(hi, lo, length, node.actionID) }
+            for childID in [node.right, node.left] where childID >= 0 {
+                let child = nodes[Int(childID)]
+                let (tailHi, tailLo) = Self.shiftRight(child.bitsHi, child.bitsLo, length)
+                stack.append((childID, hi | tailHi, lo | tailLo, length + child.bitLen))
+            }
+        }
+    }
+
+    /// Whether a prefix no longer than `length` covers `hi:lo/length`.
+    func hasPrefix(coveringHi hi0: UInt64, lo lo0: UInt64, length: UInt8) -> Bool {
+        if nodes[0].actionID != ActionTable.noneID { return true }
+        var hi = hi0
+        var lo = lo0
+        var remaining = length
+        var nodeID = 0
+        while remaining > 0 {
+            let childID = (hi >> 63 == 0) ? nodes[nodeID].left : nodes[nodeID].right
+            if childID < 0 { return false }
+            let child = nodes[Int(childID)]
+            guard child.bitLen <= remaining,
+                  Self.lcp(aHi: hi, aLo: lo, aLen: remaining,
+                           bHi: child.bitsHi, bLo: child.bitsLo, bLen: child.bitLen) == child.bitLen
+            else { return false }
+            if child.actionID != ActionTable.noneID { return true }
+            (hi, lo) = Self.shiftLeft(hi, lo, child.bitLen)
+            remaining -= child.bitLen
+            nodeID = Int(childID)
+        }
+        return false
+    }
+
+    // MARK: - Compaction
+
+    private struct PrefixKey: Hashable, Comparable {
+        let hi: UInt64
+        let lo: UInt64
+        let length: UInt8
+
+        static func < (a: PrefixKey, b: PrefixKey) -> Bool {
+            (a.hi, a.lo, a.length) < (b.hi, b.lo, b.length)
+        }
+    }
+
+    /// As ``CIDRv4Trie/compact()``.
+    mutating func compact() {
+        var actions: [PrefixKey: Int16] = [:]
+        var byLength = [[PrefixKey]](repeating: [], count: 129)
+        forEachPrefix { hi, lo, length, actionID in
+            let key = PrefixKey(hi: hi, lo: lo, length: length)
+            actions[key] = actionID
+            byLength[Int(length)].append(key)
+        }
+        guard actions.count > 1 else { return }
+
+        for length in stride(from: 128, to: 0, by: -1) {
+            let bitHi: UInt64 = length <= 64 ? UInt64(1) << (64 - length) : 0
+            let bitLo: UInt64 = length > 64 ? UInt64(1) << (128 - length) : 0
+            for key in byLength[length] {
+                let sibling = PrefixKey(hi: key.hi ^ bitHi, lo: key.lo ^ bitLo, length: key.length)
+                guard let action = actions[key], actions[sibling] == action else { continue }
+                actions[key] = nil
+                actions[sibling] = nil
+                let parent = PrefixKey(hi: key.hi & ~bitHi, lo: key.lo & ~bitLo, length: UInt8(length - 1))
+                if actions[parent] == nil { byLength[length - 1].append(parent) }
+                actions[parent] = action
+            }
+        }
+
+        var compacted = CIDRv6Trie()
+        for key in actions.keys.sorted() {
+            let action = actions[key]!
+            var enclosing: Int16?
+            var outer = Int(key.length) - 1
+            while outer >= 0, enclosing == nil {
+                let (hi, lo) = Self.maskTop(key.hi, key.lo, UInt8(outer))
+                enclosing = actions[PrefixKey(hi: hi, lo: lo, length: UInt8(outer))]
+                outer -= 1
+            }
+            if enclosing == action { continue }
+            compacted.insert(hi: key.hi, lo: key.lo, prefixLen: Int(key.length), actionID: action)
+        }
+        self = compacted
+    }
+
+    // MARK: - Patricia core
+
+    private mutating func insertCore(bitsHi: UInt64, bitsLo: UInt64, bitLen: UInt8, actionID: Int16) {
+        var hi = bitsHi
+        var lo = bitsLo
+        var remaining = bitLen
+        var nodeID: Int32 = 0
+
+        while remaining > 0 {
+            let firstBit = UInt8(hi >> 63)
+            let childID = (firstBit == 0) ? nodes[Int(nodeID)].left : nodes[Int(nodeID)].right
+
+            if childID < 0 {
+                let leafID = makeLeaf(bitsHi: hi, bitsLo: lo, bitLen: remaining, actionID: actionID)
+                if firstBit == 0 { nodes[Int(nodeID)].left = leafID }
+                else { nodes[Int(nodeID)].right = leafID }
+                return
+            }
+
+            let childBitsHi = nodes[Int(childID)].bitsHi
+            let childBitsLo = nodes[Int(childID)].bitsLo
+            let childBitLen = nodes[Int(childID)].bitLen
+            let lcp = Self.lcp(
+                aHi: hi, aLo: lo, aLen: remaining,
+                bHi: childBitsHi, bLo: childBitsLo, bLen: childBitLen
+            )
+
+            if lcp == childBitLen {
+                (hi, lo) = Self.shiftLeft(hi, lo, lcp)
+                remaining -= lcp
+                nodeID = childID
+                continue
+            }
+
+            let (midHi, midLo) = Self.maskTop(childBitsHi, childBitsLo, lcp)
+            let (existingNewHi, existingNewLo) = Self.shiftLeft(childBitsHi, childBitsLo, lcp)
+
+            var mid = Node()
+            mid.bitsHi = midHi
+            mid.bitsLo = midLo
+            mid.bitLen = lcp
+            let midID = Int32(nodes.count)
+            nodes.append(mid)
+
+            nodes[Int(childID)].bitsHi = existingNewHi
+            nodes[Int(childID)].bitsLo = existingNewLo
+            nodes[Int(childID)].bitLen = childBitLen - lcp
+
+            if UInt8(existingNewHi >> 63) == 0 { nodes[Int(midID)].left = childID }
+            else { nodes[Int(midID)].right = childID }
+
+            let (newHi, newLo) = Self.shiftLeft(hi, lo, lcp)
+            let newRemaining = remaining - lcp
+            if newRemaining == 0 {
+                nodes[Int(midID)].actionID = actionID
+            } else {
+                let leafID = makeLeaf(bitsHi: newHi, bitsLo: newLo, bitLen: newRemaining, actionID: actionID)
+                if UInt8(newHi >> 63) == 0 { nodes[Int(midID)].left = leafID }
+                else { nodes[Int(midID)].right = leafID }
+            }
+
+            if firstBit == 0 { nodes[Int(nodeID)].left = midID }
+            else { nodes[Int(nodeID)].right = midID }
+            return
+        }
+
+        nodes[Int(nodeID)].actionID = actionID
+    }
+
+    private mutating func makeLeaf(bitsHi: UInt64, bitsLo: UInt64, bitLen: UInt8, actionID: Int16) -> Int32 {
+        var leaf = Node()
+        leaf.bitsHi = bitsHi
+        leaf.bitsLo = bitsLo
+        leaf.bitLen = bitLen
+        leaf.actionID = actionID
+        let id = Int32(nodes.count)
+        nodes.append(leaf)
+        return id
+    }
+
+    // MARK: - 128-bit bit ops
+
+    fileprivate static func shiftLeft(_ hi: UInt64, _ lo: UInt64, _ amount: UInt8) -> (UInt64, UInt64) {
+        let n = Int(amount)
+        if n == 0 { return (hi, lo) }
+        if n >= 128 { return (0, 0) }
+        if n >= 64 { return (lo << (n - 64), 0) }
+        return ((hi << n) | (lo >> (64 - n)), lo << n)
+    }
+
+    private static func shiftRight(_ hi: UInt64, _ lo: UInt64, _ amount: UInt8) -> (UInt64, UInt64) {
+        let n = Int(amount)
+        if n == 0 { return (hi, lo) }
+        if n >= 128 { return (0, 0) }
+        if n >= 64 { return (0, hi >> (n - 64)) }
+        return (hi >> n, (lo >> n) | (hi << (64 - n)))
+    }
+
+    private static func maskTop(_ hi: UInt64, _ lo: UInt64, _ n: UInt8) -> (UInt64, UInt64) {
+        let count = Int(n)
+        if count == 0 { return (0, 0) }
+        if count >= 128 { return (hi, lo) }
+        if count <= 64 {
+            let mask: UInt64 = (count == 64) ? ~0 : ~UInt64(0) << (64 - count)
+            return (hi & mask, 0)
+        }
+        let mask = ~UInt64(0) << (128 - count)
+        return (hi, lo & mask)
+    }
+
+    fileprivate static func lcp(aHi: UInt64, aLo: UInt64, aLen: UInt8,
+                            bHi: UInt64, bLo: UInt64, bLen: UInt8) -> UInt8 {
+        let cap = min(aLen, bLen)
+        if cap == 0 { return 0 }
+        let dHi = aHi ^ bHi
+        if dHi != 0 { return min(cap, UInt8(dHi.leadingZeroBitCount)) }
+        let dLo = aLo ^ bLo
+        if dLo != 0 { return min(cap, 64 + UInt8(dLo.leadingZeroBitCount)) }
+        return cap
+    }
+
+    /// Packs up to 16 big-endian bytes into a (hi, lo) 128-bit pair.
+    static func pack16(_ buf: UnsafeBufferPointer<UInt8>) -> (UInt64, UInt64) {
+        var hi: UInt64 = 0
+        var lo: UInt64 = 0
+        let count = min(16, buf.count)
+        for i in 0..<count {
+            let byte = UInt64(buf[i])
+            if i < 8 {
+                hi |= byte << ((7 - i) * 8)
+            } else {
+                lo |= byte << ((7 - (i - 8)) * 8)
+            }
+        }
+        return (hi, lo)
+    }
+}
+
+// MARK: - Routing image
+//
+// The v6 trie's nodes are written column-per-field (struct of arrays) rather
+// than as the padded in-memory structs, so the image layout doesn't depend on
+// Swift's struct layout.
+//
+// The v4 trie is compiled instead into a 16-8-8 multibit table: a direct
+// 65,536-entry first level, then 256-way chunks for the third and fourth
+// bytes, with every prefix pushed down to the entries it covers so no entry
+// needs a prefix comparison. Chunks are stored poptrie-style: a 256-bit bitmap
+// marks where a chunk's entry changes from the previous one and only those
+// entries are kept, indexed by popcount, so geoip-sized /17–/24 sets stay
+// small. A lookup is at most three table steps.
+//
+// Table entry (Int32): >= 0 is a leaf holding `actionID + 1` (0 = no match);
+// < 0 is `~chunkIndex`.
+
+extension CIDRv4Trie {
+    /// Appends the stride-table columns read back by ``CIDRv4TableView``.
+    /// A trie with no prefixes writes an empty first level.
+    func write(to writer: inout RoutingImageWriter) {
+        var level1 = ContiguousArray<Int32>()
+        var chunks: [ContiguousArray<Int32>] = []
+        if nodes.count > 1 || nodes[0].actionID != ActionTable.noneID {
+            level1 = ContiguousArray(repeating: 0, count: 1 << 16)
+            forEachPrefix { network, length, actionID in
+                Self.paint(network: network, length: Int(length), leaf: Int32(actionID) + 1,
+                           level1: &level1, chunks: &chunks)
+            }
+        }
+
+        var chunkBitmap = ContiguousArray<UInt64>()
+        var chunkRank = ContiguousArray<UInt32>()
+        var chunkEntries = ContiguousArray<Int32>()
+        chunkBitmap.reserveCapacity(chunks.count * 4)
+        chunkRank.reserveCapacity(chunks.count * 4)
+        for chunk in chunks {
+            var words: [UInt64] = [0, 0, 0, 0]
+            let start = chunkEntries.count
+            for i in 0..<256 where i == 0 || chunk[i] != chunk[i - 1] {
+                words[i >> 6] |= UInt64(1) << UInt64(i & 63)
+                chunkEntries.append(chunk[i])
+            }
+            var before = start
+            for word in words {
+                chunkBitmap.append(word)
+                chunkRank.append(UInt32(before))
+                before += word.nonzeroBitCount
+            }
+        }
+
+        writer.column(level1)
+        writer.column(chunkBitmap)
+        writer.column(chunkRank)
+        writer.column(chunkEntries)
+    }
+
+    /// Overwrites the entries `network/length` covers with `leaf`, splitting
+    /// first-level entries and chunk entries into chunks as needed. Anything
+    /// overwritten came from a shorter prefix, as `forEachPrefix` orders them.
+    private static func paint(network: UInt32, length: Int, leaf: Int32,
+                              level1: inout ContiguousArray<Int32>, chunks: inout [ContiguousArray<Int32>]) {
+        let i1 = Int(network >> 16)
+        if length <= 16 {
+            for i in i1..<(i1 + (1 << (16 - length))) { level1[i] = leaf }
+            return
+        }
+        if level1[i1] >= 0 {
+            chunks.append(ContiguousArray(repeating: level1[i1], count: 256))
+            level1[i1] = ~Int32(chunks.count - 1)
+        }
+        let c2 = Int(~level1[i1])
+        let i2 = Int((network >> 8) & 0xFF)
+        if length <= 24 {
+            for i in i2..<(i2 + (1 << (24 - length))) { chunks[c2][i] = leaf }
+            return
+        }
+        if chunks[c2][i2] >= 0 {
+            chunks.append(ContiguousArray(repeating: chunks[c2][i2], count: 256))
+            chunks[c2][i2] = ~Int32(chunks.count - 1)
+        }
+        let c3 = Int(~chunks[c2][i2])
+        let i3 = Int(network & 0xFF)
+        for i in i3..<(i3 + (1 << (32 - length))) { chunks[c3][i] = leaf }
+    }
+}
+
+extension CIDRv6Trie {
+    /// Appends the node columns read back by ``CIDRv6TrieView``.
+    func write(to writer: inout RoutingImageWriter) {
+        writer.column(nodes.map(\.bitsHi))
+        writer.column(nodes.map(\.bitsLo))
+        writer.column(nodes.map(\.left))
+        writer.column(nodes.map(\.right))
+        writer.column(nodes.map(\.actionID))
+        writer.column(nodes.map(\.bitLen))
+    }
+}
+
+/// A compiled ``CIDRv4Trie`` queried in place from routing-image columns;
+/// the image must outlive the view.
+nonisolated struct CIDRv4TableView {
+    private let level1: UnsafeBufferPointer<Int32>
+    private let chunkBitmap: UnsafeBufferPointer<UInt64>
+    private let chunkRank: UnsafeBufferPointer<UInt32>
+    private let chunkEntries: UnsafeBufferPointer<Int32>
+
+    /// Reads the columns ``CIDRv4Trie/write(to:)`` appended, checking every
+    /// chunk reference and popcount index lands inside its column.
+    init?(columns: inout RoutingImage.Columns) {
+        guard let level1 = columns.next(Int32.self), let chunkBitmap = columns.next(UInt64.self),
+              let chunkRank = columns.next(UInt32.self), let chunkEntries = columns.next(Int32.self),
+              level1.isEmpty || level1.count == 1 << 16,
+              chunkBitmap.count == chunkRank.count, chunkBitmap.count % 4 == 0
+        else { return nil }
+        let chunkCount = chunkBitmap.count / 4
+        func isValid(_ entry: Int32) -> Bool { entry >= 0 || Int(~entry) < chunkCount }
+        guard level1.allSatisfy(isValid), chunkEntries.allSatisfy(isValid) else { return nil }
+        for c in 0..<chunkCount {
+            guard chunkBitmap[c * 4] & 1 != 0 else { return nil }
+            for w in 0..<4 where Int(chunkRank[c * 4 + w]) + chunkBitmap[c * 4 + w].nonzeroBitCount > chunkEntries.count {
+                return nil
+            }
+        }
+        self.level1 = level1
+        self.chunkBitmap = chunkBitmap
+        self.chunkRank = chunkRank
+        self.chunkEntries = chunkEntries
+    }
+
+    /// Longest-prefix action, or `ActionTable.noneID`.
+    func lookup(_ ip: UInt32) -> Int16 {
+        guard !level1.isEmpty else { return ActionTable.noneID }
+        var entry = level1[Int(ip >> 16)]
+        if entry < 0 {
+            entry = chunkEntry(Int(~entry), Int((ip >> 8) & 0xFF))
+            if entry < 0 { entry = chunkEntry(Int(~entry), Int(ip & 0xFF)) }
+        }
+        return Int16(truncatingIfNeeded: entry &- 1)
+    }
+
+    /// Entry `index` of chunk `chunk`: the last kept entry at or before it.
+    @inline(__always)
+    private func chunkEntry(_ chunk: Int, _ index: Int) -> Int32 {
+        let w = chunk &* 4 &+ index >> 6
+        let upTo = chunkBitmap[w] & (~UInt64(0) >> UInt64(63 &- (index & 63)))
+        return chunkEntries[Int(chunkRank[w]) &+ upTo.nonzeroBitCount &- 1]
+    }
+}
+
+/// A ``CIDRv6Trie`` queried in place from routing-image columns; the image
+/// must outlive the view.
+nonisolated struct CIDRv6TrieView {
+    private let bitsHi: UnsafeBufferPointer<UInt64>
+    private let bitsLo: UnsafeBufferPointer<UInt64>
+    private let left: UnsafeBufferPointer<Int32>
+    private let right: UnsafeBufferPointer<Int32>
+    private let actionID: UnsafeBufferPointer<Int16>
+    private let bitLen: UnsafeBufferPointer<UInt8>
+
+    init?(columns: inout RoutingImage.Columns) {
+        guard let bitsHi = columns.next(UInt64.self), let bitsLo = columns.next(UInt64.self),
+              let left = columns.next(Int32.self), let right = columns.next(Int32.self),
+              let actionID = columns.next(Int16.self), let bitLen = columns.next(UInt8.self),
+              !bitsHi.isEmpty, bitsLo.count == bitsHi.count, left.count == bitsHi.count,
+              right.count == bitsHi.count, actionID.count == bitsHi.count, bitLen.count == bitsHi.count
+        else { return nil }
+        self.bitsHi = bitsHi
+        self.bitsLo = bitsLo
+        self.left = left
+        self.right = right
+        self.actionID = actionID
+        self.bitLen = bitLen
+    }
+
+    /// Deepest action along the path for a packed 128-bit address, or `ActionTable.noneID`.
+    func lookup(hi hi0: UInt64, lo lo0: UInt64) -> Int16 {
+        var hi = hi0
+        var lo = lo0
+        var remaining: UInt8 = 128
+        var nodeID = 0
+        var deepest = actionID[0]
+
+        while remaining > 0 {
+            let childID = (hi >> 63 == 0) ? left[nodeID] : right[nodeID]
+            if childID < 0 { return deepest }
+
+            let child = Int(childID)
+            let childBitLen = bitLen[child]
+            let lcp = CIDRv6Trie.lcp(
+                aHi: hi, aLo: lo, aLen: remaining,
+                bHi: bitsHi[child], bLo: bitsLo[child], bLen: childBitLen
+            )
+            if lcp < childBitLen { return deepest }
+
+            (hi, lo) = CIDRv6Trie.shiftLeft(hi, lo, childBitLen)
+            remaining -= childBitLen
+            nodeID = child
+            if actionID[child] != ActionTable.noneID { deepest = actionID[child] }
+        }
+
+        return deepest
+    }
+}
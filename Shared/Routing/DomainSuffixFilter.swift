@@ -0,0 +1,131 @@
+//
+//  DomainSuffixFilter.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Split-block Bloom filter over every label sequence the merged suffix trie
+/// holds a rule for. Most lookups match no suffix rule at all; one probe per
+/// label of the queried host — each a single 32-byte block — proves that,
+/// so only a possible hit pays for the trie walk. About 10 bits per rule,
+/// for a false-positive rate near 1%.
+nonisolated struct DomainSuffixFilter {
+    static let bitsPerKey = 10
+    /// Eight 32-bit words, one bit set in each per key.
+    static let wordsPerBlock = 8
+
+    private var words: [UInt32]
+
+    init(keyCount: Int) {
+        let blocks = keyCount == 0 ? 0 : max(1, (keyCount * Self.bitsPerKey + 255) / 256)
+        words = [UInt32](repeating: 0, count: blocks * Self.wordsPerBlock)
+    }
+
+    /// Adds `suffix`'s whole label sequence; a suffix with no labels is never matched and adds nothing.
+    mutating func insert(suffix: UnsafeBufferPointer<UInt8>) {
+        guard !words.isEmpty else { return }
+        var last: UInt64?
+        Self.forEachSuffixKey(suffix) { key in
+            last = key
+            return false
+        }
+        guard let key = last else { return }
+        let block = Self.block(for: key, blockCount: words.count / Self.wordsPerBlock) * Self.wordsPerBlock
+        let pattern = UInt32(truncatingIfNeeded: key)
+        for i in 0..<Self.wordsPerBlock {
+            words[block + i] |= Self.bit(pattern, i)
+        }
+    }
+
+    /// Appends the column read back by ``DomainSuffixFilterView``.
+    func write(to writer: inout RoutingImageWriter) {
+        writer.column(words)
+    }
+
+    // MARK: - Hashing
+    //
+    // Labels are read right to left and empty ones skipped, exactly as the trie
+    // walk splits them, and hashed as one running FNV-1a over the TLD-first
+    // sequence, so every suffix of a host costs one pass over its bytes.
+
+    private static let salts: [UInt32] = [
+        0x47B6_137B, 0x4497_4D91, 0x8824_AD5B, 0xA2B7_289D,
+        0x7054_95C7, 0x2DF1_424B, 0x9EFC_4947, 0x5C6B_FB31,
+    ]
+
+    /// Calls `body` with the key of each label suffix of `host`, TLD first,
+    /// until it returns `true`.
+    @inline(__always)
+    static func forEachSuffixKey(_ host: UnsafeBufferPointer<UInt8>, _ body: (UInt64) -> Bool) {
+        let dot = UInt8(ascii: ".")
+        var hash: UInt64 = 0xCBF2_9CE4_8422_2325
+        var first = true
+        var end = host.count
+        while end > 0 {
+            var start = end
+            while start > 0 && host[start - 1] != dot { start -= 1 }
+            if end > start {
+                if !first { hash = (hash ^ UInt64(dot)) &* 0x0000_0100_0000_01B3 }
+                first = false
+                for k in start..<end {
+                    hash = (hash ^ UInt64(host[k])) &* 0x0000_0100_0000_01B3
+                }
+                if body(mix(hash)) { return }
+            }
+            end = start - 1
+        }
+    }
+
+    /// SplitMix64's finalizer; FNV's low bits alone are too weak to index with.
+    @inline(__always)
+    private static func mix(_ x: UInt64) -> UInt64 {
+        var z = x
+        z = (z ^ (z >> 30)) &* 0xBF58_476D_1CE4_E5B9
+        z = (z ^ (z >> 27)) &* 0x94D0_49BB_1331_11EB
+        return z ^ (z >> 31)
+    }
+
+    @inline(__always)
+    fileprivate static func block(for key: UInt64, blockCount: Int) -> Int {
+        Int(((key >> 32) &* UInt64(blockCount)) >> 32)
+    }
+
+    @inline(__always)
+    fileprivate static func bit(_ pattern: UInt32, _ word: Int) -> UInt32 {
+        1 << ((pattern &* salts[word]) >> 27)
+    }
+}
+
+/// A ``DomainSuffixFilter`` queried in place from its routing-image column;
+/// the image must outlive the view.
+nonisolated struct DomainSuffixFilterView {
+    private let words: UnsafeBufferPointer<UInt32>
+
+    init?(columns: inout RoutingImage.Columns) {
+        guard let words = columns.next(UInt32.self),
+              words.count % DomainSuffixFilter.wordsPerBlock == 0 else { return nil }
+        self.words = words
+    }
+
+    /// False only when no suffix of `host` can have a rule; an empty filter
+    /// means the trie has none.
+    func mayMatch(_ host: UnsafeBufferPointer<UInt8>) -> Bool {
+        guard !words.isEmpty else { return false }
+        let blockCount = words.count / DomainSuffixFilter.wordsPerBlock
+        var hit = false
+        DomainSuffixFilter.forEachSuffixKey(host) { key in
+            let block = DomainSuffixFilter.block(for: key, blockCount: blockCount) * DomainSuffixFilter.wordsPerBlock
+            let pattern = UInt32(truncatingIfNeeded: key)
+            for i in 0..<DomainSuffixFilter.wordsPerBlock
+            where words[block + i] & DomainSuffixFilter.bit(pattern, i) == 0 {
+                return false
+            }
+            hit = true
+            return true
+        }
+        return hit
+    }
+}
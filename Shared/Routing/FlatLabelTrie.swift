@@ -10,16 +10,101 @@ import Foundation
 // MARK: - Succinct bitvector
 //
 // A LOUDS-encoded trie navigates by rank/select over two bitvectors rather than
-// by following stored child pointers. This is a minimal rank/select structure:
-// the rank index is one `UInt32` cumulative popcount per 64-bit word (~0.5 bits
-// of overhead per stored bit). `lookup` only needs `rank1` and `select0`; both
-// are O(log words) here (a binary search over the rank index plus an in-word
-// scan), which is more than fast enough at this scale and keeps the structure
-// tiny. Value type with COW arrays, so a frozen trie is safe for concurrent reads.
-
-fileprivate struct LOUDSBitVector {
-    private(set) var words: ContiguousArray<UInt64> = []
-    private(set) var rank: ContiguousArray<UInt32> = []      // rank[w] = #ones in words[0..<w]
+// by following stored child pointers. The index is rank9 (Vigna, "Broadword
+// Implementation of Rank/Select Queries"): bits are grouped into 512-bit blocks
+// of eight words, each stored right after two index words — the number of ones
+// before the block, and the block-relative counts before words 1…7 packed nine
+// bits apiece. `rank1` then reads one 80-byte block and does one popcount.
+// `select0` starts at a sampled block (one sample per 512 zeros) and scans
+// forward; LOUDS is about half zeros, so that is the sample's block or the
+// next. Value type with COW arrays, so a frozen trie is safe for concurrent reads.
+
+nonisolated fileprivate enum RankSelect {
+    /// Two index words plus eight data words.
+    static let blockWords = 10
+    static let zerosPerSample = 512
+
+    /// Interleaved blocks and select0 samples for `words`. One block past the
+    /// last bit always exists, so `rank1(nbits)` needs no special case.
+    static func index(words: ContiguousArray<UInt64>, nbits: Int) -> (blocks: ContiguousArray<UInt64>, zeroSamples: ContiguousArray<UInt32>) {
+        let blockCount = (nbits >> 9) + 1
+        var blocks = ContiguousArray<UInt64>(repeating: 0, count: blockCount * blockWords)
+        var zeroSamples: ContiguousArray<UInt32> = []
+        var ones = 0
+        var zeros = 0
+        for b in 0..<blockCount {
+            let base = b * blockWords
+            blocks[base] = UInt64(ones)
+            var packed: UInt64 = 0
+            var inBlock = 0
+            for t in 0..<8 {
+                if t > 0 { packed |= UInt64(inBlock) << UInt64(9 * (t - 1)) }
+                let w = b * 8 + t
+                let word = w < words.count ? words[w] : 0
+                blocks[base + 2 + t] = word
+                inBlock += word.nonzeroBitCount
+            }
+            blocks[base + 1] = packed
+
+            // Sample `j` names the block holding zero number `j * 512 + 1`.
+            let blockZeros = Swift.max(0, Swift.min(512, nbits - (b << 9))) - inBlock
+            while zeroSamples.count * zerosPerSample < zeros + blockZeros { zeroSamples.append(UInt32(b)) }
+            zeros += blockZeros
+            ones += inBlock
+        }
+        return (blocks, zeroSamples)
+    }
+
+    /// Number of set bits in `[0, i)`. `i` may equal `nbits`.
+    @inline(__always)
+    static func rank1(_ blocks: UnsafeBufferPointer<UInt64>, _ i: Int) -> Int {
+        let base = (i >> 9) &* blockWords
+        let sub = (i >> 6) & 7
+        var r = Int(blocks[base])
+        if sub != 0 { r &+= Int((blocks[base + 1] >> UInt64(9 &* (sub &- 1))) & 0x1FF) }
+        let rem = i & 63
+        if rem != 0 { r &+= (blocks[base + 2 + sub] & ((UInt64(1) << UInt64(rem)) &- 1)).nonzeroBitCount }
+        return r
+    }
+
+    /// 0-based position of the `k`-th zero (1-based `k`, at most the number of
+    /// zeros). Padding past `nbits` reads as zeros but follows every real one.
+    @inline(__always)
+    static func select0(_ blocks: UnsafeBufferPointer<UInt64>, _ zeroSamples: UnsafeBufferPointer<UInt32>, _ k: Int) -> Int {
+        @inline(__always) func zerosBefore(_ block: Int) -> Int {
+            (block << 9) &- Int(blocks[block &* blockWords])
+        }
+        let blockCount = blocks.count / blockWords
+        var b = Int(zeroSamples[(k &- 1) >> 9])
+        while b + 1 < blockCount && zerosBefore(b + 1) < k { b += 1 }
+
+        let base = b &* blockWords
+        var remaining = k &- zerosBefore(b)
+        let packed = blocks[base + 1]
+        var t = 7
+        while t > 0 {
+            let zerosBeforeWord = (t << 6) &- Int((packed >> UInt64(9 &* (t &- 1))) & 0x1FF)
+            if zerosBeforeWord < remaining { remaining &-= zerosBeforeWord; break }
+            t -= 1
+        }
+
+        var word = ~blocks[base + 2 + t]
+        var pos = 0
+        while true {
+            pos = word.trailingZeroBitCount
+            remaining -= 1
+            if remaining == 0 { break }
+            word &= word &- 1
+        }
+        return (b << 9) + (t << 6) + pos
+    }
+}
+
+nonisolated fileprivate struct LOUDSBitVector {
+    /// Raw bits while appending; moved into `blocks` by `build()`.
+    private var words: ContiguousArray<UInt64> = []
+    private(set) var blocks: ContiguousArray<UInt64> = []
+    private(set) var zeroSamples: ContiguousArray<UInt32> = []
     private(set) var nbits: Int = 0
 
     mutating func append(_ bit: Bool) {
@@ -29,52 +114,27 @@ fileprivate struct LOUDSBitVector {
         nbits += 1
     }
 
-    /// Builds the cumulative-popcount index. Call once after all `append`s.
+    /// Builds the rank/select index. Call once after all `append`s.
     mutating func build() {
-        rank = ContiguousArray(repeating: 0, count: words.count + 1)
-        var acc: UInt32 = 0
-        for i in 0..<words.count {
-            rank[i] = acc
-            acc &+= UInt32(words[i].nonzeroBitCount)
-        }
-        rank[words.count] = acc
+        (blocks, zeroSamples) = RankSelect.index(words: words, nbits: nbits)
+        words = []
     }
 
-    /// Number of set bits in `[0, i)`. `i` may equal `nbits`.
+    /// See ``RankSelect/rank1(_:_:)``.
     @inline(__always)
     func rank1(_ i: Int) -> Int {
-        let w = i >> 6, rem = i & 63
-        var r = Int(rank[w])
-        if rem != 0 { r += (words[w] & ((UInt64(1) << UInt64(rem)) &- 1)).nonzeroBitCount }
-        return r
+        blocks.withUnsafeBufferPointer { RankSelect.rank1($0, i) }
     }
 
-    /// 0-based position of the `k`-th zero (1-based `k`). Padding bits past
-    /// `nbits` in the final word are masked off so they are never selected.
+    /// See ``RankSelect/select0(_:_:_:)``.
     @inline(__always)
     func select0(_ k: Int) -> Int {
-        var lo = 0, hi = words.count
-        while lo < hi {
-            let mid = (lo + hi) >> 1
-            let bitsUpTo = Swift.min((mid + 1) << 6, nbits)
-            if bitsUpTo - Int(rank[mid + 1]) < k { lo = mid + 1 } else { hi = mid }
+        blocks.withUnsafeBufferPointer { blocks in
+            zeroSamples.withUnsafeBufferPointer { RankSelect.select0(blocks, $0, k) }
         }
-        let w = lo
-        var remaining = k - ((w << 6) - Int(rank[w]))
-        let valid = Swift.min(64, nbits - (w << 6))
-        let mask: UInt64 = valid >= 64 ? ~0 : ((UInt64(1) << UInt64(valid)) &- 1)
-        var word = (~words[w]) & mask
-        var pos = 0
-        while true {
-            pos = word.trailingZeroBitCount
-            remaining -= 1
-            if remaining == 0 { break }
-            word &= word &- 1
-        }
-        return (w << 6) + pos
     }
 
-    var byteSize: Int { words.count * 8 + rank.count * MemoryLayout<UInt32>.stride }
+    var byteSize: Int { blocks.count * 8 + zeroSamples.count * MemoryLayout<UInt32>.stride }
 }
 
 // MARK: - FlatLabelTrie
@@ -98,7 +158,7 @@ fileprivate struct LOUDSBitVector {
 // the mostly-nil `[Payload?]` array (payloads are kept only at terminals),
 // roughly halving the footprint for large suffix sets while making lookups
 // faster than the old linear edge scan at high fan-out (e.g. many `*.com` rules).
-struct FlatLabelTrie<Payload> {
+nonisolated struct FlatLabelTrie<Payload> {
 
     // MARK: - Build state (dropped on freeze)
 
@@ -456,3 +516,180 @@ extension FlatLabelTrie {
         }
     }
 }
+
+extension FlatLabelTrie where Payload: Equatable {
+
+    /// Drops the entries a lookup can't tell from their absence: all but the last of
+    /// a repeated suffix, a suffix with no labels (never matched), and a suffix whose
+    /// nearest enclosing suffix carries the same payload, since everything under it
+    /// resolves the same without it. Leaves `entries` in ``buildBulk(base:entries:)``
+    /// order.
+    static func pruneRedundant(base: UnsafeBufferPointer<UInt8>, entries: inout [BulkEntry]) {
+        let dot = UInt8(ascii: ".")
+        entries.sort { a, b in
+            let c = compareReversedLabels(base, a.offset, a.length, b.offset, b.length, dot: dot)
+            return c != 0 ? c < 0 : a.order < b.order
+        }
+
+        var kept: [BulkEntry] = []
+        kept.reserveCapacity(entries.count)
+        // Kept entries enclosing the current one, outermost first.
+        var enclosing: [BulkEntry] = []
+        for (i, entry) in entries.enumerated() {
+            var end = Int(entry.offset) + Int(entry.length)
+            guard nextLabel(base, &end, Int(entry.offset), dot) != nil else { continue }
+            // A repeated suffix sorts by order; only its last occurrence counts.
+            if i + 1 < entries.count,
+               compareReversedLabels(base, entry.offset, entry.length,
+                                     entries[i + 1].offset, entries[i + 1].length, dot: dot) == 0 {
+                continue
+            }
+            while let outer = enclosing.last, !encloses(base, outer, entry, dot: dot) {
+                enclosing.removeLast()
+            }
+            if let outer = enclosing.last, outer.payload == entry.payload { continue }
+            kept.append(entry)
+            enclosing.append(entry)
+        }
+        entries = kept
+    }
+
+    /// Whether `outer`'s labels are the leading (rightmost) labels of `inner`'s.
+    private static func encloses(_ base: UnsafeBufferPointer<UInt8>, _ outer: BulkEntry, _ inner: BulkEntry, dot: UInt8) -> Bool {
+        var outerEnd = Int(outer.offset) + Int(outer.length)
+        var innerEnd = Int(inner.offset) + Int(inner.length)
+        while let a = nextLabel(base, &outerEnd, Int(outer.offset), dot) {
+            guard let b = nextLabel(base, &innerEnd, Int(inner.offset), dot),
+                  bytesEqual(base, Int32(a.start), Int32(a.length), Int32(b.start), Int32(b.length)) else { return false }
+        }
+        return true
+    }
+}
+
+// MARK: - Routing image
+//
+// The frozen arrays are written verbatim as routing-image columns, so the
+// extension can query a trie compiled by the app straight out of the mapped
+// file. `FlatLabelTrieView` is `lookup` over those columns.
+
+extension FlatLabelTrie where Payload == Int16 {
+    /// Appends the frozen trie as columns read back by ``FlatLabelTrieView``.
+    func write(to writer: inout RoutingImageWriter) {
+        writer.column([UInt32(nodeCount), UInt32(louds.nbits), UInt32(term.nbits)])
+        writer.column(louds.blocks)
+        writer.column(louds.zeroSamples)
+        writer.column(term.blocks)
+        writer.column(term.zeroSamples)
+        writer.column(labelOff)
+        writer.column(labelBytes)
+        writer.column(payloadTable)
+    }
+}
+
+nonisolated fileprivate struct LOUDSBitVectorView {
+    let blocks: UnsafeBufferPointer<UInt64>
+    let zeroSamples: UnsafeBufferPointer<UInt32>
+    let nbits: Int
+
+    init?(blocks: UnsafeBufferPointer<UInt64>, zeroSamples: UnsafeBufferPointer<UInt32>, nbits: Int) {
+        guard nbits >= 0, blocks.count == ((nbits >> 9) + 1) * RankSelect.blockWords else { return nil }
+        let zeros = nbits - RankSelect.rank1(blocks, nbits)
+        let blockCount = UInt32(blocks.count / RankSelect.blockWords)
+        guard zeros >= 0, zeroSamples.count == (zeros + RankSelect.zerosPerSample - 1) / RankSelect.zerosPerSample,
+              zeroSamples.allSatisfy({ $0 < blockCount }) else { return nil }
+        self.blocks = blocks
+        self.zeroSamples = zeroSamples
+        self.nbits = nbits
+    }
+
+    @inline(__always)
+    func rank1(_ i: Int) -> Int { RankSelect.rank1(blocks, i) }
+
+    @inline(__always)
+    func select0(_ k: Int) -> Int { RankSelect.select0(blocks, zeroSamples, k) }
+}
+
+/// A frozen `FlatLabelTrie<Int16>` queried in place from routing-image
+/// columns; the image must outlive the view.
+nonisolated struct FlatLabelTrieView {
+    private let louds: LOUDSBitVectorView
+    private let term: LOUDSBitVectorView
+    private let labelOff: UnsafeBufferPointer<Int32>
+    private let labelBytes: UnsafeBufferPointer<UInt8>
+    private let payloadTable: UnsafeBufferPointer<Int16>
+    private let nodeCount: Int
+
+    /// Reads the columns ``FlatLabelTrie/write(to:)`` appended, checking
+    /// their sizes agree.
+    init?(columns: inout RoutingImage.Columns) {
+        guard let counts = columns.next(UInt32.self), counts.count == 3,
+              let loudsBlocks = columns.next(UInt64.self), let loudsSamples = columns.next(UInt32.self),
+              let termBlocks = columns.next(UInt64.self), let termSamples = columns.next(UInt32.self),
+              let labelOff = columns.next(Int32.self), let labelBytes = columns.next(UInt8.self),
+              let payloadTable = columns.next(Int16.self),
+              let louds = LOUDSBitVectorView(blocks: loudsBlocks, zeroSamples: loudsSamples, nbits: Int(counts[1])),
+              let term = LOUDSBitVectorView(blocks: termBlocks, zeroSamples: termSamples, nbits: Int(counts[2]))
+        else { return nil }
+        let nodeCount = Int(counts[0])
+        guard nodeCount == 0 || (labelOff.count == nodeCount + 1
+                                 && term.nbits == nodeCount
+                                 && louds.nbits == 2 * nodeCount + 1
+                                 && Int(labelOff[nodeCount]) == labelBytes.count
+                                 && term.rank1(term.nbits) == payloadTable.count)
+        else { return nil }
+        self.louds = louds
+        self.term = term
+        self.labelOff = labelOff
+        self.labelBytes = labelBytes
+        self.payloadTable = payloadTable
+        self.nodeCount = nodeCount
+    }
+
+    /// Same walk as ``FlatLabelTrie/lookup(_:)``.
+    func lookup(_ host: UnsafeBufferPointer<UInt8>) -> Int16? {
+        guard nodeCount > 0 else { return nil }
+
+        var deepest: Int16? = nil
+        var node = 0
+
+        let dot = UInt8(ascii: ".")
+        var end = host.count
+        while end > 0 {
+            var start = end
+            while start > 0 && host[start - 1] != dot { start -= 1 }
+            let labelLen = end - start
+            if labelLen == 0 { end = start - 1; continue }
+
+            let z1 = louds.select0(node + 1)
+            let z2 = louds.select0(node + 2)
+            let childCount = z2 - z1 - 1
+            if childCount == 0 { return deepest }
+            let firstChildID = louds.rank1(z1 + 2) - 1
+
+            var lo = firstChildID, hi = firstChildID + childCount
+            var found = -1
+            while lo < hi {
+                let mid = (lo + hi) >> 1
+                let o = Int(labelOff[mid]); let n = Int(labelOff[mid + 1]) - o
+                let m = Swift.min(n, labelLen)
+                var k = 0; var c = 0
+                while k < m {
+                    let a = labelBytes[o + k], b = host[start + k]
+                    if a != b { c = a < b ? -1 : 1; break }
+                    k += 1
+                }
+                if c == 0 { c = (n == labelLen) ? 0 : (n < labelLen ? -1 : 1) }
+                if c < 0 { lo = mid + 1 } else if c > 0 { hi = mid } else { found = mid; break }
+            }
+
+            if found < 0 { return deepest }
+            node = found
+            let r = term.rank1(node)
+            if term.rank1(node + 1) - r == 1 { deepest = payloadTable[r] }
+
+            end = start - 1
+        }
+
+        return deepest
+    }
+}
@@ -0,0 +1,288 @@
+//
+//  GeoIPTable.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+// MARK: - Format
+//
+// The bundled country CIDR lists as one sorted range table over the IPv4
+// space, so Country Bypass answers "is this address in country X" with a
+// binary search instead of carrying the country's prefixes through the
+// routing image. The app writes it once per build; the extension maps it.
+//
+//   magic "AGI1", version u32, stamp length u16, stamp UTF-8 (the app build)
+//   countryCount u8, countryCount × 2-byte ISO code
+//   rangeCount u32, blockCount u32
+//   blocks      blockCount × (first start u32, delta offset u32)
+//   countries   rangeCount × u8, 0 = none, else 1 + index into the codes
+//   deltas      per block, each start after the first as a LEB128 delta
+//
+// All integers little-endian. Range `i` runs from its start to the next
+// range's start - 1 (the last to 255.255.255.255); the first starts at 0.
+
+nonisolated enum GeoIPTableFormat {
+    static let magic: [UInt8] = [0x41, 0x47, 0x49, 0x31]    // "AGI1"
+    static let version: UInt32 = 1
+    /// Ranges per block: one binary search, then at most this many deltas decoded.
+    static let blockSize = 64
+}
+
+nonisolated struct GeoIPTable {
+
+    private let data: Data
+    /// Offsets from `data.startIndex`.
+    private let blocksStart: Int
+    private let countriesStart: Int
+    private let deltasStart: Int
+    private let rangeCount: Int
+    private let blockCount: Int
+
+    let stamp: String
+    let countryCodes: [String]
+
+    /// Maps the file at `url`; nil if it is missing or malformed.
+    init?(contentsOf url: URL) {
+        guard let data = try? Data(contentsOf: url, options: .alwaysMapped) else { return nil }
+        self.init(data: data)
+    }
+
+    init?(data: Data) {
+        typealias Header = (stamp: String, codes: [String], rangeCount: Int, blockCount: Int,
+                            blocksStart: Int, countriesStart: Int, deltasStart: Int)
+        let header: Header? = data.withUnsafeBytes { raw in
+            let bytes = raw.bindMemory(to: UInt8.self)
+            guard bytes.count >= 10, bytes.starts(with: GeoIPTableFormat.magic),
+                  Self.u32(bytes, 4) == GeoIPTableFormat.version else { return nil }
+            let stampLength = Int(Self.u16(bytes, 8))
+            var cursor = 10 + stampLength
+            guard cursor < bytes.count else { return nil }
+            let stamp = String(decoding: bytes[10..<cursor], as: UTF8.self)
+            let countryCount = Int(bytes[cursor])
+            cursor += 1
+            guard cursor + 2 * countryCount + 8 <= bytes.count else { return nil }
+            let codes = (0..<countryCount).map { i in
+                String(decoding: bytes[(cursor + 2 * i)..<(cursor + 2 * i + 2)], as: UTF8.self)
+            }
+            cursor += 2 * countryCount
+            let rangeCount = Int(Self.u32(bytes, cursor))
+            let blockCount = Int(Self.u32(bytes, cursor + 4))
+            cursor += 8
+            guard rangeCount > 0, rangeCount <= bytes.count,
+                  blockCount == (rangeCount + GeoIPTableFormat.blockSize - 1) / GeoIPTableFormat.blockSize
+            else { return nil }
+            let blocksStart = cursor
+            let countriesStart = blocksStart + 8 * blockCount
+            let deltasStart = countriesStart + rangeCount
+            guard deltasStart <= bytes.count else { return nil }
+            var previousStart: UInt32 = 0
+            for b in 0..<blockCount {
+                let start = Self.u32(bytes, blocksStart + 8 * b)
+                let offset = Int(Self.u32(bytes, blocksStart + 8 * b + 4))
+                guard b == 0 ? start == 0 : start > previousStart,
+                      deltasStart + offset <= bytes.count else { return nil }
+                previousStart = start
+            }
+            for i in 0..<rangeCount where Int(bytes[countriesStart + i]) > countryCount { return nil }
+            return (stamp, codes, rangeCount, blockCount, blocksStart, countriesStart, deltasStart)
+        }
+        guard let header else { return nil }
+        self.data = data
+        self.stamp = header.stamp
+        self.countryCodes = header.codes
+        self.rangeCount = header.rangeCount
+        self.blockCount = header.blockCount
+        self.blocksStart = header.blocksStart
+        self.countriesStart = header.countriesStart
+        self.deltasStart = header.deltasStart
+    }
+
+    /// The 1-based country index ``country(of:)`` reports for `code`, if the table has it.
+    func countryIndex(for code: String) -> UInt8? {
+        countryCodes.firstIndex(of: code.uppercased()).map { UInt8($0 + 1) }
+    }
+
+    /// The 1-based index of the country a host-order IPv4 address belongs to, or 0.
+    func country(of address: UInt32) -> UInt8 {
+        data.withUnsafeBytes { raw in
+            let bytes = raw.bindMemory(to: UInt8.self)
+            // Last block whose first start is ≤ address; block 0 starts at 0.
+            var low = 0, high = blockCount
+            while high - low > 1 {
+                let mid = (low + high) / 2
+                if Self.u32(bytes, blocksStart + 8 * mid) <= address { low = mid } else { high = mid }
+            }
+            var start = Self.u32(bytes, blocksStart + 8 * low)
+            var cursor = deltasStart + Int(Self.u32(bytes, blocksStart + 8 * low + 4))
+            var index = low * GeoIPTableFormat.blockSize
+            let end = min(index + GeoIPTableFormat.blockSize, rangeCount)
+            while index + 1 < end {
+                let next = start &+ Self.leb128(bytes, &cursor)
+                if next > address { break }
+                start = next
+                index += 1
+            }
+            return bytes[countriesStart + index]
+        }
+    }
+
+    /// Every range of country `index` as CIDR prefixes (host-order network, length).
+    func prefixes(ofCountry index: UInt8) -> [(network: UInt32, length: Int)] {
+        var out: [(network: UInt32, length: Int)] = []
+        data.withUnsafeBytes { raw in
+            let bytes = raw.bindMemory(to: UInt8.self)
+            for b in 0..<blockCount {
+                var start = UInt64(Self.u32(bytes, blocksStart + 8 * b))
+                var cursor = deltasStart + Int(Self.u32(bytes, blocksStart + 8 * b + 4))
+                let first = b * GeoIPTableFormat.blockSize
+                let end = min(first + GeoIPTableFormat.blockSize, rangeCount)
+                for i in first..<end {
+                    let next: UInt64
+                    if i + 1 == rangeCount {
+                        next = 1 << 32
+                    } else if i + 1 == end {
+                        next = UInt64(Self.u32(bytes, blocksStart + 8 * (b + 1)))
+                    } else {
+                        next = start + UInt64(Self.leb128(bytes, &cursor))
+                    }
+                    if bytes[countriesStart + i] == index {
+                        Self.appendPrefixes(from: start, to: next, into: &out)
+                    }
+                    start = next
+                }
+            }
+        }
+        return out
+    }
+
+    /// Splits `[start, end)` into the fewest aligned prefixes.
+    private static func appendPrefixes(from start: UInt64, to end: UInt64, into out: inout [(network: UInt32, length: Int)]) {
+        var cursor = start
+        while cursor < end {
+            var size: UInt64 = cursor == 0 ? 1 << 32 : cursor & (~cursor &+ 1)
+            while cursor + size > end { size >>= 1 }
+            out.append((UInt32(truncatingIfNeeded: cursor), 32 - size.trailingZeroBitCount))
+            cursor += size
+        }
+    }
+
+    // MARK: - Writing
+
+    /// The table for `countries`' IPv4 CIDRs. Where lists overlap, the later
+    /// country wins; unparsable CIDRs are skipped.
+    static func encode(stamp: String, countries: [(code: String, cidrs: [String])]) -> Data {
+        var ranges: [(start: UInt64, end: UInt64, country: UInt8)] = []
+        for (index, country) in countries.prefix(255).enumerated() {
+            for cidr in country.cidrs {
+                let parts = cidr.split(separator: "/", maxSplits: 1)
+                guard parts.count == 2, let length = Int(parts[1]), (0...32).contains(length),
+                      let address = RoutingCompiler.parseIPv4(String(parts[0])) else { continue }
+                let size = UInt64(1) << (32 - length)
+                let start = UInt64(address) & ~(size - 1)
+                ranges.append((start, start + size, UInt8(index + 1)))
+            }
+        }
+        // Paint in order so later countries overwrite, then read off the boundaries.
+        var boundaries: [UInt64: Void] = [0: ()]
+        for range in ranges {
+            boundaries[range.start] = ()
+            boundaries[range.end] = ()
+        }
+        let points = boundaries.keys.filter { $0 < 1 << 32 }.sorted()
+        var owner = [UInt8](repeating: 0, count: points.count)
+        for range in ranges {
+            var i = lowerBound(points, range.start)
+            while i < points.count, points[i] < range.end {
+                owner[i] = range.country
+                i += 1
+            }
+        }
+        var starts: [UInt32] = []
+        var owners: [UInt8] = []
+        for (point, country) in zip(points, owner) where owners.last != country {
+            starts.append(UInt32(point))
+            owners.append(country)
+        }
+
+        var bytes = GeoIPTableFormat.magic
+        appendU32(GeoIPTableFormat.version, to: &bytes)
+        let stampBytes = Array(stamp.utf8.prefix(Int(UInt16.max)))
+        bytes.append(UInt8(truncatingIfNeeded: stampBytes.count))
+        bytes.append(UInt8(truncatingIfNeeded: stampBytes.count >> 8))
+        bytes.append(contentsOf: stampBytes)
+        let codes = countries.prefix(255).map(\.code)
+        bytes.append(UInt8(codes.count))
+        for code in codes {
+            let utf8 = Array(code.uppercased().utf8)
+            bytes.append(utf8.count > 0 ? utf8[0] : 0x20)
+            bytes.append(utf8.count > 1 ? utf8[1] : 0x20)
+        }
+        let blockCount = (starts.count + GeoIPTableFormat.blockSize - 1) / GeoIPTableFormat.blockSize
+        appendU32(UInt32(starts.count), to: &bytes)
+        appendU32(UInt32(blockCount), to: &bytes)
+
+        var deltas: [UInt8] = []
+        var index: [UInt8] = []
+        for b in 0..<blockCount {
+            let first = b * GeoIPTableFormat.blockSize
+            appendU32(starts[first], to: &index)
+            appendU32(UInt32(deltas.count), to: &index)
+            for i in (first + 1)..<min(first + GeoIPTableFormat.blockSize, starts.count) {
+                var delta = starts[i] - starts[i - 1]
+                while delta >= 0x80 {
+                    deltas.append(UInt8(truncatingIfNeeded: delta) | 0x80)
+                    delta >>= 7
+                }
+                deltas.append(UInt8(delta))
+            }
+        }
+        bytes.append(contentsOf: index)
+        bytes.append(contentsOf: owners)
+        bytes.append(contentsOf: deltas)
+        return Data(bytes)
+    }
+
+    private static func lowerBound(_ points: [UInt64], _ value: UInt64) -> Int {
+        var low = 0, high = points.count
+        while low < high {
+            let mid = (low + high) / 2
+            if points[mid] < value { low = mid + 1 } else { high = mid }
+        }
+        return low
+    }
+
+    // MARK: - Primitives
+
+    private static func u16(_ bytes: UnsafeBufferPointer<UInt8>, _ offset: Int) -> UInt16 {
+        UInt16(bytes[offset]) | (UInt16(bytes[offset + 1]) << 8)
+    }
+
+    private static func u32(_ bytes: UnsafeBufferPointer<UInt8>, _ offset: Int) -> UInt32 {
+        UInt32(bytes[offset]) | (UInt32(bytes[offset + 1]) << 8)
+            | (UInt32(bytes[offset + 2]) << 16) | (UInt32(bytes[offset + 3]) << 24)
+    }
+
+    /// Reads one delta at `cursor`; a truncated delta reads as what it holds so far.
+    private static func leb128(_ bytes: UnsafeBufferPointer<UInt8>, _ cursor: inout Int) -> UInt32 {
+        var value: UInt32 = 0
+        var shift: UInt32 = 0
+        while cursor < bytes.count, shift < 32 {
+            let byte = bytes[cursor]
+            cursor += 1
+            value |= UInt32(byte & 0x7F) << shift
+            if byte & 0x80 == 0 { break }
+            shift += 7
+        }
+        return value
+    }
+
+    private static func appendU32(_ v: UInt32, to bytes: inout [UInt8]) {
+        bytes.append(UInt8(truncatingIfNeeded: v))
+        bytes.append(UInt8(truncatingIfNeeded: v >> 8))
+        bytes.append(UInt8(truncatingIfNeeded: v >> 16))
+        bytes.append(UInt8(truncatingIfNeeded: v >> 24))
+    }
+}
@@ -0,0 +1,477 @@
+//
+//  KeywordAutomaton.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Aho–Corasick automaton for `domainKeyword`: longest substring match in one
+/// O(D) walk. `finalize()` flattens the build tree into BFS-ordered flat columns
+/// plus CSR edges; inserting after it traps. With a dense-table budget it also
+/// compiles the automaton into a DFA over byte classes, so a lookup is one
+/// transition load and one comparison per byte. A trigram prefilter in front
+/// rejects most domains that contain no keyword before either walk starts.
+nonisolated final class KeywordAutomaton {
+
+    // MARK: Build state (dropped on finalize)
+
+    private final class BuildNode {
+        var children: [UInt8: BuildNode] = [:]
+        var failure: BuildNode?
+        /// Nearest accepting ancestor via failure links; lets lookup skip the full failure chain.
+        var dictSuffix: BuildNode?
+        var actionID: Int16 = ActionTable.noneID
+        var patternLength: UInt16 = 0
+        var insertionOrder: Int32 = 0
+        /// Assigned during BFS layout; -1 until then.
+        var nodeID: Int32 = -1
+    }
+
+    private var buildRoot: BuildNode? = BuildNode()
+    /// Every inserted pattern, kept for the prefilter.
+    private var buildPatterns: [[UInt8]] = []
+    private var insertionCounter: Int32 = 0
+    private var finalized = false
+
+    // MARK: Frozen state (populated by finalize)
+
+    /// Per-node columns. Indexed by `0..<failure.count`; root is index 0.
+    /// `dictSuffix[i] == -1` means "no accepting ancestor".
+    private var failure: ContiguousArray<Int32> = []
+    private var dictSuffix: ContiguousArray<Int32> = []
+    private var actionID: ContiguousArray<Int16> = []
+    private var patternLength: ContiguousArray<UInt16> = []
+    private var insertionOrder: ContiguousArray<Int32> = []
+
+    /// CSR edges: node `i`'s edges live at `[edgeStart[i], edgeStart[i + 1])`, sorted by byte.
+    private var edgeStart: ContiguousArray<Int32> = []
+    private var edgeByte: ContiguousArray<UInt8> = []
+    private var edgeTarget: ContiguousArray<Int32> = []
+
+    /// Dense DFA, empty unless `finalize(denseTableLimit:)` built one. Bytes no
+    /// pattern contains share class 0; each other byte gets its own class.
+    /// State `s` on class `c` goes to `denseTransitions[s * classCount + c]`.
+    private var denseByteClass: ContiguousArray<UInt8> = []
+    private var denseTransitions: ContiguousArray<Int32> = []
+    /// Per state, the best pattern ending there (its own, else the best along
+    /// its failure chain), so the DFA walk needs no dictSuffix chain.
+    private var denseActionID: ContiguousArray<Int16> = []
+    private var densePatternLength: ContiguousArray<UInt16> = []
+    private var denseInsertionOrder: ContiguousArray<Int32> = []
+
+    /// Prefilter bitsets, empty when it wouldn't reject enough to pay for itself:
+    /// `prefilterSingleWords` words for one-byte patterns, then exact bigrams
+    /// for two-byte ones, then hashed trigrams, each pattern of three bytes or
+    /// more contributing one of its own. A domain with no hit in any of them
+    /// contains no pattern.
+    private var prefilter: ContiguousArray<UInt64> = []
+
+    static let prefilterSingleWords = 4
+    static let prefilterBigramWords = 1 << 10
+    static let prefilterTrigramWords = 1 << 10
+    /// Past this many trigram bits (1/8 of the table) most domains would pass
+    /// anyway, so the prefilter is left out.
+    static let prefilterTrigramLimit = prefilterTrigramWords * 64 / 8
+
+    /// Bit index of the trigram `b0 b1 b2` in the trigram table.
+    static func trigramSlot(_ b0: UInt8, _ b1: UInt8, _ b2: UInt8) -> Int {
+        let packed = UInt32(b0) << 16 | UInt32(b1) << 8 | UInt32(b2)
+        return Int((packed &* 0x9E37_79B1) >> 16)
+    }
+
+    /// Default budget for the dense table, in transitions (4 bytes each). A
+    /// few thousand keywords over the ~40 domain-name byte classes fit well
+    /// inside it; beyond it the automaton stays sparse.
+    static let denseTableLimit = 1 << 20
+
+    // MARK: Build API
+
+    func insert(_ pattern: String, actionID: Int16) {
+        guard !pattern.isEmpty else { return }
+        let bytes = Array(pattern.utf8)
+        // RFC 1035 caps domains at 253 octets; anything past UInt16.max is garbage — drop silently.
+        guard bytes.count <= Int(UInt16.max) else { return }
+
+        var node = buildRoot!
+        for b in bytes {
+            if let child = node.children[b] {
+                node = child
+            } else {
+                let child = BuildNode()
+                node.children[b] = child
+                node = child
+            }
+        }
+        insertionCounter += 1
+        if node.actionID == ActionTable.noneID { buildPatterns.append(bytes) }
+        node.actionID = actionID
+        node.patternLength = UInt16(bytes.count)
+        node.insertionOrder = insertionCounter
+    }
+
+    // MARK: Finalize
+
+    /// Builds failure/dictSuffix links and freezes the flat columns, plus the
+    /// dense DFA when it needs at most `denseTableLimit` transitions (0 keeps
+    /// the automaton sparse). Idempotent; subsequent inserts trap.
+    func finalize(denseTableLimit: Int = 0) {
+        guard !finalized else { return }
+        guard let root = buildRoot else {
+            finalized = true
+            return
+        }
+
+        // Failure links point at strictly shallower depth, so BFS order lays out a
+        // child's failure target first; sorted-byte children keep CSR rows sorted.
+        var queue: [BuildNode] = []
+        queue.reserveCapacity(64)
+        root.nodeID = 0
+        queue.append(root)
+
+        var nFailure: [Int32] = [0]                       // root's failure is itself
+        var nDictSuffix: [Int32] = [-1]
+        var nActionID: [Int16] = [root.actionID]
+        var nPatternLength: [UInt16] = [root.patternLength]
+        var nInsertionOrder: [Int32] = [root.insertionOrder]
+        var edgeStarts: [Int32] = [0]
+        var edgeBytes: [UInt8] = []
+        var edgeTargets: [Int32] = []
+
+        var head = 0
+        while head < queue.count {
+            let node = queue[head]; head += 1
+
+            let sortedChildren = node.children.sorted { $0.key < $1.key }
+            for (byte, childNode) in sortedChildren {
+                // Standard AC failure: nearest ancestor-of-failure with a
+                // `byte` child (≠ childNode), else root. node.failure is nil only for root.
+                var f = node.failure
+                while let current = f, current.children[byte] == nil, current !== root {
+                    f = current.failure
+                }
+                if let current = f, let next = current.children[byte], next !== childNode {
+                    childNode.failure = next
+                } else {
+                    childNode.failure = root
+                }
+                childNode.dictSuffix = (childNode.failure?.actionID ?? ActionTable.noneID) != ActionTable.noneID
+                    ? childNode.failure
+                    : childNode.failure?.dictSuffix
+
+                let childID = Int32(nFailure.count)
+                childNode.nodeID = childID
+                queue.append(childNode)
+
+                nFailure.append(childNode.failure!.nodeID)
+                nDictSuffix.append(childNode.dictSuffix?.nodeID ?? -1)
+                nActionID.append(childNode.actionID)
+                nPatternLength.append(childNode.patternLength)
+                nInsertionOrder.append(childNode.insertionOrder)
+
+                edgeBytes.append(byte)
+                edgeTargets.append(childID)
+            }
+            edgeStarts.append(Int32(edgeBytes.count))
+        }
+
+        failure = ContiguousArray(nFailure)
+        dictSuffix = ContiguousArray(nDictSuffix)
+        actionID = ContiguousArray(nActionID)
+        patternLength = ContiguousArray(nPatternLength)
+        insertionOrder = ContiguousArray(nInsertionOrder)
+        edgeStart = ContiguousArray(edgeStarts)
+        edgeByte = ContiguousArray(edgeBytes)
+        edgeTarget = ContiguousArray(edgeTargets)
+
+        buildRoot = nil
+        finalized = true
+        if !edgeByte.isEmpty {
+            buildDenseTable(limit: denseTableLimit)
+            buildPrefilter()
+        }
+        buildPatterns = []
+    }
+
+    /// Sets one bit per pattern. Shortest patterns go first, and a longer one
+    /// whose trigrams include an already-set slot adds nothing, which keeps the
+    /// table sparse for large keyword sets.
+    private func buildPrefilter() {
+        let bigramBase = Self.prefilterSingleWords
+        let trigramBase = bigramBase + Self.prefilterBigramWords
+        var bits = ContiguousArray<UInt64>(repeating: 0, count: trigramBase + Self.prefilterTrigramWords)
+        func isSet(_ bit: Int) -> Bool { bits[bit >> 6] & (1 << UInt64(bit & 63)) != 0 }
+        func set(_ bit: Int) { bits[bit >> 6] |= 1 << UInt64(bit & 63) }
+
+        var trigramCount = 0
+        for pattern in buildPatterns.sorted(by: { $0.count < $1.count }) {
+            switch pattern.count {
+            case 1:
+                set(Int(pattern[0]))
+            case 2:
+                set(bigramBase * 64 + (Int(pattern[0]) << 8 | Int(pattern[1])))
+            default:
+                let slots = (0..<(pattern.count - 2)).map {
+                    trigramBase * 64 + Self.trigramSlot(pattern[$0], pattern[$0 + 1], pattern[$0 + 2])
+                }
+                guard !slots.contains(where: isSet) else { continue }
+                set(slots[0])
+                trigramCount += 1
+                guard trigramCount <= Self.prefilterTrigramLimit else { return }
+            }
+        }
+        prefilter = bits
+    }
+
+    /// Fills the dense columns from the frozen sparse ones. Both a state's
+    /// transitions and its best pattern extend its failure state's, which BFS
+    /// order has already filled.
+    private func buildDenseTable(limit: Int) {
+        var byteClass = ContiguousArray<UInt8>(repeating: 0, count: 256)
+        var classCount = 1
+        for byte in edgeByte where byteClass[Int(byte)] == 0 {
+            guard classCount <= Int(UInt8.max) else { return }
+            byteClass[Int(byte)] = UInt8(classCount)
+            classCount += 1
+        }
+        let stateCount = failure.count
+        guard stateCount <= limit / classCount else { return }
+
+        var transitions = ContiguousArray<Int32>(repeating: 0, count: stateCount * classCount)
+        var bestActionID = actionID
+        var bestPatternLength = patternLength
+        var bestInsertionOrder = insertionOrder
+        for state in 0..<stateCount {
+            let row = state * classCount
+            if state != 0 {
+                let fallback = Int(failure[state])
+                let fallbackRow = fallback * classCount
+                for c in 1..<classCount { transitions[row + c] = transitions[fallbackRow + c] }
+                // A state's own pattern is longer than any suffix of it.
+                if actionID[state] == ActionTable.noneID {
+                    bestActionID[state] = bestActionID[fallback]
+                    bestPatternLength[state] = bestPatternLength[fallback]
+                    bestInsertionOrder[state] = bestInsertionOrder[fallback]
+                }
+            }
+            for e in Int(edgeStart[state])..<Int(edgeStart[state + 1]) {
+                transitions[row + Int(byteClass[Int(edgeByte[e])])] = edgeTarget[e]
+            }
+        }
+
+        denseByteClass = byteClass
+        denseTransitions = transitions
+        denseActionID = bestActionID
+        densePatternLength = bestPatternLength
+        denseInsertionOrder = bestInsertionOrder
+    }
+}
+
+// MARK: - Routing image
+
+extension KeywordAutomaton {
+    /// Appends the frozen columns read back by ``KeywordAutomatonView``.
+    func write(to writer: inout RoutingImageWriter) {
+        finalize()
+        writer.column(failure)
+        writer.column(dictSuffix)
+        writer.column(actionID)
+        writer.column(patternLength)
+        writer.column(insertionOrder)
+        writer.column(edgeStart)
+        writer.column(edgeByte)
+        writer.column(edgeTarget)
+        writer.column(denseByteClass)
+        writer.column(denseTransitions)
+        writer.column(denseActionID)
+        writer.column(densePatternLength)
+        writer.column(denseInsertionOrder)
+        writer.column(prefilter)
+    }
+}
+
+/// A finalized ``KeywordAutomaton`` queried in place from routing-image
+/// columns; the image must outlive the view.
+nonisolated struct KeywordAutomatonView {
+    private let failure: UnsafeBufferPointer<Int32>
+    private let dictSuffix: UnsafeBufferPointer<Int32>
+    private let actionID: UnsafeBufferPointer<Int16>
+    private let patternLength: UnsafeBufferPointer<UInt16>
+    private let insertionOrder: UnsafeBufferPointer<Int32>
+    private let edgeStart: UnsafeBufferPointer<Int32>
+    private let edgeByte: UnsafeBufferPointer<UInt8>
+    private let edgeTarget: UnsafeBufferPointer<Int32>
+    private let dense: Dense?
+    private let prefilter: Prefilter?
+
+    private struct Prefilter {
+        let singles: UnsafePointer<UInt64>
+        let bigrams: UnsafePointer<UInt64>
+        let trigrams: UnsafePointer<UInt64>
+        /// Any one- or two-byte pattern; without them only trigrams are probed.
+        let hasShortPatterns: Bool
+    }
+
+    private struct Dense {
+        let byteClass: UnsafeBufferPointer<UInt8>
+        let transitions: UnsafeBufferPointer<Int32>
+        let classCount: Int
+        let actionID: UnsafeBufferPointer<Int16>
+        let patternLength: UnsafeBufferPointer<UInt16>
+        let insertionOrder: UnsafeBufferPointer<Int32>
+    }
+
+    /// Reads the columns ``KeywordAutomaton/write(to:)`` appended, checking
+    /// their sizes agree.
+    init?(columns: inout RoutingImage.Columns) {
+        guard let failure = columns.next(Int32.self), let dictSuffix = columns.next(Int32.self),
+              let actionID = columns.next(Int16.self), let patternLength = columns.next(UInt16.self),
+              let insertionOrder = columns.next(Int32.self), let edgeStart = columns.next(Int32.self),
+              let edgeByte = columns.next(UInt8.self), let edgeTarget = columns.next(Int32.self),
+              let denseByteClass = columns.next(UInt8.self), let denseTransitions = columns.next(Int32.self),
+              let denseActionID = columns.next(Int16.self), let densePatternLength = columns.next(UInt16.self),
+              let denseInsertionOrder = columns.next(Int32.self), let prefilter = columns.next(UInt64.self)
+        else { return nil }
+        let nodeCount = failure.count
+        guard nodeCount > 0,
+              dictSuffix.count == nodeCount, actionID.count == nodeCount,
+              patternLength.count == nodeCount, insertionOrder.count == nodeCount,
+              edgeStart.count == nodeCount + 1,
+              edgeByte.count == edgeTarget.count, Int(edgeStart[nodeCount]) == edgeByte.count
+        else { return nil }
+        self.failure = failure
+        self.dictSuffix = dictSuffix
+        self.actionID = actionID
+        self.patternLength = patternLength
+        self.insertionOrder = insertionOrder
+        self.edgeStart = edgeStart
+        self.edgeByte = edgeByte
+        self.edgeTarget = edgeTarget
+
+        if denseByteClass.isEmpty {
+            dense = nil
+        } else {
+            let classCount = denseTransitions.count / nodeCount
+            guard denseByteClass.count == 256, classCount > 0,
+                  denseTransitions.count == nodeCount * classCount,
+                  denseByteClass.allSatisfy({ Int($0) < classCount }),
+                  denseActionID.count == nodeCount, densePatternLength.count == nodeCount,
+                  denseInsertionOrder.count == nodeCount
+            else { return nil }
+            dense = Dense(byteClass: denseByteClass, transitions: denseTransitions, classCount: classCount,
+                          actionID: denseActionID, patternLength: densePatternLength,
+                          insertionOrder: denseInsertionOrder)
+        }
+
+        if prefilter.isEmpty {
+            self.prefilter = nil
+        } else {
+            let bigramBase = KeywordAutomaton.prefilterSingleWords
+            let trigramBase = bigramBase + KeywordAutomaton.prefilterBigramWords
+            guard prefilter.count == trigramBase + KeywordAutomaton.prefilterTrigramWords,
+                  let base = prefilter.baseAddress
+            else { return nil }
+            self.prefilter = Prefilter(singles: base, bigrams: base + bigramBase, trigrams: base + trigramBase,
+                                       hasShortPatterns: prefilter[..<trigramBase].contains { $0 != 0 })
+        }
+    }
+
+    /// Best-matching action ID, or `ActionTable.noneID` when no pattern matches.
+    func lookup(_ domain: UnsafeBufferPointer<UInt8>) -> Int16 {
+        // Empty edge table means nothing was inserted; skip the walk for keyword-free tiers.
+        guard !edgeByte.isEmpty else { return ActionTable.noneID }
+        if let prefilter, !Self.mayMatch(domain, prefilter) { return ActionTable.noneID }
+        if let dense { return Self.lookup(domain, in: dense) }
+
+        var bestID: Int16 = ActionTable.noneID
+        var bestLength: UInt16 = 0
+        var bestOrder: Int32 = -1
+        var nodeID: Int32 = 0
+
+        for byte in domain {
+            var nextID = childTarget(nodeID: nodeID, byte: byte)
+            while nextID < 0 && nodeID != 0 {
+                nodeID = failure[Int(nodeID)]
+                nextID = childTarget(nodeID: nodeID, byte: byte)
+            }
+            if nextID >= 0 { nodeID = nextID }
+
+            // Enumerate accepting nodes via the dictSuffix chain.
+            var hit: Int32 = nodeID
+            while hit >= 0 {
+                let aid = actionID[Int(hit)]
+                if aid != ActionTable.noneID {
+                    let plen = patternLength[Int(hit)]
+                    let pord = insertionOrder[Int(hit)]
+                    if plen > bestLength || (plen == bestLength && pord > bestOrder) {
+                        bestID = aid
+                        bestLength = plen
+                        bestOrder = pord
+                    }
+                }
+                hit = dictSuffix[Int(hit)]
+            }
+        }
+        return bestID
+    }
+
+    /// The DFA walk: the per-state best pattern stands in for the dictSuffix chain.
+    private static func lookup(_ domain: UnsafeBufferPointer<UInt8>, in dense: Dense) -> Int16 {
+        var bestID: Int16 = ActionTable.noneID
+        var bestLength: UInt16 = 0
+        var bestOrder: Int32 = -1
+        var state = 0
+
+        for byte in domain {
+            state = Int(dense.transitions[state &* dense.classCount &+ Int(dense.byteClass[Int(byte)])])
+            let plen = dense.patternLength[state]
+            if plen > bestLength || (plen == bestLength && plen != 0 && dense.insertionOrder[state] > bestOrder) {
+                bestID = dense.actionID[state]
+                bestLength = plen
+                bestOrder = dense.insertionOrder[state]
+            }
+        }
+        return bestID
+    }
+
+    /// False when `domain` can't contain a pattern. Unlike the automaton walks,
+    /// no probe depends on the one before it, so the loads overlap; hits are
+    /// OR-ed into one word and tested once at the end.
+    private static func mayMatch(_ domain: UnsafeBufferPointer<UInt8>, _ prefilter: Prefilter) -> Bool {
+        let count = domain.count
+        var hit: UInt64 = 0
+        if count >= 3 {
+            for i in 0..<(count - 2) {
+                let slot = KeywordAutomaton.trigramSlot(domain[i], domain[i + 1], domain[i + 2])
+                hit |= prefilter.trigrams[slot >> 6] >> UInt64(slot & 63)
+            }
+        }
+        if prefilter.hasShortPatterns, count > 0 {
+            var previous = Int(domain[0])
+            hit |= prefilter.singles[previous >> 6] >> UInt64(previous & 63)
+            for i in 1..<count {
+                let byte = Int(domain[i])
+                let pair = previous << 8 | byte
+                hit |= prefilter.singles[byte >> 6] >> UInt64(byte & 63)
+                hit |= prefilter.bigrams[pair >> 6] >> UInt64(pair & 63)
+                previous = byte
+            }
+        }
+        return hit & 1 != 0
+    }
+
+    /// Edge target for `byte` from `nodeID`, or -1; rows are sorted so the scan exits early.
+    private func childTarget(nodeID: Int32, byte: UInt8) -> Int32 {
+        let start = Int(edgeStart[Int(nodeID)])
+        let end = Int(edgeStart[Int(nodeID) + 1])
+        var i = start
+        while i < end {
+            let candidateByte = edgeByte[i]
+            if candidateByte == byte { return edgeTarget[i] }
+            if candidateByte > byte { return -1 }
+            i += 1
+        }
+        return -1
+    }
+}
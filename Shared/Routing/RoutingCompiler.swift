@@ -0,0 +1,620 @@
+//
+//  RoutingCompiler.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+nonisolated private let logger = AnywhereLogger(category: "RoutingCompiler")
+
+/// Compiles an "ARB2" routing payload into a ``RoutingImage``. The app runs it
+/// whenever it writes the payload, so the extension only maps the result; the
+/// extension runs it itself only when the image is missing or from an older
+/// build.
+nonisolated enum RoutingCompiler {
+
+    /// One per ``RoutingBinaryFormat/Tier``, in priority order.
+    static let tierCount = 4
+
+    /// The image for `routingData`, or nil if the payload doesn't parse.
+    /// With a `cache`, tiers whose entries are byte-identical to the previous
+    /// compile's are reused instead of re-parsed and re-finalized.
+    static func compileImage(routingData data: Data, reusing cache: TierCache? = nil) -> Data? {
+        let configurationTable: Data
+        var tiers: [TierMatchers]
+        let merged: MergedMatchers
+        do {
+            let split = try data.withUnsafeBytes { raw in
+                var reader = RoutingBinaryReader(bytes: raw.bindMemory(to: UInt8.self))
+                return try reader.split()
+            }
+            configurationTable = data.subdata(in: (data.startIndex + split.configuration.lowerBound)..<(data.startIndex + split.configuration.upperBound))
+
+            let previous = cache?.tiers ?? []
+            tiers = []
+            var rebuilt = 0
+            for (t, source) in split.tierSources.enumerated() {
+                if t < previous.count, let reused = previous[t], reused.source == source {
+                    tiers.append(reused)
+                } else {
+                    tiers.append(try compileTier(source: source))
+                    rebuilt += 1
+                }
+            }
+            if cache != nil {
+                logger.debug("[RoutingCompiler] Rebuilt \(rebuilt) of \(tiers.count) tiers")
+            }
+            cache?.tiers = tiers
+
+            var matchers = MergedMatchers()
+            matchers.merge(tiers)
+            merged = matchers
+        } catch {
+            logger.error("[RoutingCompiler] Routing payload parse failed: \(error)")
+            return nil
+        }
+
+        var writer = RoutingImageWriter()
+        writer.column(configurationTable)
+        for tier in tiers { tier.write(to: &writer) }
+        merged.write(to: &writer)
+        return writer.finish(tierCount: tiers.count)
+    }
+
+    /// Parses and finalizes one tier from its entries (see ``RoutingBinaryReader/split()``).
+    private static func compileTier(source: [UInt8]) throws -> TierMatchers {
+        var tier = TierMatchers(source: source)
+        try source.withUnsafeBufferPointer { base in
+            var reader = RoutingBinaryReader(bytes: base)
+            try reader.readEntries { action, type, valueStart, length in
+                tier.ingestRule(action: action, type: type, valueStart: valueStart, length: length, base: base)
+            }
+            tier.finalize(base: base)
+        }
+        return tier
+    }
+
+    /// Finalized tiers from the previous compile, kept by the app between
+    /// syncs so that editing a user rule or refreshing one rule set rebuilds
+    /// only that tier; the large built-in and ad-block tiers are carried over.
+    /// The cross-tier merge is always redone. The extension compiles without
+    /// one: it can't spare the memory and compiles at most once per load.
+    nonisolated final class TierCache: @unchecked Sendable {
+        private let lock = UnfairLock()
+        private var stored: [TierMatchers?] = []
+
+        init() {}
+
+        fileprivate var tiers: [TierMatchers?] {
+            get { lock.withLock { stored } }
+            set { lock.withLock { stored = newValue } }
+        }
+    }
+
+    // MARK: - Tier state
+
+    fileprivate struct TierMatchers {
+        /// The tier's payload entries, concatenated; suffix records index it,
+        /// and a cached tier is reused only while this is unchanged.
+        let source: [UInt8]
+
+        /// Per-tier interner; matchers store `Int16` IDs resolved back at the tier boundary.
+        var actionTable = ActionTable()
+
+        var suffixTrie = FlatLabelTrie<Int16>()
+        var keywordAutomaton = KeywordAutomaton()
+        var ipv4Trie = CIDRv4Trie()
+        var ipv6Trie = CIDRv6Trie()
+        var domainRuleCount = 0
+        var ipRuleCount = 0
+
+        /// Suffix rules are buffered as `(byte range into the payload, interned action)`.
+        /// This skips the scratch node tree and its per-node dictionary.
+        var suffixRecords: [FlatLabelTrie<Int16>.BulkEntry] = []
+        /// Keywords are buffered too, so redundant ones can be dropped before the
+        /// automaton is built.
+        var keywords: [(pattern: String, actionID: Int16)] = []
+
+        init(source: [UInt8]) {
+            self.source = source
+        }
+
+        mutating func ingestRule(action: RouteTarget, type: RoutingRuleType,
+                                 valueStart: Int, length: Int, base: UnsafeBufferPointer<UInt8>) {
+            switch type {
+            case .domainSuffix:
+                collectSuffix(offset: valueStart, length: length, action: action)
+            case .domainKeyword:
+                insertKeyword(String(decoding: base[valueStart..<valueStart + length], as: UTF8.self), action: action)
+            case .ipCIDR:
+                if let parsed = RoutingCompiler.parseIPv4CIDR(String(decoding: base[valueStart..<valueStart + length], as: UTF8.self)) {
+                    insertIPv4(network: parsed.network, prefixLen: parsed.prefixLen, action: action)
+                }
+            case .ipCIDR6:
+                if let parsed = RoutingCompiler.parseIPv6CIDR(String(decoding: base[valueStart..<valueStart + length], as: UTF8.self)) {
+                    insertIPv6(network: parsed.network, prefixLen: parsed.prefixLen, action: action)
+                }
+            }
+        }
+
+        /// `offset`/`length` index into `source`.
+        mutating func collectSuffix(offset: Int, length: Int, action: RouteTarget) {
+            suffixRecords.append(.init(offset: Int32(offset), length: Int32(length),
+                                       payload: actionTable.intern(action), order: Int32(suffixRecords.count)))
+            domainRuleCount += 1
+        }
+
+        mutating func insertKeyword(_ pattern: String, action: RouteTarget) {
+            guard !pattern.isEmpty else { return }
+            keywords.append((pattern, actionTable.intern(action)))
+            domainRuleCount += 1
+        }
+
+        mutating func insertIPv4(network: UInt32, prefixLen: Int, action: RouteTarget) {
+            ipv4Trie.insert(network: network, prefixLen: prefixLen, actionID: actionTable.intern(action))
+            ipRuleCount += 1
+        }
+
+        mutating func insertIPv6(network: [UInt8], prefixLen: Int, action: RouteTarget) {
+            ipv6Trie.insert(network: network, prefixLen: prefixLen, actionID: actionTable.intern(action))
+            ipRuleCount += 1
+        }
+
+        /// Drops the tier's redundant rules, then freezes its own matchers; `base` is
+        /// `source`'s bytes. `suffixRecords` stays (pruned and reordered) for
+        /// ``MergedMatchers/merge(_:)``. Rule counts still count every rule ingested.
+        mutating func finalize(base: UnsafeBufferPointer<UInt8>) {
+            for keyword in Self.pruneKeywords(keywords) {
+                keywordAutomaton.insert(keyword.pattern, actionID: keyword.actionID)
+            }
+            keywords = []
+            keywordAutomaton.finalize(denseTableLimit: KeywordAutomaton.denseTableLimit)
+            FlatLabelTrie<Int16>.pruneRedundant(base: base, entries: &suffixRecords)
+            suffixTrie.buildBulk(base: base, entries: &suffixRecords)
+            ipv4Trie.compact()
+            ipv6Trie.compact()
+        }
+
+        /// The longest matching keyword wins, regardless of action, so one containing
+        /// another is redundant only when every keyword of the tier shares an action.
+        /// Otherwise all are kept, and the automaton keeps the last of a repeat.
+        private static func pruneKeywords(_ keywords: [(pattern: String, actionID: Int16)]) -> [(pattern: String, actionID: Int16)] {
+            guard let first = keywords.first?.actionID,
+                  keywords.allSatisfy({ $0.actionID == first }) else { return keywords }
+            var kept: [String] = []
+            // Shortest first; a repeat contains its first occurrence.
+            for pattern in keywords.map(\.pattern).sorted(by: { $0.utf8.count < $1.utf8.count })
+            where !kept.contains(where: { pattern.contains($0) }) {
+                kept.append(pattern)
+            }
+            return kept.map { ($0, first) }
+        }
+
+        /// Appends the columns read back by ``RoutingTierView``. Suffix and IP
+        /// rules are written only as part of ``MergedMatchers``.
+        func write(to writer: inout RoutingImageWriter) {
+            writer.column([UInt32(domainRuleCount), UInt32(ipRuleCount)])
+            writer.column(actionTable.proxyUUIDs.flatMap { uuid in withUnsafeBytes(of: uuid.uuid) { Array($0) } })
+            keywordAutomaton.write(to: &writer)
+        }
+    }
+
+    // MARK: - Cross-tier merge
+    //
+    // Suffix and CIDR rules of all tiers are merged into one matcher each, so a
+    // lookup walks one structure however many tiers there are. A tier wins over
+    // any lower tier wherever one of its rules matches, however much longer the
+    // lower tier's match is; so a rule is dropped when a higher tier already has
+    // a rule covering it (a suffix of the domain, a prefix no longer than the
+    // CIDR). What remains resolves by plain longest match: the deepest match
+    // always comes from the highest tier that matches at all. Keyword rules stay
+    // per tier — a keyword beats lower tiers' suffixes but loses to its own
+    // tier's — and the lookup checks them only for tiers above the suffix hit.
+
+    private struct MergedMatchers {
+        /// Merged ID → (tier, tier-local action ID).
+        var tierIndex: [UInt8] = []
+        var tierActionID: [Int16] = []
+        private var index: [Int32: Int16] = [:]
+
+        var suffixTrie = FlatLabelTrie<Int16>()
+        var suffixFilter = DomainSuffixFilter(keyCount: 0)
+        var ipv4Trie = CIDRv4Trie()
+        var ipv6Trie = CIDRv6Trie()
+
+        private mutating func intern(tier: Int, actionID: Int16) -> Int16 {
+            let key = Int32(tier) << 16 | Int32(UInt16(bitPattern: actionID))
+            if let id = index[key] { return id }
+            let id = Int16(tierIndex.count)
+            tierIndex.append(UInt8(tier))
+            tierActionID.append(actionID)
+            index[key] = id
+            return id
+        }
+
+        /// `tiers` must be finalized.
+        mutating func merge(_ tiers: [TierMatchers]) {
+            // Each tier's records index its own source; concatenate them so the
+            // merged records share one base.
+            var combined: [UInt8] = []
+            combined.reserveCapacity(tiers.reduce(0) { $0 + $1.source.count })
+            var sourceOffset: [Int32] = []
+            for tier in tiers {
+                sourceOffset.append(Int32(combined.count))
+                combined.append(contentsOf: tier.source)
+            }
+
+            combined.withUnsafeBufferPointer { base in
+                var suffixRecords: [FlatLabelTrie<Int16>.BulkEntry] = []
+                for t in tiers.indices {
+                    for record in tiers[t].suffixRecords {
+                        let offset = sourceOffset[t] + record.offset
+                        let domain = UnsafeBufferPointer(rebasing: base[Int(offset)..<Int(offset + record.length)])
+                        if tiers[..<t].contains(where: { $0.suffixTrie.lookup(domain) != nil }) { continue }
+                        suffixRecords.append(.init(offset: offset, length: record.length,
+                                                   payload: intern(tier: t, actionID: record.payload), order: record.order))
+                    }
+                }
+                suffixFilter = DomainSuffixFilter(keyCount: suffixRecords.count)
+                for record in suffixRecords {
+                    suffixFilter.insert(suffix: UnsafeBufferPointer(
+                        rebasing: base[Int(record.offset)..<Int(record.offset + record.length)]))
+                }
+                suffixTrie.buildBulk(base: base, entries: &suffixRecords)
+            }
+
+            // The merged tries hold only higher tiers while a tier is checked.
+            for t in tiers.indices {
+                var v4: [(network: UInt32, length: UInt8, actionID: Int16)] = []
+                tiers[t].ipv4Trie.forEachPrefix { network, length, actionID in
+                    if !ipv4Trie.hasPrefix(covering: network, length: length) { v4.append((network, length, actionID)) }
+                }
+                for prefix in v4 {
+                    ipv4Trie.insert(network: prefix.network, prefixLen: Int(prefix.length),
+                                    actionID: intern(tier: t, actionID: prefix.actionID))
+                }
+
+                var v6: [(hi: UInt64, lo: UInt64, length: UInt8, actionID: Int16)] = []
+                tiers[t].ipv6Trie.forEachPrefix { hi, lo, length, actionID in
+                    if !ipv6Trie.hasPrefix(coveringHi: hi, lo: lo, length: length) { v6.append((hi, lo, length, actionID)) }
+                }
+                for prefix in v6 {
+                    ipv6Trie.insert(hi: prefix.hi, lo: prefix.lo, prefixLen: Int(prefix.length),
+                                    actionID: intern(tier: t, actionID: prefix.actionID))
+                }
+            }
+        }
+
+        /// Appends the columns ``RoutingImage`` reads after the tiers.
+        func write(to writer: inout RoutingImageWriter) {
+            writer.column(tierIndex)
+            writer.column(tierActionID)
+            suffixTrie.write(to: &writer)
+            suffixFilter.write(to: &writer)
+            ipv4Trie.write(to: &writer)
+            ipv6Trie.write(to: &writer)
+        }
+    }
+
+    // MARK: - Payload reader
+
+    private struct RoutingBinaryReader {
+        enum ReadError: Error { case badMagic, truncated, malformed }
+
+        let bytes: UnsafeBufferPointer<UInt8>
+        private var cursor = 0
+        private var count: Int { bytes.count }
+
+        init(bytes: UnsafeBufferPointer<UInt8>) {
+            self.bytes = bytes
+        }
+
+        /// Splits a whole payload into its configuration table range and, per
+        /// tier, that tier's entries concatenated in payload order. Rules are
+        /// skipped, not ingested.
+        mutating func split() throws -> (configuration: Range<Int>, tierSources: [[UInt8]]) {
+            try expectMagic()
+
+            let configLength = Int(try u32())
+            let configStart = cursor
+            try advance(configLength)
+
+            var tierSources = [[UInt8]](repeating: [], count: RoutingCompiler.tierCount)
+            var remainingEntries = try u32()
+            while remainingEntries > 0 {
+                let entryStart = cursor
+                let tier = try readEntry { _, _, _, _ in }
+                tierSources[tier].append(contentsOf: bytes[entryStart..<cursor])
+                remainingEntries -= 1
+            }
+            return (configStart..<(configStart + configLength), tierSources)
+        }
+
+        /// Reads entries to the end of `bytes` (one tier's source from
+        /// ``split()``), handing each rule to `ingest`.
+        mutating func readEntries(_ ingest: (RouteTarget, RoutingRuleType, _ valueStart: Int, _ length: Int) -> Void) throws {
+            while cursor < count {
+                _ = try readEntry(ingest)
+            }
+        }
+
+        /// Returns the entry's tier index.
+        private mutating func readEntry(_ ingest: (RouteTarget, RoutingRuleType, _ valueStart: Int, _ length: Int) -> Void) throws -> Int {
+            guard let tier = RoutingBinaryFormat.Tier(rawValue: try u8()),
+                  Int(tier.rawValue) < RoutingCompiler.tierCount else { throw ReadError.malformed }
+            let action = try readAction()
+
+            var remainingRules = try u32()
+            while remainingRules > 0 {
+                let typeByte = try u8()
+                let length = Int(try u16())
+                let valueStart = cursor
+                try advance(length)
+                if let type = RoutingRuleType(rawValue: Int(typeByte)) {
+                    ingest(action, type, valueStart, length)
+                }
+                remainingRules -= 1
+            }
+            return Int(tier.rawValue)
+        }
+        private mutating func readAction() throws -> RouteTarget {
+            switch RoutingBinaryFormat.Action(rawValue: try u8()) {
+            case .direct: return .direct
+            case .reject: return .reject
+            case .proxy: return .proxy(try readUUID())
+            case nil: throw ReadError.malformed
+            }
+        }
+
+        // MARK: Primitives
+
+        private mutating func expectMagic() throws {
+            let magic = RoutingBinaryFormat.magic
+            guard cursor + magic.count <= count else { throw ReadError.truncated }
+            for k in 0..<magic.count where bytes[cursor + k] != magic[k] { throw ReadError.badMagic }
+            cursor += magic.count
+        }
+
+        private mutating func u8() throws -> UInt8 {
+            guard cursor < count else { throw ReadError.truncated }
+            defer { cursor += 1 }
+            return bytes[cursor]
+        }
+
+        private mutating func u16() throws -> UInt16 {
+            guard cursor + 2 <= count else { throw ReadError.truncated }
+            defer { cursor += 2 }
+            return UInt16(bytes[cursor]) | (UInt16(bytes[cursor + 1]) << 8)
+        }
+
+        private mutating func u32() throws -> UInt32 {
+            guard cursor + 4 <= count else { throw ReadError.truncated }
+            defer { cursor += 4 }
+            return UInt32(bytes[cursor]) | (UInt32(bytes[cursor + 1]) << 8) | (UInt32(bytes[cursor + 2]) << 16) | (UInt32(bytes[cursor + 3]) << 24)
+        }
+
+        private mutating func advance(_ n: Int) throws {
+            guard n >= 0, cursor + n <= count else { throw ReadError.truncated }
+            cursor += n
+        }
+
+        private mutating func readUUID() throws -> UUID {
+            guard cursor + 16 <= count else { throw ReadError.truncated }
+            let u = UUID(uuid: (bytes[cursor], bytes[cursor + 1], bytes[cursor + 2], bytes[cursor + 3],
+                                bytes[cursor + 4], bytes[cursor + 5], bytes[cursor + 6], bytes[cursor + 7],
+                                bytes[cursor + 8], bytes[cursor + 9], bytes[cursor + 10], bytes[cursor + 11],
+                                bytes[cursor + 12], bytes[cursor + 13], bytes[cursor + 14], bytes[cursor + 15]))
+            cursor += 16
+            return u
+        }
+    }
+
+    // MARK: - Excluded routes
+    //
+    // With fake-IP DNS, only IP-literal connections reach a real address, and
+    // for those the country-bypass tier's DIRECT CIDRs can be routed around the
+    // tunnel altogether. A bypass prefix qualifies only if no rule that could
+    // send part of it elsewhere — a non-DIRECT IP rule of any tier — overlaps
+    // it, so excluding it never changes a decision the router would make. What
+    // remains is sibling-merged and, past `limit`, cut to the widest prefixes.
+
+    /// A prefix as a 128-bit MSB-first network; IPv4 sits in the top 32 bits of `hi`.
+    struct RoutePrefix: Hashable {
+        let hi: UInt64
+        let lo: UInt64
+        let length: UInt8
+
+        init(hi: UInt64, lo: UInt64, length: UInt8) {
+            let (maskHi, maskLo) = Self.mask(length)
+            self.hi = hi & maskHi
+            self.lo = lo & maskLo
+            self.length = length
+        }
+
+        init(ipv4 network: UInt32, length: Int) {
+            self.init(hi: UInt64(network) << 32, lo: 0, length: UInt8(length))
+        }
+
+        var ipv4Network: UInt32 { UInt32(truncatingIfNeeded: hi >> 32) }
+
+        func truncated(to length: UInt8) -> RoutePrefix {
+            RoutePrefix(hi: hi, lo: lo, length: length)
+        }
+
+        /// The last address inside the prefix.
+        var end: (UInt64, UInt64) {
+            let (maskHi, maskLo) = Self.mask(length)
+            return (hi | ~maskHi, lo | ~maskLo)
+        }
+
+        static func mask(_ length: UInt8) -> (UInt64, UInt64) {
+            let hi: UInt64 = length == 0 ? 0 : length >= 64 ? ~0 : ~0 << (64 - UInt64(length))
+            let lo: UInt64 = length <= 64 ? 0 : length >= 128 ? ~0 : ~0 << (128 - UInt64(length))
+            return (hi, lo)
+        }
+    }
+
+    /// Bypass-tier DIRECT prefixes per family that no other rule overlaps,
+    /// aggregated to at most `limit` each. `reserved` prefixes (the tunnel's own
+    /// subnets, the fake-IP pools) block like a non-DIRECT rule; `bypassIPv4`
+    /// joins the bypass tier's own CIDRs, for the country ranges the payload
+    /// leaves to the ``GeoIPTable``. Nil if the payload doesn't parse.
+    static func excludedRoutePrefixes(routingData data: Data, reserved: [RoutePrefix], reservedIPv6: [RoutePrefix],
+                                      bypassIPv4: [RoutePrefix] = [],
+                                      limit: Int) -> (ipv4: [RoutePrefix], ipv6: [RoutePrefix])? {
+        var v4 = RoutePrefixAggregator(blockers: reserved)
+        for prefix in bypassIPv4 {
+            v4.add(prefix, candidate: true)
+        }
+        var v6 = RoutePrefixAggregator(blockers: reservedIPv6)
+        do {
+            try data.withUnsafeBytes { raw in
+                let bytes = raw.bindMemory(to: UInt8.self)
+                var reader = RoutingBinaryReader(bytes: bytes)
+                let split = try reader.split()
+                for (t, source) in split.tierSources.enumerated() {
+                    let isBypass = t == Int(RoutingBinaryFormat.Tier.bypass.rawValue)
+                    try source.withUnsafeBufferPointer { base in
+                        var tierReader = RoutingBinaryReader(bytes: base)
+                        try tierReader.readEntries { action, type, valueStart, length in
+                            let candidate = isBypass && action == .direct
+                            // DIRECT rules above the bypass tier agree with it; they neither add nor block.
+                            guard candidate || action != .direct else { return }
+                            let value = String(decoding: base[valueStart..<valueStart + length], as: UTF8.self)
+                            switch type {
+                            case .ipCIDR:
+                                guard let parsed = parseIPv4CIDR(value) else { return }
+                                v4.add(RoutePrefix(ipv4: parsed.network, length: parsed.prefixLen), candidate: candidate)
+                            case .ipCIDR6:
+                                guard let parsed = parseIPv6CIDR(value) else { return }
+                                let packed = parsed.network.withUnsafeBufferPointer { CIDRv6Trie.pack16($0) }
+                                v6.add(RoutePrefix(hi: packed.0, lo: packed.1, length: UInt8(parsed.prefixLen)), candidate: candidate)
+                            case .domainSuffix, .domainKeyword:
+                                break
+                            }
+                        }
+                    }
+                }
+            }
+        } catch {
+            logger.error("[RoutingCompiler] Routing payload parse failed: \(error)")
+            return nil
+        }
+        return (v4.aggregate(limit: limit), v6.aggregate(limit: limit))
+    }
+
+    private struct RoutePrefixAggregator {
+        private var blockerSet: Set<RoutePrefix>
+        private var blockers: [RoutePrefix]
+        private var candidates: [RoutePrefix] = []
+
+        init(blockers: [RoutePrefix]) {
+            self.blockers = blockers
+            blockerSet = Set(blockers)
+        }
+
+        mutating func add(_ prefix: RoutePrefix, candidate: Bool) {
+            if candidate {
+                candidates.append(prefix)
+            } else {
+                blockers.append(prefix)
+                blockerSet.insert(prefix)
+            }
+        }
+
+        func aggregate(limit: Int) -> [RoutePrefix] {
+            let sortedBlockers = blockers.sorted(by: Self.precedes)
+            var out: [RoutePrefix] = []
+            for prefix in candidates.sorted(by: Self.precedes) where !isBlocked(prefix, sortedBlockers) {
+                // Sorted by start, widest first: anything starting inside the last kept prefix is inside it.
+                if let last = out.last, !Self.startsAfter(prefix, last.end) { continue }
+                out.append(prefix)
+                while out.count >= 2 {
+                    let a = out[out.count - 2], b = out[out.count - 1]
+                    guard a.length == b.length, a.length > 0,
+                          a.truncated(to: a.length - 1) == b.truncated(to: b.length - 1) else { break }
+                    out.removeLast(2)
+                    out.append(a.truncated(to: a.length - 1))
+                }
+            }
+            guard out.count > limit else { return out }
+            return out.sorted { $0.length < $1.length }.prefix(limit).sorted(by: Self.precedes)
+        }
+
+        /// Prefixes nest or are disjoint, so an overlap is a blocker covering
+        /// `prefix` (one of its truncations) or one starting inside it.
+        private func isBlocked(_ prefix: RoutePrefix, _ sorted: [RoutePrefix]) -> Bool {
+            for length in 0...prefix.length where blockerSet.contains(prefix.truncated(to: length)) {
+                return true
+            }
+            var low = 0, high = sorted.count
+            while low < high {
+                let mid = (low + high) / 2
+                if Self.startsBefore(sorted[mid], prefix) { low = mid + 1 } else { high = mid }
+            }
+            return low < sorted.count && !Self.startsAfter(sorted[low], prefix.end)
+        }
+
+        private static func precedes(_ a: RoutePrefix, _ b: RoutePrefix) -> Bool {
+            (a.hi, a.lo, a.length) < (b.hi, b.lo, b.length)
+        }
+
+        private static func startsBefore(_ a: RoutePrefix, _ b: RoutePrefix) -> Bool {
+            (a.hi, a.lo) < (b.hi, b.lo)
+        }
+
+        private static func startsAfter(_ a: RoutePrefix, _ end: (UInt64, UInt64)) -> Bool {
+            (a.hi, a.lo) > end
+        }
+    }
+
+    // MARK: - CIDR Parsing
+
+    /// Parses "A.B.C.D/prefix" into (network, prefixLen) with host bits zeroed.
+    private static func parseIPv4CIDR(_ cidr: String) -> (network: UInt32, prefixLen: Int)? {
+        let parts = cidr.split(separator: "/", maxSplits: 1)
+        guard parts.count == 2,
+              let prefixLen = Int(parts[1]),
+              prefixLen >= 0, prefixLen <= 32,
+              let ip = parseIPv4(String(parts[0])) else { return nil }
+        let mask: UInt32 = prefixLen == 0 ? 0 : ~UInt32(0) << (32 - prefixLen)
+        return (network: ip & mask, prefixLen: prefixLen)
+    }
+
+    /// Parses a dotted-quad IPv4 string to host-order UInt32.
+    static func parseIPv4(_ ip: String) -> UInt32? {
+        let parts = ip.split(separator: ".", maxSplits: 4, omittingEmptySubsequences: false)
+        guard parts.count == 4 else { return nil }
+        var result: UInt32 = 0
+        for part in parts {
+            guard let byte = UInt8(part) else { return nil }
+            result = result << 8 | UInt32(byte)
+        }
+        return result
+    }
+
+    private static func parseIPv6CIDR(_ cidr: String) -> (network: [UInt8], prefixLen: Int)? {
+        let parts = cidr.split(separator: "/", maxSplits: 1)
+        guard parts.count == 2,
+              let prefixLen = Int(parts[1]),
+              prefixLen >= 0, prefixLen <= 128 else { return nil }
+
+        var address = in6_addr()
+        guard inet_pton(AF_INET6, String(parts[0]), &address) == 1 else { return nil }
+
+        var network = withUnsafeBytes(of: &address) { Array($0.bindMemory(to: UInt8.self)) }
+        // Zero host bits
+        for i in 0..<16 {
+            let bitPos = i * 8
+            if bitPos >= prefixLen {
+                network[i] = 0
+            } else if bitPos + 8 > prefixLen {
+                let keep = prefixLen - bitPos
+                network[i] &= ~UInt8(0) << (8 - keep)
+            }
+        }
+        return (network: network, prefixLen: prefixLen)
+    }
+}
@@ -0,0 +1,376 @@
+//
+//  RoutingImage.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+// MARK: - Format
+//
+// A routing image is the compiled form of the "ARB2" routing payload: every
+// tier's frozen matchers written as flat columns the extension maps read-only
+// and queries in place, so a tunnel start does no parsing or trie building.
+//
+//   header (32 B)   magic "ARI1", version u32, column count u32, tier count u32,
+//                   directory offset u64, reserved u64
+//   columns         raw little-endian element arrays, each 8-byte aligned
+//   directory       (offset u64, byte count u64) per column, in write order
+//
+// All offsets are file-relative, so the image is position-independent. The
+// column order is fixed by the writers: the configuration table, then per tier
+// the rule counts, proxy UUIDs and keyword automaton with its prefilter, then the cross-tier
+// merged matchers — their ID table, suffix trie and its negative filter, IPv4
+// stride table and IPv6 trie. A reader that finds anything out of place rejects the whole image.
+
+nonisolated enum RoutingImageFormat {
+    static let magic: [UInt8] = [0x41, 0x52, 0x49, 0x31]    // "ARI1"
+    /// Bump whenever a matcher's column layout changes.
+    static let version: UInt32 = 8
+    static let headerSize = 32
+    static let directoryEntrySize = 16
+}
+
+// MARK: - Action interning
+//
+// Interning `RouteTarget` (~32 B with UUID payload) to an `Int16` ID keeps matcher
+// nodes small. Top-level so the matchers and their image views share the sentinels.
+
+nonisolated struct ActionTable {
+    static let noneID: Int16 = -1
+    static let directID: Int16 = 0
+    static let rejectID: Int16 = 1
+    fileprivate static let firstProxyID: Int16 = 2
+
+    private(set) var proxyUUIDs: [UUID] = []
+    private var proxyIndex: [UUID: Int16] = [:]
+
+    mutating func intern(_ action: RouteTarget) -> Int16 {
+        switch action {
+        case .direct: return Self.directID
+        case .reject: return Self.rejectID
+        case .proxy(let uuid):
+            if let id = proxyIndex[uuid] { return id }
+            let id = Self.firstProxyID + Int16(proxyUUIDs.count)
+            proxyUUIDs.append(uuid)
+            proxyIndex[uuid] = id
+            return id
+        }
+    }
+
+    func resolve(_ id: Int16) -> RouteTarget? {
+        Self.resolve(id, proxies: proxyUUIDs)
+    }
+
+    static func resolve(_ id: Int16, proxies: [UUID]) -> RouteTarget? {
+        switch id {
+        case noneID: return nil
+        case directID: return .direct
+        case rejectID: return .reject
+        default:
+            let index = Int(id) - Int(firstProxyID)
+            guard index >= 0, index < proxies.count else { return nil }
+            return .proxy(proxies[index])
+        }
+    }
+}
+
+// MARK: - Writer
+
+nonisolated struct RoutingImageWriter {
+    private var bytes: [UInt8] = Array(repeating: 0, count: RoutingImageFormat.headerSize)
+    private var directory: [(offset: UInt64, byteCount: UInt64)] = []
+
+    /// Appends `values` as the next column.
+    mutating func column<C: Collection>(_ values: C) where C.Element: FixedWidthInteger {
+        padToAlignment()
+        let offset = bytes.count
+        #if _endian(little)
+        let copied: Void? = values.withContiguousStorageIfAvailable { buffer in
+            bytes.append(contentsOf: UnsafeRawBufferPointer(buffer))
+        }
+        #else
+        let copied: Void? = nil
+        #endif
+        if copied == nil {
+            for value in values {
+                withUnsafeBytes(of: value.littleEndian) { bytes.append(contentsOf: $0) }
+            }
+        }
+        directory.append((UInt64(offset), UInt64(bytes.count - offset)))
+    }
+
+    /// The finished image: columns, then the directory, then the header patched in.
+    func finish(tierCount: Int) -> Data {
+        var out = self
+        out.padToAlignment()
+        let directoryOffset = out.bytes.count
+        for entry in directory {
+            out.appendLittleEndian(entry.offset)
+            out.appendLittleEndian(entry.byteCount)
+        }
+
+        var header: [UInt8] = RoutingImageFormat.magic
+        for value in [RoutingImageFormat.version, UInt32(directory.count), UInt32(tierCount)] {
+            withUnsafeBytes(of: value.littleEndian) { header.append(contentsOf: $0) }
+        }
+        withUnsafeBytes(of: UInt64(directoryOffset).littleEndian) { header.append(contentsOf: $0) }
+        out.bytes.replaceSubrange(0..<header.count, with: header)
+        return Data(out.bytes)
+    }
+
+    private mutating func padToAlignment() {
+        while bytes.count & 7 != 0 { bytes.append(0) }
+    }
+
+    private mutating func appendLittleEndian(_ value: UInt64) {
+        withUnsafeBytes(of: value.littleEndian) { bytes.append(contentsOf: $0) }
+    }
+}
+
+// MARK: - Image
+
+/// A validated routing image, memory-mapped from the App Group or held in a
+/// heap copy. Its tier views point into the image's bytes, so keep the image
+/// alive for as long as any view is in use.
+nonisolated final class RoutingImage {
+
+    /// Owns the bytes; unmaps or frees them when the last view's owner lets go.
+    private final class Storage {
+        let base: UnsafeRawPointer
+        let size: Int
+        private let isMapped: Bool
+
+        init(mapping base: UnsafeRawPointer, size: Int) {
+            self.base = base
+            self.size = size
+            isMapped = true
+        }
+
+        init(copying data: Data) {
+            let buffer = UnsafeMutableRawPointer.allocate(byteCount: max(data.count, 1), alignment: 16)
+            data.copyBytes(to: buffer.assumingMemoryBound(to: UInt8.self), count: data.count)
+            base = UnsafeRawPointer(buffer)
+            size = data.count
+            isMapped = false
+        }
+
+        deinit {
+            if isMapped {
+                munmap(UnsafeMutableRawPointer(mutating: base), size)
+            } else {
+                UnsafeMutableRawPointer(mutating: base).deallocate()
+            }
+        }
+    }
+
+    /// Sequential reader over the column directory. Each `next` consumes one
+    /// column and checks that it lies inside the image and holds whole,
+    /// aligned elements of the requested type.
+    struct Columns {
+        fileprivate let base: UnsafeRawPointer
+        fileprivate let size: Int
+        fileprivate let directoryOffset: Int
+        fileprivate let count: Int
+        fileprivate var index = 0
+
+        mutating func next<T: FixedWidthInteger>(_: T.Type) -> UnsafeBufferPointer<T>? {
+            guard index < count else { return nil }
+            let entry = directoryOffset + index * RoutingImageFormat.directoryEntrySize
+            index += 1
+            let offset = UInt64(littleEndian: base.load(fromByteOffset: entry, as: UInt64.self))
+            let byteCount = UInt64(littleEndian: base.load(fromByteOffset: entry + 8, as: UInt64.self))
+            guard offset <= UInt64(size), byteCount <= UInt64(size) - offset else { return nil }
+            let start = Int(offset), length = Int(byteCount)
+            guard start % MemoryLayout<T>.alignment == 0, length % MemoryLayout<T>.stride == 0 else { return nil }
+            let elements = length / MemoryLayout<T>.stride
+            return UnsafeBufferPointer(start: (base + start).bindMemory(to: T.self, capacity: elements), count: elements)
+        }
+    }
+
+    private let storage: Storage
+
+    /// Each proxy configuration's JSON from the payload's configuration
+    /// table, still encoded; see ``RoutingBinaryFormat``.
+    let configurations: [UUID: Data]
+    let tiers: [RoutingTierView]
+    private let suffixTrie: FlatLabelTrieView
+    private let suffixFilter: DomainSuffixFilterView
+    private let ipv4Table: CIDRv4TableView
+    private let ipv6Trie: CIDRv6TrieView
+    /// Merged matcher ID → the tier that owns the rule and its action.
+    private let mergedTier: [Int]
+    private let mergedTarget: [RouteTarget]
+
+    /// Maps `url` read-only. Nil when the file is missing, stale or malformed.
+    static func mapped(at url: URL) -> RoutingImage? {
+        let fd = open(url.path, O_RDONLY)
+        guard fd >= 0 else { return nil }
+        defer { close(fd) }
+        var info = stat()
+        guard fstat(fd, &info) == 0, info.st_size >= RoutingImageFormat.headerSize else { return nil }
+        let size = Int(info.st_size)
+        guard let mapping = mmap(nil, size, PROT_READ, MAP_PRIVATE, fd, 0), mapping != MAP_FAILED else { return nil }
+        return RoutingImage(storage: Storage(mapping: UnsafeRawPointer(mapping), size: size))
+    }
+
+    /// Validates a heap copy of `bytes`, e.g. an image compiled in-process.
+    convenience init?(bytes: Data) {
+        guard bytes.count >= RoutingImageFormat.headerSize else { return nil }
+        self.init(storage: Storage(copying: bytes))
+    }
+
+    private init?(storage: Storage) {
+        let base = storage.base
+        guard (0..<4).allSatisfy({ base.load(fromByteOffset: $0, as: UInt8.self) == RoutingImageFormat.magic[$0] }),
+              UInt32(littleEndian: base.load(fromByteOffset: 4, as: UInt32.self)) == RoutingImageFormat.version
+        else { return nil }
+        let columnCount = Int(UInt32(littleEndian: base.load(fromByteOffset: 8, as: UInt32.self)))
+        let tierCount = Int(UInt32(littleEndian: base.load(fromByteOffset: 12, as: UInt32.self)))
+        let directoryOffset = UInt64(littleEndian: base.load(fromByteOffset: 16, as: UInt64.self))
+        guard directoryOffset & 7 == 0, directoryOffset <= UInt64(storage.size),
+              UInt64(storage.size) - directoryOffset >= UInt64(columnCount * RoutingImageFormat.directoryEntrySize)
+        else { return nil }
+
+        var columns = Columns(base: base, size: storage.size, directoryOffset: Int(directoryOffset), count: columnCount)
+        guard let configurationTable = columns.next(UInt8.self),
+              let configurations = Self.configurations(in: configurationTable) else { return nil }
+        var tiers: [RoutingTierView] = []
+        tiers.reserveCapacity(tierCount)
+        for _ in 0..<tierCount {
+            guard let tier = RoutingTierView(columns: &columns) else { return nil }
+            tiers.append(tier)
+        }
+        guard let mergedTierIndex = columns.next(UInt8.self), let mergedActionID = columns.next(Int16.self),
+              mergedActionID.count == mergedTierIndex.count,
+              let suffixTrie = FlatLabelTrieView(columns: &columns),
+              let suffixFilter = DomainSuffixFilterView(columns: &columns),
+              let ipv4Table = CIDRv4TableView(columns: &columns),
+              let ipv6Trie = CIDRv6TrieView(columns: &columns),
+              columns.index == columnCount
+        else { return nil }
+        var mergedTier: [Int] = []
+        var mergedTarget: [RouteTarget] = []
+        for (tier, actionID) in zip(mergedTierIndex, mergedActionID) {
+            guard Int(tier) < tiers.count, let target = tiers[Int(tier)].resolve(actionID) else { return nil }
+            mergedTier.append(Int(tier))
+            mergedTarget.append(target)
+        }
+
+        self.storage = storage
+        self.configurations = configurations
+        self.tiers = tiers
+        self.suffixTrie = suffixTrie
+        self.suffixFilter = suffixFilter
+        self.ipv4Table = ipv4Table
+        self.ipv6Trie = ipv6Trie
+        self.mergedTier = mergedTier
+        self.mergedTarget = mergedTarget
+    }
+
+    /// Indexes a configuration table by UUID without decoding any JSON.
+    /// Nil if an entry runs past the table.
+    private static func configurations(in table: UnsafeBufferPointer<UInt8>) -> [UUID: Data]? {
+        func u32(at i: Int) -> UInt32 {
+            UInt32(table[i]) | UInt32(table[i + 1]) << 8 | UInt32(table[i + 2]) << 16 | UInt32(table[i + 3]) << 24
+        }
+        guard table.count >= 4 else { return table.isEmpty ? [:] : nil }
+        let count = Int(u32(at: 0))
+        var configurations: [UUID: Data] = [:]
+        configurations.reserveCapacity(count)
+        var cursor = 4
+        for _ in 0..<count {
+            guard table.count - cursor >= 20 else { return nil }
+            let id = UUID(uuid: (table[cursor], table[cursor + 1], table[cursor + 2], table[cursor + 3],
+                                 table[cursor + 4], table[cursor + 5], table[cursor + 6], table[cursor + 7],
+                                 table[cursor + 8], table[cursor + 9], table[cursor + 10], table[cursor + 11],
+                                 table[cursor + 12], table[cursor + 13], table[cursor + 14], table[cursor + 15]))
+            let length = Int(u32(at: cursor + 16))
+            cursor += 20
+            guard table.count - cursor >= length else { return nil }
+            configurations[id] = Data(UnsafeBufferPointer(rebasing: table[cursor..<cursor + length]))
+            cursor += length
+        }
+        return configurations
+    }
+
+    // MARK: Lookup
+    //
+    // First matching tier wins; within a tier, suffix beats keyword. Suffix and
+    // CIDR rules are merged across tiers at compile time (see ``RoutingCompiler``),
+    // so each is one walk, and keywords are checked only for tiers above the
+    // suffix hit. A host the suffix filter rules out skips the trie walk.
+
+    func lookupDomain(_ domain: UnsafeBufferPointer<UInt8>) -> RouteTarget? {
+        var suffixTier = tiers.count
+        var suffixTarget: RouteTarget?
+        if suffixFilter.mayMatch(domain), let id = suffixTrie.lookup(domain), Int(id) < mergedTarget.count {
+            suffixTier = mergedTier[Int(id)]
+            suffixTarget = mergedTarget[Int(id)]
+        }
+        for i in 0..<suffixTier {
+            if let target = tiers[i].lookupKeyword(domain) { return target }
+        }
+        return suffixTarget
+    }
+
+    func lookupIPv4(_ ip: UInt32) -> RouteTarget? {
+        target(merged: ipv4Table.lookup(ip))
+    }
+
+    func lookupIPv6(hi: UInt64, lo: UInt64) -> RouteTarget? {
+        target(merged: ipv6Trie.lookup(hi: hi, lo: lo))
+    }
+
+    private func target(merged id: Int16) -> RouteTarget? {
+        id >= 0 && Int(id) < mergedTarget.count ? mergedTarget[Int(id)] : nil
+    }
+
+    /// Whether `url` holds an image this build can read, checked from the header alone.
+    static func isCurrent(at url: URL) -> Bool {
+        guard let handle = try? FileHandle(forReadingFrom: url) else { return false }
+        defer { try? handle.close() }
+        guard let header = try? handle.read(upToCount: 8), header.count == 8 else { return false }
+        let version = header[header.startIndex + 4..<header.startIndex + 8].reversed().reduce(UInt32(0)) { $0 << 8 | UInt32($1) }
+        return header.prefix(4).elementsEqual(RoutingImageFormat.magic) && version == RoutingImageFormat.version
+    }
+}
+
+// MARK: - Tier view
+
+/// One tier's share of an image: its rule counts, the proxies its action IDs
+/// name, and its keyword automaton.
+nonisolated struct RoutingTierView {
+    let domainRuleCount: Int
+    let ipRuleCount: Int
+    private let proxies: [UUID]
+    private let keywordAutomaton: KeywordAutomatonView
+
+    var isEmpty: Bool { domainRuleCount == 0 && ipRuleCount == 0 }
+
+    /// Reads one tier's columns as ``RoutingCompiler`` wrote them.
+    init?(columns: inout RoutingImage.Columns) {
+        guard let counts = columns.next(UInt32.self), counts.count == 2,
+              let proxyBytes = columns.next(UInt8.self), proxyBytes.count % 16 == 0,
+              let keywordAutomaton = KeywordAutomatonView(columns: &columns)
+        else { return nil }
+        domainRuleCount = Int(counts[0])
+        ipRuleCount = Int(counts[1])
+        proxies = stride(from: 0, to: proxyBytes.count, by: 16).map { i in
+            UUID(uuid: (proxyBytes[i], proxyBytes[i + 1], proxyBytes[i + 2], proxyBytes[i + 3],
+                        proxyBytes[i + 4], proxyBytes[i + 5], proxyBytes[i + 6], proxyBytes[i + 7],
+                        proxyBytes[i + 8], proxyBytes[i + 9], proxyBytes[i + 10], proxyBytes[i + 11],
+                        proxyBytes[i + 12], proxyBytes[i + 13], proxyBytes[i + 14], proxyBytes[i + 15]))
+        }
+        self.keywordAutomaton = keywordAutomaton
+    }
+
+    func resolve(_ actionID: Int16) -> RouteTarget? {
+        ActionTable.resolve(actionID, proxies: proxies)
+    }
+
+    func lookupKeyword(_ domain: UnsafeBufferPointer<UInt8>) -> RouteTarget? {
+        resolve(keywordAutomaton.lookup(domain))
+    }
+}
@@ -0,0 +1,202 @@
+//
+//  RoutingRuleSetColumns.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Binary form of an `.arrs` rule set: one column per ``RoutingRuleType``, each
+/// sorted bytewise and deduplicated. Loading one is a bounds check over the
+/// column ends, so a subscription's file is mapped rather than parsed, and its
+/// values go into the routing payload as they stand: domains are folded to
+/// lowercase and values too long for a payload rule dropped when the columns
+/// are built.
+///
+/// All integers little-endian. Layout:
+/// ```
+/// magic       "ARS1"              4 bytes
+/// routing     UInt8               RuleSetImportRoute raw value
+/// nameLen     UInt16
+/// name        [nameLen]           UTF-8
+/// columns     4 × Column          in RoutingRuleType raw-value order
+///
+/// Column:
+///   count     UInt32
+///   ends      count × UInt32      end of each value, relative to `values`
+///   values    [ends.last]         UTF-8 values, concatenated
+/// ```
+nonisolated struct RoutingRuleSetColumns {
+    static let magic: [UInt8] = [0x41, 0x52, 0x53, 0x31]  // "ARS1"
+
+    private static let columnOrder: [RoutingRuleType] = [.ipCIDR, .ipCIDR6, .domainSuffix, .domainKeyword]
+
+    /// The file's bytes, usually mapped.
+    let data: Data
+    let name: String
+    let routingCode: UInt8
+    private let columns: [Column]
+
+    private struct Column {
+        let type: RoutingRuleType
+        let count: Int
+        /// Offsets from `data.startIndex`.
+        let endsStart: Int
+        let valuesStart: Int
+    }
+
+    var ruleCount: Int { columns.reduce(0) { $0 + $1.count } }
+
+    static func isBinary(_ data: Data) -> Bool {
+        data.starts(with: magic)
+    }
+
+    /// Nil unless `data` is a well-formed rule-set file.
+    init?(data: Data) {
+        let header: (name: String, routing: UInt8, columns: [Column])? = data.withUnsafeBytes { raw in
+            let bytes = raw.bindMemory(to: UInt8.self)
+            guard bytes.count >= Self.magic.count + 3,
+                  bytes.starts(with: Self.magic) else { return nil }
+            let routing = bytes[4]
+            let nameLength = Int(Self.u16(bytes, 5))
+            var cursor = 7 + nameLength
+            guard cursor <= bytes.count else { return nil }
+            let name = String(decoding: bytes[7..<cursor], as: UTF8.self)
+
+            var columns: [Column] = []
+            for type in Self.columnOrder {
+                guard cursor + 4 <= bytes.count else { return nil }
+                let count = Int(Self.u32(bytes, cursor))
+                let endsStart = cursor + 4
+                let valuesStart = endsStart + 4 * count
+                guard count <= bytes.count, valuesStart <= bytes.count else { return nil }
+                var previous = 0
+                for i in 0..<count {
+                    let end = Int(Self.u32(bytes, endsStart + 4 * i))
+                    guard end > previous, end - previous <= Int(UInt16.max) else { return nil }
+                    previous = end
+                }
+                guard valuesStart + previous <= bytes.count else { return nil }
+                columns.append(Column(type: type, count: count, endsStart: endsStart, valuesStart: valuesStart))
+                cursor = valuesStart + previous
+            }
+            return (name, routing, columns)
+        }
+        guard let header else { return nil }
+        self.data = data
+        self.name = header.name
+        self.routingCode = header.routing
+        self.columns = header.columns
+    }
+
+    /// Maps the file at `url`; nil if it is missing or malformed.
+    init?(contentsOf url: URL) {
+        guard let data = try? Data(contentsOf: url, options: .alwaysMapped) else { return nil }
+        self.init(data: data)
+    }
+
+    /// Hands every value to `body` in column order, as a view into `data`.
+    func forEachValue(_ body: (RoutingRuleType, UnsafeBufferPointer<UInt8>) -> Void) {
+        data.withUnsafeBytes { raw in
+            let bytes = raw.bindMemory(to: UInt8.self)
+            for column in columns {
+                var start = column.valuesStart
+                for i in 0..<column.count {
+                    let end = column.valuesStart + Int(Self.u32(bytes, column.endsStart + 4 * i))
+                    body(column.type, UnsafeBufferPointer(rebasing: bytes[start..<end]))
+                    start = end
+                }
+            }
+        }
+    }
+
+    /// The values as rules, in column order.
+    func rules() -> [RoutingRule] {
+        var rules: [RoutingRule] = []
+        rules.reserveCapacity(ruleCount)
+        forEachValue { type, value in
+            rules.append(RoutingRule(type: type, value: String(decoding: value, as: UTF8.self)))
+        }
+        return rules
+    }
+
+    /// Whether `rules` are exactly what ``rules()`` returns, compared without materializing it.
+    func matches(_ rules: [RoutingRule]) -> Bool {
+        guard rules.count == ruleCount else { return false }
+        var index = 0
+        var equal = true
+        forEachValue { type, value in
+            guard equal else { return }
+            let rule = rules[index]
+            index += 1
+            equal = rule.type == type && rule.value.utf8.elementsEqual(value)
+        }
+        return equal
+    }
+
+    // MARK: - Writing
+
+    /// The file for `rules`, folded the way the routing payload folds them.
+    static func encode(name: String, routingCode: UInt8, rules: [RoutingRule]) -> Data {
+        var values = [[[UInt8]]](repeating: [], count: columnOrder.count)
+        for rule in rules {
+            let value: String
+            switch rule.type {
+            case .domainSuffix, .domainKeyword: value = rule.value.lowercased()
+            case .ipCIDR, .ipCIDR6: value = rule.value
+            }
+            let utf8 = Array(value.utf8)
+            guard !utf8.isEmpty, utf8.count <= Int(UInt16.max) else { continue }
+            values[rule.type.rawValue].append(utf8)
+        }
+
+        var bytes = magic
+        bytes.append(routingCode)
+        let nameBytes = Array(name.utf8.prefix(Int(UInt16.max)))
+        appendU16(UInt16(nameBytes.count), to: &bytes)
+        bytes.append(contentsOf: nameBytes)
+        for type in columnOrder {
+            var column = values[type.rawValue]
+            column.sort { $0.lexicographicallyPrecedes($1) }
+            var unique: [[UInt8]] = []
+            unique.reserveCapacity(column.count)
+            for value in column where unique.last != value {
+                unique.append(value)
+            }
+            appendU32(UInt32(unique.count), to: &bytes)
+            var end = 0
+            for value in unique {
+                end += value.count
+                appendU32(UInt32(end), to: &bytes)
+            }
+            for value in unique {
+                bytes.append(contentsOf: value)
+            }
+        }
+        return Data(bytes)
+    }
+
+    // MARK: - Primitives
+
+    private static func u16(_ bytes: UnsafeBufferPointer<UInt8>, _ offset: Int) -> UInt16 {
+        UInt16(bytes[offset]) | (UInt16(bytes[offset + 1]) << 8)
+    }
+
+    private static func u32(_ bytes: UnsafeBufferPointer<UInt8>, _ offset: Int) -> UInt32 {
+        UInt32(bytes[offset]) | (UInt32(bytes[offset + 1]) << 8)
+            | (UInt32(bytes[offset + 2]) << 16) | (UInt32(bytes[offset + 3]) << 24)
+    }
+
+    private static func appendU16(_ v: UInt16, to bytes: inout [UInt8]) {
+        bytes.append(UInt8(truncatingIfNeeded: v))
+        bytes.append(UInt8(truncatingIfNeeded: v >> 8))
+    }
+
+    private static func appendU32(_ v: UInt32, to bytes: inout [UInt8]) {
+        bytes.append(UInt8(truncatingIfNeeded: v))
+        bytes.append(UInt8(truncatingIfNeeded: v >> 8))
+        bytes.append(UInt8(truncatingIfNeeded: v >> 16))
+        bytes.append(UInt8(truncatingIfNeeded: v >> 24))
+    }
+}
@@ -28,34 +28,37 @@ struct ClashProxyParser {
     }
 
     static func parse(yaml yamlString: String) throws -> ParseResult {
-        let root: YAML.Node
+        try parse(stream: InputStream(data: Data(yamlString.utf8)))
+    }
+
+    /// Streams `proxies` out of `stream` (a downloaded file or an in-memory body): each entry is
+    /// built, converted and released before the next is read, and the rest of the document (rules,
+    /// groups) is skipped without building nodes.
+    static func parse(stream: InputStream) throws -> ParseResult {
+        var configurations: [ProxyConfiguration] = []
+        var skippedCount = 0
+
+        let outcome: YAML.StreamedSequence
         do {
-            root = try YAML.load(yamlString)
+            outcome = try YAML.forEachElement(inSequence: "proxies", from: stream) { proxyNode in
+                if proxyNode.type == .map, let configuration = parseProxy(proxyNode) {
+                    configurations.append(configuration)
+                } else {
+                    skippedCount += 1
+                }
+            }
         } catch {
             throw ParseError.invalidYAML(error.localizedDescription)
         }
 
-        guard root.type == .map else {
+        switch outcome {
+        case .streamed:
+            return ParseResult(configurations: configurations, skippedCount: skippedCount)
+        case .rootNotMapping:
             throw ParseError.invalidYAML("Root document is not a mapping")
-        }
-
-        let proxies = root["proxies"]
-        guard proxies.type == .sequence else {
+        case .keyMissing:
             throw ParseError.missingProxiesKey
         }
-
-        var configurations: [ProxyConfiguration] = []
-        var skippedCount = 0
-
-        for proxyNode in proxies {
-            if proxyNode.type == .map, let configuration = parseProxy(proxyNode) {
-                configurations.append(configuration)
-            } else {
-                skippedCount += 1
-            }
-        }
-
-        return ParseResult(configurations: configurations, skippedCount: skippedCount)
     }
 
     // MARK: - Dispatch
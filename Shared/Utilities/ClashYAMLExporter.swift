@@ -0,0 +1,313 @@
+//
+//  ClashYAMLExporter.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// The inverse of ``ClashProxyParser``: writes `proxies` and `rules` through ``YAML/Emitter``
+/// one entry at a time, so an export of any size holds a single proxy or rule in flight rather
+/// than the whole document as a string.
+struct ClashYAMLExporter {
+    struct ExportResult {
+        let exportedCount: Int
+        let skippedCount: Int
+    }
+
+    /// Rules routed to one Clash policy — a proxy name from the export, or `DIRECT` / `REJECT`.
+    struct RuleSet {
+        let policy: String
+        let rules: [RoutingRule]
+    }
+
+    /// Writes a Clash document to a new file at `url`, replacing any file there. A failed export
+    /// removes the partial file.
+    static func export<Configurations: Sequence<ProxyConfiguration>>(
+        configurations: Configurations,
+        ruleSets: [RuleSet] = [],
+        finalPolicy: String? = nil,
+        to url: URL
+    ) throws -> ExportResult {
+        let fileManager = FileManager.default
+        if fileManager.fileExists(atPath: url.path) {
+            try fileManager.removeItem(at: url)
+        }
+        guard fileManager.createFile(atPath: url.path, contents: nil) else {
+            throw CocoaError(.fileWriteUnknown, userInfo: [NSFilePathErrorKey: url.path])
+        }
+        do {
+            let handle = try FileHandle(forWritingTo: url)
+            defer { try? handle.close() }
+            return try export(configurations: configurations, ruleSets: ruleSets, finalPolicy: finalPolicy, to: handle)
+        } catch {
+            try? fileManager.removeItem(at: url)
+            throw error
+        }
+    }
+
+    /// Configurations with no Clash equivalent (Nowhere, Naive, gRPC / XHTTP transports,
+    /// plaintext Trojan / AnyTLS, chained proxies) are counted as skipped. `finalPolicy`
+    /// appends a `MATCH` rule.
+    static func export<Configurations: Sequence<ProxyConfiguration>>(
+        configurations: Configurations,
+        ruleSets: [RuleSet] = [],
+        finalPolicy: String? = nil,
+        to handle: FileHandle
+    ) throws -> ExportResult {
+        let emitter = try YAML.Emitter(handle: handle)
+        var exportedCount = 0
+        var skippedCount = 0
+
+        try emitter.beginMapping()
+        try emitter.scalar("proxies")
+        try emitter.beginSequence()
+        for configuration in configurations {
+            if try emitProxy(configuration, to: emitter) {
+                exportedCount += 1
+            } else {
+                skippedCount += 1
+            }
+        }
+        try emitter.endSequence()
+
+        if !ruleSets.isEmpty || finalPolicy != nil {
+            try emitter.scalar("rules")
+            try emitter.beginSequence()
+            for ruleSet in ruleSets {
+                for rule in ruleSet.rules {
+                    try emitter.scalar("\(ruleType(rule.type)),\(rule.value),\(ruleSet.policy)")
+                }
+            }
+            if let finalPolicy {
+                try emitter.scalar("MATCH,\(finalPolicy)")
+            }
+            try emitter.endSequence()
+        }
+        try emitter.endMapping()
+        try emitter.finish()
+
+        return ExportResult(exportedCount: exportedCount, skippedCount: skippedCount)
+    }
+
+    // MARK: - Dispatch
+
+    /// Returns false, before emitting anything, when `configuration` has no Clash form.
+    private static func emitProxy(_ configuration: ProxyConfiguration, to emitter: YAML.Emitter) throws -> Bool {
+        guard configuration.chain?.isEmpty ?? true, isExportable(configuration.outbound) else { return false }
+
+        try emitter.beginMapping()
+        try emitter.pair("name", configuration.name)
+        try emitter.pair("server", configuration.serverAddress)
+        try emitter.pair("port", Int(configuration.serverPort))
+        try emitter.pair("udp", true)
+
+        switch configuration.outbound {
+        case .vless(let uuid, let encryption, let flow, let transport, let security):
+            try emitVLESS(uuid: uuid, encryption: encryption, flow: flow, transport: transport,
+                          security: security, server: configuration.serverAddress, to: emitter)
+        case .hysteria(let password, let congestionControl, let uploadMbps, let downloadMbps, let obfuscation, let sni):
+            try emitter.pair("type", "hysteria2")
+            try emitter.pair("password", password)
+            try emitter.pair("sni", sni)
+            // No `up` / `down` is what makes the parser pick BBR.
+            if congestionControl == .brutal {
+                try emitter.pair("up", "\(uploadMbps) Mbps")
+                try emitter.pair("down", "\(downloadMbps) Mbps")
+            }
+            if let obfuscation {
+                try emitter.pair("obfs", obfuscation.typeTag)
+                try emitter.pair("obfs-password", obfuscation.password)
+                if case .gecko(_, let minPacketSize, let maxPacketSize) = obfuscation {
+                    try emitter.pair("obfs-min-packet-size", minPacketSize)
+                    try emitter.pair("obfs-max-packet-size", maxPacketSize)
+                }
+            }
+        case .trojan(let password, .tls(let tls)):
+            try emitter.pair("type", "trojan")
+            try emitter.pair("password", password)
+            try emitTLS(tls, serverNameKey: "sni", to: emitter)
+        case .anytls(let password, let idleCheckInterval, let idleTimeout, let minIdleSession, .tls(let tls)):
+            try emitter.pair("type", "anytls")
+            try emitter.pair("password", password)
+            try emitter.pair("idle-session-check-interval", idleCheckInterval)
+            try emitter.pair("idle-session-timeout", idleTimeout)
+            try emitter.pair("min-idle-session", minIdleSession)
+            try emitTLS(tls, serverNameKey: "sni", to: emitter)
+        case .shadowsocks(let password, let method):
+            try emitter.pair("type", "ss")
+            try emitter.pair("cipher", method)
+            try emitter.pair("password", password)
+        case .socks5(let username, let password):
+            try emitter.pair("type", "socks5")
+            if let username { try emitter.pair("username", username) }
+            if let password { try emitter.pair("password", password) }
+        case .sudoku(let sudoku):
+            try emitSudoku(sudoku, to: emitter)
+        default:
+            break
+        }
+        try emitter.endMapping()
+        return true
+    }
+
+    private static func isExportable(_ outbound: Outbound) -> Bool {
+        switch outbound {
+        case .vless(_, _, _, let transport, _):
+            switch transport {
+            case .raw, .ws, .httpUpgrade: return true
+            case .grpc, .xhttp:           return false
+            }
+        case .trojan(_, .tls), .anytls(_, _, _, _, .tls):
+            return true
+        case .hysteria, .shadowsocks, .socks5, .sudoku:
+            return true
+        case .trojan, .anytls, .nowhere, .http11, .http2, .http3:
+            return false
+        }
+    }
+
+    // MARK: - VLESS
+
+    private static func emitVLESS(uuid: UUID, encryption: String, flow: String?, transport: XrayTransportLayer,
+                                  security: XraySecurityLayer, server: String, to emitter: YAML.Emitter) throws {
+        try emitter.pair("type", "vless")
+        try emitter.pair("uuid", uuid.uuidString.lowercased())
+        if !encryption.isEmpty && encryption != "none" {
+            try emitter.pair("encryption", encryption)
+        }
+        if let flow, !flow.isEmpty {
+            try emitter.pair("flow", flow)
+        }
+
+        switch security {
+        case .none:
+            break
+        case .tls(let tls):
+            try emitter.pair("tls", true)
+            try emitTLS(tls, serverNameKey: "servername", to: emitter)
+        case .reality(let reality):
+            try emitter.pair("tls", true)
+            try emitter.pair("servername", reality.serverName)
+            try emitFingerprint(reality.fingerprint, to: emitter)
+            try emitter.scalar("reality-opts")
+            try emitter.beginMapping()
+            try emitter.pair("public-key", reality.publicKey.base64URLEncodedString())
+            try emitter.pair("short-id", reality.shortId.hexEncodedString())
+            try emitter.endMapping()
+        }
+
+        switch transport {
+        case .ws(let ws):
+            try emitWSOptions(host: ws.host, path: ws.path, headers: ws.headers, server: server, to: emitter) {
+                if ws.maxEarlyData > 0 {
+                    try emitter.pair("max-early-data", ws.maxEarlyData)
+                    try emitter.pair("early-data-header-name", ws.earlyDataHeaderName)
+                }
+            }
+        case .httpUpgrade(let upgrade):
+            try emitWSOptions(host: upgrade.host, path: upgrade.path, headers: upgrade.headers, server: server, to: emitter) {
+                try emitter.pair("v2ray-http-upgrade", true)
+            }
+        case .raw, .grpc, .xhttp:
+            try emitter.pair("network", "tcp")
+        }
+    }
+
+    /// The parser takes the host from a `Host` header, falling back to the server address.
+    private static func emitWSOptions(host: String, path: String, headers: [String: String], server: String,
+                                      to emitter: YAML.Emitter, extra: () throws -> Void) throws {
+        try emitter.pair("network", "ws")
+        try emitter.scalar("ws-opts")
+        try emitter.beginMapping()
+        try emitter.pair("path", path.isEmpty ? "/" : path)
+        var headers = headers
+        if headers["Host"] == nil && !host.isEmpty && host != server {
+            headers["Host"] = host
+        }
+        if !headers.isEmpty {
+            try emitter.scalar("headers")
+            try emitter.beginMapping()
+            for name in headers.keys.sorted() {
+                try emitter.pair(name, headers[name] ?? "")
+            }
+            try emitter.endMapping()
+        }
+        try extra()
+        try emitter.endMapping()
+    }
+
+    // MARK: - Sudoku
+
+    private static func emitSudoku(_ sudoku: SudokuConfiguration, to emitter: YAML.Emitter) throws {
+        try emitter.pair("type", "sudoku")
+        try emitter.pair("key", sudoku.key)
+        try emitter.pair("aead-method", sudoku.aeadMethod.rawValue)
+        try emitter.pair("table-type", sudoku.asciiMode.rawValue)
+        if !sudoku.customTables.isEmpty {
+            try emitter.scalar("custom-tables")
+            try emitter.beginSequence()
+            for table in sudoku.customTables { try emitter.scalar(table) }
+            try emitter.endSequence()
+        }
+        try emitter.pair("padding-min", sudoku.paddingMin)
+        try emitter.pair("padding-max", sudoku.paddingMax)
+        try emitter.pair("enable-pure-downlink", sudoku.enablePureDownlink)
+
+        let httpMask = sudoku.httpMask
+        try emitter.scalar("httpmask")
+        try emitter.beginMapping()
+        try emitter.pair("disable", httpMask.disable)
+        try emitter.pair("mode", httpMask.mode.rawValue)
+        try emitter.pair("tls", httpMask.tls)
+        if !httpMask.host.isEmpty { try emitter.pair("host", httpMask.host) }
+        if !httpMask.pathRoot.isEmpty { try emitter.pair("path-root", httpMask.pathRoot) }
+        try emitter.pair("multiplex", httpMask.multiplex.rawValue)
+        try emitter.endMapping()
+    }
+
+    // MARK: - Shared option emission
+
+    private static func emitTLS(_ tls: TLSConfiguration, serverNameKey: String, to emitter: YAML.Emitter) throws {
+        try emitter.pair(serverNameKey, tls.serverName)
+        if let alpn = tls.alpn, !alpn.isEmpty {
+            try emitter.scalar("alpn")
+            try emitter.beginSequence(flow: true)
+            for protocolName in alpn { try emitter.scalar(protocolName) }
+            try emitter.endSequence()
+        }
+        try emitFingerprint(tls.fingerprint, to: emitter)
+        if tls.echEnabled {
+            try emitter.scalar("ech-opts")
+            try emitter.beginMapping()
+            try emitter.pair("enable", true)
+            if let config = tls.echConfig { try emitter.pair("config", config) }
+            try emitter.endMapping()
+        }
+    }
+
+    /// Inverse of the parser's `mapFingerprint`: browser names where Clash has one, the raw
+    /// value otherwise, nothing for the default.
+    private static func emitFingerprint(_ fingerprint: TLSFingerprint, to emitter: YAML.Emitter) throws {
+        let name: String
+        switch fingerprint {
+        case .chrome120: return
+        case .chrome133:  name = "chrome"
+        case .firefox148: name = "firefox"
+        case .safari26:   name = "safari"
+        case .edge106:    name = "edge"
+        default:          name = fingerprint.rawValue
+        }
+        try emitter.pair("client-fingerprint", name)
+    }
+
+    private static func ruleType(_ type: RoutingRuleType) -> String {
+        switch type {
+        case .domainSuffix:  return "DOMAIN-SUFFIX"
+        case .domainKeyword: return "DOMAIN-KEYWORD"
+        case .ipCIDR:        return "IP-CIDR"
+        case .ipCIDR6:       return "IP-CIDR6"
+        }
+    }
+}
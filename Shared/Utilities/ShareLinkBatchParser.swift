@@ -0,0 +1,63 @@
+//
+//  ShareLinkBatchParser.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+
+/// Parses a block of share links — a decoded subscription body or a pasted list — with one
+/// line per link. Lines are cut into chunks that parse concurrently off the calling actor;
+/// results come back in input order, and a link that repeats an earlier one's server and
+/// outbound (typically the same node under another name) is dropped.
+nonisolated enum ShareLinkBatchParser {
+
+    /// Below this many lines everything parses in one chunk; spawning tasks would cost more.
+    static let minimumChunkSize = 32
+
+    /// Everything before the `#name` fragment identifies the node; the name doesn't.
+    private struct CanonicalKey: Hashable {
+        let serverAddress: String
+        let serverPort: UInt16
+        let outbound: Outbound
+    }
+
+    static func parse(_ text: String) async -> [ProxyConfiguration] {
+        let lines = text
+            .split(whereSeparator: \.isNewline)
+            .map { $0.trimmingCharacters(in: .whitespaces) }
+            .filter { ProxyConfiguration.canParseURL($0) }
+        guard !lines.isEmpty else { return [] }
+
+        let chunkSize = max(minimumChunkSize, lines.count / (ProcessInfo.processInfo.activeProcessorCount * 4))
+        let chunkCount = (lines.count + chunkSize - 1) / chunkSize
+        var chunks = [[ProxyConfiguration]](repeating: [], count: chunkCount)
+        await withTaskGroup(of: (index: Int, configurations: [ProxyConfiguration]).self) { group in
+            for index in 0..<chunkCount {
+                let slice = lines[(index * chunkSize)..<min(lines.count, (index + 1) * chunkSize)]
+                group.addTask {
+                    (index, slice.compactMap { try? ProxyConfiguration.parse(url: $0) })
+                }
+            }
+            for await chunk in group {
+                chunks[chunk.index] = chunk.configurations
+            }
+        }
+
+        var seen = Set<CanonicalKey>()
+        var configurations: [ProxyConfiguration] = []
+        configurations.reserveCapacity(lines.count)
+        for configuration in chunks.joined() {
+            let key = CanonicalKey(
+                serverAddress: configuration.serverAddress.lowercased(),
+                serverPort: configuration.serverPort,
+                outbound: configuration.outbound
+            )
+            if seen.insert(key).inserted {
+                configurations.append(configuration)
+            }
+        }
+        return configurations
+    }
+}
@@ -15,6 +15,10 @@ struct SubscriptionFetcher {
         let download: Int64?
         let total: Int64?
         let expire: Date?
+        /// BLAKE3 of the downloaded body.
+        let digest: Data
+        /// The body hashed to the caller's `knownDigest`; it wasn't parsed and `configurations` is empty.
+        var isUnchanged = false
     }
 
     enum FetchError: Error, LocalizedError {
@@ -34,7 +38,7 @@ struct SubscriptionFetcher {
         }
     }
 
-    static func fetch(url urlString: String, withRemnawaveHWID: Bool = false) async throws -> Result {
+    static func fetch(url urlString: String, withRemnawaveHWID: Bool = false, knownDigest: Data? = nil) async throws -> Result {
         guard let url = URL(string: urlString) else {
             throw FetchError.invalidURL
         }
@@ -47,31 +51,37 @@ struct SubscriptionFetcher {
 
         let allowInsecure = AWCore.getAllowInsecure()
         let delegate: InsecureSessionDelegate? = allowInsecure ? InsecureSessionDelegate() : nil
-        let (data, response): (Data, URLResponse)
+        // Downloaded to a file rather than into memory: a Clash body streams from it into the parser.
+        let (fileURL, response): (URL, URLResponse)
+        let data: Data
         do {
-            (data, response) = try await URLSession(configuration: .default, delegate: delegate, delegateQueue: nil).data(for: request)
+            (fileURL, response) = try await URLSession(configuration: .default, delegate: delegate, delegateQueue: nil).download(for: request)
+            data = try Data(contentsOf: fileURL, options: .alwaysMapped)
         } catch {
             throw FetchError.networkError(error.localizedDescription)
         }
+        defer { try? FileManager.default.removeItem(at: fileURL) }
 
         let httpResponse = response as? HTTPURLResponse
 
         let profileTitle = parseProfileTitle(from: httpResponse)
         let userInfo = parseSubscriptionUserInfo(from: httpResponse)
 
-        let bodyString: String
-        if let decoded = Data(base64Encoded: data, options: .ignoreUnknownCharacters),
-           let decodedString = String(data: decoded, encoding: .utf8),
-           ProxyConfiguration.parsableURLPrefixes.contains(where: { decodedString.contains($0) }) {
-            bodyString = decodedString
-        } else if let rawString = String(data: data, encoding: .utf8) {
-            bodyString = rawString
-        } else {
-            throw FetchError.noConfigurations
+        let digest = BLAKE3Hasher.hashParallel(data)
+        if digest == knownDigest {
+            return Result(
+                configurations: [],
+                name: profileTitle,
+                upload: userInfo.upload,
+                download: userInfo.download,
+                total: userInfo.total,
+                expire: userInfo.expire,
+                digest: digest,
+                isUnchanged: true
+            )
         }
 
-        if bodyString.contains("proxies:") {
-            let result = try ClashProxyParser.parse(yaml: bodyString)
+        func clashResult(_ result: ClashProxyParser.ParseResult) throws -> Result {
             guard !result.configurations.isEmpty else {
                 throw FetchError.noConfigurations
             }
@@ -81,15 +91,29 @@ struct SubscriptionFetcher {
                 upload: userInfo.upload,
                 download: userInfo.download,
                 total: userInfo.total,
-                expire: userInfo.expire
+                expire: userInfo.expire,
+                digest: digest
             )
         }
 
-        let configurations = bodyString
-            .components(separatedBy: .newlines)
-            .map { $0.trimmingCharacters(in: .whitespaces) }
-            .filter { ProxyConfiguration.canParseURL($0) }
-            .compactMap { try? ProxyConfiguration.parse(url: $0) }
+        let bodyString: String
+        if let decoded = Data(base64Encoded: data, options: .ignoreUnknownCharacters),
+           let decodedString = String(data: decoded, encoding: .utf8),
+           ProxyConfiguration.parsableURLPrefixes.contains(where: { decodedString.contains($0) }) {
+            bodyString = decodedString
+        } else if data.range(of: Data("proxies:".utf8)) != nil, let stream = InputStream(url: fileURL) {
+            return try clashResult(ClashProxyParser.parse(stream: stream))
+        } else if let rawString = String(data: data, encoding: .utf8) {
+            bodyString = rawString
+        } else {
+            throw FetchError.noConfigurations
+        }
+
+        if bodyString.contains("proxies:") {
+            return try clashResult(ClashProxyParser.parse(yaml: bodyString))
+        }
+
+        let configurations = await ShareLinkBatchParser.parse(bodyString)
 
         guard !configurations.isEmpty else {
             throw FetchError.noConfigurations
@@ -101,7 +125,8 @@ struct SubscriptionFetcher {
             upload: userInfo.upload,
             download: userInfo.download,
             total: userInfo.total,
-            expire: userInfo.expire
+            expire: userInfo.expire,
+            digest: digest
         )
     }
 
@@ -39,8 +39,21 @@ enum YAML {
 
         let storage: Storage
 
+        /// First position of each scalar key in a map, so lookups don't scan the pairs.
+        private let keyIndex: [String: Int]
+
         init(_ storage: Storage = .undefined) {
             self.storage = storage
+            guard case .map(let pairs) = storage else {
+                keyIndex = [:]
+                return
+            }
+            var index: [String: Int] = [:]
+            index.reserveCapacity(pairs.count)
+            for (position, pair) in pairs.enumerated() where index[pair.key.scalar] == nil {
+                index[pair.key.scalar] = position
+            }
+            keyIndex = index
         }
 
         var type: NodeType {
@@ -59,11 +72,8 @@ enum YAML {
         }
 
         subscript(key: String) -> Node {
-            guard case .map(let pairs) = storage else { return Node() }
-            for pair in pairs where pair.key.scalar == key {
-                return pair.value
-            }
-            return Node()
+            guard case .map(let pairs) = storage, let position = keyIndex[key] else { return Node() }
+            return pairs[position].value
         }
 
         subscript(index: Int) -> Node {
@@ -88,6 +98,39 @@ enum YAML {
             }
         }
     }
+
+    enum StreamedSequence {
+        case streamed
+        case rootNotMapping
+        case keyMissing
+    }
+
+    /// Streams the sequence under the root mapping's `key`: each element is built, handed to `body`
+    /// and released before the next is parsed, and sibling keys are skipped without building nodes
+    /// (anchored ones excepted, so later aliases still resolve). Input is pulled from `stream`
+    /// through libyaml's read handler, so a file never has to be held in memory whole.
+    static func forEachElement(inSequence key: String, from stream: InputStream, _ body: (Node) throws -> Void) throws -> StreamedSequence {
+        var parser = yaml_parser_t()
+        guard yaml_parser_initialize(&parser) == 1 else {
+            throw ParseError.initializationFailed
+        }
+        defer { yaml_parser_delete(&parser) }
+
+        stream.open()
+        defer { stream.close() }
+        let context = Unmanaged.passUnretained(stream).toOpaque()
+        return try withUnsafeMutablePointer(to: &parser) { parserPtr in
+            yaml_parser_set_input(parserPtr, { data, buffer, size, sizeRead in
+                guard let data, let buffer, let sizeRead else { return 0 }
+                let stream = Unmanaged<InputStream>.fromOpaque(data).takeUnretainedValue()
+                let count = stream.read(buffer, maxLength: size)
+                guard count >= 0 else { return 0 }
+                sizeRead.pointee = count
+                return 1
+            }, context)
+            return try Loader(parser: parserPtr).streamSequence(key: key, body)
+        }
+    }
 }
 
 // MARK: - Sequence conformance
@@ -151,11 +194,67 @@ private final class Loader {
         }
     }
 
+    func streamSequence(key: String, _ body: (YAML.Node) throws -> Void) throws -> YAML.StreamedSequence {
+        while true {
+            var event = try nextEvent()
+            let type = event.type
+            yaml_event_delete(&event)
+            if type == YAML_STREAM_END_EVENT { return .rootNotMapping }
+            if type == YAML_DOCUMENT_START_EVENT { break }
+        }
+        var root = try nextEvent()
+        let isMapping = root.type == YAML_MAPPING_START_EVENT
+        yaml_event_delete(&root)
+        guard isMapping else { return .rootNotMapping }
+
+        while let candidate = try parseNode() {
+            guard candidate.scalar == key else {
+                guard try skipNode() else { break }
+                continue
+            }
+            // Only the first occurrence counts, as with `Node[key]`.
+            var event = try nextEvent()
+            let isSequence = event.type == YAML_SEQUENCE_START_EVENT
+            yaml_event_delete(&event)
+            guard isSequence else { return .keyMissing }
+            while let element = try parseNode() {
+                try body(element)
+            }
+            return .streamed
+        }
+        return .keyMissing
+    }
+
     /// Returns nil when the next event closes a container, so callers can loop until nil.
     private func parseNode() throws -> YAML.Node? {
         var event = try nextEvent()
         defer { yaml_event_delete(&event) }
+        return try node(from: event)
+    }
 
+    /// Consumes the next node without building it, unless it carries an anchor. Returns false when
+    /// the next event closes a container.
+    private func skipNode() throws -> Bool {
+        var event = try nextEvent()
+        defer { yaml_event_delete(&event) }
+        switch event.type {
+        case YAML_SEQUENCE_END_EVENT, YAML_MAPPING_END_EVENT,
+             YAML_DOCUMENT_END_EVENT, YAML_STREAM_END_EVENT, YAML_NO_EVENT:
+            return false
+        case YAML_SEQUENCE_START_EVENT where event.data.sequence_start.anchor == nil,
+             YAML_MAPPING_START_EVENT where event.data.mapping_start.anchor == nil:
+            while try skipNode() {}
+            return true
+        case YAML_SCALAR_EVENT where event.data.scalar.anchor == nil, YAML_ALIAS_EVENT:
+            return true
+        default:
+            _ = try node(from: event)
+            return true
+        }
+    }
+
+    /// Builds the node `event` opens, reading its children.
+    private func node(from event: yaml_event_t) throws -> YAML.Node? {
         switch event.type {
         case YAML_SEQUENCE_END_EVENT, YAML_MAPPING_END_EVENT,
              YAML_DOCUMENT_END_EVENT, YAML_STREAM_END_EVENT, YAML_NO_EVENT:
@@ -218,3 +317,173 @@ private final class Loader {
         }
     }
 }
+
+// MARK: - libyaml event producer
+
+extension YAML {
+    enum EmitError: Error, LocalizedError {
+        case initializationFailed
+        case emit(String)
+        case write(Error)
+
+        var errorDescription: String? {
+            switch self {
+            case .initializationFailed: return "Failed to initialize the YAML emitter"
+            case .emit(let message):    return message
+            case .write(let error):     return error.localizedDescription
+            }
+        }
+    }
+
+    /// Writes one document to `handle` event by event. libyaml keeps a fixed output buffer and
+    /// hands it to the write handler as it fills, so memory stays bounded however long the
+    /// document runs. Open collections with `begin…`, close them, then call ``finish()``.
+    final class Emitter {
+        private let emitter: UnsafeMutablePointer<yaml_emitter_t>
+        private let handle: FileHandle
+        private var writeError: Error?
+
+        init(handle: FileHandle) throws {
+            emitter = .allocate(capacity: 1)
+            emitter.initialize(to: yaml_emitter_t())
+            guard yaml_emitter_initialize(emitter) == 1 else {
+                emitter.deallocate()
+                throw EmitError.initializationFailed
+            }
+            self.handle = handle
+            yaml_emitter_set_unicode(emitter, 1)
+            yaml_emitter_set_width(emitter, -1)
+            yaml_emitter_set_output(emitter, { data, buffer, size in
+                guard let data, let buffer else { return 0 }
+                let emitter = Unmanaged<Emitter>.fromOpaque(data).takeUnretainedValue()
+                return emitter.write(UnsafeBufferPointer(start: buffer, count: size)) ? 1 : 0
+            }, Unmanaged.passUnretained(self).toOpaque())
+
+            var event = yaml_event_t()
+            yaml_stream_start_event_initialize(&event, YAML_UTF8_ENCODING)
+            try emit(&event)
+            yaml_document_start_event_initialize(&event, nil, nil, nil, 1)
+            try emit(&event)
+        }
+
+        deinit {
+            yaml_emitter_delete(emitter)
+            emitter.deinitialize(count: 1)
+            emitter.deallocate()
+        }
+
+        func beginMapping(flow: Bool = false) throws {
+            var event = yaml_event_t()
+            yaml_mapping_start_event_initialize(&event, nil, nil, 1,
+                                                flow ? YAML_FLOW_MAPPING_STYLE : YAML_BLOCK_MAPPING_STYLE)
+            try emit(&event)
+        }
+
+        func endMapping() throws {
+            var event = yaml_event_t()
+            yaml_mapping_end_event_initialize(&event)
+            try emit(&event)
+        }
+
+        func beginSequence(flow: Bool = false) throws {
+            var event = yaml_event_t()
+            yaml_sequence_start_event_initialize(&event, nil, nil, 1,
+                                                 flow ? YAML_FLOW_SEQUENCE_STYLE : YAML_BLOCK_SEQUENCE_STYLE)
+            try emit(&event)
+        }
+
+        func endSequence() throws {
+            var event = yaml_event_t()
+            yaml_sequence_end_event_initialize(&event)
+            try emit(&event)
+        }
+
+        /// A string scalar; quoted when plain style would read back as null, a bool or a number.
+        func scalar(_ value: String) throws {
+            try scalar(value, style: Emitter.resolvesAsString(value) ? YAML_ANY_SCALAR_STYLE : YAML_SINGLE_QUOTED_SCALAR_STYLE)
+        }
+
+        func scalar(_ value: Int) throws {
+            try scalar(String(value), style: YAML_PLAIN_SCALAR_STYLE)
+        }
+
+        func scalar(_ value: Bool) throws {
+            try scalar(value ? "true" : "false", style: YAML_PLAIN_SCALAR_STYLE)
+        }
+
+        func pair(_ key: String, _ value: String) throws {
+            try scalar(key)
+            try scalar(value)
+        }
+
+        func pair(_ key: String, _ value: Int) throws {
+            try scalar(key)
+            try scalar(value)
+        }
+
+        func pair(_ key: String, _ value: Bool) throws {
+            try scalar(key)
+            try scalar(value)
+        }
+
+        /// Closes the document and stream and flushes what libyaml still buffers.
+        func finish() throws {
+            var event = yaml_event_t()
+            yaml_document_end_event_initialize(&event, 1)
+            try emit(&event)
+            yaml_stream_end_event_initialize(&event)
+            try emit(&event)
+            guard yaml_emitter_flush(emitter) == 1 else { throw failure() }
+        }
+
+        // MARK: - Private
+
+        private func scalar(_ value: String, style: yaml_scalar_style_t) throws {
+            var event = yaml_event_t()
+            let length = value.utf8.count
+            value.withCString { cString in
+                let bytes = UnsafeRawPointer(cString).assumingMemoryBound(to: yaml_char_t.self)
+                let plainImplicit: Int32 = style == YAML_SINGLE_QUOTED_SCALAR_STYLE ? 0 : 1
+                _ = yaml_scalar_event_initialize(&event, nil, nil, bytes, Int32(length), plainImplicit, 1, style)
+            }
+            try emit(&event)
+        }
+
+        /// libyaml takes ownership of `event` whether or not the emit succeeds.
+        private func emit(_ event: inout yaml_event_t) throws {
+            guard yaml_emitter_emit(emitter, &event) == 1 else { throw failure() }
+        }
+
+        private func failure() -> EmitError {
+            if let writeError { return .write(writeError) }
+            if let problem = emitter.pointee.problem { return .emit(String(cString: problem)) }
+            return .emit("YAML emit error")
+        }
+
+        private func write(_ bytes: UnsafeBufferPointer<UInt8>) -> Bool {
+            do {
+                try handle.write(contentsOf: bytes)
+                return true
+            } catch {
+                writeError = error
+                return false
+            }
+        }
+
+        /// False for plain scalars a YAML 1.1 or 1.2 reader would type as null, bool or number.
+        private static func resolvesAsString(_ value: String) -> Bool {
+            switch value.lowercased() {
+            case "", "~", "null", "true", "false", "yes", "no", "on", "off", "y", "n":
+                return false
+            default:
+                break
+            }
+            guard let first = value.utf8.first,
+                  first == UInt8(ascii: "-") || first == UInt8(ascii: "+") || first == UInt8(ascii: ".")
+                    || (UInt8(ascii: "0")...UInt8(ascii: "9")).contains(first) else { return true }
+            if Double(value) != nil { return false }
+            let lowered = value.lowercased()
+            return !(lowered.hasPrefix("0x") || lowered.hasPrefix("0o") || lowered.hasSuffix("inf") || lowered == ".nan")
+        }
+    }
+}
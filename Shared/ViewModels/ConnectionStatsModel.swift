@@ -18,6 +18,7 @@ class ConnectionStatsModel {
     private(set) var bytesOut: Int64 = 0
     
     private(set) var routes: [RouteTrafficEntry] = []
+    private(set) var domains: [DomainTrafficEntry] = []
     
     private(set) var tcpConnectionCount: Int = 0
     private(set) var udpConnectionCount: Int = 0
@@ -39,6 +40,7 @@ class ConnectionStatsModel {
     @ObservationIgnored private var statsTask: Task<Void, Never>?
     @ObservationIgnored private weak var session: NETunnelProviderSession?
     @ObservationIgnored private var lastRateSample: (bytesIn: Int64, bytesOut: Int64, at: ContinuousClock.Instant)?
+    @ObservationIgnored private let statsRing = StatsRing.Reader()
 
     func startPolling(session: NETunnelProviderSession) {
         self.session = session
@@ -63,6 +65,7 @@ class ConnectionStatsModel {
         bytesIn = 0
         bytesOut = 0
         routes = []
+        domains = []
         tcpConnectionCount = 0
         udpConnectionCount = 0
         memoryBytes = 0
@@ -78,25 +81,12 @@ class ConnectionStatsModel {
     }
 
     private func pollStats() async {
-        guard let session else { return }
-        guard let data = try? JSONEncoder().encode(TunnelMessage.fetchStats) else { return }
-
-        let response: Data? = await withCheckedContinuation { continuation in
-            do {
-                try session.sendProviderMessage(data) { response in
-                    continuation.resume(returning: response)
-                }
-            } catch {
-                continuation.resume(returning: nil)
-            }
-        }
-
-        guard let response,
-              let stats = try? JSONDecoder().decode(StatsResponse.self, from: response) else { return }
+        guard let stats = await fetchStats() else { return }
         updateRates(bytesIn: stats.bytesIn, bytesOut: stats.bytesOut)
         self.bytesIn = stats.bytesIn
         self.bytesOut = stats.bytesOut
         self.routes = stats.routes
+        self.domains = stats.domains
         self.tcpConnectionCount = stats.tcpConnectionCount
         self.udpConnectionCount = stats.udpConnectionCount
         self.memoryBytes = stats.memoryBytes
@@ -108,6 +98,27 @@ class ConnectionStatsModel {
         self.avgHandshakeMs = stats.avgHandshakeMs
     }
 
+    /// Reads the extension's shared stats ring, falling back to `fetchStats` when it holds
+    /// no fresh snapshot (tunnel just started, an older extension, or a racing write).
+    private func fetchStats() async -> StatsResponse? {
+        if let stats = statsRing.read() { return stats }
+        guard let session else { return nil }
+        guard let data = try? JSONEncoder().encode(TunnelMessage.fetchStats) else { return nil }
+
+        let response: Data? = await withCheckedContinuation { continuation in
+            do {
+                try session.sendProviderMessage(data) { response in
+                    continuation.resume(returning: response)
+                }
+            } catch {
+                continuation.resume(returning: nil)
+            }
+        }
+
+        guard let response else { return nil }
+        return try? JSONDecoder().decode(StatsResponse.self, from: response)
+    }
+
     private func updateRates(bytesIn: Int64, bytesOut: Int64) {
         let now = ContinuousClock.now
         defer { lastRateSample = (bytesIn, bytesOut, now) }
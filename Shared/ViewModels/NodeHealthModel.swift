@@ -0,0 +1,69 @@
+//
+//  NodeHealthModel.swift
+//  Anywhere
+//
+//  Created by NodePassProject on 10/14/26.
+//
+
+import Foundation
+import NetworkExtension
+import Observation
+
+/// The extension's live-traffic health per node, polled while a proxy list is on screen.
+@MainActor
+@Observable
+class NodeHealthModel {
+    static let shared = NodeHealthModel()
+
+    private(set) var health: [UUID: NodeHealthEntry] = [:]
+
+    @ObservationIgnored private var pollingTask: Task<Void, Never>?
+
+    func startPolling() {
+        guard pollingTask == nil else { return }
+        pollingTask = Task { [weak self] in
+            while !Task.isCancelled {
+                guard let self, !Task.isCancelled else { break }
+                await self.pollHealth()
+                try? await Task.sleep(for: .seconds(5))
+            }
+        }
+    }
+
+    /// Keeps the last table, so a list shown again doesn't flicker while the first poll runs.
+    func stopPolling() {
+        pollingTask?.cancel()
+        pollingTask = nil
+    }
+
+    private func resolveSession() async -> NETunnelProviderSession? {
+        let managers = try? await NETunnelProviderManager.loadAllFromPreferences()
+        guard let connection = managers?.first?.connection as? NETunnelProviderSession,
+              connection.status == .connected else { return nil }
+        return connection
+    }
+
+    private func pollHealth() async {
+        guard let session = await resolveSession() else {
+            if !health.isEmpty { health = [:] }
+            return
+        }
+        guard let data = try? JSONEncoder().encode(TunnelMessage.fetchNodeHealth) else { return }
+
+        let response: Data? = await withCheckedContinuation { continuation in
+            do {
+                try session.sendProviderMessage(data) { response in
+                    continuation.resume(returning: response)
+                }
+            } catch {
+                continuation.resume(returning: nil)
+            }
+        }
+
+        guard let response,
+              let payload = try? JSONDecoder().decode(NodeHealthResponse.self, from: response) else { return }
+
+        let updated = Dictionary(payload.nodes.map { ($0.id, $0) }, uniquingKeysWith: { _, last in last })
+        if updated != health { health = updated }
+    }
+}
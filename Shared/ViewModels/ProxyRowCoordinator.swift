@@ -29,6 +29,7 @@ final class ProxyRowCoordinator {
             _ = VPNViewModel.shared.selectedConfiguration
             _ = VPNViewModel.shared.selectedChainId
             _ = VPNViewModel.shared.latencyResults
+            _ = NodeHealthModel.shared.health
         } onChange: { [weak self] in
             guard let self else { return }
             Task { @MainActor in
@@ -43,17 +44,19 @@ final class ProxyRowCoordinator {
         let selectedId = VPNViewModel.shared.selectedConfiguration?.id
         let selectedChainId = VPNViewModel.shared.selectedChainId
         let latency = VPNViewModel.shared.latencyResults
+        let health = NodeHealthModel.shared.health
 
         var ordered: [ProxyListItem] = []
         var updated: [UUID: ProxyListItem] = [:]
         for configuration in configurations {
             let isSelected = configuration.id == selectedId && selectedChainId == nil
             let result = latency[configuration.id]
+            let nodeHealth = health[configuration.id]
             let model = byID[configuration.id]
             if let model {
-                model.update(configuration, isSelected: isSelected, latency: result)
+                model.update(configuration, isSelected: isSelected, latency: result, health: nodeHealth)
             }
-            let resolved = model ?? ProxyListItem(configuration, isSelected: isSelected, latency: result)
+            let resolved = model ?? ProxyListItem(configuration, isSelected: isSelected, latency: result, health: nodeHealth)
             ordered.append(resolved)
             updated[configuration.id] = resolved
         }
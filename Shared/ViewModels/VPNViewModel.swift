@@ -161,8 +161,6 @@ class VPNViewModel {
 
     @ObservationIgnored private var latencyTask: Task<Void, Never>?
 
-    private static let maxConcurrentLatencyTests = 4
-
     func testLatency(for configuration: ProxyConfiguration) {
         latencyTask?.cancel()
         let configurationId = configuration.id
@@ -243,7 +241,9 @@ class VPNViewModel {
         return await LatencyTester.test(configuration)
     }
 
-    /// Runs a batch of tests with at most `maxConcurrentLatencyTests` in flight, reporting each result as it arrives.
+    /// Runs a batch of tests with at most `LatencyTester.maxConcurrentTests` in flight, reporting each
+    /// result as it arrives. In-process batches go through `LatencyTester`'s batch stream so shared
+    /// servers resolve once; over IPC each test is its own message, since a reply is one-shot.
     nonisolated private static func runLatencyTests(
         _ configurations: [ProxyConfiguration],
         viaIPC: Bool,
@@ -251,12 +251,18 @@ class VPNViewModel {
         onResult: @Sendable @escaping (UUID, LatencyResult) async -> Void
     ) async {
         guard !configurations.isEmpty else { return }
+        guard viaIPC, let session else {
+            for await outcome in LatencyTester.test(configurations) {
+                await onResult(outcome.id, outcome.result)
+            }
+            return
+        }
         await withTaskGroup(of: (UUID, LatencyResult).self) { group in
             var iterator = configurations.makeIterator()
-            for _ in 0..<min(Self.maxConcurrentLatencyTests, configurations.count) {
+            for _ in 0..<min(LatencyTester.maxConcurrentTests, configurations.count) {
                 if let config = iterator.next() {
                     group.addTask {
-                        let r = await runSingleLatencyTest(for: config, viaIPC: viaIPC, session: session)
+                        let r = await sendLatencyTestMessage(for: config, session: session)
                         return (config.id, r)
                     }
                 }
@@ -265,7 +271,7 @@ class VPNViewModel {
                 await onResult(pair.0, pair.1)
                 if let config = iterator.next() {
                     group.addTask {
-                        let r = await runSingleLatencyTest(for: config, viaIPC: viaIPC, session: session)
+                        let r = await sendLatencyTestMessage(for: config, session: session)
                         return (config.id, r)
                     }
                 }
@@ -494,6 +500,43 @@ class VPNViewModel {
         }
     }
 
+    /// Hands the extension a group to health-probe and auto-select the default outbound from, or
+    /// nil to stop; a manual selection also stops it on the extension side. Only effective while
+    /// connected — the group doesn't survive a tunnel restart.
+    func setAutoSelectGroup(_ group: AutoSelectGroup?) {
+        guard vpnStatus == .connected, let session = providerSession,
+              let data = try? JSONEncoder().encode(TunnelMessage.setAutoSelectGroup(group)) else { return }
+        do {
+            try session.sendProviderMessage(data) { _ in }
+        } catch {
+            logger.warning("Failed to send auto-select group to tunnel: \(error.localizedDescription)")
+        }
+    }
+
+    /// Toggles the extension's data-path signposts so a field user can record an Instruments
+    /// trace of a slow session; only effective while connected.
+    func setDataPathTracing(_ enabled: Bool) {
+        guard vpnStatus == .connected, let session = providerSession,
+              let data = try? JSONEncoder().encode(TunnelMessage.setDataPathTracing(enabled)) else { return }
+        do {
+            try session.sendProviderMessage(data) { _ in }
+        } catch {
+            logger.warning("Failed to send data-path tracing toggle to tunnel: \(error.localizedDescription)")
+        }
+    }
+
+    /// Toggles qlog capture for new QUIC connections; the captures land in
+    /// `QUICQlogSink.capturedFiles()` for export to qvis. Only effective while connected.
+    func setQlogCapture(_ enabled: Bool) {
+        guard vpnStatus == .connected, let session = providerSession,
+              let data = try? JSONEncoder().encode(TunnelMessage.setQlogCapture(enabled)) else { return }
+        do {
+            try session.sendProviderMessage(data) { _ in }
+        } catch {
+            logger.warning("Failed to send qlog capture toggle to tunnel: \(error.localizedDescription)")
+        }
+    }
+
     // MARK: - DNS Resolution
 
     /// Resolves a server address to an IP string (IP literals pass through) via the